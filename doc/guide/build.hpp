@@ -174,8 +174,18 @@ The full list of options mlpack allows:
  - PROFILE=(ON/OFF): compile with profiling symbols (default OFF)
  - ARMA_EXTRA_DEBUG=(ON/OFF): compile with extra Armadillo debugging symbols
        (default OFF)
+ - ENABLE_MEMORY_TRACKING=(ON/OFF): account for the memory allocated by
+       Armadillo, overall and in the phases of algorithms; this cannot be used
+       with the Python, Julia or Go bindings (default OFF)
+ - ENABLE_HUGE_PAGES=(ON/OFF): allocate the memory of Armadillo aligned to
+       cache lines, and place large matrices in huge pages on Linux; like
+       ENABLE_MEMORY_TRACKING, this cannot be used with the Python, Julia or
+       Go bindings, since they pass the ownership of matrix memory to and from
+       malloc() and free() (default OFF)
  - BUILD_TESTS=(ON/OFF): compile the \c mlpack_test program when `make` is run
        (default ON)
+ - BUILD_BENCHMARKS=(ON/OFF): add the \c mlpack_benchmarks target, which is
+       built with `make mlpack_benchmarks` (default ON)
  - BUILD_CLI_EXECUTABLES=(ON/OFF): compile the mlpack command-line executables
        (i.e. \c mlpack_knn, \c mlpack_kfn, \c mlpack_logistic_regression, etc.)
        (default ON)
@@ -301,6 +311,20 @@ to run BinaryClassificationMetricsTest implemented in cv_test.cpp you can run th
 ./bin/mlpack_test BinaryClassificationMetricsTest
 @endcode
 
+The performance of the core algorithms can be tracked with mlpack_benchmarks,
+which is also not built when @c make is run:
+
+@code
+$ make mlpack_benchmarks
+$ bin/mlpack_benchmarks --benchmark_filter=KNN --benchmark_out=results.json
+@endcode
+
+It takes the options of Google Benchmark (\c --benchmark_filter,
+\c --benchmark_min_time, \c --benchmark_out, \c --benchmark_format and
+\c --benchmark_list_tests) and writes its results in the same JSON format, so
+that the results of two builds can be compared with the tools of Google
+Benchmark.
+
 If the build fails and you cannot figure out why, register an account on Github
 and submit an issue and the mlpack developers will quickly help you figure it
 out:
@@ -0,0 +1,172 @@
+/**
+ * @file benchmarks/ann_benchmarks.cpp
+ *
+ * Benchmarks for the forward and backward passes of the neural network layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmark;
+
+/**
+ * Measure the forward pass of the given layer on the given batch.
+ */
+template<typename LayerType>
+void LayerForward(State& state, LayerType& layer, const arma::mat& input)
+{
+  arma::mat output;
+  while (state.KeepRunning())
+  {
+    layer.Forward(input, output);
+    DoNotOptimize(output);
+  }
+  state.SetItemsProcessed(state.Iterations() * input.n_cols);
+}
+
+//! Compute the gradient of the parameters of a layer, if it has any.
+template<bool HasGradient>
+struct LayerGradient
+{
+  template<typename LayerType>
+  static void Compute(LayerType& /* layer */,
+                      const arma::mat& /* input */,
+                      const arma::mat& /* error */,
+                      arma::mat& /* gradient */) { }
+};
+
+template<>
+struct LayerGradient<true>
+{
+  template<typename LayerType>
+  static void Compute(LayerType& layer,
+                      const arma::mat& input,
+                      const arma::mat& error,
+                      arma::mat& gradient)
+  {
+    layer.Gradient(input, error, gradient);
+  }
+};
+
+/**
+ * Measure the backward pass of the given layer on the given batch, and the
+ * computation of the gradient of its parameters if it has any.
+ */
+template<bool HasGradient, typename LayerType>
+void LayerBackward(State& state, LayerType& layer, const arma::mat& input)
+{
+  arma::mat output, delta, gradient;
+  layer.Forward(input, output);
+  const arma::mat error = arma::randu<arma::mat>(output.n_rows, output.n_cols);
+  while (state.KeepRunning())
+  {
+    // The activation layers take their output as the input of Backward().
+    layer.Backward(output, error, delta);
+    LayerGradient<HasGradient>::Compute(layer, input, error, gradient);
+    DoNotOptimize(delta);
+    DoNotOptimize(gradient);
+  }
+  state.SetItemsProcessed(state.Iterations() * input.n_cols);
+}
+
+/**
+ * Linear layers; the arguments are the input size, the output size and the
+ * batch size.
+ */
+void LinearForward(State& state)
+{
+  math::RandomSeed(42);
+  Linear<> layer(state.Arg(0), state.Arg(1));
+  layer.Parameters().randu();
+  layer.Reset();
+  LayerForward(state, layer,
+      arma::randu<arma::mat>(state.Arg(0), state.Arg(2)));
+}
+
+void LinearBackward(State& state)
+{
+  math::RandomSeed(42);
+  Linear<> layer(state.Arg(0), state.Arg(1));
+  layer.Parameters().randu();
+  layer.Reset();
+  LayerBackward<true>(state, layer,
+      arma::randu<arma::mat>(state.Arg(0), state.Arg(2)));
+}
+
+/**
+ * Convolution layers with 3x3 kernels; the arguments are the width (and
+ * height) of the images, the number of input and output channels, and the
+ * batch size.
+ */
+void ConvolutionForward(State& state)
+{
+  math::RandomSeed(42);
+  const size_t size = state.Arg(0);
+  Convolution<> layer(state.Arg(1), state.Arg(2), 3, 3, 1, 1, 0, 0, size,
+      size);
+  layer.Parameters().randu();
+  layer.Reset();
+  LayerForward(state, layer,
+      arma::randu<arma::mat>(size * size * state.Arg(1), state.Arg(3)));
+}
+
+void ConvolutionBackward(State& state)
+{
+  math::RandomSeed(42);
+  const size_t size = state.Arg(0);
+  Convolution<> layer(state.Arg(1), state.Arg(2), 3, 3, 1, 1, 0, 0, size,
+      size);
+  layer.Parameters().randu();
+  layer.Reset();
+  LayerBackward<true>(state, layer,
+      arma::randu<arma::mat>(size * size * state.Arg(1), state.Arg(3)));
+}
+
+/**
+ * Activation layers; the arguments are the input size and the batch size.
+ */
+void SigmoidForward(State& state)
+{
+  SigmoidLayer<> layer;
+  LayerForward(state, layer,
+      arma::randn<arma::mat>(state.Arg(0), state.Arg(1)));
+}
+
+void SigmoidBackward(State& state)
+{
+  SigmoidLayer<> layer;
+  LayerBackward<false>(state, layer,
+      arma::randn<arma::mat>(state.Arg(0), state.Arg(1)));
+}
+
+void ReLUForward(State& state)
+{
+  ReLULayer<> layer;
+  LayerForward(state, layer,
+      arma::randn<arma::mat>(state.Arg(0), state.Arg(1)));
+}
+
+void ReLUBackward(State& state)
+{
+  ReLULayer<> layer;
+  LayerBackward<false>(state, layer,
+      arma::randn<arma::mat>(state.Arg(0), state.Arg(1)));
+}
+
+MLPACK_BENCHMARK(LinearForward, { 100, 100, 1 }, { 100, 100, 32 },
+    { 1000, 1000, 32 });
+MLPACK_BENCHMARK(LinearBackward, { 100, 100, 1 }, { 100, 100, 32 },
+    { 1000, 1000, 32 });
+MLPACK_BENCHMARK(ConvolutionForward, { 28, 1, 8, 32 }, { 28, 8, 8, 32 });
+MLPACK_BENCHMARK(ConvolutionBackward, { 28, 1, 8, 32 }, { 28, 8, 8, 32 });
+MLPACK_BENCHMARK(SigmoidForward, { 1000, 32 });
+MLPACK_BENCHMARK(SigmoidBackward, { 1000, 32 });
+MLPACK_BENCHMARK(ReLUForward, { 1000, 32 });
+MLPACK_BENCHMARK(ReLUBackward, { 1000, 32 });
@@ -0,0 +1,305 @@
+/**
+ * @file benchmarks/benchmark.cpp
+ *
+ * Implementation of the microbenchmark harness, and the main() function of
+ * mlpack_benchmarks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/core/util/version.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace std;
+
+namespace {
+
+//! A registered benchmark.
+struct Benchmark
+{
+  string name;
+  BenchmarkFunction function;
+  vector<vector<size_t>> argSets;
+};
+
+//! The result of a benchmark run.
+struct Result
+{
+  string name;
+  size_t iterations;
+  //! Times per iteration, in nanoseconds.
+  double realTime;
+  double cpuTime;
+  double itemsPerSecond;
+  double bytesPerSecond;
+};
+
+vector<Benchmark>& Benchmarks()
+{
+  static vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+//! Get the name of a run, as "Name/arg0/arg1".
+string RunName(const string& name, const vector<size_t>& args)
+{
+  ostringstream runName;
+  runName << name;
+  for (const size_t arg : args)
+    runName << "/" << arg;
+  return runName.str();
+}
+
+/**
+ * Run the benchmark with the given arguments, with more and more iterations,
+ * until the run takes the minimum time.
+ */
+Result Run(const Benchmark& benchmark,
+           const vector<size_t>& args,
+           const double minTime)
+{
+  const size_t maxIterations = 1000000000;
+  size_t iterations = 1;
+  while (true)
+  {
+    State state(args, iterations);
+    benchmark.function(state);
+
+    if (state.RealTime() >= minTime || iterations >= maxIterations)
+    {
+      Result result;
+      result.name = RunName(benchmark.name, args);
+      result.iterations = iterations;
+      result.realTime = 1e9 * state.RealTime() / iterations;
+      result.cpuTime = 1e9 * state.CPUTime() / iterations;
+      result.itemsPerSecond = (state.RealTime() > 0) ?
+          state.ItemsProcessed() / state.RealTime() : 0;
+      result.bytesPerSecond = (state.RealTime() > 0) ?
+          state.BytesProcessed() / state.RealTime() : 0;
+      return result;
+    }
+
+    // Predict the number of iterations that take the minimum time, with some
+    // margin, and grow by at most a factor of 10 (as Google Benchmark does).
+    double multiplier = 10.0;
+    if (state.RealTime() > 0)
+      multiplier = std::min(10.0, 1.4 * minTime / state.RealTime());
+    iterations = std::min(maxIterations,
+        std::max(iterations + 1, (size_t) (iterations * multiplier)));
+  }
+}
+
+//! Escape the given string for JSON.
+string EscapeJSON(const string& s)
+{
+  string result;
+  for (const char c : s)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    result += c;
+  }
+  return result;
+}
+
+//! Write the results in the JSON format of Google Benchmark.
+void WriteJSON(ostream& out, const vector<Result>& results, const char* program)
+{
+  const time_t now = time(NULL);
+  char date[64];
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+  out << "{" << endl;
+  out << "  \"context\": {" << endl;
+  out << "    \"date\": \"" << date << "\"," << endl;
+  out << "    \"executable\": \"" << EscapeJSON(program) << "\"," << endl;
+  out << "    \"num_cpus\": " << thread::hardware_concurrency() << "," << endl;
+  out << "    \"mlpack_version\": \"" << EscapeJSON(util::GetVersion())
+      << "\"," << endl;
+  #ifdef DEBUG
+  out << "    \"library_build_type\": \"debug\"" << endl;
+  #else
+  out << "    \"library_build_type\": \"release\"" << endl;
+  #endif
+  out << "  }," << endl;
+  out << "  \"benchmarks\": [" << endl;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& r = results[i];
+    out << "    {" << endl;
+    out << "      \"name\": \"" << EscapeJSON(r.name) << "\"," << endl;
+    out << "      \"run_name\": \"" << EscapeJSON(r.name) << "\"," << endl;
+    out << "      \"run_type\": \"iteration\"," << endl;
+    out << "      \"iterations\": " << r.iterations << "," << endl;
+    out << "      \"real_time\": " << r.realTime << "," << endl;
+    out << "      \"cpu_time\": " << r.cpuTime << "," << endl;
+    out << "      \"time_unit\": \"ns\"";
+    if (r.itemsPerSecond > 0)
+      out << "," << endl << "      \"items_per_second\": " << r.itemsPerSecond;
+    if (r.bytesPerSecond > 0)
+      out << "," << endl << "      \"bytes_per_second\": " << r.bytesPerSecond;
+    out << endl << "    }" << ((i + 1 < results.size()) ? "," : "") << endl;
+  }
+  out << "  ]" << endl;
+  out << "}" << endl;
+}
+
+} // namespace
+
+State::State(const vector<size_t>& args, const size_t maxIterations) :
+    args(args),
+    maxIterations(maxIterations),
+    iterations(0),
+    running(false),
+    cpuStart(0),
+    realTime(0.0),
+    cpuTime(0.0),
+    itemsProcessed(0),
+    bytesProcessed(0)
+{
+  // Nothing to do.
+}
+
+void State::PauseTiming()
+{
+  if (!running)
+    return;
+
+  const clock_t cpuEnd = clock();
+  const chrono::steady_clock::time_point realEnd = chrono::steady_clock::now();
+  realTime += chrono::duration<double>(realEnd - realStart).count();
+  cpuTime += double(cpuEnd - cpuStart) / CLOCKS_PER_SEC;
+  running = false;
+}
+
+void State::ResumeTiming()
+{
+  if (running)
+    return;
+
+  running = true;
+  realStart = chrono::steady_clock::now();
+  cpuStart = clock();
+}
+
+size_t benchmark::RegisterBenchmark(const string& name,
+                                    BenchmarkFunction function,
+                                    const vector<vector<size_t>>& argSets)
+{
+  Benchmark b;
+  b.name = name;
+  b.function = function;
+  b.argSets = argSets;
+  if (b.argSets.empty())
+    b.argSets.push_back(vector<size_t>());
+
+  Benchmarks().push_back(b);
+  return Benchmarks().size() - 1;
+}
+
+int benchmark::RunBenchmarks(int argc, char** argv)
+{
+  string filter = ".";
+  double minTime = 0.5;
+  string outFile;
+  string format = "console";
+  bool listTests = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    const string arg = argv[i];
+    const size_t equals = arg.find('=');
+    const string option = arg.substr(0, equals);
+    const string value = (equals == string::npos) ? "" :
+        arg.substr(equals + 1);
+
+    if (option == "--benchmark_filter")
+      filter = value;
+    else if (option == "--benchmark_min_time")
+      minTime = atof(value.c_str());
+    else if (option == "--benchmark_out")
+      outFile = value;
+    else if (option == "--benchmark_format" &&
+        (value == "console" || value == "json"))
+      format = value;
+    else if (option == "--benchmark_list_tests")
+      listTests = true;
+    else
+    {
+      cerr << "Unknown option '" << arg << "'.  The options are "
+          << "--benchmark_filter=<regex>, --benchmark_min_time=<seconds>, "
+          << "--benchmark_out=<file>, --benchmark_format=<console|json>, and "
+          << "--benchmark_list_tests." << endl;
+      return 1;
+    }
+  }
+
+  const regex filterRegex(filter);
+  vector<Result> results;
+  if (format == "console" && !listTests)
+  {
+    cout << left << setw(50) << "Benchmark" << right << setw(15) << "Time"
+        << setw(15) << "CPU" << setw(12) << "Iterations" << endl;
+    cout << string(92, '-') << endl;
+  }
+
+  for (const Benchmark& b : Benchmarks())
+  {
+    for (const vector<size_t>& args : b.argSets)
+    {
+      const string name = RunName(b.name, args);
+      if (!regex_search(name, filterRegex))
+        continue;
+
+      if (listTests)
+      {
+        cout << name << endl;
+        continue;
+      }
+
+      results.push_back(Run(b, args, minTime));
+      if (format == "console")
+      {
+        const Result& r = results.back();
+        cout << left << setw(50) << r.name << right << setw(12) << fixed
+            << setprecision(0) << r.realTime << " ns" << setw(12) << r.cpuTime
+            << " ns" << setw(12) << r.iterations << endl;
+      }
+    }
+  }
+
+  if (listTests)
+    return 0;
+
+  if (format == "json")
+    WriteJSON(cout, results, argv[0]);
+
+  if (!outFile.empty())
+  {
+    ofstream out(outFile.c_str());
+    if (!out.is_open())
+    {
+      cerr << "Cannot open '" << outFile << "' for writing." << endl;
+      return 1;
+    }
+
+    WriteJSON(out, results, argv[0]);
+  }
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  return RunBenchmarks(argc, argv);
+}
@@ -0,0 +1,182 @@
+/**
+ * @file benchmarks/benchmark.hpp
+ *
+ * A small microbenchmark harness for mlpack_benchmarks, with the interface and
+ * the JSON output format of Google Benchmark, so that results can be tracked
+ * over time with the usual tools (e.g. compare.py).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+#include <ctime>
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * The State of a benchmark run is given to the benchmark function, which
+ * repeats the measured code while KeepRunning() returns true:
+ *
+ * @code
+ * void KDTreeBuild(benchmark::State& state)
+ * {
+ *   arma::mat data = arma::randu<arma::mat>(3, state.Arg(0));
+ *   while (state.KeepRunning())
+ *   {
+ *     KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(data);
+ *   }
+ *   state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+ * }
+ * MLPACK_BENCHMARK(KDTreeBuild, { 1000 }, { 10000 });
+ * @endcode
+ *
+ * Setup done before the loop is not measured; setup inside the loop can be
+ * excluded with PauseTiming() and ResumeTiming().
+ */
+class State
+{
+ public:
+  /**
+   * Create the state of a run with the given arguments and number of
+   * iterations.
+   */
+  State(const std::vector<size_t>& args, const size_t maxIterations);
+
+  /**
+   * Return true if another iteration should be run.  The first call starts
+   * the timers and the last one stops them.
+   */
+  bool KeepRunning()
+  {
+    if (iterations == 0)
+      ResumeTiming();
+    else if (iterations == maxIterations)
+    {
+      PauseTiming();
+      return false;
+    }
+
+    ++iterations;
+    return true;
+  }
+
+  //! Stop the timers, to exclude setup from the measurement.
+  void PauseTiming();
+  //! Restart the timers.
+  void ResumeTiming();
+
+  //! Get the i'th argument of the run.
+  size_t Arg(const size_t i) const { return args.at(i); }
+
+  //! Get the number of iterations that have been started.
+  size_t Iterations() const { return iterations; }
+
+  //! Set the number of items processed by all iterations (for a throughput).
+  void SetItemsProcessed(const size_t items) { itemsProcessed = items; }
+  //! Set the number of bytes processed by all iterations (for a throughput).
+  void SetBytesProcessed(const size_t bytes) { bytesProcessed = bytes; }
+
+  //! Get the measured wall clock time, in seconds.
+  double RealTime() const { return realTime; }
+  //! Get the measured processor time, in seconds.
+  double CPUTime() const { return cpuTime; }
+  //! Get the number of items processed.
+  size_t ItemsProcessed() const { return itemsProcessed; }
+  //! Get the number of bytes processed.
+  size_t BytesProcessed() const { return bytesProcessed; }
+
+ private:
+  //! The arguments of the run.
+  std::vector<size_t> args;
+  //! The number of iterations to run.
+  size_t maxIterations;
+  //! The number of iterations started.
+  size_t iterations;
+  //! True if the timers are running.
+  bool running;
+  //! The time the timers were (re)started.
+  std::chrono::steady_clock::time_point realStart;
+  //! The processor time the timers were (re)started.
+  std::clock_t cpuStart;
+  //! The accumulated wall clock time.
+  double realTime;
+  //! The accumulated processor time.
+  double cpuTime;
+  //! The number of items processed.
+  size_t itemsProcessed;
+  //! The number of bytes processed.
+  size_t bytesProcessed;
+};
+
+//! The type of the benchmark functions.
+typedef void (*BenchmarkFunction)(State&);
+
+/**
+ * Register a benchmark, to be run once for each of the given argument lists
+ * (or once without arguments, if there are none), and return its index.  This
+ * is called by MLPACK_BENCHMARK().
+ *
+ * @param name Name of the benchmark.
+ * @param function Benchmark function.
+ * @param argSets Argument lists to run the benchmark with.
+ */
+size_t RegisterBenchmark(const std::string& name,
+                         BenchmarkFunction function,
+                         const std::vector<std::vector<size_t>>& argSets);
+
+/**
+ * Run the registered benchmarks, as selected by the command-line options, and
+ * return the exit code of the program.  The options are the ones of Google
+ * Benchmark:
+ *
+ *  - --benchmark_filter=<regex>: only run the benchmarks whose name (with the
+ *    arguments, as in "KDTreeBuild/1000") matches.
+ *  - --benchmark_min_time=<seconds>: the minimum time of each run (default
+ *    0.5).
+ *  - --benchmark_out=<file>: also write the results as JSON to the file.
+ *  - --benchmark_format=<console|json>: the format of the results that are
+ *    printed.
+ *  - --benchmark_list_tests: only print the names of the benchmarks.
+ */
+int RunBenchmarks(int argc, char** argv);
+
+/**
+ * Prevent the compiler from optimizing away the computation of the given
+ * value.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+  // A compiler barrier that pretends to read the value.
+  #if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+  #else
+  static volatile const void* sink;
+  sink = &value;
+  #endif
+}
+
+} // namespace benchmark
+} // namespace mlpack
+
+#define MLPACK_BENCHMARK_JOIN_INNER(X, Y) X##Y
+#define MLPACK_BENCHMARK_JOIN(X, Y) MLPACK_BENCHMARK_JOIN_INNER(X, Y)
+
+/**
+ * Register the given benchmark function, with the given argument lists, as in
+ * MLPACK_BENCHMARK(KNNSearch, { 1000, 1 }, { 10000, 5 }).
+ */
+#define MLPACK_BENCHMARK(FUNCTION, ...) \
+    static const size_t MLPACK_BENCHMARK_JOIN(mlpackBenchmark, __LINE__) = \
+        mlpack::benchmark::RegisterBenchmark(#FUNCTION, FUNCTION, \
+            std::vector<std::vector<size_t>>({ __VA_ARGS__ }))
+
+#endif
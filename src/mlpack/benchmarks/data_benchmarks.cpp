@@ -0,0 +1,128 @@
+/**
+ * @file benchmarks/data_benchmarks.cpp
+ *
+ * Benchmarks for loading and saving datasets, and for the serialization of
+ * models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "benchmark.hpp"
+
+#include <fstream>
+#include <sstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::neighbor;
+using namespace mlpack::tree;
+
+//! Get the size of the given file, in bytes.
+size_t FileSize(const std::string& filename)
+{
+  std::ifstream f(filename.c_str(), std::ios::binary | std::ios::ate);
+  return (size_t) f.tellg();
+}
+
+/**
+ * Load a random dataset from a file of the given type (with the given
+ * extension); the arguments are the number of points and the dimensionality.
+ */
+void LoadFile(State& state, const std::string& extension)
+{
+  math::RandomSeed(42);
+  const std::string filename = "benchmark_load." + extension;
+  data::Save(filename, arma::randu<arma::mat>(state.Arg(1), state.Arg(0)),
+      true);
+
+  arma::mat data;
+  while (state.KeepRunning())
+  {
+    data::Load(filename, data, true);
+    DoNotOptimize(data);
+  }
+  state.SetBytesProcessed(state.Iterations() * FileSize(filename));
+  remove(filename.c_str());
+}
+
+void LoadCSV(State& state) { LoadFile(state, "csv"); }
+
+void LoadArmaBinary(State& state) { LoadFile(state, "bin"); }
+
+/**
+ * Save a random dataset as CSV; the arguments are the number of points and the
+ * dimensionality.
+ */
+void SaveCSV(State& state)
+{
+  math::RandomSeed(42);
+  const std::string filename = "benchmark_save.csv";
+  const arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  while (state.KeepRunning())
+    data::Save(filename, data, true);
+
+  state.SetBytesProcessed(state.Iterations() * FileSize(filename));
+  remove(filename.c_str());
+}
+
+/**
+ * Save the given model to a binary archive in memory and load it back.
+ */
+template<typename ModelType>
+void Serialize(State& state, ModelType& model)
+{
+  size_t bytes = 0;
+  while (state.KeepRunning())
+  {
+    std::stringstream stream;
+    {
+      cereal::BinaryOutputArchive ar(stream);
+      ar(cereal::make_nvp("model", model));
+    }
+    bytes += stream.str().size();
+
+    ModelType newModel;
+    {
+      cereal::BinaryInputArchive ar(stream);
+      ar(cereal::make_nvp("model", newModel));
+    }
+    DoNotOptimize(newModel);
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+/**
+ * Serialize a kNN model (with its kd-tree); the arguments are the number of
+ * points and the dimensionality.
+ */
+void SerializeKNN(State& state)
+{
+  math::RandomSeed(42);
+  KNN knn(arma::randu<arma::mat>(state.Arg(1), state.Arg(0)));
+  Serialize(state, knn);
+}
+
+/**
+ * Serialize a decision tree; the arguments are the number of points and the
+ * dimensionality of the training set.
+ */
+void SerializeDecisionTree(State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  const arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      data.row(0) > 0.5);
+  DecisionTree<> tree(data, labels, 2, 1);
+  Serialize(state, tree);
+}
+
+MLPACK_BENCHMARK(LoadCSV, { 10000, 10 }, { 100000, 10 });
+MLPACK_BENCHMARK(LoadArmaBinary, { 10000, 10 }, { 100000, 10 });
+MLPACK_BENCHMARK(SaveCSV, { 10000, 10 }, { 100000, 10 });
+MLPACK_BENCHMARK(SerializeKNN, { 10000, 3 }, { 100000, 3 });
+MLPACK_BENCHMARK(SerializeDecisionTree, { 10000, 10 });
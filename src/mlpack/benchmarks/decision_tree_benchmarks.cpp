@@ -0,0 +1,112 @@
+/**
+ * @file benchmarks/decision_tree_benchmarks.cpp
+ *
+ * Benchmarks for the training and the classification of decision trees and
+ * random forests.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::tree;
+
+/**
+ * Create a classification dataset with the given number of points and
+ * dimensions, where the label of each point depends on its first dimensions, so
+ * that the trees have some structure to learn.
+ */
+void ClassificationData(const size_t points,
+                        const size_t dimensions,
+                        arma::mat& data,
+                        arma::Row<size_t>& labels)
+{
+  math::RandomSeed(42);
+  data = arma::randu<arma::mat>(dimensions, points);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = (data(0, i) + data(1 % dimensions, i) > 1.0) ? 1 : 0;
+    // Flip some labels, so that the trees do not stop early.
+    if (math::Random() < 0.1)
+      labels[i] = 1 - labels[i];
+  }
+}
+
+/**
+ * The arguments of all benchmarks are the number of points and the number of
+ * dimensions; the random forests have 10 trees.
+ */
+void DecisionTreeTrain(State& state)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(state.Arg(0), state.Arg(1), data, labels);
+
+  DecisionTree<> tree;
+  while (state.KeepRunning())
+  {
+    tree.Train(data, labels, 2);
+    DoNotOptimize(tree.NumChildren());
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+void DecisionTreeClassify(State& state)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(state.Arg(0), state.Arg(1), data, labels);
+  DecisionTree<> tree(data, labels, 2);
+
+  arma::Row<size_t> predictions;
+  while (state.KeepRunning())
+  {
+    tree.Classify(data, predictions);
+    DoNotOptimize(predictions);
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+void RandomForestTrain(State& state)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(state.Arg(0), state.Arg(1), data, labels);
+
+  RandomForest<> forest;
+  while (state.KeepRunning())
+  {
+    forest.Train(data, labels, 2, 10);
+    DoNotOptimize(forest.NumTrees());
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+void RandomForestClassify(State& state)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(state.Arg(0), state.Arg(1), data, labels);
+  RandomForest<> forest(data, labels, 2, 10);
+
+  arma::Row<size_t> predictions;
+  while (state.KeepRunning())
+  {
+    forest.Classify(data, predictions);
+    DoNotOptimize(predictions);
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+MLPACK_BENCHMARK(DecisionTreeTrain, { 10000, 10 }, { 100000, 10 });
+MLPACK_BENCHMARK(DecisionTreeClassify, { 10000, 10 }, { 100000, 10 });
+MLPACK_BENCHMARK(RandomForestTrain, { 10000, 10 });
+MLPACK_BENCHMARK(RandomForestClassify, { 10000, 10 });
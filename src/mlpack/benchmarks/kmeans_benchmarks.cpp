@@ -0,0 +1,74 @@
+/**
+ * @file benchmarks/kmeans_benchmarks.cpp
+ *
+ * Benchmarks for the Lloyd iteration strategies of k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::kmeans;
+using namespace mlpack::metric;
+
+/**
+ * Run at most 10 Lloyd iterations with the given strategy, from the same
+ * initial centroids; the arguments are the number of points, the
+ * dimensionality and the number of clusters.
+ */
+template<template<class, class> class LloydStepType>
+void KMeansCluster(State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  const arma::mat initialCentroids = data.cols(0, state.Arg(2) - 1);
+
+  // Limiting the number of iterations keeps each run short.
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(10);
+
+  arma::mat centroids;
+  while (state.KeepRunning())
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(data, state.Arg(2), centroids, true);
+    DoNotOptimize(centroids);
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+void NaiveKMeansCluster(State& state) { KMeansCluster<NaiveKMeans>(state); }
+
+void ElkanKMeansCluster(State& state) { KMeansCluster<ElkanKMeans>(state); }
+
+void HamerlyKMeansCluster(State& state)
+{
+  KMeansCluster<HamerlyKMeans>(state);
+}
+
+void PellegMooreKMeansCluster(State& state)
+{
+  KMeansCluster<PellegMooreKMeans>(state);
+}
+
+void DualTreeKMeansCluster(State& state)
+{
+  KMeansCluster<DefaultDualTreeKMeans>(state);
+}
+
+MLPACK_BENCHMARK(NaiveKMeansCluster, { 10000, 5, 10 }, { 10000, 5, 100 });
+MLPACK_BENCHMARK(ElkanKMeansCluster, { 10000, 5, 10 }, { 10000, 5, 100 });
+MLPACK_BENCHMARK(HamerlyKMeansCluster, { 10000, 5, 10 }, { 10000, 5, 100 });
+MLPACK_BENCHMARK(PellegMooreKMeansCluster, { 10000, 5, 10 },
+    { 10000, 5, 100 });
+MLPACK_BENCHMARK(DualTreeKMeansCluster, { 10000, 5, 10 }, { 10000, 5, 100 });
@@ -0,0 +1,131 @@
+/**
+ * @file benchmarks/search_benchmarks.cpp
+ *
+ * Benchmarks for the tree-based search algorithms: nearest neighbor search,
+ * range search and kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::metric;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+using namespace mlpack::tree;
+
+/**
+ * Find the k nearest neighbors of all the points, with the given tree type and
+ * search mode; the arguments are the number of points, the dimensionality and
+ * k.  The trees are built outside of the measurement.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KNNSearch(State& state, const NeighborSearchMode mode)
+{
+  math::RandomSeed(42);
+  arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn(std::move(data), mode);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  while (state.KeepRunning())
+  {
+    knn.Search(state.Arg(2), neighbors, distances);
+    DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+void KNNDualTreeKD(State& state) { KNNSearch<KDTree>(state, DUAL_TREE_MODE); }
+
+void KNNSingleTreeKD(State& state)
+{
+  KNNSearch<KDTree>(state, SINGLE_TREE_MODE);
+}
+
+void KNNDualTreeBall(State& state)
+{
+  KNNSearch<BallTree>(state, DUAL_TREE_MODE);
+}
+
+void KNNDualTreeCover(State& state)
+{
+  KNNSearch<StandardCoverTree>(state, DUAL_TREE_MODE);
+}
+
+void KNNNaive(State& state) { KNNSearch<KDTree>(state, NAIVE_MODE); }
+
+/**
+ * Find the points within a range of all the points; the arguments are the
+ * number of points, the dimensionality, and the upper bound of the range in
+ * thousandths.
+ */
+void RangeSearchDualTree(State& state)
+{
+  math::RandomSeed(42);
+  arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  RangeSearch<> rs(std::move(data));
+
+  const math::Range range(0.0, state.Arg(2) / 1000.0);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  while (state.KeepRunning())
+  {
+    rs.Search(range, neighbors, distances);
+    DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+/**
+ * Estimate the density at all the points with a Gaussian kernel, with the given
+ * tree type; the arguments are the number of points, the dimensionality, and
+ * the bandwidth in thousandths.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDEDualTree(State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, TreeType> kde(0.05, 0.0,
+      GaussianKernel(state.Arg(2) / 1000.0));
+  kde.Train(data);
+
+  arma::vec estimations;
+  while (state.KeepRunning())
+  {
+    kde.Evaluate(data, estimations);
+    DoNotOptimize(estimations);
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+void KDEDualTreeKD(State& state) { KDEDualTree<KDTree>(state); }
+
+void KDEDualTreeBall(State& state) { KDEDualTree<BallTree>(state); }
+
+MLPACK_BENCHMARK(KNNDualTreeKD, { 10000, 3, 5 }, { 100000, 3, 5 },
+    { 10000, 10, 5 }, { 10000, 3, 50 });
+MLPACK_BENCHMARK(KNNSingleTreeKD, { 10000, 3, 5 }, { 10000, 10, 5 });
+MLPACK_BENCHMARK(KNNDualTreeBall, { 10000, 3, 5 }, { 10000, 10, 5 });
+MLPACK_BENCHMARK(KNNDualTreeCover, { 10000, 3, 5 }, { 10000, 10, 5 });
+MLPACK_BENCHMARK(KNNNaive, { 2000, 3, 5 });
+MLPACK_BENCHMARK(RangeSearchDualTree, { 10000, 3, 50 }, { 100000, 3, 20 });
+MLPACK_BENCHMARK(KDEDualTreeKD, { 10000, 3, 100 }, { 10000, 10, 500 });
+MLPACK_BENCHMARK(KDEDualTreeBall, { 10000, 3, 100 });
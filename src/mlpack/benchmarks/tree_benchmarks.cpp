@@ -0,0 +1,79 @@
+/**
+ * @file benchmarks/tree_benchmarks.cpp
+ *
+ * Benchmarks for the construction of the trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+/**
+ * Build a tree of the given type on uniform random points; the arguments are
+ * the number of points, the dimensionality and the leaf size.
+ */
+template<typename TreeType>
+void TreeBuild(State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  while (state.KeepRunning())
+  {
+    TreeType tree(data, state.Arg(2));
+    DoNotOptimize(tree.NumDescendants());
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+void KDTreeBuild(State& state)
+{
+  TreeBuild<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>(state);
+}
+
+void BallTreeBuild(State& state)
+{
+  TreeBuild<BallTree<EuclideanDistance, EmptyStatistic, arma::mat>>(state);
+}
+
+void VPTreeBuild(State& state)
+{
+  TreeBuild<VPTree<EuclideanDistance, EmptyStatistic, arma::mat>>(state);
+}
+
+void RTreeBuild(State& state)
+{
+  TreeBuild<RTree<EuclideanDistance, EmptyStatistic, arma::mat>>(state);
+}
+
+//! Cover trees have no leaf size, so the third argument is the base.
+void CoverTreeBuild(State& state)
+{
+  math::RandomSeed(42);
+  const arma::mat data = arma::randu<arma::mat>(state.Arg(1), state.Arg(0));
+  while (state.KeepRunning())
+  {
+    StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(data,
+        (double) state.Arg(2));
+    DoNotOptimize(tree.NumDescendants());
+  }
+  state.SetItemsProcessed(state.Iterations() * state.Arg(0));
+}
+
+MLPACK_BENCHMARK(KDTreeBuild, { 10000, 3, 20 }, { 100000, 3, 20 },
+    { 100000, 10, 20 }, { 100000, 3, 1 });
+MLPACK_BENCHMARK(BallTreeBuild, { 10000, 3, 20 }, { 100000, 10, 20 });
+MLPACK_BENCHMARK(VPTreeBuild, { 10000, 3, 20 }, { 100000, 10, 20 });
+MLPACK_BENCHMARK(RTreeBuild, { 10000, 3, 20 }, { 100000, 3, 20 });
+MLPACK_BENCHMARK(CoverTreeBuild, { 10000, 3, 2 }, { 100000, 3, 2 },
+    { 10000, 10, 2 });
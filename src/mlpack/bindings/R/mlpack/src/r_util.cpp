@@ -16,20 +16,81 @@
 using namespace mlpack;
 using namespace Rcpp;
 
-template<typename eT>
-bool inline inplace_transpose(arma::Mat<eT>& X)
-{
-  try
-  {
-    X = arma::trans(X);
-    return false;
-  }
-  catch (std::bad_alloc&)
+// R matrices are column-major, like Armadillo matrices, but they hold one point
+// per row, so matrices have to be transposed on the way in and on the way out;
+// vectors can be copied as they are.  R owns the memory of its objects and can
+// neither give it away nor adopt memory allocated by Armadillo, so one copy is
+// needed in each direction; the functions below make sure that it is the only
+// one, by transposing and converting the elements in the same pass, directly
+// between the memory of the R object and the memory of the Armadillo object.
+
+// Copy the elements of the given R matrix or vector to out (which has the
+// right size already), transposing them if needed and subtracting the given
+// offset.
+template<typename RType, typename MatType>
+inline void CopyFromR(const RType* mem,
+                      const size_t rows,
+                      const size_t cols,
+                      const bool transpose,
+                      const typename MatType::elem_type offset,
+                      MatType& out)
+{
+  typedef typename MatType::elem_type eT;
+  eT* outMem = out.memptr();
+  for (size_t c = 0; c < cols; ++c)
   {
-    return true;
+    for (size_t r = 0; r < rows; ++r)
+    {
+      const eT value = eT(mem[c * rows + r]) - offset;
+      outMem[transpose ? (r * cols + c) : (c * rows + r)] = value;
+    }
   }
 }
 
+// Convert the given R matrix or vector (numeric, integer or logical) to an
+// Armadillo object, transposing it if needed and subtracting the given offset.
+template<typename MatType>
+inline void FromR(SEXP x,
+                  const bool transpose,
+                  const typename MatType::elem_type offset,
+                  MatType& out)
+{
+  const size_t rows = Rf_nrows(x);
+  const size_t cols = Rf_ncols(x);
+  if (MatType::is_row)
+    out.set_size(1, rows * cols);
+  else if (MatType::is_col)
+    out.set_size(rows * cols, 1);
+  else if (transpose)
+    out.set_size(cols, rows);
+  else
+    out.set_size(rows, cols);
+
+  if (TYPEOF(x) == INTSXP)
+    CopyFromR(INTEGER(x), rows, cols, transpose, offset, out);
+  else if (TYPEOF(x) == LGLSXP)
+    CopyFromR(LOGICAL(x), rows, cols, transpose, offset, out);
+  else if (TYPEOF(x) == REALSXP)
+    CopyFromR(REAL(x), rows, cols, transpose, offset, out);
+  else
+    Rcpp::stop("Input must be a numeric, integer or logical matrix or vector!");
+}
+
+// Copy the transpose of the given Armadillo object to a new R numeric matrix,
+// adding the given offset, and then free the Armadillo object.
+template<typename MatType>
+inline Rcpp::NumericMatrix ToR(MatType& m, const double offset)
+{
+  Rcpp::NumericMatrix result(m.n_cols, m.n_rows);
+  double* outMem = result.begin();
+  for (size_t c = 0; c < m.n_cols; ++c)
+    for (size_t r = 0; r < m.n_rows; ++r)
+      outMem[r * m.n_cols + c] = double(m(r, c)) + offset;
+
+  m.reset();
+  return result;
+}
+
 // Create a new util::Params object.
 // [[Rcpp::export]]
 SEXP CreateParams(const std::string& bindingName)
@@ -114,10 +175,10 @@ void SetParamVecInt(SEXP params,
 // [[Rcpp::export]]
 void SetParamMat(SEXP params,
                     const std::string& paramName,
-                    const arma::mat& paramValue)
+                    SEXP paramValue)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::mat>(paramName) = paramValue.t();
+  FromR(paramValue, true, 0.0, p.Get<arma::mat>(paramName));
   p.SetPassed(paramName);
 }
 
@@ -125,10 +186,10 @@ void SetParamMat(SEXP params,
 // [[Rcpp::export]]
 void SetParamUMat(SEXP params,
                      const std::string& paramName,
-                     const arma::Mat<size_t>& paramValue)
+                     SEXP paramValue)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::Mat<size_t>>(paramName) = paramValue.t();
+  FromR(paramValue, true, size_t(0), p.Get<arma::Mat<size_t>>(paramName));
   p.SetPassed(paramName);
 }
 
@@ -136,10 +197,10 @@ void SetParamUMat(SEXP params,
 // [[Rcpp::export]]
 void SetParamRow(SEXP params,
                     const std::string& paramName,
-                    const arma::rowvec& paramValue)
+                    SEXP paramValue)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::rowvec>(paramName) = std::move(paramValue);
+  FromR(paramValue, false, 0.0, p.Get<arma::rowvec>(paramName));
   p.SetPassed(paramName);
 }
 
@@ -147,10 +208,10 @@ void SetParamRow(SEXP params,
 // [[Rcpp::export]]
 void SetParamURow(SEXP params,
                      const std::string& paramName,
-                     const arma::Row<size_t>& paramValue)
+                     SEXP paramValue)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::Row<size_t>>(paramName) = paramValue - 1;
+  FromR(paramValue, false, size_t(1), p.Get<arma::Row<size_t>>(paramName));
   p.SetPassed(paramName);
 }
 
@@ -158,10 +219,10 @@ void SetParamURow(SEXP params,
 // [[Rcpp::export]]
 void SetParamCol(SEXP params,
                     const std::string& paramName,
-                    const arma::vec& paramValue)
+                    SEXP paramValue)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::vec>(paramName) = std::move(paramValue);
+  FromR(paramValue, false, 0.0, p.Get<arma::vec>(paramName));
   p.SetPassed(paramName);
 }
 
@@ -169,10 +230,10 @@ void SetParamCol(SEXP params,
 // [[Rcpp::export]]
 void SetParamUCol(SEXP params,
                      const std::string& paramName,
-                     const arma::Col<size_t>& paramValue)
+                     SEXP paramValue)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::Col<size_t>>(paramName) = paramValue - 1;
+  FromR(paramValue, false, size_t(1), p.Get<arma::Col<size_t>>(paramName));
   p.SetPassed(paramName);
 }
 
@@ -182,10 +243,10 @@ void SetParamUCol(SEXP params,
 void SetParamMatWithInfo(SEXP params,
                             const std::string& paramName,
                             const LogicalVector& dimensions,
-                            const arma::mat& paramValue)
+                            SEXP paramValue)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  data::DatasetInfo d(paramValue.n_cols);
+  data::DatasetInfo d(Rf_ncols(paramValue));
   for (size_t i = 0; i < d.Dimensionality(); ++i)
   {
     d.Type(i) = (dimensions[i]) ? data::Datatype::categorical :
@@ -193,8 +254,8 @@ void SetParamMatWithInfo(SEXP params,
   }
   std::get<0>(p.Get<std::tuple<data::DatasetInfo, arma::mat>>(
       paramName)) = std::move(d);
-  std::get<1>(p.Get<std::tuple<data::DatasetInfo, arma::mat>>(
-      paramName)) = paramValue.t();
+  FromR(paramValue, true, 0.0,
+      std::get<1>(p.Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName)));
   p.SetPassed(paramName);
 }
 
@@ -251,55 +312,53 @@ const std::vector<int>& GetParamVecInt(SEXP params,
 
 // Call p.Get<arma::mat>().
 // [[Rcpp::export]]
-const arma::mat& GetParamMat(SEXP params, const std::string& paramName)
+Rcpp::NumericMatrix GetParamMat(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  inplace_transpose(p.Get<arma::mat>(paramName));
-  return std::move(p.Get<arma::mat>(paramName));
+  return ToR(p.Get<arma::mat>(paramName), 0.0);
 }
 
 // Call p.Get<arma::Mat<size_t>>().
 // [[Rcpp::export]]
-const arma::Mat<size_t>& GetParamUMat(SEXP params,
-                                      const std::string& paramName)
+Rcpp::NumericMatrix GetParamUMat(SEXP params,
+                                 const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  inplace_transpose(p.Get<arma::Mat<size_t>>(paramName));
-  return std::move(p.Get<arma::Mat<size_t>>(paramName));
+  return ToR(p.Get<arma::Mat<size_t>>(paramName), 0.0);
 }
 
 // Call p.Get<arma::rowvec>().
 // [[Rcpp::export]]
-const arma::vec GetParamRow(SEXP params, const std::string& paramName)
+Rcpp::NumericMatrix GetParamRow(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::rowvec>(paramName).t();
+  return ToR(p.Get<arma::rowvec>(paramName), 0.0);
 }
 
 // Call p.Get<arma::Row<size_t>>().
 // [[Rcpp::export]]
-const arma::Col<size_t> GetParamURow(SEXP params,
-                                     const std::string& paramName)
+Rcpp::NumericMatrix GetParamURow(SEXP params,
+                                 const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::Row<size_t>>(paramName).t() + 1;
+  return ToR(p.Get<arma::Row<size_t>>(paramName), 1.0);
 }
 
 // Call p.Get<arma::vec>().
 // [[Rcpp::export]]
-const arma::rowvec GetParamCol(SEXP params, const std::string& paramName)
+Rcpp::NumericMatrix GetParamCol(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::vec>(paramName).t();
+  return ToR(p.Get<arma::vec>(paramName), 0.0);
 }
 
 // Call p.Get<arma::Col<size_t>>().
 // [[Rcpp::export]]
-const arma::Row<size_t> GetParamUCol(SEXP params,
-                                     const std::string& paramName)
+Rcpp::NumericMatrix GetParamUCol(SEXP params,
+                                 const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::Col<size_t>>(paramName).t() + 1;
+  return ToR(p.Get<arma::Col<size_t>>(paramName), 1.0);
 }
 
 // Call p.Get<std::tuple<data::DatasetInfo, arma::mat>>().
@@ -309,8 +368,8 @@ List IO_GetParamMatWithInfo(SEXP params, const std::string& paramName)
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
   const data::DatasetInfo& d = std::get<0>(
       p.Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName));
-  const arma::mat& m = std::get<1>(
-      p.Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName)).t();
+  Rcpp::NumericMatrix m = ToR(std::get<1>(
+      p.Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName)), 0.0);
 
   LogicalVector dims(d.Dimensionality());
   for (size_t i = 0; i < d.Dimensionality(); ++i)
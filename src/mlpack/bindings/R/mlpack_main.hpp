@@ -81,5 +81,8 @@ using Option = mlpack::bindings::r::ROption<T>;
 // Add default parameters that are included in every program.
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_INT_IN("num_threads", "Number of threads to use for the parallel parts "
+    "of the method (with OpenMP), and for the BLAS library if it is OpenBLAS "
+    "or MKL; 0 uses the default number of threads.", "", 0);
 
 #endif
@@ -14,20 +14,68 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/io.hpp>
+#include <unordered_set>
 
 namespace mlpack {
 namespace bindings {
 namespace cli {
 
+/**
+ * Delete all of the memory held by the parameters, except the memory in the
+ * given set (which is owned by someone else).  We may hold the same pointer
+ * twice, so we have to be careful to not delete it multiple times.
+ */
+inline void CleanMemory(
+    util::Params& params,
+    const std::unordered_set<void*>& sharedMemory =
+        std::unordered_set<void*>())
+{
+  std::map<std::string, util::ParamData>& parameters = params.Parameters();
+  std::unordered_map<void*, util::ParamData*> memoryAddresses;
+  for (auto& it : parameters)
+  {
+    util::ParamData& data = it.second;
+
+    void* result;
+    params.functionMap[data.tname]["GetAllocatedMemory"](data, NULL,
+        (void*) &result);
+    if (result != NULL && memoryAddresses.count(result) == 0 &&
+        sharedMemory.count(result) == 0)
+    {
+      memoryAddresses[result] = &data;
+    }
+  }
+
+  // Now we have all the unique addresses that need to be deleted.
+  std::unordered_map<void*, util::ParamData*>::const_iterator it2;
+  it2 = memoryAddresses.begin();
+  while (it2 != memoryAddresses.end())
+  {
+    util::ParamData& data = *(it2->second);
+
+    params.functionMap[data.tname]["DeleteAllocatedMemory"](data, NULL, NULL);
+
+    ++it2;
+  }
+}
+
 /**
  * Handle command-line program termination.  If --help or --info was passed, we
  * won't make it here, so we don't have to write any contingencies for that.
+ * Any memory in sharedMemory is not deleted.
  */
-inline void EndProgram(util::Params& params, util::Timers& timers)
+inline void EndProgram(
+    util::Params& params,
+    util::Timers& timers,
+    const std::unordered_set<void*>& sharedMemory =
+        std::unordered_set<void*>())
 {
   // Stop the timers.
   timers.StopAllTimers();
 
+  // Write the queued log messages before the output.
+  Log::SetAsynchronous(false);
+
   // Print any output.
   std::map<std::string, util::ParamData>& parameters = params.Parameters();
   for (auto& it : parameters)
@@ -77,34 +125,27 @@ inline void EndProgram(util::Params& params, util::Timers& timers)
     {
       Log::Info << "  " << it2.first << ": " << timers.Print(it2.second);
     }
-  }
 
-  // Lastly clean up any memory.  If we are holding any pointers, then we "own"
-  // them.  But we may hold the same pointer twice, so we have to be careful to
-  // not delete it multiple times.
-  std::unordered_map<void*, util::ParamData*> memoryAddresses;
-  for (auto& it : parameters)
-  {
-    util::ParamData& data = it.second;
+    // The profiled scopes are only measured if mlpack was compiled with
+    // ENABLE_PROFILING.
+    if (!util::Profiler::Empty())
+    {
+      Log::Info << "Profiled scopes (JSON):" << std::endl
+          << util::Profiler::ToJSON() << std::endl;
+    }
 
-    void* result;
-    params.functionMap[data.tname]["GetAllocatedMemory"](data, NULL,
-        (void*) &result);
-    if (result != NULL && memoryAddresses.count(result) == 0)
-      memoryAddresses[result] = &data;
+    // The memory phases are only recorded if mlpack was compiled with
+    // ENABLE_MEMORY_TRACKING.
+    if (!util::MemoryTracker::Empty())
+    {
+      Log::Info << "Memory phases (JSON):" << std::endl
+          << util::MemoryTracker::ToJSON() << std::endl;
+    }
   }
 
-  // Now we have all the unique addresses that need to be deleted.
-  std::unordered_map<void*, util::ParamData*>::const_iterator it2;
-  it2 = memoryAddresses.begin();
-  while (it2 != memoryAddresses.end())
-  {
-    util::ParamData& data = *(it2->second);
-
-    params.functionMap[data.tname]["DeleteAllocatedMemory"](data, NULL, NULL);
-
-    ++it2;
-  }
+  // Lastly clean up any memory.  If we are holding any pointers, then we "own"
+  // them.
+  CleanMemory(params, sharedMemory);
 }
 
 } // namespace cli
@@ -73,9 +73,11 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 }
 
 #include <mlpack/core/util/param.hpp>
+#include <mlpack/core/util/threads.hpp>
 #include <mlpack/core/util/timers.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/run_server.hpp>
 
 // Forward definition of the binding function.
 void BINDING_FUNCTION(mlpack::util::Params&, mlpack::util::Timers&);
@@ -90,6 +92,17 @@ int main(int argc, char** argv)
   mlpack::util::Timers timers;
   timers.Enabled() = true;
   mlpack::Timer::EnableTiming();
+  // Use the number of threads given with --num_threads, if any.
+  mlpack::util::SetNumThreads(params);
+
+  // In server mode, the inputs are loaded once, and each line of stdin is a
+  // call of the binding.
+  if (params.Has("server"))
+  {
+    mlpack::bindings::cli::RunServer(params, argc, argv, BINDING_FUNCTION,
+        std::cin, std::cout);
+    return 0;
+  }
 
   // A "total_time" timer is run by default for each mlpack program.
   timers.Start("total_time");
@@ -111,5 +124,13 @@ PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
     false, true, false, false);
 PARAM_GLOBAL(bool, "version", "Display the version of mlpack.", "V", "bool",
     false, true, false, false);
+PARAM_GLOBAL(bool, "server", "If specified, load the given inputs once, and "
+    "then run the program once for each line of standard input, which holds "
+    "the additional options of that run; \"ok\" or \"error: <message>\" is "
+    "printed after each run.", "", "bool", false, true, false, false);
+PARAM_GLOBAL(int, "num_threads", "Number of threads to use for the parallel "
+    "parts of the method (with OpenMP), and for the BLAS library if it is "
+    "OpenBLAS or MKL; 0 uses the default number of threads.", "", "int", false,
+    true, false, 0);
 
 #endif
@@ -127,8 +127,10 @@ mlpack::util::Params ParseCommandLine(
 
   if (params.Has("verbose"))
   {
-    // Give [INFO ] output.
+    // Give [INFO ] output.  It is written on a background thread, so that
+    // informational messages in training loops do not slow the program down.
     Log::Info.ignoreInput = false;
+    Log::SetAsynchronous(true);
   }
 
   // Now, issue an error if we forgot any required options.
@@ -0,0 +1,139 @@
+/**
+ * @file bindings/cli/run_server.hpp
+ *
+ * Run a command-line binding as a long-running server that loads its input
+ * models and matrices once, and then answers requests read from a stream.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_RUN_SERVER_HPP
+#define MLPACK_BINDINGS_CLI_RUN_SERVER_HPP
+
+#include <mlpack/core.hpp>
+#include <unordered_set>
+
+#include "parse_command_line.hpp"
+#include "end_program.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Serve requests for the given binding.  Every input parameter that was given
+ * on the command line (for instance `--input_model_file`) is loaded once, and
+ * kept for all requests.  Then, each line of the input stream is a request,
+ * which holds the options of one call of the binding, separated by whitespace
+ * (for instance `--test_file test.csv --predictions_file predictions.csv`).
+ * The options of the command line are added to the options of each request,
+ * and cannot be given again.  After each request, a line "ok" or
+ * "error: <message>" is written to the output stream.  The server stops at the
+ * end of the input stream, or at a line "quit".
+ *
+ * The loaded models are shared by all requests, so a binding that modifies its
+ * input model will see the modified model in the next request.  Each request
+ * works on its own copy of the loaded matrices.
+ *
+ * @param params Parameters of the command line.
+ * @param argc Number of arguments of the command line.
+ * @param argv Arguments of the command line.
+ * @param binding Function to call for each request.
+ * @param in Stream to read the requests from.
+ * @param out Stream to write the result of each request to.
+ */
+template<typename BindingFunctionType>
+void RunServer(util::Params& params,
+               int argc,
+               char** argv,
+               const BindingFunctionType& binding,
+               std::istream& in,
+               std::ostream& out)
+{
+  // Load every input that was given on the command line, and remember which
+  // memory is owned by the server.
+  std::map<std::string, util::ParamData>& parameters = params.Parameters();
+  std::unordered_set<void*> sharedMemory;
+  for (auto& it : parameters)
+  {
+    util::ParamData& d = it.second;
+    if (!d.input || !d.wasPassed)
+      continue;
+
+    void* value;
+    params.functionMap[d.tname]["GetParam"](d, NULL, (void*) &value);
+    void* memory;
+    params.functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+        (void*) &memory);
+    if (memory != NULL)
+      sharedMemory.insert(memory);
+  }
+
+  std::string line;
+  while (std::getline(in, line))
+  {
+    std::istringstream lineStream(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (lineStream >> token)
+      tokens.push_back(token);
+
+    if (tokens.empty())
+      continue;
+    if (tokens.size() == 1 && tokens[0] == "quit")
+      break;
+
+    std::vector<char*> requestArgv(argv, argv + argc);
+    for (size_t i = 0; i < tokens.size(); ++i)
+      requestArgv.push_back(&tokens[i][0]);
+
+    try
+    {
+      util::Params requestParams = ParseCommandLine((int) requestArgv.size(),
+          requestArgv.data());
+
+      // Use the inputs that were already loaded.
+      for (auto& it : parameters)
+      {
+        const util::ParamData& d = it.second;
+        if (!d.input || !d.wasPassed)
+          continue;
+
+        util::ParamData& requestData = requestParams.Parameters()[it.first];
+        requestData.value = d.value;
+        requestData.loaded = d.loaded;
+      }
+
+      util::Timers timers;
+      timers.Enabled() = true;
+      timers.Start("total_time");
+      try
+      {
+        binding(requestParams, timers);
+      }
+      catch (...)
+      {
+        CleanMemory(requestParams, sharedMemory);
+        throw;
+      }
+      timers.Stop("total_time");
+
+      EndProgram(requestParams, timers, sharedMemory);
+      out << "ok" << std::endl;
+    }
+    catch (std::exception& e)
+    {
+      out << "error: " << e.what() << std::endl;
+    }
+  }
+
+  CleanMemory(params);
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
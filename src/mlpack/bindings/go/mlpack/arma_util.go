@@ -90,12 +90,24 @@ func (m *mlpackArma) allocArmaPtrMatWithInfo(p *params,
   runtime.KeepAlive(m)
 }
 
+// Returns the elements of a Gonum matrix in row-major order (which is the
+// column-major order of the mlpack matrix with one column per row), without
+// copying them, unless the matrix is a view of a part of a larger matrix,
+// whose rows are not contiguous.
+func gonumData(m *mat.Dense) []float64 {
+  r, c := m.Dims()
+  blas64General := m.RawMatrix()
+  if blas64General.Stride == c || r == 1 {
+    return blas64General.Data
+  }
+  return mat.DenseCopyOf(m).RawMatrix().Data
+}
+
 // Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
 func gonumToArmaMat(p *params, identifier string, m *mat.Dense) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Dims()
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := gonumData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -107,8 +119,7 @@ func gonumToArmaMat(p *params, identifier string, m *mat.Dense) {
 func gonumToArmaUmat(p *params, identifier string, m *mat.Dense) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Dims()
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := gonumData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -124,14 +135,13 @@ func gonumToArmaRow(p *params, identifier string, m *mat.Dense) {
     panic("Given matrix must have a single column")
   }
 
-  // Transpose if Column vector is given
+  // A column vector may be given too; its elements are in the same
+  // order, so it does not need to be transposed.
   if e == 1 {
-    m = mat.DenseCopyOf(m.T())
     e = err
   }
 
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := gonumData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -147,14 +157,13 @@ func gonumToArmaUrow(p *params, identifier string, m *mat.Dense) {
     panic("Given matrix must have a single column")
   }
 
-  // Transpose if Column vector is given
+  // A column vector may be given too; its elements are in the same
+  // order, so it does not need to be transposed.
   if e == 1 {
-    m = mat.DenseCopyOf(m.T())
     e = err
   }
 
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := gonumData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -170,14 +179,13 @@ func gonumToArmaCol(p *params, identifier string, m *mat.Dense) {
     panic("Given matrix must have a single row")
   }
 
-  // Transpose if Row vector is given
+  // A row vector may be given too; its elements are in the same
+  // order, so it does not need to be transposed.
   if e == 1 {
-    m = mat.DenseCopyOf(m.T())
     e = err
   }
 
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := gonumData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -193,14 +201,13 @@ func gonumToArmaUcol(p *params, identifier string, m *mat.Dense) {
     panic("Given matrix must have a single row")
   }
 
-  // Transpose if Row vector is given
+  // A row vector may be given too; its elements are in the same
+  // order, so it does not need to be transposed.
   if e == 1 {
-    m = mat.DenseCopyOf(m.T())
     e = err
   }
 
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := gonumData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -215,8 +222,7 @@ func gonumToArmaMatWithInfo(p *params,
                             m *matrixWithInfo) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Data.Dims()
-  blas64General := m.Data.RawMatrix()
-  dataAndInfo := blas64General.Data
+  dataAndInfo := gonumData(m.Data)
   boolarray := m.Categoricals
   // Pass pointer of the underlying matrix to mlpack.
   boolptr := unsafe.Pointer(&boolarray[0])
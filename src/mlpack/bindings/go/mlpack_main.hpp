@@ -82,5 +82,9 @@ using Option = mlpack::bindings::go::GoOption<T>;
 PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
     "list of parameters and timers at the end of execution.", "v", "bool",
     false, true, false, false);
+PARAM_GLOBAL(int, "num_threads", "Number of threads to use for the parallel "
+    "parts of the method (with OpenMP), and for the BLAS library if it is "
+    "OpenBLAS or MKL; 0 uses the default number of threads.", "", "int", false,
+    true, false, 0);
 
 #endif
@@ -81,7 +81,8 @@ class MDOption
 
     // Add the option.
     if (identifier != "verbose" && identifier != "copy_all_inputs" &&
-        identifier != "help" && identifier != "info" && identifier != "version")
+        identifier != "help" && identifier != "info" &&
+        identifier != "version" && identifier != "server")
     {
       IO::AddParameter(bindingName, std::move(data));
     }
@@ -89,6 +89,10 @@ PARAM_GLOBAL(std::string, "info", "Print help on a specific option.", "",
     "std::string", false, true, false, "");
 PARAM_GLOBAL(bool, "version", "Display the version of mlpack.", "V", "bool",
     false, true, false, false);
+PARAM_GLOBAL(bool, "server", "If specified, load the given inputs once, and "
+    "then run the program once for each line of standard input, which holds "
+    "the additional options of that run; \"ok\" or \"error: <message>\" is "
+    "printed after each run.", "", "bool", false, true, false, false);
 
 // Python-specific parameters.
 PARAM_GLOBAL(bool, "copy_all_inputs", "If specified, all input parameters will "
@@ -98,5 +102,9 @@ PARAM_GLOBAL(bool, "copy_all_inputs", "If specified, all input parameters will "
 PARAM_GLOBAL(bool, "check_input_matrices", "If specified, the input matrix "
     "is checked for NaN and inf values; an exception is thrown if any are "
     "found.", "", "bool", false, true, false, false);
+PARAM_GLOBAL(int, "num_threads", "Number of threads to use for the parallel "
+    "parts of the method (with OpenMP), and for the BLAS library if it is "
+    "OpenBLAS or MKL; 0 uses the default number of threads.", "", "int", false,
+    true, false, 0);
 
 #endif
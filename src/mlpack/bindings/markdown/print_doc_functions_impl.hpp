@@ -614,6 +614,7 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("server");
 
     s += "python\n";
     std::string import = PrintImport(programName);
@@ -627,6 +628,7 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("server");
     p.Parameters().erase("copy_all_inputs");
     p.Parameters().erase("check_input_matrices");
 
@@ -642,6 +644,7 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("server");
     p.Parameters().erase("copy_all_inputs");
     p.Parameters().erase("check_input_matrices");
 
@@ -657,6 +660,7 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("server");
     p.Parameters().erase("copy_all_inputs");
     p.Parameters().erase("check_input_matrices");
 
@@ -133,7 +133,7 @@ void PrintDocs(const std::string& bindingName,
         continue;
       if (languages[i] != "cli" &&
           (it->second.name == "help" || it->second.name == "info" ||
-           it->second.name == "version"))
+           it->second.name == "version" || it->second.name == "server"))
         continue;
 
       // Print name, type, description, default.
@@ -162,7 +162,8 @@ void PrintDocs(const std::string& bindingName,
       cout << desc; // just a string
       // Print whether or not it's a "special" language-only parameter.
       if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "server")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
@@ -226,7 +227,8 @@ void PrintDocs(const std::string& bindingName,
       cout << it->second.desc;
       // Print whether or not it's a "special" language-only parameter.
       if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "server")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
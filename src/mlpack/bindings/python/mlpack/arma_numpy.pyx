@@ -9,6 +9,12 @@ matrix and free the memory upon destruction (and the numpy object will no longer
 "own" the matrix).  Similarly, if an Armadillo object is converted to a numpy
 object, then the numpy object will "own" the matrix.
 
+A copy is only made when the numpy object is not C-contiguous, or when its
+memory must be taken but it does not own it (i.e. it is a view of another
+array).  Since mlpack expects one point per column, an F-contiguous matrix with
+one point per row holds the transpose of what we need, so it is always copied
+once, by to_matrix().
+
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
 
@@ -48,8 +54,12 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
+    # If needed, make a copy where we own the memory, except on Windows where
+    # we never copy.  If we do not need to take the memory, any C-contiguous
+    # array (including views of other arrays) can be used directly, since it
+    # stays alive for as long as the Armadillo object is used.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -68,9 +78,12 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  If we do not need to take the memory, any C-contiguous
+    # array (including views of other arrays) can be used directly, since it
+    # stays alive for as long as the Armadillo object is used.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -132,9 +145,12 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  If we do not need to take the memory, any C-contiguous
+    # array (including views of other arrays) can be used directly, since it
+    # stays alive for as long as the Armadillo object is used.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -154,9 +170,12 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  If we do not need to take the memory, any C-contiguous
+    # array (including views of other arrays) can be used directly, since it
+    # stays alive for as long as the Armadillo object is used.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -215,9 +234,12 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  If we do not need to take the memory, any C-contiguous
+    # array (including views of other arrays) can be used directly, since it
+    # stays alive for as long as the Armadillo object is used.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -237,9 +259,12 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  If we do not need to take the memory, any C-contiguous
+    # array (including views of other arrays) can be used directly, since it
+    # stays alive for as long as the Armadillo object is used.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -5,7 +5,8 @@ io.pyx: Cython functionality for mlpack::IO and other utilities.
 This file imports the Parameters() function from mlpack::IO, plus other utility
 functions: SetParam(), SetParamPtr(), SetParamWithInfo(), GetParam(),
 GetParamWithInfo(), EnableVerbose(), DisableVerbose(), DisableBacktrace(),
-EnableTimers() and ResetTimers().
+EnableTimers(), ResetTimers() and SetNumThreads(), and the LocalRandomGenerator
+class, which gives each call of a binding its own random number generator.
 
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
@@ -34,3 +35,11 @@ cdef extern from "<mlpack/bindings/python/mlpack/io_util.hpp>" \
   void DisableBacktrace() nogil except +
   void ResetTimers() nogil except +
   void EnableTimers() nogil except +
+
+cdef extern from "<mlpack/core/util/threads.hpp>" \
+    namespace "mlpack::util" nogil:
+  void SetNumThreads(Params) nogil except +
+
+cdef extern from "<mlpack/core/math/random.hpp>" namespace "mlpack::math" nogil:
+  cdef cppclass LocalRandomGenerator:
+    LocalRandomGenerator() nogil
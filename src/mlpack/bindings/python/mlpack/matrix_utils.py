@@ -53,7 +53,10 @@ def to_matrix(x, dtype=np.double, copy=False):
     else:
       return x, False
   elif (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.f_contiguous):
-    # A copy is always necessary here.
+    # A copy is always necessary here: mlpack stores one point per column, so
+    # the memory of an F-contiguous matrix with one point per row holds the
+    # transpose of what we need.  The copy is owned by the Armadillo object
+    # afterwards, so this is the only copy that is made.
     return x.copy("C"), True
   else:
     if isinstance(x, pd.core.series.Series) or isinstance(x, pd.DataFrame):
@@ -89,11 +92,9 @@ def to_matrix_with_info(x, dtype, copy=False):
     else:
       d = np.zeros([x.shape[1]], dtype=np.bool)
 
-    # Copy the matrix if needed.
-    if copy:
-      return (x.copy(order="C"), True, d)
-    else:
-      return (x, False, d)
+    # Convert and copy the matrix only if needed.
+    t = to_matrix(x, dtype=dtype, copy=copy)
+    return (t[0], t[1], d)
 
   if isinstance(x, pd.DataFrame) or isinstance(x, pd.Series):
     # It's a pandas dataframe.  So we need to see if any of the dtypes are
@@ -91,5 +91,9 @@ PARAM_GLOBAL(bool, "copy_all_inputs", "If specified, all input parameters "
 PARAM_GLOBAL(bool, "check_input_matrices", "If specified, the input matrix "
     "is checked for NaN and inf values; an exception is thrown if any are "
     "found.", "", "bool", false, true, false, false);
+PARAM_GLOBAL(int, "num_threads", "Number of threads to use for the parallel "
+    "parts of the method (with OpenMP), and for the BLAS library if it is "
+    "OpenBLAS or MKL; 0 uses the default number of threads.", "", "int", false,
+    true, false, 0);
 
 #endif
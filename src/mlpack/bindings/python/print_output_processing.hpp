@@ -210,7 +210,7 @@ void PrintOutputProcessing(
       if (data.input && data.cppType == d.cppType && data.required)
       {
         std::cout << prefix << "if (<" << strippedType
-            << "Type> result).modelptr" << d.name << " == (<" << strippedType
+            << "Type> result).modelptr == (<" << strippedType
             << "Type> " << data.name << ").modelptr:" << std::endl;
         std::cout << prefix << "  (<" << strippedType
             << "Type> result).modelptr = <" << strippedType << "*> 0"
@@ -222,7 +222,7 @@ void PrintOutputProcessing(
         std::cout << prefix << "if " << data.name << " is not None:"
             << std::endl;
         std::cout << prefix << "  if (<" << strippedType
-            << "Type> result).modelptr" << d.name << " == (<" << strippedType
+            << "Type> result).modelptr == (<" << strippedType
             << "Type> " << data.name << ").modelptr:" << std::endl;
         std::cout << prefix << "    (<" << strippedType
             << "Type> result).modelptr = <" << strippedType << "*> 0"
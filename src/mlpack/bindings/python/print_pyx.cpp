@@ -81,7 +81,8 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "from io cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from io cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
-      << "ResetTimers, EnableTimers" << endl;
+      << "ResetTimers, EnableTimers, LocalRandomGenerator, SetNumThreads"
+      << endl;
   cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
   cout << "from preprocess_json_params import process_params_out, "
       << "process_params_in" << endl;
@@ -201,6 +202,9 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "  cdef Params p = IO.Parameters(\"" << bindingName << "\")"
       << endl;
   cout << "  cdef Timers t" << endl;
+  // Give the call its own random number generator, so that concurrent calls
+  // (and their seeds) do not interfere with each other.
+  cout << "  cdef LocalRandomGenerator rng" << endl;
 
   // Determine whether or not we need to copy parameters.
   cout << "  if isinstance(copy_all_inputs, bool):" << endl;
@@ -242,9 +246,15 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "  if check_input_matrices:" << endl;
   cout << "    p.CheckInputMatrices()" << endl;
 
-  // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpack_" << bindingName << "(p, t)" << endl;
+  // Call the method.  The GIL is released during the call, so that other
+  // Python threads can run (and call other bindings) in the meantime; the
+  // Params and Timers objects are local to this call.
+  cout << "  # Call the mlpack program, without the GIL so that other Python "
+      << "threads" << endl;
+  cout << "  # can run." << endl;
+  cout << "  with nogil:" << endl;
+  cout << "    SetNumThreads(p)" << endl;
+  cout << "    mlpack_" << bindingName << "(p, t)" << endl;
 
   // Do any output processing and return.
   cout << "  # Initialize result dictionary." << endl;
@@ -13,6 +13,8 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import pickle
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -37,6 +39,37 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output['int_out'], 13)
     self.assertEqual(output['double_out'], 5.0)
 
+  def testRunBindingConcurrently(self):
+    """
+    The bindings release the GIL, so they may be called from several threads
+    at once; each call should get its own results.
+    """
+    results = [None] * 8
+    def run(i):
+      results[i] = test_python_binding(string_in='hello',
+                                       int_in=12,
+                                       double_in=4.0,
+                                       mat_req_in=[[1.0]],
+                                       col_req_in=[1.0],
+                                       matrix_in=np.full((100, 5), float(i)),
+                                       flag1=True)
+
+    threads = [threading.Thread(target=run, args=(i,))
+               for i in range(len(results))]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+
+    for i in range(len(results)):
+      self.assertEqual(results[i]['string_out'], 'hello2')
+      self.assertEqual(results[i]['int_out'], 13)
+      self.assertEqual(results[i]['double_out'], 5.0)
+      self.assertEqual(results[i]['matrix_out'].shape, (100, 4))
+      for j in [0, 1, 3]:
+        self.assertTrue((results[i]['matrix_out'][:, j] == i).all())
+      self.assertTrue((results[i]['matrix_out'][:, 2] == 2 * i).all())
+
   def testRunBindingNoFlag(self):
     """
     If we forget the mandatory flag, we should get wrong results.
@@ -157,6 +190,39 @@ class TestPythonBinding(unittest.TestCase):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
 
+  def testNumpyMatrixView(self):
+    """
+    A C-contiguous view of a larger matrix can be passed without a copy, and we
+    should get back the rows of the view with the third dimension doubled and
+    the fifth forgotten.
+    """
+    x = np.random.rand(200, 5);
+    z = copy.deepcopy(x)
+    view = z[50:150]
+    self.assertFalse(view.flags.owndata)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=view)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['matrix_out'].dtype, np.double)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j + 50, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j + 50, 2], output['matrix_out'][j, 2])
+
+    # The rest of the matrix must not be touched.
+    for i in range(5):
+      for j in list(range(50)) + list(range(150, 200)):
+        self.assertEqual(x[j, i], z[j, i])
+
   def testNumpyFContiguousMatrix(self):
     """
     The matrix with F_CONTIGUOUS set we pass in, we should get back with the third
@@ -867,6 +933,44 @@ class TestPythonBinding(unittest.TestCase):
 
     self.assertEqual(output2['model_bw_out'], 20.0)
 
+  def testModelReuse(self):
+    """
+    Pass the same model handle to two calls, and make sure that both give the
+    same results as a pickled and unpickled copy of the model.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 build_model=True)
+    model = output['model_out']
+
+    output2 = test_python_binding(string_in='hello',
+                                  int_in=12,
+                                  double_in=4.0,
+                                  mat_req_in=[[1.0]],
+                                  col_req_in=[1.0],
+                                  model_in=model)
+    output3 = test_python_binding(string_in='hello',
+                                  int_in=12,
+                                  double_in=4.0,
+                                  mat_req_in=[[1.0]],
+                                  col_req_in=[1.0],
+                                  model_in=model)
+
+    pickled = pickle.loads(pickle.dumps(model))
+    output4 = test_python_binding(string_in='hello',
+                                  int_in=12,
+                                  double_in=4.0,
+                                  mat_req_in=[[1.0]],
+                                  col_req_in=[1.0],
+                                  model_in=pickled)
+
+    self.assertEqual(output2['model_bw_out'], 20.0)
+    self.assertEqual(output3['model_bw_out'], output2['model_bw_out'])
+    self.assertEqual(output4['model_bw_out'], output2['model_bw_out'])
+
   def testOneDimensionNumpyMatrix(self):
     """
     Test that we can pass one dimension matrix from matrix_in
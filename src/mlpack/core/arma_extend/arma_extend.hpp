@@ -14,6 +14,21 @@
 #define ARMA_EXTRA_MAT_PROTO mlpack/core/arma_extend/Mat_extra_bones.hpp
 #define ARMA_EXTRA_SPMAT_PROTO mlpack/core/arma_extend/SpMat_extra_bones.hpp
 
+// Account for the memory of Armadillo objects, or place large matrices in huge
+// pages, if requested (see core/util/memory_tracker.hpp and
+// core/util/huge_page_allocator.hpp).  The MemoryTracker uses the
+// HugePageAllocator if both are requested.
+#if defined(MLPACK_ENABLE_MEMORY_TRACKING)
+  #include <mlpack/core/util/memory_tracker.hpp>
+  #define ARMA_ALIEN_MEM_ALLOC_FUNCTION mlpack::util::MemoryTracker::Allocate
+  #define ARMA_ALIEN_MEM_FREE_FUNCTION mlpack::util::MemoryTracker::Free
+#elif defined(MLPACK_ENABLE_HUGE_PAGES)
+  #include <mlpack/core/util/huge_page_allocator.hpp>
+  #define ARMA_ALIEN_MEM_ALLOC_FUNCTION \
+      mlpack::util::HugePageAllocator::Allocate
+  #define ARMA_ALIEN_MEM_FREE_FUNCTION mlpack::util::HugePageAllocator::Free
+#endif
+
 #include <armadillo>
 
 #endif
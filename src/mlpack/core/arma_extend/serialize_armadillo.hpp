@@ -20,10 +20,43 @@
 
 #include <armadillo>
 
+namespace cereal {
+
+/**
+ * Serialize the given array of n elements of an Armadillo object.  Archives
+ * that support binary data (the binary and portable binary archives) read or
+ * write the whole array in one call, which gives the same bytes as writing the
+ * elements one by one but runs at close to the bandwidth of the stream; other
+ * archives serialize each element with the given name.
+ */
+template<typename Archive, typename eT>
+typename std::enable_if<std::is_arithmetic<eT>::value &&
+    (traits::is_output_serializable<BinaryData<eT*>, Archive>::value ||
+     traits::is_input_serializable<BinaryData<eT*>, Archive>::value)>::type
+SerializeArmaMemory(Archive& ar,
+                    eT* memory,
+                    const size_t n,
+                    const char* /* name */)
+{
+  ar(binary_data(memory, n * sizeof(eT)));
+}
+
+template<typename Archive, typename eT>
+typename std::enable_if<!(std::is_arithmetic<eT>::value &&
+    (traits::is_output_serializable<BinaryData<eT*>, Archive>::value ||
+     traits::is_input_serializable<BinaryData<eT*>, Archive>::value))>::type
+SerializeArmaMemory(Archive& ar,
+                    eT* memory,
+                    const size_t n,
+                    const char* name)
+{
+  for (size_t i = 0; i < n; ++i)
+    ar(cereal::make_nvp(name, memory[i]));
+}
+
 /**
  * Add an external serialization function for SpMat.
  */
-namespace cereal {
 
 template<typename Archive, typename eT>
 void serialize(Archive& ar, arma::SpMat<eT>& mat)
@@ -51,12 +84,12 @@ void serialize(Archive& ar, arma::SpMat<eT>& mat)
   }
 
   // Serialize the values held in the sparse matrix.
-  for (size_t i = 0; i < mat.n_nonzero; ++i)
-    ar(cereal::make_nvp("value", arma::access::rw(mat.values[i])));
-  for (size_t i = 0; i < mat.n_nonzero; ++i)
-    ar(cereal::make_nvp("row_index", arma::access::rw(mat.row_indices[i])));
-  for (size_t i = 0; i < mat.n_cols + 1; ++i)
-    ar(cereal::make_nvp("col_ptr", arma::access::rw(mat.col_ptrs[i])));
+  SerializeArmaMemory(ar, const_cast<eT*>(mat.values), mat.n_nonzero,
+      "value");
+  SerializeArmaMemory(ar, const_cast<arma::uword*>(mat.row_indices),
+      mat.n_nonzero, "row_index");
+  SerializeArmaMemory(ar, const_cast<arma::uword*>(mat.col_ptrs),
+      mat.n_cols + 1, "col_ptr");
 }
 
 // Add an external serialization function for Mat.
@@ -79,8 +112,7 @@ void serialize(Archive& ar, arma::Mat<eT>& mat)
   }
 
   // Directly serialize the contents of the matrix's memory.
-  for (size_t i = 0; i < mat.n_elem; ++i)
-    ar(cereal::make_nvp("elem", arma::access::rw(mat.mem[i])));
+  SerializeArmaMemory(ar, mat.memptr(), mat.n_elem, "elem");
 }
 
 // Add a serialization function for armadillo Cube
@@ -100,8 +132,7 @@ void serialize(Archive& ar, arma::Cube<eT>& cube)
     cube.set_size(n_rows, n_cols, n_slices);
 
   // Directly serialize the contents of the cube's memory.
-  for (size_t i = 0; i < cube.n_elem; ++i)
-    ar(cereal::make_nvp("elem", arma::access::rw(cube.mem[i])));
+  SerializeArmaMemory(ar, cube.memptr(), cube.n_elem, "elem");
 }
 
 } // end namespace cereal
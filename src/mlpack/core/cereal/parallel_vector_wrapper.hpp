@@ -0,0 +1,183 @@
+/**
+ * @file core/cereal/parallel_vector_wrapper.hpp
+ *
+ * Implementation of a vector wrapper that serializes the elements of a vector
+ * independently, so that they can be saved and loaded in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_PARALLEL_VECTOR_WRAPPER_HPP
+#define MLPACK_CORE_CEREAL_PARALLEL_VECTOR_WRAPPER_HPP
+
+#include <cereal/cereal.hpp>
+#include <cereal/details/traits.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cereal {
+
+/**
+ * The ParallelVectorWrapper serializes a std::vector whose elements are large
+ * objects (such as the trees of a forest) so that they can be loaded in
+ * parallel.  With a binary archive, each element is serialized into its own
+ * block of bytes, with a new archive of the same type; the archive then holds
+ * the number of elements, the size of each block (which gives the offset of
+ * each element) and the blocks.  So, when the vector is loaded, the blocks are
+ * read first, and the elements are then deserialized from the blocks in
+ * parallel (and, when it is saved, they are serialized in parallel).  This
+ * holds each serialized element in memory once while the vector is saved or
+ * loaded.
+ *
+ * With a text archive (JSON or XML), the vector is serialized as a usual
+ * std::vector, one element after the other.
+ *
+ * The format of binary archives differs from the format of std::vector, so a
+ * class that starts to use the wrapper must increase its version, and load
+ * older versions as a std::vector.
+ */
+template<typename T>
+class ParallelVectorWrapper
+{
+ public:
+  ParallelVectorWrapper(std::vector<T>& vec) : vec(vec) { }
+
+  template<typename Archive>
+  typename std::enable_if<traits::is_text_archive<Archive>::value>::type
+  save(Archive& ar) const
+  {
+    ar(make_size_tag(static_cast<size_type>(vec.size())));
+    for (size_t i = 0; i < vec.size(); ++i)
+      ar(vec[i]);
+  }
+
+  template<typename Archive>
+  typename std::enable_if<!traits::is_text_archive<Archive>::value>::type
+  save(Archive& ar) const
+  {
+    const std::vector<T>& elems = vec;
+    std::vector<std::string> blocks(elems.size());
+    std::exception_ptr error;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) elems.size(); ++i)
+    {
+      try
+      {
+        std::ostringstream oss;
+        {
+          Archive blockAr(oss);
+          blockAr(cereal::make_nvp("item", elems[i]));
+        }
+        blocks[i] = oss.str();
+      }
+      catch (...)
+      {
+        #pragma omp critical
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+
+    std::vector<uint64_t> blockSizes(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i)
+      blockSizes[i] = blocks[i].size();
+
+    ar(CEREAL_NVP(blockSizes));
+    for (size_t i = 0; i < blocks.size(); ++i)
+      ar(binary_data(&blocks[i][0], blocks[i].size()));
+  }
+
+  template<typename Archive>
+  typename std::enable_if<traits::is_text_archive<Archive>::value>::type
+  load(Archive& ar)
+  {
+    size_type size;
+    ar(make_size_tag(size));
+    vec.resize(static_cast<size_t>(size));
+    for (size_t i = 0; i < vec.size(); ++i)
+      ar(vec[i]);
+  }
+
+  template<typename Archive>
+  typename std::enable_if<!traits::is_text_archive<Archive>::value>::type
+  load(Archive& ar)
+  {
+    // Read all the blocks, then deserialize them in parallel.
+    std::vector<uint64_t> blockSizes;
+    ar(CEREAL_NVP(blockSizes));
+
+    std::vector<std::string> blocks(blockSizes.size());
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+      blocks[i].resize(blockSizes[i]);
+      ar(binary_data(&blocks[i][0], blocks[i].size()));
+    }
+
+    vec.clear();
+    vec.resize(blocks.size());
+    std::exception_ptr error;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) blocks.size(); ++i)
+    {
+      try
+      {
+        std::istringstream iss(blocks[i]);
+        Archive blockAr(iss);
+        blockAr(cereal::make_nvp("item", vec[i]));
+      }
+      catch (...)
+      {
+        #pragma omp critical
+        if (!error)
+          error = std::current_exception();
+      }
+
+      // Free the block as soon as it is not needed anymore.
+      std::string().swap(blocks[i]);
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+ private:
+  std::vector<T>& vec;
+};
+
+/**
+ * Serialize a std::vector with a ParallelVectorWrapper, so that its elements
+ * are saved and loaded in parallel.
+ *
+ * @param t A reference to the std::vector to be serialized.
+ */
+template<typename T>
+inline ParallelVectorWrapper<T>
+make_parallel_vector(std::vector<T>& t)
+{
+  return ParallelVectorWrapper<T>(t);
+}
+
+/**
+ * Serialize a std::vector T whose elements are large objects with the above
+ * ParallelVectorWrapper class, so that the elements are saved and loaded in
+ * parallel with binary archives.  It should be given a name with
+ * cereal::make_nvp().
+ *
+ * @param T std::vector to be serialized.
+ */
+#define CEREAL_PARALLEL_VECTOR(T) cereal::make_parallel_vector(T)
+
+} // namespace cereal
+
+#endif // MLPACK_CORE_CEREAL_PARALLEL_VECTOR_WRAPPER_HPP
@@ -0,0 +1,54 @@
+/**
+ * @file core/cereal/template_class_version.hpp
+ *
+ * Definition of the CEREAL_TEMPLATE_CLASS_VERSION() macro, which sets the
+ * serialization version of a class template.  cereal's own
+ * CEREAL_CLASS_VERSION() macro only works for non-template classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_TEMPLATE_CLASS_VERSION_HPP
+#define MLPACK_CORE_CEREAL_TEMPLATE_CLASS_VERSION_HPP
+
+#include <cereal/cereal.hpp>
+
+//! Remove the parentheses around a macro argument.
+#define MLPACK_CEREAL_UNWRAP(...) __VA_ARGS__
+
+/**
+ * Set the serialization version of a class template.  Since the template
+ * signature and the type usually contain commas, every argument must be
+ * wrapped in parentheses; for instance:
+ *
+ * @code
+ * CEREAL_TEMPLATE_CLASS_VERSION((template<typename T, typename U>),
+ *     (MyClass<T, U>), (1));
+ * @endcode
+ *
+ * This must be used in the global namespace.
+ */
+#define CEREAL_TEMPLATE_CLASS_VERSION(SIGNATURE, T, VERSION) \
+namespace cereal { \
+namespace detail { \
+MLPACK_CEREAL_UNWRAP SIGNATURE struct Version<MLPACK_CEREAL_UNWRAP T> \
+{ \
+  static const std::uint32_t version; \
+  static std::uint32_t registerVersion() \
+  { \
+    ::cereal::detail::StaticObject<Versions>::getInstance().mapping.emplace( \
+        std::type_index(typeid(MLPACK_CEREAL_UNWRAP T)).hash_code(), \
+        MLPACK_CEREAL_UNWRAP VERSION); \
+    return MLPACK_CEREAL_UNWRAP VERSION; \
+  } \
+  static void unused() { (void) version; } \
+}; \
+MLPACK_CEREAL_UNWRAP SIGNATURE const std::uint32_t \
+    Version<MLPACK_CEREAL_UNWRAP T>::version = \
+    Version<MLPACK_CEREAL_UNWRAP T>::registerVersion(); \
+} \
+}
+
+#endif
@@ -98,6 +98,22 @@ class CVBase
                     const WeightsType& weights,
                     const MLAlgorithmArgs&... args);
 
+  /**
+   * Train MLAlgorithm like Train(), but start from the given parameters of a
+   * previously trained model if they are not empty, and then replace them with
+   * the parameters of the new model.  Starting from a model trained with
+   * similar hyper-parameters (warm start) usually makes the training much
+   * faster.  This needs a constructor of MLAlgorithm that takes the initial
+   * parameters right after the predictions (and the numClasses parameter, if
+   * it is taken), like LogisticRegression, and no support for weighted
+   * learning; otherwise the model is trained from scratch.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm WarmStartTrain(const MatType& xs,
+                             const PredictionsType& ys,
+                             typename MIE::ParametersType& parameters,
+                             const MLAlgorithmArgs&... args);
+
  private:
   static_assert(MIE::IsSupported,
       "The given MLAlgorithm is not supported by MetaInfoExtractor");
@@ -121,6 +137,72 @@ class CVBase
   static void AssertWeightsSize(const MatType& xs,
                                 const WeightsType& weights);
 
+  /**
+   * An indication whether MLAlgorithm can be warm-started with the given
+   * arguments.  Algorithms that support weighted learning are never
+   * warm-started, since their constructors take the weights in the place of the
+   * initial parameters.
+   */
+  template<typename... MLAlgorithmArgs>
+  using CanWarmStart = std::integral_constant<bool,
+      !std::is_same<typename MIE::ParametersType, void*>::value &&
+      !MIE::SupportsWeights && !MIE::TakesDatasetInfo &&
+      (MIE::TakesNumClasses ?
+      std::is_constructible<MLAlgorithm, const MatType&, const PredictionsType&,
+          const size_t, const typename MIE::ParametersType&,
+          const MLAlgorithmArgs&...>::value :
+      std::is_constructible<MLAlgorithm, const MatType&, const PredictionsType&,
+          const typename MIE::ParametersType&,
+          const MLAlgorithmArgs&...>::value)>;
+
+  /**
+   * Warm-start the training if the given parameters are not empty, and store
+   * the parameters of the trained model in them.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm TrainFromParameters(const MatType& xs,
+                                  const PredictionsType& ys,
+                                  typename MIE::ParametersType& parameters,
+                                  std::true_type /* canWarmStart */,
+                                  const MLAlgorithmArgs&... args);
+
+  /**
+   * Train from scratch, since MLAlgorithm cannot be warm-started.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm TrainFromParameters(const MatType& xs,
+                                  const PredictionsType& ys,
+                                  typename MIE::ParametersType& parameters,
+                                  std::false_type /* canWarmStart */,
+                                  const MLAlgorithmArgs&... args);
+
+  /**
+   * Construct a trained MLAlgorithm model from the given initial parameters if
+   * MLAlgorithm doesn't take the numClasses parameter.
+   */
+  template<typename... MLAlgorithmArgs,
+           bool Enabled = !MIE::TakesNumClasses,
+           typename = typename std::enable_if<Enabled>::type>
+  MLAlgorithm WarmStartTrainModel(
+      const MatType& xs,
+      const PredictionsType& ys,
+      const typename MIE::ParametersType& parameters,
+      const MLAlgorithmArgs&... args);
+
+  /**
+   * Construct a trained MLAlgorithm model from the given initial parameters if
+   * MLAlgorithm takes the numClasses parameter.
+   */
+  template<typename... MLAlgorithmArgs,
+           bool Enabled = MIE::TakesNumClasses,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void>
+  MLAlgorithm WarmStartTrainModel(
+      const MatType& xs,
+      const PredictionsType& ys,
+      const typename MIE::ParametersType& parameters,
+      const MLAlgorithmArgs&... args);
+
   /**
    * Construct a trained MLAlgorithm model if MLAlgorithm doesn't take the
    * numClasses parameter.
@@ -98,6 +98,98 @@ MLAlgorithm CVBase<MLAlgorithm,
   return TrainModel(xs, ys, weights, args...);
 }
 
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::WarmStartTrain(
+    const MatType& xs,
+    const PredictionsType& ys,
+    typename MIE::ParametersType& parameters,
+    const MLAlgorithmArgs&... args)
+{
+  return TrainFromParameters(xs, ys, parameters,
+      CanWarmStart<MLAlgorithmArgs...>(), args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::TrainFromParameters(
+    const MatType& xs,
+    const PredictionsType& ys,
+    typename MIE::ParametersType& parameters,
+    std::true_type /* canWarmStart */,
+    const MLAlgorithmArgs&... args)
+{
+  MLAlgorithm model = (parameters.n_elem == 0) ? Train(xs, ys, args...) :
+      WarmStartTrainModel(xs, ys, parameters, args...);
+  parameters = model.Parameters();
+
+  return model;
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::TrainFromParameters(
+    const MatType& xs,
+    const PredictionsType& ys,
+    typename MIE::ParametersType& /* parameters */,
+    std::false_type /* canWarmStart */,
+    const MLAlgorithmArgs&... args)
+{
+  return Train(xs, ys, args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::WarmStartTrainModel(
+    const MatType& xs,
+    const PredictionsType& ys,
+    const typename MIE::ParametersType& parameters,
+    const MLAlgorithmArgs&... args)
+{
+  return MLAlgorithm(xs, ys, parameters, args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::WarmStartTrainModel(
+    const MatType& xs,
+    const PredictionsType& ys,
+    const typename MIE::ParametersType& parameters,
+    const MLAlgorithmArgs&... args)
+{
+  return MLAlgorithm(xs, ys, numClasses, parameters, args...);
+}
+
 template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
@@ -44,6 +44,13 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * The k folds are trained and evaluated in parallel (if OpenMP is enabled),
+ * each with its own model and its own random stream (see
+ * math::RandomStream()), and the validation subsets are aliases of the data.
+ * A training subset is also an alias when it is contiguous, and a copy that
+ * only lives while its fold runs otherwise.  Note that models that use OpenMP
+ * themselves are then trained with one thread each.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -168,6 +175,19 @@ class KFoldCV
           const WeightsType& weights,
           const bool shuffle = true);
 
+  /**
+   * Copy the given KFoldCV object, but only use the first subsetRatio fraction
+   * of its (possibly shuffled) data points, and at least k, split into k bins
+   * again.  The model from the last run is not copied.  HyperParameterTuner
+   * uses this to evaluate candidates in parallel and on growing subsets of the
+   * data.
+   *
+   * @param other KFoldCV object to copy.
+   * @param subsetRatio Fraction of the data points to use (more than 0 and not
+   *     more than 1).
+   */
+  KFoldCV(const KFoldCV& other, const double subsetRatio = 1.0);
+
   /**
    * Run k-fold cross-validation.
    *
@@ -180,6 +200,16 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  /**
+   * Get whether each call to Evaluate() warm-starts the training of each fold
+   * from the model of that fold in the previous call, when MLAlgorithm supports
+   * it (see CVBase::WarmStartTrain()).  Weighted training always starts from
+   * scratch.
+   */
+  bool WarmStart() const { return warmStart; }
+  //! Modify whether each call to Evaluate() warm-starts the training.
+  bool& WarmStart() { return warmStart; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -209,11 +239,11 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
-  //! The extended (by repeating the first k - 2 bins) data points.
+  //! The data points.
   MatType xs;
-  //! The extended (by repeating the first k - 2 bins) predictions.
+  //! The predictions.
   PredictionsType ys;
-  //! The extended (by repeating the first k - 2 bins) weights.
+  //! The weights.
   WeightsType weights;
 
   //! The original size of the dataset.
@@ -225,6 +255,11 @@ class KFoldCV
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! Whether to warm-start the training from the previous models.
+  bool warmStart;
+  //! The parameters of the previous model of each fold, for warm starts.
+  std::vector<typename Base::MIE::ParametersType> warmStartParameters;
+
   /**
    * Assert the k parameter and data consistency and initialize fields required
    * for running k-fold cross-validation.
@@ -247,12 +282,24 @@ class KFoldCV
           const bool shuffle);
 
   /**
-   * Initialize the given destination matrix with the given source joined with
-   * its first k - 2 bins.
+   * Initialize the given destination matrix with the given source, and the
+   * sizes of the bins.
    */
   template<typename DataType>
   void InitKFoldCVMat(const DataType& source, DataType& destination);
 
+  /**
+   * Get a copy of the first n points of the given data (or of the given
+   * weights, if there are any).
+   */
+  template<typename DataType>
+  static DataType FirstPoints(const DataType& data, const size_t n);
+
+  /**
+   * Return the given pointer, since weights are not supported.
+   */
+  static void* FirstPoints(void* data, const size_t n);
+
   /**
    * Train and run evaluation in the case of non-weighted learning.
    */
@@ -273,20 +320,23 @@ class KFoldCV
   /**
    * Calculate the index of the first column of the ith validation subset.
    *
-   * We take the ith validation subset after the ith training subset if
-   * i < k - 1 and before it otherwise.
+   * The 0th validation subset is the last bin, and the ith one (i > 0) is the
+   * (i - 1)th bin.
    */
   inline size_t ValidationSubsetFirstCol(const size_t i);
 
   /**
-   * Get the ith training subset from a variable of a matrix type.
+   * Get the ith training subset (all the points that are not in the ith
+   * validation subset) from a variable of a matrix type.  It is an alias of
+   * the data if the validation subset is at the beginning or at the end of the
+   * data, and a copy otherwise.
    */
   template<typename ElementType>
   inline arma::Mat<ElementType> GetTrainingSubset(arma::Mat<ElementType>& m,
                                                   const size_t i);
 
   /**
-   * Get the ith training subset from a variable of a row type.
+   * Get the ith training subset from a variable of a row type, like above.
    */
   template<typename ElementType>
   inline arma::Row<ElementType> GetTrainingSubset(arma::Row<ElementType>& r,
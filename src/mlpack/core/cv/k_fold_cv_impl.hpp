@@ -12,6 +12,8 @@
 #ifndef MLPACK_CORE_CV_K_FOLD_CV_IMPL_HPP
 #define MLPACK_CORE_CV_K_FOLD_CV_IMPL_HPP
 
+#include <exception>
+
 namespace mlpack {
 namespace cv {
 
@@ -135,7 +137,9 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    warmStart(false),
+    warmStartParameters(k)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +170,9 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    warmStart(false),
+    warmStartParameters(k)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -179,6 +185,34 @@ KFoldCV<MLAlgorithm,
     Shuffle();
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+KFoldCV<MLAlgorithm,
+        Metric,
+        MatType,
+        PredictionsType,
+        WeightsType>::KFoldCV(const KFoldCV& other,
+                              const double subsetRatio) :
+    base(other.base),
+    k(other.k),
+    warmStart(other.warmStart),
+    warmStartParameters(other.k)
+{
+  if (subsetRatio <= 0.0 || subsetRatio > 1.0)
+    throw std::invalid_argument("KFoldCV: the subsetRatio parameter should be "
+        "more than 0 and not more than 1");
+
+  const size_t subsetSize = std::min((size_t) other.xs.n_cols, std::max(k,
+      (size_t) std::ceil(subsetRatio * other.xs.n_cols)));
+
+  InitKFoldCVMat(FirstPoints(other.xs, subsetSize), xs);
+  InitKFoldCVMat(FirstPoints(other.ys, subsetSize), ys);
+  weights = FirstPoints(other.weights, subsetSize);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -228,8 +262,40 @@ void KFoldCV<MLAlgorithm,
   binSize = source.n_cols / k;
   lastBinSize = source.n_cols - ((k - 1) * binSize);
 
-  destination = (k == 2) ? source : arma::join_rows(source,
-      source.cols(0, source.n_cols - lastBinSize - 1));
+  destination = source;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename DataType>
+DataType KFoldCV<MLAlgorithm,
+                 Metric,
+                 MatType,
+                 PredictionsType,
+                 WeightsType>::FirstPoints(const DataType& data, const size_t n)
+{
+  // The weights are optional.
+  if (data.n_cols == 0)
+    return data;
+
+  return data.cols(0, n - 1);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void* KFoldCV<MLAlgorithm,
+              Metric,
+              MatType,
+              PredictionsType,
+              WeightsType>::FirstPoints(void* data, const size_t /* n */)
+{
+  return data;
 }
 
 template<typename MLAlgorithm,
@@ -246,13 +312,47 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
+  // Each fold draws its random numbers from its own stream, whichever thread
+  // runs it.
+  const size_t firstStream = math::ReserveRandomStreams(k);
+
+  // Exceptions cannot leave the parallel region, so the first one is thrown
+  // after it.
+  std::exception_ptr exception;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+  {
+    try
+    {
+      math::RandGen() = math::RandomStream(firstStream + i);
+
+      MLAlgorithm&& model = warmStart ?
+          base.WarmStartTrain(GetTrainingSubset(xs, i),
+              GetTrainingSubset(ys, i), warmStartParameters[i], args...) :
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      #pragma omp critical(KFoldCVException)
+      {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+
   size_t numInvalidScores = 0;
   for (size_t i = 0; i < k; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
     if (std::isnan(evaluations(i)) || std::isinf(evaluations(i)))
     {
       ++numInvalidScores;
@@ -260,8 +360,6 @@ double KFoldCV<MLAlgorithm,
           << "a score of " << evaluations(i) << "; ignoring when computing "
           << "the average score." << std::endl;
     }
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
   if (numInvalidScores == k)
@@ -288,19 +386,47 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
-  for (size_t i = 0; i < k; ++i)
+  // Each fold draws its random numbers from its own stream, whichever thread
+  // runs it.
+  const size_t firstStream = math::ReserveRandomStreams(k);
+
+  // Exceptions cannot leave the parallel region, so the first one is thrown
+  // after it.
+  std::exception_ptr exception;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    try
+    {
+      math::RandGen() = math::RandomStream(firstStream + i);
+
+      MLAlgorithm&& model = (weights.n_elem > 0) ?
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              GetTrainingSubset(weights, i), args...) :
+          warmStart ?
+          base.WarmStartTrain(GetTrainingSubset(xs, i),
+              GetTrainingSubset(ys, i), warmStartParameters[i], args...) :
+          base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+              args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      #pragma omp critical(KFoldCVException)
+      {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
   }
 
+  if (exception)
+    std::rethrow_exception(exception);
+
   return arma::mean(evaluations);
 }
 
@@ -316,14 +442,7 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
-  math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
-
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
+  math::ShuffleData(xs, ys, xs, ys);
 }
 
 template<typename MLAlgorithm,
@@ -338,22 +457,10 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  WeightsType weightsOrig;
   if (weights.n_elem > 0)
-    weightsOrig = weights.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
-  if (weights.n_elem > 0)
-    math::ShuffleData(xsOrig, ysOrig, weightsOrig, xsOrig, ysOrig, weightsOrig);
+    math::ShuffleData(xs, ys, weights, xs, ys, weights);
   else
-    math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
-
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
-  if (weights.n_elem > 0)
-    InitKFoldCVMat(weightsOrig, weights);
+    math::ShuffleData(xs, ys, xs, ys);
 }
 
 template<typename MLAlgorithm,
@@ -367,7 +474,6 @@ size_t KFoldCV<MLAlgorithm,
                PredictionsType,
                WeightsType>::ValidationSubsetFirstCol(const size_t i)
 {
-  // Use as close to the beginning of the dataset as we can.
   return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
 }
 
@@ -385,14 +491,17 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     arma::Mat<ElementType>& m,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
-
-  return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
-      false, true);
+  const size_t begin = ValidationSubsetFirstCol(i);
+  const size_t end = begin + ((i == 0) ? lastBinSize : binSize);
+
+  // The points before and after the validation subset.
+  if (end == m.n_cols)
+    return arma::Mat<ElementType>(m.memptr(), m.n_rows, begin, false, true);
+  else if (begin == 0)
+    return arma::Mat<ElementType>(m.colptr(end), m.n_rows, m.n_cols - end,
+        false, true);
+  else
+    return arma::join_rows(m.cols(0, begin - 1), m.cols(end, m.n_cols - 1));
 }
 
 template<typename MLAlgorithm,
@@ -409,13 +518,16 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     arma::Row<ElementType>& r,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
-
-  return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
+  const size_t begin = ValidationSubsetFirstCol(i);
+  const size_t end = begin + ((i == 0) ? lastBinSize : binSize);
+
+  // The points before and after the validation subset.
+  if (end == r.n_cols)
+    return arma::Row<ElementType>(r.memptr(), begin, false, true);
+  else if (begin == 0)
+    return arma::Row<ElementType>(r.colptr(end), r.n_cols - end, false, true);
+  else
+    return arma::join_rows(r.cols(0, begin - 1), r.cols(end, r.n_cols - 1));
 }
 
 template<typename MLAlgorithm,
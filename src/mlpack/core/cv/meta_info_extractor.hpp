@@ -240,6 +240,25 @@ struct SelectMethodForm<MLAlgorithm>
   };
 };
 
+/**
+ * A type function that gives the type of the parameters of a trained model, as
+ * returned by its Parameters() method.  It is void* if the model has no
+ * Parameters() method.
+ */
+template<typename MLAlgorithm, typename = void>
+struct ParametersTypeOf
+{
+  using Type = void*;
+};
+
+template<typename MLAlgorithm>
+struct ParametersTypeOf<MLAlgorithm, typename std::conditional<true, void,
+    decltype(std::declval<const MLAlgorithm&>().Parameters())>::type>
+{
+  using Type = typename std::decay<
+      decltype(std::declval<const MLAlgorithm&>().Parameters())>::type;
+};
+
 /**
  * MetaInfoExtractor is a tool for extracting meta information about a given
  * machine learning algorithm. It can be used to automatically extract the type
@@ -345,6 +364,13 @@ class MetaInfoExtractor
    * An indication whether MLAlgorithm takes the numClasses (size_t) parameter.
    */
   static const bool TakesNumClasses = Selects<TF4, TF5>::value;
+
+  /**
+   * The type of the parameters of a trained MLAlgorithm model, which can be
+   * used to warm-start the training of another model.  It is equal to void* if
+   * MLAlgorithm has no Parameters() method.
+   */
+  using ParametersType = typename ParametersTypeOf<MLAlgorithm>::Type;
 };
 
 } // namespace cv
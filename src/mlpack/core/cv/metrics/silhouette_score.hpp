@@ -53,6 +53,25 @@ class SilhouetteScore
                         const arma::Row<size_t>& labels,
                         const Metric& metric);
 
+  /**
+   * Estimate the overall silhouette score from the silhouette scores of a
+   * random sample of the points (each computed exactly, against all the
+   * points).  This takes O(sampleSize * n) time instead of O(n^2), which
+   * makes large datasets tractable.  If sampleSize is at least the number of
+   * points, this is the same as Overall().
+   *
+   * @param X Column-major data used for clustering.
+   * @param labels Labels assigned to data by clustering.
+   * @param metric Metric to be used to calculate dissimilarity.
+   * @param sampleSize Number of points to sample.
+   * @return (double) estimated silhouette score.
+   */
+  template<typename DataType, typename Metric>
+  static double SampledOverall(const DataType& X,
+                               const arma::Row<size_t>& labels,
+                               const Metric& metric,
+                               const size_t sampleSize);
+
   /**
    * Find the individual silhouette scores for precomputted dissimilarites.
    *
@@ -68,6 +87,11 @@ class SilhouetteScore
    * Find silhouette score of all individual elements.
    * (Distance not precomputed).
    *
+   * The distances are computed in blocks of points, in parallel, and summed
+   * for each cluster, so that the full distance matrix is never held in
+   * memory.  For the Euclidean and squared Euclidean distances, each block of
+   * distances is computed with a matrix product.
+   *
    * @param X Column-major data used for clustering.
    * @param labels Labels assigned to data by clustering.
    * @param metric Metric to be used to calculate dissimilarity.
@@ -97,6 +121,63 @@ class SilhouetteScore
    * to maximize the metric.
    */
   static const bool NeedsMinimization = false;
+
+ private:
+  /**
+   * Find the silhouette scores of the given points, against all the points.
+   *
+   * @param X Column-major data used for clustering.
+   * @param labels Labels assigned to data by clustering.
+   * @param points Indices of the points to score.
+   * @param metric Metric to be used to calculate dissimilarity.
+   */
+  template<typename DataType, typename Metric>
+  static arma::rowvec PointsScore(const DataType& X,
+                                  const arma::Row<size_t>& labels,
+                                  const arma::uvec& points,
+                                  const Metric& metric);
+
+  /**
+   * Compute the distances between the given query points and the reference
+   * points with indices in [referenceBegin, referenceEnd), with one row per
+   * query point.
+   */
+  template<typename DataType, typename Metric>
+  static void BlockDistances(const DataType& X,
+                             const arma::uvec& queries,
+                             const size_t referenceBegin,
+                             const size_t referenceEnd,
+                             const Metric& metric,
+                             arma::mat& distances);
+
+  /**
+   * Compute the Euclidean (or squared Euclidean) distances of a block with a
+   * matrix product.
+   */
+  template<typename DataType, bool TakeRoot>
+  static void BlockDistances(const DataType& X,
+                             const arma::uvec& queries,
+                             const size_t referenceBegin,
+                             const size_t referenceEnd,
+                             const metric::LMetric<2, TakeRoot>& metric,
+                             arma::mat& distances);
+
+  /**
+   * Map the labels to cluster indices in [0, number of clusters), and count
+   * the points of each cluster.
+   */
+  static void ClusterIndices(const arma::Row<size_t>& labels,
+                             arma::Row<size_t>& clusters,
+                             arma::Col<size_t>& counts);
+
+  /**
+   * Find the silhouette scores of points given the sums of their distances to
+   * the points of each cluster (one column per point), their clusters, and
+   * the number of points of each cluster.
+   */
+  static arma::rowvec ScoresFromSums(const arma::mat& sums,
+                                     const arma::Row<size_t>& clusters,
+                                     const arma::Col<size_t>& counts);
 };
 
 } // namespace cv
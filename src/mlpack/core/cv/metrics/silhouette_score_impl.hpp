@@ -26,49 +26,45 @@ double SilhouetteScore::Overall(const DataType& X,
   return arma::mean(SamplesScore(X, labels, metric));
 }
 
+template<typename DataType, typename Metric>
+double SilhouetteScore::SampledOverall(const DataType& X,
+                                       const arma::Row<size_t>& labels,
+                                       const Metric& metric,
+                                       const size_t sampleSize)
+{
+  util::CheckSameSizes(X, labels, "SilhouetteScore::SampledOverall()");
+  if (sampleSize >= X.n_cols)
+    return arma::mean(SamplesScore(X, labels, metric));
+
+  if (sampleSize == 0)
+  {
+    Log::Fatal << "SilhouetteScore::SampledOverall(): sampleSize must be "
+        << "positive!" << std::endl;
+  }
+
+  const arma::uvec points = arma::randperm(X.n_cols, sampleSize);
+  return arma::mean(PointsScore(X, labels, points, metric));
+}
+
 template<typename DataType>
 arma::rowvec SilhouetteScore::SamplesScore(const DataType& distances,
                                            const arma::Row<size_t>& labels)
 {
   util::CheckSameSizes(distances, labels, "SilhouetteScore::SamplesScore()");
 
-  // Stores the silhouette scores of individual samples.
-  arma::rowvec sampleScores(distances.n_rows);
-  // Finds one index per cluster.
-  arma::ucolvec clusterLabels = arma::find_unique(labels, false);
+  arma::Row<size_t> clusters;
+  arma::Col<size_t> counts;
+  ClusterIndices(labels, clusters, counts);
 
-  for (size_t i = 0; i < distances.n_rows; i++)
+  // Sum the distances of each element to the elements of each cluster.
+  arma::mat sums(counts.n_elem, distances.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < distances.n_cols; ++i)
   {
-    double interClusterDistance = DBL_MAX, intraClusterDistance = 0;
-    double minInterClusterDistance = DBL_MAX;
-    for (size_t j = 0; j < clusterLabels.n_elem; j++)
-    {
-      size_t clusterLabel = labels(clusterLabels(j));
-      if (labels(i) != clusterLabel) {
-        interClusterDistance = MeanDistanceFromCluster(
-          distances.col(i), labels, clusterLabel, false);
-        if (interClusterDistance < minInterClusterDistance) {
-          minInterClusterDistance = interClusterDistance;
-        }
-      } else {
-        intraClusterDistance = MeanDistanceFromCluster(
-          distances.col(i), labels, clusterLabel, true);
-        if (intraClusterDistance == 0) {
-          // s(i) = 0, no more calculation needed.
-          break;
-        }
-      }
-    }
-    if (intraClusterDistance == 0) {
-      // i is the only element in the cluster.
-      sampleScores(i) = 0.0;
-    } else {
-      sampleScores(i) = minInterClusterDistance - intraClusterDistance;
-      sampleScores(i) /= std::max(
-        intraClusterDistance, minInterClusterDistance);
-    }
+    for (size_t j = 0; j < distances.n_rows; ++j)
+      sums(clusters[j], i) += distances(j, i);
   }
-  return sampleScores;
+
+  return ScoresFromSums(sums, clusters, counts);
 }
 
 template<typename DataType, typename Metric>
@@ -77,8 +73,155 @@ arma::rowvec SilhouetteScore::SamplesScore(const DataType& X,
                                            const Metric& metric)
 {
   util::CheckSameSizes(X, labels, "SilhouetteScore::SamplesScore()");
-  DataType distances = PairwiseDistances(X, metric);
-  return SamplesScore(distances, labels);
+  if (X.n_cols == 0)
+    return arma::rowvec();
+
+  return PointsScore(X, labels, arma::regspace<arma::uvec>(0, X.n_cols - 1),
+      metric);
+}
+
+template<typename DataType, typename Metric>
+arma::rowvec SilhouetteScore::PointsScore(const DataType& X,
+                                          const arma::Row<size_t>& labels,
+                                          const arma::uvec& points,
+                                          const Metric& metric)
+{
+  arma::Row<size_t> clusters;
+  arma::Col<size_t> counts;
+  ClusterIndices(labels, clusters, counts);
+
+  // For each block of points, the distances to each block of all the points
+  // are computed and summed for each cluster, so only one block of distances
+  // per thread is held in memory.
+  const size_t blockSize = 512;
+  const size_t numBlocks = (points.n_elem + blockSize - 1) / blockSize;
+  arma::mat sums(counts.n_elem, points.n_elem);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_elem);
+    const arma::uvec queries = points.subvec(begin, end - 1);
+
+    // The sums of this block, with one column per cluster.
+    arma::mat blockSums(queries.n_elem, counts.n_elem, arma::fill::zeros);
+    arma::mat distances;
+    for (size_t r = 0; r < X.n_cols; r += blockSize)
+    {
+      const size_t referenceEnd = std::min(r + blockSize, (size_t) X.n_cols);
+      BlockDistances(X, queries, r, referenceEnd, metric, distances);
+      for (size_t j = r; j < referenceEnd; ++j)
+        blockSums.col(clusters[j]) += distances.col(j - r);
+    }
+
+    sums.cols(begin, end - 1) = blockSums.t();
+  }
+
+  return ScoresFromSums(sums, clusters.cols(points), counts);
+}
+
+template<typename DataType, typename Metric>
+void SilhouetteScore::BlockDistances(const DataType& X,
+                                     const arma::uvec& queries,
+                                     const size_t referenceBegin,
+                                     const size_t referenceEnd,
+                                     const Metric& metric,
+                                     arma::mat& distances)
+{
+  distances.set_size(queries.n_elem, referenceEnd - referenceBegin);
+  for (size_t r = referenceBegin; r < referenceEnd; ++r)
+  {
+    for (size_t q = 0; q < queries.n_elem; ++q)
+    {
+      distances(q, r - referenceBegin) = metric.Evaluate(X.col(queries[q]),
+          X.col(r));
+    }
+  }
+}
+
+template<typename DataType, bool TakeRoot>
+void SilhouetteScore::BlockDistances(const DataType& X,
+                                     const arma::uvec& queries,
+                                     const size_t referenceBegin,
+                                     const size_t referenceEnd,
+                                     const metric::LMetric<2, TakeRoot>&
+                                         /* metric */,
+                                     arma::mat& distances)
+{
+  // ||q - r||^2 = ||q||^2 + ||r||^2 - 2 q^T r.
+  const arma::mat queryPoints = arma::conv_to<arma::mat>::from(
+      X.cols(queries));
+  const arma::mat referencePoints = arma::conv_to<arma::mat>::from(
+      X.cols(referenceBegin, referenceEnd - 1));
+
+  distances = -2.0 * queryPoints.t() * referencePoints;
+  distances.each_col() += arma::sum(arma::square(queryPoints), 0).t();
+  distances.each_row() += arma::sum(arma::square(referencePoints), 0);
+
+  // Remove the negative values caused by cancellation, and make the distance
+  // of each point to itself exactly zero.
+  distances.transform([](double d) { return std::max(d, 0.0); });
+  for (size_t q = 0; q < queries.n_elem; ++q)
+  {
+    if (queries[q] >= referenceBegin && queries[q] < referenceEnd)
+      distances(q, queries[q] - referenceBegin) = 0.0;
+  }
+
+  if (TakeRoot)
+    distances = arma::sqrt(distances);
+}
+
+inline void SilhouetteScore::ClusterIndices(const arma::Row<size_t>& labels,
+                                            arma::Row<size_t>& clusters,
+                                            arma::Col<size_t>& counts)
+{
+  const arma::Row<size_t> uniqueLabels = arma::unique(labels);
+  clusters.set_size(labels.n_elem);
+  counts.zeros(uniqueLabels.n_elem);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    clusters[i] = std::lower_bound(uniqueLabels.begin(), uniqueLabels.end(),
+        labels[i]) - uniqueLabels.begin();
+    ++counts[clusters[i]];
+  }
+}
+
+inline arma::rowvec SilhouetteScore::ScoresFromSums(
+    const arma::mat& sums,
+    const arma::Row<size_t>& clusters,
+    const arma::Col<size_t>& counts)
+{
+  // Stores the silhouette scores of individual samples.
+  arma::rowvec sampleScores(clusters.n_elem);
+  for (size_t i = 0; i < clusters.n_elem; ++i)
+  {
+    const size_t cluster = clusters[i];
+    const double intraClusterDistance = (counts[cluster] > 1) ?
+        sums(cluster, i) / (counts[cluster] - 1) : 0.0;
+    if (intraClusterDistance == 0)
+    {
+      // i is the only element in the cluster (or all the elements of the
+      // cluster are the same).
+      sampleScores[i] = 0.0;
+      continue;
+    }
+
+    double minInterClusterDistance = DBL_MAX;
+    for (size_t c = 0; c < counts.n_elem; ++c)
+    {
+      if (c != cluster)
+      {
+        minInterClusterDistance = std::min(minInterClusterDistance,
+            sums(c, i) / counts[c]);
+      }
+    }
+
+    sampleScores[i] = (minInterClusterDistance - intraClusterDistance) /
+        std::max(intraClusterDistance, minInterClusterDistance);
+  }
+
+  return sampleScores;
 }
 
 double SilhouetteScore::MeanDistanceFromCluster(const arma::colvec& distances,
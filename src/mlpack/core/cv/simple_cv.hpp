@@ -198,6 +198,19 @@ class SimpleCV
            const size_t numClasses,
            WeightsInType&& weights);
 
+  /**
+   * Copy the given SimpleCV object, but train only on the first subsetRatio
+   * fraction of its training set (at least one point).  The validation set is
+   * the same, and the last trained model is not copied.  HyperParameterTuner
+   * uses this to evaluate candidates in parallel and on growing subsets of the
+   * data.
+   *
+   * @param other SimpleCV object to copy.
+   * @param subsetRatio Fraction of the training set to train on (more than 0
+   *     and not more than 1).
+   */
+  SimpleCV(const SimpleCV& other, const double subsetRatio = 1.0);
+
   /**
    * Train on the training set and assess performance on the validation set by
    * using the class Metric.
@@ -211,6 +224,15 @@ class SimpleCV
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
+  /**
+   * Get whether each call to Evaluate() warm-starts the training from the
+   * model of the previous call, when MLAlgorithm supports it (see
+   * CVBase::WarmStartTrain()).  Weighted training always starts from scratch.
+   */
+  bool WarmStart() const { return warmStart; }
+  //! Modify whether each call to Evaluate() warm-starts the training.
+  bool& WarmStart() { return warmStart; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -240,6 +262,11 @@ class SimpleCV
   //! The pointer to the last trained model.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! Whether to warm-start the training from the previous model.
+  bool warmStart;
+  //! The parameters of the previous model, for warm starts.
+  typename Base::MIE::ParametersType warmStartParameters;
+
   /**
    * Assert data consistency and initialize fields required for running
    * cross-validation.
@@ -269,6 +296,19 @@ class SimpleCV
    */
   size_t CalculateAndAssertNumberOfTrainingPoints(const double validationSize);
 
+  /**
+   * Initialize the training weights with the first numberOfTrainingPoints
+   * weights, if there are any weights.
+   */
+  template<typename WeightsInType>
+  void InitTrainingWeights(WeightsInType& weights,
+                           const size_t numberOfTrainingPoints);
+
+  /**
+   * Do nothing, since weights are not supported.
+   */
+  void InitTrainingWeights(void* weights, const size_t numberOfTrainingPoints);
+
   /**
    * Get the specified submatrix without coping the data.
    */
@@ -143,7 +143,9 @@ SimpleCV<MLAlgorithm,
                                 PIT&& ys) :
     base(std::move(base)),
     xs(std::forward<MIT>(xs)),
-    ys(std::forward<PIT>(ys))
+    ys(std::forward<PIT>(ys)),
+    warmStart(false),
+    warmStartParameters()
 {
   Base::AssertDataConsistency(this->xs, this->ys);
 
@@ -182,6 +184,40 @@ SimpleCV<MLAlgorithm,
   trainingWeights = GetSubset(this->weights, 0, trainingXs.n_cols - 1);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+SimpleCV<MLAlgorithm,
+         Metric,
+         MatType,
+         PredictionsType,
+         WeightsType>::SimpleCV(const SimpleCV& other,
+                                const double subsetRatio) :
+    base(other.base),
+    xs(other.xs),
+    ys(other.ys),
+    weights(other.weights),
+    warmStart(other.warmStart),
+    warmStartParameters()
+{
+  if (subsetRatio <= 0.0 || subsetRatio > 1.0)
+    throw std::invalid_argument("SimpleCV: the subsetRatio parameter should "
+        "be more than 0 and not more than 1");
+
+  const size_t numberOfTrainingPoints = other.trainingXs.n_cols;
+  const size_t subsetSize = std::min(numberOfTrainingPoints, std::max(
+      (size_t) 1, (size_t) std::ceil(subsetRatio * numberOfTrainingPoints)));
+
+  trainingXs = GetSubset(xs, 0, subsetSize - 1);
+  trainingYs = GetSubset(ys, 0, subsetSize - 1);
+  InitTrainingWeights(weights, subsetSize);
+
+  validationXs = GetSubset(xs, numberOfTrainingPoints, xs.n_cols - 1);
+  validationYs = GetSubset(ys, numberOfTrainingPoints, xs.n_cols - 1);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -243,6 +279,40 @@ size_t SimpleCV<MLAlgorithm,
   return trainingPoints;
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename WeightsInType>
+void SimpleCV<MLAlgorithm,
+              Metric,
+              MatType,
+              PredictionsType,
+              WeightsType>::InitTrainingWeights(
+    WeightsInType& weights,
+    const size_t numberOfTrainingPoints)
+{
+  if (weights.n_elem > 0)
+    trainingWeights = GetSubset(weights, 0, numberOfTrainingPoints - 1);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void SimpleCV<MLAlgorithm,
+              Metric,
+              MatType,
+              PredictionsType,
+              WeightsType>::InitTrainingWeights(
+    void* /* weights */,
+    const size_t /* numberOfTrainingPoints */)
+{
+  // Nothing to do.
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -293,7 +363,12 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  if (warmStart)
+    modelPtr.reset(new MLAlgorithm(base.WarmStartTrain(trainingXs, trainingYs,
+        warmStartParameters, args...)));
+  else
+    modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs,
+        args...)));
 
   return Metric::Evaluate(*modelPtr, validationXs, validationYs);
 }
@@ -313,6 +388,9 @@ double SimpleCV<MLAlgorithm,
   if (trainingWeights.n_elem > 0)
     modelPtr.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, trainingWeights, args...)));
+  else if (warmStart)
+    modelPtr.reset(new MLAlgorithm(base.WarmStartTrain(trainingXs, trainingYs,
+        warmStartParameters, args...)));
   else
     modelPtr.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, args...)));
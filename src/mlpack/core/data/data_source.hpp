@@ -0,0 +1,162 @@
+/**
+ * @file core/data/data_source.hpp
+ *
+ * Definition of the DataSource class, which reads a dataset from disk in
+ * batches of points, so that models can be trained on datasets that do not fit
+ * in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DATA_SOURCE_HPP
+#define MLPACK_CORE_DATA_DATA_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+#include <future>
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The DataSource class reads a dataset from a file in batches of points, so
+ * that only one batch (plus the next one, if prefetching is enabled) is held in
+ * memory at a time.  Like data::Load(), each point is returned as a column of
+ * the batch.  If prefetching is enabled, the next batch is read on a
+ * background thread while the current one is used, so that reading the file
+ * overlaps with computation.
+ *
+ * Two file formats are supported, determined by the extension of the file:
+ *
+ *  - Numeric text files (.csv, .tsv, .txt), with one point per line and the
+ *    values separated by commas, tabs or spaces.
+ *  - Armadillo binary files (.bin), as written by
+ *    data::Save(filename, matrix, true, false, arma::arma_binary).  Like for
+ *    MappedMatrix, the file must hold one point per column, so it should be
+ *    saved with transpose = false.
+ *
+ * HDF5 files can't be read in parts with Armadillo, so they are not supported;
+ * convert them to Armadillo binary first.
+ *
+ * A typical loop over a DataSource is:
+ *
+ * @code
+ * data::DataSource<> source("dataset.csv", 10000);
+ * arma::mat batch;
+ * while (source.Next(batch))
+ * {
+ *   // Use the batch.
+ * }
+ * @endcode
+ *
+ * @tparam MatType Type of matrix to read into.
+ */
+template<typename MatType = arma::mat>
+class DataSource
+{
+ public:
+  //! The element type of the matrix.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Open the given file, and start reading the first batch if prefetching is
+   * enabled.  Throws std::runtime_error if the file can't be opened or read,
+   * and std::invalid_argument if the format is not supported.
+   *
+   * @param filename Name of the file to read.
+   * @param batchSize Number of points in each batch.
+   * @param prefetch If true, read the next batch on a background thread.
+   */
+  DataSource(const std::string& filename,
+             const size_t batchSize,
+             const bool prefetch = true);
+
+  //! Wait for any background read to finish and close the file.
+  ~DataSource();
+
+  // The file can't be shared between objects.
+  DataSource(const DataSource&) = delete;
+  DataSource& operator=(const DataSource&) = delete;
+
+  /**
+   * Get the next batch of points.  The last batch of the file may have fewer
+   * than BatchSize() points.  Throws std::runtime_error if the file can't be
+   * parsed.
+   *
+   * @param batch Matrix to store the batch in.
+   * @return false if there are no more points in the file.
+   */
+  bool Next(MatType& batch);
+
+  //! Go back to the beginning of the file.
+  void Reset();
+
+  //! Get the number of dimensions of the points.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+
+ private:
+  //! Read the next batch from the file; return false at the end of the file.
+  bool ReadBatch(MatType& batch);
+
+  //! Read the next batch from a text file.
+  bool ReadTextBatch(MatType& batch);
+
+  //! Read the next batch from an Armadillo binary file.
+  bool ReadBinaryBatch(MatType& batch);
+
+  //! Start reading the next batch on a background thread.
+  void Prefetch();
+
+  /**
+   * Parse the values of a line of a text file.  If values is NULL, the values
+   * are only counted.  Throws std::runtime_error if the line can't be parsed or
+   * holds more than maxValues values.
+   *
+   * @param line Line to parse.
+   * @param values Array to store the values in, or NULL.
+   * @param maxValues Maximum number of values on the line.
+   * @return The number of values on the line.
+   */
+  size_t ParseLine(const std::string& line,
+                   ElemType* values,
+                   const size_t maxValues) const;
+
+  //! Name of the file.
+  std::string filename;
+  //! Number of points in each batch.
+  size_t batchSize;
+  //! If true, the next batch is read on a background thread.
+  bool prefetch;
+  //! If true, the file is an Armadillo binary file.
+  bool binary;
+  //! The opened file.
+  std::ifstream stream;
+  //! Position of the first point in the file.
+  std::streampos dataStart;
+  //! Number of dimensions of the points.
+  size_t dimensionality;
+  //! Number of points in the file (only known for binary files).
+  size_t points;
+  //! Number of points read so far.
+  size_t pointsRead;
+  //! Number of the line that is read next (for error messages).
+  size_t line;
+  //! The batch being read on the background thread.
+  MatType nextBatch;
+  //! The result of the background read.
+  std::future<bool> pending;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "data_source_impl.hpp"
+
+#endif
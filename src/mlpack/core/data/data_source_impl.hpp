@@ -0,0 +1,245 @@
+/**
+ * @file core/data/data_source_impl.hpp
+ *
+ * Implementation of the DataSource class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DATA_SOURCE_IMPL_HPP
+#define MLPACK_CORE_DATA_DATA_SOURCE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "data_source.hpp"
+#include "extension.hpp"
+
+#include <cstdlib>
+
+namespace mlpack {
+namespace data {
+
+template<typename MatType>
+DataSource<MatType>::DataSource(const std::string& filename,
+                                const size_t batchSize,
+                                const bool prefetch) :
+    filename(filename),
+    batchSize(batchSize),
+    prefetch(prefetch),
+    binary(false),
+    dimensionality(0),
+    points(0),
+    pointsRead(0),
+    line(0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("DataSource::DataSource(): batch size must "
+        "be positive");
+  }
+
+  const std::string extension = Extension(filename);
+  if (extension == "bin")
+  {
+    binary = true;
+  }
+  else if (extension != "csv" && extension != "tsv" && extension != "txt")
+  {
+    throw std::invalid_argument("DataSource::DataSource(): cannot read file '"
+        + filename + "' in parts; only text (csv, tsv, txt) and Armadillo "
+        "binary (bin) files are supported");
+  }
+
+  stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("DataSource::DataSource(): cannot open file '" +
+        filename + "'");
+  }
+
+  if (binary)
+  {
+    // The Armadillo binary header is the type string, then the dimensions,
+    // each on its own line.
+    std::string header;
+    std::getline(stream, header);
+    stream >> dimensionality >> points;
+    stream.get();
+    if (!stream || header != arma::diskio::gen_bin_header(
+        arma::Mat<ElemType>()))
+    {
+      throw std::runtime_error("DataSource::DataSource(): file '" + filename +
+          "' is not an Armadillo binary file with header " +
+          arma::diskio::gen_bin_header(arma::Mat<ElemType>()));
+    }
+  }
+  else
+  {
+    // The number of values on the first line that is not empty gives the
+    // dimensionality.
+    std::string text;
+    const size_t maxValues = std::numeric_limits<size_t>::max();
+    while (dimensionality == 0 && std::getline(stream, text))
+      dimensionality = ParseLine(text, NULL, maxValues);
+
+    stream.clear();
+    stream.seekg(0, std::ios::beg);
+  }
+
+  dataStart = stream.tellg();
+  if (prefetch)
+    Prefetch();
+}
+
+template<typename MatType>
+DataSource<MatType>::~DataSource()
+{
+  if (pending.valid())
+    pending.wait();
+}
+
+template<typename MatType>
+bool DataSource<MatType>::Next(MatType& batch)
+{
+  if (!pending.valid())
+    return ReadBatch(batch);
+
+  // Wait for the background read; this rethrows any exception of the read.
+  if (!pending.get())
+    return false;
+
+  batch.swap(nextBatch);
+  Prefetch();
+  return true;
+}
+
+template<typename MatType>
+void DataSource<MatType>::Reset()
+{
+  if (pending.valid())
+    pending.wait();
+  pending = std::future<bool>();
+
+  stream.clear();
+  stream.seekg(dataStart);
+  pointsRead = 0;
+  line = 0;
+
+  if (prefetch)
+    Prefetch();
+}
+
+template<typename MatType>
+void DataSource<MatType>::Prefetch()
+{
+  pending = std::async(std::launch::async,
+      [this]() { return ReadBatch(nextBatch); });
+}
+
+template<typename MatType>
+bool DataSource<MatType>::ReadBatch(MatType& batch)
+{
+  return binary ? ReadBinaryBatch(batch) : ReadTextBatch(batch);
+}
+
+template<typename MatType>
+bool DataSource<MatType>::ReadTextBatch(MatType& batch)
+{
+  batch.set_size(dimensionality, batchSize);
+
+  size_t col = 0;
+  std::string text;
+  while (col < batchSize && std::getline(stream, text))
+  {
+    ++line;
+    const size_t values = ParseLine(text, batch.colptr(col), dimensionality);
+
+    // Skip empty lines.
+    if (values == 0)
+      continue;
+
+    if (values != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "DataSource::Next(): wrong number of dimensions (" << values
+          << ") on line " << line << " of '" << filename << "'; should be "
+          << dimensionality << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++col;
+  }
+
+  if (col == 0)
+    return false;
+
+  if (col < batchSize)
+    batch.resize(dimensionality, col);
+
+  pointsRead += col;
+  return true;
+}
+
+template<typename MatType>
+bool DataSource<MatType>::ReadBinaryBatch(MatType& batch)
+{
+  if (pointsRead == points)
+    return false;
+
+  const size_t cols = std::min(batchSize, points - pointsRead);
+  batch.set_size(dimensionality, cols);
+  stream.read((char*) batch.memptr(), batch.n_elem * sizeof(ElemType));
+  if (!stream)
+  {
+    throw std::runtime_error("DataSource::Next(): file '" + filename +
+        "' is too short for its dimensions");
+  }
+
+  pointsRead += cols;
+  return true;
+}
+
+template<typename MatType>
+size_t DataSource<MatType>::ParseLine(const std::string& text,
+                                      ElemType* values,
+                                      const size_t maxValues) const
+{
+  size_t count = 0;
+  const char* p = text.c_str();
+  while (true)
+  {
+    while (*p == ' ' || *p == '\t' || *p == '\r')
+      ++p;
+    if (*p == '\0')
+      break;
+
+    char* end;
+    const double value = std::strtod(p, &end);
+    if (end == p || count == maxValues)
+    {
+      std::ostringstream oss;
+      oss << "DataSource::Next(): parsing error on line " << line << " of '"
+          << filename << "'!";
+      throw std::runtime_error(oss.str());
+    }
+
+    if (values != NULL)
+      values[count] = ElemType(value);
+    ++count;
+
+    // Skip the delimiter.
+    p = end;
+    while (*p == ' ' || *p == '\t' || *p == '\r')
+      ++p;
+    if (*p == ',')
+      ++p;
+  }
+
+  return count;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -16,8 +16,11 @@
 #define MLPACK_CORE_DATA_DATASET_INFO_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/cereal/template_class_version.hpp>
 #include <unordered_map>
 
+#include "interned_string_map.hpp"
+
 #include "map_policies/increment_policy.hpp"
 
 namespace mlpack {
@@ -32,7 +35,10 @@ namespace data {
  *
  * DatasetMapper objects can also map from arbitrary types; the type to map from
  * can be specified with the InputType template parameter.  By default, the
- * InputType parameter is std::string.
+ * InputType parameter is std::string.  The mappings from strings are held in
+ * an InternedStringMap for each dimension, so that mapping the tokens of a
+ * file doesn't allocate memory for each token, and copying or serializing
+ * the mappings is cheap.
  *
  * @tparam PolicyType Mapping policy used to specify MapString().
  * @tparam InputType Type of input to be mapped.
@@ -147,15 +153,21 @@ class DatasetMapper
    */
   size_t Dimensionality() const;
 
+  /**
+   * Return a DatasetMapper that holds the types and mappings of only the given
+   * dimensions, in the given order, and a copy of the policy; dimension i of
+   * the result is dimension dimensions[i] of this object.  This is useful when
+   * only some of the dimensions of a dataset are loaded.
+   *
+   * @param dimensions Dimensions to keep.
+   */
+  DatasetMapper Subset(const std::vector<size_t>& dimensions) const;
+
   /**
    * Serialize the dataset information.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
-  {
-    ar(CEREAL_NVP(types));
-    ar(CEREAL_NVP(maps));
-  }
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Return the policy of the mapper.
   const PolicyType& Policy() const;
@@ -169,9 +181,11 @@ class DatasetMapper
   //! Types of each dimension.
   std::vector<Datatype> types;
 
-  // Forward mapping type.
-  using ForwardMapType = typename std::unordered_map<InputType, typename
-      PolicyType::MappedType>;
+  // Forward mapping type.  Strings are interned.
+  using ForwardMapType = typename std::conditional<
+      std::is_same<InputType, std::string>::value,
+      InternedStringMap<typename PolicyType::MappedType>,
+      std::unordered_map<InputType, typename PolicyType::MappedType>>::type;
 
   // Reverse mapping type.  Multiple inputs may map to a single output, hence
   // the need for std::vector.
@@ -198,6 +212,12 @@ using DatasetInfo = DatasetMapper<data::IncrementPolicy>;
 } // namespace data
 } // namespace mlpack
 
+//! Set the serialization version of the DatasetMapper class.  Version 0
+//! stored the mappings from strings as std::unordered_maps.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename PolicyType,
+    typename InputType>), (mlpack::data::DatasetMapper<PolicyType, InputType>),
+    (1));
+
 #include "dataset_mapper_impl.hpp"
 
 #endif
@@ -230,6 +230,64 @@ inline size_t DatasetMapper<PolicyType, InputType>::Dimensionality() const
   return types.size();
 }
 
+template<typename PolicyType, typename InputType>
+inline DatasetMapper<PolicyType, InputType>
+DatasetMapper<PolicyType, InputType>::Subset(
+    const std::vector<size_t>& dimensions) const
+{
+  DatasetMapper subset(dimensions.size());
+  subset.policy = policy;
+  for (size_t i = 0; i < dimensions.size(); ++i)
+  {
+    if (dimensions[i] >= types.size())
+    {
+      std::ostringstream oss;
+      oss << "DatasetMapper::Subset(): dimension " << dimensions[i]
+          << " is out of range; there are only " << types.size()
+          << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+
+    subset.types[i] = types[dimensions[i]];
+    typename MapType::const_iterator it = maps.find(dimensions[i]);
+    if (it != maps.end())
+      subset.maps[i] = it->second;
+  }
+
+  return subset;
+}
+
+template<typename PolicyType, typename InputType>
+template<typename Archive>
+void DatasetMapper<PolicyType, InputType>::serialize(Archive& ar,
+                                                     const uint32_t version)
+{
+  ar(CEREAL_NVP(types));
+  if (version > 0)
+  {
+    ar(CEREAL_NVP(maps));
+    return;
+  }
+
+  // Version 0 held std::unordered_maps as forward mappings; this is only used
+  // when loading.
+  typedef std::unordered_map<InputType, typename PolicyType::MappedType>
+      OldForwardMapType;
+  std::unordered_map<size_t, std::pair<OldForwardMapType, ReverseMapType>>
+      oldMaps;
+  ar(cereal::make_nvp("maps", oldMaps));
+
+  maps.clear();
+  for (auto& dimension : oldMaps)
+  {
+    std::pair<ForwardMapType, ReverseMapType>& mappings =
+        maps[dimension.first];
+    for (const auto& mapping : dimension.second.first)
+      mappings.first.insert(mapping);
+    mappings.second = std::move(dimension.second.second);
+  }
+}
+
 template<typename PolicyType, typename InputType>
 inline const PolicyType& DatasetMapper<PolicyType, InputType>::Policy() const
 {
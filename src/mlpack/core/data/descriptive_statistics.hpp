@@ -0,0 +1,310 @@
+/**
+ * @file core/data/descriptive_statistics.hpp
+ *
+ * DescriptiveStatistics class, which computes the moments, extrema and
+ * quantiles of each dimension of a dataset in a single pass over the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DESCRIPTIVE_STATISTICS_HPP
+#define MLPACK_CORE_DATA_DESCRIPTIVE_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "quantile_sketch.hpp"
+#include "scaler_methods/column_statistics.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The DescriptiveStatistics class holds the number of points, and the mean,
+ * the sums of the second, third and fourth powers of the deviations from the
+ * mean, the minimum, the maximum and a QuantileSketch of each dimension of a
+ * dataset.  From them, the variance, skewness, kurtosis and (approximate)
+ * quantiles of each dimension are computed, without holding the dataset in
+ * memory.  The count, mean, second moment and extrema are a ColumnStatistics
+ * object; the third and fourth moments are built on top of it.  Each chunk of
+ * points given to Update() is summarized on its own (the ColumnStatistics of
+ * the chunk, then the third and fourth moments around the mean of the chunk),
+ * and merged into the statistics with the pairwise formulas of Pebay.  So a
+ * dataset can be given to Update() in chunks, for instance the batches of a
+ * DataSource, and the statistics of chunks processed elsewhere can be combined
+ * with Merge().
+ *
+ * With OpenMP, each call to Update() is parallel: the ColumnStatistics of the
+ * chunk are computed by blocks of points, and the higher moments and sketches
+ * by ranges of dimensions.
+ *
+ * @code
+ * DescriptiveStatistics statistics;
+ * DataSource<> source("dataset.csv", 100000);
+ * arma::mat batch;
+ * while (source.Next(batch))
+ *   statistics.Update(batch);
+ * arma::vec skewness = statistics.Skewness();
+ * arma::vec median = statistics.Median();
+ * @endcode
+ */
+class DescriptiveStatistics
+{
+ public:
+  /**
+   * Create an empty object, with no points.
+   *
+   * @param sketchCapacity Capacity of the quantile sketch of each dimension;
+   *     the quantiles of up to this many points are exact.
+   */
+  DescriptiveStatistics(const size_t sketchCapacity = 512) :
+      sketchCapacity(sketchCapacity)
+  { }
+
+  /**
+   * Add the points (columns) of the given dataset to the statistics.  The
+   * dimensionality of the dataset must be the same for every call.
+   *
+   * @param input Dataset to add.
+   */
+  template<typename MatType>
+  void Update(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (Count() > 0 && input.n_rows != Dimensionality())
+    {
+      std::ostringstream oss;
+      oss << "DescriptiveStatistics::Update(): dataset has " << input.n_rows
+          << " dimensions, but previous data had " << Dimensionality();
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (Count() == 0)
+      sketches.assign(input.n_rows, QuantileSketch(sketchCapacity));
+
+    ColumnStatistics chunk;
+    chunk.Update(input);
+
+    // The third and fourth moments of the chunk, around its mean.  Each thread
+    // owns a range of dimensions, so the values are given to each sketch in
+    // order.
+    arma::vec chunkM3(input.n_rows, arma::fill::zeros);
+    arma::vec chunkM4(input.n_rows, arma::fill::zeros);
+
+    #ifdef HAS_OPENMP
+    const size_t threads = (size_t) omp_get_max_threads();
+    #else
+    const size_t threads = 1;
+    #endif
+
+    const size_t blocks = std::min(threads, (size_t) input.n_rows);
+    const double* meanPtr = chunk.Mean().memptr();
+    double* m3Ptr = chunkM3.memptr();
+    double* m4Ptr = chunkM4.memptr();
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t first = b * input.n_rows / blocks;
+      const size_t last = (b + 1) * input.n_rows / blocks;
+      for (size_t j = 0; j < input.n_cols; ++j)
+      {
+        const typename MatType::elem_type* x = input.colptr(j);
+        for (size_t i = first; i < last; ++i)
+        {
+          const double value = (double) x[i];
+          const double delta = value - meanPtr[i];
+          const double delta2 = delta * delta;
+          m3Ptr[i] += delta2 * delta;
+          m4Ptr[i] += delta2 * delta2;
+          sketches[i].Insert(value);
+        }
+      }
+    }
+
+    MergeMoments(chunk, chunkM3, chunkM4);
+  }
+
+  /**
+   * Merge the statistics of other points into these statistics.
+   *
+   * @param other Statistics of the other points.
+   */
+  void Merge(const DescriptiveStatistics& other)
+  {
+    if (other.Count() == 0)
+      return;
+
+    if (Count() == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    if (other.Dimensionality() != Dimensionality())
+    {
+      std::ostringstream oss;
+      oss << "DescriptiveStatistics::Merge(): merged statistics have "
+          << other.Dimensionality() << " dimensions, but these statistics "
+          << "have " << Dimensionality();
+      throw std::invalid_argument(oss.str());
+    }
+
+    MergeMoments(other.columns, other.m3, other.m4);
+    for (size_t i = 0; i < sketches.size(); ++i)
+      sketches[i].Merge(other.sketches[i]);
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return columns.Count(); }
+  //! Get the number of dimensions.
+  size_t Dimensionality() const { return columns.Mean().n_elem; }
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return columns.Mean(); }
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return columns.Min(); }
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return columns.Max(); }
+
+  /**
+   * Get the variance of each dimension.
+   *
+   * @param population If true, the points are the population; otherwise they
+   *     are a sample, and the unbiased variance is returned.
+   */
+  arma::vec Variance(const bool population = false) const
+  {
+    const double n = (double) Count();
+    return columns.M2() / (population ? n : n - 1);
+  }
+
+  /**
+   * Get the standard deviation of each dimension.
+   *
+   * @param population If true, the points are the population; otherwise they
+   *     are a sample.
+   */
+  arma::vec StandardDeviation(const bool population = false) const
+  {
+    return arma::sqrt(Variance(population));
+  }
+
+  /**
+   * Get the skewness of each dimension.
+   *
+   * @param population If true, the points are the population; otherwise they
+   *     are a sample, and the sample skewness is returned.
+   */
+  arma::vec Skewness(const bool population = false) const
+  {
+    const double n = (double) Count();
+    const arma::vec s3 = arma::pow(StandardDeviation(population), 3);
+    if (population)
+      return m3 / (n * s3);
+    return n * m3 / ((n - 1) * (n - 2) * s3);
+  }
+
+  /**
+   * Get the excess kurtosis of each dimension.
+   *
+   * @param population If true, the points are the population; otherwise they
+   *     are a sample, and the sample excess kurtosis is returned.
+   */
+  arma::vec Kurtosis(const bool population = false) const
+  {
+    const double n = (double) Count();
+    if (population)
+      return n * m4 / arma::square(columns.M2()) - 3;
+
+    const arma::vec s4 = arma::square(Variance(false));
+    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+    return normC * m4 / s4 - norm3;
+  }
+
+  /**
+   * Estimate the given quantile of the given dimension with its sketch.
+   *
+   * @param dimension Dimension to get the quantile of.
+   * @param q Quantile to estimate, in [0, 1].
+   */
+  double Quantile(const size_t dimension, const double q) const
+  {
+    return sketches[dimension].Quantile(q);
+  }
+
+  //! Estimate the median of each dimension.
+  arma::vec Median() const
+  {
+    arma::vec median(sketches.size());
+    for (size_t i = 0; i < sketches.size(); ++i)
+      median[i] = sketches[i].Quantile(0.5);
+    return median;
+  }
+
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(sketchCapacity));
+    ar(CEREAL_NVP(columns));
+    ar(CEREAL_NVP(m3));
+    ar(CEREAL_NVP(m4));
+    ar(CEREAL_NVP(sketches));
+  }
+
+ private:
+  /**
+   * Merge the moments of other points, given by their ColumnStatistics and
+   * their sums of the third and fourth powers of the deviations from their
+   * mean, into these statistics.  The sketches are not changed.
+   */
+  void MergeMoments(const ColumnStatistics& other,
+                    const arma::vec& otherM3,
+                    const arma::vec& otherM4)
+  {
+    if (Count() == 0)
+    {
+      columns = other;
+      m3 = otherM3;
+      m4 = otherM4;
+      return;
+    }
+
+    const double na = (double) Count();
+    const double nb = (double) other.Count();
+    const double n = na + nb;
+    const arma::vec delta = other.Mean() - columns.Mean();
+    const arma::vec delta2 = arma::square(delta);
+    const arma::vec& m2 = columns.M2();
+    const arma::vec& otherM2 = other.M2();
+
+    m4 += otherM4 + arma::square(delta2) * (na * nb * (na * na - na * nb +
+        nb * nb) / (n * n * n)) + 6 * delta2 % (na * na * otherM2 + nb * nb *
+        m2) / (n * n) + 4 * delta % (na * otherM3 - nb * m3) / n;
+    m3 += otherM3 + delta2 % delta * (na * nb * (na - nb) / (n * n)) +
+        3 * delta % (na * otherM2 - nb * m2) / n;
+    columns.Merge(other);
+  }
+
+  //! The capacity of the quantile sketch of each dimension.
+  size_t sketchCapacity;
+  //! The number of points, and the mean, sum of squared deviations from the
+  //! mean, minimum and maximum of each dimension.
+  ColumnStatistics columns;
+  //! The sum of cubed deviations from the mean of each dimension.
+  arma::vec m3;
+  //! The sum of fourth powers of deviations from the mean of each dimension.
+  arma::vec m4;
+  //! The quantile sketch of each dimension.
+  std::vector<QuantileSketch> sketches;
+}; // class DescriptiveStatistics
+
+} // namespace data
+} // namespace mlpack
+
+#endif
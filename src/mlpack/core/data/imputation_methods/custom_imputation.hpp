@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_CUSTOM_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -71,6 +72,27 @@ class CustomImputation
     }
   }
 
+  /**
+   * Impute function for several dimensions at once.  The missing values of all
+   * the given dimensions are replaced with the custom value in a single
+   * parallel pass over the input.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckMissingValues(mappedValues, dimensions);
+    details::ReplaceMissing(input, mappedValues, dimensions,
+        std::vector<double>(dimensions.size(), customValue), columnMajor);
+  }
+
  private:
   //! A user-defined value that the user wants to replace missing values with.
   T customValue;
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_LISTWISE_DELETION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -66,6 +67,57 @@ class ListwiseDeletion
       input = input.rows(arma::uvec(colsToKeep));
     }
   }
+
+  /**
+   * Impute function for several dimensions at once: remove every point (column
+   * or row) that has a missing value in any of the given dimensions.  The
+   * points are checked in a single parallel pass, and the kept points are then
+   * copied once, instead of once for each dimension.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to check.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckMissingValues(mappedValues, dimensions);
+
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(numPoints);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+    {
+      bool missing = false;
+      for (size_t d = 0; d < dimensions.size() && !missing; ++d)
+      {
+        missing = details::IsMissing(columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]), mappedValues[d]);
+      }
+
+      keep[i] = !missing;
+    }
+
+    std::vector<arma::uword> pointsToKeep;
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      if (keep[i])
+        pointsToKeep.push_back(i);
+    }
+
+    // Nothing has to be copied if no point is removed.
+    if (pointsToKeep.size() == numPoints)
+      return;
+
+    if (columnMajor)
+      input = input.cols(arma::uvec(pointsToKeep));
+    else
+      input = input.rows(arma::uvec(pointsToKeep));
+  }
 }; // class ListwiseDeletion
 
 } // namespace data
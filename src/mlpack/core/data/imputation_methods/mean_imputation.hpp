@@ -13,6 +13,11 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace data {
@@ -96,6 +101,74 @@ class MeanImputation
       input(target.first, target.second) = mean;
     }
   }
+
+  /**
+   * Impute function for several dimensions at once.  The means of all the
+   * given dimensions are computed in a single parallel pass over the points,
+   * and the missing values are then replaced in place in a second pass.  This
+   * is much faster than one call per dimension when many dimensions have
+   * missing values.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckMissingValues(mappedValues, dimensions);
+
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    #ifdef HAS_OPENMP
+    const size_t numBlocks = std::max(std::min((size_t) omp_get_max_threads(),
+        numPoints), (size_t) 1);
+    #else
+    const size_t numBlocks = 1;
+    #endif
+
+    // Each block of points is summed separately, and the sums are added in the
+    // order of the blocks, so the result does not depend on the scheduling.
+    arma::mat sums(dimensions.size(), numBlocks, arma::fill::zeros);
+    arma::Mat<size_t> elems(dimensions.size(), numBlocks, arma::fill::zeros);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t end = (b + 1) * numPoints / numBlocks;
+      for (size_t i = b * numPoints / numBlocks; i < end; ++i)
+      {
+        for (size_t d = 0; d < dimensions.size(); ++d)
+        {
+          const T value = columnMajor ? input(dimensions[d], i) :
+              input(i, dimensions[d]);
+          if (!details::IsMissing(value, mappedValues[d]))
+          {
+            sums(d, b) += value;
+            elems(d, b)++;
+          }
+        }
+      }
+    }
+
+    std::vector<double> means(dimensions.size());
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      const size_t dimensionElems = arma::accu(elems.row(d));
+      if (dimensionElems == 0)
+      {
+        Log::Fatal << "it is impossible to calculate mean; no valid elements "
+            << "in dimension " << dimensions[d] << std::endl;
+      }
+
+      means[d] = arma::accu(sums.row(d)) / dimensionElems;
+    }
+
+    details::ReplaceMissing(input, mappedValues, dimensions, means,
+        columnMajor);
+  }
 }; // class MeanImputation
 
 } // namespace data
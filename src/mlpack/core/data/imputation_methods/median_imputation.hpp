@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEDIAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -78,13 +79,94 @@ class MedianImputation
     }
 
     // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
+    const double median = Median(elemsToKeep);
 
     for (const PairType& target : targets)
     {
        input(target.first, target.second) = median;
     }
   }
+
+  /**
+   * Impute function for several dimensions at once.  The dimensions are
+   * processed in parallel: the valid values of each dimension are copied once,
+   * and its median is found with a partial sort of the copy.  The missing
+   * values are then replaced in place in a single pass.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues Value that the user wants to get rid of, for each
+   *     dimension.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::CheckMissingValues(mappedValues, dimensions);
+
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<double> medians(dimensions.size());
+    std::vector<char> empty(dimensions.size(), 0);
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      std::vector<double> elemsToKeep;
+      elemsToKeep.reserve(numPoints);
+      for (size_t i = 0; i < numPoints; ++i)
+      {
+        const T value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (!details::IsMissing(value, mappedValues[d]))
+          elemsToKeep.push_back(value);
+      }
+
+      // An exception can't leave the parallel region.
+      if (elemsToKeep.empty())
+        empty[d] = 1;
+      else
+        medians[d] = Median(elemsToKeep);
+    }
+
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      if (empty[d])
+      {
+        Log::Fatal << "it is impossible to calculate median; no valid "
+            << "elements in dimension " << dimensions[d] << std::endl;
+      }
+    }
+
+    details::ReplaceMissing(input, mappedValues, dimensions, medians,
+        columnMajor);
+  }
+
+ private:
+  /**
+   * Compute the median of the given values, which are reordered.  For an even
+   * number of values, this is the average of the two middle values.
+   *
+   * @param values Values to find the median of.
+   */
+  static double Median(std::vector<double>& values)
+  {
+    if (values.empty())
+    {
+      Log::Fatal << "it is impossible to calculate median; no valid elements "
+          << "in the dimension" << std::endl;
+    }
+
+    const size_t half = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + half, values.end());
+    if (values.size() % 2 == 1)
+      return values[half];
+
+    // The lower middle value is the largest value of the first half.
+    const double lower = *std::max_element(values.begin(),
+        values.begin() + half);
+    return (lower + values[half]) / 2.0;
+  }
 }; // class MedianImputation
 
 } // namespace data
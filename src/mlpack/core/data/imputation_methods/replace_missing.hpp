@@ -0,0 +1,99 @@
+/**
+ * @file core/data/imputation_methods/replace_missing.hpp
+ *
+ * Utility functions shared by the imputation strategies that impute several
+ * dimensions at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_IMPUTE_STRATEGIES_REPLACE_MISSING_HPP
+#define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_REPLACE_MISSING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Return true if the given value is missing (mappedValue or NaN).
+template<typename T>
+inline bool IsMissing(const T& value, const T& mappedValue)
+{
+  return value == mappedValue || std::isnan(value);
+}
+
+/**
+ * Replace the missing values of each of the given dimensions with the given
+ * replacement of the dimension, in place.  The points are processed in
+ * parallel, so the matrix is only traversed once.
+ *
+ * @param input Matrix that contains the missing values.
+ * @param mappedValues Value that is missing, for each dimension.
+ * @param dimensions Indices of the dimensions to replace values in.
+ * @param replacements Value to replace the missing values with, for each
+ *     dimension.
+ * @param columnMajor Whether the points of the input are columns or rows.
+ */
+template<typename T>
+void ReplaceMissing(arma::Mat<T>& input,
+                    const std::vector<T>& mappedValues,
+                    const std::vector<size_t>& dimensions,
+                    const std::vector<double>& replacements,
+                    const bool columnMajor)
+{
+  if (columnMajor)
+  {
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      T* point = input.colptr(i);
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        if (IsMissing(point[dimensions[d]], mappedValues[d]))
+          point[dimensions[d]] = replacements[d];
+      }
+    }
+  }
+  else
+  {
+    // Each dimension is a contiguous column.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      T* dimension = input.colptr(dimensions[d]);
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        if (IsMissing(dimension[i], mappedValues[d]))
+          dimension[i] = replacements[d];
+      }
+    }
+  }
+}
+
+/**
+ * Throw an exception unless there is one missing value for each dimension.
+ *
+ * @param mappedValues Value that is missing, for each dimension.
+ * @param dimensions Indices of the dimensions.
+ */
+template<typename T>
+void CheckMissingValues(const std::vector<T>& mappedValues,
+                        const std::vector<size_t>& dimensions)
+{
+  if (mappedValues.size() != dimensions.size())
+  {
+    std::ostringstream oss;
+    oss << "Impute(): " << mappedValues.size() << " missing values given for "
+        << dimensions.size() << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
+
+#endif
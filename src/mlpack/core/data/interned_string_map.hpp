@@ -0,0 +1,265 @@
+/**
+ * @file core/data/interned_string_map.hpp
+ *
+ * Definition of the InternedStringMap class, a map from strings to values that
+ * stores its keys in a single arena.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_INTERNED_STRING_MAP_HPP
+#define MLPACK_CORE_DATA_INTERNED_STRING_MAP_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstring>
+#include <unordered_map>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The InternedStringMap class maps strings to values, like a
+ * std::unordered_map<std::string, MappedType>, but without one allocation per
+ * key: the characters of all the keys are appended to one arena, and the
+ * entries are found with an open-addressing hash table (with linear probing)
+ * that holds the index of each entry.  The hash of each key is kept, so that
+ * probes only compare the characters of keys with the same hash, and so that
+ * the table can grow without hashing the keys again.  Keys can be looked up
+ * from a pointer and a length, without building a std::string.
+ *
+ * The entries are kept in the order they were inserted, and only the arena,
+ * the offsets of the keys and the values are serialized (the hash table is
+ * built again when the map is loaded), so copying and serializing the map is
+ * cheap.  Entries can't be removed.
+ *
+ * The members count(), at(), insert(), size(), empty() and clear() behave like
+ * those of std::unordered_map, so the map policies of DatasetMapper can use
+ * either type.
+ *
+ * @tparam MappedType Type of the values.
+ */
+template<typename MappedType>
+class InternedStringMap
+{
+ public:
+  //! Create an empty map.
+  InternedStringMap() : offsets(1, 0) { }
+
+  //! Get the number of entries.
+  size_t size() const { return values.size(); }
+  //! Return whether the map has no entries.
+  bool empty() const { return values.empty(); }
+
+  //! Remove all the entries.
+  void clear()
+  {
+    arena.clear();
+    offsets.assign(1, 0);
+    values.clear();
+    hashes.clear();
+    slots.clear();
+  }
+
+  /**
+   * Find the value of the given key, or return NULL if the key is not in the
+   * map.
+   *
+   * @param key Characters of the key.
+   * @param length Number of characters of the key.
+   */
+  const MappedType* Find(const char* key, const size_t length) const
+  {
+    const size_t entry = FindEntry(key, length, Hash(key, length));
+    return (entry == npos) ? NULL : &values[entry];
+  }
+
+  /**
+   * Insert the given key with the given value, if the key is not in the map
+   * yet.  Return the index of the entry of the key, and whether it was
+   * inserted.
+   *
+   * @param key Characters of the key.
+   * @param length Number of characters of the key.
+   * @param value Value of the key.
+   */
+  std::pair<size_t, bool> Insert(const char* key,
+                                 const size_t length,
+                                 const MappedType& value)
+  {
+    const size_t hash = Hash(key, length);
+    const size_t entry = FindEntry(key, length, hash);
+    if (entry != npos)
+      return std::make_pair(entry, false);
+
+    // Keep at most half of the slots used.
+    if (2 * (values.size() + 1) > slots.size())
+      Rehash(std::max((size_t) 16, 2 * slots.size()));
+
+    arena.append(key, length);
+    offsets.push_back(arena.size());
+    values.push_back(value);
+    hashes.push_back(hash);
+    PlaceEntry(values.size() - 1);
+    return std::make_pair(values.size() - 1, true);
+  }
+
+  //! Return 1 if the given key is in the map, and 0 otherwise.
+  size_t count(const std::string& key) const
+  {
+    return (Find(key.data(), key.size()) == NULL) ? 0 : 1;
+  }
+
+  //! Get the value of the given key; throws std::out_of_range if the key is
+  //! not in the map.
+  const MappedType& at(const std::string& key) const
+  {
+    const MappedType* value = Find(key.data(), key.size());
+    if (value == NULL)
+    {
+      throw std::out_of_range("InternedStringMap::at(): key '" + key +
+          "' not found");
+    }
+
+    return *value;
+  }
+
+  //! Insert the given key and value, if the key is not in the map yet, and
+  //! return whether it was inserted.
+  bool insert(const std::pair<std::string, MappedType>& entry)
+  {
+    return Insert(entry.first.data(), entry.first.size(), entry.second).second;
+  }
+
+  //! Get the key of the given entry (in the order of insertion).
+  std::string Key(const size_t entry) const
+  {
+    return arena.substr(offsets[entry], offsets[entry + 1] - offsets[entry]);
+  }
+
+  //! Get the value of the given entry (in the order of insertion).
+  const MappedType& Value(const size_t entry) const { return values[entry]; }
+
+  /**
+   * Serialize the map.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(arena));
+    ar(CEREAL_NVP(offsets));
+    ar(CEREAL_NVP(values));
+
+    if (cereal::is_loading<Archive>())
+    {
+      hashes.resize(values.size());
+      for (size_t i = 0; i < values.size(); ++i)
+      {
+        hashes[i] = Hash(arena.data() + offsets[i],
+            offsets[i + 1] - offsets[i]);
+      }
+
+      slots.clear();
+      size_t tableSize = 16;
+      while (2 * values.size() > tableSize)
+        tableSize *= 2;
+      Rehash(tableSize);
+    }
+  }
+
+ private:
+  //! The index of no entry.
+  static const size_t npos = size_t(-1);
+
+  //! Compute the hash of the given key (64-bit FNV-1a).
+  static size_t Hash(const char* key, const size_t length)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+      hash ^= (unsigned char) key[i];
+      hash *= 1099511628211ULL;
+    }
+    return (size_t) hash;
+  }
+
+  //! Find the entry of the given key, with the given hash, or return npos.
+  size_t FindEntry(const char* key,
+                   const size_t length,
+                   const size_t hash) const
+  {
+    if (slots.empty())
+      return npos;
+
+    const size_t mask = slots.size() - 1;
+    for (size_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+      const size_t entry = slots[slot] - 1;
+      if (hashes[entry] == hash &&
+          offsets[entry + 1] - offsets[entry] == length &&
+          std::memcmp(arena.data() + offsets[entry], key, length) == 0)
+        return entry;
+    }
+
+    return npos;
+  }
+
+  //! Put the given entry in the first free slot of its probe sequence.
+  void PlaceEntry(const size_t entry)
+  {
+    const size_t mask = slots.size() - 1;
+    size_t slot = hashes[entry] & mask;
+    while (slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    slots[slot] = entry + 1;
+  }
+
+  //! Rebuild the hash table with the given number of slots (a power of 2).
+  void Rehash(const size_t tableSize)
+  {
+    slots.assign(tableSize, 0);
+    for (size_t i = 0; i < values.size(); ++i)
+      PlaceEntry(i);
+  }
+
+  //! The characters of all the keys, one after the other.
+  std::string arena;
+  //! The offset of the key of each entry in the arena, followed by the size of
+  //! the arena.
+  std::vector<size_t> offsets;
+  //! The value of each entry.
+  std::vector<MappedType> values;
+  //! The hash of the key of each entry.
+  std::vector<size_t> hashes;
+  //! The hash table: the index of an entry plus one, or 0 for a free slot.
+  std::vector<size_t> slots;
+};
+
+/**
+ * Find the value of the given key in the given map with a single lookup, or
+ * return NULL if the key is not in the map.
+ */
+template<typename MappedType>
+inline const MappedType* FindMapping(const InternedStringMap<MappedType>& map,
+                                     const std::string& key)
+{
+  return map.Find(key.data(), key.size());
+}
+
+//! Find the value of the given key in the given std::unordered_map, or return
+//! NULL if the key is not in the map.
+template<typename KeyType, typename MappedType>
+inline const MappedType* FindMapping(
+    const std::unordered_map<KeyType, MappedType>& map,
+    const KeyType& key)
+{
+  typename std::unordered_map<KeyType, MappedType>::const_iterator it =
+      map.find(key);
+  return (it == map.end()) ? NULL : &it->second;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
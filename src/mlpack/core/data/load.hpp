@@ -42,6 +42,11 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * Datasets in the mlpack dataset format (.mlds) can also be loaded; then the
+ * categorical mappings stored in the file are ignored.
+ * LibSVM (SVMlight) files, denoted by .svm or .libsvm, are loaded as sparse
+ * files and then made dense; their labels are not loaded (see below).
+ *
  * By default, this function will try to automatically determine the type of
  * file to load based on its extension and by inspecting the file.  If you know
  * the file type and want to specify it manually, override the default
@@ -84,6 +89,11 @@ bool Load(const std::string& filename,
  *  - TXT (coord_ascii), denoted by .txt
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
+ *  - LibSVM (SVMlight), denoted by .svm or .libsvm
+ *
+ * LibSVM files are read in a single pass with data::LoadLibSVM(), holding one
+ * point per line; the labels are not loaded, but loading the same file into a
+ * row vector gives them.
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -234,6 +244,9 @@ bool Load(const std::string& filename,
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * If the file is a LibSVM (SVMlight) file, denoted by .svm or .libsvm, the
+ * labels of its points are loaded (see data::LoadLibSVM()).
+ *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
@@ -255,12 +268,13 @@ bool Load(const std::string& filename,
  * Loads a matrix from a file, guessing the filetype from the extension and
  * mapping categorical features with a DatasetMapper object.  This will
  * transpose the matrix (unless the transpose parameter is set to false).
- * This particular overload of Load() can only load text-based formats, such as
- * those given below:
+ * This particular overload of Load() can only load the formats given below:
  *
  * - CSV (csv_ascii), denoted by .csv, or optionally .txt
  * - TSV (raw_ascii), denoted by .tsv, .csv, or .txt
  * - ASCII (raw_ascii), denoted by .txt
+ * - ARFF, denoted by .arff
+ * - mlpack dataset, denoted by .mlds (see data::SaveMLDS())
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -392,7 +406,8 @@ bool Load(const std::string& filename,
           const bool fatal = false);
 
 /**
- * Load the image file into the given matrix.
+ * Load the image files into the given matrix, with one column per image.  All
+ * images must have the same size; use LoadImages() to resize them.
  *
  * @param files A vector consisting of filenames.
  * @param matrix Matrix to save the image from.
@@ -406,6 +421,37 @@ bool Load(const std::vector<std::string>& files,
           ImageInfo& info,
           const bool fatal = false);
 
+/**
+ * Load the given image files into a matrix with one column per image, and
+ * resize and normalize them on the way.  The files are decoded in parallel
+ * when OpenMP is available, and each image is resized and normalized by the
+ * thread that decoded it, straight into its column of the matrix.
+ *
+ * If info.Width() or info.Height() is not 0, every image is resized to that
+ * size (a dimension that is 0 keeps the size of the first image) with bilinear
+ * interpolation, like the ann::BilinearInterpolation layer; otherwise, all
+ * images must have the same size.  info.Channels() selects grayscale (1) or
+ * RGB images.  If mean and stddev are given, they must have one element per
+ * channel, and every value v of channel c (between 0 and 255) is stored as
+ * (v - mean[c]) / stddev[c].  After loading, info holds the size and number of
+ * channels of the images in the matrix.
+ *
+ * @param files A vector consisting of filenames.
+ * @param matrix Matrix to load the images into.
+ * @param info An object of ImageInfo class.
+ * @param mean Mean of each channel, or an empty vector.
+ * @param stddev Standard deviation of each channel, or an empty vector.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadImages(const std::vector<std::string>& files,
+                arma::Mat<eT>& matrix,
+                ImageInfo& info,
+                const arma::vec& mean = arma::vec(),
+                const arma::vec& stddev = arma::vec(),
+                const bool fatal = false);
+
 // Implementation found in load_image.cpp.
 bool LoadImage(const std::string& filename,
                arma::Mat<unsigned char>& matrix,
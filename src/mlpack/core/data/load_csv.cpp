@@ -12,6 +12,13 @@
  */
 #include "load_csv.hpp"
 
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 using namespace boost::spirit;
 
 namespace mlpack {
@@ -83,5 +90,83 @@ void LoadCSV::CheckOpen()
   inFile.unsetf(std::ios::skipws);
 }
 
+LoadCSV::MappedFile::MappedFile(const std::string& filename,
+                                std::ifstream& stream) :
+    mapping(NULL),
+    data(NULL),
+    length(0)
+{
+  #ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  struct stat fileInfo;
+  if (fd >= 0 && fstat(fd, &fileInfo) == 0 && fileInfo.st_size > 0)
+  {
+    length = (size_t) fileInfo.st_size;
+    mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+      mapping = NULL;
+    else
+      data = (const char*) mapping;
+  }
+
+  if (fd >= 0)
+    close(fd);
+  #endif
+
+  // If the file can't be mapped, read it into memory instead.
+  if (mapping == NULL)
+  {
+    std::ostringstream contents;
+    stream.clear();
+    stream.seekg(0, std::ios::beg);
+    contents << stream.rdbuf();
+    buffer = contents.str();
+    data = buffer.data();
+    length = buffer.size();
+  }
+}
+
+LoadCSV::MappedFile::~MappedFile()
+{
+  #ifndef _WIN32
+  if (mapping != NULL)
+    munmap(mapping, length);
+  #endif
+}
+
+std::vector<size_t> LoadCSV::SplitLines(const MappedFile& file,
+                                        const size_t chunks)
+{
+  std::vector<size_t> chunkStarts(1, 0);
+  for (size_t c = 1; c < chunks; ++c)
+  {
+    // Start the chunk after the end of the line that holds its first
+    // character, unless that is past the start of the last chunk.
+    size_t start = std::max(c * (file.Length() / chunks), chunkStarts.back());
+    const char* lineEnd = (const char*) std::memchr(file.Data() + start, '\n',
+        file.Length() - start);
+    if (lineEnd == NULL)
+      break;
+
+    start = (lineEnd - file.Data()) + 1;
+    if (start > chunkStarts.back() && start < file.Length())
+      chunkStarts.push_back(start);
+  }
+
+  chunkStarts.push_back(file.Length());
+  return chunkStarts;
+}
+
+size_t LoadCSV::CountLines(const MappedFile& file,
+                           const size_t begin,
+                           const size_t end)
+{
+  size_t lines = std::count(file.Data() + begin, file.Data() + end, '\n');
+  if (end > begin && file.Data()[end - 1] != '\n')
+    ++lines;
+
+  return lines;
+}
+
 } // namespace data
 } // namespace mlpack
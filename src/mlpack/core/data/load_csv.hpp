@@ -18,8 +18,10 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
 
+#include <cstring>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "extension.hpp"
 #include "format.hpp"
@@ -58,7 +60,18 @@ class LoadCSV
   {
     CheckOpen();
 
-    if (transpose)
+    // The chunks of the file can only be parsed independently if numeric
+    // values are mapped without side effects, so that only the categorical
+    // values have to be mapped in order; this is the case for IncrementPolicy.
+    size_t threads = 1;
+    #ifdef HAS_OPENMP
+    if (std::is_same<PolicyType, IncrementPolicy>::value)
+      threads = omp_get_max_threads();
+    #endif
+
+    if (threads > 1)
+      ParallelParse(inout, infoSet, transpose, threads);
+    else if (transpose)
       TransposeParse(inout, infoSet);
     else
       NonTransposeParse(inout, infoSet);
@@ -381,6 +394,290 @@ class LoadCSV
     }
   }
 
+  /**
+   * Holds the contents of a file in memory.  The file is memory-mapped where
+   * this is supported, and read into memory otherwise.
+   */
+  class MappedFile
+  {
+   public:
+    /**
+     * Map the given file, which is open in the given stream.
+     *
+     * @param filename Name of the file to map.
+     * @param stream Open stream of the file, used if the file can't be mapped.
+     */
+    MappedFile(const std::string& filename, std::ifstream& stream);
+
+    //! Unmap the file.
+    ~MappedFile();
+
+    // The mapping can't be shared between objects.
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //! Get the contents of the file.
+    const char* Data() const { return data; }
+    //! Get the length of the file.
+    size_t Length() const { return length; }
+
+   private:
+    //! The memory mapping, or NULL if the file was read into the buffer.
+    void* mapping;
+    //! The contents of the file, if it was not mapped.
+    std::string buffer;
+    //! The contents of the file.
+    const char* data;
+    //! The length of the file.
+    size_t length;
+  };
+
+  /**
+   * Split the given file contents into (at most) the given number of chunks of
+   * roughly equal size, so that each chunk starts at the beginning of a line.
+   * The returned vector holds the offset of each chunk, followed by the length
+   * of the file.
+   *
+   * @param file The contents of the file.
+   * @param chunks Number of chunks.
+   */
+  static std::vector<size_t> SplitLines(const MappedFile& file,
+                                        const size_t chunks);
+
+  /**
+   * Count the lines in the given range of the file, in the same way as
+   * std::getline() (so a last line without a newline is counted).
+   *
+   * @param file The contents of the file.
+   * @param begin Offset of the first character of the range.
+   * @param end Offset past the last character of the range.
+   */
+  static size_t CountLines(const MappedFile& file,
+                           const size_t begin,
+                           const size_t end);
+
+  /**
+   * Call the given function with each line of the given range of the file,
+   * with whitespace removed from either side.
+   *
+   * @param file The contents of the file.
+   * @param begin Offset of the first character of the range.
+   * @param end Offset past the last character of the range.
+   * @param f Function to call with each line (as a std::string&).
+   */
+  template<typename LineFunction>
+  static void ForEachLine(const MappedFile& file,
+                          const size_t begin,
+                          const size_t end,
+                          LineFunction f)
+  {
+    std::string line;
+    size_t pos = begin;
+    while (pos < end)
+    {
+      const char* lineEnd = (const char*) std::memchr(file.Data() + pos, '\n',
+          end - pos);
+      const size_t next = (lineEnd == NULL) ? end : lineEnd - file.Data();
+
+      line.assign(file.Data() + pos, next - pos);
+      boost::trim(line);
+      f(line);
+
+      pos = next + 1;
+    }
+  }
+
+  /**
+   * Parse the file in parallel, giving the same result as TransposeParse() or
+   * NonTransposeParse().  The file is memory-mapped and split into chunks at
+   * line boundaries; the chunks are passed through the first pass of the
+   * DatasetMapper and parsed in parallel, with a copy of the DatasetMapper for
+   * each chunk.  Values in numeric dimensions are written directly to the
+   * matrix, and values in categorical dimensions are mapped with infoSet
+   * after the parallel parse, in the order of the file, so the mappings do not
+   * depend on the number of threads.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to load with.
+   * @param transpose If true, the matrix is transposed on loading.
+   * @param threads Number of threads to use.
+   */
+  template<typename T, typename PolicyType>
+  void ParallelParse(arma::Mat<T>& inout,
+                     DatasetMapper<PolicyType>& infoSet,
+                     const bool transpose,
+                     const size_t threads)
+  {
+    using namespace boost::spirit;
+
+    MappedFile file(filename, inFile);
+    const std::vector<size_t> chunkStarts = SplitLines(file, threads);
+    const size_t numChunks = chunkStarts.size() - 1;
+
+    // Count the lines of each chunk, to get the index of the first line of
+    // each chunk.
+    std::vector<size_t> firstLine(numChunks + 1, 0);
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      firstLine[c + 1] = CountLines(file, chunkStarts[c],
+          chunkStarts[c + 1]);
+    }
+    for (size_t c = 0; c < numChunks; ++c)
+      firstLine[c + 1] += firstLine[c];
+
+    // The number of values on the first line gives the other dimension.
+    size_t lineValues = 0;
+    const char* firstLineEnd = (const char*) std::memchr(file.Data(), '\n',
+        file.Length());
+    ForEachLine(file, 0, (firstLineEnd == NULL) ? file.Length() :
+        firstLineEnd - file.Data(), [&](std::string& line)
+        {
+          auto countValues = [&lineValues](iter_type) { ++lineValues; };
+          qi::parse(line.begin(), line.end(),
+              stringRule[countValues] % delimiterRule);
+        });
+
+    const size_t rows = transpose ? lineValues : firstLine[numChunks];
+    const size_t cols = transpose ? firstLine[numChunks] : lineValues;
+    if (infoSet.Dimensionality() == 0)
+    {
+      infoSet.SetDimensionality(rows);
+    }
+    else if (infoSet.Dimensionality() != rows)
+    {
+      std::ostringstream oss;
+      oss << "data::LoadCSV(): given DatasetInfo has dimensionality "
+          << infoSet.Dimensionality() << ", but data has dimensionality "
+          << rows;
+      throw std::invalid_argument(oss.str());
+    }
+
+    // Take the first pass over each chunk with its own DatasetMapper, and then
+    // merge the types of the dimensions.
+    if (PolicyType::NeedsFirstPass)
+    {
+      std::vector<DatasetMapper<PolicyType>> chunkInfo(numChunks, infoSet);
+      #pragma omp parallel for schedule(static) num_threads(threads)
+      for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+      {
+        size_t lineIndex = firstLine[c];
+        ForEachLine(file, chunkStarts[c], chunkStarts[c + 1],
+            [&](std::string& line)
+            {
+              size_t dim = 0;
+              auto firstPassMap = [&](const iter_type& iter)
+              {
+                const size_t d = transpose ? dim++ : lineIndex;
+                if (d >= rows)
+                  return;
+
+                std::string str(iter.begin(), iter.end());
+                boost::trim(str);
+                chunkInfo[c].template MapFirstPass<T>(std::move(str), d);
+              };
+
+              qi::parse(line.begin(), line.end(),
+                  stringRule[firstPassMap] % delimiterRule);
+              ++lineIndex;
+            });
+      }
+
+      for (size_t c = 0; c < numChunks; ++c)
+      {
+        for (size_t d = 0; d < rows; ++d)
+        {
+          if (chunkInfo[c].Type(d) == Datatype::categorical)
+            infoSet.Type(d) = Datatype::categorical;
+        }
+      }
+    }
+
+    // Now parse each chunk.  The values of categorical dimensions are kept,
+    // with their position, to be mapped afterwards.
+    inout.set_size(rows, cols);
+    std::vector<DatasetMapper<PolicyType>> chunkInfo(numChunks, infoSet);
+    std::vector<std::vector<std::pair<size_t, std::string>>> categorical(
+        numChunks);
+    std::vector<std::string> errors(numChunks);
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      size_t lineIndex = firstLine[c];
+      ForEachLine(file, chunkStarts[c], chunkStarts[c + 1],
+          [&](std::string& line)
+          {
+            if (!errors[c].empty())
+              return;
+
+            size_t index = 0;
+            auto parseString = [&](const iter_type& iter)
+            {
+              std::string str(iter.begin(), iter.end());
+              if (!transpose && str == "\t")
+                str.clear();
+              boost::trim(str);
+
+              const size_t row = transpose ? index : lineIndex;
+              const size_t col = transpose ? lineIndex : index;
+              ++index;
+              if (row >= rows || col >= cols)
+                return;
+
+              if (chunkInfo[c].Type(row) == Datatype::categorical)
+              {
+                categorical[c].push_back(std::make_pair(row + col * rows,
+                    std::move(str)));
+              }
+              else
+              {
+                inout(row, col) = chunkInfo[c].template MapString<T>(
+                    std::move(str), row);
+              }
+            };
+
+            const bool canParse = qi::parse(line.begin(), line.end(),
+                stringRule[parseString] % delimiterRule);
+
+            // Make sure we got the right number of values.
+            std::ostringstream oss;
+            if (index != lineValues)
+            {
+              oss << "LoadCSV::" << (transpose ? "Transpose" : "NonTranspose")
+                  << "Parse(): wrong number of dimensions (" << index
+                  << ") on line " << lineIndex << "; should be " << lineValues
+                  << " dimensions.";
+              errors[c] = oss.str();
+            }
+            else if (!canParse)
+            {
+              oss << "LoadCSV::" << (transpose ? "Transpose" : "NonTranspose")
+                  << "Parse(): parsing error on line " << lineIndex << "!";
+              errors[c] = oss.str();
+            }
+
+            ++lineIndex;
+          });
+    }
+
+    // Report the error on the first line that failed.
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      if (!errors[c].empty())
+        throw std::runtime_error(errors[c]);
+    }
+
+    // Map the categorical values in the order of the file.
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      for (std::pair<size_t, std::string>& value : categorical[c])
+      {
+        inout[value.first] = infoSet.template MapString<T>(
+            std::move(value.second), value.first % rows);
+      }
+    }
+  }
+
   //! Spirit rule for parsing.
   boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
   //! Spirit rule for delimiters (i.e. ',' for CSVs).
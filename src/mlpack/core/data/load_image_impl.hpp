@@ -51,6 +51,84 @@ bool Load(const std::vector<std::string>& files,
           arma::Mat<eT>& matrix,
           ImageInfo& info,
           const bool fatal)
+{
+  // Keep the size of the images.
+  info.Width() = 0;
+  info.Height() = 0;
+  return LoadImages(files, matrix, info, arma::vec(), arma::vec(), fatal);
+}
+
+namespace details {
+
+/**
+ * Resize an image decoded by STB (with interleaved channels) with bilinear
+ * interpolation, normalize each of its channels, and store the result in the
+ * given memory.  The interpolation is the same as in the
+ * ann::BilinearInterpolation layer.
+ */
+template<typename eT>
+void ResizeImage(const unsigned char* image,
+                 const size_t inWidth,
+                 const size_t inHeight,
+                 const size_t channels,
+                 eT* output,
+                 const size_t outWidth,
+                 const size_t outHeight,
+                 const arma::vec& offset,
+                 const arma::vec& scale)
+{
+  // Find the two input pixels to interpolate between for each output pixel.
+  // An image with only one row or column is interpolated with itself.
+  std::vector<size_t> rows(outHeight), cols(outWidth);
+  std::vector<double> rowDeltas(outHeight), colDeltas(outWidth);
+  const double scaleRow = (double) inHeight / (double) outHeight;
+  const double scaleCol = (double) inWidth / (double) outWidth;
+  for (size_t i = 0; i < outHeight; ++i)
+  {
+    rows[i] = std::min((size_t) std::floor(i * scaleRow),
+        inHeight - std::min(inHeight, (size_t) 2));
+    rowDeltas[i] = (inHeight == 1) ? 0.0 :
+        std::min(i * scaleRow - rows[i], 1.0);
+  }
+  for (size_t j = 0; j < outWidth; ++j)
+  {
+    cols[j] = std::min((size_t) std::floor(j * scaleCol),
+        inWidth - std::min(inWidth, (size_t) 2));
+    colDeltas[j] = (inWidth == 1) ? 0.0 :
+        std::min(j * scaleCol - cols[j], 1.0);
+  }
+
+  const size_t nextRow = (inHeight == 1) ? 0 : inWidth * channels;
+  const size_t nextCol = (inWidth == 1) ? 0 : channels;
+  for (size_t i = 0; i < outHeight; ++i)
+  {
+    const double deltaR = rowDeltas[i];
+    for (size_t j = 0; j < outWidth; ++j)
+    {
+      const double deltaC = colDeltas[j];
+      const unsigned char* in = image + (rows[i] * inWidth + cols[j]) *
+          channels;
+      for (size_t c = 0; c < channels; ++c, ++in, ++output)
+      {
+        const double value = (1 - deltaR) * (1 - deltaC) * in[0] +
+            deltaR * (1 - deltaC) * in[nextRow] +
+            (1 - deltaR) * deltaC * in[nextCol] +
+            deltaR * deltaC * in[nextRow + nextCol];
+        *output = eT((value - offset[c]) * scale[c]);
+      }
+    }
+  }
+}
+
+} // namespace details
+
+template<typename eT>
+bool LoadImages(const std::vector<std::string>& files,
+                arma::Mat<eT>& matrix,
+                ImageInfo& info,
+                const arma::vec& mean,
+                const arma::vec& stddev,
+                const bool fatal)
 {
   if (files.size() == 0)
   {
@@ -65,28 +143,100 @@ bool Load(const std::vector<std::string>& files,
     return false;
   }
 
-  arma::Mat<unsigned char> img;
-  bool status = LoadImage(files[0], img, info, fatal);
+  Timer::Start("loading_image");
 
-  if (!status)
+  // The first image gives the number of channels, and the size of the images
+  // if no size is given.
+  arma::Mat<unsigned char> image;
+  ImageInfo imageInfo(0, 0, info.Channels());
+  if (!LoadImage(files[0], image, imageInfo, fatal))
+  {
+    Timer::Stop("loading_image");
     return false;
+  }
+
+  // STB reports the number of channels in the file, not the number of channels
+  // that were loaded.
+  const size_t channels = image.n_elem / (imageInfo.Width() *
+      imageInfo.Height());
+  const bool resize = (info.Width() != 0 || info.Height() != 0);
+  const size_t width = (info.Width() != 0) ? info.Width() : imageInfo.Width();
+  const size_t height = (info.Height() != 0) ? info.Height() :
+      imageInfo.Height();
+
+  // Without normalization, the values are kept.
+  arma::vec offset(channels, arma::fill::zeros);
+  arma::vec scale(channels, arma::fill::ones);
+  if (!mean.is_empty() || !stddev.is_empty())
+  {
+    if (mean.n_elem != channels || stddev.n_elem != channels)
+    {
+      Timer::Stop("loading_image");
+      std::ostringstream oss;
+      oss << "Load(): the mean and standard deviation must have one element "
+          << "per channel (" << channels << ")." << std::endl;
+
+      if (fatal)
+        Log::Fatal << oss.str();
+      else
+        Log::Warn << oss.str();
 
-  // Decide matrix dimension using the image height and width.
-  arma::Mat<unsigned char> tmpMatrix(
-      info.Width() * info.Height() * info.Channels(), files.size());
-  tmpMatrix.col(0) = img;
+      return false;
+    }
+
+    offset = mean;
+    scale = 1.0 / stddev;
+  }
+
+  matrix.set_size(width * height * channels, files.size());
+  details::ResizeImage(image.memptr(), imageInfo.Width(), imageInfo.Height(),
+      channels, matrix.colptr(0), width, height, offset, scale);
 
-  for (size_t i = 1; i < files.size() ; ++i)
+  // Each image is decoded, resized and normalized by the same thread, straight
+  // into its column.  The decoding time varies with the files, so the images
+  // are distributed dynamically.
+  std::vector<std::string> errors(files.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 1; i < (omp_size_t) files.size(); ++i)
+  {
+    arma::Mat<unsigned char> decoded;
+    ImageInfo decodedInfo(0, 0, info.Channels());
+    if (!LoadImage(files[i], decoded, decodedInfo, false))
+    {
+      errors[i] = "failed to load image '" + files[i] + "'";
+      continue;
+    }
+
+    if (!resize && (decodedInfo.Width() != imageInfo.Width() ||
+        decodedInfo.Height() != imageInfo.Height()))
+    {
+      errors[i] = "image '" + files[i] + "' does not have the size of image "
+          "'" + files[0] + "'";
+      continue;
+    }
+
+    details::ResizeImage(decoded.memptr(), decodedInfo.Width(),
+        decodedInfo.Height(), channels, matrix.colptr(i), width, height,
+        offset, scale);
+  }
+
+  Timer::Stop("loading_image");
+  for (size_t i = 1; i < files.size(); ++i)
   {
-    arma::Mat<unsigned char> colImg(tmpMatrix.colptr(i), tmpMatrix.n_rows, 1,
-        false, true);
-    status = LoadImage(files[i], colImg, info, fatal);
+    if (!errors[i].empty())
+    {
+      if (fatal)
+        Log::Fatal << "Load(): " << errors[i] << "." << std::endl;
+      else
+        Log::Warn << "Load(): " << errors[i] << "." << std::endl;
 
-    if (!status)
       return false;
+    }
   }
 
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tmpMatrix);
+  info.Width() = width;
+  info.Height() = height;
+  info.Channels() = channels;
   return true;
 }
 
@@ -28,6 +28,8 @@
 #include <boost/algorithm/string.hpp>
 
 #include "load_arff.hpp"
+#include "load_libsvm.hpp"
+#include "mlds.hpp"
 
 namespace mlpack {
 namespace data {
@@ -92,6 +94,44 @@ bool Load(const std::string& filename,
           const bool transpose,
           const arma::file_type inputLoadType)
 {
+  // Files in the mlpack dataset format are not Armadillo files.
+  if (inputLoadType == arma::auto_detect && Extension(filename) == "mlds")
+  {
+    Timer::Start("loading_data");
+    Log::Info << "Loading '" << filename << "' as mlpack dataset.  "
+        << std::flush;
+    try
+    {
+      LoadMLDS(filename, matrix, std::vector<size_t>(), transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
+        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
+  // LibSVM files are sparse; the labels are not loaded.
+  if (inputLoadType == arma::auto_detect && IsLibSVMFile(filename))
+  {
+    arma::SpMat<eT> sparse;
+    if (!Load(filename, sparse, fatal, transpose))
+      return false;
+
+    matrix = arma::Mat<eT>(sparse);
+    return true;
+  }
+
   Timer::Start("loading_data");
 
   // Catch nonexistent files by opening the stream ourselves.
@@ -270,6 +310,25 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (extension == "mlds")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack dataset.  "
+        << std::flush;
+    try
+    {
+      LoadMLDS(filename, matrix, info, std::vector<size_t>(), transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
   else
   {
     // The type is unknown.
@@ -323,6 +382,37 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // LibSVM files are not Armadillo files; the labels are not loaded.
+  if (IsLibSVMFile(filename))
+  {
+    Log::Info << "Loading '" << filename << "' as LibSVM data.  "
+        << std::flush;
+    try
+    {
+      arma::rowvec labels;
+      LoadLibSVM(filename, matrix, labels);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
+
+    // The points are loaded as columns, so they have to be transposed if the
+    // file should not be.
+    const bool success = transpose || inplace_transpose(matrix, fatal);
+    Timer::Stop("loading_data");
+    return success;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
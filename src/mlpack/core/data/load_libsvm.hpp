@@ -0,0 +1,69 @@
+/**
+ * @file core/data/load_libsvm.hpp
+ *
+ * Load a sparse dataset in the LibSVM (SVMlight) format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_LIBSVM_HPP
+#define MLPACK_CORE_DATA_LOAD_LIBSVM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "extension.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return true if the given file has the extension of a LibSVM file (.svm or
+ * .libsvm).
+ */
+inline bool IsLibSVMFile(const std::string& filename)
+{
+  const std::string extension = Extension(filename);
+  return (extension == "svm" || extension == "libsvm");
+}
+
+/**
+ * Load a dataset in the LibSVM (SVMlight) format into a sparse matrix with one
+ * point per column, and the labels of the points.  Each line of the file holds
+ * one point, as a label followed by index:value pairs, where the indices start
+ * at 1:
+ *
+ * @code
+ * 1 3:0.5 10:1.2 1024:3
+ * -1 1:2 # Comments are ignored.
+ * @endcode
+ *
+ * The file is read in a single pass, and the compressed columns of the matrix
+ * are built directly, so only the nonzero values are ever held in memory.
+ * Query ids (qid:) are skipped.  The number of rows of the matrix is the
+ * largest index in the file, unless dimensionality is given; then an exception
+ * is thrown if an index is larger.
+ *
+ * If the label type is unsigned and the labels are -1 and +1 (the usual
+ * convention for binary problems in LibSVM files), -1 is loaded as 0.  Any
+ * other negative label can't be stored in an unsigned type, and an exception
+ * is thrown.  An exception is also thrown if the file can't be parsed.
+ *
+ * @param filename Name of LibSVM file to load.
+ * @param matrix Sparse matrix to load the points into.
+ * @param labels Row vector to load the labels into.
+ * @param dimensionality Number of rows of the matrix, or 0.
+ */
+template<typename eT, typename LabelType>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const size_t dimensionality = 0);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_libsvm_impl.hpp"
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @file core/data/load_libsvm_impl.hpp
+ *
+ * Implementation of LibSVM (SVMlight) loading.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_LIBSVM_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_LIBSVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_libsvm.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace mlpack {
+namespace data {
+
+namespace details {
+
+//! Return the exception for a parsing error on the given line.
+inline std::runtime_error LibSVMError(const std::string& filename,
+                                      const size_t line,
+                                      const std::string& reason)
+{
+  std::ostringstream oss;
+  oss << "LoadLibSVM(): " << reason << " on line " << line << " of '"
+      << filename << "'";
+  return std::runtime_error(oss.str());
+}
+
+} // namespace details
+
+template<typename eT, typename LabelType>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const size_t dimensionality)
+{
+  std::ifstream stream(filename.c_str());
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("LoadLibSVM(): cannot open file '" + filename +
+        "'");
+  }
+
+  // The compressed columns of the matrix, which are built while reading.
+  std::vector<arma::uword> rowIndices;
+  std::vector<eT> values;
+  std::vector<arma::uword> colPtrs(1, 0);
+  std::vector<double> labelValues;
+  size_t rows = 0;
+
+  std::string text;
+  size_t line = 0;
+  std::vector<std::pair<arma::uword, eT>> column;
+  while (std::getline(stream, text))
+  {
+    ++line;
+    const size_t comment = text.find('#');
+    if (comment != std::string::npos)
+      text.resize(comment);
+
+    const char* p = text.c_str();
+    while (std::isspace((unsigned char) *p))
+      ++p;
+    if (*p == '\0')
+      continue;
+
+    char* end;
+    labelValues.push_back(std::strtod(p, &end));
+    if (end == p || !(std::isspace((unsigned char) *end) || *end == '\0'))
+      throw details::LibSVMError(filename, line, "invalid label");
+    p = end;
+
+    const size_t columnStart = rowIndices.size();
+    bool sorted = true;
+    while (true)
+    {
+      while (std::isspace((unsigned char) *p))
+        ++p;
+      if (*p == '\0')
+        break;
+
+      if (std::strncmp(p, "qid:", 4) == 0)
+      {
+        while (*p != '\0' && !std::isspace((unsigned char) *p))
+          ++p;
+        continue;
+      }
+
+      if (!std::isdigit((unsigned char) *p))
+        throw details::LibSVMError(filename, line, "invalid index");
+      const unsigned long long index = std::strtoull(p, &end, 10);
+      if (*end != ':' || index == 0)
+      {
+        throw details::LibSVMError(filename, line, "invalid index (indices "
+            "start at 1)");
+      }
+
+      p = end + 1;
+      const double value = std::strtod(p, &end);
+      if (end == p || !(std::isspace((unsigned char) *end) || *end == '\0'))
+        throw details::LibSVMError(filename, line, "invalid value");
+      p = end;
+
+      // Zeros are not stored in a sparse matrix.
+      if (value == 0.0)
+        continue;
+
+      if (rowIndices.size() > columnStart && index - 1 <= rowIndices.back())
+        sorted = false;
+      rowIndices.push_back((arma::uword) (index - 1));
+      values.push_back(eT(value));
+      rows = std::max(rows, (size_t) index);
+    }
+
+    // The row indices of each column must be sorted and unique.
+    if (!sorted)
+    {
+      column.clear();
+      for (size_t i = columnStart; i < rowIndices.size(); ++i)
+        column.push_back(std::make_pair(rowIndices[i], values[i]));
+      std::sort(column.begin(), column.end(),
+          [](const std::pair<arma::uword, eT>& a,
+             const std::pair<arma::uword, eT>& b)
+          { return a.first < b.first; });
+
+      for (size_t i = 0; i < column.size(); ++i)
+      {
+        if (i > 0 && column[i].first == column[i - 1].first)
+        {
+          throw details::LibSVMError(filename, line, "index " +
+              std::to_string(column[i].first + 1) + " given twice");
+        }
+
+        rowIndices[columnStart + i] = column[i].first;
+        values[columnStart + i] = column[i].second;
+      }
+    }
+
+    colPtrs.push_back(rowIndices.size());
+  }
+
+  if (dimensionality != 0 && rows > dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "LoadLibSVM(): '" << filename << "' has index " << rows
+        << ", but the dimensionality is " << dimensionality;
+    throw std::runtime_error(oss.str());
+  }
+
+  // Check the labels before the matrix is built.
+  bool negative = false, signs = true;
+  for (size_t i = 0; i < labelValues.size(); ++i)
+  {
+    negative |= (labelValues[i] < 0);
+    signs &= (labelValues[i] == -1 || labelValues[i] == 1);
+  }
+
+  const bool mapSigns = negative && !std::numeric_limits<LabelType>::is_signed;
+  if (mapSigns && !signs)
+  {
+    throw std::runtime_error("LoadLibSVM(): '" + filename + "' has negative "
+        "labels, which can't be loaded as unsigned values");
+  }
+
+  labels.set_size(labelValues.size());
+  for (size_t i = 0; i < labelValues.size(); ++i)
+  {
+    labels[i] = (mapSigns && labelValues[i] < 0) ? LabelType(0) :
+        LabelType(labelValues[i]);
+  }
+
+  // Free each array as soon as it is copied.
+  const size_t cols = colPtrs.size() - 1;
+  arma::Col<arma::uword> rowIndicesCol(rowIndices);
+  std::vector<arma::uword>().swap(rowIndices);
+  arma::Col<arma::uword> colPtrsCol(colPtrs);
+  std::vector<arma::uword>().swap(colPtrs);
+  arma::Col<eT> valuesCol(values);
+  std::vector<eT>().swap(values);
+
+  matrix = arma::SpMat<eT>(rowIndicesCol, colPtrsCol, valuesCol,
+      (dimensionality == 0) ? rows : dimensionality, cols);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
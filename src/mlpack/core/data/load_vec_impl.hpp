@@ -15,6 +15,7 @@
 
 // In case it hasn't already been included.
 #include "load.hpp"
+#include "load_libsvm.hpp"
 
 namespace mlpack {
 namespace data {
@@ -89,6 +90,27 @@ bool Load(const std::string& filename,
           arma::Row<eT>& rowvec,
           const bool fatal)
 {
+  // The labels of a LibSVM file are stored with its points.
+  if (IsLibSVMFile(filename))
+  {
+    try
+    {
+      arma::sp_mat points;
+      LoadLibSVM(filename, points, rowvec);
+      return true;
+    }
+    catch (std::exception& e)
+    {
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      rowvec.clear();
+      return false;
+    }
+  }
+
   arma::Mat<eT> tmp;
   bool success = Load(filename, tmp, fatal, false);
   if (!success)
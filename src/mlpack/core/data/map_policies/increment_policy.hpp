@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <unordered_map>
 #include <mlpack/core/data/map_policies/datatype.hpp>
+#include <mlpack/core/data/interned_string_map.hpp>
 
 namespace mlpack {
 namespace data {
@@ -109,37 +110,25 @@ class IncrementPolicy
       // Otherwise, we must map.
     }
 
-    // If this condition is true, either we have no mapping for the given input
-    // or we have no mappings for the given dimension at all.  In either case,
-    // we create a mapping.
-    if (maps.count(dimension) == 0 ||
-        maps[dimension].first.count(input) == 0)
-    {
-      // This input does not exist yet.
-      size_t numMappings = maps[dimension].first.size();
+    // Most inputs of a categorical dimension are already mapped, so look the
+    // input up only once.
+    typename MapType::mapped_type& mappings = maps[dimension];
+    const MappedType* mapped = FindMapping(mappings.first, input);
+    if (mapped != NULL)
+      return T(*mapped);
 
-      // Change type of the feature to categorical.
-      if (numMappings == 0)
-        types[dimension] = Datatype::categorical;
+    // This input does not exist yet, so we create a mapping.
+    const size_t numMappings = mappings.first.size();
 
-      typedef typename std::pair<InputType, MappedType> PairType;
-      maps[dimension].first.insert(PairType(input, numMappings));
+    // Change type of the feature to categorical.
+    if (numMappings == 0)
+      types[dimension] = Datatype::categorical;
 
-      // Do we need to create the second map?
-      if (maps[dimension].second.count(numMappings) == 0)
-      {
-        maps[dimension].second.insert(std::make_pair(numMappings,
-            std::vector<InputType>()));
-      }
-      maps[dimension].second[numMappings].push_back(input);
+    typedef typename std::pair<InputType, MappedType> PairType;
+    mappings.first.insert(PairType(input, numMappings));
+    mappings.second[numMappings].push_back(input);
 
-      return T(numMappings);
-    }
-    else
-    {
-      // This input already exists in the mapping.
-      return maps[dimension].first.at(input);
-    }
+    return T(numMappings);
   }
 
  private:
@@ -0,0 +1,104 @@
+/**
+ * @file core/data/mapped_matrix.hpp
+ *
+ * Definition of the MappedMatrix class, which memory-maps a matrix stored on
+ * disk so that it can be used without reading it into memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <sstream>
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The MappedMatrix class memory-maps a matrix file and exposes its contents as
+ * an Armadillo matrix that uses the mapped memory directly, so no data is read
+ * or copied when the object is constructed.  Pages of the file are loaded by
+ * the operating system when they are first accessed, which means that a large
+ * dataset can be used almost immediately if it is already in the page cache.
+ *
+ * Two file formats are supported:
+ *
+ *  - Armadillo binary (arma::arma_binary), as written by
+ *    data::Save(filename, matrix, true, false, arma::arma_binary).  The header
+ *    of the file must match the element type.  The data can only be used in
+ *    place if the length of the header is a multiple of the alignment of the
+ *    element type; otherwise it is copied into memory (and writeBack can't be
+ *    used).
+ *  - Raw binary (arma::raw_binary); then the number of rows of the matrix must
+ *    be given, and the number of columns is computed from the file size.
+ *
+ * Unlike data::Load(), the matrix is not transposed: the file must hold one
+ * point per column, so it should be saved with transpose = false.
+ *
+ * The matrix can be moved into the constructor of any tree or model without a
+ * copy (for instance, `KNN knn(std::move(mapped.Matrix()))`).  Trees that
+ * rearrange their dataset (such as BinarySpaceTree) then permute the columns
+ * in the mapped memory.  If writeBack is false (the default), the mapping is
+ * private, so modified pages are copied in memory and the file is never
+ * changed.  If writeBack is true, modifications are written to the file
+ * instead, so the dataset does not need to fit in memory; note that the file
+ * then holds the permuted dataset after any tree is built on it.
+ *
+ * The MappedMatrix object must outlive every matrix, tree or model that uses
+ * its memory.  Memory mapping is not available on Windows; there, the
+ * constructor throws std::runtime_error.
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT = double>
+class MappedMatrix
+{
+ public:
+  /**
+   * Map the given file.  If rows is 0, the file must be in Armadillo binary
+   * format; otherwise, it must be in raw binary format and hold a matrix with
+   * the given number of rows.
+   *
+   * @param filename Name of file to map.
+   * @param rows Number of rows (dimensions) of a raw binary matrix, or 0.
+   * @param writeBack If true, changes to the matrix are written to the file.
+   */
+  MappedMatrix(const std::string& filename,
+               const size_t rows = 0,
+               const bool writeBack = false);
+
+  //! Unmap the file.
+  ~MappedMatrix();
+
+  // The mapping can't be shared between objects.
+  MappedMatrix(const MappedMatrix&) = delete;
+  MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+  //! Get the mapped matrix.
+  const arma::Mat<eT>& Matrix() const { return matrix; }
+  //! Modify the mapped matrix (or move it into a tree or model).
+  arma::Mat<eT>& Matrix() { return matrix; }
+
+ private:
+  //! Whether changes are written back to the file.
+  bool writeBack;
+  //! The start of the mapping.
+  void* mapping;
+  //! The length of the mapping in bytes.
+  size_t length;
+  //! The matrix that uses the mapped memory.
+  arma::Mat<eT> matrix;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file core/data/mapped_matrix_impl.hpp
+ *
+ * Implementation of the MappedMatrix class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#include <cstring>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename,
+                               const size_t rows,
+                               const bool writeBack) :
+    writeBack(writeBack),
+    mapping(NULL),
+    length(0)
+{
+  #ifdef _WIN32
+  throw std::runtime_error("MappedMatrix(): memory-mapped matrices are "
+      "not supported on Windows");
+  #else
+  const int fd = open(filename.c_str(), writeBack ? O_RDWR : O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("MappedMatrix(): cannot open file '" +
+        filename + "'");
+  }
+
+  struct stat fileInfo;
+  if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size == 0)
+  {
+    close(fd);
+    throw std::runtime_error("MappedMatrix(): cannot map empty file '" +
+        filename + "'");
+  }
+
+  // A private mapping can still be written to; the modified pages are simply
+  // never written back to the file.
+  length = (size_t) fileInfo.st_size;
+  mapping = mmap(NULL, length, PROT_READ | PROT_WRITE,
+      writeBack ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    mapping = NULL;
+    throw std::runtime_error("MappedMatrix(): cannot map file '" +
+        filename + "'");
+  }
+
+  char* bytes = (char*) mapping;
+  size_t offset = 0;
+  size_t nRows = rows;
+  size_t nCols = 0;
+  if (rows == 0)
+  {
+    // The Armadillo binary header is the type string, then the dimensions,
+    // each on its own line.
+    const std::string header = arma::diskio::gen_bin_header(arma::Mat<eT>());
+    size_t newlines = 0;
+    while (offset < length && offset < 256 && newlines < 2)
+    {
+      if (bytes[offset] == '\n')
+        ++newlines;
+      ++offset;
+    }
+
+    std::istringstream headerStream(std::string(bytes, offset));
+    std::string fileHeader;
+    headerStream >> fileHeader >> nRows >> nCols;
+    if (newlines < 2 || fileHeader != header || !headerStream)
+    {
+      munmap(mapping, length);
+      mapping = NULL;
+      throw std::runtime_error("MappedMatrix(): file '" + filename +
+          "' is not an Armadillo binary file with header " + header);
+    }
+
+    // Compare the dimensions with the number of elements in the file without
+    // computing their product, which may overflow for a corrupt header.
+    const size_t elements = (length - offset) / sizeof(eT);
+    if (nRows != 0 && nCols > elements / nRows)
+    {
+      munmap(mapping, length);
+      mapping = NULL;
+      throw std::runtime_error("MappedMatrix(): file '" + filename +
+          "' is too short for its dimensions");
+    }
+  }
+  else
+  {
+    if (rows > length / sizeof(eT) || length % (rows * sizeof(eT)) != 0)
+    {
+      munmap(mapping, length);
+      mapping = NULL;
+      throw std::runtime_error("MappedMatrix(): size of file '" +
+          filename + "' is not a multiple of the size of one column");
+    }
+
+    nCols = length / (rows * sizeof(eT));
+  }
+
+  // The text header of an Armadillo binary file usually leaves the data
+  // misaligned for the element type, and then it can't be used in place.
+  if (offset % alignof(eT) != 0)
+  {
+    if (writeBack)
+    {
+      munmap(mapping, length);
+      mapping = NULL;
+      throw std::runtime_error("MappedMatrix(): the data of file '" +
+          filename + "' is not aligned for its element type, so changes "
+          "can't be written back; save it in raw binary format instead");
+    }
+
+    Log::Warn << "MappedMatrix(): the data of file '" << filename << "' is "
+        << "not aligned for its element type; copying it into memory."
+        << std::endl;
+    matrix.set_size(nRows, nCols);
+    std::memcpy(matrix.memptr(), bytes + offset, matrix.n_elem * sizeof(eT));
+    munmap(mapping, length);
+    mapping = NULL;
+    return;
+  }
+
+  // The matrix is not strict, so that it can be moved into trees and models
+  // without copying the data.
+  matrix = arma::Mat<eT>((eT*) (bytes + offset), nRows, nCols, false, false);
+
+  Log::Info << "Mapped " << nRows << "x" << nCols << " matrix from '"
+      << filename << "'." << std::endl;
+  #endif
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+  #ifndef _WIN32
+  if (mapping)
+    munmap(mapping, length);
+  #endif
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file core/data/mlds.hpp
+ *
+ * Load and save datasets in the mlpack dataset format (.mlds), which stores a
+ * matrix together with the DatasetMapper that holds its categorical mappings.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MLDS_HPP
+#define MLPACK_CORE_DATA_MLDS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Save a dataset in the mlpack dataset format (.mlds), together with the
+ * DatasetMapper that holds its dimension types and categorical mappings, so
+ * that it can be loaded again without parsing text or mapping strings.  The
+ * format is binary and columnar: after a short text header and the serialized
+ * DatasetMapper, the values of each dimension are stored contiguously, so that
+ * a subset of the dimensions can be loaded without reading the others.  The
+ * values are stored with the element type of the matrix, and the file has to
+ * be loaded into a matrix of the same type.
+ *
+ * Like data::Save(), if transpose is true the matrix holds one point per
+ * column; otherwise it holds one point per row.  An exception is thrown upon
+ * failure, or if the dimensionality of info does not match the matrix.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save.
+ * @param info DatasetMapper of the matrix.
+ * @param transpose If true, the matrix holds one point per column.
+ */
+template<typename eT, typename PolicyType>
+void SaveMLDS(const std::string& filename,
+              const arma::Mat<eT>& matrix,
+              const DatasetMapper<PolicyType>& info,
+              const bool transpose = true);
+
+/**
+ * Load a dataset in the mlpack dataset format (.mlds), and replace the types
+ * and mappings of info with those stored in the file (the policy of info is
+ * kept).  The PolicyType must be the same as the one the file was saved with.
+ *
+ * If dimensions is not empty, only the given dimensions are loaded, in the
+ * given order, and info only holds those dimensions.  Where memory mapping is
+ * available, the file is mapped and only the pages holding the requested
+ * dimensions are read.  An exception is thrown upon failure.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Matrix to load into.
+ * @param info DatasetMapper to load the types and mappings into.
+ * @param dimensions Dimensions to load; if empty, all dimensions are loaded.
+ * @param transpose If true, load one point per column (like data::Load()).
+ */
+template<typename eT, typename PolicyType>
+void LoadMLDS(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info,
+              const std::vector<size_t>& dimensions = std::vector<size_t>(),
+              const bool transpose = true);
+
+/**
+ * Load a dataset in the mlpack dataset format (.mlds), ignoring the mappings
+ * stored in the file.  See the overload above for details.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Matrix to load into.
+ * @param dimensions Dimensions to load; if empty, all dimensions are loaded.
+ * @param transpose If true, load one point per column (like data::Load()).
+ */
+template<typename eT>
+void LoadMLDS(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              const std::vector<size_t>& dimensions = std::vector<size_t>(),
+              const bool transpose = true);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mlds_impl.hpp"
+
+#endif
@@ -0,0 +1,288 @@
+/**
+ * @file core/data/mlds_impl.hpp
+ *
+ * Implementation of loading and saving datasets in the mlpack dataset format.
+ *
+ * A file in this format holds, in order:
+ *
+ *  - the line "MLPACK_DATASET 1";
+ *  - the Armadillo binary header of the element type (e.g. ARMA_MAT_BIN_FN008),
+ *    on its own line;
+ *  - the number of points, the number of dimensions and the size in bytes of
+ *    the serialized DatasetMapper, on one line;
+ *  - the DatasetMapper, serialized with cereal's binary archive;
+ *  - zero padding up to the next multiple of 64 bytes;
+ *  - the values of each dimension, one dimension after another.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MLDS_IMPL_HPP
+#define MLPACK_CORE_DATA_MLDS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mlds.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+namespace details {
+
+//! Get the first line of a file in the mlpack dataset format.
+inline std::string MLDSMagic()
+{
+  return "MLPACK_DATASET 1";
+}
+
+//! Get the offset of the values, given the size of the header and mapper.
+inline size_t MLDSDataStart(const size_t headerSize)
+{
+  // The values are aligned, so that the mapped values can be used directly.
+  return (headerSize + 63) / 64 * 64;
+}
+
+/**
+ * Load the values of the given dimensions of a file in the mlpack dataset
+ * format, and return the serialized DatasetMapper of the file.
+ */
+template<typename eT>
+std::string LoadMLDSData(const std::string& filename,
+                         arma::Mat<eT>& matrix,
+                         const std::vector<size_t>& dimensions,
+                         const bool transpose)
+{
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("LoadMLDS(): cannot open file '" + filename +
+        "'");
+  }
+
+  std::string magic, header;
+  size_t points = 0, dimensionality = 0, infoSize = 0;
+  std::getline(stream, magic);
+  std::getline(stream, header);
+  stream >> points >> dimensionality >> infoSize;
+  stream.get();
+  if (!stream || magic != MLDSMagic())
+  {
+    throw std::runtime_error("LoadMLDS(): file '" + filename + "' is not an "
+        "mlpack dataset file");
+  }
+
+  const std::string expected = arma::diskio::gen_bin_header(arma::Mat<eT>());
+  if (header != expected)
+  {
+    throw std::runtime_error("LoadMLDS(): file '" + filename + "' holds "
+        "values of type " + header + ", not " + expected);
+  }
+
+  std::string info(infoSize, '\0');
+  stream.read(&info[0], infoSize);
+  if (!stream)
+  {
+    throw std::runtime_error("LoadMLDS(): file '" + filename + "' is too "
+        "short for its dimensions");
+  }
+
+  const size_t dataStart = MLDSDataStart((size_t) stream.tellg());
+  const size_t dimensionBytes = points * sizeof(eT);
+
+  std::vector<size_t> loaded = dimensions;
+  if (loaded.empty())
+  {
+    loaded.resize(dimensionality);
+    for (size_t i = 0; i < dimensionality; ++i)
+      loaded[i] = i;
+  }
+
+  for (size_t i = 0; i < loaded.size(); ++i)
+  {
+    if (loaded[i] >= dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "LoadMLDS(): dimension " << loaded[i] << " is out of range; '"
+          << filename << "' has only " << dimensionality << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  if (transpose)
+    matrix.set_size(loaded.size(), points);
+  else
+    matrix.set_size(points, loaded.size());
+
+  #ifndef _WIN32
+  // Map the file, so that only the pages of the loaded dimensions are read.
+  stream.close();
+  const int fd = open(filename.c_str(), O_RDONLY);
+  struct stat fileInfo;
+  if (fd < 0 || fstat(fd, &fileInfo) != 0)
+  {
+    if (fd >= 0)
+      close(fd);
+    throw std::runtime_error("LoadMLDS(): cannot open file '" + filename +
+        "'");
+  }
+
+  const size_t length = (size_t) fileInfo.st_size;
+  if (length < dataStart + dimensionality * dimensionBytes)
+  {
+    close(fd);
+    throw std::runtime_error("LoadMLDS(): file '" + filename + "' is too "
+        "short for its dimensions");
+  }
+
+  void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    throw std::runtime_error("LoadMLDS(): cannot map file '" + filename +
+        "'");
+  }
+
+  const eT* values = (const eT*) ((const char*) mapping + dataStart);
+  for (size_t i = 0; i < loaded.size(); ++i)
+  {
+    // The mapping is read-only, but the alias is only read from.
+    const arma::Row<eT> dimension(const_cast<eT*>(values + loaded[i] * points),
+        points, false, true);
+    if (transpose)
+      matrix.row(i) = dimension;
+    else
+      matrix.col(i) = dimension.t();
+  }
+
+  munmap(mapping, length);
+  #else
+  arma::Row<eT> dimension(points);
+  for (size_t i = 0; i < loaded.size(); ++i)
+  {
+    stream.seekg(dataStart + loaded[i] * dimensionBytes);
+    stream.read((char*) dimension.memptr(), dimensionBytes);
+    if (!stream)
+    {
+      throw std::runtime_error("LoadMLDS(): file '" + filename + "' is too "
+          "short for its dimensions");
+    }
+
+    if (transpose)
+      matrix.row(i) = dimension;
+    else
+      matrix.col(i) = dimension.t();
+  }
+  #endif
+
+  return info;
+}
+
+} // namespace details
+
+template<typename eT, typename PolicyType>
+void SaveMLDS(const std::string& filename,
+              const arma::Mat<eT>& matrix,
+              const DatasetMapper<PolicyType>& info,
+              const bool transpose)
+{
+  const size_t dimensionality = transpose ? matrix.n_rows : matrix.n_cols;
+  const size_t points = transpose ? matrix.n_cols : matrix.n_rows;
+  if (info.Dimensionality() != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "SaveMLDS(): the DatasetMapper has " << info.Dimensionality()
+        << " dimensions, but the matrix has " << dimensionality;
+    throw std::invalid_argument(oss.str());
+  }
+
+  std::ostringstream infoStream;
+  {
+    cereal::BinaryOutputArchive ar(infoStream);
+    ar(cereal::make_nvp("info", info));
+  }
+  const std::string infoBytes = infoStream.str();
+
+  std::ostringstream headerStream;
+  headerStream << details::MLDSMagic() << "\n"
+      << arma::diskio::gen_bin_header(arma::Mat<eT>()) << "\n"
+      << points << " " << dimensionality << " " << infoBytes.size() << "\n";
+  const std::string header = headerStream.str();
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("SaveMLDS(): cannot open file '" + filename +
+        "' for writing");
+  }
+
+  const size_t headerSize = header.size() + infoBytes.size();
+  const std::string padding(details::MLDSDataStart(headerSize) - headerSize,
+      '\0');
+  stream.write(header.data(), header.size());
+  stream.write(infoBytes.data(), infoBytes.size());
+  stream.write(padding.data(), padding.size());
+
+  if (transpose)
+  {
+    // Each dimension is a row of the matrix, so it has to be gathered first.
+    arma::Row<eT> dimension;
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      dimension = matrix.row(d);
+      stream.write((const char*) dimension.memptr(), points * sizeof(eT));
+    }
+  }
+  else
+  {
+    stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+  }
+
+  if (!stream)
+  {
+    throw std::runtime_error("SaveMLDS(): cannot write to file '" + filename +
+        "'");
+  }
+}
+
+template<typename eT, typename PolicyType>
+void LoadMLDS(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info,
+              const std::vector<size_t>& dimensions,
+              const bool transpose)
+{
+  std::istringstream infoStream(details::LoadMLDSData(filename, matrix,
+      dimensions, transpose));
+  {
+    cereal::BinaryInputArchive ar(infoStream);
+    ar(cereal::make_nvp("info", info));
+  }
+
+  if (!dimensions.empty())
+    info = info.Subset(dimensions);
+}
+
+template<typename eT>
+void LoadMLDS(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              const std::vector<size_t>& dimensions,
+              const bool transpose)
+{
+  details::LoadMLDSData(filename, matrix, dimensions, transpose);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
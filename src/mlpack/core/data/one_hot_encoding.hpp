@@ -33,6 +33,18 @@ template<typename RowType, typename MatType>
 void OneHotEncoding(const RowType& labelsIn,
                     MatType& output);
 
+/**
+ * Overloaded function for the above function, which stores the binary vectors
+ * in a sparse matrix.  The sparse matrix is built directly from the labels,
+ * without inserting each value.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Sparse binary matrix.
+ */
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a vector of indices to encode and outputs a matrix.
@@ -47,6 +59,20 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     const arma::Col<size_t>& indices,
                     arma::Mat<eT>& output);
 
+/**
+ * Overloaded function for the above function, which stores the encoded matrix
+ * in a sparse matrix.  Only the nonzero values are stored, so dimensions with
+ * many categories do not need a dense matrix of the encoded size.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a DatasetInfo object and outputs a matrix.
@@ -62,6 +88,19 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     arma::Mat<eT>& output,
                     const data::DatasetInfo& datasetInfo);
 
+/**
+ * Overloaded function for the above function, which stores the encoded matrix
+ * in a sparse matrix.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Encoded sparse matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo);
+
 } // namespace data
 } // namespace mlpack
 
@@ -16,9 +16,111 @@
 // In case it hasn't been included yet.
 #include "one_hot_encoding.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 
+namespace details {
+
+/**
+ * Map each of the given labels to an integer, in the order in which the labels
+ * first appear, and return the number of distinct labels.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param labels Integer labels, starting from zero.
+ */
+template<typename KeyType, typename RowType>
+size_t OneHotLabels(const RowType& labelsIn, arma::Row<size_t>& labels)
+{
+  labels.set_size(labelsIn.n_elem);
+
+  // Loop over the input labels, and develop the mapping.
+  std::unordered_map<KeyType, size_t> labelMap;
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    // If labelsIn[i] is already in the map, use the existing label; otherwise
+    // add it to the map.
+    const size_t curLabel = labelMap.size();
+    labels[i] = labelMap.emplace(labelsIn[i], curLabel).first->second;
+  }
+
+  return labelMap.size();
+}
+
+/**
+ * Compute the mappings of the dimensions of the input to be one-hot encoded.
+ * The values of each of those dimensions are mapped to integers in the order
+ * in which they first appear; the dimensions are independent, so they are
+ * mapped in parallel.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param codeRows For each row of the input, the column of codes that holds
+ *     its mapped values, or the number of rows of the input if the row is not
+ *     encoded.
+ * @param codes The mapped values of each encoded row (as columns).
+ * @param dimensionOffsets The offset of each row of the input in the encoded
+ *     matrix, followed by the number of rows of the encoded matrix.
+ */
+template<typename eT>
+void OneHotCodes(const arma::Mat<eT>& input,
+                 const arma::Col<size_t>& indices,
+                 std::vector<size_t>& codeRows,
+                 arma::Mat<size_t>& codes,
+                 arma::Col<size_t>& dimensionOffsets)
+{
+  const size_t notEncoded = input.n_rows;
+  codeRows.assign(input.n_rows, notEncoded);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "OneHotEncoding(): index " << indices[i] << " is out of range; "
+          << "the input has only " << input.n_rows << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+
+    codeRows[indices[i]] = 0;
+  }
+
+  // Duplicate indices are only encoded once.
+  std::vector<size_t> encodedRows;
+  for (size_t row = 0; row < input.n_rows; ++row)
+  {
+    if (codeRows[row] != notEncoded)
+    {
+      codeRows[row] = encodedRows.size();
+      encodedRows.push_back(row);
+    }
+  }
+
+  // Each dimension takes one row of the output, unless it is encoded.
+  arma::Col<size_t> dimensionCounts(input.n_rows + 1, arma::fill::ones);
+  dimensionCounts[0] = 0;
+  codes.set_size(input.n_cols, encodedRows.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t e = 0; e < (omp_size_t) encodedRows.size(); ++e)
+  {
+    const size_t row = encodedRows[e];
+    std::unordered_map<eT, size_t> mapping;
+    for (size_t col = 0; col < input.n_cols; ++col)
+    {
+      const size_t code = mapping.size();
+      codes(col, e) = mapping.emplace(input(row, col), code).first->second;
+    }
+
+    dimensionCounts[row + 1] = mapping.size();
+  }
+
+  dimensionOffsets = arma::cumsum(dimensionCounts);
+}
+
+} // namespace details
+
 /**
  * Given a set of labels of a particular datatype, convert them to binary
  * vector. The categorical values be mapped to integer values.
@@ -34,35 +136,35 @@ void OneHotEncoding(const RowType& labelsIn,
                     MatType& output)
 {
   arma::Row<size_t> labels;
-  labels.set_size(labelsIn.n_elem);
+  const size_t numLabels = details::OneHotLabels<
+      typename MatType::elem_type>(labelsIn, labels);
 
-  // Loop over the input labels, and develop the mapping.
-  // Map for labelsIn to labels.
-  std::unordered_map<typename MatType::elem_type, size_t> labelMap;
-  size_t curLabel = 0;
-  for (size_t i = 0; i < labelsIn.n_elem; ++i)
-  {
-    // If labelsIn[i] is already in the map, use the existing label.
-    if (labelMap.count(labelsIn[i]) != 0)
-    {
-      labels[i] = labelMap[labelsIn[i]] - 1;
-    }
-    else
-    {
-      // If labelsIn[i] not there then add it to the map.
-      labelMap[labelsIn[i]] = curLabel + 1;
-      labels[i] = curLabel;
-      ++curLabel;
-    }
-  }
   // Resize output matrix to necessary size, and fill it with zeros.
-  output.zeros(curLabel, labelsIn.n_elem);
+  output.zeros(numLabels, labelsIn.n_elem);
   // Fill ones in at the required places.
   for (size_t i = 0; i < labelsIn.n_elem; ++i)
   {
     output(labels[i], i) = 1;
   }
-  labelMap.clear();
+}
+
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output)
+{
+  arma::Row<size_t> labels;
+  const size_t numLabels = details::OneHotLabels<eT>(labelsIn, labels);
+
+  // Each column holds a single one, in the row of its label.
+  arma::umat locations(2, labelsIn.n_elem);
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    locations(0, i) = labels[i];
+    locations(1, i) = i;
+  }
+
+  output = arma::SpMat<eT>(locations, arma::ones<arma::Col<eT>>(
+      labelsIn.n_elem), numLabels, labelsIn.n_elem, false);
 }
 
 /**
@@ -86,61 +188,88 @@ void OneHotEncoding(const arma::Mat<eT>& input,
     return;
   }
 
-  // First, we need to compute the size of the output matrix.
+  std::vector<size_t> codeRows;
+  arma::Mat<size_t> codes;
+  arma::Col<size_t> dimensionOffsets;
+  details::OneHotCodes(input, indices, codeRows, codes, dimensionOffsets);
 
-  // This vector will eventually hold the offsets for each dimension in the
-  // one-hot encoded matrix, but first it will just hold the counts of
-  // dimensions for each dimension.
-  arma::Col<size_t> dimensionOffsets(input.n_rows, arma::fill::ones);
-  // This will hold the mappings from a value that should be one-hot encoded to
-  // the index of the dimension it should take.
-  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
-  for (size_t i = 0; i < indices.n_elem; ++i)
-  {
-    dimensionOffsets[indices[i]] = 0;
-    mappings.insert(
-        std::make_pair(indices[i], std::unordered_map<eT, size_t>()));
-  }
+  // Now, initialize the output matrix to the right size.
+  output.zeros(dimensionOffsets[input.n_rows], input.n_cols);
 
-  for (size_t col = 0; col < input.n_cols; ++col)
+  // Finally, one-hot encode the matrix; each point is encoded independently.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      if (mappings.count(row) != 0)
+      if (codeRows[row] != input.n_rows)
       {
-        // We have to one-hot encode this point.
-        if (mappings[row].count(input(row, col)) == 0)
-          mappings[row][input(row, col)] = dimensionOffsets[row]++;
+        output(dimensionOffsets[row] + codes(col, codeRows[row]), col) = eT(1);
+      }
+      else
+      {
+        // No need for one-hot encoding.
+        output(dimensionOffsets[row], col) = input(row, col);
       }
     }
   }
+}
+
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output)
+{
+  std::vector<size_t> codeRows;
+  arma::Mat<size_t> codes;
+  arma::Col<size_t> dimensionOffsets;
+  details::OneHotCodes(input, indices, codeRows, codes, dimensionOffsets);
 
-  // Turn the dimension counts into offsets.  Note that the last element is the
-  // total number of dimensions, and the first element is the offset for
-  // dimension *2* (not 1).
-  for (size_t i = 1; i < dimensionOffsets.n_elem; ++i)
-    dimensionOffsets[i] += dimensionOffsets[i - 1];
+  // Count the nonzero values of each column first.
+  arma::Col<arma::uword> colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
+  {
+    arma::uword count = 0;
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      if (codeRows[row] != input.n_rows || input(row, col) != eT(0))
+        ++count;
+    }
 
-  // Now, initialize the output matrix to the right size.
-  output.zeros(dimensionOffsets[dimensionOffsets.n_elem - 1], input.n_cols);
+    colPtrs[col + 1] = count;
+  }
 
-  // Finally, one-hot encode the matrix.
   for (size_t col = 0; col < input.n_cols; ++col)
+    colPtrs[col + 1] += colPtrs[col];
+
+  // Now fill in the values; the rows of each column are increasing, since the
+  // offsets of the dimensions are.
+  arma::Col<arma::uword> rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
+    arma::uword position = colPtrs[col];
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      const size_t dimOffset = (row == 0) ? 0 : dimensionOffsets[row - 1];
-      if (mappings.count(row) != 0)
+      if (codeRows[row] != input.n_rows)
       {
-        output(dimOffset + mappings[row][input(row, col)], col) = eT(1);
+        rowIndices[position] = dimensionOffsets[row] +
+            codes(col, codeRows[row]);
+        values[position++] = eT(1);
       }
-      else
+      else if (input(row, col) != eT(0))
       {
-        // No need for one-hot encoding.
-        output(dimOffset, col) = input(row, col);
+        rowIndices[position] = dimensionOffsets[row];
+        values[position++] = input(row, col);
       }
     }
   }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values,
+      dimensionOffsets[input.n_rows], input.n_cols);
 }
 
 /**
@@ -169,6 +298,22 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   OneHotEncoding(input, arma::Col<size_t>(indices), output);
 }
 
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      indices.push_back(i);
+    }
+  }
+  OneHotEncoding(input, arma::Col<size_t>(indices), output);
+}
+
 } // namespace data
 } // namespace mlpack
 
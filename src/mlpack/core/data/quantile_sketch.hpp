@@ -0,0 +1,270 @@
+/**
+ * @file core/data/quantile_sketch.hpp
+ *
+ * QuantileSketch class, which estimates the quantiles of a stream of values in
+ * a small, bounded amount of memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_QUANTILE_SKETCH_HPP
+#define MLPACK_CORE_DATA_QUANTILE_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The QuantileSketch class estimates the quantiles of a stream of values, in
+ * memory that grows only with the logarithm of the number of values.  It is a
+ * mergeable sketch made of compactors (Manku, Rajagopalan and Lindsay; Karnin,
+ * Lang and Liberty): level l holds values that each stand for 2^l values of
+ * the stream, and when a level holds more than Capacity() values, they are
+ * sorted and every other one is moved up to the next level.  The rank error of
+ * a quantile is then about log2(n / capacity) / capacity, relative to the
+ * number of values n.  Until the first compaction, that is for at most
+ * Capacity() values, the quantiles are exact.
+ *
+ * Two sketches of different parts of a stream can be combined with Merge(), so
+ * that the parts can be processed by different threads, or in chunks.  The
+ * compactions are deterministic, so the same values given in the same order
+ * always give the same sketch.  Besides quantiles, the sketch estimates ranks
+ * with Rank(), and gives the values it keeps with their weights with
+ * WeightedValues(), for algorithms that sweep over the estimated distribution
+ * (such as tree::QuantileNumericSplit).
+ *
+ * @code
+ * QuantileSketch sketch;
+ * for (size_t i = 0; i < values.n_elem; ++i)
+ *   sketch.Insert(values[i]);
+ * const double median = sketch.Quantile(0.5);
+ * @endcode
+ */
+class QuantileSketch
+{
+ public:
+  /**
+   * Create an empty sketch with the given capacity of each level.  A larger
+   * capacity gives more accurate quantiles, with more memory and time.
+   *
+   * @param capacity Number of values kept by each level (at least 2).
+   */
+  QuantileSketch(const size_t capacity = 512) :
+      capacity(std::max(capacity, (size_t) 2)),
+      count(0)
+  { }
+
+  /**
+   * Add a value to the sketch.
+   *
+   * @param value Value to add.
+   */
+  void Insert(const double value)
+  {
+    if (levels.empty())
+      AddLevel();
+
+    levels[0].push_back(value);
+    ++count;
+    if (levels[0].size() > capacity)
+      Compress();
+  }
+
+  /**
+   * Merge the values of another sketch, of the same capacity, into this
+   * sketch.
+   *
+   * @param other Sketch to merge.
+   */
+  void Merge(const QuantileSketch& other)
+  {
+    if (other.capacity != capacity)
+    {
+      std::ostringstream oss;
+      oss << "QuantileSketch::Merge(): capacity of merged sketch ("
+          << other.capacity << ") differs from capacity of this sketch ("
+          << capacity << ")";
+      throw std::invalid_argument(oss.str());
+    }
+
+    while (levels.size() < other.levels.size())
+      AddLevel();
+    for (size_t l = 0; l < other.levels.size(); ++l)
+    {
+      levels[l].insert(levels[l].end(), other.levels[l].begin(),
+          other.levels[l].end());
+    }
+    count += other.count;
+    Compress();
+  }
+
+  /**
+   * Estimate the given quantile of the values.  As for arma::median(), the
+   * quantiles of the exact values are linearly interpolated, so that the
+   * median of an even number of values is the mean of the two middle ones.
+   * Throws std::invalid_argument if the sketch holds no values.
+   *
+   * @param q Quantile to estimate, in [0, 1].
+   * @return Estimate of the quantile.
+   */
+  double Quantile(const double q) const
+  {
+    if (count == 0)
+    {
+      throw std::invalid_argument("QuantileSketch::Quantile(): the sketch "
+          "holds no values");
+    }
+
+    const double clamped = std::min(std::max(q, 0.0), 1.0);
+
+    // Exact quantile, if nothing was compacted yet.
+    if (levels.size() == 1)
+    {
+      std::vector<double> values(levels[0]);
+      std::sort(values.begin(), values.end());
+      const double position = clamped * (values.size() - 1);
+      const size_t lower = (size_t) position;
+      if (lower + 1 >= values.size())
+        return values.back();
+      return values[lower] + (position - lower) *
+          (values[lower + 1] - values[lower]);
+    }
+
+    std::vector<std::pair<double, size_t>> weighted;
+    WeightedValues(weighted);
+
+    const double rank = clamped * (count - 1);
+    size_t cumulative = 0;
+    for (size_t i = 0; i < weighted.size(); ++i)
+    {
+      cumulative += weighted[i].second;
+      if ((double) cumulative > rank)
+        return weighted[i].first;
+    }
+    return weighted.back().first;
+  }
+
+  /**
+   * Estimate the number of values added to the sketch that are smaller than
+   * the given value.  This is exact until the first compaction.
+   *
+   * @param value Value to estimate the rank of.
+   */
+  size_t Rank(const double value) const
+  {
+    size_t rank = 0;
+    for (size_t l = 0; l < levels.size(); ++l)
+      for (size_t i = 0; i < levels[l].size(); ++i)
+        if (levels[l][i] < value)
+          rank += (size_t) 1 << l;
+
+    return rank;
+  }
+
+  /**
+   * Get the values kept by the sketch with their weights (the number of
+   * values of the stream that each stands for), sorted by value.  The weights
+   * add up to Count(), so sweeping over them gives an estimate of the whole
+   * distribution.
+   *
+   * @param weighted Vector to store the pairs of values and weights in.
+   */
+  void WeightedValues(std::vector<std::pair<double, size_t>>& weighted) const
+  {
+    weighted.clear();
+    weighted.reserve(NumItems());
+    for (size_t l = 0; l < levels.size(); ++l)
+      for (size_t i = 0; i < levels[l].size(); ++i)
+        weighted.push_back(std::make_pair(levels[l][i], (size_t) 1 << l));
+    std::sort(weighted.begin(), weighted.end());
+  }
+
+  //! Get the number of values added to the sketch.
+  size_t Count() const { return count; }
+  //! Get the number of values kept by each level.
+  size_t Capacity() const { return capacity; }
+
+  //! Get the number of values kept by the sketch.
+  size_t NumItems() const
+  {
+    size_t items = 0;
+    for (size_t l = 0; l < levels.size(); ++l)
+      items += levels[l].size();
+    return items;
+  }
+
+  //! Get the number of levels of the sketch.
+  size_t NumLevels() const { return levels.size(); }
+
+  //! Get the memory used by the sketch, in bytes.
+  size_t MemoryUsage() const
+  {
+    size_t memory = sizeof(QuantileSketch) + offsets.size() / 8;
+    for (size_t l = 0; l < levels.size(); ++l)
+    {
+      memory += sizeof(std::vector<double>) +
+          levels[l].capacity() * sizeof(double);
+    }
+    return memory;
+  }
+
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(capacity));
+    ar(CEREAL_NVP(count));
+    ar(CEREAL_NVP(levels));
+    ar(CEREAL_NVP(offsets));
+  }
+
+ private:
+  //! Add an empty level on top of the sketch.
+  void AddLevel()
+  {
+    levels.push_back(std::vector<double>());
+    levels.back().reserve(capacity + 1);
+    offsets.push_back(false);
+  }
+
+  //! Compact every level that holds more than capacity values.
+  void Compress()
+  {
+    for (size_t l = 0; l < levels.size(); ++l)
+    {
+      if (levels[l].size() <= capacity)
+        continue;
+
+      if (l + 1 == levels.size())
+        AddLevel();
+
+      // Move one value of each pair of sorted values up (with twice the
+      // weight); if there is an odd number of values, the smallest one stays.
+      // The offset alternates, so that the values moved up are not always
+      // the smaller ones of their pairs.
+      std::vector<double>& level = levels[l];
+      std::sort(level.begin(), level.end());
+      const size_t start = level.size() % 2;
+      for (size_t i = start + (offsets[l] ? 1 : 0); i < level.size(); i += 2)
+        levels[l + 1].push_back(level[i]);
+      offsets[l] = !offsets[l];
+      level.resize(start);
+    }
+  }
+
+  //! The number of values kept by each level.
+  size_t capacity;
+  //! The number of values added to the sketch.
+  size_t count;
+  //! The values of each level; a value of level l stands for 2^l values.
+  std::vector<std::vector<double>> levels;
+  //! The offset of the next compaction of each level.
+  std::vector<bool> offsets;
+}; // class QuantileSketch
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,7 @@
 #include <mlpack/core/arma_extend/arma_extend.hpp> // Includes Armadillo.
 #include <string>
 
+#include "dataset_mapper.hpp"
 #include "format.hpp"
 #include "image_info.hpp"
 
@@ -40,6 +41,9 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
  *
+ * Matrices can also be saved in the mlpack dataset format (.mlds); then every
+ * dimension is marked as numeric.
+ *
  * By default, this function will try to automatically determine the format to
  * save with based only on the filename's extension.  If you would prefer to
  * specify a file type manually, override the default
@@ -66,6 +70,33 @@ bool Save(const std::string& filename,
           bool transpose = true,
           arma::file_type inputSaveType = arma::auto_detect);
 
+/**
+ * Saves a matrix to file together with the DatasetMapper that holds its
+ * dimension types and categorical mappings, so that they can be restored by
+ * data::Load() with a DatasetMapper.  The only format that can store the
+ * mappings is the mlpack dataset format, denoted by .mlds; see
+ * data::SaveMLDS() for details.  For any other extension, an error will be
+ * given.
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.  If the 'transpose' parameter is set to true, the
+ * matrix holds one point per column, as after data::Load().
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save into file.
+ * @param info DatasetMapper of the matrix.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, the matrix holds one point per column (default
+ *     true).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT, typename PolicyType>
+bool Save(const std::string& filename,
+          const arma::Mat<eT>& matrix,
+          const DatasetMapper<PolicyType>& info,
+          const bool fatal = false,
+          const bool transpose = true);
+
 /**
  * Saves a sparse matrix to file, guessing the filetype from the
  * extension.  This will transpose the matrix at save time.  If the
@@ -16,6 +16,7 @@
 #include "save.hpp"
 #include "extension.hpp"
 #include "detect_file_type.hpp"
+#include "mlds.hpp"
 
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/json.hpp>
@@ -50,6 +51,13 @@ bool Save(const std::string& filename,
           bool transpose,
           arma::file_type inputSaveType)
 {
+  // Files in the mlpack dataset format are not Armadillo files.
+  if (inputSaveType == arma::auto_detect && Extension(filename) == "mlds")
+  {
+    const DatasetInfo info(transpose ? matrix.n_rows : matrix.n_cols);
+    return Save(filename, matrix, info, fatal, transpose);
+  }
+
   Timer::Start("saving_data");
 
   arma::file_type saveType = inputSaveType;
@@ -150,6 +158,50 @@ bool Save(const std::string& filename,
   return true;
 }
 
+// Save with mappings.
+template<typename eT, typename PolicyType>
+bool Save(const std::string& filename,
+          const arma::Mat<eT>& matrix,
+          const DatasetMapper<PolicyType>& info,
+          const bool fatal,
+          const bool transpose)
+{
+  Timer::Start("saving_data");
+
+  if (Extension(filename) != "mlds")
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Cannot save '" << filename << "' with its mappings; only "
+          << "the mlpack dataset format (.mlds) can store them." << std::endl;
+    else
+      Log::Warn << "Cannot save '" << filename << "' with its mappings; only "
+          << "the mlpack dataset format (.mlds) can store them.  Save failed."
+          << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Saving mlpack dataset to '" << filename << "'." << std::endl;
+  try
+  {
+    SaveMLDS(filename, matrix, info, transpose);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
 // Save a Sparse Matrix
 template<typename eT>
 bool Save(const std::string& filename,
@@ -0,0 +1,217 @@
+/**
+ * @file core/data/scaler_methods/column_statistics.hpp
+ *
+ * ColumnStatistics class, which computes the statistics that the scalers are
+ * fitted with in a single pass over the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COLUMN_STATISTICS_HPP
+#define MLPACK_CORE_DATA_COLUMN_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The ColumnStatistics class holds the number of points, and the mean, sum of
+ * squared deviations from the mean, minimum and maximum of each dimension of a
+ * dataset.  All of them are computed in a single pass over the points with
+ * Welford's method.  With OpenMP, each thread makes the pass over its own
+ * block of points, and the statistics of the blocks are then merged with the
+ * pairwise formulas of Chan et al.  The same merge is used when more points
+ * are added with Update(), so a dataset can be processed in chunks.
+ *
+ * @code
+ * ColumnStatistics statistics;
+ * statistics.Update(firstChunk);
+ * statistics.Update(secondChunk);
+ * arma::vec variance = statistics.Variance();
+ * @endcode
+ */
+class ColumnStatistics
+{
+ public:
+  //! Create an empty object, with no points.
+  ColumnStatistics() : count(0) { }
+
+  /**
+   * Add the points (columns) of the given dataset to the statistics.  The
+   * dimensionality of the dataset must be the same for every call.
+   *
+   * @param input Dataset to add.
+   */
+  template<typename MatType>
+  void Update(const MatType& input)
+  {
+    if (count > 0 && input.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "ColumnStatistics::Update(): dataset has " << input.n_rows
+          << " dimensions, but previous data had " << mean.n_elem;
+      throw std::invalid_argument(oss.str());
+    }
+
+    #ifdef HAS_OPENMP
+    const size_t blocks = std::max(std::min((size_t) omp_get_max_threads(),
+        (size_t) input.n_cols), (size_t) 1);
+    #else
+    const size_t blocks = 1;
+    #endif
+
+    std::vector<ColumnStatistics> partial(blocks);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t begin = b * input.n_cols / blocks;
+      const size_t end = (b + 1) * input.n_cols / blocks;
+      partial[b].UpdateSerial(input, begin, end);
+    }
+
+    for (size_t b = 0; b < blocks; ++b)
+      Merge(partial[b]);
+  }
+
+  /**
+   * Merge the statistics of other points into these statistics.
+   *
+   * @param other Statistics of the other points.
+   */
+  void Merge(const ColumnStatistics& other)
+  {
+    if (other.count == 0)
+      return;
+
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    const double total = (double) (count + other.count);
+    const arma::vec delta = other.mean - mean;
+    mean += delta * (other.count / total);
+    m2 += other.m2 + arma::square(delta) * (count * (other.count / total));
+    min = arma::min(min, other.min);
+    max = arma::max(max, other.max);
+    count += other.count;
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return min; }
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return max; }
+  //! Get the sum of squared deviations from the mean of each dimension.
+  const arma::vec& M2() const { return m2; }
+
+  //! Get the (biased) variance of each dimension.
+  arma::vec Variance() const { return m2 / (double) count; }
+
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(count));
+    ar(CEREAL_NVP(mean));
+    ar(CEREAL_NVP(m2));
+    ar(CEREAL_NVP(min));
+    ar(CEREAL_NVP(max));
+  }
+
+ private:
+  /**
+   * Compute the statistics of the points [begin, end) of the given dataset,
+   * which must be the first points given to this object.
+   */
+  template<typename MatType>
+  void UpdateSerial(const MatType& input, const size_t begin, const size_t end)
+  {
+    const size_t n = input.n_rows;
+    mean.zeros(n);
+    m2.zeros(n);
+    min.set_size(n);
+    min.fill(std::numeric_limits<double>::infinity());
+    max.set_size(n);
+    max.fill(-std::numeric_limits<double>::infinity());
+
+    double* meanPtr = mean.memptr();
+    double* m2Ptr = m2.memptr();
+    double* minPtr = min.memptr();
+    double* maxPtr = max.memptr();
+    for (size_t j = begin; j < end; ++j)
+    {
+      const typename MatType::elem_type* x = input.colptr(j);
+      const double inverseCount = 1.0 / (double) (++count);
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double value = (double) x[i];
+        const double delta = value - meanPtr[i];
+        meanPtr[i] += delta * inverseCount;
+        m2Ptr[i] += delta * (value - meanPtr[i]);
+        minPtr[i] = std::min(minPtr[i], value);
+        maxPtr[i] = std::max(maxPtr[i], value);
+      }
+    }
+  }
+
+  //! The number of points.
+  size_t count;
+  //! The mean of each dimension.
+  arma::vec mean;
+  //! The sum of squared deviations from the mean of each dimension.
+  arma::vec m2;
+  //! The minimum of each dimension.
+  arma::vec min;
+  //! The maximum of each dimension.
+  arma::vec max;
+}; // class ColumnStatistics
+
+/**
+ * Scale every point (column) of the given dataset in place, so that each
+ * value x of dimension i becomes x * scale[i] + offset[i].  All of the scalers
+ * are of this form.  The points are scaled in parallel with OpenMP.
+ *
+ * @param input Dataset to scale.
+ * @param scale Scale of each dimension.
+ * @param offset Offset of each dimension.
+ */
+template<typename MatType>
+void ScaleColumns(MatType& input,
+                  const arma::vec& scale,
+                  const arma::vec& offset)
+{
+  if (input.n_rows != scale.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "Transform(): dataset has " << input.n_rows << " dimensions, but "
+        << "the scaler was fitted with " << scale.n_elem;
+    throw std::invalid_argument(oss.str());
+  }
+
+  typedef typename MatType::elem_type ElemType;
+  const double* scalePtr = scale.memptr();
+  const double* offsetPtr = offset.memptr();
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+  {
+    ElemType* x = input.colptr(j);
+    for (size_t i = 0; i < input.n_rows; ++i)
+      x[i] = ElemType(x[i] * scalePtr[i] + offsetPtr[i]);
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
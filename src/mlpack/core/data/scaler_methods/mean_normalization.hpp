@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_MEAN_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "column_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -54,9 +55,26 @@ class MeanNormalization
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics = ColumnStatistics();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features to another chunk of the dataset, so that the
+   * scaler is fitted to all the points given to Fit() and PartialFit() since
+   * the last call to Fit().  This allows a dataset that does not fit in memory
+   * to be fitted in chunks.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    // The mean, minimum and maximum are computed in a single pass.
+    statistics.Update(input);
+    itemMean = statistics.Mean();
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = itemMax - itemMin;
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -81,6 +99,22 @@ class MeanNormalization
     output = (input.each_col() - itemMean).each_col() / scale;
   }
 
+  /**
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& input)
+  {
+    if (itemMean.is_empty() || scale.is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+        " refer to the documentation.");
+    }
+    ScaleColumns(input, 1.0 / scale, -itemMean / scale);
+  }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -104,15 +138,24 @@ class MeanNormalization
   const arma::vec& Scale() const { return scale; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMin));
     ar(CEREAL_NVP(itemMax));
     ar(CEREAL_NVP(scale));
     ar(CEREAL_NVP(itemMean));
+
+    // Older versions did not store the statistics, so PartialFit() on them
+    // starts a new fit.
+    if (version > 0)
+      ar(CEREAL_NVP(statistics));
+    else if (cereal::is_loading<Archive>())
+      statistics = ColumnStatistics();
   }
 
  private:
+  // Statistics of the points fitted so far.
+  ColumnStatistics statistics;
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Vector which holds minimum of each feature.
@@ -126,4 +169,6 @@ class MeanNormalization
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::MeanNormalization, 1);
+
 #endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "column_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -73,8 +74,25 @@ class MinMaxScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics = ColumnStatistics();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features to another chunk of the dataset, so that the
+   * scaler is fitted to all the points given to Fit() and PartialFit() since
+   * the last call to Fit().  This allows a dataset that does not fit in memory
+   * to be fitted in chunks.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    // The minimum and maximum are computed in a single pass.
+    statistics.Update(input);
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = itemMax - itemMin;
     // Handle zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -103,6 +121,22 @@ class MinMaxScaler
     output = (input.each_col() % scale).each_col() + scalerowmin;
   }
 
+  /**
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& input)
+  {
+    if (scalerowmin.is_empty() || scale.is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+        " refer to the documentation.");
+    }
+    ScaleColumns(input, scale, scalerowmin);
+  }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -128,7 +162,7 @@ class MinMaxScaler
   double ScaleMin() const { return scaleMin; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMin));
     ar(CEREAL_NVP(itemMax));
@@ -136,9 +170,18 @@ class MinMaxScaler
     ar(CEREAL_NVP(scaleMin));
     ar(CEREAL_NVP(scaleMax));
     ar(CEREAL_NVP(scalerowmin));
+
+    // Older versions did not store the statistics, so PartialFit() on them
+    // starts a new fit.
+    if (version > 0)
+      ar(CEREAL_NVP(statistics));
+    else if (cereal::is_loading<Archive>())
+      statistics = ColumnStatistics();
   }
 
  private:
+  // Statistics of the points fitted so far.
+  ColumnStatistics statistics;
   // Vector which holds minimum of each feature.
   arma::vec itemMin;
   // Vector which holds maximum of each feature.
@@ -156,4 +199,6 @@ class MinMaxScaler
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::MinMaxScaler, 1);
+
 #endif
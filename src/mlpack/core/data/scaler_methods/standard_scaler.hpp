@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_STANDARD_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "column_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -55,8 +56,25 @@ class StandardScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
+    statistics = ColumnStatistics();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features to another chunk of the dataset, so that the
+   * scaler is fitted to all the points given to Fit() and PartialFit() since
+   * the last call to Fit().  This allows a dataset that does not fit in memory
+   * to be fitted in chunks.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    // The mean and deviation are computed in a single pass.
+    statistics.Update(input);
+    itemMean = statistics.Mean();
+    itemStdDev = arma::sqrt(statistics.Variance());
     // Handle zeros in scale vector.
     itemStdDev.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
@@ -80,6 +98,22 @@ class StandardScaler
     output = (input.each_col() - itemMean).each_col() / itemStdDev;
   }
 
+  /**
+   * Function to scale features in place.
+   *
+   * @param input Dataset to scale features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& input)
+  {
+    if (itemMean.is_empty() || itemStdDev.is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+        " refer to the documentation.");
+    }
+    ScaleColumns(input, 1.0 / itemStdDev, -itemMean / itemStdDev);
+  }
+
   /**
    * Function to retrieve original dataset.
    *
@@ -99,13 +133,22 @@ class StandardScaler
   const arma::vec& ItemStdDev() const { return itemStdDev; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMean));
     ar(CEREAL_NVP(itemStdDev));
+
+    // Older versions did not store the statistics, so PartialFit() on them
+    // starts a new fit.
+    if (version > 0)
+      ar(CEREAL_NVP(statistics));
+    else if (cereal::is_loading<Archive>())
+      statistics = ColumnStatistics();
   }
 
  private:
+  // Statistics of the points fitted so far.
+  ColumnStatistics statistics;
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Vector which holds standard devation of each feature.
@@ -115,4 +158,6 @@ class StandardScaler
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::StandardScaler, 1);
+
 #endif
@@ -14,6 +14,8 @@
 #define MLPACK_CORE_DATA_SPLIT_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
 namespace data {
@@ -63,51 +65,61 @@ void SplitHelper(const InputType& input,
 }
 
 /**
- * Given an input dataset and labels, stratify into a training set and test set.
- * It is recommended to have the input labels between the range [0, n) where n
- * is the number of different labels. The NormalizeLabels() function in
- * mlpack::data can be used for this.
- * Expects labels to be of type arma::Row<> or arma::Col<>.
- * Throws a runtime error if this is not the case.
- * Example usage below. This overload places the stratified dataset into the
- * four output parameters given (trainData, testData, trainLabel,
- * and testLabel).
+ * Compute the indices of the points of a training set and a test set, without
+ * copying any data.  The test set holds floor(numPoints * testRatio) points.
+ * The indices can be used to select the points (e.g. with input.cols()), or to
+ * process the sets in place.
  *
  * @code
- * arma::mat input = loadData();
- * arma::Row<size_t> label = loadLabel();
- * arma::mat trainData;
- * arma::mat testData;
- * arma::Row<size_t> trainLabel;
- * arma::Row<size_t> testLabel;
- * math::RandomSeed(100); // Set the seed if you like.
- *
- * // Stratify the dataset into a training and test set, with 30% of the data
- * // being held out for the test set.
- * StratifiedSplit(input, label, trainData,
- *                 testData, trainLabel, testLabel, 0.3);
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
  * @endcode
  *
- * @param input Input dataset to stratify.
+ * @param numPoints Number of points in the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = (trainSize > 0) ? arma::uvec(order.subvec(0, trainSize - 1)) :
+      arma::uvec();
+  testIndices = (testSize > 0) ? arma::uvec(order.subvec(trainSize,
+      numPoints - 1)) : arma::uvec();
+}
+
+/**
+ * Compute the indices of the points of a stratified training set and test set,
+ * without copying any data; see StratifiedSplit() for details.  It is
+ * recommended to have the input labels between the range [0, n) where n is
+ * the number of different labels.
+ *
  * @param inputLabel Input labels to stratify.
- * @param trainData Matrix to store training data into.
- * @param testData Matrix to store test data into.
- * @param trainLabel Vector to store training labels into.
- * @param testLabel Vector to store test labels into.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
  * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
  * @param shuffleData If true, the sample order is shuffled; otherwise, each
  *     sample is visited in linear order. (Default true.)
  */
-template<typename T, typename LabelsType,
-         typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
-void StratifiedSplit(const arma::Mat<T>& input,
-                     const LabelsType& inputLabel,
-                     arma::Mat<T>& trainData,
-                     arma::Mat<T>& testData,
-                     LabelsType& trainLabel,
-                     LabelsType& testLabel,
-                     const double testRatio,
-                     const bool shuffleData = true)
+template<typename LabelsType>
+void StratifiedSplitIndices(const LabelsType& inputLabel,
+                            arma::uvec& trainIndices,
+                            arma::uvec& testIndices,
+                            const double testRatio,
+                            const bool shuffleData = true)
 {
   /**
    * Basic idea:
@@ -142,12 +154,6 @@ void StratifiedSplit(const arma::Mat<T>& input,
    * 0
    * 1 1
    */
-  const bool typeCheck = (arma::is_Row<LabelsType>::value)
-      || (arma::is_Col<LabelsType>::value);
-  if (!typeCheck)
-    throw std::runtime_error("data::Split(): when stratified sampling is done, "
-        "labels must have type `arma::Row<>`!");
-  util::CheckSameSizes(input, inputLabel, "data::Split()");
   size_t trainIdx = 0;
   size_t testIdx = 0;
   size_t trainSize = 0;
@@ -168,56 +174,93 @@ void StratifiedSplit(const arma::Mat<T>& input,
     trainSize += labelCount - floor(labelCount * testRatio);
   }
 
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
-  trainLabel.set_size(inputLabel.n_rows, trainSize);
-  testLabel.set_size(inputLabel.n_rows, testSize);
+  trainIndices.set_size(trainSize);
+  testIndices.set_size(testSize);
 
+  arma::uvec order = arma::linspace<arma::uvec>(0, inputLabel.n_elem - 1,
+      inputLabel.n_elem);
   if (shuffleData)
-  {
-    arma::uvec order = arma::shuffle(
-        arma::linspace<arma::uvec>(0, input.n_cols - 1, input.n_cols));
+    order = arma::shuffle(order);
 
-    for (arma::uword i : order)
+  for (arma::uword i : order)
+  {
+    typename LabelsType::elem_type label = inputLabel[i];
+    if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
     {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
+      testLabelCounts[label] += 1;
+      testIndices[testIdx++] = i;
     }
-  }
-  else
-  {
-    for (arma::uword i = 0; i < input.n_cols; i++)
+    else
     {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
+      trainIndices[trainIdx++] = i;
     }
   }
 }
 
+/**
+ * Given an input dataset and labels, stratify into a training set and test set.
+ * It is recommended to have the input labels between the range [0, n) where n
+ * is the number of different labels. The NormalizeLabels() function in
+ * mlpack::data can be used for this.
+ * Expects labels to be of type arma::Row<> or arma::Col<>.
+ * Throws a runtime error if this is not the case.
+ * Example usage below. This overload places the stratified dataset into the
+ * four output parameters given (trainData, testData, trainLabel,
+ * and testLabel).
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * arma::mat trainData;
+ * arma::mat testData;
+ * arma::Row<size_t> trainLabel;
+ * arma::Row<size_t> testLabel;
+ * math::RandomSeed(100); // Set the seed if you like.
+ *
+ * // Stratify the dataset into a training and test set, with 30% of the data
+ * // being held out for the test set.
+ * StratifiedSplit(input, label, trainData,
+ *                 testData, trainLabel, testLabel, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to stratify.
+ * @param inputLabel Input labels to stratify.
+ * @param trainData Matrix to store training data into.
+ * @param testData Matrix to store test data into.
+ * @param trainLabel Vector to store training labels into.
+ * @param testLabel Vector to store test labels into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+template<typename T, typename LabelsType,
+         typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
+void StratifiedSplit(const arma::Mat<T>& input,
+                     const LabelsType& inputLabel,
+                     arma::Mat<T>& trainData,
+                     arma::Mat<T>& testData,
+                     LabelsType& trainLabel,
+                     LabelsType& testLabel,
+                     const double testRatio,
+                     const bool shuffleData = true)
+{
+  const bool typeCheck = (arma::is_Row<LabelsType>::value)
+      || (arma::is_Col<LabelsType>::value);
+  if (!typeCheck)
+    throw std::runtime_error("data::Split(): when stratified sampling is done, "
+        "labels must have type `arma::Row<>`!");
+  util::CheckSameSizes(input, inputLabel, "data::Split()");
+
+  arma::uvec trainIndices, testIndices;
+  StratifiedSplitIndices(inputLabel, trainIndices, testIndices, testRatio,
+      shuffleData);
+
+  trainData = input.cols(trainIndices);
+  testData = input.cols(testIndices);
+  trainLabel = inputLabel.cols(trainIndices);
+  testLabel = inputLabel.cols(testIndices);
+}
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload places the split dataset into the four
@@ -319,6 +362,60 @@ void Split(const arma::Mat<T>& input,
   }
 }
 
+/**
+ * Given an input dataset and labels, split into a training set and test set
+ * without copying them.  If shuffleData is true, the points and labels are
+ * shuffled in place first (see math::ShuffleDataInPlace()); then trainData and
+ * testData are made aliases of the first and last columns of input, and
+ * trainLabel and testLabel aliases of the first and last elements of
+ * inputLabel.  So, the split needs no memory beyond the input itself, but the
+ * aliases are only valid as long as the input is not modified or destroyed.
+ *
+ * For the same random seed, the shuffled order is not the same as the order
+ * given by Split().
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * arma::mat trainData, testData;
+ * arma::Row<size_t> trainLabel, testLabel;
+ * SplitInPlace(input, label, trainData, testData, trainLabel, testLabel, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to split (shuffled in place).
+ * @param inputLabel Input labels to split (shuffled in place).
+ * @param trainData Matrix to make an alias of the training data.
+ * @param testData Matrix to make an alias of the test data.
+ * @param trainLabel Row to make an alias of the training labels.
+ * @param testLabel Row to make an alias of the test labels.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *       sample is visited in linear order. (Default true.)
+ */
+template<typename T, typename U>
+void SplitInPlace(arma::Mat<T>& input,
+                  arma::Row<U>& inputLabel,
+                  arma::Mat<T>& trainData,
+                  arma::Mat<T>& testData,
+                  arma::Row<U>& trainLabel,
+                  arma::Row<U>& testLabel,
+                  const double testRatio,
+                  const bool shuffleData = true)
+{
+  util::CheckSameSizes(input, inputLabel, "data::SplitInPlace()");
+  if (shuffleData)
+    math::ShuffleDataInPlace(input, inputLabel);
+
+  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
+  const size_t trainSize = input.n_cols - testSize;
+
+  math::MakeAlias(trainData, input.memptr(), input.n_rows, trainSize);
+  math::MakeAlias(testData, input.memptr() + trainSize * input.n_rows,
+      input.n_rows, testSize);
+  math::MakeAlias(trainLabel, inputLabel.memptr(), trainSize);
+  math::MakeAlias(testLabel, inputLabel.memptr() + trainSize, testSize);
+}
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload returns the split dataset as a std::tuple
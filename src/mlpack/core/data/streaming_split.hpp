@@ -0,0 +1,259 @@
+/**
+ * @file core/data/streaming_split.hpp
+ *
+ * Split a dataset file into a training file and a test file without loading
+ * it into memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_SPLIT_HPP
+#define MLPACK_CORE_DATA_STREAMING_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+#include <fstream>
+#include <map>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Return true if the given line holds only whitespace.
+inline bool IsBlankLine(const std::string& line)
+{
+  return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+//! Return the given label line without surrounding whitespace.
+inline std::string TrimLabel(const std::string& line)
+{
+  const size_t begin = line.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return std::string();
+
+  const size_t end = line.find_last_not_of(" \t\r");
+  return line.substr(begin, end - begin + 1);
+}
+
+//! Open the given file for reading, or throw an exception.
+inline void OpenInput(std::ifstream& stream, const std::string& filename)
+{
+  stream.open(filename.c_str());
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("StreamingSplit(): cannot open file '" + filename +
+        "' for reading");
+  }
+}
+
+//! Open the given file for writing, or throw an exception.
+inline void OpenOutput(std::ofstream& stream, const std::string& filename)
+{
+  stream.open(filename.c_str());
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("StreamingSplit(): cannot open file '" + filename +
+        "' for writing");
+  }
+}
+
+/**
+ * Decide whether the next point goes to the test set, with selection
+ * sampling: if needed of the remaining points must still be selected, the
+ * point is selected with probability needed / remaining.  This selects exactly
+ * the requested number of points, uniformly at random.
+ */
+inline bool SelectPoint(size_t& needed, size_t& remaining)
+{
+  const bool selected = (math::Random() * remaining < needed);
+  if (selected)
+    --needed;
+  --remaining;
+  return selected;
+}
+
+} // namespace details
+
+/**
+ * Split the points of a text dataset file (e.g. a CSV file with one point per
+ * line) into a training file and a test file, without loading the dataset
+ * into memory.  The file is read twice: once to count the points, and once to
+ * write each line, verbatim, to one of the output files.  Blank lines are
+ * skipped.  The test file gets floor(n * testRatio) points, chosen uniformly at
+ * random (the seed can be set with math::RandomSeed()).
+ *
+ * Unlike Split(), the points keep their order in the input file; they are not
+ * shuffled, since that would need the whole dataset in memory.
+ *
+ * @code
+ * // Hold out 20% of the points for the test set.
+ * StreamingSplit("data.csv", "train.csv", "test.csv", 0.2);
+ * @endcode
+ *
+ * @param inputFile Dataset file to split.
+ * @param trainFile File to write the training points to.
+ * @param testFile File to write the test points to.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ */
+inline void StreamingSplit(const std::string& inputFile,
+                           const std::string& trainFile,
+                           const std::string& testFile,
+                           const double testRatio)
+{
+  std::ifstream input;
+  std::string line;
+  details::OpenInput(input, inputFile);
+  size_t numPoints = 0;
+  while (std::getline(input, line))
+  {
+    if (!details::IsBlankLine(line))
+      ++numPoints;
+  }
+
+  // Read the file again.
+  input.close();
+  details::OpenInput(input, inputFile);
+
+  std::ofstream train, test;
+  details::OpenOutput(train, trainFile);
+  details::OpenOutput(test, testFile);
+
+  size_t needed = static_cast<size_t>(numPoints * testRatio);
+  size_t remaining = numPoints;
+  while (std::getline(input, line))
+  {
+    if (details::IsBlankLine(line))
+      continue;
+
+    (details::SelectPoint(needed, remaining) ? test : train) << line << '\n';
+  }
+}
+
+/**
+ * Split the points of a text dataset file and the labels of a label file (one
+ * label per line) into training and test files, without loading them into
+ * memory.  The two input files are read in lockstep, and must hold the same
+ * number of (non-blank) lines.  If stratifyData is true, the test set gets
+ * floor(n_l * testRatio) of the n_l points of each label l, as in
+ * StratifiedSplit(); labels are compared as text, without surrounding
+ * whitespace.  Otherwise, the test set gets floor(n * testRatio) points.  In
+ * both cases, the points are chosen uniformly at random, and they keep their
+ * order in the input files.
+ *
+ * @code
+ * StreamingSplit("data.csv", "labels.csv", "train.csv", "test.csv",
+ *     "train_labels.csv", "test_labels.csv", 0.2, true);
+ * @endcode
+ *
+ * @param inputFile Dataset file to split.
+ * @param labelsFile Labels file to split.
+ * @param trainFile File to write the training points to.
+ * @param testFile File to write the test points to.
+ * @param trainLabelsFile File to write the training labels to.
+ * @param testLabelsFile File to write the test labels to.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param stratifyData If true, the train and test splits are stratified so
+ *     that the ratio of each label in the training and test splits is the
+ *     same as in the input. (Default false.)
+ */
+inline void StreamingSplit(const std::string& inputFile,
+                           const std::string& labelsFile,
+                           const std::string& trainFile,
+                           const std::string& testFile,
+                           const std::string& trainLabelsFile,
+                           const std::string& testLabelsFile,
+                           const double testRatio,
+                           const bool stratifyData = false)
+{
+  std::ifstream input, labels;
+  std::string line, label;
+
+  // Count the points, and the points of each label if needed.
+  details::OpenInput(input, inputFile);
+  size_t numPoints = 0;
+  while (std::getline(input, line))
+  {
+    if (!details::IsBlankLine(line))
+      ++numPoints;
+  }
+
+  details::OpenInput(labels, labelsFile);
+  size_t numLabels = 0;
+  std::map<std::string, size_t> labelCounts;
+  while (std::getline(labels, label))
+  {
+    if (details::IsBlankLine(label))
+      continue;
+
+    ++numLabels;
+    if (stratifyData)
+      ++labelCounts[details::TrimLabel(label)];
+  }
+
+  if (numPoints != numLabels)
+  {
+    std::ostringstream oss;
+    oss << "StreamingSplit(): '" << inputFile << "' has " << numPoints
+        << " points, but '" << labelsFile << "' has " << numLabels
+        << " labels";
+    throw std::runtime_error(oss.str());
+  }
+
+  // The number of test points still needed, and of points still remaining,
+  // overall or for each label.
+  size_t needed = static_cast<size_t>(numPoints * testRatio);
+  size_t remaining = numPoints;
+  std::map<std::string, std::pair<size_t, size_t>> labelSampling;
+  for (const std::pair<const std::string, size_t>& count : labelCounts)
+  {
+    labelSampling[count.first] = std::make_pair(
+        static_cast<size_t>(count.second * testRatio), count.second);
+  }
+
+  input.close();
+  labels.close();
+  details::OpenInput(input, inputFile);
+  details::OpenInput(labels, labelsFile);
+
+  std::ofstream train, test, trainLabels, testLabels;
+  details::OpenOutput(train, trainFile);
+  details::OpenOutput(test, testFile);
+  details::OpenOutput(trainLabels, trainLabelsFile);
+  details::OpenOutput(testLabels, testLabelsFile);
+
+  while (std::getline(input, line))
+  {
+    if (details::IsBlankLine(line))
+      continue;
+
+    // The counts matched, so there is a label for each point.
+    do
+    {
+      std::getline(labels, label);
+    } while (details::IsBlankLine(label));
+
+    bool selected;
+    if (stratifyData)
+    {
+      std::pair<size_t, size_t>& sampling =
+          labelSampling[details::TrimLabel(label)];
+      selected = details::SelectPoint(sampling.first, sampling.second);
+    }
+    else
+    {
+      selected = details::SelectPoint(needed, remaining);
+    }
+
+    (selected ? test : train) << line << '\n';
+    (selected ? testLabels : trainLabels) << label << '\n';
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
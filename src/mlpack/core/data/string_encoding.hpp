@@ -99,6 +99,12 @@ class StringEncoding
    * writes it in the column-major order. If the output type is 2D std::vector
    * then the function writes it in the row major order.
    *
+   * The strings are tokenized and encoded in parallel with OpenMP; the labels
+   * of the tokens are the same as if the strings were processed one after
+   * another.  If the output is an arma::sp_mat, only the nonzero values are
+   * stored while encoding, so the output can be much larger than the available
+   * memory would allow for a dense matrix.
+   *
    * @tparam OutputType Type of the output container. The function supports
    *                    the following types: arma::mat, arma::sp_mat,
    *                    std::vector<std::vector<>>.
@@ -114,6 +120,7 @@ class StringEncoding
    * the extracted token and returns the token;
    * 2. IsTokenEmpty() that accepts a token and returns true if the given
    *    token is empty.
+   * Both have to be safe to call from several threads at once.
    */
   template<typename OutputType, typename TokenizerType>
   void Encode(const std::vector<std::string>& input,
@@ -202,6 +209,68 @@ class StringEncoding
                     typename std::enable_if<StringEncodingPolicyTraits<
                         PolicyType>::onePassEncoding>::type* = 0);
 
+  /**
+   * A helper function to encode the given text and write the result to
+   * the given sparse matrix in the column-major order.  Each column is encoded
+   * into a buffer, and the nonzero values of the columns are then copied to
+   * the compressed representation of the output at once.
+   *
+   * @tparam eT Type of the output values.
+   * @tparam TokenizerType Type of the tokenizer.
+   * @tparam PolicyType The type of the encoding policy. It has to be
+   *                    equal to EncodingPolicyType.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output sparse matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object.
+   */
+  template<typename eT, typename TokenizerType, typename PolicyType>
+  void EncodeHelper(const std::vector<std::string>& input,
+                    arma::SpMat<eT>& output,
+                    const TokenizerType& tokenizer,
+                    PolicyType& policy);
+
+  /**
+   * Tokenize the given strings in parallel, and store the labels of the tokens
+   * of each string in labels.  Each thread labels the tokens of a block of
+   * strings with its own dictionary, and the dictionaries of the blocks are
+   * then merged into the dictionary of this object in the order of the
+   * blocks, so the labels are the same as if the strings were processed one
+   * after another.  The maximum number of tokens of a string is returned.
+   *
+   * @param input Corpus of text to tokenize.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object (not used).
+   * @param labels Labels of the tokens of each string.
+   */
+  template<typename TokenizerType, typename PolicyType>
+  size_t ExtractLabels(const std::vector<std::string>& input,
+                       const TokenizerType& tokenizer,
+                       const PolicyType& policy,
+                       std::vector<std::vector<size_t>>& labels,
+                       typename std::enable_if<!StringEncodingPolicyTraits<
+                           PolicyType>::hashesTokens>::type* = 0);
+
+  /**
+   * Tokenize the given strings in parallel, and store the labels of the tokens
+   * of each string in labels.  This is the overload for policies that label
+   * the tokens by hashing them, so the dictionary is not used.  The maximum
+   * number of tokens of a string is returned.
+   *
+   * @param input Corpus of text to tokenize.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object, which labels the tokens.
+   * @param labels Labels of the tokens of each string.
+   */
+  template<typename TokenizerType, typename PolicyType>
+  size_t ExtractLabels(const std::vector<std::string>& input,
+                       const TokenizerType& tokenizer,
+                       const PolicyType& policy,
+                       std::vector<std::vector<size_t>>& labels,
+                       typename std::enable_if<StringEncodingPolicyTraits<
+                           PolicyType>::hashesTokens>::type* = 0);
+
  private:
   //! The encoding policy object.
   EncodingPolicyType encodingPolicy;
@@ -17,9 +17,98 @@
 #include "string_encoding.hpp"
 #include <type_traits>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace data {
 
+namespace details {
+
+/**
+ * A column of a sparse matrix that the encoding policies can write to as if
+ * it was a dense matrix (through operator(), n_rows and n_cols).  The written
+ * values are then extracted in the order of their rows, and the column is
+ * cleared for the next string.  Only the written values are visited, so a
+ * column costs time proportional to its number of nonzero values.
+ *
+ * @tparam eT Type of the values.
+ */
+template<typename eT>
+class SparseEncodingColumn
+{
+ public:
+  //! The type of the values.
+  using elem_type = eT;
+
+  /**
+   * Create the column of a matrix of the given size.
+   *
+   * @param n_rows Number of rows of the matrix.
+   * @param n_cols Number of columns of the matrix.
+   */
+  SparseEncodingColumn(const size_t n_rows, const size_t n_cols) :
+      n_rows(n_rows),
+      n_cols(n_cols),
+      values(n_rows, eT(0)),
+      written(n_rows, 0)
+  { }
+
+  //! Access the value in the given row (the column is ignored).
+  eT& operator()(const size_t row, const size_t /* col */)
+  {
+    if (!written[row])
+    {
+      written[row] = 1;
+      rows.push_back(row);
+    }
+
+    return values[row];
+  }
+
+  /**
+   * Store the nonzero values of the column and their rows, in the order of
+   * the rows, and clear the column.
+   *
+   * @param rowIndices Vector to store the rows of the values in.
+   * @param columnValues Vector to store the values in.
+   */
+  void Extract(std::vector<arma::uword>& rowIndices,
+               std::vector<eT>& columnValues)
+  {
+    std::sort(rows.begin(), rows.end());
+    for (const size_t row : rows)
+    {
+      if (values[row] != eT(0))
+      {
+        rowIndices.push_back(row);
+        columnValues.push_back(values[row]);
+      }
+
+      values[row] = eT(0);
+      written[row] = 0;
+    }
+
+    rows.clear();
+  }
+
+  //! The number of rows of the matrix.
+  const size_t n_rows;
+  //! The number of columns of the matrix.
+  const size_t n_cols;
+
+ private:
+  //! The values of the column.
+  std::vector<eT> values;
+  //! Whether each value has been written.
+  std::vector<char> written;
+  //! The rows that have been written.
+  std::vector<size_t> rows;
+};
+
+} // namespace details
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename ... ArgTypes>
 StringEncoding<EncodingPolicyType, DictionaryType>::StringEncoding(
@@ -97,6 +186,137 @@ void StringEncoding<EncodingPolicyType, DictionaryType>::Encode(
 }
 
 
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType>
+size_t StringEncoding<EncodingPolicyType, DictionaryType>::ExtractLabels(
+    const std::vector<std::string>& input,
+    const TokenizerType& tokenizer,
+    const PolicyType& /* policy */,
+    std::vector<std::vector<size_t>>& labels,
+    typename std::enable_if<!StringEncodingPolicyTraits<
+        PolicyType>::hashesTokens>::type*)
+{
+  using TokenType = typename std::remove_reference<
+      typename DictionaryType::TokenType>::type;
+
+  #ifdef HAS_OPENMP
+  const size_t numBlocks = std::max(std::min((size_t) omp_get_max_threads(),
+      input.size()), (size_t) 1);
+  #else
+  const size_t numBlocks = 1;
+  #endif
+
+  labels.clear();
+  labels.resize(input.size());
+
+  // The tokens of each block, in the order of their block labels.
+  std::vector<std::vector<TokenType>> blockTokens(numBlocks);
+
+  // The first pass labels the tokens of each block with the dictionary of the
+  // block.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    DictionaryType blockDictionary;
+    const size_t end = (b + 1) * input.size() / numBlocks;
+    for (size_t i = b * input.size() / numBlocks; i < end; ++i)
+    {
+      boost::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+
+      static_assert(
+          std::is_same<typename std::remove_reference<decltype(token)>::type,
+                       TokenType>::value,
+          "The dictionary token type doesn't match the return value type "
+          "of the tokenizer.");
+
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        if (blockDictionary.HasToken(token))
+        {
+          labels[i].push_back(blockDictionary.Value(token));
+        }
+        else
+        {
+          blockTokens[b].push_back(token);
+          labels[i].push_back(blockDictionary.AddToken(std::move(token)));
+        }
+
+        token = tokenizer(strView);
+      }
+    }
+  }
+
+  // Now merge the dictionaries of the blocks in order, so that each token gets
+  // the label it would get if the strings were processed serially.
+  std::vector<std::vector<size_t>> blockLabels(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    blockLabels[b].resize(blockTokens[b].size());
+    for (size_t j = 0; j < blockTokens[b].size(); ++j)
+    {
+      TokenType& token = blockTokens[b][j];
+      if (dictionary.HasToken(token))
+        blockLabels[b][j] = dictionary.Value(token);
+      else
+        blockLabels[b][j] = dictionary.AddToken(std::move(token));
+    }
+  }
+
+  // Finally, replace the block labels with the labels of the dictionary.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t end = (b + 1) * input.size() / numBlocks;
+    for (size_t i = b * input.size() / numBlocks; i < end; ++i)
+    {
+      // The block labels are assigned sequentially starting from one.
+      for (size_t j = 0; j < labels[i].size(); ++j)
+        labels[i][j] = blockLabels[b][labels[i][j] - 1];
+    }
+  }
+
+  size_t maxNumTokens = 0;
+  for (size_t i = 0; i < labels.size(); ++i)
+    maxNumTokens = std::max(maxNumTokens, labels[i].size());
+
+  return maxNumTokens;
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType>
+size_t StringEncoding<EncodingPolicyType, DictionaryType>::ExtractLabels(
+    const std::vector<std::string>& input,
+    const TokenizerType& tokenizer,
+    const PolicyType& policy,
+    std::vector<std::vector<size_t>>& labels,
+    typename std::enable_if<StringEncodingPolicyTraits<
+        PolicyType>::hashesTokens>::type*)
+{
+  labels.clear();
+  labels.resize(input.size());
+
+  // No dictionary is needed, so each string can be labeled independently.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) input.size(); ++i)
+  {
+    boost::string_view strView(input[i]);
+    auto token = tokenizer(strView);
+
+    while (!tokenizer.IsTokenEmpty(token))
+    {
+      labels[i].push_back(policy.Label(token));
+      token = tokenizer(strView);
+    }
+  }
+
+  size_t maxNumTokens = 0;
+  for (size_t i = 0; i < labels.size(); ++i)
+    maxNumTokens = std::max(maxNumTokens, labels[i].size());
+
+  return maxNumTokens;
+}
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename MatType, typename TokenizerType, typename PolicyType>
 void StringEncoding<EncodingPolicyType, DictionaryType>::
@@ -105,55 +325,83 @@ EncodeHelper(const std::vector<std::string>& input,
              const TokenizerType& tokenizer,
              PolicyType& policy)
 {
-  size_t numColumns = 0;
+  std::vector<std::vector<size_t>> labels;
+  const size_t numColumns = ExtractLabels(input, tokenizer, policy, labels);
 
+  // The statistics of the policy (if any) are computed serially.
   policy.Reset();
+  for (size_t i = 0; i < labels.size(); ++i)
+    for (size_t j = 0; j < labels[i].size(); ++j)
+      policy.PreprocessToken(i, j, labels[i][j]);
 
-  // The first pass adds the extracted tokens to the dictionary.
-  for (size_t i = 0; i < input.size(); ++i)
+  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
+
+  // Each string is written to its own column (or row), so the strings can be
+  // encoded in parallel.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) labels.size(); ++i)
   {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
+    for (size_t j = 0; j < labels[i].size(); ++j)
+      policy.Encode(output, labels[i][j], i, j);
+  }
+}
 
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename eT, typename TokenizerType, typename PolicyType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::
+EncodeHelper(const std::vector<std::string>& input,
+             arma::SpMat<eT>& output,
+             const TokenizerType& tokenizer,
+             PolicyType& policy)
+{
+  std::vector<std::vector<size_t>> labels;
+  const size_t numColumns = ExtractLabels(input, tokenizer, policy, labels);
 
-    size_t numTokens = 0;
+  policy.Reset();
+  for (size_t i = 0; i < labels.size(); ++i)
+    for (size_t j = 0; j < labels[i].size(); ++j)
+      policy.PreprocessToken(i, j, labels[i][j]);
 
-    while (!tokenizer.IsTokenEmpty(token))
-    {
-      if (!dictionary.HasToken(token))
-        dictionary.AddToken(std::move(token));
+  // An empty sparse matrix is cheap to initialize; this only sets the size of
+  // the output.
+  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
+  const size_t numRows = output.n_rows;
 
-      policy.PreprocessToken(i, numTokens, dictionary.Value(token));
+  std::vector<std::vector<arma::uword>> rowIndices(input.size());
+  std::vector<std::vector<eT>> values(input.size());
+  #pragma omp parallel
+  {
+    details::SparseEncodingColumn<eT> column(numRows, input.size());
 
-      token = tokenizer(strView);
-      numTokens++;
-    }
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) labels.size(); ++i)
+    {
+      for (size_t j = 0; j < labels[i].size(); ++j)
+        policy.Encode(column, labels[i][j], i, j);
 
-    numColumns = std::max(numColumns, numTokens);
+      column.Extract(rowIndices[i], values[i]);
+      std::vector<size_t>().swap(labels[i]);
+    }
   }
 
-  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
-
-  // The second pass writes the encoded values to the output.
+  arma::Col<arma::uword> colPtrs(input.size() + 1);
+  colPtrs[0] = 0;
   for (size_t i = 0; i < input.size(); ++i)
-  {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
-    size_t numTokens = 0;
+    colPtrs[i + 1] = colPtrs[i] + rowIndices[i].size();
 
-    while (!tokenizer.IsTokenEmpty(token))
-    {
-      policy.Encode(output, dictionary.Value(token), i, numTokens);
-      token = tokenizer(strView);
-      numTokens++;
-    }
+  arma::Col<arma::uword> rowIndicesCol(colPtrs[input.size()]);
+  arma::Col<eT> valuesCol(colPtrs[input.size()]);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) input.size(); ++i)
+  {
+    std::copy(rowIndices[i].begin(), rowIndices[i].end(),
+        rowIndicesCol.begin() + colPtrs[i]);
+    std::copy(values[i].begin(), values[i].end(),
+        valuesCol.begin() + colPtrs[i]);
   }
+
+  output = arma::SpMat<eT>(rowIndicesCol, colPtrs, valuesCol, numRows,
+      input.size());
 }
 
 template<typename EncodingPolicyType, typename DictionaryType>
@@ -166,33 +414,20 @@ EncodeHelper(const std::vector<std::string>& input,
              typename std::enable_if<StringEncodingPolicyTraits<
                  PolicyType>::onePassEncoding>::type*)
 {
-  policy.Reset();
+  std::vector<std::vector<size_t>> labels;
+  ExtractLabels(input, tokenizer, policy, labels);
 
-  // The loop below extracts the tokens and writes the encoded values
-  // at once.
-  for (size_t i = 0; i < input.size(); ++i)
-  {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
-
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
+  policy.Reset();
 
-    output.emplace_back();
+  output.clear();
+  output.resize(input.size());
 
-    while (!tokenizer.IsTokenEmpty(token))
-    {
-      if (dictionary.HasToken(token))
-        policy.Encode(output[i], dictionary.Value(token));
-      else
-        policy.Encode(output[i], dictionary.AddToken(std::move(token)));
-
-      token = tokenizer(strView);
-    }
+  // The loop below writes the encoded values of each string at once.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) labels.size(); ++i)
+  {
+    for (size_t j = 0; j < labels[i].size(); ++j)
+      policy.Encode(output[i], labels[i][j]);
   }
 }
 
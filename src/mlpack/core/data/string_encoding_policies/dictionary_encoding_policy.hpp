@@ -133,6 +133,12 @@ struct StringEncodingPolicyTraits<DictionaryEncodingPolicy>
    * any information about other tokens as well as the total tokens count.
    */
   static const bool onePassEncoding = true;
+
+  /**
+   * Indicates if the policy labels the tokens itself (by hashing them), so
+   * that no dictionary is built.
+   */
+  static const bool hashesTokens = false;
 };
 
 /**
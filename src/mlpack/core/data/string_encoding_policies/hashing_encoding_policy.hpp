@@ -0,0 +1,245 @@
+/**
+ * @file core/data/string_encoding_policies/hashing_encoding_policy.hpp
+ *
+ * Definition of the HashingEncodingPolicy class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STRING_ENCODING_POLICIES_HASHING_ENCODING_POLICY_HPP
+#define MLPACK_CORE_DATA_STRING_ENCODING_POLICIES_HASHING_ENCODING_POLICY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
+#include <mlpack/core/data/string_encoding.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Definition of the HashingEncodingPolicy class.
+ *
+ * HashingEncodingPolicy is used as a helper class for StringEncoding. It
+ * implements the hashing trick: like the bag of words encoding, each dataset
+ * item is mapped to a vector of token counts, but the coordinate of a token is
+ * given by a hash of the token modulo the number of features, so no dictionary
+ * is built (and the dictionary of the StringEncoding object stays empty).
+ * Different tokens may share a coordinate; the number of features controls how
+ * often that happens.  The hash function is FNV-1a for string tokens, so the
+ * coordinates do not depend on the platform.
+ *
+ * The output has as many rows as features, so for large numbers of features
+ * the output should be an arma::sp_mat.
+ */
+class HashingEncodingPolicy
+{
+ public:
+  /**
+   * Construct the policy with the given number of features.
+   *
+   * @param numFeatures Number of features (coordinates) of the output.
+   */
+  HashingEncodingPolicy(const size_t numFeatures = 1 << 20) :
+      numFeatures(numFeatures)
+  {
+    if (numFeatures == 0)
+    {
+      throw std::invalid_argument("HashingEncodingPolicy: the number of "
+          "features must be positive");
+    }
+  }
+
+  /**
+   * Clear the necessary internal variables.
+   */
+  static void Reset()
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The function initializes the output matrix. The encoder writes data
+   * in the column-major order.
+   *
+   * @tparam MatType The output matrix type.
+   *
+   * @param output Output matrix to store the encoded results (sp_mat or mat).
+   * @param datasetSize The number of strings in the input dataset.
+   * @param * (maxNumTokens) The maximum number of tokens in the strings of the
+   *                     input dataset (not used).
+   * @param * (dictionarySize) The size of the dictionary (not used).
+   */
+  template<typename MatType>
+  void InitMatrix(MatType& output,
+                  const size_t datasetSize,
+                  const size_t /* maxNumTokens */,
+                  const size_t /* dictionarySize */) const
+  {
+    output.zeros(numFeatures, datasetSize);
+  }
+
+  /**
+   * The function initializes the output matrix. The encoder writes data
+   * in the row-major order.
+   *
+   * Overloaded function to save the result in vector<vector<ElemType>>.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param output Output matrix to store the encoded results.
+   * @param datasetSize The number of strings in the input dataset.
+   * @param * (maxNumTokens) The maximum number of tokens in the strings of the
+   *                     input dataset (not used).
+   * @param * (dictionarySize) The size of the dictionary (not used).
+   */
+  template<typename ElemType>
+  void InitMatrix(std::vector<std::vector<ElemType>>& output,
+                  const size_t datasetSize,
+                  const size_t /* maxNumTokens */,
+                  const size_t /* dictionarySize */) const
+  {
+    output.resize(datasetSize, std::vector<ElemType>(numFeatures));
+  }
+
+  /**
+   * The function writes the encoded token to the output. The encoder writes
+   * data in the column-major order.
+   *
+   * @tparam MatType The output matrix type.
+   *
+   * @param output Output matrix to store the encoded results (sp_mat or mat).
+   * @param value The encoded token.
+   * @param line The line number at which the encoding is performed.
+   * @param * (index) The token index in the line.
+   */
+  template<typename MatType>
+  static void Encode(MatType& output,
+                     const size_t value,
+                     const size_t line,
+                     const size_t /* index */)
+  {
+    // The labels are assigned starting from one.
+    output(value - 1, line) += 1;
+  }
+
+  /**
+   * The function writes the encoded token to the output. The encoder writes
+   * data in the row-major order.
+   *
+   * Overloaded function to accept vector<vector<ElemType>> as the output
+   * type.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param output Output matrix to store the encoded results.
+   * @param value The encoded token.
+   * @param line The line number at which the encoding is performed.
+   * @param * (index) The token index in the line.
+   */
+  template<typename ElemType>
+  static void Encode(std::vector<std::vector<ElemType>>& output,
+                     const size_t value,
+                     const size_t line,
+                     const size_t /* index */)
+  {
+    // The labels are assigned starting from one.
+    output[line][value - 1] += 1;
+  }
+
+  /**
+   * The function is not used by the hashing encoding policy.
+   *
+   * @param * (line) The line number at which the encoding is performed.
+   * @param * (index) The token sequence number in the line.
+   * @param * (value) The encoded token.
+   */
+  static void PreprocessToken(const size_t /* line */,
+                              const size_t /* index */,
+                              const size_t /* value */)
+  { }
+
+  /**
+   * Return the label of the given token, which is in [1, NumFeatures()].
+   *
+   * @param token The token to label.
+   */
+  template<typename TokenType>
+  size_t Label(const TokenType& token) const
+  {
+    return (size_t) (Hash(token) % numFeatures) + 1;
+  }
+
+  //! Get the number of features.
+  size_t NumFeatures() const { return numFeatures; }
+  //! Modify the number of features.
+  size_t& NumFeatures() { return numFeatures; }
+
+  /**
+   * Serialize the class to the given archive.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(numFeatures));
+  }
+
+ private:
+  //! Compute the 64-bit FNV-1a hash of the given string token.
+  static uint64_t Hash(const boost::string_view token)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : token)
+    {
+      hash ^= (unsigned char) c;
+      hash *= 1099511628211ULL;
+    }
+
+    return hash;
+  }
+
+  //! Compute the hash of any other (integral) token, which is its value.
+  template<typename TokenType>
+  static uint64_t Hash(const TokenType& token)
+  {
+    return (uint64_t) token;
+  }
+
+  //! The number of features.
+  size_t numFeatures;
+};
+
+/**
+ * The specialization provides some information about the hashing encoding
+ * policy.
+ */
+template<>
+struct StringEncodingPolicyTraits<HashingEncodingPolicy>
+{
+  /**
+   * Indicates if the policy is able to encode the token at once without
+   * any information about other tokens as well as the total tokens count.
+   */
+  static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy labels the tokens itself (by hashing them), so
+   * that no dictionary is built.
+   */
+  static const bool hashesTokens = true;
+};
+
+/**
+ * A convenient alias for the StringEncoding class with HashingEncodingPolicy.
+ * The dictionary is not used.
+ *
+ * @tparam TokenType Type of the tokens.
+ */
+template<typename TokenType>
+using HashingEncoding = StringEncoding<HashingEncodingPolicy,
+                                       StringEncodingDictionary<TokenType>>;
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -31,6 +31,12 @@ struct StringEncodingPolicyTraits
    * any information about other tokens as well as the total tokens count.
    */
   static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy labels the tokens itself (by hashing them), so
+   * that no dictionary is built.
+   */
+  static const bool hashesTokens = false;
 };
 
 } // namespace data
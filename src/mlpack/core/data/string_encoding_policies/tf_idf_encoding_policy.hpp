@@ -150,13 +150,15 @@ class TfIdfEncodingPolicy
               const size_t line,
               const size_t /* index */)
   {
+    // The statistics are only read here, so that the lines can be encoded in
+    // parallel.
     const typename MatType::elem_type tf =
         TermFrequency<typename MatType::elem_type>(
-            tokensFrequences[line][value], linesSizes[line]);
+            tokensFrequences[line].at(value), linesSizes[line]);
 
     const typename MatType::elem_type idf =
         InverseDocumentFrequency<typename MatType::elem_type>(
-            output.n_cols, numContainingStrings[value]);
+            output.n_cols, numContainingStrings.at(value));
 
     output(value - 1, line) =  tf * idf;
   }
@@ -183,10 +185,10 @@ class TfIdfEncodingPolicy
               const size_t /* index */)
   {
     const ElemType tf = TermFrequency<ElemType>(
-        tokensFrequences[line][value], linesSizes[line]);
+        tokensFrequences[line].at(value), linesSizes[line]);
 
     const ElemType idf = InverseDocumentFrequency<ElemType>(
-        output.size(), numContainingStrings[value]);
+        output.size(), numContainingStrings.at(value));
 
     output[line][value - 1] =  tf * idf;
   }
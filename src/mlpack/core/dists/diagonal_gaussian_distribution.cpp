@@ -41,9 +41,8 @@ double DiagonalGaussianDistribution::LogProbability(
     const arma::vec& observation) const
 {
   const size_t k = observation.n_elem;
-  const arma::vec diff = observation - mean;
-  const arma::vec logExponent = diff.t() * arma::diagmat(invCov) * diff;
-  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * logExponent(0);
+  return -0.5 * k * log2pi - 0.5 * logDetCov -
+      0.5 * arma::accu(arma::square(observation - mean) % invCov);
 }
 
 void DiagonalGaussianDistribution::LogProbability(
@@ -51,16 +50,19 @@ void DiagonalGaussianDistribution::LogProbability(
     arma::vec& logProbabilities) const
 {
   const size_t k = observations.n_rows;
-
-  // Column i of 'diffs' is the difference between observations.col(i) and
-  // the mean.
-  arma::mat diffs = observations.each_col() - mean;
+  const double logNormalizer = -0.5 * k * log2pi - 0.5 * logDetCov;
 
   // Calculates log of exponent equation in multivariate Gaussian
-  // distribution. We use only diagonal part for faster computation.
-  arma::vec logExponents = -0.5 * arma::trans(diffs % diffs) * invCov;
-
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  // distribution. We use only diagonal part for faster computation.  The
+  // expression of each observation is evaluated without temporaries, so no
+  // memory is allocated beyond the output.
+  logProbabilities.set_size(observations.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) observations.n_cols; ++i)
+  {
+    logProbabilities[i] = logNormalizer - 0.5 *
+        arma::accu(arma::square(observations.col(i) - mean) % invCov);
+  }
 }
 
 arma::vec DiagonalGaussianDistribution::Random() const
@@ -15,6 +15,47 @@
 using namespace mlpack;
 using namespace mlpack::distribution;
 
+/**
+ * Return the log probability of each of the given observations.  The logs of
+ * the probabilities are taken once per call, and the log probability of each
+ * observation is a sum of table lookups.
+ */
+void DiscreteDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  // Ensure the observations have the same dimension with the probabilities.
+  if (x.n_rows != probabilities.size())
+  {
+    Log::Fatal << "DiscreteDistribution::LogProbability(): observations have "
+        << "incorrect dimension " << x.n_rows << " but should have dimension "
+        << probabilities.size() << "!" << std::endl;
+  }
+
+  std::vector<arma::vec> logProbs(probabilities.size());
+  for (size_t d = 0; d < probabilities.size(); ++d)
+    logProbs[d] = arma::log(probabilities[d]);
+
+  logProbabilities.zeros(x.n_cols);
+  for (size_t i = 0; i < x.n_cols; ++i)
+  {
+    for (size_t d = 0; d < x.n_rows; ++d)
+    {
+      // Adding 0.5 helps ensure that we cast the floating point to a size_t
+      // correctly.
+      const size_t obs = size_t(x(d, i) + 0.5);
+
+      // Ensure that the observation is within the bounds.
+      if (obs >= logProbs[d].n_elem)
+      {
+        Log::Fatal << "DiscreteDistribution::LogProbability(): received "
+            << "observation " << obs << "; observation must be in [0, "
+            << logProbs[d].n_elem << "] for this distribution." << std::endl;
+      }
+      logProbabilities[i] += logProbs[d][obs];
+    }
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -165,7 +165,6 @@ class DiscreteDistribution
    */
   double LogProbability(const arma::vec& observation) const
   {
-    // TODO: consider storing log probabilities instead?
     return log(Probability(observation));
   }
 
@@ -178,9 +177,8 @@ class DiscreteDistribution
    */
   void Probability(const arma::mat& x, arma::vec& probabilities) const
   {
-    probabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-      probabilities(i) = Probability(x.unsafe_col(i));
+    LogProbability(x, probabilities);
+    probabilities = arma::exp(probabilities);
   }
 
   /**
@@ -191,12 +189,7 @@ class DiscreteDistribution
    * @param logProbabilities Output log-probabilities for each input
    *   observation.
    */
-  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
-  {
-    logProbabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; ++i)
-      logProbabilities(i) = log(Probability(x.unsafe_col(i)));
-  }
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
    * Return a randomly generated observation (one-dimensional vector; one
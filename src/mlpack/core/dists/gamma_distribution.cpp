@@ -163,28 +163,9 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
 void GammaDistribution::Probability(const arma::mat& observations,
                                     arma::vec& probabilities) const
 {
-  size_t numObs = observations.n_cols;
-
-  // Set all equal to 1 (multiplication neutral).
-  probabilities.ones(numObs);
-
-  // Compute denominator only once for each dimension.
-  arma::vec denominators(alpha.n_elem);
-  for (size_t d = 0; d < alpha.n_elem; ++d)
-    denominators(d) = std::tgamma(alpha(d)) * std::pow(beta(d), alpha(d));
-
-  // Compute probability of each observation.
-  for (size_t i = 0; i < numObs; ++i)
-  {
-    for (size_t d = 0; d < observations.n_rows; ++d)
-    {
-      // Compute probability using Multiplication Law.
-      double factor = std::exp(-observations(d, i) / beta(d));
-      double numerator = std::pow(observations(d, i), alpha(d) - 1);
-
-      probabilities(i) *= factor * numerator / denominators(d);
-    }
-  }
+  // Work in log space, so that large values of alpha do not overflow.
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
 }
 
 // Returns the probability of one observation (x) for one of the Gamma's
@@ -199,28 +180,28 @@ double GammaDistribution::Probability(double x, size_t dim) const
 void GammaDistribution::LogProbability(const arma::mat& observations,
                                        arma::vec& logProbabilities) const
 {
-  size_t numObs = observations.n_cols;
-
-  // Set all equal to 0 (addition neutral).
-  logProbabilities.zeros(numObs);
-
-  // Compute denominator only once for each dimension.
-  arma::vec denominators(alpha.n_elem);
+  // The log of the denominator of each dimension, log(Gamma(alpha) *
+  // beta^alpha), is summed once, since the dimensions are independent.
+  double logDenominator = 0.0;
   for (size_t d = 0; d < alpha.n_elem; ++d)
-    denominators(d) = std::tgamma(alpha(d)) * std::pow(beta(d), alpha(d));
+    logDenominator += std::lgamma(alpha(d)) + alpha(d) * std::log(beta(d));
 
-  // Compute probability of each observation.
-  for (size_t i = 0; i < numObs; ++i)
+  // Compute the log probability of each observation with the Logarithm
+  // addition property.  (When alpha is 1, x^(alpha - 1) is 1 even for x = 0.)
+  logProbabilities.set_size(observations.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) observations.n_cols; ++i)
   {
+    double logProbability = -logDenominator;
     for (size_t d = 0; d < observations.n_rows; ++d)
     {
-      // Compute probability using Multiplication Law and Logarithm addition
-      // property.
-      double factor = std::exp(-observations(d, i) / beta(d));
-      double numerator = std::pow(observations(d, i), alpha(d) - 1);
-
-      logProbabilities(i) += std::log(numerator * factor / denominators(d));
+      const double x = observations(d, i);
+      logProbability -= x / beta(d);
+      if (alpha(d) != 1.0)
+        logProbability += (alpha(d) - 1) * std::log(x);
     }
+
+    logProbabilities[i] = logProbability;
   }
 }
 
@@ -241,7 +222,7 @@ arma::vec GammaDistribution::Random() const
   {
     std::gamma_distribution<double> dist(alpha(d), beta(d));
     // Use the mlpack random object.
-    randVec(d) = dist(mlpack::math::randGen);
+    randVec(d) = dist(mlpack::math::RandGen());
   }
 
   return randVec;
@@ -12,6 +12,7 @@
  */
 #include "gaussian_distribution.hpp"
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
+#include <mlpack/core/math/ccov.hpp>
 
 using namespace mlpack;
 using namespace mlpack::distribution;
@@ -72,8 +73,31 @@ double GaussianDistribution::LogProbability(const arma::vec& observation) const
 {
   const size_t k = observation.n_elem;
   const arma::vec diff = mean - observation;
-  const arma::vec v = (diff.t() * invCov * diff);
-  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
+  const double v = arma::dot(diff, invCov * diff);
+  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v;
+}
+
+void GaussianDistribution::Mahalanobis(const arma::mat& x,
+                                       arma::vec& distances) const
+{
+  distances.set_size(x.n_cols);
+
+  // With cov = L L^T, (x - mean)^T cov^-1 (x - mean) = ||L^-1 (x - mean)||^2,
+  // and L^-1 (x - mean) is a triangular solve.  Each block of points is
+  // centered and solved on its own, so that only one block of differences is
+  // held at once per thread.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (x.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) x.n_cols);
+
+    const arma::mat diffs = x.cols(begin, end - 1).each_col() - mean;
+    const arma::mat z = arma::solve(arma::trimatl(covLower), diffs);
+    distances.subvec(begin, end - 1) = arma::sum(arma::square(z), 0).t();
+  }
 }
 
 arma::vec GaussianDistribution::Random() const
@@ -88,12 +112,7 @@ arma::vec GaussianDistribution::Random() const
  */
 void GaussianDistribution::Train(const arma::mat& observations)
 {
-  if (observations.n_cols > 0)
-  {
-    mean.zeros(observations.n_rows);
-    covariance.zeros(observations.n_rows, observations.n_rows);
-  }
-  else // This will end up just being empty.
+  if (observations.n_cols == 0) // This will end up just being empty.
   {
     // TODO(stephentu): why do we allow this case? why not throw an error?
     mean.zeros(0);
@@ -102,22 +121,15 @@ void GaussianDistribution::Train(const arma::mat& observations)
   }
 
   // Calculate the mean.
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    mean += observations.col(i);
-
-  // Normalize the mean.
-  mean /= observations.n_cols;
-
-  // Now calculate the covariance.
-  for (size_t i = 0; i < observations.n_cols; ++i)
-  {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += obsNoMean * trans(obsNoMean);
-  }
-
-  // Finish estimating the covariance by normalizing, with the (1 / (n - 1)) so
-  // that it is the unbiased estimator.
-  covariance /= (observations.n_cols - 1);
+  mean = arma::mean(observations, 1);
+
+  // Now calculate the covariance, with the (1 / (n - 1)) so that it is the
+  // unbiased estimator.  ColumnCovariance() treats a single column as a row,
+  // so that case is handled separately.
+  if (observations.n_cols > 1)
+    covariance = math::ColumnCovariance(observations);
+  else
+    covariance.zeros(observations.n_rows, observations.n_rows);
 
   // Ensure that the covariance is positive definite.
   gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
@@ -169,12 +181,11 @@ void GaussianDistribution::Train(const arma::mat& observations,
   if (sumProb > 0)
     mean /= sumProb;
 
-  // Now find the covariance.
-  for (size_t i = 0; i < observations.n_cols; ++i)
-  {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += probabilities[i] * (obsNoMean * trans(obsNoMean));
-  }
+  // Now find the covariance, as one product of the centered observations,
+  // each weighted by the square root of its probability.
+  arma::mat weighted = observations.each_col() - mean;
+  weighted.each_row() %= arma::sqrt(probabilities.t());
+  covariance = weighted * weighted.t();
 
   // This is probably biased, but I don't know how to unbias it.
   if (sumProb > 0)
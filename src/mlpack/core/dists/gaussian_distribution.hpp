@@ -107,16 +107,23 @@ class GaussianDistribution
    */
   void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
   {
-    // Column i of 'diffs' is the difference between x.col(i) and the mean.
-    arma::mat diffs = x;
-    diffs.each_col() -= mean;
-
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-        sum(diffs % (-0.5 * invCov * diffs), 0).t();
+    Mahalanobis(x, logProbabilities);
+    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov -
+        0.5 * logProbabilities;
   }
 
+  /**
+   * Compute the squared Mahalanobis distance of each data point (column) in
+   * the given matrix to the mean, (x - mean)^T cov^-1 (x - mean).  This uses
+   * the cached Cholesky factor of the covariance, with triangular solves over
+   * blocks of points (in parallel), instead of a product with the inverse
+   * covariance.
+   *
+   * @param x List of observations.
+   * @param distances Output squared distance for each input observation.
+   */
+  void Mahalanobis(const arma::mat& x, arma::vec& distances) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
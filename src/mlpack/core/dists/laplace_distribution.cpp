@@ -24,7 +24,29 @@ double LaplaceDistribution::LogProbability(const arma::vec& observation) const
 {
   // Evaluate the PDF of the Laplace distribution to determine
   // the log probability.
-  return -log(2. * scale) - arma::norm(observation - mean, 2) / scale;
+  return -log(2. * scale) - std::sqrt(arma::accu(arma::square(observation -
+      mean))) / scale;
+}
+
+/**
+ * Evaluate log probability density function of given observations.
+ *
+ * @param x List of observations.
+ * @param logProbabilities Output log probabilities for each input observation.
+ */
+void LaplaceDistribution::LogProbability(const arma::mat& x,
+                                         arma::vec& logProbabilities) const
+{
+  // The distance of each observation is evaluated without temporaries, so no
+  // memory is allocated beyond the output.
+  const double logNormalizer = -log(2. * scale);
+  logProbabilities.set_size(x.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+  {
+    logProbabilities[i] = logNormalizer -
+        std::sqrt(arma::accu(arma::square(x.col(i) - mean))) / scale;
+  }
 }
 
 /**
@@ -36,11 +58,8 @@ double LaplaceDistribution::LogProbability(const arma::vec& observation) const
 void LaplaceDistribution::Probability(const arma::mat& x,
                                       arma::vec& probabilities) const
 {
-  probabilities.set_size(x.n_cols);
-  for (size_t i = 0; i < x.n_cols; ++i)
-  {
-    probabilities(i) = Probability(x.unsafe_col(i));
-  }
+  LogProbability(x, probabilities);
+  probabilities = arma::exp(probabilities);
 }
 
 /**
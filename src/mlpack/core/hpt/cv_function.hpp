@@ -13,6 +13,7 @@
 #define MLPACK_CORE_HPT_CV_FUNCTION_HPP
 
 #include <mlpack/core.hpp>
+#include <map>
 
 namespace mlpack {
 namespace hpt {
@@ -66,7 +67,10 @@ class CVFunction
              const BoundArgs&... args);
 
   /**
-   * Run cross-validation with the bound and passed parameters.
+   * Run cross-validation with the bound and passed parameters.  The result for
+   * each distinct set of parameters is remembered, so cross-validation is run
+   * only once for it (optimizers often evaluate the same parameters again, as
+   * in the calculation of the gradient).
    *
    * @param parameters Arguments (rather than the bound arguments) that should
    *     be passed into the Evaluate method of the CVType object.
@@ -86,6 +90,12 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  //! Get the best objective so far.
+  double BestObjective() const { return bestObjective; }
+
+  //! Get the number of distinct sets of parameters evaluated so far.
+  size_t NumEvaluations() const { return evaluations.size(); }
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -125,6 +135,9 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! The results of cross-validation for each evaluated set of parameters.
+  std::map<std::vector<double>, double> evaluations;
+
   /**
    * Collect all arguments and run cross-validation.
    */
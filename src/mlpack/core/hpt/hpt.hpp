@@ -67,6 +67,18 @@ namespace hpt {
  *     Fixed(useCholesky), lambda1Set, lambda2Set);
  * @endcode
  *
+ * With GridSearch and a cross-validation strategy that can be copied with a
+ * subset of its data (like SimpleCV and KFoldCV), the candidates are evaluated
+ * in parallel with OpenMP, each thread with its own copy of the
+ * cross-validation object, rather than one at a time by GridSearch itself.  The
+ * best model is then trained again with the best hyper-parameters.  Setting
+ * ReductionFactor() to some eta > 1 turns on successive halving: all the
+ * candidates are first evaluated on a small fraction of the data, and only the
+ * best 1 / eta of them are kept for the next round, which uses eta times more
+ * data, until the last round uses all the data.  This is much faster for large
+ * grids, at the risk of dropping candidates that only do well with a lot of
+ * data.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
@@ -151,6 +163,44 @@ class HyperParameterTuner
    */
   double& MinDelta() { return minDelta; }
 
+  /**
+   * Get the reduction factor eta of successive halving in grid search.  Each
+   * round keeps the best 1 / eta of the candidates, and evaluates them on eta
+   * times more data.  Successive halving is not used if it is less than 2.
+   *
+   * The default value is 0.
+   */
+  size_t ReductionFactor() const { return reductionFactor; }
+
+  /**
+   * Modify the reduction factor eta of successive halving in grid search.
+   * Each round keeps the best 1 / eta of the candidates, and evaluates them on
+   * eta times more data.  Successive halving is not used if it is less than 2.
+   *
+   * The default value is 0.
+   */
+  size_t& ReductionFactor() { return reductionFactor; }
+
+  /**
+   * Get whether the training for each candidate starts from the model of the
+   * previous candidate, when the cross-validation strategy has a WarmStart()
+   * option (like SimpleCV and KFoldCV) and MLAlgorithm supports it (like
+   * LogisticRegression and SoftmaxRegression).  This makes sweeps over a
+   * regularization parameter much faster.  In a parallel grid search, each
+   * thread evaluates a contiguous block of the candidates.
+   *
+   * The default value is false.
+   */
+  bool WarmStart() const { return warmStart; }
+
+  /**
+   * Modify whether the training for each candidate starts from the model of
+   * the previous candidate (see WarmStart() const).
+   *
+   * The default value is false.
+   */
+  bool& WarmStart() { return warmStart; }
+
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
@@ -230,6 +280,20 @@ class HyperParameterTuner
    */
   double minDelta;
 
+  //! The reduction factor of successive halving in grid search.
+  size_t reductionFactor;
+
+  //! Whether to warm-start the training for each candidate.
+  bool warmStart;
+
+  /**
+   * Whether the grid search evaluates the candidates itself (in parallel),
+   * which needs copies of the cross-validation object with subsets of its data.
+   */
+  using ParallelGridSearch = std::integral_constant<bool,
+      std::is_same<OptimizerType, ens::GridSearch>::value &&
+      std::is_constructible<CVType, const CVType&, const double>::value>;
+
   /**
    * A type function to check whether the element I of the tuple type is a
    * PreFixedArg.
@@ -324,6 +388,52 @@ class HyperParameterTuner
       data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
       FixedArgs... fixedArgs);
 
+  /**
+   * Set whether the given cross-validation object warm-starts the training.
+   * This overload is called if it has a WarmStart() option.
+   */
+  template<typename CVT>
+  static auto SetWarmStart(CVT& cvObject, const bool enabled, int)
+      -> decltype(cvObject.WarmStart() = enabled, void())
+  { cvObject.WarmStart() = enabled; }
+
+  /**
+   * Do nothing, since the given cross-validation object has no WarmStart()
+   * option.
+   */
+  template<typename CVT>
+  static void SetWarmStart(CVT& /* cvObject */,
+                           const bool /* enabled */,
+                           long)
+  { }
+
+  /**
+   * Run the optimizer on the CVFunction with the given fixed arguments, store
+   * the best model, and return the best objective.
+   */
+  template<size_t TotalArgs, typename... FixedArgs>
+  inline double RunOptimizer(
+      arma::mat& bestParams,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      const std::vector<bool>& categoricalDimensions,
+      const arma::Row<size_t>& numCategories,
+      std::false_type /* parallelGridSearch */,
+      const FixedArgs&... fixedArgs);
+
+  /**
+   * Evaluate all the candidates of the grid in parallel, with successive
+   * halving if the reduction factor is at least 2, store the best model, and
+   * return the best objective.
+   */
+  template<size_t TotalArgs, typename... FixedArgs>
+  inline double RunOptimizer(
+      arma::mat& bestParams,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      const std::vector<bool>& categoricalDimensions,
+      const arma::Row<size_t>& numCategories,
+      std::true_type /* parallelGridSearch */,
+      const FixedArgs&... fixedArgs);
+
   /**
    * Gather all elements of vector in an argument list and use them to create a
    * tuple.
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_HPT_HPT_IMPL_HPP
 
 #include <mlpack/core.hpp>
+#include <exception>
 
 namespace mlpack {
 namespace hpt {
@@ -32,7 +33,8 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...), relativeDelta(0.01), minDelta(1e-10), reductionFactor(0),
+    warmStart(false) {}
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -102,13 +104,10 @@ void HyperParameterTuner<MLAlgorithm,
         mlpack::data::Datatype::categorical;
   }
 
-  CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
-      cvFunction(cv, datasetInfo, relativeDelta, minDelta, fixedArgs...);
-  bestObjective = Metric::NeedsMinimization ? optimizer.Optimize(cvFunction,
-      bestParams, categoricalDimensions, numCategories) :
-      -optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
-      numCategories);
-      bestModel = std::move(cvFunction.BestModel());
+  const double objective = RunOptimizer<totalArgs>(bestParams, datasetInfo,
+      categoricalDimensions, numCategories, ParallelGridSearch(),
+      fixedArgs...);
+  bestObjective = Metric::NeedsMinimization ? objective : -objective;
 }
 
 template<typename MLAlgorithm,
@@ -204,6 +203,222 @@ void HyperParameterTuner<MLAlgorithm,
   InitAndOptimize<I + 1>(args, bestParams, datasetInfo, fixedArgs...);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<size_t TotalArgs, typename... FixedArgs>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::RunOptimizer(
+    arma::mat& bestParams,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    std::false_type /* parallelGridSearch */,
+    const FixedArgs&... fixedArgs)
+{
+  SetWarmStart(cv, warmStart, 0);
+
+  CVFunction<CVType, MLAlgorithm, TotalArgs, FixedArgs...>
+      cvFunction(cv, datasetInfo, relativeDelta, minDelta, fixedArgs...);
+  const double objective = optimizer.Optimize(cvFunction, bestParams,
+      categoricalDimensions, numCategories);
+  bestModel = std::move(cvFunction.BestModel());
+
+  return objective;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<size_t TotalArgs, typename... FixedArgs>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::RunOptimizer(
+    arma::mat& bestParams,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    std::true_type /* parallelGridSearch */,
+    const FixedArgs&... fixedArgs)
+{
+  using CVFunctionType =
+      CVFunction<CVType, MLAlgorithm, TotalArgs, FixedArgs...>;
+
+  // The copies of the cross-validation object for the threads take the
+  // setting.
+  SetWarmStart(cv, warmStart, 0);
+
+  for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+  {
+    if (!categoricalDimensions[d])
+    {
+      std::ostringstream oss;
+      oss << "HyperParameterTuner::Optimize(): GridSearch needs a collection "
+          << "of values for each hyper-parameter, but the dimension " << d
+          << " is not categorical" << std::endl;
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  // Enumerate the candidates in the same order as GridSearch, with the first
+  // hyper-parameter changing the slowest.
+  size_t numCandidates = 1;
+  for (size_t d = 0; d < numCategories.n_elem; ++d)
+    numCandidates *= numCategories[d];
+
+  arma::mat candidates(numCategories.n_elem, numCandidates);
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    size_t index = c;
+    for (size_t d = numCategories.n_elem; d > 0; --d)
+    {
+      candidates(d - 1, c) = index % numCategories[d - 1];
+      index /= numCategories[d - 1];
+    }
+  }
+
+  // With successive halving, each round keeps the best 1 / reductionFactor of
+  // the candidates, until there are less than reductionFactor of them.
+  size_t numRounds = 0;
+  if (reductionFactor >= 2)
+  {
+    for (size_t n = numCandidates; n >= reductionFactor; n /= reductionFactor)
+      ++numRounds;
+  }
+
+  std::vector<size_t> remaining(numCandidates);
+  for (size_t c = 0; c < numCandidates; ++c)
+    remaining[c] = c;
+
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+
+  arma::vec objectives;
+  for (size_t round = 0; round <= numRounds; ++round)
+  {
+    // Each round uses reductionFactor times more data than the previous one,
+    // and the last one uses all the data.
+    const double subsetRatio = (round == numRounds) ? 1.0 :
+        std::pow((double) reductionFactor, (double) round - numRounds);
+    if (numRounds > 0)
+    {
+      Log::Info << "HyperParameterTuner::Optimize(): successive halving round "
+          << round + 1 << " of " << numRounds + 1 << ", with "
+          << remaining.size() << " candidates on " << 100.0 * subsetRatio
+          << "% of the data." << std::endl;
+    }
+
+    // Each thread makes its own copy of the cross-validation object for its
+    // first candidate.
+    std::vector<std::unique_ptr<CVType>> threadCVs(numThreads);
+    std::vector<std::unique_ptr<CVFunctionType>> cvFunctions(numThreads);
+
+    // Each candidate draws its random numbers from its own stream, whichever
+    // thread evaluates it.
+    const size_t firstStream = math::ReserveRandomStreams(remaining.size());
+
+    // Exceptions cannot leave the parallel region, so the first one is thrown
+    // after it.
+    std::exception_ptr exception;
+
+    objectives.set_size(remaining.size());
+    auto evaluate = [&](const size_t i)
+    {
+      try
+      {
+        #ifdef HAS_OPENMP
+        const size_t thread = omp_get_thread_num();
+        #else
+        const size_t thread = 0;
+        #endif
+        if (!cvFunctions[thread])
+        {
+          threadCVs[thread].reset(new CVType(cv, subsetRatio));
+          cvFunctions[thread].reset(new CVFunctionType(*threadCVs[thread],
+              datasetInfo, relativeDelta, minDelta, fixedArgs...));
+        }
+
+        math::RandGen() = math::RandomStream(firstStream + i);
+        objectives[i] = cvFunctions[thread]->Evaluate(
+            candidates.col(remaining[i]));
+      }
+      catch (...)
+      {
+        #pragma omp critical(HyperParameterTunerException)
+        {
+          if (!exception)
+            exception = std::current_exception();
+        }
+      }
+    };
+
+    // With warm starts, each thread takes a contiguous block of candidates, so
+    // that each model starts from one trained with similar hyper-parameters.
+    if (warmStart)
+    {
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) remaining.size(); ++i)
+        evaluate(i);
+    }
+    else
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) remaining.size(); ++i)
+        evaluate(i);
+    }
+
+    if (exception)
+      std::rethrow_exception(exception);
+
+    // Like GridSearch, never choose a candidate with a NaN objective.
+    objectives.replace(arma::datum::nan, arma::datum::inf);
+
+    if (round < numRounds)
+    {
+      // Keep the best candidates, in their original order.
+      const arma::uvec order = arma::stable_sort_index(objectives);
+      std::vector<size_t> kept(std::max((size_t) 1,
+          remaining.size() / reductionFactor));
+      for (size_t j = 0; j < kept.size(); ++j)
+        kept[j] = remaining[order[j]];
+      std::sort(kept.begin(), kept.end());
+      remaining.swap(kept);
+    }
+  }
+
+  // The first of the best candidates wins, as with GridSearch.  Its model is in
+  // the cross-validation object of some thread, so it is trained again.
+  bestParams = candidates.col(remaining[objectives.index_min()]);
+
+  SetWarmStart(cv, false, 0);
+  CVFunctionType cvFunction(cv, datasetInfo, relativeDelta, minDelta,
+      fixedArgs...);
+  const double objective = cvFunction.Evaluate(bestParams);
+  bestModel = std::move(cvFunction.BestModel());
+
+  return objective;
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          template<typename, typename, typename, typename, typename> class CV,
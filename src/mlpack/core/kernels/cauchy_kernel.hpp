@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -68,6 +69,24 @@ class CauchyKernel
         std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  /**
+   * Evaluate the Cauchy kernel between each point of a and each point of b, so
+   * that output(i, j) = K(a_i, b_j).  The squared distances are computed with
+   * one matrix product (see PairwiseSquaredDistances()).
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& output) const
+  {
+    PairwiseSquaredDistances(a, b, output);
+    output = 1.0 / (1.0 + output / (bandwidth * bandwidth));
+  }
+
   /**
    * Serialize the kernel.
    */
@@ -89,6 +108,10 @@ class KernelTraits<CauchyKernel>
  public:
   //! The Cauchy kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Cauchy kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The Cauchy kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
 };
 
 } // namespace kernel
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -41,6 +42,20 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Computes the cosine distance between each point of a and each point of b,
+   * so that output(i, j) = d(a_i, b_j).  The inner products are computed with
+   * one matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the cosine distances in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::mat& output);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
@@ -56,6 +71,9 @@ class KernelTraits<CosineDistance>
 
   //! The cosine kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+
+  //! The cosine kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
 };
 
 } // namespace kernel
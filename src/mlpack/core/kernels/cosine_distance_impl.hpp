@@ -32,6 +32,24 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+template<typename MatTypeA, typename MatTypeB>
+void CosineDistance::Evaluate(const MatTypeA& a,
+                              const MatTypeB& b,
+                              arma::mat& output)
+{
+  PairwiseInnerProducts(a, b, output);
+
+  // As above, the cosine similarity with a zero vector is 0.
+  auto inverse = [](const double norm)
+      { return (norm == 0.0) ? 0.0 : 1.0 / norm; };
+  arma::rowvec aInverseNorms = arma::sqrt(arma::sum(arma::square(a), 0));
+  arma::rowvec bInverseNorms = arma::sqrt(arma::sum(arma::square(b), 0));
+  aInverseNorms.transform(inverse);
+  bInverseNorms.transform(inverse);
+  output.each_col() %= aInverseNorms.t();
+  output.each_row() %= bInverseNorms;
+}
+
 } // namespace kernel
 } // namespace mlpack
 
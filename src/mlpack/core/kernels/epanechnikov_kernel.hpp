@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -51,6 +52,20 @@ class EpanechnikovKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
 
+  /**
+   * Evaluate the Epanechnikov kernel between each point of a and each point of
+   * b, so that output(i, j) = K(a_i, b_j).  The squared distances are computed
+   * with one matrix product (see PairwiseSquaredDistances()).
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& output) const;
+
   /**
    * Evaluate the Epanechnikov kernel given that the distance between the two
    * input points is known.
@@ -111,6 +126,8 @@ class KernelTraits<EpanechnikovKernel>
   static const bool IsNormalized = true;
   //! The Epanechnikov kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Epanechnikov kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
 };
 
 } // namespace kernel
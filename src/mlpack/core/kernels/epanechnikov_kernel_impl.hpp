@@ -29,6 +29,16 @@ inline double EpanechnikovKernel::Evaluate(const VecTypeA& a, const VecTypeB& b)
       * inverseBandwidthSquared);
 }
 
+template<typename MatTypeA, typename MatTypeB>
+inline void EpanechnikovKernel::Evaluate(const MatTypeA& a,
+                                         const MatTypeB& b,
+                                         arma::mat& output) const
+{
+  PairwiseSquaredDistances(a, b, output);
+  output = arma::clamp(1.0 - output * inverseBandwidthSquared, 0.0,
+      arma::datum::inf);
+}
+
 /**
  * Obtains the convolution integral [integral of K(||x-a||) K(||b-x||) dx]
  * for the two vectors.
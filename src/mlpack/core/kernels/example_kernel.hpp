@@ -72,6 +72,13 @@ namespace kernel {
  * generalization, mlpack methods expect all kernels to require state and hence
  * must store instantiated kernel functions; this is why a default constructor
  * is necessary.
+ *
+ * @note
+ * A kernel may also provide a batched `Evaluate(a, b, output)` function, which
+ * evaluates the kernel between each point of the set a and each point of the
+ * set b (for instance, from the inner products a^T b, with one matrix
+ * product).  It should then set `KernelTraits<>::HasBatchEvaluation` to true,
+ * so that methods like KernelMatrix() and brute-force FastMKS use it.
  */
 class ExampleKernel
 {
@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -68,6 +69,24 @@ class GaussianKernel
     return exp(gamma * metric::SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the Gaussian kernel between each point of a and each point of b,
+   * so that output(i, j) = K(a_i, b_j).  The squared distances are computed
+   * with one matrix product (see PairwiseSquaredDistances()).
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& output) const
+  {
+    PairwiseSquaredDistances(a, b, output);
+    output = arma::exp(gamma * output);
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -171,6 +190,8 @@ class KernelTraits<GaussianKernel>
   static const bool IsNormalized = true;
   //! The Gaussian kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Gaussian kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
 };
 
 } // namespace kernel
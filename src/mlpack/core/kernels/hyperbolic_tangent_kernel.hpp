@@ -13,6 +13,8 @@
 #define MLPACK_CORE_KERNELS_HYPERBOLIC_TANGENT_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -62,6 +64,24 @@ class HyperbolicTangentKernel
     return tanh(scale * arma::dot(a, b) + offset);
   }
 
+  /**
+   * Evaluate the hyperbolic tangent kernel between each point of a and each
+   * point of b, so that output(i, j) = K(a_i, b_j).  The inner products are
+   * computed with one matrix product.
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& output) const
+  {
+    PairwiseInnerProducts(a, b, output);
+    output = arma::tanh(scale * output + offset);
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
@@ -85,6 +105,19 @@ class HyperbolicTangentKernel
   double offset;
 };
 
+//! Kernel traits for the hyperbolic tangent kernel.
+template<>
+class KernelTraits<HyperbolicTangentKernel>
+{
+ public:
+  //! The hyperbolic tangent kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The hyperbolic tangent kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The hyperbolic tangent kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -0,0 +1,61 @@
+/**
+ * @file core/kernels/kernel_matrix.hpp
+ *
+ * Definition of KernelMatrix(), which computes the matrix of kernel
+ * evaluations between two sets of points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kernel_traits.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the kernel matrix between the points in the columns of a and b, so
+ * that kernelMatrix(i, j) = K(a_i, b_j).  The kernels with a batched
+ * Evaluate() function (see KernelTraits::HasBatchEvaluation), which compute it
+ * from the inner products a^T b or the squared distances between the points,
+ * with one (blocked, multithreaded) BLAS product, are evaluated with it.  Any
+ * other kernel is evaluated entry by entry, in parallel; each thread uses its
+ * own copy of the kernel.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernelMatrix Matrix to store the kernel evaluations in.
+ */
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& kernelMatrix);
+
+/**
+ * Compute the (symmetric) kernel matrix of the points in the columns of data,
+ * so that kernelMatrix(i, j) = K(x_i, x_j).  For kernels that are evaluated
+ * entry by entry, only the upper triangular part is evaluated.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points.
+ * @param kernelMatrix Matrix to store the kernel evaluations in.
+ */
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& data,
+                  arma::mat& kernelMatrix);
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file core/kernels/kernel_matrix_impl.hpp
+ *
+ * Implementation of KernelMatrix().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+//! Compute a kernel matrix entry by entry.
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& kernelMatrix,
+                  const std::false_type& /* hasBatchEvaluation */)
+{
+  kernelMatrix.set_size(a.n_cols, b.n_cols);
+
+  #pragma omp parallel
+  {
+    // Some kernels are not safe to evaluate from several threads at once.
+    KernelType threadKernel(kernel);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+    {
+      for (size_t i = 0; i < a.n_cols; ++i)
+      {
+        kernelMatrix(i, j) = threadKernel.Evaluate(a.unsafe_col(i),
+            b.unsafe_col(j));
+      }
+    }
+  }
+}
+
+//! Compute a kernel matrix with the batched Evaluate() of the kernel.
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& kernelMatrix,
+                  const std::true_type& /* hasBatchEvaluation */)
+{
+  kernel.Evaluate(a, b, kernelMatrix);
+}
+
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& kernelMatrix)
+{
+  KernelMatrix(kernel, a, b, kernelMatrix, std::integral_constant<bool,
+      KernelTraits<KernelType>::HasBatchEvaluation>());
+}
+
+//! Compute a symmetric kernel matrix entry by entry.
+template<typename KernelType>
+void SymmetricKernelMatrix(const KernelType& kernel,
+                           const arma::mat& data,
+                           arma::mat& kernelMatrix,
+                           const std::false_type& /* hasBatchEvaluation */)
+{
+  kernelMatrix.set_size(data.n_cols, data.n_cols);
+
+  // Only the upper triangular part needs to be evaluated.  The columns get
+  // longer towards the end, so they are scheduled dynamically.
+  #pragma omp parallel
+  {
+    KernelType threadKernel(kernel);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      for (size_t i = 0; i <= (size_t) j; ++i)
+      {
+        kernelMatrix(i, j) = threadKernel.Evaluate(data.unsafe_col(i),
+            data.unsafe_col(j));
+      }
+    }
+  }
+
+  kernelMatrix = arma::symmatu(kernelMatrix);
+}
+
+//! Compute a symmetric kernel matrix with the batched Evaluate() of the kernel.
+template<typename KernelType>
+void SymmetricKernelMatrix(const KernelType& kernel,
+                           const arma::mat& data,
+                           arma::mat& kernelMatrix,
+                           const std::true_type& /* hasBatchEvaluation */)
+{
+  kernel.Evaluate(data, data, kernelMatrix);
+
+  // Make the result exactly symmetric.
+  kernelMatrix = arma::symmatu(kernelMatrix);
+}
+
+template<typename KernelType>
+void KernelMatrix(const KernelType& kernel,
+                  const arma::mat& data,
+                  arma::mat& kernelMatrix)
+{
+  SymmetricKernelMatrix(kernel, data, kernelMatrix, std::integral_constant<
+      bool, KernelTraits<KernelType>::HasBatchEvaluation>());
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -36,6 +36,13 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel has a batched Evaluate(a, b, output) function,
+   * which evaluates the kernel between all the pairs of points of two sets at
+   * once.
+   */
+  static const bool HasBatchEvaluation = false;
 };
 
 } // namespace kernel
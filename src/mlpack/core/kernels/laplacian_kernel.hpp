@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_LAPLACIAN_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -64,6 +65,24 @@ class LaplacianKernel
     return exp(-metric::EuclideanDistance::Evaluate(a, b) / bandwidth);
   }
 
+  /**
+   * Evaluate the Laplacian kernel between each point of a and each point of b,
+   * so that output(i, j) = K(a_i, b_j).  The squared distances are computed
+   * with one matrix product (see PairwiseSquaredDistances()).
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& output) const
+  {
+    PairwiseSquaredDistances(a, b, output);
+    output = arma::exp(-arma::sqrt(output) / bandwidth);
+  }
+
   /**
    * Evaluation of the Laplacian kernel given the distance between two points.
    *
@@ -117,6 +136,8 @@ class KernelTraits<LaplacianKernel>
   static const bool IsNormalized = true;
   //! The Laplacian kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Laplacian kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
 };
 
 } // namespace kernel
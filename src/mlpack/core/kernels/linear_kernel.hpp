@@ -15,6 +15,8 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -55,11 +57,43 @@ class LinearKernel
     return arma::dot(a, b);
   }
 
+  /**
+   * Evaluate the linear kernel between each point of a and each point of b, so
+   * that output(i, j) = K(a_i, b_j).  The inner products are computed with one
+   * matrix product.
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::mat& output)
+  {
+    PairwiseInnerProducts(a, b, output);
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
 };
 
+//! Kernel traits for the linear kernel.
+template<>
+class KernelTraits<LinearKernel>
+{
+ public:
+  //! The linear kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The linear kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The linear kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
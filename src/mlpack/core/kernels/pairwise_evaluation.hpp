@@ -0,0 +1,69 @@
+/**
+ * @file core/kernels/pairwise_evaluation.hpp
+ *
+ * Helpers for the batched Evaluate() functions of the kernels, which compute
+ * the inner products and the squared distances between two sets of points with
+ * one matrix product.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_PAIRWISE_EVALUATION_HPP
+#define MLPACK_CORE_KERNELS_PAIRWISE_EVALUATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the inner products between the points in the columns of a and b, so
+ * that products(i, j) = a_i^T b_j.
+ *
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param products Matrix to store the inner products in.
+ */
+template<typename MatTypeA, typename MatTypeB>
+void PairwiseInnerProducts(const MatTypeA& a,
+                           const MatTypeB& b,
+                           arma::mat& products)
+{
+  products = a.t() * b;
+}
+
+/**
+ * Compute the squared Euclidean distances between the points in the columns of
+ * a and b, so that distances(i, j) = ||a_i - b_j||^2, from the inner products
+ * with ||a_i - b_j||^2 = ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j.  If a and b are
+ * the same object, the diagonal is exactly zero.
+ *
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param distances Matrix to store the squared distances in.
+ */
+template<typename MatTypeA, typename MatTypeB>
+void PairwiseSquaredDistances(const MatTypeA& a,
+                              const MatTypeB& b,
+                              arma::mat& distances)
+{
+  distances = -2.0 * (a.t() * b);
+  distances.each_col() += arma::sum(arma::square(a), 0).t();
+  distances.each_row() += arma::sum(arma::square(b), 0);
+
+  // Rounding can make the squared distances of (nearly) equal points slightly
+  // negative.
+  distances.transform([](const double d) { return std::max(d, 0.0); });
+
+  // The distances of the points to themselves are exactly zero, which matters
+  // for the kernels that take their square root.
+  if ((const void*) &a == (const void*) &b)
+    distances.diag().zeros();
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -12,6 +12,7 @@
 
 #include <boost/math/special_functions/gamma.hpp>
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -47,6 +48,26 @@ class SphericalKernel
         (metric::SquaredEuclideanDistance::Evaluate(a, b) <= bandwidthSquared) ?
         1.0 : 0.0;
   }
+
+  /**
+   * Evaluate the spherical kernel between each point of a and each point of b,
+   * so that output(i, j) = K(a_i, b_j).  The squared distances are computed
+   * with one matrix product (see PairwiseSquaredDistances()).
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& output) const
+  {
+    PairwiseSquaredDistances(a, b, output);
+    const double threshold = bandwidthSquared;
+    output.transform([threshold](const double d)
+        { return (d <= threshold) ? 1.0 : 0.0; });
+  }
   /**
    * Obtains the convolution integral [integral K(||x-a||)K(||b-x||)dx]
    * for the two vectors.
@@ -124,6 +145,8 @@ class KernelTraits<SphericalKernel>
   static const bool IsNormalized = true;
   //! The spherical kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The spherical kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
 };
 
 } // namespace kernel
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/kernels/pairwise_evaluation.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -52,6 +53,25 @@ class TriangularKernel
         bandwidth));
   }
 
+  /**
+   * Evaluate the triangular kernel between each point of a and each point of b,
+   * so that output(i, j) = K(a_i, b_j).  The squared distances are computed
+   * with one matrix product (see PairwiseSquaredDistances()).
+   *
+   * @tparam MatTypeA Type of the first set of points.
+   * @tparam MatTypeB Type of the second set of points.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param output Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& output) const
+  {
+    PairwiseSquaredDistances(a, b, output);
+    output = arma::clamp(1.0 - arma::sqrt(output) / bandwidth, 0.0,
+        arma::datum::inf);
+  }
+
   /**
    * Evaluate the triangular kernel given that the distance between the two
    * points is known.
@@ -112,6 +132,8 @@ class KernelTraits<TriangularKernel>
   static const bool IsNormalized = true;
   //! The triangular kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The triangular kernel has a batched Evaluate() function.
+  static const bool HasBatchEvaluation = true;
 };
 
 } // namespace kernel
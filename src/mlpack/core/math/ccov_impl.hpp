@@ -15,9 +15,57 @@
 
 #include "ccov.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
 
+namespace details {
+
+/**
+ * Merge the mean and scatter matrix (the sum of the outer products of the
+ * centered points) of a set of points into those of another set, with the
+ * pairwise update of Chan, Golub and LeVeque.  Unlike the sums of the points
+ * and of their outer products, this is numerically stable.
+ *
+ * @param count Number of points of the first set; updated.
+ * @param mean Mean of the first set; updated.
+ * @param scatter Scatter matrix of the first set; updated.
+ * @param otherCount Number of points of the second set.
+ * @param otherMean Mean of the second set.
+ * @param otherScatter Scatter matrix of the second set.
+ */
+template<typename eT>
+inline void MergeScatter(size_t& count,
+                         arma::Col<eT>& mean,
+                         arma::Mat<eT>& scatter,
+                         const size_t otherCount,
+                         const arma::Col<eT>& otherMean,
+                         const arma::Mat<eT>& otherScatter)
+{
+  if (otherCount == 0)
+    return;
+
+  if (count == 0)
+  {
+    count = otherCount;
+    mean = otherMean;
+    scatter = otherScatter;
+    return;
+  }
+
+  const size_t total = count + otherCount;
+  const arma::Col<eT> delta = otherMean - mean;
+  scatter += otherScatter;
+  scatter += (eT(count) * eT(otherCount) / eT(total)) * (delta * delta.t());
+  mean += (eT(otherCount) / eT(total)) * delta;
+  count = total;
+}
+
+} // namespace details
+
 template<typename eT>
 inline arma::Mat<eT> ColumnCovariance(const arma::Mat<eT>& x,
                                       const size_t normType)
@@ -40,9 +88,49 @@ inline arma::Mat<eT> ColumnCovariance(const arma::Mat<eT>& x,
     const size_t n = xAlias.n_cols;
     const eT normVal = (normType == 0) ? ((n > 1) ? eT(n - 1) : eT(1)) : eT(n);
 
-    const arma::Mat<eT> tmp = xAlias.each_col() - arma::mean(xAlias, 1);
+    // The points are split into one range per thread, and each range is
+    // processed in blocks of columns: the scatter matrix of each block is
+    // computed around the mean of that block (so only a block of centered
+    // points is held at once), and merged into the scatter matrix of the range.
+    // The ranges are merged in order, so the result does not depend on the
+    // scheduling.  This is a single pass over the points.
+    const size_t blockSize = 4096;
+    #ifdef HAS_OPENMP
+    const size_t numRanges = std::max(std::min((size_t) omp_get_max_threads(),
+        (n + blockSize - 1) / blockSize), (size_t) 1);
+    #else
+    const size_t numRanges = 1;
+    #endif
+
+    std::vector<size_t> counts(numRanges, 0);
+    std::vector<arma::Col<eT>> means(numRanges);
+    std::vector<arma::Mat<eT>> scatters(numRanges);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t r = 0; r < (omp_size_t) numRanges; ++r)
+    {
+      const size_t end = (r + 1) * n / numRanges;
+      for (size_t begin = r * n / numRanges; begin < end; begin += blockSize)
+      {
+        const size_t blockEnd = std::min(begin + blockSize, end);
+        const arma::Col<eT> blockMean = arma::mean(
+            xAlias.cols(begin, blockEnd - 1), 1);
+        const arma::Mat<eT> centered =
+            xAlias.cols(begin, blockEnd - 1).each_col() - blockMean;
+
+        details::MergeScatter(counts[r], means[r], scatters[r],
+            blockEnd - begin, blockMean, arma::Mat<eT>(centered *
+            centered.t()));
+      }
+    }
+
+    size_t count = 0;
+    arma::Col<eT> mean;
+    for (size_t r = 0; r < numRanges; ++r)
+    {
+      details::MergeScatter(count, mean, out, counts[r], means[r],
+          scatters[r]);
+    }
 
-    out = tmp * tmp.t();
     out /= normVal;
   }
 
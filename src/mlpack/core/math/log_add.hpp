@@ -28,44 +28,65 @@ template<typename T>
 T LogAdd(T x, T y);
 
 /**
- * Log-sum a vector of log values.  (T should be an Armadillo type.)
+ * Compute an approximation of exp(x), with a relative error below 1e-8, that
+ * needs no call to the math library: the argument is reduced to
+ * x = n log(2) + r with |r| <= log(2) / 2, exp(r) is computed with a
+ * polynomial, and 2^n is built directly from its bits.  Arguments below -708
+ * give (about) 1e-308 instead of zero, and arguments above 709 give (about)
+ * 8e307 instead of infinity.  Since it has no branches, loops that call it can
+ * be vectorized by the compiler.
+ *
+ * @param x Exponent.
+ * @return Approximation of e^x.
+ */
+inline double FastExp(const double x);
+
+/**
+ * Log-sum a vector of log values.  (T should be an Armadillo type.)  The
+ * maximum and the sum of exponentials are computed in two fused passes over
+ * the values, without temporaries if x is a dense vector or matrix.  If Fast
+ * is true, the exponentials are computed with FastExp().
  *
  * @param x vector of log values
  * @return log(e^x0 + e^x1 + ...)
  */
-template<typename T>
+template<typename T, bool Fast = false>
 typename T::elem_type AccuLog(const T& x);
 
 /**
- * Compute the sum of exponentials of each element in each column, then compute
+ * Compute the sum of exponentials of each element in each row, then compute
  * the log of that.  If InPlace is true, then the values of `y` will also be
- * added to the sum.
+ * added to the sum.  The matrix is traversed column by column, so the maxima
+ * and the sums of all the rows are updated together (which the compiler can
+ * vectorize), and no temporary of the size of x is created.  If Fast is true,
+ * the exponentials are computed with FastExp().
  *
  * That is, if InPlace is false, then this method will set `y` such that:
  *
- *     `y_i = log(sum(exp(x.col(i))))`
+ *     `y_i = log(sum(exp(x.row(i))))`
  *
  * and if InPlace is true, then `y` will be set such that:
  *
- *     `y_i = log(sum(exp(x.col(i))) + exp(y_i))`.
+ *     `y_i = log(sum(exp(x.row(i))) + exp(y_i))`.
  */
-template<typename T, bool InPlace = false>
+template<typename T, bool InPlace = false, bool Fast = false>
 void LogSumExp(const T& x, arma::Col<typename T::elem_type>& y);
 
 /**
- * Compute the sum of exponentials of each element in each row, then compute the
- * log of that.  If InPlace is true, then the values of `y` will also be added
- * to the sum.
+ * Compute the sum of exponentials of each element in each column, then compute
+ * the log of that.  If InPlace is true, then the values of `y` will also be
+ * added to the sum.  Each column is reduced in two fused passes, without
+ * temporaries.  If Fast is true, the exponentials are computed with FastExp().
  *
  * That is, if InPlace is false, then this method will set `y` such that:
  *
- *     `y_i = log(sum(exp(x.row(i))))`
+ *     `y_i = log(sum(exp(x.col(i))))`
  *
  * and if InPlace is true, then `y` will be set such that:
  *
- *     `y_i = log(sum(exp(x.row(i))) + exp(y_i))`.
+ *     `y_i = log(sum(exp(x.col(i))) + exp(y_i))`.
  */
-template<typename T, bool InPlace = false>
+template<typename T, bool InPlace = false, bool Fast = false>
 void LogSumExpT(const T& x, arma::Col<typename T::elem_type>& y);
 
 } // namespace math
@@ -14,6 +14,8 @@
 
 #include "log_add.hpp"
 
+#include <cstring>
+
 namespace mlpack {
 namespace math {
 
@@ -50,88 +52,238 @@ T LogAdd(T x, T y)
   if (std::isinf(d) || std::isinf(r))
     return r;
 
-  return r + log(1 + exp(d));
+  return r + std::log1p(std::exp(d));
 }
 
+/**
+ * Approximate exponential, without branches or calls to the math library.
+ */
+inline double FastExp(const double x)
+{
+  // Keep 2^n in the range of normal numbers (NaNs are kept).
+  const double clamped = std::min(std::max(x, -708.0), 709.0);
+
+  // x = n log(2) + r, with log(2) split in two parts so that r is exact.
+  const double n = std::floor(clamped * 1.4426950408889634 + 0.5);
+  const double r = clamped - n * 0.693145751953125 -
+      n * 1.42860682030941723212e-6;
+
+  // Taylor polynomial of exp(r); the error is below 1e-8 for |r| <= log(2) / 2.
+  const double p = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 + r *
+      (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720 + r * (1.0 / 5040)))))));
+
+  // Build 2^n from its exponent bits.
+  const uint64_t bits = ((uint64_t) ((int64_t) n + 1023)) << 52;
+  double scale;
+  std::memcpy(&scale, &bits, sizeof(double));
+  return p * scale;
+}
+
+namespace details {
+
+/**
+ * The exponential used by the log-sum-exp functions: std::exp() in the precise
+ * mode, and FastExp() in the fast mode.
+ */
+template<bool Fast>
+struct LogSumExpExp
+{
+  template<typename eT>
+  static eT Apply(const eT x) { return std::exp(x); }
+};
+
+template<>
+struct LogSumExpExp<true>
+{
+  template<typename eT>
+  static eT Apply(const eT x) { return (eT) FastExp((double) x); }
+};
+
+/**
+ * Get a dense matrix holding the given object: dense objects are used
+ * directly, and anything else (subviews, expressions) is evaluated into the
+ * given temporary.
+ */
+template<typename T>
+inline typename std::enable_if<
+    std::is_base_of<arma::Mat<typename T::elem_type>, T>::value,
+    const arma::Mat<typename T::elem_type>&>::type
+DenseMatrix(const T& x, arma::Mat<typename T::elem_type>& /* temporary */)
+{
+  return x;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !std::is_base_of<arma::Mat<typename T::elem_type>, T>::value,
+    const arma::Mat<typename T::elem_type>&>::type
+DenseMatrix(const T& x, arma::Mat<typename T::elem_type>& temporary)
+{
+  temporary = x;
+  return temporary;
+}
+
+//! The number of independent accumulators of the reductions, so that they
+//! can be vectorized without reordering the operations.
+static const size_t logSumExpLanes = 4;
+
+/**
+ * Compute the maximum of the given values (or -inf if there are none).
+ */
+template<typename eT>
+inline eT MaxValue(const eT* x, const size_t n)
+{
+  eT maxs[logSumExpLanes];
+  for (size_t l = 0; l < logSumExpLanes; ++l)
+    maxs[l] = -std::numeric_limits<eT>::infinity();
+
+  const size_t blocked = n - n % logSumExpLanes;
+  for (size_t i = 0; i < blocked; i += logSumExpLanes)
+    for (size_t l = 0; l < logSumExpLanes; ++l)
+      maxs[l] = (x[i + l] > maxs[l]) ? x[i + l] : maxs[l];
+  for (size_t i = blocked; i < n; ++i)
+    maxs[0] = (x[i] > maxs[0]) ? x[i] : maxs[0];
+
+  eT maxVal = maxs[0];
+  for (size_t l = 1; l < logSumExpLanes; ++l)
+    maxVal = (maxs[l] > maxVal) ? maxs[l] : maxVal;
+  return maxVal;
+}
+
+/**
+ * Compute the sum of exp(x_i - shift) over the given values.
+ */
+template<bool Fast, typename eT>
+inline eT SumExp(const eT* x, const size_t n, const eT shift)
+{
+  eT sums[logSumExpLanes];
+  for (size_t l = 0; l < logSumExpLanes; ++l)
+    sums[l] = 0;
+
+  const size_t blocked = n - n % logSumExpLanes;
+  for (size_t i = 0; i < blocked; i += logSumExpLanes)
+    for (size_t l = 0; l < logSumExpLanes; ++l)
+      sums[l] += LogSumExpExp<Fast>::Apply(x[i + l] - shift);
+  for (size_t i = blocked; i < n; ++i)
+    sums[0] += LogSumExpExp<Fast>::Apply(x[i] - shift);
+
+  eT sum = sums[0];
+  for (size_t l = 1; l < logSumExpLanes; ++l)
+    sum += sums[l];
+  return sum;
+}
+
+} // namespace details
+
 /**
  * Sum a vector of log values.
  *
  * @param x vector of log values
  * @return log(e^x0 + e^x1 + ...)
  */
-template<typename T>
+template<typename T, bool Fast>
 typename T::elem_type AccuLog(const T& x)
 {
-  typename T::elem_type maxVal = max(x);
-  if (maxVal == -std::numeric_limits<typename T::elem_type>::infinity())
+  typedef typename T::elem_type eT;
+
+  arma::Mat<eT> temporary;
+  const arma::Mat<eT>& values = details::DenseMatrix(x, temporary);
+
+  const eT maxVal = details::MaxValue(values.memptr(), values.n_elem);
+  if (std::isinf(maxVal))
     return maxVal;
 
-  return maxVal + log(sum(exp(x - maxVal)));;
+  return maxVal + std::log(details::SumExp<Fast>(values.memptr(),
+      values.n_elem, maxVal));
 }
 
 /**
- * Compute the sum of exponentials of each element in each column, then compute
+ * Compute the sum of exponentials of each element in each row, then compute
  * the log of that.  If InPlace is true, then the values of `y` will also be
  * added to the sum.
  */
-template<typename T, bool InPlace>
+template<typename T, bool InPlace, bool Fast>
 void LogSumExp(const T& x, arma::Col<typename T::elem_type>& y)
 {
-  arma::Col<typename T::elem_type> maxs;
+  typedef typename T::elem_type eT;
 
-  if (InPlace)
-  {
-    // Compute the maximum in each column (treating y as a column too).
-    maxs = max(max(x, 1), y);
+  arma::Mat<eT> temporary;
+  const arma::Mat<eT>& values = details::DenseMatrix(x, temporary);
+  const size_t rows = values.n_rows;
 
-    y = maxs + log(sum(exp(x - repmat(maxs, 1, x.n_cols)), 1) +
-        exp(y - maxs));
-  }
+  // Compute the maximum in each row (treating y as a column too).
+  arma::Col<eT> maxs(rows);
+  if (InPlace)
+    maxs = y;
   else
+    maxs.fill(-std::numeric_limits<eT>::infinity());
+
+  eT* maxPtr = maxs.memptr();
+  for (size_t j = 0; j < values.n_cols; ++j)
   {
-    // Compute the maximum element in each column.
-    maxs = max(x, 1);
+    const eT* col = values.colptr(j);
+    for (size_t i = 0; i < rows; ++i)
+      maxPtr[i] = (col[i] > maxPtr[i]) ? col[i] : maxPtr[i];
+  }
 
-    y = maxs + log(sum(exp(x - repmat(maxs, 1, x.n_cols)), 1));
+  // Now sum the exponentials of the shifted values of each row.
+  arma::Col<eT> sums(rows);
+  eT* sumPtr = sums.memptr();
+  for (size_t i = 0; i < rows; ++i)
+  {
+    sumPtr[i] = InPlace ?
+        details::LogSumExpExp<Fast>::Apply(y[i] - maxPtr[i]) : 0;
   }
 
-  if (maxs.has_inf())
+  for (size_t j = 0; j < values.n_cols; ++j)
   {
-    y.replace(-std::numeric_limits<typename T::elem_type>::quiet_NaN(),
-              -std::numeric_limits<typename T::elem_type>::infinity());
+    const eT* col = values.colptr(j);
+    for (size_t i = 0; i < rows; ++i)
+      sumPtr[i] += details::LogSumExpExp<Fast>::Apply(col[i] - maxPtr[i]);
   }
+
+  // A row whose maximum is infinite sums to that maximum.
+  y.set_size(rows);
+  for (size_t i = 0; i < rows; ++i)
+    y[i] = std::isinf(maxPtr[i]) ? maxPtr[i] : maxPtr[i] + std::log(sumPtr[i]);
 }
 
 /**
- * Compute the sum of exponentials of each element in each row, then compute the
- * log of that.  If InPlace is true, then the values of `y` will also be added
- * to the sum.
+ * Compute the sum of exponentials of each element in each column, then compute
+ * the log of that.  If InPlace is true, then the values of `y` will also be
+ * added to the sum.
  */
-template<typename T, bool InPlace>
+template<typename T, bool InPlace, bool Fast>
 void LogSumExpT(const T& x, arma::Col<typename T::elem_type>& y)
 {
-  arma::Row<typename T::elem_type> maxs;
+  typedef typename T::elem_type eT;
 
-  if (InPlace)
-  {
-    // Compute the maximum element in each column.
-    maxs = max(max(x, 0), y.t());
+  arma::Mat<eT> temporary;
+  const arma::Mat<eT>& values = details::DenseMatrix(x, temporary);
 
-    y = maxs.t() + log(sum(exp(x - repmat(maxs, x.n_rows, 1)), 0) +
-        exp(y.t() - maxs)).t();
-  }
-  else
+  if (!InPlace)
+    y.set_size(values.n_cols);
+
+  for (size_t j = 0; j < values.n_cols; ++j)
   {
-    // Compute the maximum element in each column.
-    arma::Row<typename T::elem_type> maxs = max(x, 0);
+    const eT* col = values.colptr(j);
 
-    y = (maxs + log(sum(exp(x - repmat(maxs, x.n_rows, 1)), 0))).t();
-  }
+    // Compute the maximum of the column (and y_j).
+    eT maxVal = details::MaxValue(col, values.n_rows);
+    if (InPlace && y[j] > maxVal)
+      maxVal = y[j];
 
-  if (maxs.has_inf())
-  {
-    y.replace(-std::numeric_limits<typename T::elem_type>::quiet_NaN(),
-              -std::numeric_limits<typename T::elem_type>::infinity());
+    // A column whose maximum is infinite sums to that maximum.
+    if (std::isinf(maxVal))
+    {
+      y[j] = maxVal;
+      continue;
+    }
+
+    eT sum = details::SumExp<Fast>(col, values.n_rows, maxVal);
+    if (InPlace)
+      sum += details::LogSumExpExp<Fast>::Apply(y[j] - maxVal);
+    y[j] = maxVal + std::log(sum);
   }
 }
 
@@ -102,6 +102,37 @@ arma::SpCol<ElemType> MakeAlias(const arma::SpCol<ElemType>& input,
   return arma::SpCol<ElemType>(input);
 }
 
+/**
+ * Make the given matrix an alias of the given memory.  The copy and move
+ * assignment operators of Armadillo copy the memory of an alias, so the matrix
+ * is reconstructed in place instead.  If strict is true, then the alias cannot
+ * be resized or pointed at new memory.
+ */
+template<typename ElemType>
+void MakeAlias(arma::Mat<ElemType>& m,
+               ElemType* memory,
+               const size_t numRows,
+               const size_t numCols,
+               const bool strict = true)
+{
+  m.~Mat();
+  new (&m) arma::Mat<ElemType>(memory, numRows, numCols, false, strict);
+}
+
+/**
+ * Make the given row an alias of the given memory.  If strict is true, then the
+ * alias cannot be resized or pointed at new memory.
+ */
+template<typename ElemType>
+void MakeAlias(arma::Row<ElemType>& r,
+               ElemType* memory,
+               const size_t numElem,
+               const bool strict = true)
+{
+  r.~Row();
+  new (&r) arma::Row<ElemType>(memory, numElem, false, strict);
+}
+
 /**
  * Clear an alias so that no data is overwritten.  This resets the matrix if it
  * is an alias (and does nothing otherwise).
@@ -0,0 +1,111 @@
+/**
+ * @file core/math/parallel_multiply.hpp
+ *
+ * Functions to multiply a (possibly sparse) data matrix with a dense matrix,
+ * in parallel for sparse matrices, and to do so as if the data had been
+ * centered.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PARALLEL_MULTIPLY_HPP
+#define MLPACK_CORE_MATH_PARALLEL_MULTIPLY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math /** Miscellaneous math routines. */ {
+
+/**
+ * Compute output = a * b.  The dense product is left to BLAS.
+ *
+ * @param a Dense matrix.
+ * @param b Dense matrix.
+ * @param output Matrix to store the product in.
+ */
+template<typename eT>
+void ParallelMultiply(const arma::Mat<eT>& a,
+                      const arma::Mat<eT>& b,
+                      arma::Mat<eT>& output);
+
+/**
+ * Compute output = a * b for a sparse matrix a.  The columns of the output are
+ * computed in parallel with OpenMP.
+ *
+ * @param a Sparse matrix.
+ * @param b Dense matrix.
+ * @param output Matrix to store the product in.
+ */
+template<typename eT>
+void ParallelMultiply(const arma::SpMat<eT>& a,
+                      const arma::Mat<eT>& b,
+                      arma::Mat<eT>& output);
+
+/**
+ * Compute output = a^T * b.  The dense product is left to BLAS.
+ *
+ * @param a Dense matrix.
+ * @param b Dense matrix.
+ * @param output Matrix to store the product in.
+ */
+template<typename eT>
+void ParallelMultiplyTrans(const arma::Mat<eT>& a,
+                           const arma::Mat<eT>& b,
+                           arma::Mat<eT>& output);
+
+/**
+ * Compute output = a^T * b for a sparse matrix a, without forming a^T.  The
+ * rows of the output (one for each column of a) are computed in parallel with
+ * OpenMP.
+ *
+ * @param a Sparse matrix.
+ * @param b Dense matrix.
+ * @param output Matrix to store the product in.
+ */
+template<typename eT>
+void ParallelMultiplyTrans(const arma::SpMat<eT>& a,
+                           const arma::Mat<eT>& b,
+                           arma::Mat<eT>& output);
+
+/**
+ * Compute output = (a - mean * 1^T) * b, that is, the product of the data
+ * centered on the given mean and b, without forming the centered data (so a
+ * sparse matrix stays sparse).  If the mean is empty, the data is not
+ * centered.
+ *
+ * @param a Data matrix (dense or sparse).
+ * @param mean Column vector to center the columns of the data on.
+ * @param b Dense matrix.
+ * @param output Matrix to store the product in.
+ */
+template<typename MatType, typename eT>
+void CenteredMultiply(const MatType& a,
+                      const arma::Mat<eT>& mean,
+                      const arma::Mat<eT>& b,
+                      arma::Mat<eT>& output);
+
+/**
+ * Compute output = (a - mean * 1^T)^T * b, that is, the product of the
+ * transposed data centered on the given mean and b, without forming the
+ * centered data.  If the mean is empty, the data is not centered.
+ *
+ * @param a Data matrix (dense or sparse).
+ * @param mean Column vector to center the columns of the data on.
+ * @param b Dense matrix.
+ * @param output Matrix to store the product in.
+ */
+template<typename MatType, typename eT>
+void CenteredMultiplyTrans(const MatType& a,
+                           const arma::Mat<eT>& mean,
+                           const arma::Mat<eT>& b,
+                           arma::Mat<eT>& output);
+
+} // namespace math
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_multiply_impl.hpp"
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file core/math/parallel_multiply_impl.hpp
+ *
+ * Implementation of the parallel and implicitly centered products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PARALLEL_MULTIPLY_IMPL_HPP
+#define MLPACK_CORE_MATH_PARALLEL_MULTIPLY_IMPL_HPP
+
+#include "parallel_multiply.hpp"
+
+namespace mlpack {
+namespace math /** Miscellaneous math routines. */ {
+
+template<typename eT>
+void ParallelMultiply(const arma::Mat<eT>& a,
+                      const arma::Mat<eT>& b,
+                      arma::Mat<eT>& output)
+{
+  output = a * b;
+}
+
+template<typename eT>
+void ParallelMultiply(const arma::SpMat<eT>& a,
+                      const arma::Mat<eT>& b,
+                      arma::Mat<eT>& output)
+{
+  if (a.n_cols != b.n_rows)
+    Log::Fatal << "ParallelMultiply(): matrix multiplication invalid!"
+        << std::endl;
+
+  // The compressed form must be up to date before the threads read it.
+  a.sync();
+  output.zeros(a.n_rows, b.n_cols);
+
+  // Each thread walks over all the nonzero elements for its columns of b, and
+  // writes only to the same columns of the output.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    const eT* bCol = b.colptr(j);
+    eT* outCol = output.colptr(j);
+    for (size_t c = 0; c < a.n_cols; ++c)
+    {
+      if (bCol[c] == 0)
+        continue;
+
+      for (size_t p = a.col_ptrs[c]; p < a.col_ptrs[c + 1]; ++p)
+        outCol[a.row_indices[p]] += a.values[p] * bCol[c];
+    }
+  }
+}
+
+template<typename eT>
+void ParallelMultiplyTrans(const arma::Mat<eT>& a,
+                           const arma::Mat<eT>& b,
+                           arma::Mat<eT>& output)
+{
+  output = a.t() * b;
+}
+
+template<typename eT>
+void ParallelMultiplyTrans(const arma::SpMat<eT>& a,
+                           const arma::Mat<eT>& b,
+                           arma::Mat<eT>& output)
+{
+  if (a.n_rows != b.n_rows)
+    Log::Fatal << "ParallelMultiplyTrans(): matrix multiplication invalid!"
+        << std::endl;
+
+  a.sync();
+
+  // Row i of the output is the combination of the rows of b given by column i
+  // of a.  Working with the transposes keeps the accesses contiguous.
+  const arma::Mat<eT> bTrans = b.t();
+  arma::Mat<eT> outputTrans(b.n_cols, a.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) a.n_cols; ++i)
+  {
+    eT* outCol = outputTrans.colptr(i);
+    for (size_t p = a.col_ptrs[i]; p < a.col_ptrs[i + 1]; ++p)
+    {
+      const eT value = a.values[p];
+      const eT* bCol = bTrans.colptr(a.row_indices[p]);
+      for (size_t k = 0; k < bTrans.n_rows; ++k)
+        outCol[k] += value * bCol[k];
+    }
+  }
+
+  output = outputTrans.t();
+}
+
+template<typename MatType, typename eT>
+void CenteredMultiply(const MatType& a,
+                      const arma::Mat<eT>& mean,
+                      const arma::Mat<eT>& b,
+                      arma::Mat<eT>& output)
+{
+  ParallelMultiply(a, b, output);
+
+  // (a - mean * 1^T) * b = a * b - mean * (1^T * b).
+  if (!mean.is_empty())
+    output -= mean * arma::sum(b, 0);
+}
+
+template<typename MatType, typename eT>
+void CenteredMultiplyTrans(const MatType& a,
+                           const arma::Mat<eT>& mean,
+                           const arma::Mat<eT>& b,
+                           arma::Mat<eT>& output)
+{
+  ParallelMultiplyTrans(a, b, output);
+
+  // (a - mean * 1^T)^T * b = a^T * b - 1 * (mean^T * b).
+  if (!mean.is_empty())
+    output.each_row() -= mean.t() * b;
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -9,6 +9,11 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <random>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <mlpack/mlpack_export.hpp>
 
 namespace mlpack {
@@ -20,6 +25,19 @@ MLPACK_EXPORT std::mt19937 randGen;
 MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+// Seed from which all the random streams are derived.  The default matches
+// the default seed of std::mt19937.
+MLPACK_EXPORT std::atomic<size_t> randSeed(5489);
+// Number of random streams reserved since the last seed.
+MLPACK_EXPORT std::atomic<size_t> randStreams(0);
+// Number of times the seed was set.
+MLPACK_EXPORT std::atomic<size_t> randGeneration(1);
+// Number of LocalRandomGenerator objects created.
+MLPACK_EXPORT std::atomic<size_t> randContexts(0);
+// Seeds of the existing LocalRandomGenerator objects.
+MLPACK_EXPORT std::map<size_t, uint64_t> randContextSeeds;
+// Lock of randContextSeeds.
+MLPACK_EXPORT std::mutex randContextMutex;
 
 } // namespace math
 } // namespace mlpack
@@ -14,6 +14,13 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
 #include <random>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
@@ -29,6 +36,144 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// Seed given to RandomSeed(), from which all the random streams are derived.
+extern MLPACK_EXPORT std::atomic<size_t> randSeed;
+// Number of random streams reserved since the last call to RandomSeed().
+extern MLPACK_EXPORT std::atomic<size_t> randStreams;
+// Number of calls to RandomSeed(), so that the generators of the threads know
+// when to reseed themselves.
+extern MLPACK_EXPORT std::atomic<size_t> randGeneration;
+// Number of LocalRandomGenerator objects created, from which each of them gets
+// its identifier.
+extern MLPACK_EXPORT std::atomic<size_t> randContexts;
+// Seeds of the existing LocalRandomGenerator objects, by identifier, so that
+// RandomStream() can find them from any thread.
+extern MLPACK_EXPORT std::map<size_t, uint64_t> randContextSeeds;
+// Lock of randContextSeeds.
+extern MLPACK_EXPORT std::mutex randContextMutex;
+
+/**
+ * The number of low bits of a random stream index that hold the index of the
+ * stream for its seed; the high bits hold the identifier of the
+ * LocalRandomGenerator that reserved it (or 0 for the global streams).
+ */
+static const size_t randStreamBits = sizeof(size_t) * 4;
+
+/**
+ * Reset the random streams after the seed is set to the given value.
+ */
+inline void ResetRandomStreams(const size_t seed)
+{
+  randSeed = seed;
+  randStreams = 0;
+  ++randGeneration;
+}
+
+/**
+ * While a LocalRandomGenerator exists, the thread that created it uses the
+ * generator, the normal distribution, the seed and the random streams of the
+ * object instead of the global ones (outside of OpenMP parallel regions), and
+ * RandomSeed() in that thread only seeds the object.  This lets several
+ * threads run mlpack methods at the same time (as the Python bindings do,
+ * since they release the GIL during the computation) without sharing the
+ * global generator: the streams reserved by ReserveRandomStreams() are
+ * numbered for the object only, and RandomStream() derives them from the
+ * object's seed in any thread, so the numbers drawn from them depend only on
+ * the seed given to the call.
+ *
+ * The generators that RandGen() gives the threads inside OpenMP parallel
+ * regions cannot know the LocalRandomGenerator of the thread that started the
+ * region, so they are still seeded from the global seed; numbers drawn from
+ * them are not reproducible with the seed of a LocalRandomGenerator (the
+ * random streams are).  The objects must be destroyed in the reverse order of
+ * their creation.
+ */
+class LocalRandomGenerator
+{
+ public:
+  //! Make the calling thread use this generator.
+  LocalRandomGenerator() :
+      normalDist(0.0, 1.0),
+      seed(5489),
+      streams(0),
+      previous(Current())
+  {
+    // Identifier 0 is taken by the global streams.
+    do
+    {
+      id = (++randContexts) & ((size_t(1) << randStreamBits) - 1);
+    } while (id == 0);
+
+    {
+      std::lock_guard<std::mutex> lock(randContextMutex);
+      randContextSeeds[id] = seed;
+    }
+    Current() = this;
+  }
+
+  //! Make the calling thread use the generator it used before.
+  ~LocalRandomGenerator()
+  {
+    Current() = previous;
+    std::lock_guard<std::mutex> lock(randContextMutex);
+    randContextSeeds.erase(id);
+  }
+
+  // The object is registered by address, so it cannot be copied.
+  LocalRandomGenerator(const LocalRandomGenerator&) = delete;
+  LocalRandomGenerator& operator=(const LocalRandomGenerator&) = delete;
+
+  //! Get the local generator of the calling thread, or NULL if it has none.
+  static LocalRandomGenerator*& Current()
+  {
+    static thread_local LocalRandomGenerator* current = NULL;
+    return current;
+  }
+
+  /**
+   * Seed the generator, and reset the random streams of the object.
+   *
+   * @param newSeed Seed for the random number generator.
+   */
+  void Seed(const size_t newSeed)
+  {
+    gen.seed((uint32_t) newSeed);
+    normalDist.reset();
+    seed = newSeed;
+    streams = 0;
+    std::lock_guard<std::mutex> lock(randContextMutex);
+    randContextSeeds[id] = seed;
+  }
+
+  /**
+   * Reserve the given number of consecutive random streams of the object, and
+   * return the index of the first one (see ReserveRandomStreams()).
+   *
+   * @param numStreams Number of streams to reserve.
+   */
+  size_t ReserveStreams(const size_t numStreams)
+  {
+    const size_t first = streams;
+    streams += numStreams;
+    return (id << randStreamBits) | first;
+  }
+
+  //! The random number generator.
+  std::mt19937 gen;
+  //! The normal distribution.
+  std::normal_distribution<> normalDist;
+
+ private:
+  //! The seed given to Seed().
+  uint64_t seed;
+  //! The number of streams reserved since the last call to Seed().
+  size_t streams;
+  //! The identifier of the object, which is the high part of the indices of
+  //! its streams.
+  size_t id;
+  //! The local generator of the thread before this one was created.
+  LocalRandomGenerator* previous;
+};
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
@@ -40,6 +185,16 @@ extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
 inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
+    if (LocalRandomGenerator::Current() != NULL)
+    {
+      // Only seed the generator and the streams of this thread; the global
+      // seed and streams are not touched, so that other threads are not
+      // disturbed.
+      LocalRandomGenerator::Current()->Seed(seed);
+      arma::arma_rng::set_seed(seed);
+      return;
+    }
+
     randGen.seed((uint32_t) seed);
     #if (BINDING_TYPE == BINDING_TYPE_R)
       // To suppress Found 'srand', possibly from 'srand' (C).
@@ -48,6 +203,7 @@ inline void RandomSeed(const size_t seed)
       srand((unsigned int) seed);
     #endif
     arma::arma_rng::set_seed(seed);
+    ResetRandomStreams(seed);
   #else
     (void) seed;
   #endif
@@ -67,6 +223,7 @@ inline void FixedRandomSeed()
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
+  ResetRandomStreams(seed);
 }
 
 inline void CustomRandomSeed(const size_t seed)
@@ -74,15 +231,128 @@ inline void CustomRandomSeed(const size_t seed)
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
+  ResetRandomStreams(seed);
 }
 #endif
 
+/**
+ * Reserve the given number of consecutive random streams, and return the index
+ * of the first one.  The streams are numbered in the order they are reserved
+ * since the last call to RandomSeed(), so reserving them outside of parallel
+ * regions gives the same streams on every run with the same seed.  If the
+ * calling thread has a LocalRandomGenerator, the streams of that object are
+ * reserved.
+ *
+ * @param numStreams Number of streams to reserve.
+ */
+inline size_t ReserveRandomStreams(const size_t numStreams)
+{
+  if (LocalRandomGenerator::Current() != NULL)
+    return LocalRandomGenerator::Current()->ReserveStreams(numStreams);
+
+  return randStreams.fetch_add(numStreams);
+}
+
+/**
+ * Create the generator of the given random stream.  It is seeded from the seed
+ * given to RandomSeed() and the index of the stream only, so that a task that
+ * draws its random numbers from its own stream (as given by
+ * ReserveRandomStreams()) gets the same numbers whichever thread runs it, and
+ * however many threads there are.  The streams of a LocalRandomGenerator are
+ * seeded from the seed of that object (the same streams as the global ones
+ * after RandomSeed() with that seed).
+ *
+ * @param stream Index of the stream.
+ */
+inline std::mt19937 RandomStream(const size_t stream)
+{
+  const size_t context = stream >> randStreamBits;
+  const uint64_t index = stream & ((size_t(1) << randStreamBits) - 1);
+
+  uint64_t seed = randSeed;
+  if (context != 0)
+  {
+    std::lock_guard<std::mutex> lock(randContextMutex);
+    std::map<size_t, uint64_t>::const_iterator it =
+        randContextSeeds.find(context);
+    if (it != randContextSeeds.end())
+      seed = it->second;
+  }
+
+  std::seed_seq sequence({ (uint32_t) 0, (uint32_t) seed,
+      (uint32_t) (seed >> 32), (uint32_t) index,
+      (uint32_t) (index >> 32) });
+  return std::mt19937(sequence);
+}
+
+/**
+ * Get the random number generator of the calling thread.  Outside of parallel
+ * regions, this is the global generator randGen (or the LocalRandomGenerator of
+ * the thread, if it has one).  Inside of OpenMP parallel
+ * regions, each thread has its own generator, seeded from the seed given to
+ * RandomSeed() and the position of the thread in its team (and in the teams
+ * above it), so that the threads never contend for (or corrupt) the global
+ * generator, and a parallel loop with a static schedule draws the same numbers
+ * on every run with the same seed and number of threads.
+ */
+inline std::mt19937& RandGen()
+{
+  #ifdef HAS_OPENMP
+  if (omp_in_parallel())
+  {
+    static thread_local std::mt19937 threadGen;
+    static thread_local size_t threadGeneration = 0;
+    const size_t generation = randGeneration;
+    if (threadGeneration != generation)
+    {
+      const uint64_t seed = randSeed;
+      std::vector<uint32_t> words({ (uint32_t) 1, (uint32_t) seed,
+          (uint32_t) (seed >> 32), (uint32_t) generation });
+      for (int level = 1; level <= omp_get_level(); ++level)
+        words.push_back((uint32_t) omp_get_ancestor_thread_num(level));
+      std::seed_seq sequence(words.begin(), words.end());
+      threadGen.seed(sequence);
+      threadGeneration = generation;
+    }
+
+    return threadGen;
+  }
+  #endif
+
+  if (LocalRandomGenerator::Current() != NULL)
+    return LocalRandomGenerator::Current()->gen;
+
+  return randGen;
+}
+
+/**
+ * Get the normal distribution of the calling thread, which, like RandGen(), is
+ * the global one (or the local one) outside of parallel regions.  (A normal
+ * distribution caches every other value it generates, so it cannot be shared
+ * between threads.)
+ */
+inline std::normal_distribution<>& RandNormalDist()
+{
+  #ifdef HAS_OPENMP
+  if (omp_in_parallel())
+  {
+    static thread_local std::normal_distribution<> threadNormalDist(0.0, 1.0);
+    return threadNormalDist;
+  }
+  #endif
+
+  if (LocalRandomGenerator::Current() != NULL)
+    return LocalRandomGenerator::Current()->normalDist;
+
+  return randNormalDist;
+}
+
 /**
  * Generates a uniform random number between 0 and 1.
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  return randUniformDist(RandGen());
 }
 
 /**
@@ -90,7 +360,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * randUniformDist(RandGen());
 }
 
 /**
@@ -109,7 +379,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * randUniformDist(RandGen()));
 }
 
 /**
@@ -118,7 +388,7 @@ inline int RandInt(const int hiExclusive)
 inline int RandInt(const int lo, const int hiExclusive)
 {
   return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+                               * randUniformDist(RandGen()));
 }
 
 /**
@@ -126,7 +396,7 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  return RandNormalDist()(RandGen());
 }
 
 /**
@@ -138,7 +408,64 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormalDist()(RandGen()) + mean;
+}
+
+/**
+ * Fill the given matrix with random numbers from the given distribution, in
+ * parallel.  The elements are split into blocks of fixed size, and each block
+ * is drawn from its own random stream, so the result only depends on the seed
+ * given to RandomSeed() (and the streams reserved before), and not on the
+ * number of threads.
+ *
+ * @param x Matrix to fill (its size is kept).
+ * @param distribution Distribution to draw the elements from.
+ */
+template<typename MatType, typename DistributionType>
+void RandomFill(MatType& x, const DistributionType& distribution)
+{
+  const size_t blockSize = 16384;
+  const size_t numBlocks = (x.n_elem + blockSize - 1) / blockSize;
+  const size_t firstStream = ReserveRandomStreams(numBlocks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 generator = RandomStream(firstStream + b);
+    DistributionType blockDistribution(distribution);
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) x.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      x[i] = blockDistribution(generator);
+  }
+}
+
+/**
+ * Fill the given matrix with uniform random numbers between 0 and 1, in
+ * parallel, like arma::randu() but reproducible across thread counts (see
+ * RandomFill()).
+ *
+ * @param x Matrix to fill (its size is kept).
+ */
+template<typename MatType>
+void RandUniformFill(MatType& x)
+{
+  typedef typename MatType::elem_type ElemType;
+  RandomFill(x, std::uniform_real_distribution<ElemType>(0, 1));
+}
+
+/**
+ * Fill the given matrix with normally distributed random numbers with mean 0
+ * and variance 1, in parallel, like arma::randn() but reproducible across
+ * thread counts (see RandomFill()).
+ *
+ * @param x Matrix to fill (its size is kept).
+ */
+template<typename MatType>
+void RandNormalFill(MatType& x)
+{
+  typedef typename MatType::elem_type ElemType;
+  RandomFill(x, std::normal_distribution<ElemType>(0, 1));
 }
 
 /**
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_MATH_SHUFFLE_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace math {
@@ -237,6 +238,43 @@ void ShuffleData(const MatType& inputPoints,
   }
 }
 
+/**
+ * Shuffle a dense dataset and associated labels (or responses) in place, with
+ * the Fisher-Yates algorithm, so that no copy of the data is made.  It is
+ * expected that points and labels have the same number of columns (so, be sure
+ * that labels, if it is a vector, is a row vector).  The shuffled order is not
+ * the same as the order given by the other overloads for the same random seed.
+ *
+ * @param points Dataset to shuffle.
+ * @param labels Labels (or responses) to shuffle the same way.
+ */
+template<typename MatType, typename LabelsType>
+void ShuffleDataInPlace(
+    MatType& points,
+    LabelsType& labels,
+    const std::enable_if_t<!arma::is_SpMat<MatType>::value>* = 0,
+    const std::enable_if_t<!arma::is_Cube<MatType>::value>* = 0)
+{
+  if (points.n_cols != labels.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ShuffleDataInPlace(): number of points (" << points.n_cols << ") "
+        << "does not match number of labels (" << labels.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t i = points.n_cols; i > 1; --i)
+  {
+    // Swap the last point of the unshuffled part with a random one of them.
+    const size_t j = std::uniform_int_distribution<size_t>(0, i - 1)(RandGen());
+    if (j != i - 1)
+    {
+      points.swap_cols(j, i - 1);
+      labels.swap_cols(j, i - 1);
+    }
+  }
+}
+
 } // namespace math
 } // namespace mlpack
 
@@ -18,6 +18,66 @@
 namespace mlpack {
 namespace metric {
 
+/**
+ * For dense vectors of two to four elements, Sum() computes the sum of the
+ * |a_i - b_i| (Power = 1) or of the (a_i - b_i)^2 (Power = 2) with a loop of
+ * fixed length, which the compiler can unroll; for such low-dimensional points,
+ * this is much cheaper than an Armadillo expression.  For other vectors, it
+ * returns false, and the sum must be computed in the usual way.
+ */
+template<bool IsDense>
+struct FixedDimensionSum
+{
+  template<int Power, typename VecTypeA, typename VecTypeB>
+  static bool Sum(const VecTypeA& /* a */,
+                  const VecTypeB& /* b */,
+                  typename VecTypeA::elem_type& /* sum */)
+  {
+    return false;
+  }
+};
+
+template<>
+struct FixedDimensionSum<true>
+{
+  template<int Power, typename VecTypeA, typename VecTypeB>
+  static bool Sum(const VecTypeA& a,
+                  const VecTypeB& b,
+                  typename VecTypeA::elem_type& sum)
+  {
+    switch (a.n_elem)
+    {
+      case 2:
+        sum = FixedSum<Power, 2>(a, b);
+        return true;
+      case 3:
+        sum = FixedSum<Power, 3>(a, b);
+        return true;
+      case 4:
+        sum = FixedSum<Power, 4>(a, b);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  template<int Power, size_t Dim, typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type FixedSum(const VecTypeA& a,
+                                               const VecTypeB& b)
+  {
+    typedef typename VecTypeA::elem_type ElemType;
+
+    ElemType sum = 0;
+    for (size_t i = 0; i < Dim; ++i)
+    {
+      const ElemType diff = a[i] - b[i];
+      sum += (Power == 1) ? ((diff < 0) ? -diff : diff) : diff * diff;
+    }
+
+    return sum;
+  }
+};
+
 // Unspecialized implementation.  This should almost never be used...
 template<int Power, bool TakeRoot>
 template<typename VecTypeA, typename VecTypeB>
@@ -42,6 +102,11 @@ typename VecTypeA::elem_type LMetric<1, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type sum;
+  if (FixedDimensionSum<!arma::is_arma_sparse_type<VecTypeA>::value &&
+      !arma::is_arma_sparse_type<VecTypeB>::value>::template Sum<1>(a, b, sum))
+    return sum;
+
   return arma::accu(abs(a - b));
 }
 
@@ -51,6 +116,11 @@ typename VecTypeA::elem_type LMetric<1, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type sum;
+  if (FixedDimensionSum<!arma::is_arma_sparse_type<VecTypeA>::value &&
+      !arma::is_arma_sparse_type<VecTypeB>::value>::template Sum<1>(a, b, sum))
+    return sum;
+
   return arma::accu(abs(a - b));
 }
 
@@ -61,6 +131,15 @@ typename VecTypeA::elem_type LMetric<2, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  // norm() guards against underflow and overflow, so the sum is only used if
+  // it is positive and finite.
+  typedef typename VecTypeA::elem_type ElemType;
+  ElemType sum;
+  if (FixedDimensionSum<!arma::is_arma_sparse_type<VecTypeA>::value &&
+      !arma::is_arma_sparse_type<VecTypeB>::value>::template Sum<2>(a, b,
+      sum) && sum > 0 && sum <= std::numeric_limits<ElemType>::max())
+    return (ElemType) std::sqrt(sum);
+
   return arma::norm(a - b, 2);
 }
 
@@ -70,6 +149,11 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
+  typename VecTypeA::elem_type sum;
+  if (FixedDimensionSum<!arma::is_arma_sparse_type<VecTypeA>::value &&
+      !arma::is_arma_sparse_type<VecTypeB>::value>::template Sum<2>(a, b, sum))
+    return sum;
+
   return accu(arma::square(a - b));
 }
 
@@ -25,9 +25,8 @@ template<typename VecTypeA, typename VecTypeB>
 double MahalanobisDistance<false>::Evaluate(const VecTypeA& a,
                                             const VecTypeB& b)
 {
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1
-  return out[0];
+  const arma::vec m = (a - b);
+  return arma::dot(m, covariance * m);
 }
 /**
  * Specialization for rooted case.  This requires one extra evaluation of
@@ -42,9 +41,8 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   if (covariance.n_rows == 0)
     covariance = arma::eye<arma::mat>(a.n_elem, a.n_elem);
 
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1;
-  return sqrt(out[0]);
+  const arma::vec m = (a - b);
+  return sqrt(arma::dot(m, covariance * m));
 }
 
 // Serialize the Mahalanobis distance.
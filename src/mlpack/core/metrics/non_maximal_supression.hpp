@@ -12,6 +12,9 @@
 #ifndef MLPACK_CORE_METRICS_NMS_HPP
 #define MLPACK_CORE_METRICS_NMS_HPP
 
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/size_checks.hpp>
+
 namespace mlpack {
 namespace metric {
 
@@ -31,6 +34,15 @@ namespace metric {
  * Where x0 and y0 are bottom left bounding box coordinates and h, w are
  * height and width of the bounding box.
  *
+ * The boxes are sorted once by confidence score, and the IoU of each selected
+ * box with all the remaining boxes is computed in a single loop over arrays of
+ * coordinates, which the compiler can vectorize; suppressed boxes are marked
+ * in a mask instead of being removed from a list of indices.
+ *
+ * Per-class NMS (where boxes only suppress boxes of the same class) is given by
+ * the overload of Evaluate() that takes labels, and Soft-NMS (where the scores
+ * of overlapping boxes are decayed instead of discarded) by SoftEvaluate().
+ *
  * @tparam UseCoordinates Toggles between the two representation of bounding box.
  *                        If true, each value in vector represents a coordinate 
  *                        in the formate x0, y0, x1, y1. Else the bounding box is
@@ -70,11 +82,104 @@ class NMS
                        OutputType& selectedIndices,
                        const double threshold = 0.5);
 
+  /**
+   * Performs non-maximal suppression separately for each class: a bounding
+   * box only suppresses the bounding boxes with the same label.  The selected
+   * indices of all the classes are sorted in descending order of the
+   * confidence scores.
+   *
+   * @param boundingBoxes Column major representation of bounding boxes.
+   * @param confidenceScores Vector containing confidence score corresponding
+   *                         to each bounding box.
+   * @param labels Class of each bounding box.
+   * @param selectedIndices Output of Non Maximal Suppression (NMS) is stored
+   *                        here.
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *                  of the same class that have IoU greater than the
+   *                  threshold.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename LabelsType,
+      typename OutputType
+  >
+  static void Evaluate(const BoundingBoxesType& boundingBoxes,
+                       const ConfidenceScoreType& confidenceScores,
+                       const LabelsType& labels,
+                       OutputType& selectedIndices,
+                       const double threshold = 0.5);
+
+  /**
+   * Performs Soft-NMS with a Gaussian penalty: the bounding box with the
+   * highest score is selected, and the score of each remaining bounding box is
+   * multiplied by exp(-IoU^2 / sigma), until the highest remaining score is
+   * below scoreThreshold.
+   *
+   * @param boundingBoxes Column major representation of bounding boxes.
+   * @param confidenceScores Vector containing confidence score corresponding
+   *                         to each bounding box.
+   * @param selectedIndices Indices of the selected bounding boxes, in the
+   *                        order they were selected (descending order of the
+   *                        decayed scores).
+   * @param selectedScores Decayed score of each selected bounding box.
+   * @param sigma Width of the Gaussian penalty.
+   * @param scoreThreshold Bounding boxes whose decayed score is below this are
+   *                       discarded.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename OutputType
+  >
+  static void SoftEvaluate(const BoundingBoxesType& boundingBoxes,
+                           const ConfidenceScoreType& confidenceScores,
+                           OutputType& selectedIndices,
+                           arma::vec& selectedScores,
+                           const double sigma = 0.5,
+                           const double scoreThreshold = 0.001);
+
   static const bool useCoordinates = UseCoordinates;
 
   //! Serialize the metric.
   template <typename Archive>
   void serialize(Archive &ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Check the sizes of the inputs, and store the coordinates {x1, y1, x2, y2}
+   * and the area of each bounding box in the rows of `boxes`, with the
+   * bounding boxes in the given order.
+   */
+  template<typename BoundingBoxesType, typename ConfidenceScoreType>
+  static void PrepareBoxes(const BoundingBoxesType& boundingBoxes,
+                           const ConfidenceScoreType& confidenceScores,
+                           const arma::uvec& order,
+                           arma::mat& boxes);
+
+  /**
+   * Compute the IoU of the bounding box `i` of `boxes` (as given by
+   * PrepareBoxes()) with the bounding boxes in [begin, end).
+   */
+  static void BatchIoU(const arma::mat& boxes,
+                       const size_t i,
+                       const size_t begin,
+                       const size_t end,
+                       double* ious);
+
+  /**
+   * Performs greedy NMS on the bounding boxes in descending order of score;
+   * if classes is not empty, only bounding boxes of the same class suppress
+   * each other.
+   */
+  template<typename BoundingBoxesType,
+           typename ConfidenceScoreType,
+           typename OutputType>
+  static void Suppress(const BoundingBoxesType& boundingBoxes,
+                       const ConfidenceScoreType& confidenceScores,
+                       const arma::Col<size_t>& classes,
+                       OutputType& selectedIndices,
+                       const double threshold);
 }; // Class NMS.
 
 } // namespace metric
@@ -30,98 +30,225 @@ void NMS<UseCoordinates>::Evaluate(
     OutputType& selectedIndices,
     const double threshold)
 {
-  Log::Assert(boundingBoxes.n_rows == 4, "Bounding boxes must \
-      contain only 4 rows determining coordinates of bounding \
-      box either in {x1, y1, x2, y2} or {x1, y1, h, w} format.\
-      Refer to the documentation for more information.");
-
-  Log::Assert(confidenceScores.n_cols != boundingBoxes.n_cols, "Each \
-      bounding box must correspond to atleast and only 1 bounding box. \
-      Found " + std::to_string(confidenceScores.n_cols) + " confidence \
-      scores for " + std::to_string(boundingBoxes.n_cols) + " bounding boxes.");
-
-  // Clear selected bounding boxes.
-  selectedIndices.clear();
-
-  // Obtain Sorted indices for bounding boxes according to
-  // their confidence scores.
-  arma::ucolvec sortedIndices = arma::sort_index(confidenceScores);
-
-  // Pre-Compute area of each bounding box.
-  arma::mat area;
-  if (UseCoordinates)
-  {
-    area = (boundingBoxes.row(2) - boundingBoxes.row(0)) %
-        (boundingBoxes.row(3) - boundingBoxes.row(1));
-  }
-  else
+  Suppress(boundingBoxes, confidenceScores, arma::Col<size_t>(),
+      selectedIndices, threshold);
+}
+
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename LabelsType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::Evaluate(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    const LabelsType& labels,
+    OutputType& selectedIndices,
+    const double threshold)
+{
+  util::CheckSameSizes(boundingBoxes, (size_t) labels.n_elem,
+      "NMS::Evaluate()", "labels");
+
+  arma::Col<size_t> classes(labels.n_elem);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    classes[i] = (size_t) labels[i];
+
+  Suppress(boundingBoxes, confidenceScores, classes, selectedIndices,
+      threshold);
+}
+
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::SoftEvaluate(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    OutputType& selectedIndices,
+    arma::vec& selectedScores,
+    const double sigma,
+    const double scoreThreshold)
+{
+  if (sigma <= 0.0)
   {
-    area = boundingBoxes.row(2) % boundingBoxes.row(3);
+    Log::Fatal << "NMS::SoftEvaluate(): sigma must be positive!"
+        << std::endl;
   }
 
-  while (sortedIndices.n_elem > 0)
-  {
-    size_t selectedIndex = sortedIndices(sortedIndices.n_elem - 1);
+  const size_t n = boundingBoxes.n_cols;
+  arma::uvec indices(n);
+  for (size_t i = 0; i < n; ++i)
+    indices[i] = i;
 
-    // Choose the box with the largest probability.
-    selectedIndices.insert_rows(0, arma::uvec(1).fill(selectedIndex));
+  arma::mat boxes;
+  PrepareBoxes(boundingBoxes, confidenceScores, indices, boxes);
+  arma::vec scores = arma::conv_to<arma::vec>::from(confidenceScores);
 
-    // Check if there are other bounding boxes to compare with.
-    if (sortedIndices.n_elem == 1)
-    {
+  std::vector<size_t> selected;
+  std::vector<double> selectedScoresList;
+  arma::vec ious(n);
+  // The remaining bounding boxes are kept in [begin, n) of `boxes`, `scores`
+  // and `indices`, so that their IoU can be computed in one loop.
+  for (size_t begin = 0; begin < n; ++begin)
+  {
+    // Move the bounding box with the highest remaining score to the front.
+    const size_t best = begin + scores.subvec(begin, n - 1).index_max();
+    if (scores[best] < scoreThreshold)
       break;
-    }
 
-    // Remove the last index.
-    sortedIndices = sortedIndices(arma::span(0, sortedIndices.n_rows - 2),
-        arma::span());
+    boxes.swap_cols(begin, best);
+    scores.swap_rows(begin, best);
+    indices.swap_rows(begin, best);
+    selected.push_back(indices[begin]);
+    selectedScoresList.push_back(scores[begin]);
 
-    // Get x and y coordinates for remaining bounding boxes.
-    BoundingBoxesType x2 = boundingBoxes.submat(arma::uvec(1).fill(2),
-        sortedIndices);
+    if (begin + 1 == n)
+      break;
 
-    BoundingBoxesType x1 = boundingBoxes.submat(arma::uvec(1).fill(0),
-        sortedIndices);;
+    BatchIoU(boxes, begin, begin + 1, n, ious.memptr());
+    for (size_t j = begin + 1; j < n; ++j)
+      scores[j] *= std::exp(-ious[j - begin - 1] * ious[j - begin - 1] / sigma);
+  }
 
-    BoundingBoxesType y2 = boundingBoxes.submat(arma::uvec(1).fill(3),
-        sortedIndices);
+  selectedIndices.set_size(selected.size());
+  selectedScores.set_size(selected.size());
+  for (size_t i = 0; i < selected.size(); ++i)
+  {
+    selectedIndices[i] = selected[i];
+    selectedScores[i] = selectedScoresList[i];
+  }
+}
 
-    BoundingBoxesType y1 = boundingBoxes.submat(arma::uvec(1).fill(1),
-        sortedIndices);
+template<bool UseCoordinates>
+template<typename BoundingBoxesType, typename ConfidenceScoreType>
+void NMS<UseCoordinates>::PrepareBoxes(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    const arma::uvec& order,
+    arma::mat& boxes)
+{
+  if (boundingBoxes.n_rows != 4)
+  {
+    Log::Fatal << "NMS: bounding boxes must contain only 4 rows determining "
+        << "coordinates of bounding box either in {x1, y1, x2, y2} or "
+        << "{x1, y1, h, w} format; refer to the documentation for more "
+        << "information." << std::endl;
+  }
 
-    size_t selectedX2 = boundingBoxes(2, selectedIndex);
-    size_t selectedY2 = boundingBoxes(3, selectedIndex);
-    size_t selectedX1 = boundingBoxes(0, selectedIndex);
-    size_t selectedY1 = boundingBoxes(1, selectedIndex);
+  util::CheckSameSizes(boundingBoxes, (size_t) confidenceScores.n_elem,
+      "NMS", "confidence scores");
 
+  // Store the bounding boxes as {x1, y1, x2, y2, area}, in the given order.
+  boxes.set_size(5, order.n_elem);
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    const size_t index = order[i];
+    boxes(0, i) = boundingBoxes(0, index);
+    boxes(1, i) = boundingBoxes(1, index);
+    boxes(2, i) = boundingBoxes(2, index);
+    boxes(3, i) = boundingBoxes(3, index);
     if (!UseCoordinates)
     {
       // Change height - width representation to coordinate represention.
-      x2 = x2 + x1;
-      y2 = y2 + y1;
-      selectedX2 = selectedX2 + selectedX1;
-      selectedY2 = selectedY2 + selectedY1;
+      boxes(2, i) += boxes(0, i);
+      boxes(3, i) += boxes(1, i);
     }
 
-    // Calculate points of intersection between the bounding box with
-    // highest confidence score and remaining bounding boxes.
-    x2 = arma::clamp(x2, DBL_MIN, selectedX2);
-    y2 = arma::clamp(y2, DBL_MIN, selectedY2);
-    x1 = arma::clamp(x1, selectedX1, DBL_MAX);
-    y1 = arma::clamp(y1, selectedY1, DBL_MAX);
+    boxes(4, i) = (boxes(2, i) - boxes(0, i)) * (boxes(3, i) - boxes(1, i));
+  }
+}
 
-    BoundingBoxesType intersectionArea = arma::clamp(x2 - x1, 0.0, DBL_MAX) %
-          arma::clamp(y2 - y1, 0.0, DBL_MAX);
+template<bool UseCoordinates>
+void NMS<UseCoordinates>::BatchIoU(const arma::mat& boxes,
+                                   const size_t i,
+                                   const size_t begin,
+                                   const size_t end,
+                                   double* ious)
+{
+  const double x1 = boxes(0, i);
+  const double y1 = boxes(1, i);
+  const double x2 = boxes(2, i);
+  const double y2 = boxes(3, i);
+  const double area = boxes(4, i);
 
-    // Calculate IoU of remaining boxes with the last bounding box with
-    // the highest confidence score.
-    BoundingBoxesType calculateIoU = intersectionArea /
-        (area(sortedIndices).t() - intersectionArea + area(selectedIndex));
+  // The boxes are columns of 5 contiguous values; this loop has no branches,
+  // so that it can be vectorized.
+  const double* box = boxes.colptr(begin);
+  for (size_t j = 0; j < end - begin; ++j, box += 5)
+  {
+    const double width = std::max(std::min(x2, box[2]) -
+        std::max(x1, box[0]), 0.0);
+    const double height = std::max(std::min(y2, box[3]) -
+        std::max(y1, box[1]), 0.0);
+    const double intersection = width * height;
+    ious[j] = intersection / (area + box[4] - intersection);
+  }
+}
 
-    sortedIndices = sortedIndices(arma::find(calculateIoU <= threshold));
+template<bool UseCoordinates>
+template<typename BoundingBoxesType,
+         typename ConfidenceScoreType,
+         typename OutputType>
+void NMS<UseCoordinates>::Suppress(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    const arma::Col<size_t>& classes,
+    OutputType& selectedIndices,
+    const double threshold)
+{
+  // Obtain sorted indices for bounding boxes according to their confidence
+  // scores, and store the bounding boxes in that order.
+  const arma::uvec sortedIndices = arma::stable_sort_index(
+      arma::conv_to<arma::vec>::from(confidenceScores), "descend");
+  arma::mat boxes;
+  PrepareBoxes(boundingBoxes, confidenceScores, sortedIndices, boxes);
+
+  const size_t n = sortedIndices.n_elem;
+  arma::Col<size_t> sortedClasses;
+  if (!classes.is_empty())
+    sortedClasses = classes.elem(sortedIndices);
+
+  // suppressed[j] is nonzero if the j'th bounding box (in sorted order) has
+  // been suppressed.
+  std::vector<unsigned char> suppressed(n, 0);
+  std::vector<size_t> selected;
+  arma::vec ious(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (suppressed[i])
+      continue;
+
+    // Choose the box with the largest probability.
+    selected.push_back(sortedIndices[i]);
+    if (i + 1 == n)
+      break;
+
+    // Calculate IoU of remaining boxes with the selected box, and suppress
+    // the ones that overlap it too much.
+    BatchIoU(boxes, i, i + 1, n, ious.memptr());
+    if (sortedClasses.is_empty())
+    {
+      for (size_t j = i + 1; j < n; ++j)
+        suppressed[j] |= (ious[j - i - 1] > threshold);
+    }
+    else
+    {
+      const size_t cls = sortedClasses[i];
+      for (size_t j = i + 1; j < n; ++j)
+      {
+        suppressed[j] |= ((ious[j - i - 1] > threshold) &
+            (sortedClasses[j] == cls));
+      }
+    }
   }
 
-  selectedIndices = arma::flipud(selectedIndices);
+  selectedIndices.set_size(selected.size());
+  for (size_t i = 0; i < selected.size(); ++i)
+    selectedIndices[i] = selected[i];
 }
 
 template<bool UseCoordinates>
@@ -0,0 +1,63 @@
+/**
+ * @file core/tree/base_case_range.hpp
+ *
+ * Definition of the BaseCaseRange() function, which evaluates the base cases
+ * between one query point and a contiguous range of reference points.  Rules
+ * classes may implement a BaseCaseRange() method to evaluate the whole range at
+ * once; otherwise, BaseCase() is called for every pair.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BASE_CASE_RANGE_HPP
+#define MLPACK_CORE_TREE_BASE_CASE_RANGE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+// This gives us a HasBaseCaseRange<T> type, where HasBaseCaseRange<T>::value
+// is true if the rules class T has a BaseCaseRange() method.
+HAS_ANY_METHOD_FORM(BaseCaseRange, HasBaseCaseRange);
+
+/**
+ * Evaluate the base cases between the given query point and the reference
+ * points in [referenceBegin, referenceEnd), using the BaseCaseRange() method of
+ * the rules.
+ */
+template<typename RuleType>
+inline force_inline
+typename std::enable_if_t<HasBaseCaseRange<RuleType>::value>
+BaseCaseRange(RuleType& rule,
+              const size_t queryIndex,
+              const size_t referenceBegin,
+              const size_t referenceEnd)
+{
+  rule.BaseCaseRange(queryIndex, referenceBegin, referenceEnd);
+}
+
+/**
+ * Evaluate the base cases between the given query point and the reference
+ * points in [referenceBegin, referenceEnd), one pair at a time, for rules
+ * without a BaseCaseRange() method.
+ */
+template<typename RuleType>
+inline force_inline
+typename std::enable_if_t<!HasBaseCaseRange<RuleType>::value>
+BaseCaseRange(RuleType& rule,
+              const size_t queryIndex,
+              const size_t referenceBegin,
+              const size_t referenceEnd)
+{
+  for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+    rule.BaseCase(queryIndex, ref);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
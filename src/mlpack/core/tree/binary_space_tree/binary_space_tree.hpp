@@ -12,9 +12,12 @@
 #define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BINARY_SPACE_TREE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <map>
 
 #include "../statistic.hpp"
+#include "../node_pool.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -25,9 +28,10 @@ namespace tree /** Trees and tree-building procedures. */ {
  * the constructor with the dataset to build the tree on, and the entire tree
  * will be built.
  *
- * This particular tree does not allow growth, so you cannot add or delete nodes
- * from it.  If you need to add or delete a node, the better procedure is to
- * rebuild the tree entirely.
+ * Points can be added to the tree with InsertPoints() and removed from it with
+ * RemovePoints() without rebuilding it, but the tree may then be less balanced
+ * (and its bounds looser) than a tree built on the new points; if many points
+ * change, the better procedure is to rebuild the tree entirely.
  *
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
@@ -315,6 +319,14 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  //! Allocate nodes from a NodePool, so that nodes are contiguous in memory.
+  static void* operator new(size_t size)
+  { return NodePool<BinarySpaceTree>::Allocate(size); }
+
+  //! Return the memory of a node to its NodePool.
+  static void operator delete(void* p, size_t size)
+  { NodePool<BinarySpaceTree>::Deallocate(p, size); }
+
   //! Return the bound object for this node.
   const BoundType<MetricType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -507,6 +519,51 @@ class BinarySpaceTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) const { bound.Center(center); }
 
+  /**
+   * Recompute the bounds, the furthest descendant distances, the parent
+   * distances and the statistics of this node and all of its descendants from
+   * the points they hold.  Call this after points of the dataset have been
+   * modified in place: each node keeps the same points, so the tree stays
+   * valid, but it may be less balanced than a tree built on the new points.
+   */
+  void RefitBounds();
+
+  /**
+   * Insert the given points into the tree, without rebuilding it.  This can
+   * only be called on the root.  Each point is added to the leaf reached by
+   * descending into the nearest child (by MinDistance()); the points of the
+   * dataset after that leaf move to make room for it.  Only the nodes that
+   * receive points have their bounds, distances and statistics updated, and
+   * the leaves that then hold more than maxLeafSize points are split (unless
+   * the split type cannot split a node on its own; see SplitTraits).
+   *
+   * @param points Points to insert.
+   * @param oldFromNew Mapping from the positions of the points in the dataset
+   *     to their original indices (with one element for each point of the
+   *     dataset), which is updated.  The new points get the original indices
+   *     oldFromNew.size(), oldFromNew.size() + 1, and so on.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void InsertPoints(const MatType& points,
+                    std::vector<size_t>& oldFromNew,
+                    const size_t maxLeafSize = 20);
+
+  /**
+   * Remove the points at the given positions of the dataset from the tree,
+   * without rebuilding it.  This can only be called on the root.  The removed
+   * points are moved after all the points of the tree, so that they stay in
+   * the dataset (which then has more columns than the root has points), but
+   * no node holds them; the other points keep their order.  The bounds are not
+   * shrunk, so they stay valid but may be looser than needed.  An exception is
+   * thrown if a position does not hold a point of the tree.
+   *
+   * @param positions Positions in the dataset of the points to remove.
+   * @param oldFromNew Mapping from the positions of the points in the dataset
+   *     to their original indices, which is updated.
+   */
+  void RemovePoints(const arma::Col<size_t>& positions,
+                    std::vector<size_t>& oldFromNew);
+
  private:
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -529,6 +586,48 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Split the root node.  If OpenMP is enabled and the splitter can be shared
+   * between threads (see SplitTraits), the top of the tree is split serially
+   * until there are enough subtrees to keep every thread busy, and then those
+   * subtrees are built in parallel.  Otherwise this is the same as SplitNode().
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if they are not
+   *     needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void SplitRoot(std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize,
+                 SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Split the current node, but not its children: they only receive their
+   * points, and must be split with SplitNode() afterwards.  The parent
+   * distances of the children are not computed.  Returns false if the node
+   * is a leaf.
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if they are not
+   *     needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  bool SplitNodeShallow(std::vector<size_t>* oldFromNew,
+                        const size_t maxLeafSize,
+                        SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Construct a child of the given parent holding the given points, without
+   * splitting it.  The bound is empty and the statistic is not built.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point held by this node.
+   * @param count Number of points held by this node.
+   */
+  BinarySpaceTree(BinarySpaceTree* parent,
+                  const size_t begin,
+                  const size_t count);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -546,6 +645,27 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Move this node and its descendants after the points inserted before them
+   * by InsertPoints(), add the new points to the leaves, and update the nodes
+   * that received points.  Returns the number of points added to this node.
+   *
+   * @param offset Number of points inserted before this node.
+   * @param newPoints New points of each leaf that receives points.
+   * @param addedPoints New points added below this node so far; the new
+   *     points of this node are appended.
+   * @param oldFromNew Mapping from positions to original indices.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  size_t AddInsertedPoints(
+      const size_t offset,
+      const std::map<const BinarySpaceTree*, MatType>& newPoints,
+      std::vector<const MatType*>& addedPoints,
+      std::vector<size_t>& oldFromNew,
+      const size_t maxLeafSize,
+      SplitType<BoundType<MetricType>, MatType>& splitter);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -16,6 +16,11 @@
 
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <stack>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace tree {
@@ -43,7 +48,7 @@ BinarySpaceTree(
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitRoot(NULL, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -76,7 +81,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -110,7 +115,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -140,7 +145,7 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitRoot(NULL, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -173,7 +178,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -207,7 +212,7 @@ BinarySpaceTree(
 
   // Now do the actual splitting.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitRoot(&oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -318,6 +323,30 @@ BinarySpaceTree(
     newFromOld[oldFromNew[i]] = i;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree* parent,
+    const size_t begin,
+    const size_t count) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(begin),
+    count(count),
+    bound(parent->Dataset().n_rows),
+    parentDistance(0),
+    furthestDescendantDistance(0),
+    dataset(&parent->Dataset())
+{
+  // Nothing to do: the node is split later.
+}
+
 /**
  * Create a binary space tree by copying the other tree.  Be careful!  This can
  * take a long time and use a lot of memory.
@@ -992,6 +1021,450 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitRoot(std::vector<size_t>* oldFromNew,
+          const size_t maxLeafSize,
+          SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  // Small trees are not worth the overhead.
+  const bool parallel = SplitTraits<Split>::ThreadSafe && (numThreads > 1) &&
+      (count >= 10000) && (count > 8 * numThreads * maxLeafSize);
+  #else
+  const bool parallel = false;
+  #endif
+
+  if (!parallel)
+  {
+    if (oldFromNew)
+      SplitNode(*oldFromNew, maxLeafSize, splitter);
+    else
+      SplitNode(maxLeafSize, splitter);
+    return;
+  }
+
+  #ifdef HAS_OPENMP
+  // Split the top of the tree serially until all the unsplit nodes are small
+  // enough that there are several of them per thread, so that the dynamic
+  // schedule can balance the load.
+  const size_t maxSubtreeSize = count / (4 * numThreads);
+  std::vector<BinarySpaceTree*> topNodes;
+  std::vector<BinarySpaceTree*> subtrees;
+  std::stack<BinarySpaceTree*> stack;
+
+  UpdateBound(bound);
+  stack.push(this);
+  while (!stack.empty())
+  {
+    BinarySpaceTree* node = stack.top();
+    stack.pop();
+
+    if (node->count <= maxSubtreeSize)
+    {
+      subtrees.push_back(node);
+      continue;
+    }
+
+    topNodes.push_back(node);
+    if (node->SplitNodeShallow(oldFromNew, maxLeafSize, splitter))
+    {
+      stack.push(node->right);
+      stack.push(node->left);
+    }
+  }
+
+  // The subtrees hold disjoint ranges of points, so they can be built in
+  // parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    if (oldFromNew)
+      subtrees[i]->SplitNode(*oldFromNew, maxLeafSize, splitter);
+    else
+      subtrees[i]->SplitNode(maxLeafSize, splitter);
+
+    subtrees[i]->stat = StatisticType(*subtrees[i]);
+  }
+
+  // Now build the statistics of the top nodes, children first.  The statistic
+  // of the root is built by the constructor.
+  for (size_t i = topNodes.size() - 1; i > 0; --i)
+    topNodes[i]->stat = StatisticType(*topNodes[i]);
+  #endif
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitNodeShallow(std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize,
+                 SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // The bound of this node has already been computed, either by SplitRoot() or
+  // by the call for the parent.
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (count <= maxLeafSize)
+    return false;
+
+  typename Split::SplitInfo splitInfo;
+  if (!splitter.SplitNode(bound, *dataset, begin, count, splitInfo))
+    return false;
+
+  const size_t splitCol = (oldFromNew == NULL) ?
+      splitter.PerformSplit(*dataset, begin, count, splitInfo) :
+      splitter.PerformSplit(*dataset, begin, count, splitInfo, *oldFromNew);
+
+  assert(splitCol > begin);
+  assert(splitCol < begin + count);
+
+  left = new BinarySpaceTree(this, begin, splitCol - begin);
+  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol);
+
+  // The left bound must be computed first, in case the right bound depends on
+  // it (i.e. for hollow ball bounds).
+  left->UpdateBound(left->bound);
+  right->UpdateBound(right->bound);
+
+  // Calculate parent distances for those two nodes.
+  arma::vec center, leftCenter, rightCenter;
+  Center(center);
+  left->Center(leftCenter);
+  right->Center(rightCenter);
+
+  left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+  right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+
+  return true;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+RefitBounds()
+{
+  // The left child must be refit first, in case the bound of the right child
+  // depends on it (i.e. for hollow ball bounds).
+  if (left)
+    left->RefitBounds();
+  if (right)
+    right->RefitBounds();
+
+  bound = BoundType<MetricType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left)
+  {
+    arma::vec center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+    right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+  }
+
+  // The children are done, so the statistic can be built.
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+InsertPoints(const MatType& points,
+             std::vector<size_t>& oldFromNew,
+             const size_t maxLeafSize)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::InsertPoints(): points can "
+        "only be inserted at the root of the tree");
+  }
+
+  if (points.n_cols == 0)
+    return;
+
+  if (points.n_rows != dataset->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "BinarySpaceTree::InsertPoints(): dimensionality of new points ("
+        << points.n_rows << ") does not match dimensionality of the dataset ("
+        << dataset->n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (oldFromNew.size() != dataset->n_cols)
+  {
+    throw std::invalid_argument("BinarySpaceTree::InsertPoints(): the mapping "
+        "must hold one index for each point of the dataset");
+  }
+
+  // Find the leaf of each new point.
+  std::map<const BinarySpaceTree*, std::vector<size_t>> leafPoints;
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const BinarySpaceTree* node = this;
+    while (!node->IsLeaf())
+    {
+      node = (node->left->MinDistance(points.col(i)) <=
+          node->right->MinDistance(points.col(i))) ? node->left : node->right;
+    }
+
+    leafPoints[node].push_back(i);
+  }
+
+  // Build the new dataset: the new points of each leaf go right after its old
+  // points.  The leaves are visited in order, so that their ranges follow each
+  // other.
+  const size_t oldCols = dataset->n_cols;
+  MatType newDataset(dataset->n_rows, oldCols + points.n_cols);
+  std::vector<size_t> newOldFromNew(oldCols + points.n_cols);
+  std::map<const BinarySpaceTree*, MatType> newPoints;
+  size_t source = 0;
+  size_t dest = 0;
+
+  std::stack<const BinarySpaceTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    const BinarySpaceTree* node = stack.top();
+    stack.pop();
+
+    if (!node->IsLeaf())
+    {
+      stack.push(node->right);
+      stack.push(node->left);
+      continue;
+    }
+
+    typename std::map<const BinarySpaceTree*, std::vector<size_t>>::
+        const_iterator it = leafPoints.find(node);
+    if (it == leafPoints.end())
+      continue;
+
+    // Copy the old points up to the end of the leaf.
+    const size_t end = node->begin + node->count;
+    if (end > source)
+    {
+      newDataset.cols(dest, dest + (end - source) - 1) =
+          dataset->cols(source, end - 1);
+      std::copy(oldFromNew.begin() + source, oldFromNew.begin() + end,
+          newOldFromNew.begin() + dest);
+      dest += end - source;
+      source = end;
+    }
+
+    const arma::uvec indices = arma::conv_to<arma::uvec>::from(it->second);
+    MatType& leafNewPoints = newPoints[node];
+    leafNewPoints = points.cols(indices);
+    newDataset.cols(dest, dest + indices.n_elem - 1) = leafNewPoints;
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      newOldFromNew[dest + i] = oldCols + indices[i];
+    dest += indices.n_elem;
+  }
+
+  // The rest of the points (including the points removed by RemovePoints()).
+  if (source < oldCols)
+  {
+    newDataset.cols(dest, dest + (oldCols - source) - 1) =
+        dataset->cols(source, oldCols - 1);
+    std::copy(oldFromNew.begin() + source, oldFromNew.end(),
+        newOldFromNew.begin() + dest);
+  }
+
+  *dataset = std::move(newDataset);
+  oldFromNew.swap(newOldFromNew);
+
+  // Now move the nodes, and update the ones that received points.
+  SplitType<BoundType<MetricType>, MatType> splitter;
+  std::vector<const MatType*> addedPoints;
+  AddInsertedPoints(0, newPoints, addedPoints, oldFromNew, maxLeafSize,
+      splitter);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+    SplitType>::AddInsertedPoints(
+    const size_t offset,
+    const std::map<const BinarySpaceTree*, MatType>& newPoints,
+    std::vector<const MatType*>& addedPoints,
+    std::vector<size_t>& oldFromNew,
+    const size_t maxLeafSize,
+    SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  begin += offset;
+
+  if (IsLeaf())
+  {
+    typename std::map<const BinarySpaceTree*, MatType>::const_iterator it =
+        newPoints.find(this);
+    if (it == newPoints.end())
+      return 0;
+
+    count += it->second.n_cols;
+    addedPoints.push_back(&it->second);
+    bound |= it->second;
+    furthestDescendantDistance = 0.5 * bound.Diameter();
+
+    // Split the leaf if it became too large (and the splitter can split it on
+    // its own); this also builds the statistics of the children.
+    if (count > maxLeafSize && SplitTraits<Split>::LocalSplits)
+      SplitNode(oldFromNew, maxLeafSize, splitter);
+
+    stat = StatisticType(*this);
+    return it->second.n_cols;
+  }
+
+  const size_t firstAdded = addedPoints.size();
+  const size_t leftAdded = left->AddInsertedPoints(offset, newPoints,
+      addedPoints, oldFromNew, maxLeafSize, splitter);
+  const size_t rightAdded = right->AddInsertedPoints(offset + leftAdded,
+      newPoints, addedPoints, oldFromNew, maxLeafSize, splitter);
+  if (leftAdded + rightAdded == 0)
+    return 0;
+
+  // Grow the bound to hold the new points of the children.
+  count += leftAdded + rightAdded;
+  for (size_t i = firstAdded; i < addedPoints.size(); ++i)
+    bound |= *addedPoints[i];
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  arma::vec center, leftCenter, rightCenter;
+  Center(center);
+  left->Center(leftCenter);
+  right->Center(rightCenter);
+
+  left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+  right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+
+  stat = StatisticType(*this);
+  return leftAdded + rightAdded;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+RemovePoints(const arma::Col<size_t>& positions,
+             std::vector<size_t>& oldFromNew)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::RemovePoints(): points can "
+        "only be removed at the root of the tree");
+  }
+
+  if (oldFromNew.size() != dataset->n_cols)
+  {
+    throw std::invalid_argument("BinarySpaceTree::RemovePoints(): the mapping "
+        "must hold one index for each point of the dataset");
+  }
+
+  if (positions.n_elem == 0)
+    return;
+
+  // The points of the tree are the first count points of the dataset.
+  std::vector<bool> removed(count, false);
+  for (size_t i = 0; i < positions.n_elem; ++i)
+  {
+    if (positions[i] >= count || removed[positions[i]])
+    {
+      std::ostringstream oss;
+      oss << "BinarySpaceTree::RemovePoints(): the point at position "
+          << positions[i] << " is not in the tree!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    removed[positions[i]] = true;
+  }
+
+  // The kept points of the tree come first, then the removed points, then the
+  // points that were removed before.  keptBefore[p] is the number of kept
+  // points before position p.
+  arma::uvec order(dataset->n_cols);
+  std::vector<size_t> keptBefore(count + 1, 0);
+  size_t next = 0;
+  for (size_t p = 0; p < count; ++p)
+  {
+    keptBefore[p + 1] = keptBefore[p] + (removed[p] ? 0 : 1);
+    if (!removed[p])
+      order[next++] = p;
+  }
+  for (size_t p = 0; p < count; ++p)
+  {
+    if (removed[p])
+      order[next++] = p;
+  }
+  for (size_t p = count; p < dataset->n_cols; ++p)
+    order[next++] = p;
+
+  *dataset = dataset->cols(order);
+  std::vector<size_t> newOldFromNew(oldFromNew.size());
+  for (size_t i = 0; i < order.n_elem; ++i)
+    newOldFromNew[i] = oldFromNew[order[i]];
+  oldFromNew.swap(newOldFromNew);
+
+  // Now move the nodes.  The bounds stay valid, but the statistics of the
+  // nodes that lost points are built again.
+  std::stack<BinarySpaceTree*> stack;
+  std::vector<BinarySpaceTree*> changed;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    BinarySpaceTree* node = stack.top();
+    stack.pop();
+
+    const size_t newBegin = keptBefore[node->begin];
+    const size_t newCount = keptBefore[node->begin + node->count] - newBegin;
+    if (newBegin == node->begin && newCount == node->count)
+      continue;
+
+    if (newCount != node->count)
+      changed.push_back(node);
+    node->begin = newBegin;
+    node->count = newCount;
+
+    if (!node->IsLeaf())
+    {
+      stack.push(node->left);
+      stack.push(node->right);
+    }
+  }
+
+  // The children are visited after their parents, so the statistics are built
+  // in the reverse order.
+  for (size_t i = changed.size(); i > 0; --i)
+    changed[i - 1]->stat = StatisticType(*changed[i - 1]);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -1065,7 +1538,7 @@ template<typename MetricType,
              class SplitType>
 template<typename Archive>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-    serialize(Archive& ar, const uint32_t /* version */)
+    serialize(Archive& ar, const uint32_t version)
 {
   // If we're loading, and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
@@ -1082,56 +1555,205 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     right = NULL;
   }
 
-  ar(CEREAL_NVP(begin));
-  ar(CEREAL_NVP(count));
-  ar(CEREAL_NVP(bound));
-  ar(CEREAL_NVP(stat));
-
-  ar(CEREAL_NVP(parentDistance));
-  ar(CEREAL_NVP(furthestDescendantDistance));
+  // Older versions stored each node recursively, one level of the archive per
+  // level of the tree.
+  if (version == 0)
+  {
+    ar(CEREAL_NVP(begin));
+    ar(CEREAL_NVP(count));
+    ar(CEREAL_NVP(bound));
+    ar(CEREAL_NVP(stat));
+
+    ar(CEREAL_NVP(parentDistance));
+    ar(CEREAL_NVP(furthestDescendantDistance));
+
+    // Save children last.
+    bool hasLeft = (left != NULL);
+    bool hasRight = (right != NULL);
+    bool hasParent = (parent != NULL);
+
+    ar(CEREAL_NVP(hasLeft));
+    ar(CEREAL_NVP(hasRight));
+    ar(CEREAL_NVP(hasParent));
+    if (hasLeft)
+      ar(CEREAL_POINTER(left));
+    if (hasRight)
+      ar(CEREAL_POINTER(right));
+    if (!hasParent)
+    {
+      MatType*& datasetTemp = const_cast<MatType*&>(dataset);
+      ar(CEREAL_POINTER(datasetTemp));
+    }
 
-  // Save children last.
-  bool hasLeft = (left != NULL);
-  bool hasRight = (right != NULL);
-  bool hasParent = (parent != NULL);
+    if (cereal::is_loading<Archive>())
+    {
+      if (left)
+        left->parent = this;
+      if (right)
+        right->parent = this;
+    }
+    // If we are the root, we need to restore the dataset pointer throughout
+    if (!hasParent)
+    {
+      std::stack<BinarySpaceTree*> stack;
+      if (left)
+        stack.push(left);
+      if (right)
+        stack.push(right);
+      while (!stack.empty())
+      {
+        BinarySpaceTree* node = stack.top();
+        stack.pop();
+        node->dataset = dataset;
+        if (node->left)
+          stack.push(node->left);
+        if (node->right)
+         stack.push(node->right);
+      }
+    }
 
-  ar(CEREAL_NVP(hasLeft));
-  ar(CEREAL_NVP(hasRight));
-  ar(CEREAL_NVP(hasParent));
-  if (hasLeft)
-    ar(CEREAL_POINTER(left));
-  if (hasRight)
-    ar(CEREAL_POINTER(right));
-  if (!hasParent)
-  {
-    MatType*& datasetTemp = const_cast<MatType*&>(dataset);
-    ar(CEREAL_POINTER(datasetTemp));
+    return;
   }
 
-  if (cereal::is_loading<Archive>())
-  {
-    if (left)
-      left->parent = this;
-    if (right)
-      right->parent = this;
-  }
-  // If we are the root, we need to restore the dataset pointer throughout
-  if (!hasParent)
+  // The whole subtree is stored as flat lists of node properties in preorder,
+  // so that no recursion (and no nested archive object) is needed per node.
+  // Bit 0 of each entry of 'children' is set if the node has a left child, and
+  // bit 1 if it has a right child.
+  std::vector<BinarySpaceTree*> nodes;
+  std::vector<size_t> begins;
+  std::vector<size_t> counts;
+  std::vector<ElemType> parentDistances;
+  std::vector<ElemType> furthestDistances;
+  std::vector<uint8_t> children;
+
+  if (cereal::is_saving<Archive>())
   {
     std::stack<BinarySpaceTree*> stack;
-    if (left)
-      stack.push(left);
-    if (right)
-      stack.push(right);
+    stack.push(this);
     while (!stack.empty())
     {
       BinarySpaceTree* node = stack.top();
       stack.pop();
-      node->dataset = dataset;
+
+      nodes.push_back(node);
+      begins.push_back(node->begin);
+      counts.push_back(node->count);
+      parentDistances.push_back(node->parentDistance);
+      furthestDistances.push_back(node->furthestDescendantDistance);
+      children.push_back((node->left ? 1 : 0) | (node->right ? 2 : 0));
+
+      // Push the right child first so that the left subtree comes first.
+      if (node->right)
+        stack.push(node->right);
       if (node->left)
         stack.push(node->left);
-      if (node->right)
-       stack.push(node->right);
+    }
+  }
+
+  ar(CEREAL_NVP(begins));
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(parentDistances));
+  ar(CEREAL_NVP(furthestDistances));
+  ar(CEREAL_NVP(children));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (children.empty() || begins.size() != children.size() ||
+        counts.size() != children.size() ||
+        parentDistances.size() != children.size() ||
+        furthestDistances.size() != children.size())
+    {
+      throw std::runtime_error("BinarySpaceTree::serialize(): invalid tree "
+          "structure in archive!");
+    }
+
+    // Find the parent of each node, and whether it is a left child.  Each
+    // node on the stack still needs at least one of its children.  This is
+    // checked before any node is allocated, so that an invalid archive does
+    // not leave a partial tree behind.
+    std::vector<size_t> parents(children.size());
+    std::vector<bool> isLeft(children.size(), false);
+    std::vector<bool> hasLeft(children.size(), false);
+    std::stack<size_t> stack;
+    if (children[0] != 0)
+      stack.push(0);
+    for (size_t i = 1; i < children.size(); ++i)
+    {
+      if (stack.empty())
+      {
+        throw std::runtime_error("BinarySpaceTree::serialize(): invalid tree "
+            "structure in archive!");
+      }
+
+      const size_t p = stack.top();
+      parents[i] = p;
+      if ((children[p] & 1) && !hasLeft[p])
+      {
+        isLeft[i] = true;
+        hasLeft[p] = true;
+        if (!(children[p] & 2))
+          stack.pop();
+      }
+      else
+      {
+        stack.pop();
+      }
+
+      if (children[i] != 0)
+        stack.push(i);
+    }
+
+    if (!stack.empty())
+    {
+      throw std::runtime_error("BinarySpaceTree::serialize(): invalid tree "
+          "structure in archive!");
+    }
+
+    // All the nodes below this one are built in one contiguous block of the
+    // NodePool, in preorder, so that loading a tree performs a single
+    // allocation for its nodes and traversals walk forward in memory.
+    std::vector<void*> memory;
+    NodePool<BinarySpaceTree>::AllocateContiguous(children.size() - 1,
+        memory);
+    nodes.resize(children.size());
+    nodes[0] = this;
+    for (size_t i = 1; i < children.size(); ++i)
+    {
+      nodes[i] = ::new (memory[i - 1]) BinarySpaceTree();
+      nodes[i]->parent = nodes[parents[i]];
+      if (isLeft[i])
+        nodes[parents[i]]->left = nodes[i];
+      else
+        nodes[parents[i]]->right = nodes[i];
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodes[i]->begin = begins[i];
+      nodes[i]->count = counts[i];
+      nodes[i]->parentDistance = parentDistances[i];
+      nodes[i]->furthestDescendantDistance = furthestDistances[i];
+    }
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    ar(nodes[i]->bound);
+    ar(nodes[i]->stat);
+  }
+
+  bool hasParent = (parent != NULL);
+  ar(CEREAL_NVP(hasParent));
+  if (!hasParent)
+  {
+    MatType*& datasetTemp = const_cast<MatType*&>(dataset);
+    ar(CEREAL_POINTER(datasetTemp));
+
+    // Restore the dataset pointer throughout the tree.
+    if (cereal::is_loading<Archive>())
+    {
+      for (size_t i = 1; i < nodes.size(); ++i)
+        nodes[i]->dataset = dataset;
     }
   }
 }
@@ -1139,4 +1761,14 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 } // namespace tree
 } // namespace mlpack
 
+// Since version 1, the tree is stored as flat lists of node properties.
+CEREAL_TEMPLATE_CLASS_VERSION((template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    template<typename BoundMetricType, typename...> class BoundType,
+    template<typename SplitBoundType, typename SplitMatType> class SplitType>),
+    (mlpack::tree::BinarySpaceTree<MetricType, StatisticType, MatType,
+    BoundType, SplitType>), (1));
+
 #endif
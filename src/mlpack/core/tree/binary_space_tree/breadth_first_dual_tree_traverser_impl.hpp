@@ -16,6 +16,8 @@
 
 // In case it hasn't been included yet.
 #include "breadth_first_dual_tree_traverser.hpp"
+#include "../base_case_range.hpp"
+#include "../traversal_statistics.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -123,9 +125,12 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     if (score == DBL_MAX)
     {
       ++numPrunes;
+      TraversalStatistics::RecordPrune(referenceNode);
       continue;
     }
 
+    TraversalStatistics::RecordVisit(referenceNode);
+
     // If both are leaves, we must evaluate the base case.
     if (queryNode.IsLeaf() && referenceNode.IsLeaf())
     {
@@ -142,10 +147,11 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
 //        if (childScore == DBL_MAX)
 //          continue; // We can't improve this particular point.
 
-        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-          rule.BaseCase(query, ref);
+        BaseCaseRange(rule, query, referenceNode.Begin(), refEnd);
 
         numBaseCases += referenceNode.Count();
+        TraversalStatistics::RecordBaseCases(referenceNode,
+            referenceNode.Count());
       }
     }
     else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
@@ -16,6 +16,9 @@
 
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
+#include "../base_case_range.hpp"
+#include "../prefetch.hpp"
+#include "../traversal_statistics.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -50,8 +53,11 @@ DualTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
         referenceNode)
 {
+  MLPACK_PROFILE_SCOPE("binary_space_tree_dual_tree_traversal");
+
   // Increment the visit counter.
   ++numVisited;
+  TraversalStatistics::RecordVisit(referenceNode);
 
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
@@ -64,6 +70,7 @@ DualTreeTraverser<RuleType>::Traverse(
     if (rootScore == DBL_MAX)
     {
       ++numPrunes;
+      TraversalStatistics::RecordPrune(referenceNode);
       return;
     }
   }
@@ -85,10 +92,11 @@ DualTreeTraverser<RuleType>::Traverse(
       if (childScore == DBL_MAX)
         continue; // We can't improve this particular point.
 
-      for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-        rule.BaseCase(query, ref);
+      BaseCaseRange(rule, query, referenceNode.Begin(), refEnd);
 
       numBaseCases += referenceNode.Count();
+      TraversalStatistics::RecordBaseCases(referenceNode,
+          referenceNode.Count());
     }
   }
   else if (((!queryNode.IsLeaf()) && referenceNode.IsLeaf()) ||
@@ -96,14 +104,23 @@ DualTreeTraverser<RuleType>::Traverse(
             !queryNode.IsLeaf() && !referenceNode.IsLeaf()))
   {
     // We have to recurse down the query node.  In this case the recursion order
-    // does not matter.
+    // does not matter.  Both children are requested from memory first, so that
+    // the loads overlap.
+    PrefetchNode(*queryNode.Left());
+    PrefetchNode(*queryNode.Right());
+
     const double leftScore = rule.Score(*queryNode.Left(), referenceNode);
     ++numScores;
 
     if (leftScore != DBL_MAX)
+    {
       Traverse(*queryNode.Left(), referenceNode);
+    }
     else
+    {
       ++numPrunes;
+      TraversalStatistics::RecordPrune(referenceNode);
+    }
 
     // Before recursing, we have to set the traversal information correctly.
     rule.TraversalInfo() = traversalInfo;
@@ -111,15 +128,24 @@ DualTreeTraverser<RuleType>::Traverse(
     ++numScores;
 
     if (rightScore != DBL_MAX)
+    {
       Traverse(*queryNode.Right(), referenceNode);
+    }
     else
+    {
       ++numPrunes;
+      TraversalStatistics::RecordPrune(referenceNode);
+    }
   }
   else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
   {
     // We have to recurse down the reference node.  In this case the recursion
     // order does matter.  Before recursing, though, we have to set the
-    // traversal information correctly.
+    // traversal information correctly.  Both children are requested from
+    // memory first, so that the loads overlap.
+    PrefetchNode(*referenceNode.Left());
+    PrefetchNode(*referenceNode.Right());
+
     double leftScore = rule.Score(queryNode, *referenceNode.Left());
     typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
     rule.TraversalInfo() = traversalInfo;
@@ -144,7 +170,10 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(queryNode, *referenceNode.Right());
       }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Right());
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -161,13 +190,17 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(queryNode, *referenceNode.Left());
       }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Left());
+      }
     }
     else // leftScore is equal to rightScore.
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2;
+        TraversalStatistics::RecordPrune(*referenceNode.Left(), 2);
       }
       else
       {
@@ -187,7 +220,10 @@ DualTreeTraverser<RuleType>::Traverse(
           Traverse(queryNode, *referenceNode.Right());
         }
         else
+        {
           ++numPrunes;
+          TraversalStatistics::RecordPrune(*referenceNode.Right());
+        }
       }
     }
   }
@@ -196,7 +232,13 @@ DualTreeTraverser<RuleType>::Traverse(
     // We have to recurse down both query and reference nodes.  Because the
     // query descent order does not matter, we will go to the left query child
     // first.  Before recursing, we have to set the traversal information
-    // correctly.
+    // correctly.  All four children are requested from memory first, so that
+    // the loads overlap.
+    PrefetchNode(*queryNode.Left());
+    PrefetchNode(*queryNode.Right());
+    PrefetchNode(*referenceNode.Left());
+    PrefetchNode(*referenceNode.Right());
+
     double leftScore = rule.Score(*queryNode.Left(), *referenceNode.Left());
     typename RuleType::TraversalInfoType leftInfo = rule.TraversalInfo();
     rule.TraversalInfo() = traversalInfo;
@@ -223,7 +265,10 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Left(), *referenceNode.Right());
       }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Right());
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -241,13 +286,17 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Left(), *referenceNode.Left());
       }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Left());
+      }
     }
     else
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2;
+        TraversalStatistics::RecordPrune(*referenceNode.Left(), 2);
       }
       else
       {
@@ -268,7 +317,10 @@ DualTreeTraverser<RuleType>::Traverse(
           Traverse(*queryNode.Left(), *referenceNode.Right());
         }
         else
+        {
           ++numPrunes;
+          TraversalStatistics::RecordPrune(*referenceNode.Right());
+        }
       }
     }
 
@@ -301,7 +353,10 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Right(), *referenceNode.Right());
       }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Right());
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -319,13 +374,17 @@ DualTreeTraverser<RuleType>::Traverse(
         Traverse(*queryNode.Right(), *referenceNode.Left());
       }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Left());
+      }
     }
     else
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2;
+        TraversalStatistics::RecordPrune(*referenceNode.Left(), 2);
       }
       else
       {
@@ -346,7 +405,10 @@ DualTreeTraverser<RuleType>::Traverse(
           Traverse(*queryNode.Right(), *referenceNode.Right());
         }
         else
+        {
           ++numPrunes;
+          TraversalStatistics::RecordPrune(*referenceNode.Right());
+        }
       }
     }
   }
@@ -16,6 +16,10 @@
 
 // In case it hasn't been included yet.
 #include "single_tree_traverser.hpp"
+#include "../base_case_range.hpp"
+#include "../child_bounds.hpp"
+#include "../prefetch.hpp"
+#include "../traversal_statistics.hpp"
 
 #include <stack>
 
@@ -48,12 +52,16 @@ SingleTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
         referenceNode)
 {
+  MLPACK_PROFILE_SCOPE("binary_space_tree_single_tree_traversal");
+  TraversalStatistics::RecordVisit(referenceNode);
+
   // If we are a leaf, run the base case as necessary.
   if (referenceNode.IsLeaf())
   {
+    MLPACK_PROFILE_SCOPE("base_cases");
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-    for (size_t i = referenceNode.Begin(); i < refEnd; ++i)
-      rule.BaseCase(queryIndex, i);
+    BaseCaseRange(rule, queryIndex, referenceNode.Begin(), refEnd);
+    TraversalStatistics::RecordBaseCases(referenceNode, referenceNode.Count());
   }
   else
   {
@@ -65,13 +73,29 @@ SingleTreeTraverser<RuleType>::Traverse(
       if (rootScore == DBL_MAX)
       {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(referenceNode);
         return;
       }
     }
 
-    // If either score is DBL_MAX, we do not recurse into that node.
-    double leftScore = rule.Score(queryIndex, *referenceNode.Left());
-    double rightScore = rule.Score(queryIndex, *referenceNode.Right());
+    // Request both children from memory before scoring either, so that the
+    // loads overlap.
+    PrefetchNode(*referenceNode.Left());
+    PrefetchNode(*referenceNode.Right());
+
+    // If either score is DBL_MAX, we do not recurse into that node.  Both
+    // children are scored at once, if the rules can do that.
+    arma::vec childScores;
+    ScoreChildren(rule, queryIndex, referenceNode, childScores);
+    double leftScore = childScores[0];
+    double rightScore = childScores[1];
+
+    // The points of the leaves we may visit are loaded while the first child
+    // is traversed.
+    if (leftScore != DBL_MAX)
+      PrefetchLeafPoints(*referenceNode.Left());
+    if (rightScore != DBL_MAX)
+      PrefetchLeafPoints(*referenceNode.Right());
 
     if (leftScore < rightScore)
     {
@@ -82,9 +106,14 @@ SingleTreeTraverser<RuleType>::Traverse(
       rightScore = rule.Rescore(queryIndex, *referenceNode.Right(), rightScore);
 
       if (rightScore != DBL_MAX)
+      {
         Traverse(queryIndex, *referenceNode.Right()); // Recurse to the right.
+      }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Right());
+      }
     }
     else if (rightScore < leftScore)
     {
@@ -95,15 +124,21 @@ SingleTreeTraverser<RuleType>::Traverse(
       leftScore = rule.Rescore(queryIndex, *referenceNode.Left(), leftScore);
 
       if (leftScore != DBL_MAX)
+      {
         Traverse(queryIndex, *referenceNode.Left()); // Recurse to the left.
+      }
       else
+      {
         ++numPrunes;
+        TraversalStatistics::RecordPrune(*referenceNode.Left());
+      }
     }
     else // leftScore is equal to rightScore.
     {
       if (leftScore == DBL_MAX)
       {
         numPrunes += 2; // Pruned both left and right.
+        TraversalStatistics::RecordPrune(*referenceNode.Left(), 2);
       }
       else
       {
@@ -115,9 +150,14 @@ SingleTreeTraverser<RuleType>::Traverse(
             rightScore);
 
         if (rightScore != DBL_MAX)
+        {
           Traverse(queryIndex, *referenceNode.Right());
+        }
         else
+        {
           ++numPrunes;
+          TraversalStatistics::RecordPrune(*referenceNode.Right());
+        }
       }
     }
   }
@@ -0,0 +1,79 @@
+/**
+ * @file core/tree/binary_space_tree/split_traits.hpp
+ *
+ * Definition of the SplitTraits class, which describes properties of the
+ * splitting strategies of BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+#include "ub_tree_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class describes properties of a BinarySpaceTree splitting
+ * strategy.  By default, nothing is assumed about the splitter; specializations
+ * can declare more.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if different nodes can be split at the same time with the
+   * same splitter object; that is, the splitter holds no state and uses no
+   * random numbers.  If so, subtrees may be built in parallel.
+   */
+  static const bool ThreadSafe = false;
+
+  /**
+   * This is true if a node can be split on its own by a new splitter object,
+   * as BinarySpaceTree::InsertPoints() does for the leaves that grow too large.
+   * This is false if the splitter prepares the splits of all the nodes when the
+   * root is split.
+   */
+  static const bool LocalSplits = true;
+};
+
+//! MidpointSplit has no state and is deterministic.
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ThreadSafe = true;
+  static const bool LocalSplits = true;
+};
+
+//! MeanSplit has no state and is deterministic.
+template<typename BoundType, typename MatType>
+class SplitTraits<MeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ThreadSafe = true;
+  static const bool LocalSplits = true;
+};
+
+//! UBTreeSplit computes the addresses of all the points when the root is
+//! split, and keeps them for the other nodes.
+template<typename BoundType, typename MatType>
+class SplitTraits<UBTreeSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ThreadSafe = false;
+  static const bool LocalSplits = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
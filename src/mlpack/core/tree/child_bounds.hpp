@@ -0,0 +1,189 @@
+/**
+ * @file core/tree/child_bounds.hpp
+ *
+ * Definition of the ChildBounds class, which stores the bounds of the children
+ * of each node of a tree together, and of the ScoreChildren() function, which
+ * scores all the children of a node at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_CHILD_BOUNDS_HPP
+#define MLPACK_CORE_TREE_CHILD_BOUNDS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+#include <unordered_map>
+#include "hrect_bound_set.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The type of the bound of the given tree type (without reference or const),
+ * or void if the tree has no Bound() method.
+ */
+template<typename TreeType>
+struct TreeBoundType
+{
+ private:
+  template<typename T>
+  static typename std::decay<decltype(std::declval<const T&>().Bound())>::type
+  Get(int);
+
+  template<typename T>
+  static void Get(...);
+
+ public:
+  typedef decltype(Get<TreeType>(0)) type;
+};
+
+/**
+ * IsHRectBound<T>::value is true if T is a HRectBound; then
+ * IsHRectBound<T>::MetricType is its metric.
+ */
+template<typename BoundType>
+struct IsHRectBound
+{
+  static const bool value = false;
+  typedef metric::LMetric<2, true> MetricType;
+};
+
+template<typename BoundMetricType, typename BoundElemType>
+struct IsHRectBound<bound::HRectBound<BoundMetricType, BoundElemType>>
+{
+  static const bool value = true;
+  typedef BoundMetricType MetricType;
+};
+
+/**
+ * The ChildBounds class holds, for each node of a tree that has children, the
+ * bounds of its children in a bound::HRectBoundSet, so that the distances from
+ * a point to all the children of a node can be computed in one pass over
+ * contiguous memory.  Rules classes that are given a ChildBounds object can
+ * then score all the children of a node at once in ScoreChildren() (for
+ * instance, NeighborSearchRules::ScoreChildren()).
+ *
+ * Only trees whose bound is a HRectBound (kd-trees, octrees, R trees, ...) are
+ * supported; for other trees, the object is empty and Children() always
+ * returns NULL.  The tree must not be modified while the object is used.
+ *
+ * @tparam TreeType Type of the tree.
+ * @tparam ElemType Type used to store the ends of the bounds: float halves the
+ *     memory of the bounds, which are then rounded outwards.
+ */
+template<typename TreeType, typename ElemType = double>
+class ChildBounds
+{
+ public:
+  //! The type of the bound of the tree.
+  typedef typename TreeBoundType<TreeType>::type BoundType;
+  //! The type of the set of bounds of the children of a node.
+  typedef bound::HRectBoundSet<typename IsHRectBound<BoundType>::MetricType,
+      ElemType> SetType;
+
+  //! Create an empty object.
+  ChildBounds() { }
+
+  /**
+   * Store the bounds of the children of each node of the given tree.
+   *
+   * @param tree Root of the tree.
+   */
+  ChildBounds(const TreeType& tree) { Build<TreeType>(tree); }
+
+  /**
+   * Get the set of the bounds of the children of the given node (in the order
+   * of Child()), or NULL if the node is not known (or is a leaf).
+   */
+  const SetType* Children(const TreeType& node) const
+  {
+    typename std::unordered_map<const TreeType*, size_t>::const_iterator it =
+        indices.find(&node);
+    return (it == indices.end()) ? NULL : &sets[it->second];
+  }
+
+  //! Get the number of nodes whose child bounds are stored.
+  size_t NumNodes() const { return sets.size(); }
+
+ private:
+  //! Store the bounds of the children of every node of the given tree.
+  template<typename T>
+  typename std::enable_if<IsHRectBound<BoundType>::value &&
+      std::is_same<T, TreeType>::value>::type
+  Build(const T& tree)
+  {
+    std::vector<const TreeType*> stack(1, &tree);
+    while (!stack.empty())
+    {
+      const TreeType* node = stack.back();
+      stack.pop_back();
+      if (node->NumChildren() == 0)
+        continue;
+
+      SetType set(node->Bound().Dim(), node->NumChildren());
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+      {
+        set.Set(i, node->Child(i).Bound());
+        stack.push_back(&node->Child(i));
+      }
+
+      indices[node] = sets.size();
+      sets.push_back(std::move(set));
+    }
+  }
+
+  //! Trees without HRectBound bounds are not supported.
+  template<typename T>
+  typename std::enable_if<!IsHRectBound<BoundType>::value &&
+      std::is_same<T, TreeType>::value>::type
+  Build(const T& /* tree */) { }
+
+  //! The sets of bounds of the children of the nodes.
+  std::vector<SetType> sets;
+  //! The index in sets of each node.
+  std::unordered_map<const TreeType*, size_t> indices;
+}; // class ChildBounds
+
+// This gives us a HasScoreChildren<T> type, where HasScoreChildren<T>::value
+// is true if the rules class T has a ScoreChildren() method.
+HAS_ANY_METHOD_FORM(ScoreChildren, HasScoreChildren);
+
+/**
+ * Score all the children of the given reference node for the given query
+ * point, using the ScoreChildren() method of the rules.
+ */
+template<typename RuleType, typename TreeType>
+inline force_inline
+typename std::enable_if_t<HasScoreChildren<RuleType>::value>
+ScoreChildren(RuleType& rule,
+              const size_t queryIndex,
+              TreeType& referenceNode,
+              arma::vec& scores)
+{
+  rule.ScoreChildren(queryIndex, referenceNode, scores);
+}
+
+/**
+ * Score all the children of the given reference node for the given query
+ * point, one at a time, for rules without a ScoreChildren() method.
+ */
+template<typename RuleType, typename TreeType>
+inline force_inline
+typename std::enable_if_t<!HasScoreChildren<RuleType>::value>
+ScoreChildren(RuleType& rule,
+              const size_t queryIndex,
+              TreeType& referenceNode,
+              arma::vec& scores)
+{
+  scores.set_size(referenceNode.NumChildren());
+  for (size_t i = 0; i < scores.n_elem; ++i)
+    scores[i] = rule.Score(queryIndex, referenceNode.Child(i));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -30,10 +30,11 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
   {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
+    double l2Norm = arma::norm(dataset.unsafe_col(i), 2);
     l2NormsSquared(i) = l2Norm * l2Norm;
   }
 
@@ -126,27 +127,37 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
+    // Collect the current basis in a matrix, with two more columns for the
+    // basis vectors of the children, so that the projections onto the basis
+    // are matrix products.  (The columns of zeros do not change the
+    // projections.)
+    const size_t basisSize = treeQueue.size();
+    arma::mat currentBasis;
+    CollectBasis(treeQueue, currentBasis, 2);
+
     // Calculate basis vectors of left and right children.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
+    GramSchmidt(currentBasis, currentLeft->Centroid(), lBasisVector);
+    currentBasis.col(basisSize) = lBasisVector;
+    GramSchmidt(currentBasis, currentRight->Centroid(), rBasisVector);
+    currentBasis.col(basisSize + 1) = rBasisVector;
 
     // Add basis vectors to their respective nodes.
     currentLeft->BasisVector(lBasisVector);
     currentRight->BasisVector(rBasisVector);
 
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, currentBasis);
+    MonteCarloError(currentRight, currentBasis);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
-    // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    // Calculate Monte Carlo error estimate for the root node.  The basis of the
+    // queue is now the basis above.
+    monteCarloError = MonteCarloError(&root, currentBasis);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -372,39 +383,56 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
 {
-  // Set new basis vector to centroid.
-  newBasisVector = centroid;
-
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.end(); ++i)
-  {
-    currentNode = *i;
+  arma::mat currentBasis;
+  CollectBasis(treeQueue, currentBasis, addBasisVector ? 1 : 0);
+  if (addBasisVector)
+    currentBasis.col(treeQueue.size()) = *addBasisVector;
 
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+  GramSchmidt(currentBasis, centroid, newBasisVector);
+}
 
-  // If additional basis vector is passed, take it into account.
-  if (addBasisVector)
+void CosineTree::GramSchmidt(const arma::mat& basis,
+                             const arma::vec& centroid,
+                             arma::vec& newBasisVector)
+{
+  // Remove the projection of the centroid onto the basis, twice: the second
+  // pass removes what was left because of rounding errors in the first pass.
+  newBasisVector = centroid;
+  if (basis.n_cols > 0)
   {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      const arma::vec projections = basis.t() * newBasisVector;
+      newBasisVector -= basis * projections;
+    }
   }
 
   // Normalize the modified centroid vector.
-  if (arma::norm(newBasisVector, 2))
-    newBasisVector /= arma::norm(newBasisVector, 2);
+  const double norm = arma::norm(newBasisVector, 2);
+  if (norm)
+    newBasisVector /= norm;
 }
 
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  // The additional basis vectors are only used if both are passed.
+  const bool addBasisVectors = (addBasisVector1 && addBasisVector2);
+
+  arma::mat currentBasis;
+  CollectBasis(treeQueue, currentBasis, addBasisVectors ? 2 : 0);
+  if (addBasisVectors)
+  {
+    currentBasis.col(treeQueue.size()) = *addBasisVector1;
+    currentBasis.col(treeQueue.size() + 1) = *addBasisVector2;
+  }
+
+  return MonteCarloError(node, currentBasis);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node, const arma::mat& basis)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -417,52 +445,20 @@ double CosineTree::MonteCarloError(CosineTree* node,
   // Get pointer to the original dataset.
   const arma::mat& dataset = node->GetDataset();
 
-  // Initialize weighted projection magnitudes as zeros.
+  // Calculate the weighted squared norm of the projection of each sample onto
+  // the current basis.
   arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
-
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
+  if (basis.n_cols == 0)
+  {
+    weightedMagnitudes.zeros(numSamples);
+  }
   else
-    projectionSize = treeQueue.size();
-
-  // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; ++i)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); ++j, ++k)
-    {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
-
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
+    const arma::uvec sampledCols =
+        arma::conv_to<arma::uvec>::from(sampledIndices);
+    const arma::mat projections = basis.t() * dataset.cols(sampledCols);
+    weightedMagnitudes = arma::sum(arma::square(projections), 0).t() /
+        probabilities;
   }
 
   // Compute mean and standard deviation of the weighted samples.
@@ -488,20 +484,21 @@ double CosineTree::MonteCarloError(CosineTree* node,
 
 void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
 {
-  // Initialize basis as matrix of zeros.
-  basis.zeros(dataset->n_rows, treeQueue.size());
+  CollectBasis(treeQueue, basis);
+}
 
-  // Variables for iterating through the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
+void CosineTree::CollectBasis(const CosineNodeQueue& treeQueue,
+                              arma::mat& basis,
+                              const size_t extraColumns) const
+{
+  // Initialize basis as matrix of zeros.
+  basis.zeros(dataset->n_rows, treeQueue.size() + extraColumns);
 
   // Transfer basis vectors from the queue to the basis matrix.
   size_t j = 0;
+  CosineNodeQueue::const_iterator i = treeQueue.begin();
   for ( ; i != treeQueue.end(); ++i, ++j)
-  {
-    currentNode = *i;
-    basis.col(j) = currentNode->BasisVector();
-  }
+    basis.col(j) = (*i)->BasisVector();
 }
 
 void CosineTree::CosineNodeSplit()
@@ -633,21 +630,30 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; ++i)
+  // The norms of the columns are known already, so each cosine only takes one
+  // dot product.
+  const arma::vec splitPoint = dataset->unsafe_col(indices[splitPointIndex]);
+  const double splitNorm = std::sqrt(l2NormsSquared(splitPointIndex));
+  if (splitNorm == 0)
+    return;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
-    {
-      cosines(i) = 0;
-    }
-    else
+    if (l2NormsSquared(i) != 0)
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset->col(indices[splitPointIndex]),
-                                  dataset->col(indices[i])));
+      const double dot = arma::dot(splitPoint,
+          dataset->unsafe_col(indices[i]));
+      cosines(i) = std::min(1.0, std::abs(dot) /
+          (splitNorm * std::sqrt(l2NormsSquared(i))));
     }
   }
+
+  // The split point must have a cosine of exactly 1 with itself, so that it
+  // is not taken as the maximum cosine in CosineNodeSplit().
+  cosines(splitPointIndex) = 1.0;
 }
 
 void CosineTree::CalculateCentroid()
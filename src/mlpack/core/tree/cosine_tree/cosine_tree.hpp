@@ -116,6 +116,21 @@ class CosineTree
                            arma::vec& newBasisVector,
                            arma::vec* addBasisVector = NULL);
 
+  /**
+   * Calculates the orthonormalization of the passed centroid, with respect to
+   * the subspace spanned by the columns of the given matrix, which must be
+   * orthonormal (or zero).  This uses classical Gram-Schmidt with one step of
+   * reorthogonalization (CGS2), so that each step is a pair of matrix-vector
+   * products, while the result is as accurate as modified Gram-Schmidt.
+   *
+   * @param basis Matrix whose columns are the current basis vectors.
+   * @param centroid Centroid of the node being added to the basis.
+   * @param newBasisVector Orthonormalized centroid of the node.
+   */
+  void GramSchmidt(const arma::mat& basis,
+                   const arma::vec& centroid,
+                   arma::vec& newBasisVector);
+
   /**
    * Estimates the squared error of the projection of the input node's matrix
    * onto the current vector subspace. A normal distribution is fit using
@@ -133,6 +148,17 @@ class CosineTree
                          arma::vec* addBasisVector1 = NULL,
                          arma::vec* addBasisVector2 = NULL);
 
+  /**
+   * Estimates the squared error of the projection of the input node's matrix
+   * onto the subspace spanned by the (orthonormal) columns of the given
+   * matrix, as above.  The projections of all the samples are computed with
+   * one matrix product.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   * @param basis Matrix whose columns are the current basis vectors.
+   */
+  double MonteCarloError(CosineTree* node, const arma::mat& basis);
+
   /**
    * Constructs the final basis matrix, after the cosine tree construction.
    *
@@ -140,6 +166,19 @@ class CosineTree
    */
   void ConstructBasis(CosineNodeQueue& treeQueue);
 
+  /**
+   * Store the basis vectors of the nodes in the given priority queue in the
+   * columns of the given matrix, followed by the given number of columns of
+   * zeros.
+   *
+   * @param treeQueue Priority queue of cosine nodes.
+   * @param basis Matrix to store the basis vectors in.
+   * @param extraColumns Number of columns of zeros to add.
+   */
+  void CollectBasis(const CosineNodeQueue& treeQueue,
+                    arma::mat& basis,
+                    const size_t extraColumns = 0) const;
+
   /**
    * This function splits the cosine node into two children based on the cosines
    * of the columns contained in the node, with respect to the sampled splitting
@@ -16,6 +16,7 @@
 #include <mlpack/core/math/range.hpp>
 
 #include "../statistic.hpp"
+#include "../node_pool.hpp"
 #include "first_point_is_root.hpp"
 
 namespace mlpack {
@@ -267,6 +268,14 @@ class CoverTree
    */
   ~CoverTree();
 
+  //! Allocate nodes from a NodePool, so that nodes are contiguous in memory.
+  static void* operator new(size_t size)
+  { return NodePool<CoverTree>::Allocate(size); }
+
+  //! Return the memory of a node to its NodePool.
+  static void operator delete(void* p, size_t size)
+  { NodePool<CoverTree>::Deallocate(p, size); }
+
   //! A single-tree cover tree traverser; see single_tree_traverser.hpp for
   //! implementation.
   template<typename RuleType>
@@ -485,6 +494,39 @@ class CoverTree
                         const arma::Col<size_t>& indices,
                         arma::vec& distances,
                         const size_t pointSetSize);
+
+  /**
+   * Fill the vector of distances with the distances between the point specified
+   * by pointIndex and each point in the indices array, like ComputeDistances(),
+   * but reuse the distances of the points to the parent of the new node.  On
+   * input, distances holds the distance of each point to the parent; if the
+   * triangle inequality |d(parent, x) - d(parent, point)| shows that a point is
+   * farther than the given bound, its distance is not computed and the lower
+   * bound is stored instead.  Those points are then pruned from the far set as
+   * if the distance had been computed.
+   *
+   * @param pointIndex Point to build the distances for.
+   * @param parentDistance Distance between the point and the parent.
+   * @param indices List of indices to compute distances for.
+   * @param distances Vector holding the distances to the parent; will be
+   *     overwritten with the distances to the point.
+   * @param pointSetSize Number of points in arrays to calculate distances for.
+   * @param bound Points farther than this bound do not need exact distances.
+   */
+  void ComputeChildDistances(const size_t pointIndex,
+                             const ElemType parentDistance,
+                             const arma::Col<size_t>& indices,
+                             arma::vec& distances,
+                             const size_t pointSetSize,
+                             const ElemType bound);
+
+  /**
+   * Minimum number of distances to compute before ComputeDistances() and
+   * ComputeChildDistances() compute them in parallel.  Only the top levels of
+   * the tree have point sets this large.
+   */
+  static constexpr size_t ParallelDistancesThreshold = 4096;
+
   /**
    * Split the given indices and distances into a near and a far set, returning
    * the number of points in the near set.  The distances must already be
@@ -1274,10 +1274,14 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     childIndices.rows(0, (nearSetSize + farSetSize - 2)) = indices.rows(1,
         nearSetSize + farSetSize - 1);
     arma::vec childDistances(nearSetSize + farSetSize);
+    childDistances.rows(0, (nearSetSize + farSetSize - 2)) = distances.rows(1,
+        nearSetSize + farSetSize - 1);
 
-    // Build distances for the child.
-    ComputeDistances(indices[0], childIndices, childDistances, nearSetSize
-        + farSetSize - 1);
+    // Build distances for the child.  We already know the distance of every
+    // point to this node, so points that the triangle inequality puts beyond
+    // the far set bound are skipped.
+    ComputeChildDistances(indices[0], distances[0], childIndices,
+        childDistances, nearSetSize + farSetSize - 1, base * bound);
 
     // Split into near and far sets for this point.
     childNearSetSize = SplitNearFar(childIndices, childDistances, bound,
@@ -1393,14 +1397,55 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 {
   // For each point, rebuild the distances.  The indices do not need to be
   // modified.
+  // This is only worth doing in parallel for the large point sets at the top
+  // of the tree.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  #pragma omp parallel for schedule(static) \
+      if (pointSetSize >= ParallelDistancesThreshold)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
   }
 }
 
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    ComputeChildDistances(const size_t pointIndex,
+                          const ElemType parentDistance,
+                          const arma::Col<size_t>& indices,
+                          arma::vec& distances,
+                          const size_t pointSetSize,
+                          const ElemType bound)
+{
+  size_t computed = 0;
+  #pragma omp parallel for schedule(static) reduction(+:computed) \
+      if (pointSetSize >= ParallelDistancesThreshold)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
+  {
+    // By the triangle inequality, the distance to the point is at least the
+    // difference of the distances to the parent.
+    const ElemType lowerBound = std::abs(distances[i] - parentDistance);
+    if (lowerBound > bound)
+    {
+      distances[i] = lowerBound;
+    }
+    else
+    {
+      distances[i] = metric->Evaluate(dataset->col(pointIndex),
+          dataset->col(indices[i]));
+      ++computed;
+    }
+  }
+
+  distanceComps += computed;
+}
+
 template<
     typename MetricType,
     typename StatisticType,
@@ -0,0 +1,224 @@
+/**
+ * @file core/tree/hrect_bound_set.hpp
+ *
+ * Definition of the HRectBoundSet class, which stores several hyperrectangle
+ * bounds together so that the distances from a point to all of them can be
+ * computed in one pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_HRECT_BOUND_SET_HPP
+#define MLPACK_CORE_TREE_HRECT_BOUND_SET_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hrectbound.hpp"
+
+namespace mlpack {
+namespace bound {
+
+/**
+ * The HRectBoundSet class holds a set of hyperrectangle bounds (typically the
+ * bounds of the children of a tree node) in structure-of-arrays form: for each
+ * dimension, the lower ends of all the bounds are contiguous, and so are the
+ * upper ends.  MinDistance() and MaxDistance() then compute the distances from
+ * a point to all the bounds at once, with an inner loop over the bounds that
+ * the compiler can vectorize, instead of one call (and one pass over the point)
+ * per bound.  The distances are the same as those of HRectBound::MinDistance()
+ * and HRectBound::MaxDistance().
+ *
+ * The ends of the bounds can be stored with less precision than the bounds they
+ * come from (for instance, float for bounds of double), to reduce the memory
+ * and cache footprint of the set.  They are then rounded outwards, so that the
+ * stored bounds still contain the original ones: the minimum distances can only
+ * be a little smaller, and the maximum distances a little larger, so pruning
+ * with them remains exact.
+ *
+ * @tparam MetricType Type of metric to use; must be of type LMetric (the same
+ *     as that of the stored bounds).
+ * @tparam ElemType Type of the stored ends of the bounds.
+ */
+template<typename MetricType = metric::LMetric<2, true>,
+         typename ElemType = double>
+class HRectBoundSet
+{
+  static_assert(meta::IsLMetric<MetricType>::Value == true,
+      "HRectBoundSet can only be used with the LMetric<> metric type.");
+
+ public:
+  //! Create an empty set.
+  HRectBoundSet() { }
+
+  /**
+   * Create a set of the given number of bounds of the given dimensionality.
+   * The bounds must then be given with Set().
+   *
+   * @param dimension Dimensionality of the bounds.
+   * @param size Number of bounds.
+   */
+  HRectBoundSet(const size_t dimension, const size_t size) :
+      lo(size, dimension),
+      hi(size, dimension)
+  { }
+
+  /**
+   * Store the given bound at the given index of the set.
+   *
+   * @param index Index of the bound in the set.
+   * @param bound Bound to store.
+   */
+  template<typename BoundElemType>
+  void Set(const size_t index,
+           const HRectBound<MetricType, BoundElemType>& bound)
+  {
+    Log::Assert(bound.Dim() == lo.n_cols);
+    for (size_t d = 0; d < lo.n_cols; ++d)
+    {
+      lo(index, d) = RoundDown((double) bound[d].Lo());
+      hi(index, d) = RoundUp((double) bound[d].Hi());
+    }
+  }
+
+  //! Get the number of bounds in the set.
+  size_t Size() const { return lo.n_rows; }
+  //! Get the dimensionality of the bounds.
+  size_t Dim() const { return lo.n_cols; }
+
+  /**
+   * Compute the minimum distance between the given point and each bound of
+   * the set.
+   *
+   * @param point Point to compute the distances to.
+   * @param distances Output distances (one per bound).
+   */
+  template<typename VecType>
+  void MinDistance(const VecType& point, arma::vec& distances) const
+  {
+    Log::Assert(point.n_elem == lo.n_cols);
+
+    const size_t n = lo.n_rows;
+    distances.zeros(n);
+    double* sums = distances.memptr();
+    for (size_t d = 0; d < lo.n_cols; ++d)
+    {
+      const ElemType* loPtr = lo.colptr(d);
+      const ElemType* hiPtr = hi.colptr(d);
+      const double p = (double) point[d];
+      for (size_t i = 0; i < n; ++i)
+      {
+        // As in HRectBound::MinDistance(), only one of 'lower' or 'higher' is
+        // positive, and x + |x| = max(2x, 0).
+        const double lower = (double) loPtr[i] - p;
+        const double higher = p - (double) hiPtr[i];
+        const double v = (lower + std::fabs(lower)) + (higher +
+            std::fabs(higher));
+        sums[i] += Power(v);
+      }
+    }
+
+    // Take the root and cancel out the factor of 2 introduced above.
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (MetricType::Power == 1)
+        sums[i] *= 0.5;
+      else if (MetricType::Power == 2)
+        sums[i] = MetricType::TakeRoot ? std::sqrt(sums[i]) * 0.5 :
+            sums[i] * 0.25;
+      else if (MetricType::TakeRoot)
+        sums[i] = std::pow(sums[i], 1.0 / (double) MetricType::Power) / 2.0;
+      else
+        sums[i] /= std::pow(2.0, MetricType::Power);
+    }
+  }
+
+  /**
+   * Compute the maximum distance between the given point and each bound of
+   * the set.
+   *
+   * @param point Point to compute the distances to.
+   * @param distances Output distances (one per bound).
+   */
+  template<typename VecType>
+  void MaxDistance(const VecType& point, arma::vec& distances) const
+  {
+    Log::Assert(point.n_elem == lo.n_cols);
+
+    const size_t n = lo.n_rows;
+    distances.zeros(n);
+    double* sums = distances.memptr();
+    for (size_t d = 0; d < lo.n_cols; ++d)
+    {
+      const ElemType* loPtr = lo.colptr(d);
+      const ElemType* hiPtr = hi.colptr(d);
+      const double p = (double) point[d];
+      for (size_t i = 0; i < n; ++i)
+      {
+        const double v = std::max(std::fabs(p - (double) loPtr[i]),
+            std::fabs((double) hiPtr[i] - p));
+        sums[i] += Power(v);
+      }
+    }
+
+    if (MetricType::TakeRoot && MetricType::Power != 1)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        sums[i] = (MetricType::Power == 2) ? std::sqrt(sums[i]) :
+            std::pow(sums[i], 1.0 / (double) MetricType::Power);
+      }
+    }
+  }
+
+ private:
+  //! Raise the given non-negative value to the power of the metric.
+  static double Power(const double v)
+  {
+    // The compiler should optimize out this if statement entirely.
+    if (MetricType::Power == 1)
+      return v;
+    else if (MetricType::Power == 2)
+      return v * v;
+    else
+      return std::pow(v, (double) MetricType::Power);
+  }
+
+  //! Convert the given value to ElemType, rounding towards -infinity.
+  static ElemType RoundDown(const double value)
+  {
+    if (value < -(double) std::numeric_limits<ElemType>::max())
+      return -std::numeric_limits<ElemType>::infinity();
+    if (value > (double) std::numeric_limits<ElemType>::max())
+      return std::numeric_limits<ElemType>::max();
+
+    const ElemType rounded = (ElemType) value;
+    return ((double) rounded > value) ? std::nextafter(rounded,
+        -std::numeric_limits<ElemType>::infinity()) : rounded;
+  }
+
+  //! Convert the given value to ElemType, rounding towards +infinity.
+  static ElemType RoundUp(const double value)
+  {
+    if (value > (double) std::numeric_limits<ElemType>::max())
+      return std::numeric_limits<ElemType>::infinity();
+    if (value < -(double) std::numeric_limits<ElemType>::max())
+      return -std::numeric_limits<ElemType>::max();
+
+    const ElemType rounded = (ElemType) value;
+    return ((double) rounded < value) ? std::nextafter(rounded,
+        std::numeric_limits<ElemType>::infinity()) : rounded;
+  }
+
+  //! The lower end of each bound (one row per bound, one column per
+  //! dimension).
+  arma::Mat<ElemType> lo;
+  //! The upper end of each bound (one row per bound, one column per
+  //! dimension).
+  arma::Mat<ElemType> hi;
+}; // class HRectBoundSet
+
+} // namespace bound
+} // namespace mlpack
+
+#endif
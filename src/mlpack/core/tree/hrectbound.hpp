@@ -244,6 +244,32 @@ class HRectBound
   ElemType minWidth;
   //! Instantiated metric (likely has size 0).
   MetricType metric;
+
+  /**
+   * Calculate the sum over the dimensions of MinDistance() for a point, before
+   * the root is taken.  FixedDim is the dimensionality of the bound if it is
+   * known at compile time (so that the loop can be unrolled), or 0.  The
+   * functions below take the same parameter.
+   */
+  template<size_t FixedDim, typename VecType>
+  ElemType MinDistanceSum(const VecType& point) const;
+  //! Calculate the sum over the dimensions of MinDistance() for a bound.
+  template<size_t FixedDim>
+  ElemType MinDistanceSum(const HRectBound& other) const;
+
+  //! Calculate the sum over the dimensions of MaxDistance() for a point.
+  template<size_t FixedDim, typename VecType>
+  ElemType MaxDistanceSum(const VecType& point) const;
+  //! Calculate the sum over the dimensions of MaxDistance() for a bound.
+  template<size_t FixedDim>
+  ElemType MaxDistanceSum(const HRectBound& other) const;
+
+  //! Calculate the sums over the dimensions of RangeDistance() for a point.
+  template<size_t FixedDim, typename VecType>
+  math::RangeType<ElemType> RangeDistanceSums(const VecType& point) const;
+  //! Calculate the sums over the dimensions of RangeDistance() for a bound.
+  template<size_t FixedDim>
+  math::RangeType<ElemType> RangeDistanceSums(const HRectBound& other) const;
 };
 
 // A specialization of BoundTraits for this class.
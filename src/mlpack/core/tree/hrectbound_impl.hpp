@@ -182,20 +182,21 @@ inline ElemType HRectBound<MetricType, ElemType>::Volume() const
 }
 
 /**
- * Calculates minimum bound-to-point squared distance.
+ * Calculates the sum over the dimensions of the minimum bound-to-point
+ * distance, before the root is taken.
  */
 template<typename MetricType, typename ElemType>
-template<typename VecType>
-inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
-    const VecType& point,
-    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+template<size_t FixedDim, typename VecType>
+inline ElemType
+HRectBound<MetricType, ElemType>::MinDistanceSum(const VecType& point) const
 {
-  Log::Assert(point.n_elem == dim);
+  // A FixedDim of 0 means the dimensionality is only known at runtime.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
 
   ElemType sum = 0;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     lower = bounds[d].Lo() - point[d];
     higher = point[d] - bounds[d].Hi();
@@ -217,6 +218,38 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
     }
   }
 
+  return sum;
+}
+
+/**
+ * Calculates minimum bound-to-point squared distance.
+ */
+template<typename MetricType, typename ElemType>
+template<typename VecType>
+inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
+    const VecType& point,
+    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  Log::Assert(point.n_elem == dim);
+
+  // Bounds of two to four dimensions use loops of fixed length, which the
+  // compiler can unroll.
+  ElemType sum;
+  switch (dim)
+  {
+    case 2:
+      sum = MinDistanceSum<2>(point);
+      break;
+    case 3:
+      sum = MinDistanceSum<3>(point);
+      break;
+    case 4:
+      sum = MinDistanceSum<4>(point);
+      break;
+    default:
+      sum = MinDistanceSum<0>(point);
+  }
+
   // Now take the Power'th root (but make sure our result is squared if it needs
   // to be); then cancel out the constant of 2 (which may have been squared now)
   // that was introduced earlier.  The compiler should optimize out the if
@@ -241,20 +274,23 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
 }
 
 /**
- * Calculates minimum bound-to-bound squared distance.
+ * Calculates the sum over the dimensions of the minimum bound-to-bound
+ * distance, before the root is taken.
  */
 template<typename MetricType, typename ElemType>
-ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
-    const
+template<size_t FixedDim>
+inline ElemType
+HRectBound<MetricType, ElemType>::MinDistanceSum(const HRectBound& other) const
 {
-  Log::Assert(dim == other.dim);
+  // A FixedDim of 0 means the dimensionality is only known at runtime.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
 
   ElemType sum = 0;
   const math::RangeType<ElemType>* mbound = bounds;
   const math::RangeType<ElemType>* obound = other.bounds;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     lower = obound->Lo() - mbound->Hi();
     higher = mbound->Lo() - obound->Hi();
@@ -281,6 +317,36 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
     obound++;
   }
 
+  return sum;
+}
+
+/**
+ * Calculates minimum bound-to-bound squared distance.
+ */
+template<typename MetricType, typename ElemType>
+ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
+    const
+{
+  Log::Assert(dim == other.dim);
+
+  // Bounds of two to four dimensions use loops of fixed length, which the
+  // compiler can unroll.
+  ElemType sum;
+  switch (dim)
+  {
+    case 2:
+      sum = MinDistanceSum<2>(other);
+      break;
+    case 3:
+      sum = MinDistanceSum<3>(other);
+      break;
+    case 4:
+      sum = MinDistanceSum<4>(other);
+      break;
+    default:
+      sum = MinDistanceSum<0>(other);
+  }
+
   // The compiler should optimize out this if statement entirely.
   if (MetricType::Power == 1)
     return sum * 0.5;
@@ -302,19 +368,19 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
 }
 
 /**
- * Calculates maximum bound-to-point squared distance.
+ * Calculates the sum over the dimensions of the maximum bound-to-point
+ * distance, before the root is taken.
  */
 template<typename MetricType, typename ElemType>
-template<typename VecType>
-inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
-    const VecType& point,
-    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+template<size_t FixedDim, typename VecType>
+inline ElemType
+HRectBound<MetricType, ElemType>::MaxDistanceSum(const VecType& point) const
 {
-  ElemType sum = 0;
+  // A FixedDim of 0 means the dimensionality is only known at runtime.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
 
-  Log::Assert(point.n_elem == dim);
-
-  for (size_t d = 0; d < dim; d++)
+  ElemType sum = 0;
+  for (size_t d = 0; d < n; d++)
   {
     ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
         fabs(bounds[d].Hi() - point[d]));
@@ -328,6 +394,38 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
       sum += std::pow(v, (ElemType) MetricType::Power);
   }
 
+  return sum;
+}
+
+/**
+ * Calculates maximum bound-to-point squared distance.
+ */
+template<typename MetricType, typename ElemType>
+template<typename VecType>
+inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
+    const VecType& point,
+    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  Log::Assert(point.n_elem == dim);
+
+  // Bounds of two to four dimensions use loops of fixed length, which the
+  // compiler can unroll.
+  ElemType sum;
+  switch (dim)
+  {
+    case 2:
+      sum = MaxDistanceSum<2>(point);
+      break;
+    case 3:
+      sum = MaxDistanceSum<3>(point);
+      break;
+    case 4:
+      sum = MaxDistanceSum<4>(point);
+      break;
+    default:
+      sum = MaxDistanceSum<0>(point);
+  }
+
   // The compiler should optimize out this if statement entirely.
   if (MetricType::TakeRoot)
   {
@@ -343,19 +441,21 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
 }
 
 /**
- * Computes maximum distance.
+ * Calculates the sum over the dimensions of the maximum bound-to-bound
+ * distance, before the root is taken.
  */
 template<typename MetricType, typename ElemType>
-inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
-    const HRectBound& other)
-    const
+template<size_t FixedDim>
+inline ElemType
+HRectBound<MetricType, ElemType>::MaxDistanceSum(const HRectBound& other) const
 {
-  ElemType sum = 0;
+  // A FixedDim of 0 means the dimensionality is only known at runtime.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
 
-  Log::Assert(dim == other.dim);
+  ElemType sum = 0;
 
   ElemType v;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
         fabs(bounds[d].Hi() - other.bounds[d].Lo()));
@@ -369,6 +469,37 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
       sum += std::pow(v, (ElemType) MetricType::Power);
   }
 
+  return sum;
+}
+
+/**
+ * Computes maximum distance.
+ */
+template<typename MetricType, typename ElemType>
+inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
+    const HRectBound& other)
+    const
+{
+  Log::Assert(dim == other.dim);
+
+  // Bounds of two to four dimensions use loops of fixed length, which the
+  // compiler can unroll.
+  ElemType sum;
+  switch (dim)
+  {
+    case 2:
+      sum = MaxDistanceSum<2>(other);
+      break;
+    case 3:
+      sum = MaxDistanceSum<3>(other);
+      break;
+    case 4:
+      sum = MaxDistanceSum<4>(other);
+      break;
+    default:
+      sum = MaxDistanceSum<0>(other);
+  }
+
   // The compiler should optimize out this if statement entirely.
   if (MetricType::TakeRoot)
   {
@@ -384,20 +515,23 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
 }
 
 /**
- * Calculates minimum and maximum bound-to-bound squared distance.
+ * Calculates the sums over the dimensions of the minimum and maximum
+ * bound-to-bound distances, before the root is taken.
  */
 template<typename MetricType, typename ElemType>
+template<size_t FixedDim>
 inline math::RangeType<ElemType>
-HRectBound<MetricType, ElemType>::RangeDistance(
+HRectBound<MetricType, ElemType>::RangeDistanceSums(
     const HRectBound& other) const
 {
+  // A FixedDim of 0 means the dimensionality is only known at runtime.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+
   ElemType loSum = 0;
   ElemType hiSum = 0;
 
-  Log::Assert(dim == other.dim);
-
   ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     v1 = other.bounds[d].Lo() - bounds[d].Hi();
     v2 = bounds[d].Lo() - other.bounds[d].Hi();
@@ -431,6 +565,39 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     }
   }
 
+  return math::RangeType<ElemType>(loSum, hiSum);
+}
+
+/**
+ * Calculates minimum and maximum bound-to-bound squared distance.
+ */
+template<typename MetricType, typename ElemType>
+inline math::RangeType<ElemType>
+HRectBound<MetricType, ElemType>::RangeDistance(
+    const HRectBound& other) const
+{
+  Log::Assert(dim == other.dim);
+
+  // Bounds of two to four dimensions use loops of fixed length, which the
+  // compiler can unroll.
+  math::RangeType<ElemType> sums;
+  switch (dim)
+  {
+    case 2:
+      sums = RangeDistanceSums<2>(other);
+      break;
+    case 3:
+      sums = RangeDistanceSums<3>(other);
+      break;
+    case 4:
+      sums = RangeDistanceSums<4>(other);
+      break;
+    default:
+      sums = RangeDistanceSums<0>(other);
+  }
+  const ElemType loSum = sums.Lo();
+  const ElemType hiSum = sums.Hi();
+
   if (MetricType::TakeRoot)
   {
     if (MetricType::Power == 1)
@@ -450,22 +617,22 @@ HRectBound<MetricType, ElemType>::RangeDistance(
 }
 
 /**
- * Calculates minimum and maximum bound-to-point squared distance.
+ * Calculates the sums over the dimensions of the minimum and maximum
+ * bound-to-point distances, before the root is taken.
  */
 template<typename MetricType, typename ElemType>
-template<typename VecType>
+template<size_t FixedDim, typename VecType>
 inline math::RangeType<ElemType>
-HRectBound<MetricType, ElemType>::RangeDistance(
-    const VecType& point,
-    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+HRectBound<MetricType, ElemType>::RangeDistanceSums(const VecType& point) const
 {
+  // A FixedDim of 0 means the dimensionality is only known at runtime.
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+
   ElemType loSum = 0;
   ElemType hiSum = 0;
 
-  Log::Assert(point.n_elem == dim);
-
   ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < n; d++)
   {
     v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
     v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
@@ -507,6 +674,41 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     }
   }
 
+  return math::RangeType<ElemType>(loSum, hiSum);
+}
+
+/**
+ * Calculates minimum and maximum bound-to-point squared distance.
+ */
+template<typename MetricType, typename ElemType>
+template<typename VecType>
+inline math::RangeType<ElemType>
+HRectBound<MetricType, ElemType>::RangeDistance(
+    const VecType& point,
+    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  Log::Assert(point.n_elem == dim);
+
+  // Bounds of two to four dimensions use loops of fixed length, which the
+  // compiler can unroll.
+  math::RangeType<ElemType> sums;
+  switch (dim)
+  {
+    case 2:
+      sums = RangeDistanceSums<2>(point);
+      break;
+    case 3:
+      sums = RangeDistanceSums<3>(point);
+      break;
+    case 4:
+      sums = RangeDistanceSums<4>(point);
+      break;
+    default:
+      sums = RangeDistanceSums<0>(point);
+  }
+  const ElemType loSum = sums.Lo();
+  const ElemType hiSum = sums.Hi();
+
   if (MetricType::TakeRoot)
   {
     if (MetricType::Power == 1)
@@ -0,0 +1,258 @@
+/**
+ * @file core/tree/node_pool.hpp
+ *
+ * Definition of the NodePool class, which allocates tree nodes from large
+ * contiguous chunks instead of allocating every node separately on the heap.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_NODE_POOL_HPP
+#define MLPACK_CORE_TREE_NODE_POOL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mutex>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The NodePool class is a pool allocator for tree nodes.  Nodes are carved out
+ * of chunks that each hold many nodes, so building a tree performs only a few
+ * large allocations, and nodes that are created one after another (i.e. during
+ * tree construction) are adjacent in memory, which improves locality during
+ * traversal.  When every node of a chunk has been freed, the chunk is given
+ * back to the system.  AllocateContiguous() gives the memory of many nodes from
+ * one chunk of exactly that size, for code that knows how many nodes it will
+ * create (such as the deserialization of a tree).
+ *
+ * There is one pool per node type, shared by all trees of that type.  The pool
+ * is thread-safe.  Trees use the pool through class-specific operator new and
+ * operator delete, so that `new` and `delete` on nodes work as usual:
+ *
+ * @code
+ * static void* operator new(size_t size)
+ * { return NodePool<MyTree>::Allocate(size); }
+ *
+ * static void operator delete(void* p, size_t size)
+ * { NodePool<MyTree>::Deallocate(p, size); }
+ * @endcode
+ *
+ * @tparam NodeType Type of node to allocate.
+ */
+template<typename NodeType>
+class NodePool
+{
+ public:
+  //! Number of nodes held by each chunk.
+  static constexpr size_t ChunkSize = 512;
+
+  /**
+   * Allocate memory for one node.  If the requested size is not the size of
+   * NodeType (i.e. for a derived class), the global operator new is used.
+   *
+   * @param size Number of bytes to allocate.
+   */
+  static void* Allocate(const size_t size)
+  {
+    if (size != sizeof(NodeType))
+      return ::operator new(size);
+
+    return Instance().AllocateSlot();
+  }
+
+  /**
+   * Free the memory of one node that was allocated with Allocate().
+   *
+   * @param p Memory to free.
+   * @param size Number of bytes that were allocated.
+   */
+  static void Deallocate(void* p, const size_t size)
+  {
+    if (!p)
+      return;
+
+    if (size != sizeof(NodeType))
+    {
+      ::operator delete(p);
+      return;
+    }
+
+    Instance().DeallocateSlot(p);
+  }
+
+  /**
+   * Allocate memory for the given number of nodes, next to each other in one
+   * chunk, and store the address of each node in the given vector.  The nodes
+   * must be constructed with placement new (`::new (nodes[i]) NodeType(...)`),
+   * and each is freed with Deallocate() as usual; their memory is given back
+   * to the system when all of them have been freed.
+   *
+   * @param n Number of nodes to allocate.
+   * @param nodes Vector to store the address of each node in.
+   */
+  static void AllocateContiguous(const size_t n, std::vector<void*>& nodes)
+  {
+    nodes.clear();
+    if (n == 0)
+      return;
+
+    Instance().AllocateBlock(n, nodes);
+  }
+
+ private:
+  struct Chunk;
+
+  //! Storage for one node, and the chunk it belongs to.
+  struct Slot
+  {
+    //! The node (or, when the slot is free, the next free slot).
+    union
+    {
+      alignas(alignof(NodeType)) unsigned char node[sizeof(NodeType)];
+      Slot* next;
+    };
+    //! The chunk that holds this slot.
+    Chunk* chunk;
+  };
+
+  //! A contiguous block of slots.
+  struct Chunk
+  {
+    //! The slots of the chunk.
+    Slot* slots;
+    //! The number of slots of the chunk.
+    size_t size;
+    //! The number of slots that have ever been handed out.
+    size_t used;
+    //! The number of slots currently in use.
+    size_t live;
+    //! The list of slots that were freed.
+    Slot* freeList;
+    //! The index of the chunk in the list of chunks with free slots, or
+    //! Closed if the chunk is full.
+    size_t openIndex;
+  };
+
+  //! The openIndex of chunks that are not in the list of open chunks.
+  static const size_t Closed = size_t(-1);
+
+  //! Create a chunk with the given number of slots.
+  static Chunk* NewChunk(const size_t size)
+  {
+    Chunk* chunk = new Chunk;
+    chunk->slots = new Slot[size];
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->live = 0;
+    chunk->freeList = NULL;
+    chunk->openIndex = Closed;
+    return chunk;
+  }
+
+  //! Free the given chunk.
+  static void DeleteChunk(Chunk* chunk)
+  {
+    delete[] chunk->slots;
+    delete chunk;
+  }
+
+  //! Get the pool for this node type.  The pool is never destroyed, so that
+  //! static trees can still be deleted at program exit.
+  static NodePool& Instance()
+  {
+    static NodePool* pool = new NodePool();
+    return *pool;
+  }
+
+  //! Take a slot from a chunk that has free slots.
+  void* AllocateSlot()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (open.empty())
+    {
+      Chunk* chunk = NewChunk(ChunkSize);
+      chunk->openIndex = open.size();
+      open.push_back(chunk);
+    }
+
+    // Use the most recently opened chunk, so that consecutive allocations are
+    // next to each other.
+    Chunk* chunk = open.back();
+    Slot* slot;
+    if (chunk->freeList)
+    {
+      slot = chunk->freeList;
+      chunk->freeList = slot->next;
+    }
+    else
+    {
+      slot = &chunk->slots[chunk->used++];
+    }
+
+    slot->chunk = chunk;
+    if (++chunk->live == chunk->size)
+    {
+      open.pop_back();
+      chunk->openIndex = Closed;
+    }
+
+    return (void*) slot->node;
+  }
+
+  //! Hand out all the slots of a new chunk of the given size.  The chunk is
+  //! full, so it only joins the open chunks once one of its slots is freed.
+  void AllocateBlock(const size_t n, std::vector<void*>& nodes)
+  {
+    Chunk* chunk = NewChunk(n);
+    chunk->used = n;
+    chunk->live = n;
+
+    nodes.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      chunk->slots[i].chunk = chunk;
+      nodes[i] = (void*) chunk->slots[i].node;
+    }
+  }
+
+  //! Return a slot to its chunk, and free the chunk if it is empty.
+  void DeallocateSlot(void* p)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Slot* slot = (Slot*) p;
+    Chunk* chunk = slot->chunk;
+    slot->next = chunk->freeList;
+    chunk->freeList = slot;
+
+    if (chunk->live-- == chunk->size)
+    {
+      chunk->openIndex = open.size();
+      open.push_back(chunk);
+    }
+
+    if (chunk->live == 0)
+    {
+      // Remove the chunk from the list of open chunks.
+      Chunk* last = open.back();
+      open[chunk->openIndex] = last;
+      last->openIndex = chunk->openIndex;
+      open.pop_back();
+      DeleteChunk(chunk);
+    }
+  }
+
+  //! The chunks that have free slots.
+  std::vector<Chunk*> open;
+  //! The mutex that protects the pool.
+  std::mutex mutex;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -19,6 +19,24 @@
 namespace mlpack {
 namespace tree {
 
+/**
+ * An Octree is a tree where each node splits its cell in half along every
+ * dimension, so that each node has up to 2^d children; children that would
+ * hold no points are not created.  The dataset is reordered so that the points
+ * of each node are consecutive.
+ *
+ * The tree is usually built by recursively partitioning the points of each
+ * node.  For large low-dimensional dense datasets (for instance 3-dimensional
+ * point clouds), the tree can instead be built from Morton codes by passing
+ * mortonBuild = true to the constructors of the root: the cell of each point
+ * at each level is computed in parallel and stored as a 64-bit code (with
+ * 64 / d levels), the codes are sorted with a parallel radix sort, and the
+ * nodes are then found as the runs of codes with the same prefix.  The nodes
+ * below the levels given by the codes are split recursively as usual.  The
+ * resulting tree has the same nodes, holding the same points, as the tree
+ * built recursively; only the order of the points inside each leaf may
+ * differ, and it is reported through oldFromNew as usual.
+ */
 template<typename MetricType = metric::EuclideanDistance,
          typename StatisticType = EmptyStatistic,
          typename MatType = arma::mat>
@@ -72,8 +90,12 @@ class Octree
    *
    * @param data Dataset to create tree from.  This will be copied!
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param mortonBuild If true, build the tree from the sorted Morton codes
+   *      of the points (see the class documentation).
    */
-  Octree(const MatType& data, const size_t maxLeafSize = 20);
+  Octree(const MatType& data,
+         const size_t maxLeafSize = 20,
+         const bool mortonBuild = false);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -86,10 +108,13 @@ class Octree
    * @param oldFromNew Vector which will be filled with the old positions for
    *      each new point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param mortonBuild If true, build the tree from the sorted Morton codes
+   *      of the points (see the class documentation).
    */
   Octree(const MatType& data,
          std::vector<size_t>& oldFromNew,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const bool mortonBuild = false);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -105,11 +130,14 @@ class Octree
    * @param newFromOld Vector which will be filled with the new positions for
    *      each old point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param mortonBuild If true, build the tree from the sorted Morton codes
+   *      of the points (see the class documentation).
    */
   Octree(const MatType& data,
          std::vector<size_t>& oldFromNew,
          std::vector<size_t>& newFromOld,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const bool mortonBuild = false);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -118,8 +146,12 @@ class Octree
    *
    * @param data Dataset to create tree from.  This will be copied!
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param mortonBuild If true, build the tree from the sorted Morton codes
+   *      of the points (see the class documentation).
    */
-  Octree(MatType&& data, const size_t maxLeafSize = 20);
+  Octree(MatType&& data,
+         const size_t maxLeafSize = 20,
+         const bool mortonBuild = false);
 
   /**
    * Construct this as the root node of an octree on the given dataset. This
@@ -132,10 +164,13 @@ class Octree
    * @param oldFromNew Vector which will be filled with the old positions for
    *      each new point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param mortonBuild If true, build the tree from the sorted Morton codes
+   *      of the points (see the class documentation).
    */
   Octree(MatType&& data,
          std::vector<size_t>& oldFromNew,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const bool mortonBuild = false);
 
   /**
    * Construct this as the root node of an octree on the given dataset.  This
@@ -151,11 +186,14 @@ class Octree
    * @param newFromOld Vector which will be filled with the new positions for
    *      each old point.
    * @param maxLeafSize Maximum number of points in a leaf node.
+   * @param mortonBuild If true, build the tree from the sorted Morton codes
+   *      of the points (see the class documentation).
    */
   Octree(MatType&& data,
          std::vector<size_t>& oldFromNew,
          std::vector<size_t>& newFromOld,
-         const size_t maxLeafSize = 20);
+         const size_t maxLeafSize = 20,
+         const bool mortonBuild = false);
 
   /**
    * Construct this node as a child of the given parent, starting at column
@@ -413,6 +451,80 @@ class Octree
   friend class cereal::access;
 
  private:
+  /**
+   * Construct this node as a child of the given parent, holding the points in
+   * columns [begin, begin + count) of the dataset, which are sorted by the
+   * given Morton codes.  This is used by MortonBuild().
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point of the node.
+   * @param count Number of points of the node.
+   * @param center Center of the node (for splitting).
+   * @param width Width of the node in each dimension.
+   * @param codes Morton code of each point of the dataset.
+   * @param levels Number of levels held by each code.
+   * @param level Level of this node.
+   * @param oldFromNew Mappings from old to new (or NULL).
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(Octree* parent,
+         const size_t begin,
+         const size_t count,
+         const arma::vec& center,
+         const double width,
+         const std::vector<uint64_t>& codes,
+         const size_t levels,
+         const size_t level,
+         std::vector<size_t>* oldFromNew,
+         const size_t maxLeafSize);
+
+  /**
+   * Compute the bound of the root node, build the tree below it, and build
+   * the statistic.
+   *
+   * @param oldFromNew Mappings from old to new (or NULL).
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   * @param mortonBuild Whether to build the tree from Morton codes.
+   */
+  void BuildRoot(std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize,
+                 const bool mortonBuild);
+
+  /**
+   * Build the tree below the root from the Morton codes of the points: compute
+   * the codes, sort the points by code, and create the nodes.
+   *
+   * @param center Center of the root.
+   * @param width Width of the root.
+   * @param oldFromNew Mappings from old to new (or NULL).
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void MortonBuild(const arma::vec& center,
+                   const double width,
+                   std::vector<size_t>* oldFromNew,
+                   const size_t maxLeafSize);
+
+  /**
+   * Create the children of the node from the Morton codes of its points,
+   * which are sorted; below the levels held by the codes, the node is split
+   * with SplitNode().
+   *
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param codes Morton code of each point of the dataset.
+   * @param levels Number of levels held by each code.
+   * @param level Level of this node.
+   * @param oldFromNew Mappings from old to new (or NULL).
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void MortonSplitNode(const arma::vec& center,
+                       const double width,
+                       const std::vector<uint64_t>& codes,
+                       const size_t levels,
+                       const size_t level,
+                       std::vector<size_t>* oldFromNew,
+                       const size_t maxLeafSize);
+
   /**
    * Split the node, using the given center and the given maximum width of this
    * node.
@@ -14,6 +14,7 @@
 
 #include "octree.hpp"
 #include <mlpack/core/tree/perform_split.hpp>
+#include "radix_sort.hpp"
 #include <stack>
 
 namespace mlpack {
@@ -22,7 +23,8 @@ namespace tree {
 //! Construct the tree.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
-                                                   const size_t maxLeafSize) :
+                                                   const size_t maxLeafSize,
+                                                   const bool mortonBuild) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -30,29 +32,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
     parent(NULL),
     parentDistance(0.0)
 {
-  if (count > 0)
-  {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
-
-    double maxWidth = 0.0;
-    for (size_t i = 0; i < bound.Dim(); ++i)
-      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
-        maxWidth = bound[i].Hi() - bound[i].Lo();
-
-    SplitNode(center, maxWidth, maxLeafSize);
-
-    furthestDescendantDistance = 0.5 * bound.Diameter();
-  }
-  else
-  {
-    furthestDescendantDistance = 0.0;
-  }
-
-  // Initialize the statistic.
-  stat = StatisticType(*this);
+  BuildRoot(NULL, maxLeafSize, mortonBuild);
 }
 
 //! Construct the tree.
@@ -60,7 +40,8 @@ template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(
     const MatType& dataset,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool mortonBuild) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -72,29 +53,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
     oldFromNew[i] = i;
 
-  if (count > 0)
-  {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
-
-    double maxWidth = 0.0;
-    for (size_t i = 0; i < bound.Dim(); ++i)
-      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
-        maxWidth = bound[i].Hi() - bound[i].Lo();
-
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
-
-    furthestDescendantDistance = 0.5 * bound.Diameter();
-  }
-  else
-  {
-    furthestDescendantDistance = 0.0;
-  }
-
-  // Initialize the statistic.
-  stat = StatisticType(*this);
+  BuildRoot(&oldFromNew, maxLeafSize, mortonBuild);
 }
 
 //! Construct the tree.
@@ -103,7 +62,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     const MatType& dataset,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool mortonBuild) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -115,29 +75,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
     oldFromNew[i] = i;
 
-  if (count > 0)
-  {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
-
-    double maxWidth = 0.0;
-    for (size_t i = 0; i < bound.Dim(); ++i)
-      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
-        maxWidth = bound[i].Hi() - bound[i].Lo();
-
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
-
-    furthestDescendantDistance = 0.5 * bound.Diameter();
-  }
-  else
-  {
-    furthestDescendantDistance = 0.0;
-  }
-
-  // Initialize the statistic.
-  stat = StatisticType(*this);
+  BuildRoot(&oldFromNew, maxLeafSize, mortonBuild);
 
   // Map the newFromOld indices correctly.
   newFromOld.resize(this->dataset->n_cols);
@@ -148,7 +86,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 //! Construct the tree.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
-                                                   const size_t maxLeafSize) :
+                                                   const size_t maxLeafSize,
+                                                   const bool mortonBuild) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -156,29 +95,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
     parent(NULL),
     parentDistance(0.0)
 {
-  if (count > 0)
-  {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
-
-    double maxWidth = 0.0;
-    for (size_t i = 0; i < bound.Dim(); ++i)
-      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
-        maxWidth = bound[i].Hi() - bound[i].Lo();
-
-    SplitNode(center, maxWidth, maxLeafSize);
-
-    furthestDescendantDistance = 0.5 * bound.Diameter();
-  }
-  else
-  {
-    furthestDescendantDistance = 0.0;
-  }
-
-  // Initialize the statistic.
-  stat = StatisticType(*this);
+  BuildRoot(NULL, maxLeafSize, mortonBuild);
 }
 
 //! Construct the tree.
@@ -186,7 +103,8 @@ template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(
     MatType&& dataset,
     std::vector<size_t>& oldFromNew,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool mortonBuild) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -198,29 +116,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
     oldFromNew[i] = i;
 
-  if (count > 0)
-  {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
-
-    double maxWidth = 0.0;
-    for (size_t i = 0; i < bound.Dim(); ++i)
-      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
-        maxWidth = bound[i].Hi() - bound[i].Lo();
-
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
-
-    furthestDescendantDistance = 0.5 * bound.Diameter();
-  }
-  else
-  {
-    furthestDescendantDistance = 0.0;
-  }
-
-  // Initialize the statistic.
-  stat = StatisticType(*this);
+  BuildRoot(&oldFromNew, maxLeafSize, mortonBuild);
 }
 
 //! Construct the tree.
@@ -229,7 +125,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     MatType&& dataset,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    const size_t maxLeafSize) :
+    const size_t maxLeafSize,
+    const bool mortonBuild) :
     begin(0),
     count(dataset.n_cols),
     bound(dataset.n_rows),
@@ -241,29 +138,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
     oldFromNew[i] = i;
 
-  if (count > 0)
-  {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
-
-    double maxWidth = 0.0;
-    for (size_t i = 0; i < bound.Dim(); ++i)
-      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
-        maxWidth = bound[i].Hi() - bound[i].Lo();
-
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
-
-    furthestDescendantDistance = 0.5 * bound.Diameter();
-  }
-  else
-  {
-    furthestDescendantDistance = 0.0;
-  }
-
-  // Initialize the statistic.
-  stat = StatisticType(*this);
+  BuildRoot(&oldFromNew, maxLeafSize, mortonBuild);
 
   // Map the newFromOld indices correctly.
   newFromOld.resize(this->dataset->n_cols);
@@ -340,6 +215,45 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   stat = StatisticType(*this);
 }
 
+//! Construct a child node from the Morton codes of its points.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    Octree* parent,
+    const size_t begin,
+    const size_t count,
+    const arma::vec& center,
+    const double width,
+    const std::vector<uint64_t>& codes,
+    const size_t levels,
+    const size_t level,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent)
+{
+  // Calculate empirical center of data.
+  bound |= dataset->cols(begin, begin + count - 1);
+
+  // Now split the node.
+  MortonSplitNode(center, width, codes, levels, level, oldFromNew,
+      maxLeafSize);
+
+  // Calculate the distance from the empirical center of this node to the
+  // empirical center of the parent.
+  arma::vec trueCenter, parentCenter;
+  bound.Center(trueCenter);
+  parent->Bound().Center(parentCenter);
+  parentDistance = metric.Evaluate(trueCenter, parentCenter);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
 //! Copy the given tree.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(const Octree& other) :
@@ -770,6 +684,207 @@ void Octree<MetricType, StatisticType, MatType>::serialize(
   }
 }
 
+//! Build the tree below the root.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::BuildRoot(
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize,
+    const bool mortonBuild)
+{
+  if (count > 0)
+  {
+    // Calculate empirical center of data.
+    bound |= *dataset;
+    arma::vec center;
+    bound.Center(center);
+
+    double maxWidth = 0.0;
+    for (size_t i = 0; i < bound.Dim(); ++i)
+      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
+        maxWidth = bound[i].Hi() - bound[i].Lo();
+
+    if (mortonBuild)
+      MortonBuild(center, maxWidth, oldFromNew, maxLeafSize);
+    else if (oldFromNew)
+      SplitNode(center, maxWidth, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, maxLeafSize);
+
+    furthestDescendantDistance = 0.5 * bound.Diameter();
+  }
+  else
+  {
+    furthestDescendantDistance = 0.0;
+  }
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
+//! Build the tree below the root from the Morton codes of the points.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonBuild(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // Each level of the codes holds one bit per dimension.
+  const size_t dims = dataset->n_rows;
+  const size_t levels = (dims == 0) ? 0 : 64 / dims;
+  if (levels == 0 || count <= maxLeafSize)
+  {
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  // Compute the code of each point by following its cells down the tree, with
+  // the same arithmetic as SplitNode(), so that the points fall on the same
+  // sides of the splits.  Bit d of the digit of a level is set if the point is
+  // on the right of the center of its cell in dimension d, as for the index of
+  // the children in SplitNode(); the first level is the most significant.
+  std::vector<uint64_t> codes(count);
+  #pragma omp parallel
+  {
+    arma::vec cellCenter(dims);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+    {
+      cellCenter = center;
+      double cellWidth = width;
+      uint64_t code = 0;
+      for (size_t l = 0; l < levels; ++l)
+      {
+        const double childWidth = cellWidth / 2.0;
+        uint64_t digit = 0;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          if ((*dataset)(d, i) < cellCenter[d])
+          {
+            cellCenter[d] -= childWidth;
+          }
+          else
+          {
+            digit |= ((uint64_t) 1 << d);
+            cellCenter[d] += childWidth;
+          }
+        }
+
+        code |= digit << (dims * (levels - 1 - l));
+        cellWidth = childWidth;
+      }
+
+      codes[i] = code;
+    }
+  }
+
+  std::vector<size_t> order(count);
+  for (size_t i = 0; i < count; ++i)
+    order[i] = i;
+  ParallelRadixSort(codes, order);
+
+  // Reorder the points by code.
+  MatType sortedDataset(dataset->n_rows, dataset->n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+    sortedDataset.col(i) = dataset->col(order[i]);
+  *dataset = std::move(sortedDataset);
+
+  if (oldFromNew)
+  {
+    const std::vector<size_t> oldIndices(*oldFromNew);
+    for (size_t i = 0; i < count; ++i)
+      (*oldFromNew)[i] = oldIndices[order[i]];
+  }
+
+  MortonSplitNode(center, width, codes, levels, 0, oldFromNew, maxLeafSize);
+}
+
+//! Create the children of the node from the sorted Morton codes.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonSplitNode(
+    const arma::vec& center,
+    const double width,
+    const std::vector<uint64_t>& codes,
+    const size_t levels,
+    const size_t level,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node.
+  if (count <= maxLeafSize)
+    return;
+
+  // Below the levels held by the codes, split the node recursively.
+  if (level == levels)
+  {
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  // The points are sorted by code, so the points of each child are a run of
+  // points with the same digit at this level, and the runs are in the order of
+  // the children in SplitNode().
+  const size_t dims = dataset->n_rows;
+  const size_t shift = dims * (levels - 1 - level);
+  const uint64_t mask = (dims == 64) ? ~((uint64_t) 0) :
+      (((uint64_t) 1 << dims) - 1);
+  std::vector<size_t> childBegins;
+  std::vector<size_t> childIndices;
+  for (size_t i = begin; i < begin + count; ++i)
+  {
+    const size_t digit = (size_t) ((codes[i] >> shift) & mask);
+    if (childIndices.empty() || digit != childIndices.back())
+    {
+      childBegins.push_back(i);
+      childIndices.push_back(digit);
+    }
+  }
+  childBegins.push_back(begin + count);
+
+  const double childWidth = width / 2.0;
+  children.resize(childIndices.size());
+  auto createChild = [&](const size_t c)
+  {
+    // Create the correct center.
+    arma::vec childCenter(center.n_elem);
+    for (size_t d = 0; d < center.n_elem; ++d)
+    {
+      // Is the dimension "right" (1) or "left" (0)?
+      if (((childIndices[c] >> d) & 1) == 0)
+        childCenter[d] = center[d] - childWidth;
+      else
+        childCenter[d] = center[d] + childWidth;
+    }
+
+    children[c] = new Octree(this, childBegins[c],
+        childBegins[c + 1] - childBegins[c], childCenter, childWidth, codes,
+        levels, level + 1, oldFromNew, maxLeafSize);
+  };
+
+  // The children of the root hold disjoint ranges of points, so they are built
+  // in parallel.
+  if (level == 0)
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) children.size(); ++c)
+      createChild(c);
+  }
+  else
+  {
+    for (size_t c = 0; c < children.size(); ++c)
+      createChild(c);
+  }
+}
+
 //! Split the node.
 template<typename MetricType, typename StatisticType, typename MatType>
 void Octree<MetricType, StatisticType, MatType>::SplitNode(
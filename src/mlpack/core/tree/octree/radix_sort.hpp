@@ -0,0 +1,107 @@
+/**
+ * @file core/tree/octree/radix_sort.hpp
+ *
+ * Definition of ParallelRadixSort(), which sorts point indices by 64-bit keys
+ * with several threads; it is used to build an Octree from Morton codes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_OCTREE_RADIX_SORT_HPP
+#define MLPACK_CORE_TREE_OCTREE_RADIX_SORT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Sort the given keys, and reorder the given values in the same way, with a
+ * least-significant-digit radix sort on 8-bit digits.  The sort is stable, so
+ * the result does not depend on the number of threads.  Each pass splits the
+ * elements into one block per thread, counts the digits of each block in
+ * parallel, and then scatters the blocks in parallel; passes in which all the
+ * keys have the same digit are skipped.
+ *
+ * @param keys Keys to sort.
+ * @param values Values to reorder with the keys (of the same size).
+ */
+inline void ParallelRadixSort(std::vector<uint64_t>& keys,
+                              std::vector<size_t>& values)
+{
+  const size_t count = keys.size();
+  const size_t numDigits = 256;
+
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  if (!omp_in_parallel())
+    numBlocks = std::min((size_t) omp_get_max_threads(), count / 65536 + 1);
+  #endif
+
+  std::vector<size_t> offsets(numBlocks + 1);
+  for (size_t b = 0; b <= numBlocks; ++b)
+    offsets[b] = count * b / numBlocks;
+
+  std::vector<uint64_t> keyBuffer(count);
+  std::vector<size_t> valueBuffer(count);
+  // positions[b * numDigits + digit] is the next position of the given digit
+  // for block b.
+  std::vector<size_t> positions(numBlocks * numDigits);
+
+  for (size_t shift = 0; shift < 64; shift += 8)
+  {
+    std::fill(positions.begin(), positions.end(), 0);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      size_t* histogram = positions.data() + b * numDigits;
+      for (size_t i = offsets[b]; i < offsets[b + 1]; ++i)
+        ++histogram[(keys[i] >> shift) & 0xFF];
+    }
+
+    // Turn the counts into starting positions, digit by digit and then block
+    // by block, so that the order of equal digits is kept.
+    size_t position = 0;
+    bool skip = false;
+    for (size_t digit = 0; digit < numDigits; ++digit)
+    {
+      size_t digitCount = 0;
+      for (size_t b = 0; b < numBlocks; ++b)
+      {
+        const size_t blockCount = positions[b * numDigits + digit];
+        positions[b * numDigits + digit] = position;
+        position += blockCount;
+        digitCount += blockCount;
+      }
+
+      if (digitCount == count)
+        skip = true;
+    }
+
+    if (skip)
+      continue;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      size_t* blockPositions = positions.data() + b * numDigits;
+      for (size_t i = offsets[b]; i < offsets[b + 1]; ++i)
+      {
+        const size_t p = blockPositions[(keys[i] >> shift) & 0xFF]++;
+        keyBuffer[p] = keys[i];
+        valueBuffer[p] = values[i];
+      }
+    }
+
+    keys.swap(keyBuffer);
+    values.swap(valueBuffer);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
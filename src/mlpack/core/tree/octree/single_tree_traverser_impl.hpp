@@ -14,6 +14,8 @@
 
 // In case it hasn't been included yet.
 #include "single_tree_traverser.hpp"
+#include "../child_bounds.hpp"
+#include "../prefetch.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -55,15 +57,32 @@ void Octree<MetricType, StatisticType, MatType>::SingleTreeTraverser<RuleType>::
       }
     }
 
-    // Do a prioritized recursion, by scoring all candidates and then sorting
-    // them.
-    arma::vec scores(referenceNode.NumChildren());
-    for (size_t i = 0; i < scores.n_elem; ++i)
-      scores[i] = rule.Score(queryIndex, referenceNode.Child(i));
+    // Request all children from memory before scoring any, so that the loads
+    // overlap.
+    for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+      PrefetchNode(referenceNode.Child(i));
+
+    // Do a prioritized recursion, by scoring all candidates (at once, if the
+    // rules can do that) and then sorting them.
+    arma::vec scores;
+    ScoreChildren(rule, queryIndex, referenceNode, scores);
 
     // Sort the scores.
     arma::uvec sortedIndices = arma::sort_index(scores);
 
+    // Prefetch the points of the first leaf child that may be visited; they
+    // are loaded while the children before it are traversed.
+    for (size_t i = 0; i < sortedIndices.n_elem; ++i)
+    {
+      if (scores[sortedIndices[i]] == DBL_MAX)
+        break;
+      if (referenceNode.Child(sortedIndices[i]).IsLeaf())
+      {
+        PrefetchLeafPoints(referenceNode.Child(sortedIndices[i]));
+        break;
+      }
+    }
+
     for (size_t i = 0; i < sortedIndices.n_elem; ++i)
     {
       // If the node is pruned, all subsequent nodes in sorted order will also
@@ -0,0 +1,142 @@
+/**
+ * @file core/tree/prefetch.hpp
+ *
+ * Definition of the PrefetchNode() and PrefetchPoints() functions, which the
+ * tree traversers use to request the nodes and points they are about to visit
+ * from memory ahead of time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PREFETCH_HPP
+#define MLPACK_CORE_TREE_PREFETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hrectbound.hpp"
+#include "ballbound.hpp"
+
+/**
+ * Prefetch the cache line holding the given address for reading.  This is a
+ * hint only; it does nothing if the compiler has no prefetch intrinsic.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+  #define MLPACK_PREFETCH(address) \
+      __builtin_prefetch((const void*) (address), 0, 3)
+#else
+  #define MLPACK_PREFETCH(address) ((void) (address))
+#endif
+
+namespace mlpack {
+namespace tree {
+
+//! The number of bytes assumed for a cache line.
+static constexpr size_t PrefetchLineSize = 64;
+//! The maximum number of cache lines prefetched for one block of memory.
+static constexpr size_t PrefetchMaxLines = 8;
+
+/**
+ * Prefetch up to PrefetchMaxLines cache lines of the given block of memory.
+ */
+inline force_inline void PrefetchBlock(const void* address, const size_t bytes)
+{
+  const char* block = (const char*) address;
+  const size_t lines = std::min((bytes + PrefetchLineSize - 1) /
+      PrefetchLineSize, PrefetchMaxLines);
+  for (size_t i = 0; i < lines; ++i)
+    MLPACK_PREFETCH(block + i * PrefetchLineSize);
+}
+
+/**
+ * Prefetch a bound whose data is held inside the bound object.
+ */
+template<typename BoundType>
+inline force_inline void PrefetchBound(const BoundType& bound)
+{
+  MLPACK_PREFETCH(&bound);
+}
+
+/**
+ * Prefetch a hyperrectangle bound, whose ranges are held in a separate array.
+ */
+template<typename MetricType, typename ElemType>
+inline force_inline void PrefetchBound(
+    const HRectBound<MetricType, ElemType>& bound)
+{
+  MLPACK_PREFETCH(&bound);
+  if (bound.Dim() > 0)
+  {
+    PrefetchBlock(&bound[0],
+        bound.Dim() * sizeof(math::RangeType<ElemType>));
+  }
+}
+
+/**
+ * Prefetch a ball bound, whose center is held in a separate vector.
+ */
+template<typename MetricType, typename VecType>
+inline force_inline void PrefetchBound(
+    const BallBound<MetricType, VecType>& bound)
+{
+  MLPACK_PREFETCH(&bound);
+  PrefetchBlock(bound.Center().memptr(),
+      bound.Center().n_elem * sizeof(typename VecType::elem_type));
+}
+
+/**
+ * Prefetch the given node and its bound, so that they are in cache when the
+ * node is scored.
+ */
+template<typename TreeType>
+inline force_inline void PrefetchNode(const TreeType& node)
+{
+  MLPACK_PREFETCH(&node);
+  PrefetchBound(node.Bound());
+}
+
+/**
+ * Prefetch the first cache lines of the given contiguous range of points of a
+ * dense dataset, so that they are in cache when the base cases are computed.
+ */
+template<typename MatType>
+inline force_inline
+typename std::enable_if_t<arma::is_Mat<MatType>::value>
+PrefetchPoints(const MatType& dataset, const size_t begin, const size_t count)
+{
+  if (count == 0 || begin >= dataset.n_cols)
+    return;
+
+  PrefetchBlock(dataset.colptr(begin),
+      count * dataset.n_rows * sizeof(typename MatType::elem_type));
+}
+
+/**
+ * Sparse datasets are not prefetched: the columns are not contiguous blocks.
+ */
+template<typename MatType>
+inline force_inline
+typename std::enable_if_t<!arma::is_Mat<MatType>::value>
+PrefetchPoints(const MatType& /* dataset */,
+               const size_t /* begin */,
+               const size_t /* count */)
+{
+  // Nothing to do.
+}
+
+/**
+ * Prefetch the points of the given node, if it is a leaf of a tree that holds
+ * the points of each node contiguously in the dataset (BinarySpaceTree and
+ * Octree).
+ */
+template<typename TreeType>
+inline force_inline void PrefetchLeafPoints(const TreeType& node)
+{
+  if (node.IsLeaf() && node.NumPoints() > 0)
+    PrefetchPoints(node.Dataset(), node.Point(0), node.NumPoints());
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file core/tree/prepared_queries.hpp
+ *
+ * Definition of the PreparedQueries and PreparedQueryTree classes, which hold
+ * a query set (and possibly a tree built on it) that is searched several times.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PREPARED_QUERIES_HPP
+#define MLPACK_CORE_TREE_PREPARED_QUERIES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * PreparedQueries holds a query set that will be used for several searches, so
+ * that whatever is built on the query set is only built once.  The models that
+ * hide their tree type (NSModel, RSModel and KDEModel) return these objects
+ * from their PrepareQueries() methods; when the search mode uses a query tree,
+ * the returned object is a PreparedQueryTree, which also holds the tree.
+ *
+ * The query tree may reorder the points of the query set; QuerySet() returns
+ * the points in the order of the tree, and Unmap() moves results computed in
+ * that order back into the original order of the queries.
+ */
+class PreparedQueries
+{
+ public:
+  //! Hold the given query set, without a tree.
+  PreparedQueries(arma::mat&& querySet) : querySet(std::move(querySet)) { }
+
+  //! Destruct the object.
+  virtual ~PreparedQueries() { }
+
+  // The tree of a PreparedQueryTree is owned, so these cannot be copied.
+  PreparedQueries(const PreparedQueries&) = delete;
+  PreparedQueries& operator=(const PreparedQueries&) = delete;
+
+  //! Get the query points (in the order of the tree, if there is one).
+  virtual const arma::mat& QuerySet() const { return querySet; }
+
+  //! Get the index of each point of QuerySet() in the original query set (this
+  //! is empty if the points were not reordered).
+  const std::vector<size_t>& OldFromNew() const { return oldFromNew; }
+
+  //! Move the columns of the given results, computed for the points of
+  //! QuerySet(), into the original order of the queries.
+  template<typename eT>
+  void Unmap(arma::Mat<eT>& results) const
+  {
+    if (oldFromNew.empty())
+      return;
+
+    arma::Mat<eT> unmapped(results.n_rows, results.n_cols);
+    for (size_t i = 0; i < results.n_cols; ++i)
+      unmapped.col(oldFromNew[i]) = results.col(i);
+    results = std::move(unmapped);
+  }
+
+  //! Move the elements of the given results, computed for the points of
+  //! QuerySet(), into the original order of the queries.
+  template<typename T>
+  void Unmap(std::vector<T>& results) const
+  {
+    if (oldFromNew.empty())
+      return;
+
+    std::vector<T> unmapped(results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+      unmapped[oldFromNew[i]] = std::move(results[i]);
+    results = std::move(unmapped);
+  }
+
+ protected:
+  //! Create the object for a subclass which holds the points elsewhere.
+  PreparedQueries(std::vector<size_t>&& oldFromNew) :
+      oldFromNew(std::move(oldFromNew)) { }
+
+  //! The query set, if there is no tree.
+  arma::mat querySet;
+  //! The original index of each point of QuerySet().
+  std::vector<size_t> oldFromNew;
+};
+
+/**
+ * PreparedQueryTree holds a query tree that will be used for several searches.
+ * The searches reset the statistics of the tree when they need to, so the tree
+ * does not have to be rebuilt.
+ *
+ * @tparam TreeType Type of the query tree.
+ */
+template<typename TreeType>
+class PreparedQueryTree : public PreparedQueries
+{
+ public:
+  /**
+   * Take ownership of the given query tree.
+   *
+   * @param tree Query tree, allocated with new.
+   * @param oldFromNew Original index of each point of the tree's dataset, or
+   *     an empty vector if the tree did not reorder the points.
+   */
+  PreparedQueryTree(TreeType* tree, std::vector<size_t>&& oldFromNew) :
+      PreparedQueries(std::move(oldFromNew)),
+      tree(tree)
+  {
+    // Nothing to do.
+  }
+
+  //! Delete the tree.
+  virtual ~PreparedQueryTree() { delete tree; }
+
+  //! Get the query points, in the order of the tree.
+  virtual const arma::mat& QuerySet() const { return tree->Dataset(); }
+
+  //! Get the query tree.
+  TreeType& Tree() { return *tree; }
+
+ private:
+  //! The query tree.
+  TreeType* tree;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
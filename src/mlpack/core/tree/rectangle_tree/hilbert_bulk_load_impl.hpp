@@ -0,0 +1,50 @@
+/**
+ * @file core/tree/rectangle_tree/hilbert_bulk_load_impl.hpp
+ *
+ * Implementation of the HilbertBulkLoad class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_BULK_LOAD_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_BULK_LOAD_IMPL_HPP
+
+#include "hilbert_bulk_load.hpp"
+#include "parallel_sort.hpp"
+
+#include <numeric>
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void HilbertBulkLoad::Order(const MatType& points,
+                            const size_t /* groupSize */,
+                            std::vector<size_t>& order)
+{
+  typedef DiscreteHilbertValue<typename MatType::elem_type> HilbertValueType;
+  typedef typename HilbertValueType::HilbertElemType HilbertElemType;
+
+  arma::Mat<HilbertElemType> values(points.n_rows, points.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    values.col(i) = HilbertValueType::CalculateValue(points.col(i));
+
+  order.resize(points.n_cols);
+  std::iota(order.begin(), order.end(), 0);
+
+  // Compare the values in place, without copying them.
+  ParallelSort(order, 0, order.size(), [&values](const size_t a,
+      const size_t b)
+  {
+    return HilbertValueType::CompareValues(values.unsafe_col(a),
+        values.unsafe_col(b)) < 0;
+  });
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
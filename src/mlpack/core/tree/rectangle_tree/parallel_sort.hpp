@@ -0,0 +1,79 @@
+/**
+ * @file core/tree/rectangle_tree/parallel_sort.hpp
+ *
+ * Definition of ParallelSort(), which sorts a range of point indices with
+ * several threads; it is used when bulk loading a RectangleTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_PARALLEL_SORT_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_PARALLEL_SORT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Sort the elements [begin, end) of the given vector with the given
+ * comparator.  The range is split into one chunk per thread; the chunks are
+ * sorted in parallel and then merged pairwise.  Small ranges, and calls from
+ * inside a parallel region, are sorted with std::sort.
+ *
+ * @param elements Vector holding the range to sort.
+ * @param begin Index of the first element of the range.
+ * @param end Index after the last element of the range.
+ * @param compare Comparator, as for std::sort.
+ */
+template<typename CompareType>
+void ParallelSort(std::vector<size_t>& elements,
+                  const size_t begin,
+                  const size_t end,
+                  CompareType compare)
+{
+  const size_t count = end - begin;
+  std::vector<size_t>::iterator first = elements.begin() + begin;
+
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+  if (!omp_in_parallel())
+    numChunks = std::min((size_t) omp_get_max_threads(), count / 4096 + 1);
+  #endif
+
+  if (numChunks <= 1)
+  {
+    std::sort(first, first + count, compare);
+    return;
+  }
+
+  std::vector<size_t> offsets(numChunks + 1);
+  for (size_t c = 0; c <= numChunks; ++c)
+    offsets[c] = count * c / numChunks;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    std::sort(first + offsets[c], first + offsets[c + 1], compare);
+
+  // Merge neighboring runs, doubling their width each round.
+  for (size_t width = 1; width < numChunks; width *= 2)
+  {
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; c += 2 * width)
+    {
+      if ((size_t) c + width < numChunks)
+      {
+        const size_t last = std::min((size_t) c + 2 * width, numChunks);
+        std::inplace_merge(first + offsets[c], first + offsets[c + width],
+            first + offsets[last], compare);
+      }
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
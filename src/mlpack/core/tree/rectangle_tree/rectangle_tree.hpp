@@ -17,9 +17,14 @@
 
 #include "../hrectbound.hpp"
 #include "../statistic.hpp"
+#include "../node_pool.hpp"
+#include "../tree_traits.hpp"
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
+#include "hilbert_r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "str_bulk_load.hpp"
+#include "hilbert_bulk_load.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -156,6 +161,62 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset, instead of inserting the points one by one.  The
+   * BulkLoadType (STRBulkLoad or HilbertBulkLoad) orders the points, and each
+   * run of maxLeafSize points in that order becomes a leaf; the nodes of each
+   * level are then ordered and grouped the same way, maxNumChildren at a
+   * time, up to the root.  So every node is full, except possibly the last two
+   * nodes of each level, which share their points evenly.  This is much faster
+   * than insertion; points may still be inserted and deleted afterwards.
+   *
+   * Bulk loading is not available for trees whose split keeps extra
+   * invariants, that is, Hilbert R trees and R+ and R++ trees.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoad Instantiated bulk loading policy (it holds no state).
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  template<typename BulkLoadType>
+  RectangleTree(const MatType& data,
+                const BulkLoadType& bulkLoad,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2,
+                typename std::enable_if_t<
+                    !std::is_arithmetic<BulkLoadType>::value>* = 0);
+
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset, and taking ownership of the given dataset.  See the
+   * constructor above for details.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoad Instantiated bulk loading policy (it holds no state).
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  template<typename BulkLoadType>
+  RectangleTree(MatType&& data,
+                const BulkLoadType& bulkLoad,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2,
+                typename std::enable_if_t<
+                    !std::is_arithmetic<BulkLoadType>::value>* = 0);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -215,6 +276,14 @@ class RectangleTree
    */
   ~RectangleTree();
 
+  //! Allocate nodes from a NodePool, so that nodes are contiguous in memory.
+  static void* operator new(size_t size)
+  { return NodePool<RectangleTree>::Allocate(size); }
+
+  //! Return the memory of a node to its NodePool.
+  static void operator delete(void* p, size_t size)
+  { NodePool<RectangleTree>::Deallocate(p, size); }
+
   /**
    * Delete this node of the tree, but leave the stuff contained in it intact.
    * This is used when splitting a node, where the data in this tree is moved to
@@ -564,6 +633,23 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  /**
+   * Build the tree below this (empty) root node from the whole dataset, with
+   * the given bulk loading policy.
+   */
+  template<typename BulkLoadType>
+  void BulkLoad();
+
+  /**
+   * Compute the offsets of the groups of the given number of elements, with at
+   * most maxSize elements in each group.  If the last group would have fewer
+   * than minSize elements, the last two groups share their elements evenly.
+   */
+  static void GroupOffsets(const size_t numElements,
+                           const size_t maxSize,
+                           const size_t minSize,
+                           std::vector<size_t>& offsets);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
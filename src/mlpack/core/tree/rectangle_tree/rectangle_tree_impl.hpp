@@ -121,6 +121,86 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename BulkLoadType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadType& /* bulkLoad */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren,
+              typename std::enable_if_t<
+                  !std::is_arithmetic<BulkLoadType>::value>*) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad<BulkLoadType>();
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename BulkLoadType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadType& /* bulkLoad */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren,
+              typename std::enable_if_t<
+                  !std::is_arithmetic<BulkLoadType>::value>*) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad<BulkLoadType>();
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -459,6 +539,126 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   auxiliaryInfo.NullifyData();
 }
 
+/**
+ * Build the tree bottom-up: order the points and cut the order into leaves,
+ * then order the centers of the nodes of each level and cut that order into
+ * the nodes of the next level, until at most maxNumChildren nodes are left.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename BulkLoadType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad()
+{
+  // The Hilbert R tree keeps its children sorted by Hilbert value, and R+ and
+  // R++ trees keep their children disjoint; packing gives neither.
+  static_assert(TreeTraits<RectangleTree>::HasOverlappingChildren,
+      "RectangleTree: bulk loading cannot build R+ or R++ trees.");
+  static_assert(!std::is_same<DescentType, HilbertRTreeDescentHeuristic>::value,
+      "RectangleTree: bulk loading cannot build Hilbert R trees.");
+
+  // A small dataset fits into this node.
+  if (dataset->n_cols <= maxLeafSize)
+  {
+    for (size_t i = 0; i < dataset->n_cols; ++i)
+    {
+      bound |= dataset->col(i);
+      points[count++] = i;
+    }
+
+    numDescendants = count;
+    return;
+  }
+
+  std::vector<size_t> order, offsets;
+  BulkLoadType::Order(*dataset, maxLeafSize, order);
+  GroupOffsets(dataset->n_cols, maxLeafSize, minLeafSize, offsets);
+
+  // The new nodes are created as children of this node, so that they get its
+  // parameters; their parents are set when they are grouped.
+  std::vector<RectangleTree*> nodes(offsets.size() - 1);
+  for (size_t g = 0; g < nodes.size(); ++g)
+  {
+    RectangleTree* leaf = new RectangleTree(this);
+    for (size_t i = offsets[g]; i < offsets[g + 1]; ++i)
+    {
+      leaf->bound |= dataset->col(order[i]);
+      leaf->points[leaf->count++] = order[i];
+    }
+
+    leaf->numDescendants = leaf->count;
+    nodes[g] = leaf;
+  }
+
+  arma::Col<ElemType> center;
+  while (nodes.size() > maxNumChildren)
+  {
+    arma::Mat<ElemType> centers(dataset->n_rows, nodes.size());
+    for (size_t j = 0; j < nodes.size(); ++j)
+    {
+      nodes[j]->bound.Center(center);
+      centers.col(j) = center;
+    }
+
+    BulkLoadType::Order(centers, maxNumChildren, order);
+    GroupOffsets(nodes.size(), maxNumChildren, minNumChildren, offsets);
+
+    std::vector<RectangleTree*> parents(offsets.size() - 1);
+    for (size_t g = 0; g < parents.size(); ++g)
+    {
+      RectangleTree* node = new RectangleTree(this);
+      for (size_t i = offsets[g]; i < offsets[g + 1]; ++i)
+      {
+        RectangleTree* child = nodes[order[i]];
+        node->bound |= child->bound;
+        node->numDescendants += child->numDescendants;
+        node->children[node->numChildren++] = child;
+        child->parent = node;
+      }
+
+      parents[g] = node;
+    }
+
+    nodes.swap(parents);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    bound |= nodes[i]->bound;
+    numDescendants += nodes[i]->numDescendants;
+    children[numChildren++] = nodes[i];
+    nodes[i]->parent = this;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    GroupOffsets(const size_t numElements,
+                 const size_t maxSize,
+                 const size_t minSize,
+                 std::vector<size_t>& offsets)
+{
+  const size_t numGroups = (numElements + maxSize - 1) / maxSize;
+  offsets.resize(numGroups + 1);
+  for (size_t g = 0; g < numGroups; ++g)
+    offsets[g] = g * maxSize;
+  offsets[numGroups] = numElements;
+
+  if (numGroups > 1 && numElements - offsets[numGroups - 1] < minSize)
+    offsets[numGroups - 1] = (offsets[numGroups - 2] + numElements + 1) / 2;
+}
+
 /**
  * Recurse through the tree and insert the point at the leaf node chosen
  * by the heuristic.
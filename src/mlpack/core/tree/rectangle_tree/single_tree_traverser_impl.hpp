@@ -15,6 +15,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_SINGLE_TREE_TRAVERSER_IMPL_HPP
 
 #include "single_tree_traverser.hpp"
+#include "../child_bounds.hpp"
 
 #include <algorithm>
 #include <stack>
@@ -59,12 +60,16 @@ SingleTreeTraverser<RuleType>::Traverse(
   }
 
   // This is not a leaf node so we sort the children of this node by their
-  // scores.
+  // scores (computed at once, if the rules can do that).  The children are not
+  // const, so neither is the node, for the rules.
+  arma::vec scores;
+  ScoreChildren(rule, queryIndex, const_cast<RectangleTree&>(referenceNode),
+      scores);
   std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
   for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
   {
     nodesAndScores[i].node = &(referenceNode.Child(i));
-    nodesAndScores[i].score = rule.Score(queryIndex, *nodesAndScores[i].node);
+    nodesAndScores[i].score = scores[i];
   }
 
   std::sort(nodesAndScores.begin(), nodesAndScores.end(), NodeComparator);
@@ -0,0 +1,75 @@
+/**
+ * @file core/tree/rectangle_tree/str_bulk_load.hpp
+ *
+ * Definition of the STRBulkLoad class, which orders points with
+ * Sort-Tile-Recursive packing to bulk load a RectangleTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_STR_BULK_LOAD_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_STR_BULK_LOAD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The STRBulkLoad class orders points with the Sort-Tile-Recursive algorithm
+ * of Leutenegger et al., so that a RectangleTree can be bulk loaded by cutting
+ * the order into groups.  With P groups in d dimensions, the points are sorted
+ * by the first coordinate and cut into ceil(P^(1/d)) slabs of whole groups;
+ * each slab is then tiled the same way in the remaining dimensions.  The slabs
+ * are tiled in parallel.
+ *
+ * @code
+ * @inproceedings{leutenegger1997str,
+ *   title={STR: A Simple and Efficient Algorithm for R-Tree Packing},
+ *   author={Leutenegger, Scott T. and Lopez, Mario A. and Edgington, Jeffrey},
+ *   booktitle={Proceedings of the 13th International Conference on Data
+ *       Engineering (ICDE 1997)},
+ *   pages={497--506},
+ *   year={1997}
+ * }
+ * @endcode
+ */
+class STRBulkLoad
+{
+ public:
+  /**
+   * Order the columns of the given matrix so that each run of groupSize
+   * consecutive points in the order (and the rest, at the end) forms a tile.
+   *
+   * @param points Matrix of points (or node centers) to order.
+   * @param groupSize Number of points in each group.
+   * @param order Vector that will hold the order of the columns.
+   */
+  template<typename MatType>
+  static void Order(const MatType& points,
+                    const size_t groupSize,
+                    std::vector<size_t>& order);
+
+ private:
+  /**
+   * Tile the points order[begin], ..., order[end - 1] in the dimensions from
+   * dim on.
+   */
+  template<typename MatType>
+  static void Tile(const MatType& points,
+                   const size_t groupSize,
+                   std::vector<size_t>& order,
+                   const size_t begin,
+                   const size_t end,
+                   const size_t dim);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "str_bulk_load_impl.hpp"
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file core/tree/rectangle_tree/str_bulk_load_impl.hpp
+ *
+ * Implementation of the STRBulkLoad class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_STR_BULK_LOAD_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_STR_BULK_LOAD_IMPL_HPP
+
+#include "str_bulk_load.hpp"
+#include "parallel_sort.hpp"
+
+#include <numeric>
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void STRBulkLoad::Order(const MatType& points,
+                        const size_t groupSize,
+                        std::vector<size_t>& order)
+{
+  order.resize(points.n_cols);
+  std::iota(order.begin(), order.end(), 0);
+
+  if (points.n_cols > 0)
+    Tile(points, groupSize, order, 0, points.n_cols, 0);
+}
+
+template<typename MatType>
+void STRBulkLoad::Tile(const MatType& points,
+                       const size_t groupSize,
+                       std::vector<size_t>& order,
+                       const size_t begin,
+                       const size_t end,
+                       const size_t dim)
+{
+  ParallelSort(order, begin, end, [&points, dim](const size_t a,
+      const size_t b) { return points(dim, a) < points(dim, b); });
+
+  const size_t numGroups = (end - begin + groupSize - 1) / groupSize;
+  if (dim + 1 == points.n_rows || numGroups <= 1)
+    return;
+
+  // Cut the points into slabs of whole groups, so that only the last group of
+  // the whole order can be partial.  (The small offset keeps exact roots, like
+  // 8^(1/3), from being rounded up.)
+  const size_t numSlabs = (size_t) std::ceil(std::pow((double) numGroups,
+      1.0 / (points.n_rows - dim)) - 1e-9);
+  const size_t slabSize = ((numGroups + numSlabs - 1) / numSlabs) * groupSize;
+  const size_t slabs = (end - begin + slabSize - 1) / slabSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t s = 0; s < (omp_size_t) slabs; ++s)
+  {
+    Tile(points, groupSize, order, begin + s * slabSize,
+        std::min(begin + (s + 1) * slabSize, end), dim + 1);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -62,8 +62,11 @@ bool SpaceSplit<MetricType, MatType>::GetProjVector(
 {
   MetricType metric;
 
-  // Efficiently estimate the farthest pair of points in the given set.
-  size_t fst = points[rand() % points.n_elem];
+  // Efficiently estimate the farthest pair of points in the given set,
+  // starting from the point in the middle of the list.  (The start is not
+  // random, so that the tree does not depend on the order in which the nodes
+  // are split, and can be built in parallel.)
+  size_t fst = points[points.n_elem / 2];
   size_t snd = points[0];
   double max = metric.Evaluate(data.col(fst), data.col(snd));
 
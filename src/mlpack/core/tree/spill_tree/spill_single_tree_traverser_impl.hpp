@@ -17,6 +17,7 @@
 
 // In case it hasn't been included yet.
 #include "spill_single_tree_traverser.hpp"
+#include "../prefetch.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -74,6 +75,11 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
     }
     else
     {
+      // Request both children from memory before scoring either, so that the
+      // loads overlap.
+      PrefetchNode(*referenceNode.Left());
+      PrefetchNode(*referenceNode.Right());
+
       // If either score is DBL_MAX, we do not recurse into that node.
       double leftScore = rule.Score(queryIndex, *referenceNode.Left());
       double rightScore = rule.Score(queryIndex, *referenceNode.Right());
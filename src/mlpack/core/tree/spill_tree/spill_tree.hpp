@@ -32,6 +32,9 @@ namespace tree /** Trees and tree-building procedures. */ {
  * In this way, we can ensure that each split reduces the number of points of a
  * node by at least a constant factor.
  *
+ * When OpenMP is available, the top levels of large trees are split serially,
+ * and the subtrees below them are then built in parallel.
+ *
  * This particular tree does not allow growth, so you cannot add or delete nodes
  * from it.  If you need to add or delete a node, the better procedure is to
  * rebuild the tree entirely.
@@ -437,7 +440,70 @@ class SpillTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) { bound.Center(center); }
 
+  /**
+   * Reorder the columns of the dataset in the order in which a depth-first
+   * traversal reaches the leaves, so that the points of each leaf are close
+   * together in memory (as in a BinarySpaceTree); a point held by several
+   * leaves is placed with the first one.  The point indices held by the tree
+   * are updated, and the tree then holds its own copy of the reordered
+   * dataset.  This may only be called on the root node.
+   *
+   * Since the indices change, results computed with the tree afterwards (for
+   * instance by NeighborSearch) refer to the reordered dataset; use oldFromNew
+   * to map them back.
+   *
+   * @param oldFromNew Vector that will hold the original index of each point
+   *     of the reordered dataset.
+   */
+  void Relayout(std::vector<size_t>& oldFromNew);
+
  private:
+  /**
+   * Create an unsplit child of the given parent that will hold the given
+   * number of points; SplitNode() or SplitNodeShallow() must be called next.
+   * This is used by BuildTree().
+   *
+   * @param parent Parent of this node.
+   * @param count Number of points held by the node.
+   */
+  SpillTree(SpillTree* parent, const size_t count);
+
+  /**
+   * Build the tree below this root node.  For large trees, when OpenMP is
+   * available, the top levels are split serially and the subtrees below them
+   * are built in parallel; otherwise this is the same as SplitNode().
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  void BuildTree(arma::Col<size_t>& points,
+                 const size_t maxLeafSize,
+                 const double tau,
+                 const double rho);
+
+  /**
+   * Split the current node into two unsplit children, and give the points of
+   * each child.  Return false if the node is a leaf.
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param leftPoints Indexes of points to be included in left child.
+   * @param rightPoints Indexes of points to be included in right child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  bool SplitNodeShallow(arma::Col<size_t>& points,
+                        arma::Col<size_t>& leftPoints,
+                        arma::Col<size_t>& rightPoints,
+                        const size_t maxLeafSize,
+                        const double tau,
+                        const double rho);
+
+  //! Set the parent distances of the children, once their bounds are known.
+  void SetChildParentDistances();
+
   /**
    * Splits the current node, assigning its left and right children recursively.
    *
@@ -14,7 +14,9 @@
 // In case it wasn't included already for some reason.
 #include "spill_tree.hpp"
 
+#include <deque>
 #include <queue>
+#include <stack>
 
 namespace mlpack {
 namespace tree {
@@ -50,7 +52,7 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  BuildTree(points, maxLeafSize, tau, rho);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -87,7 +89,7 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  BuildTree(points, maxLeafSize, tau, rho);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -717,10 +719,212 @@ template<typename MetricType,
          template<typename SplitMetricType, typename SplitMatType>
              class SplitType>
 void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
-    SplitNode(arma::Col<size_t>& points,
+    Relayout(std::vector<size_t>& oldFromNew)
+{
+  if (parent != NULL)
+  {
+    Log::Fatal << "SpillTree::Relayout(): only the root node can be laid "
+        << "out!" << std::endl;
+  }
+
+  // Number the points in the order the leaves are reached.
+  const size_t invalid = size_t() - 1;
+  std::vector<size_t> newFromOld(dataset->n_cols, invalid);
+  oldFromNew.clear();
+  oldFromNew.reserve(dataset->n_cols);
+
+  std::stack<SpillTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    SpillTree* node = stack.top();
+    stack.pop();
+
+    if (node->IsLeaf())
+    {
+      for (size_t i = 0; i < node->NumPoints(); ++i)
+      {
+        const size_t point = node->Point(i);
+        if (newFromOld[point] == invalid)
+        {
+          newFromOld[point] = oldFromNew.size();
+          oldFromNew.push_back(point);
+        }
+      }
+    }
+    else
+    {
+      // The left child is visited first.
+      stack.push(node->right);
+      stack.push(node->left);
+    }
+  }
+
+  // Every point is held by a leaf, but keep any stray point anyway.
+  for (size_t i = 0; i < newFromOld.size(); ++i)
+  {
+    if (newFromOld[i] == invalid)
+    {
+      newFromOld[i] = oldFromNew.size();
+      oldFromNew.push_back(i);
+    }
+  }
+
+  MatType* newDataset = new MatType(dataset->n_rows, dataset->n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    newDataset->col(i) = dataset->col(oldFromNew[i]);
+
+  if (localDataset)
+    delete dataset;
+  localDataset = true;
+
+  // Now point every node at the new dataset and renumber its points.
+  stack.push(this);
+  while (!stack.empty())
+  {
+    SpillTree* node = stack.top();
+    stack.pop();
+
+    node->dataset = newDataset;
+    if (node->pointsIndex)
+    {
+      for (size_t i = 0; i < node->pointsIndex->n_elem; ++i)
+        (*node->pointsIndex)[i] = newFromOld[(*node->pointsIndex)[i]];
+    }
+
+    if (node->left)
+      stack.push(node->left);
+    if (node->right)
+      stack.push(node->right);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillTree(SpillTree* parent, const size_t count) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    count(count),
+    pointsIndex(NULL),
+    overlappingNode(false),
+    hyperplane(),
+    bound(parent->Dataset().n_rows),
+    parentDistance(0),
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    localDataset(false)
+{
+  // Nothing to do: the node is split by BuildTree().
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildTree(arma::Col<size_t>& points,
               const size_t maxLeafSize,
               const double tau,
               const double rho)
+{
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  // Small trees are not worth the overhead.
+  const bool parallel = (numThreads > 1) && (count >= 10000) &&
+      (count > 8 * numThreads * maxLeafSize);
+  #else
+  const bool parallel = false;
+  #endif
+
+  if (!parallel)
+  {
+    SplitNode(points, maxLeafSize, tau, rho);
+    return;
+  }
+
+  #ifdef HAS_OPENMP
+  // Split the top of the tree serially until all the unsplit nodes are small
+  // enough that there are several of them per thread, so that the dynamic
+  // schedule can balance the load.  The point lists are held in deques, so
+  // that they are never copied when more are added.
+  const size_t maxSubtreeSize = count / (4 * numThreads);
+  std::vector<SpillTree*> topNodes;
+  std::vector<SpillTree*> subtrees;
+  std::deque<arma::Col<size_t>> subtreePoints;
+  std::vector<SpillTree*> stack(1, this);
+  std::deque<arma::Col<size_t>> stackPoints(1);
+  stackPoints.back().swap(points);
+  while (!stack.empty())
+  {
+    SpillTree* node = stack.back();
+    arma::Col<size_t> nodePoints;
+    nodePoints.swap(stackPoints.back());
+    stack.pop_back();
+    stackPoints.pop_back();
+
+    if (node->count <= maxSubtreeSize)
+    {
+      subtrees.push_back(node);
+      subtreePoints.push_back(arma::Col<size_t>());
+      subtreePoints.back().swap(nodePoints);
+      continue;
+    }
+
+    topNodes.push_back(node);
+    arma::Col<size_t> leftPoints, rightPoints;
+    if (node->SplitNodeShallow(nodePoints, leftPoints, rightPoints,
+        maxLeafSize, tau, rho))
+    {
+      stack.push_back(node->right);
+      stackPoints.push_back(arma::Col<size_t>());
+      stackPoints.back().swap(rightPoints);
+      stack.push_back(node->left);
+      stackPoints.push_back(arma::Col<size_t>());
+      stackPoints.back().swap(leftPoints);
+    }
+  }
+
+  // The subtrees only read the dataset, so they can be built in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    subtrees[i]->SplitNode(subtreePoints[i], maxLeafSize, tau, rho);
+    subtrees[i]->stat = StatisticType(*subtrees[i]);
+  }
+
+  // Now finish the top nodes, children first, in the same order as
+  // SplitNode().  The statistic of the root is built by the constructor.
+  for (size_t i = topNodes.size(); i > 0; --i)
+  {
+    SpillTree* node = topNodes[i - 1];
+    if (node->left)
+      node->SetChildParentDistances();
+    if (i > 1)
+      node->stat = StatisticType(*node);
+  }
+  #endif
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SplitNodeShallow(arma::Col<size_t>& points,
+                     arma::Col<size_t>& leftPoints,
+                     arma::Col<size_t>& rightPoints,
+                     const size_t maxLeafSize,
+                     const double tau,
+                     const double rho)
 {
   // We need to expand the bounds of this node properly.
   for (size_t i = 0; i < points.n_elem; ++i)
@@ -734,7 +938,7 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   {
     pointsIndex = new arma::Col<size_t>();
     pointsIndex->swap(points);
-    return; // We can't split this.
+    return false; // We can't split this.
   }
 
   const bool split = SplitType<MetricType, MatType>::SplitSpace(bound,
@@ -745,10 +949,9 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   {
     pointsIndex = new arma::Col<size_t>();
     pointsIndex->swap(points);
-    return; // We can't split this.
+    return false; // We can't split this.
   }
 
-  arma::Col<size_t> leftPoints, rightPoints;
   // Split the node.
   overlappingNode = SplitPoints(tau, rho, points, leftPoints, rightPoints);
 
@@ -765,12 +968,20 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     arma::Col<size_t>().swap(points);
   }
 
-  // Now we will recursively split the children by calling their constructors
-  // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  left = new SpillTree(this, leftPoints.n_elem);
+  right = new SpillTree(this, rightPoints.n_elem);
+  return true;
+}
 
-  // Calculate parent distances for those two nodes.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SetChildParentDistances()
+{
   arma::vec center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
@@ -784,6 +995,33 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SplitNode(arma::Col<size_t>& points,
+              const size_t maxLeafSize,
+              const double tau,
+              const double rho)
+{
+  arma::Col<size_t> leftPoints, rightPoints;
+  if (!SplitNodeShallow(points, leftPoints, rightPoints, maxLeafSize, tau,
+      rho))
+    return;
+
+  // Now we will recursively split the children, and build their statistics.
+  left->SplitNode(leftPoints, maxLeafSize, tau, rho);
+  left->stat = StatisticType(*left);
+  right->SplitNode(rightPoints, maxLeafSize, tau, rho);
+  right->stat = StatisticType(*right);
+
+  // Calculate parent distances for those two nodes.
+  SetChildParentDistances();
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -0,0 +1,157 @@
+/**
+ * @file core/tree/subtree_frontier.hpp
+ *
+ * This file contains a function that splits a tree into a set of disjoint
+ * subtrees which together hold every descendant point of the tree.  This is
+ * useful for parallelizing traversals: each subtree can be handed to a
+ * different thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SUBTREE_FRONTIER_HPP
+#define MLPACK_CORE_TREE_SUBTREE_FRONTIER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <queue>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+// Forward declaration, so that the spill tree overload below can be declared.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+class SpillTree;
+
+namespace subtree_frontier {
+
+//! Order nodes so that the node with the most descendants is on top.
+template<typename TreeType>
+struct FrontierNodeCmp
+{
+  bool operator()(const TreeType* a, const TreeType* b) const
+  {
+    return a->NumDescendants() < b->NumDescendants();
+  }
+};
+
+//! Return true if the children of the given node may hold the same points.
+template<typename TreeType>
+bool ChildrenOverlap(const TreeType& /* node */)
+{
+  return !TreeTraits<TreeType>::UniqueNumDescendants;
+}
+
+//! The children of a spill tree node only hold the same points if it is an
+//! overlapping node.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+bool ChildrenOverlap(const SpillTree<MetricType, StatisticType, MatType,
+    HyperplaneType, SplitType>& node)
+{
+  return node.Overlap();
+}
+
+//! Return true if the given node can be replaced by its children in the
+//! frontier without losing or duplicating any descendant point.
+template<typename TreeType>
+bool CanExpand(const TreeType& node)
+{
+  if (node.IsLeaf() || ChildrenOverlap(node))
+    return false;
+
+  // Points held directly by a non-leaf node are only owned by a child if the
+  // tree has self-children.
+  return (node.NumPoints() == 0) || TreeTraits<TreeType>::HasSelfChildren;
+}
+
+//! Allow every node to be split.
+template<typename TreeType>
+struct SplitAnyNode
+{
+  bool operator()(const TreeType& /* node */) const { return true; }
+};
+
+} // namespace subtree_frontier
+
+/**
+ * Collect a set of disjoint subtrees of the given tree such that every
+ * descendant point of the tree is a descendant of exactly one of the subtrees.
+ * Nodes are split largest-first until at least minNodes subtrees are found or
+ * no more nodes can be split, so the resulting subtrees are roughly balanced.
+ *
+ * Nodes whose children may hold the same points (the overlapping nodes of
+ * spill trees) are never split, since the subtrees would not be disjoint.  So
+ * a spill tree built with tau = 0 can be split into subtrees as usual.
+ *
+ * The optional canSplit functor takes a node and returns false if the node
+ * must not be split even though it could be; the DualTreeKMeans class uses it
+ * to keep the nodes that it has pruned whole.
+ *
+ * @param root Root of the tree to split.
+ * @param minNodes Minimum number of subtrees to find, if possible.
+ * @param frontier Vector in which the subtrees will be stored.
+ * @param canSplit Functor returning whether the given node may be split.
+ */
+template<typename TreeType, typename SplitPredicateType>
+void SubtreeFrontier(TreeType& root,
+                     const size_t minNodes,
+                     std::vector<TreeType*>& frontier,
+                     SplitPredicateType canSplit)
+{
+  frontier.clear();
+  std::priority_queue<TreeType*, std::vector<TreeType*>,
+      subtree_frontier::FrontierNodeCmp<TreeType>> nodes;
+  nodes.push(&root);
+
+  // Nodes that cannot be split any further go straight into the frontier.
+  while (!nodes.empty() && (nodes.size() + frontier.size() < minNodes))
+  {
+    TreeType* node = nodes.top();
+    nodes.pop();
+
+    if (!subtree_frontier::CanExpand(*node) || !canSplit(*node))
+    {
+      frontier.push_back(node);
+      continue;
+    }
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push(&node->Child(i));
+  }
+
+  while (!nodes.empty())
+  {
+    frontier.push_back(nodes.top());
+    nodes.pop();
+  }
+}
+
+/**
+ * Collect a set of disjoint subtrees of the given tree, splitting every node
+ * that can be split; see the overload above.
+ */
+template<typename TreeType>
+void SubtreeFrontier(TreeType& root,
+                     const size_t minNodes,
+                     std::vector<TreeType*>& frontier)
+{
+  SubtreeFrontier(root, minNodes, frontier,
+      subtree_frontier::SplitAnyNode<TreeType>());
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * Opt-in statistics on the work done by the tree traversers, which can be used
+ * to pick the tree type and the leaf size for a given dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The TraversalStatistics class counts, for each depth of the reference tree,
+ * the nodes that the traversers visit, the nodes that they prune, and the base
+ * cases that they evaluate, and it counts each evaluation of the base cases of
+ * a leaf by the size of the leaf.  In a dual-tree traversal, each visited or
+ * pruned node combination is counted at the depth of its reference node.
+ *
+ * The statistics are only recorded while they are started, and only one
+ * TraversalStatistics object can be started at a time.  When none is started,
+ * a traverser only pays one load and one branch per node.  Since they do not
+ * depend on the rules, the statistics are the same for every algorithm:
+ *
+ * @code
+ * TraversalStatistics statistics;
+ * statistics.Start();
+ * rangeSearch.Search(querySet, range, neighbors, distances);
+ * statistics.Stop();
+ * arma::Mat<size_t> perDepth = statistics.Matrix();
+ * @endcode
+ *
+ * Each OpenMP thread records into its own counters, so parallel traversals can
+ * be measured too.
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create the object, with no statistics.
+  TraversalStatistics() { /* Nothing to do. */ }
+
+  //! Stop recording, if needed.
+  ~TraversalStatistics() { Stop(); }
+
+  // The object may be referenced by the traversers, so it cannot be copied.
+  TraversalStatistics(const TraversalStatistics&) = delete;
+  TraversalStatistics& operator=(const TraversalStatistics&) = delete;
+
+  /**
+   * Start recording the traversals into this object (the statistics of
+   * previous recordings are kept).  Another object that is recording is
+   * stopped.
+   */
+  void Start()
+  {
+    #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+    #else
+    const size_t numThreads = 1;
+    #endif
+    if (counters.size() < numThreads)
+      counters.resize(numThreads);
+
+    ActivePointer().store(this);
+  }
+
+  //! Stop recording the traversals into this object.
+  void Stop()
+  {
+    TraversalStatistics* expected = this;
+    ActivePointer().compare_exchange_strong(expected, NULL);
+  }
+
+  //! Remove all the statistics.
+  void Reset() { counters.assign(counters.size(), Counters()); }
+
+  /**
+   * Get the statistics for each depth of the reference tree, with one row per
+   * depth, and the number of visited nodes, pruned nodes, and base cases in
+   * the three columns.
+   */
+  arma::Mat<size_t> Matrix() const
+  {
+    size_t maxDepth = 0;
+    for (const Counters& c : counters)
+      maxDepth = std::max(maxDepth, c.perDepth.n_rows);
+
+    arma::Mat<size_t> result(maxDepth, 3, arma::fill::zeros);
+    for (const Counters& c : counters)
+    {
+      if (c.perDepth.n_rows > 0)
+        result.rows(0, c.perDepth.n_rows - 1) += c.perDepth;
+    }
+
+    return result;
+  }
+
+  /**
+   * Get the number of times the base cases of a leaf were evaluated, by leaf
+   * size: element i holds the number of evaluations of leaves with i points.
+   */
+  arma::Col<size_t> LeafSizes() const
+  {
+    size_t maxSize = 0;
+    for (const Counters& c : counters)
+      maxSize = std::max(maxSize, c.leafSizes.n_elem);
+
+    arma::Col<size_t> result(maxSize, arma::fill::zeros);
+    for (const Counters& c : counters)
+    {
+      if (c.leafSizes.n_elem > 0)
+        result.subvec(0, c.leafSizes.n_elem - 1) += c.leafSizes;
+    }
+
+    return result;
+  }
+
+  //! Get the total number of visited nodes.
+  size_t NumVisited() const { return Total(0); }
+  //! Get the total number of pruned nodes.
+  size_t NumPrunes() const { return Total(1); }
+  //! Get the total number of base cases.
+  size_t NumBaseCases() const { return Total(2); }
+
+  //! Get the object that is recording, or NULL if none is.
+  static TraversalStatistics* Active()
+  {
+    return ActivePointer().load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Record a visit of the given node, if the statistics are started.
+   */
+  template<typename TreeType>
+  static void RecordVisit(const TreeType& node)
+  {
+    TraversalStatistics* statistics = Active();
+    if (statistics != NULL)
+      statistics->Record(Depth(node), 0, 1);
+  }
+
+  /**
+   * Record a prune of the given node, if the statistics are started.
+   */
+  template<typename TreeType>
+  static void RecordPrune(const TreeType& node, const size_t numPrunes = 1)
+  {
+    TraversalStatistics* statistics = Active();
+    if (statistics != NULL)
+      statistics->Record(Depth(node), 1, numPrunes);
+  }
+
+  /**
+   * Record the evaluation of the given number of base cases in the given leaf,
+   * if the statistics are started.
+   */
+  template<typename TreeType>
+  static void RecordBaseCases(const TreeType& leaf, const size_t numBaseCases)
+  {
+    TraversalStatistics* statistics = Active();
+    if (statistics == NULL)
+      return;
+
+    statistics->Record(Depth(leaf), 2, numBaseCases);
+
+    arma::Col<size_t>& leafSizes = statistics->LocalCounters().leafSizes;
+    const size_t size = leaf.NumPoints();
+    if (leafSizes.n_elem <= size)
+      leafSizes.resize(size + 1);
+    ++leafSizes[size];
+  }
+
+ private:
+  //! The counters of one thread.
+  struct Counters
+  {
+    //! The visits, prunes and base cases at each depth.
+    arma::Mat<size_t> perDepth;
+    //! The number of leaf evaluations for each leaf size.
+    arma::Col<size_t> leafSizes;
+  };
+
+  //! Get the depth of the given node.
+  template<typename TreeType>
+  static size_t Depth(const TreeType& node)
+  {
+    size_t depth = 0;
+    for (const TreeType* parent = node.Parent(); parent != NULL;
+        parent = parent->Parent())
+    {
+      ++depth;
+    }
+
+    return depth;
+  }
+
+  //! Add the given count to the given column at the given depth.
+  void Record(const size_t depth, const size_t column, const size_t count)
+  {
+    arma::Mat<size_t>& perDepth = LocalCounters().perDepth;
+    if (perDepth.n_rows <= depth)
+    {
+      // Keep the existing counts.
+      perDepth.resize(depth + 1, 3);
+    }
+
+    perDepth(depth, column) += count;
+  }
+
+  //! Get the counters of the calling thread.
+  Counters& LocalCounters()
+  {
+    #ifdef HAS_OPENMP
+    return counters[omp_get_thread_num() % counters.size()];
+    #else
+    return counters[0];
+    #endif
+  }
+
+  //! Get the sum of the given column over all depths.
+  size_t Total(const size_t column) const
+  {
+    const arma::Mat<size_t> m = Matrix();
+    return (m.n_rows == 0) ? 0 : arma::accu(m.col(column));
+  }
+
+  //! Get the pointer to the object that is recording.
+  static std::atomic<TraversalStatistics*>& ActivePointer()
+  {
+    static std::atomic<TraversalStatistics*> active(NULL);
+    return active;
+  }
+
+  //! The counters of each thread.
+  std::vector<Counters> counters;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file core/util/async_log_writer.cpp
+ *
+ * Implementation of the AsyncLogWriter.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "async_log_writer.hpp"
+
+#include <set>
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+
+AsyncLogWriter& AsyncLogWriter::Get()
+{
+  static AsyncLogWriter writer;
+  return writer;
+}
+
+AsyncLogWriter::AsyncLogWriter() :
+    queuedBytes(0),
+    maxQueuedBytes(16 * 1024 * 1024),
+    unreportedDroppedLines(0),
+    droppedLines(0),
+    writing(false),
+    stop(false)
+{
+  // Nothing to do.
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  queued.notify_one();
+
+  if (thread.joinable())
+    thread.join();
+}
+
+void AsyncLogWriter::Write(ostream& destination, string&& line)
+{
+  {
+    lock_guard<std::mutex> lock(mutex);
+    if (!thread.joinable())
+      thread = std::thread(&AsyncLogWriter::Run, this);
+
+    if (queuedBytes + line.size() > maxQueuedBytes)
+    {
+      ++unreportedDroppedLines;
+      ++droppedLines;
+      return;
+    }
+
+    if (unreportedDroppedLines > 0)
+    {
+      string report = "[" + to_string(unreportedDroppedLines) + " log lines "
+          "dropped because the output could not keep up]\n";
+      queuedBytes += report.size();
+      queue.push_back(make_pair(&destination, move(report)));
+      unreportedDroppedLines = 0;
+    }
+
+    queuedBytes += line.size();
+    queue.push_back(make_pair(&destination, move(line)));
+  }
+  queued.notify_one();
+}
+
+void AsyncLogWriter::Flush()
+{
+  unique_lock<std::mutex> lock(mutex);
+  written.wait(lock, [this]() { return queue.empty() && !writing; });
+}
+
+size_t AsyncLogWriter::DroppedLines()
+{
+  lock_guard<std::mutex> lock(mutex);
+  return droppedLines;
+}
+
+void AsyncLogWriter::Run()
+{
+  unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    queued.wait(lock, [this]() { return stop || !queue.empty(); });
+    if (queue.empty())
+      break; // The writer is stopped, and everything has been written.
+
+    // Take the whole batch, so that the logging threads are not blocked while
+    // it is written.
+    deque<pair<ostream*, string>> batch;
+    batch.swap(queue);
+    queuedBytes = 0;
+    writing = true;
+    lock.unlock();
+
+    set<ostream*> destinations;
+    for (pair<ostream*, string>& line : batch)
+    {
+      line.first->write(line.second.data(), line.second.size());
+      destinations.insert(line.first);
+    }
+    for (ostream* destination : destinations)
+      destination->flush();
+
+    lock.lock();
+    writing = false;
+    written.notify_all();
+  }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file core/util/async_log_writer.hpp
+ *
+ * A background writer for the lines of asynchronous PrefixedOutStreams.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_ASYNC_LOG_WRITER_HPP
+#define MLPACK_CORE_UTIL_ASYNC_LOG_WRITER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The AsyncLogWriter writes complete log lines to their destination streams on
+ * a background thread, so that the threads that log only pay for appending the
+ * line to a queue.  Lines queued by one thread are written in order, and the
+ * destination streams are flushed once per batch of lines instead of once per
+ * line.
+ *
+ * The queue is bounded by MaxQueuedBytes(): when a burst of lines would exceed
+ * it (because the destination cannot keep up), the lines are dropped instead of
+ * blocking the logging threads, and the number of dropped lines is reported
+ * with the next line that is written.
+ *
+ * There is only one AsyncLogWriter, given by Get(); its thread is started when
+ * the first line is written, and the remaining lines are written when the
+ * program ends.
+ */
+class AsyncLogWriter
+{
+ public:
+  //! Get the writer.
+  static AsyncLogWriter& Get();
+
+  //! Write the remaining lines and stop the thread.
+  ~AsyncLogWriter();
+
+  // The writer owns a thread, so it cannot be copied.
+  AsyncLogWriter(const AsyncLogWriter&) = delete;
+  AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+  /**
+   * Queue the given line (which should end with a newline) to be written to
+   * the given stream.
+   */
+  void Write(std::ostream& destination, std::string&& line);
+
+  //! Wait until all the queued lines have been written and flushed.
+  void Flush();
+
+  //! Get the maximum number of bytes that can be queued.
+  size_t MaxQueuedBytes() const { return maxQueuedBytes; }
+  //! Modify the maximum number of bytes that can be queued (this should be
+  //! done when no thread is logging).
+  size_t& MaxQueuedBytes() { return maxQueuedBytes; }
+
+  //! Get the total number of lines that have been dropped.
+  size_t DroppedLines();
+
+ private:
+  //! Create the writer, without starting its thread.
+  AsyncLogWriter();
+
+  //! Write the queued lines until the writer is stopped.
+  void Run();
+
+  //! The queued lines, with their destinations.
+  std::deque<std::pair<std::ostream*, std::string>> queue;
+  //! The number of bytes in the queue.
+  size_t queuedBytes;
+  //! The maximum number of bytes in the queue.
+  size_t maxQueuedBytes;
+  //! The number of lines dropped since the last report.
+  size_t unreportedDroppedLines;
+  //! The total number of lines dropped.
+  size_t droppedLines;
+  //! True while the thread is writing a batch of lines.
+  bool writing;
+  //! True when the thread must stop.
+  bool stop;
+
+  //! The lock of the members above.
+  std::mutex mutex;
+  //! Signaled when lines are queued, or when the writer is stopped.
+  std::condition_variable queued;
+  //! Signaled when a batch of lines has been written.
+  std::condition_variable written;
+  //! The writing thread (started by the first Write()).
+  std::thread thread;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file core/util/batch_predictor.hpp
+ *
+ * The BatchPredictor class, which groups single-point prediction requests into
+ * batches for the batch prediction method of a model.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_BATCH_PREDICTOR_HPP
+#define MLPACK_CORE_UTIL_BATCH_PREDICTOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Statistics of the requests completed by a BatchPredictor.
+ */
+struct BatchPredictorStats
+{
+  //! The number of completed requests.
+  size_t requests;
+  //! The number of batches that were run.
+  size_t batches;
+  //! The average number of requests per batch.
+  double meanBatchSize;
+  //! The average time between the submission and the completion of a
+  //! request, in seconds.
+  double meanLatency;
+  //! The longest time between the submission and the completion of a request,
+  //! in seconds.
+  double maxLatency;
+  //! The number of requests completed per second, since the predictor was
+  //! created or its statistics were reset.
+  double throughput;
+};
+
+/**
+ * A BatchPredictor answers prediction requests for single points with the
+ * batch prediction method of a model, which is much faster per point.  The
+ * requests are queued, and a background thread gathers them into batches of
+ * at most MaxBatchSize() points, runs the given prediction function on each
+ * batch, and completes the future of each request with its column of the
+ * results.
+ *
+ * A batch is run as soon as it is full, or when waiting any longer would make
+ * its oldest request miss the latency budget MaxLatency(); the time that a
+ * batch takes to run is estimated from the previous batches, so that the
+ * batches are smaller when the model is slow.  So, with few requests, each
+ * request is answered after about MaxLatency() seconds, and under load, the
+ * batches grow up to MaxBatchSize().
+ *
+ * The prediction function is only called by the background thread, so the
+ * model does not need to support concurrent predictions; but it must not be
+ * modified while the predictor exists.
+ *
+ * @code
+ * RandomForest<> rf;
+ * // ... Train the forest ...
+ *
+ * BatchPredictor<arma::Row<size_t>> predictor(
+ *     [&rf](const arma::mat& points, arma::Row<size_t>& predictions)
+ *     {
+ *       rf.Classify(points, predictions);
+ *     }, 256, 0.002);
+ *
+ * // From any thread:
+ * std::future<arma::Row<size_t>> f = predictor.Predict(point);
+ * const size_t prediction = f.get()[0];
+ * @endcode
+ *
+ * @tparam OutputType Type of the results of a batch (one column per point);
+ *     the result of each request is its column, as an OutputType.
+ * @tparam InputType Type of the matrix of the points of a batch.
+ */
+template<typename OutputType = arma::mat, typename InputType = arma::mat>
+class BatchPredictor
+{
+ public:
+  //! The type of a point.
+  typedef arma::Col<typename InputType::elem_type> PointType;
+  //! The type of the function that predicts the results of a batch.
+  typedef std::function<void(const InputType&, OutputType&)> PredictFunction;
+
+  /**
+   * Create the predictor, and start its thread.
+   *
+   * @param predict Function that stores the results of the given points in
+   *     the given matrix (one column per point).
+   * @param maxBatchSize Maximum number of points in a batch.
+   * @param maxLatency Latency budget of a request, in seconds.
+   */
+  BatchPredictor(PredictFunction predict,
+                 const size_t maxBatchSize = 256,
+                 const double maxLatency = 0.001);
+
+  //! Answer the queued requests, and stop the thread.
+  ~BatchPredictor();
+
+  // The predictor owns a thread, so it cannot be copied.
+  BatchPredictor(const BatchPredictor&) = delete;
+  BatchPredictor& operator=(const BatchPredictor&) = delete;
+
+  /**
+   * Queue a request to predict the result of the given point.  The returned
+   * future holds the result, or the exception thrown by the prediction
+   * function (or std::invalid_argument if the point does not have the
+   * dimensionality of the other points of its batch).
+   *
+   * @param point Point to predict the result of.
+   */
+  std::future<OutputType> Predict(PointType point);
+
+  //! Get the statistics of the completed requests.
+  BatchPredictorStats Stats();
+  //! Reset the statistics.
+  void ResetStats();
+
+  //! Get the maximum number of points in a batch.
+  size_t MaxBatchSize() const { return maxBatchSize; }
+  //! Get the latency budget of a request, in seconds.
+  double MaxLatency() const { return maxLatency; }
+
+ private:
+  //! The clock used to measure latencies.
+  typedef std::chrono::steady_clock Clock;
+
+  //! A queued request.
+  struct Request
+  {
+    //! The point.
+    PointType point;
+    //! The promise of the result.
+    std::promise<OutputType> result;
+    //! The time the request was queued at.
+    Clock::time_point arrival;
+  };
+
+  //! Run batches until the predictor is stopped.
+  void Run();
+
+  //! Run the given batch, and complete its requests.
+  void RunBatch(std::deque<Request>& batch);
+
+  //! The prediction function.
+  PredictFunction predict;
+  //! The maximum number of points in a batch.
+  size_t maxBatchSize;
+  //! The latency budget of a request, in seconds.
+  double maxLatency;
+
+  //! The queued requests.
+  std::deque<Request> queue;
+  //! True when the thread must stop.
+  bool stop;
+  //! The estimated time to run a batch, in seconds (a moving average).
+  double batchTime;
+
+  //! The statistics of the completed requests.
+  size_t completedRequests;
+  size_t completedBatches;
+  double totalLatency;
+  double maximumLatency;
+  Clock::time_point statsStart;
+
+  //! The lock of the members above.
+  std::mutex mutex;
+  //! Signaled when a request is queued, or when the predictor is stopped.
+  std::condition_variable queued;
+  //! The thread that runs the batches.
+  std::thread thread;
+};
+
+} // namespace util
+} // namespace mlpack
+
+// Include implementation.
+#include "batch_predictor_impl.hpp"
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file core/util/batch_predictor_impl.hpp
+ *
+ * Implementation of the BatchPredictor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_BATCH_PREDICTOR_IMPL_HPP
+#define MLPACK_CORE_UTIL_BATCH_PREDICTOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "batch_predictor.hpp"
+
+namespace mlpack {
+namespace util {
+
+template<typename OutputType, typename InputType>
+BatchPredictor<OutputType, InputType>::BatchPredictor(
+    PredictFunction predict,
+    const size_t maxBatchSize,
+    const double maxLatency) :
+    predict(std::move(predict)),
+    maxBatchSize(std::max(maxBatchSize, (size_t) 1)),
+    maxLatency(maxLatency),
+    stop(false),
+    batchTime(0.0),
+    completedRequests(0),
+    completedBatches(0),
+    totalLatency(0.0),
+    maximumLatency(0.0),
+    statsStart(Clock::now())
+{
+  thread = std::thread(&BatchPredictor::Run, this);
+}
+
+template<typename OutputType, typename InputType>
+BatchPredictor<OutputType, InputType>::~BatchPredictor()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  queued.notify_one();
+
+  thread.join();
+}
+
+template<typename OutputType, typename InputType>
+std::future<OutputType> BatchPredictor<OutputType, InputType>::Predict(
+    PointType point)
+{
+  Request request;
+  request.point = std::move(point);
+  request.arrival = Clock::now();
+  std::future<OutputType> result = request.result.get_future();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(std::move(request));
+  }
+  queued.notify_one();
+
+  return result;
+}
+
+template<typename OutputType, typename InputType>
+BatchPredictorStats BatchPredictor<OutputType, InputType>::Stats()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  BatchPredictorStats stats;
+  stats.requests = completedRequests;
+  stats.batches = completedBatches;
+  stats.meanBatchSize = (completedBatches == 0) ? 0.0 :
+      (double) completedRequests / completedBatches;
+  stats.meanLatency = (completedRequests == 0) ? 0.0 :
+      totalLatency / completedRequests;
+  stats.maxLatency = maximumLatency;
+  const double elapsed = std::chrono::duration<double>(Clock::now() -
+      statsStart).count();
+  stats.throughput = (elapsed > 0.0) ? completedRequests / elapsed : 0.0;
+  return stats;
+}
+
+template<typename OutputType, typename InputType>
+void BatchPredictor<OutputType, InputType>::ResetStats()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  completedRequests = 0;
+  completedBatches = 0;
+  totalLatency = 0.0;
+  maximumLatency = 0.0;
+  statsStart = Clock::now();
+}
+
+template<typename OutputType, typename InputType>
+void BatchPredictor<OutputType, InputType>::Run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    queued.wait(lock, [this]() { return stop || !queue.empty(); });
+    if (queue.empty())
+      break; // The predictor is stopped, and every request has been answered.
+
+    // Wait for more requests until the batch is full, or until the oldest
+    // request would miss its latency budget if the batch ran any later.
+    const double wait = std::max(maxLatency - batchTime, 0.0);
+    const Clock::time_point deadline = queue.front().arrival +
+        std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(wait));
+    queued.wait_until(lock, deadline, [this]()
+        { return stop || queue.size() >= maxBatchSize; });
+
+    const size_t batchSize = std::min(queue.size(), maxBatchSize);
+    std::deque<Request> batch(std::make_move_iterator(queue.begin()),
+        std::make_move_iterator(queue.begin() + batchSize));
+    queue.erase(queue.begin(), queue.begin() + batchSize);
+    lock.unlock();
+
+    const Clock::time_point start = Clock::now();
+    RunBatch(batch);
+    const Clock::time_point end = Clock::now();
+
+    lock.lock();
+    const double elapsed = std::chrono::duration<double>(end - start).count();
+    batchTime = (completedBatches == 0) ? elapsed :
+        0.8 * batchTime + 0.2 * elapsed;
+
+    ++completedBatches;
+    completedRequests += batch.size();
+    for (const Request& request : batch)
+    {
+      const double latency = std::chrono::duration<double>(end -
+          request.arrival).count();
+      totalLatency += latency;
+      maximumLatency = std::max(maximumLatency, latency);
+    }
+  }
+}
+
+template<typename OutputType, typename InputType>
+void BatchPredictor<OutputType, InputType>::RunBatch(
+    std::deque<Request>& batch)
+{
+  // The points that do not have the dimensionality of the first point of the
+  // batch are rejected.
+  const size_t dimensionality = batch.front().point.n_elem;
+  std::vector<Request*> valid;
+  for (Request& request : batch)
+  {
+    if (request.point.n_elem == dimensionality)
+    {
+      valid.push_back(&request);
+    }
+    else
+    {
+      std::ostringstream oss;
+      oss << "BatchPredictor::Predict(): point has dimensionality "
+          << request.point.n_elem << ", but the other points of its batch have "
+          << "dimensionality " << dimensionality << "!";
+      request.result.set_exception(std::make_exception_ptr(
+          std::invalid_argument(oss.str())));
+    }
+  }
+
+  InputType points(dimensionality, valid.size());
+  for (size_t i = 0; i < valid.size(); ++i)
+    points.col(i) = valid[i]->point;
+
+  OutputType results;
+  try
+  {
+    predict(points, results);
+    if (results.n_cols != valid.size())
+    {
+      throw std::logic_error("BatchPredictor: the prediction function gave "
+          "the wrong number of results!");
+    }
+  }
+  catch (...)
+  {
+    for (Request* request : valid)
+      request->result.set_exception(std::current_exception());
+    return;
+  }
+
+  for (size_t i = 0; i < valid.size(); ++i)
+    valid[i]->result.set_value(OutputType(results.col(i)));
+}
+
+} // namespace util
+} // namespace mlpack
+
+#endif
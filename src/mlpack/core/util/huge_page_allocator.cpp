@@ -0,0 +1,271 @@
+/**
+ * @file core/util/huge_page_allocator.cpp
+ *
+ * Implementation of the HugePageAllocator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "huge_page_allocator.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+  #include <sys/mman.h>
+#endif
+
+#ifdef _WIN32
+  #include <malloc.h>
+#endif
+
+// Older C libraries do not define the flags that choose the size of explicit
+// huge pages.
+#if defined(__linux__) && defined(MAP_HUGETLB)
+  #ifndef MAP_HUGE_SHIFT
+    #define MAP_HUGE_SHIFT 26
+  #endif
+  #ifndef MAP_HUGE_2MB
+    #define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+  #endif
+  #ifndef MAP_HUGE_1GB
+    #define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+  #endif
+#endif
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+
+const size_t HugePageAllocator::Alignment;
+
+namespace {
+
+//! The size of a (2 MB) huge page.
+const size_t hugePageSize = size_t(1) << 21;
+//! The size of a 1 GB huge page.
+const size_t giganticPageSize = size_t(1) << 30;
+
+/**
+ * The header before each allocation: the start and the length of the mapping
+ * (the length is 0 if the memory is not mapped).  It takes Alignment bytes, so
+ * that the memory after it stays aligned.
+ */
+struct Header
+{
+  void* start;
+  size_t mapLength;
+};
+
+static_assert(sizeof(Header) <= HugePageAllocator::Alignment,
+    "The allocation header must fit in the alignment.");
+
+//! Get the initial mode, from the MLPACK_HUGE_PAGES environment variable.
+HugePageAllocator::HugePageMode InitialMode()
+{
+  const char* mode = getenv("MLPACK_HUGE_PAGES");
+  if (mode == NULL)
+    return HugePageAllocator::TRANSPARENT_HUGE_PAGES;
+  else if (strcmp(mode, "none") == 0)
+    return HugePageAllocator::NO_HUGE_PAGES;
+  else if (strcmp(mode, "2mb") == 0)
+    return HugePageAllocator::HUGE_PAGES_2MB;
+  else if (strcmp(mode, "1gb") == 0)
+    return HugePageAllocator::HUGE_PAGES_1GB;
+  else
+    return HugePageAllocator::TRANSPARENT_HUGE_PAGES;
+}
+
+//! The mode.
+atomic<int>& CurrentMode()
+{
+  static atomic<int> mode((int) InitialMode());
+  return mode;
+}
+
+//! The minimum size of the allocations mapped with huge pages.
+atomic<size_t>& CurrentThreshold()
+{
+  static atomic<size_t> threshold(hugePageSize);
+  return threshold;
+}
+
+//! The number of bytes currently mapped.
+atomic<size_t>& Mapped()
+{
+  static atomic<size_t> mapped(0);
+  return mapped;
+}
+
+//! Round the given size up to a multiple of the given power of two.
+size_t RoundUp(const size_t bytes, const size_t multiple)
+{
+  return (bytes + multiple - 1) & ~(multiple - 1);
+}
+
+//! Allocate the given number of bytes aligned to Alignment bytes, without
+//! mapping them.
+char* AllocateAligned(const size_t bytes)
+{
+  #ifdef _WIN32
+  return (char*) _aligned_malloc(bytes, HugePageAllocator::Alignment);
+  #else
+  void* memory = NULL;
+  if (posix_memalign(&memory, HugePageAllocator::Alignment, bytes) != 0)
+    return NULL;
+  return (char*) memory;
+  #endif
+}
+
+//! Free memory given by AllocateAligned().
+void FreeAligned(void* memory)
+{
+  #ifdef _WIN32
+  _aligned_free(memory);
+  #else
+  free(memory);
+  #endif
+}
+
+#ifdef __linux__
+
+/**
+ * Map the given number of bytes with explicit huge pages of the given size,
+ * returning NULL if the pool does not have enough free pages.
+ */
+char* MapExplicit(const size_t bytes, const size_t pageSize, size_t& length)
+{
+  #ifdef MAP_HUGETLB
+  length = RoundUp(bytes, pageSize);
+  const int sizeFlag = (pageSize == giganticPageSize) ? MAP_HUGE_1GB :
+      MAP_HUGE_2MB;
+  void* memory = mmap(NULL, length, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | sizeFlag, -1, 0);
+  return (memory == MAP_FAILED) ? NULL : (char*) memory;
+  #else
+  (void) bytes;
+  (void) pageSize;
+  (void) length;
+  return NULL;
+  #endif
+}
+
+/**
+ * Map the given number of bytes at an address aligned to 2 MB, and advise the
+ * kernel to back the mapping with transparent huge pages.  Returns NULL if the
+ * memory cannot be mapped.
+ */
+char* MapTransparent(const size_t bytes, size_t& length)
+{
+  length = RoundUp(bytes, hugePageSize);
+
+  // Map an extra huge page, and unmap the parts before and after the aligned
+  // range.
+  void* memory = mmap(NULL, length + hugePageSize, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED)
+    return NULL;
+
+  char* start = (char*) memory;
+  char* aligned = (char*) RoundUp((uintptr_t) start, hugePageSize);
+  if (aligned > start)
+    munmap(start, aligned - start);
+  if (aligned + length < start + length + hugePageSize)
+    munmap(aligned + length, (start + length + hugePageSize) -
+        (aligned + length));
+
+  #ifdef MADV_HUGEPAGE
+  madvise(aligned, length, MADV_HUGEPAGE);
+  #endif
+
+  return aligned;
+}
+
+#endif
+
+} // namespace
+
+void* HugePageAllocator::Allocate(const size_t bytes)
+{
+  const size_t totalBytes = bytes + Alignment;
+  char* start = NULL;
+  size_t mapLength = 0;
+
+  #ifdef __linux__
+  const HugePageMode mode = Mode();
+  if (mode != NO_HUGE_PAGES && bytes >= Threshold())
+  {
+    if (mode == HUGE_PAGES_1GB)
+      start = MapExplicit(totalBytes, giganticPageSize, mapLength);
+    if (start == NULL && (mode == HUGE_PAGES_2MB || mode == HUGE_PAGES_1GB))
+      start = MapExplicit(totalBytes, hugePageSize, mapLength);
+    if (start == NULL)
+      start = MapTransparent(totalBytes, mapLength);
+
+    if (start != NULL)
+      Mapped().fetch_add(mapLength, memory_order_relaxed);
+    else
+      mapLength = 0;
+  }
+  #endif
+
+  if (start == NULL)
+    start = AllocateAligned(totalBytes);
+  if (start == NULL)
+    return NULL;
+
+  Header* header = (Header*) start;
+  header->start = start;
+  header->mapLength = mapLength;
+  return start + Alignment;
+}
+
+void HugePageAllocator::Free(void* memory)
+{
+  if (memory == NULL)
+    return;
+
+  const Header* header = (const Header*) (((char*) memory) - Alignment);
+  void* start = header->start;
+
+  #ifdef __linux__
+  const size_t mapLength = header->mapLength;
+  if (mapLength > 0)
+  {
+    munmap(start, mapLength);
+    Mapped().fetch_sub(mapLength, memory_order_relaxed);
+    return;
+  }
+  #endif
+
+  FreeAligned(start);
+}
+
+void HugePageAllocator::SetMode(const HugePageMode mode)
+{
+  CurrentMode().store((int) mode, memory_order_relaxed);
+}
+
+HugePageAllocator::HugePageMode HugePageAllocator::Mode()
+{
+  return (HugePageMode) CurrentMode().load(memory_order_relaxed);
+}
+
+void HugePageAllocator::SetThreshold(const size_t bytes)
+{
+  CurrentThreshold().store(bytes, memory_order_relaxed);
+}
+
+size_t HugePageAllocator::Threshold()
+{
+  return CurrentThreshold().load(memory_order_relaxed);
+}
+
+size_t HugePageAllocator::MappedBytes()
+{
+  return Mapped().load(memory_order_relaxed);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file core/util/huge_page_allocator.hpp
+ *
+ * An allocator for Armadillo that aligns memory to cache lines, and places
+ * large matrices in huge pages.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTILITIES_HUGE_PAGE_ALLOCATOR_HPP
+#define MLPACK_CORE_UTILITIES_HUGE_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The HugePageAllocator allocates memory aligned to 64 bytes (a cache line),
+ * and, on Linux, maps the allocations of at least Threshold() bytes directly
+ * with huge pages, so that random accesses to large matrices (such as the
+ * reference set of a tree, or the data that minibatches are gathered from)
+ * need fewer TLB entries and page walks.  The huge pages are either
+ * transparent huge pages (the mapping is aligned to 2 MB and advised with
+ * MADV_HUGEPAGE, so the kernel backs it with huge pages when it can), or
+ * explicit 2 MB or 1 GB pages from the kernel's reserved pool (MAP_HUGETLB);
+ * if the pool has too few free pages, transparent huge pages are used
+ * instead.  On other systems, all allocations are only aligned.
+ *
+ * The allocator is only used if MLPACK_ENABLE_HUGE_PAGES is defined (this is
+ * done by the ENABLE_HUGE_PAGES CMake option): then Armadillo is told to
+ * allocate all of its memory with Allocate() and Free() (through
+ * ARMA_ALIEN_MEM_ALLOC_FUNCTION and ARMA_ALIEN_MEM_FREE_FUNCTION), so that the
+ * matrices loaded by data::Load(), the trees and buffers of the neighbor and
+ * range searches, and the parameters and buffers of neural networks all use
+ * it.  As with the MemoryTracker, all the code of a program that uses
+ * Armadillo must then be compiled with MLPACK_ENABLE_HUGE_PAGES, and the
+ * Python, Julia and Go bindings (which pass the ownership of matrix memory
+ * between Armadillo and malloc() and free()) cannot be used; CMake refuses to
+ * configure ENABLE_HUGE_PAGES together with them.  If both are enabled, the
+ * MemoryTracker allocates its memory with the HugePageAllocator.
+ *
+ * The mode can be changed at any time with SetMode(); existing allocations
+ * keep their pages.  The initial mode is given by the MLPACK_HUGE_PAGES
+ * environment variable ("none", "transparent", "2mb" or "1gb"), and is
+ * TRANSPARENT_HUGE_PAGES if it is not set.
+ */
+class HugePageAllocator
+{
+ public:
+  //! The kinds of pages for large allocations.
+  enum HugePageMode
+  {
+    NO_HUGE_PAGES,
+    TRANSPARENT_HUGE_PAGES,
+    HUGE_PAGES_2MB,
+    HUGE_PAGES_1GB
+  };
+
+  //! The alignment of all allocations, in bytes.
+  static const size_t Alignment = 64;
+
+  /**
+   * Allocate the given number of bytes, aligned to Alignment bytes, with huge
+   * pages if the allocation is large enough.  This returns NULL if the memory
+   * cannot be allocated.
+   *
+   * @param bytes Number of bytes to allocate.
+   */
+  static void* Allocate(const size_t bytes);
+
+  /**
+   * Free memory allocated by Allocate().
+   *
+   * @param memory Memory to free (may be NULL).
+   */
+  static void Free(void* memory);
+
+  //! Set the kind of pages used for large allocations.
+  static void SetMode(const HugePageMode mode);
+  //! Get the kind of pages used for large allocations.
+  static HugePageMode Mode();
+
+  //! Set the minimum size of the allocations mapped with huge pages, in bytes.
+  static void SetThreshold(const size_t bytes);
+  //! Get the minimum size of the allocations mapped with huge pages, in bytes
+  //! (2 MB by default).
+  static size_t Threshold();
+
+  //! Get the number of bytes currently mapped for large allocations.
+  static size_t MappedBytes();
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -189,8 +189,11 @@ util::Timers& IO::GetTimers()
  */
 util::Params IO::Parameters(const std::string& bindingName)
 {
-  // We don't need a mutex here, because we are only randomly accessing elements
-  // of the maps.
+  // The maps use operator[], which may insert, and bindings may be called from
+  // several threads at once (for instance from Python, with the GIL released),
+  // so the maps must be locked.
+  std::lock_guard<std::mutex> lock(GetSingleton().mapMutex);
+  std::lock_guard<std::mutex> docLock(GetSingleton().docMutex);
 
   std::map<char, std::string> resultAliases =
       GetSingleton().aliases[bindingName];
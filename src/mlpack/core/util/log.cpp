@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "log.hpp"
+#include "async_log_writer.hpp"
 
 #ifdef HAS_BFD_DL
   #include "backtrace.hpp"
@@ -38,3 +39,17 @@ void Log::Assert(bool condition, const std::string& message)
 void Log::Assert(bool /* condition */, const std::string& /* message */)
 { }
 #endif
+
+void Log::SetAsynchronous(const bool async)
+{
+#ifdef DEBUG
+  Debug.Asynchronous(async);
+#endif
+  Info.Asynchronous(async);
+  Warn.Asynchronous(async);
+}
+
+void Log::Flush()
+{
+  util::AsyncLogWriter::Get().Flush();
+}
@@ -49,7 +49,8 @@ namespace mlpack {
  *
  * Any messages sent to Log::Debug will not be shown when compiling in non-debug
  * mode.  Messages to Log::Info will only be shown when the --verbose flag is
- * given to the program (or rather, the IO class).
+ * given to the program (or rather, the IO class); when they are not shown,
+ * they are not even formatted.
  *
  * @see PrefixedOutStream, NullOutStream, IO
  */
@@ -64,6 +65,21 @@ class Log
   static void Assert(bool condition,
                      const std::string& message = "Assert Failed.");
 
+  /**
+   * Make Log::Debug, Log::Info and Log::Warn asynchronous (or synchronous
+   * again, after writing the queued lines).  Asynchronous streams buffer the
+   * output of each thread and write each complete line on a background thread,
+   * so that logging inside hot loops, from many threads, does not wait for the
+   * terminal.  Log::Fatal stays synchronous, and writes the queued lines before
+   * its message.
+   *
+   * @see util::PrefixedOutStream::Asynchronous()
+   */
+  static void SetAsynchronous(const bool async);
+
+  //! Wait until the lines queued by asynchronous streams have been written.
+  static void Flush();
+
   /**
    * MLPACK_EXPORT is required for global variables, so that they are properly
    * exported by the Windows compiler.
@@ -0,0 +1,253 @@
+/**
+ * @file core/util/memory_tracker.cpp
+ *
+ * Implementation of the MemoryTracker.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "memory_tracker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+#ifdef MLPACK_ENABLE_HUGE_PAGES
+  #include "huge_page_allocator.hpp"
+#endif
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+
+namespace {
+
+/**
+ * The size of the header before each allocation, which holds the size of the
+ * allocation.  It keeps the alignment of the memory below it.
+ */
+#ifdef MLPACK_ENABLE_HUGE_PAGES
+const size_t headerSize = HugePageAllocator::Alignment;
+#else
+const size_t headerSize = alignof(max_align_t);
+#endif
+
+static_assert(headerSize >= sizeof(size_t),
+    "The allocation header must be able to hold a size_t.");
+
+//! Escape the given name for JSON.
+string EscapeJSON(const string& name)
+{
+  string result;
+  for (const char c : name)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    result += c;
+  }
+  return result;
+}
+
+//! Allocate the memory below the tracker: with the HugePageAllocator if it is
+//! enabled, so that both can be used together.
+char* AllocateBlock(const size_t bytes)
+{
+  #ifdef MLPACK_ENABLE_HUGE_PAGES
+  return (char*) HugePageAllocator::Allocate(bytes);
+  #else
+  return (char*) malloc(bytes);
+  #endif
+}
+
+//! Free memory given by AllocateBlock().
+void FreeBlock(void* memory)
+{
+  #ifdef MLPACK_ENABLE_HUGE_PAGES
+  HugePageAllocator::Free(memory);
+  #else
+  free(memory);
+  #endif
+}
+
+} // namespace
+
+atomic<size_t>& MemoryTracker::Current()
+{
+  static atomic<size_t> current(0);
+  return current;
+}
+
+atomic<size_t>& MemoryTracker::Peak()
+{
+  static atomic<size_t> peak(0);
+  return peak;
+}
+
+atomic<size_t>& MemoryTracker::PhasePeak()
+{
+  static atomic<size_t> phasePeak(0);
+  return phasePeak;
+}
+
+atomic<size_t>& MemoryTracker::AllocationCount()
+{
+  static atomic<size_t> allocations(0);
+  return allocations;
+}
+
+vector<MemoryTracker::Frame>& MemoryTracker::Stack()
+{
+  static vector<Frame> stack;
+  return stack;
+}
+
+map<string, MemoryTracker::PhaseStatistics>& MemoryTracker::Statistics()
+{
+  static map<string, PhaseStatistics> statistics;
+  return statistics;
+}
+
+mutex& MemoryTracker::PhaseMutex()
+{
+  static mutex phaseMutex;
+  return phaseMutex;
+}
+
+void MemoryTracker::RaisePeak(atomic<size_t>& peak, const size_t bytes)
+{
+  size_t oldPeak = peak.load(memory_order_relaxed);
+  while (oldPeak < bytes &&
+      !peak.compare_exchange_weak(oldPeak, bytes, memory_order_relaxed))
+  { }
+}
+
+void* MemoryTracker::Allocate(const size_t bytes)
+{
+  char* memory = AllocateBlock(bytes + headerSize);
+  if (memory == NULL)
+    return NULL;
+
+  *((size_t*) memory) = bytes;
+  AllocationCount().fetch_add(1, memory_order_relaxed);
+  const size_t current = Current().fetch_add(bytes, memory_order_relaxed) +
+      bytes;
+  RaisePeak(Peak(), current);
+  RaisePeak(PhasePeak(), current);
+
+  return memory + headerSize;
+}
+
+void MemoryTracker::Free(void* memory)
+{
+  if (memory == NULL)
+    return;
+
+  char* block = ((char*) memory) - headerSize;
+  Current().fetch_sub(*((size_t*) block), memory_order_relaxed);
+  FreeBlock(block);
+}
+
+size_t MemoryTracker::CurrentBytes()
+{
+  return Current().load(memory_order_relaxed);
+}
+
+size_t MemoryTracker::PeakBytes()
+{
+  return Peak().load(memory_order_relaxed);
+}
+
+size_t MemoryTracker::Allocations()
+{
+  return AllocationCount().load(memory_order_relaxed);
+}
+
+bool MemoryTracker::EnterPhase(const string& name)
+{
+  #ifdef HAS_OPENMP
+  if (omp_in_parallel())
+    return false;
+  #endif
+
+  lock_guard<mutex> lock(PhaseMutex());
+  const size_t current = CurrentBytes();
+  Stack().push_back(Frame{ name, current,
+      PhasePeak().load(memory_order_relaxed) });
+  PhasePeak().store(current, memory_order_relaxed);
+  return true;
+}
+
+void MemoryTracker::ExitPhase()
+{
+  lock_guard<mutex> lock(PhaseMutex());
+  if (Stack().empty())
+    return;
+
+  const Frame frame = Stack().back();
+  Stack().pop_back();
+
+  const size_t current = CurrentBytes();
+  const size_t phasePeak = max(PhasePeak().load(memory_order_relaxed),
+      max(frame.startBytes, current));
+
+  PhaseStatistics& statistics = Statistics()[frame.name];
+  ++statistics.calls;
+  statistics.peakBytes = max(statistics.peakBytes, phasePeak);
+  statistics.peakIncrease = max(statistics.peakIncrease,
+      phasePeak - frame.startBytes);
+  statistics.netBytes += (int64_t) current - (int64_t) frame.startBytes;
+
+  // The peak of this phase is also a peak of the enclosing phase.
+  PhasePeak().store(max(frame.outerPeak, phasePeak), memory_order_relaxed);
+}
+
+void MemoryTracker::Reset()
+{
+  lock_guard<mutex> lock(PhaseMutex());
+  Stack().clear();
+  Statistics().clear();
+  Peak().store(CurrentBytes(), memory_order_relaxed);
+  PhasePeak().store(CurrentBytes(), memory_order_relaxed);
+}
+
+bool MemoryTracker::Empty()
+{
+  lock_guard<mutex> lock(PhaseMutex());
+  return Statistics().empty();
+}
+
+map<string, MemoryTracker::PhaseStatistics> MemoryTracker::Phases()
+{
+  lock_guard<mutex> lock(PhaseMutex());
+  return Statistics();
+}
+
+string MemoryTracker::ToJSON()
+{
+  const map<string, PhaseStatistics> phases = Phases();
+
+  ostringstream json;
+  json << "{ \"current_bytes\": " << CurrentBytes() << ", \"peak_bytes\": "
+      << PeakBytes() << ", \"phases\": [";
+  bool first = true;
+  for (const pair<const string, PhaseStatistics>& phase : phases)
+  {
+    if (!first)
+      json << ", ";
+    first = false;
+
+    json << "{ \"name\": \"" << EscapeJSON(phase.first) << "\", \"calls\": "
+        << phase.second.calls << ", \"peak_bytes\": "
+        << phase.second.peakBytes << ", \"peak_increase_bytes\": "
+        << phase.second.peakIncrease << ", \"net_bytes\": "
+        << phase.second.netBytes << " }";
+  }
+  json << "] }";
+  return json.str();
+}
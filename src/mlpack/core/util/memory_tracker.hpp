@@ -0,0 +1,219 @@
+/**
+ * @file core/util/memory_tracker.hpp
+ *
+ * An allocator for Armadillo that accounts for the current and peak memory
+ * used by matrices, overall and in named phases of an algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTILITIES_MEMORY_TRACKER_HPP
+#define MLPACK_CORE_UTILITIES_MEMORY_TRACKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The MemoryTracker counts the bytes allocated by Armadillo objects, and
+ * records the peak number of bytes in use, both overall and in named phases of
+ * an algorithm (such as "reference_tree_building" or "ffn_training").  For
+ * each phase, it keeps the number of times the phase ran, the highest peak of
+ * all of its runs, the highest increase of the peak over the memory in use at
+ * the start of a run, and the total net change of the memory in use at the end
+ * of the runs.  Phases may be nested; the peak of an inner phase also counts
+ * for the outer phases.
+ *
+ * The tracker is only used if MLPACK_ENABLE_MEMORY_TRACKING is defined (this
+ * is done by the ENABLE_MEMORY_TRACKING CMake option): then Armadillo is told
+ * to allocate its memory with Allocate() and Free() (through
+ * ARMA_ALIEN_MEM_ALLOC_FUNCTION and ARMA_ALIEN_MEM_FREE_FUNCTION), and the
+ * MLPACK_MEMORY_PHASE() macro marks the rest of a C++ scope as a phase:
+ *
+ * @code
+ * void Train(...)
+ * {
+ *   MLPACK_MEMORY_PHASE("tree_building");
+ *   ...
+ * }
+ * @endcode
+ *
+ * Since memory allocated by Armadillo with the tracker must be freed by the
+ * tracker, all the code of a program that uses Armadillo (mlpack and the
+ * program itself) must be compiled with the same setting of
+ * MLPACK_ENABLE_MEMORY_TRACKING.  Memory that is not allocated by Armadillo
+ * (such as the nodes of trees) is not counted.  For the same reason, the
+ * tracker cannot be used with the Python, Julia or Go bindings, which pass the
+ * ownership of matrix memory between Armadillo and malloc() and free(); CMake
+ * refuses to configure ENABLE_MEMORY_TRACKING together with them.
+ *
+ * Allocations may happen on any thread, but phases are only recorded when
+ * they are entered outside of OpenMP parallel regions; the phases entered
+ * inside them are ignored.  Command-line programs print the phases with the
+ * timers when --verbose is given.
+ */
+class MemoryTracker
+{
+ public:
+  //! The statistics of a phase.
+  struct PhaseStatistics
+  {
+    //! The number of times the phase ran.
+    size_t calls;
+    //! The highest number of bytes in use during the phase.
+    size_t peakBytes;
+    //! The highest increase of the bytes in use during a run of the phase,
+    //! over the bytes in use at its start.
+    size_t peakIncrease;
+    //! The total change of the bytes in use by the runs of the phase.
+    int64_t netBytes;
+  };
+
+  /**
+   * Allocate the given number of bytes, and account for them.  The memory is
+   * aligned like memory from malloc() (or from the HugePageAllocator, if
+   * MLPACK_ENABLE_HUGE_PAGES is defined).  This returns NULL if the memory
+   * cannot be allocated.
+   *
+   * @param bytes Number of bytes to allocate.
+   */
+  static void* Allocate(const size_t bytes);
+
+  /**
+   * Free memory allocated by Allocate(), and account for it.
+   *
+   * @param memory Memory to free (may be NULL).
+   */
+  static void Free(void* memory);
+
+  //! Get the number of bytes currently allocated.
+  static size_t CurrentBytes();
+  //! Get the highest number of bytes allocated since the last Reset().
+  static size_t PeakBytes();
+  //! Get the number of allocations made by Allocate() since the program
+  //! started.
+  static size_t Allocations();
+
+  /**
+   * Enter the phase with the given name.  This returns false (and does
+   * nothing) if called inside an OpenMP parallel region.
+   *
+   * @param name Name of the phase.
+   */
+  static bool EnterPhase(const std::string& name);
+
+  /**
+   * Leave the innermost phase, and record its statistics.
+   */
+  static void ExitPhase();
+
+  /**
+   * Remove the statistics of all phases, and set the peak to the number of
+   * bytes currently allocated.  No phase may be running.
+   */
+  static void Reset();
+
+  //! Return true if no phase has been recorded.
+  static bool Empty();
+
+  //! Get the statistics of all recorded phases, by name.
+  static std::map<std::string, PhaseStatistics> Phases();
+
+  /**
+   * Return the memory statistics as JSON, in the form
+   *
+   * @code
+   * { "current_bytes": 1024, "peak_bytes": 4096, "phases": [{ "name": "a",
+   *   "calls": 1, "peak_bytes": 4096, "peak_increase_bytes": 3072,
+   *   "net_bytes": 0 }] }
+   * @endcode
+   */
+  static std::string ToJSON();
+
+ private:
+  //! A running phase.
+  struct Frame
+  {
+    //! The name of the phase.
+    std::string name;
+    //! The bytes in use when the phase was entered.
+    size_t startBytes;
+    //! The peak of the enclosing phases when the phase was entered.
+    size_t outerPeak;
+  };
+
+  //! Raise the given peak to the given value, if it is lower.
+  static void RaisePeak(std::atomic<size_t>& peak, const size_t bytes);
+
+  //! The bytes currently allocated.
+  static std::atomic<size_t>& Current();
+  //! The highest number of bytes allocated since the last Reset().
+  static std::atomic<size_t>& Peak();
+  //! The highest number of bytes allocated since the innermost phase started.
+  static std::atomic<size_t>& PhasePeak();
+  //! The number of allocations made by Allocate().
+  static std::atomic<size_t>& AllocationCount();
+
+  //! The running phases.
+  static std::vector<Frame>& Stack();
+  //! The statistics of the recorded phases.
+  static std::map<std::string, PhaseStatistics>& Statistics();
+  //! The lock of the running phases and the statistics.
+  static std::mutex& PhaseMutex();
+};
+
+/**
+ * Record the enclosing C++ scope as a MemoryTracker phase: the phase is
+ * entered on construction and left on destruction.
+ */
+class MemoryPhase
+{
+ public:
+  //! Enter the phase with the given name.
+  explicit MemoryPhase(const std::string& name) :
+      entered(MemoryTracker::EnterPhase(name)) { }
+
+  //! Leave the phase.
+  ~MemoryPhase()
+  {
+    if (entered)
+      MemoryTracker::ExitPhase();
+  }
+
+  // Phases cannot be copied.
+  MemoryPhase(const MemoryPhase&) = delete;
+  MemoryPhase& operator=(const MemoryPhase&) = delete;
+
+ private:
+  //! Whether the phase was entered (outside of a parallel region).
+  bool entered;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#define MLPACK_MEMORY_PHASE_JOIN_INNER(X, Y) X##Y
+#define MLPACK_MEMORY_PHASE_JOIN(X, Y) MLPACK_MEMORY_PHASE_JOIN_INNER(X, Y)
+
+/**
+ * Record the rest of the enclosing C++ scope as a memory phase with the given
+ * name, if MLPACK_ENABLE_MEMORY_TRACKING is defined.
+ */
+#ifdef MLPACK_ENABLE_MEMORY_TRACKING
+  #define MLPACK_MEMORY_PHASE(NAME) \
+      mlpack::util::MemoryPhase MLPACK_MEMORY_PHASE_JOIN(mlpackMemoryPhase, \
+          __LINE__)(NAME)
+#else
+  #define MLPACK_MEMORY_PHASE(NAME)
+#endif
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @file core/util/numa.hpp
+ *
+ * Utilities for the NUMA mode (see SetNUMAMode()): the parallel first-touch
+ * placement of matrices, and per-node replicas of read-only objects.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_NUMA_HPP
+#define MLPACK_CORE_UTIL_NUMA_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "threads.hpp"
+
+#include <memory>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Return whether a matrix with the given number of columns should be placed
+ * with parallel first touch: the NUMA mode must be enabled, and there must be
+ * several threads and several columns.
+ */
+inline bool UseFirstTouch(const size_t cols)
+{
+  #ifdef HAS_OPENMP
+  return NUMAMode() && (cols > 1) && (NumThreads() > 1) && !omp_in_parallel();
+  #else
+  (void) cols;
+  return false;
+  #endif
+}
+
+/**
+ * In NUMA mode, copy the given matrix into a new matrix whose columns are
+ * written by a parallel loop with a static schedule, and return the copy;
+ * otherwise, return the matrix itself.  The operating system allocates each
+ * page of the copy in the memory of the socket of the thread that writes it
+ * first, so a parallel loop over the columns of the copy with a static
+ * schedule (and the same number of threads) reads each column from the memory
+ * of its own socket.
+ *
+ * @param matrix Matrix to copy.
+ * @param copy Storage for the copy (only used in NUMA mode).
+ * @return The matrix to use: copy in NUMA mode, matrix otherwise.
+ */
+template<typename eT>
+const arma::Mat<eT>& FirstTouchCopy(const arma::Mat<eT>& matrix,
+                                    arma::Mat<eT>& copy)
+{
+  if (!UseFirstTouch(matrix.n_cols))
+    return matrix;
+
+  copy.set_size(matrix.n_rows, matrix.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) matrix.n_cols; ++i)
+  {
+    std::copy(matrix.colptr(i), matrix.colptr(i) + matrix.n_rows,
+        copy.colptr(i));
+  }
+
+  return copy;
+}
+
+/**
+ * Other matrix types (like sparse matrices) are used as they are.
+ */
+template<typename MatType>
+const MatType& FirstTouchCopy(const MatType& matrix, MatType& /* copy */)
+{
+  return matrix;
+}
+
+/**
+ * In NUMA mode, move the elements of the given matrix to new memory that is
+ * first touched by a parallel loop over the columns with a static schedule (see
+ * FirstTouchCopy()); otherwise, do nothing.  The matrix keeps its address, so
+ * pointers to it (like the dataset of a tree) stay valid.
+ *
+ * @param matrix Matrix to place.
+ */
+template<typename eT>
+void FirstTouch(arma::Mat<eT>& matrix)
+{
+  arma::Mat<eT> copy;
+  if (&FirstTouchCopy(matrix, copy) == &copy)
+    matrix.steal_mem(copy);
+}
+
+//! Other matrix types (like sparse matrices) are left as they are.
+template<typename MatType>
+void FirstTouch(MatType& /* matrix */)
+{
+  // Nothing to do.
+}
+
+/**
+ * The NUMAReplicas class holds one copy of a read-only object per NUMA node in
+ * NUMA mode, so that the threads of a parallel region can read the object from
+ * the memory of their own socket.  Each copy is made by a thread of its node,
+ * so it is allocated on that node.  Outside of NUMA mode (or on a machine with
+ * one node), no copy is made, and Local() returns the original object.
+ *
+ * @code
+ * NUMAReplicas<std::vector<Tree>> replicas(trees);
+ * #pragma omp parallel
+ * {
+ *   const std::vector<Tree>& localTrees = replicas.Local();
+ *   #pragma omp for
+ *   for (...)
+ *   {
+ *     // Use localTrees.
+ *   }
+ * }
+ * @endcode
+ *
+ * @tparam T Type of the object; it must be copy-constructible.
+ */
+template<typename T>
+class NUMAReplicas
+{
+ public:
+  /**
+   * Make the replicas of the given object, which must not be modified or
+   * destroyed while the NUMAReplicas object is used.  This should be called
+   * outside of a parallel region.
+   *
+   * @param original Object to replicate.
+   */
+  NUMAReplicas(const T& original) : original(original)
+  {
+    #ifdef HAS_OPENMP
+    const size_t numNodes = NumNUMANodes();
+    if (!NUMAMode() || numNodes < 2 || NumThreads() < 2 || omp_in_parallel())
+      return;
+
+    // The first thread of each node that starts copies the object.
+    replicas.resize(numNodes);
+    std::vector<char> claimed(numNodes, 0);
+    #pragma omp parallel
+    {
+      const size_t node = NUMANode();
+      bool copy = false;
+      #pragma omp critical(mlpack_numa_replicas)
+      {
+        if (node < numNodes && !claimed[node])
+        {
+          claimed[node] = 1;
+          copy = true;
+        }
+      }
+
+      if (copy)
+        replicas[node].reset(new T(original));
+    }
+    #endif
+  }
+
+  //! Get the replica of the node of the calling thread (or the original).
+  const T& Local() const
+  {
+    if (replicas.empty())
+      return original;
+
+    const size_t node = NUMANode();
+    return (node < replicas.size() && replicas[node]) ? *replicas[node] :
+        original;
+  }
+
+  //! Get the number of replicas that were made.
+  size_t NumReplicas() const
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < replicas.size(); ++i)
+      count += (replicas[i] ? 1 : 0);
+    return count;
+  }
+
+ private:
+  //! The original object.
+  const T& original;
+  //! The replica of each node (null for the nodes that have none).
+  std::vector<std::unique_ptr<T>> replicas;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,9 @@
 #include <mlpack/prereqs.hpp>
 
 #include "prefixedoutstream.hpp"
+#include "async_log_writer.hpp"
+
+#include <unordered_map>
 
 using namespace mlpack::util;
 
@@ -125,3 +128,41 @@ PrefixedOutStream& PrefixedOutStream::operator<<(
   BaseLogic<std::ios_base& (*)(std::ios_base&)>(pf);
   return *this;
 }
+
+void PrefixedOutStream::Asynchronous(const bool async)
+{
+  if (fatal)
+    return;
+
+  if (asynchronous && !async)
+    FlushAsynchronous();
+  asynchronous = async;
+}
+
+void PrefixedOutStream::WriteAsynchronous(const std::string& text)
+{
+  // The incomplete line of each asynchronous stream, in each thread.
+  static thread_local std::unordered_map<const PrefixedOutStream*,
+      std::string> buffers;
+  std::string& buffer = buffers[this];
+
+  size_t nl;
+  size_t pos = 0;
+  while ((nl = text.find('\n', pos)) != std::string::npos)
+  {
+    std::string line;
+    line.reserve(prefix.size() + buffer.size() + (nl - pos) + 1);
+    line.append(prefix).append(buffer).append(text, pos, nl - pos + 1);
+    buffer.clear();
+    AsyncLogWriter::Get().Write(destination, std::move(line));
+
+    pos = nl + 1;
+  }
+
+  buffer.append(text, pos, std::string::npos);
+}
+
+void PrefixedOutStream::FlushAsynchronous()
+{
+  AsyncLogWriter::Get().Flush();
+}
@@ -69,9 +69,27 @@ class PrefixedOutStream
       // We want the first call to operator<< to prefix the prefix so we set
       // carriageReturned to true.
       carriageReturned(true),
-      fatal(fatal)
+      fatal(fatal),
+      asynchronous(false)
     { /* nothing to do */ }
 
+  /**
+   * Get whether the stream is asynchronous.  An asynchronous stream collects
+   * the output of each thread in a buffer of that thread, and each complete
+   * line is written to the destination by the background AsyncLogWriter, so
+   * the threads that log are never blocked by the destination or by each
+   * other.  The output of the threads is not interleaved within lines, but a
+   * line is only written once it is complete.
+   */
+  bool Asynchronous() const { return asynchronous; }
+
+  /**
+   * Make the stream asynchronous (or synchronous again, after writing the
+   * queued lines).  Fatal streams are always synchronous, since they must
+   * print their message before throwing.
+   */
+  void Asynchronous(const bool async);
+
   //! Write a bool to the stream.
   PrefixedOutStream& operator<<(bool val);
   //! Write a short to the stream.
@@ -156,6 +174,15 @@ class PrefixedOutStream
    */
   inline void PrefixIfNeeded();
 
+  /**
+   * Append the given text to the buffer of the calling thread, and queue the
+   * complete lines.
+   */
+  void WriteAsynchronous(const std::string& text);
+
+  //! Wait until the lines queued by asynchronous streams have been written.
+  static void FlushAsynchronous();
+
   //! Contains the prefix we must prepend to each line.
   std::string prefix;
 
@@ -166,6 +193,9 @@ class PrefixedOutStream
   //! If true, a std::runtime_error exception will be thrown when a CR is
   //! encountered.
   bool fatal;
+
+  //! If true, complete lines are written by the AsyncLogWriter.
+  bool asynchronous;
 };
 
 } // namespace util
@@ -43,8 +43,18 @@ PrefixedOutStream::BaseLogic(const T& val)
   bool newlined = false;
   std::string line;
 
+  // A stream that ignores its input does not even format it (though a fatal
+  // stream still needs to find the end of its message).
+  if (ignoreInput && !fatal)
+    return;
+
+  // Keep the order of the messages that are queued by asynchronous streams.
+  if (fatal)
+    FlushAsynchronous();
+
   // If we need to, output the prefix.
-  PrefixIfNeeded();
+  if (!asynchronous)
+    PrefixIfNeeded();
 
   std::ostringstream convert;
   // Sync flags and precision with destination stream
@@ -77,6 +87,13 @@ PrefixedOutStream::BaseLogic(const T& val)
       return;
     }
 
+    // An asynchronous stream only queues the complete lines.
+    if (asynchronous)
+    {
+      WriteAsynchronous(line);
+      return;
+    }
+
     // Now, we need to check for newlines in the output and print it.
     size_t nl;
     size_t pos = 0;
@@ -154,8 +171,18 @@ PrefixedOutStream::BaseLogic(const T& val)
   bool newlined = false;
   std::string line;
 
+  // A stream that ignores its input does not even format it (though a fatal
+  // stream still needs to find the end of its message).
+  if (ignoreInput && !fatal)
+    return;
+
+  // Keep the order of the messages that are queued by asynchronous streams.
+  if (fatal)
+    FlushAsynchronous();
+
   // If we need to, output the prefix.
-  PrefixIfNeeded();
+  if (!asynchronous)
+    PrefixIfNeeded();
 
   std::ostringstream convert;
 
@@ -209,6 +236,13 @@ PrefixedOutStream::BaseLogic(const T& val)
       return;
     }
 
+    // An asynchronous stream only queues the complete lines.
+    if (asynchronous)
+    {
+      WriteAsynchronous(line);
+      return;
+    }
+
     // Now, we need to check for newlines in the output and print it.
     size_t nl;
     size_t pos = 0;
@@ -0,0 +1,254 @@
+/**
+ * @file core/util/profiler.cpp
+ *
+ * Implementation of the Profiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "profiler.hpp"
+
+#include <map>
+#include <sstream>
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+using namespace chrono;
+
+namespace {
+
+//! The id of the root of the call trees.
+const size_t rootId = size_t(-1);
+
+//! The registered names of the scopes, and a lock for them.
+vector<string>& ScopeNames()
+{
+  static vector<string> names;
+  return names;
+}
+
+mutex& ScopeNamesMutex()
+{
+  static mutex namesMutex;
+  return namesMutex;
+}
+
+//! A node of the merged call tree.
+struct MergedNode
+{
+  uint64_t calls;
+  uint64_t nanoseconds;
+  //! The ids of the child scopes, and their nodes.
+  map<size_t, size_t> children;
+};
+
+//! Escape the given name for JSON.
+string EscapeJSON(const string& name)
+{
+  string result;
+  for (const char c : name)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    result += c;
+  }
+  return result;
+}
+
+//! Print the children of the given merged node as a JSON array.
+void PrintJSON(const vector<MergedNode>& nodes,
+               const size_t node,
+               const vector<string>& names,
+               ostringstream& json)
+{
+  json << "[";
+  bool first = true;
+  for (const pair<const size_t, size_t>& child : nodes[node].children)
+  {
+    if (!first)
+      json << ", ";
+    first = false;
+
+    const MergedNode& childNode = nodes[child.second];
+    json << "{ \"name\": \"" << EscapeJSON(names[child.first])
+        << "\", \"calls\": " << childNode.calls << ", \"nanoseconds\": "
+        << childNode.nanoseconds << ", \"children\": ";
+    PrintJSON(nodes, child.second, names, json);
+    json << " }";
+  }
+  json << "]";
+}
+
+} // namespace
+
+/**
+ * The measurements of all threads are kept (also after the threads end), so
+ * that they can be merged.
+ */
+vector<unique_ptr<Profiler::ThreadData>>& Profiler::AllThreadData()
+{
+  static vector<unique_ptr<ThreadData>> data;
+  return data;
+}
+
+mutex& Profiler::AllThreadDataMutex()
+{
+  static mutex dataMutex;
+  return dataMutex;
+}
+
+/**
+ * Get the id of the scope with the given name, registering it if needed.
+ */
+size_t Profiler::Register(const string& name)
+{
+  lock_guard<mutex> lock(ScopeNamesMutex());
+  vector<string>& names = ScopeNames();
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    if (names[i] == name)
+      return i;
+  }
+
+  names.push_back(name);
+  return names.size() - 1;
+}
+
+/**
+ * Get the measurements of the calling thread, creating them the first time.
+ */
+Profiler::ThreadData& Profiler::LocalData()
+{
+  static thread_local ThreadData* localData = NULL;
+  if (localData == NULL)
+  {
+    unique_ptr<ThreadData> data(new ThreadData());
+    data->nodes.push_back(Node{ rootId, 0, 0, {} });
+
+    lock_guard<mutex> lock(AllThreadDataMutex());
+    localData = data.get();
+    AllThreadData().push_back(move(data));
+  }
+
+  return *localData;
+}
+
+void Profiler::Enter(const size_t id)
+{
+  ThreadData& data = LocalData();
+  const size_t parent = data.stack.empty() ? 0 : data.stack.back().node;
+
+  // Fold recursive calls into the running scope.
+  if (!data.stack.empty() && data.nodes[parent].id == id)
+  {
+    ++data.stack.back().recursion;
+    ++data.nodes[parent].calls;
+    return;
+  }
+
+  size_t node = data.nodes.size();
+  for (const pair<size_t, size_t>& child : data.nodes[parent].children)
+  {
+    if (child.first == id)
+    {
+      node = child.second;
+      break;
+    }
+  }
+
+  if (node == data.nodes.size())
+  {
+    data.nodes[parent].children.push_back(make_pair(id, node));
+    data.nodes.push_back(Node{ id, 0, 0, {} });
+  }
+
+  ++data.nodes[node].calls;
+  data.stack.push_back(Frame{ node, 0, steady_clock::now() });
+}
+
+void Profiler::Exit()
+{
+  const steady_clock::time_point end = steady_clock::now();
+  ThreadData& data = LocalData();
+  if (data.stack.empty())
+    return;
+
+  Frame& frame = data.stack.back();
+  if (frame.recursion > 0)
+  {
+    --frame.recursion;
+    return;
+  }
+
+  data.nodes[frame.node].nanoseconds +=
+      duration_cast<nanoseconds>(end - frame.start).count();
+  data.stack.pop_back();
+}
+
+void Profiler::Reset()
+{
+  lock_guard<mutex> lock(AllThreadDataMutex());
+  for (unique_ptr<ThreadData>& data : AllThreadData())
+  {
+    data->nodes.resize(1);
+    data->nodes[0].children.clear();
+    data->stack.clear();
+  }
+}
+
+bool Profiler::Empty()
+{
+  lock_guard<mutex> lock(AllThreadDataMutex());
+  for (const unique_ptr<ThreadData>& data : AllThreadData())
+  {
+    if (data->nodes.size() > 1)
+      return false;
+  }
+
+  return true;
+}
+
+string Profiler::ToJSON()
+{
+  // Merge the call trees of all threads, by the names of the scopes on the path
+  // from the root.
+  vector<MergedNode> merged(1, MergedNode{ 0, 0, {} });
+  {
+    lock_guard<mutex> lock(AllThreadDataMutex());
+    for (const unique_ptr<ThreadData>& data : AllThreadData())
+    {
+      // Depth-first, with the pairs of thread nodes and merged nodes.
+      vector<pair<size_t, size_t>> stack;
+      stack.push_back(make_pair(size_t(0), size_t(0)));
+      while (!stack.empty())
+      {
+        const Node& node = data->nodes[stack.back().first];
+        const size_t mergedNode = stack.back().second;
+        stack.pop_back();
+
+        for (const pair<size_t, size_t>& child : node.children)
+        {
+          if (merged[mergedNode].children.count(child.first) == 0)
+          {
+            merged[mergedNode].children[child.first] = merged.size();
+            merged.push_back(MergedNode{ 0, 0, {} });
+          }
+
+          const size_t mergedChild = merged[mergedNode].children[child.first];
+          merged[mergedChild].calls += data->nodes[child.second].calls;
+          merged[mergedChild].nanoseconds +=
+              data->nodes[child.second].nanoseconds;
+          stack.push_back(make_pair(child.second, mergedChild));
+        }
+      }
+    }
+  }
+
+  lock_guard<mutex> lock(ScopeNamesMutex());
+  ostringstream json;
+  PrintJSON(merged, 0, ScopeNames(), json);
+  return json.str();
+}
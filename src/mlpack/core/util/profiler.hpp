@@ -0,0 +1,179 @@
+/**
+ * @file core/util/profiler.hpp
+ *
+ * A hierarchical profiler with low enough overhead to be used inside hot paths,
+ * such as tree traversals.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTILITIES_PROFILER_HPP
+#define MLPACK_CORE_UTILITIES_PROFILER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The Profiler measures the time spent in named scopes, and the number of times
+ * each scope is entered, as a call tree.  Unlike the Timers, the name of each
+ * scope is interned once into an id with Register(), and each thread records
+ * its scopes in its own call tree, so entering and leaving a scope takes no
+ * lock and does no string or map operation.  Times have nanosecond resolution.
+ * Recursive calls of the innermost scope (as in a tree traversal) are folded
+ * into one call tree node, and counted as calls.
+ *
+ * Scopes are usually profiled with the MLPACK_PROFILE_SCOPE() macro, which
+ * compiles to nothing unless MLPACK_ENABLE_PROFILING is defined (this is done
+ * by the ENABLE_PROFILING CMake option), so that profiled hot paths cost
+ * nothing in regular builds:
+ *
+ * @code
+ * void Traverse(...)
+ * {
+ *   MLPACK_PROFILE_SCOPE("single_tree_traversal");
+ *   ...
+ * }
+ * @endcode
+ *
+ * The call trees of all threads are merged by ToJSON(), which should only be
+ * called when no profiled scope is running; command-line programs print it
+ * with the timers when --verbose is given.
+ */
+class Profiler
+{
+ public:
+  /**
+   * Get the id of the scope with the given name, registering it if needed.
+   * This takes a lock, so the result should be kept (as MLPACK_PROFILE_SCOPE()
+   * does).
+   *
+   * @param name Name of the scope.
+   */
+  static size_t Register(const std::string& name);
+
+  /**
+   * Enter the scope with the given id on the calling thread.
+   *
+   * @param id Id of the scope, as given by Register().
+   */
+  static void Enter(const size_t id);
+
+  /**
+   * Leave the innermost scope of the calling thread.
+   */
+  static void Exit();
+
+  /**
+   * Remove all the measurements of all threads.  No profiled scope may be
+   * running.
+   */
+  static void Reset();
+
+  //! Return true if no scope has been measured.
+  static bool Empty();
+
+  /**
+   * Return the call tree of all threads, merged, as JSON, in the form
+   *
+   * @code
+   * [{ "name": "a", "calls": 2, "nanoseconds": 1500, "children": [ ... ] }]
+   * @endcode
+   *
+   * No profiled scope may be running.
+   */
+  static std::string ToJSON();
+
+ private:
+  //! A node of the call tree of a thread.
+  struct Node
+  {
+    //! The id of the scope.
+    size_t id;
+    //! The number of calls.
+    uint64_t calls;
+    //! The total time spent in the scope.
+    uint64_t nanoseconds;
+    //! The ids of the child scopes, and their nodes.
+    std::vector<std::pair<size_t, size_t>> children;
+  };
+
+  //! A running scope.
+  struct Frame
+  {
+    //! The node of the scope.
+    size_t node;
+    //! The number of folded recursive calls that are running.
+    size_t recursion;
+    //! The time the scope was entered.
+    std::chrono::steady_clock::time_point start;
+  };
+
+  //! The measurements of one thread.
+  struct ThreadData
+  {
+    //! The call tree; the first node is the root.
+    std::vector<Node> nodes;
+    //! The running scopes.
+    std::vector<Frame> stack;
+  };
+
+  //! Get the measurements of the calling thread.
+  static ThreadData& LocalData();
+
+  //! Get the measurements of all threads (also after the threads end).
+  static std::vector<std::unique_ptr<ThreadData>>& AllThreadData();
+
+  //! Get the lock of the measurements of all threads.
+  static std::mutex& AllThreadDataMutex();
+};
+
+/**
+ * Profile the enclosing C++ scope: the Profiler scope is entered on
+ * construction and left on destruction.
+ */
+class ProfileScope
+{
+ public:
+  //! Enter the scope with the given id.
+  explicit ProfileScope(const size_t id) { Profiler::Enter(id); }
+
+  //! Leave the scope.
+  ~ProfileScope() { Profiler::Exit(); }
+
+  // Scopes cannot be copied.
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#define MLPACK_PROFILE_JOIN_INNER(X, Y) X##Y
+#define MLPACK_PROFILE_JOIN(X, Y) MLPACK_PROFILE_JOIN_INNER(X, Y)
+
+/**
+ * Profile the rest of the enclosing C++ scope under the given name, if
+ * MLPACK_ENABLE_PROFILING is defined.  The name is only registered the first
+ * time the line runs.
+ */
+#ifdef MLPACK_ENABLE_PROFILING
+  #define MLPACK_PROFILE_SCOPE(NAME) \
+      static const size_t MLPACK_PROFILE_JOIN(mlpackProfileId, __LINE__) = \
+          mlpack::util::Profiler::Register(NAME); \
+      mlpack::util::ProfileScope MLPACK_PROFILE_JOIN(mlpackProfileScope, \
+          __LINE__)(MLPACK_PROFILE_JOIN(mlpackProfileId, __LINE__))
+#else
+  #define MLPACK_PROFILE_SCOPE(NAME)
+#endif
+
+#endif
@@ -0,0 +1,276 @@
+/**
+ * @file core/util/threads.cpp
+ *
+ * Implementation of the control of the number of threads of OpenMP and BLAS.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "threads.hpp"
+#include "log.hpp"
+#include "params.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+// The thread-control functions of OpenBLAS and MKL are declared as weak
+// symbols, so that they are null when mlpack is linked with another BLAS
+// library.  Weak symbols are not available with MSVC, and on macOS they need
+// extra linker flags, so the number of BLAS threads is not controlled there.
+#if defined(__GNUC__) && !defined(_WIN32) && !defined(__APPLE__)
+  #define MLPACK_BLAS_THREAD_CONTROL
+extern "C" {
+void openblas_set_num_threads(int) __attribute__((weak));
+int openblas_get_num_threads() __attribute__((weak));
+void MKL_Set_Num_Threads(int) __attribute__((weak));
+int MKL_Get_Max_Threads() __attribute__((weak));
+}
+#endif
+
+using namespace mlpack;
+
+namespace {
+
+#ifdef HAS_OPENMP
+//! The number of threads of OpenMP when the program starts.
+const int defaultThreads = omp_get_max_threads();
+#endif
+
+//! Whether the NUMA mode is enabled.
+std::atomic<bool> numaMode(false);
+
+//! The lock of the state of the BLAS threads below.
+std::mutex blasMutex;
+//! The number of threads of BLAS before it was first changed (0 if it was not
+//! changed yet).
+size_t defaultBLASThreads = 0;
+//! The number of SerialBLASScopes that exist.
+size_t serialBLASScopes = 0;
+//! The number of BLAS threads to restore when the last scope is destroyed.
+size_t scopeBLASThreads = 0;
+
+//! Set the number of BLAS threads (with the lock held).
+bool SetBLASThreads(const size_t numThreads)
+{
+#ifdef MLPACK_BLAS_THREAD_CONTROL
+  if (defaultBLASThreads == 0)
+    defaultBLASThreads = BLASNumThreads();
+  const int threads = (int) ((numThreads == 0) ? defaultBLASThreads :
+      numThreads);
+  if (openblas_set_num_threads)
+  {
+    openblas_set_num_threads(threads);
+    return true;
+  }
+  if (MKL_Set_Num_Threads)
+  {
+    MKL_Set_Num_Threads(threads);
+    return true;
+  }
+#else
+  (void) numThreads;
+#endif
+  return false;
+}
+
+} // namespace
+
+void mlpack::SetNumThreads(const size_t numThreads)
+{
+#ifdef HAS_OPENMP
+  omp_set_num_threads((numThreads == 0) ? defaultThreads : (int) numThreads);
+#endif
+  SetBLASNumThreads(numThreads);
+}
+
+size_t mlpack::NumThreads()
+{
+#ifdef HAS_OPENMP
+  return (size_t) omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+void mlpack::SetNestedParallelism(const bool nested)
+{
+#ifdef HAS_OPENMP
+  // The runtime lowers the number of levels to the number it supports.
+  omp_set_max_active_levels(nested ? std::numeric_limits<int>::max() : 1);
+#else
+  (void) nested;
+#endif
+}
+
+bool mlpack::NestedParallelism()
+{
+#ifdef HAS_OPENMP
+  return omp_get_max_active_levels() > 1;
+#else
+  return false;
+#endif
+}
+
+bool mlpack::SetBLASNumThreads(const size_t numThreads)
+{
+  std::lock_guard<std::mutex> lock(blasMutex);
+  // While a SerialBLASScope exists, the new setting is used when the last
+  // scope is destroyed.
+  if (serialBLASScopes > 0)
+  {
+    scopeBLASThreads = numThreads;
+    return (BLASNumThreads() != 0);
+  }
+
+  return SetBLASThreads(numThreads);
+}
+
+size_t mlpack::BLASNumThreads()
+{
+#ifdef MLPACK_BLAS_THREAD_CONTROL
+  if (openblas_get_num_threads)
+    return (size_t) openblas_get_num_threads();
+  if (MKL_Get_Max_Threads)
+    return (size_t) MKL_Get_Max_Threads();
+#endif
+  return 0;
+}
+
+SerialBLASScope::SerialBLASScope()
+{
+  std::lock_guard<std::mutex> lock(blasMutex);
+  if (serialBLASScopes++ == 0)
+  {
+    scopeBLASThreads = BLASNumThreads();
+    SetBLASThreads(1);
+  }
+}
+
+SerialBLASScope::~SerialBLASScope()
+{
+  std::lock_guard<std::mutex> lock(blasMutex);
+  if (--serialBLASScopes == 0)
+    SetBLASThreads(scopeBLASThreads);
+}
+
+void mlpack::SetNUMAMode(const bool enabled)
+{
+  numaMode = enabled;
+  if (enabled && !PinThreads())
+  {
+    Log::Warn << "SetNUMAMode(): threads could not be pinned to cores; set "
+        << "OMP_PROC_BIND=close and OMP_PLACES=cores instead." << std::endl;
+  }
+}
+
+bool mlpack::NUMAMode()
+{
+  return numaMode;
+}
+
+bool mlpack::PinThreads()
+{
+#if defined(HAS_OPENMP) && defined(__linux__)
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return false;
+
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET(cpu, &allowed))
+      cpus.push_back(cpu);
+  if (cpus.empty())
+    return false;
+
+  // Thread i of the pool runs on the i-th allowed core (modulo the number of
+  // cores).
+  int failures = 0;
+  #pragma omp parallel reduction(+:failures)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[omp_get_thread_num() % cpus.size()], &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+      ++failures;
+  }
+
+  return (failures == 0);
+#else
+  return false;
+#endif
+}
+
+size_t mlpack::NumNUMANodes()
+{
+#ifdef __linux__
+  // The file holds a list of ranges of nodes, like "0-1" or "0,2-3"; the
+  // number of nodes is one more than the last node.  It is only read once.
+  static const size_t numNodes = []() -> size_t
+  {
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!(online >> nodes) || nodes.empty())
+      return 1;
+
+    const size_t last = nodes.find_last_of("-,");
+    try
+    {
+      return std::stoul((last == std::string::npos) ? nodes :
+          nodes.substr(last + 1)) + 1;
+    }
+    catch (std::exception&)
+    {
+      return 1;
+    }
+  }();
+
+  return numNodes;
+#else
+  return 1;
+#endif
+}
+
+size_t mlpack::NUMANode()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned int cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0)
+    return node;
+#endif
+  return 0;
+}
+
+void mlpack::util::SetNumThreads(Params& params)
+{
+  if (params.Parameters().count("num_threads") == 0 ||
+      !params.Has("num_threads"))
+    return;
+
+  const int numThreads = params.Get<int>("num_threads");
+  if (numThreads < 0)
+  {
+    Log::Fatal << "Invalid number of threads " << numThreads << " specified "
+        << "with --num_threads; must be greater than or equal to 0!"
+        << std::endl;
+  }
+
+  mlpack::SetNumThreads((size_t) numThreads);
+}
@@ -0,0 +1,154 @@
+/**
+ * @file core/util/threads.hpp
+ *
+ * Control of the number of threads used by the OpenMP regions of mlpack and by
+ * the BLAS library, and of nested parallelism.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_HPP
+#define MLPACK_CORE_UTIL_THREADS_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+
+/**
+ * Set the number of threads used by the parallel regions of mlpack that are
+ * started by the calling thread (this is omp_set_num_threads(), so other
+ * threads, such as other Python threads running bindings, keep their own
+ * setting).  The number of threads of the BLAS library is set too, if it is
+ * OpenBLAS or MKL, so that BLAS calls made outside of parallel regions use the
+ * same number of threads.  If numThreads is 0, the default number of threads
+ * (given by OMP_NUM_THREADS, or the number of cores) is used again.
+ *
+ * Without OpenMP, this only sets the number of threads of BLAS.
+ *
+ * @param numThreads Number of threads to use, or 0 for the default.
+ */
+void SetNumThreads(const size_t numThreads);
+
+/**
+ * Get the number of threads that a parallel region started by the calling
+ * thread will use (1 without OpenMP).
+ */
+size_t NumThreads();
+
+/**
+ * Enable or disable nested parallelism.  When it is disabled (the default of
+ * most OpenMP runtimes), a parallel region started inside another parallel
+ * region runs on one thread, so that methods that are parallel at several
+ * levels (for instance RandomForest, which trains trees in parallel, and
+ * DecisionTree, which builds subtrees in parallel) do not start more threads
+ * than cores.
+ *
+ * @param nested Whether nested parallel regions may use several threads.
+ */
+void SetNestedParallelism(const bool nested);
+
+//! Return whether nested parallel regions may use several threads.
+bool NestedParallelism();
+
+/**
+ * Set the number of threads of the BLAS library, if it is OpenBLAS or MKL;
+ * otherwise, do nothing and return false.  The setting is global to the
+ * process.  If numThreads is 0, the default number of threads of the library
+ * is used again.
+ *
+ * @param numThreads Number of BLAS threads to use, or 0 for the default.
+ * @return Whether the number of threads of the BLAS library could be set.
+ */
+bool SetBLASNumThreads(const size_t numThreads);
+
+/**
+ * Get the number of threads of the BLAS library, or 0 if it is not known
+ * (because the library is neither OpenBLAS nor MKL).
+ */
+size_t BLASNumThreads();
+
+/**
+ * A SerialBLASScope makes the BLAS library run on one thread while it exists.
+ * It is meant to be created before a parallel region whose threads call BLAS,
+ * so that each of them does not start its own BLAS threads; when the last
+ * SerialBLASScope is destroyed, the previous number of BLAS threads is used
+ * again.
+ *
+ * @code
+ * SerialBLASScope serialBLAS;
+ * #pragma omp parallel for
+ * for (...)
+ * {
+ *   // Each iteration calls BLAS on the thread that runs it.
+ * }
+ * @endcode
+ */
+class SerialBLASScope
+{
+ public:
+  //! Make BLAS run on one thread.
+  SerialBLASScope();
+  //! Restore the number of BLAS threads, if this is the last scope.
+  ~SerialBLASScope();
+
+  // A scope cannot be copied.
+  SerialBLASScope(const SerialBLASScope&) = delete;
+  SerialBLASScope& operator=(const SerialBLASScope&) = delete;
+};
+
+/**
+ * Enable or disable the NUMA mode.  In NUMA mode, the threads of the calling
+ * thread are pinned to cores (see PinThreads()), and the methods that support
+ * it place their large read-only data in the memory of the sockets that use
+ * it: KMeans and NeighborSearch initialize their data matrices in parallel, so
+ * that each page is first touched (and so allocated) by one of the threads
+ * that work on it, and RandomForest classifies with one replica of the forest
+ * per NUMA node.  This uses more memory and a little more time up front, so
+ * it is only worth it on machines with several sockets.  The NUMA mode is
+ * disabled by default.
+ *
+ * @param enabled Whether to use the NUMA mode.
+ */
+void SetNUMAMode(const bool enabled);
+
+//! Return whether the NUMA mode is enabled.
+bool NUMAMode();
+
+/**
+ * Pin each thread of the OpenMP thread pool of the calling thread to one of
+ * the cores it may run on, so that the threads do not move between sockets (the
+ * OpenMP runtimes reuse the same threads for later parallel regions, as long
+ * as the number of threads does not change).  This is only supported on
+ * Linux; elsewhere, OMP_PROC_BIND=close and OMP_PLACES=cores can be used
+ * instead.
+ *
+ * @return Whether the threads could be pinned.
+ */
+bool PinThreads();
+
+//! Get the number of NUMA nodes of the machine (1 if it is not known).
+size_t NumNUMANodes();
+
+//! Get the NUMA node that the calling thread runs on (0 if it is not known).
+size_t NUMANode();
+
+namespace util {
+
+class Params;
+
+/**
+ * Set the number of threads of the calling thread to the value of the
+ * "num_threads" parameter of a binding, if it was passed; a negative value is
+ * a fatal error.  This is called by the bindings of each language before the
+ * binding is run.
+ *
+ * @param params Parameters of the binding.
+ */
+void SetNumThreads(Params& params);
+
+} // namespace util
+} // namespace mlpack
+
+#endif
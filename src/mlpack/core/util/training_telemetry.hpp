@@ -0,0 +1,465 @@
+/**
+ * @file core/util/training_telemetry.hpp
+ *
+ * An ensmallen callback that reports the training throughput of a model: the
+ * samples per second, the time split between the objective, the gradient and
+ * the optimizer update, the time of each layer of an FFN, and the number of
+ * Armadillo allocations, as JSON lines.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTILITIES_TRAINING_TELEMETRY_HPP
+#define MLPACK_CORE_UTILITIES_TRAINING_TELEMETRY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+#include <chrono>
+
+namespace mlpack {
+namespace util {
+
+// This gives us a HasLayerForwardTimes<T> type, where
+// HasLayerForwardTimes<T>::value is true if the function T (such as an FFN)
+// measures the time of each of its layers.
+HAS_ANY_METHOD_FORM(LayerForwardTimes, HasLayerForwardTimes);
+
+// This gives us a HasNumFunctions<T> type, where HasNumFunctions<T>::value is
+// true if the function T is separable.
+HAS_ANY_METHOD_FORM(NumFunctions, HasNumFunctions);
+
+/**
+ * TrainingTelemetry is an ensmallen callback that measures where the time of
+ * an optimization goes, so that the throughput bottlenecks of a training job
+ * can be found without a profiler.  It can be given to any Train() function
+ * that takes ensmallen callbacks, such as those of FFN, LogisticRegression,
+ * SoftmaxRegression and LinearSVM:
+ *
+ * @code
+ * std::ofstream telemetry("telemetry.jsonl");
+ * model.Train(data, labels, optimizer, TrainingTelemetry(telemetry));
+ * @endcode
+ *
+ * The time between two events of the optimizer is given to the event that
+ * ends it: the time until the objective is reported counts as evaluation time,
+ * the time until the gradient is reported as gradient time, and the time until
+ * a step is taken as update time.  Most optimizers compute the objective and
+ * the gradient together (with EvaluateWithGradient()), so that both are
+ * counted as evaluation time; for an FFN, the forward and backward time of
+ * each layer is measured too (see FFN::LayerTiming()), which splits that time.
+ * The number of Armadillo allocations is only counted if mlpack was compiled
+ * with ENABLE_MEMORY_TRACKING (see MemoryTracker), and is 0 otherwise.
+ *
+ * The statistics are written as one JSON object per line: one for each epoch
+ * (for optimizers that report epochs), one for every StepInterval() steps if
+ * it is not 0, and one for the whole optimization, like
+ *
+ * @code
+ * { "event": "epoch", "index": 1, "objective": 0.52, "seconds": 0.31,
+ *   "steps": 32, "evaluations": 32, "samples": 1000,
+ *   "samples_per_second": 3225.8, "evaluate_seconds": 0.27,
+ *   "gradient_seconds": 0.0001, "update_seconds": 0.03, "allocations": 640,
+ *   "allocations_per_step": 20, "layer_forward_seconds": [0.09, 0.01],
+ *   "layer_backward_seconds": [0.1, 0.02] }
+ * @endcode
+ *
+ * (on one line).  An epoch processes all the points of the function; for
+ * optimizers that do not report epochs (such as L-BFGS), each evaluation is
+ * taken to process all the points.
+ */
+class TrainingTelemetry
+{
+ public:
+  //! The statistics of a part of an optimization.
+  struct Statistics
+  {
+    //! Create empty statistics.
+    Statistics() :
+        seconds(0.0),
+        evaluateSeconds(0.0),
+        gradientSeconds(0.0),
+        updateSeconds(0.0),
+        steps(0),
+        evaluations(0),
+        samples(0),
+        allocations(0),
+        objective(0.0)
+    { }
+
+    //! Get the number of samples processed per second.
+    double SamplesPerSecond() const
+    {
+      return (seconds > 0.0) ? samples / seconds : 0.0;
+    }
+
+    //! The total time.
+    double seconds;
+    //! The time spent computing the objective.
+    double evaluateSeconds;
+    //! The time spent computing the gradient (after the objective).
+    double gradientSeconds;
+    //! The time spent updating the coordinates.
+    double updateSeconds;
+    //! The number of steps taken.
+    size_t steps;
+    //! The number of evaluations of the objective.
+    size_t evaluations;
+    //! The number of samples processed.
+    size_t samples;
+    //! The number of Armadillo allocations.
+    size_t allocations;
+    //! The last reported objective.
+    double objective;
+    //! The time spent in the forward pass of each layer (for an FFN).
+    std::vector<double> layerForwardSeconds;
+    //! The time spent in the backward pass of each layer (for an FFN).
+    std::vector<double> layerBackwardSeconds;
+  };
+
+  /**
+   * Create the callback, which writes its JSON lines to the given stream.
+   *
+   * @param output Stream to write the statistics to.
+   * @param stepInterval Write the statistics of every stepInterval'th step (0
+   *     means that no steps are written).
+   */
+  TrainingTelemetry(std::ostream& output = std::cout,
+                    const size_t stepInterval = 0) :
+      output(output),
+      stepInterval(stepInterval),
+      epochs(0),
+      totalAllocations(0),
+      epochAllocations(0),
+      stepAllocations(0),
+      layerTiming(false)
+  { }
+
+  /**
+   * Start measuring at the beginning of the optimization.
+   *
+   * @param function Function to optimize.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& function,
+                         MatType& /* coordinates */)
+  {
+    total = epoch = step = lastEpoch = Statistics();
+    epochs = 0;
+    totalAllocations = epochAllocations = stepAllocations =
+        MemoryTracker::Allocations();
+    StartLayerTiming(function);
+    lastEvent = std::chrono::steady_clock::now();
+  }
+
+  /**
+   * Account for an evaluation of the objective.
+   *
+   * @param objective Objective of the coordinates.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double objective)
+  {
+    Add(&Statistics::evaluateSeconds);
+    ++total.evaluations;
+    ++epoch.evaluations;
+    ++step.evaluations;
+    total.objective = epoch.objective = step.objective = objective;
+  }
+
+  //! Account for a computation of the gradient.
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  void Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const GradType& /* gradient */)
+  {
+    Add(&Statistics::gradientSeconds);
+  }
+
+  //! Account for an update of the coordinates, and write the statistics of
+  //! the step if needed.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 MatType& /* coordinates */)
+  {
+    Add(&Statistics::updateSeconds);
+    ++total.steps;
+    ++epoch.steps;
+    ++step.steps;
+
+    if (stepInterval > 0 && total.steps % stepInterval == 0)
+    {
+      step.allocations = MemoryTracker::Allocations() - stepAllocations;
+      Print("step", total.steps, step);
+    }
+
+    step = Statistics();
+    stepAllocations = MemoryTracker::Allocations();
+    lastEvent = std::chrono::steady_clock::now();
+  }
+
+  /**
+   * Write the statistics of the epoch that ended.
+   *
+   * @param function Function to optimize.
+   * @param epochIndex Index of the epoch.
+   * @param objective Objective of the epoch.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& function,
+                const MatType& /* coordinates */,
+                const size_t epochIndex,
+                const double objective)
+  {
+    Add(NULL);
+    ++epochs;
+    epoch.objective = objective;
+    epoch.samples = NumFunctions(function);
+    total.samples += epoch.samples;
+    epoch.allocations = MemoryTracker::Allocations() - epochAllocations;
+    LayerSeconds(function, epochForward, epochBackward, epoch);
+    Print("epoch", epochIndex, epoch);
+
+    lastEpoch = epoch;
+    epoch = Statistics();
+    epochAllocations = MemoryTracker::Allocations();
+    LayerSnapshot(function, epochForward, epochBackward);
+    lastEvent = std::chrono::steady_clock::now();
+  }
+
+  /**
+   * Write the statistics of the whole optimization.
+   *
+   * @param function Function that was optimized.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& function,
+                       MatType& /* coordinates */)
+  {
+    Add(NULL);
+    if (epochs == 0)
+      total.samples = total.evaluations * NumFunctions(function);
+    total.allocations = MemoryTracker::Allocations() - totalAllocations;
+    LayerSeconds(function, totalForward, totalBackward, total);
+    Print("optimization", epochs, total);
+    StopLayerTiming(function);
+  }
+
+  //! Get the statistics of the last optimization (or of the one in progress).
+  const Statistics& Total() const { return total; }
+  //! Get the statistics of the last finished epoch.
+  const Statistics& LastEpoch() const { return lastEpoch; }
+  //! Get the number of finished epochs.
+  size_t Epochs() const { return epochs; }
+
+  //! Get the interval of the steps that are written (0 for none).
+  size_t StepInterval() const { return stepInterval; }
+  //! Modify the interval of the steps that are written (0 for none).
+  size_t& StepInterval() { return stepInterval; }
+
+ private:
+  /**
+   * Add the time since the last event to the total time, and to the given
+   * part of it if it is not NULL.
+   */
+  void Add(double Statistics::* part)
+  {
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(now -
+        lastEvent).count();
+    lastEvent = now;
+
+    total.seconds += seconds;
+    epoch.seconds += seconds;
+    step.seconds += seconds;
+    if (part != NULL)
+    {
+      total.*part += seconds;
+      epoch.*part += seconds;
+      step.*part += seconds;
+    }
+  }
+
+  //! Write the given statistics as a JSON line.
+  void Print(const std::string& event,
+             const size_t index,
+             const Statistics& statistics)
+  {
+    output << "{ \"event\": \"" << event << "\", \"index\": " << index
+        << ", \"objective\": " << statistics.objective << ", \"seconds\": "
+        << statistics.seconds << ", \"steps\": " << statistics.steps
+        << ", \"evaluations\": " << statistics.evaluations
+        << ", \"samples\": " << statistics.samples
+        << ", \"samples_per_second\": " << statistics.SamplesPerSecond()
+        << ", \"evaluate_seconds\": " << statistics.evaluateSeconds
+        << ", \"gradient_seconds\": " << statistics.gradientSeconds
+        << ", \"update_seconds\": " << statistics.updateSeconds
+        << ", \"allocations\": " << statistics.allocations
+        << ", \"allocations_per_step\": " << ((statistics.steps > 0) ?
+        double(statistics.allocations) / statistics.steps : 0.0);
+    if (!statistics.layerForwardSeconds.empty())
+    {
+      output << ", \"layer_forward_seconds\": ";
+      PrintArray(statistics.layerForwardSeconds);
+      output << ", \"layer_backward_seconds\": ";
+      PrintArray(statistics.layerBackwardSeconds);
+    }
+    output << " }" << std::endl;
+  }
+
+  //! Write the given values as a JSON array.
+  void PrintArray(const std::vector<double>& values)
+  {
+    output << "[";
+    for (size_t i = 0; i < values.size(); ++i)
+      output << ((i == 0) ? "" : ", ") << values[i];
+    output << "]";
+  }
+
+  //! Get the number of points of a separable function.
+  template<typename FunctionType>
+  static typename std::enable_if<HasNumFunctions<FunctionType>::value,
+      size_t>::type
+  NumFunctions(const FunctionType& function)
+  {
+    return function.NumFunctions();
+  }
+
+  //! Get the number of points of a function that is not separable (1).
+  template<typename FunctionType>
+  static typename std::enable_if<!HasNumFunctions<FunctionType>::value,
+      size_t>::type
+  NumFunctions(const FunctionType& /* function */)
+  {
+    return 1;
+  }
+
+  //! Turn on the layer timing of the function, and take the first snapshots.
+  template<typename FunctionType>
+  typename std::enable_if<HasLayerForwardTimes<FunctionType>::value>::type
+  StartLayerTiming(FunctionType& function)
+  {
+    layerTiming = function.LayerTiming();
+    function.LayerTiming() = true;
+    LayerSnapshot(function, totalForward, totalBackward);
+    LayerSnapshot(function, epochForward, epochBackward);
+  }
+
+  //! Restore the layer timing of the function.
+  template<typename FunctionType>
+  typename std::enable_if<HasLayerForwardTimes<FunctionType>::value>::type
+  StopLayerTiming(FunctionType& function)
+  {
+    function.LayerTiming() = layerTiming;
+  }
+
+  //! Keep the current layer times of the function.
+  template<typename FunctionType>
+  static typename std::enable_if<
+      HasLayerForwardTimes<FunctionType>::value>::type
+  LayerSnapshot(const FunctionType& function,
+                std::vector<double>& forward,
+                std::vector<double>& backward)
+  {
+    forward = function.LayerForwardTimes();
+    backward = function.LayerBackwardTimes();
+  }
+
+  //! Set the layer times of the given statistics, since the given snapshots.
+  template<typename FunctionType>
+  static typename std::enable_if<
+      HasLayerForwardTimes<FunctionType>::value>::type
+  LayerSeconds(const FunctionType& function,
+               const std::vector<double>& forward,
+               const std::vector<double>& backward,
+               Statistics& statistics)
+  {
+    statistics.layerForwardSeconds = function.LayerForwardTimes();
+    statistics.layerBackwardSeconds = function.LayerBackwardTimes();
+    for (size_t i = 0; i < forward.size() &&
+        i < statistics.layerForwardSeconds.size(); ++i)
+      statistics.layerForwardSeconds[i] -= forward[i];
+    for (size_t i = 0; i < backward.size() &&
+        i < statistics.layerBackwardSeconds.size(); ++i)
+      statistics.layerBackwardSeconds[i] -= backward[i];
+  }
+
+  //! Functions without layers have no layer times.
+  template<typename FunctionType>
+  typename std::enable_if<!HasLayerForwardTimes<FunctionType>::value>::type
+  StartLayerTiming(FunctionType& /* function */) { }
+
+  //! Functions without layers have no layer times.
+  template<typename FunctionType>
+  typename std::enable_if<!HasLayerForwardTimes<FunctionType>::value>::type
+  StopLayerTiming(FunctionType& /* function */) { }
+
+  //! Functions without layers have no layer times.
+  template<typename FunctionType>
+  static typename std::enable_if<
+      !HasLayerForwardTimes<FunctionType>::value>::type
+  LayerSnapshot(const FunctionType& /* function */,
+                std::vector<double>& /* forward */,
+                std::vector<double>& /* backward */) { }
+
+  //! Functions without layers have no layer times.
+  template<typename FunctionType>
+  static typename std::enable_if<
+      !HasLayerForwardTimes<FunctionType>::value>::type
+  LayerSeconds(const FunctionType& /* function */,
+               const std::vector<double>& /* forward */,
+               const std::vector<double>& /* backward */,
+               Statistics& /* statistics */) { }
+
+  //! The stream the statistics are written to.
+  std::ostream& output;
+  //! The interval of the steps that are written.
+  size_t stepInterval;
+
+  //! The time of the last event.
+  std::chrono::steady_clock::time_point lastEvent;
+
+  //! The statistics of the optimization.
+  Statistics total;
+  //! The statistics of the current epoch.
+  Statistics epoch;
+  //! The statistics of the current step.
+  Statistics step;
+  //! The statistics of the last finished epoch.
+  Statistics lastEpoch;
+  //! The number of finished epochs.
+  size_t epochs;
+
+  //! The number of allocations at the start of the optimization, the epoch
+  //! and the step.
+  size_t totalAllocations;
+  size_t epochAllocations;
+  size_t stepAllocations;
+
+  //! The layer times at the start of the optimization and of the epoch.
+  std::vector<double> totalForward;
+  std::vector<double> totalBackward;
+  std::vector<double> epochForward;
+  std::vector<double> epochBackward;
+
+  //! The layer timing of the function before the optimization.
+  bool layerTiming;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
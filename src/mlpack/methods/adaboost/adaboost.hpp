@@ -173,6 +173,51 @@ class AdaBoost
   void Classify(const MatType& test,
                 arma::Row<size_t>& predictedLabels);
 
+  /**
+   * Classify the given test points, but stop evaluating weak learners for a
+   * point as soon as its predicted class is decided.  The weak learners are
+   * evaluated in order of decreasing weight, and after each one, a point is
+   * decided when the margin between its two best classes is larger than
+   * confidence times the total weight of the weak learners not evaluated yet.
+   * With confidence = 1, those weak learners can't change the prediction, so
+   * the predicted labels are the same as those of Classify() (up to rounding
+   * errors); a smaller confidence stops earlier, and gives an approximation.
+   *
+   * The weak learners classify the points that are not decided yet all at
+   * once, so easy points only cost the first few weak learners.  The
+   * probabilities of a point are the normalized votes of the weak learners
+   * that were evaluated for it.
+   *
+   * @param test Testing data.
+   * @param predictedLabels Vector in which the predicted labels of the test
+   *      set will be stored.
+   * @param probabilities matrix to store the predicted class probabilities for
+   *      each point in the test set.
+   * @param confidence Fraction of the weight of the remaining weak learners
+   *      that the margin must exceed; must be in (0, 1].
+   * @return The total number of evaluations of a weak learner on a point.
+   */
+  size_t EarlyExitClassify(const MatType& test,
+                           arma::Row<size_t>& predictedLabels,
+                           arma::mat& probabilities,
+                           const double confidence = 1.0);
+
+  /**
+   * Classify the given test points, but stop evaluating weak learners for a
+   * point as soon as its predicted class is decided.  See the other overload
+   * of EarlyExitClassify() for details.
+   *
+   * @param test Testing data.
+   * @param predictedLabels Vector in which the predicted labels of the test
+   *      set will be stored.
+   * @param confidence Fraction of the weight of the remaining weak learners
+   *      that the margin must exceed; must be in (0, 1].
+   * @return The total number of evaluations of a weak learner on a point.
+   */
+  size_t EarlyExitClassify(const MatType& test,
+                           arma::Row<size_t>& predictedLabels,
+                           const double confidence = 1.0);
+
   /**
    * Serialize the AdaBoost model.
    */
@@ -87,12 +87,9 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
+  // For each point, 1 if the weak learner classifies it correctly and -1
+  // otherwise.
+  arma::rowvec margins(labels.n_cols);
 
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
@@ -102,20 +99,9 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
-
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; ++i)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
-    // rt = (sum) D(i) y(i) ht(xi)
-    rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
@@ -131,7 +117,7 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     // This trains the new WeakLearnerType using the hyperparameters from the
     // given WeakLearnerType.
 
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
+    WeakLearnerType w(other, data, labels, numClasses, weights);
     // There is a bug with Adaboost!  It will not use the specified
     // hyperparameters for the decision tree because they are not properly
     // passed to the new weak learners!  (And: it's a hard bug, because the
@@ -139,19 +125,15 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     // trained with!)
 
     // DecisionTree(DecisionTree&, MatType&, LabelsType&, size_t, WeightsType&, double = 0.0, double = 0.0, ...);
-    w.Classify(tempData, predictedLabels);
+    w.Classify(data, predictedLabels);
 
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
-
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; ++j) // instead of D, ht
-    {
-      if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
-      else
-        rt -= arma::accu(D.col(j));
-    }
+    // Now, calculate alpha(t) using ht.  rt is the weighted error:
+    // rt = (sum) D(i) y(i) ht(xi).  The weight of each point is the sum of its
+    // column of D, so rt is the dot product of the weights and the margins.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; ++j)
+      margins[j] = (predictedLabels[j] == labels[j]) ? 1.0 : -1.0;
+    rt = arma::dot(weights, margins);
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
       break;
@@ -174,44 +156,12 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; ++j)
-    {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
-      else
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
-    }
+    // Now start modifying the weights: the weights of the correctly classified
+    // points are divided by exp(alphat), and the others are multiplied by it.
+    D.each_row() %= arma::exp(-alphat * margins);
 
-    // Normalize D.
+    // Normalize D with zt, the normalization constant.
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -248,24 +198,135 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
   probabilities.zeros(numClasses, test.n_cols);
   predictedLabels.set_size(test.n_cols);
 
+  // Each weak learner classifies all of the points at once, and then its votes
+  // are added to the points' columns.
   for (size_t i = 0; i < wl.size(); ++i)
   {
     wl[i].Classify(test, tempPredictedLabels);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; ++j)
-      probabilities(tempPredictedLabels(j), j) += alpha[i];
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) tempPredictedLabels.n_cols; ++j)
+      probabilities(tempPredictedLabels[j], j) += alpha[i];
   }
 
-  arma::colvec pRow;
-  arma::uword maxIndex = 0;
+  probabilities.each_row() /= arma::sum(probabilities, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) predictedLabels.n_cols; ++i)
+    predictedLabels[i] = probabilities.col(i).index_max();
+}
 
-  for (size_t i = 0; i < predictedLabels.n_cols; ++i)
+/**
+ * Classify the given test points, stopping early for the decided points.
+ */
+template<typename WeakLearnerType, typename MatType>
+size_t AdaBoost<WeakLearnerType, MatType>::EarlyExitClassify(
+    const MatType& test,
+    arma::Row<size_t>& predictedLabels,
+    const double confidence)
+{
+  arma::mat probabilities;
+
+  return EarlyExitClassify(test, predictedLabels, probabilities, confidence);
+}
+
+/**
+ * Classify the given test points, stopping early for the decided points.
+ */
+template<typename WeakLearnerType, typename MatType>
+size_t AdaBoost<WeakLearnerType, MatType>::EarlyExitClassify(
+    const MatType& test,
+    arma::Row<size_t>& predictedLabels,
+    arma::mat& probabilities,
+    const double confidence)
+{
+  if (confidence <= 0.0 || confidence > 1.0)
   {
-    probabilities.col(i) /= arma::accu(probabilities.col(i));
-    pRow = probabilities.unsafe_col(i);
-    pRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    std::ostringstream oss;
+    oss << "AdaBoost::EarlyExitClassify(): confidence must be in (0, 1] "
+        << "(given " << confidence << ")!";
+    throw std::invalid_argument(oss.str());
   }
+
+  probabilities.zeros(numClasses, test.n_cols);
+  predictedLabels.set_size(test.n_cols);
+
+  // The heaviest weak learners are evaluated first, since they decide the most
+  // points.  remaining[i] is the total weight of the weak learners from the
+  // i'th one in that order on: it bounds how much they can reduce the margin
+  // between two classes.
+  const arma::vec weights = arma::abs(arma::conv_to<arma::vec>::from(alpha));
+  const arma::uvec order = arma::sort_index(weights, "descend");
+  std::vector<double> remaining(wl.size() + 1, 0.0);
+  for (size_t i = wl.size(); i > 0; --i)
+    remaining[i - 1] = remaining[i] + weights[order[i - 1]];
+
+  // The points that are not decided yet, and their columns of the test set.
+  // The submatrix is only copied again when points were decided.
+  arma::uvec active(test.n_cols);
+  for (size_t j = 0; j < test.n_cols; ++j)
+    active[j] = j;
+  MatType activeTest;
+  bool allActive = true;
+
+  arma::Row<size_t> tempPredictedLabels;
+  arma::Col<char> decided;
+  size_t evaluations = 0;
+  for (size_t i = 0; i < wl.size() && active.n_elem > 0; ++i)
+  {
+    const size_t learner = order[i];
+    wl[learner].Classify(allActive ? test : activeTest, tempPredictedLabels);
+    evaluations += active.n_elem;
+
+    // Add the votes, and check which points can't change class anymore.
+    decided.zeros(active.n_elem);
+    const double bound = confidence * remaining[i + 1];
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) active.n_elem; ++j)
+    {
+      const size_t point = active[j];
+      probabilities(tempPredictedLabels[j], point) += alpha[learner];
+
+      double best = -DBL_MAX;
+      double second = -DBL_MAX;
+      for (size_t c = 0; c < numClasses; ++c)
+      {
+        const double vote = probabilities(c, point);
+        if (vote > best)
+        {
+          second = best;
+          best = vote;
+        }
+        else if (vote > second)
+        {
+          second = vote;
+        }
+      }
+
+      decided[j] = (numClasses < 2 || best - second > bound);
+    }
+
+    size_t kept = 0;
+    for (size_t j = 0; j < active.n_elem; ++j)
+      if (!decided[j])
+        active[kept++] = active[j];
+
+    if (kept < active.n_elem)
+    {
+      active.resize(kept);
+      if (kept > 0)
+        activeTest = test.cols(active);
+      allActive = false;
+    }
+  }
+
+  probabilities.each_row() /= arma::sum(probabilities, 0);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) predictedLabels.n_cols; ++i)
+    predictedLabels[i] = probabilities.col(i).index_max();
+
+  return evaluations;
 }
 
 /**
@@ -274,7 +335,7 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
 template<typename WeakLearnerType, typename MatType>
 template<typename Archive>
 void AdaBoost<WeakLearnerType, MatType>::serialize(Archive& ar,
-                                                   const uint32_t /* version */)
+                                                   const uint32_t version)
 {
   ar(CEREAL_NVP(numClasses));
   ar(CEREAL_NVP(tolerance));
@@ -286,10 +347,20 @@ void AdaBoost<WeakLearnerType, MatType>::serialize(Archive& ar,
     wl.clear();
     wl.resize(alpha.size());
   }
-  ar(CEREAL_NVP(wl));
+  // Since version 1, the weak learners are stored so that they can be loaded
+  // in parallel.
+  if (version > 0)
+    ar(cereal::make_nvp("wl", CEREAL_PARALLEL_VECTOR(wl)));
+  else
+    ar(CEREAL_NVP(wl));
 }
 
 } // namespace adaboost
 } // namespace mlpack
 
+// Since version 1, the weak learners are stored with CEREAL_PARALLEL_VECTOR.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename WeakLearnerType,
+    typename MatType>), (mlpack::adaboost::AdaBoost<WeakLearnerType, MatType>),
+    (1));
+
 #endif
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIST_UPDATE_RULES_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/parallel_multiply.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -35,6 +36,10 @@ namespace amf {
  * This is a multiplicative rule that ensures that the Frobenius norm
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ is non-increasing between subsequent
  * iterations. Both of the update rules for W and H are defined in this file.
+ *
+ * The products with V are computed in parallel if V is sparse, and the
+ * products of the factors are grouped so that no matrix of the size of V is
+ * formed.
  */
 class NMFMultiplicativeDistanceUpdate
 {
@@ -71,7 +76,9 @@ class NMFMultiplicativeDistanceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    arma::mat numerator;
+    math::ParallelMultiply(V, arma::mat(H.t()), numerator);
+    W = (W % numerator) / (W * (H * H.t()));
   }
 
   /**
@@ -93,7 +100,10 @@ class NMFMultiplicativeDistanceUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    // W^T V is computed as its transpose, V^T W.
+    arma::mat numerator;
+    math::ParallelMultiplyTrans(V, W, numerator);
+    H = (H % numerator.t()) / ((W.t() * W) * H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
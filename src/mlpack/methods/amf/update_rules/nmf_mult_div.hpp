@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIV_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/parallel_multiply.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -41,9 +42,10 @@ namespace amf {
  * is non-increasing between subsequent iterations. Both of the update rules
  * for W and H are defined in this file.
  *
- * This set of update rules is not meant to work with sparse matrices.  Using
- * sparse matrices often causes NaNs in the output, so other choices of update
- * rules are better in that situation.
+ * For sparse matrices, W H is only evaluated at the nonzero elements of V (the
+ * other elements do not contribute to the numerators), so the dense product W H
+ * is never formed, and the zeros of V cause no NaNs.  The ratios and the
+ * products with them are computed in parallel.
  */
 class NMFMultiplicativeDivergenceUpdate
 {
@@ -81,28 +83,15 @@ class NMFMultiplicativeDivergenceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::rowvec t2;
+    // The numerator is (V / (W H)) H^T, where the division is element-wise.
+    typename RatioType<MatType>::type ratios;
+    Ratios(V, W, H, ratios);
 
-    t1 = W * H;
-    for (size_t i = 0; i < W.n_rows; ++i)
-    {
-      for (size_t j = 0; j < W.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = H.row(j) % V.row(i) / t1.row(i);
-        t2.set_size(H.n_cols);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = H(j, k) * V(i, k) / t1(i, k);
-        }
-
-        W(i, j) = W(i, j) * sum(t2) / sum(H.row(j));
-      }
-    }
+    arma::mat numerator;
+    math::ParallelMultiply(ratios, arma::mat(H.t()), numerator);
+
+    W %= numerator;
+    W.each_row() /= arma::sum(H, 1).t();
   }
 
   /**
@@ -125,33 +114,77 @@ class NMFMultiplicativeDivergenceUpdate
                             const arma::mat& W,
                             arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::colvec t2;
+    // The numerator is W^T (V / (W H)); it is computed as its transpose.
+    typename RatioType<MatType>::type ratios;
+    Ratios(V, W, H, ratios);
 
-    t1 = W * H;
-    for (size_t i = 0; i < H.n_rows; ++i)
-    {
-      for (size_t j = 0; j < H.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = W.col(i) % V.col(j) / t1.col(j);
-        t2.set_size(W.n_rows);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = W(k, i) * V(k, j) / t1(k, j);
-        }
-
-        H(i, j) = H(i, j) * sum(t2) / sum(W.col(i));
-      }
-    }
+    arma::mat numerator;
+    math::ParallelMultiplyTrans(ratios, W, numerator);
+
+    H %= numerator.t();
+    H.each_col() /= arma::sum(W, 0).t();
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+
+ private:
+  //! The type of the element-wise ratios V / (W H): sparse for sparse V.
+  template<typename MatType>
+  struct RatioType
+  {
+    typedef arma::mat type;
+  };
+
+  //! The type of the element-wise ratios V / (W H): sparse for sparse V.
+  template<typename eT>
+  struct RatioType<arma::SpMat<eT>>
+  {
+    typedef arma::sp_mat type;
+  };
+
+  /**
+   * Compute the element-wise ratios V / (W H) for dense V.
+   */
+  template<typename MatType>
+  static void Ratios(const MatType& V,
+                     const arma::mat& W,
+                     const arma::mat& H,
+                     arma::mat& ratios)
+  {
+    ratios = V / (W * H);
+  }
+
+  /**
+   * Compute the element-wise ratios V / (W H) for sparse V, only at the
+   * nonzero elements of V (a sampled dense-dense product), so the result has
+   * the sparsity pattern of V.
+   */
+  template<typename eT>
+  static void Ratios(const arma::SpMat<eT>& V,
+                     const arma::mat& W,
+                     const arma::mat& H,
+                     arma::sp_mat& ratios)
+  {
+    // The rows of W are accessed as the columns of W^T.
+    V.sync();
+    const arma::mat wTrans = W.t();
+    arma::vec values(V.n_nonzero);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+    {
+      for (size_t p = V.col_ptrs[j]; p < V.col_ptrs[j + 1]; ++p)
+      {
+        values[p] = V.values[p] / arma::dot(wTrans.col(V.row_indices[p]),
+            H.col(j));
+      }
+    }
+
+    ratios = arma::sp_mat(arma::uvec(V.row_indices, V.n_nonzero),
+        arma::uvec(V.col_ptrs, V.n_cols + 1), values, V.n_rows, V.n_cols);
+  }
 };
 
 } // namespace amf
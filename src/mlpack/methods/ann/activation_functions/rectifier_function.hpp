@@ -65,8 +65,8 @@ class RectifierFunction
   template<typename eT>
   static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
   {
-    y.zeros(x.n_rows, x.n_cols);
-    y = arma::max(y, x);
+    // This is computed element by element, so y may use the memory of x.
+    y = arma::max(arma::zeros<arma::Mat<eT>>(x.n_rows, x.n_cols), x);
   }
 
   /**
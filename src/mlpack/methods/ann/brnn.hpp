@@ -292,6 +292,25 @@ class BRNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  /**
+   * Get whether gradient checkpointing is used during backpropagation through
+   * time; see RNN::Checkpointing().
+   */
+  bool Checkpointing() const { return checkpointing; }
+  //! Modify whether gradient checkpointing is used.
+  bool& Checkpointing() { return checkpointing; }
+
+  /**
+   * Get whether the forward and backward RNNs run concurrently (false by
+   * default).  Each direction then runs over the whole sequence as one task,
+   * for the forward pass and for backpropagation through time, and only the
+   * merge layer and the output layer run after both.  While both directions
+   * run, BLAS uses one thread.
+   */
+  bool Parallel() const { return parallel; }
+  //! Modify whether the forward and backward RNNs run concurrently.
+  bool& Parallel() { return parallel; }
+
   //! Get the matrix of responses to the input data points.
   const arma::cube& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -326,6 +345,20 @@ class BRNN
    */
   void ResetDeterministic();
 
+  /**
+   * Forward the given batch of the sequences through the forward RNN (from
+   * the first step to the last) and the backward RNN (from the last step to
+   * the first), and store the output of the last layer of each RNN at each
+   * step.  If saveOutputs is true, the outputs of all layers are stored too,
+   * for backpropagation through time.
+   */
+  void ForwardDirections(const arma::cube& predictors,
+                         const size_t begin,
+                         const size_t batchSize,
+                         std::vector<arma::mat>& forwardResults,
+                         std::vector<arma::mat>& backwardResults,
+                         const bool saveOutputs);
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -399,15 +432,18 @@ class BRNN
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
+  //! If true, the outputs of layers without state are not stored for BPTT.
+  bool checkpointing;
+
+  //! If true, the forward and backward RNNs run concurrently.
+  bool parallel;
+
   //! The current gradient for the gradient pass for forward RNN.
   arma::mat forwardGradient;
 
   //! The current gradient for the gradient pass for backward RNN.
   arma::mat backwardGradient;
 
-  //! The total gradient from each gradient pass.
-  arma::mat totalGradient;
-
   //! Forward RNN
   RNN<OutputLayerType, InitializationRuleType, CustomLayers...> forwardRNN;
 
@@ -25,6 +25,7 @@
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
 #include "visitor/run_set_visitor.hpp"
+#include "util/run_modules.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -52,6 +53,8 @@ BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     single(single),
     numFunctions(0),
     deterministic(true),
+    checkpointing(false),
+    parallel(false),
     forwardRNN(rho, single, outputLayer, initializeRule),
     backwardRNN(rho, single, outputLayer, initializeRule)
 {
@@ -219,20 +222,8 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-    {
-      forwardRNN.Forward(arma::mat(
-          predictors.slice(seqNum).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true));
-      backwardRNN.Forward(std::move(arma::mat(
-          predictors.slice(rho - seqNum - 1).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
-
-      boost::apply_visitor(SaveOutputParameterVisitor(results1),
-          forwardRNN.network.back());
-      boost::apply_visitor(SaveOutputParameterVisitor(results2),
-          backwardRNN.network.back());
-    }
+    ForwardDirections(predictors, begin, effectiveBatchSize, results1,
+        results2, false);
     reverse(results1.begin(), results1.end());
 
     // Forward outputs from both RNN's through merge layer for each time step.
@@ -296,20 +287,7 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   size_t responseSeq = 0;
 
   std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-
-    boost::apply_visitor(SaveOutputParameterVisitor(results1),
-        forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(results2),
-        backwardRNN.network.back());
-  }
+  ForwardDirections(predictors, begin, batchSize, results1, results2, false);
   if (outputSize == 0)
   {
     outputSize = boost::apply_visitor(outputParameterVisitor,
@@ -410,31 +388,12 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   forwardRNN.ResetCells();
   backwardRNN.ResetCells();
+  forwardRNN.checkpointing = backwardRNN.checkpointing = checkpointing;
   size_t networkSize = backwardRNN.network.size();
 
   // Forward propogation from both directions.
   std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    forwardRNN.Forward(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    backwardRNN.Forward(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          forwardRNNOutputParameter), forwardRNN.network[l]);
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          backwardRNNOutputParameter), backwardRNN.network[l]);
-    }
-    boost::apply_visitor(SaveOutputParameterVisitor(results1),
-        forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(results2),
-        backwardRNN.network.back());
-  }
+  ForwardDirections(predictors, begin, batchSize, results1, results2, true);
   if (outputSize == 0)
   {
     outputSize = boost::apply_visitor(outputParameterVisitor,
@@ -507,87 +466,57 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     allDelta.push_back(arma::mat(delta));
   }
 
-  // BPTT ForwardRNN from t = T to 1.
-  totalGradient = arma::mat(gradient.memptr(),
-      parameter.n_elem / 2, 1, false, false);
-
   forwardGradient.zeros();
   forwardRNN.ResetGradients(forwardGradient);
   backwardGradient.zeros();
   backwardRNN.ResetGradients(backwardGradient);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // BPTT ForwardRNN from t = T to 1, and BackwardRNN from t = 1 to T.  Each
+  // one only uses its own module of the merge layer, so both can run at the
+  // same time.
+  RunModules(2, parallel, [&](const size_t direction)
   {
-    forwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          forwardRNNOutputParameter),
-          forwardRNN.network[networkSize - 1 - l]);
-    }
-    boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
-        outputParameterVisitor, forwardRNN.network.back()),
-        allDelta[rho - seqNum - 1], delta, 0),
-        mergeLayer);
+    RNN<OutputLayerType, InitializationRuleType, CustomLayers...>& rnn =
+        (direction == 0) ? forwardRNN : backwardRNN;
+    arma::mat& rnnGradient = (direction == 0) ? forwardGradient :
+        backwardGradient;
+    std::vector<arma::mat>& rnnOutputParameter = (direction == 0) ?
+        forwardRNNOutputParameter : backwardRNNOutputParameter;
+    arma::mat totalGradient(gradient.memptr() + direction *
+        (parameter.n_elem / 2), parameter.n_elem / 2, 1, false, true);
+    arma::mat rnnDelta;
 
-    for (size_t i = 2; i < networkSize; ++i)
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
     {
-      boost::apply_visitor(BackwardVisitor(
+      const size_t step = (direction == 0) ? rho - seqNum - 1 : seqNum;
+      rnnGradient.zeros();
+      const arma::mat stepData(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true);
+      rnn.LoadOutputs(rnnOutputParameter, stepData);
+      boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+          outputParameterVisitor, rnn.network.back()),
+          allDelta[step], rnnDelta, direction), mergeLayer);
+
+      for (size_t i = 2; i < networkSize; ++i)
+      {
+        boost::apply_visitor(BackwardVisitor(
+            boost::apply_visitor(outputParameterVisitor,
+            rnn.network[networkSize - i]),
+            boost::apply_visitor(deltaVisitor,
+            rnn.network[networkSize - i + 1]),
+            boost::apply_visitor(deltaVisitor,
+            rnn.network[networkSize - i])),
+            rnn.network[networkSize - i]);
+      }
+      rnn.Gradient(stepData);
+      boost::apply_visitor(GradientVisitor(
           boost::apply_visitor(outputParameterVisitor,
-          forwardRNN.network[networkSize - i]),
-          boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i + 1]),
-          boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i])),
-          forwardRNN.network[networkSize - i]);
+          rnn.network[networkSize - 2]),
+          allDelta[step], direction), mergeLayer);
+      totalGradient += rnnGradient;
     }
-    forwardRNN.Gradient(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    boost::apply_visitor(GradientVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        forwardRNN.network[networkSize - 2]),
-        allDelta[rho - seqNum - 1], 0), mergeLayer);
-    totalGradient += forwardGradient;
-  }
+  });
 
-  // BPTT BackwardRNN from t = 1 to T.
-  totalGradient = arma::mat(gradient.memptr() + parameter.n_elem/2,
-      parameter.n_elem/2, 1, false, false);
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    backwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          backwardRNNOutputParameter),
-          backwardRNN.network[networkSize - 1 - l]);
-    }
-    boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network.back()),
-        allDelta[seqNum], delta, 1), mergeLayer);
-    for (size_t i = 2; i < networkSize; ++i)
-    {
-      boost::apply_visitor(BackwardVisitor(
-        boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - i]), boost::apply_visitor(
-        deltaVisitor, backwardRNN.network[networkSize - i + 1]),
-        boost::apply_visitor(deltaVisitor,
-        backwardRNN.network[networkSize - i])),
-        backwardRNN.network[networkSize - i]);
-    }
-
-    backwardRNN.Gradient(
-        arma::mat(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
-    boost::apply_visitor(GradientVisitor(
-        std::move(boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - 2])),
-        allDelta[seqNum], 1), mergeLayer);
-    totalGradient += backwardGradient;
-  }
   return performance;
 }
 
@@ -711,6 +640,42 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   backwardRNN.ResetDeterministic();
 }
 
+template<typename OutputLayerType, typename MergeLayerType,
+         typename MergeOutputType, typename InitializationRuleType,
+         typename... CustomLayers>
+void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
+    InitializationRuleType, CustomLayers...>::ForwardDirections(
+    const arma::cube& predictors,
+    const size_t begin,
+    const size_t batchSize,
+    std::vector<arma::mat>& forwardResults,
+    std::vector<arma::mat>& backwardResults,
+    const bool saveOutputs)
+{
+  // The two RNNs are independent until the merge layer.
+  RunModules(2, parallel, [&](const size_t direction)
+  {
+    RNN<OutputLayerType, InitializationRuleType, CustomLayers...>& rnn =
+        (direction == 0) ? forwardRNN : backwardRNN;
+    std::vector<arma::mat>& results = (direction == 0) ? forwardResults :
+        backwardResults;
+    std::vector<arma::mat>& rnnOutputParameter = (direction == 0) ?
+        forwardRNNOutputParameter : backwardRNNOutputParameter;
+
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    {
+      const size_t step = (direction == 0) ? seqNum : rho - seqNum - 1;
+      rnn.Forward(arma::mat((double*) predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true));
+
+      if (saveOutputs)
+        rnn.SaveOutputs(rnnOutputParameter);
+      boost::apply_visitor(SaveOutputParameterVisitor(results),
+          rnn.network.back());
+    }
+  });
+}
+
 template<typename OutputLayerType, typename MergeLayerType,
          typename MergeOutputType, typename InitializationRuleType,
          typename... CustomLayers>
@@ -0,0 +1,211 @@
+/**
+ * @file methods/ann/convolution_rules/cached_fft_convolution.hpp
+ *
+ * Implementation of the convolution through fft with precomputed filter
+ * spectra.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_CACHED_FFT_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_CACHED_FFT_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "naive_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution through fft, like
+ * NaiveConvolution (the filter is not flipped), with the spectra of the
+ * filters computed once by FilterSpectra() and reused for any number of
+ * inputs.  The convolution of a set of input maps with a set of filters
+ * transforms each input map once, accumulates the products of all the input
+ * maps of an output map in the frequency domain, and uses one inverse
+ * transform per output map.  So the cost of a convolution barely depends on
+ * the size of the filter, which makes large filters practical.  The
+ * convolution can be computed with the valid border type (default) or the
+ * full border type.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * When the forward convolution rule of the Convolution layer is
+ * CachedFFTConvolution, the layer keeps the spectra of its filters until its
+ * weights change, and convolves all the input maps of each point at once.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = ValidConvolution>
+class CachedFFTConvolution
+{
+ public:
+  /*
+   * Perform a convolution of one input map with one filter.  This computes the
+   * spectrum of the filter, so it is only faster than NaiveConvolution for
+   * large filters; dilated convolutions and strided full convolutions are
+   * computed by NaiveConvolution.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Mat<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    if (dilationW != 1 || dilationH != 1 ||
+        (std::is_same<BorderMode, FullConvolution>::value &&
+        (dW != 1 || dH != 1)))
+    {
+      NaiveConvolution<BorderMode>::Convolution(input, filter, output, dW, dH,
+          dilationW, dilationH);
+      return;
+    }
+
+    const arma::Cube<eT> inputMaps(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+    const arma::Cube<eT> filters(const_cast<eT*>(filter.memptr()),
+        filter.n_rows, filter.n_cols, 1, false, true);
+
+    arma::Cube<std::complex<eT>> spectra;
+    FilterSpectra(filters, input.n_rows, input.n_cols, spectra);
+
+    arma::Cube<eT> outputMaps;
+    Convolution(inputMaps, spectra, filter.n_rows, filter.n_cols, outputMaps,
+        dW, dH);
+    output = outputMaps.slice(0);
+  }
+
+  /**
+   * Compute the spectra of the given filters for inputs of the given size.
+   * The spectra only have to be computed again when the filters or the size of
+   * the inputs change.
+   *
+   * @param filters Filters to transform (one per slice).
+   * @param inputRows Number of rows of the inputs.
+   * @param inputCols Number of columns of the inputs.
+   * @param spectra Output spectra (one per slice).
+   */
+  template<typename eT>
+  static void FilterSpectra(const arma::Cube<eT>& filters,
+                            const size_t inputRows,
+                            const size_t inputCols,
+                            arma::Cube<std::complex<eT>>& spectra)
+  {
+    const size_t rows = SpectrumSize(inputRows, filters.n_rows);
+    const size_t cols = SpectrumSize(inputCols, filters.n_cols);
+
+    spectra.set_size(rows, cols, filters.n_slices);
+    for (size_t s = 0; s < filters.n_slices; ++s)
+    {
+      // Convolving with the rotated filter correlates with the filter.
+      const arma::Mat<eT> rotated = arma::fliplr(arma::flipud(
+          filters.slice(s)));
+      spectra.slice(s) = arma::fft2(rotated, rows, cols);
+    }
+  }
+
+  /**
+   * Convolve a set of input maps with the filters of each output map, given
+   * by their spectra: slice (o * input.n_slices + i) of filterSpectra is the
+   * filter that maps input map i to output map o, and output map o is the sum
+   * of the convolutions of all the input maps with their filters.  Strides
+   * are only supported in the valid mode.
+   *
+   * @param input Input maps (one per slice).
+   * @param filterSpectra Spectra of the filters, computed by FilterSpectra()
+   *     for inputs of the size of the input maps.
+   * @param filterRows Number of rows of the filters.
+   * @param filterCols Number of columns of the filters.
+   * @param output Output maps (one per slice).
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<std::complex<eT>>& filterSpectra,
+                          const size_t filterRows,
+                          const size_t filterCols,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    const size_t rows = filterSpectra.n_rows;
+    const size_t cols = filterSpectra.n_cols;
+    const size_t inMaps = input.n_slices;
+    const size_t outMaps = filterSpectra.n_slices / inMaps;
+
+    // Transform each input map once for all the output maps.
+    arma::Cube<std::complex<eT>> inputSpectra(rows, cols, inMaps);
+    for (size_t i = 0; i < inMaps; ++i)
+      inputSpectra.slice(i) = arma::fft2(input.slice(i), rows, cols);
+
+    // In the valid mode, the first filterRows - 1 rows (and filterCols - 1
+    // columns) are wrapped around, and are not part of the result.
+    const bool valid = std::is_same<BorderMode, ValidConvolution>::value;
+    const size_t rowOffset = valid ? filterRows - 1 : 0;
+    const size_t colOffset = valid ? filterCols - 1 : 0;
+    const size_t outputRows = (rows - rowOffset - 1) / dW + 1;
+    const size_t outputCols = (cols - colOffset - 1) / dH + 1;
+
+    output.set_size(outputRows, outputCols, outMaps);
+    arma::Mat<std::complex<eT>> product;
+    for (size_t o = 0; o < outMaps; ++o)
+    {
+      product = inputSpectra.slice(0) % filterSpectra.slice(o * inMaps);
+      for (size_t i = 1; i < inMaps; ++i)
+        product += inputSpectra.slice(i) % filterSpectra.slice(o * inMaps + i);
+
+      const arma::Mat<eT> result = arma::real(arma::ifft2(product));
+      if (dW == 1 && dH == 1)
+      {
+        output.slice(o) = result.submat(rowOffset, colOffset, rows - 1,
+            cols - 1);
+        continue;
+      }
+
+      for (size_t j = 0; j < outputCols; ++j)
+        for (size_t i = 0; i < outputRows; ++i)
+          output(i, j, o) = result(rowOffset + i * dW, colOffset + j * dH);
+    }
+  }
+
+ private:
+  //! Get the size of the spectra along one dimension.  In the valid mode, the
+  //! circular convolution of the size of the input is enough; in the full
+  //! mode, the transform is padded so that nothing wraps around.
+  static size_t SpectrumSize(const size_t inputSize, const size_t filterSize)
+  {
+    return std::is_same<BorderMode, ValidConvolution>::value ? inputSize :
+        inputSize + filterSize - 1;
+  }
+};  // class CachedFFTConvolution
+
+//! Whether the given convolution rule is a CachedFFTConvolution.
+template<typename ConvolutionRule>
+struct IsCachedFFTConvolution : public std::false_type { };
+
+template<typename BorderMode>
+struct IsCachedFFTConvolution<CachedFFTConvolution<BorderMode>> :
+    public std::true_type { };
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,396 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution through a matrix multiplication, by
+ * lowering the input to a matrix of patches (im2col).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by copying every patch of the input
+ * that the filter is applied to into one row of a matrix (im2col), so that the
+ * convolution becomes a single matrix product that is computed by BLAS.  The
+ * convolution can be computed with the valid border type or the full border
+ * type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * When a convolution rule of the Convolution layer is Im2ColConvolution, the
+ * layer lowers all the input maps of each point at once with Im2Col() for that
+ * pass (forward, backward or gradient), so that the pass is one matrix product
+ * per point over all input and output maps instead of one convolution per pair
+ * of maps.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const size_t outputRows =
+        (input.n_rows - (filter.n_rows - 1) * dilationW - 1) / dW + 1;
+    const size_t outputCols =
+        (input.n_cols - (filter.n_cols - 1) * dilationH - 1) / dH + 1;
+
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+    arma::Mat<eT> patches;
+    Im2Col(inputCube, filter.n_rows, filter.n_cols, dW, dH, 0, 0, outputRows,
+        outputCols, patches, dilationW, dilationH);
+
+    output.set_size(outputRows, outputCols);
+    arma::Col<eT> outputVec(output.memptr(), output.n_elem, false, true);
+    outputVec = patches * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // Use the same working output shape as NaiveConvolution.
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; ++i)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; ++i)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad the input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Copy every patch of the input that a kernelRows x kernelCols filter is
+   * applied to into one row of the patches matrix.  Row (j * outputRows + i)
+   * of the patches matrix holds the patch of output position (i, j), and
+   * column ((s * kernelCols + kj) * kernelRows + ki) holds the element (ki, kj)
+   * of the patch in slice s of the input; so, the convolution of the input
+   * with a filter cube of the same number of slices is the product of the
+   * patches matrix with the vectorised filter cube.  Elements of a patch that
+   * are outside of the input (because of the padding) are zero.  The patches
+   * matrix is only reallocated if its size changes, so it can be reused
+   * between calls.
+   *
+   * @param input Input maps (one per slice).
+   * @param kernelRows Number of rows of the filter.
+   * @param kernelCols Number of columns of the filter.
+   * @param dW Stride of filter application in the x direction (rows).
+   * @param dH Stride of filter application in the y direction (columns).
+   * @param padRows Number of rows of zero padding before the input.
+   * @param padCols Number of columns of zero padding before the input.
+   * @param outputRows Number of rows of the convolution output.
+   * @param outputCols Number of columns of the convolution output.
+   * @param patches Matrix to store the patches in.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t kernelRows,
+                     const size_t kernelCols,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t padRows,
+                     const size_t padCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     arma::Mat<eT>& patches,
+                     const size_t dilationW = 1,
+                     const size_t dilationH = 1)
+  {
+    patches.set_size(outputRows * outputCols,
+        kernelRows * kernelCols * input.n_slices);
+
+    eT* patchesPtr = patches.memptr();
+    for (size_t s = 0; s < input.n_slices; ++s)
+    {
+      for (size_t kj = 0; kj < kernelCols; ++kj)
+      {
+        for (size_t ki = 0; ki < kernelRows; ++ki)
+        {
+          for (size_t j = 0; j < outputCols; ++j)
+          {
+            // Work with the position in the padded input.
+            const size_t col = j * dH + kj * dilationH;
+            if (col < padCols || col - padCols >= input.n_cols)
+            {
+              std::fill(patchesPtr, patchesPtr + outputRows, eT(0));
+              patchesPtr += outputRows;
+              continue;
+            }
+
+            const eT* inputPtr = input.slice_colptr(s, col - padCols);
+            for (size_t i = 0; i < outputRows; ++i, ++patchesPtr)
+            {
+              const size_t row = i * dW + ki * dilationW;
+              *patchesPtr = (row < padRows || row - padRows >= input.n_rows) ?
+                  eT(0) : inputPtr[row - padRows];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Add every row of the patches matrix back to the part of the output that
+   * the patch was taken from; this is the transpose of Im2Col(), and is used
+   * to compute the error with respect to the input.  The output must already
+   * have the size of the input given to Im2Col(); elements of a patch that
+   * would be in the padding are discarded.
+   *
+   * @param patches Matrix of patches, in the layout produced by Im2Col().
+   * @param kernelRows Number of rows of the filter.
+   * @param kernelCols Number of columns of the filter.
+   * @param dW Stride of filter application in the x direction (rows).
+   * @param dH Stride of filter application in the y direction (columns).
+   * @param padRows Number of rows of zero padding before the input.
+   * @param padCols Number of columns of zero padding before the input.
+   * @param outputRows Number of rows of the convolution output.
+   * @param outputCols Number of columns of the convolution output.
+   * @param output Maps to add the patches to.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& patches,
+                     const size_t kernelRows,
+                     const size_t kernelCols,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t padRows,
+                     const size_t padCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     arma::Cube<eT>& output,
+                     const size_t dilationW = 1,
+                     const size_t dilationH = 1)
+  {
+    const eT* patchesPtr = patches.memptr();
+    for (size_t s = 0; s < output.n_slices; ++s)
+    {
+      for (size_t kj = 0; kj < kernelCols; ++kj)
+      {
+        for (size_t ki = 0; ki < kernelRows; ++ki)
+        {
+          for (size_t j = 0; j < outputCols; ++j)
+          {
+            const size_t col = j * dH + kj * dilationH;
+            if (col < padCols || col - padCols >= output.n_cols)
+            {
+              patchesPtr += outputRows;
+              continue;
+            }
+
+            eT* outputPtr = output.slice_colptr(s, col - padCols);
+            for (size_t i = 0; i < outputRows; ++i, ++patchesPtr)
+            {
+              const size_t row = i * dW + ki * dilationW;
+              if (row >= padRows && row - padRows < output.n_rows)
+                outputPtr[row - padRows] += *patchesPtr;
+            }
+          }
+        }
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+//! Whether the given convolution rule is an Im2ColConvolution.
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution : public std::false_type { };
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>> :
+    public std::true_type { };
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
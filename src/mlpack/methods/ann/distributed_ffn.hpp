@@ -0,0 +1,174 @@
+/**
+ * @file methods/ann/distributed_ffn.hpp
+ *
+ * Definition of the DistributedFFN class, which trains a feedforward network
+ * with data parallelism across several processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DISTRIBUTED_FFN_HPP
+#define MLPACK_METHODS_ANN_DISTRIBUTED_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/local_communicator.hpp>
+
+#include "ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * DistributedFFN trains an FFN on a dataset whose shards are held by several
+ * processes (the ranks of the communicator; see kmeans::LocalCommunicator and
+ * kmeans::MPICommunicator).  Each rank holds a copy of the network; the
+ * parameters of rank 0 are given to every rank before the training starts.
+ * Then the optimizer runs on every rank, on the separable function given by
+ * this class: each evaluation computes the objective and the gradient of the
+ * batch of the local shard with FFN::EvaluateWithGradient(), and they are
+ * averaged over the ranks with one all-reduce (the objective is sent with the
+ * gradient), so that every rank takes the same optimizer step, and the copies
+ * of the network stay the same.  A batch of batchSize points on each of p
+ * ranks so has the effect of a batch of p * batchSize points.
+ *
+ * The optimizer must be one of the separable optimizers of ensmallen (SGD and
+ * its variants, such as Adam or RMSProp), and every rank must use the same
+ * optimizer settings and hold the same number of points, so that all the ranks
+ * evaluate the same number of batches.  Each rank shuffles its own shard.
+ *
+ * The callbacks are given to the optimizer of each rank, with this object as
+ * the function; a callback that saves checkpoints should only save them on
+ * rank 0:
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * // ... Add the layers ...
+ *
+ * kmeans::MPICommunicator communicator;
+ * DistributedFFN<FFN<NegativeLogLikelihood<>>, kmeans::MPICommunicator>
+ *     distributed(model, communicator);
+ * ens::Adam optimizer(0.001, 32);
+ * distributed.Train(predictorsShard, responsesShard, optimizer,
+ *     ens::EarlyStopAtMinLoss());
+ * @endcode
+ *
+ * @tparam FFNType Type of the network to train.
+ * @tparam CommunicatorType Communicator of the ranks.
+ */
+template<typename FFNType,
+         typename CommunicatorType = kmeans::LocalCommunicator>
+class DistributedFFN
+{
+ public:
+  /**
+   * Create the object, which trains the given network (which must exist for
+   * the lifetime of the object).
+   *
+   * @param model Network to train.
+   * @param communicator Communicator of the ranks that hold the data.
+   */
+  DistributedFFN(FFNType& model,
+                 CommunicatorType communicator = CommunicatorType());
+
+  /**
+   * Train the network on the shard of the training data held by this rank;
+   * this must be called by all the ranks at the same time.  The network of
+   * every rank starts from the parameters of the network of rank 0.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables of this rank.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(arma::mat predictors,
+               arma::mat responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Evaluate the network with the given parameters on a batch of the shard of
+   * each rank, and return the objective averaged over the ranks.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point of the batch of this rank.
+   * @param batchSize Number of points of the batch of this rank.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Evaluate the network with the given parameters on a batch of the shard of
+   * each rank, and compute the gradient; the objective and the gradient are
+   * averaged over the ranks.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point of the batch of this rank.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points of the batch of this rank.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Compute the gradient of the network with the given parameters on a batch
+   * of the shard of each rank, averaged over the ranks.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point of the batch of this rank.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points of the batch of this rank.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  //! Shuffle the order in which the points of the shard are visited.
+  void Shuffle() { model.Shuffle(); }
+
+  //! Return the number of points of the shard of each rank.
+  size_t NumFunctions() const { return model.NumFunctions(); }
+
+  //! Get the network.
+  const FFNType& Model() const { return model; }
+  //! Modify the network.
+  FFNType& Model() { return model; }
+
+  //! Get the communicator.
+  const CommunicatorType& Communicator() const { return communicator; }
+  //! Modify the communicator.
+  CommunicatorType& Communicator() { return communicator; }
+
+ private:
+  /**
+   * Replace the given objective and gradient by their averages over the
+   * ranks, and return the objective.
+   */
+  double Average(const double objective, arma::mat& gradient);
+
+  //! The network to train.
+  FFNType& model;
+  //! The communicator of the ranks.
+  CommunicatorType communicator;
+  //! The buffer that holds the gradient and the objective while they are
+  //! reduced (it is reused from one batch to the next).
+  arma::mat buffer;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file methods/ann/distributed_ffn_impl.hpp
+ *
+ * Implementation of the DistributedFFN class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DISTRIBUTED_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_DISTRIBUTED_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_ffn.hpp"
+
+#include "util/check_input_shape.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename FFNType, typename CommunicatorType>
+DistributedFFN<FFNType, CommunicatorType>::DistributedFFN(
+    FFNType& model,
+    CommunicatorType communicator) :
+    model(model),
+    communicator(std::move(communicator))
+{
+  // Nothing to do.
+}
+
+template<typename FFNType, typename CommunicatorType>
+template<typename OptimizerType, typename... CallbackTypes>
+double DistributedFFN<FFNType, CommunicatorType>::Train(
+    arma::mat predictors,
+    arma::mat responses,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  CheckInputShape(model.Model(), predictors.n_rows,
+      "DistributedFFN::Train()");
+
+  // Every rank must evaluate the same number of batches, so the shards must
+  // have the same size; every rank checks the sizes of all the shards, so they
+  // all throw together.
+  arma::mat sizes(1, communicator.Size(), arma::fill::zeros);
+  sizes[communicator.Rank()] = responses.n_cols;
+  communicator.AllReduceSum(sizes);
+  if (arma::any(arma::vectorise(sizes) != sizes[0]))
+  {
+    throw std::invalid_argument("DistributedFFN::Train(): the shards of the "
+        "ranks must have the same number of points!");
+  }
+
+  model.ResetData(std::move(predictors), std::move(responses));
+
+  // Give the parameters of rank 0 to every rank.  The parameters are reduced in
+  // place, because the layers hold aliases of them.
+  if (communicator.Rank() != 0)
+    model.parameter.zeros();
+  communicator.AllReduceSum(model.parameter);
+
+  model.template WarnMessageMaxIterations<OptimizerType>(optimizer,
+      model.NumFunctions());
+
+  // Train the model.
+  const double out = optimizer.Optimize(*this, model.parameter, callbacks...);
+
+  Log::Info << "DistributedFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename FFNType, typename CommunicatorType>
+double DistributedFFN<FFNType, CommunicatorType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize)
+{
+  arma::mat objective(1, 1);
+  objective[0] = model.Evaluate(parameters, begin, batchSize);
+  communicator.AllReduceSum(objective);
+  return objective[0] / communicator.Size();
+}
+
+template<typename FFNType, typename CommunicatorType>
+double DistributedFFN<FFNType, CommunicatorType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  const double objective = model.EvaluateWithGradient(parameters, begin,
+      gradient, batchSize);
+  return Average(objective, gradient);
+}
+
+template<typename FFNType, typename CommunicatorType>
+void DistributedFFN<FFNType, CommunicatorType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename FFNType, typename CommunicatorType>
+double DistributedFFN<FFNType, CommunicatorType>::Average(
+    const double objective,
+    arma::mat& gradient)
+{
+  if (communicator.Size() == 1)
+    return objective;
+
+  // The objective is appended to the gradient, so that both are reduced in one
+  // call.
+  const size_t n = gradient.n_elem;
+  buffer.set_size(n + 1, 1);
+  std::copy(gradient.memptr(), gradient.memptr() + n, buffer.memptr());
+  buffer[n] = objective;
+
+  communicator.AllReduceSum(buffer);
+  buffer /= communicator.Size();
+
+  std::copy(buffer.memptr(), buffer.memptr() + n, gradient.memptr());
+  return buffer[n];
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,9 @@
 #define MLPACK_METHODS_ANN_FFN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/data_source.hpp>
+#include <chrono>
+#include <memory>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
@@ -26,6 +29,7 @@
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "util/memory_plan.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -163,6 +167,64 @@ class FFN
                arma::mat responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer, like Train(), but give sparse gradients (arma::sp_mat) to the
+   * optimizer.  If the first layer of the network is a Lookup (embedding)
+   * layer, the gradient of the embedding table then only holds the embeddings
+   * of the tokens in each batch, so neither the network nor the optimizer
+   * has to go over the whole table for each batch, as long as the update of
+   * the optimizer only touches the nonzero elements of the gradient (as the
+   * vanilla update of ens::SGD does).  This matters for large vocabularies.
+   *
+   * The gradients of the other layers are computed as usual.  The sparse
+   * gradients are computed with one thread, whatever Threads() is.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model; it must
+   *     accept a gradient type, like the ensmallen optimizers.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double TrainSparse(arma::mat predictors,
+                     arma::mat responses,
+                     OptimizerType& optimizer,
+                     CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on data read from disk, one batch of points
+   * at a time, so that the dataset does not need to fit in memory.  Both data
+   * sources are reset, and then the optimizer is run on each batch in turn
+   * (with batches read in the background while the optimizer runs, if the
+   * data sources prefetch); so, one call makes one pass over the data.  Call
+   * it again for more passes.
+   *
+   * Each batch is one call to optimizer.Optimize(), so the optimizer should
+   * usually be set to make one pass over a batch (e.g. MaxIterations() equal
+   * to the batch size of the data sources for SGD-like optimizers), and to
+   * keep its state between calls (e.g. ResetPolicy() = false).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Source of the input training variables.
+   * @param responses Source of the outputs of the input training variables;
+   *     it must hold the same number of points as predictors.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the last batch (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(data::DataSource<arma::mat>& predictors,
+               data::DataSource<arma::mat>& responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -171,10 +233,78 @@ class FFN
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
+   * The points are passed through the network in batches of batchSize
+   * points, so that each layer processes a whole batch at once.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Create a network with the same layers as this network that uses the
+   * weights of this network instead of a copy of them.  The new network has
+   * its own layer objects, and so its own activations and other intermediate
+   * results.  This allows one trained network to be used for prediction from
+   * several threads at once, with one shared network per thread and only one
+   * copy of the weights:
+   *
+   * @code
+   * std::vector<FFN<>> local;
+   * for (size_t i = 0; i < threads; ++i)
+   *   local.push_back(model.ShareWeights());
+   *
+   * #pragma omp parallel for
+   * for (size_t i = 0; i < threads; ++i)
+   *   local[i].Predict(predictors[i], results[i]);
+   * @endcode
+   *
+   * The returned network is in deterministic (prediction) mode, and does not
+   * hold the training data.  This network must outlive it, and the weights of
+   * this network must not be changed or reallocated (for instance by Train()
+   * or ResetParameters()) while the returned network is in use.  Some layers
+   * (i.e. BatchNorm) write to their weights while the new network is created
+   * (the values are restored afterwards), so ShareWeights() must not be called
+   * while another network is using the weights.
+   */
+  FFN ShareWeights() const;
+
+  /**
+   * Fold every BatchNorm layer that directly follows a Linear or Convolution
+   * layer into the weights and biases of that layer, and remove the BatchNorm
+   * layer from the network.  In deterministic mode, BatchNorm only scales and
+   * shifts each unit (or channel) with the running mean and variance, which
+   * is the same as scaling the weights and biases of the previous layer; so
+   * the predictions of the network are unchanged (up to rounding), but each
+   * forward pass does less work and reads less memory.
+   *
+   * This is meant to be called after training, before the network is used
+   * for prediction; training the fused network is not the same as training
+   * the original one.  Other BatchNorm layers are left as they are.
+   *
+   * @return The number of BatchNorm layers that were removed.
+   */
+  size_t FuseBatchNorm();
+
+  /**
+   * Quantize the network for inference: replace every Linear layer with a
+   * QuantizedLinear layer, which stores its weights as 8-bit integers with one
+   * scale per output unit.  The range of the input of each layer is
+   * calibrated by passing the given data through the network, so the data
+   * should be representative of the data the network will be used on (a few
+   * hundred points are usually enough).
+   *
+   * Quantized layers have no trainable parameters, so the network should not
+   * be trained after this.  The quantized network can be serialized as usual.
+   *
+   * @param calibrationData Input data used to find the range of the input of
+   *     each layer.
+   * @return The number of Linear layers that were quantized.
+   */
+  size_t Quantize(const arma::mat& calibrationData);
 
   /**
    * Evaluate the feedforward network with the given predictors and responses.
@@ -275,9 +405,47 @@ class FFN
                 arma::mat& gradient,
                 const size_t batchSize);
 
+  /**
+   * Evaluate the feedforward network with the given parameters on a number of
+   * points, and compute the gradient as a sparse matrix.  If the first layer
+   * of the network is a Lookup layer, only the gradient of the embeddings of
+   * the tokens in the batch is computed (see Lookup::SparseGradient()), and
+   * the embedding table is never gone over.  This is used by TrainSparse().
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::sp_mat& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the feedforward network as a sparse matrix, with
+   * the given parameters, and with respect to only a number of points in the
+   * dataset (see the sparse overload of EvaluateWithGradient()).
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize);
+
   /**
    * Shuffle the order of function visitation. This may be called by the
-   * optimizer.
+   * optimizer.  Only the visitation order is shuffled, and the points of each
+   * batch are gathered when the batch is evaluated, so the training data is
+   * never copied as a whole.
    */
   void Shuffle();
 
@@ -314,6 +482,86 @@ class FFN
   //! Modify the initial point for the optimization.
   arma::mat& Parameters() { return parameter; }
 
+  /**
+   * Get the number of threads used to compute the objective and gradient of a
+   * batch during training.  If it is greater than one, each batch is split
+   * into that many shards, and each shard is passed forward and backward
+   * through its own copy of the layers (which shares the weights of this
+   * network) on its own thread; the output layer is evaluated on the whole
+   * batch, and the gradients of the shards are summed.  This is useful for
+   * networks with small layers, where multithreaded BLAS does not help.
+   * Layers that compute statistics over the batch (i.e. BatchNorm) see only
+   * their shard.  The default is 1.
+   */
+  size_t Threads() const { return threads; }
+  //! Modify the number of threads used to compute the objective and gradient
+  //! of a batch during training.
+  size_t& Threads() { return threads; }
+
+  /**
+   * Get whether the activations and the deltas of the layers are placed in one
+   * block of memory during training, according to a memory plan.  After the
+   * first batch of a given size, the sizes of the activations and deltas of
+   * the layers are known, and each activation and delta is given a part of
+   * one block (see MemoryPlan): the activations are needed until the
+   * gradient is computed, but the delta of a layer is only needed until the
+   * gradient of the previous layer is computed, so the deltas of the layers
+   * share memory, and the backward pass computes the gradient of each layer
+   * right after its delta.  The activation of a logistic, tanh, softplus or
+   * rectifier layer that follows a Linear or LinearNoBias layer is computed in
+   * place, in the activation of that layer.  This reduces the peak memory of
+   * training (see PlannedMemory()), and the activations and deltas are not
+   * allocated for each batch.
+   *
+   * The plan is made again when the batch size changes, and it is not used
+   * when Threads() is greater than one.  The default is false.
+   */
+  bool MemoryPlanning() const { return memoryPlanning; }
+  //! Modify whether the activations and the deltas of the layers are placed
+  //! in one block of memory during training.
+  bool& MemoryPlanning() { return memoryPlanning; }
+
+  /**
+   * Get the number of elements of the block of memory of the memory plan, or
+   * 0 if no plan has been made (see MemoryPlanning()).
+   */
+  size_t PlannedMemory() const { return arena.n_elem; }
+
+  /**
+   * Get whether mixed precision is used.  When it is, the matrix products of
+   * the Linear and LinearNoBias layers (which dominate the cost of large
+   * MLPs) are computed in single precision, while the parameters, and the
+   * gradients given to the optimizer, are kept in double precision (see
+   * Linear::MixedPrecision()).  The default is false.
+   */
+  bool MixedPrecision() const { return mixedPrecision; }
+  //! Modify whether mixed precision is used.
+  bool& MixedPrecision() { return mixedPrecision; }
+
+  /**
+   * Get whether the time spent in the forward and backward pass of each layer
+   * is measured.  When it is, the times of the passes of the network (but not
+   * of the replicas used when Threads() > 1) are added to
+   * LayerForwardTimes() and LayerBackwardTimes().  The default is false.
+   */
+  bool LayerTiming() const { return layerTiming; }
+  //! Modify whether the time spent in the passes of each layer is measured.
+  bool& LayerTiming() { return layerTiming; }
+
+  //! Get the total time spent in the forward pass of each layer while
+  //! LayerTiming() was on, in seconds.
+  const std::vector<double>& LayerForwardTimes() const
+  {
+    return layerForwardTimes;
+  }
+
+  //! Get the total time spent in the backward pass of each layer while
+  //! LayerTiming() was on, in seconds.
+  const std::vector<double>& LayerBackwardTimes() const
+  {
+    return layerBackwardTimes;
+  }
+
   //! Get the matrix of responses to the input data points.
   const arma::mat& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -402,6 +650,23 @@ class FFN
    */
   void ResetData(arma::mat predictors, arma::mat responses);
 
+  /**
+   * Make input and target aliases of the predictors and the responses of the
+   * batch of the given size that starts at the given position of the
+   * visitation order.  When the points are visited in order, they are aliases
+   * of the training data; otherwise the points of the batch are gathered into
+   * buffers that are reused from one batch to the next.
+   *
+   * @param begin Position of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param input Matrix to make an alias of the predictors of the batch.
+   * @param target Matrix to make an alias of the responses of the batch.
+   */
+  void Batch(const size_t begin,
+             const size_t batchSize,
+             arma::mat& input,
+             arma::mat& target);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -421,11 +686,85 @@ class FFN
    */
   void ResetDeterministic();
 
+  /**
+   * Set the mixed precision mode of the Linear and LinearNoBias layers to the
+   * mode of the network.
+   */
+  void ResetMixedPrecision();
+
+  /**
+   * Lay out the given parameters of each layer contiguously in the parameters
+   * of the network, and make every layer use them.  This is used after layers
+   * are replaced or removed.
+   *
+   * @param layerParameters The parameters of each layer of the network.
+   */
+  void ResetLayerParameters(const std::vector<arma::mat>& layerParameters);
+
+  /**
+   * Copy the layers of this network into the given (empty) network, and make
+   * them use the parameters of this network.
+   *
+   * @param shared Network to copy the layers into.
+   */
+  void ShareLayers(FFN& shared) const;
+
+  /**
+   * Evaluate the objective and gradient of the given batch with the threads
+   * given by Threads(), with one shard of the batch per thread.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateWithGradientParallel(const size_t begin,
+                                      arma::mat& gradient,
+                                      const size_t batchSize);
+
   /**
    * Reset the gradient for all modules that implement the Gradient function.
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Make the memory plan of the activations and the deltas of the layers,
+   * given their sizes after a batch of the given size.
+   *
+   * @param batchSize Number of points in the batch.
+   */
+  void PlanMemory(const size_t batchSize);
+
+  /**
+   * Make the layers use the parts of the block of memory given by the memory
+   * plan for their activations and deltas.
+   */
+  void UseMemoryPlan();
+
+  /**
+   * Return true if the activation of the given layer can be computed in place
+   * in the activation of the previous layer.
+   *
+   * @param i Index of the layer.
+   */
+  bool InPlace(const size_t i);
+
+  /**
+   * Add the time since the given start to the given time of the given layer,
+   * making room for the times of all layers if needed.
+   */
+  void AddLayerTime(std::vector<double>& times,
+                    const size_t i,
+                    const std::chrono::steady_clock::time_point& start);
+
+  /**
+   * The Backward algorithm, computing the gradient of each layer right after
+   * its delta, so that the deltas can share memory (see MemoryPlanning()).
+   *
+   * @param input Input of the network.
+   */
+  template<typename InputType>
+  void BackwardWithGradient(const InputType& input);
+
   /**
    * Swap the content of this network with given network.
    *
@@ -464,6 +803,18 @@ class FFN
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
+  //! The order in which the points are visited, given by Shuffle(); if it is
+  //! empty, the points are visited in the order of the data.
+  arma::uvec visitationOrder;
+
+  //! The buffer the predictors of a batch are gathered into, when the points
+  //! are not visited in order.
+  arma::mat predictorsBuffer;
+
+  //! The buffer the responses of a batch are gathered into, when the points
+  //! are not visited in order.
+  arma::mat responsesBuffer;
+
   //! The current error for the backward pass.
   arma::mat error;
 
@@ -506,9 +857,62 @@ class FFN
   //! Locally-stored gradient parameter.
   arma::mat gradient;
 
+  //! The dense part of the gradient computed by the sparse overload of
+  //! EvaluateWithGradient(); the part of the Lookup layer is always zero.
+  arma::mat sparseDenseGradient;
+
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The number of threads used to compute the gradient of a batch.
+  size_t threads;
+
+  //! The networks that compute the other shards of a batch when threads > 1;
+  //! they share the parameters of this network.
+  std::vector<std::unique_ptr<FFN> > replicas;
+
+  //! The parameters the replicas were created for.
+  const double* replicaParameter;
+
+  //! A part of the block of memory of the memory plan.
+  struct PlannedBuffer
+  {
+    //! The offset of the part in the block.
+    size_t offset;
+    //! The number of rows of the buffer.
+    size_t rows;
+    //! The number of columns of the buffer.
+    size_t cols;
+  };
+
+  //! Whether the activations and deltas are placed by a memory plan.
+  bool memoryPlanning;
+
+  //! The batch size of the memory plan (0 if there is no plan).
+  size_t plannedBatchSize;
+
+  //! The block of memory of the memory plan.
+  arma::mat arena;
+
+  //! The parts of the block used by the activation of each layer.
+  std::vector<PlannedBuffer> plannedOutputs;
+
+  //! The parts of the block used by the delta of each layer (the first layer
+  //! has no delta).
+  std::vector<PlannedBuffer> plannedDeltas;
+
+  //! Whether the matrix products of the linear layers use single precision.
+  bool mixedPrecision;
+
+  //! Whether the time spent in the passes of each layer is measured.
+  bool layerTiming;
+
+  //! The total time spent in the forward pass of each layer.
+  std::vector<double> layerForwardTimes;
+
+  //! The total time spent in the backward pass of each layer.
+  std::vector<double> layerBackwardTimes;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -517,6 +921,10 @@ class FFN
     typename PolicyType
   >
   friend class GAN;
+
+  // DistributedFFN prepares the network for training like Train() does.
+  template<typename FFNType, typename CommunicatorType>
+  friend class DistributedFFN;
 }; // class FFN
 
 } // namespace ann
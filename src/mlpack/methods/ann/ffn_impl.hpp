@@ -39,7 +39,13 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(false)
+    deterministic(false),
+    threads(1),
+    replicaParameter(NULL),
+    memoryPlanning(false),
+    plannedBatchSize(0),
+    mixedPrecision(false),
+    layerTiming(false)
 {
   /* Nothing to do here. */
 }
@@ -60,6 +66,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
   numFunctions = responses.n_cols;
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  visitationOrder.reset();
   this->deterministic = false;
   ResetDeterministic();
 
@@ -115,6 +122,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
                                                               predictors.n_rows,
                                                               "FFN<>::Train()");
 
+  MLPACK_MEMORY_PHASE("ffn_training");
   ResetData(std::move(predictors), std::move(responses));
 
   WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
@@ -139,6 +147,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
                                                               predictors.n_rows,
                                                               "FFN<>::Train()");
 
+  MLPACK_MEMORY_PHASE("ffn_training");
   ResetData(std::move(predictors), std::move(responses));
 
   OptimizerType optimizer;
@@ -153,6 +162,68 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+TrainSparse(arma::mat predictors,
+            arma::mat responses,
+            OptimizerType& optimizer,
+            CallbackTypes&&... callbacks)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network,
+      predictors.n_rows, "FFN<>::TrainSparse()");
+
+  MLPACK_MEMORY_PHASE("ffn_training");
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model, with sparse gradients.
+  const double out = optimizer.template Optimize<FFN, arma::mat, arma::sp_mat>(
+      *this, parameter, callbacks...);
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    data::DataSource<arma::mat>& predictors,
+    data::DataSource<arma::mat>& responses,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  predictors.Reset();
+  responses.Reset();
+
+  double out = 0.0;
+  arma::mat predictorsBatch, responsesBatch;
+  while (predictors.Next(predictorsBatch))
+  {
+    if (!responses.Next(responsesBatch) ||
+        responsesBatch.n_cols != predictorsBatch.n_cols)
+    {
+      throw std::invalid_argument("FFN<>::Train(): the predictors and the "
+          "responses have different numbers of points");
+    }
+
+    out = Train(std::move(predictorsBatch), std::move(responsesBatch),
+        optimizer, callbacks...);
+  }
+
+  if (responses.Next(responsesBatch))
+  {
+    throw std::invalid_argument("FFN<>::Train(): the predictors and the "
+        "responses have different numbers of points");
+  }
+
+  return out;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename PredictorsType, typename ResponsesType>
@@ -221,7 +292,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
   CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(
       network, predictors.n_rows, "FFN<>::Predict()");
@@ -235,22 +306,207 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  // Process in accordance with the given batch size.
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+    Forward(arma::mat(predictors.colptr(begin), predictors.n_rows,
+        effectiveBatchSize, false, true));
+
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network.back());
+
+    // The size of the output is only known after the first forward pass.
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = output;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ShareWeights()
+    const
+{
+  FFN shared(outputLayer, initializeRule);
+  shared.width = width;
+  shared.height = height;
+  shared.reset = reset;
+
+  ShareLayers(shared);
+
+  shared.deterministic = true;
+  shared.ResetDeterministic();
+
+  return shared;
+}
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::FuseBatchNorm()
+{
+  if (parameter.is_empty())
+    ResetParameters();
 
-  for (size_t i = 1; i < predictors.n_cols; ++i)
+  // The parameters of the layers we keep, in order.
+  std::vector<LayerTypes<CustomLayers...> > fused;
+  std::vector<arma::mat> fusedParameters;
+  size_t removed = 0;
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true));
+    const size_t layerSize = boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+    fused.push_back(network[i]);
+    if (layerSize > 0)
+      fusedParameters.push_back(parameter.rows(offset, offset + layerSize - 1));
+    else
+      fusedParameters.push_back(arma::mat());
+    offset += layerSize;
+
+    if (i + 1 == network.size())
+      break;
+
+    BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i + 1]);
+    if (!batchNorm)
+      continue;
+
+    // In deterministic mode, the output of the BatchNorm layer for unit (or
+    // channel) j is scale(j) * x + shift(j).
+    const size_t size = (*batchNorm)->InputSize();
+    const arma::mat& batchNormParameters = (*batchNorm)->Parameters();
+    const arma::vec scale = batchNormParameters.rows(0, size - 1) /
+        arma::sqrt((*batchNorm)->TrainingVariance() +
+        (*batchNorm)->Epsilon());
+    const arma::vec shift = batchNormParameters.rows(size, 2 * size - 1) -
+        scale % (*batchNorm)->TrainingMean();
+
+    arma::mat& layerParameters = fusedParameters.back();
+    bool fold = false;
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+    {
+      if ((*linear)->OutputSize() == size)
+      {
+        // The weights are stored as an outSize x inSize matrix, followed by
+        // the biases.
+        arma::mat weight(layerParameters.memptr(), size,
+            (*linear)->InputSize(), false, true);
+        arma::vec bias(layerParameters.memptr() + weight.n_elem, size, false,
+            true);
+        weight.each_col() %= scale;
+        bias = scale % bias + shift;
+        fold = true;
+      }
+    }
+    else if (Convolution<>** convolution =
+        boost::get<Convolution<>*>(&network[i]))
+    {
+      if ((*convolution)->OutputSize() == size)
+      {
+        // The filters of output map j are the slices j * inSize to
+        // (j + 1) * inSize - 1, followed by the biases.
+        const size_t inSize = (*convolution)->InputSize();
+        arma::cube weight(layerParameters.memptr(),
+            (*convolution)->KernelWidth(), (*convolution)->KernelHeight(),
+            size * inSize, false, true);
+        arma::vec bias(layerParameters.memptr() + weight.n_elem, size, false,
+            true);
+        for (size_t j = 0; j < size; ++j)
+          weight.slices(j * inSize, (j + 1) * inSize - 1) *= scale(j);
+        bias = scale % bias + shift;
+        fold = true;
+      }
+    }
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
-        network.back());
-    results.col(i) = resultsTemp.col(0);
+    if (fold)
+    {
+      // Skip the parameters of the BatchNorm layer, and remove it.
+      offset += batchNormParameters.n_elem;
+      boost::apply_visitor(deleteVisitor, network[i + 1]);
+      ++removed;
+      ++i;
+    }
+  }
+
+  if (removed == 0)
+    return 0;
+
+  network = std::move(fused);
+  ResetLayerParameters(fusedParameters);
+
+  return removed;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::Quantize(const arma::mat& calibrationData)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(
+      network, calibrationData.n_rows, "FFN<>::Quantize()");
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // Find the range of the input of every layer on the calibration data.
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(calibrationData);
+
+  // All the ranges are taken from the full-precision pass before any layer is
+  // replaced, since a replaced layer no longer holds its output.
+  std::vector<double> inputRanges(network.size(), 0.0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    if (boost::get<Linear<>*>(&network[i]))
+    {
+      const arma::mat& input = (i == 0) ? calibrationData :
+          boost::apply_visitor(outputParameterVisitor, network[i - 1]);
+      inputRanges[i] = arma::abs(input).max();
+    }
   }
+
+  std::vector<arma::mat> layerParameters;
+  size_t quantized = 0;
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t layerSize = boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+    Linear<>** linear = boost::get<Linear<>*>(&network[i]);
+    if (linear)
+    {
+      QuantizedLinear<>* layer = new QuantizedLinear<>(**linear,
+          inputRanges[i]);
+      delete *linear;
+      network[i] = layer;
+      layerParameters.push_back(arma::mat());
+      ++quantized;
+    }
+    else if (layerSize > 0)
+    {
+      layerParameters.push_back(parameter.rows(offset, offset + layerSize - 1));
+    }
+    else
+    {
+      layerParameters.push_back(arma::mat());
+    }
+
+    offset += layerSize;
+  }
+
+  if (quantized > 0)
+    ResetLayerParameters(layerParameters);
+
+  return quantized;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -313,10 +569,12 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
+  arma::mat input, target;
+  Batch(begin, batchSize, input, target);
+
+  Forward(input);
   double res = outputLayer.Forward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1));
+      boost::apply_visitor(outputParameterVisitor, network.back()), target);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -374,10 +632,22 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(predictors.cols(begin, begin + batchSize - 1));
+  if (threads > 1 && batchSize >= threads)
+    return EvaluateWithGradientParallel(begin, gradient, batchSize);
+
+  // Use the memory plan if there is one for the current network and batch
+  // size.
+  const bool planned = memoryPlanning && plannedBatchSize == batchSize &&
+      plannedOutputs.size() == network.size();
+  if (planned)
+    UseMemoryPlan();
+
+  arma::mat input, target;
+  Batch(begin, batchSize, input, target);
+
+  Forward(input);
   double res = outputLayer.Forward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1));
+      boost::apply_visitor(outputParameterVisitor, network.back()), target);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -385,13 +655,24 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   }
 
   outputLayer.Backward(
-      boost::apply_visitor(outputParameterVisitor, network.back()),
-      responses.cols(begin, begin + batchSize - 1),
+      boost::apply_visitor(outputParameterVisitor, network.back()), target,
       error);
 
-  Backward();
-  ResetGradients(gradient);
-  Gradient(predictors.cols(begin, begin + batchSize - 1));
+  if (planned)
+  {
+    ResetGradients(gradient);
+    BackwardWithGradient(input);
+  }
+  else
+  {
+    Backward();
+    ResetGradients(gradient);
+    Gradient(input);
+
+    // Now the sizes of the activations and the deltas are known.
+    if (memoryPlanning && network.size() > 1)
+      PlanMemory(batchSize);
+  }
 
   return res;
 }
@@ -407,11 +688,172 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+EvaluateWithGradient(const arma::mat& parameters,
+                     const size_t begin,
+                     arma::sp_mat& gradient,
+                     const size_t batchSize)
+{
+  Lookup<arma::mat, arma::mat>** lookupPtr =
+      boost::get<Lookup<arma::mat, arma::mat>*>(&network.front());
+  if (lookupPtr == NULL)
+  {
+    // Without a Lookup layer, the whole gradient is dense anyway.
+    const double res = EvaluateWithGradient(parameters, begin,
+        sparseDenseGradient, batchSize);
+    gradient = arma::sp_mat(sparseDenseGradient);
+    return res;
+  }
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // Only the gradient of the layers after the Lookup layer has to be zeroed;
+  // the part of the Lookup layer is not written.
+  const size_t lookupSize = (*lookupPtr)->Parameters().n_elem;
+  if (sparseDenseGradient.n_elem != parameter.n_elem)
+    sparseDenseGradient.zeros(parameter.n_rows, parameter.n_cols);
+  else if (lookupSize < parameter.n_elem)
+    sparseDenseGradient.rows(lookupSize, parameter.n_elem - 1).zeros();
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  arma::mat input, target;
+  Batch(begin, batchSize, input, target);
+
+  Forward(input);
+  double res = outputLayer.Forward(
+      boost::apply_visitor(outputParameterVisitor, network.back()), target);
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    res += boost::apply_visitor(lossVisitor, network[i]);
+  }
+
+  outputLayer.Backward(
+      boost::apply_visitor(outputParameterVisitor, network.back()), target,
+      error);
+
+  Backward();
+  ResetGradients(sparseDenseGradient);
+
+  // Compute the gradient of every layer but the Lookup layer, like Gradient()
+  // does.
+  for (size_t i = 1; i + 1 < network.size(); ++i)
+  {
+    boost::apply_visitor(GradientVisitor(boost::apply_visitor(
+        outputParameterVisitor, network[i - 1]),
+        boost::apply_visitor(deltaVisitor, network[i + 1])), network[i]);
+  }
+
+  if (network.size() > 1)
+  {
+    boost::apply_visitor(GradientVisitor(boost::apply_visitor(
+        outputParameterVisitor, network[network.size() - 2]), error),
+        network[network.size() - 1]);
+  }
+
+  arma::mat embeddingGradient;
+  (*lookupPtr)->SparseGradient(input, (network.size() > 1) ?
+      boost::apply_visitor(deltaVisitor, network[1]) : error,
+      embeddingGradient);
+
+  // Assemble the sparse gradient: first the used embeddings (in increasing
+  // order of column), and then the gradient of the other layers.
+  const arma::uvec& usedColumns = (*lookupPtr)->UsedColumns();
+  const size_t embeddingSize = embeddingGradient.n_rows;
+  const size_t numEmbeddingElements = embeddingGradient.n_elem;
+  const size_t nonzeros = numEmbeddingElements +
+      (parameter.n_elem - lookupSize);
+
+  arma::uvec rowIndices(nonzeros);
+  arma::vec values(nonzeros);
+  for (size_t j = 0; j < usedColumns.n_elem; ++j)
+  {
+    for (size_t r = 0; r < embeddingSize; ++r)
+      rowIndices[j * embeddingSize + r] = usedColumns[j] * embeddingSize + r;
+  }
+
+  if (numEmbeddingElements > 0)
+  {
+    values.subvec(0, numEmbeddingElements - 1) =
+        arma::vectorise(embeddingGradient);
+  }
+
+  if (nonzeros > numEmbeddingElements)
+  {
+    rowIndices.subvec(numEmbeddingElements, nonzeros - 1) =
+        arma::regspace<arma::uvec>(lookupSize, parameter.n_elem - 1);
+    values.subvec(numEmbeddingElements, nonzeros - 1) =
+        sparseDenseGradient.rows(lookupSize, parameter.n_elem - 1);
+  }
+
+  arma::uvec columnPointers(2);
+  columnPointers[0] = 0;
+  columnPointers[1] = nonzeros;
+  gradient = arma::sp_mat(rowIndices, columnPointers, values,
+      parameter.n_rows, parameter.n_cols);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  visitationOrder = arma::randperm<arma::uvec>(numFunctions);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Batch(
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& input,
+    arma::mat& target)
+{
+  // The aliases are not strict, so that they can be pointed at other memory
+  // by assignment (see GAN::Evaluate()).
+  if (visitationOrder.is_empty())
+  {
+    math::MakeAlias(input, predictors.colptr(begin), predictors.n_rows,
+        batchSize, false);
+    math::MakeAlias(target, responses.colptr(begin), responses.n_rows,
+        batchSize, false);
+    return;
+  }
+
+  // The buffers keep their memory as long as the batch size does not change.
+  predictorsBuffer.set_size(predictors.n_rows, batchSize);
+  responsesBuffer.set_size(responses.n_rows, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t point = visitationOrder[begin + i];
+    predictorsBuffer.col(i) = predictors.col(point);
+    responsesBuffer.col(i) = responses.col(point);
+  }
+
+  math::MakeAlias(input, predictorsBuffer.memptr(), predictors.n_rows,
+      batchSize, false);
+  math::MakeAlias(target, responsesBuffer.memptr(), responses.n_rows,
+      batchSize, false);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -420,6 +862,7 @@ void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetParameters()
 {
   ResetDeterministic();
+  plannedBatchSize = 0;
 
   // Reset the network parameter with the given initialization rule.
   NetworkInitialization<InitializationRuleType,
@@ -427,6 +870,45 @@ void FFN<OutputLayerType, InitializationRuleType,
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetLayerParameters(
+    const std::vector<arma::mat>& layerParameters)
+{
+  plannedBatchSize = 0;
+
+  size_t numParameters = 0;
+  for (size_t i = 0; i < layerParameters.size(); ++i)
+    numParameters += layerParameters[i].n_elem;
+
+  arma::mat newParameter(numParameters, 1);
+  size_t offset = 0;
+  for (size_t i = 0; i < layerParameters.size(); ++i)
+  {
+    if (layerParameters[i].n_elem == 0)
+      continue;
+
+    newParameter.rows(offset, offset + layerParameters[i].n_elem - 1) =
+        arma::vectorise(layerParameters[i]);
+    offset += layerParameters[i].n_elem;
+  }
+
+  parameter = newParameter;
+  offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+        network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+
+  // Some layers (i.e. BatchNorm) initialize their parameters in Reset(), so
+  // restore the values.
+  parameter = newParameter;
+  ResetDeterministic();
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -437,6 +919,158 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(deterministicSetVisitor));
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetMixedPrecision()
+{
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+    {
+      (*linear)->MixedPrecision() = mixedPrecision;
+    }
+    else if (LinearNoBias<>** linear =
+        boost::get<LinearNoBias<>*>(&network[i]))
+    {
+      (*linear)->MixedPrecision() = mixedPrecision;
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ShareLayers(FFN& shared) const
+{
+  // Some layers (i.e. BatchNorm) initialize their parameters in Reset(), so
+  // keep the values to restore them.
+  const arma::mat values = parameter;
+
+  shared.parameter = arma::mat(const_cast<double*>(parameter.memptr()),
+      parameter.n_rows, parameter.n_cols, false, false);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    shared.network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+    offset += boost::apply_visitor(WeightSetVisitor(shared.parameter, offset),
+        shared.network.back());
+    boost::apply_visitor(resetVisitor, shared.network.back());
+  }
+
+  shared.parameter = values;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::EvaluateWithGradientParallel(
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  // The replicas have to be created again if the parameters have been
+  // reallocated or the network has changed.
+  if (replicas.size() != threads - 1 ||
+      replicaParameter != parameter.memptr() ||
+      (!replicas.empty() && replicas[0]->network.size() != network.size()))
+  {
+    replicas.clear();
+    for (size_t i = 1; i < threads; ++i)
+    {
+      replicas.emplace_back(new FFN(outputLayer, initializeRule));
+      FFN& replica = *replicas.back();
+      replica.width = width;
+      replica.height = height;
+      replica.reset = reset;
+      ShareLayers(replica);
+    }
+
+    replicaParameter = parameter.memptr();
+  }
+
+  for (size_t i = 0; i < replicas.size(); ++i)
+  {
+    replicas[i]->deterministic = false;
+    replicas[i]->ResetDeterministic();
+    replicas[i]->mixedPrecision = mixedPrecision;
+  }
+
+  // Shard s holds the points [begin + bounds[s], begin + bounds[s + 1]).
+  std::vector<size_t> bounds(threads + 1);
+  for (size_t s = 0; s <= threads; ++s)
+    bounds[s] = s * batchSize / threads;
+
+  // The gradient of each shard; the first shard uses the given gradient.
+  std::vector<arma::mat> gradients(threads - 1);
+
+  arma::mat input, target;
+  Batch(begin, batchSize, input, target);
+
+  // Pass each shard forward through its own network.
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  for (omp_size_t s = 0; s < (omp_size_t) threads; ++s)
+  {
+    FFN& net = (s == 0) ? *this : *replicas[s - 1];
+    net.Forward(input.cols(bounds[s], bounds[s + 1] - 1));
+  }
+
+  // Evaluate the output layer on the whole batch, so that the objective and
+  // the error are the same as without shards.
+  const arma::mat& lastOutput = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  arma::mat output(lastOutput.n_rows, batchSize);
+  for (size_t s = 0; s < threads; ++s)
+  {
+    FFN& net = (s == 0) ? *this : *replicas[s - 1];
+    output.cols(bounds[s], bounds[s + 1] - 1) = boost::apply_visitor(
+        outputParameterVisitor, net.network.back());
+  }
+
+  double res = outputLayer.Forward(output, target);
+  for (size_t s = 0; s < threads; ++s)
+  {
+    FFN& net = (s == 0) ? *this : *replicas[s - 1];
+    for (size_t i = 0; i < net.network.size(); ++i)
+      res += boost::apply_visitor(lossVisitor, net.network[i]);
+  }
+
+  outputLayer.Backward(output, target, error);
+
+  // Give each network the error of its shard.
+  for (size_t s = 1; s < threads; ++s)
+    replicas[s - 1]->error = error.cols(bounds[s], bounds[s + 1] - 1);
+  error = arma::mat(error.cols(bounds[0], bounds[1] - 1));
+
+  // Pass the error of each shard backward through its own network.
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  for (omp_size_t s = 0; s < (omp_size_t) threads; ++s)
+  {
+    FFN& net = (s == 0) ? *this : *replicas[s - 1];
+    arma::mat& netGradient = (s == 0) ? gradient : gradients[s - 1];
+    if (s != 0)
+      netGradient.zeros(gradient.n_rows, gradient.n_cols);
+
+    net.Backward();
+    net.ResetGradients(netGradient);
+    net.Gradient(input.cols(bounds[s], bounds[s + 1] - 1));
+  }
+
+  // Sum the gradients of the shards.
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  for (omp_size_t i = 0; i < (omp_size_t) gradient.n_elem; ++i)
+  {
+    double sum = 0.0;
+    for (size_t s = 0; s < gradients.size(); ++s)
+      sum += gradients[s][i];
+
+    gradient[i] += sum;
+  }
+
+  return res;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -456,10 +1090,19 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  ResetMixedPrecision();
+
+  std::chrono::steady_clock::time_point start;
+  if (layerTiming)
+    start = std::chrono::steady_clock::now();
+
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
 
+  if (layerTiming)
+    AddLayerTime(layerForwardTimes, 0, start);
+
   if (!reset)
   {
     if (boost::apply_visitor(outputWidthVisitor, network.front()) != 0)
@@ -484,10 +1127,16 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
+    if (layerTiming)
+      start = std::chrono::steady_clock::now();
+
     boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])), network[i]);
 
+    if (layerTiming)
+      AddLayerTime(layerForwardTimes, i, start);
+
     if (!reset)
     {
       // Get the output width.
@@ -512,18 +1161,184 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  std::chrono::steady_clock::time_point start;
+  if (layerTiming)
+    start = std::chrono::steady_clock::now();
+
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network.back()), error,
       boost::apply_visitor(deltaVisitor, network.back())), network.back());
 
+  if (layerTiming)
+    AddLayerTime(layerBackwardTimes, network.size() - 1, start);
+
   for (size_t i = 2; i < network.size(); ++i)
   {
+    if (layerTiming)
+      start = std::chrono::steady_clock::now();
+
     boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[network.size() - i]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+
+    if (layerTiming)
+      AddLayerTime(layerBackwardTimes, network.size() - i, start);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+AddLayerTime(std::vector<double>& times,
+             const size_t i,
+             const std::chrono::steady_clock::time_point& start)
+{
+  if (times.size() != network.size())
+    times.resize(network.size(), 0.0);
+
+  times[i] += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlanMemory(const size_t batchSize)
+{
+  // The steps of the backward pass: the delta of layer i is computed in step
+  // (network.size() - 1 - i), and it is used until the gradient of layer
+  // (i - 1) is computed in the next step.  The activations are used during
+  // all the steps.
+  const size_t numSteps = network.size();
+  MemoryPlan plan;
+  std::vector<size_t> outputIndices(network.size());
+  std::vector<size_t> deltaIndices(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    if (i > 0 && InPlace(i) && output.n_elem == boost::apply_visitor(
+        outputParameterVisitor, network[i - 1]).n_elem)
+      outputIndices[i] = outputIndices[i - 1];
+    else
+      outputIndices[i] = plan.Add(output.n_elem, 0, numSteps);
+  }
+
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    const size_t step = network.size() - 1 - i;
+    deltaIndices[i] = plan.Add(boost::apply_visitor(deltaVisitor,
+        network[i]).n_elem, step, step + 1);
+  }
+
+  plan.Plan();
+  arena.set_size(plan.Size(), 1);
+
+  plannedOutputs.resize(network.size());
+  plannedDeltas.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    plannedOutputs[i].offset = plan.Offset(outputIndices[i]);
+    plannedOutputs[i].rows = output.n_rows;
+    plannedOutputs[i].cols = output.n_cols;
+
+    const arma::mat& delta = boost::apply_visitor(deltaVisitor, network[i]);
+    plannedDeltas[i].offset = (i > 0) ? plan.Offset(deltaIndices[i]) : 0;
+    plannedDeltas[i].rows = (i > 0) ? delta.n_rows : 0;
+    plannedDeltas[i].cols = (i > 0) ? delta.n_cols : 0;
   }
+
+  plannedBatchSize = batchSize;
+  Log::Info << "FFN::PlanMemory(): the activations and deltas use "
+      << plan.Size() << " elements instead of " << plan.TotalElements()
+      << "." << std::endl;
+
+  // Some layers may still use the previous block, which has been freed.
+  UseMemoryPlan();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::UseMemoryPlan()
+{
+  // The layers keep their memory if they resize these matrices, so their
+  // results are right even if the plan is not right anymore.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(outputParameterVisitor, network[i]) = arma::mat(
+        arena.memptr() + plannedOutputs[i].offset, plannedOutputs[i].rows,
+        plannedOutputs[i].cols, false, false);
+
+    if (i > 0)
+    {
+      boost::apply_visitor(deltaVisitor, network[i]) = arma::mat(
+          arena.memptr() + plannedDeltas[i].offset, plannedDeltas[i].rows,
+          plannedDeltas[i].cols, false, false);
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::InPlace(const size_t i)
+{
+  // The activation functions of these layers are computed element by element,
+  // and their backward pass only uses their output.
+  const bool activation =
+      boost::get<BaseLayer<LogisticFunction, arma::mat, arma::mat>*>(
+          &network[i]) != NULL ||
+      boost::get<BaseLayer<TanhFunction, arma::mat, arma::mat>*>(
+          &network[i]) != NULL ||
+      boost::get<BaseLayer<SoftplusFunction, arma::mat, arma::mat>*>(
+          &network[i]) != NULL ||
+      boost::get<BaseLayer<RectifierFunction, arma::mat, arma::mat>*>(
+          &network[i]) != NULL;
+
+  // The backward pass of these layers does not use their output, so it can be
+  // overwritten.
+  const bool linear =
+      boost::get<Linear<arma::mat, arma::mat, NoRegularizer>*>(
+          &network[i - 1]) != NULL ||
+      boost::get<LinearNoBias<arma::mat, arma::mat, NoRegularizer>*>(
+          &network[i - 1]) != NULL;
+
+  return activation && linear;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BackwardWithGradient(const InputType& input)
+{
+  boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+      outputParameterVisitor, network.back()), error,
+      boost::apply_visitor(deltaVisitor, network.back())), network.back());
+  boost::apply_visitor(GradientVisitor(boost::apply_visitor(
+      outputParameterVisitor, network[network.size() - 2]), error),
+      network.back());
+
+  for (size_t i = 2; i < network.size(); ++i)
+  {
+    const size_t layer = network.size() - i;
+    boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+        outputParameterVisitor, network[layer]),
+        boost::apply_visitor(deltaVisitor, network[layer + 1]),
+        boost::apply_visitor(deltaVisitor, network[layer])), network[layer]);
+    boost::apply_visitor(GradientVisitor(boost::apply_visitor(
+        outputParameterVisitor, network[layer - 1]),
+        boost::apply_visitor(deltaVisitor, network[layer + 1])),
+        network[layer]);
+  }
+
+  boost::apply_visitor(GradientVisitor(input,
+      boost::apply_visitor(deltaVisitor, network[1])), network.front());
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -601,12 +1416,25 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(responses, network.responses);
   std::swap(parameter, network.parameter);
   std::swap(numFunctions, network.numFunctions);
+  std::swap(visitationOrder, network.visitationOrder);
   std::swap(error, network.error);
   std::swap(deterministic, network.deterministic);
   std::swap(delta, network.delta);
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(threads, network.threads);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaParameter, network.replicaParameter);
+  std::swap(memoryPlanning, network.memoryPlanning);
+  std::swap(plannedBatchSize, network.plannedBatchSize);
+  std::swap(arena, network.arena);
+  std::swap(plannedOutputs, network.plannedOutputs);
+  std::swap(plannedDeltas, network.plannedDeltas);
+  std::swap(mixedPrecision, network.mixedPrecision);
+  std::swap(layerTiming, network.layerTiming);
+  std::swap(layerForwardTimes, network.layerForwardTimes);
+  std::swap(layerBackwardTimes, network.layerBackwardTimes);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -622,12 +1450,21 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     responses(network.responses),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
+    visitationOrder(network.visitationOrder),
     error(network.error),
     deterministic(network.deterministic),
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    threads(network.threads),
+    replicaParameter(NULL),
+    memoryPlanning(network.memoryPlanning),
+    plannedBatchSize(0),
+    mixedPrecision(network.mixedPrecision),
+    layerTiming(network.layerTiming),
+    layerForwardTimes(network.layerForwardTimes),
+    layerBackwardTimes(network.layerBackwardTimes)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -651,12 +1488,25 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     responses(std::move(network.responses)),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
+    visitationOrder(std::move(network.visitationOrder)),
     error(std::move(network.error)),
     deterministic(network.deterministic),
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    threads(network.threads),
+    replicas(std::move(network.replicas)),
+    replicaParameter(network.replicaParameter),
+    memoryPlanning(network.memoryPlanning),
+    plannedBatchSize(network.plannedBatchSize),
+    arena(std::move(network.arena)),
+    plannedOutputs(std::move(network.plannedOutputs)),
+    plannedDeltas(std::move(network.plannedDeltas)),
+    mixedPrecision(network.mixedPrecision),
+    layerTiming(network.layerTiming),
+    layerForwardTimes(std::move(network.layerForwardTimes)),
+    layerBackwardTimes(std::move(network.layerBackwardTimes))
 {
   this->network = std::move(network.network);
 };
@@ -162,6 +162,7 @@ void GAN<Model, InitializationRuleType, Noise, PolicyType>::ResetData(
       arma::zeros(1, batchSize);
   this->discriminator.responses = arma::mat(this->responses.memptr(),
       this->responses.n_rows, this->responses.n_cols, false, false);
+  this->discriminator.visitationOrder.reset();
 
   this->generator.predictors.set_size(noiseDim, batchSize);
   this->generator.responses.set_size(predictors.n_rows, batchSize);
@@ -252,10 +253,9 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
     ResetDeterministic();
   }
 
-  currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
-      predictors.n_rows, batchSize, false, false);
-  currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
-      false);
+  // Get the real points of the batch, in the visitation order of the
+  // discriminator.
+  discriminator.Batch(i, batchSize, currentInput, currentTarget);
 
   discriminator.Forward(currentInput);
   double res = discriminator.outputLayer.Forward(
@@ -411,9 +411,12 @@ template<
 >
 void GAN<Model, InitializationRuleType, Noise, PolicyType>::Shuffle()
 {
-  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      numFunctions - 1, numFunctions));
-  predictors.cols(0, numFunctions - 1) = predictors.cols(ordering);
+  // Only the visitation order of the real points is shuffled; the discriminator
+  // gathers the points of each batch, so the data is never copied as a whole.
+  // The generated points, after the real points, are visited in order.
+  discriminator.visitationOrder = arma::join_cols(
+      arma::randperm<arma::uvec>(numFunctions),
+      arma::regspace<arma::uvec>(numFunctions, numFunctions + batchSize - 1));
 }
 
 template<
@@ -45,10 +45,9 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
     ResetDeterministic();
   }
 
-  currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
-      predictors.n_rows, batchSize, false, false);
-  currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
-      false);
+  // Get the real points of the batch, in the visitation order of the
+  // discriminator.
+  discriminator.Batch(i, batchSize, currentInput, currentTarget);
 
   discriminator.Forward(currentInput);
   double res = discriminator.outputLayer.Forward(
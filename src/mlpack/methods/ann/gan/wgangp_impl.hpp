@@ -46,10 +46,9 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
     ResetDeterministic();
   }
 
-  currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
-      predictors.n_rows, batchSize, false, false);
-  currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
-      false);
+  // Get the real points of the batch, in the visitation order of the
+  // discriminator.
+  discriminator.Batch(i, batchSize, currentInput, currentTarget);
 
   discriminator.Forward(std::move(currentInput));
   double res = discriminator.outputLayer.Forward(
@@ -141,8 +140,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
-      predictors.n_rows, batchSize, false, false);
+  // Get the real points of the batch, in the visitation order of the
+  // discriminator.
+  discriminator.Batch(i, batchSize, currentInput, currentTarget);
 
   // Get the gradients of the Discriminator.
   double res = discriminator.EvaluateWithGradient(discriminator.parameter,
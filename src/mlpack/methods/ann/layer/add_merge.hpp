@@ -179,6 +179,18 @@ class AddMerge
   //! Modify the value of run parameter.
   bool& Run() { return run; }
 
+  /**
+   * Get whether the Forward(), Backward() and Gradient() passes of the modules
+   * run concurrently on the OpenMP thread pool (false by default).  This is
+   * worth it when the modules are small, so that BLAS gains little from its
+   * own threads; the modules must be distinct objects, and must not share any
+   * state (such as a random number generator; the layers that draw random
+   * numbers, like Dropout, use the global one).  This is not serialized.
+   */
+  bool Parallel() const { return parallel; }
+  //! Modify whether the passes of the modules run concurrently.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialize the layer.
    */
@@ -193,6 +205,9 @@ class AddMerge
   //! before merging the output.
   bool run;
 
+  //! Parameter which indicates if the modules run concurrently.
+  bool parallel;
+
   //! We need this to know whether we should delete the internally-held layers
   //! in the destructor.
   bool ownsLayers;
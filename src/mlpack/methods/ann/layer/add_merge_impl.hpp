@@ -19,6 +19,7 @@
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
+#include "../util/run_modules.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -27,7 +28,7 @@ template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 AddMerge<InputDataType, OutputDataType, CustomLayers...>::AddMerge(
     const bool model, const bool run) :
-    model(model), run(run), ownsLayers(!model)
+    model(model), run(run), parallel(false), ownsLayers(!model)
 {
   // Nothing to do here.
 }
@@ -36,7 +37,7 @@ template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 AddMerge<InputDataType, OutputDataType, CustomLayers...>::AddMerge(
     const bool model, const bool run, const bool ownsLayers) :
-    model(model), run(run), ownsLayers(ownsLayers)
+    model(model), run(run), parallel(false), ownsLayers(ownsLayers)
 {
   // Nothing to do here.
 }
@@ -60,12 +61,12 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Forward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
       boost::apply_visitor(ForwardVisitor(input,
           boost::apply_visitor(outputParameterVisitor, network[i])),
           network[i]);
-    }
+    });
   }
 
   output = boost::apply_visitor(outputParameterVisitor, network.front());
@@ -85,12 +86,12 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Backward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
       boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
           outputParameterVisitor, network[i]), gy,
           boost::apply_visitor(deltaVisitor, network[i])), network[i]);
-    }
+    });
 
     g = boost::apply_visitor(deltaVisitor, network[0]);
     for (size_t i = 1; i < network.size(); ++i)
@@ -127,10 +128,10 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Gradient(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
       boost::apply_visitor(GradientVisitor(input, error), network[i]);
-    }
+    });
   }
 }
 
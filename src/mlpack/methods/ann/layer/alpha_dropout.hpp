@@ -17,6 +17,7 @@
 #define MLPACK_METHODS_ANN_LAYER_ALPHA_DROPOUT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/dropout_mask.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -107,8 +108,13 @@ class AlphaDropout
   //! Value of alphaDash.
   double AlphaDash() const {return alphaDash; }
 
-  //! Get the mask.
-  OutputDataType const& Mask() const {return mask;}
+  //! Get the mask of the last forward pass (ones for the kept elements).
+  OutputDataType Mask() const
+  {
+    OutputDataType unpacked;
+    mask.Unpack(unpacked);
+    return unpacked;
+  }
 
   //! Modify the probability of setting a value to alphaDash. As
   //! 'a' and 'b' depend on 'ratio', modify them as well.
@@ -132,8 +138,8 @@ class AlphaDropout
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored mast object.
-  OutputDataType mask;
+  //! The mask of the last forward pass (one bit per element).
+  DropoutMask mask;
 
   //! The probability of setting a value to aplhaDash.
   double ratio;
@@ -99,40 +99,42 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
           " greater than 1 to fix the warning." << std::endl;
     }
 
-    // Input corresponds to output from convolution layer.
-    // Use a cube for simplicity.
-    arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
-        inputSize, size, batchSize, false, false);
-
-    // Initialize output to same size and values for convenience.
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        inputSize, size, batchSize, false, false);
-    outputTemp = inputTemp;
-
-    // Calculate mean and variance over all channels.
-    mean = arma::mean(arma::mean(inputTemp, 2), 0);
-    variance = arma::mean(arma::mean(arma::pow(
-        inputTemp.each_slice() - arma::repmat(mean,
-        inputSize, 1), 2), 2), 0);
-
-    outputTemp.each_slice() -= arma::repmat(mean, inputSize, 1);
-
-    // Used in backward propagation.
-    inputMean.set_size(arma::size(inputTemp));
-    inputMean = outputTemp;
-
-    // Normalize output.
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(variance,
-        inputSize, 1) + eps);
-
-    // Re-used in backward propagation.
-    normalized.set_size(arma::size(inputTemp));
-    normalized = outputTemp;
-
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        inputSize, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        inputSize, 1);
+    // The input corresponds to the output of a convolution layer: the
+    // values of channel c of a point are the rows
+    // [c * inputSize, (c + 1) * inputSize) of its column.  Each channel is
+    // handled in one pass for the statistics, and one pass that normalizes,
+    // scales and shifts.
+    mean.set_size(1, size);
+    variance.set_size(1, size);
+    normalized.set_size(inputSize, size, batchSize);
+
+    #pragma omp parallel for
+    for (omp_size_t c = 0; c < (omp_size_t) size; ++c)
+    {
+      NormalizationStatistics statistics;
+      for (size_t b = 0; b < batchSize; ++b)
+        statistics.Add(input.colptr(b) + c * inputSize, inputSize);
+
+      mean(c) = statistics.Mean();
+      variance(c) = statistics.Variance();
+
+      const double channelMean = mean(c);
+      const double stdInv = 1.0 / std::sqrt(variance(c) + eps);
+      const double scale = gamma(c);
+      const double shift = beta(c);
+      for (size_t b = 0; b < batchSize; ++b)
+      {
+        const eT* x = input.colptr(b) + c * inputSize;
+        eT* y = output.colptr(b) + c * inputSize;
+        double* xHat = normalized.slice(b).colptr(c);
+        for (size_t r = 0; r < inputSize; ++r)
+        {
+          // Re-used in backward propagation.
+          xHat[r] = (x[r] - channelMean) * stdInv;
+          y[r] = scale * xHat[r] + shift;
+        }
+      }
+    }
 
     count += 1;
     averageFactor = average ? 1.0 / count : momentum;
@@ -150,19 +152,21 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
   }
   else
   {
-    // Normalize the input and scale and shift the output.
-    output = input;
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        input.n_rows / size, size, batchSize, false, false);
-
-    outputTemp.each_slice() -= arma::repmat(runningMean.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(runningVariance.t(),
-        input.n_rows / size, 1) + eps);
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        input.n_rows / size, 1);
+    // Normalize the input and scale and shift the output, as one affine
+    // function for each channel.
+    #pragma omp parallel for
+    for (omp_size_t c = 0; c < (omp_size_t) size; ++c)
+    {
+      const double scale = gamma(c) / std::sqrt(runningVariance(c) + eps);
+      const double shift = beta(c) - runningMean(c) * scale;
+      for (size_t b = 0; b < batchSize; ++b)
+      {
+        const eT* x = input.colptr(b) + c * inputSize;
+        eT* y = output.colptr(b) + c * inputSize;
+        for (size_t r = 0; r < inputSize; ++r)
+          y[r] = scale * x[r] + shift;
+      }
+    }
   }
 }
 
@@ -173,35 +177,46 @@ void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
+  const size_t batchSize = input.n_cols;
+  const size_t inputSize = input.n_rows / size;
   g.set_size(arma::size(input));
-  arma::cube gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-  arma::cube gTemp(const_cast<arma::Mat<eT>&>(g).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-
-  // Step 1: dl / dxhat.
-  arma::cube norm = gyTemp.each_slice() % arma::repmat(gamma.t(),
-      input.n_rows / size, 1);
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  arma::mat temp = arma::sum(norm % inputMean, 2);
-  arma::mat vars = temp % arma::repmat(arma::pow(stdInv, 3),
-      input.n_rows / size, 1) * -0.5;
-
-  // Step 3: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  gTemp = (norm.each_slice() % arma::repmat(stdInv,
-      input.n_rows / size, 1) +
-      (inputMean.each_slice() % vars * 2)) / input.n_cols;
-
-  // Step 4: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  arma::mat normTemp = arma::sum(norm.each_slice() %
-      arma::repmat(-stdInv, input.n_rows / size, 1) , 2) /
-      input.n_cols;
-  gTemp.each_slice() += normTemp;
+
+  // With n = dl / dxhat = gy * gamma, the gradient is
+  // stdInv * (n - xhat * sum(n * xhat) - sum(n)) / m, where the sums are over
+  // the points of the batch; the sums are computed in one pass over each
+  // channel, and the gradient in a second one.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) size; ++c)
+  {
+    const double stdInv = 1.0 / std::sqrt(variance(c) + eps);
+    const double scale = gamma(c);
+
+    arma::vec normXHatSum(inputSize, arma::fill::zeros);
+    arma::vec normSum(inputSize, arma::fill::zeros);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const eT* dy = gy.colptr(b) + c * inputSize;
+      const double* xHat = normalized.slice(b).colptr(c);
+      for (size_t r = 0; r < inputSize; ++r)
+      {
+        const double norm = dy[r] * scale;
+        normXHatSum[r] += norm * xHat[r];
+        normSum[r] += norm;
+      }
+    }
+
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const eT* dy = gy.colptr(b) + c * inputSize;
+      const double* xHat = normalized.slice(b).colptr(c);
+      eT* dx = g.colptr(b) + c * inputSize;
+      for (size_t r = 0; r < inputSize; ++r)
+      {
+        dx[r] = stdInv * (dy[r] * scale - xHat[r] * normXHatSum[r] -
+            normSum[r]) / batchSize;
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -211,17 +226,28 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
+  const size_t inputSize = error.n_rows / size;
   gradient.set_size(size + size, 1);
-  arma::cube errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
-      error.n_rows / size, size, error.n_cols, false, false);
 
-  // Step 5: dl / dy * xhat.
-  arma::mat temp = arma::sum(arma::sum(normalized % errorTemp, 0), 2);
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = temp.t();
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) size; ++c)
+  {
+    // Step 5: dl / dy * xhat, and step 6: dl / dy.
+    double gammaGradient = 0.0, betaGradient = 0.0;
+    for (size_t b = 0; b < error.n_cols; ++b)
+    {
+      const eT* e = error.colptr(b) + c * inputSize;
+      const double* xHat = normalized.slice(b).colptr(c);
+      for (size_t r = 0; r < inputSize; ++r)
+      {
+        gammaGradient += xHat[r] * e[r];
+        betaGradient += e[r];
+      }
+    }
 
-  // Step 6: dl / dy.
-  temp = arma::sum(arma::sum(errorTemp, 0), 2);
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) = temp.t();
+    gradient(c) = gammaGradient;
+    gradient(size + c) = betaGradient;
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
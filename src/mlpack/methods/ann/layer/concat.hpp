@@ -172,6 +172,18 @@ class Concat
   //! Modify the value of run parameter.
   bool& Run() { return run; }
 
+  /**
+   * Get whether the Forward(), Backward() and Gradient() passes of the modules
+   * run concurrently on the OpenMP thread pool (false by default).  This is
+   * worth it when the modules are small, so that BLAS gains little from its
+   * own threads; the modules must be distinct objects, and must not share any
+   * state (such as a random number generator; the layers that draw random
+   * numbers, like Dropout, use the global one).  This is not serialized.
+   */
+  bool Parallel() const { return parallel; }
+  //! Modify whether the passes of the modules run concurrently.
+  bool& Parallel() { return parallel; }
+
   arma::mat const& InputParameter() const { return inputParameter; }
   //! Modify the input parameter.
   arma::mat& InputParameter() { return inputParameter; }
@@ -204,6 +216,26 @@ class Concat
   void serialize(Archive& ar,  const uint32_t /* version */);
 
  private:
+  /**
+   * Get the first row of the output of each module in the output of the
+   * layer, followed by the number of rows of the output of the layer.
+   */
+  std::vector<size_t> ModuleRowCounts() const;
+
+  /**
+   * Get the rows of the given error that correspond to the module whose
+   * output starts at row rowCount and has the given number of rows.  If the
+   * module is the only one, the result is an alias of the error; otherwise the
+   * rows are copied into the front of the given buffer (which is enlarged if
+   * needed, so that it is allocated once for all the modules), and the result
+   * is an alias of the buffer.
+   */
+  template<typename eT>
+  arma::Mat<eT> ModuleRows(const arma::Mat<eT>& error,
+                           const size_t rowCount,
+                           const size_t rows,
+                           arma::Mat<eT>& buffer) const;
+
   //! Parameter which indicates the input size of modules.
   arma::Row<size_t> inputSize;
 
@@ -220,6 +252,9 @@ class Concat
   //! before merging the output.
   bool run;
 
+  //! Parameter which indicates if the modules run concurrently.
+  bool parallel;
+
   //! Parameter to store channels.
   size_t channels;
 
@@ -19,6 +19,7 @@
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
+#include "../util/run_modules.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -31,6 +32,7 @@ Concat<InputDataType, OutputDataType, CustomLayers...>::Concat(
     useAxis(false),
     model(model),
     run(run),
+    parallel(false),
     channels(1)
 {
   weights.set_size(0, 0);
@@ -47,7 +49,8 @@ Concat<InputDataType, OutputDataType, CustomLayers...>::Concat(
     axis(axis),
     useAxis(true),
     model(model),
-    run(run)
+    run(run),
+    parallel(false)
 {
   weights.set_size(0, 0);
 
@@ -106,31 +109,40 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
       boost::apply_visitor(ForwardVisitor(input,
           boost::apply_visitor(outputParameterVisitor, network[i])),
           network[i]);
-    }
+    });
   }
 
-  output = boost::apply_visitor(outputParameterVisitor, network.front());
+  // Allocate the output once, and write the output of each layer directly into
+  // its rows.
+  size_t outRows = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    outRows += boost::apply_visitor(outputParameterVisitor, network[i]).n_rows;
+  const size_t outCols = boost::apply_visitor(outputParameterVisitor,
+      network.front()).n_cols;
+  output.set_size(outRows, outCols);
 
-  // Reshape output to incorporate the channels.
-  output.reshape(output.n_rows / channels, output.n_cols * channels);
+  // View the output with the channels stacked horizontally, so that the
+  // outputs of the layers are concatenated along the given axis.
+  arma::Mat<eT> outputTmp(output.memptr(), outRows / channels,
+      outCols * channels, false, true);
 
-  for (size_t i = 1; i < network.size(); ++i)
+  size_t rowCount = 0;
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    arma::Mat<eT> out = boost::apply_visitor(outputParameterVisitor,
+    const arma::mat& out = boost::apply_visitor(outputParameterVisitor,
         network[i]);
+    const arma::Mat<eT> outTmp((eT*) out.memptr(), out.n_rows / channels,
+        out.n_cols * channels, false, true);
 
-    out.reshape(out.n_rows / channels, out.n_cols * channels);
-
-    // Vertically concatentate output from each layer.
-    output = arma::join_cols(output, out);
+    outputTmp.rows(rowCount / channels, (rowCount + out.n_rows) / channels - 1)
+        = outTmp;
+    rowCount += out.n_rows;
   }
-  // Reshape output to its original shape.
-  output.reshape(output.n_rows * channels, output.n_cols / channels);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -139,28 +151,24 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  size_t rowCount = 0;
   if (run)
   {
-    arma::Mat<eT> delta;
-    arma::Mat<eT> gyTmp(((arma::Mat<eT>&) gy).memptr(), gy.n_rows / channels,
-        gy.n_cols * channels, false, false);
-    for (size_t i = 0; i < network.size(); ++i)
-    {
-      // Use rows from the error corresponding to the output from each layer.
-      size_t rows = boost::apply_visitor(
-          outputParameterVisitor, network[i]).n_rows;
+    // Use rows from the error corresponding to the output from each layer.
+    const std::vector<size_t> rowCounts = ModuleRowCounts();
 
+    // When the layers run in parallel, each one has its own buffer.
+    std::vector<arma::Mat<eT>> buffers(parallel ? network.size() : 1);
+    RunModules(network.size(), parallel, [&](const size_t i)
+    {
       // Extract from gy the parameters for the i-th network.
-      delta = gyTmp.rows(rowCount / channels, (rowCount + rows) / channels - 1);
-      delta.reshape(delta.n_rows * channels, delta.n_cols / channels);
+      const arma::Mat<eT> delta = ModuleRows(gy, rowCounts[i],
+          rowCounts[i + 1] - rowCounts[i], buffers[parallel ? i : 0]);
 
       boost::apply_visitor(BackwardVisitor(
           boost::apply_visitor(outputParameterVisitor,
           network[i]), delta,
           boost::apply_visitor(deltaVisitor, network[i])), network[i]);
-      rowCount += rows;
-    }
+    });
 
     g = boost::apply_visitor(deltaVisitor, network[0]);
     for (size_t i = 1; i < network.size(); ++i)
@@ -192,13 +200,9 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
   }
   rows = boost::apply_visitor(outputParameterVisitor, network[index]).n_rows;
 
-  // Reshape gy to extract the i-th layer gy.
-  arma::Mat<eT> gyTmp(((arma::Mat<eT>&) gy).memptr(), gy.n_rows / channels,
-      gy.n_cols * channels, false, false);
-
-  arma::Mat<eT> delta = gyTmp.rows(rowCount / channels, (rowCount + rows) /
-      channels - 1);
-  delta.reshape(delta.n_rows * channels, delta.n_cols / channels);
+  // Extract the i-th layer gy.
+  arma::Mat<eT> buffer;
+  const arma::Mat<eT> delta = ModuleRows(gy, rowCount, rows, buffer);
 
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network[index]), delta,
@@ -217,23 +221,16 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
 {
   if (run)
   {
-    size_t rowCount = 0;
-    // Reshape error to extract the i-th layer error.
-    arma::Mat<eT> errorTmp(((arma::Mat<eT>&) error).memptr(),
-        error.n_rows / channels, error.n_cols * channels, false, false);
-    for (size_t i = 0; i < network.size(); ++i)
+    const std::vector<size_t> rowCounts = ModuleRowCounts();
+    std::vector<arma::Mat<eT>> buffers(parallel ? network.size() : 1);
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
-      size_t rows = boost::apply_visitor(
-          outputParameterVisitor, network[i]).n_rows;
-
       // Extract from error the parameters for the i-th network.
-      arma::Mat<eT> err = errorTmp.rows(rowCount / channels, (rowCount + rows) /
-          channels - 1);
-      err.reshape(err.n_rows * channels, err.n_cols / channels);
+      const arma::Mat<eT> err = ModuleRows(error, rowCounts[i],
+          rowCounts[i + 1] - rowCounts[i], buffers[parallel ? i : 0]);
 
       boost::apply_visitor(GradientVisitor(input, err), network[i]);
-      rowCount += rows;
-    }
+    });
   }
 }
 
@@ -255,15 +252,57 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   size_t rows = boost::apply_visitor(
       outputParameterVisitor, network[index]).n_rows;
 
-  arma::Mat<eT> errorTmp(((arma::Mat<eT>&) error).memptr(),
-      error.n_rows / channels, error.n_cols * channels, false, false);
-  arma::Mat<eT> err = errorTmp.rows(rowCount / channels, (rowCount + rows) /
-      channels - 1);
-  err.reshape(err.n_rows * channels, err.n_cols / channels);
+  arma::Mat<eT> buffer;
+  const arma::Mat<eT> err = ModuleRows(error, rowCount, rows, buffer);
 
   boost::apply_visitor(GradientVisitor(input, err), network[index]);
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+std::vector<size_t> Concat<InputDataType, OutputDataType, CustomLayers...>::
+ModuleRowCounts() const
+{
+  std::vector<size_t> rowCounts(network.size() + 1, 0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    rowCounts[i + 1] = rowCounts[i] + boost::apply_visitor(
+        outputParameterVisitor, network[i]).n_rows;
+  }
+
+  return rowCounts;
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+template<typename eT>
+arma::Mat<eT> Concat<InputDataType, OutputDataType, CustomLayers...>::
+ModuleRows(const arma::Mat<eT>& error,
+           const size_t rowCount,
+           const size_t rows,
+           arma::Mat<eT>& buffer) const
+{
+  if (rows == error.n_rows)
+  {
+    return arma::Mat<eT>((eT*) error.memptr(), error.n_rows, error.n_cols,
+        false, true);
+  }
+
+  if (buffer.n_elem < rows * error.n_cols)
+    buffer.set_size(rows * error.n_cols, 1);
+
+  // The rows of the module are not contiguous, so copy them, with the channels
+  // stacked horizontally.
+  const arma::Mat<eT> errorTmp((eT*) error.memptr(), error.n_rows / channels,
+      error.n_cols * channels, false, true);
+  arma::Mat<eT> blockTmp(buffer.memptr(), rows / channels,
+      error.n_cols * channels, false, true);
+  blockTmp = errorTmp.rows(rowCount / channels, (rowCount + rows) / channels -
+      1);
+
+  return arma::Mat<eT>(buffer.memptr(), rows, error.n_cols, false, true);
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename Archive>
@@ -51,7 +51,9 @@ double ConcatPerformance<
   double output = 0;
   for (size_t i = 0; i < input.n_elem; i+= elements)
   {
-    arma::mat subInput = input.submat(i, 0, i + elements - 1, 0);
+    // Each block of the input is contiguous, so use it in place.
+    const arma::Mat<eT> subInput((eT*) input.memptr() + i, elements, 1, false,
+        true);
     output += outputLayer.Forward(subInput, target);
   }
 
@@ -75,20 +77,23 @@ void ConcatPerformance<
 {
   const size_t elements = input.n_elem / inSize;
 
-  arma::mat subInput = input.submat(0, 0, elements - 1, 0);
-  arma::mat subOutput;
+  const arma::Mat<eT> firstInput((eT*) input.memptr(), elements, 1, false,
+      true);
+  arma::Mat<eT> firstOutput;
 
-  outputLayer.Backward(subInput, target, subOutput);
+  outputLayer.Backward(firstInput, target, firstOutput);
 
-  output = arma::zeros(subOutput.n_elem, inSize);
-  output.col(0) = subOutput;
+  output.set_size(firstOutput.n_elem, inSize);
+  output.col(0) = arma::vectorise(firstOutput);
 
-  for (size_t i = elements, j = 0; i < input.n_elem; i+= elements, ++j)
+  // Write the error of each other block directly into its column.
+  for (size_t i = elements, j = 1; i < input.n_elem; i+= elements, ++j)
   {
-    subInput = input.submat(i, 0, i + elements - 1, 0);
+    const arma::Mat<eT> subInput((eT*) input.memptr() + i, elements, 1, false,
+        true);
+    arma::Mat<eT> subOutput(output.colptr(j), firstOutput.n_rows,
+        firstOutput.n_cols, false, true);
     outputLayer.Backward(subInput, target, subOutput);
-
-    output.col(j) = subOutput;
   }
 }
 
@@ -15,9 +15,11 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
+#include <mlpack/methods/ann/convolution_rules/cached_fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -325,6 +327,47 @@ class Convolution
    */
   void InitializeSamePadding();
 
+  /*
+   * Ordinary feed forward pass using im2col (for Im2ColConvolution).
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /*
+   * Ordinary feed forward pass through fft with the cached spectra of the
+   * filters (for CachedFFTConvolution).  The spectra are computed again only
+   * when the weights or the size of the input changed since the last pass.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void ForwardCachedFFT(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /*
+   * Ordinary feed backward pass using col2im (for Im2ColConvolution).
+   *
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient using im2col (for Im2ColConvolution).
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void GradientIm2Col(const arma::Mat<eT>& input,
+                      const arma::Mat<eT>& error,
+                      arma::Mat<eT>& gradient);
+
   /*
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -420,6 +463,21 @@ class Convolution
   //! Locally-stored transformed gradient parameter.
   arma::cube gradientTemp;
 
+  //! Locally-stored input patches for Im2ColConvolution.
+  arma::mat patches;
+
+  //! Locally-stored filter spectra for CachedFFTConvolution.
+  arma::cx_cube filterSpectra;
+
+  //! Locally-stored weights that the filter spectra were computed from.
+  arma::cube spectraWeight;
+
+  //! Locally-stored padded input width that the spectra were computed for.
+  size_t spectraWidth;
+
+  //! Locally-stored padded input height that the spectra were computed for.
+  size_t spectraHeight;
+
   //! Locally-stored padding layer.
   ann::Padding<> padding;
 
@@ -115,7 +115,9 @@ Convolution<
     inputWidth(inputWidth),
     inputHeight(inputHeight),
     outputWidth(0),
-    outputHeight(0)
+    outputHeight(0),
+    spectraWidth(0),
+    spectraHeight(0)
 {
   weights.set_size(WeightSize(), 1);
 
@@ -175,6 +177,17 @@ void Convolution<
 >::Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
   batchSize = input.n_cols;
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    ForwardIm2Col(input, output);
+    return;
+  }
+  else if (IsCachedFFTConvolution<ForwardConvolutionRule>::value)
+  {
+    ForwardCachedFFT(input, output);
+    return;
+  }
+
   arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
@@ -252,6 +265,12 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    BackwardIm2Col(gy, g);
+    return;
+  }
+
   arma::cube mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
 
@@ -309,6 +328,15 @@ void Convolution<
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
+  // The forward pass with im2col does not store the padded input, so the
+  // gradient must be computed with im2col too.
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value ||
+      IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    GradientIm2Col(input, error, gradient);
+    return;
+  }
+
   arma::cube mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
   arma::cube inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
@@ -409,6 +437,194 @@ void Convolution<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const size_t wConv = ConvOutSize(inputWidth, kernelWidth, strideWidth,
+      padWLeft, padWRight);
+  const size_t hConv = ConvOutSize(inputHeight, kernelHeight, strideHeight,
+      padHTop, padHBottom);
+
+  // Column o of the weight matrix holds all the filters of output map o.
+  const arma::Mat<eT> weightMat(weights.memptr(),
+      kernelWidth * kernelHeight * inSize, outSize, false, true);
+
+  output.set_size(wConv * hConv * outSize, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const arma::Cube<eT> inputSlices(const_cast<eT*>(input.colptr(i)),
+        inputWidth, inputHeight, inSize, false, true);
+    Im2ColConvolution<>::Im2Col(inputSlices, kernelWidth, kernelHeight,
+        strideWidth, strideHeight, padWLeft, padHTop, wConv, hConv, patches);
+
+    // Each column of the result is one output map of this point.
+    arma::Mat<eT> outputMaps(output.colptr(i), wConv * hConv, outSize, false,
+        true);
+    outputMaps = patches * weightMat;
+    outputMaps.each_row() += bias.t();
+  }
+
+  outputWidth = wConv;
+  outputHeight = hConv;
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardCachedFFT(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const size_t paddedWidth = inputWidth + padWLeft + padWRight;
+  const size_t paddedHeight = inputHeight + padHTop + padHBottom;
+  const bool padded = (paddedWidth != inputWidth ||
+      paddedHeight != inputHeight);
+
+  // The weights are updated in place by the optimizer, so they are compared
+  // with the weights that the spectra were computed from; this is much
+  // cheaper than the transforms.
+  if (spectraWidth != paddedWidth || spectraHeight != paddedHeight ||
+      spectraWeight.n_elem != weight.n_elem ||
+      !std::equal(weight.begin(), weight.end(), spectraWeight.begin()))
+  {
+    ForwardConvolutionRule::FilterSpectra(weight, paddedWidth, paddedHeight,
+        filterSpectra);
+    spectraWeight = weight;
+    spectraWidth = paddedWidth;
+    spectraHeight = paddedHeight;
+  }
+
+  const size_t wConv = ConvOutSize(inputWidth, kernelWidth, strideWidth,
+      padWLeft, padWRight);
+  const size_t hConv = ConvOutSize(inputHeight, kernelHeight, strideHeight,
+      padHTop, padHBottom);
+
+  output.set_size(wConv * hConv * outSize, batchSize);
+  if (padded)
+    inputPaddedTemp.set_size(paddedWidth, paddedHeight, inSize);
+
+  arma::Cube<eT> outputMaps;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const arma::Cube<eT> inputSlices(const_cast<eT*>(input.colptr(i)),
+        inputWidth, inputHeight, inSize, false, true);
+    if (padded)
+    {
+      for (size_t inMap = 0; inMap < inSize; ++inMap)
+        padding.Forward(inputSlices.slice(inMap), inputPaddedTemp.slice(inMap));
+    }
+
+    ForwardConvolutionRule::Convolution(padded ? inputPaddedTemp : inputSlices,
+        filterSpectra, kernelWidth, kernelHeight, outputMaps, strideWidth,
+        strideHeight);
+
+    arma::Mat<eT> outputSlices(output.colptr(i), wConv * hConv, outSize,
+        false, true);
+    outputSlices = arma::Mat<eT>(outputMaps.memptr(), wConv * hConv, outSize,
+        false, true);
+    outputSlices.each_row() += bias.t();
+  }
+
+  outputWidth = wConv;
+  outputHeight = hConv;
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const arma::Mat<eT> weightMat(weights.memptr(),
+      kernelWidth * kernelHeight * inSize, outSize, false, true);
+
+  g.zeros(inputWidth * inputHeight * inSize, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const arma::Mat<eT> errorMaps(const_cast<eT*>(gy.colptr(i)),
+        outputWidth * outputHeight, outSize, false, true);
+    patches = errorMaps * weightMat.t();
+
+    arma::Cube<eT> gSlices(g.colptr(i), inputWidth, inputHeight, inSize,
+        false, true);
+    Im2ColConvolution<>::Col2Im(patches, kernelWidth, kernelHeight,
+        strideWidth, strideHeight, padWLeft, padHTop, outputWidth,
+        outputHeight, gSlices);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientIm2Col(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  gradient.zeros(weights.n_elem, 1);
+  arma::Mat<eT> weightGradient(gradient.memptr(),
+      kernelWidth * kernelHeight * inSize, outSize, false, true);
+  arma::Col<eT> biasGradient(gradient.memptr() + weight.n_elem, outSize,
+      false, true);
+
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const arma::Cube<eT> inputSlices(const_cast<eT*>(input.colptr(i)),
+        inputWidth, inputHeight, inSize, false, true);
+    Im2ColConvolution<>::Im2Col(inputSlices, kernelWidth, kernelHeight,
+        strideWidth, strideHeight, padWLeft, padHTop, outputWidth,
+        outputHeight, patches);
+
+    const arma::Mat<eT> errorMaps(const_cast<eT*>(error.colptr(i)),
+        outputWidth * outputHeight, outSize, false, true);
+    weightGradient += patches.t() * errorMaps;
+    biasGradient += arma::sum(errorMaps, 0).t();
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
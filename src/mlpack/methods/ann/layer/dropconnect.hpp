@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_ANN_LAYER_DROPCONNECT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/dropout_mask.hpp>
 
 #include "layer_types.hpp"
 #include "add_merge.hpp"
@@ -178,8 +179,8 @@ class DropConnect
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored mask object.
-  OutputDataType mask;
+  //! The mask of the weights of the last forward pass (one bit per weight).
+  DropoutMask mask;
 
   //! If true dropout and scaling is disabled, see notes above.
   bool deterministic;
@@ -67,10 +67,10 @@ void DropConnect<InputDataType, OutputDataType>::Forward(
 
     // Scale with input / (1 - ratio) and set values to zero with
     // probability ratio.
-    mask = arma::randu<arma::Mat<eT> >(denoise.n_rows, denoise.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
+    mask.Generate(denoise.n_rows, denoise.n_cols, ratio);
 
-    arma::mat tmp = denoise % mask;
+    arma::mat tmp;
+    mask.Apply(denoise, tmp, 1.0);
     boost::apply_visitor(ParametersSetVisitor(tmp), baseLayer);
 
     boost::apply_visitor(ForwardVisitor(input, output), baseLayer);
@@ -92,10 +92,9 @@ void Dropout<InputDataType, OutputDataType>::Forward(
   else
   {
     // Scale with input / (1 - ratio) and set values to zero with probability
-    // 'ratio'.
-    mask = arma::randu<arma::Mat<eT> >(input.n_rows, input.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
-    output = input % mask * scale;
+    // 'ratio', in one pass.
+    mask.Generate(input.n_rows, input.n_cols, ratio);
+    mask.Apply(input, output, (eT) scale);
   }
 }
 
@@ -106,7 +105,7 @@ void Dropout<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
-  g = gy % mask * scale;
+  mask.Apply(gy, g, (eT) scale);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -193,49 +193,48 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
-  gate.cols(forwardStep, forwardStep + batchStep) = input2GateWeight * input +
-      output2GateWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  gate.cols(forwardStep, forwardStep + batchStep).each_col() += input2GateBias;
-
-  arma::subview<double> sigmoidOut = gateActivation.cols(forwardStep,
-      forwardStep + batchStep);
-  FastSigmoid(
-      gate.submat(0, forwardStep, 3 * outSize - 1, forwardStep + batchStep),
-      sigmoidOut);
-
-  stateActivation.cols(forwardStep, forwardStep + batchStep) = arma::tanh(
-      gate.submat(3 * outSize, forwardStep, 4 * outSize - 1,
-      forwardStep + batchStep));
-
-  // Update the cell: cmul1 + cmul2
-  // where cmul1 is input gate * hidden state and
-  // cmul2 is forget gate * cell (prevCell).
-  if (forwardStep == 0)
+  // Compute all four gate blocks of the current time step with one matrix
+  // multiplication for the input and one accumulated in place for the previous
+  // output; the columns of the step are stored contiguously, so the results
+  // are written straight into the preallocated workspace.
+  OutputDataType stepGate(gate.colptr(forwardStep), 4 * outSize, batchSize,
+      false, true);
+  const OutputDataType prevStepOutput(outParameter.colptr(forwardStep),
+      outSize, batchSize, false, true);
+  stepGate = input2GateWeight * input;
+  stepGate += output2GateWeight * prevStepOutput;
+
+  // Apply the nonlinearities and update the cell and the output in a single
+  // element-wise pass: the cell is cmul1 + cmul2, where cmul1 is input gate *
+  // hidden state and cmul2 is forget gate * cell (prevCell).
+  for (size_t j = forwardStep; j <= forwardStep + batchStep; ++j)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep);
+    ElemType* gateCol = gate.colptr(j);
+    ElemType* gateActivationCol = gateActivation.colptr(j);
+    ElemType* stateActivationCol = stateActivation.colptr(j);
+    ElemType* cellCol = cell.colptr(j);
+    ElemType* cellActivationCol = cellActivation.colptr(j);
+    ElemType* outCol = outParameter.colptr(j + batchSize);
+    const ElemType* prevCellCol = (forwardStep == 0) ? NULL :
+        cell.colptr(j - batchSize);
+
+    for (size_t i = 0; i < 4 * outSize; ++i)
+      gateCol[i] += input2GateBias[i];
+
+    for (size_t i = 0; i < 3 * outSize; ++i)
+      gateActivationCol[i] = FastSigmoid(gateCol[i]);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      stateActivationCol[i] = std::tanh(gateCol[3 * outSize + i]);
+      cellCol[i] = gateActivationCol[i] * stateActivationCol[i];
+      if (prevCellCol)
+        cellCol[i] += gateActivationCol[2 * outSize + i] * prevCellCol[i];
+
+      cellActivationCol[i] = std::tanh(cellCol[i]);
+      outCol[i] = cellActivationCol[i] * gateActivationCol[outSize + i];
+    }
   }
-  else
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep) +
-        gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
-        forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-  }
-
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
-
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) = cellActivation.cols(
-      forwardStep, forwardStep + batchStep) % gateActivation.submat(
-      outSize, forwardStep, 2 * outSize - 1, forwardStep + batchStep);
 
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
@@ -247,6 +246,54 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::Step(const InputDataType& input,
+                                                   OutputDataType& output,
+                                                   OutputDataType& state)
+{
+  if (state.is_empty())
+  {
+    state.zeros(2 * outSize, input.n_cols);
+  }
+  else if (state.n_rows != 2 * outSize || state.n_cols != input.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "FastLSTM<>::Step(): the state has " << state.n_rows << " rows and "
+        << state.n_cols << " columns, but " << 2 * outSize << " rows and "
+        << input.n_cols << " columns (one per stream) are expected!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Compute the four gate blocks of all streams, then the cell and the output
+  // of each stream, as Forward() does.
+  const OutputDataType prevOutput = state.rows(0, outSize - 1);
+  OutputDataType stepGate = input2GateWeight * input;
+  stepGate += output2GateWeight * prevOutput;
+
+  output.set_size(outSize, input.n_cols);
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    ElemType* gateCol = stepGate.colptr(j);
+    ElemType* stateCol = state.colptr(j);
+    ElemType* outCol = output.colptr(j);
+
+    for (size_t i = 0; i < 4 * outSize; ++i)
+      gateCol[i] += input2GateBias[i];
+
+    for (size_t i = 0; i < 3 * outSize; ++i)
+      gateCol[i] = FastSigmoid(gateCol[i]);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType cell = gateCol[i] * std::tanh(gateCol[3 * outSize + i]) +
+          gateCol[2 * outSize + i] * stateCol[outSize + i];
+      outCol[i] = std::tanh(cell) * gateCol[outSize + i];
+      stateCol[i] = outCol[i];
+      stateCol[outSize + i] = cell;
+    }
+  }
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename ErrorType, typename GradientType>
 void FastLSTM<InputDataType, OutputDataType>::Backward(
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_GROUPNORM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/normalization_statistics.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -190,12 +191,6 @@ class GroupNorm
 
   //! Locally-stored normalized input.
   OutputDataType normalized;
-
-  //! Locally-stored temp matrix.
-  OutputDataType temp;
-
-  //! Locally-stored zero mean input.
-  OutputDataType inputMean;
 }; // class GroupNorm
 
 } // namespace ann
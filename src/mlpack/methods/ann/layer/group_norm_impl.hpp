@@ -66,40 +66,43 @@ template<typename eT>
 void GroupNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  if (output.is_empty())
-    output.set_size(input.n_rows / groupCount, input.n_cols * groupCount);
-
   assert(size % groupCount == 0);
   assert(input.n_rows % size == 0);
 
-  arma::mat reshapedInput(const_cast<arma::Mat<eT>&>(input).memptr(),
-      input.n_rows / groupCount, input.n_cols * groupCount, false, false);
-
-  mean = arma::mean(reshapedInput, 0);
-  variance = arma::var(reshapedInput, 1, 0);
-
-  // Normalize the input.
-  output = reshapedInput.each_row() - mean;
-  inputMean = output;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  output.reshape(input.n_rows, input.n_cols);
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  arma::mat expandedGamma, expandedBeta;
-  expandedGamma.set_size(input.n_rows, 1);
-  expandedBeta.set_size(input.n_rows, 1);
-
-  for (size_t r = 0; r < input.n_rows; ++r)
+  // Each point has groupCount groups of groupSize consecutive elements, so
+  // group k of all the points is elements [k * groupSize, (k + 1) * groupSize)
+  // of the input.
+  const size_t groupSize = input.n_rows / groupCount;
+  const size_t groups = input.n_cols * groupCount;
+  mean.set_size(1, groups);
+  variance.set_size(1, groups);
+  normalized.set_size(arma::size(input));
+  output.set_size(arma::size(input));
+
+  // Each group is normalized in one pass for the statistics, and one pass
+  // that normalizes, scales and shifts.
+  #pragma omp parallel for
+  for (omp_size_t k = 0; k < (omp_size_t) groups; ++k)
   {
-    expandedGamma(r) = gamma(r * size / input.n_rows);
-    expandedBeta(r) = beta(r * size / input.n_rows);
+    const eT* x = input.memptr() + k * groupSize;
+    NormalizationStatistics statistics;
+    statistics.Add(x, groupSize);
+    mean(k) = statistics.Mean();
+    variance(k) = statistics.Variance();
+
+    const double groupMean = mean(k);
+    const double stdInv = 1.0 / std::sqrt(variance(k) + eps);
+    const size_t firstRow = (k % groupCount) * groupSize;
+    eT* y = output.memptr() + k * groupSize;
+    // Reused in the backward and gradient step.
+    double* xHat = normalized.memptr() + k * groupSize;
+    for (size_t j = 0; j < groupSize; ++j)
+    {
+      const size_t channel = (firstRow + j) * size / input.n_rows;
+      xHat[j] = (x[j] - groupMean) * stdInv;
+      y[j] = gamma(channel) * xHat[j] + beta(channel);
+    }
   }
-
-  // Scale and shift the output.
-  output.each_col() %= expandedGamma;
-  output.each_col() += expandedBeta;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -107,41 +110,36 @@ template<typename eT>
 void GroupNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  if (g.is_empty())
-    g.set_size(input.n_rows / groupCount, input.n_cols * groupCount);
-
-  arma::mat inputReshaped(const_cast<arma::Mat<eT>&>(input).memptr(),
-      input.n_rows / groupCount, input.n_cols * groupCount, false, false);
-
-  arma::mat expandedGamma;
-  expandedGamma.set_size(input.n_rows, 1);
-  for (size_t r = 0; r < input.n_rows; ++r)
+  const size_t groupSize = input.n_rows / groupCount;
+  const size_t groups = input.n_cols * groupCount;
+  g.set_size(arma::size(input));
+
+  // With n = dl / dxhat = gy * gamma, the gradient is
+  // stdInv * (n - xhat * sum(n * xhat) / m - sum(n) / m), where the sums are
+  // over the m elements of the group.
+  #pragma omp parallel for
+  for (omp_size_t k = 0; k < (omp_size_t) groups; ++k)
   {
-    expandedGamma(r) = gamma(r * size / input.n_rows);
+    const double stdInv = 1.0 / std::sqrt(variance(k) + eps);
+    const size_t firstRow = (k % groupCount) * groupSize;
+    const eT* dy = gy.memptr() + k * groupSize;
+    const double* xHat = normalized.memptr() + k * groupSize;
+
+    double normXHatSum = 0.0, normSum = 0.0;
+    for (size_t j = 0; j < groupSize; ++j)
+    {
+      const double norm = dy[j] * gamma((firstRow + j) * size / input.n_rows);
+      normXHatSum += norm * xHat[j];
+      normSum += norm;
+    }
+
+    eT* dx = g.memptr() + k * groupSize;
+    for (size_t j = 0; j < groupSize; ++j)
+    {
+      const double norm = dy[j] * gamma((firstRow + j) * size / input.n_rows);
+      dx[j] = stdInv * (norm - (xHat[j] * normXHatSum + normSum) / groupSize);
+    }
   }
-
-  // dl / dxhat.
-  const arma::mat norm = gy.each_col() % expandedGamma;
-
-  arma::mat normReshaped(const_cast<arma::Mat<eT>&>(norm).memptr(),
-      gy.n_rows / groupCount, gy.n_cols * groupCount, false, false);
-
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(normReshaped % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (normReshaped.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / inputReshaped.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += arma::sum(normReshaped.each_row() % -stdInv, 0) /
-      inputReshaped.n_rows;
-  g.reshape(input.n_rows, input.n_cols);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -153,22 +151,19 @@ void GroupNorm<InputDataType, OutputDataType>::Gradient(
 {
   assert(error.n_rows % size == 0);
   const size_t channelSize = error.n_rows / size;
-  temp = arma::sum(normalized % error, 1);
-  arma::mat tempReshaped((temp).memptr(),
-      channelSize, temp.n_elem / channelSize, false, false);
+  gradient.zeros(size + size, 1);
 
-  gradient.set_size(size + size, 1);
-
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(tempReshaped, 0).t();
-
-  temp = arma::sum(error, 1);
-  arma::mat tempErrorReshaped((temp).memptr(),
-      channelSize, temp.n_elem / channelSize, false, false);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(tempErrorReshaped, 0).t();
+  // Step 5: dl / dy * xhat, and step 6: dl / dy, in one pass.
+  for (size_t i = 0; i < error.n_cols; ++i)
+  {
+    const eT* e = error.colptr(i);
+    const double* xHat = normalized.colptr(i);
+    for (size_t r = 0; r < error.n_rows; ++r)
+    {
+      gradient(r / channelSize) += xHat[r] * e[r];
+      gradient(size + r / channelSize) += e[r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
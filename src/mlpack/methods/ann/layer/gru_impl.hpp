@@ -16,7 +16,8 @@
 // In case it hasn't yet been included.
 #include "gru.hpp"
 
-#include "../visitor/forward_visitor.hpp"
+#include "linear.hpp"
+#include "linear_no_bias.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
 
@@ -102,57 +103,73 @@ void GRU<InputDataType, OutputDataType>::Forward(
     gradIterator = outParameter.end();
   }
 
-  // Process the input linearly(zt, rt, ot).
-  boost::apply_visitor(ForwardVisitor(input,
-      boost::apply_visitor(outputParameterVisitor, input2GateModule)),
-      input2GateModule);
-
-  // Process the output(zt, rt) linearly.
-  boost::apply_visitor(ForwardVisitor(*prevOutput,
-      boost::apply_visitor(outputParameterVisitor, output2GateModule)),
+  // The gates are computed with one matrix multiplication for each of the
+  // input, the previous output and the reset previous output, written straight
+  // into the outputs of the modules, which are used by Backward() and
+  // Gradient().  Everything else is done in one element-wise pass.
+  Linear<>& input2Gate = *boost::get<Linear<>*>(input2GateModule);
+  LinearNoBias<>& output2Gate = *boost::get<LinearNoBias<>*>(
       output2GateModule);
+  LinearNoBias<>& outputHidden2Gate = *boost::get<LinearNoBias<>*>(
+      outputHidden2GateModule);
 
-  // Merge the outputs(zt and rt).
-  output = (boost::apply_visitor(outputParameterVisitor,
-      input2GateModule).submat(0, 0, 2 * outSize - 1, batchSize - 1) +
-      boost::apply_visitor(outputParameterVisitor, output2GateModule));
-
-  // Pass the first outSize through inputGate(it).
-  boost::apply_visitor(ForwardVisitor(output.submat(
-      0, 0, 1 * outSize - 1, batchSize - 1), boost::apply_visitor(
-      outputParameterVisitor, inputGateModule)), inputGateModule);
-
-  // Pass the second through forgetGate.
-  boost::apply_visitor(ForwardVisitor(output.submat(
-      1 * outSize, 0, 2 * outSize - 1, batchSize - 1),
-      boost::apply_visitor(outputParameterVisitor, forgetGateModule)),
+  arma::mat& inputGate = boost::apply_visitor(outputParameterVisitor,
+      inputGateModule);
+  arma::mat& forgetGate = boost::apply_visitor(outputParameterVisitor,
       forgetGateModule);
+  arma::mat& hiddenState = boost::apply_visitor(outputParameterVisitor,
+      hiddenStateModule);
+  inputGate.set_size(outSize, batchSize);
+  forgetGate.set_size(outSize, batchSize);
+  hiddenState.set_size(outSize, batchSize);
+  resetOutput.set_size(outSize, batchSize);
+  output.set_size(outSize, batchSize);
+
+  // Process the input linearly (zt, rt, ot), and the output (zt, rt).
+  arma::mat& inputGates = input2Gate.OutputParameter();
+  arma::mat& outputGates = output2Gate.OutputParameter();
+  inputGates = input2Gate.Weight() * input;
+  outputGates = output2Gate.Weight() * (*prevOutput);
+
+  const arma::mat& bias = input2Gate.Bias();
+  const arma::mat& prev = *prevOutput;
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    for (size_t i = 0; i < 2 * outSize; ++i)
+      inputGates(i, j) += bias(i);
 
-  arma::mat modInput = (boost::apply_visitor(outputParameterVisitor,
-      forgetGateModule) % *prevOutput);
+    // Pass the first outSize through inputGate(it), and the second through
+    // forgetGate.
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      inputGate(i, j) = LogisticFunction::Fn(inputGates(i, j) +
+          outputGates(i, j));
+      forgetGate(i, j) = LogisticFunction::Fn(inputGates(outSize + i, j) +
+          outputGates(outSize + i, j));
+      resetOutput(i, j) = forgetGate(i, j) * prev(i, j);
+    }
+  }
 
   // Pass that through the outputHidden2GateModule.
-  boost::apply_visitor(ForwardVisitor(modInput,
-      boost::apply_visitor(outputParameterVisitor, outputHidden2GateModule)),
-      outputHidden2GateModule);
-
-  // Merge for ot.
-  arma::mat outputH = boost::apply_visitor(outputParameterVisitor,
-      input2GateModule).submat(2 * outSize, 0, 3 * outSize - 1, batchSize - 1) +
-      boost::apply_visitor(outputParameterVisitor, outputHidden2GateModule);
-
-  // Pass it through hiddenGate.
-  boost::apply_visitor(ForwardVisitor(outputH,
-      boost::apply_visitor(outputParameterVisitor, hiddenStateModule)),
-      hiddenStateModule);
+  arma::mat& hiddenGates = outputHidden2Gate.OutputParameter();
+  hiddenGates = outputHidden2Gate.Weight() * resetOutput;
 
-  // Update the output (nextOutput): cmul1 + cmul2
-  // Where cmul1 is input gate * prevOutput and
-  // cmul2 is (1 - input gate) * hidden gate.
-  output = (boost::apply_visitor(outputParameterVisitor, inputGateModule)
-      % (*prevOutput - boost::apply_visitor(outputParameterVisitor,
-      hiddenStateModule))) + boost::apply_visitor(outputParameterVisitor,
-      hiddenStateModule);
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      // Merge for ot, and pass it through hiddenGate.
+      inputGates(2 * outSize + i, j) += bias(2 * outSize + i);
+      hiddenState(i, j) = std::tanh(inputGates(2 * outSize + i, j) +
+          hiddenGates(i, j));
+
+      // Update the output (nextOutput): cmul1 + cmul2
+      // Where cmul1 is input gate * prevOutput and
+      // cmul2 is (1 - input gate) * hidden gate.
+      output(i, j) = inputGate(i, j) * (prev(i, j) - hiddenState(i, j)) +
+          hiddenState(i, j);
+    }
+  }
 
   forwardStep++;
   if (forwardStep == rho)
@@ -191,6 +208,67 @@ void GRU<InputDataType, OutputDataType>::Forward(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::Step(const InputDataType& input,
+                                              OutputDataType& output,
+                                              OutputDataType& state)
+{
+  if (state.is_empty())
+  {
+    state.zeros(outSize, input.n_cols);
+  }
+  else if (state.n_rows != outSize || state.n_cols != input.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "GRU<>::Step(): the state has " << state.n_rows << " rows and "
+        << state.n_cols << " columns, but " << outSize << " rows and "
+        << input.n_cols << " columns (one per stream) are expected!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The same computation as Forward(), with the previous output of each
+  // stream taken from the state.
+  const Linear<>& input2Gate = *boost::get<Linear<>*>(input2GateModule);
+  const LinearNoBias<>& output2Gate = *boost::get<LinearNoBias<>*>(
+      output2GateModule);
+  const LinearNoBias<>& outputHidden2Gate = *boost::get<LinearNoBias<>*>(
+      outputHidden2GateModule);
+
+  OutputDataType inputGates = input2Gate.Weight() * input;
+  inputGates.each_col() += input2Gate.Bias();
+  const OutputDataType outputGates = output2Gate.Weight() * state;
+
+  OutputDataType updateGate(outSize, input.n_cols);
+  OutputDataType stepResetOutput(outSize, input.n_cols);
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      updateGate(i, j) = LogisticFunction::Fn(inputGates(i, j) +
+          outputGates(i, j));
+      stepResetOutput(i, j) = LogisticFunction::Fn(inputGates(outSize + i, j)
+          + outputGates(outSize + i, j)) * state(i, j);
+    }
+  }
+
+  const OutputDataType hiddenGates = outputHidden2Gate.Weight() *
+      stepResetOutput;
+
+  output.set_size(outSize, input.n_cols);
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const double hiddenState = std::tanh(inputGates(2 * outSize + i, j) +
+          hiddenGates(i, j));
+      output(i, j) = updateGate(i, j) * (state(i, j) - hiddenState) +
+          hiddenState;
+    }
+  }
+
+  state = output;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void GRU<InputDataType, OutputDataType>::Backward(
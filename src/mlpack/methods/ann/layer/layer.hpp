@@ -63,6 +63,7 @@
 #include "parametric_relu.hpp"
 #include "pixel_shuffle.hpp"
 #include "positional_encoding.hpp"
+#include "quantized_linear.hpp"
 #include "recurrent_attention.hpp"
 #include "recurrent.hpp"
 #include "reinforce_normal.hpp"
@@ -74,6 +75,7 @@
 #include "softmax.hpp"
 #include "softmin.hpp"
 #include "spatial_dropout.hpp"
+#include "static_sequential.hpp"
 #include "subview.hpp"
 #include "transposed_convolution.hpp"
 #include "virtual_batch_norm.hpp"
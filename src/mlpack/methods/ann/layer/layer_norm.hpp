@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LAYERNORM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/normalization_statistics.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -196,9 +197,6 @@ class LayerNorm
 
   //! Locally-stored normalized input.
   OutputDataType normalized;
-
-  //! Locally-stored zero mean input.
-  OutputDataType inputMean;
 }; // class LayerNorm
 
 } // namespace ann
@@ -59,20 +59,33 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
-
-  // Normalize the input.
-  output = input.each_row() - mean;
-  inputMean = output;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
+  normalized.set_size(arma::size(input));
+  output.set_size(arma::size(input));
+
+  // Each point is normalized in one pass for the statistics, and one pass
+  // that normalizes, scales and shifts.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    NormalizationStatistics statistics;
+    statistics.Add(input.colptr(i), input.n_rows);
+    mean(i) = statistics.Mean();
+    variance(i) = statistics.Variance();
+
+    const double pointMean = mean(i);
+    const double stdInv = 1.0 / std::sqrt(variance(i) + eps);
+    const eT* x = input.colptr(i);
+    eT* y = output.colptr(i);
+    // Reused in the backward and gradient step.
+    double* xHat = normalized.colptr(i);
+    for (size_t r = 0; r < input.n_rows; ++r)
+    {
+      xHat[r] = (x[r] - pointMean) * stdInv;
+      y[r] = gamma(r) * xHat[r] + beta(r);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -80,23 +93,34 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat.
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += arma::sum(norm.each_row() % -stdInv, 0) / input.n_rows;
+  const size_t m = input.n_rows;
+  g.set_size(arma::size(input));
+
+  // With n = dl / dxhat = gy * gamma, the gradient is
+  // stdInv * (n - xhat * sum(n * xhat) / m - sum(n) / m), where the sums are
+  // over the elements of the point.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    const double stdInv = 1.0 / std::sqrt(variance(i) + eps);
+    const eT* dy = gy.colptr(i);
+    const double* xHat = normalized.colptr(i);
+
+    double normXHatSum = 0.0, normSum = 0.0;
+    for (size_t r = 0; r < m; ++r)
+    {
+      const double norm = dy[r] * gamma(r);
+      normXHatSum += norm * xHat[r];
+      normSum += norm;
+    }
+
+    eT* dx = g.colptr(i);
+    for (size_t r = 0; r < m; ++r)
+    {
+      dx[r] = stdInv * (dy[r] * gamma(r) - (xHat[r] * normXHatSum + normSum) /
+          m);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -106,14 +130,21 @@ void LayerNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
+  gradient.zeros(size + size, 1);
+  double* gammaGradient = gradient.memptr();
+  double* betaGradient = gradient.memptr() + size;
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // Step 5: dl / dy * xhat, and step 6: dl / dy, in one pass.
+  for (size_t i = 0; i < error.n_cols; ++i)
+  {
+    const eT* e = error.colptr(i);
+    const double* xHat = normalized.colptr(i);
+    for (size_t r = 0; r < error.n_rows; ++r)
+    {
+      gammaGradient[r] += xHat[r] * e[r];
+      betaGradient[r] += e[r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
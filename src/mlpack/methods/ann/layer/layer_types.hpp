@@ -88,6 +88,8 @@ template<typename InputDataType, typename OutputDataType> class VRClassReward;
 template<typename InputDataType, typename OutputDataType> class Concatenate;
 template<typename InputDataType, typename OutputDataType> class Padding;
 template<typename InputDataType, typename OutputDataType> class ReLU6;
+template<typename InputDataType, typename OutputDataType>
+class QuantizedLinear;
 
 template<typename InputDataType,
          typename OutputDataType,
@@ -251,7 +253,8 @@ using MoreTypes = boost::variant<
         ISRLU<arma::mat, arma::mat>*,
         BicubicInterpolation<arma::mat, arma::mat>*,
         NearestInterpolation<arma::mat, arma::mat>*,
-        GroupNorm<arma::mat, arma::mat>*
+        GroupNorm<arma::mat, arma::mat>*,
+        QuantizedLinear<arma::mat, arma::mat>*
 >;
 
 template <typename... CustomLayers>
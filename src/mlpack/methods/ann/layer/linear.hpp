@@ -158,6 +158,16 @@ class Linear
     return inSize;
   }
 
+  //! Get whether the matrix products are computed in single precision.
+  bool MixedPrecision() const { return mixedPrecision; }
+  /**
+   * Modify whether the matrix products of the forward pass, the backward pass
+   * and the gradient are computed in single precision.  The weights (and the
+   * gradient given to the optimizer) are still stored in double precision, so
+   * that small updates are not lost.  The default is false.
+   */
+  bool& MixedPrecision() { return mixedPrecision; }
+
   /**
    * Serialize the layer
    */
@@ -194,6 +204,12 @@ class Linear
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! Whether the matrix products are computed in single precision.
+  bool mixedPrecision;
+
+  //! Locally-stored single precision copy of the weight, from Forward().
+  arma::fmat weightFloat;
 }; // class Linear
 
 } // namespace ann
@@ -23,7 +23,8 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 Linear<InputDataType, OutputDataType, RegularizerType>::Linear() :
     inSize(0),
-    outSize(0)
+    outSize(0),
+    mixedPrecision(false)
 {
   // Nothing to do here.
 }
@@ -36,7 +37,8 @@ Linear<InputDataType, OutputDataType, RegularizerType>::Linear(
     RegularizerType regularizer) :
     inSize(inSize),
     outSize(outSize),
-    regularizer(regularizer)
+    regularizer(regularizer),
+    mixedPrecision(false)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -48,7 +50,8 @@ Linear<InputDataType, OutputDataType, RegularizerType>::Linear(
     inSize(layer.inSize),
     outSize(layer.outSize),
     weights(layer.weights),
-    regularizer(layer.regularizer)
+    regularizer(layer.regularizer),
+    mixedPrecision(layer.mixedPrecision)
 {
   // Nothing to do here.
 }
@@ -60,7 +63,8 @@ Linear<InputDataType, OutputDataType, RegularizerType>::Linear(
     inSize(0),
     outSize(0),
     weights(std::move(layer.weights)),
-    regularizer(std::move(layer.regularizer))
+    regularizer(std::move(layer.regularizer)),
+    mixedPrecision(layer.mixedPrecision)
 {
   // Nothing to do here.
 }
@@ -77,6 +81,7 @@ operator=(const Linear& layer)
     outSize = layer.outSize;
     weights = layer.weights;
     regularizer = layer.regularizer;
+    mixedPrecision = layer.mixedPrecision;
   }
   return *this;
 }
@@ -93,6 +98,7 @@ operator=(Linear&& layer)
     outSize = layer.outSize;
     weights = std::move(layer.weights);
     regularizer = std::move(layer.regularizer);
+    mixedPrecision = layer.mixedPrecision;
   }
   return *this;
 }
@@ -112,7 +118,18 @@ template<typename eT>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  output = weight * input;
+  if (mixedPrecision)
+  {
+    // Multiply in single precision; the weights are kept in double precision
+    // for the optimizer.
+    weightFloat = arma::conv_to<arma::fmat>::from(weight);
+    output = arma::conv_to<arma::Mat<eT>>::from(weightFloat *
+        arma::conv_to<arma::fmat>::from(input));
+  }
+  else
+  {
+    output = weight * input;
+  }
   output.each_col() += bias;
 }
 
@@ -122,7 +139,15 @@ template<typename eT>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  g = weight.t() * gy;
+  if (mixedPrecision)
+  {
+    g = arma::conv_to<arma::Mat<eT>>::from(weightFloat.t() *
+        arma::conv_to<arma::fmat>::from(gy));
+  }
+  else
+  {
+    g = weight.t() * gy;
+  }
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -133,8 +158,20 @@ void Linear<InputDataType, OutputDataType, RegularizerType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
-      error * input.t());
+  if (mixedPrecision)
+  {
+    // The product is accumulated in single precision, and stored in double
+    // precision.
+    gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::conv_to<
+        arma::Mat<eT>>::from(arma::vectorise(
+        arma::conv_to<arma::fmat>::from(error) *
+        arma::conv_to<arma::fmat>::from(input).t()));
+  }
+  else
+  {
+    gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+        error * input.t());
+  }
   gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
       arma::sum(error, 1);
   regularizer.Evaluate(weights, gradient);
@@ -123,6 +123,11 @@ class LinearNoBias
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get the weight of the layer.
+  OutputDataType const& Weight() const { return weight; }
+  //! Modify the weight of the layer.
+  OutputDataType& Weight() { return weight; }
+
   //! Get the size of the weights.
   size_t WeightSize() const
   {
@@ -135,6 +140,16 @@ class LinearNoBias
     return inSize;
   }
 
+  //! Get whether the matrix products are computed in single precision.
+  bool MixedPrecision() const { return mixedPrecision; }
+  /**
+   * Modify whether the matrix products of the forward pass, the backward pass
+   * and the gradient are computed in single precision.  The weights (and the
+   * gradient given to the optimizer) are still stored in double precision, so
+   * that small updates are not lost.  The default is false.
+   */
+  bool& MixedPrecision() { return mixedPrecision; }
+
   /**
    * Serialize the layer
    */
@@ -168,6 +183,12 @@ class LinearNoBias
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! Whether the matrix products are computed in single precision.
+  bool mixedPrecision;
+
+  //! Locally-stored single precision copy of the weight, from Forward().
+  arma::fmat weightFloat;
 }; // class LinearNoBias
 
 } // namespace ann
@@ -23,7 +23,8 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 LinearNoBias<InputDataType, OutputDataType, RegularizerType>::LinearNoBias() :
     inSize(0),
-    outSize(0)
+    outSize(0),
+    mixedPrecision(false)
 {
   // Nothing to do here.
 }
@@ -36,7 +37,8 @@ LinearNoBias<InputDataType, OutputDataType, RegularizerType>::LinearNoBias(
     RegularizerType regularizer) :
     inSize(inSize),
     outSize(outSize),
-    regularizer(regularizer)
+    regularizer(regularizer),
+    mixedPrecision(false)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -54,7 +56,18 @@ template<typename eT>
 void LinearNoBias<InputDataType, OutputDataType, RegularizerType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  output = weight * input;
+  if (mixedPrecision)
+  {
+    // Multiply in single precision; the weights are kept in double precision
+    // for the optimizer.
+    weightFloat = arma::conv_to<arma::fmat>::from(weight);
+    output = arma::conv_to<arma::Mat<eT>>::from(weightFloat *
+        arma::conv_to<arma::fmat>::from(input));
+  }
+  else
+  {
+    output = weight * input;
+  }
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -63,7 +76,15 @@ template<typename eT>
 void LinearNoBias<InputDataType, OutputDataType, RegularizerType>::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  g = weight.t() * gy;
+  if (mixedPrecision)
+  {
+    g = arma::conv_to<arma::Mat<eT>>::from(weightFloat.t() *
+        arma::conv_to<arma::fmat>::from(gy));
+  }
+  else
+  {
+    g = weight.t() * gy;
+  }
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -74,8 +95,20 @@ void LinearNoBias<InputDataType, OutputDataType, RegularizerType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
-      error * input.t());
+  if (mixedPrecision)
+  {
+    // The product is accumulated in single precision, and stored in double
+    // precision.
+    gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::conv_to<
+        arma::Mat<eT>>::from(arma::vectorise(
+        arma::conv_to<arma::fmat>::from(error) *
+        arma::conv_to<arma::fmat>::from(input).t()));
+  }
+  else
+  {
+    gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+        error * input.t());
+  }
   regularizer.Evaluate(weights, gradient);
 }
 
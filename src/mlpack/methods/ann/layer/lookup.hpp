@@ -85,6 +85,29 @@ class Lookup
                 const arma::Mat<eT>& error,
                 arma::Mat<eT>& gradient);
 
+  /**
+   * Calculate the gradient of only the embeddings of the tokens in the given
+   * input (the other columns of the gradient are zero).  The indices of these
+   * columns, in increasing order, are stored and can be accessed with
+   * UsedColumns(), and column i of the given gradient is the gradient of
+   * column UsedColumns()[i] of the weights.
+   *
+   * This is also used by Gradient(), and by the FFN when it is trained with
+   * sparse gradients (see FFN::TrainSparse()), so that only the referenced
+   * embeddings are accumulated and updated.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient of the used columns.
+   */
+  template<typename eT>
+  void SparseGradient(const arma::Mat<eT>& input,
+                      const arma::Mat<eT>& error,
+                      arma::Mat<eT>& gradient);
+
+  //! Get the indices of the embeddings used by the last gradient computation.
+  const arma::uvec& UsedColumns() const { return usedColumns; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -135,6 +158,9 @@ class Lookup
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! Locally-stored indices of the embeddings used by the last gradient.
+  arma::uvec usedColumns;
 }; // class Lookup
 
 // Alias for using as embedding layer.
@@ -65,20 +65,40 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& input,
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
+{
+  arma::Mat<eT> usedGradient;
+  SparseGradient(input, error, usedGradient);
+
+  gradient.zeros(arma::size(weights));
+  gradient.cols(usedColumns) = usedGradient;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Lookup<InputDataType, OutputDataType>::SparseGradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
 {
   const size_t seqLength = input.n_rows;
   const size_t batchSize = input.n_cols;
 
-  arma::Cube<eT> errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
-      embeddingSize, seqLength, batchSize, false, false);
+  // The indices of the embeddings of each token, in the order of the input.
+  const arma::uvec tokens = arma::conv_to<arma::uvec>::from(
+      arma::vectorise(input)) - 1;
+  usedColumns = arma::unique(tokens);
 
-  gradient.set_size(arma::size(weights));
-  gradient.zeros();
+  // Map each used embedding to its column in the gradient.  The used columns
+  // are sorted, so the position of each token is found with a binary search.
+  arma::Mat<eT> errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
+      embeddingSize, seqLength * batchSize, false, false);
 
-  for (size_t i = 0; i < batchSize; ++i)
+  gradient.zeros(embeddingSize, usedColumns.n_elem);
+  for (size_t i = 0; i < tokens.n_elem; ++i)
   {
-    gradient.cols(arma::conv_to<arma::uvec>::from(input.col(i)) - 1)
-        += errorTemp.slice(i);
+    const size_t column = std::lower_bound(usedColumns.begin(),
+        usedColumns.end(), tokens[i]) - usedColumns.begin();
+    gradient.col(column) += errorTemp.col(i);
   }
 }
 
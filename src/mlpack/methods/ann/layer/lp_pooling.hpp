@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LP_POOLING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/pooling_kernels.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -67,12 +68,12 @@ class LpPooling
    * input, calculating the function f(x) by propagating x backwards through f.
    * Using the results from the feed forward pass.
    *
-   * @param * (input) The propagated input activation.
+   * @param input The propagated input activation.
    * @param gy The backpropagated error.
    * @param g The calculated gradient.
    */
   template<typename eT>
-  void Backward(const arma::Mat<eT>& /* input */,
+  void Backward(const arma::Mat<eT>& input,
                 const arma::Mat<eT>& gy,
                 arma::Mat<eT>& g);
 
@@ -152,107 +153,6 @@ class LpPooling
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
-  /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   */
-  template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
-  {
-    arma::Mat<eT> inputPre = input;
-    inputPre = arma::pow(inputPre, normType);
-
-    for (size_t i = 1; i < input.n_cols; ++i)
-      inputPre.col(i) += inputPre.col(i - 1);
-
-    for (size_t i = 1; i < input.n_rows; ++i)
-      inputPre.row(i) += inputPre.row(i - 1);
-
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-         ++j, colidx += strideHeight)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-           ++i, rowidx += strideWidth)
-      {
-        double val = 0.0;
-        size_t rowEnd = rowidx + kernelWidth - 1;
-        size_t colEnd = colidx + kernelHeight - 1;
-
-        if (rowEnd > input.n_rows - 1)
-          rowEnd = input.n_rows - 1;
-        if (colEnd > input.n_cols - 1)
-          colEnd = input.n_cols - 1;
-
-        val += inputPre(rowEnd, colEnd);
-        if (rowidx >= 1)
-        {
-          if (colidx >= 1)
-            val += inputPre(rowidx - 1, colidx - 1);
-          val -= inputPre(rowidx - 1, colEnd);
-        }
-
-        if (colidx >= 1)
-          val -= inputPre(rowEnd, colidx - 1);
-
-        output(i, j) = val;
-      }
-    }
-
-    output = arma::pow(output, 1.0 / normType);
-  }
-
-  /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
-   */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& input,
-                 const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output)
-  {
-    arma::Mat<eT> unpooledError;
-    for (size_t j = 0, colidx = 0; j < input.n_cols; j += strideHeight,
-         colidx++)
-    {
-      for (size_t i = 0, rowidx = 0; i < input.n_rows; i += strideWidth,
-           rowidx++)
-      {
-        size_t rowEnd = i + kernelWidth - 1;
-        size_t colEnd = j + kernelHeight - 1;
-
-        if (rowEnd > input.n_rows - 1)
-        {
-          if (floor)
-            continue;
-          rowEnd = input.n_rows - 1;
-        }
-
-        if (colEnd > input.n_cols - 1)
-        {
-          if (floor)
-            continue;
-          colEnd = input.n_cols - 1;
-        }
-
-        arma::mat InputArea = input(arma::span(i, rowEnd),
-            arma::span(j, colEnd));
-
-        size_t sum = pow(arma::accu(arma::pow(InputArea, normType)),
-            (normType - 1) / normType);
-        unpooledError = arma::Mat<eT>(InputArea.n_rows, InputArea.n_cols);
-        unpooledError.fill(error(rowidx, colidx) / InputArea.n_elem);
-        unpooledError %= arma::pow(InputArea, normType - 1);
-        unpooledError /= sum;
-        output(arma::span(i, i + InputArea.n_rows - 1),
-            arma::span(j, j + InputArea.n_cols - 1)) += unpooledError;
-      }
-    }
-  }
-
   //! Locally-stored norm type.
   size_t normType;
 
@@ -289,21 +189,9 @@ class LpPooling
   //! Locally-stored output height.
   size_t outputHeight;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored number of input units.
   size_t batchSize;
 
-  //! Locally-stored output parameter.
-  arma::cube outputTemp;
-
-  //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
-
-  //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
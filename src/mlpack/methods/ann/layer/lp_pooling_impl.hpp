@@ -45,7 +45,6 @@ LpPooling<InputDataType, OutputDataType>::LpPooling(
     inputHeight(0),
     outputWidth(0),
     outputHeight(0),
-    reset(false),
     batchSize(0)
 {
   // Nothing to do here.
@@ -58,8 +57,6 @@ void LpPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&>(input).memptr(),
-      inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
   {
@@ -76,39 +73,69 @@ void LpPooling<InputDataType, OutputDataType>::Forward(
         (double) kernelHeight) / (double) strideHeight + 1);
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  const PoolingShape shape(inputWidth, inputHeight, outputWidth, outputHeight,
+      kernelWidth, kernelHeight, strideWidth, strideHeight);
+  const size_t slices = batchSize * inSize;
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  output.set_size(outputSliceSize * inSize, batchSize);
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) slices; ++s)
+  {
+    const arma::Mat<eT> inputSlice(const_cast<eT*>(input.memptr()) +
+        s * inputSliceSize, inputWidth, inputHeight, false, true);
+    arma::Mat<eT> outputSlice(output.memptr() + s * outputSliceSize,
+        outputWidth, outputHeight, false, true);
+
+    const arma::Mat<eT> powers = arma::pow(inputSlice, (double) normType);
+    SumPoolingKernel(shape, powers.memptr(), outputSlice.memptr());
+    outputSlice = arma::pow(outputSlice, 1.0 / normType);
+  }
 
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
-  outSize = batchSize * inSize;
+  outSize = slices;
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void LpPooling<InputDataType, OutputDataType>::Backward(
-  const arma::Mat<eT>& /* input */,
+  const arma::Mat<eT>& input,
   const arma::Mat<eT>& gy,
   arma::Mat<eT>& g)
 {
-  arma::cube mappedError = arma::cube(((arma::Mat<eT>&) gy).memptr(),
-      outputWidth, outputHeight, outSize, false, false);
-
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
-
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  const PoolingShape shape(inputWidth, inputHeight, outputWidth, outputHeight,
+      kernelWidth, kernelHeight, strideWidth, strideHeight);
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
+  const double p = (double) normType;
+
+  g.zeros(inputSliceSize * inSize, batchSize);
+
+  // For the output y = (sum_k x_k^p)^(1 / p) of a window, the derivative with
+  // respect to x_k is x_k^(p - 1) * (sum_k x_k^p)^((1 - p) / p).
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) outSize; ++s)
   {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
+    const arma::Mat<eT> inputSlice(const_cast<eT*>(input.memptr()) +
+        s * inputSliceSize, inputWidth, inputHeight, false, true);
+    arma::Mat<eT> gSlice(g.memptr() + s * inputSliceSize, inputWidth,
+        inputHeight, false, true);
+
+    const arma::Mat<eT> powers = arma::pow(inputSlice, p);
+    arma::Mat<eT> error(outputWidth, outputHeight);
+    SumPoolingKernel(shape, powers.memptr(), error.memptr());
+
+    const eT* errorSlice = gy.memptr() + s * outputSliceSize;
+    for (size_t i = 0; i < outputSliceSize; ++i)
+    {
+      error[i] = (error[i] == 0) ? 0 :
+          errorSlice[i] * std::pow(error[i], (1.0 - p) / p);
+    }
+
+    SumUnpoolingKernel(shape, error.memptr(), gSlice.memptr());
+    gSlice %= arma::pow(inputSlice, p - 1.0);
   }
-
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -113,6 +113,23 @@ class LSTM
                OutputType& cellState,
                bool useCellState = false);
 
+  /**
+   * Run one step of the layer for inference, on a batch of independent
+   * streams, without the buffers that Forward() keeps for backpropagation
+   * through time (so the cost of a step does not depend on rho, and the
+   * state is not reset after rho steps).  Column j of the input, the output
+   * and the state belong to stream j.  The state holds the previous output
+   * and the cell of each stream (2 * outSize rows), and is updated; an empty
+   * state starts new streams.
+   *
+   * @param input Input of the step, one column per stream.
+   * @param output Output of the step, one column per stream.
+   * @param state State of the streams.
+   */
+  void Step(const InputDataType& input,
+            OutputDataType& output,
+            OutputDataType& state);
+
   /**
    * Ordinary feed backward pass of a neural network, calculating the function
    * f(x) by propagating x backwards trough f. Using the results from the feed
@@ -357,6 +357,59 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::Step(const InputDataType& input,
+                                               OutputDataType& output,
+                                               OutputDataType& state)
+{
+  if (state.is_empty())
+  {
+    state.zeros(2 * outSize, input.n_cols);
+  }
+  else if (state.n_rows != 2 * outSize || state.n_cols != input.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "LSTM<>::Step(): the state has " << state.n_rows << " rows and "
+        << state.n_cols << " columns, but " << 2 * outSize << " rows and "
+        << input.n_cols << " columns (one per stream) are expected!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The gates of the step; a new stream has a zero output and cell, as at the
+  // first step of Forward().
+  const OutputDataType prevOutput = state.rows(0, outSize - 1);
+  const OutputDataType prevCell = state.rows(outSize, 2 * outSize - 1);
+
+  OutputDataType inputGate = input2GateInputWeight * input +
+      output2GateInputWeight * prevOutput;
+  inputGate.each_col() += input2GateInputBias;
+  inputGate += prevCell.each_col() % cell2GateInputWeight;
+  inputGate = 1.0 / (1 + arma::exp(-inputGate));
+
+  OutputDataType forgetGate = input2GateForgetWeight * input +
+      output2GateForgetWeight * prevOutput;
+  forgetGate.each_col() += input2GateForgetBias;
+  forgetGate += prevCell.each_col() % cell2GateForgetWeight;
+  forgetGate = 1.0 / (1 + arma::exp(-forgetGate));
+
+  OutputDataType hiddenLayer = input2HiddenWeight * input +
+      output2HiddenWeight * prevOutput;
+  hiddenLayer.each_col() += input2HiddenBias;
+
+  const OutputDataType newCell = forgetGate % prevCell + inputGate %
+      arma::tanh(hiddenLayer);
+
+  OutputDataType outputGate = input2GateOutputWeight * input +
+      output2GateOutputWeight * prevOutput + newCell.each_col() %
+      cell2GateOutputWeight;
+  outputGate.each_col() += input2GateOutputBias;
+  outputGate = 1.0 / (1 + arma::exp(-outputGate));
+
+  output = arma::tanh(newCell) % outputGate;
+  state.rows(0, outSize - 1) = output;
+  state.rows(outSize, 2 * outSize - 1) = newCell;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Backward(
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_MAX_POOLING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/pooling_kernels.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -170,68 +171,6 @@ class MaxPooling
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-        ++j, colidx += strideHeight)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-          ++i, rowidx += strideWidth)
-      {
-        size_t rowEnd = rowidx + kernelWidth - 1;
-        size_t colEnd = colidx + kernelHeight - 1;
-
-        if (rowEnd > input.n_rows - 1)
-          rowEnd = input.n_rows - 1;
-        if (colEnd > input.n_cols - 1)
-          colEnd = input.n_cols - 1;
-
-        arma::mat subInput = input(
-            arma::span(rowidx, rowEnd),
-            arma::span(colidx, colEnd));
-
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
-
-        if (!deterministic)
-        {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx, rowEnd),
-              arma::span(colidx, colEnd));
-
-          poolingIndices(i, j) = subIndices(idx);
-        }
-      }
-    }
-  }
-
-  /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param error The backward error.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
-    }
-  }
-
   //! Locally-stored width of the pooling window.
   size_t kernelWidth;
 
@@ -253,9 +192,6 @@ class MaxPooling
   //! Locally-stored number of output channels.
   size_t outSize;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored input width.
   size_t inputWidth;
 
@@ -275,18 +211,6 @@ class MaxPooling
   //! Locally-stored number of input units.
   size_t batchSize;
 
-  //! Locally-stored output parameter.
-  arma::cube outputTemp;
-
-  //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
-
-  //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
-
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -296,14 +220,10 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
-
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored pooling indices: for each forward pass that is not
+  //! deterministic, the index in its input slice of the maximum of each output
+  //! (one column per slice).
+  std::vector<arma::Mat<size_t>> poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
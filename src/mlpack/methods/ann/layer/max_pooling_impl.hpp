@@ -39,7 +39,6 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     floor(floor),
     inSize(0),
     outSize(0),
-    reset(false),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
@@ -57,8 +56,6 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&>(input).memptr(),
-      inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
   {
@@ -75,45 +72,27 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
         (double) kernelHeight) / (double) strideHeight + 1);
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  const PoolingShape shape(inputWidth, inputHeight, outputWidth, outputHeight,
+      kernelWidth, kernelHeight, strideWidth, strideHeight);
+  const size_t slices = batchSize * inSize;
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
 
+  output.set_size(outputSliceSize * inSize, batchSize);
   if (!deterministic)
-  {
-    poolingIndices.push_back(outputTemp);
-  }
+    poolingIndices.push_back(arma::Mat<size_t>(outputSliceSize, slices));
 
-  if (!reset)
+  // Each slice (one channel of one point) is pooled independently, directly
+  // from the input.
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) slices; ++s)
   {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
-
-    reset = true;
+    MaxPoolingKernel(shape, input.memptr() + s * inputSliceSize,
+        output.memptr() + s * outputSliceSize, deterministic ? NULL :
+        poolingIndices.back().colptr(s));
   }
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-  {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
-    }
-  }
-
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
-
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
-  outSize = batchSize * inSize;
+  outSize = slices;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -121,21 +100,25 @@ template<typename eT>
 void MaxPooling<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  arma::cube mappedError = arma::cube(((arma::Mat<eT>&) gy).memptr(),
-      outputWidth, outputHeight, outSize, false, false);
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
+  const arma::Mat<size_t>& indices = poolingIndices.back();
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  g.zeros(inputSliceSize * inSize, batchSize);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  // The windows of a slice may overlap, so each slice is unpooled by one
+  // thread.
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) outSize; ++s)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    const eT* error = gy.memptr() + s * outputSliceSize;
+    const size_t* index = indices.colptr(s);
+    eT* gSlice = g.memptr() + s * inputSliceSize;
+    for (size_t i = 0; i < outputSliceSize; ++i)
+      gSlice[index[i]] += error[i];
   }
 
   poolingIndices.pop_back();
-
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
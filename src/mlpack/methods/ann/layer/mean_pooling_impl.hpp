@@ -43,7 +43,6 @@ MeanPooling<InputDataType, OutputDataType>::MeanPooling(
     inputHeight(0),
     outputWidth(0),
     outputHeight(0),
-    reset(false),
     deterministic(false),
     batchSize(0)
 {
@@ -57,8 +56,6 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&>(input).memptr(),
-      inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
   {
@@ -75,18 +72,31 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
         (double) kernelHeight) / (double) strideHeight + 1);
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  const PoolingShape shape(inputWidth, inputHeight, outputWidth, outputHeight,
+      kernelWidth, kernelHeight, strideWidth, strideHeight);
+  const size_t slices = batchSize * inSize;
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  output.set_size(outputSliceSize * inSize, batchSize);
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) slices; ++s)
+  {
+    eT* outputSlice = output.memptr() + s * outputSliceSize;
+    SumPoolingKernel(shape, input.memptr() + s * inputSliceSize, outputSlice);
+
+    // Windows at the border of the input are clipped, so they are averaged
+    // over fewer elements.
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t cols = shape.WindowCols(j);
+      for (size_t i = 0; i < outputWidth; ++i)
+        outputSlice[j * outputWidth + i] /= (eT) (shape.WindowRows(i) * cols);
+    }
+  }
 
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
-  outSize = batchSize * inSize;
+  outSize = slices;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -96,18 +106,31 @@ void MeanPooling<InputDataType, OutputDataType>::Backward(
   const arma::Mat<eT>& gy,
   arma::Mat<eT>& g)
 {
-  arma::cube mappedError = arma::cube(((arma::Mat<eT>&) gy).memptr(),
-      outputWidth, outputHeight, outSize, false, false);
+  const PoolingShape shape(inputWidth, inputHeight, outputWidth, outputHeight,
+      kernelWidth, kernelHeight, strideWidth, strideHeight);
+  const size_t inputSliceSize = inputWidth * inputHeight;
+  const size_t outputSliceSize = outputWidth * outputHeight;
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  g.zeros(inputSliceSize * inSize, batchSize);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  // Each output spreads its error evenly over the elements of its window.
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) outSize; ++s)
   {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
+    arma::Mat<eT> error(outputWidth, outputHeight);
+    const eT* errorSlice = gy.memptr() + s * outputSliceSize;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t cols = shape.WindowCols(j);
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        error(i, j) = errorSlice[j * outputWidth + i] /
+            (eT) (shape.WindowRows(i) * cols);
+      }
+    }
+
+    SumUnpoolingKernel(shape, error.memptr(), g.memptr() + s * inputSliceSize);
   }
-
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
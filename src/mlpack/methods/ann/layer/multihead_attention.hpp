@@ -25,7 +25,6 @@
 #define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <mlpack/methods/ann/layer/softmax.hpp>
 #include <mlpack/methods/ann/layer/dropout.hpp>
 #include <mlpack/methods/ann/init_rules/glorot_init.hpp>
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
@@ -185,6 +184,31 @@ class MultiheadAttention
   }
 
  private:
+  /**
+   * Concatenate the transposed slices of the given cube, i.e. return the
+   * matrix [trans(cube.slice(0)), trans(cube.slice(1)), ...].
+   */
+  template<typename eT>
+  static arma::Mat<eT> JoinTransposedSlices(const arma::Cube<eT>& cube);
+
+  /**
+   * The inverse of JoinTransposedSlices(): set slice i of the cube to the
+   * transpose of the columns (i * sliceRows) to ((i + 1) * sliceRows - 1) of
+   * the given matrix.
+   */
+  template<typename eT>
+  static void SplitTransposedSlices(const arma::Mat<eT>& m,
+                                    const size_t sliceRows,
+                                    arma::Cube<eT>& cube);
+
+  /**
+   * Backpropagate the given error through the softmax (over each column) of
+   * each slice, in-place, given the probabilities computed by the softmax.
+   */
+  template<typename eT>
+  static void SoftmaxBackward(const arma::Cube<eT>& probabilities,
+                              arma::Cube<eT>& error);
+
   //! Element Type of the input.
   typedef typename OutputDataType::elem_type ElemType;
 
@@ -251,9 +275,6 @@ class MultiheadAttention
   //! Locally-stored attention output weight to be fed to last linear layer.
   arma::Cube<ElemType> attnOut;
 
-  //! Softmax layer to represent the probabilities of next sequence.
-  Softmax<InputDataType, OutputDataType> softmax;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
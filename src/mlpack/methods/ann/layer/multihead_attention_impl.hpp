@@ -88,50 +88,65 @@ template <typename eT>
 void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
 Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  typedef typename arma::Cube<eT> CubeType;
+  typedef typename arma::Mat<eT> MatType;
 
   if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
   {
     Log::Fatal << "Incorrect input dimensions!" << std::endl;
   }
 
+  // The attention mask has elements 0 or -infinity, and is used to black-out
+  // future sequences (generally in Encoder-Decoder attention).  The key
+  // padding mask, which also has elements 0 or -infinity, blacks-out any
+  // particular word in the sequence.
+  // The shape of attnMask : (tgtSeqLen, srcSeqLen).
+  // The shape of keyPaddingMask : (1, srcSeqLen).
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
+  }
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
+  }
+
   const size_t batchSize = input.n_cols;
 
   // shape of output : (embedDim * tgtSeqLen, batchSize).
   output.set_size(embedDim * tgtSeqLen, batchSize);
 
-  // Reshape the input, the query, and the key into a cube from a matrix.
-  // The shape of q : (embedDim, tgtSeqLen, batchSize).
-  // The shape of k : (embedDim, srcSeqLen, batchSize).
-  // The shape of v : (embedDim, srcSeqLen, batchSize).
-  const CubeType q(const_cast<arma::Mat<eT>&>(input).memptr(),
-      embedDim, tgtSeqLen, batchSize, false, false);
-  const CubeType k(const_cast<arma::Mat<eT>&>(input).memptr() +
+  // View the query, the key and the value of the whole batch as matrices.
+  // The shape of q : (embedDim, tgtSeqLen * batchSize).
+  // The shape of k : (embedDim, srcSeqLen * batchSize).
+  // The shape of v : (embedDim, srcSeqLen * batchSize).
+  const MatType q(const_cast<MatType&>(input).memptr(),
+      embedDim, tgtSeqLen * batchSize, false, false);
+  const MatType k(const_cast<MatType&>(input).memptr() +
       embedDim * tgtSeqLen * batchSize,
-      embedDim, srcSeqLen, batchSize, false, false);
-  const CubeType v(const_cast<arma::Mat<eT>&>(input).memptr() +
+      embedDim, srcSeqLen * batchSize, false, false);
+  const MatType v(const_cast<MatType&>(input).memptr() +
       embedDim * (tgtSeqLen + srcSeqLen) * batchSize,
-      embedDim, srcSeqLen, batchSize, false, false);
+      embedDim, srcSeqLen * batchSize, false, false);
 
   // qProj, kProj, and vProj are the linearly projected query, key and value
-  // respectively.
-  qProj.set_size(tgtSeqLen, embedDim, batchSize);
-  kProj.set_size(srcSeqLen, embedDim, batchSize);
-  vProj.set_size(srcSeqLen, embedDim, batchSize);
-
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    qProj.slice(i) = arma::trans(
-        queryWt * q.slice(i) + arma::repmat(qBias, 1, tgtSeqLen));
-    kProj.slice(i) = arma::trans(
-        keyWt * k.slice(i) + arma::repmat(kBias, 1, srcSeqLen));
-    vProj.slice(i) = arma::trans(
-        valueWt * v.slice(i) + arma::repmat(vBias, 1, srcSeqLen));
-  }
-
-  // The scaling factor sqrt(headDim) is used to prevent exploding values
-  // after dot product i.e. when qProj is multiplied with kProj.
-  qProj /= std::sqrt(headDim);
+  // respectively.  Each projection of the whole batch is a single matrix
+  // product, instead of one small product per sample.  The scaling factor
+  // sqrt(headDim) is used to prevent exploding values after dot product i.e.
+  // when qProj is multiplied with kProj.
+  MatType projected = queryWt * q;
+  projected.each_col() += qBias;
+  projected /= std::sqrt(headDim);
+  SplitTransposedSlices(projected, tgtSeqLen, qProj);
+
+  projected = keyWt * k;
+  projected.each_col() += kBias;
+  SplitTransposedSlices(projected, srcSeqLen, kProj);
+
+  projected = valueWt * v;
+  projected.each_col() += vBias;
+  SplitTransposedSlices(projected, srcSeqLen, vProj);
 
   // Split the qProj, kProj and vProj into n heads. That's what Multihead
   // Attention is.
@@ -139,53 +154,52 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   kProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
   vProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
 
-  // Calculate the scores i.e. perform the matrix multiplication operation
-  // on qProj and kProj. Here score = qProj . kProj'
-  scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
-
-  // Apply the attention mask if provided. The attention mask is used to black-
-  // out future sequences and generally used in Encoder-Decoder attention.
-  // The attention mask has elements 0 or -infinity.
-  // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
-  if (!attnMask.is_empty())
-  {
-    if (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen)
-      Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
-    scores.each_slice() += attnMask;
-  }
-
-  // Apply the key padding mask when provided. It blacks-out any particular
-  // word in the sequence.
-  // The key padding mask has elements 0 or -infinity.
-  // The shape of keyPaddingMask : (1, srcSeqLen).
-  if (!keyPaddingMask.is_empty())
+  // For each head of each sample, compute the scores (qProj . kProj'), apply
+  // the masks and the softmax, and multiply with vProj, in one pass over the
+  // scores while they are in cache.  The heads are independent, so they are
+  // computed in parallel.
+  // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
+  // The shape of attnOut : (tgtSeqLen, headDim, numHeads * batchSize).
+  scores.set_size(tgtSeqLen, srcSeqLen, numHeads * batchSize);
+  attnOut.set_size(tgtSeqLen, headDim, numHeads * batchSize);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) scores.n_slices; ++i)
   {
-    if (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen)
-        Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
-    scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+    const MatType qSlice(qProj.slice_memptr(i), tgtSeqLen, headDim, false,
+        true);
+    const MatType kSlice(kProj.slice_memptr(i), srcSeqLen, headDim, false,
+        true);
+    const MatType vSlice(vProj.slice_memptr(i), srcSeqLen, headDim, false,
+        true);
+    MatType score(scores.slice_memptr(i), tgtSeqLen, srcSeqLen, false, true);
+    MatType out(attnOut.slice_memptr(i), tgtSeqLen, headDim, false, true);
+
+    score = qSlice * kSlice.t();
+    if (!attnMask.is_empty())
+      score += attnMask;
+    if (!keyPaddingMask.is_empty())
+      score.each_row() += keyPaddingMask;
+
+    // This is the same softmax as the Softmax layer (over each column).
+    score.each_row() -= arma::max(score, 0);
+    score = arma::exp(score);
+    score.each_row() /= arma::sum(score, 0);
+
+    out = score * vSlice;
   }
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    softmax.Forward(scores.slice(i), softmax.OutputParameter());
-    scores.slice(i) = softmax.OutputParameter();
-  }
-
-  // Calculate the attention output i.e. matrix multiplication of softmax
-  // output and vProj.
-  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
-
   // Now we will concatenate output of all the heads i.e. we will reshape
   // attnOut to (tgtSeqLen, embedDim, batchSize).
   attnOut.reshape(tgtSeqLen, embedDim, batchSize);
 
-  // The final output is the linear projection of attention output.
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    output.col(i) = arma::vectorise(arma::trans(attnOut.slice(i) * outWt
-        + arma::repmat(outBias, tgtSeqLen, 1)));
-  }
+  // The final output is the linear projection of attention output; for the
+  // whole batch, it is a single matrix product.  The output of sample i is
+  // vectorise(trans(attnOut.slice(i) * outWt + outBias)).
+  MatType outputView(output.memptr(), embedDim, tgtSeqLen * batchSize, false,
+      true);
+  outputView = outWt.t() * JoinTransposedSlices(attnOut);
+  outputView.each_col() += outBias.t();
 }
 
 template <typename InputDataType, typename OutputDataType,
@@ -197,6 +211,7 @@ Backward(const arma::Mat<eT>& /* input */,
          arma::Mat<eT>& g)
 {
   typedef typename arma::Cube<eT> CubeType;
+  typedef typename arma::Mat<eT> MatType;
 
   if (gy.n_rows != tgtSeqLen * embedDim)
   {
@@ -206,17 +221,17 @@ Backward(const arma::Mat<eT>& /* input */,
   const size_t batchSize = gy.n_cols;
   g.set_size(embedDim * (tgtSeqLen + 2 * srcSeqLen), batchSize);
 
-  // Reshape the propagated gradient into a cube.
+  // View the propagated gradient of the whole batch as a matrix.
+  // The shape of gyMat : (embedDim, tgtSeqLen * batchSize).
+  const MatType gyMat(const_cast<MatType&>(gy).memptr(), embedDim,
+      tgtSeqLen * batchSize, false, false);
+
+  // Backpropagate through the output projection, for the whole batch at once.
   // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
   // We need not split it into n heads now because this is the part when
   // output were concatenated from n heads.
-  CubeType gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(), embedDim,
-      tgtSeqLen, batchSize, true, false);
-
-  // The shape of gyTemp : (embedDim, tgtSeqLen, batchSize).
-  // The shape of outWt : (embedDim, embedDim).
-  // The shape of the result : (tgtSeqLen, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Mat(gyTemp, outWt, true, true);
+  CubeType gyTemp;
+  SplitTransposedSlices(MatType(outWt * gyMat), tgtSeqLen, gyTemp);
 
   // Now since the shape of gyTemp is (tgtSeqLen, embedDim, batchSize). We will
   // split it into n heads.
@@ -229,13 +244,17 @@ Backward(const arma::Mat<eT>& /* input */,
   // The shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
   CubeType tmp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
 
-  // Concatenate results of all the attention heads.
+  // Concatenate results of all the attention heads, and backpropagate through
+  // the value projection.  The error of sample i is in the columns
+  // (i * srcSeqLen) to ((i + 1) * srcSeqLen - 1) of gyProj.
   tmp.reshape(srcSeqLen, embedDim, batchSize);
+  MatType gyProj = valueWt.t() * JoinTransposedSlices(tmp);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat((tgtSeqLen + srcSeqLen) * embedDim, i, g.n_rows - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * valueWt));
+        = arma::vectorise(gyProj.cols(i * srcSeqLen,
+        (i + 1) * srcSeqLen - 1));
   }
 
   // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
@@ -243,11 +262,8 @@ Backward(const arma::Mat<eT>& /* input */,
   // So the new shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   gyTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // We will perform backpropagation of softmax over each slice of gyTemp.
-    softmax.Backward(scores.slice(i), gyTemp.slice(i), gyTemp.slice(i));
-  }
+  // Perform backpropagation of softmax over each slice of gyTemp.
+  SoftmaxBackward(scores, gyTemp);
 
   // Obtain backpropagated error of key.
   // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
@@ -257,11 +273,13 @@ Backward(const arma::Mat<eT>& /* input */,
 
   // Concatenate results of all the attention heads.
   tmp.reshape(srcSeqLen, embedDim, batchSize);
+  gyProj = keyWt.t() * JoinTransposedSlices(tmp);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat(tgtSeqLen * embedDim, i, (tgtSeqLen + srcSeqLen) * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * keyWt));
+        = arma::vectorise(gyProj.cols(i * srcSeqLen,
+        (i + 1) * srcSeqLen - 1));
   }
 
   // Obtain backpropagated error of the query.
@@ -272,11 +290,13 @@ Backward(const arma::Mat<eT>& /* input */,
 
   // Concatenate results of all the attention heads.
   tmp.reshape(tgtSeqLen, embedDim, batchSize);
+  gyProj = queryWt.t() * JoinTransposedSlices(tmp);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat(0, i, tgtSeqLen * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * queryWt));
+        = arma::vectorise(gyProj.cols(i * tgtSeqLen,
+        (i + 1) * tgtSeqLen - 1));
   }
 }
 
@@ -307,37 +327,34 @@ Gradient(const arma::Mat<eT>& input,
   // The shape of gradient : (4 * embedDim * embedDim + 4 * embedDim, 1).
   gradient.set_size(arma::size(weights));
 
-  const CubeType q(const_cast<MatType&>(input).memptr(),
-      embedDim, tgtSeqLen, batchSize, false, false);
-  const CubeType k(const_cast<MatType&>(input).memptr() + q.n_elem,
-      embedDim, srcSeqLen, batchSize, false, false);
-  const CubeType v(const_cast<MatType&>(input).memptr() + q.n_elem + k.n_elem,
-      embedDim, srcSeqLen, batchSize, false, false);
+  // View the query, the key and the value of the whole batch as matrices,
+  // like in Forward().
+  const MatType q(const_cast<MatType&>(input).memptr(),
+      embedDim, tgtSeqLen * batchSize, false, false);
+  const MatType k(const_cast<MatType&>(input).memptr() + q.n_elem,
+      embedDim, srcSeqLen * batchSize, false, false);
+  const MatType v(const_cast<MatType&>(input).memptr() + q.n_elem + k.n_elem,
+      embedDim, srcSeqLen * batchSize, false, false);
 
-  // Reshape the propagated error into a cube.
-  // The shape of errorTemp : (embedDim, tgtSeqLen, batchSize).
-  CubeType errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(), embedDim,
-      tgtSeqLen, batchSize, true, false);
+  // View the propagated error as a matrix.
+  // The shape of errorMat : (embedDim, tgtSeqLen * batchSize).
+  const MatType errorMat(const_cast<MatType&>(error).memptr(), embedDim,
+      tgtSeqLen * batchSize, false, false);
 
   // Gradient wrt. outBias, i.e. dL/d(outBias).
   gradient.rows(4 * wtSize + 3 * embedDim, 4 * wtSize + 4 * embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(errorTemp, 2), 1));
-
-  // The shape of attnOut : (tgtSeqLen, embedDim, batchSize).
-  // The shape of errorTemp : (embedDim, tgtSeqLen, batchSize).
-  // The shape of gyTemp : (embedDim, embedDim, batchSize).
-  CubeType gyTemp = math::MultiplyCube2Cube(attnOut, errorTemp, true, true);
+      = arma::sum(errorMat, 1);
 
-  // Gradient wrt. outWt, i.e. dL/d(outWt). We will take sum of gyTemp along
-  // the slices and vectorise the output.
+  // Gradient wrt. outWt, i.e. dL/d(outWt).  The sum over the batch of
+  // trans(attnOut.slice(i)) * trans(errorTemp.slice(i)) is a single matrix
+  // product.
   gradient.rows(3 * wtSize, 4 * wtSize - 1)
-      = arma::vectorise(arma::sum(gyTemp, 2));
+      = arma::vectorise(JoinTransposedSlices(attnOut) * errorMat.t());
 
   // Partial derivative wrt. attnOut.
-  // The shape of outWt : (embedDim, embedDim).
-  // The shape of errorTemp : (embedDim, tgtSeqLen, batchSize).
   // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Mat(errorTemp, outWt, true, true);
+  CubeType gyTemp;
+  SplitTransposedSlices(MatType(outWt * errorMat), tgtSeqLen, gyTemp);
 
   // Now we will split it into n heads i.e. reshape it into a cube of shape
   // (tgtSeqLen, headDim, numHeads * batchSize).
@@ -346,7 +363,7 @@ Gradient(const arma::Mat<eT>& input,
   // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
   // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   // The new shape of errorTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  errorTemp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
+  CubeType errorTemp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
 
   // Now we will concatenate the propagated errors from all heads i.e. we
   // will reshape errorTemp to (srcSeqLen, embedDim, batchSize).
@@ -357,28 +374,18 @@ Gradient(const arma::Mat<eT>& input,
   gradient.rows(4 * wtSize + 2 * embedDim, 4 * wtSize + 3 * embedDim - 1)
       = arma::vectorise(arma::sum(arma::sum(errorTemp, 2), 0));
 
-  // Shape of v : (srcSeqLen, embedDim, batchSize).
-  // Shape of errorTemp : (srcSeqLen, embedDim, bathSize).
-  // The new shape of errorTemp : (embedDim, embedDim, batchSize).
-  errorTemp = math::MultiplyCube2Cube(errorTemp, v, true, true);
-
-  // Gradient wrt. valueWt, i.e. dL/d(valueWt). We will take summation over all
-  // batches of errorTemp.
+  // Gradient wrt. valueWt, i.e. dL/d(valueWt), summed over all the batches.
   gradient.rows(2 * wtSize, 3 * wtSize - 1)
-      = arma::vectorise(arma::sum(errorTemp, 2));
+      = arma::vectorise(JoinTransposedSlices(errorTemp) * v.t());
 
   // Now, the shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
   // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
   // The new shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
   errorTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The new shape of errorTemp remain same.
-    softmax.Backward(scores.slice(i), errorTemp.slice(i), errorTemp.slice(i));
-  }
+  // Backpropagate through the softmax; the shape of errorTemp remains the
+  // same.
+  SoftmaxBackward(scores, errorTemp);
 
   // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
   // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
@@ -394,14 +401,9 @@ Gradient(const arma::Mat<eT>& input,
   gradient.rows(4 * wtSize + embedDim, 4 * wtSize + 2 * embedDim - 1)
       = arma::vectorise(arma::sum(arma::sum(gyTemp, 2), 0));
 
-  // The shape of k : (embedDim, srcSeqLen, batchSize).
-  // The shape of gyTemp : (srcSeqLen, embedDim, batchSize).
-  // The shape of dkeyWt : (embedDim, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, k, true, true);
-
-  // Gradient wrt. keyWt, i.e. dL/d(keyWt). We will take summation over all the
-  // batches of dkeyWt.
-  gradient.rows(wtSize, 2 * wtSize - 1) = arma::vectorise(arma::sum(gyTemp, 2));
+  // Gradient wrt. keyWt, i.e. dL/d(keyWt), summed over all the batches.
+  gradient.rows(wtSize, 2 * wtSize - 1)
+      = arma::vectorise(JoinTransposedSlices(gyTemp) * k.t());
 
   // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
   // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
@@ -417,19 +419,76 @@ Gradient(const arma::Mat<eT>& input,
   gradient.rows(4 * wtSize, 4 * wtSize + embedDim - 1)
       = arma::vectorise(arma::sum(arma::sum(gyTemp, 2), 0));
 
-  // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
-  // The shape of q : (embedDim, tgtSeqLen, batchSize).
-  // The shape of gyTemp : (embedDim, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, q, true, true);
-
-  // Gradient wrt. queryWt, i.e. dL/d(queryBias). We will take summation over
-  // all the batches of gyTemp.
-  gradient.rows(0, wtSize - 1) = arma::vectorise(arma::sum(gyTemp, 2));
+  // Gradient wrt. queryWt, i.e. dL/d(queryWt), summed over all the batches.
+  gradient.rows(0, wtSize - 1)
+      = arma::vectorise(JoinTransposedSlices(gyTemp) * q.t());
 
   // Regularize according to the given regularization rule.
   regularizer.Evaluate(weights, gradient);
 }
 
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template <typename eT>
+arma::Mat<eT> MultiheadAttention<InputDataType, OutputDataType,
+    RegularizerType>::JoinTransposedSlices(const arma::Cube<eT>& cube)
+{
+  arma::Mat<eT> result(cube.n_cols, cube.n_rows * cube.n_slices);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) cube.n_slices; ++i)
+  {
+    const arma::Mat<eT> slice(const_cast<eT*>(cube.slice_memptr(i)),
+        cube.n_rows, cube.n_cols, false, true);
+    arma::Mat<eT> block(result.colptr(i * cube.n_rows), cube.n_cols,
+        cube.n_rows, false, true);
+    block = slice.t();
+  }
+
+  return result;
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template <typename eT>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+SplitTransposedSlices(const arma::Mat<eT>& m,
+                      const size_t sliceRows,
+                      arma::Cube<eT>& cube)
+{
+  cube.set_size(sliceRows, m.n_rows, m.n_cols / sliceRows);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) cube.n_slices; ++i)
+  {
+    const arma::Mat<eT> block(const_cast<eT*>(m.colptr(i * sliceRows)),
+        m.n_rows, sliceRows, false, true);
+    arma::Mat<eT> slice(cube.slice_memptr(i), sliceRows, m.n_rows, false,
+        true);
+    slice = block.t();
+  }
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template <typename eT>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+SoftmaxBackward(const arma::Cube<eT>& probabilities, arma::Cube<eT>& error)
+{
+  // This is the backward pass of the Softmax layer (over each column), for
+  // each slice.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) error.n_slices; ++i)
+  {
+    const arma::Mat<eT> p(const_cast<eT*>(probabilities.slice_memptr(i)),
+        error.n_rows, error.n_cols, false, true);
+    arma::Mat<eT> e(error.slice_memptr(i), error.n_rows, error.n_cols, false,
+        true);
+    e.each_row() -= arma::sum(e % p, 0);
+    e %= p;
+  }
+}
+
 template <typename InputDataType, typename OutputDataType,
           typename RegularizerType>
 template <typename Archive>
@@ -19,6 +19,7 @@
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
+#include "../util/run_modules.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -27,7 +28,7 @@ template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::MultiplyMerge(
     const bool model, const bool run) :
-    model(model), run(run), ownsLayer(!model)
+    model(model), run(run), parallel(false), ownsLayer(!model)
 {
   // Nothing to do here.
 }
@@ -38,6 +39,7 @@ MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::MultiplyMerge(
     const MultiplyMerge& layer) :
     model(layer.model),
     run(layer.run),
+    parallel(layer.parallel),
     ownsLayer(layer.ownsLayer),
     network(layer.network),
     weights(layer.weights)
@@ -51,6 +53,7 @@ MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::MultiplyMerge(
     MultiplyMerge&& layer) :
     model(std::move(layer.model)),
     run(std::move(layer.run)),
+    parallel(layer.parallel),
     ownsLayer(std::move(layer.ownsLayer)),
     network(std::move(layer.network)),
     weights(std::move(layer.weights))
@@ -68,6 +71,7 @@ MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::operator=(
   {
     model = layer.model;
     run = layer.run;
+    parallel = layer.parallel;
     ownsLayer = layer.ownsLayer;
     network = layer.network;
     weights = layer.weights;
@@ -85,6 +89,7 @@ MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::operator=(
   {
     model = std::move(layer.model);
     run = std::move(layer.run);
+    parallel = layer.parallel;
     ownsLayer = std::move(layer.ownsLayer);
     network = std::move(layer.network);
     weights = std::move(layer.weights);
@@ -111,12 +116,12 @@ void MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::Forward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
       boost::apply_visitor(ForwardVisitor(input,
           boost::apply_visitor(outputParameterVisitor, network[i])),
           network[i]);
-    }
+    });
   }
 
   output = boost::apply_visitor(outputParameterVisitor, network.front());
@@ -134,12 +139,12 @@ void MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::Backward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
       boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
           outputParameterVisitor, network[i]), gy,
           boost::apply_visitor(deltaVisitor, network[i])), network[i]);
-    }
+    });
 
     g = boost::apply_visitor(deltaVisitor, network[0]);
     for (size_t i = 1; i < network.size(); ++i)
@@ -161,10 +166,10 @@ void MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::Gradient(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    RunModules(network.size(), parallel, [&](const size_t i)
     {
       boost::apply_visitor(GradientVisitor(input, error), network[i]);
-    }
+    });
   }
 }
 
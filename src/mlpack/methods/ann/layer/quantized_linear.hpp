@@ -0,0 +1,166 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer class, a fully-connected layer whose
+ * weights are stored as 8-bit integers, for inference only.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer_types.hpp"
+#include "linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The QuantizedLinear layer computes the same affine transformation as the
+ * Linear layer, but stores the weights as 8-bit integers with one scale per
+ * output unit (symmetric per-channel quantization), so the weights take four
+ * times less memory than with floats.  In the forward pass, the input is
+ * quantized to 8-bit integers too, with a fixed scale computed from the range
+ * of the input seen during calibration, and the products are accumulated in
+ * 32-bit integers before the result is scaled back and the (unquantized) bias
+ * is added.
+ *
+ * The layer has no trainable parameters: it is meant to be created from a
+ * trained Linear layer, usually with FFN::Quantize().  The backward pass uses
+ * the dequantized weights, so the error can still be propagated through the
+ * layer.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear layer object from the weights of a trained
+   * Linear layer.  Inputs of the layer are expected to lie in
+   * [-inputRange, inputRange]; larger inputs are clipped.
+   *
+   * @param layer The Linear layer to quantize.
+   * @param inputRange Largest absolute value of the input of the layer.
+   */
+  template<typename RegularizerType>
+  QuantizedLinear(
+      const Linear<InputDataType, OutputDataType, RegularizerType>& layer,
+      const double inputRange);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the output size.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the quantized weights; column i holds the weights of output unit i.
+  arma::Mat<arma::s8> const& Weight() const { return weight; }
+
+  //! Get the scale of the weights of each output unit.
+  OutputDataType const& Scales() const { return scales; }
+
+  //! Get the bias.
+  OutputDataType const& Bias() const { return bias; }
+
+  //! Get the scale of the input.
+  double InputScale() const { return inputScale; }
+
+  //! Get the shape of the input.
+  size_t InputShape() const
+  {
+    return inSize;
+  }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored quantized weights, stored as inSize x outSize so that
+  //! the weights of one output unit are contiguous.
+  arma::Mat<arma::s8> weight;
+
+  //! Locally-stored scale of the weights of each output unit.
+  OutputDataType scales;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored scale of the input.
+  double inputScale;
+
+  //! Locally-stored quantized input.
+  arma::Mat<arma::s8> quantizedInput;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer class, a fully-connected layer
+ * whose weights are stored as 8-bit integers, for inference only.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear() :
+    inSize(0),
+    outSize(0),
+    inputScale(1.0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename RegularizerType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const Linear<InputDataType, OutputDataType, RegularizerType>& layer,
+    const double inputRange) :
+    inSize(layer.InputSize()),
+    outSize(layer.OutputSize()),
+    bias(layer.Bias()),
+    inputScale(inputRange > 0.0 ? inputRange / 127.0 : 1.0)
+{
+  // Use symmetric quantization with one scale per output unit, so that the
+  // largest weight of each unit maps to 127.
+  const OutputDataType& layerWeight = layer.Weight();
+  scales = arma::max(arma::abs(layerWeight), 1) / 127.0;
+  scales.replace(0.0, 1.0);
+
+  weight.set_size(inSize, outSize);
+  for (size_t i = 0; i < outSize; ++i)
+  {
+    for (size_t j = 0; j < inSize; ++j)
+    {
+      weight(j, i) = (arma::s8) std::round(layerWeight(i, j) / scales(i));
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  // Quantize the input, clipping values outside of the calibrated range.
+  quantizedInput.set_size(input.n_rows, input.n_cols);
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    const double value = std::round(input[i] / inputScale);
+    quantizedInput[i] = (arma::s8) std::min(std::max(value, -127.0), 127.0);
+  }
+
+  // The dot products are accumulated in 32-bit integers; with 8-bit operands
+  // this loop can be vectorized by the compiler.
+  output.set_size(outSize, input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const arma::s8* x = quantizedInput.colptr(i);
+    for (size_t j = 0; j < outSize; ++j)
+    {
+      const arma::s8* w = weight.colptr(j);
+      int32_t sum = 0;
+      for (size_t k = 0; k < inSize; ++k)
+        sum += (int32_t) x[k] * (int32_t) w[k];
+
+      output(j, i) = sum * inputScale * scales[j] + bias[j];
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  g = arma::conv_to<arma::Mat<eT>>::from(weight) * (gy.each_col() % scales);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(scales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,301 @@
+/**
+ * @file methods/ann/layer/static_sequential.hpp
+ *
+ * Definition of the StaticSequential class, a feed-forward container for a
+ * fixed list of layers whose types are known at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_STATIC_SEQUENTIAL_HPP
+#define MLPACK_METHODS_ANN_LAYER_STATIC_SEQUENTIAL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <tuple>
+
+#include "layer_traits.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The StaticSequential class plugs a fixed list of layers together, like
+ * Sequential, but the types of the layers are template parameters and the
+ * layers are held by value.  So, calls from one layer to the next are direct
+ * calls instead of visitor dispatch over the LayerTypes variant, and the
+ * compiler can inline across layers.  This is useful for small networks, where
+ * the cost of the dispatch is not negligible compared to the computation.
+ *
+ * A StaticSequential object is itself a layer, so it is used as a custom layer
+ * of an FFN; the parameters of all the layers are stored in the parameters of
+ * the StaticSequential object, in order.  For instance:
+ *
+ * @code
+ * typedef StaticSequential<Linear<>, ReLULayer<>, Linear<>> Block;
+ *
+ * FFN<NegativeLogLikelihood<>, RandomInitialization, Block> model;
+ * model.Add<Block>(Linear<>(10, 32), ReLULayer<>(), Linear<>(32, 3));
+ * model.Add<LogSoftMax<>>();
+ * @endcode
+ *
+ * The layers must be ordinary layers that know their input shape from their
+ * constructor: layers that hold other layers (i.e. that have a Model()
+ * function) are not supported, and the input width and height are not passed
+ * from one layer to the next.
+ *
+ * @tparam Layers Types of the layers, in order.
+ */
+template<typename... Layers>
+class StaticSequential
+{
+  static_assert(sizeof...(Layers) > 0,
+      "StaticSequential must hold at least one layer.");
+
+ public:
+  //! The number of layers.
+  static const size_t NumLayers = sizeof...(Layers);
+
+  //! Create the StaticSequential object with default-constructed layers.
+  StaticSequential();
+
+  /**
+   * Create the StaticSequential object from the given layers.
+   *
+   * @param layers The layers, in order.
+   */
+  StaticSequential(Layers... layers);
+
+  /**
+   * Set the parameters of the layers to the parameters of this object.  This
+   * is called after the parameters have been set (for instance, by the FFN
+   * class).
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards through f, using the results from the feed
+   * forward pass.
+   *
+   * @param output The output of the feed forward pass.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& output,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& error,
+                arma::Mat<eT>& gradient);
+
+  //! Get the layer with the given index.
+  template<size_t I>
+  typename std::tuple_element<I, std::tuple<Layers...>>::type& Layer()
+  { return std::get<I>(layers); }
+  //! Get the layer with the given index.
+  template<size_t I>
+  const typename std::tuple_element<I, std::tuple<Layers...>>::type&
+  Layer() const { return std::get<I>(layers); }
+
+  //! Get the parameters.
+  const arma::mat& Parameters() const { return parameters; }
+  //! Modify the parameters.
+  arma::mat& Parameters() { return parameters; }
+
+  //! Get the output parameter.
+  const arma::mat& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  arma::mat& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  const arma::mat& Delta() const { return delta; }
+  //! Modify the delta.
+  arma::mat& Delta() { return delta; }
+
+  //! Get the gradient.
+  const arma::mat& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  arma::mat& Gradient() { return gradient; }
+
+  //! Get the value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Shorthand for the index of a layer, used to recurse over the layers.
+  template<size_t I>
+  using Index = std::integral_constant<size_t, I>;
+
+  //! Return the number of parameters of the layers from the given index on.
+  template<size_t I>
+  size_t NumParameters(Index<I>) const;
+  size_t NumParameters(Index<NumLayers>) const { return 0; }
+
+  //! Set the parameters of the layers from the given index on.
+  template<size_t I>
+  void ResetFrom(Index<I>, const size_t offset);
+  void ResetFrom(Index<NumLayers>, const size_t /* offset */) { }
+
+  //! Run the forward pass of the layers from the given index on.
+  template<typename InputType, typename OutputType, size_t I>
+  void ForwardFrom(const InputType& input, OutputType& output, Index<I>);
+  template<typename InputType, typename OutputType>
+  void ForwardFrom(const InputType& input,
+                   OutputType& output,
+                   Index<NumLayers - 1>);
+
+  //! Run the backward pass of the layers from the given index down.
+  template<typename OutputType, typename ErrorType, typename DeltaType,
+           size_t I>
+  void BackwardFrom(const OutputType& output,
+                    const ErrorType& gy,
+                    DeltaType& g,
+                    Index<I>);
+  template<typename OutputType, typename ErrorType, typename DeltaType>
+  void BackwardFrom(const OutputType& output,
+                    const ErrorType& gy,
+                    DeltaType& g,
+                    Index<0>);
+
+  //! Compute the gradients of the layers from the given index on.
+  template<typename InputType, typename ErrorType, size_t I>
+  void GradientFrom(const InputType& input,
+                    const ErrorType& error,
+                    arma::mat& gradient,
+                    const size_t offset,
+                    Index<I>);
+  template<typename InputType, typename ErrorType>
+  void GradientFrom(const InputType& input,
+                    const ErrorType& error,
+                    arma::mat& gradient,
+                    const size_t offset,
+                    Index<NumLayers - 1>);
+
+  //! Serialize the layers from the given index on.
+  template<typename Archive, size_t I>
+  void SerializeFrom(Archive& ar, Index<I>);
+  template<typename Archive>
+  void SerializeFrom(Archive& /* ar */, Index<NumLayers>) { }
+
+  //! Return the number of parameters of a layer with parameters.
+  template<typename T>
+  static typename std::enable_if<
+      HasParametersCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+  LayerParameters(const T& layer) { return layer.Parameters().n_elem; }
+
+  //! Return the number of parameters of a layer without parameters.
+  template<typename T>
+  static typename std::enable_if<
+      !HasParametersCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+  LayerParameters(const T& /* layer */) { return 0; }
+
+  //! Make the parameters of a layer use the given memory, and reset it.
+  template<typename T>
+  static typename std::enable_if<
+      HasParametersCheck<T, arma::mat&(T::*)()>::value, void>::type
+  SetLayerParameters(T& layer, double* memory);
+
+  //! Nothing to set for a layer without parameters.
+  template<typename T>
+  static typename std::enable_if<
+      !HasParametersCheck<T, arma::mat&(T::*)()>::value, void>::type
+  SetLayerParameters(T& /* layer */, double* /* memory */) { }
+
+  //! Reset a layer that has a Reset() function.
+  template<typename T>
+  static typename std::enable_if<
+      HasResetCheck<T, void(T::*)()>::value, void>::type
+  ResetLayer(T& layer) { layer.Reset(); }
+
+  //! Nothing to reset for a layer without a Reset() function.
+  template<typename T>
+  static typename std::enable_if<
+      !HasResetCheck<T, void(T::*)()>::value, void>::type
+  ResetLayer(T& /* layer */) { }
+
+  //! Set the deterministic parameter of a layer that has one.
+  template<typename T>
+  static typename std::enable_if<
+      HasDeterministicCheck<T, bool&(T::*)(void)>::value, void>::type
+  SetDeterministic(T& layer, const bool deterministic)
+  { layer.Deterministic() = deterministic; }
+
+  //! Nothing to set for a layer without a deterministic parameter.
+  template<typename T>
+  static typename std::enable_if<
+      !HasDeterministicCheck<T, bool&(T::*)(void)>::value, void>::type
+  SetDeterministic(T& /* layer */, const bool /* deterministic */) { }
+
+  //! Compute the gradient of a layer that has parameters.
+  template<typename T, typename InputType, typename ErrorType>
+  static typename std::enable_if<
+      HasGradientCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+  LayerGradient(T& layer,
+                const InputType& input,
+                const ErrorType& error,
+                double* memory);
+
+  //! Nothing to compute for a layer without parameters.
+  template<typename T, typename InputType, typename ErrorType>
+  static typename std::enable_if<
+      !HasGradientCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+  LayerGradient(T& /* layer */,
+                const InputType& /* input */,
+                const ErrorType& /* error */,
+                double* /* memory */) { return 0; }
+
+  //! The layers.
+  std::tuple<Layers...> layers;
+
+  //! Locally-stored parameters of all the layers.
+  arma::mat parameters;
+
+  //! Locally-stored delta object.
+  arma::mat delta;
+
+  //! Locally-stored gradient object.
+  arma::mat gradient;
+
+  //! Locally-stored output parameter object.
+  arma::mat outputParameter;
+
+  //! If true, the layers are in testing mode.
+  bool deterministic;
+}; // class StaticSequential
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_sequential_impl.hpp"
+
+#endif
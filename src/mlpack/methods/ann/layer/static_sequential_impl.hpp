@@ -0,0 +1,217 @@
+/**
+ * @file methods/ann/layer/static_sequential_impl.hpp
+ *
+ * Implementation of the StaticSequential class, a feed-forward container for a
+ * fixed list of layers whose types are known at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_STATIC_SEQUENTIAL_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_STATIC_SEQUENTIAL_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "static_sequential.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename... Layers>
+StaticSequential<Layers...>::StaticSequential() :
+    deterministic(false)
+{
+  parameters.set_size(NumParameters(Index<0>()), 1);
+}
+
+template<typename... Layers>
+StaticSequential<Layers...>::StaticSequential(Layers... layers) :
+    layers(std::move(layers)...),
+    deterministic(false)
+{
+  parameters.set_size(NumParameters(Index<0>()), 1);
+}
+
+template<typename... Layers>
+void StaticSequential<Layers...>::Reset()
+{
+  ResetFrom(Index<0>(), 0);
+}
+
+template<typename... Layers>
+template<typename eT>
+void StaticSequential<Layers...>::Forward(const arma::Mat<eT>& input,
+                                          arma::Mat<eT>& output)
+{
+  ForwardFrom(input, output, Index<0>());
+}
+
+template<typename... Layers>
+template<typename eT>
+void StaticSequential<Layers...>::Backward(const arma::Mat<eT>& output,
+                                           const arma::Mat<eT>& gy,
+                                           arma::Mat<eT>& g)
+{
+  BackwardFrom(output, gy, g, Index<NumLayers - 1>());
+}
+
+template<typename... Layers>
+template<typename eT>
+void StaticSequential<Layers...>::Gradient(const arma::Mat<eT>& input,
+                                           const arma::Mat<eT>& error,
+                                           arma::Mat<eT>& gradient)
+{
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  GradientFrom(input, error, gradient, 0, Index<0>());
+}
+
+template<typename... Layers>
+template<typename Archive>
+void StaticSequential<Layers...>::serialize(Archive& ar,
+                                            const uint32_t /* version */)
+{
+  SerializeFrom(ar, Index<0>());
+
+  // The parameters are set by the network after loading.
+  if (cereal::is_loading<Archive>())
+    parameters.set_size(NumParameters(Index<0>()), 1);
+}
+
+template<typename... Layers>
+template<size_t I>
+size_t StaticSequential<Layers...>::NumParameters(Index<I>) const
+{
+  return LayerParameters(std::get<I>(layers)) + NumParameters(Index<I + 1>());
+}
+
+template<typename... Layers>
+template<size_t I>
+void StaticSequential<Layers...>::ResetFrom(Index<I>, const size_t offset)
+{
+  auto& layer = std::get<I>(layers);
+  const size_t layerParameters = LayerParameters(layer);
+  SetLayerParameters(layer, parameters.memptr() + offset);
+  ResetLayer(layer);
+
+  ResetFrom(Index<I + 1>(), offset + layerParameters);
+}
+
+template<typename... Layers>
+template<typename InputType, typename OutputType, size_t I>
+void StaticSequential<Layers...>::ForwardFrom(const InputType& input,
+                                              OutputType& output,
+                                              Index<I>)
+{
+  auto& layer = std::get<I>(layers);
+  SetDeterministic(layer, deterministic);
+  layer.Forward(input, layer.OutputParameter());
+
+  ForwardFrom(layer.OutputParameter(), output, Index<I + 1>());
+}
+
+template<typename... Layers>
+template<typename InputType, typename OutputType>
+void StaticSequential<Layers...>::ForwardFrom(const InputType& input,
+                                              OutputType& output,
+                                              Index<NumLayers - 1>)
+{
+  // The last layer writes straight to the output.
+  auto& layer = std::get<NumLayers - 1>(layers);
+  SetDeterministic(layer, deterministic);
+  layer.Forward(input, output);
+}
+
+template<typename... Layers>
+template<typename OutputType, typename ErrorType, typename DeltaType,
+         size_t I>
+void StaticSequential<Layers...>::BackwardFrom(const OutputType& output,
+                                               const ErrorType& gy,
+                                               DeltaType& g,
+                                               Index<I>)
+{
+  auto& layer = std::get<I>(layers);
+  layer.Backward(output, gy, layer.Delta());
+
+  BackwardFrom(std::get<I - 1>(layers).OutputParameter(), layer.Delta(), g,
+      Index<I - 1>());
+}
+
+template<typename... Layers>
+template<typename OutputType, typename ErrorType, typename DeltaType>
+void StaticSequential<Layers...>::BackwardFrom(const OutputType& output,
+                                               const ErrorType& gy,
+                                               DeltaType& g,
+                                               Index<0>)
+{
+  // The first layer writes straight to the error of this layer.
+  std::get<0>(layers).Backward(output, gy, g);
+}
+
+template<typename... Layers>
+template<typename InputType, typename ErrorType, size_t I>
+void StaticSequential<Layers...>::GradientFrom(const InputType& input,
+                                               const ErrorType& error,
+                                               arma::mat& gradient,
+                                               const size_t offset,
+                                               Index<I>)
+{
+  // The error of the output of this layer is the delta of the next layer.
+  auto& layer = std::get<I>(layers);
+  const size_t layerParameters = LayerGradient(layer, input,
+      std::get<I + 1>(layers).Delta(), gradient.memptr() + offset);
+
+  GradientFrom(layer.OutputParameter(), error, gradient,
+      offset + layerParameters, Index<I + 1>());
+}
+
+template<typename... Layers>
+template<typename InputType, typename ErrorType>
+void StaticSequential<Layers...>::GradientFrom(const InputType& input,
+                                               const ErrorType& error,
+                                               arma::mat& gradient,
+                                               const size_t offset,
+                                               Index<NumLayers - 1>)
+{
+  LayerGradient(std::get<NumLayers - 1>(layers), input, error,
+      gradient.memptr() + offset);
+}
+
+template<typename... Layers>
+template<typename Archive, size_t I>
+void StaticSequential<Layers...>::SerializeFrom(Archive& ar, Index<I>)
+{
+  ar(cereal::make_nvp("layer", std::get<I>(layers)));
+  SerializeFrom(ar, Index<I + 1>());
+}
+
+template<typename... Layers>
+template<typename T>
+typename std::enable_if<
+    HasParametersCheck<T, arma::mat&(T::*)()>::value, void>::type
+StaticSequential<Layers...>::SetLayerParameters(T& layer, double* memory)
+{
+  layer.Parameters() = arma::mat(memory, layer.Parameters().n_rows,
+      layer.Parameters().n_cols, false, false);
+}
+
+template<typename... Layers>
+template<typename T, typename InputType, typename ErrorType>
+typename std::enable_if<
+    HasGradientCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+StaticSequential<Layers...>::LayerGradient(T& layer,
+                                           const InputType& input,
+                                           const ErrorType& error,
+                                           double* memory)
+{
+  layer.Gradient() = arma::mat(memory, layer.Parameters().n_rows,
+      layer.Parameters().n_cols, false, false);
+  layer.Gradient(input, error, layer.Gradient());
+
+  return layer.Parameters().n_elem;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -380,6 +380,15 @@ class RBM
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  /**
+   * Replace each probability in the given matrix with a sample of the
+   * Bernoulli distribution with that probability.  The uniform random numbers
+   * are drawn in parallel (see math::RandUniformFill()).
+   *
+   * @param probabilities Probabilities to sample from.
+   */
+  void SampleBernoulli(arma::Mat<ElemType>& probabilities);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
@@ -442,6 +451,8 @@ class RBM
   arma::Mat<ElemType> positiveGradient;
   //! Locally-stored temporary output of Gibbs chain.
   arma::Mat<ElemType> gibbsTemporary;
+  //! Locally-stored random numbers used for sampling.
+  arma::Mat<ElemType> randomValues;
   //! Locally-stored persistent CD-k boolean flag.
   bool persistence;
   //! Locally-stored reset variable.
@@ -168,11 +168,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>& output)
 {
   HiddenMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -187,11 +183,23 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>& output)
 {
   VisibleMean(input, output);
+  SampleBernoulli(output);
+}
 
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+void RBM<InitializationRuleType, DataType, PolicyType>::SampleBernoulli(
+    arma::Mat<ElemType>& probabilities)
+{
+  randomValues.set_size(probabilities.n_rows, probabilities.n_cols);
+  math::RandUniformFill(randomValues);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) probabilities.n_elem; ++i)
+    probabilities[i] = (randomValues[i] < probabilities[i]) ? 1 : 0;
 }
 
 template<
@@ -238,25 +246,31 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
 {
   this->steps = (steps == SIZE_MAX) ? this->numSteps : steps;
 
-  if (persistence && !state.is_empty())
-  {
+  // With persistent CD, the chains continue from the state.  If the batch is
+  // smaller than the state (as the last batch of an epoch may be), only the
+  // first chains are continued.
+  const bool continueChains = persistence && !state.is_empty();
+  if (continueChains && state.n_cols > input.n_cols)
+    SampleHidden(state.head_cols(input.n_cols), gibbsTemporary);
+  else if (continueChains)
     SampleHidden(state, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
-  }
   else
-  {
     SampleHidden(input, gibbsTemporary);
-    SampleVisible(gibbsTemporary, output);
-  }
+  SampleVisible(gibbsTemporary, output);
 
   for (size_t j = 1; j < this->steps; ++j)
   {
     SampleHidden(output, gibbsTemporary);
     SampleVisible(gibbsTemporary, output);
   }
+
+  // Keep the chains in place, so that the state is only allocated once.
   if (persistence)
   {
-    state = output;
+    if (state.n_rows == output.n_rows && state.n_cols > output.n_cols)
+      state.head_cols(output.n_cols) = output;
+    else
+      state = output;
   }
 }
 
@@ -277,7 +291,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(predictors.cols(i, i + batchSize - 1),
       positiveGradient);
 
-  for (size_t i = 0; i < negSteps; ++i)
+  for (size_t j = 0; j < negSteps; ++j)
   {
     Gibbs(predictors.cols(i, i + batchSize - 1),
         negativeSamples);
@@ -75,10 +75,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
   freeEnergy -= 0.5 * hiddenSize * poolSize *
       std::log((2.0 * M_PI) / slabPenalty);
 
+  // The slices of the weight cube are adjacent, so the projections on all the
+  // slices take one matrix product.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  const arma::Mat<ElemType> projections = input.t() * weights;
   for (size_t i = 0; i < hiddenSize; ++i)
   {
-    ElemType sum = arma::accu(arma::square(input.t() * weight.slice(i))) /
-        (2.0 * slabPenalty);
+    ElemType sum = arma::accu(arma::square(projections.cols(i * poolSize,
+        (i + 1) * poolSize - 1))) / (2.0 * slabPenalty);
     freeEnergy -= SoftplusFunction::Fn(spikeBias(i) - sum);
   }
 
@@ -106,10 +111,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   SampleSpike(spikeMean, spikeSamples);
   SlabMean(input, spikeSamples, slabMean);
 
-  for (size_t i = 0 ; i < hiddenSize; ++i)
+  // input * repmat(slabMean.col(i).t(), input.n_cols, 1) is the outer product
+  // of the sum of the input points with slabMean.col(i).
+  const arma::Col<ElemType> inputSum = arma::sum(input, 1);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) hiddenSize; ++i)
   {
-    weightGrad.slice(i) = input * arma::repmat(slabMean.col(i).t(),
-        input.n_cols, 1) * spikeMean(i);
+    arma::Mat<ElemType> slice(weightGrad.slice_memptr(i), visibleSize,
+        poolSize, false, true);
+    slice = inputSum * slabMean.col(i).t() * spikeMean(i);
   }
 
   spikeBiasGrad = spikeMean;
@@ -160,10 +170,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; ++k)
   {
-    for (size_t i = 0; i < visibleSize; ++i)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    math::RandNormalFill(output);
+    output = output / visiblePenalty(0) + visibleMean;
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -196,12 +204,14 @@ RBM<InitializationRuleType, DataType, PolicyType>::VisibleMean(
   DataType slab(input.memptr() + hiddenSize, poolSize, hiddenSize, false,
       false);
 
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    output += weight.slice(i) * slab.col(i) * spike(i);
-  }
+  // Scale each slab by its spike, so that the sum over the hidden units takes
+  // one matrix-vector product with all the slices of the weight cube.
+  arma::Mat<ElemType> scaledSlab = slab;
+  scaledSlab.each_row() %= spike.t();
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
 
-  output = ((1.0 / visiblePenalty(0)) * output);
+  output = (weights * arma::vectorise(scaledSlab)) / visiblePenalty(0);
 }
 
 template<
@@ -237,10 +247,19 @@ RBM<InitializationRuleType, DataType, PolicyType>::SpikeMean(
     const InputType& visible,
     DataType& spikeMean)
 {
+  // The sum of the elements of v^T W_i W_i^T v is ||W_i^T s||^2, where s is
+  // the sum of the columns of v, so all the hidden units take one
+  // matrix-vector product.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  arma::Mat<ElemType> projections = weights.t() *
+      arma::Col<ElemType>(arma::sum(visible, 1));
+  projections.reshape(poolSize, hiddenSize);
+  const arma::Row<ElemType> energy = arma::sum(arma::square(projections), 0);
+
   for (size_t i = 0; i < hiddenSize; ++i)
   {
-    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) * arma::accu(
-        visible.t() * (weight.slice(i) * weight.slice(i).t()) * visible)
+    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) * energy(i)
         / std::pow(visible.n_cols, 2) + spikeBias(i));
   }
 }
@@ -256,10 +275,10 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     InputType& spikeMean,
     DataType& spike)
 {
+  randomValues.set_size(hiddenSize, 1);
+  math::RandUniformFill(randomValues);
   for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+    spike(i) = (randomValues(i) < spikeMean(i)) ? 1 : 0;
 }
 
 template<
@@ -274,11 +293,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::SlabMean(
     DataType& spike,
     DataType& slabMean)
 {
+  // The mean over the points of W_i^T v is W_i^T times the mean of v.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  arma::Mat<ElemType> projections = weights.t() *
+      arma::Col<ElemType>(arma::mean(visible, 1));
+  projections.reshape(poolSize, hiddenSize);
+
   for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    slabMean.col(i) = arma::mean((1.0 / slabPenalty) * spike(i) *
-        weight.slice(i).t() * visible, 1);
-  }
+    slabMean.col(i) = (1.0 / slabPenalty) * spike(i) * projections.col(i);
 }
 
 template<
@@ -292,13 +315,10 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     InputType& slabMean,
     DataType& slab)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    for (size_t j = 0; j < poolSize; ++j)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  // math::RandNormal(mean, variance) scales by the variance.
+  randomValues.set_size(poolSize, hiddenSize);
+  math::RandNormalFill(randomValues);
+  slab = slabMean + randomValues / slabPenalty;
 }
 
 } // namespace ann
@@ -18,6 +18,7 @@
 #include "visitor/delta_visitor.hpp"
 #include "visitor/output_parameter_visitor.hpp"
 #include "visitor/reset_visitor.hpp"
+#include "visitor/stateless_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
 
@@ -202,6 +203,77 @@ class RNN
                arma::cube& results,
                const size_t batchSize = 256);
 
+  /**
+   * Run one step of the network for inference on a batch of streams, such as
+   * live sensor feeds: column j of input is the next sample of stream j, and
+   * column j of output is the output of the network for it.  The state of the
+   * recurrent layers (LSTM, FastLSTM and GRU) of each stream is kept in the
+   * given state between calls, so that each step costs the same however long
+   * the streams are, instead of running Predict() again on the last rho
+   * samples.  An empty state starts new streams.
+   *
+   * Each state holds one matrix per layer, with one column per stream, so
+   * independent groups of streams can use their own states, and the states of
+   * several groups can be batched together by joining the columns of their
+   * matrices (and split again with cols()).  Layers with state other than
+   * LSTM, FastLSTM and GRU (for instance Recurrent, or layers that hold other
+   * layers) are not supported, and a std::logic_error is thrown for them.
+   *
+   * @code
+   * std::vector<arma::mat> state;
+   * while (...)
+   * {
+   *   // Get the next sample of the stream.
+   *   model.Step(sample, output, state);
+   * }
+   * @endcode
+   *
+   * @param input Next sample of each stream.
+   * @param output Output of the network for each stream.
+   * @param state State of the streams.
+   */
+  void Step(const arma::mat& input,
+            arma::mat& output,
+            std::vector<arma::mat>& state);
+
+  /**
+   * Run one step of the network for inference on a batch of streams, with the
+   * state held by the network; see the overload above, and ResetStepState().
+   *
+   * @param input Next sample of each stream.
+   * @param output Output of the network for each stream.
+   */
+  void Step(const arma::mat& input, arma::mat& output)
+  {
+    Step(input, output, stepState);
+  }
+
+  //! Forget the state used by Step(), so that the next step starts new streams.
+  void ResetStepState() { stepState.clear(); }
+
+  /**
+   * Create a network with the same layers as this network that uses the
+   * weights of this network instead of a copy of them.  The new network has
+   * its own layer objects, and so its own activations and other intermediate
+   * results.  This allows one trained network to be used for prediction from
+   * several threads at once, with one shared network per thread and only one
+   * copy of the weights:
+   *
+   * @code
+   * #pragma omp parallel
+   * {
+   *   auto local = model.ShareWeights();
+   *   local.Predict(predictors, results);
+   * }
+   * @endcode
+   *
+   * The returned network is in deterministic (prediction) mode, and does not
+   * hold the training data.  This network must outlive it, and the weights of
+   * this network must not be changed or reallocated (for instance by Train()
+   * or ResetParameters()) while the returned network is in use.
+   */
+  RNN ShareWeights() const;
+
   /**
    * Evaluate the recurrent neural network with the given parameters. This
    * function is usually called by the optimizer to train the model.
@@ -271,7 +343,9 @@ class RNN
 
   /**
    * Shuffle the order of function visitation. This may be called by the
-   * optimizer.
+   * optimizer.  Only the visitation order is shuffled, and the sequences of
+   * each batch are gathered when the batch is evaluated, so the training data
+   * is never copied as a whole.
    */
   void Shuffle();
 
@@ -303,6 +377,18 @@ class RNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  /**
+   * Get whether gradient checkpointing is used during backpropagation through
+   * time.  If true, the outputs of layers without state (see
+   * StatelessVisitor) are not stored for each time step, but are computed
+   * again from the stored outputs of the other layers during the backward
+   * pass.  This reduces the memory used for long sequences at the cost of one
+   * additional forward pass of these layers.
+   */
+  bool Checkpointing() const { return checkpointing; }
+  //! Modify whether gradient checkpointing is used.
+  bool& Checkpointing() { return checkpointing; }
+
   //! Get the matrix of responses to the input data points.
   const arma::cube& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -345,6 +431,24 @@ class RNN
    */
   void ResetCells();
 
+  /**
+   * Get the predictors and the responses of the batch of the given size that
+   * starts at the given position of the visitation order, and return the index
+   * of the first sequence of the batch in them.  When the sequences are
+   * visited in order, they are the training data itself; otherwise the
+   * sequences of the batch are gathered into buffers that are reused from one
+   * batch to the next.
+   *
+   * @param begin Position of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param input Set to the cube holding the predictors of the batch.
+   * @param target Set to the cube holding the responses of the batch.
+   */
+  size_t Batch(const size_t begin,
+               const size_t batchSize,
+               arma::cube*& input,
+               arma::cube*& target);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -369,6 +473,25 @@ class RNN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Store the outputs of the layers for the current time step, for the
+   * backward pass.  If checkpointing is enabled, the outputs of layers
+   * without state are not stored.
+   *
+   * @param outputs The outputs of all time steps stored so far.
+   */
+  void SaveOutputs(std::vector<arma::mat>& outputs);
+
+  /**
+   * Restore the outputs of the layers for the last stored time step, and
+   * compute the outputs that were not stored again if checkpointing is
+   * enabled.
+   *
+   * @param outputs The outputs of all time steps stored so far.
+   * @param input The input of the time step that is restored.
+   */
+  void LoadOutputs(std::vector<arma::mat>& outputs, const arma::mat& input);
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -409,6 +532,18 @@ class RNN
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
+  //! The order in which the sequences are visited, given by Shuffle(); if it
+  //! is empty, the sequences are visited in the order of the data.
+  arma::uvec visitationOrder;
+
+  //! The buffer the predictors of a batch are gathered into, when the
+  //! sequences are not visited in order.
+  arma::cube predictorsBuffer;
+
+  //! The buffer the responses of a batch are gathered into, when the sequences
+  //! are not visited in order.
+  arma::cube responsesBuffer;
+
   //! The current error for the backward pass.
   arma::mat error;
 
@@ -436,6 +571,15 @@ class RNN
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
+  //! If true, the outputs of layers without state are not stored for BPTT.
+  bool checkpointing;
+
+  //! Locally-stored stateless visitor.
+  StatelessVisitor statelessVisitor;
+
+  //! The state of the streams of Step(), when it is held by the network.
+  std::vector<arma::mat> stepState;
+
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
 
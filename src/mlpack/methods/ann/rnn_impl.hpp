@@ -24,6 +24,7 @@
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
+#include "visitor/step_visitor.hpp"
 
 #include "util/check_input_shape.hpp"
 
@@ -46,7 +47,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     reset(false),
     single(single),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    checkpointing(false)
 {
   /* Nothing to do here */
 }
@@ -65,7 +67,9 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     single(network.single),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
-    deterministic(network.deterministic)
+    visitationOrder(network.visitationOrder),
+    deterministic(network.deterministic),
+    checkpointing(network.checkpointing)
 {
   for (size_t i = 0; i < network.network.size(); ++i)
   {
@@ -90,7 +94,9 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     network(std::move(network.network)),
     parameter(std::move(network.parameter)),
     numFunctions(std::move(network.numFunctions)),
-    deterministic(std::move(network.deterministic))
+    visitationOrder(std::move(network.visitationOrder)),
+    deterministic(std::move(network.deterministic)),
+    checkpointing(std::move(network.checkpointing))
 {
   // Nothing to do here.
 }
@@ -156,6 +162,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  visitationOrder.reset();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -201,6 +208,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  visitationOrder.reset();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -273,6 +281,79 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Step(
+    const arma::mat& input,
+    arma::mat& output,
+    std::vector<arma::mat>& state)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(
+      network, input.n_rows, "RNN<>::Step()");
+
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (state.empty())
+  {
+    state.resize(network.size());
+  }
+  else if (state.size() != network.size())
+  {
+    throw std::invalid_argument("RNN<>::Step(): the state has a different "
+        "number of layers than the network!");
+  }
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(StepVisitor((i == 0) ? input :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]),
+        boost::apply_visitor(outputParameterVisitor, network[i]), state[i]),
+        network[i]);
+  }
+
+  output = boost::apply_visitor(outputParameterVisitor, network.back());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+RNN<OutputLayerType, InitializationRuleType, CustomLayers...>
+RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::ShareWeights()
+    const
+{
+  RNN shared(rho, single, outputLayer, initializeRule);
+  shared.inputSize = inputSize;
+  shared.outputSize = outputSize;
+  shared.targetSize = targetSize;
+  shared.reset = reset;
+
+  // Use the memory of our parameters; it is not modified during prediction.
+  shared.parameter = arma::mat(const_cast<double*>(parameter.memptr()),
+      parameter.n_rows, parameter.n_cols, false, false);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    shared.network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+    offset += boost::apply_visitor(WeightSetVisitor(shared.parameter, offset),
+        shared.network.back());
+    boost::apply_visitor(resetVisitor, shared.network.back());
+  }
+
+  shared.deterministic = true;
+  shared.ResetDeterministic();
+
+  return shared;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
@@ -304,13 +385,17 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 
   ResetCells();
 
+  arma::cube* input;
+  arma::cube* target;
+  const size_t first = Batch(begin, batchSize, input, target);
+
   double performance = 0;
   size_t responseSeq = 0;
 
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+    arma::mat stepData(input->slice(seqNum).colptr(first),
         predictors.n_rows, batchSize, false, true);
     Forward(stepData);
     if (!single)
@@ -320,7 +405,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 
     performance += outputLayer.Forward(boost::apply_visitor(
         outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
+        arma::mat(target->slice(responseSeq).colptr(first),
             responses.n_rows, batchSize, false, true));
   }
 
@@ -385,6 +470,10 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   ResetCells();
 
+  arma::cube* input;
+  arma::cube* target;
+  const size_t first = Batch(begin, batchSize, input, target);
+
   double performance = 0;
   size_t responseSeq = 0;
   const size_t effectiveRho = std::min(rho, size_t(responses.size()));
@@ -392,7 +481,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+    arma::mat stepData(input->slice(seqNum).colptr(first),
         predictors.n_rows, batchSize, false, true);
     Forward(stepData);
     if (!single)
@@ -400,15 +489,11 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       responseSeq = seqNum;
     }
 
-    for (size_t l = 0; l < network.size(); ++l)
-    {
-      boost::apply_visitor(SaveOutputParameterVisitor(moduleOutputParameter),
-          network[l]);
-    }
+    SaveOutputs(moduleOutputParameter);
 
     performance += outputLayer.Forward(boost::apply_visitor(
         outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
+        arma::mat(target->slice(responseSeq).colptr(first),
             responses.n_rows, batchSize, false, true));
   }
 
@@ -430,11 +515,10 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
   {
     currentGradient.zeros();
-    for (size_t l = 0; l < network.size(); ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(moduleOutputParameter),
-          network[network.size() - 1 - l]);
-    }
+    const arma::mat stepData(
+        input->slice(effectiveRho - seqNum - 1).colptr(first),
+        predictors.n_rows, batchSize, false, true);
+    LoadOutputs(moduleOutputParameter, stepData);
 
     if (single && seqNum > 0)
     {
@@ -444,21 +528,19 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     {
       outputLayer.Backward(boost::apply_visitor(
           outputParameterVisitor, network.back()),
-          arma::mat(responses.slice(0).colptr(begin),
+          arma::mat(target->slice(0).colptr(first),
           responses.n_rows, batchSize, false, true), error);
     }
     else
     {
       outputLayer.Backward(boost::apply_visitor(
           outputParameterVisitor, network.back()),
-          arma::mat(responses.slice(effectiveRho - seqNum - 1).colptr(begin),
+          arma::mat(target->slice(effectiveRho - seqNum - 1).colptr(first),
           responses.n_rows, batchSize, false, true), error);
     }
 
     Backward();
-    Gradient(
-        arma::mat(predictors.slice(effectiveRho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true));
+    Gradient(stepData);
     gradient += currentGradient;
   }
 
@@ -480,11 +562,39 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  arma::cube newPredictors, newResponses;
-  math::ShuffleData(predictors, responses, newPredictors, newResponses);
+  visitationOrder = arma::randperm<arma::uvec>(numFunctions);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Batch(
+    const size_t begin,
+    const size_t batchSize,
+    arma::cube*& input,
+    arma::cube*& target)
+{
+  if (visitationOrder.is_empty())
+  {
+    input = &predictors;
+    target = &responses;
+    return begin;
+  }
 
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+  // The buffers keep their memory as long as the batch size does not change.
+  predictorsBuffer.set_size(predictors.n_rows, batchSize, predictors.n_slices);
+  responsesBuffer.set_size(responses.n_rows, batchSize, responses.n_slices);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t sequence = visitationOrder[begin + i];
+    for (size_t s = 0; s < predictors.n_slices; ++s)
+      predictorsBuffer.slice(s).col(i) = predictors.slice(s).col(sequence);
+    for (size_t s = 0; s < responses.n_slices; ++s)
+      responsesBuffer.slice(s).col(i) = responses.slice(s).col(sequence);
+  }
+
+  input = &predictorsBuffer;
+  target = &responsesBuffer;
+  return 0;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -535,6 +645,53 @@ void RNN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+SaveOutputs(std::vector<arma::mat>& outputs)
+{
+  for (size_t l = 0; l < network.size(); ++l)
+  {
+    // The output of a layer without state is computed again during the
+    // backward pass, so only a placeholder is stored.
+    if (checkpointing && boost::apply_visitor(statelessVisitor, network[l]))
+      outputs.push_back(arma::mat());
+    else
+      boost::apply_visitor(SaveOutputParameterVisitor(outputs), network[l]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+LoadOutputs(std::vector<arma::mat>& outputs, const arma::mat& input)
+{
+  for (size_t l = 0; l < network.size(); ++l)
+  {
+    LayerTypes<CustomLayers...>& layer = network[network.size() - 1 - l];
+    if (checkpointing && boost::apply_visitor(statelessVisitor, layer))
+      outputs.pop_back();
+    else
+      boost::apply_visitor(LoadOutputParameterVisitor(outputs), layer);
+  }
+
+  if (!checkpointing)
+    return;
+
+  // Compute the outputs that were not stored from the input of each layer,
+  // which is either restored or computed already.
+  for (size_t l = 0; l < network.size(); ++l)
+  {
+    if (!boost::apply_visitor(statelessVisitor, network[l]))
+      continue;
+
+    boost::apply_visitor(ForwardVisitor(l == 0 ? input :
+        boost::apply_visitor(outputParameterVisitor, network[l - 1]),
+        boost::apply_visitor(outputParameterVisitor, network[l])),
+        network[l]);
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename InputType>
@@ -0,0 +1,149 @@
+/**
+ * @file methods/ann/util/dropout_mask.hpp
+ *
+ * The DropoutMask class, a bit-packed random mask shared by the Dropout,
+ * AlphaDropout and DropConnect layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_DROPOUT_MASK_HPP
+#define MLPACK_METHODS_ANN_UTIL_DROPOUT_MASK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A DropoutMask holds a random mask of the elements of a matrix, one bit per
+ * element, which tells whether each element is kept or dropped.  The bits are
+ * drawn from a counter-based generator (SplitMix64, applied to the index of
+ * each pair of elements and a seed taken from math::RandGen() once per mask),
+ * so the words of the mask are generated in parallel, and the mask only
+ * depends on the seed.  Each element is kept with probability 1 - ratio (up to
+ * a resolution of 2^-32).
+ *
+ * Apply() fuses the mask with the transformation of the layer: each kept
+ * element x becomes keepScale * x + keepOffset, and each dropped element
+ * becomes dropValue, in one pass over the matrix.
+ */
+class DropoutMask
+{
+ public:
+  //! Create an empty mask.
+  DropoutMask() : numRows(0), numCols(0) { }
+
+  /**
+   * Draw a new mask for a matrix of the given size, where each element is
+   * dropped with probability ratio.
+   *
+   * @param rows Number of rows of the matrix.
+   * @param cols Number of columns of the matrix.
+   * @param ratio Probability of dropping an element.
+   */
+  void Generate(const size_t rows, const size_t cols, const double ratio)
+  {
+    numRows = rows;
+    numCols = cols;
+    const size_t n = rows * cols;
+    bits.resize((n + 63) / 64);
+
+    const uint64_t seed = ((uint64_t) math::RandGen()() << 32) |
+        (uint64_t) math::RandGen()();
+    // An element is kept when its 32 random bits are at least the threshold.
+    const uint64_t threshold = (uint64_t) (std::min(std::max(ratio, 0.0),
+        1.0) * 4294967296.0);
+
+    #pragma omp parallel for schedule(static) if (bits.size() >= 1024)
+    for (omp_size_t w = 0; w < (omp_size_t) bits.size(); ++w)
+    {
+      uint64_t word = 0;
+      for (size_t j = 0; j < 32; ++j)
+      {
+        const uint64_t r = SplitMix64(seed + 32 * w + j);
+        word |= (uint64_t) ((r & 0xFFFFFFFF) >= threshold) << (2 * j);
+        word |= (uint64_t) ((r >> 32) >= threshold) << (2 * j + 1);
+      }
+      bits[w] = word;
+    }
+
+    // Clear the bits past the end of the matrix.
+    if (n % 64 != 0)
+      bits.back() &= ((uint64_t) 1 << (n % 64)) - 1;
+  }
+
+  /**
+   * Compute output = keepScale * input + keepOffset for the kept elements, and
+   * dropValue for the dropped elements.  The input must have the size of the
+   * mask; the output may be the input.
+   */
+  template<typename eT>
+  void Apply(const arma::Mat<eT>& input,
+             arma::Mat<eT>& output,
+             const eT keepScale,
+             const eT keepOffset = eT(0),
+             const eT dropValue = eT(0)) const
+  {
+    output.set_size(numRows, numCols);
+    const eT* in = input.memptr();
+    eT* out = output.memptr();
+    const size_t n = input.n_elem;
+
+    #pragma omp parallel for schedule(static) if (bits.size() >= 1024)
+    for (omp_size_t w = 0; w < (omp_size_t) bits.size(); ++w)
+    {
+      const uint64_t word = bits[w];
+      const size_t begin = 64 * w;
+      const size_t end = std::min(begin + 64, n);
+      for (size_t i = begin; i < end; ++i)
+      {
+        const eT keep = (eT) ((word >> (i - begin)) & 1);
+        out[i] = keep * (keepScale * in[i] + keepOffset) +
+            (1 - keep) * dropValue;
+      }
+    }
+  }
+
+  //! Store the mask in the given matrix, as ones (kept) and zeros (dropped).
+  template<typename MatType>
+  void Unpack(MatType& mask) const
+  {
+    mask.set_size(numRows, numCols);
+    for (size_t i = 0; i < mask.n_elem; ++i)
+      mask[i] = (bits[i / 64] >> (i % 64)) & 1;
+  }
+
+  //! Return whether the element at the given (column-major) index is kept.
+  bool Keep(const size_t i) const { return (bits[i / 64] >> (i % 64)) & 1; }
+
+  //! Get the number of rows of the mask.
+  size_t Rows() const { return numRows; }
+  //! Get the number of columns of the mask.
+  size_t Cols() const { return numCols; }
+
+ private:
+  //! The SplitMix64 function, which gives 64 random bits for each counter.
+  static uint64_t SplitMix64(uint64_t x)
+  {
+    x = (x + 1) * 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  //! The bits of the mask, 64 elements per word (in column-major order).
+  std::vector<uint64_t> bits;
+  //! The number of rows of the mask.
+  size_t numRows;
+  //! The number of columns of the mask.
+  size_t numCols;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file methods/ann/util/memory_plan.hpp
+ *
+ * Definition of the MemoryPlan class, which places buffers with known
+ * lifetimes in one block of memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_MEMORY_PLAN_HPP
+#define MLPACK_METHODS_ANN_UTIL_MEMORY_PLAN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The MemoryPlan class places a set of buffers in one block of memory, given
+ * the number of elements of each buffer and the steps during which it is used
+ * (its liveness).  Buffers whose steps overlap get disjoint parts of the block,
+ * and buffers whose steps do not overlap may share memory, so the block is
+ * usually much smaller than the sum of the buffers.  The FFN class uses it to
+ * place the activations and the deltas of its layers (see
+ * FFN::MemoryPlanning()).
+ *
+ * @code
+ * MemoryPlan plan;
+ * const size_t a = plan.Add(100, 0, 1); // Used in steps 0 and 1.
+ * const size_t b = plan.Add(100, 2, 3); // Used in steps 2 and 3.
+ * plan.Plan();
+ * // Now plan.Size() is 100, and a and b have the same offset.
+ * @endcode
+ *
+ * The buffers are placed from the largest to the smallest, each at the lowest
+ * offset where it does not overlap a buffer that is placed already and that is
+ * used during one of its steps.
+ */
+class MemoryPlan
+{
+ public:
+  //! Create an empty plan.
+  MemoryPlan() : size(0) { /* Nothing to do. */ }
+
+  /**
+   * Add a buffer to the plan, and return its index.
+   *
+   * @param elements Number of elements of the buffer.
+   * @param begin First step during which the buffer is used.
+   * @param end Last step during which the buffer is used.
+   */
+  size_t Add(const size_t elements, const size_t begin, const size_t end)
+  {
+    Buffer buffer;
+    buffer.elements = elements;
+    buffer.begin = begin;
+    buffer.end = end;
+    buffers.push_back(buffer);
+    return buffers.size() - 1;
+  }
+
+  //! Compute the offset of each buffer, and the size of the block.
+  void Plan()
+  {
+    std::vector<size_t> order(buffers.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [this](const size_t a, const size_t b)
+        {
+          return buffers[a].elements > buffers[b].elements;
+        });
+
+    offsets.assign(buffers.size(), 0);
+    size = 0;
+    std::vector<size_t> placed;
+    for (const size_t i : order)
+    {
+      // Collect the parts of the block that are used during the steps of this
+      // buffer, sorted by offset.
+      std::vector<std::pair<size_t, size_t>> used;
+      for (const size_t j : placed)
+      {
+        if (buffers[j].begin <= buffers[i].end &&
+            buffers[i].begin <= buffers[j].end)
+        {
+          used.push_back(std::make_pair(offsets[j],
+              offsets[j] + buffers[j].elements));
+        }
+      }
+      std::sort(used.begin(), used.end());
+
+      // Take the first gap that is large enough.
+      size_t offset = 0;
+      for (const std::pair<size_t, size_t>& part : used)
+      {
+        if (part.first >= offset + buffers[i].elements)
+          break;
+        offset = std::max(offset, part.second);
+      }
+
+      offsets[i] = offset;
+      size = std::max(size, offset + buffers[i].elements);
+      placed.push_back(i);
+    }
+  }
+
+  //! Get the offset of the given buffer (after Plan()).
+  size_t Offset(const size_t buffer) const { return offsets[buffer]; }
+
+  //! Get the number of elements of the block (after Plan()).
+  size_t Size() const { return size; }
+
+  //! Get the number of buffers.
+  size_t NumBuffers() const { return buffers.size(); }
+
+  //! Get the sum of the number of elements of all the buffers.
+  size_t TotalElements() const
+  {
+    size_t total = 0;
+    for (const Buffer& buffer : buffers)
+      total += buffer.elements;
+    return total;
+  }
+
+ private:
+  //! A buffer of the plan.
+  struct Buffer
+  {
+    //! The number of elements.
+    size_t elements;
+    //! The first step during which the buffer is used.
+    size_t begin;
+    //! The last step during which the buffer is used.
+    size_t end;
+  };
+
+  //! The buffers.
+  std::vector<Buffer> buffers;
+  //! The offset of each buffer.
+  std::vector<size_t> offsets;
+  //! The number of elements of the block.
+  size_t size;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
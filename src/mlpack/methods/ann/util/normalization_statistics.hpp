@@ -0,0 +1,95 @@
+/**
+ * @file methods/ann/util/normalization_statistics.hpp
+ *
+ * Definition of the NormalizationStatistics class, which computes the mean and
+ * the variance of the values normalized by the normalization layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_NORMALIZATION_STATISTICS_HPP
+#define MLPACK_METHODS_ANN_UTIL_NORMALIZATION_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The NormalizationStatistics class computes the mean and the (biased)
+ * variance of values given as contiguous segments, with one pass over memory.
+ * The mean and the variance of each segment are computed while the segment is
+ * in the cache, and they are combined with the statistics of the previous
+ * segments with the update of Chan et al. (the parallel form of Welford's
+ * algorithm), so the result stays accurate when the mean is large compared to
+ * the standard deviation.
+ *
+ * @code
+ * NormalizationStatistics statistics;
+ * for (size_t i = 0; i < data.n_cols; ++i)
+ *   statistics.Add(data.colptr(i), data.n_rows);
+ * // Now statistics.Mean() and statistics.Variance() are the mean and the
+ * // variance of all the elements of data.
+ * @endcode
+ */
+class NormalizationStatistics
+{
+ public:
+  //! Create the statistics of no values.
+  NormalizationStatistics() : count(0.0), mean(0.0), m2(0.0)
+  {
+    /* Nothing to do. */
+  }
+
+  /**
+   * Add the given segment of values to the statistics.
+   *
+   * @param values Pointer to the values.
+   * @param n Number of values.
+   */
+  template<typename eT>
+  void Add(const eT* values, const size_t n)
+  {
+    if (n == 0)
+      return;
+
+    double segmentMean = 0.0;
+    for (size_t i = 0; i < n; ++i)
+      segmentMean += values[i];
+    segmentMean /= n;
+
+    double segmentM2 = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double d = values[i] - segmentMean;
+      segmentM2 += d * d;
+    }
+
+    const double total = count + n;
+    const double delta = segmentMean - mean;
+    mean += delta * n / total;
+    m2 += segmentM2 + delta * delta * count * n / total;
+    count = total;
+  }
+
+  //! Get the mean of the values.
+  double Mean() const { return mean; }
+
+  //! Get the variance of the values (divided by the number of values).
+  double Variance() const { return (count > 0.0) ? m2 / count : 0.0; }
+
+ private:
+  //! The number of values.
+  double count;
+  //! The mean of the values.
+  double mean;
+  //! The sum of the squared differences between the values and their mean.
+  double m2;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
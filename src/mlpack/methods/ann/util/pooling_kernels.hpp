@@ -0,0 +1,289 @@
+/**
+ * @file methods/ann/util/pooling_kernels.hpp
+ *
+ * Kernels for the max, mean and Lp pooling layers, which pool one channel of
+ * one point at a time directly from the input, without copying the windows.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_POOLING_KERNELS_HPP
+#define MLPACK_METHODS_ANN_UTIL_POOLING_KERNELS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The pooling kernels work on one slice (one channel of one point), stored in
+ * column-major order as an inRows x inCols matrix, and produce an outRows x
+ * outCols matrix.  Output (i, j) pools the window that starts at input
+ * (i * strideWidth, j * strideHeight) and has kernelWidth x kernelHeight
+ * elements, clipped at the border of the input.
+ *
+ * The innermost loops run over the output rows for a fixed position in the
+ * window, so that they have no branches on the window bounds and can be
+ * vectorized.
+ */
+struct PoolingShape
+{
+  //! Create the shape of a pooling operation.
+  PoolingShape(const size_t inRows,
+               const size_t inCols,
+               const size_t outRows,
+               const size_t outCols,
+               const size_t kernelWidth,
+               const size_t kernelHeight,
+               const size_t strideWidth,
+               const size_t strideHeight) :
+      inRows(inRows),
+      inCols(inCols),
+      outRows(outRows),
+      outCols(outCols),
+      kernelWidth(kernelWidth),
+      kernelHeight(kernelHeight),
+      strideWidth(strideWidth),
+      strideHeight(strideHeight)
+  {
+    /* Nothing to do. */
+  }
+
+  //! The number of rows of the input.
+  size_t inRows;
+  //! The number of columns of the input.
+  size_t inCols;
+  //! The number of rows of the output.
+  size_t outRows;
+  //! The number of columns of the output.
+  size_t outCols;
+  //! The width of the window (in rows).
+  size_t kernelWidth;
+  //! The height of the window (in columns).
+  size_t kernelHeight;
+  //! The stride between the windows of two output rows.
+  size_t strideWidth;
+  //! The stride between the windows of two output columns.
+  size_t strideHeight;
+
+  /**
+   * Get the number of output rows whose window contains row offset kr (so
+   * that row i * strideWidth + kr of the input exists).
+   */
+  size_t RowsWithOffset(const size_t kr) const
+  {
+    if (kr >= kernelWidth || kr >= inRows)
+      return 0;
+    return std::min(outRows, (inRows - kr + strideWidth - 1) / strideWidth);
+  }
+
+  //! Get the number of rows of the (clipped) window of output row i.
+  size_t WindowRows(const size_t i) const
+  {
+    return std::min(kernelWidth, inRows - i * strideWidth);
+  }
+
+  //! Get the number of columns of the (clipped) window of output column j.
+  size_t WindowCols(const size_t j) const
+  {
+    return std::min(kernelHeight, inCols - j * strideHeight);
+  }
+
+  /**
+   * Return true if summing each window directly is cheaper than using a
+   * summed-area table of the input, which costs about
+   * 4 * outputs + 2 * inputs operations.
+   */
+  bool DirectSums() const
+  {
+    return outRows * outCols * kernelWidth * kernelHeight <=
+        4 * outRows * outCols + 2 * inRows * inCols;
+  }
+};
+
+/**
+ * Compute the maximum of each window of the given slice, and (if indices is
+ * not NULL) the index in the slice of the first element with the maximum
+ * (in column-major order), in one pass.
+ */
+template<typename eT>
+inline void MaxPoolingKernel(const PoolingShape& shape,
+                             const eT* input,
+                             eT* output,
+                             size_t* indices)
+{
+  for (size_t j = 0; j < shape.outCols; ++j)
+  {
+    const size_t colBegin = j * shape.strideHeight;
+    const size_t colEnd = std::min(colBegin + shape.kernelHeight,
+        shape.inCols);
+    eT* out = output + j * shape.outRows;
+    size_t* index = (indices == NULL) ? NULL : indices + j * shape.outRows;
+
+    // The first element of each window.
+    const eT* first = input + colBegin * shape.inRows;
+    for (size_t i = 0; i < shape.outRows; ++i)
+      out[i] = first[i * shape.strideWidth];
+    if (index != NULL)
+    {
+      for (size_t i = 0; i < shape.outRows; ++i)
+        index[i] = colBegin * shape.inRows + i * shape.strideWidth;
+    }
+
+    for (size_t c = colBegin; c < colEnd; ++c)
+    {
+      for (size_t kr = (c == colBegin) ? 1 : 0; kr < shape.kernelWidth; ++kr)
+      {
+        const size_t rows = shape.RowsWithOffset(kr);
+        const eT* in = input + c * shape.inRows + kr;
+        if (index == NULL)
+        {
+          for (size_t i = 0; i < rows; ++i)
+            out[i] = std::max(out[i], in[i * shape.strideWidth]);
+        }
+        else
+        {
+          const size_t offset = c * shape.inRows + kr;
+          for (size_t i = 0; i < rows; ++i)
+          {
+            const eT value = in[i * shape.strideWidth];
+            if (value > out[i])
+            {
+              out[i] = value;
+              index[i] = offset + i * shape.strideWidth;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Compute the sum of each window of the given slice.
+ */
+template<typename eT>
+inline void SumPoolingKernel(const PoolingShape& shape,
+                             const eT* input,
+                             eT* output)
+{
+  if (shape.DirectSums())
+  {
+    for (size_t j = 0; j < shape.outCols; ++j)
+    {
+      const size_t colBegin = j * shape.strideHeight;
+      const size_t colEnd = std::min(colBegin + shape.kernelHeight,
+          shape.inCols);
+      eT* out = output + j * shape.outRows;
+      std::fill(out, out + shape.outRows, eT(0));
+      for (size_t c = colBegin; c < colEnd; ++c)
+      {
+        for (size_t kr = 0; kr < shape.kernelWidth; ++kr)
+        {
+          const size_t rows = shape.RowsWithOffset(kr);
+          const eT* in = input + c * shape.inRows + kr;
+          for (size_t i = 0; i < rows; ++i)
+            out[i] += in[i * shape.strideWidth];
+        }
+      }
+    }
+    return;
+  }
+
+  // Use a summed-area table: table(r, c) is the sum of input(0:r, 0:c), so
+  // that each window takes four lookups.
+  arma::Mat<eT> table(input, shape.inRows, shape.inCols);
+  for (size_t c = 1; c < shape.inCols; ++c)
+    table.col(c) += table.col(c - 1);
+  for (size_t r = 1; r < shape.inRows; ++r)
+    table.row(r) += table.row(r - 1);
+
+  for (size_t j = 0; j < shape.outCols; ++j)
+  {
+    const size_t colBegin = j * shape.strideHeight;
+    const size_t colEnd = colBegin + shape.WindowCols(j) - 1;
+    for (size_t i = 0; i < shape.outRows; ++i)
+    {
+      const size_t rowBegin = i * shape.strideWidth;
+      const size_t rowEnd = rowBegin + shape.WindowRows(i) - 1;
+      eT sum = table(rowEnd, colEnd);
+      if (rowBegin > 0)
+        sum -= table(rowBegin - 1, colEnd);
+      if (colBegin > 0)
+        sum -= table(rowEnd, colBegin - 1);
+      if (rowBegin > 0 && colBegin > 0)
+        sum += table(rowBegin - 1, colBegin - 1);
+      output[j * shape.outRows + i] = sum;
+    }
+  }
+}
+
+/**
+ * Add value (i, j) of the given outRows x outCols matrix to each element of
+ * the window of output (i, j) in the given slice; this is the transpose of
+ * SumPoolingKernel().
+ */
+template<typename eT>
+inline void SumUnpoolingKernel(const PoolingShape& shape,
+                               const eT* values,
+                               eT* g)
+{
+  if (shape.DirectSums())
+  {
+    for (size_t j = 0; j < shape.outCols; ++j)
+    {
+      const size_t colBegin = j * shape.strideHeight;
+      const size_t colEnd = std::min(colBegin + shape.kernelHeight,
+          shape.inCols);
+      const eT* value = values + j * shape.outRows;
+      for (size_t c = colBegin; c < colEnd; ++c)
+      {
+        for (size_t kr = 0; kr < shape.kernelWidth; ++kr)
+        {
+          const size_t rows = shape.RowsWithOffset(kr);
+          eT* out = g + c * shape.inRows + kr;
+          for (size_t i = 0; i < rows; ++i)
+            out[i * shape.strideWidth] += value[i];
+        }
+      }
+    }
+    return;
+  }
+
+  // Add each value at the corners of its window in a difference table, whose
+  // prefix sums (over the columns, then the rows) give the result.
+  arma::Mat<eT> table(shape.inRows, shape.inCols, arma::fill::zeros);
+  for (size_t j = 0; j < shape.outCols; ++j)
+  {
+    const size_t colBegin = j * shape.strideHeight;
+    const size_t colEnd = colBegin + shape.WindowCols(j);
+    for (size_t i = 0; i < shape.outRows; ++i)
+    {
+      const size_t rowBegin = i * shape.strideWidth;
+      const size_t rowEnd = rowBegin + shape.WindowRows(i);
+      const eT value = values[j * shape.outRows + i];
+      table(rowBegin, colBegin) += value;
+      if (rowEnd < shape.inRows)
+        table(rowEnd, colBegin) -= value;
+      if (colEnd < shape.inCols)
+        table(rowBegin, colEnd) -= value;
+      if (rowEnd < shape.inRows && colEnd < shape.inCols)
+        table(rowEnd, colEnd) += value;
+    }
+  }
+
+  for (size_t c = 1; c < shape.inCols; ++c)
+    table.col(c) += table.col(c - 1);
+  for (size_t r = 1; r < shape.inRows; ++r)
+    table.row(r) += table.row(r - 1);
+
+  arma::Mat<eT> out(g, shape.inRows, shape.inCols, false, true);
+  out += table;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file methods/ann/util/run_modules.hpp
+ *
+ * The RunModules() function, which runs a function on each module of a
+ * container layer whose modules are independent, optionally in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_RUN_MODULES_HPP
+#define MLPACK_METHODS_ANN_UTIL_RUN_MODULES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/threads.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Call function(i) for each module i in [0, numModules).  If parallel is true
+ * (and there are several modules), the calls run concurrently on the OpenMP
+ * thread pool, with BLAS on one thread while they run, so that the threads of
+ * the modules do not each start their own BLAS threads.  The function must
+ * then only write to the buffers of module i.
+ *
+ * @param numModules Number of modules.
+ * @param parallel Whether to run the modules concurrently.
+ * @param function Function to call with the index of each module.
+ */
+template<typename FunctionType>
+inline void RunModules(const size_t numModules,
+                       const bool parallel,
+                       const FunctionType& function)
+{
+  if (!parallel || numModules < 2)
+  {
+    for (size_t i = 0; i < numModules; ++i)
+      function(i);
+    return;
+  }
+
+  SerialBLASScope serialBLAS;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numModules; ++i)
+    function((size_t) i);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file methods/ann/visitor/stateless_visitor.hpp
+ *
+ * Boost static visitor abstraction that tells whether the output of a layer
+ * only depends on its current input.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STATELESS_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STATELESS_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * StatelessVisitor returns true if the output of the given layer only depends
+ * on its current input (and on its parameters), so that it can be computed
+ * again from the input at any time.  This is not the case for recurrent
+ * layers (with a ResetCell() or Rho() function), for layers that hold other
+ * layers (with a Model() function), and for layers that behave differently in
+ * training mode (with a Deterministic() function, i.e. Dropout).
+ */
+class StatelessVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Return whether the layer is stateless.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  bool operator()(MoreTypes layer) const;
+
+ private:
+  //! Return true for a layer without state.
+  template<typename T>
+  typename std::enable_if<
+      !HasResetCellCheck<T, void(T::*)(const size_t)>::value &&
+      !HasRho<T, size_t&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value &&
+      !HasDeterministicCheck<T, bool&(T::*)(void)>::value, bool>::type
+  LayerStateless(T* layer) const;
+
+  //! Return false for a layer with state.
+  template<typename T>
+  typename std::enable_if<
+      HasResetCellCheck<T, void(T::*)(const size_t)>::value ||
+      HasRho<T, size_t&(T::*)(void)>::value ||
+      HasModelCheck<T>::value ||
+      HasDeterministicCheck<T, bool&(T::*)(void)>::value, bool>::type
+  LayerStateless(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "stateless_visitor_impl.hpp"
+
+#endif
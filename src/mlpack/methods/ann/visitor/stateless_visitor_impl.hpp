@@ -0,0 +1,58 @@
+/**
+ * @file methods/ann/visitor/stateless_visitor_impl.hpp
+ *
+ * Implementation of the StatelessVisitor class, which tells whether the output
+ * of a layer only depends on its current input.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STATELESS_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STATELESS_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "stateless_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! StatelessVisitor visitor class.
+template<typename LayerType>
+inline bool StatelessVisitor::operator()(LayerType* layer) const
+{
+  return LayerStateless(layer);
+}
+
+inline bool StatelessVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasResetCellCheck<T, void(T::*)(const size_t)>::value &&
+    !HasRho<T, size_t&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value &&
+    !HasDeterministicCheck<T, bool&(T::*)(void)>::value, bool>::type
+StatelessVisitor::LayerStateless(T* /* layer */) const
+{
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasResetCellCheck<T, void(T::*)(const size_t)>::value ||
+    HasRho<T, size_t&(T::*)(void)>::value ||
+    HasModelCheck<T>::value ||
+    HasDeterministicCheck<T, bool&(T::*)(void)>::value, bool>::type
+StatelessVisitor::LayerStateless(T* /* layer */) const
+{
+  return false;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file methods/ann/visitor/step_visitor.hpp
+ *
+ * Boost static visitor abstraction that runs one inference step of a layer on
+ * a batch of streams, using and updating their state.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * StepVisitor executes the Step() function of a recurrent layer which
+ * implements it (LSTM, FastLSTM and GRU), with the given state, and the
+ * Forward() function of a layer without state.  Other layers with state
+ * (recurrent layers without a Step() function, and layers that hold other
+ * layers) are not supported, and a std::logic_error is thrown for them.
+ */
+class StepVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Execute the Step() function given the input, output and state.
+  StepVisitor(const arma::mat& input, arma::mat& output, arma::mat& state);
+
+  //! Execute the Step() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The input parameter set.
+  const arma::mat& input;
+
+  //! The output parameter set.
+  arma::mat& output;
+
+  //! The state of the layer.
+  arma::mat& state;
+
+  //! Execute the Step() function for a module which implements it.
+  template<typename T>
+  typename std::enable_if<
+      HasStepCheck<T, void(T::*)(const arma::mat&, arma::mat&, arma::mat&)>
+      ::value, void>::type
+  LayerStep(T* layer) const;
+
+  //! Execute the Forward() function for a module without state.
+  template<typename T>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)(const arma::mat&, arma::mat&, arma::mat&)>
+      ::value && !HasResetCellCheck<T, void(T::*)(const size_t)>::value &&
+      !HasRho<T, size_t&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerStep(T* layer) const;
+
+  //! Throw for a module with state which does not implement Step().
+  template<typename T>
+  typename std::enable_if<
+      !HasStepCheck<T, void(T::*)(const arma::mat&, arma::mat&, arma::mat&)>
+      ::value && (HasResetCellCheck<T, void(T::*)(const size_t)>::value ||
+      HasRho<T, size_t&(T::*)(void)>::value ||
+      HasModelCheck<T>::value), void>::type
+  LayerStep(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "step_visitor_impl.hpp"
+
+#endif
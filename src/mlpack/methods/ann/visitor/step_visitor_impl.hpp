@@ -0,0 +1,78 @@
+/**
+ * @file methods/ann/visitor/step_visitor_impl.hpp
+ *
+ * Implementation of the StepVisitor class, which runs one inference step of a
+ * layer on a batch of streams.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_STEP_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "step_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! StepVisitor visitor class.
+inline StepVisitor::StepVisitor(const arma::mat& input,
+                                arma::mat& output,
+                                arma::mat& state) :
+    input(input),
+    output(output),
+    state(state)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void StepVisitor::operator()(LayerType* layer) const
+{
+  LayerStep(layer);
+}
+
+inline void StepVisitor::operator()(MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasStepCheck<T, void(T::*)(const arma::mat&, arma::mat&, arma::mat&)>
+    ::value, void>::type
+StepVisitor::LayerStep(T* layer) const
+{
+  layer->Step(input, output, state);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStepCheck<T, void(T::*)(const arma::mat&, arma::mat&, arma::mat&)>
+    ::value && !HasResetCellCheck<T, void(T::*)(const size_t)>::value &&
+    !HasRho<T, size_t&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value, void>::type
+StepVisitor::LayerStep(T* layer) const
+{
+  layer->Forward(input, output);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStepCheck<T, void(T::*)(const arma::mat&, arma::mat&, arma::mat&)>
+    ::value && (HasResetCellCheck<T, void(T::*)(const size_t)>::value ||
+    HasRho<T, size_t&(T::*)(void)>::value ||
+    HasModelCheck<T>::value), void>::type
+StepVisitor::LayerStep(T* /* layer */) const
+{
+  throw std::logic_error("StepVisitor: only the LSTM, FastLSTM and GRU "
+      "layers, and layers without state, support Step()!");
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -83,6 +83,9 @@ class DrusillaSelect
    * the k'th row in that column will refer to the k'th candidate neighbor or
    * distance for that query point.
    *
+   * The queries are searched in parallel (with OpenMP), in blocks whose
+   * distances to the candidate set are computed with one matrix product.
+   *
    * @param querySet Set of query points to search.
    * @param k Number of furthest neighbors to search for.
    * @param neighbors Matrix to store resulting neighbors in.
@@ -110,6 +113,16 @@ class DrusillaSelect
   arma::Col<size_t>& CandidateIndices() { return candidateIndices; }
 
  private:
+  /**
+   * Return true if the first (distance, candidate) pair is further than the
+   * second; ties are broken by the index of the candidate.
+   */
+  static bool FurtherCandidate(const std::pair<double, size_t>& a,
+                               const std::pair<double, size_t>& b)
+  {
+    return (a.first > b.first) || (a.first == b.first && a.second < b.second);
+  }
+
   //! The reference set.
   MatType candidateSet;
   //! Indices of each point in the reference set.
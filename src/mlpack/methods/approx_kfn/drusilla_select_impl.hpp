@@ -16,9 +16,7 @@
 #include "drusilla_select.hpp"
 
 #include <queue>
-#include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
-#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
-#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 #include <algorithm>
 
 namespace mlpack {
@@ -81,7 +79,8 @@ void DrusillaSelect<MatType>::Train(
   candidateSet.set_size(referenceSet.n_rows, l * m);
   candidateIndices.set_size(l * m);
 
-  arma::vec dataMean(arma::mean(referenceSet, 1));
+  typedef typename MatType::elem_type ElemType;
+  arma::Col<ElemType> dataMean(arma::mean(referenceSet, 1));
   arma::vec norms(referenceSet.n_cols);
 
   MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
@@ -98,7 +97,8 @@ void DrusillaSelect<MatType>::Train(
     arma::uword maxIndex = 0;
     norms.max(maxIndex);
 
-    arma::vec line(refCopy.col(maxIndex) / arma::norm(refCopy.col(maxIndex)));
+    arma::Col<ElemType> line(refCopy.col(maxIndex) /
+        arma::norm(refCopy.col(maxIndex)));
 
     // Calculate distortion and offset and make scores.
     std::vector<bool> closeAngle(referenceSet.n_cols, false);
@@ -179,23 +179,62 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
-      tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+  // The squared distances between the queries and the candidates are
+  // ||q||^2 + ||c||^2 - 2 q^T c, so the inner products of a block of queries
+  // with all the candidates take one matrix product.  The blocks are small
+  // enough that their inner products fit in the cache.
+  typedef typename MatType::elem_type ElemType;
+  const size_t numCandidates = candidateSet.n_cols;
+  const size_t blockSize = std::max((size_t) 1, std::min((size_t) 256,
+      (size_t) 65536 / numCandidates));
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
+  arma::vec candidateNorms(numCandidates);
+  for (size_t r = 0; r < numCandidates; ++r)
+    candidateNorms[r] = std::pow(arma::norm(candidateSet.col(r)), 2.0);
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+    const arma::Mat<ElemType> products(candidateSet.t() *
+        querySet.cols(begin, end - 1));
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+    std::vector<std::pair<double, size_t>> candidates(numCandidates);
+    for (size_t q = begin; q < end; ++q)
+    {
+      const double queryNorm = std::pow(arma::norm(querySet.col(q)), 2.0);
+      for (size_t r = 0; r < numCandidates; ++r)
+      {
+        candidates[r] = std::make_pair(queryNorm + candidateNorms[r] -
+            2.0 * products(r, q - begin), r);
+      }
 
-  rules.GetResults(neighbors, distances);
+      // Take the k furthest candidates (the first in the candidate set when
+      // there is a tie), and compute their distances exactly, so that they do
+      // not suffer from the cancellation of the expansion above.
+      std::partial_sort(candidates.begin(), candidates.begin() + k,
+          candidates.end(), FurtherCandidate);
+      for (size_t j = 0; j < k; ++j)
+      {
+        const size_t r = candidates[j].second;
+        candidates[j].first = metric::EuclideanDistance::Evaluate(
+            querySet.col(q), candidateSet.col(r));
+      }
+      std::stable_sort(candidates.begin(), candidates.begin() + k,
+          FurtherCandidate);
 
-  // Map the neighbors back to their original indices in the reference set.
-  for (size_t i = 0; i < neighbors.n_elem; ++i)
-    neighbors[i] = candidateIndices[neighbors[i]];
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, q) = candidateIndices[candidates[j].second];
+        distances(j, q) = candidates[j].first;
+      }
+    }
+  }
 }
 
 //! Serialize the model.
@@ -34,6 +34,8 @@ template<typename MatType = arma::mat>
 class QDAFN
 {
  public:
+  typedef typename MatType::elem_type ElemType;
+
   /**
    * Construct the QDAFN object but do not train it.  Be sure to call Train()
    * before calling Search().
@@ -73,6 +75,11 @@ class QDAFN
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
    * mlpack NeighborSearch and LSHSearch classes.
+   *
+   * The query points are searched in parallel (with OpenMP), and their
+   * projections on the random lines take one matrix product.  If fewer than k
+   * distinct candidates are found for a query point, the remaining neighbors
+   * are set to SIZE_MAX (and their distances to 0).
    */
   void Search(const MatType& querySet,
               const size_t k,
@@ -97,14 +104,14 @@ class QDAFN
   //! The number of elements to store for each projection.
   size_t m;
   //! The random lines we are projecting onto.  Has l columns.
-  arma::mat lines;
+  arma::Mat<ElemType> lines;
   //! Projections of each point onto each random line.
-  arma::mat projections;
+  arma::Mat<ElemType> projections;
 
   //! Indices of the points for each S.
   arma::Mat<size_t> sIndices;
   //! Values of a_i * x for each point in S.
-  arma::mat sValues;
+  arma::Mat<ElemType> sValues;
 
   // Candidate sets; one element in the vector for each table.
   std::vector<MatType> candidateSet;
@@ -64,7 +64,7 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   mlpack::distribution::GaussianDistribution gd(referenceSet.n_rows);
   lines.set_size(referenceSet.n_rows, l);
   for (size_t i = 0; i < l; ++i)
-    lines.col(i) = gd.Random();
+    lines.col(i) = arma::conv_to<arma::Col<ElemType>>::from(gd.Random());
 
   // Now, project each of the reference points onto each line, and collect the
   // top m elements.
@@ -104,8 +104,12 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
+  // The projections of all the query points on all the lines.
+  const arma::Mat<ElemType> queryProjections = lines.t() * querySet;
+
   // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
   {
     // Initialize a priority queue.
     // The size_t represents the index of the table, and the double represents
@@ -113,8 +117,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     std::priority_queue<std::pair<double, size_t>> queue;
     for (size_t i = 0; i < l; ++i)
     {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
+      const double val = sValues(0, i) - queryProjections(i, q);
       queue.push(std::make_pair(val, i));
     }
 
@@ -122,14 +125,12 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     // in each table (they start at 0).
     arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
 
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+    // Now that the queue is initialized, iterate over m elements, and collect
+    // their distances to the query point.
+    std::vector<std::pair<double, size_t>> results(m);
     for (size_t i = 0; i < m; ++i)
     {
-      std::pair<size_t, double> p = queue.top();
+      const std::pair<double, size_t> p = queue.top();
       queue.pop();
 
       // Get index of reference point to look at.
@@ -139,7 +140,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       const double dist = mlpack::metric::EuclideanDistance::Evaluate(
           querySet.col(q), candidateSet[p.second].col(tableIndex));
 
-      resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
+      results[i] = std::make_pair(dist, sIndices(tableIndex, p.second));
 
       // Now (line 14) get the next element and insert into the queue.  Do this
       // by adjusting the previous value.  Don't insert anything if we are at
@@ -154,27 +155,21 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       }
     }
 
-    // Extract the results and deduplicate them.
-    size_t extracted = 1;
-    neighbors(0, q) = resultsQueue.top().second;
-    distances(0, q) = resultsQueue.top().first;
-    resultsQueue.pop();
+    // Sort the results from the furthest, and extract the first k distinct
+    // points.  A point that is in several tables has the same distance each
+    // time, so its copies are adjacent.
+    std::sort(results.begin(), results.end(),
+        std::greater<std::pair<double, size_t>>());
 
-    while (!resultsQueue.empty())
+    size_t extracted = 0;
+    for (size_t i = 0; i < results.size() && extracted < k; ++i)
     {
-      if (extracted == k)
-        break;
-
-      std::pair<double, size_t> result = resultsQueue.top();
-      resultsQueue.pop();
+      if (extracted > 0 && neighbors(extracted - 1, q) == results[i].second)
+        continue;
 
-      // Avoid inserting any duplicates.
-      if (neighbors(extracted - 1, q) != result.second)
-      {
-        neighbors(extracted, q) = resultsQueue.top().second;
-        distances(extracted, q) = resultsQueue.top().first;
-        ++extracted;
-      }
+      neighbors(extracted, q) = results[i].second;
+      distances(extracted, q) = results[i].first;
+      ++extracted;
     }
   }
 }
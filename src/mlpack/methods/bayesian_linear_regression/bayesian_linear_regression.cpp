@@ -33,15 +33,74 @@ BayesianLinearRegression::BayesianLinearRegression(const bool centerData,
 double BayesianLinearRegression::Train(const arma::mat& data,
                                        const arma::rowvec& responses)
 {
-  arma::mat phi;
-  arma::rowvec t;
-  arma::colvec eigVal;
-  arma::mat eigVec;
+  statistics = NormalEquations();
+  return PartialFit(data, responses);
+}
 
-  // Preprocess the data. Center and scale.
-  responsesOffset = CenterScaleData(data, responses, phi, t);
+double BayesianLinearRegression::Train(const arma::sp_mat& data,
+                                       const arma::rowvec& responses)
+{
+  statistics = NormalEquations();
+  return PartialFit(data, responses);
+}
 
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
+double BayesianLinearRegression::PartialFit(const arma::mat& data,
+                                            const arma::rowvec& responses)
+{
+  statistics.Update(data, responses);
+  Solve();
+  return RMSE(data, responses);
+}
+
+double BayesianLinearRegression::PartialFit(const arma::sp_mat& data,
+                                            const arma::rowvec& responses)
+{
+  statistics.Update(data, responses);
+  Solve();
+  return RMSE(data, responses);
+}
+
+void BayesianLinearRegression::Solve()
+{
+  const double n = (double) statistics.Count();
+
+  // Form phi * phi^T, phi * t^T and t * t^T for the centered and scaled data
+  // phi and responses t from the statistics.
+  arma::mat phiPhit;
+  arma::colvec phitT;
+  double tTt;
+  if (centerData)
+  {
+    dataOffset = statistics.DataMean();
+    responsesOffset = statistics.ResponsesMean();
+    phiPhit = statistics.Scatter();
+    phitT = statistics.CrossScatter();
+    tTt = statistics.ResponsesScatter();
+  }
+  else
+  {
+    dataOffset.reset();
+    responsesOffset = 0.0;
+    phiPhit = statistics.Gram();
+    phitT = statistics.Correlations();
+    tTt = statistics.ResponsesSquares();
+  }
+
+  if (scaleData)
+  {
+    dataScale = sqrt(statistics.Scatter().diag() / (n - 1));
+    phiPhit.each_col() /= dataScale;
+    phiPhit.each_row() /= dataScale.t();
+    phitT /= dataScale;
+  }
+  else
+  {
+    dataScale.reset();
+  }
+
+  arma::colvec eigVal;
+  arma::mat eigVec;
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phiPhit)))
   {
     Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
                << "of covariance failed!" << std::endl;
@@ -49,11 +108,12 @@ double BayesianLinearRegression::Train(const arma::mat& data,
 
   // Compute this quantities once and for all.
   const arma::mat eigVecInv = inv(eigVec);
-  const arma::colvec eigVecInvPhitT = eigVecInv * phi * t.t();
+  const arma::colvec eigVecInvPhitT = eigVecInv * phitT;
 
   // Initialize the hyperparameters and begin with an infinitely broad prior.
+  // The variance of t does not depend on whether it is centered.
   alpha = 1e-6;
-  beta =  1 / (var(t, 1) * 0.1);
+  beta =  1 / ((statistics.ResponsesScatter() / n) * 0.1);
 
   unsigned short i = 0;
   double deltaAlpha = 1.0, crit = 1.0;
@@ -70,9 +130,13 @@ double BayesianLinearRegression::Train(const arma::mat& data,
     gamma = sum(eigVal / (alpha / beta + eigVal));
     alpha = gamma / dot(omega, omega);
 
-    // Update beta.
-    const arma::rowvec temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+    // Update beta.  The squared norm of t - omega^T phi is expanded, so that
+    // the data is not needed; the expansion cannot resolve a norm below its
+    // rounding error, so that is the smallest norm used.
+    const double residual = std::max(tTt - 2 * dot(omega, phitT) +
+        dot(omega, phiPhit * omega),
+        std::numeric_limits<double>::epsilon() * tTt);
+    beta = (n - gamma) / residual;
 
     // Compute the stopping criterion.
     deltaAlpha += alpha;
@@ -82,8 +146,6 @@ double BayesianLinearRegression::Train(const arma::mat& data,
   }
   // Compute the covariance matrix for the uncertainties later.
   matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVecInv;
-
-  return RMSE(data, responses);
 }
 
 void BayesianLinearRegression::Predict(const arma::mat& points,
@@ -95,6 +157,21 @@ void BayesianLinearRegression::Predict(const arma::mat& points,
   predictions = omega.t() * matX + responsesOffset;
 }
 
+void BayesianLinearRegression::Predict(const arma::sp_mat& points,
+                                       arma::rowvec& predictions) const
+{
+  // omega^T D^-1 (x - mu) is (D^-1 omega)^T x - (D^-1 omega)^T mu, where D is
+  // the diagonal matrix of the scales.
+  arma::colvec w = omega;
+  if (scaleData)
+    w /= dataScale;
+
+  predictions = w.t() * points;
+  if (centerData)
+    predictions -= dot(w, dataOffset);
+  predictions += responsesOffset;
+}
+
 void BayesianLinearRegression::Predict(const arma::mat& points,
                                        arma::rowvec& predictions,
                                        arma::rowvec& std) const
@@ -115,46 +192,12 @@ double BayesianLinearRegression::RMSE(const arma::mat& data,
   return sqrt(mean(square(responses - predictions)));
 }
 
-double BayesianLinearRegression::CenterScaleData(const arma::mat& data,
-                                                 const arma::rowvec& responses,
-                                                 arma::mat& dataProc,
-                                                 arma::rowvec& responsesProc)
+double BayesianLinearRegression::RMSE(const arma::sp_mat& data,
+                                      const arma::rowvec& responses) const
 {
-  if (!centerData && !scaleData)
-  {
-    dataProc = arma::mat(const_cast<double*>(data.memptr()), data.n_rows,
-                                             data.n_cols, false, true);
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else if (centerData && !scaleData)
-  {
-    dataOffset = mean(data, 1);
-    responsesOffset = mean(responses);
-    dataProc = data.each_col() - dataOffset;
-    responsesProc = responses - responsesOffset;
-  }
-
-  else if (!centerData && scaleData)
-  {
-    dataScale = stddev(data, 0, 1);
-    dataProc = data.each_col() / dataScale;
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else
-  {
-    dataOffset = mean(data, 1);
-    dataScale = stddev(data, 0, 1);
-    responsesOffset = mean(responses);
-    dataProc = (data.each_col() - dataOffset).each_col() / dataScale;
-    responsesProc = responses - responsesOffset;
-  }
-  return responsesOffset;
+  arma::rowvec predictions;
+  Predict(data, predictions);
+  return sqrt(mean(square(responses - predictions)));
 }
 
 void BayesianLinearRegression::CenterScaleDataPred(
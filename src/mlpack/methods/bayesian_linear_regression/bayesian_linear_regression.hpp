@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_BAYESIAN_LINEAR_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/linear_regression/normal_equations.hpp>
 
 namespace mlpack {
 namespace regression {
@@ -46,6 +47,12 @@ namespace regression {
  * function described in the section 3.5.2 of the C.Bishop book, Pattern
  * Recognition and Machine Learning.
  *
+ * Everything the maximization needs is computed from the statistics of the
+ * normal equations (see NormalEquations), which are accumulated in parallel in
+ * a single pass over the data.  The statistics are kept, so PartialFit() can
+ * add more data to the model a chunk at a time.  Dense and sparse data are
+ * supported.
+ *
  * @code
  * @article{MacKay91bayesianinterpolation,
  *   author = {David J.C. MacKay},
@@ -129,6 +136,40 @@ class BayesianLinearRegression
   double Train(const arma::mat& data,
                const arma::rowvec& responses);
 
+  /**
+   * Run BayesianLinearRegression on sparse data.  See the other overload.
+   *
+   * @param data Column-major input data, dim(P, N).
+   * @param responses A vector of targets, dim(N).
+   * @return Root mean squared error.
+   */
+  double Train(const arma::sp_mat& data,
+               const arma::rowvec& responses);
+
+  /**
+   * Add the given data to the model, and train it again.  The result is the
+   * same as if Train() had been called with all of the data given to Train()
+   * and PartialFit() since the model was last trained, but only the statistics
+   * of that data are kept.
+   *
+   * @param data Column-major input data, dim(P, N).
+   * @param responses A vector of targets, dim(N).
+   * @return Root mean squared error on the given data.
+   */
+  double PartialFit(const arma::mat& data,
+                    const arma::rowvec& responses);
+
+  /**
+   * Add the given sparse data to the model, and train it again.  See the
+   * other overload.
+   *
+   * @param data Column-major input data, dim(P, N).
+   * @param responses A vector of targets, dim(N).
+   * @return Root mean squared error on the given data.
+   */
+  double PartialFit(const arma::sp_mat& data,
+                    const arma::rowvec& responses);
+
   /**
    * Predict \f$y_{i}\f$ for each data point in the given data matrix using the
    * currently-trained Bayesian Ridge model.
@@ -140,6 +181,17 @@ class BayesianLinearRegression
   void Predict(const arma::mat& points,
                arma::rowvec& predictions) const;
 
+  /**
+   * Predict \f$y_{i}\f$ for each data point in the given sparse data matrix
+   * using the currently-trained Bayesian Ridge model.  The centering and
+   * scaling are folded into the solution, so the points are not densified.
+   *
+   * @param points The data points to apply the model.
+   * @param predictions y, Contains the  predicted values on completion.
+   */
+  void Predict(const arma::sp_mat& points,
+               arma::rowvec& predictions) const;
+
   /**
    * Predict \f$y_{i}\f$ and the standard deviation of the predictive posterior
    * distribution for each data point in the given data matrix, using the
@@ -165,6 +217,17 @@ class BayesianLinearRegression
   double RMSE(const arma::mat& data,
               const arma::rowvec& responses) const;
 
+  /**
+   * Compute the Root Mean Square Error between the predictions returned by the
+   * model and the true responses, for sparse data.
+   *
+   * @param data Data points to predict
+   * @param responses A vector of targets.
+   * @return Root mean squared error.
+   **/
+  double RMSE(const arma::sp_mat& data,
+              const arma::rowvec& responses) const;
+
   /**
    * Get the solution vector.
    *
@@ -239,6 +302,9 @@ class BayesianLinearRegression
   //! Modify the tolerance for training to converge.
   double& Tolerance() { return tolerance; }
 
+  //! Get the statistics of the data the model was trained on.
+  const NormalEquations& Statistics() const { return statistics; }
+
   /**
    * Serialize the BayesianLinearRegression model.
    */
@@ -282,20 +348,14 @@ class BayesianLinearRegression
   //! Covariance matrix of the solution vector omega.
   arma::mat matCovariance;
 
+  //! The statistics of the data the model was trained on.
+  NormalEquations statistics;
+
   /**
-   * Center and scale the data accordind to centerData and scaleData.
-   * Allows future modifications of new points.
-   *
-   * @param data Design matrix in column-major format, dim(P, N).
-   * @param responses A vector of targets.
-   * @param dataProc Data processed, dim(P, N).
-   * @param responsesProc Responses processed, dim(N).
-   * @return reponsesOffset Mean of responses.
+   * Center and scale the data according to centerData and scaleData, and
+   * maximize the evidence, all from the statistics of the data.
    */
-  double CenterScaleData(const arma::mat& data,
-                         const arma::rowvec& responses,
-                         arma::mat& dataProc,
-                         arma::rowvec& responsesProc);
+  void Solve();
 
   /**
    * Center and scale the points before prediction.
@@ -312,4 +372,6 @@ class BayesianLinearRegression
 // Include implementation of serialize.
 #include "bayesian_linear_regression_impl.hpp"
 
+CEREAL_CLASS_VERSION(mlpack::regression::BayesianLinearRegression, 1);
+
 #endif
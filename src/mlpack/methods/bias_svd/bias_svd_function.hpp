@@ -136,6 +136,25 @@ class BiasSVDFunction
   size_t numItems;
 };
 
+/**
+ * Optimize the given BiasSVDFunction with stratified parallel SGD: in each
+ * epoch, the ratings are visited one stratum of RatingBlocks at a time, and the
+ * blocks of a stratum are processed by different threads.  The blocks share no
+ * user or item, so the parameters are updated without atomics or locks.  The
+ * ParallelSGD specializations below call this; the thread share size of the
+ * optimizer is not used.
+ *
+ * @param optimizer Parallel SGD optimizer holding the parameters of the
+ *     optimization.
+ * @param function The BiasSVDFunction to optimize.
+ * @param iterate Starting point; the optimized parameters will be stored here.
+ * @return Objective value of the final point.
+ */
+template<typename DecayPolicyType>
+double StratifiedOptimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                          BiasSVDFunction<arma::mat>& function,
+                          arma::mat& iterate);
+
 } // namespace svd
 } // namespace mlpack
 
@@ -163,6 +182,12 @@ namespace ens {
       mlpack::svd::BiasSVDFunction<arma::mat>& function,
       arma::mat& parameters);
 
+  template <>
+  template <>
+  inline double ParallelSGD<ConstantStep>::Optimize(
+      mlpack::svd::BiasSVDFunction<arma::mat>& function,
+      arma::mat& parameters);
+
 } // namespace ens
 
 /**
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_BIAS_SVD_BIAS_SVD_FUNCTION_IMPL_HPP
 
 #include "bias_svd_function.hpp"
+#include "rating_blocks.hpp"
 #include <mlpack/core/math/make_alias.hpp>
 
 namespace mlpack {
@@ -178,6 +179,120 @@ void BiasSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template<typename DecayPolicyType>
+double StratifiedOptimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                          BiasSVDFunction<arma::mat>& function,
+                          arma::mat& iterate)
+{
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  const arma::mat& data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const double lambda = function.Lambda();
+
+  // Rank of decomposition.
+  const size_t rank = function.Rank();
+
+  // Each thread gets one block of users and one block of items in each
+  // stratum, so no two threads ever touch the same parameter column.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+    numBlocks = omp_get_max_threads();
+  #endif
+  RatingBlocks blocks(data, numUsers, function.NumItems(), numBlocks);
+  arma::uvec strata = arma::linspace<arma::uvec>(0, blocks.NumBlocks() - 1,
+      blocks.NumBlocks());
+
+  // Iterate till the objective is within tolerance or the maximum number of
+  // allowed iterations is reached. If maxIterations is 0, this will iterate
+  // till convergence.
+  for (size_t i = 1; i != optimizer.MaxIterations(); ++i)
+  {
+    // Calculate the overall objective.
+    lastObjective = overallObjective;
+    overallObjective = 0;
+
+    #pragma omp parallel for reduction(+:overallObjective)
+    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
+    {
+      overallObjective += function.Evaluate(iterate, j);
+    }
+
+    // Output current objective function.
+    Log::Info << "Parallel SGD: iteration " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Parallel SGD: converged to " << overallObjective
+          << "; terminating with failure. Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < optimizer.Tolerance())
+    {
+      Log::Info << "SGD: minimized within tolerance " << optimizer.Tolerance()
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    // Get the stepsize for this iteration
+    const double stepSize = optimizer.DecayPolicy().StepSize(i);
+
+    if (optimizer.Shuffle()) // Determine order of visitation.
+    {
+      blocks.Shuffle();
+      strata = arma::shuffle(strata);
+    }
+
+    for (size_t s = 0; s < strata.n_elem; ++s)
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) blocks.NumBlocks(); ++b)
+      {
+        const size_t itemBlock = blocks.ItemBlock(b, strata[s]);
+        const size_t end = blocks.End(b, itemBlock);
+        for (size_t j = blocks.Begin(b, itemBlock); j < end; ++j)
+        {
+          // Indices for accessing the the correct parameter columns.
+          const size_t example = blocks.Rating(j);
+          const size_t user = data(0, example);
+          const size_t item = data(1, example) + numUsers;
+
+          // Prediction error for the example.
+          const double rating = data(2, example);
+          const double userBias = iterate(rank, user);
+          const double itemBias = iterate(rank, item);
+          const double ratingError = rating - userBias - itemBias -
+              arma::dot(iterate.col(user).subvec(0, rank - 1),
+                        iterate.col(item).subvec(0, rank - 1));
+
+          const arma::vec userVec = iterate.col(user).subvec(0, rank - 1);
+
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example, which belong to this block only.
+          iterate.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+              lambda * userVec -
+              ratingError * iterate.col(item).subvec(0, rank - 1));
+          iterate.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+              lambda * iterate.col(item).subvec(0, rank - 1) -
+              ratingError * userVec);
+          iterate(rank, user) -= stepSize * 2 * (
+              lambda * iterate(rank, user) - ratingError);
+          iterate(rank, item) -= stepSize * 2 * (
+              lambda * iterate(rank, item) - ratingError);
+        }
+      }
+    }
+  }
+  Log::Info << "\n Parallel SGD terminated with objective : "
+      << overallObjective << std::endl;
+
+  return overallObjective;
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -264,117 +379,16 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     mlpack::svd::BiasSVDFunction<arma::mat>& function,
     arma::mat& iterate)
 {
-  double overallObjective = DBL_MAX;
-  double lastObjective;
-
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-  const size_t numUsers = function.NumUsers();
-  const double lambda = function.Lambda();
-
-  // Rank of decomposition.
-  const size_t rank = function.Rank();
-
-  // Iterate till the objective is within tolerance or the maximum number of
-  // allowed iterations is reached. If maxIterations is 0, this will iterate
-  // till convergence.
-  for (size_t i = 1; i != maxIterations; ++i)
-  {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-    overallObjective = 0;
-
-    #pragma omp parallel for reduction(+:overallObjective)
-    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
-    {
-      overallObjective += function.Evaluate(iterate, j);
-    }
-
-    // Output current objective function.
-    mlpack::Log::Info << "Parallel SGD: iteration " << i << ", objective "
-        << overallObjective << "." << std::endl;
-
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
-    {
-      mlpack::Log::Warn << "Parallel SGD: converged to " << overallObjective
-          << "; terminating with failure. Try a smaller step size?"
-          << std::endl;
-      return overallObjective;
-    }
-
-    if (std::abs(lastObjective - overallObjective) < tolerance)
-    {
-      mlpack::Log::Info << "SGD: minimized within tolerance " << tolerance
-          << "; terminating optimization." << std::endl;
-      return overallObjective;
-    }
-
-    // Get the stepsize for this iteration
-    double stepSize = decayPolicy.StepSize(i);
-
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-
-    #pragma omp parallel
-    {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        double ratingError = rating - userBias - itemBias -
-            arma::dot(iterate.col(user).subvec(0, rank - 1),
-                      iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * iterate.col(user).subvec(0, rank - 1));
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-      }
-    }
-  }
-  mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
-    << overallObjective << std::endl;
+  return mlpack::svd::StratifiedOptimize(*this, function, iterate);
+}
 
-  return overallObjective;
+template <>
+template <>
+inline double ParallelSGD<ConstantStep>::Optimize(
+    mlpack::svd::BiasSVDFunction<arma::mat>& function,
+    arma::mat& iterate)
+{
+  return mlpack::svd::StratifiedOptimize(*this, function, iterate);
 }
 
 } // namespace ens
@@ -0,0 +1,100 @@
+/**
+ * @file methods/bias_svd/rating_blocks.hpp
+ *
+ * Definition of the RatingBlocks class, which partitions a rating dataset into
+ * blocks of users and items for stratified parallel SGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_BIAS_SVD_RATING_BLOCKS_HPP
+#define MLPACK_METHODS_BIAS_SVD_RATING_BLOCKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * The RatingBlocks class splits the users and the items of a rating dataset
+ * into the same number of blocks, and groups the ratings by their user block
+ * and item block.  In stratum s, user block b is paired with item block
+ * (b + s) mod NumBlocks(), so the blocks of one stratum share no user and no
+ * item, and can be given to different threads without any synchronization.
+ * Every rating is in exactly one stratum.  This is the stratification of
+ * distributed SGD (DSGD; Gemulla et al., 2011).
+ *
+ * Users and items are assigned to blocks in random order, cutting so that each
+ * block holds about the same number of ratings.
+ */
+class RatingBlocks
+{
+ public:
+  /**
+   * Partition the given ratings.
+   *
+   * @param data Rating dataset; each column is (user, item, rating).
+   * @param numUsers Number of users.
+   * @param numItems Number of items.
+   * @param numBlocks Number of blocks of users (and of items).
+   */
+  RatingBlocks(const arma::mat& data,
+               const size_t numUsers,
+               const size_t numItems,
+               const size_t numBlocks);
+
+  /**
+   * Shuffle the order of the ratings inside each block.
+   */
+  void Shuffle();
+
+  //! Get the number of blocks of users (and of items).
+  size_t NumBlocks() const { return numBlocks; }
+
+  //! Get the item block paired with the given user block in the given stratum.
+  size_t ItemBlock(const size_t userBlock, const size_t stratum) const
+  {
+    return (userBlock + stratum) % numBlocks;
+  }
+
+  //! Get the position of the first rating of the given block.
+  size_t Begin(const size_t userBlock, const size_t itemBlock) const
+  {
+    return offsets[userBlock * numBlocks + itemBlock];
+  }
+
+  //! Get the position after the last rating of the given block.
+  size_t End(const size_t userBlock, const size_t itemBlock) const
+  {
+    return offsets[userBlock * numBlocks + itemBlock + 1];
+  }
+
+  //! Get the column of the dataset of the rating at the given position.
+  size_t Rating(const size_t position) const { return ratings[position]; }
+
+ private:
+  /**
+   * Assign the given number of elements to blocks, in random order, so that
+   * every block gets about the same total count.
+   */
+  static void Assign(const arma::Col<size_t>& counts,
+                     const size_t numBlocks,
+                     arma::Col<size_t>& blocks);
+
+  //! The number of blocks of users (and of items).
+  size_t numBlocks;
+  //! The start of each block in ratings, in row-major block order.
+  arma::Col<size_t> offsets;
+  //! The columns of the ratings of the dataset, grouped by block.
+  arma::Col<size_t> ratings;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+// Include implementation.
+#include "rating_blocks_impl.hpp"
+
+#endif
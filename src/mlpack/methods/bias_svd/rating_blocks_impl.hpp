@@ -0,0 +1,90 @@
+/**
+ * @file methods/bias_svd/rating_blocks_impl.hpp
+ *
+ * Implementation of the RatingBlocks class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_BIAS_SVD_RATING_BLOCKS_IMPL_HPP
+#define MLPACK_METHODS_BIAS_SVD_RATING_BLOCKS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "rating_blocks.hpp"
+
+namespace mlpack {
+namespace svd {
+
+inline RatingBlocks::RatingBlocks(const arma::mat& data,
+                                  const size_t numUsers,
+                                  const size_t numItems,
+                                  const size_t numBlocks) :
+    numBlocks(std::max(numBlocks, (size_t) 1))
+{
+  // Count the ratings of each user and item, and assign them to blocks.
+  arma::Col<size_t> userCounts(numUsers, arma::fill::zeros);
+  arma::Col<size_t> itemCounts(numItems, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    ++userCounts[(size_t) data(0, i)];
+    ++itemCounts[(size_t) data(1, i)];
+  }
+
+  arma::Col<size_t> userBlocks, itemBlocks;
+  Assign(userCounts, this->numBlocks, userBlocks);
+  Assign(itemCounts, this->numBlocks, itemBlocks);
+
+  // Sort the ratings by block with a counting sort.
+  const size_t totalBlocks = this->numBlocks * this->numBlocks;
+  arma::Col<size_t> blockOf(data.n_cols);
+  offsets.zeros(totalBlocks + 1);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    blockOf[i] = userBlocks[(size_t) data(0, i)] * this->numBlocks +
+        itemBlocks[(size_t) data(1, i)];
+    ++offsets[blockOf[i] + 1];
+  }
+
+  for (size_t b = 0; b < totalBlocks; ++b)
+    offsets[b + 1] += offsets[b];
+
+  arma::Col<size_t> next = offsets.subvec(0, totalBlocks - 1);
+  ratings.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    ratings[next[blockOf[i]]++] = i;
+}
+
+inline void RatingBlocks::Shuffle()
+{
+  for (size_t b = 0; b < numBlocks * numBlocks; ++b)
+  {
+    std::shuffle(ratings.begin() + offsets[b], ratings.begin() + offsets[b + 1],
+        math::RandGen());
+  }
+}
+
+inline void RatingBlocks::Assign(const arma::Col<size_t>& counts,
+                                 const size_t numBlocks,
+                                 arma::Col<size_t>& blocks)
+{
+  const size_t total = arma::accu(counts);
+  blocks.zeros(counts.n_elem);
+  if (total == 0)
+    return;
+
+  // Each element goes to the block its first rating falls in.
+  const arma::uvec order = arma::randperm(counts.n_elem);
+  size_t seen = 0;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    blocks[order[i]] = std::min(seen * numBlocks / total, numBlocks - 1);
+    seen += counts[order[i]];
+  }
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
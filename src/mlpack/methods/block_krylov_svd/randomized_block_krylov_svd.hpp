@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/parallel_multiply.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -104,6 +105,44 @@ class RandomizedBlockKrylovSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized block krylov SVD.  The products with the data are computed
+   * in parallel, and the data is never made dense.
+   *
+   * @param data Sparse data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * randomized block krylov SVD, centering the data on the given mean.  The
+   * centering is applied implicitly in the products with the data, so no
+   * centered (or, for sparse data, dense) copy of the data is made.
+   *
+   * @param data Data matrix (dense or sparse).
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   * @param rowMean Mean to center the data on (empty for no centering).
+   */
+  template<typename MatType>
+  void Apply(const MatType& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank,
+             const arma::mat& rowMean);
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -125,4 +164,7 @@ class RandomizedBlockKrylovSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_block_krylov_svd_impl.hpp"
+
 #endif
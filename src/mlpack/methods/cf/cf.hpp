@@ -17,7 +17,9 @@
 #define MLPACK_METHODS_CF_CF_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
@@ -31,6 +33,39 @@
 
 namespace mlpack {
 namespace cf /** Collaborative filtering. **/ {
+
+// This gives us a HasGetRatingOfUsers<T> type, where
+// HasGetRatingOfUsers<T>::value is true if the decomposition policy T can
+// compute the ratings of a batch of users at once.
+HAS_ANY_METHOD_FORM(GetRatingOfUsers, HasGetRatingOfUsers);
+
+// This gives us a HasGetUserFactors<T> type, where HasGetUserFactors<T>::value
+// is true if the decomposition policy T predicts ratings as W() times the
+// combined user factors.
+HAS_ANY_METHOD_FORM(GetUserFactors, HasGetUserFactors);
+
+class ItemMeanNormalization;
+template<typename... NormalizationTypes>
+class CombinedNormalization;
+
+/**
+ * IsItemIndependentNormalization<T>::value is true if the normalization T
+ * denormalizes all ratings of a user with the same increasing function, so
+ * that the order of the items of a user does not depend on it.  This holds for
+ * every normalization but ItemMeanNormalization (and, to be safe, any
+ * CombinedNormalization).
+ */
+template<typename NormalizationType>
+struct IsItemIndependentNormalization : public std::true_type { };
+
+template<>
+struct IsItemIndependentNormalization<ItemMeanNormalization> :
+    public std::false_type { };
+
+template<typename... NormalizationTypes>
+struct IsItemIndependentNormalization<
+    CombinedNormalization<NormalizationTypes...>> : public std::false_type { };
+
 /**
  * This class implements Collaborative Filtering (CF). This implementation
  * presently supports Alternating Least Squares (ALS) for collaborative
@@ -143,6 +178,38 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Fold the given ratings of new or existing users into the model without
+   * refactorizing the rating matrix.  The ratings are normalized with
+   * NormalizationType::FoldIn() and added to the rating table, and the factors
+   * (columns of H()) of every user in the data are solved for by regularized
+   * least squares against the fixed item factors W(), using all the ratings of
+   * that user.  Users not in the model yet are added; the items must already
+   * be in the model.
+   *
+   * The decomposition policy must predict ratings as W() * H() (it must have a
+   * GetUserFactors() method).
+   *
+   * @param data New ratings in the form of coordinate list (user, item,
+   *     rating).
+   * @param lambda Regularization parameter for the least squares problems.
+   */
+  void FoldInUsers(const arma::mat& data, const double lambda = 0.0);
+
+  /**
+   * Fold the given ratings of new or existing items into the model without
+   * refactorizing the rating matrix.  This is the same as FoldInUsers(), but
+   * the factors (rows of W()) of every item in the data are solved for against
+   * the fixed user factors H().  Items not in the model yet are added; the
+   * users must already be in the model.  An item index built by
+   * BuildItemIndex() is discarded.
+   *
+   * @param data New ratings in the form of coordinate list (user, item,
+   *     rating).
+   * @param lambda Regularization parameter for the least squares problems.
+   */
+  void FoldInItems(const arma::mat& data, const double lambda = 0.0);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -216,6 +283,23 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Build an index for maximum inner product search over the item factors,
+   * with FastMKS and the linear kernel.  Afterwards, GetRecommendations() finds
+   * the top items of each user by searching the index instead of rating every
+   * item, which takes time sublinear in the number of items.  The index is
+   * discarded by Train() and is not serialized, so call this again after
+   * training or loading the model.
+   *
+   * The decomposition policy must predict ratings as W() * H() (it must have a
+   * GetUserFactors() method), and the normalization must not depend on the
+   * item (see IsItemIndependentNormalization).
+   */
+  void BuildItemIndex();
+
+  //! Get whether an item index was built by BuildItemIndex().
+  bool HasItemIndex() const { return hasItemIndex; }
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -273,6 +357,87 @@ class CFType
   arma::sp_mat cleanedData;
   //! Data normalization object.
   NormalizationType normalization;
+  //! Maximum inner product search index over the item factors.
+  fastmks::FastMKS<kernel::LinearKernel> itemIndex;
+  //! Whether itemIndex has been built for the current factorization.
+  bool hasItemIndex;
+
+  //! The number of users whose ratings GetRecommendations() computes at once.
+  static constexpr size_t RecommendationBatchSize = 256;
+
+  /**
+   * Compute the ratings of a batch of users: column i of ratings is the sum
+   * over j of weights(j, i) times the ratings of user neighborhood(j, i).  The
+   * decomposition policy computes them at once with its GetRatingOfUsers()
+   * method.
+   */
+  template<typename PolicyType = DecompositionPolicy>
+  void GetRatingOfUsers(
+      const arma::Mat<size_t>& neighborhood,
+      const arma::mat& weights,
+      arma::mat& ratings,
+      const typename std::enable_if_t<
+          HasGetRatingOfUsers<PolicyType>::value>* = 0) const;
+
+  /**
+   * Compute the ratings of a batch of users as above, for decomposition
+   * policies without a GetRatingOfUsers() method; the users are handled in
+   * parallel with GetRatingOfUser().
+   */
+  template<typename PolicyType = DecompositionPolicy>
+  void GetRatingOfUsers(
+      const arma::Mat<size_t>& neighborhood,
+      const arma::mat& weights,
+      arma::mat& ratings,
+      const typename std::enable_if_t<
+          !HasGetRatingOfUsers<PolicyType>::value>* = 0) const;
+
+  /**
+   * Normalize the given new ratings and add them to cleanedData, growing it if
+   * they have new users or items.
+   */
+  void AddRatings(const arma::mat& data);
+
+  /**
+   * Solve for the given columns of factors by regularized least squares
+   * against the fixed factors: factors.col(c) minimizes the squared error of
+   * fixed.t() * factors.col(c) on the nonzero elements of ratings.col(c), plus
+   * lambda times its squared norm.
+   */
+  static void FoldInFactors(const arma::sp_mat& ratings,
+                            const arma::uvec& columns,
+                            const arma::mat& fixed,
+                            const double lambda,
+                            arma::mat& factors);
+
+  /**
+   * Find the top unrated items of the given users with the item index; column
+   * i of neighborhood and weights gives the combination of users that rates
+   * the items for users(i).
+   */
+  template<typename PolicyType = DecompositionPolicy>
+  void GetIndexedRecommendations(
+      const size_t numRecs,
+      arma::Mat<size_t>& recommendations,
+      const arma::Col<size_t>& users,
+      const arma::Mat<size_t>& neighborhood,
+      const arma::mat& weights,
+      const typename std::enable_if_t<
+          HasGetUserFactors<PolicyType>::value>* = 0);
+
+  /**
+   * This overload is never called, since no item index can be built for
+   * decomposition policies without a GetUserFactors() method.
+   */
+  template<typename PolicyType = DecompositionPolicy>
+  void GetIndexedRecommendations(
+      const size_t numRecs,
+      arma::Mat<size_t>& recommendations,
+      const arma::Col<size_t>& users,
+      const arma::Mat<size_t>& neighborhood,
+      const arma::mat& weights,
+      const typename std::enable_if_t<
+          !HasGetUserFactors<PolicyType>::value>* = 0);
 
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
@@ -30,7 +30,8 @@ CFType<DecompositionPolicy,
 CFType(const size_t numUsersForSimilarity,
        const size_t rank) :
     numUsersForSimilarity(numUsersForSimilarity),
-    rank(rank)
+    rank(rank),
+    hasItemIndex(false)
 {
   // Validate neighbourhood size.
   if (numUsersForSimilarity < 1)
@@ -58,7 +59,8 @@ CFType(const MatType& data,
        const double minResidue,
        const bool mit) :
     numUsersForSimilarity(numUsersForSimilarity),
-    rank(rank)
+    rank(rank),
+    hasItemIndex(false)
 {
   // Validate neighbourhood size.
   if (numUsersForSimilarity < 1)
@@ -84,6 +86,7 @@ Train(const arma::mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  hasItemIndex = false;
 
   // Make a copy of data before performing normalization.
   arma::mat normalizedData(data);
@@ -123,6 +126,7 @@ Train(const arma::sp_mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  hasItemIndex = false;
 
   // data is not used in the following decomposition.Apply() method, so we only
   // need to Normalize cleanedData.
@@ -197,78 +201,399 @@ GetRecommendations(const size_t numRecs,
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
   recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
 
   // Initialization of an InterpolationPolicy object should be put ahead of the
   // following loop, because the initialization may takes a relatively long
   // time and we don't want to repeat the initialization process in each loop.
   InterpolationPolicy interpolation(cleanedData);
 
+  // Calculate interpolation weights.  This is done serially, since some
+  // interpolation policies cache intermediate results.
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
   for (size_t i = 0; i < users.n_elem; ++i)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
         neighborhood.col(i), similarities.col(i), cleanedData);
+  }
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
-    {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
-    }
+  if (hasItemIndex)
+  {
+    GetIndexedRecommendations(numRecs, recommendations, users, neighborhood,
+        weights);
+    return;
+  }
+
+  // Default candidate: the smallest possible value and invalid item number.
+  const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
+  std::vector<char> incomplete(users.n_elem, 0);
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
+  // The ratings are computed for a batch of users at a time, so that they are
+  // one matrix product but do not have to be held for every user at once.
+  for (size_t batchBegin = 0; batchBegin < users.n_elem;
+       batchBegin += RecommendationBatchSize)
+  {
+    const size_t batchEnd = std::min(batchBegin + RecommendationBatchSize,
+        (size_t) users.n_elem);
+
+    // First, calculate the weighted sum of neighborhood values.
+    arma::mat ratings;
+    GetRatingOfUsers(neighborhood.cols(batchBegin, batchEnd - 1),
+        weights.cols(batchBegin, batchEnd - 1), ratings);
 
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) (batchEnd - batchBegin); ++b)
     {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
+      const size_t i = batchBegin + b;
+      const size_t user = users(i);
+
+      // Let's build the list of candidate recomendations for the given user.
+      std::vector<Candidate> vect(numRecs, def);
+      typedef std::priority_queue<Candidate, std::vector<Candidate>,
+          CandidateCmp> CandidateList;
+      CandidateList pqueue(CandidateCmp(), std::move(vect));
+
+      // The items the user already rated are the nonzeros of its column, in
+      // increasing order, so they are skipped while walking the items.  The
+      // algorithm omits rating of zero. Thus, when normalizing original
       // ratings in Normalize(), if normalized rating equals zero, it is set
       // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
+      arma::sp_mat::const_iterator rated = cleanedData.begin_col(user);
+      const arma::sp_mat::const_iterator ratedEnd = cleanedData.end_col(user);
 
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
+      // Look through the ratings column corresponding to the current user.
+      for (size_t j = 0; j < ratings.n_rows; ++j)
       {
-        Candidate c = std::make_pair(realRating, j);
+        if (rated != ratedEnd && rated.row() == j)
+        {
+          ++rated;
+          continue; // The user already rated the item.
+        }
+
+        // Is the estimated value better than the worst candidate?
+        // Denormalize rating before comparison.
+        double realRating = normalization.Denormalize(user, j, ratings(j, b));
+        if (realRating > pqueue.top().first)
+        {
+          Candidate c = std::make_pair(realRating, j);
+          pqueue.pop();
+          pqueue.push(c);
+        }
+      }
+
+      for (size_t p = 1; p <= numRecs; p++)
+      {
+        recommendations(numRecs - p, i) = pqueue.top().second;
         pqueue.pop();
-        pqueue.push(c);
       }
-    }
 
-    for (size_t p = 1; p <= numRecs; p++)
-    {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      if (recommendations(numRecs - 1, i) == def.second)
+        incomplete[i] = 1;
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (incomplete[i])
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
   }
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInUsers(const arma::mat& data, const double lambda)
+{
+  static_assert(HasGetUserFactors<DecompositionPolicy>::value,
+      "CFType::FoldInUsers(): the decomposition policy must predict ratings "
+      "as W() * H() and have a GetUserFactors() method");
+
+  if (data.n_cols == 0)
+    return;
+
+  if ((size_t) arma::max(data.row(1)) >= cleanedData.n_rows)
+  {
+    Log::Fatal << "CFType::FoldInUsers(): item indices must be less than the "
+        << "number of items in the model (" << cleanedData.n_rows << ")!"
+        << std::endl;
+  }
+
+  AddRatings(data);
+
+  // New users start with zero factors, and are then solved for like the
+  // others.
+  arma::mat& h = decomposition.H();
+  h.resize(h.n_rows, cleanedData.n_cols);
+  const arma::uvec users =
+      arma::unique(arma::conv_to<arma::uvec>::from(data.row(0)));
+  FoldInFactors(cleanedData, users, decomposition.W().t(), lambda, h);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInItems(const arma::mat& data, const double lambda)
+{
+  static_assert(HasGetUserFactors<DecompositionPolicy>::value,
+      "CFType::FoldInItems(): the decomposition policy must predict ratings "
+      "as W() * H() and have a GetUserFactors() method");
+
+  if (data.n_cols == 0)
+    return;
+
+  if ((size_t) arma::max(data.row(0)) >= cleanedData.n_cols)
+  {
+    Log::Fatal << "CFType::FoldInItems(): user indices must be less than the "
+        << "number of users in the model (" << cleanedData.n_cols << ")!"
+        << std::endl;
+  }
+
+  AddRatings(data);
+
+  // The items are the columns of W^T and of the transposed rating table.
+  arma::mat itemFactors = decomposition.W().t();
+  itemFactors.resize(itemFactors.n_rows, cleanedData.n_rows);
+  const arma::uvec items =
+      arma::unique(arma::conv_to<arma::uvec>::from(data.row(1)));
+  const arma::sp_mat itemRatings = cleanedData.t();
+  FoldInFactors(itemRatings, items, decomposition.H(), lambda, itemFactors);
+  decomposition.W() = itemFactors.t();
+
+  hasItemIndex = false;
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+AddRatings(const arma::mat& data)
+{
+  arma::mat normalizedData(data);
+  normalization.FoldIn(normalizedData);
+
+  const size_t numItems = std::max((size_t) cleanedData.n_rows,
+      (size_t) arma::max(data.row(1)) + 1);
+  const size_t numUsers = std::max((size_t) cleanedData.n_cols,
+      (size_t) arma::max(data.row(0)) + 1);
+  cleanedData.resize(numItems, numUsers);
+
+  for (size_t i = 0; i < normalizedData.n_cols; ++i)
+  {
+    const size_t user = (size_t) normalizedData(0, i);
+    const size_t item = (size_t) normalizedData(1, i);
+
+    // As in CleanData(), ratings of zero are omitted.
+    if (normalizedData(2, i) == 0)
+    {
+      Log::Warn << "User rating of 0 ignored for user " << user << ", item "
+          << item << "." << std::endl;
+    }
+
+    cleanedData(item, user) = normalizedData(2, i);
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInFactors(const arma::sp_mat& ratings,
+              const arma::uvec& columns,
+              const arma::mat& fixed,
+              const double lambda,
+              arma::mat& factors)
+{
+  const size_t rank = fixed.n_rows;
+  size_t failures = 0;
+
+  // Reading the ratings brings their compressed form up to date if they were
+  // just modified; do that once, before the threads read them.
+  ratings.begin();
+
+  // Each column is a small independent problem.
+  #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+  for (omp_size_t c = 0; c < (omp_size_t) columns.n_elem; ++c)
+  {
+    arma::mat gram = lambda * arma::eye<arma::mat>(rank, rank);
+    arma::vec rhs(rank, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = ratings.begin_col(columns[c]);
+    arma::sp_mat::const_iterator itEnd = ratings.end_col(columns[c]);
+    for (; it != itEnd; ++it)
+    {
+      gram += fixed.col(it.row()) * fixed.col(it.row()).t();
+      rhs += (*it) * fixed.col(it.row());
+    }
+
+    arma::vec x;
+    if (!arma::solve(x, gram, rhs))
+    {
+      x.zeros(rank);
+      ++failures;
+    }
+
+    factors.col(columns[c]) = x;
+  }
+
+  if (failures > 0)
+  {
+    Log::Warn << "CFType: could not solve for the factors of " << failures
+        << " users or items while folding them in; their factors are set to "
+        << "zero.  Try a positive lambda." << std::endl;
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+BuildItemIndex()
+{
+  static_assert(HasGetUserFactors<DecompositionPolicy>::value,
+      "CFType::BuildItemIndex(): the decomposition policy must predict ratings "
+      "as W() * H() and have a GetUserFactors() method");
+  static_assert(IsItemIndependentNormalization<NormalizationType>::value,
+      "CFType::BuildItemIndex(): the normalization must not depend on the "
+      "item");
+
+  // The items are the columns of W^T.
+  itemIndex.Train(arma::mat(decomposition.W().t()));
+  hasItemIndex = true;
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename PolicyType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetIndexedRecommendations(
+    const size_t numRecs,
+    arma::Mat<size_t>& recommendations,
+    const arma::Col<size_t>& users,
+    const arma::Mat<size_t>& neighborhood,
+    const arma::mat& weights,
+    const typename std::enable_if_t<
+        HasGetUserFactors<PolicyType>::value>*)
+{
+  // The rating of an item for a user is the inner product of the item factors
+  // and the combined user factors; the normalization does not change the order
+  // of the items of a user.
+  arma::mat factors;
+  decomposition.GetUserFactors(neighborhood, weights, factors);
+
+  // The items a user already rated are skipped, so the search asks for that
+  // many more items.  Users are grouped by that number, rounded up to a power
+  // of two, so that each group is one search.
+  const size_t numItems = cleanedData.n_rows;
+  std::map<size_t, std::vector<size_t>> groups;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    const size_t wanted = numRecs + cleanedData.col(users(i)).n_nonzero;
+    size_t k = 1;
+    while (k < wanted && k < numItems)
+      k *= 2;
+    groups[std::min(k, numItems)].push_back(i);
+  }
+
+  for (std::map<size_t, std::vector<size_t>>::const_iterator it =
+       groups.begin(); it != groups.end(); ++it)
+  {
+    const size_t k = it->first;
+    const std::vector<size_t>& group = it->second;
+
+    arma::mat query(factors.n_rows, group.size());
+    for (size_t g = 0; g < group.size(); ++g)
+      query.col(g) = factors.col(group[g]);
+
+    arma::Mat<size_t> indices;
+    arma::mat products;
+    itemIndex.Search(query, k, indices, products);
+
+    for (size_t g = 0; g < group.size(); ++g)
+    {
+      const size_t i = group[g];
+      size_t found = 0;
+      for (size_t j = 0; j < k && found < numRecs; ++j)
+      {
+        const size_t item = indices(j, g);
+        if (item >= numItems || cleanedData(item, users(i)) != 0.0)
+          continue; // Not an item, or the user already rated it.
+
+        recommendations(found++, i) = item;
+      }
+
+      if (found < numRecs)
+        Log::Warn << "Could not provide " << numRecs << " recommendations "
+            << "for user " << users(i) << " (not enough un-rated items)!"
+            << std::endl;
+    }
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename PolicyType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetIndexedRecommendations(
+    const size_t /* numRecs */,
+    arma::Mat<size_t>& /* recommendations */,
+    const arma::Col<size_t>& /* users */,
+    const arma::Mat<size_t>& /* neighborhood */,
+    const arma::mat& /* weights */,
+    const typename std::enable_if_t<
+        !HasGetUserFactors<PolicyType>::value>*)
+{
+  Log::Fatal << "CFType::GetRecommendations(): no item index can be used with "
+      << "this decomposition policy!" << std::endl;
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename PolicyType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRatingOfUsers(
+    const arma::Mat<size_t>& neighborhood,
+    const arma::mat& weights,
+    arma::mat& ratings,
+    const typename std::enable_if_t<
+        HasGetRatingOfUsers<PolicyType>::value>*) const
+{
+  decomposition.GetRatingOfUsers(neighborhood, weights, ratings);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename PolicyType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRatingOfUsers(
+    const arma::Mat<size_t>& neighborhood,
+    const arma::mat& weights,
+    arma::mat& ratings,
+    const typename std::enable_if_t<
+        !HasGetRatingOfUsers<PolicyType>::value>*) const
+{
+  ratings.zeros(cleanedData.n_rows, neighborhood.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) neighborhood.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      arma::vec neighborRatings;
+      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
+      ratings.col(i) += weights(j, i) * neighborRatings;
+    }
+  }
+}
+
 // Predict the rating for a single user/item combination.
 template<typename DecompositionPolicy,
          typename NormalizationType>
@@ -432,6 +757,10 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(decomposition));
   ar(CEREAL_NVP(cleanedData));
   ar(CEREAL_NVP(normalization));
+
+  // The item index is not saved; it has to be built again.
+  if (cereal::is_loading<Archive>())
+    hasItemIndex = false;
 }
 
 } // namespace cf
@@ -30,6 +30,7 @@
 #include <mlpack/methods/cf/decomposition_policies/svd_incomplete_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svdplusplus_method.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/regression_interpolation.hpp>
@@ -95,6 +96,7 @@ BINDING_LONG_DESC(
     " - 'SVDCompleteIncremental' -- SVD complete incremental learning\n"
     " - 'BiasSVD' -- Bias SVD using a SGD optimizer\n"
     " - 'SVDPP' -- SVD++ using a SGD optimizer\n"
+    " - 'ALS' -- Parallel alternating least squares on the sparse ratings\n"
     "\n\n"
     "The following neighbor search algorithms can be specified via" +
     " the " + PRINT_PARAM_STRING("neighbor_search") + " parameter:"
@@ -119,6 +121,17 @@ BINDING_LONG_DESC(
     " - 'user_mean'  -- User Mean Normalization\n"
     " - 'z_score'  -- Z-Score Normalization\n"
     "\n"
+    "Ratings of new users (or new ratings of known users) may be folded into "
+    "a model without training it again by passing them with the " +
+    PRINT_PARAM_STRING("fold_in") + " parameter, in the same format as the "
+    "training set; the factors of those users are then solved for by least "
+    "squares against the fixed item factors, regularized by " +
+    PRINT_PARAM_STRING("fold_in_lambda") + ".  If " +
+    PRINT_PARAM_STRING("fold_in_items") + " is specified, the ratings are "
+    "folded in for their items instead.  The ratings are folded in before "
+    "any recommendations are computed.  This is not supported for the "
+    "'BiasSVD' and 'SVDPP' algorithms."
+    "\n\n"
     "A trained model may be saved to with the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.");
 
@@ -180,6 +193,14 @@ PARAM_DOUBLE_IN("min_residue", "Residue required to terminate the factorization"
 PARAM_MODEL_IN(CFModel, "input_model", "Trained CF model to load.", "m");
 PARAM_MODEL_OUT(CFModel, "output_model", "Output for trained CF model.", "M");
 
+// Fold new ratings into the model.
+PARAM_MATRIX_IN("fold_in", "Ratings of new or known users to fold into the "
+    "model without training it again.", "F");
+PARAM_FLAG("fold_in_items", "Fold the ratings to fold in into the model for "
+    "their items instead of their users.", "");
+PARAM_DOUBLE_IN("fold_in_lambda", "Regularization parameter for folding in "
+    "new ratings.", "", 0.0);
+
 // Query settings.
 PARAM_UMATRIX_IN("query", "List of query users for which recommendations should"
     " be generated.", "q");
@@ -220,7 +241,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   RequireParamInSet<string>(params, "algorithm", { "NMF", "BatchSVD",
       "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
-      "RandSVD", "BiasSVD", "SVDPP" }, true, "unknown algorithm");
+      "RandSVD", "BiasSVD", "SVDPP", "ALS" }, true, "unknown algorithm");
 
   ReportIgnoredParam(params, {{ "iteration_only_termination", true }},
       "min_residue");
@@ -306,6 +327,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
           "when max_iterations is reached");
       cf->DecompositionType() = CFModel::SVD_PLUS_PLUS;
     }
+    else if (algo == "ALS")
+    {
+      cf->DecompositionType() = CFModel::ALS;
+    }
 
     // Perform the factorization and do whatever the user wanted.
     const size_t neighborhood = (size_t) params.Get<int>("neighborhood");
@@ -340,12 +365,46 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   {
     // Load from a model after validating parameters.
     RequireAtLeastOnePassed(params, { "query", "all_user_recommendations",
-        "test" }, true);
+        "test", "fold_in" }, true);
 
     // Load an input model.
     cf = std::move(params.Get<CFModel*>("input_model"));
   }
 
+  if (params.Has("fold_in"))
+  {
+    RequireParamValue<double>(params, "fold_in_lambda",
+        [](double x) { return x >= 0; }, true,
+        "fold_in_lambda must be non-negative");
+
+    arma::mat foldIn = std::move(params.Get<arma::mat>("fold_in"));
+    if (foldIn.n_rows != 3)
+    {
+      Log::Fatal << "Ratings to fold in must have 3 dimensions (user, item, "
+          << "rating)!" << endl;
+    }
+
+    timers.Start("cf_fold_in");
+    if (params.Has("fold_in_items"))
+    {
+      Log::Info << "Folding " << foldIn.n_cols << " ratings into the model "
+          << "for their items." << endl;
+      cf->FoldInItems(foldIn, params.Get<double>("fold_in_lambda"));
+    }
+    else
+    {
+      Log::Info << "Folding " << foldIn.n_cols << " ratings into the model "
+          << "for their users." << endl;
+      cf->FoldInUsers(foldIn, params.Get<double>("fold_in_lambda"));
+    }
+    timers.Stop("cf_fold_in");
+  }
+  else
+  {
+    ReportIgnoredParam(params, "fold_in_items", "no ratings to fold in");
+    ReportIgnoredParam(params, "fold_in_lambda", "no ratings to fold in");
+  }
+
   // Get the types of the neighbor search method and the interpolation.  (These
   // may or may not be used.)
   NeighborSearchTypes nsType;
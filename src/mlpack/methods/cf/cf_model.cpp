@@ -166,6 +166,11 @@ void CFModel::Train(const arma::mat& data,
       cf = TrainHelper(SVDPlusPlusPolicy(), normalizationType, data,
           numUsersForSimilarity, rank, maxIterations, minResidue, mit);
       break;
+
+    case ALS:
+      cf = TrainHelper(ALSPolicy(), normalizationType, data,
+          numUsersForSimilarity, rank, maxIterations, minResidue, mit);
+      break;
   }
 }
 
@@ -198,5 +203,17 @@ void CFModel::GetRecommendations(const NeighborSearchTypes nsType,
   cf->GetRecommendations(nsType, interpolationType, numRecs, recommendations);
 }
 
+//! Fold the ratings of new or existing users into the model.
+void CFModel::FoldInUsers(const arma::mat& data, const double lambda)
+{
+  cf->FoldInUsers(data, lambda);
+}
+
+//! Fold the ratings of new or existing items into the model.
+void CFModel::FoldInItems(const arma::mat& data, const double lambda)
+{
+  cf->FoldInItems(data, lambda);
+}
+
 } // namespace cf
 } // namespace mlpack
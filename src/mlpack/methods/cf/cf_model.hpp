@@ -78,6 +78,12 @@ class CFWrapperBase
       const size_t numRecs,
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users) = 0;
+
+  //! Fold the ratings of new or existing users into the model.
+  virtual void FoldInUsers(const arma::mat& data, const double lambda) = 0;
+
+  //! Fold the ratings of new or existing items into the model.
+  virtual void FoldInItems(const arma::mat& data, const double lambda) = 0;
 };
 
 /**
@@ -144,6 +150,12 @@ class CFWrapper : public CFWrapperBase
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users);
 
+  //! Fold the ratings of new or existing users into the model.
+  virtual void FoldInUsers(const arma::mat& data, const double lambda);
+
+  //! Fold the ratings of new or existing items into the model.
+  virtual void FoldInItems(const arma::mat& data, const double lambda);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -171,7 +183,8 @@ class CFModel
     SVD_COMPLETE,
     SVD_INCOMPLETE,
     BIAS_SVD,
-    SVD_PLUS_PLUS
+    SVD_PLUS_PLUS,
+    ALS
   };
 
   enum NormalizationTypes
@@ -267,6 +280,28 @@ class CFModel
                           const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  /**
+   * Fold the ratings of new or existing users into the model without
+   * retraining; see CFType::FoldInUsers().  This is not supported by the
+   * BIAS_SVD and SVD_PLUS_PLUS decompositions.
+   *
+   * @param data New ratings in the form of coordinate list (user, item,
+   *     rating).
+   * @param lambda Regularization parameter for the least squares problems.
+   */
+  void FoldInUsers(const arma::mat& data, const double lambda = 0.0);
+
+  /**
+   * Fold the ratings of new or existing items into the model without
+   * retraining; see CFType::FoldInItems().  This is not supported by the
+   * BIAS_SVD and SVD_PLUS_PLUS decompositions.
+   *
+   * @param data New ratings in the form of coordinate list (user, item,
+   *     rating).
+   * @param lambda Regularization parameter for the least squares problems.
+   */
+  void FoldInItems(const arma::mat& data, const double lambda = 0.0);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
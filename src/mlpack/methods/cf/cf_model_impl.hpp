@@ -22,6 +22,7 @@
 #include "neighbor_search_policies/lmetric_search.hpp"
 #include "neighbor_search_policies/pearson_search.hpp"
 
+#include "decomposition_policies/als_method.hpp"
 #include "decomposition_policies/batch_svd_method.hpp"
 #include "decomposition_policies/bias_svd_method.hpp"
 #include "decomposition_policies/nmf_method.hpp"
@@ -206,6 +207,50 @@ void CFWrapper<DecompositionPolicy, NormalizationPolicy>::GetRecommendations(
   }
 }
 
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void FoldInHelper(CFType<DecompositionPolicy, NormalizationPolicy>& cf,
+                  const arma::mat& data,
+                  const double lambda,
+                  const bool items,
+                  const typename std::enable_if_t<
+                      HasGetUserFactors<DecompositionPolicy>::value>* = 0)
+{
+  if (items)
+    cf.FoldInItems(data, lambda);
+  else
+    cf.FoldInUsers(data, lambda);
+}
+
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void FoldInHelper(CFType<DecompositionPolicy, NormalizationPolicy>& /* cf */,
+                  const arma::mat& /* data */,
+                  const double /* lambda */,
+                  const bool /* items */,
+                  const typename std::enable_if_t<
+                      !HasGetUserFactors<DecompositionPolicy>::value>* = 0)
+{
+  Log::Fatal << "CFModel: folding in new ratings is not supported by this "
+      << "decomposition; train the model again instead." << std::endl;
+}
+
+//! Fold the ratings of new or existing users into the model.
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void CFWrapper<DecompositionPolicy, NormalizationPolicy>::FoldInUsers(
+    const arma::mat& data,
+    const double lambda)
+{
+  FoldInHelper(cf, data, lambda, false);
+}
+
+//! Fold the ratings of new or existing items into the model.
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void CFWrapper<DecompositionPolicy, NormalizationPolicy>::FoldInItems(
+    const arma::mat& data,
+    const double lambda)
+{
+  FoldInHelper(cf, data, lambda, true);
+}
+
 template<typename DecompositionPolicy>
 CFWrapperBase* InitializeModelHelper(
     CFModel::NormalizationTypes normalizationType)
@@ -261,6 +306,9 @@ inline CFWrapperBase* InitializeModel(
 
     case CFModel::SVD_PLUS_PLUS:
       return InitializeModelHelper<SVDPlusPlusPolicy>(normalizationType);
+
+    case CFModel::ALS:
+      return InitializeModelHelper<ALSPolicy>(normalizationType);
   }
 
   // This shouldn't ever happen.
@@ -368,6 +416,10 @@ void CFModel::serialize(Archive& ar, const uint32_t /* version */)
     case SVD_PLUS_PLUS:
       SerializeHelper<SVDPlusPlusPolicy>(ar, cf, normalizationType);
       break;
+
+    case ALS:
+      SerializeHelper<ALSPolicy>(ar, cf, normalizationType);
+      break;
   }
 }
 
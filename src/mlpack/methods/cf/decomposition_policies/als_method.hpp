@@ -0,0 +1,497 @@
+/**
+ * @file methods/cf/decomposition_policies/als_method.hpp
+ *
+ * Implementation of the parallel alternating least squares method for use in
+ * Collaborative Filtering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Implementation of the alternating least squares (ALS) policy to act as a
+ * wrapper when accessing ALS from within CFType.  Each iteration solves the
+ * regularized normal equations of every user with the item matrix fixed, and
+ * then those of every item with the user matrix fixed; the equations of
+ * different users (or items) are independent, so they are solved in parallel
+ * when OpenMP is available.  Only the nonzero ratings of the sparse rating
+ * matrix are visited, and no dense user-by-item matrix is ever formed.
+ *
+ * With explicit feedback, the ratings are fitted directly, with the weighted
+ * regularization of Zhou et al. ("Large-scale parallel collaborative filtering
+ * for the Netflix prize", 2008):
+ *
+ * \f$ \min \sum_{(i, u) \in R} (r_{iu} - w_i^T h_u)^2 + \lambda (\sum_i n_i
+ * \| w_i \|^2 + \sum_u n_u \| h_u \|^2) \f$.
+ *
+ * With implicit feedback, every rating is a preference of 1 with confidence
+ * \f$ 1 + \alpha r_{iu} \f$ and every missing rating is a preference of 0 with
+ * confidence 1, as in Hu et al. ("Collaborative filtering for implicit
+ * feedback datasets", 2008).  The term of the missing ratings is handled with
+ * a Gram matrix of the fixed factors that is computed once per half-iteration,
+ * so a solve only costs time in the number of nonzero ratings.
+ *
+ * The systems are solved directly, or with a few warm-started conjugate
+ * gradient iterations (as in Takacs et al., "Applications of the conjugate
+ * gradient method for implicit feedback collaborative filtering", 2011),
+ * which avoids forming each system.
+ *
+ * An example of how to use ALSPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<ALSPolicy> cf(data);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ */
+class ALSPolicy
+{
+ public:
+  /**
+   * Use ALS to perform collaborative filtering.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether the ratings are implicit feedback.
+   * @param alpha Confidence scaling of implicit ratings.
+   * @param conjugateGradientIterations Number of conjugate gradient
+   *     iterations for each system (0 solves the systems directly).
+   */
+  ALSPolicy(const double lambda = 0.1,
+            const bool implicit = false,
+            const double alpha = 40.0,
+            const size_t conjugateGradientIterations = 0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha),
+      conjugateGradientIterations(conjugateGradientIterations)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided data set using ALS.
+   *
+   * @param * (data) Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix (cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param minResidue Relative change of the objective required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  template<typename MatType>
+  void Apply(const MatType& /* data */,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit)
+  {
+    if (lambda <= 0.0)
+    {
+      Log::Fatal << "ALSPolicy::Apply(): lambda must be positive (given "
+          << lambda << ")!" << std::endl;
+    }
+
+    // The ratings of each item are the columns of the transpose.  (Taking the
+    // transpose also brings the compressed columns of cleanedData up to date
+    // with any cached element insertions, since Solve() reads them directly.)
+    const arma::sp_mat itemRatings = cleanedData.t();
+
+    // The item matrix is held transposed while iterating, so that the factors
+    // of each item are a column.
+    arma::mat wt = arma::randu<arma::mat>(rank, cleanedData.n_rows);
+    h.zeros(rank, cleanedData.n_cols);
+
+    double lastObjective = DBL_MAX;
+    for (size_t i = 0; maxIterations == 0 || i < maxIterations; ++i)
+    {
+      Solve(cleanedData, wt, h);
+      Solve(itemRatings, h, wt);
+
+      if (mit && maxIterations != 0)
+        continue;
+
+      const double objective = Objective(cleanedData, itemRatings, wt);
+      const double residue = std::abs(lastObjective - objective) /
+          std::max(objective, 1e-300);
+      Log::Info << "ALS iteration " << i << ": objective " << objective
+          << "." << std::endl;
+      if (lastObjective != DBL_MAX && residue < minResidue)
+        break;
+      lastObjective = objective;
+    }
+
+    w = wt.t();
+  }
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    double rating = arma::as_scalar(w.row(item) * h.col(user));
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    rating = w * h.col(user);
+  }
+
+  /**
+   * Get the factors of weighted combinations of users: column i of factors is
+   * the sum over j of weights(j, i) times the factors of user
+   * neighborhood(j, i), so that W() * factors holds the combined ratings.
+   *
+   * @param neighborhood Users to combine for each column.
+   * @param weights Weight of each user in the neighborhood.
+   * @param factors Resulting user factor matrix.
+   */
+  void GetUserFactors(const arma::Mat<size_t>& neighborhood,
+                      const arma::mat& weights,
+                      arma::mat& factors) const
+  {
+    factors.zeros(h.n_rows, neighborhood.n_cols);
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        factors.col(i) += weights(j, i) * h.col(neighborhood(j, i));
+  }
+
+  /**
+   * Get predicted ratings for weighted combinations of users: column i of
+   * ratings is the sum over j of weights(j, i) times the ratings of user
+   * neighborhood(j, i).
+   *
+   * @param neighborhood Users to combine for each column.
+   * @param weights Weight of each user in the neighborhood.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Mat<size_t>& neighborhood,
+                        const arma::mat& weights,
+                        arma::mat& ratings) const
+  {
+    // Combining the user vectors first gives all ratings in one product.
+    arma::mat factors;
+    GetUserFactors(neighborhood, weights, factors);
+    ratings = w * factors;
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // As for NMFPolicy, the search on the rating matrix X = W * H is done on
+    // H with the Mahalanobis distance where M^{-1} = W^T W; multiplying H by
+    // the Cholesky factor reduces it to a Euclidean search.
+    arma::mat l = arma::chol(w.t() * w);
+    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
+
+    // Temporarily store feature vector of queried users.
+    arma::mat query(stretchedH.n_rows, users.n_elem);
+    // Select feature vectors of queried users.
+    for (size_t i = 0; i < users.n_elem; ++i)
+      query.col(i) = stretchedH.col(users(i));
+
+    NeighborSearchPolicy neighborSearch(stretchedH);
+    neighborSearch.Search(
+        query, numUsersForSimilarity, neighborhood, similarities);
+  }
+
+  //! Get the Item Matrix.
+  const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
+  //! Get the User Matrix.
+  const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the ratings are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the ratings are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence scaling of implicit ratings.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scaling of implicit ratings.
+  double& Alpha() { return alpha; }
+
+  //! Get the number of conjugate gradient iterations (0 for direct solves).
+  size_t ConjugateGradientIterations() const
+  {
+    return conjugateGradientIterations;
+  }
+  //! Modify the number of conjugate gradient iterations.
+  size_t& ConjugateGradientIterations() { return conjugateGradientIterations; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(w));
+    ar(CEREAL_NVP(h));
+  }
+
+ private:
+  /**
+   * Solve the normal equations of every column of the given ratings, holding
+   * the factors of their rows fixed.  The systems are independent, so the
+   * columns are solved in parallel.
+   *
+   * @param ratings Sparse ratings; row i of column j rates fixed.col(i).
+   * @param fixed Fixed factors, one column for each row of the ratings.
+   * @param solved Factors to solve for, one column for each column of the
+   *     ratings; with conjugate gradient, the current values are the start.
+   */
+  void Solve(const arma::sp_mat& ratings,
+             const arma::mat& fixed,
+             arma::mat& solved) const
+  {
+    const size_t rank = fixed.n_rows;
+
+    // The implicit systems share the Gram matrix of all fixed factors, which
+    // accounts for the missing ratings.
+    arma::mat gram;
+    if (implicit)
+    {
+      gram = fixed * fixed.t();
+      gram.diag() += lambda;
+    }
+
+    // The compressed columns are read directly, so that concurrent reads
+    // never touch the element cache of the sparse matrix.
+    const arma::uword* colPtrs = ratings.col_ptrs;
+    const arma::uword* rowIndices = ratings.row_indices;
+    const double* values = ratings.values;
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+    {
+      const size_t begin = colPtrs[j];
+      const size_t count = colPtrs[j + 1] - begin;
+      if (count == 0)
+      {
+        // Without ratings, the regularized solution is zero.
+        solved.col(j).zeros();
+        continue;
+      }
+
+      // Gather the fixed factors of the rated rows and their weights in the
+      // system: the confidence minus one (implicit), or one (explicit).
+      arma::mat local(rank, count);
+      arma::vec weights(count);
+      arma::vec b(rank, arma::fill::zeros);
+      for (size_t k = 0; k < count; ++k)
+      {
+        local.col(k) = fixed.col(rowIndices[begin + k]);
+        const double rating = values[begin + k];
+        if (implicit)
+        {
+          weights[k] = alpha * rating;
+          b += (1.0 + alpha * rating) * local.col(k);
+        }
+        else
+        {
+          weights[k] = 1.0;
+          b += rating * local.col(k);
+        }
+      }
+
+      // The explicit regularization is weighted by the number of ratings.
+      const double shift = implicit ? 0.0 : lambda * count;
+      if (conjugateGradientIterations == 0)
+      {
+        arma::mat a = (local.each_row() % weights.t()) * local.t();
+        if (implicit)
+          a += gram;
+        else
+          a.diag() += shift;
+
+        arma::vec x;
+        if (!arma::solve(x, a, b))
+        {
+          Log::Warning << "ALSPolicy::Apply(): could not solve the normal "
+              << "equations of column " << j << "; setting it to zero."
+              << std::endl;
+          x.zeros(rank);
+        }
+        solved.col(j) = x;
+      }
+      else
+      {
+        ConjugateGradient(local, weights, gram, shift, b, solved.col(j));
+      }
+    }
+  }
+
+  /**
+   * Run conjugate gradient iterations on the system
+   * (local * diag(weights) * local^T + gram + shift * I) x = b, without
+   * forming it.
+   */
+  template<typename VecType>
+  void ConjugateGradient(const arma::mat& local,
+                         const arma::vec& weights,
+                         const arma::mat& gram,
+                         const double shift,
+                         const arma::vec& b,
+                         VecType&& x) const
+  {
+    arma::vec solution = x;
+    arma::vec residual = b - Multiply(local, weights, gram, shift, solution);
+    arma::vec direction = residual;
+    double residualNorm = arma::dot(residual, residual);
+    for (size_t i = 0; i < conjugateGradientIterations; ++i)
+    {
+      if (residualNorm < 1e-20)
+        break;
+
+      const arma::vec product = Multiply(local, weights, gram, shift,
+          direction);
+      const double step = residualNorm / arma::dot(direction, product);
+      solution += step * direction;
+      residual -= step * product;
+
+      const double newResidualNorm = arma::dot(residual, residual);
+      direction = residual + (newResidualNorm / residualNorm) * direction;
+      residualNorm = newResidualNorm;
+    }
+
+    x = solution;
+  }
+
+  //! Multiply the vector by the system of ConjugateGradient().
+  arma::vec Multiply(const arma::mat& local,
+                     const arma::vec& weights,
+                     const arma::mat& gram,
+                     const double shift,
+                     const arma::vec& v) const
+  {
+    arma::vec product = local * (weights % (local.t() * v));
+    if (implicit)
+      product += gram * v;
+    else
+      product += shift * v;
+    return product;
+  }
+
+  /**
+   * Compute the objective of the current factorization, using only the
+   * nonzero ratings.
+   */
+  double Objective(const arma::sp_mat& ratings,
+                   const arma::sp_mat& itemRatings,
+                   const arma::mat& wt) const
+  {
+    double loss = 0.0;
+    #pragma omp parallel for schedule(dynamic, 16) reduction(+:loss)
+    for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+    {
+      for (size_t k = ratings.col_ptrs[j]; k < ratings.col_ptrs[j + 1]; ++k)
+      {
+        const double rating = ratings.values[k];
+        const double prediction = arma::dot(wt.col(ratings.row_indices[k]),
+            h.col(j));
+        if (implicit)
+        {
+          // The missing ratings are counted below, so remove their term.
+          loss += (1.0 + alpha * rating) * std::pow(1.0 - prediction, 2.0) -
+              prediction * prediction;
+        }
+        else
+        {
+          loss += std::pow(rating - prediction, 2.0);
+        }
+      }
+    }
+
+    if (implicit)
+    {
+      // The sum of all squared predictions is trace((W^T W) (H H^T)).
+      loss += arma::accu((wt * wt.t()) % (h * h.t()));
+      return loss + lambda * (arma::accu(arma::square(wt)) +
+          arma::accu(arma::square(h)));
+    }
+
+    // The explicit regularization is weighted by the number of ratings.
+    return loss + lambda * (WeightedNorm(h, ratings) +
+        WeightedNorm(wt, itemRatings));
+  }
+
+  //! Sum the squared norms of the factors, each times its number of ratings.
+  static double WeightedNorm(const arma::mat& factors,
+                             const arma::sp_mat& ratings)
+  {
+    double norm = 0.0;
+    for (size_t j = 0; j < factors.n_cols; ++j)
+    {
+      norm += (ratings.col_ptrs[j + 1] - ratings.col_ptrs[j]) *
+          arma::dot(factors.col(j), factors.col(j));
+    }
+    return norm;
+  }
+
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the ratings are implicit feedback.
+  bool implicit;
+  //! Confidence scaling of implicit ratings.
+  double alpha;
+  //! Number of conjugate gradient iterations (0 for direct solves).
+  size_t conjugateGradientIterations;
+  //! Item matrix.
+  arma::mat w;
+  //! User matrix.
+  arma::mat h;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
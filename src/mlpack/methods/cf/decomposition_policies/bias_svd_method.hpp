@@ -106,6 +106,36 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get predicted ratings for weighted combinations of users: column i of
+   * ratings is the sum over j of weights(j, i) times the ratings of user
+   * neighborhood(j, i).
+   *
+   * @param neighborhood Users to combine for each column.
+   * @param weights Weight of each user in the neighborhood.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Mat<size_t>& neighborhood,
+                        const arma::mat& weights,
+                        arma::mat& ratings) const
+  {
+    // Combining the user vectors first gives all ratings in one product.
+    arma::mat combined(h.n_rows, neighborhood.n_cols, arma::fill::zeros);
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        combined.col(i) += weights(j, i) * h.col(neighborhood(j, i));
+
+    // The item and user biases are combined with the same weights.
+    ratings = w * combined;
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+    {
+      double userBias = 0.0;
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        userBias += weights(j, i) * q(neighborhood(j, i));
+      ratings.col(i) += arma::accu(weights.col(i)) * p + userBias;
+    }
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
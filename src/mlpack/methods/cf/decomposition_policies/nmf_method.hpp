@@ -104,6 +104,44 @@ class NMFPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the factors of weighted combinations of users: column i of factors is
+   * the sum over j of weights(j, i) times the factors of user
+   * neighborhood(j, i), so that W() * factors holds the combined ratings.
+   *
+   * @param neighborhood Users to combine for each column.
+   * @param weights Weight of each user in the neighborhood.
+   * @param factors Resulting user factor matrix.
+   */
+  void GetUserFactors(const arma::Mat<size_t>& neighborhood,
+                      const arma::mat& weights,
+                      arma::mat& factors) const
+  {
+    factors.zeros(h.n_rows, neighborhood.n_cols);
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        factors.col(i) += weights(j, i) * h.col(neighborhood(j, i));
+  }
+
+  /**
+   * Get predicted ratings for weighted combinations of users: column i of
+   * ratings is the sum over j of weights(j, i) times the ratings of user
+   * neighborhood(j, i).
+   *
+   * @param neighborhood Users to combine for each column.
+   * @param weights Weight of each user in the neighborhood.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Mat<size_t>& neighborhood,
+                        const arma::mat& weights,
+                        arma::mat& ratings) const
+  {
+    // Combining the user vectors first gives all ratings in one product.
+    arma::mat factors;
+    GetUserFactors(neighborhood, weights, factors);
+    ratings = w * factors;
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -145,8 +183,12 @@ class NMFPolicy
 
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
 
   /**
    * Serialization.
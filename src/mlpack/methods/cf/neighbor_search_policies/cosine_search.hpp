@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/sparse_cosine_search.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -27,6 +28,11 @@ namespace cf {
  * NeighborSearch with Euclidean distance, KDTree). Cosine similarities are
  * calculated from Euclidean distance.
  *
+ * If the reference set is sparse, the neighbors are found with a
+ * neighbor::SparseCosineSearch instead, which accumulates the similarities
+ * from an inverted index of the reference set, so that sparse high-dimensional
+ * data (where trees prune little) is never converted to a dense matrix.
+ *
  * An example of how to use CosineSearch in CF is shown below:
  *
  * @code
@@ -50,7 +56,7 @@ class CosineSearch
    *
    * @param referenceSet Set of reference points.
    */
-  CosineSearch(const arma::mat& referenceSet)
+  CosineSearch(const arma::mat& referenceSet) : sparse(false)
   {
     // Normalize all vectors to unit length.
     arma::mat normalizedSet = arma::normalise(referenceSet, 2, 0);
@@ -58,6 +64,17 @@ class CosineSearch
     neighborSearch.Train(std::move(normalizedSet));
   }
 
+  /**
+   * Constructor with a sparse reference set, which is indexed by a
+   * neighbor::SparseCosineSearch.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  CosineSearch(const arma::sp_mat& referenceSet) :
+      sparseSearch(referenceSet),
+      sparse(true)
+  { }
+
   /**
    * Given a set of query points, find the nearest k neighbors, and return
    * similarities. Similarities are non-negative and no larger than one.
@@ -70,6 +87,12 @@ class CosineSearch
   void Search(const arma::mat& query, const size_t k,
               arma::Mat<size_t>& neighbors, arma::mat& similarities)
   {
+    if (sparse)
+    {
+      Search(arma::sp_mat(query), k, neighbors, similarities);
+      return;
+    }
+
     // Normalize query vectors to unit length.
     arma::mat normalizedQuery = arma::normalise(query, 2, 0);
 
@@ -84,9 +107,36 @@ class CosineSearch
     similarities = 1 - arma::pow(similarities, 2) / 4.0;
   }
 
+  /**
+   * Given a set of sparse query points, find the nearest k neighbors, and
+   * return similarities in the same range as above.
+   *
+   * @param query A set of query points.
+   * @param k Number of neighbors to search.
+   * @param neighbors Nearest neighbors.
+   * @param similarities Similarities between query point and its neighbors.
+   */
+  void Search(const arma::sp_mat& query, const size_t k,
+              arma::Mat<size_t>& neighbors, arma::mat& similarities)
+  {
+    if (!sparse)
+    {
+      Search(arma::mat(query), k, neighbors, similarities);
+      return;
+    }
+
+    // Map the cosine similarities to [0, 1].
+    sparseSearch.Search(query, k, neighbors, similarities);
+    similarities = (similarities + 1) / 2.0;
+  }
+
  private:
   //! NeighborSearch object.
   neighbor::KNN neighborSearch;
+  //! Inverted index of a sparse reference set.
+  neighbor::SparseCosineSearch sparseSearch;
+  //! Whether the reference set is sparse.
+  bool sparse;
 };
 
 } // namespace cf
@@ -82,6 +82,48 @@ class ItemMeanNormalization
     });
   }
 
+  /**
+   * Normalize new ratings that are folded into the model.  The mean of each
+   * item that is not known yet is computed from its ratings in the given data;
+   * the means of known items are kept, so that their ratings already in the
+   * model stay normalized the same way.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t known = itemMean.n_elem;
+    const size_t itemNum = std::max((size_t) arma::max(data.row(1)) + 1, known);
+    itemMean.resize(itemNum); // The new means are zero.
+    // Number of new ratings for each new item.
+    arma::Row<size_t> ratingNum(itemNum, arma::fill::zeros);
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      if (item >= known)
+      {
+        itemMean(item) += datapoint(2);
+        ratingNum(item) += 1;
+      }
+    });
+
+    for (size_t i = known; i < itemNum; ++i)
+    {
+      if (ratingNum(i) != 0)
+        itemMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      datapoint(2) -= itemMean((size_t) datapoint(1));
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Normalize the data by subtracting item mean from each of existing ratings.
    *
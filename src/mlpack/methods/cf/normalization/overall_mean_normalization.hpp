@@ -60,6 +60,25 @@ class OverallMeanNormalization
     });
   }
 
+  /**
+   * Normalize new ratings that are folded into the model by subtracting the
+   * mean of the training ratings.  The mean is not updated: that would change
+   * the normalization of every rating already in the model.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) -= mean;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive float value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Normalize the data by subtracting the mean of all existing ratings.
    *
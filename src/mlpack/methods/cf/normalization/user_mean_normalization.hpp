@@ -82,6 +82,48 @@ class UserMeanNormalization
     });
   }
 
+  /**
+   * Normalize new ratings that are folded into the model.  The mean of each
+   * user that is not known yet is computed from its ratings in the given data;
+   * the means of known users are kept, so that their ratings already in the
+   * model stay normalized the same way.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t known = userMean.n_elem;
+    const size_t userNum = std::max((size_t) arma::max(data.row(0)) + 1, known);
+    userMean.resize(userNum); // The new means are zero.
+    // Number of new ratings for each new user.
+    arma::Row<size_t> ratingNum(userNum, arma::fill::zeros);
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      if (user >= known)
+      {
+        userMean(user) += datapoint(2);
+        ratingNum(user) += 1;
+      }
+    });
+
+    for (size_t i = known; i < userNum; ++i)
+    {
+      if (ratingNum(i) != 0)
+        userMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      datapoint(2) -= userMean((size_t) datapoint(0));
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Normalize the data by subtracting user mean from each of existing rating.
    *
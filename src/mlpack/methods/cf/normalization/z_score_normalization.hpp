@@ -68,6 +68,25 @@ class ZScoreNormalization
     });
   }
 
+  /**
+   * Normalize new ratings that are folded into the model with the mean and
+   * standard deviation of the training ratings.  These are not updated: that
+   * would change the normalization of every rating already in the model.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) = (data.row(2) - mean) / stddev;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive float value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Normalize the data to zero mean and one standard deviation.
    *
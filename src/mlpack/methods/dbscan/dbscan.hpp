@@ -15,7 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 
@@ -43,9 +43,22 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
- * @tparam RangeSearchType Class to use for range searching.
+ * A point is a core point if at least minPoints points (including itself) are
+ * within epsilon of it.  Core points within epsilon of each other are in the
+ * same cluster, other points within epsilon of a core point are border points
+ * of the cluster of the lowest-index such core point, and the remaining points
+ * are noise.  With OpenMP, the core points are merged in parallel with a
+ * lock-free emst::ConcurrentUnionFind and the points are labeled in parallel;
+ * the range searches themselves are parallel if the RangeSearchType is in
+ * single-tree mode.  The clusters don't depend on the number of threads, and
+ * they are numbered in the order the PointSelectionPolicy visits their points.
+ *
+ * @tparam RangeSearchType Class to use for range searching.  In batch mode, it
+ *      must provide the monochromatic Search() that streams its results to a
+ *      callback, like range::RangeSearch.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
- *      with.
+ *      with.  Since core points are merged with a union-find structure, this
+ *      only changes the order the clusters are numbered in.
  */
 template<typename RangeSearchType = range::RangeSearch<>,
          typename PointSelectionPolicy = OrderedPointSelection>
@@ -53,14 +66,15 @@ class DBSCAN
 {
  public:
   /**
-   * Construct the DBSCAN object with the given parameters.  The batchMode
-   * parameter should be set to false in the case where RAM issues will be
-   * encountered (i.e. if the dataset is very large or if epsilon is large).
-   * When batchMode is false, each point will be searched iteratively, which
-   * could be slower but will use less memory.
+   * Construct the DBSCAN object with the given parameters.  When batchMode is
+   * true, all points are searched at once, twice, and the results are streamed
+   * instead of stored, so the memory used is linear in the number of points.
+   * When batchMode is false, the points are searched in blocks, only once, and
+   * the neighborhoods of one block are stored at a time.
    *
    * @param epsilon Size of range query.
-   * @param minPoints Minimum number of points for each cluster.
+   * @param minPoints Minimum number of points within epsilon of a core point,
+   *     including itself.
    * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
@@ -129,31 +143,67 @@ class DBSCAN
   PointSelectionPolicy pointSelector;
 
   /**
-   * Performs DBSCAN clustering on the data, returning the number of clusters and
-   * also the list of cluster assignments.  This searches each point iteratively,
-   * and can save on RAM usage.  It may be slower than the batch search with a
-   * dual-tree algorithm.
+   * Performs DBSCAN clustering on the data, searching the points in blocks so
+   * that only the neighborhoods of one block are held in memory at a time.
+   * Unlike the batch search, each point is only searched once, but a query
+   * tree is built for each block.
    *
    * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   * @param corePoints Set to 1 for each core point.
+   * @param coreNeighbors Set to the lowest index of the core points within
+   *     epsilon of each point that is not a core point.
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf,
+                        std::vector<char>& corePoints,
+                        std::vector<std::atomic<size_t>>& coreNeighbors);
 
   /**
-   * Performs DBSCAN clustering on the data, returning number of clusters
-   * and also the list of cluster assignments.  This can perform search in batch,
-   * so it is well suited for dual-tree or naive search.
+   * Performs DBSCAN clustering on the data, searching all points in batch, so
+   * it is well suited for dual-tree or naive search.  The results of the range
+   * search are streamed instead of stored, so this takes memory linear in the
+   * number of points: one search counts the neighbors of each point to find
+   * the core points, and a second one merges them.
    *
    * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   * @param corePoints Set to 1 for each core point.
+   * @param coreNeighbors Set to the lowest index of the core points within
+   *     epsilon of each point that is not a core point.
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf,
+                    std::vector<char>& corePoints,
+                    std::vector<std::atomic<size_t>>& coreNeighbors);
+
+  /**
+   * Merge the core points of a block of points, given their neighborhoods
+   * (which include the points themselves).  The core points of the block are
+   * found first; then each of them is merged with the core points found so far
+   * in its neighborhood, and is recorded as a core neighbor of the other points
+   * of its neighborhood.  Since the neighborhoods are symmetric, each pair of
+   * core points is merged when the second of their blocks is processed.
+   *
+   * @param begin Index of the first point of the block.
+   * @param neighbors Neighborhood of each point of the block.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   * @param corePoints Set to 1 for each core point of the block.
+   * @param coreNeighbors Lowest index of the core points found so far within
+   *     epsilon of each point.
+   */
+  void MergeBlock(const size_t begin,
+                  const std::vector<std::vector<size_t>>& neighbors,
+                  emst::ConcurrentUnionFind& uf,
+                  std::vector<char>& corePoints,
+                  std::vector<std::atomic<size_t>>& coreNeighbors);
+
+  //! Atomically set the given core neighbor to the given index, if it is
+  //! lower.
+  static void SetCoreNeighbor(std::atomic<size_t>& coreNeighbor,
+                              const size_t index);
 };
 
 } // namespace dbscan
@@ -100,40 +100,56 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  // Initialize the UnionFind object, and the status of each point.
+  emst::ConcurrentUnionFind uf(data.n_cols);
+  std::vector<char> corePoints(data.n_cols, 0);
+  std::vector<std::atomic<size_t>> coreNeighbors(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    coreNeighbors[i].store(SIZE_MAX, std::memory_order_relaxed);
+
   rangeSearch.Train(data);
 
   if (batchMode)
-    BatchCluster(data, uf);
+    BatchCluster(data, uf, corePoints, coreNeighbors);
   else
-    PointwiseCluster(data, uf);
+    PointwiseCluster(data, uf, corePoints, coreNeighbors);
 
-  // Now set assignments.
+  // Now label each point with the component of its core point, or of its
+  // lowest-index core neighbor.  The component of a cluster is the lowest
+  // index of its core points.
   assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
-
-  // Get a count of all clusters.
-  const size_t numClusters = arma::max(assignments) + 1;
-  arma::Col<size_t> counts(numClusters, arma::fill::zeros);
-  for (size_t i = 0; i < assignments.n_elem; ++i)
-    counts[assignments[i]]++;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    const size_t coreNeighbor = coreNeighbors[i].load(
+        std::memory_order_relaxed);
+    if (corePoints[i])
+      assignments[i] = uf.Find(i);
+    else if (coreNeighbor != SIZE_MAX)
+      assignments[i] = uf.Find(coreNeighbor);
+    else
+      assignments[i] = SIZE_MAX;
+  }
 
-  // Now assign clusters to new indices.
+  // Now assign clusters to new indices, in the order the point selection
+  // policy visits them.
   size_t currentCluster = 0;
-  arma::Col<size_t> newAssignments(numClusters);
-  for (size_t i = 0; i < counts.n_elem; ++i)
+  arma::Col<size_t> newAssignments(data.n_cols);
+  newAssignments.fill(SIZE_MAX);
+  for (size_t i = 0; i < data.n_cols; ++i)
   {
-    if (counts[i] >= minPoints)
-      newAssignments[i] = currentCluster++;
-    else
-      newAssignments[i] = SIZE_MAX;
+    const size_t component = assignments[pointSelector.Select(i, data)];
+    if (component != SIZE_MAX && newAssignments[component] == SIZE_MAX)
+      newAssignments[component] = currentCluster++;
   }
 
   // Now reassign.
-  for (size_t i = 0; i < assignments.n_elem; ++i)
-    assignments[i] = newAssignments[assignments[i]];
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) assignments.n_elem; ++i)
+  {
+    if (assignments[i] != SIZE_MAX)
+      assignments[i] = newAssignments[assignments[i]];
+  }
 
   Log::Info << currentCluster << " clusters found." << std::endl;
 
@@ -141,64 +157,133 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 }
 
 /**
- * Performs DBSCAN clustering on the data, returning the number of clusters and
- * also the list of cluster assignments.  This searches each point iteratively,
- * and can save on RAM usage.  It may be slower than the batch search with a
- * dual-tree algorithm.
+ * Performs DBSCAN clustering on the data, searching the points in blocks, so
+ * that only the neighborhoods of one block are held in memory at a time.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf,
+    std::vector<char>& corePoints,
+    std::vector<std::atomic<size_t>>& coreNeighbors)
 {
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  // The points are searched in blocks, so that a single-tree search can split
+  // the points of the block across threads.
+  const size_t blockSize = 1000;
+  for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
   {
-    if (i % 10000 == 0 && i > 0)
-      Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
+    if (begin % 10000 == 0 && begin > 0)
+      Log::Info << "DBSCAN clustering on point " << begin << "..." << std::endl;
 
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
+    // Do the range search for only this block.
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    rangeSearch.Search(data.cols(begin, end - 1), math::Range(0.0, epsilon),
+        neighbors, distances);
 
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    MergeBlock(begin, neighbors, uf, corePoints, coreNeighbors);
   }
 }
 
 /**
- * Performs DBSCAN clustering on the data, returning number of clusters
- * and also the list of cluster assignments.  This can perform search in batch,
- * naive search).
+ * Performs DBSCAN clustering on the data, searching all points in batch, so
+ * it is well suited for dual-tree or naive search.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
-    const MatType& data,
-    emst::UnionFind& uf)
+    const MatType& /* data */,
+    emst::ConcurrentUnionFind& uf,
+    std::vector<char>& corePoints,
+    std::vector<std::atomic<size_t>>& coreNeighbors)
 {
-  // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
-  Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
+  // The neighborhoods are never stored: the results of the range search are
+  // streamed to a callback, once to count the neighbors of each point and once
+  // to merge the core points.  The reference tree is reused as the query tree,
+  // so the points will not be returned in their own neighborhoods.  All of the
+  // results of a point are given by the same thread, so the counts don't need
+  // to be atomic.
+  Log::Info << "Counting neighbors." << std::endl;
+  std::vector<size_t> counts(corePoints.size(), 0);
+  auto countNeighbors = [&counts](const size_t queryIndex,
+                                  const size_t /* referenceIndex */,
+                                  const double /* distance */)
+  {
+    ++counts[queryIndex];
+  };
+  rangeSearch.Search(math::Range(0.0, epsilon), countNeighbors);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) counts.size(); ++i)
+    corePoints[i] = (counts[i] + 1 >= minPoints) ? 1 : 0;
+
+  // Each pair of points is given in both orders, so each pair of core points
+  // only needs to be merged once.
+  Log::Info << "Merging core points." << std::endl;
+  auto mergeNeighbors = [&](const size_t queryIndex,
+                            const size_t referenceIndex,
+                            const double /* distance */)
+  {
+    if (!corePoints[queryIndex])
+      return;
+
+    if (!corePoints[referenceIndex])
+      SetCoreNeighbor(coreNeighbors[referenceIndex], queryIndex);
+    else if (queryIndex < referenceIndex)
+      uf.Union(queryIndex, referenceIndex);
+  };
+  rangeSearch.Search(math::Range(0.0, epsilon), mergeNeighbors);
   Log::Info << "Range search complete." << std::endl;
+}
 
-  // Now loop over all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
+template<typename RangeSearchType, typename PointSelectionPolicy>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::MergeBlock(
+    const size_t begin,
+    const std::vector<std::vector<size_t>>& neighbors,
+    emst::ConcurrentUnionFind& uf,
+    std::vector<char>& corePoints,
+    std::vector<std::atomic<size_t>>& coreNeighbors)
+{
+  // Find the core points of the block first, so that the core points of the
+  // block can be merged with each other.  Each neighborhood includes its own
+  // point.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) neighbors.size(); ++i)
+    corePoints[begin + i] = (neighbors[i].size() >= minPoints) ? 1 : 0;
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) neighbors.size(); ++i)
   {
-    // Get the next index.
-    const size_t index = pointSelector.Select(i, data);
-    for (size_t j = 0; j < neighbors[index].size(); ++j)
-      uf.Union(index, neighbors[index][j]);
+    const size_t index = begin + i;
+    if (!corePoints[index])
+      continue;
+
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+    {
+      // If the neighbor is not a core point (or hasn't been searched yet), it
+      // may be a border point of this cluster.
+      const size_t neighbor = neighbors[i][j];
+      if (corePoints[neighbor])
+        uf.Union(index, neighbor);
+      else
+        SetCoreNeighbor(coreNeighbors[neighbor], index);
+    }
   }
 }
 
+template<typename RangeSearchType, typename PointSelectionPolicy>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::SetCoreNeighbor(
+    std::atomic<size_t>& coreNeighbor,
+    const size_t index)
+{
+  size_t current = coreNeighbor.load(std::memory_order_relaxed);
+  while (index < current && !coreNeighbor.compare_exchange_weak(current,
+      index, std::memory_order_relaxed)) { }
+}
+
 } // namespace dbscan
 } // namespace mlpack
 
@@ -22,7 +22,8 @@ namespace tree {
  * The AllCategoricalSplit is a splitting function that will split categorical
  * features into many children: one child for each category. This is a generic
  * splitting strategy and can be used for both regression and classification
- * trees.
+ * trees.  For features with many categories, BinaryCategoricalSplit, which
+ * splits the categories into two groups, is usually a better choice.
  *
  * @tparam FitnessFunction Fitness function to evaluate gain with.
  */
@@ -181,6 +181,15 @@ class BestBinaryNumericSplit
       const ElemType& point,
       const double& splitInfo,
       const AuxiliarySplitInfo& /* aux */);
+
+ private:
+  /**
+   * Return the indices that sort the given values.  When most of the values
+   * are zero (as for sparse or one-hot encoded data), only the nonzero values
+   * are sorted, so this takes O(n + k log k) time for k nonzero values.
+   */
+  template<typename VecType>
+  static arma::uvec SortIndex(const VecType& data);
 };
 
 } // namespace tree
@@ -36,7 +36,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     return DBL_MAX; // It can't be outperformed.
 
   // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
+  arma::uvec sortedIndices = SortIndex(data);
   arma::Row<size_t> sortedLabels(labels.n_elem);
   arma::rowvec sortedWeights;
   for (size_t i = 0; i < sortedLabels.n_elem; ++i)
@@ -213,7 +213,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     return DBL_MAX; // It can't be outperformed.
 
   // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
+  arma::uvec sortedIndices = SortIndex(data);
   arma::Row<RType> sortedResponses(responses.n_elem);
   arma::Row<WType> sortedWeights;
   for (size_t i = 0; i < sortedResponses.n_elem; ++i)
@@ -352,7 +352,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     return DBL_MAX; // It can't be outperformed.
 
   // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
+  arma::uvec sortedIndices = SortIndex(data);
   arma::Row<RType> sortedResponses(responses.n_elem);
   arma::Row<WType> sortedWeights;
   for (size_t i = 0; i < sortedResponses.n_elem; ++i)
@@ -469,6 +469,50 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   return bestFoundGain;
 }
 
+template<typename FitnessFunction>
+template<typename VecType>
+arma::uvec BestBinaryNumericSplit<FitnessFunction>::SortIndex(
+    const VecType& data)
+{
+  typedef typename VecType::elem_type ElemType;
+  const arma::Row<ElemType> values(data);
+
+  // Only the nonzero values need to be sorted: the zeros all go between the
+  // negative and the positive values.
+  const arma::uvec negative = arma::find(values < 0);
+  const arma::uvec positive = arma::find(values > 0);
+  const size_t numZeros = values.n_elem - negative.n_elem - positive.n_elem;
+  if (numZeros < values.n_elem / 4)
+    return arma::sort_index(values);
+
+  arma::uvec sortedIndices(values.n_elem);
+  size_t k = 0;
+  if (negative.n_elem > 0)
+  {
+    const arma::uvec order = arma::sort_index(values.cols(negative));
+    for (size_t i = 0; i < order.n_elem; ++i)
+      sortedIndices[k++] = negative[order[i]];
+  }
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    if (values[i] == 0)
+      sortedIndices[k++] = i;
+  }
+  if (positive.n_elem > 0)
+  {
+    const arma::uvec order = arma::sort_index(values.cols(positive));
+    for (size_t i = 0; i < order.n_elem; ++i)
+      sortedIndices[k++] = positive[order[i]];
+  }
+
+  // Values that are neither negative, zero nor positive (NaNs) can't be
+  // ordered this way.
+  if (k != values.n_elem)
+    return arma::sort_index(values);
+
+  return sortedIndices;
+}
+
 template<typename FitnessFunction>
 template<typename ElemType>
 size_t BestBinaryNumericSplit<FitnessFunction>::CalculateDirection(
@@ -0,0 +1,194 @@
+/**
+ * @file methods/decision_tree/binary_categorical_split.hpp
+ *
+ * A tree splitter that splits categorical features into two children, for
+ * features with many categories.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BinaryCategoricalSplit is a splitting function for decision trees that
+ * splits a categorical feature into two children, each holding a set of
+ * categories, instead of one child per category like AllCategoricalSplit.  This
+ * makes it usable for features with many categories, where each category only
+ * has a few points.
+ *
+ * Searching all of the 2^(k - 1) partitions of k categories is not feasible, so
+ * the categories are sorted and only the k - 1 partitions that keep the sorted
+ * order are searched, with the same scan as BestBinaryNumericSplit.  For
+ * regression, the categories are sorted by their mean response (for a gradient
+ * boosting tree, where the responses are gradients, this is the usual
+ * gradient-sorted order); this finds the best partition for the mean squared
+ * error.  For classification, the categories are sorted by the proportion of
+ * each class in turn, which finds the best partition for two classes.
+ *
+ * Categories that have no points at a node go to the child with the most
+ * points.  Trees with these splits can't be compiled into a FlatForest.
+ *
+ * @code
+ * DecisionTree<GiniGain, BestBinaryNumericSplit, BinaryCategoricalSplit>
+ *     tree(data, datasetInfo, labels, numClasses);
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to evaluate gain with.
+ */
+template<typename FitnessFunction>
+class BinaryCategoricalSplit
+{
+ public:
+  /**
+   * The child each category goes to.
+   */
+  class AuxiliarySplitInfo
+  {
+   public:
+    //! For each category seen during training, whether it goes to the second
+    //! child.
+    std::vector<bool> directions;
+
+    //! Serialize the split information.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(directions));
+    }
+  };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.  splitInfo will store the child that categories not in aux
+   * go to.
+   *
+   * This overload is used only for classification.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename LabelsType,
+           typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const size_t numCategories,
+      const LabelsType& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.  splitInfo will store the child that categories not in aux
+   * go to.
+   *
+   * This overload is used only for regression.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It it used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const size_t numCategories,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  static size_t NumChildren(const double& /* splitInfo */,
+                            const AuxiliarySplitInfo& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Calculate the direction a point should percolate to.
+   *
+   * @param point the Point to use.
+   * @param splitInfo The child that unseen categories go to.
+   * @param aux The child that each category goes to.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const double& splitInfo,
+      const AuxiliarySplitInfo& aux);
+
+ private:
+  /**
+   * Store the rank of each category in the order of the given keys into
+   * ranks, and the rank of the category of each point into pointRanks.
+   */
+  template<typename VecType>
+  static void RankCategories(const VecType& data,
+                             const arma::rowvec& keys,
+                             arma::uvec& ranks,
+                             arma::rowvec& pointRanks);
+
+  /**
+   * Fill the auxiliary split information for the split of the ranked
+   * categories at the given threshold, and return the child that categories
+   * without points go to.
+   */
+  static size_t StoreSplit(const arma::uvec& ranks,
+                           const double threshold,
+                           const arma::rowvec& categoryWeights,
+                           AuxiliarySplitInfo& aux);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "binary_categorical_split_impl.hpp"
+
+#endif
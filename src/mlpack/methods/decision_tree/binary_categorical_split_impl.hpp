@@ -0,0 +1,200 @@
+/**
+ * @file methods/decision_tree/binary_categorical_split_impl.hpp
+ *
+ * Implementation of the BinaryCategoricalSplit categorical split class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binary_categorical_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+// Overload used in classification.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename LabelsType,
+         typename WeightVecType>
+double BinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const LabelsType& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& aux)
+{
+  // Sum the weight of each class in each category.
+  arma::mat classWeights(numClasses, numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    classWeights((size_t) labels[i], (size_t) data[i]) +=
+        UseWeights ? (double) weights[i] : 1.0;
+  }
+  const arma::rowvec categoryWeights = arma::sum(classWeights, 0);
+
+  // For two classes, the best partition is one of the splits of the categories
+  // sorted by the proportion of the second class.  For more classes, we try the
+  // categories sorted by the proportion of each class.
+  const arma::Row<size_t> nodeLabels(labels);
+  const size_t firstClass = (numClasses == 2) ? 1 : 0;
+  double bestFoundGain = DBL_MAX;
+  double bestThreshold = 0.0;
+  arma::uvec bestRanks;
+  for (size_t k = firstClass; k < numClasses; ++k)
+  {
+    arma::rowvec keys(numCategories, arma::fill::zeros);
+    for (size_t c = 0; c < numCategories; ++c)
+    {
+      if (categoryWeights[c] > 0.0)
+        keys[c] = classWeights(k, c) / categoryWeights[c];
+    }
+
+    arma::uvec ranks;
+    arma::rowvec pointRanks;
+    RankCategories(data, keys, ranks, pointRanks);
+
+    arma::vec rankSplitInfo;
+    typename BestBinaryNumericSplit<FitnessFunction>::AuxiliarySplitInfo
+        rankAux;
+    const double gain = BestBinaryNumericSplit<FitnessFunction>::template
+        SplitIfBetter<UseWeights>((bestFoundGain == DBL_MAX) ? bestGain :
+        bestFoundGain, pointRanks, nodeLabels, numClasses, weights,
+        minimumLeafSize, (bestFoundGain == DBL_MAX) ? minimumGainSplit : 0.0,
+        rankSplitInfo, rankAux);
+
+    if (gain != DBL_MAX)
+    {
+      bestFoundGain = gain;
+      bestThreshold = rankSplitInfo[0];
+      bestRanks = std::move(ranks);
+    }
+  }
+
+  if (bestFoundGain == DBL_MAX)
+    return DBL_MAX;
+
+  splitInfo.set_size(1);
+  splitInfo[0] = StoreSplit(bestRanks, bestThreshold, categoryWeights, aux);
+  return bestFoundGain;
+}
+
+// Overload used in regression.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+double BinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& aux,
+    FitnessFunction& fitnessFunction)
+{
+  // Sort the categories by their mean response.
+  arma::rowvec categoryWeights(numCategories, arma::fill::zeros);
+  arma::rowvec keys(numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const double w = UseWeights ? (double) weights[i] : 1.0;
+    categoryWeights[(size_t) data[i]] += w;
+    keys[(size_t) data[i]] += w * responses[i];
+  }
+  for (size_t c = 0; c < numCategories; ++c)
+  {
+    if (categoryWeights[c] > 0.0)
+      keys[c] /= categoryWeights[c];
+  }
+
+  arma::uvec ranks;
+  arma::rowvec pointRanks;
+  RankCategories(data, keys, ranks, pointRanks);
+
+  double threshold;
+  typename BestBinaryNumericSplit<FitnessFunction>::AuxiliarySplitInfo rankAux;
+  const double gain = BestBinaryNumericSplit<FitnessFunction>::template
+      SplitIfBetter<UseWeights>(bestGain, pointRanks, responses, weights,
+      minimumLeafSize, minimumGainSplit, threshold, rankAux, fitnessFunction);
+
+  if (gain == DBL_MAX)
+    return DBL_MAX;
+
+  splitInfo = StoreSplit(ranks, threshold, categoryWeights, aux);
+  return gain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t BinaryCategoricalSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const double& splitInfo,
+    const AuxiliarySplitInfo& aux)
+{
+  const size_t category = (size_t) point;
+  if (category < aux.directions.size())
+    return aux.directions[category] ? 1 : 0;
+  else
+    return (size_t) splitInfo;
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void BinaryCategoricalSplit<FitnessFunction>::RankCategories(
+    const VecType& data,
+    const arma::rowvec& keys,
+    arma::uvec& ranks,
+    arma::rowvec& pointRanks)
+{
+  const arma::uvec order = arma::stable_sort_index(keys);
+  ranks.set_size(keys.n_elem);
+  for (size_t r = 0; r < order.n_elem; ++r)
+    ranks[order[r]] = r;
+
+  pointRanks.set_size(data.n_elem);
+  for (size_t i = 0; i < data.n_elem; ++i)
+    pointRanks[i] = (double) ranks[(size_t) data[i]];
+}
+
+template<typename FitnessFunction>
+size_t BinaryCategoricalSplit<FitnessFunction>::StoreSplit(
+    const arma::uvec& ranks,
+    const double threshold,
+    const arma::rowvec& categoryWeights,
+    AuxiliarySplitInfo& aux)
+{
+  double childWeights[2] = { 0.0, 0.0 };
+  aux.directions.resize(ranks.n_elem);
+  for (size_t c = 0; c < ranks.n_elem; ++c)
+  {
+    aux.directions[c] = ((double) ranks[c] > threshold);
+    childWeights[aux.directions[c] ? 1 : 0] += categoryWeights[c];
+  }
+
+  // Categories without points at this node go to the heavier child.
+  const size_t defaultChild = (childWeights[1] > childWeights[0]) ? 1 : 0;
+  for (size_t c = 0; c < ranks.n_elem; ++c)
+  {
+    if (categoryWeights[c] == 0.0)
+      aux.directions[c] = (defaultChild == 1);
+  }
+
+  return defaultChild;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,211 @@
+/**
+ * @file methods/decision_tree/binned_binary_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split between histogram
+ * bins, without sorting the points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINNED_BINARY_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINNED_BINARY_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BinnedBinaryNumericSplit is a splitting function for decision trees that
+ * searches a numeric dimension for the best binary split, considering only the
+ * boundaries between NumBins() equal-width bins spanning the values of the
+ * node.  The points are ordered by bin with a counting sort, which takes
+ * linear time and does not compare values, so finding a split costs O(n +
+ * NumBins()) per dimension instead of the O(n log n) sort of
+ * BestBinaryNumericSplit.  Since the bins are recomputed at each node, the
+ * splits get finer as the tree grows; nodes with at most NumBins() points use
+ * the exact search of BestBinaryNumericSplit.
+ *
+ * It can be used with GiniGain and InformationGain for classification, and
+ * with MSEGain and MADGain for regression, e.g.
+ *
+ * @code
+ * DecisionTree<GiniGain, BinnedBinaryNumericSplit> tree(data, labels, 3);
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class BinnedBinaryNumericSplit
+{
+ public:
+  // No extra info needed for split.
+  class AuxiliarySplitInfo { };
+
+  //! Return the number of bins that the values of a node are divided into.
+  static size_t NumBins() { return 256; }
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is used only for classification tasks.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is used only for regression tasks, with fitness functions
+   * that only implement Evaluate().
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It it used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is specialized for any fitness function that implements
+   * BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It it used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  static size_t NumChildren(const double& /* splitInfo */,
+                            const AuxiliarySplitInfo& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param splitInfo Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const double& splitInfo,
+      const AuxiliarySplitInfo& /* aux */);
+
+ private:
+  /**
+   * Order the points by bin with a counting sort.  For each bin b, the points
+   * of bins [0, b] are then sortedIndices[0, binEnds[b]).  splitValues[b] is
+   * the value halfway between the largest value of the bins [0, b] and the
+   * smallest value of the bins after b.  Returns false if all of the values are
+   * the same, so that no split is possible.
+   */
+  template<typename VecType>
+  static bool SortByBin(const VecType& data,
+                        arma::uvec& sortedIndices,
+                        arma::uvec& binEnds,
+                        arma::vec& splitValues);
+
+  //! Return true if bin b is empty.
+  static bool EmptyBin(const arma::uvec& binEnds, const size_t b)
+  {
+    return binEnds[b] == ((b == 0) ? 0 : binEnds[b - 1]);
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "binned_binary_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,528 @@
+/**
+ * @file methods/decision_tree/binned_binary_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split between
+ * histogram bins.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINNED_BINARY_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINNED_BINARY_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binned_binary_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+// Overload used for classification.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double BinnedBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Small nodes are searched exactly.
+  if (data.n_elem <= NumBins())
+  {
+    typename BestBinaryNumericSplit<FitnessFunction>::AuxiliarySplitInfo
+        bestAux;
+    return BestBinaryNumericSplit<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(bestGain, data, labels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, splitInfo, bestAux);
+  }
+
+  arma::uvec sortedIndices, binEnds;
+  arma::vec splitValues;
+  if (!SortByBin(data, sortedIndices, binEnds, splitValues))
+    return DBL_MAX;
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  const size_t n = data.n_elem;
+
+  // All of the points start on the right.
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, 2);
+    for (size_t i = 0; i < n; ++i)
+    {
+      classWeightSums(labels[i], 1) += weights[i];
+      totalRightWeight += weights[i];
+    }
+    totalWeight = totalRightWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    classCounts.zeros(numClasses, 2);
+    for (size_t i = 0; i < n; ++i)
+      ++classCounts(labels[i], 1);
+    bestFoundGain *= n;
+  }
+
+  // Loop through the boundaries between bins, choosing the best one.
+  size_t index = 0;
+  for (size_t b = 0; b + 1 < NumBins(); ++b)
+  {
+    if (binEnds[b] + minimum > n)
+      break;
+
+    // Move the points of this bin to the left child.
+    for (; index < binEnds[b]; ++index)
+    {
+      const size_t i = sortedIndices[index];
+      if (UseWeights)
+      {
+        classWeightSums(labels[i], 1) -= weights[i];
+        classWeightSums(labels[i], 0) += weights[i];
+        totalLeftWeight += weights[i];
+        totalRightWeight -= weights[i];
+      }
+      else
+      {
+        --classCounts(labels[i], 1);
+        ++classCounts(labels[i], 0);
+      }
+    }
+
+    // Make sure that the value has changed.
+    if (EmptyBin(binEnds, b) || index < minimum)
+      continue;
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    const double leftGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(0),
+            numClasses, totalLeftWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(0),
+            numClasses, index);
+    const double rightGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(1),
+            numClasses, totalRightWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(1),
+            numClasses, size_t(n - index));
+
+    double gain;
+    if (UseWeights)
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    else
+      gain = double(index) * leftGain + double(n - index) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just
+      // take this one.
+      splitInfo.set_size(1);
+      splitInfo[0] = splitValues[b];
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo.set_size(1);
+      splitInfo[0] = splitValues[b];
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= n;
+
+  return bestFoundGain;
+}
+
+// Overload used for regression.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+BinnedBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& /* aux */,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Small nodes are searched exactly.
+  if (data.n_elem <= NumBins())
+  {
+    typename BestBinaryNumericSplit<FitnessFunction>::AuxiliarySplitInfo
+        bestAux;
+    return BestBinaryNumericSplit<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(bestGain, data, responses, weights,
+        minimumLeafSize, minimumGainSplit, splitInfo, bestAux,
+        fitnessFunction);
+  }
+
+  arma::uvec sortedIndices, binEnds;
+  arma::vec splitValues;
+  if (!SortByBin(data, sortedIndices, binEnds, splitValues))
+    return DBL_MAX;
+
+  // The responses of the points of each child are contiguous once ordered by
+  // bin.
+  const size_t n = data.n_elem;
+  arma::Row<RType> sortedResponses(n);
+  arma::Row<WType> sortedWeights;
+  for (size_t i = 0; i < n; ++i)
+    sortedResponses[i] = responses[sortedIndices[i]];
+  if (UseWeights)
+  {
+    sortedWeights.set_size(n);
+    for (size_t i = 0; i < n; ++i)
+      sortedWeights[i] = weights[sortedIndices[i]];
+  }
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  WType totalWeight = 0.0;
+  WType totalLeftWeight = 0.0;
+  WType totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    totalWeight = arma::accu(sortedWeights);
+    totalRightWeight = totalWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    bestFoundGain *= n;
+  }
+
+  // Loop through the boundaries between bins, choosing the best one.
+  size_t index = 0;
+  for (size_t b = 0; b + 1 < NumBins(); ++b)
+  {
+    if (binEnds[b] + minimum > n)
+      break;
+
+    for (; index < binEnds[b]; ++index)
+    {
+      if (UseWeights)
+      {
+        totalLeftWeight += sortedWeights[index];
+        totalRightWeight -= sortedWeights[index];
+      }
+    }
+
+    // Make sure that the value has changed.
+    if (EmptyBin(binEnds, b) || index < minimum)
+      continue;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, 0, index);
+    const double rightGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, index, n);
+
+    double gain;
+    if (UseWeights)
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    else
+      gain = double(index) * leftGain + double(n - index) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      splitInfo = splitValues[b];
+      return gain;
+    }
+    if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo = splitValues[b];
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= n;
+
+  return bestFoundGain;
+}
+
+// Optimized version for any fitness function that implements
+// BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+BinnedBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& /* aux */,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Small nodes are searched exactly.
+  if (data.n_elem <= NumBins())
+  {
+    typename BestBinaryNumericSplit<FitnessFunction>::AuxiliarySplitInfo
+        bestAux;
+    return BestBinaryNumericSplit<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(bestGain, data, responses, weights,
+        minimumLeafSize, minimumGainSplit, splitInfo, bestAux,
+        fitnessFunction);
+  }
+
+  arma::uvec sortedIndices, binEnds;
+  arma::vec splitValues;
+  if (!SortByBin(data, sortedIndices, binEnds, splitValues))
+    return DBL_MAX;
+
+  const size_t n = data.n_elem;
+  arma::Row<RType> sortedResponses(n);
+  arma::Row<WType> sortedWeights;
+  for (size_t i = 0; i < n; ++i)
+    sortedResponses[i] = responses[sortedIndices[i]];
+  if (UseWeights)
+  {
+    sortedWeights.set_size(n);
+    for (size_t i = 0; i < n; ++i)
+      sortedWeights[i] = weights[sortedIndices[i]];
+  }
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  WType totalWeight = 0.0;
+  WType leftChildWeight = 0.0;
+  WType rightChildWeight = 0.0;
+  if (UseWeights)
+  {
+    totalWeight = arma::accu(sortedWeights);
+    rightChildWeight = totalWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    bestFoundGain *= n;
+  }
+
+  // All of the points start on the right, and are stepped through one by one.
+  fitnessFunction.template BinaryScanInitialize<UseWeights>(sortedResponses,
+      sortedWeights, 1);
+
+  // Loop through the boundaries between bins, choosing the best one.
+  size_t index = 0;
+  for (size_t b = 0; b + 1 < NumBins(); ++b)
+  {
+    if (binEnds[b] + minimum > n)
+      break;
+
+    for (; index < binEnds[b]; ++index)
+    {
+      if (UseWeights)
+      {
+        leftChildWeight += sortedWeights[index];
+        rightChildWeight -= sortedWeights[index];
+      }
+
+      // Steps through the current index and updates the cached data.
+      fitnessFunction.template BinaryStep<UseWeights>(sortedResponses,
+          sortedWeights, index);
+    }
+
+    // Make sure that the value has changed.
+    if (EmptyBin(binEnds, b) || index < minimum)
+      continue;
+
+    // Calculate the gain for the left and right child.
+    std::tuple<double, double> binaryGains = fitnessFunction.BinaryGains();
+    const double leftGain = std::get<0>(binaryGains);
+    const double rightGain = std::get<1>(binaryGains);
+
+    double gain;
+    if (UseWeights)
+      gain = leftChildWeight * leftGain + rightChildWeight * rightGain;
+    else
+      gain = double(index) * leftGain + double(n - index) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      splitInfo = splitValues[b];
+      return gain;
+    }
+    if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo = splitValues[b];
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= n;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t BinnedBinaryNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const double& splitInfo,
+    const AuxiliarySplitInfo& /* aux */)
+{
+  if (point <= splitInfo)
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+bool BinnedBinaryNumericSplit<FitnessFunction>::SortByBin(
+    const VecType& data,
+    arma::uvec& sortedIndices,
+    arma::uvec& binEnds,
+    arma::vec& splitValues)
+{
+  const size_t n = data.n_elem;
+  const size_t numBins = NumBins();
+
+  double minValue = data[0];
+  double maxValue = data[0];
+  for (size_t i = 1; i < n; ++i)
+  {
+    minValue = std::min(minValue, (double) data[i]);
+    maxValue = std::max(maxValue, (double) data[i]);
+  }
+
+  if (minValue == maxValue)
+    return false;
+
+  // Count the points of each bin, and track the extreme values of each bin.
+  const double scale = numBins / (maxValue - minValue);
+  arma::uvec pointBins(n);
+  arma::vec binMin(numBins), binMax(numBins);
+  binMin.fill(DBL_MAX);
+  binMax.fill(-DBL_MAX);
+  binEnds.zeros(numBins);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double value = (double) data[i];
+    const size_t b = std::min((size_t) ((value - minValue) * scale),
+        numBins - 1);
+    pointBins[i] = b;
+    ++binEnds[b];
+    binMin[b] = std::min(binMin[b], value);
+    binMax[b] = std::max(binMax[b], value);
+  }
+
+  // Turn the counts into the positions of each bin, then place the points.
+  arma::uvec next(numBins);
+  next[0] = 0;
+  for (size_t b = 1; b < numBins; ++b)
+  {
+    binEnds[b] += binEnds[b - 1];
+    next[b] = binEnds[b - 1];
+  }
+
+  sortedIndices.set_size(n);
+  for (size_t i = 0; i < n; ++i)
+    sortedIndices[next[pointBins[i]]++] = i;
+
+  // The split after bin b is halfway between the largest value of the bins up
+  // to b and the smallest value of the bins after b.  It is only used when bin
+  // b and a later bin have points, so the largest value is that of bin b.
+  double rightMin = DBL_MAX;
+  splitValues.set_size(numBins);
+  for (size_t b = numBins; b > 0; --b)
+  {
+    splitValues[b - 1] = (binMax[b - 1] + rightMin) / 2.0;
+    rightMin = std::min(rightMin, binMin[b - 1]);
+  }
+
+  return true;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
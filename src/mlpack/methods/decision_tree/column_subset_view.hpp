@@ -0,0 +1,153 @@
+/**
+ * @file methods/decision_tree/column_subset_view.hpp
+ *
+ * Definition of the ColumnSubsetView class, which presents a subset of the
+ * columns of a matrix to DecisionTree without copying them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_COLUMN_SUBSET_VIEW_HPP
+#define MLPACK_METHODS_DECISION_TREE_COLUMN_SUBSET_VIEW_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A ColumnSubsetView holds a reference to a matrix and a list of column
+ * indices, and provides the part of the matrix interface that DecisionTree
+ * training uses: n_rows, n_cols, element access, swap_cols() (which only swaps
+ * the indices), and cols(first, last).row(i) (which gathers the values of one
+ * dimension into a row vector).  Many decision trees can then be trained on
+ * different subsets of the same dataset, each holding only its own indices, and
+ * sparse matrices can be partitioned without moving their nonzeros.
+ *
+ * The matrix must outlive the view, and must not be modified while the view is
+ * in use.
+ *
+ * @tparam MatType Type of the matrix.
+ */
+template<typename MatType>
+class ColumnSubsetView
+{
+ public:
+  //! The type of the elements of the matrix.
+  typedef typename MatType::elem_type elem_type;
+
+  /**
+   * A range of consecutive columns of the view.
+   */
+  class Columns
+  {
+   public:
+    //! Create the range of columns [first, last] of the given view.
+    Columns(const ColumnSubsetView& view,
+            const size_t first,
+            const size_t last) :
+        view(view), first(first), last(last) { }
+
+    //! Gather dimension i of the columns of the range into a row vector.
+    arma::Row<elem_type> row(const size_t i) const
+    {
+      arma::Row<elem_type> values(last - first + 1);
+      for (size_t j = first; j <= last; ++j)
+        values[j - first] = view(i, j);
+      return values;
+    }
+
+   private:
+    //! The view the columns belong to.
+    const ColumnSubsetView& view;
+    //! The first column of the range.
+    size_t first;
+    //! The last column of the range.
+    size_t last;
+  };
+
+  /**
+   * Create a view of the given columns of the given matrix.
+   *
+   * @param data Matrix to view.
+   * @param indices Indices of the columns of the matrix in the view.
+   */
+  ColumnSubsetView(const MatType& data, arma::uvec indices) :
+      data(&data),
+      indices(std::move(indices)),
+      n_rows(data.n_rows),
+      n_cols(this->indices.n_elem)
+  { }
+
+  //! Get element (i, j) of the view.
+  elem_type operator()(const size_t i, const size_t j) const
+  {
+    return (*data)(i, indices[j]);
+  }
+
+  //! Get the columns [first, last] of the view.
+  Columns cols(const size_t first, const size_t last) const
+  {
+    return Columns(*this, first, last);
+  }
+
+  //! Swap columns i and j of the view; the matrix is not modified.
+  void swap_cols(const size_t i, const size_t j)
+  {
+    std::swap(indices[i], indices[j]);
+  }
+
+  //! Get the matrix.
+  const MatType& Data() const { return *data; }
+  //! Get the indices of the columns of the matrix in the view.
+  const arma::uvec& Indices() const { return indices; }
+
+ private:
+  //! The matrix.
+  const MatType* data;
+  //! The indices of the columns of the matrix in the view.
+  arma::uvec indices;
+
+ public:
+  //! The number of rows of the view.
+  size_t n_rows;
+  //! The number of columns of the view.
+  size_t n_cols;
+};
+
+/**
+ * The matrix that DecisionTree training partitions in place.  Dense matrices
+ * are partitioned directly, but swapping two columns of a sparse matrix moves
+ * all of the nonzeros between them, so sparse matrices are partitioned through
+ * a ColumnSubsetView instead.
+ */
+template<typename MatType, bool IsSparse = arma::is_SpMat<MatType>::value>
+struct TrainingView
+{
+  //! The type training partitions.
+  typedef MatType& type;
+
+  //! Return the object training partitions for the given data.
+  static MatType& Create(MatType& data) { return data; }
+};
+
+template<typename MatType>
+struct TrainingView<MatType, true>
+{
+  //! The type training partitions.
+  typedef ColumnSubsetView<MatType> type;
+
+  //! Return the object training partitions for the given data.
+  static ColumnSubsetView<MatType> Create(const MatType& data)
+  {
+    return ColumnSubsetView<MatType>(data, (data.n_cols == 0) ? arma::uvec() :
+        arma::regspace<arma::uvec>(0, data.n_cols - 1));
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -17,9 +17,13 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "binned_binary_numeric_split.hpp"
 #include "random_binary_numeric_split.hpp"
 #include "all_categorical_split.hpp"
+#include "binary_categorical_split.hpp"
 #include "all_dimension_select.hpp"
+#include "column_subset_view.hpp"
+#include "flat_forest.hpp"
 #include <type_traits>
 
 namespace mlpack {
@@ -31,6 +35,16 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is available and training is not already running in a parallel
+ * region, large trees are trained in parallel: the dimensions of large nodes
+ * are searched in parallel, and once the top of the tree has been split, the
+ * subtrees below it are trained in parallel.
+ *
+ * The tree can be trained on sparse data (arma::sp_mat).  The points of a node
+ * are then kept together through a view that reorders column indices, so no
+ * nonzero is moved while training, and the numeric splits only sort the
+ * nonzero values of each dimension.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -446,6 +460,19 @@ class DecisionTree :
                 arma::Row<size_t>& predictions,
                 arma::mat& probabilities) const;
 
+  /**
+   * Compile the trained tree into a FlatForest, which classifies batches of
+   * points faster and gives the same predictions and probabilities.  The tree
+   * must use binary numeric splits and AllCategoricalSplit (see FlatForest);
+   * otherwise std::invalid_argument is thrown.
+   */
+  FlatForest Compile() const
+  {
+    FlatForest forest;
+    forest.AddTree(*this);
+    return forest;
+  }
+
   /**
    * Serialize the tree.
    */
@@ -463,6 +490,17 @@ class DecisionTree :
   //! Get the split dimension (only meaningful if this is a non-leaf in a
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionTypeOrMajorityClass;
+  }
+  //! Get the split information (only meaningful if this is a non-leaf in a
+  //! trained tree).
+  double SplitInfo() const { return classProbabilities[0]; }
+  //! Get the class probabilities (only meaningful if this is a leaf).
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
 
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
@@ -504,6 +542,35 @@ class DecisionTree :
   typedef typename CategoricalSplit::AuxiliarySplitInfo
       CategoricalAuxiliarySplitInfo;
 
+  //! Serialize the given auxiliary split information base class, if it holds
+  //! anything.
+  template<typename AuxType, typename Archive>
+  void SerializeAux(Archive& ar,
+                    const char* name,
+                    const std::enable_if_t<
+                        !std::is_empty<AuxType>::value>* = 0)
+  {
+    ar(cereal::make_nvp(name, static_cast<AuxType&>(*this)));
+  }
+
+  //! Nothing has to be serialized for an empty auxiliary split information
+  //! class.
+  template<typename AuxType, typename Archive>
+  void SerializeAux(Archive& /* ar */,
+                    const char* /* name */,
+                    const std::enable_if_t<
+                        std::is_empty<AuxType>::value>* = 0) { }
+
+  //! Reset the auxiliary split information of the split type that was not
+  //! chosen, so that it doesn't hold on to anything.
+  void ClearUnusedAux(const bool categorical)
+  {
+    if (categorical)
+      NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    else
+      CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+  }
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -569,6 +636,92 @@ class DecisionTree :
                const double minimumGainSplit,
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Find the best split of the points of this node and, if there is one,
+   * reorder the points by child and create the (untrained) children;
+   * otherwise, make this node a leaf.  The dimensions of large nodes are
+   * searched in parallel.  The parameters are the same as for Train().
+   *
+   * @param childCounts This will be filled with the number of points of each
+   *      child.
+   * @return The gain of the best split, or of the node if it is a leaf.
+   */
+  template<bool UseWeights, typename MatType>
+  double SplitNode(MatType& data,
+                   const size_t begin,
+                   const size_t count,
+                   const data::DatasetInfo& datasetInfo,
+                   arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   arma::rowvec& weights,
+                   const size_t minimumLeafSize,
+                   const double minimumGainSplit,
+                   const size_t maximumDepth,
+                   DimensionSelectionType& dimensionSelector,
+                   arma::Row<size_t>& childCounts);
+
+  /**
+   * Find the best split of the points of this node, assuming that all
+   * dimensions are numeric; see the other overload.
+   */
+  template<bool UseWeights, typename MatType>
+  double SplitNode(MatType& data,
+                   const size_t begin,
+                   const size_t count,
+                   arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   arma::rowvec& weights,
+                   const size_t minimumLeafSize,
+                   const double minimumGainSplit,
+                   const size_t maximumDepth,
+                   DimensionSelectionType& dimensionSelector,
+                   arma::Row<size_t>& childCounts);
+
+  /**
+   * Train the children of this node, which has just been split by
+   * SplitNode(), in parallel: the top of the tree is split serially and the
+   * subtrees below it are trained in parallel.  With a deterministic
+   * dimension selector and split, the tree and the returned entropy are the
+   * same as those of a serial Train().
+   *
+   * @param datasetInfo Type information for each dimension, or NULL if all
+   *      dimensions are numeric.
+   * @param childCounts Number of points of each child of this node.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainSubtrees(MatType& data,
+                       const size_t begin,
+                       const size_t count,
+                       const data::DatasetInfo* datasetInfo,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       arma::rowvec& weights,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const size_t maximumDepth,
+                       DimensionSelectionType& dimensionSelector,
+                       const arma::Row<size_t>& childCounts);
+
+  //! Return true if the given numbers of points and dimensions of a node are
+  //! worth searching in parallel (and we are not in a parallel region).
+  static bool ParallelSplitSearch(const size_t count,
+                                  const size_t numDimensions);
+
+  //! Return true if a node with the given number of points is worth training
+  //! in parallel (and we are not in a parallel region).
+  static bool ParallelSubtrees(const size_t count);
+
+  /**
+   * Given the gain of the best split of each dimension (or DBL_MAX), each
+   * found against the gain of the node, return the index of the split that a
+   * serial search of the dimensions in the same order would choose, or
+   * gains.size() if there is none.  In that case bestGain is not modified.
+   */
+  static size_t BestSplit(const std::vector<double>& gains,
+                          const double minimumGainSplit,
+                          double& bestGain);
 };
 
 /**
@@ -14,6 +14,10 @@
 
 #include "decision_tree.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -48,10 +52,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  Train<false>(trainingData, 0, trainingData.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -85,10 +93,15 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<false>(trainingData, 0, trainingData.n_cols, tmpLabels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -127,9 +140,13 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  Train<true>(trainingData, 0, trainingData.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -167,9 +184,13 @@ DecisionTree<FitnessFunction,
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-              tmpWeights, minimumLeafSize, minimumGainSplit);
+  Train<true>(trainingData, 0, trainingData.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct and train with weights.
@@ -209,9 +230,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<true>(trainingData, 0, trainingData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -253,9 +279,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<true>(trainingData, 0, trainingData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct, don't train.
@@ -453,11 +484,15 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  return Train<false>(trainingData, 0, trainingData.n_cols, datasetInfo,
+      tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -493,10 +528,14 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<false>(trainingData, 0, trainingData.n_cols, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -541,10 +580,14 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  return Train<true>(trainingData, 0, trainingData.n_cols, datasetInfo,
+      tmpLabels, numClasses, tmpWeights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given weighted data.
@@ -587,13 +630,17 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<true>(trainingData, 0, trainingData.n_cols, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
-//! Train on the given data, assuming all dimensions are numeric.
+//! Train on the given data.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
@@ -616,6 +663,151 @@ double DecisionTree<FitnessFunction,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector)
+{
+  arma::Row<size_t> childCounts;
+  double bestGain = SplitNode<UseWeights>(data, begin, count, datasetInfo,
+      labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector, childCounts);
+
+  // If we are a leaf, bestGain is the gain of the node.
+  if (children.empty())
+    return -bestGain;
+
+  // The subtrees of large trees are built in parallel.
+  if (ParallelSubtrees(count))
+  {
+    return TrainSubtrees<UseWeights>(data, begin, count, &datasetInfo, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, childCounts);
+  }
+
+  // Initialize bestGain if recursive split is allowed.
+  if (!NoRecursion)
+  {
+    bestGain = 0.0;
+  }
+
+  size_t childBegin = begin;
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    // Now build the child recursively.
+    if (NoRecursion)
+    {
+      children[i]->template Train<UseWeights>(data, childBegin,
+          childCounts[i], datasetInfo, labels, numClasses, weights,
+          childCounts[i], minimumGainSplit, maximumDepth - 1,
+          dimensionSelector);
+    }
+    else
+    {
+      // During recursion entropy of child node may change.
+      double childGain = children[i]->template Train<UseWeights>(data,
+          childBegin, childCounts[i], datasetInfo, labels, numClasses,
+          weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
+          dimensionSelector);
+      bestGain += double(childCounts[i]) / double(count) * (-childGain);
+    }
+    childBegin += childCounts[i];
+  }
+
+  return -bestGain;
+}
+
+//! Train on the given data, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  arma::Row<size_t> childCounts;
+  double bestGain = SplitNode<UseWeights>(data, begin, count, labels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector, childCounts);
+
+  // If we are a leaf, bestGain is the gain of the node.
+  if (children.empty())
+    return -bestGain;
+
+  // The subtrees of large trees are built in parallel.
+  if (ParallelSubtrees(count))
+  {
+    return TrainSubtrees<UseWeights>(data, begin, count, NULL, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, childCounts);
+  }
+
+  // Initialize bestGain if recursive split is allowed.
+  if (!NoRecursion)
+  {
+    bestGain = 0.0;
+  }
+
+  size_t childBegin = begin;
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    // Now build the child recursively.
+    if (NoRecursion)
+    {
+      children[i]->template Train<UseWeights>(data, childBegin,
+          childCounts[i], labels, numClasses, weights, childCounts[i],
+          minimumGainSplit, maximumDepth - 1, dimensionSelector);
+    }
+    else
+    {
+      // During recursion entropy of child node may change.
+      double childGain = children[i]->template Train<UseWeights>(data,
+          childBegin, childCounts[i], labels, numClasses, weights,
+          minimumLeafSize, minimumGainSplit, maximumDepth - 1,
+          dimensionSelector);
+      bestGain += double(childCounts[i]) / double(count) * (-childGain);
+    }
+    childBegin += childCounts[i];
+  }
+
+  return -bestGain;
+}
+
+//! Split the node, without training the children.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::SplitNode(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo& datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    arma::Row<size_t>& childCounts)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -636,48 +828,111 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    std::vector<size_t> dimensions;
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    if (ParallelSplitSearch(count, dimensions.size()))
     {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      // Search all of the dimensions in parallel, each against the gain of the
+      // node, with their own auxiliary information.
+      const double nodeGain = bestGain;
+      std::vector<double> gains(dimensions.size(), DBL_MAX);
+      std::vector<arma::vec> splitInfo(dimensions.size());
+      std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+      std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+          dimensions.size());
+
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t j = 0; j < (omp_size_t) dimensions.size(); ++j)
       {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
+        const size_t i = dimensions[j];
+        if (datasetInfo.Type(i) == data::Datatype::categorical)
+        {
+          gains[j] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              data.cols(begin, begin + count - 1).row(i),
+              datasetInfo.NumMappings(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              splitInfo[j],
+              categoricalAux[j]);
+        }
+        else if (datasetInfo.Type(i) == data::Datatype::numeric)
+        {
+          gains[j] = NumericSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              data.cols(begin, begin + count - 1).row(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              splitInfo[j],
+              numericAux[j]);
+        }
       }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+
+      const size_t best = BestSplit(gains, minimumGainSplit, bestGain);
+      if (best != gains.size())
       {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
+        bestDim = dimensions[best];
+        classProbabilities = std::move(splitInfo[best]);
+        NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+        CategoricalAuxiliarySplitInfo::operator=(categoricalAux[best]);
       }
+    }
+    else
+    {
+      for (size_t j = 0; j < dimensions.size(); ++j)
+      {
+        const size_t i = dimensions[j];
+        double dimGain = -DBL_MAX;
+        if (datasetInfo.Type(i) == data::Datatype::categorical)
+        {
+          dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(
+              bestGain,
+              data.cols(begin, begin + count - 1).row(i),
+              datasetInfo.NumMappings(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              classProbabilities,
+              *this);
+        }
+        else if (datasetInfo.Type(i) == data::Datatype::numeric)
+        {
+          dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+              data.cols(begin, begin + count - 1).row(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              classProbabilities,
+              *this);
+        }
 
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
+        // If the splitter reported that it did not split, move to the next
+        // dimension.
+        if (dimGain == DBL_MAX)
+          continue;
 
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
+        // Was there an improvement?  If so mark that it's the new best
+        // dimension.
+        bestDim = i;
+        bestGain = dimGain;
 
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
+        // If the gain is the best possible, no need to keep looking.
+        if (bestGain >= 0.0)
+          break;
+      }
     }
   }
 
@@ -686,6 +941,7 @@ double DecisionTree<FitnessFunction,
   {
     dimensionTypeOrMajorityClass = (size_t) datasetInfo.Type(bestDim);
     splitDimension = bestDim;
+    ClearUnusedAux(datasetInfo.Type(bestDim) == data::Datatype::categorical);
 
     // Get the number of children we will have.
     size_t numChildren = 0;
@@ -712,16 +968,10 @@ double DecisionTree<FitnessFunction,
     }
 
     // Figure out counts of children.
-    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
+    childCounts.zeros(numChildren);
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
     // Split into children.
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
@@ -740,25 +990,7 @@ double DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
+      children.push_back(new DecisionTree());
     }
   }
   else
@@ -774,10 +1006,11 @@ double DecisionTree<FitnessFunction,
         UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   }
 
-  return -bestGain;
+  return bestGain;
 }
 
-//! Train on the given data, assuming all dimensions are numeric.
+//! Split the node, assuming all dimensions are numeric, without training the
+//! children.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
@@ -788,7 +1021,7 @@ double DecisionTree<FitnessFunction,
                     NumericSplitType,
                     CategoricalSplitType,
                     DimensionSelectionType,
-                    NoRecursion>::Train(
+                    NoRecursion>::SplitNode(
     MatType& data,
     const size_t begin,
     const size_t count,
@@ -798,7 +1031,8 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    arma::Row<size_t>& childCounts)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -821,33 +1055,70 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    std::vector<size_t> dimensions;
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
-    {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
-
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
+      dimensions.push_back(i);
 
-      bestDim = i;
-      bestGain = dimGain;
+    if (ParallelSplitSearch(count, dimensions.size()))
+    {
+      // Search all of the dimensions in parallel, each against the gain of the
+      // node, with their own auxiliary information.
+      const double nodeGain = bestGain;
+      std::vector<double> gains(dimensions.size(), DBL_MAX);
+      std::vector<arma::vec> splitInfo(dimensions.size());
+      std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t j = 0; j < (omp_size_t) dimensions.size(); ++j)
+      {
+        gains[j] = NumericSplit::template SplitIfBetter<UseWeights>(nodeGain,
+            data.cols(begin, begin + count - 1).row(dimensions[j]),
+            labels.cols(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            splitInfo[j],
+            numericAux[j]);
+      }
 
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
+      const size_t best = BestSplit(gains, minimumGainSplit, bestGain);
+      if (best != gains.size())
+      {
+        bestDim = dimensions[best];
+        classProbabilities = std::move(splitInfo[best]);
+        NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+      }
+    }
+    else
+    {
+      for (size_t j = 0; j < dimensions.size(); ++j)
+      {
+        const size_t i = dimensions[j];
+        const double dimGain = NumericSplit::template
+            SplitIfBetter<UseWeights>(bestGain,
+                data.cols(begin, begin + count - 1).row(i),
+                labels.cols(begin, begin + count - 1),
+                numClasses,
+                UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+                minimumLeafSize,
+                minimumGainSplit,
+                classProbabilities,
+                *this);
+
+        // If the splitter did not report that it improved, then move to the
+        // next dimension.
+        if (dimGain == DBL_MAX)
+          continue;
+
+        bestDim = i;
+        bestGain = dimGain;
+
+        // If the gain is the best possible, no need to keep looking.
+        if (bestGain >= 0.0)
+          break;
+      }
     }
   }
 
@@ -870,17 +1141,10 @@ double DecisionTree<FitnessFunction,
     }
 
     // Calculate counts of children in each node.
-    arma::Row<size_t> childCounts(numChildren);
-    childCounts.zeros();
+    childCounts.zeros(numChildren);
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
@@ -898,25 +1162,7 @@ double DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
+      children.push_back(new DecisionTree());
     }
   }
   else
@@ -931,7 +1177,214 @@ double DecisionTree<FitnessFunction,
         UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   }
 
-  return -bestGain;
+  return bestGain;
+}
+
+//! Train the children of a large split node in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::TrainSubtrees(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    const arma::Row<size_t>& childCounts)
+{
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+
+  // Split the top of the tree serially, breadth-first, until all the unsplit
+  // nodes are small enough that there are several of them per thread, so that
+  // the dynamic schedule can balance the load.  This node is the first one,
+  // and the children of each split node are consecutive.
+  const size_t maxSubtreeSize = count / (4 * numThreads);
+  std::vector<DecisionTree*> nodes(1, this);
+  std::vector<size_t> begins(1, begin), counts(1, count);
+  std::vector<size_t> depths(1, maximumDepth), firstChild(1, 1);
+  std::vector<double> gains(1, 0.0);
+  std::vector<size_t> subtrees;
+
+  for (size_t s = 0; s < nodes.size(); ++s)
+  {
+    DecisionTree* node = nodes[s];
+    arma::Row<size_t> nodeChildCounts;
+    if (s == 0)
+    {
+      // This node has already been split.
+      nodeChildCounts = childCounts;
+    }
+    else if (counts[s] <= maxSubtreeSize)
+    {
+      subtrees.push_back(s);
+      continue;
+    }
+    else
+    {
+      const double gain = datasetInfo ?
+          node->template SplitNode<UseWeights>(data, begins[s], counts[s],
+              *datasetInfo, labels, numClasses, weights, minimumLeafSize,
+              minimumGainSplit, depths[s], dimensionSelector,
+              nodeChildCounts) :
+          node->template SplitNode<UseWeights>(data, begins[s], counts[s],
+              labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+              depths[s], dimensionSelector, nodeChildCounts);
+
+      if (node->children.empty())
+      {
+        gains[s] = -gain;
+        continue;
+      }
+      firstChild[s] = nodes.size();
+    }
+
+    size_t childBegin = begins[s];
+    for (size_t i = 0; i < node->children.size(); ++i)
+    {
+      nodes.push_back(node->children[i]);
+      begins.push_back(childBegin);
+      counts.push_back(nodeChildCounts[i]);
+      depths.push_back(depths[s] - 1);
+      firstChild.push_back(0);
+      gains.push_back(0.0);
+      childBegin += nodeChildCounts[i];
+    }
+  }
+
+  // The subtrees hold disjoint ranges of points, so they can be built in
+  // parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    const size_t s = subtrees[i];
+    // The dimension selector may hold state, so each subtree uses its own.
+    DimensionSelectionType selector(dimensionSelector);
+    gains[s] = datasetInfo ?
+        nodes[s]->template Train<UseWeights>(data, begins[s], counts[s],
+            *datasetInfo, labels, numClasses, weights, minimumLeafSize,
+            minimumGainSplit, depths[s], selector) :
+        nodes[s]->template Train<UseWeights>(data, begins[s], counts[s],
+            labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+            depths[s], selector);
+  }
+
+  // Now compute the gains of the split nodes, children first, just as Train()
+  // does.
+  for (size_t s = nodes.size(); s > 0; --s)
+  {
+    const size_t n = s - 1;
+    if (firstChild[n] == 0)
+      continue; // A leaf or a subtree.
+
+    double bestGain = 0.0;
+    for (size_t i = 0; i < nodes[n]->children.size(); ++i)
+    {
+      const size_t child = firstChild[n] + i;
+      bestGain += double(counts[child]) / double(counts[n]) * (-gains[child]);
+    }
+    gains[n] = -bestGain;
+  }
+
+  return gains[0];
+}
+
+//! Return whether to search the dimensions of a node in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+bool DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  NoRecursion>::ParallelSplitSearch(
+    const size_t count,
+    const size_t numDimensions)
+{
+  #ifdef HAS_OPENMP
+  // Small nodes are not worth the overhead.
+  return (numDimensions > 1) && (count >= 1000) &&
+      (omp_get_max_threads() > 1) && !omp_in_parallel();
+  #else
+  (void) count;
+  (void) numDimensions;
+  return false;
+  #endif
+}
+
+//! Return whether to build the subtrees of a node in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+bool DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  NoRecursion>::ParallelSubtrees(const size_t count)
+{
+  #ifdef HAS_OPENMP
+  // Small trees are not worth the overhead.
+  return !NoRecursion && (count >= 10000) && (omp_get_max_threads() > 1) &&
+      !omp_in_parallel();
+  #else
+  (void) count;
+  return false;
+  #endif
+}
+
+//! Choose the split that a serial search of the dimensions would choose.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::BestSplit(
+    const std::vector<double>& gains,
+    const double minimumGainSplit,
+    double& bestGain)
+{
+  size_t best = gains.size();
+  for (size_t j = 0; j < gains.size(); ++j)
+  {
+    // A serial search only takes a later dimension if it improves on the best
+    // split so far by at least minimumGainSplit.
+    if (gains[j] == DBL_MAX ||
+        (best != gains.size() && gains[j] <= bestGain + minimumGainSplit))
+      continue;
+
+    best = j;
+    bestGain = gains[j];
+
+    // If the gain is the best possible, a serial search stops here.
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  return best;
 }
 
 //! Return the class.
@@ -1004,7 +1457,8 @@ void DecisionTree<FitnessFunction,
   }
 
   // Loop over each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     predictions[i] = Classify(data.col(i));
 }
 
@@ -1038,7 +1492,8 @@ void DecisionTree<FitnessFunction,
     node = &node->Child(0);
   probabilities.set_size(node->classProbabilities.n_elem, data.n_cols);
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
     arma::vec v = probabilities.unsafe_col(i); // Alias of column.
     Classify(data.col(i), predictions[i], v);
@@ -1073,6 +1528,10 @@ void DecisionTree<FitnessFunction,
   ar(CEREAL_NVP(splitDimension));
   ar(CEREAL_NVP(dimensionTypeOrMajorityClass));
   ar(CEREAL_NVP(classProbabilities));
+
+  // Empty auxiliary split information classes add nothing to the archive.
+  SerializeAux<NumericAuxiliarySplitInfo>(ar, "numericAux");
+  SerializeAux<CategoricalAuxiliarySplitInfo>(ar, "categoricalAux");
 }
 
 template<typename FitnessFunction,
@@ -17,9 +17,12 @@
 #include "mad_gain.hpp"
 #include "mse_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "binned_binary_numeric_split.hpp"
 #include "all_categorical_split.hpp"
+#include "binary_categorical_split.hpp"
 #include "random_binary_numeric_split.hpp"
 #include "all_dimension_select.hpp"
+#include "column_subset_view.hpp"
 #include <type_traits>
 
 
@@ -32,6 +35,9 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * The tree can be trained on sparse data (arma::sp_mat), through a view that
+ * reorders column indices instead of moving nonzeros.
  */
 template<typename FitnessFunction = MSEGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -467,6 +473,35 @@ class DecisionTreeRegressor :
   typedef typename CategoricalSplit::AuxiliarySplitInfo
       CategoricalAuxiliarySplitInfo;
 
+  //! Serialize the given auxiliary split information base class, if it holds
+  //! anything.
+  template<typename AuxType, typename Archive>
+  void SerializeAux(Archive& ar,
+                    const char* name,
+                    const std::enable_if_t<
+                        !std::is_empty<AuxType>::value>* = 0)
+  {
+    ar(cereal::make_nvp(name, static_cast<AuxType&>(*this)));
+  }
+
+  //! Nothing has to be serialized for an empty auxiliary split information
+  //! class.
+  template<typename AuxType, typename Archive>
+  void SerializeAux(Archive& /* ar */,
+                    const char* /* name */,
+                    const std::enable_if_t<
+                        std::is_empty<AuxType>::value>* = 0) { }
+
+  //! Reset the auxiliary split information of the split type that was not
+  //! chosen, so that it doesn't hold on to anything.
+  void ClearUnusedAux(const bool categorical)
+  {
+    if (categorical)
+      NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    else
+      CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+  }
+
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
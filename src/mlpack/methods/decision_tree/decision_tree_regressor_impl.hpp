@@ -66,9 +66,13 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  Train<false>(trainingData, 0, trainingData.n_cols, datasetInfo, tmpResponses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -102,9 +106,13 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpResponses, weights,
+  Train<false>(trainingData, 0, trainingData.n_cols, tmpResponses, weights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -142,8 +150,12 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  Train<true>(trainingData, 0, trainingData.n_cols, datasetInfo, tmpResponses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -184,8 +196,12 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses, tmpWeights,
+  Train<true>(trainingData, 0, trainingData.n_cols, tmpResponses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -222,9 +238,13 @@ DecisionTreeRegressor<FitnessFunction,
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
-              tmpWeights, minimumLeafSize, minimumGainSplit);
+  Train<true>(trainingData, 0, trainingData.n_cols, datasetInfo, tmpResponses,
+      tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Take ownership of another tree and train with weights.
@@ -265,8 +285,12 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses, tmpWeights,
+  Train<true>(trainingData, 0, trainingData.n_cols, tmpResponses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -448,10 +472,14 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<false>(trainingData, 0, trainingData.n_cols, datasetInfo,
+      tmpResponses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
 
@@ -488,9 +516,13 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpResponses,
+  return Train<false>(trainingData, 0, trainingData.n_cols, tmpResponses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
@@ -536,9 +568,13 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<true>(trainingData, 0, trainingData.n_cols, datasetInfo,
+      tmpResponses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
 
@@ -582,8 +618,12 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Sparse data is partitioned through a view (see TrainingView).
+  typename TrainingView<TrueMatType>::type trainingData =
+      TrainingView<TrueMatType>::Create(tmpData);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses,
+  return Train<true>(trainingData, 0, trainingData.n_cols, tmpResponses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
@@ -680,6 +720,7 @@ double DecisionTreeRegressor<FitnessFunction,
   {
     dimensionType = (size_t) datasetInfo.Type(bestDim);
     splitDimension = bestDim;
+    ClearUnusedAux(datasetInfo.Type(bestDim) == data::Datatype::categorical);
 
     // Get the number of children we will have.
     size_t numChildren = 0;
@@ -1025,6 +1066,10 @@ void DecisionTreeRegressor<FitnessFunction,
   ar(CEREAL_NVP(splitDimension));
   ar(CEREAL_NVP(dimensionType));
   ar(CEREAL_NVP(splitPointOrPrediction));
+
+  // Empty auxiliary split information classes add nothing to the archive.
+  SerializeAux<NumericAuxiliarySplitInfo>(ar, "numericAux");
+  SerializeAux<CategoricalAuxiliarySplitInfo>(ar, "categoricalAux");
 }
 
 //! Return the number of leaves.
@@ -0,0 +1,146 @@
+/**
+ * @file methods/decision_tree/flat_forest.hpp
+ *
+ * Definition of the FlatForest class, which holds trained decision trees in
+ * flat arrays for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The FlatForest class is a compiled form of one or more trained decision trees
+ * (e.g. a DecisionTree or the trees of a RandomForest), for classification
+ * only.  The nodes of all of the trees are stored in a struct-of-arrays layout
+ * (split dimension, threshold, first child and number of children of each
+ * node), in breadth-first order, so that the children of a node are
+ * contiguous and no pointer is followed during a traversal.
+ *
+ * Points are classified in blocks: each tree is traversed by all of the points
+ * of a block at once, one level at a time, so that the independent traversals
+ * overlap their memory accesses, and the nodes near the root stay in cache.
+ * The blocks are classified in parallel with OpenMP.  The predictions and
+ * probabilities are the same as those of the trees: the probabilities are
+ * the average of the class probabilities of the leaves that each tree sends
+ * the point to.
+ *
+ * Numeric splits must send points with a value at most the split information
+ * of the node to the first child and all others to the second one (as
+ * BestBinaryNumericSplit, RandomBinaryNumericSplit and
+ * BinnedBinaryNumericSplit do), and categorical splits must send each category
+ * to the child of the same index (as AllCategoricalSplit does, but not
+ * BinaryCategoricalSplit); AddTree() throws an exception otherwise.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 100);
+ * FlatForest flat = rf.Compile();
+ * arma::Row<size_t> predictions;
+ * flat.Classify(testData, predictions);
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  //! Create an empty forest.
+  FlatForest() : numClasses(0) { }
+
+  /**
+   * Compile the given trained decision tree and add it to the forest.  All of
+   * the trees of the forest must have the same number of classes.
+   *
+   * @param tree Tree to add.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  /**
+   * Classify the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, and also return estimates of the probabilities
+   * of each class.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the total number of nodes of the trees.
+  size_t NumNodes() const { return numChildren.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Return the child of internal node n that a point with the given value in
+   * the split dimension goes to.  Categories past the last child go to the
+   * last child.
+   */
+  size_t Next(const size_t n, const double value) const
+  {
+    if (categorical[n])
+      return children[n] + std::min((size_t) value, numChildren[n] - 1);
+    else
+      return children[n] + (value <= thresholds[n] ? 0 : 1);
+  }
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The index of the root of each tree.
+  std::vector<size_t> roots;
+  //! The dimension each node splits on (internal nodes only).
+  std::vector<size_t> dimensions;
+  //! The threshold of each numeric split (internal nodes only).
+  std::vector<double> thresholds;
+  //! Whether each split is categorical (internal nodes only).
+  std::vector<unsigned char> categorical;
+  //! The index of the first child of each internal node, or the index of the
+  //! column of leafProbabilities of each leaf.
+  std::vector<size_t> children;
+  //! The number of children of each node (0 for a leaf).
+  std::vector<size_t> numChildren;
+  //! The class probabilities of each leaf.
+  arma::mat leafProbabilities;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
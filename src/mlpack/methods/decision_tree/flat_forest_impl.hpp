@@ -0,0 +1,244 @@
+/**
+ * @file methods/decision_tree/flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+void FlatForest::AddTree(const TreeType& tree)
+{
+  if (!roots.empty() && tree.NumClasses() != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::AddTree(): tree has " << tree.NumClasses()
+        << " classes, but the forest has " << numClasses;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The nodes are numbered in breadth-first order, so that the children of
+  // each node are contiguous.  They are compiled into local arrays first, so
+  // that the forest is unchanged if the tree can't be compiled.
+  const size_t root = numChildren.size();
+  std::vector<size_t> newDimensions, newChildren, newNumChildren;
+  std::vector<double> newThresholds;
+  std::vector<unsigned char> newCategorical;
+  std::vector<const arma::vec*> leaves;
+
+  std::queue<const TreeType*> queue;
+  queue.push(&tree);
+  while (!queue.empty())
+  {
+    const TreeType& node = *queue.front();
+    queue.pop();
+
+    const size_t k = node.NumChildren();
+    newNumChildren.push_back(k);
+    if (k == 0)
+    {
+      newDimensions.push_back(0);
+      newThresholds.push_back(0.0);
+      newCategorical.push_back(0);
+      newChildren.push_back(leafProbabilities.n_cols + leaves.size());
+      leaves.push_back(&node.ClassProbabilities());
+      continue;
+    }
+
+    // The first child is numbered after all of the nodes already queued.
+    const size_t d = node.SplitDimension();
+    newDimensions.push_back(d);
+    newChildren.push_back(root + newNumChildren.size() + queue.size());
+
+    // Check that the split sends points where Next() will.
+    arma::vec probe(d + 1, arma::fill::zeros);
+    bool valid = true;
+    if (node.SplitDimensionType() == data::Datatype::categorical)
+    {
+      // Splits that keep a child for each category don't need auxiliary
+      // information; those that do (like BinaryCategoricalSplit) map
+      // categories to children in a way the arrays can't hold.
+      valid = std::is_empty<typename TreeType::CategoricalSplit::
+          AuxiliarySplitInfo>::value;
+      newThresholds.push_back(0.0);
+      newCategorical.push_back(1);
+      for (size_t c = 0; c < k && valid; ++c)
+      {
+        probe[d] = (double) c;
+        valid = (node.CalculateDirection(probe) == c);
+      }
+    }
+    else
+    {
+      const double threshold = node.SplitInfo();
+      newThresholds.push_back(threshold);
+      newCategorical.push_back(0);
+      probe[d] = threshold;
+      valid = (k == 2 && node.CalculateDirection(probe) == 0);
+      probe[d] = std::nextafter(threshold,
+          std::numeric_limits<double>::infinity());
+      valid = valid && (node.CalculateDirection(probe) == 1);
+    }
+
+    if (!valid)
+    {
+      throw std::invalid_argument("FlatForest::AddTree(): the tree has a "
+          "split that can't be compiled");
+    }
+
+    for (size_t c = 0; c < k; ++c)
+      queue.push(&node.Child(c));
+  }
+
+  const size_t treeClasses = leaves[0]->n_elem;
+  for (size_t i = 1; i < leaves.size(); ++i)
+  {
+    if (leaves[i]->n_elem != treeClasses)
+    {
+      throw std::invalid_argument("FlatForest::AddTree(): the leaves of the "
+          "tree have different numbers of classes");
+    }
+  }
+
+  // Now that the tree is compiled, add it to the forest.
+  numClasses = treeClasses;
+  roots.push_back(root);
+  dimensions.insert(dimensions.end(), newDimensions.begin(),
+      newDimensions.end());
+  thresholds.insert(thresholds.end(), newThresholds.begin(),
+      newThresholds.end());
+  categorical.insert(categorical.end(), newCategorical.begin(),
+      newCategorical.end());
+  children.insert(children.end(), newChildren.begin(), newChildren.end());
+  numChildren.insert(numChildren.end(), newNumChildren.begin(),
+      newNumChildren.end());
+
+  const size_t firstLeaf = leafProbabilities.n_cols;
+  leafProbabilities.resize(numClasses, firstLeaf + leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+    leafProbabilities.col(firstLeaf + i) = *leaves[i];
+}
+
+template<typename VecType>
+size_t FlatForest::Classify(const VecType& point) const
+{
+  if (roots.empty())
+  {
+    throw std::invalid_argument("FlatForest::Classify(): the forest has no "
+        "trees");
+  }
+
+  arma::vec probabilities(numClasses, arma::fill::zeros);
+  for (size_t t = 0; t < roots.size(); ++t)
+  {
+    size_t n = roots[t];
+    while (numChildren[n] != 0)
+      n = Next(n, (double) point[dimensions[n]]);
+
+    probabilities += leafProbabilities.col(children[n]);
+  }
+
+  return probabilities.index_max();
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.empty())
+  {
+    throw std::invalid_argument("FlatForest::Classify(): the forest has no "
+        "trees");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  // Each tree is traversed by the points of a block together, one level at a
+  // time, until all of them have reached a leaf.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    size_t nodes[blockSize];
+
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+        nodes[i - begin] = roots[t];
+
+      bool active = true;
+      while (active)
+      {
+        active = false;
+        for (size_t i = begin; i < end; ++i)
+        {
+          size_t& n = nodes[i - begin];
+          if (numChildren[n] != 0)
+          {
+            n = Next(n, (double) data(dimensions[n], i));
+            active = true;
+          }
+        }
+      }
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        const size_t leaf = children[nodes[i - begin]];
+        const double* leafProbs = leafProbabilities.colptr(leaf);
+        double* p = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          p[c] += leafProbs[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= (double) roots.size();
+      predictions[i] = probabilities.col(i).index_max();
+    }
+  }
+}
+
+template<typename Archive>
+void FlatForest::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(roots));
+  ar(CEREAL_NVP(dimensions));
+  ar(CEREAL_NVP(thresholds));
+  ar(CEREAL_NVP(categorical));
+  ar(CEREAL_NVP(children));
+  ar(CEREAL_NVP(numChildren));
+  ar(CEREAL_NVP(leafProbabilities));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
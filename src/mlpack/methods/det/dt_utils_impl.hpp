@@ -177,15 +177,18 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   const MatType cvData(dataset);
   const size_t testSize = dataset.n_cols / folds;
 
-  arma::vec regularizationConstants(prunedSequence.size());
-  regularizationConstants.fill(0.0);
+  // Each fold stores its regularization constants in its own column, and they
+  // are summed once all of the folds are done.
+  arma::mat foldRegularizationConstants(prunedSequence.size(), folds,
+      arma::fill::zeros);
 
   timers.Start("cross_validation");
   // Go through each fold.  On the Visual Studio compiler, we have to use
   // intmax_t because size_t is not yet supported by their OpenMP
   // implementation. omp_size_t is the appropriate type according to the
   // platform.
-  #pragma omp parallel for shared(prunedSequence, regularizationConstants)
+  #pragma omp parallel for schedule(dynamic) \
+      shared(prunedSequence, foldRegularizationConstants)
   for (omp_size_t fold = 0; fold < (omp_size_t) folds; fold++)
   {
     // Break up data into train and test sets.
@@ -225,8 +228,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     // Sequentially prune with all the values of available alphas and adding
     // values for test values.  Don't enter this loop if there are less than two
     // trees in the pruned sequence.
-    arma::vec cvRegularizationConstants(prunedSequence.size());
-    cvRegularizationConstants.fill(0.0);
+    arma::subview_col<double> cvRegularizationConstants =
+        foldRegularizationConstants.col(fold);
     for (size_t i = 0;
          i < ((prunedSequence.size() < 2) ? 0 : prunedSequence.size() - 2); ++i)
     {
@@ -258,12 +261,12 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     if (prunedSequence.size() > 2)
       cvRegularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal
         / (double) cvData.n_cols;
-
-    #pragma omp critical(DTreeCVUpdate)
-    regularizationConstants += cvRegularizationConstants;
   }
   timers.Stop("cross_validation");
 
+  const arma::vec regularizationConstants =
+      arma::sum(foldRegularizationConstants, 1);
+
   double optimalAlpha = -1.0;
   long double cvBestError = -std::numeric_limits<long double>::max();
 
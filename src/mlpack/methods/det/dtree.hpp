@@ -149,7 +149,9 @@ class DTree
 
   /**
    * Greedily expand the tree.  The points in the dataset will be reordered
-   * during tree growth.
+   * during tree growth.  For dense data, the values of each dimension are
+   * sorted once before growing the tree, which takes memory for a copy of the
+   * data and its indices.
    *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
@@ -336,15 +338,42 @@ class DTree
   // Utility methods.
 
   /**
-   * Find the dimension to split on.
+   * Greedily expand the tree, given the presorted values of each dimension (see
+   * FindSplit()).
+   */
+  double Grow(MatType& data,
+              arma::Col<size_t>& oldFromNew,
+              const bool useVolReg,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              arma::Mat<ElemType>& sortedValues,
+              arma::Mat<size_t>& sortedPoints);
+
+  /**
+   * Find the dimension to split on.  The dimensions are searched in parallel.
+   * If sortedValues is not empty, the rows [start, end) of its column d are the
+   * sorted values of dimension d of the points of the node; otherwise the
+   * values are sorted here.
    */
   bool FindSplit(const MatType& data,
+                 const arma::Mat<ElemType>& sortedValues,
                  size_t& splitDim,
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
                  const size_t minLeafSize = 5) const;
 
+  /**
+   * Reorder the presorted values of the points of the node (and their indices
+   * in sortedPoints) so that those of the left child come first, after the
+   * node has been split at splitIndex.
+   */
+  void SplitSorted(const size_t splitDim,
+                   const ElemType splitValue,
+                   const size_t splitIndex,
+                   arma::Mat<ElemType>& sortedValues,
+                   arma::Mat<size_t>& sortedPoints) const;
+
   /**
    * Split the data, returning the number of points left of the split.
    */
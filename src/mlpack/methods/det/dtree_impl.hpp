@@ -57,22 +57,19 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
-// Now the custom arma::Mat implementation.
+/**
+ * Scan the given values of a dimension, which must already be sorted, and put
+ * all splits in a vector.  This is used for the presorted values of dense
+ * datasets.
+ */
 template<typename ElemType>
-void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
-                   const arma::Mat<ElemType>& data,
-                   size_t dim,
-                   const size_t start,
-                   const size_t end,
-                   const size_t minLeafSize)
+void ExtractSortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                         const ElemType* dimVec,
+                         const size_t n_elem,
+                         const size_t minLeafSize)
 {
   typedef std::pair<ElemType, size_t> SplitItem;
-  arma::rowvec dimVec = data(dim, arma::span(start, end - 1));
-
-  // We sort these, in-place (it's a copy of the data, anyways).
-  std::sort(dimVec.begin(), dimVec.end());
-
-  for (size_t i = minLeafSize - 1; i < dimVec.n_elem - minLeafSize; ++i)
+  for (size_t i = minLeafSize - 1; i < n_elem - minLeafSize; ++i)
   {
     // This makes sense for real continuous data. This kinda corrupts the data
     // and estimation if the data is ordinal. Potentially we can fix that by
@@ -85,6 +82,23 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+// Now the custom arma::Mat implementation.
+template<typename ElemType>
+void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                   const arma::Mat<ElemType>& data,
+                   size_t dim,
+                   const size_t start,
+                   const size_t end,
+                   const size_t minLeafSize)
+{
+  arma::Row<ElemType> dimVec = data(dim, arma::span(start, end - 1));
+
+  // We sort these, in-place (it's a copy of the data, anyways).
+  std::sort(dimVec.begin(), dimVec.end());
+
+  ExtractSortedSplits(splitVec, dimVec.memptr(), dimVec.n_elem, minLeafSize);
+}
+
 // This the custom, sparse optimized implementation of the same routine.
 template<typename ElemType>
 void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
@@ -434,12 +448,14 @@ double DTree<MatType, TagType>::LogNegativeError(const size_t totalPoints) const
 // all possible splits.  The dataset is the full data set but the start and
 // end are used to obtain the point in this node.
 template<typename MatType, typename TagType>
-bool DTree<MatType, TagType>::FindSplit(const MatType& data,
-                                        size_t& splitDim,
-                                        ElemType& splitValue,
-                                        double& leftError,
-                                        double& rightError,
-                                        const size_t minLeafSize) const
+bool DTree<MatType, TagType>::FindSplit(
+    const MatType& data,
+    const arma::Mat<ElemType>& sortedValues,
+    size_t& splitDim,
+    ElemType& splitValue,
+    double& leftError,
+    double& rightError,
+    const size_t minLeafSize) const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -450,17 +466,17 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
 
   const size_t points = end - start;
 
-  double minError = logNegError;
-  bool splitFound = false;
+  // The best split of each dimension is found in parallel, and the best of
+  // them is chosen afterwards, in the order of the dimensions.
+  std::vector<char> dimSplitFounds(maxVals.n_elem, 0);
+  std::vector<double> dimErrors(maxVals.n_elem);
+  std::vector<double> dimLeftErrors(maxVals.n_elem);
+  std::vector<double> dimRightErrors(maxVals.n_elem);
+  std::vector<ElemType> dimSplitValues(maxVals.n_elem);
 
   // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
-  #pragma omp parallel for default(shared)
-  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t dim = 0; dim < (omp_size_t) maxVals.n_elem; ++dim)
   {
     const ElemType min = minVals[dim];
     const ElemType max = maxVals[dim];
@@ -480,7 +496,10 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     double dimRightError = 0.0; // always be set to something else before use.
     ElemType dimSplitValue = 0.0;
 
-    // Get the values for splitting. The old implementation:
+    // Get the values for splitting.  If the values of each dimension were
+    // sorted before growing the tree, the values of this node are already
+    // sorted.  Otherwise, they are extracted and sorted; the old
+    // implementation:
     //   dimVec = data.row(dim).subvec(start, end - 1);
     //   dimVec = arma::sort(dimVec);
     // could be quite inefficient for sparse matrices, due to
@@ -488,8 +507,16 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     // sparse matrices.
 
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (sortedValues.n_elem > 0)
+    {
+      details::ExtractSortedSplits(splitVec,
+          sortedValues.colptr(dim) + start, points, minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -528,22 +555,35 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       }
     }
 
-    const double actualMinDimError = std::log(minDimError)
-      - 2 * std::log((double) data.n_cols)
-      - volumeWithoutDim;
-
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+    if (dimSplitFound)
     {
       // Calculate actual error (in logspace) by adding terms back to our
       // estimate.
-      minError = actualMinDimError;
-      splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
+      dimSplitFounds[dim] = 1;
+      dimErrors[dim] = std::log(minDimError)
+        - 2 * std::log((double) data.n_cols)
         - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
+      dimSplitValues[dim] = dimSplitValue;
+      dimLeftErrors[dim] = std::log(dimLeftError)
+        - 2 * std::log((double) data.n_cols)
         - volumeWithoutDim;
+      dimRightErrors[dim] = std::log(dimRightError)
+        - 2 * std::log((double) data.n_cols)
+        - volumeWithoutDim;
+    }
+  }
+
+  double minError = logNegError;
+  bool splitFound = false;
+  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+  {
+    if (dimSplitFounds[dim] && (dimErrors[dim] > minError))
+    {
+      minError = dimErrors[dim];
+      splitDim = dim;
+      splitValue = dimSplitValues[dim];
+      leftError = dimLeftErrors[dim];
+      rightError = dimRightErrors[dim];
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -585,6 +625,55 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
   return left;
 }
 
+// Split the presorted values of the node so that those of the points of the
+// left child come first, keeping both parts sorted.
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::SplitSorted(const size_t splitDim,
+                                          const ElemType splitValue,
+                                          const size_t splitIndex,
+                                          arma::Mat<ElemType>& sortedValues,
+                                          arma::Mat<size_t>& sortedPoints) const
+{
+  // The values of the split dimension are sorted, so the points of the left
+  // child are the first ones.
+  std::vector<char> goesLeft(sortedPoints.n_rows, 0);
+  for (size_t i = start; i < end &&
+       sortedValues(i, splitDim) <= splitValue; ++i)
+    goesLeft[sortedPoints(i, splitDim)] = 1;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t dim = 0; dim < (omp_size_t) sortedValues.n_cols; ++dim)
+  {
+    if ((size_t) dim == splitDim)
+      continue;
+
+    ElemType* values = sortedValues.colptr(dim);
+    size_t* points = sortedPoints.colptr(dim);
+    std::vector<ElemType> rightValues;
+    std::vector<size_t> rightPoints;
+    rightValues.reserve(end - splitIndex);
+    rightPoints.reserve(end - splitIndex);
+
+    size_t l = start;
+    for (size_t i = start; i < end; ++i)
+    {
+      if (goesLeft[points[i]])
+      {
+        values[l] = values[i];
+        points[l++] = points[i];
+      }
+      else
+      {
+        rightValues.push_back(values[i]);
+        rightPoints.push_back(points[i]);
+      }
+    }
+
+    std::copy(rightValues.begin(), rightValues.end(), values + l);
+    std::copy(rightPoints.begin(), rightPoints.end(), points + l);
+  }
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -596,6 +685,46 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
+  // For dense data, sort the values of each dimension once, so that no node
+  // has to sort them again.  Sparse data is sorted at each node, since only
+  // its nonzero values have to be sorted.
+  arma::Mat<ElemType> sortedValues;
+  arma::Mat<size_t> sortedPoints;
+  if (!arma::is_SpMat<MatType>::value)
+  {
+    sortedValues.set_size(data.n_cols, data.n_rows);
+    sortedPoints.set_size(data.n_cols, data.n_rows);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t dim = 0; dim < (omp_size_t) data.n_rows; ++dim)
+    {
+      arma::Col<ElemType> values(end - start);
+      for (size_t i = start; i < end; ++i)
+        values[i - start] = data(dim, i);
+
+      const arma::uvec order = arma::stable_sort_index(values);
+      for (size_t i = 0; i < order.n_elem; ++i)
+      {
+        sortedValues(start + i, dim) = values[order[i]];
+        sortedPoints(start + i, dim) = start + order[i];
+      }
+    }
+  }
+
+  return Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+      sortedValues, sortedPoints);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::Grow(MatType& data,
+                                     arma::Col<size_t>& oldFromNew,
+                                     const bool useVolReg,
+                                     const size_t maxLeafSize,
+                                     const size_t minLeafSize,
+                                     arma::Mat<ElemType>& sortedValues,
+                                     arma::Mat<size_t>& sortedPoints)
+{
+
   double leftG, rightG;
 
   // Compute points ratio.
@@ -614,11 +743,14 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, sortedValues, dim, splitValueTmp, leftError,
+        rightError, minLeafSize))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
       const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      if (sortedValues.n_elem > 0)
+        SplitSorted(dim, splitValueTmp, splitIndex, sortedValues, sortedPoints);
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -638,9 +770,9 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
       leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
+                         minLeafSize, sortedValues, sortedPoints);
       rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+                           minLeafSize, sortedValues, sortedPoints);
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
@@ -0,0 +1,108 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * Implements a union-find data structure that can be used by several threads
+ * at once.  Components are linked with atomic compare-and-swap operations, so
+ * no locks are needed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure, in the style of Anderson and Woll's
+ * wait-free union-find.  As with UnionFind, each point is initially in its own
+ * component, Union(x, y) unites the components containing x and y, and Find(x)
+ * returns the index of the component containing x; but Union() and Find() can
+ * be called by several threads at the same time.
+ *
+ * A root is always linked below the root with the smaller index, with a single
+ * compare-and-swap that fails if another thread has linked it first, and Find()
+ * halves the paths it follows.  Since the parent of each point only ever
+ * decreases, the index of each component is the smallest index of its points,
+ * so the result doesn't depend on the order the unions were done in.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.  This is safe to call while
+   * other threads call Union().
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    size_t p = parent[x].load(std::memory_order_acquire);
+    while (p != x)
+    {
+      // Point x to its grandparent, unless another thread already moved it.
+      const size_t grandparent = parent[p].load(std::memory_order_acquire);
+      if (grandparent != p)
+      {
+        parent[x].compare_exchange_weak(p, grandparent,
+            std::memory_order_acq_rel);
+      }
+
+      x = grandparent;
+      p = parent[x].load(std::memory_order_acquire);
+    }
+
+    return x;
+  }
+
+  /**
+   * Union the components containing x and y.  This is safe to call from
+   * several threads at once.
+   *
+   * @param x one component
+   * @param y the other component
+   * @return true if this call merged the components, or false if they were
+   *     already the same component
+   */
+  bool Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return false;
+
+      // Link the root with the larger index; this fails if it is not a root
+      // anymore, in which case we try again from the new roots.
+      if (x < y)
+        std::swap(x, y);
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y,
+          std::memory_order_acq_rel))
+        return true;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
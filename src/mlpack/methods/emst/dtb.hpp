@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -68,6 +69,16 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * With OpenMP, the nearest neighbors of the components are found in parallel
+ * at each Borůvka round, by splitting the tree into disjoint query subtrees
+ * that are each traversed against the whole tree, and the new edges are added
+ * in parallel with a lock-free ConcurrentUnionFind.  The nearest point outside
+ * of its component is found for each point, so that each point is only
+ * written by one thread; the candidate of each component, which is only used
+ * for pruning, is lowered atomically.  The edge of each component is then the
+ * nearest neighbor of its point with the smallest index among those at the
+ * candidate distance.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -103,14 +114,18 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
-
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsInComponent;
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsOutComponent;
-  //! List of edge distances.
-  arma::vec neighborsDistances;
+  ConcurrentUnionFind connections;
+
+  //! The point inside each component that is an endpoint of its candidate
+  //! edge.
+  std::vector<std::atomic<size_t>> neighborsInComponent;
+  //! The distance of the candidate edge of each component.
+  std::vector<std::atomic<double>> neighborsDistances;
+  //! The nearest point outside of its component found for each point.
+  arma::Col<size_t> pointNeighbors;
+  //! The distance to the nearest point outside of its component found for
+  //! each point.
+  arma::vec pointDistances;
 
   //! Total distance of the tree.
   double totalDist;
@@ -176,6 +191,19 @@ class DualTreeBoruvka
   void ComputeMST(arma::mat& results);
 
  private:
+  /**
+   * Find the nearest neighbor outside of its component of each point, with a
+   * dual-tree traversal of each of the given query subtrees (in parallel if
+   * there are several).
+   *
+   * @param frontier Disjoint query subtrees that cover the tree.
+   * @param baseCases Incremented with the number of base cases.
+   * @param scores Incremented with the number of node combinations scored.
+   */
+  void DualTreeTraversal(const std::vector<Tree*>& frontier,
+                         size_t& baseCases,
+                         size_t& scores);
+
   /**
    * Adds a single edge to the edge list
    */
@@ -201,6 +229,11 @@ class DualTreeBoruvka
    * The values stored in the tree must be reset on each iteration.
    */
   void Cleanup();
+
+  /**
+   * Reset the candidate edges of all components and points.
+   */
+  void ResetCandidates();
 }; // class DualTreeBoruvka
 
 } // namespace emst
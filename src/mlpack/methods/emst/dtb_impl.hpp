@@ -14,6 +14,8 @@
 
 #include "dtb_rules.hpp"
 
+#include <mlpack/core/tree/subtree_frontier.hpp>
+
 namespace mlpack {
 namespace emst {
 
@@ -58,15 +60,16 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(!naive),
     naive(naive),
     connections(dataset.n_cols),
+    neighborsInComponent(dataset.n_cols),
+    neighborsDistances(dataset.n_cols),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Set size.
 
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  pointNeighbors.set_size(data.n_cols);
+  pointDistances.set_size(data.n_cols);
+  ResetCandidates();
 }
 
 template<
@@ -83,15 +86,16 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(false),
     naive(false),
     connections(data.n_cols),
+    neighborsInComponent(data.n_cols),
+    neighborsDistances(data.n_cols),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Fill with EdgePairs.
 
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  pointNeighbors.set_size(data.n_cols);
+  pointDistances.set_size(data.n_cols);
+  ResetCandidates();
 }
 
 template<
@@ -121,22 +125,44 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 {
   totalDist = 0; // Reset distance.
 
+  // Split the tree into several query subtrees per thread, so that the dynamic
+  // schedule can balance the load when some subtrees are pruned much earlier
+  // than others.
+  std::vector<Tree*> frontier;
+  if (!naive)
+  {
+    #ifdef HAS_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+    if (numThreads > 1)
+      tree::SubtreeFrontier(*tree, 8 * numThreads, frontier);
+    #endif
+    if (frontier.empty())
+      frontier.push_back(tree);
+  }
+
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  size_t baseCases = 0;
+  size_t scores = 0;
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
     {
       // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      #pragma omp parallel
+      {
+        MetricType threadMetric(metric);
+        RuleType rules(data, connections, neighborsDistances, pointDistances,
+            pointNeighbors, threadMetric);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            rules.BaseCase(i, j);
+      }
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      DualTreeTraversal(frontier, baseCases, scores);
     }
 
     AddAllEdges();
@@ -146,8 +172,8 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -157,6 +183,60 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   Log::Info << "Total spanning tree length: " << totalDist << std::endl;
 }
 
+/**
+ * Find the nearest neighbor outside of its component of each point.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeTraversal(
+    const std::vector<Tree*>& frontier,
+    size_t& baseCases,
+    size_t& scores)
+{
+  typedef DTBRules<MetricType, Tree> RuleType;
+
+  if (frontier.size() == 1)
+  {
+    RuleType rules(data, connections, neighborsDistances, pointDistances,
+        pointNeighbors, metric);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*frontier[0], *tree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    return;
+  }
+
+  size_t threadBaseCases = 0;
+  size_t threadScores = 0;
+
+  #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+  {
+    MetricType threadMetric(metric);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The subtrees are disjoint, so the results of each point are only
+      // written by one thread.
+      RuleType rules(data, connections, neighborsDistances, pointDistances,
+          pointNeighbors, threadMetric);
+      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+      traverser.Traverse(*frontier[i], *tree);
+
+      threadBaseCases += rules.BaseCases();
+      threadScores += rules.Scores();
+    }
+  }
+
+  baseCases += threadBaseCases;
+  scores += threadScores;
+}
+
 /**
  * Adds a single edge to the edge list
  */
@@ -191,19 +271,52 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
-  for (size_t i = 0; i < data.n_cols; ++i)
+  const size_t n = data.n_cols;
+
+  // The candidate edge of each component starts at its point with the smallest
+  // index among those whose nearest neighbor is at the candidate distance, so
+  // that the edge doesn't depend on the order the points were searched in.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
-    {
-      // totalDist = totalDist + dist;
-      // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
-    }
+    const size_t component = connections.Find(i);
+    if (pointDistances[i] == DBL_MAX || pointDistances[i] !=
+        neighborsDistances[component].load(std::memory_order_relaxed))
+      continue;
+
+    std::atomic<size_t>& inEdge = neighborsInComponent[component];
+    size_t current = inEdge.load(std::memory_order_relaxed);
+    while ((size_t) i < current && !inEdge.compare_exchange_weak(current, i,
+        std::memory_order_relaxed)) { }
+  }
+
+  // Now merge the components along their candidate edges.  When several
+  // components pick edges that would close a cycle (this can only happen with
+  // edges of equal length), the union-find structure only keeps the edges that
+  // actually merge two components.
+  std::vector<char> added(n, 0);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) n; ++c)
+  {
+    const size_t inEdge = neighborsInComponent[c].load(
+        std::memory_order_relaxed);
+    if (inEdge != n && connections.Union(inEdge, pointNeighbors[inEdge]))
+      added[c] = 1;
+  }
+
+  for (size_t c = 0; c < n; ++c)
+  {
+    if (!added[c])
+      continue;
+
+    // totalDist = totalDist + dist;
+    // changed to make this agree with the cover tree code
+    const size_t inEdge = neighborsInComponent[c].load(
+        std::memory_order_relaxed);
+    const double distance = neighborsDistances[c].load(
+        std::memory_order_relaxed);
+    totalDist += distance;
+    AddEdge(inEdge, pointNeighbors[inEdge], distance);
   }
 }
 
@@ -314,13 +427,32 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; ++i)
-    neighborsDistances[i] = DBL_MAX;
+  ResetCandidates();
 
   if (!naive)
     CleanupHelper(tree);
 }
 
+/**
+ * Reset the candidate edges of all components and points.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ResetCandidates()
+{
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    pointDistances[i] = DBL_MAX;
+    neighborsDistances[i].store(DBL_MAX, std::memory_order_relaxed);
+    neighborsInComponent[i].store(data.n_cols, std::memory_order_relaxed);
+  }
+}
+
 } // namespace emst
 } // namespace mlpack
 
@@ -16,18 +16,40 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include "concurrent_union_find.hpp"
+
 namespace mlpack {
 namespace emst {
 
+/**
+ * The rules for one Borůvka round of the DualTreeBoruvka algorithm, which find
+ * the nearest point outside of its component for each query point.  Several
+ * rules objects can traverse disjoint query subtrees at the same time: the
+ * results of each point are only written by the rules that own it, and the
+ * candidate distance of each component, which is only used for pruning, is
+ * lowered atomically.
+ */
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the rules.
+   *
+   * @param dataSet The data points.
+   * @param connections The components found so far.
+   * @param neighborsDistances The candidate distance of each component.
+   * @param pointDistances The distance to the nearest point found outside of
+   *     its component, for each point.
+   * @param pointNeighbors The nearest point found outside of its component,
+   *     for each point.
+   * @param metric The instantiated metric.
+   */
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
-           arma::vec& neighborsDistances,
-           arma::Col<size_t>& neighborsInComponent,
-           arma::Col<size_t>& neighborsOutComponent,
+           ConcurrentUnionFind& connections,
+           std::vector<std::atomic<double>>& neighborsDistances,
+           arma::vec& pointDistances,
+           arma::Col<size_t>& pointNeighbors,
            MetricType& metric);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -102,18 +124,17 @@ class DTBRules
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
   //! The distance to the candidate nearest neighbor for each component.
-  arma::vec& neighborsDistances;
+  std::vector<std::atomic<double>>& neighborsDistances;
 
-  //! The index of the point in the component that is an endpoint of the
-  //! candidate edge.
-  arma::Col<size_t>& neighborsInComponent;
+  //! The distance to the nearest point outside of its component found for
+  //! each point.
+  arma::vec& pointDistances;
 
-  //! The index of the point outside of the component that is an endpoint
-  //! of the candidate edge.
-  arma::Col<size_t>& neighborsOutComponent;
+  //! The nearest point outside of its component found for each point.
+  arma::Col<size_t>& pointNeighbors;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -18,17 +18,17 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
-         arma::vec& neighborsDistances,
-         arma::Col<size_t>& neighborsInComponent,
-         arma::Col<size_t>& neighborsOutComponent,
+         ConcurrentUnionFind& connections,
+         std::vector<std::atomic<double>>& neighborsDistances,
+         arma::vec& pointDistances,
+         arma::Col<size_t>& pointNeighbors,
          MetricType& metric)
 :
   dataSet(dataSet),
   connections(connections),
   neighborsDistances(neighborsDistances),
-  neighborsInComponent(neighborsInComponent),
-  neighborsOutComponent(neighborsOutComponent),
+  pointDistances(pointDistances),
+  pointNeighbors(pointNeighbors),
   metric(metric),
   baseCases(0),
   scores(0)
@@ -51,24 +51,33 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
 
   size_t referenceComponentIndex = connections.Find(referenceIndex);
 
+  std::atomic<double>& componentDistance =
+      neighborsDistances[queryComponentIndex];
   if (queryComponentIndex != referenceComponentIndex)
   {
     ++baseCases;
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
-    if (distance < neighborsDistances[queryComponentIndex])
+    if (distance < pointDistances[queryIndex])
     {
       Log::Assert(queryIndex != referenceIndex);
 
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      pointDistances[queryIndex] = distance;
+      pointNeighbors[queryIndex] = referenceIndex;
+
+      // Lower the candidate distance of the component, unless another point
+      // has already found a closer neighbor.
+      double current = componentDistance.load(std::memory_order_relaxed);
+      while (distance < current && !componentDistance.compare_exchange_weak(
+          current, distance, std::memory_order_relaxed)) { }
     }
   }
 
-  if (newUpperBound < neighborsDistances[queryComponentIndex])
-    newUpperBound = neighborsDistances[queryComponentIndex];
+  const double componentBound =
+      componentDistance.load(std::memory_order_relaxed);
+  if (newUpperBound < componentBound)
+    newUpperBound = componentBound;
 
   Log::Assert(newUpperBound >= 0.0);
 
@@ -93,8 +102,8 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
-      ? DBL_MAX : distance;
+  return neighborsDistances[queryComponentIndex].load(
+      std::memory_order_relaxed) < distance ? DBL_MAX : distance;
 }
 
 template<typename MetricType, typename TreeType>
@@ -104,8 +113,8 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
-      ? DBL_MAX : oldScore;
+  return (oldScore > neighborsDistances[connections.Find(queryIndex)].load(
+      std::memory_order_relaxed)) ? DBL_MAX : oldScore;
 }
 
 template<typename MetricType, typename TreeType>
@@ -153,7 +162,8 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t pointComponent = connections.Find(queryNode.Point(i));
-    const double bound = neighborsDistances[pointComponent];
+    const double bound =
+        neighborsDistances[pointComponent].load(std::memory_order_relaxed);
 
     if (bound > worstPointBound)
       worstPointBound = bound;
@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/ip_metric.hpp>
 #include "fastmks_stat.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
 #include <queue>
 
 namespace mlpack {
@@ -339,6 +340,52 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  //! Number of query points evaluated together in brute-force search.
+  static constexpr size_t QueryBlockSize = 256;
+  //! Number of reference points evaluated together in brute-force search.
+  static constexpr size_t ReferenceBlockSize = 1024;
+
+  /**
+   * Perform brute-force search, in parallel over the query points.  The kernel
+   * is evaluated between a block of query points and a block of reference
+   * points at a time; with kernels that have a batched Evaluate() (see
+   * KernelTraits::HasBatchEvaluation), this is one matrix product.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param sameSet If true, a point is not returned as its own result.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  /**
+   * Perform a single-tree traversal of the reference tree for every query
+   * point.  If OpenMP is available, the query points are split across threads.
+   * Since the rules cache kernel values in the statistics of the reference
+   * nodes, each thread traverses its own copy of the reference tree.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules object that receives the results of all threads.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
+  /**
+   * Perform a dual-tree traversal of the given query tree and the reference
+   * tree.  If OpenMP is available, the query tree is split into disjoint
+   * subtrees that are traversed in parallel, each with its own rules object.
+   *
+   * @param queryTree Tree built on query points.
+   * @param rules Rules object that receives the results of all threads.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
 };
 
 } // namespace fastmks
@@ -18,10 +18,38 @@
 #include "fastmks_rules.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 
 namespace mlpack {
 namespace fastmks {
 
+//! Evaluate the kernel between each point of a and each point of b, with the
+//! batched Evaluate() of the kernel.
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void BlockKernels(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& output,
+                  const std::true_type& /* hasBatchEvaluation */)
+{
+  kernel.Evaluate(a, b, output);
+}
+
+//! Evaluate the kernel between each point of a and each point of b, one pair
+//! at a time.
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void BlockKernels(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& output,
+                  const std::false_type& /* hasBatchEvaluation */)
+{
+  output.set_size(a.n_cols, b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      output(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+}
+
 // No data; create a model on an empty dataset.
 template<typename KernelType,
          typename MatType,
@@ -439,34 +467,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
-
+    NaiveSearch(querySet, k, indices, kernels, false);
     return;
   }
 
@@ -478,10 +479,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, querySet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(querySet.n_cols, rules);
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
@@ -539,9 +537,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, rules);
 
   Log::Info << rules.BaseCases() << " base cases." << std::endl;
   Log::Info << rules.Scores() << " scores." << std::endl;
@@ -566,37 +562,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
-
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
     return;
   }
 
@@ -608,15 +574,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
-
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+    SingleTreeTraversal(referenceSet->n_cols, rules);
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
@@ -630,6 +588,194 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  indices.set_size(k, querySet.n_cols);
+  kernels.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  // The kernel is evaluated between a block of query points and a block of
+  // reference points at a time.  Each thread keeps the k best candidates of
+  // each of its query points in a min-heap.
+  const size_t numBlocks = (querySet.n_cols + QueryBlockSize - 1) /
+      QueryBlockSize;
+
+  #pragma omp parallel
+  {
+    arma::mat products;
+    std::vector<std::vector<Candidate>> heaps(QueryBlockSize);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t queryBegin = b * QueryBlockSize;
+      const size_t queryEnd = std::min(queryBegin + QueryBlockSize,
+          (size_t) querySet.n_cols);
+      for (size_t j = 0; j < queryEnd - queryBegin; ++j)
+        heaps[j].assign(k, std::make_pair(-DBL_MAX, size_t() - 1));
+
+      for (size_t r = 0; r < referenceSet->n_cols; r += ReferenceBlockSize)
+      {
+        const size_t referenceEnd = std::min(r + ReferenceBlockSize,
+            (size_t) referenceSet->n_cols);
+        BlockKernels(metric.Kernel(), referenceSet->cols(r, referenceEnd - 1),
+            querySet.cols(queryBegin, queryEnd - 1), products,
+            std::integral_constant<bool,
+                kernel::KernelTraits<KernelType>::HasBatchEvaluation>());
+
+        for (size_t j = 0; j < queryEnd - queryBegin; ++j)
+        {
+          std::vector<Candidate>& heap = heaps[j];
+          const double* column = products.colptr(j);
+          for (size_t i = 0; i < referenceEnd - r; ++i)
+          {
+            // Don't return the point as its own candidate.
+            if (sameSet && (r + i == queryBegin + j))
+              continue;
+
+            if (column[i] > heap.front().first)
+            {
+              std::pop_heap(heap.begin(), heap.end(), CandidateCmp());
+              heap.back() = std::make_pair(column[i], r + i);
+              std::push_heap(heap.begin(), heap.end(), CandidateCmp());
+            }
+          }
+        }
+      }
+
+      for (size_t j = 0; j < queryEnd - queryBegin; ++j)
+      {
+        // Sorting a min-heap gives the candidates in descending order.
+        std::sort_heap(heaps[j].begin(), heaps[j].end(), CandidateCmp());
+        for (size_t i = 0; i < k; ++i)
+        {
+          indices(i, queryBegin + j) = heaps[j][i].second;
+          kernels(i, queryBegin + j) = heaps[j][i].first;
+        }
+      }
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void FastMKS<KernelType, MatType, TreeType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+  #ifdef HAS_OPENMP
+  if (omp_get_max_threads() > 1 && numQueries > 1)
+  {
+    size_t threadScores = 0;
+    size_t threadBaseCases = 0;
+
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      // The rules store the last kernel evaluation of each reference node in
+      // its statistic, so each thread needs its own copy of the tree.  The
+      // copy shares the dataset unless the tree owns it.
+      Tree threadTree(*referenceTree);
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        traverser.Traverse(i, threadTree);
+
+      threadScores += threadRules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+    return;
+  }
+  #endif
+
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+
+  Log::Info << "Pruned " << traverser.NumPrunes() << " nodes." << std::endl;
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void FastMKS<KernelType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+  // Split the query tree into several subtrees per thread, so that the dynamic
+  // schedule can balance the load when some subtrees are pruned much earlier
+  // than others.
+  std::vector<Tree*> frontier;
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+    tree::SubtreeFrontier(queryTree, 8 * numThreads, frontier);
+  #endif
+
+  if (frontier.size() <= 1)
+  {
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return;
+  }
+
+  // The bounds of the query nodes above the subtrees are not updated by the
+  // traversal, so they must not hold the bounds of an earlier search.
+  for (size_t i = 0; i < frontier.size(); ++i)
+  {
+    for (Tree* node = frontier[i]->Parent(); node != NULL;
+        node = node->Parent())
+      node->Stat().Bound() = -DBL_MAX;
+  }
+
+  size_t threadScores = 0;
+  size_t threadBaseCases = 0;
+
+  #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+  {
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The subtrees are disjoint, so each thread's rules can insert directly
+      // into the candidate lists of the main rules object.  Only the query
+      // statistics are modified, so the reference tree can be shared.
+      RuleType threadRules(rules);
+      typename Tree::template DualTreeTraverser<RuleType>
+          traverser(threadRules);
+      traverser.Traverse(*frontier[i], *referenceTree);
+
+      threadScores += threadRules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+    }
+  }
+
+  rules.Scores() += threadScores;
+  rules.BaseCases() += threadBaseCases;
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
@@ -48,6 +48,19 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct a FastMKSRules object for one thread of a parallel traversal.
+   * The new object has its own traversal information and statistics, but it
+   * inserts candidates directly into the candidate lists of the given rules
+   * object and shares its self-kernels, so the results of every thread are
+   * available through other.GetResults() once all threads are finished.  Each
+   * thread must visit a set of query points that is disjoint from the sets of
+   * query points visited by every other thread.
+   *
+   * @param other Rules object whose candidate lists will be used.
+   */
+  FastMKSRules(FastMKSRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -152,8 +165,12 @@ class FastMKSRules
   typedef boost::heap::priority_queue<Candidate,
       boost::heap::compare<CandidateCmp>> CandidateList;
 
+  //! Candidate lists owned by this object.  This is empty if the object was
+  //! constructed for a thread of a parallel traversal.
+  std::vector<CandidateList> candidateStorage;
+
   //! Set of candidates for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of points to search for.
   const size_t k;
@@ -26,6 +26,7 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     KernelType& kernel) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
     kernel(kernel),
     lastQueryIndex(-1),
@@ -64,6 +65,31 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   candidates.swap(tmp);
 }
 
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(FastMKSRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    kernel(other.kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    baseCases(0),
+    scores(0)
+{
+  // Use the self-kernels of the other object, without copying them.
+  queryKernels = arma::vec(other.queryKernels.memptr(),
+      other.queryKernels.n_elem, false, true);
+  referenceKernels = arma::vec(other.referenceKernels.memptr(),
+      other.referenceKernels.n_elem, false, true);
+
+  // As in the other constructor, the last query and reference node pointers
+  // must be invalid but not NULL.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename KernelType, typename TreeType>
 void FastMKSRules<KernelType, TreeType>::GetResults(
     arma::Mat<size_t>& indices,
@@ -189,6 +189,28 @@ double DiagonalGMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the DiagonalGMM with a chunk of new observations.
+ */
+template<typename FittingType>
+double DiagonalGMM::PartialFit(const arma::mat& observations,
+                               FittingType& fitter)
+{
+  return fitter.Step(observations, dists, weights);
+}
+
+/**
+ * Update the DiagonalGMM with a chunk of new observations, each of which has
+ * a certain probability of being from this distribution.
+ */
+template<typename FittingType>
+double DiagonalGMM::PartialFit(const arma::mat& observations,
+                               const arma::vec& probabilities,
+                               FittingType& fitter)
+{
+  return fitter.Step(observations, probabilities, dists, weights);
+}
+
 //! Serialize the object.
 template<typename Archive>
 void DiagonalGMM::serialize(Archive& ar, const uint32_t /* version */)
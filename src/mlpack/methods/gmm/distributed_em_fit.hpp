@@ -0,0 +1,193 @@
+/**
+ * @file methods/gmm/distributed_em_fit.hpp
+ *
+ * Definition of DistributedEMFit, which fits a GMM with the EM algorithm to a
+ * dataset that is split between several processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+// Initial clustering mechanism.
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM with the EM algorithm to a dataset that is split into
+ * shards, each held by one process (one rank of the communicator).  In each
+ * iteration, every rank computes the responsibilities of its observations and
+ * their sufficient statistics (the total responsibility of each component, and
+ * the weighted sums of the observations and of their centered outer
+ * products); the statistics are summed over all the ranks with the
+ * communicator, so every rank computes the same model.  The initial model is
+ * given by kmeans::DistributedKMeans with the same communicator.
+ *
+ * The same interface as EMFit is provided, so this can be used as the
+ * FittingType of GMM::Train() and DiagonalGMM::Train(), which must be called
+ * by all the ranks at the same time, with one trial (the best of several
+ * trials would be chosen from the log-likelihood of each shard, so the ranks
+ * could keep different models).  The log-likelihood returned by Train() is
+ * the one of the shard of the rank.
+ *
+ * @code
+ * extern arma::mat shard; // The part of the dataset held by this rank.
+ * GMM gmm(10, shard.n_rows);
+ * DistributedEMFit<kmeans::MPICommunicator> fitter(
+ *     kmeans::MPICommunicator(MPI_COMM_WORLD));
+ * gmm.Train(shard, 1, false, fitter);
+ * @endcode
+ *
+ * @tparam CommunicatorType Communicator of the ranks; see
+ *     kmeans::LocalCommunicator.
+ * @tparam CovarianceConstraintPolicy Constraint policy of the covariances.
+ * @tparam Distribution Type of the components (GaussianDistribution or
+ *     DiagonalGaussianDistribution).
+ */
+template<typename CommunicatorType = kmeans::LocalCommunicator,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class DistributedEMFit
+{
+ public:
+  /**
+   * Construct the DistributedEMFit object.
+   *
+   * @param communicator Communicator of the ranks that hold the data.
+   * @param maxIterations Maximum number of iterations for EM (0 means no
+   *     limit).
+   * @param tolerance Log-likelihood tolerance required for convergence (the
+   *     log-likelihood of the whole dataset).
+   * @param constraint Constraint policy of covariance.
+   */
+  DistributedEMFit(CommunicatorType communicator = CommunicatorType(),
+                   const size_t maxIterations = 300,
+                   const double tolerance = 1e-10,
+                   CovarianceConstraintPolicy constraint =
+                       CovarianceConstraintPolicy());
+
+  /**
+   * Fit the dataset whose shard is given to a Gaussian mixture model.  The
+   * size of the vectors (indicating the number of components) must already
+   * be set.  If useInitialModel is true, the given model (which must be the
+   * same on every rank) is used as the initial model, instead of the initial
+   * clustering.
+   *
+   * @param observations Shard of the observations held by this rank.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the dataset whose shard is given to a Gaussian mixture model, taking
+   * into account the probability of each observation being from this mixture.
+   * Otherwise, this is the same as the other overload of Estimate().
+   *
+   * @param observations Shard of the observations held by this rank.
+   * @param probabilities Probability of each observation of the shard being
+   *      from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the communicator.
+  const CommunicatorType& Communicator() const { return communicator; }
+  //! Modify the communicator.
+  CommunicatorType& Communicator() { return communicator; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+ private:
+  /**
+   * Run EM; probabilities holds the probability of each observation, or is
+   * empty if they are all 1.
+   */
+  void EM(const arma::mat& observations,
+          const arma::vec& probabilities,
+          std::vector<Distribution>& dists,
+          arma::vec& weights,
+          const bool useInitialModel);
+
+  /**
+   * Compute the initial model from the assignments given by
+   * kmeans::DistributedKMeans.
+   */
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<Distribution>& dists,
+                         arma::vec& weights);
+
+  /**
+   * Compute the responsibilities of the components for the observations
+   * (one column per component), and return the log-likelihood of the whole
+   * dataset.
+   */
+  double Responsibilities(const arma::mat& observations,
+                          const arma::vec& probabilities,
+                          const std::vector<Distribution>& dists,
+                          const arma::vec& weights,
+                          arma::mat& responsibilities) const;
+
+  /**
+   * Update the model from the given responsibilities of the observations of
+   * this rank, combining the statistics of all the ranks.  A component with no
+   * responsibility keeps its parameters.
+   */
+  void Update(const arma::mat& observations,
+              const arma::mat& responsibilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! The communicator of the ranks.
+  CommunicatorType communicator;
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_em_fit_impl.hpp"
+
+#endif
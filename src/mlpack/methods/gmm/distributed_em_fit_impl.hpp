@@ -0,0 +1,253 @@
+/**
+ * @file methods/gmm/distributed_em_fit_impl.hpp
+ *
+ * Implementation of DistributedEMFit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+template<typename CommunicatorType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+DistributedEMFit<CommunicatorType, CovarianceConstraintPolicy, Distribution>::
+DistributedEMFit(CommunicatorType communicator,
+                 const size_t maxIterations,
+                 const double tolerance,
+                 CovarianceConstraintPolicy constraint) :
+    communicator(std::move(communicator)),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    constraint(constraint)
+{ /* Nothing to do. */ }
+
+template<typename CommunicatorType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<CommunicatorType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  EM(observations, arma::vec(), dists, weights, useInitialModel);
+}
+
+template<typename CommunicatorType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<CommunicatorType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (probabilities.n_elem != observations.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DistributedEMFit::Estimate(): " << probabilities.n_elem
+        << " probabilities given for " << observations.n_cols
+        << " observations!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  EM(observations, probabilities, dists, weights, useInitialModel);
+}
+
+template<typename CommunicatorType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<CommunicatorType, CovarianceConstraintPolicy,
+    Distribution>::EM(const arma::mat& observations,
+                      const arma::vec& probabilities,
+                      std::vector<Distribution>& dists,
+                      arma::vec& weights,
+                      const bool useInitialModel)
+{
+  // Only perform initial clustering if the user wanted it.
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  arma::mat responsibilities;
+  double l = Responsibilities(observations, probabilities, dists, weights,
+      responsibilities);
+
+  Log::Debug << "DistributedEMFit::Estimate(): initial log-likelihood: " << l
+      << std::endl;
+
+  // Every rank computes the same log-likelihood, so they all stop after the
+  // same iteration.
+  double lOld = -DBL_MAX;
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  {
+    Log::Info << "DistributedEMFit::Estimate(): iteration " << iteration
+        << ", log-likelihood " << l << "." << std::endl;
+
+    Update(observations, responsibilities, dists, weights);
+
+    lOld = l;
+    l = Responsibilities(observations, probabilities, dists, weights,
+        responsibilities);
+
+    iteration++;
+  }
+}
+
+template<typename CommunicatorType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<CommunicatorType, CovarianceConstraintPolicy,
+    Distribution>::InitialClustering(const arma::mat& observations,
+                                     std::vector<Distribution>& dists,
+                                     arma::vec& weights)
+{
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  kmeans::DistributedKMeans<CommunicatorType> clusterer(communicator);
+  clusterer.Cluster(observations, dists.size(), assignments, centroids);
+
+  // Each point is given entirely to its cluster.
+  arma::mat responsibilities(observations.n_cols, dists.size(),
+      arma::fill::zeros);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    responsibilities(i, assignments[i]) = 1.0;
+
+  Update(observations, responsibilities, dists, weights);
+}
+
+template<typename CommunicatorType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double DistributedEMFit<CommunicatorType, CovarianceConstraintPolicy,
+    Distribution>::Responsibilities(const arma::mat& observations,
+                                    const arma::vec& probabilities,
+                                    const std::vector<Distribution>& dists,
+                                    const arma::vec& weights,
+                                    arma::mat& responsibilities) const
+{
+  responsibilities.set_size(observations.n_cols, dists.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    // Store the log probabilities of each component directly into its column.
+    arma::vec logProbsAlias = responsibilities.unsafe_col(i);
+    dists[i].LogProbability(observations, logProbsAlias);
+    logProbsAlias += log(weights[i]);
+  }
+
+  // Normalize row-wise, and sum the log-likelihoods of the points.
+  arma::mat logLikelihood(1, 1, arma::fill::zeros);
+  arma::vec pointLogLikelihoods;
+  mlpack::math::LogSumExp(responsibilities, pointLogLikelihoods);
+  // Avoid dividing by zero; if the probability for everything is 0, we don't
+  // want to make it NaN.
+  arma::vec probSums = pointLogLikelihoods;
+  probSums.replace(-std::numeric_limits<double>::infinity(), 0.0);
+  responsibilities.each_col() -= probSums;
+  responsibilities = arma::exp(responsibilities);
+
+  if (probabilities.n_elem == 0)
+  {
+    logLikelihood(0, 0) = arma::accu(pointLogLikelihoods);
+  }
+  else
+  {
+    responsibilities.each_col() %= probabilities;
+    logLikelihood(0, 0) = arma::dot(probabilities, pointLogLikelihoods);
+  }
+
+  communicator.AllReduceSum(logLikelihood);
+  return logLikelihood(0, 0);
+}
+
+template<typename CommunicatorType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void DistributedEMFit<CommunicatorType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& observations,
+                          const arma::mat& responsibilities,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  const size_t dimensionality = observations.n_rows;
+  const size_t components = dists.size();
+
+  // Check if the type of Distribution is DiagonalGaussianDistribution.  If so,
+  // only the diagonals of the covariances are computed (and reduced).
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  // The first pass reduces the weighted sums of the observations (in the first
+  // rows) and the total responsibility of each component (in the last row).
+  arma::mat stats(dimensionality + 1, components);
+  stats.head_rows(dimensionality) = observations * responsibilities;
+  stats.row(dimensionality) = arma::sum(responsibilities, 0);
+  communicator.AllReduceSum(stats);
+
+  const arma::rowvec totals = stats.row(dimensionality);
+  arma::mat means = stats.head_rows(dimensionality);
+  for (size_t i = 0; i < components; ++i)
+    if (totals[i] > 0)
+      means.col(i) /= totals[i];
+
+  // The second pass reduces the weighted centered outer products of the
+  // observations, one column per component.
+  arma::mat covStats(isDiagGaussDist ? dimensionality :
+      dimensionality * dimensionality, components);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) components; ++i)
+  {
+    const arma::mat centered = observations.each_col() - means.col(i);
+    if (isDiagGaussDist)
+    {
+      covStats.col(i) = (centered % centered) * responsibilities.col(i);
+    }
+    else
+    {
+      arma::mat cov(covStats.colptr(i), dimensionality, dimensionality, false,
+          true);
+      cov = (centered.each_row() % responsibilities.col(i).t()) *
+          centered.t();
+    }
+  }
+  communicator.AllReduceSum(covStats);
+
+  for (size_t i = 0; i < components; ++i)
+  {
+    // A component that is given no point keeps its parameters.
+    if (totals[i] == 0)
+      continue;
+
+    typename std::conditional<isDiagGaussDist, arma::vec, arma::mat>::type
+        cov = covStats.col(i) / totals[i];
+    if (!isDiagGaussDist)
+      cov.reshape(dimensionality, dimensionality);
+
+    // Apply constraints to the covariance matrix.
+    constraint.ApplyConstraint(cov);
+
+    dists[i].Mean() = means.col(i);
+    dists[i].Covariance(std::move(cov));
+  }
+
+  weights = (totals / arma::accu(totals)).t();
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
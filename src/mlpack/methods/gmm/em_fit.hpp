@@ -162,6 +162,58 @@ class EMFit
       const std::vector<Distribution>& dists,
       const arma::vec& weights) const;
 
+  /**
+   * Compute the log-probability of each observation under each component, plus
+   * the log of the weight of the component, and store it in the given matrix,
+   * which will have one column per component.  The components are handled in
+   * parallel.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions of the components.
+   * @param weights Vector of a priori weights.
+   * @param logProbs Matrix to store the log-probabilities in.
+   */
+  template<typename DistributionType>
+  static void LogProbabilities(const arma::mat& observations,
+                               const std::vector<DistributionType>& dists,
+                               const arma::vec& weights,
+                               arma::mat& logProbs);
+
+  /**
+   * Compute the log-probability of each observation under each component, plus
+   * the log of the weight of the component, for Gaussian components.  The
+   * observations are whitened by each component in blocks, so that the
+   * Mahalanobis distances are computed with matrix multiplications, and the
+   * blocks and components are handled in parallel.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions of the components.
+   * @param weights Vector of a priori weights.
+   * @param logProbs Matrix to store the log-probabilities in.
+   */
+  static void LogProbabilities(
+      const arma::mat& observations,
+      const std::vector<distribution::GaussianDistribution>& dists,
+      const arma::vec& weights,
+      arma::mat& logProbs);
+
+  /**
+   * Update the means and covariances of the components (the M-step), given the
+   * log of the (unnormalized) probability of each observation belonging to each
+   * component and the log of the sum of each column of those probabilities.
+   * The means and covariances are computed in parallel over the components.
+   *
+   * @param observations List of observations.
+   * @param condLogProb Log-probability of each observation (rows) belonging to
+   *     each component (columns).
+   * @param probRowSums Log of the sum of each column of condLogProb.
+   * @param dists Distributions to store model in.
+   */
+  void UpdateComponents(const arma::mat& observations,
+                        const arma::mat& condLogProb,
+                        const arma::vec& probRowSums,
+                        std::vector<Distribution>& dists);
+
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
    * covariance.  If InitialClusteringType == kmeans::KMeans<>, this will use
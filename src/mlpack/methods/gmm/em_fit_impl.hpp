@@ -88,71 +88,22 @@ Estimate(const arma::mat& observations,
 
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
+    LogProbabilities(observations, dists, weights, condLogProb);
 
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    // Normalize row-wise.  Avoid dividing by zero; if the probability for
+    // everything is 0, we don't want to make it NaN.
+    arma::vec probSums;
+    mlpack::math::LogSumExp(condLogProb, probSums);
+    probSums.replace(-std::numeric_limits<double>::infinity(), 0.0);
+    condLogProb.each_col() -= probSums;
 
     // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
-    }
+    arma::vec probRowSums;
+    mlpack::math::LogSumExpT(condLogProb, probRowSums);
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities.
+    UpdateComponents(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -186,6 +137,7 @@ Estimate(const arma::mat& observations,
 
   double lOld = -DBL_MAX;
   arma::mat condLogProb(observations.n_cols, dists.size());
+  const arma::vec logProbabilities = arma::log(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -193,79 +145,25 @@ Estimate(const arma::mat& observations,
   {
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = arma::log(probabilities);
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = mlpack::math::AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-    }
+    LogProbabilities(observations, dists, weights, condLogProb);
+
+    // Normalize row-wise.  Avoid dividing by zero; if the probability for
+    // everything is 0, we don't want to make it NaN.
+    arma::vec probSums;
+    mlpack::math::LogSumExp(condLogProb, probSums);
+    probSums.replace(-std::numeric_limits<double>::infinity(), 0.0);
+    condLogProb.each_col() -= probSums;
+
+    // Weight the conditional probabilities by the probability of each point
+    // being from this mixture model, and store the sum of probabilities of
+    // each state over all the observations.
+    condLogProb.each_col() += logProbabilities;
+    arma::vec probRowSums;
+    mlpack::math::LogSumExpT(condLogProb, probRowSums);
+
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities.
+    UpdateComponents(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -383,30 +281,180 @@ LogLikelihood(const arma::mat& observations,
 {
   double logLikelihood = 0;
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
-
   // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
-  {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
-  }
+  arma::mat logLikelihoods;
+  LogProbabilities(observations, dists, weights, logLikelihoods);
+
   // Now sum over every point.
+  arma::vec pointLogLikelihoods;
+  mlpack::math::LogSumExp(logLikelihoods, pointLogLikelihoods);
+
   for (size_t j = 0; j < observations.n_cols; ++j)
   {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    if (pointLogLikelihoods[j] == -std::numeric_limits<double>::infinity())
     {
       Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
           << "outlier." << std::endl;
     }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
+    logLikelihood += pointLogLikelihoods[j];
   }
 
   return logLikelihood;
 }
 
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename DistributionType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+LogProbabilities(const arma::mat& observations,
+                 const std::vector<DistributionType>& dists,
+                 const arma::vec& weights,
+                 arma::mat& logProbs)
+{
+  logProbs.set_size(observations.n_cols, dists.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    // Store the log probabilities of each component directly into its column.
+    arma::vec logProbsAlias = logProbs.unsafe_col(i);
+    dists[i].LogProbability(observations, logProbsAlias);
+    logProbsAlias += log(weights[i]);
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+LogProbabilities(const arma::mat& observations,
+                 const std::vector<distribution::GaussianDistribution>& dists,
+                 const arma::vec& weights,
+                 arma::mat& logProbs)
+{
+  logProbs.set_size(observations.n_cols, dists.size());
+
+  // If L is the lower Cholesky factor of the covariance of a component, then
+  // the Mahalanobis distance of x is the squared norm of inv(L) * (x - mean).
+  // So we whiten the observations with inv(L), which turns the distance
+  // computations of a block of observations into a single matrix product.
+  std::vector<arma::mat> whitenings(dists.size());
+  arma::mat whitenedMeans(observations.n_rows, dists.size());
+  arma::vec constants(dists.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    // The distribution has already factored its covariance successfully, so
+    // this shouldn't fail; if it does, we fall back to LogProbability().
+    arma::mat covLower;
+    if (arma::chol(covLower, dists[i].Covariance(), "lower"))
+    {
+      whitenings[i] = arma::inv(arma::trimatl(covLower));
+      whitenedMeans.col(i) = whitenings[i] * dists[i].Mean();
+    }
+
+    constants[i] = log(weights[i]) - 0.5 * observations.n_rows *
+        std::log(2.0 * M_PI) - 0.5 * dists[i].LogDetCov();
+  }
+
+  // Each task is one component of one block of observations.  The components of
+  // a block are next to each other, so that a thread can often reuse a block
+  // that is already in its cache.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) (numBlocks * dists.size()); ++t)
+  {
+    const size_t i = t % dists.size();
+    const size_t begin = (t / dists.size()) * blockSize;
+    const size_t end = std::min(begin + blockSize,
+        (size_t) observations.n_cols) - 1;
+
+    if (whitenings[i].is_empty())
+    {
+      arma::vec blockLogProbs;
+      dists[i].LogProbability(observations.cols(begin, end), blockLogProbs);
+      logProbs(arma::span(begin, end), i) = blockLogProbs + log(weights[i]);
+      continue;
+    }
+
+    arma::mat whitened = whitenings[i] * observations.cols(begin, end);
+    whitened.each_col() -= whitenedMeans.col(i);
+    logProbs(arma::span(begin, end), i) = constants[i] -
+        0.5 * arma::sum(arma::square(whitened), 0).t();
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+UpdateComponents(const arma::mat& observations,
+                 const arma::mat& condLogProb,
+                 const arma::vec& probRowSums,
+                 std::vector<Distribution>& dists)
+{
+  // If the distribution is DiagonalGaussianDistribution, calculate the
+  // covariance only with diagonal components.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+  std::vector<typename std::conditional<isDiagGaussDist,
+      arma::vec, arma::mat>::type> covs(dists.size());
+
+  // The covariances are accumulated over blocks of observations, so that each
+  // thread only needs a block-sized temporary matrix.
+  const size_t blockSize = 1024;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+      continue;
+
+    const arma::vec probs = arma::exp(condLogProb.col(i) - probRowSums[i]);
+    dists[i].Mean() = observations * probs;
+
+    if (isDiagGaussDist)
+      covs[i].zeros(observations.n_rows);
+    else
+      covs[i].zeros(observations.n_rows, observations.n_rows);
+
+    for (size_t begin = 0; begin < observations.n_cols; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols) - 1;
+      arma::mat tmp = observations.cols(begin, end);
+      tmp.each_col() -= dists[i].Mean();
+
+      if (isDiagGaussDist)
+      {
+        arma::mat tmpB = arma::square(tmp);
+        tmpB.each_row() %= trans(probs.subvec(begin, end));
+        covs[i] += arma::sum(tmpB, 1);
+      }
+      else
+      {
+        arma::mat tmpB = tmp.each_row() % trans(probs.subvec(begin, end));
+        covs[i] += tmp * trans(tmpB);
+      }
+    }
+  }
+
+  // Applying the constraint and factoring the covariance are cheap next to the
+  // passes over the data, and they may fail with Log::Fatal, which must not
+  // throw out of a parallel region, so they are done serially.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+      continue;
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covs[i]);
+    dists[i].Covariance(std::move(covs[i]));
+  }
+}
+
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
@@ -91,11 +91,8 @@ void GMM::LogProbability(const arma::mat& observation,
     dists[i].LogProbability(observation, temp);
   }
 
-  // Save log(weights) as a vector.
-  arma::vec logWeights = arma::log(weights);
-
-  // Compute log-probability.
-  logProb += repmat(logWeights.t(), logProb.n_rows, 1);
+  // Add the log of the weight of each component.
+  logProb.each_row() += arma::log(weights).t();
   math::LogSumExp(logProb, logProbs);
 }
 
@@ -191,23 +188,28 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Compute the log probabilities of all the observations under each
+  // component at once (LogProbability() is used, otherwise Probability() would
+  // overflow easily), then find the maximum probability component of each
+  // observation.
+  arma::mat logProbs(observations.n_cols, gaussians);
+  for (size_t j = 0; j < gaussians; ++j)
+  {
+    arma::vec alias(logProbs.colptr(j), observations.n_cols, false, true);
+    dists[j].LogProbability(observations, alias);
+    alias += log(weights[j]);
+  }
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
   labels.set_size(observations.n_cols);
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
-    // Find maximum probability component.
+    // The last component wins ties, as before.
     double probability = -std::numeric_limits<double>::infinity();
     for (size_t j = 0; j < gaussians; ++j)
     {
-      // We have to use LogProbability() otherwise Probability() would overflow
-      // easily.
-      double newProb = LogProbability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbs(i, j) >= probability)
       {
-        probability = newProb;
+        probability = logProbs(i, j);
         labels[i] = j;
       }
     }
@@ -238,8 +240,9 @@ double GMM::LogLikelihood(
   }
 
   // Now sum over every point.
-  for (size_t j = 0; j < data.n_cols; ++j)
-    loglikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
+  arma::vec pointLogLikelihoods;
+  mlpack::math::LogSumExpT(logLikelihoods, pointLogLikelihoods);
+  loglikelihood += arma::accu(pointLogLikelihoods);
   return loglikelihood;
 }
 
@@ -17,6 +17,7 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+#include "stochastic_em_fit.hpp"
 
 namespace mlpack {
 namespace gmm /** Gaussian Mixture Models. */ {
@@ -276,6 +277,42 @@ class GMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with a chunk of new observations, with a single step of
+   * the given stochastic fitting method (StochasticEMFit is suggested).  The
+   * model should already be trained, for instance with Train() on the first
+   * chunk.  The fitter keeps track of the number of steps taken, so the same
+   * fitter should be passed for each chunk.
+   *
+   * @code
+   * StochasticEMFit<> fitter;
+   * for (size_t i = 0; i < chunks.size(); ++i)
+   *   g.PartialFit(chunks[i], fitter);
+   * @endcode
+   *
+   * @param observations Chunk of new observations.
+   * @param fitter The fitter to use.
+   * @return The log-likelihood of the chunk before the update.
+   */
+  template<typename FittingType>
+  double PartialFit(const arma::mat& observations, FittingType& fitter);
+
+  /**
+   * Update the model with a chunk of new observations, taking into account the
+   * probability of each observation actually being from this distribution.
+   * Otherwise, this is the same as the other overload of PartialFit().
+   *
+   * @param observations Chunk of new observations.
+   * @param probabilities Probability of each observation being from this
+   *     distribution.
+   * @param fitter The fitter to use.
+   * @return The log-likelihood of the chunk before the update.
+   */
+  template<typename FittingType>
+  double PartialFit(const arma::mat& observations,
+                    const arma::vec& probabilities,
+                    FittingType& fitter);
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
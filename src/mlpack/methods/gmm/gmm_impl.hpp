@@ -187,6 +187,27 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the GMM with a chunk of new observations.
+ */
+template<typename FittingType>
+double GMM::PartialFit(const arma::mat& observations, FittingType& fitter)
+{
+  return fitter.Step(observations, dists, weights);
+}
+
+/**
+ * Update the GMM with a chunk of new observations, each of which has a certain
+ * probability of being from this distribution.
+ */
+template<typename FittingType>
+double GMM::PartialFit(const arma::mat& observations,
+                       const arma::vec& probabilities,
+                       FittingType& fitter)
+{
+  return fitter.Step(observations, probabilities, dists, weights);
+}
+
 /**
  * Serialize the object.
  */
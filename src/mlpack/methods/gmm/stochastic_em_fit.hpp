@@ -0,0 +1,232 @@
+/**
+ * @file methods/gmm/stochastic_em_fit.hpp
+ *
+ * Utility class to fit a GMM with stochastic (online) EM, which updates the
+ * model with a mini-batch of observations at each step.  Used by
+ * GMM::Train<>() and GMM::PartialFit<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the stochastic EM algorithm of
+ * Cappé and Moulines:
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line expectation-maximization algorithm for latent data models},
+ *   author={Capp{\'e}, Olivier and Moulines, Eric},
+ *   journal={Journal of the Royal Statistical Society: Series B (Statistical
+ *       Methodology)},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * Instead of computing the responsibilities of every observation at each
+ * iteration, each step computes them for a mini-batch, and moves the
+ * sufficient statistics of the model (the weight, mean and second moment of
+ * each component) towards those of the mini-batch with a step size of
+ *
+ *   rho_t = (t + Delay())^(-ForgettingRate()),
+ *
+ * where t is the number of steps taken so far.  The forgetting rate should be
+ * in (0.5, 1] for the steps to converge; smaller forgetting rates forget old
+ * observations faster, which suits data that drifts over time.
+ *
+ * The same interface as EMFit is provided, so this can be used as the
+ * FittingType of GMM::Train() and DiagonalGMM::Train().  Step() updates an
+ * existing model with a single mini-batch, and is used by GMM::PartialFit()
+ * to refresh a trained model with new observations.  The number of steps is
+ * kept between calls, so the step size keeps decaying across chunks.
+ *
+ * The initial clustering is run on a random sample of the observations, of
+ * BatchSize() points or ten points per component, whichever is larger.  The
+ * clustering mechanism must implement the same Cluster() method as for EMFit.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class StochasticEMFit
+{
+ public:
+  /**
+   * Construct the StochasticEMFit object.
+   *
+   * @param maxIterations Number of mini-batch steps taken by Estimate().
+   * @param batchSize Number of observations in each mini-batch.
+   * @param forgettingRate Exponent of the decay of the step size.
+   * @param delay Offset of the step count in the step size; must be at least
+   *     1.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  StochasticEMFit(const size_t maxIterations = 300,
+                  const size_t batchSize = 1000,
+                  const double forgettingRate = 0.6,
+                  const double delay = 1.0,
+                  InitialClusteringType clusterer = InitialClusteringType(),
+                  CovarianceConstraintPolicy constraint =
+                      CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with MaxIterations()
+   * mini-batch steps, each on BatchSize() observations sampled with
+   * replacement.  The size of the vectors (indicating the number of
+   * components) must already be set.  If useInitialModel is set to true, the
+   * given model is used as the initial model instead of running the initial
+   * clustering.  This resets the number of steps taken.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with mini-batch
+   * steps, taking into account the probabilities of each point being from
+   * this mixture.  Otherwise, this is the same as the other overload of
+   * Estimate().
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Take a single step of stochastic EM with the given mini-batch, updating
+   * the given model.  The components are updated in parallel.
+   *
+   * @param batch Mini-batch of observations.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return The log-likelihood of the mini-batch before the update.
+   */
+  double Step(const arma::mat& batch,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Take a single step of stochastic EM with the given mini-batch, taking into
+   * account the probabilities of each point being from this mixture.
+   *
+   * @param batch Mini-batch of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return The log-likelihood of the mini-batch before the update.
+   */
+  double Step(const arma::mat& batch,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the number of mini-batch steps taken by Estimate().
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the number of mini-batch steps taken by Estimate().
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of observations in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the forgetting rate of the step size.
+  double ForgettingRate() const { return forgettingRate; }
+  //! Modify the forgetting rate of the step size.
+  double& ForgettingRate() { return forgettingRate; }
+
+  //! Get the delay of the step size.
+  double Delay() const { return delay; }
+  //! Modify the delay of the step size.
+  double& Delay() { return delay; }
+
+  //! Get the number of steps taken so far.
+  size_t Steps() const { return steps; }
+  //! Modify the number of steps taken so far.
+  size_t& Steps() { return steps; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  /**
+   * Run the clusterer on a random sample of the observations, and then turn
+   * the cluster assignments into Gaussians.  Components that get no points
+   * keep their parameters, with a weight of zero.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<Distribution>& dists,
+                         arma::vec& weights);
+
+  //! Number of mini-batch steps taken by Estimate().
+  size_t maxIterations;
+  //! Number of observations in each mini-batch.
+  size_t batchSize;
+  //! Exponent of the decay of the step size.
+  double forgettingRate;
+  //! Offset of the step count in the step size.
+  double delay;
+  //! Number of steps taken so far.
+  size_t steps;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "stochastic_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,270 @@
+/**
+ * @file methods/gmm/stochastic_em_fit_impl.hpp
+ *
+ * Implementation of the stochastic EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "stochastic_em_fit.hpp"
+
+#include <mlpack/core/math/log_add.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::StochasticEMFit(const size_t maxIterations,
+                                   const size_t batchSize,
+                                   const double forgettingRate,
+                                   const double delay,
+                                   InitialClusteringType clusterer,
+                                   CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    batchSize(batchSize),
+    forgettingRate(forgettingRate),
+    delay(delay),
+    steps(0),
+    clusterer(clusterer),
+    constraint(constraint)
+{
+  if (delay < 1.0)
+  {
+    Log::Fatal << "StochasticEMFit::StochasticEMFit(): delay must be at least "
+        << "1 (given " << delay << ")!" << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Estimate(observations, arma::ones<arma::vec>(observations.n_cols), dists,
+      weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (observations.n_cols == 0)
+    return;
+
+  // Only perform initial clustering if the user wanted it.
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  steps = 0;
+  arma::uvec batch(std::min(batchSize, (size_t) observations.n_cols));
+  for (size_t iteration = 0; iteration < maxIterations; ++iteration)
+  {
+    // Sample the batch, with replacement.
+    for (size_t i = 0; i < batch.n_elem; ++i)
+      batch[i] = math::RandInt(0, observations.n_cols);
+
+    const double logLikelihood = Step(observations.cols(batch),
+        probabilities.elem(batch), dists, weights);
+
+    Log::Debug << "StochasticEMFit::Estimate(): step " << iteration << ", "
+        << "batch log-likelihood " << logLikelihood << "." << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& batch,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  return Step(batch, arma::ones<arma::vec>(batch.n_cols), dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& batch,
+                        const arma::vec& probabilities,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  // Calculate the conditional log probabilities of each component for each
+  // point of the batch.
+  arma::mat condLogProb(batch.n_cols, dists.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
+    dists[i].LogProbability(batch, condLogProbAlias);
+    condLogProbAlias += log(weights[i]);
+  }
+
+  // Normalize row-wise, keeping the log-likelihood of each point.
+  arma::vec logLikelihoods;
+  mlpack::math::LogSumExp(condLogProb, logLikelihoods);
+  for (size_t j = 0; j < batch.n_cols; ++j)
+  {
+    if (logLikelihoods[j] != -std::numeric_limits<double>::infinity())
+      condLogProb.row(j) -= logLikelihoods[j];
+  }
+
+  const double totalProbability = arma::accu(probabilities);
+  if (totalProbability == 0.0)
+    return arma::accu(logLikelihoods);
+
+  const double stepSize = std::min(1.0,
+      std::pow(steps + delay, -forgettingRate));
+  ++steps;
+
+  // Each component moves its sufficient statistics towards those of the batch.
+  // Instead of the raw second moments, we combine the covariances around the
+  // new mean, which is equivalent but doesn't lose precision when the mean is
+  // far from the origin.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+  typedef typename std::conditional<isDiagGaussDist, arma::vec,
+      arma::mat>::type CovarianceType;
+  std::vector<arma::vec> means(dists.size());
+  std::vector<CovarianceType> covs(dists.size());
+  arma::vec newWeights(dists.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    const arma::vec probs = arma::exp(condLogProb.col(i)) % probabilities;
+    const double probSum = arma::accu(probs);
+    const double batchWeight = probSum / totalProbability;
+    newWeights[i] = (1.0 - stepSize) * weights[i] + stepSize * batchWeight;
+
+    // Don't update if the batch has no probability of being from the Gaussian.
+    if (probSum == 0.0 || newWeights[i] == 0.0)
+      continue;
+
+    const arma::vec batchMean = batch * probs / probSum;
+    const double oldFraction = (1.0 - stepSize) * weights[i] / newWeights[i];
+    const double batchFraction = stepSize * batchWeight / newWeights[i];
+    means[i] = oldFraction * dists[i].Mean() + batchFraction * batchMean;
+
+    const arma::vec oldDiff = dists[i].Mean() - means[i];
+    const arma::vec batchDiff = batchMean - means[i];
+    arma::mat centered = batch.each_col() - batchMean;
+    if (isDiagGaussDist)
+    {
+      arma::mat weighted = arma::square(centered);
+      weighted.each_row() %= trans(probs / probSum);
+      covs[i] = oldFraction * (dists[i].Covariance() + oldDiff % oldDiff) +
+          batchFraction * (arma::sum(weighted, 1) + batchDiff % batchDiff);
+    }
+    else
+    {
+      arma::mat weighted = centered.each_row() % trans(probs / probSum);
+      covs[i] = oldFraction * (dists[i].Covariance() + oldDiff * oldDiff.t()) +
+          batchFraction * (centered * weighted.t() + batchDiff * batchDiff.t());
+    }
+  }
+
+  // Applying the constraint and factoring the covariance may fail with
+  // Log::Fatal, which must not throw out of a parallel region, so this is done
+  // serially.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (means[i].is_empty())
+      continue;
+
+    dists[i].Mean() = std::move(means[i]);
+    constraint.ApplyConstraint(covs[i]);
+    dists[i].Covariance(std::move(covs[i]));
+  }
+
+  // Points with zero likelihood have no responsibilities, so the weights may
+  // not sum to one anymore.
+  if (arma::accu(newWeights) > 0.0)
+    weights = newWeights / arma::accu(newWeights);
+
+  return arma::accu(logLikelihoods);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitialClustering(const arma::mat& observations,
+                                     std::vector<Distribution>& dists,
+                                     arma::vec& weights)
+{
+  // Sample the points to cluster, without replacement.
+  const size_t sampleSize = std::min((size_t) observations.n_cols,
+      std::max(batchSize, 10 * dists.size()));
+  const arma::uvec sample = arma::randperm(observations.n_cols, sampleSize);
+  const arma::mat sampleObservations = observations.cols(sample);
+
+  arma::Row<size_t> assignments;
+  clusterer.Cluster(sampleObservations, dists.size(), assignments);
+
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+  typename std::conditional<isDiagGaussDist, arma::vec, arma::mat>::type cov;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::uvec points = arma::find(assignments == i);
+    weights[i] = (double) points.n_elem / sampleSize;
+    if (points.n_elem == 0)
+      continue;
+
+    arma::mat clusterPoints = sampleObservations.cols(points);
+    dists[i].Mean() = arma::mean(clusterPoints, 1);
+    clusterPoints.each_col() -= dists[i].Mean();
+    if (isDiagGaussDist)
+      cov = arma::mean(arma::square(clusterPoints), 1);
+    else
+      cov = clusterPoints * clusterPoints.t() / points.n_elem;
+
+    // Apply constraints to covariance matrix.
+    constraint.ApplyConstraint(cov);
+    dists[i].Covariance(std::move(cov));
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(batchSize));
+  ar(CEREAL_NVP(forgettingRate));
+  ar(CEREAL_NVP(delay));
+  ar(CEREAL_NVP(steps));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,208 @@
+/**
+ * @file methods/hdbscan/hdbscan.hpp
+ *
+ * An implementation of the HDBSCAN hierarchical density-based clustering
+ * method, built on tree-based nearest neighbor search and the dual-tree
+ * Borůvka minimum spanning tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include "mutual_reachability_distance.hpp"
+
+namespace mlpack {
+namespace hdbscan /** HDBSCAN clustering. */ {
+
+/**
+ * HDBSCAN (Hierarchical DBSCAN) is a clustering technique described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-based clustering based on hierarchical density estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Pacific-Asia Conference on Knowledge Discovery and Data Mining
+ *       (PAKDD 2013)},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * HDBSCAN considers the DBSCAN clusterings for every value of epsilon at once,
+ * and keeps the clusters that persist the longest, so no radius has to be
+ * chosen.  The core distance of each point is the distance to its
+ * MinPoints()-th nearest neighbor (counting the point itself), and the
+ * clusters are found in the minimum spanning tree of the points under the
+ * mutual reachability distance
+ *
+ *   d_mreach(a, b) = max(core(a), core(b), d(a, b)).
+ *
+ * Removing the edges of the tree from the longest one down gives the cluster
+ * hierarchy; it is condensed by ignoring the splits that separate fewer than
+ * MinClusterSize() points, which are considered to fall out of their cluster,
+ * and the clusters with the largest total stability (the sum over their
+ * points of how long, in 1 / d_mreach, each point stays in the cluster) are
+ * selected.
+ *
+ * The core distances are computed with a neighbor::NeighborSearch, and the
+ * minimum spanning tree with an emst::DualTreeBoruvka that uses
+ * MutualReachabilityDistance on the points augmented with their core
+ * distance; both are parallel with OpenMP.  The hierarchy is then condensed
+ * and the clusters are selected in time linear in the number of points.
+ *
+ * @tparam MetricType Metric of the points.
+ * @tparam TreeType Type of tree to use for the nearest neighbor search and the
+ *     minimum spanning tree.  The bounds of the tree must work with any
+ *     metric, since it is built with MutualReachabilityDistance for the
+ *     minimum spanning tree, so tree::BallTree is the default.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::BallTree>
+class HDBSCAN
+{
+ public:
+  /**
+   * Construct the HDBSCAN object with the given parameters.
+   *
+   * @param minClusterSize Minimum number of points in a cluster; must be at
+   *     least 2.
+   * @param minPoints Number of neighbors (including the point itself) that
+   *     define the core distance of a point.  If 0, minClusterSize is used.
+   * @param allowSingleCluster If true, all the points may be selected as a
+   *     single cluster; otherwise at least two clusters are returned, unless
+   *     every point is noise.
+   * @param metric Instantiated metric.
+   */
+  HDBSCAN(const size_t minClusterSize,
+          const size_t minPoints = 0,
+          const bool allowSingleCluster = false,
+          const MetricType metric = MetricType());
+
+  /**
+   * Performs HDBSCAN clustering on the data, returning the number of clusters
+   * and also the centroid of each cluster.
+   *
+   * @param data Dataset to cluster.
+   * @param centroids Matrix in which centroids are stored.
+   */
+  size_t Cluster(const arma::mat& data,
+                 arma::mat& centroids);
+
+  /**
+   * Performs HDBSCAN clustering on the data, returning the number of clusters
+   * and also the list of cluster assignments.  If assignments[i] == SIZE_MAX,
+   * then the point is considered "noise".
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   */
+  size_t Cluster(const arma::mat& data,
+                 arma::Row<size_t>& assignments);
+
+  /**
+   * Performs HDBSCAN clustering on the data, returning the number of clusters,
+   * the centroid of each cluster and also the list of cluster assignments.
+   * If assignments[i] == SIZE_MAX, then the point is considered "noise".
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   * @param centroids Matrix in which centroids are stored.
+   */
+  size_t Cluster(const arma::mat& data,
+                 arma::Row<size_t>& assignments,
+                 arma::mat& centroids);
+
+  //! Get the minimum number of points in a cluster.
+  size_t MinClusterSize() const { return minClusterSize; }
+  //! Modify the minimum number of points in a cluster.
+  size_t& MinClusterSize() { return minClusterSize; }
+
+  //! Get the number of neighbors that define the core distance.
+  size_t MinPoints() const { return minPoints; }
+  //! Modify the number of neighbors that define the core distance.
+  size_t& MinPoints() { return minPoints; }
+
+  //! Get whether all the points may be selected as a single cluster.
+  bool AllowSingleCluster() const { return allowSingleCluster; }
+  //! Modify whether all the points may be selected as a single cluster.
+  bool& AllowSingleCluster() { return allowSingleCluster; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! Minimum number of points in a cluster.
+  size_t minClusterSize;
+
+  //! Number of neighbors (including the point itself) that define the core
+  //! distance.
+  size_t minPoints;
+
+  //! Whether all the points may be selected as a single cluster.
+  bool allowSingleCluster;
+
+  //! Instantiated metric.
+  MetricType metric;
+
+  /**
+   * Compute the core distance of each point, with a dual-tree nearest
+   * neighbor search.
+   *
+   * @param data Dataset to cluster.
+   * @param coreDistances Vector to store the core distances in.
+   */
+  void CoreDistances(const arma::mat& data, arma::rowvec& coreDistances);
+
+  /**
+   * Build the single linkage hierarchy from the edges of the minimum spanning
+   * tree, sorted by increasing length.  Node i < n is point i, and the merge
+   * of edge k creates node n + k, whose children are left[k] and right[k].
+   *
+   * @param mst Edges of the minimum spanning tree, as returned by
+   *     emst::DualTreeBoruvka::ComputeMST().
+   * @param left Left child of each merge.
+   * @param right Right child of each merge.
+   * @param sizes Number of points under each node.
+   */
+  static void SingleLinkage(const arma::mat& mst,
+                            arma::Col<size_t>& left,
+                            arma::Col<size_t>& right,
+                            arma::Col<size_t>& sizes);
+
+  /**
+   * Condense the single linkage hierarchy, select the most stable clusters,
+   * and label the points.
+   *
+   * @param mst Edges of the minimum spanning tree.
+   * @param left Left child of each merge.
+   * @param right Right child of each merge.
+   * @param sizes Number of points under each node.
+   * @param assignments Vector to store cluster assignments.
+   * @return The number of clusters.
+   */
+  size_t ExtractClusters(const arma::mat& mst,
+                         const arma::Col<size_t>& left,
+                         const arma::Col<size_t>& right,
+                         const arma::Col<size_t>& sizes,
+                         arma::Row<size_t>& assignments) const;
+};
+
+} // namespace hdbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "hdbscan_impl.hpp"
+
+#endif
@@ -0,0 +1,342 @@
+/**
+ * @file methods/hdbscan/hdbscan_impl.hpp
+ *
+ * Implementation of HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hdbscan.hpp"
+
+namespace mlpack {
+namespace hdbscan {
+
+/**
+ * Construct the HDBSCAN object with the given parameters.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+HDBSCAN<MetricType, TreeType>::HDBSCAN(const size_t minClusterSize,
+                                       const size_t minPoints,
+                                       const bool allowSingleCluster,
+                                       const MetricType metric) :
+    minClusterSize(minClusterSize),
+    minPoints(minPoints == 0 ? minClusterSize : minPoints),
+    allowSingleCluster(allowSingleCluster),
+    metric(metric)
+{
+  if (minClusterSize < 2)
+  {
+    Log::Fatal << "HDBSCAN::HDBSCAN(): minClusterSize must be at least 2 "
+        << "(given " << minClusterSize << ")!" << std::endl;
+  }
+}
+
+/**
+ * Performs HDBSCAN clustering on the data, returning the number of clusters
+ * and also the centroid of each cluster.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::Cluster(const arma::mat& data,
+                                              arma::mat& centroids)
+{
+  // These assignments will be thrown away, but there is no way to avoid
+  // calculating them.
+  arma::Row<size_t> assignments;
+
+  return Cluster(data, assignments, centroids);
+}
+
+/**
+ * Performs HDBSCAN clustering on the data, returning the number of clusters,
+ * the centroid of each cluster and also the list of cluster assignments.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::Cluster(const arma::mat& data,
+                                              arma::Row<size_t>& assignments,
+                                              arma::mat& centroids)
+{
+  const size_t numClusters = Cluster(data, assignments);
+
+  // Now calculate the centroids.
+  centroids.zeros(data.n_rows, numClusters);
+
+  // Calculate number of points in each cluster.
+  arma::Row<size_t> counts;
+  counts.zeros(numClusters);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (assignments[i] != SIZE_MAX)
+    {
+      centroids.col(assignments[i]) += data.col(i);
+      ++counts[assignments[i]];
+    }
+  }
+
+  // Every selected cluster has at least minClusterSize points.
+  for (size_t i = 0; i < numClusters; ++i)
+    centroids.col(i) /= counts[i];
+
+  return numClusters;
+}
+
+/**
+ * Performs HDBSCAN clustering on the data, returning the number of clusters
+ * and also the list of cluster assignments.
+ */
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::Cluster(const arma::mat& data,
+                                              arma::Row<size_t>& assignments)
+{
+  assignments.set_size(data.n_cols);
+  assignments.fill(SIZE_MAX);
+
+  // With fewer points than a cluster, everything is noise.
+  if (data.n_cols < minClusterSize)
+    return 0;
+
+  if (minPoints > data.n_cols)
+  {
+    Log::Fatal << "HDBSCAN::Cluster(): minPoints (" << minPoints << ") must "
+        << "not be greater than the number of points (" << data.n_cols << ")!"
+        << std::endl;
+  }
+
+  arma::rowvec coreDistances;
+  CoreDistances(data, coreDistances);
+
+  // Append the core distances to the points, so that the mutual reachability
+  // distance can be evaluated on them.
+  arma::mat mst;
+  {
+    arma::mat augmentedData(data.n_rows + 1, data.n_cols);
+    augmentedData.head_rows(data.n_rows) = data;
+    augmentedData.row(data.n_rows) = coreDistances;
+
+    typedef MutualReachabilityDistance<MetricType> MutualReachabilityType;
+    emst::DualTreeBoruvka<MutualReachabilityType, arma::mat, TreeType> dtb(
+        augmentedData, false, MutualReachabilityType(metric));
+    dtb.ComputeMST(mst);
+  }
+
+  arma::Col<size_t> left, right, sizes;
+  SingleLinkage(mst, left, right, sizes);
+
+  const size_t numClusters = ExtractClusters(mst, left, right, sizes,
+      assignments);
+
+  Log::Info << "HDBSCAN::Cluster(): found " << numClusters << " clusters."
+      << std::endl;
+
+  return numClusters;
+}
+
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void HDBSCAN<MetricType, TreeType>::CoreDistances(const arma::mat& data,
+                                                  arma::rowvec& coreDistances)
+{
+  // A point is its own first neighbor.
+  coreDistances.zeros(data.n_cols);
+  if (minPoints <= 1)
+    return;
+
+  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+      arma::mat, TreeType> knn(data, neighbor::DUAL_TREE_MODE, 0.0, metric);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(minPoints - 1, neighbors, distances);
+
+  coreDistances = distances.row(minPoints - 2);
+}
+
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void HDBSCAN<MetricType, TreeType>::SingleLinkage(const arma::mat& mst,
+                                                  arma::Col<size_t>& left,
+                                                  arma::Col<size_t>& right,
+                                                  arma::Col<size_t>& sizes)
+{
+  const size_t n = mst.n_cols + 1;
+  left.set_size(n - 1);
+  right.set_size(n - 1);
+  sizes.ones(2 * n - 1);
+
+  // The hierarchy node of each component of the union-find structure.
+  emst::UnionFind connections(n);
+  arma::Col<size_t> nodes = arma::regspace<arma::Col<size_t>>(0, n - 1);
+  for (size_t k = 0; k < mst.n_cols; ++k)
+  {
+    const size_t a = connections.Find((size_t) mst(0, k));
+    const size_t b = connections.Find((size_t) mst(1, k));
+
+    left[k] = nodes[a];
+    right[k] = nodes[b];
+    sizes[n + k] = sizes[left[k]] + sizes[right[k]];
+
+    connections.Union(a, b);
+    nodes[connections.Find(a)] = n + k;
+  }
+}
+
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::ExtractClusters(
+    const arma::mat& mst,
+    const arma::Col<size_t>& left,
+    const arma::Col<size_t>& right,
+    const arma::Col<size_t>& sizes,
+    arma::Row<size_t>& assignments) const
+{
+  const size_t n = mst.n_cols + 1;
+
+  // Clusters are born when a merge node is split in two children that are
+  // both large enough; 1 / distance is the "lambda" at which that happens.
+  auto lambda = [&](const size_t node)
+  {
+    const double distance = mst(2, node - n);
+    return (distance > 0.0) ? 1.0 / distance : DBL_MAX;
+  };
+
+  // The condensed clusters, in the order they are born, so that the parent of
+  // a cluster comes before it.  The root cluster holds all the points.
+  std::vector<size_t> parents(1, SIZE_MAX);
+  std::vector<double> births(1, 0.0);
+  std::vector<double> stabilities(1, 0.0);
+
+  // The cluster each point falls out of.
+  arma::Col<size_t> pointClusters(n);
+
+  // Mark the points under the given node as falling out of the given cluster.
+  std::vector<size_t> fallStack;
+  auto fallOut = [&](const size_t node, const size_t cluster, const double l)
+  {
+    stabilities[cluster] += (l - births[cluster]) * sizes[node];
+    fallStack.push_back(node);
+    while (!fallStack.empty())
+    {
+      const size_t x = fallStack.back();
+      fallStack.pop_back();
+      if (x < n)
+      {
+        pointClusters[x] = cluster;
+      }
+      else
+      {
+        fallStack.push_back(left[x - n]);
+        fallStack.push_back(right[x - n]);
+      }
+    }
+  };
+
+  // Walk down the hierarchy from the root.  Each merge node is visited once,
+  // and each point falls out of exactly one cluster, so this takes linear time.
+  std::vector<std::pair<size_t, size_t>> stack;
+  stack.push_back(std::make_pair(2 * n - 2, 0));
+  while (!stack.empty())
+  {
+    const size_t node = stack.back().first;
+    const size_t cluster = stack.back().second;
+    stack.pop_back();
+
+    const double l = lambda(node);
+    const size_t children[2] = { left[node - n], right[node - n] };
+    const bool large[2] = { sizes[children[0]] >= minClusterSize,
+                            sizes[children[1]] >= minClusterSize };
+    if (large[0] && large[1])
+    {
+      // The cluster splits in two new clusters.
+      stabilities[cluster] += (l - births[cluster]) * sizes[node];
+      for (size_t c = 0; c < 2; ++c)
+      {
+        stack.push_back(std::make_pair(children[c], parents.size()));
+        parents.push_back(cluster);
+        births.push_back(l);
+        stabilities.push_back(0.0);
+      }
+    }
+    else
+    {
+      // The small children fall out, and the large one (if any) is still the
+      // same cluster.  Since minClusterSize is at least 2, large children are
+      // always merge nodes.
+      for (size_t c = 0; c < 2; ++c)
+      {
+        if (large[c])
+          stack.push_back(std::make_pair(children[c], cluster));
+        else
+          fallOut(children[c], cluster, l);
+      }
+    }
+  }
+
+  // Select the clusters from the leaves up: a cluster is selected if it is
+  // more stable than the best selection among its descendants.
+  const size_t numCandidates = parents.size();
+  std::vector<double> childStabilities(numCandidates, 0.0);
+  std::vector<char> hasChildren(numCandidates, 0);
+  std::vector<char> selected(numCandidates, 0);
+  for (size_t c = numCandidates; c > 0; --c)
+  {
+    const size_t i = c - 1;
+    double best = childStabilities[i];
+    if ((i > 0 || allowSingleCluster) &&
+        (!hasChildren[i] || stabilities[i] >= childStabilities[i]))
+    {
+      selected[i] = 1;
+      best = stabilities[i];
+    }
+
+    if (i > 0)
+    {
+      childStabilities[parents[i]] += best;
+      hasChildren[parents[i]] = 1;
+    }
+  }
+
+  // Now label the clusters from the root down; the descendants of a selected
+  // cluster belong to it.
+  std::vector<size_t> labels(numCandidates, SIZE_MAX);
+  size_t numClusters = 0;
+  for (size_t i = 0; i < numCandidates; ++i)
+  {
+    if (i > 0 && labels[parents[i]] != SIZE_MAX)
+      labels[i] = labels[parents[i]];
+    else if (selected[i])
+      labels[i] = numClusters++;
+  }
+
+  for (size_t i = 0; i < n; ++i)
+    assignments[i] = labels[pointClusters[i]];
+
+  return numClusters;
+}
+
+} // namespace hdbscan
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file methods/hdbscan/hdbscan_main.cpp
+ *
+ * Implementation of program to run HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/io.hpp>
+
+#ifdef BINDING_NAME
+  #undef BINDING_NAME
+#endif
+#define BINDING_NAME hdbscan
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "hdbscan.hpp"
+
+using namespace mlpack;
+using namespace mlpack::hdbscan;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_USER_NAME("HDBSCAN clustering");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of HDBSCAN clustering.  Given a dataset, this can "
+    "compute and return a density-based clustering of that dataset without a "
+    "search radius.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program implements the HDBSCAN algorithm for hierarchical "
+    "density-based clustering, using tree-based nearest neighbor search and "
+    "the dual-tree Boruvka minimum spanning tree.  Unlike DBSCAN, no search "
+    "radius has to be given: the clusters that persist over the widest range "
+    "of densities are returned."
+    "\n\n"
+    "The input dataset to be clustered may be specified with the " +
+    PRINT_PARAM_STRING("input") + " parameter; the minimum number of points in "
+    "a cluster may be specified with the " +
+    PRINT_PARAM_STRING("min_cluster_size") + " parameter, and the number of "
+    "neighbors that define the density around each point may be specified "
+    "with the " + PRINT_PARAM_STRING("min_points") + " parameter (by default, "
+    "it is the minimum cluster size).  If " +
+    PRINT_PARAM_STRING("allow_single_cluster") + " is specified, all the "
+    "points may be returned as a single cluster."
+    "\n\n"
+    "The " + PRINT_PARAM_STRING("assignments") + " and " +
+    PRINT_PARAM_STRING("centroids") + " output parameters may be "
+    "used to save the output of the clustering. " +
+    PRINT_PARAM_STRING("assignments") + " contains the cluster assignments of "
+    "each point, and " + PRINT_PARAM_STRING("centroids") + " contains the "
+    "centroids of each cluster.  Noise points are assigned to the largest "
+    "possible value of the assignment type.");
+
+// Example.
+BINDING_EXAMPLE(
+    "An example usage to run HDBSCAN on the dataset in " +
+    PRINT_DATASET("input") + " with a minimum cluster size of 10 is given "
+    "below:"
+    "\n\n" +
+    PRINT_CALL("hdbscan", "input", "input", "min_cluster_size", 10,
+        "assignments", "assignments"));
+
+// See also...
+BINDING_SEE_ALSO("@dbscan", "#dbscan");
+BINDING_SEE_ALSO("@emst", "#emst");
+BINDING_SEE_ALSO("Density-based clustering based on hierarchical density "
+        "estimates", "https://doi.org/10.1007/978-3-642-37456-2_14");
+BINDING_SEE_ALSO("mlpack::hdbscan::HDBSCAN class documentation",
+        "@doxygen/classmlpack_1_1hdbscan_1_1HDBSCAN.html");
+
+PARAM_MATRIX_IN_REQ("input", "Input dataset to cluster.", "i");
+PARAM_UROW_OUT("assignments", "Output matrix for assignments of each "
+    "point.", "a");
+PARAM_MATRIX_OUT("centroids", "Matrix to save output centroids to.", "C");
+
+PARAM_INT_IN("min_cluster_size", "Minimum number of points in a cluster.", "m",
+    5);
+PARAM_INT_IN("min_points", "Number of neighbors (including the point itself) "
+    "that define the core distance of a point; if 0, the minimum cluster size "
+    "is used.", "k", 0);
+PARAM_FLAG("allow_single_cluster", "If set, all the points may be returned as "
+    "a single cluster.", "S");
+
+void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
+{
+  RequireAtLeastOnePassed(params, { "assignments", "centroids" }, false,
+      "no output will be saved");
+
+  // The minimum cluster size should be at least 2.
+  RequireParamValue<int>(params, "min_cluster_size",
+      [](int x) { return x >= 2; }, true,
+      "invalid value of min_cluster_size specified");
+
+  // The number of neighbors should not be negative.
+  RequireParamValue<int>(params, "min_points", [](int x) { return x >= 0; },
+      true, "invalid value of min_points specified");
+
+  arma::mat dataset = std::move(params.Get<arma::mat>("input"));
+  const size_t minClusterSize = (size_t) params.Get<int>("min_cluster_size");
+  const size_t minPoints = (size_t) params.Get<int>("min_points");
+
+  HDBSCAN<> h(minClusterSize, minPoints, params.Has("allow_single_cluster"));
+
+  arma::Row<size_t> assignments;
+  timers.Start("clustering");
+  // If possible, avoid the overhead of calculating centroids.
+  if (params.Has("centroids"))
+  {
+    arma::mat centroids;
+
+    h.Cluster(dataset, assignments, centroids);
+
+    params.Get<arma::mat>("centroids") = std::move(centroids);
+  }
+  else
+  {
+    h.Cluster(dataset, assignments);
+  }
+  timers.Stop("clustering");
+
+  if (params.Has("assignments"))
+    params.Get<arma::Row<size_t>>("assignments") = std::move(assignments);
+}
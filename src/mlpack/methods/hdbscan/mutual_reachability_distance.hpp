@@ -0,0 +1,92 @@
+/**
+ * @file methods/hdbscan/mutual_reachability_distance.hpp
+ *
+ * The mutual reachability distance used by HDBSCAN, evaluated on points that
+ * carry their core distance as an extra dimension.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_MUTUAL_REACHABILITY_DISTANCE_HPP
+#define MLPACK_METHODS_HDBSCAN_MUTUAL_REACHABILITY_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace hdbscan {
+
+/**
+ * The mutual reachability distance between two points a and b is
+ *
+ *   d_mreach(a, b) = max(core(a), core(b), d(a, b)),
+ *
+ * where d() is the underlying metric and core(x) is the distance from x to its
+ * k-th nearest neighbor.  A metric only sees the coordinates of the points, so
+ * this metric expects points whose last dimension holds their core distance;
+ * the underlying metric is evaluated on the other dimensions.
+ *
+ * When the underlying metric satisfies the triangle inequality and the core
+ * distances are non-negative, so does the mutual reachability distance, even
+ * for vectors that are not points of the dataset (like the center of a ball
+ * bound, whose core distance is the mean of that of its points).  So trees
+ * whose bounds only rely on the metric, like tree::BallTree, can be built on
+ * the augmented points, and dual-tree algorithms like emst::DualTreeBoruvka
+ * can use this metric.  Note that the distance of a point to itself is its
+ * core distance, and not zero.
+ *
+ * @tparam MetricType Underlying metric of the points.
+ */
+template<typename MetricType = metric::EuclideanDistance>
+class MutualReachabilityDistance
+{
+ public:
+  /**
+   * Construct the mutual reachability distance with the given underlying
+   * metric.
+   *
+   * @param metric Underlying metric of the points.
+   */
+  MutualReachabilityDistance(const MetricType metric = MetricType()) :
+      metric(metric)
+  { }
+
+  /**
+   * Evaluate the mutual reachability distance between two points, whose last
+   * dimension holds their core distance.
+   *
+   * @param a First point.
+   * @param b Second point.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  typename VecTypeA::elem_type Evaluate(const VecTypeA& a, const VecTypeB& b)
+  {
+    const size_t dims = a.n_elem - 1;
+    const typename VecTypeA::elem_type distance =
+        metric.Evaluate(a.head(dims), b.head(dims));
+    return std::max(distance, std::max(a[dims], b[dims]));
+  }
+
+  //! Get the underlying metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the underlying metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the metric.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(metric));
+  }
+
+ private:
+  //! The underlying metric.
+  MetricType metric;
+};
+
+} // namespace hdbscan
+} // namespace mlpack
+
+#endif
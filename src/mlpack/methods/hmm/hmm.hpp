@@ -290,6 +290,29 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are processed in
+   * parallel.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    observation sequence will be stored.
+   * @return Log-likelihood of the most probable state sequence of each
+   *    observation sequence.
+   */
+  arma::vec Predict(const std::vector<arma::mat>& dataSeq,
+                    std::vector<arma::Row<size_t>>& stateSeq) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are processed in parallel.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @return Log-likelihood of each of the given sequences.
+   */
+  arma::vec LogLikelihood(const std::vector<arma::mat>& dataSeq) const;
+
   /**
    * Compute the log of the scaling factor of the given emission probability
    * at time t. To calculate the log-likelihood for the whole sequence,
@@ -493,6 +516,18 @@ class HMM
                 arma::mat& backwardLogProb,
                 arma::mat& logProbs) const;
 
+  /**
+   * Compute the emission log-probabilities of each observation of the given
+   * sequence for each state, with one (batch) call to each distribution.  The
+   * returned matrix has rows equal to the number of observations and columns
+   * equal to the number of hidden states.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logProbs Matrix in which the log-probabilities will be saved.
+   */
+  void EmissionLogProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logProbs) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
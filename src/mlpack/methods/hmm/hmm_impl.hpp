@@ -113,11 +113,29 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
           << dimensionality << " dimensions)." << std::endl;
   }
 
+  // Bring the log-space parameters up to date before the sequences are
+  // processed in parallel, so that the threads only read them.
+  ConvertToLogSpace();
+
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // do not change between iterations, so the list of them is filled once;
+  // sequence seq starts at column offsets[seq].
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -133,70 +151,93 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The sequences are independent given the current model, so each thread
+    // accumulates the statistics of its own sequences, and these are summed
+    // (in log-space) at the end.
+    #pragma omp parallel
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      math::LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
-          newLogInitial);
-
-      // Define a variable to store the value of log-probability for data.
-      arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
-      // Save the values of log-probability to logProbs.
-      for (size_t i = 0; i < logTransition.n_rows; i++)
-      {
-        // Define alias of desired column.
-        arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-        // Use advanced constructor for using logProbs directly.
-        emission[i].LogProbability(dataSeq[seq], alias);
-      }
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec threadLogInitial(newLogInitial.n_elem);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat threadLogTransition(newLogTransition.n_rows,
+          newLogTransition.n_cols);
+      threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+      double threadLoglik = 0;
+
+      // Loop over each sequence.
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
-        // Assemble temporary vector that's used in log-sum computation.
-        if (t < dataSeq[seq].n_cols - 1)
+        const arma::mat& data = dataSeq[seq];
+
+        // The emission log-probabilities are computed once for the sequence,
+        // in one batch for each state, and used for both the E-step and the
+        // M-step.
+        arma::mat logProbs;
+        EmissionLogProbabilities(data, logProbs);
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+        Forward(data, logScales, forwardLog, logProbs);
+        Backward(data, logScales, backwardLog, logProbs);
+        arma::mat stateLogProb = forwardLog + backwardLog;
+        threadLoglik += accu(logScales);
+
+        // Add to estimate of initial probability for state j.
+        math::LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
+            threadLogInitial);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t < data.n_cols; ++t)
         {
-          // This term is the same across all states, so compute it once and
-          // cache it.
-          const arma::vec tmp = backwardLog.col(t + 1) +
-              logProbs.row(t + 1).t() - logScales[t + 1];
-          arma::vec output;
-          math::LogSumExp(tmp, output);
-
-          for (size_t j = 0; j < logTransition.n_cols; ++j)
+          // Assemble temporary vector that's used in log-sum computation.
+          if (t < data.n_cols - 1)
           {
-            // Compute the estimate of T_ij (probability of transition from
-            // state j to state i).  We postpone multiplication of the old T_ij
-            // until later.
-            arma::vec tmp2 = output + forwardLog(j, t);
-            arma::vec alias = newLogTransition.unsafe_col(j);
-            math::LogSumExp<arma::vec, true>(tmp2, alias);
+            // This term is the same across all states, so compute it once and
+            // cache it.
+            const arma::vec tmp = backwardLog.col(t + 1) +
+                logProbs.row(t + 1).t() - logScales[t + 1];
+            arma::vec output;
+            math::LogSumExp(tmp, output);
+
+            for (size_t j = 0; j < logTransition.n_cols; ++j)
+            {
+              // Compute the estimate of T_ij (probability of transition from
+              // state j to state i).  We postpone multiplication of the old
+              // T_ij until later.
+              arma::vec tmp2 = output + forwardLog(j, t);
+              arma::vec alias = threadLogTransition.unsafe_col(j);
+              math::LogSumExp<arma::vec, true>(tmp2, alias);
+            }
           }
+
+          // Add to list of emission weights, for Distribution::Train().  Each
+          // sequence has its own range of the list.
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
+            emissionProb[j][offsets[seq] + t] = exp(stateLogProb(j, t));
         }
+      }
 
-        // Add to list of emission observations, for Distribution::Train().
-        for (size_t j = 0; j < logTransition.n_cols; ++j)
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
-        emissionList.col(sumTime) = dataSeq[seq].col(t);
-        sumTime++;
+      #pragma omp critical
+      {
+        loglik += threadLoglik;
+        for (size_t i = 0; i < newLogInitial.n_elem; ++i)
+        {
+          newLogInitial[i] = math::LogAdd(newLogInitial[i],
+              threadLogInitial[i]);
+        }
+        for (size_t i = 0; i < newLogTransition.n_elem; ++i)
+        {
+          newLogTransition[i] = math::LogAdd(newLogTransition[i],
+              threadLogTransition[i]);
+        }
       }
     }
 
@@ -354,16 +395,8 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::mat& backwardLogProb,
                                       arma::vec& logScales) const
 {
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   // First run the forward-backward algorithm.
   Forward(dataSeq, logScales, forwardLogProb, logProbs);
@@ -496,42 +529,35 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 
   ConvertToLogSpace();
 
+  // The emission log-probabilities of every observation are computed in one
+  // batch for each state.
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
+  logStateProb.col(0) = logInitial + logProbs.row(0).t();
   for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
     stateSeqBack(state, 0) = state;
-  }
 
   // Store the best first state.
   arma::uword index;
 
-  // Define a variable to store the value of log-probability for dataSeq.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
-
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
+    // Assemble the state probability for this element.  Given that we are in
+    // state j, we use the state with the highest probability of being the
+    // previous state: element (j, i) of 'scores' is the log-probability of
+    // being in state i at time t - 1 and moving to state j.  The maximization
+    // over i is done for all j at once (a max-plus product).
+    const arma::mat scores = logTransition.each_row() +
+        logStateProb.col(t - 1).t();
+    const arma::uvec best = arma::index_max(scores, 1);
     for (size_t j = 0; j < logTransition.n_rows; j++)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) + logProbs(t, j);
-      stateSeqBack(j, t) = index;
+      logStateProb(j, t) = scores(j, best[j]) + logProbs(t, j);
+      stateSeqBack(j, t) = best[j];
     }
   }
 
@@ -547,6 +573,47 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
+/**
+ * Compute the most probable hidden state sequence of each of the given data
+ * sequences.
+ */
+template<typename Distribution>
+arma::vec HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                     std::vector<arma::Row<size_t>>& stateSeq)
+    const
+{
+  // Bring the log-space parameters up to date first, so that the threads only
+  // read them.
+  ConvertToLogSpace();
+
+  arma::vec logLikelihoods(dataSeq.size());
+  stateSeq.resize(dataSeq.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    logLikelihoods[i] = Predict(dataSeq[i], stateSeq[i]);
+
+  return logLikelihoods;
+}
+
+/**
+ * Compute the log-likelihood of each of the given data sequences.
+ */
+template<typename Distribution>
+arma::vec HMM<Distribution>::LogLikelihood(
+    const std::vector<arma::mat>& dataSeq) const
+{
+  // Bring the log-space parameters up to date first, so that the threads only
+  // read them.
+  ConvertToLogSpace();
+
+  arma::vec logLikelihoods(dataSeq.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    logLikelihoods[i] = LogLikelihood(dataSeq[i]);
+
+  return logLikelihoods;
+}
+
 /**
  * Compute the log-likelihood of the given data sequence.
  */
@@ -750,8 +817,8 @@ arma::vec HMM<Distribution>::ForwardAtTn(const arma::vec& emissionLogProb,
   // and emitting the given observation.  To do this computation in log-space,
   // we can use LogSumExp().
   arma::vec forwardLogProb;
-  arma::mat tmp = logTransition + repmat(prevForwardLogProb.t(),
-      logTransition.n_rows, 1);
+  arma::mat tmp = logTransition;
+  tmp.each_row() += prevForwardLogProb.t();
   math::LogSumExp(tmp, forwardLogProb);
   forwardLogProb += emissionLogProb;
 
@@ -817,9 +884,8 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
     // from the current state multiplied by the probability of each of those
     // states emitting the given observation.  To compute this in log-space, we
     // can use LogSumExpT().
-    const arma::mat tmp = logTransition +
-        repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
-        repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
+    arma::mat tmp = logTransition;
+    tmp.each_col() += backwardLogProb.col(t + 1) + logProbs.row(t + 1).t();
     arma::vec alias = backwardLogProb.unsafe_col(t);
     math::LogSumExpT<arma::mat, true>(tmp, alias);
 
@@ -829,6 +895,25 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * Compute the emission log-probabilities of each observation for each state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbabilities(const arma::mat& dataSeq,
+                                                 arma::mat& logProbs) const
+{
+  logProbs.set_size(dataSeq.n_cols, logTransition.n_rows);
+
+  // Save the values of log-probability to logProbs.
+  for (size_t i = 0; i < logTransition.n_rows; i++)
+  {
+    // Define alias of desired column.
+    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+    // Use advanced constructor for using logProbs directly.
+    emission[i].LogProbability(dataSeq, alias);
+  }
+}
+
 /**
  * Make sure the variables in log space are in sync with the linear
  * counterparts.
@@ -49,7 +49,14 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("input_model") + " parameter, and evaluates the "
     "log-likelihood of a sequence of observations, given with the " +
     PRINT_PARAM_STRING("input") + " parameter.  The computed log-likelihood is"
-    " given as output.");
+    " given as output."
+    "\n\n"
+    "Many sequences may be scored at once (and in parallel) by concatenating "
+    "their observations in " + PRINT_PARAM_STRING("input") + " and giving the "
+    "length of each sequence with the " + PRINT_PARAM_STRING("lengths") +
+    " parameter; the log-likelihood of each sequence is then given in " +
+    PRINT_PARAM_STRING("log_likelihoods") + ", and " +
+    PRINT_PARAM_STRING("log_likelihood") + " is their sum.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -71,7 +78,36 @@ BINDING_SEE_ALSO("mlpack::hmm::HMM class documentation",
 PARAM_MATRIX_IN_REQ("input", "File containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "File containing HMM.", "m");
 
+PARAM_UCOL_IN("lengths", "If given, the observations are the concatenation "
+    "of sequences with these lengths, and each is scored separately.", "l");
+
 PARAM_DOUBLE_OUT("log_likelihood", "Log-likelihood of the sequence.");
+PARAM_COL_OUT("log_likelihoods", "Log-likelihood of each sequence, if "
+    "'lengths' is given.", "L");
+
+// Split the columns of the given matrix into sequences of the given lengths.
+static void SplitSequences(const mat& data,
+                           const arma::Col<size_t>& lengths,
+                           vector<mat>& sequences)
+{
+  if (accu(lengths) != data.n_cols)
+  {
+    Log::Fatal << "The sequence lengths (" << accu(lengths) << " observations "
+        << "in total) do not match the number of observations ("
+        << data.n_cols << ")!" << endl;
+  }
+
+  sequences.resize(lengths.n_elem);
+  size_t begin = 0;
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+  {
+    if (lengths[i] == 0)
+      Log::Fatal << "Sequence " << i << " has length 0!" << endl;
+
+    sequences[i] = data.cols(begin, begin + lengths[i] - 1);
+    begin += lengths[i];
+  }
+}
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -99,6 +135,19 @@ struct Loglik
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
+    if (params.Has("lengths"))
+    {
+      // Score all the sequences at once.
+      vector<mat> sequences;
+      SplitSequences(dataSeq, params.Get<arma::Col<size_t>>("lengths"),
+          sequences);
+      const arma::vec logliks = hmm.LogLikelihood(sequences);
+
+      params.Get<double>("log_likelihood") = accu(logliks);
+      params.Get<arma::vec>("log_likelihoods") = logliks;
+      return;
+    }
+
     const double loglik = hmm.LogLikelihood(dataSeq);
 
     params.Get<double>("log_likelihood") = loglik;
@@ -51,7 +51,13 @@ BINDING_LONG_DESC(
     "hidden state sequence of a given sequence of observations (specified as "
     "'" + PRINT_PARAM_STRING("input") + ", using the Viterbi algorithm.  The "
     "computed state sequence may be saved using the " +
-    PRINT_PARAM_STRING("output") + " output parameter.");
+    PRINT_PARAM_STRING("output") + " output parameter."
+    "\n\n"
+    "Many sequences may be processed at once (and in parallel) by concatenating"
+    " their observations in " + PRINT_PARAM_STRING("input") + " and giving "
+    "the length of each sequence with the " + PRINT_PARAM_STRING("lengths") +
+    " parameter; " + PRINT_PARAM_STRING("output") + " then holds the "
+    "concatenated state sequences.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -74,8 +80,34 @@ BINDING_SEE_ALSO("mlpack::hmm::HMM class documentation",
 
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
+PARAM_UCOL_IN("lengths", "If given, the observations are the concatenation "
+    "of sequences with these lengths, and each is predicted separately.", "l");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
 
+// Split the columns of the given matrix into sequences of the given lengths.
+static void SplitSequences(const mat& data,
+                           const arma::Col<size_t>& lengths,
+                           vector<mat>& sequences)
+{
+  if (accu(lengths) != data.n_cols)
+  {
+    Log::Fatal << "The sequence lengths (" << accu(lengths) << " observations "
+        << "in total) do not match the number of observations ("
+        << data.n_cols << ")!" << endl;
+  }
+
+  sequences.resize(lengths.n_elem);
+  size_t begin = 0;
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+  {
+    if (lengths[i] == 0)
+      Log::Fatal << "Sequence " << i << " has length 0!" << endl;
+
+    sequences[i] = data.cols(begin, begin + lengths[i] - 1);
+    begin += lengths[i];
+  }
+}
+
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
 struct Viterbi
@@ -103,7 +135,28 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    if (params.Has("lengths"))
+    {
+      // Predict all the sequences at once.
+      vector<mat> sequences;
+      SplitSequences(dataSeq, params.Get<arma::Col<size_t>>("lengths"),
+          sequences);
+      vector<arma::Row<size_t>> stateSequences;
+      hmm.Predict(sequences, stateSequences);
+
+      sequence.set_size(dataSeq.n_cols);
+      size_t begin = 0;
+      for (size_t i = 0; i < stateSequences.size(); ++i)
+      {
+        sequence.cols(begin, begin + stateSequences[i].n_elem - 1) =
+            stateSequences[i];
+        begin += stateSequences[i].n_elem;
+      }
+    }
+    else
+    {
+      hmm.Predict(dataSeq, sequence);
+    }
 
     // Save output.
     params.Get<arma::Mat<size_t>>("output") = std::move(sequence);
@@ -0,0 +1,363 @@
+/**
+ * @file methods/hnsw/hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world (HNSW) graph, as described
+ * in the following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Y.A. and Yashunin, D.A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world graph on a
+ * reference set, and finds approximate nearest neighbors of query points by
+ * greedy search in the graph.  Each point is in the bottom layer of the
+ * graph, and in each layer above with probability 1 / MaxConnections(); in
+ * each layer, a point is linked to at most MaxConnections() close points (twice
+ * that in the bottom layer), chosen so that they lie in different directions.
+ * A search descends greedily from the top layer, and then explores the bottom
+ * layer with a list of the Ef() closest points found so far; a larger Ef()
+ * gives a better recall but a slower search.
+ *
+ * The graph is built with OpenMP, inserting the points in parallel; the links
+ * of each point are protected by a set of locks, so that points can be
+ * inserted while other insertions search the graph.  Insert() adds points to a
+ * trained graph in the same way.  Because of the parallel insertions, the
+ * graph (and so the approximate results) may change with the number of
+ * threads.  Searches are parallel over query points, and must not be run at
+ * the same time as insertions.
+ *
+ * Each thread keeps a list of the visited points while it builds the graph or
+ * searches, which takes two bytes per reference point.  For the Euclidean
+ * distance, the graph is built and searched with squared distances, which
+ * give the same order without a square root per evaluation.
+ *
+ * @tparam MetricType Metric to use for the search.
+ * @tparam MatType Type of matrix to use to store the data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Build the graph of the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxConnections Maximum number of links of each point in each layer
+   *     above the bottom one (the bottom layer allows twice that); must be at
+   *     least 2.
+   * @param efConstruction Size of the list of closest points used to find the
+   *     links of each inserted point.
+   * @param ef Size of the list of closest points explored by a search.  The
+   *     search always explores at least k points.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t maxConnections = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an HNSWSearch object without a reference set.  Train() must be
+   * called before searching.
+   *
+   * @param maxConnections Maximum number of links of each point in each layer
+   *     above the bottom one; must be at least 2.
+   * @param efConstruction Size of the list of closest points used to find the
+   *     links of each inserted point.
+   * @param ef Size of the list of closest points explored by a search.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(const size_t maxConnections = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  //! Copy the given HNSWSearch object.
+  HNSWSearch(const HNSWSearch& other);
+  //! Take ownership of the given HNSWSearch object.
+  HNSWSearch(HNSWSearch&& other);
+  //! Copy the given HNSWSearch object.
+  HNSWSearch& operator=(const HNSWSearch& other);
+  //! Take ownership of the given HNSWSearch object.
+  HNSWSearch& operator=(HNSWSearch&& other);
+
+  /**
+   * Build the graph of the given reference set, replacing the current one.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Add the given points to the reference set and to the graph.  The new
+   * points are inserted in parallel; their indices follow those of the
+   * current reference points.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Find the approximate k nearest neighbors of each point of the query set,
+   * in parallel over the query points.  If fewer than k neighbors are found,
+   * the rest of the results are filled with SIZE_MAX and DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Find the approximate k nearest neighbors of each point of the reference
+   * set, not counting the point itself.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the maximum number of links of each point in the upper layers.
+  size_t MaxConnections() const { return maxConnections; }
+
+  //! Get the size of the list of closest points used to insert points.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the size of the list of closest points used to insert points.
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Get the size of the list of closest points explored by a search.
+  size_t Ef() const { return ef; }
+  //! Modify the size of the list of closest points explored by a search.
+  size_t& Ef() { return ef; }
+
+  //! Get the index of the top layer of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the HNSWSearch object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  //! A point of the graph and its distance to the point being searched for.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * The set of points visited by one search.  Each point stores the tag of the
+   * last search that visited it, so that the set can be cleared in constant
+   * time between searches.
+   */
+  class VisitedSet
+  {
+   public:
+    //! Create the set for the given number of points.
+    VisitedSet(const size_t size) : tags(size, 0), tag(0) { }
+
+    //! Clear the set.
+    void Reset()
+    {
+      if (++tag == 0)
+      {
+        std::fill(tags.begin(), tags.end(), 0);
+        tag = 1;
+      }
+    }
+
+    //! Mark the given point as visited; returns false if it already was.
+    bool Visit(const size_t point)
+    {
+      if (tags[point] == tag)
+        return false;
+      tags[point] = tag;
+      return true;
+    }
+
+   private:
+    //! The tag of the last search that visited each point.
+    std::vector<uint16_t> tags;
+    //! The tag of the current search.
+    uint16_t tag;
+  };
+
+  /**
+   * Draw the levels of the points starting at the given index, and insert
+   * them in the graph in parallel.
+   *
+   * @param begin Index of the first point to insert.
+   */
+  void InsertPoints(const size_t begin);
+
+  /**
+   * Insert a point in the graph.  Its level must already be drawn.
+   *
+   * @param point Index of the point to insert.
+   * @param visited Visited set of the calling thread.
+   */
+  void InsertPoint(const size_t point, VisitedSet& visited);
+
+  /**
+   * Find the approximate nearest neighbors of a point, skipping the given
+   * reference point (or none if exclude is SIZE_MAX).
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t k,
+                   const size_t exclude,
+                   VisitedSet& visited,
+                   std::vector<Candidate>& results);
+
+  /**
+   * Move greedily from the given point to the closest point to the query in
+   * the given layer.
+   */
+  template<typename VecType>
+  size_t GreedySearch(const VecType& query,
+                      size_t entry,
+                      const size_t layer,
+                      const bool lock);
+
+  /**
+   * Find the listSize closest points to the query in the given layer, starting
+   * from the given points.  The results are sorted by increasing distance.
+   */
+  template<typename VecType>
+  void SearchLayer(const VecType& query,
+                   const std::vector<Candidate>& entries,
+                   const size_t listSize,
+                   const size_t layer,
+                   VisitedSet& visited,
+                   const bool lock,
+                   std::vector<Candidate>& results);
+
+  /**
+   * Keep at most m of the given candidates, sorted by increasing distance,
+   * skipping those that are closer to a kept candidate than to the point
+   * they are linked from.
+   */
+  void SelectNeighbors(std::vector<Candidate>& candidates, const size_t m);
+
+  /**
+   * Link the given node to a new neighbor in the given layer, pruning its
+   * links if there are too many.
+   */
+  void AddLink(const size_t node,
+               const size_t layer,
+               const size_t neighbor,
+               const double distance);
+
+  //! Copy the links of a node in the given layer, locking it if requested.
+  void CopyLinks(const size_t node,
+                 const size_t layer,
+                 const bool lock,
+                 std::vector<size_t>& links);
+
+  //! Get the link list of a node in a layer: its length, then the links.
+  size_t* Links(const size_t node, const size_t layer)
+  {
+    return (layer == 0) ? baseLinks.colptr(node) :
+        upperLinks[node].data() + (layer - 1) * (maxConnections + 1);
+  }
+
+  //! Get the maximum number of links of each point in a layer.
+  size_t MaxLinks(const size_t layer) const
+  {
+    return (layer == 0) ? 2 * maxConnections : maxConnections;
+  }
+
+  //! Get the lock that protects the links of a node.
+  std::mutex& Lock(const size_t node) { return locks[node % locks.size()]; }
+
+  //! Evaluate the distance used to build and search the graph.
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b);
+
+  //! Whether the squared distance is used instead of the Euclidean distance.
+  static constexpr bool UseSquaredDistance =
+      std::is_same<MetricType, metric::EuclideanDistance>::value;
+
+  //! Number of locks protecting the links of the nodes.
+  static constexpr size_t NumLocks = 4096;
+
+  //! The reference set.
+  MatType referenceSet;
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! Maximum number of links of each point in the upper layers.
+  size_t maxConnections;
+  //! Size of the list of closest points used to insert points.
+  size_t efConstruction;
+  //! Size of the list of closest points explored by a search.
+  size_t ef;
+
+  //! The top layer of each point.
+  std::vector<size_t> levels;
+  //! The links of each point in the bottom layer: the number of links, then
+  //! the links.
+  arma::Mat<size_t> baseLinks;
+  //! The links of each point in the layers above the bottom one.
+  std::vector<std::vector<size_t>> upperLinks;
+
+  //! The point the searches start from, in the top layer.
+  size_t entryPoint;
+  //! The index of the top layer.
+  size_t maxLevel;
+
+  //! The locks protecting the links of the nodes during insertions.
+  std::vector<std::mutex> locks;
+  //! The lock protecting the entry point during insertions.
+  std::mutex entryLock;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,568 @@
+/**
+ * @file methods/hnsw/hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSetIn,
+                                            const size_t maxConnections,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    HNSWSearch(maxConnections, efConstruction, ef, metric)
+{
+  Train(std::move(referenceSetIn));
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t maxConnections,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    metric(metric),
+    maxConnections(maxConnections),
+    efConstruction(efConstruction),
+    ef(ef),
+    entryPoint(0),
+    maxLevel(0),
+    locks(NumLocks)
+{
+  if (maxConnections < 2)
+  {
+    Log::Fatal << "HNSWSearch::HNSWSearch(): maxConnections must be at least "
+        << "2 (given " << maxConnections << ")!" << std::endl;
+  }
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const HNSWSearch& other) :
+    referenceSet(other.referenceSet),
+    metric(other.metric),
+    maxConnections(other.maxConnections),
+    efConstruction(other.efConstruction),
+    ef(other.ef),
+    levels(other.levels),
+    baseLinks(other.baseLinks),
+    upperLinks(other.upperLinks),
+    entryPoint(other.entryPoint),
+    maxLevel(other.maxLevel),
+    locks(NumLocks)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(HNSWSearch&& other) :
+    referenceSet(std::move(other.referenceSet)),
+    metric(std::move(other.metric)),
+    maxConnections(other.maxConnections),
+    efConstruction(other.efConstruction),
+    ef(other.ef),
+    levels(std::move(other.levels)),
+    baseLinks(std::move(other.baseLinks)),
+    upperLinks(std::move(other.upperLinks)),
+    entryPoint(other.entryPoint),
+    maxLevel(other.maxLevel),
+    locks(NumLocks)
+{
+  // Reset the other object.
+  other.entryPoint = 0;
+  other.maxLevel = 0;
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>&
+HNSWSearch<MetricType, MatType>::operator=(const HNSWSearch& other)
+{
+  if (this != &other)
+  {
+    referenceSet = other.referenceSet;
+    metric = other.metric;
+    maxConnections = other.maxConnections;
+    efConstruction = other.efConstruction;
+    ef = other.ef;
+    levels = other.levels;
+    baseLinks = other.baseLinks;
+    upperLinks = other.upperLinks;
+    entryPoint = other.entryPoint;
+    maxLevel = other.maxLevel;
+  }
+
+  return *this;
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>&
+HNSWSearch<MetricType, MatType>::operator=(HNSWSearch&& other)
+{
+  if (this != &other)
+  {
+    referenceSet = std::move(other.referenceSet);
+    metric = std::move(other.metric);
+    maxConnections = other.maxConnections;
+    efConstruction = other.efConstruction;
+    ef = other.ef;
+    levels = std::move(other.levels);
+    baseLinks = std::move(other.baseLinks);
+    upperLinks = std::move(other.upperLinks);
+    entryPoint = other.entryPoint;
+    maxLevel = other.maxLevel;
+
+    // Reset the other object.
+    other.entryPoint = 0;
+    other.maxLevel = 0;
+  }
+
+  return *this;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+  levels.clear();
+  upperLinks.clear();
+  baseLinks.reset();
+  entryPoint = 0;
+  maxLevel = 0;
+
+  InsertPoints(0);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Insert(const MatType& points)
+{
+  if (referenceSet.n_cols == 0)
+  {
+    Train(points);
+    return;
+  }
+
+  if (points.n_rows != referenceSet.n_rows)
+  {
+    Log::Fatal << "HNSWSearch::Insert(): dimensionality of points ("
+        << points.n_rows << ") does not match the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!" << std::endl;
+  }
+
+  const size_t begin = referenceSet.n_cols;
+  referenceSet.insert_cols(begin, points);
+  InsertPoints(begin);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertPoints(const size_t begin)
+{
+  const size_t n = referenceSet.n_cols;
+  if (begin == n)
+    return;
+
+  // Draw the levels serially, since the random number generator is not
+  // thread-safe.  Each point goes up a layer with probability 1 / M.
+  const double levelMultiplier = 1.0 / std::log((double) maxConnections);
+  levels.resize(n);
+  upperLinks.resize(n);
+  for (size_t i = begin; i < n; ++i)
+  {
+    levels[i] = (size_t) (-std::log(1.0 - math::Random()) * levelMultiplier);
+    upperLinks[i].assign(levels[i] * (maxConnections + 1), 0);
+  }
+
+  baseLinks.resize(2 * maxConnections + 1, n);
+  baseLinks.cols(begin, n - 1).zeros();
+
+  // The first point of an empty graph is its entry point.
+  size_t first = begin;
+  if (begin == 0)
+  {
+    entryPoint = 0;
+    maxLevel = levels[0];
+    first = 1;
+  }
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(n);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = (omp_size_t) first; i < (omp_size_t) n; ++i)
+      InsertPoint(i, visited);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertPoint(const size_t point,
+                                                  VisitedSet& visited)
+{
+  const size_t level = levels[point];
+
+  // A point that goes above the top layer becomes the new entry point; the
+  // other insertions have to wait until it is linked.
+  std::unique_lock<std::mutex> entryGuard(entryLock);
+  size_t entry = entryPoint;
+  const size_t topLevel = maxLevel;
+  if (level <= topLevel)
+    entryGuard.unlock();
+
+  const auto query = referenceSet.col(point);
+  for (size_t l = topLevel; l > level; --l)
+    entry = GreedySearch(query, entry, l, true);
+
+  std::vector<Candidate> entries(1, Candidate(Evaluate(query,
+      referenceSet.col(entry)), entry));
+  std::vector<Candidate> candidates;
+  for (size_t l = std::min(level, topLevel) + 1; l > 0; --l)
+  {
+    const size_t layer = l - 1;
+    SearchLayer(query, entries, efConstruction, layer, visited, true,
+        candidates);
+    entries = candidates;
+    SelectNeighbors(candidates, maxConnections);
+
+    {
+      std::lock_guard<std::mutex> guard(Lock(point));
+      size_t* links = Links(point, layer);
+      links[0] = candidates.size();
+      for (size_t j = 0; j < candidates.size(); ++j)
+        links[j + 1] = candidates[j].second;
+    }
+
+    for (size_t j = 0; j < candidates.size(); ++j)
+      AddLink(candidates[j].second, layer, point, candidates[j].first);
+  }
+
+  if (level > topLevel)
+  {
+    entryPoint = point;
+    maxLevel = level;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k > referenceSet.n_cols)
+  {
+    Log::Fatal << "HNSWSearch::Search(): requested " << k << " neighbors, but "
+        << "the reference set has only " << referenceSet.n_cols << " points!"
+        << std::endl;
+  }
+
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    Log::Fatal << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") does not match the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!" << std::endl;
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(referenceSet.n_cols);
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      SearchPoint(querySet.col(q), k, SIZE_MAX, visited, results);
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, q) = (j < results.size()) ? results[j].second : SIZE_MAX;
+        distances(j, q) = (j < results.size()) ? results[j].first : DBL_MAX;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k >= referenceSet.n_cols)
+  {
+    Log::Fatal << "HNSWSearch::Search(): requested " << k << " neighbors, but "
+        << "the reference set has only " << referenceSet.n_cols << " points, "
+        << "including the query point!" << std::endl;
+  }
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(referenceSet.n_cols);
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) referenceSet.n_cols; ++q)
+    {
+      SearchPoint(referenceSet.col(q), k, q, visited, results);
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, q) = (j < results.size()) ? results[j].second : SIZE_MAX;
+        distances(j, q) = (j < results.size()) ? results[j].first : DBL_MAX;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchPoint(
+    const VecType& query,
+    const size_t k,
+    const size_t exclude,
+    VisitedSet& visited,
+    std::vector<Candidate>& results)
+{
+  size_t entry = entryPoint;
+  for (size_t l = maxLevel; l > 0; --l)
+    entry = GreedySearch(query, entry, l, false);
+
+  std::vector<Candidate> entries(1, Candidate(Evaluate(query,
+      referenceSet.col(entry)), entry));
+  const size_t searchSize = std::max(ef, k + (exclude == SIZE_MAX ? 0 : 1));
+  SearchLayer(query, entries, searchSize, 0, visited, false, results);
+
+  if (exclude != SIZE_MAX)
+  {
+    results.erase(std::remove_if(results.begin(), results.end(),
+        [exclude](const Candidate& c) { return c.second == exclude; }),
+        results.end());
+  }
+
+  if (results.size() > k)
+    results.resize(k);
+
+  if (UseSquaredDistance)
+  {
+    for (size_t j = 0; j < results.size(); ++j)
+      results[j].first = std::sqrt(results[j].first);
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+size_t HNSWSearch<MetricType, MatType>::GreedySearch(const VecType& query,
+                                                     size_t entry,
+                                                     const size_t layer,
+                                                     const bool lock)
+{
+  double bestDistance = Evaluate(query, referenceSet.col(entry));
+  std::vector<size_t> links;
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    CopyLinks(entry, layer, lock, links);
+    for (size_t j = 0; j < links.size(); ++j)
+    {
+      const double distance = Evaluate(query, referenceSet.col(links[j]));
+      if (distance < bestDistance)
+      {
+        bestDistance = distance;
+        entry = links[j];
+        changed = true;
+      }
+    }
+  }
+
+  return entry;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLayer(
+    const VecType& query,
+    const std::vector<Candidate>& entries,
+    const size_t listSize,
+    const size_t layer,
+    VisitedSet& visited,
+    const bool lock,
+    std::vector<Candidate>& results)
+{
+  visited.Reset();
+
+  // The points left to expand, closest first, and the listSize closest points
+  // found so far, furthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate> best;
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    visited.Visit(entries[i].second);
+    candidates.push(entries[i]);
+    best.push(entries[i]);
+    if (best.size() > listSize)
+      best.pop();
+  }
+
+  std::vector<size_t> links;
+  while (!candidates.empty())
+  {
+    const Candidate current = candidates.top();
+    if (best.size() >= listSize && current.first > best.top().first)
+      break;
+    candidates.pop();
+
+    CopyLinks(current.second, layer, lock, links);
+    for (size_t j = 0; j < links.size(); ++j)
+    {
+      if (!visited.Visit(links[j]))
+        continue;
+
+      const double distance = Evaluate(query, referenceSet.col(links[j]));
+      if (best.size() < listSize || distance < best.top().first)
+      {
+        candidates.push(Candidate(distance, links[j]));
+        best.push(Candidate(distance, links[j]));
+        if (best.size() > listSize)
+          best.pop();
+      }
+    }
+  }
+
+  results.resize(best.size());
+  for (size_t i = results.size(); i > 0; --i)
+  {
+    results[i - 1] = best.top();
+    best.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    std::vector<Candidate>& candidates,
+    const size_t m)
+{
+  if (candidates.size() <= m)
+    return;
+
+  std::vector<Candidate> selected;
+  selected.reserve(m);
+  for (size_t i = 0; i < candidates.size() && selected.size() < m; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      if (Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j].second)) < candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidates[i]);
+  }
+
+  candidates = std::move(selected);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::AddLink(const size_t node,
+                                              const size_t layer,
+                                              const size_t neighbor,
+                                              const double distance)
+{
+  std::lock_guard<std::mutex> guard(Lock(node));
+  size_t* links = Links(node, layer);
+  const size_t maxLinks = MaxLinks(layer);
+  if (links[0] < maxLinks)
+  {
+    links[links[0] + 1] = neighbor;
+    ++links[0];
+    return;
+  }
+
+  // The node has too many links, so select them again among its current links
+  // and the new one.
+  std::vector<Candidate> candidates;
+  candidates.reserve(maxLinks + 1);
+  candidates.push_back(Candidate(distance, neighbor));
+  for (size_t j = 1; j <= maxLinks; ++j)
+  {
+    candidates.push_back(Candidate(Evaluate(referenceSet.col(node),
+        referenceSet.col(links[j])), links[j]));
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  SelectNeighbors(candidates, maxLinks);
+  links[0] = candidates.size();
+  for (size_t j = 0; j < candidates.size(); ++j)
+    links[j + 1] = candidates[j].second;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::CopyLinks(const size_t node,
+                                                const size_t layer,
+                                                const bool lock,
+                                                std::vector<size_t>& links)
+{
+  std::unique_lock<std::mutex> guard(Lock(node), std::defer_lock);
+  if (lock)
+    guard.lock();
+
+  const size_t* nodeLinks = Links(node, layer);
+  links.assign(nodeLinks + 1, nodeLinks + 1 + nodeLinks[0]);
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecTypeA, typename VecTypeB>
+double HNSWSearch<MetricType, MatType>::Evaluate(const VecTypeA& a,
+                                                 const VecTypeB& b)
+{
+  if (UseSquaredDistance)
+    return metric::SquaredEuclideanDistance::Evaluate(a, b);
+  else
+    return metric.Evaluate(a, b);
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(Archive& ar,
+                                                const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(metric));
+  ar(CEREAL_NVP(maxConnections));
+  ar(CEREAL_NVP(efConstruction));
+  ar(CEREAL_NVP(ef));
+  ar(CEREAL_NVP(levels));
+  ar(CEREAL_NVP(baseLinks));
+  ar(CEREAL_NVP(upperLinks));
+  ar(CEREAL_NVP(entryPoint));
+  ar(CEREAL_NVP(maxLevel));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -106,6 +106,15 @@ class BinaryNumericSplit
   //! The probability of the majority class given the points seen so far.
   double MajorityProbability() const;
 
+  //! Get the memory used by the statistics, in bytes (counting about four
+  //! pointers of overhead for each node of the map).
+  size_t MemoryUsage() const
+  {
+    return sizeof(BinaryNumericSplit) + sortedElements.size() *
+        (sizeof(std::pair<ObservationType, size_t>) + 4 * sizeof(void*)) +
+        classCounts.n_elem * sizeof(size_t);
+  }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
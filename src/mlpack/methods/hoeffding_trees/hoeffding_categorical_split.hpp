@@ -106,6 +106,13 @@ class HoeffdingCategoricalSplit
   //! Get the probability of the majority class given the points seen so far.
   double MajorityProbability() const;
 
+  //! Get the memory used by the statistics, in bytes.
+  size_t MemoryUsage() const
+  {
+    return sizeof(HoeffdingCategoricalSplit) +
+        sufficientStatistics.n_elem * sizeof(size_t);
+  }
+
   //! Serialize the categorical split.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
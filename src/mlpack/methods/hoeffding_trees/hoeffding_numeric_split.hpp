@@ -119,6 +119,15 @@ class HoeffdingNumericSplit
   //! Return the number of bins.
   size_t Bins() const { return bins; }
 
+  //! Get the memory used by the statistics, in bytes.
+  size_t MemoryUsage() const
+  {
+    return sizeof(HoeffdingNumericSplit) +
+        observations.n_elem * sizeof(ObservationType) +
+        splitPoints.n_elem * sizeof(ObservationType) +
+        (labels.n_elem + sufficientStatistics.n_elem) * sizeof(size_t);
+  }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
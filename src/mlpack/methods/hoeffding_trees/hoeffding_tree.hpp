@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/data/dataset_mapper.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include "gini_impurity.hpp"
 #include "hoeffding_numeric_split.hpp"
 #include "hoeffding_categorical_split.hpp"
@@ -48,6 +49,20 @@ namespace tree {
  * categorical attributes are handled.  As far as the actual splitting goes,
  * the meat of the splitting procedure will be contained in those two classes.
  *
+ * The split statistics of the leaves take memory that grows with the number of
+ * leaves (and, for some split types, with the number of points).  With a
+ * MemoryBudget(), the statistics are bounded in streaming training: every
+ * CheckInterval() points, the leaves are ranked by promise (the number of
+ * points they saw that were not of their majority class at the time), and if
+ * the statistics take more than the budget, only as many of the most promising
+ * leaves as fit in the budget (at the average memory of an active leaf) stay
+ * active.  The other leaves are deactivated: their statistics are freed, and
+ * they keep predicting their majority class, but they only count the points
+ * they see, until they are promising enough to be reactivated with empty
+ * statistics.  Numeric splits whose memory is bounded, like
+ * QuantileNumericSplit, keep the memory per leaf small, so that more leaves
+ * stay active.
+ *
  * @tparam FitnessFunction Fitness function to use.
  * @tparam NumericSplitType Technique for splitting numeric features.
  * @tparam CategoricalSplitType Technique for splitting categorical features.
@@ -237,6 +252,24 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a minibatch of points in streaming mode, with the given labels.
+   * The tree will not be reset before training.  The points are first routed to
+   * the leaves they reach, and then the statistics of each dimension of each
+   * leaf are updated in parallel with OpenMP, in the order of the points.
+   *
+   * This is equivalent to calling Train(point, label) on each point in turn,
+   * except that each leaf checks for a split only once, after all of the points
+   * of the minibatch that reach it (if that took it past a multiple of
+   * CheckInterval() points).  So, if the minibatches are CheckInterval() points
+   * long, the tree is the same as if it had been trained point by point.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   */
+  template<typename MatType>
+  void TrainMinibatch(const MatType& data, const arma::Row<size_t>& labels);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -285,6 +318,35 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the memory budget of the split statistics of the leaves, in bytes (0
+  //! if there is no budget).
+  size_t MemoryBudget() const { return memoryBudget; }
+  /**
+   * Set the memory budget of the split statistics of the leaves of this node,
+   * in bytes (0 for no budget).  The budget is enforced every CheckInterval()
+   * points given to this node in streaming training (that is, to
+   * Train(point, label), TrainMinibatch(), or Train() without batch training);
+   * it should be set on the root of the tree.
+   */
+  void MemoryBudget(const size_t memoryBudget);
+
+  //! Get whether this node collects split statistics (false for the leaves
+  //! deactivated by the memory budget).
+  bool IsActive() const { return active; }
+
+  /**
+   * Get the (estimated) memory used by the split statistics of this node and
+   * all of its descendants, in bytes.
+   */
+  size_t MemoryUsage() const;
+
+  /**
+   * Enforce the memory budget on the leaves of this node now: if needed,
+   * deactivate the least promising leaves, or reactivate the most promising
+   * inactive leaves.  This does nothing if there is no budget.
+   */
+  void EnforceMemoryBudget();
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -404,6 +466,16 @@ class HoeffdingTree
   //! If the split has occurred, these are the children.
   std::vector<HoeffdingTree*> children;
 
+  //! Whether the leaf collects split statistics.
+  bool active;
+  //! The number of training points the leaf saw that were not of its majority
+  //! class at the time (its promise for the memory budget).
+  size_t numMistakes;
+  //! The memory budget of the split statistics of the leaves, in bytes.
+  size_t memoryBudget;
+  //! The number of samples since the memory budget was last enforced.
+  size_t samplesSinceMemoryCheck;
+
   /**
    * Perform training (typically after a reset, but not necessarily).  This
    * assumes datasetInfo and dimensionMappings are set correctly.
@@ -413,6 +485,22 @@ class HoeffdingTree
                      const arma::Row<size_t>& labels,
                      const bool batchTraining);
 
+  //! Take the majority class of the node from its split statistics.
+  void UpdateMajorityClass();
+
+  //! Get the memory used by the split statistics of this node only.
+  size_t LeafMemoryUsage() const;
+
+  /**
+   * Create empty split statistics for this (inactive) leaf, with the
+   * parameters of the given splits, and start collecting statistics again.
+   */
+  void Activate(const CategoricalSplitType<FitnessFunction>& categoricalSplitIn,
+                const NumericSplitType<FitnessFunction>& numericSplitIn);
+
+  //! Free the split statistics of this leaf, and stop collecting statistics.
+  void Deactivate();
+
   /**
    * Reset the tree.  This assumes datasetInfo is set correctly.
    */
@@ -19,6 +19,30 @@
 namespace mlpack {
 namespace tree {
 
+namespace details {
+
+HAS_MEM_FUNC(MemoryUsage, HasMemoryUsage);
+
+//! Get the memory used by the given split statistics, in bytes.
+template<typename SplitType>
+typename std::enable_if<HasMemoryUsage<SplitType,
+    size_t(SplitType::*)() const>::value, size_t>::type
+SplitMemoryUsage(const SplitType& split)
+{
+  return split.MemoryUsage();
+}
+
+//! Split types without a MemoryUsage() method only count their own size.
+template<typename SplitType>
+typename std::enable_if<!HasMemoryUsage<SplitType,
+    size_t(SplitType::*)() const>::value, size_t>::type
+SplitMemoryUsage(const SplitType& /* split */)
+{
+  return sizeof(SplitType);
+}
+
+} // namespace details
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
@@ -53,7 +77,11 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    active(true),
+    numMistakes(0),
+    memoryBudget(0),
+    samplesSinceMemoryCheck(0)
 {
   // Reset the tree.
   ResetTree(categoricalSplitIn, numericSplitIn);
@@ -97,7 +125,11 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    active(true),
+    numMistakes(0),
+    memoryBudget(0),
+    samplesSinceMemoryCheck(0)
 {
   // Do we need to generate the mappings too?
   if (ownsMappings)
@@ -145,7 +177,11 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    active(true),
+    numMistakes(0),
+    memoryBudget(0),
+    samplesSinceMemoryCheck(0)
 {
   // Nothing to do.
 }
@@ -173,7 +209,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
     categoricalSplit(other.categoricalSplit),
-    numericSplit(other.numericSplit)
+    numericSplit(other.numericSplit),
+    active(other.active),
+    numMistakes(other.numMistakes),
+    memoryBudget(other.memoryBudget),
+    samplesSinceMemoryCheck(0)
 {
   // Copy each of the children.
   for (size_t i = 0; i < other.children.size(); ++i)
@@ -213,7 +253,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
     categoricalSplit(std::move(other.categoricalSplit)),
-    numericSplit(std::move(other.numericSplit))
+    numericSplit(std::move(other.numericSplit)),
+    active(other.active),
+    numMistakes(other.numMistakes),
+    memoryBudget(other.memoryBudget),
+    samplesSinceMemoryCheck(other.samplesSinceMemoryCheck)
 {
   // Remove pointers.
   other.dimensionMappings = nullptr;
@@ -258,6 +302,10 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>&
     majorityProbability = other.majorityProbability;
     categoricalSplit = other.categoricalSplit;
     numericSplit = other.numericSplit;
+    active = other.active;
+    numMistakes = other.numMistakes;
+    memoryBudget = other.memoryBudget;
+    samplesSinceMemoryCheck = 0;
 
     // Copy each of the children.
     for (size_t i = 0; i < other.children.size(); ++i)
@@ -304,6 +352,10 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>&
     majorityProbability = other.majorityProbability;
     categoricalSplit = std::move(other.categoricalSplit);
     numericSplit = std::move(other.numericSplit);
+    active = other.active;
+    numMistakes = other.numMistakes;
+    memoryBudget = other.memoryBudget;
+    samplesSinceMemoryCheck = other.samplesSinceMemoryCheck;
 
     // Remove pointers.
     other.dimensionMappings = nullptr;
@@ -413,7 +465,15 @@ void HoeffdingTree<
     CategoricalSplitType
 >::Train(const VecType& point, const size_t label)
 {
-  if (splitDimension == size_t(-1))
+  if (splitDimension == size_t(-1) && label != majorityClass)
+    ++numMistakes;
+
+  if (splitDimension == size_t(-1) && !active)
+  {
+    // The leaf was deactivated by the memory budget, so only count the point.
+    ++numSamples;
+  }
+  else if (splitDimension == size_t(-1))
   {
     ++numSamples;
     size_t numericIndex = 0;
@@ -426,17 +486,7 @@ void HoeffdingTree<
         numericSplits[numericIndex++].Train(point[i], label);
     }
 
-    // Grab majority class from splits.
-    if (categoricalSplits.size() > 0)
-    {
-      majorityClass = categoricalSplits[0].MajorityClass();
-      majorityProbability = categoricalSplits[0].MajorityProbability();
-    }
-    else
-    {
-      majorityClass = numericSplits[0].MajorityClass();
-      majorityProbability = numericSplits[0].MajorityProbability();
-    }
+    UpdateMajorityClass();
 
     // Check for a split, if we should.
     if (numSamples % checkInterval == 0)
@@ -457,6 +507,121 @@ void HoeffdingTree<
     size_t direction = CalculateDirection(point);
     children[direction]->Train(point, label);
   }
+
+  if (memoryBudget > 0 && ++samplesSinceMemoryCheck >= checkInterval)
+    EnforceMemoryBudget();
+}
+
+//! Train on a minibatch of points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainMinibatch(const MatType& data,
+                  const arma::Row<size_t>& labels)
+{
+  util::CheckSameSizes(data, labels, "HoeffdingTree::TrainMinibatch()");
+  if (data.n_rows != datasetInfo->Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingTree::TrainMinibatch(): dataset has " << data.n_rows
+        << " dimensions, but the tree has " << datasetInfo->Dimensionality();
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Route each point to the leaf it reaches.
+  std::vector<HoeffdingTree*> pointLeaves(data.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    HoeffdingTree* node = this;
+    while (node->splitDimension != size_t(-1))
+      node = node->children[node->CalculateDirection(data.col(i))];
+    pointLeaves[i] = node;
+  }
+
+  // Group the points by leaf, keeping their order.
+  std::vector<HoeffdingTree*> leaves;
+  std::vector<std::vector<size_t>> leafPoints;
+  std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    auto it = leafIndices.find(pointLeaves[i]);
+    if (it == leafIndices.end())
+    {
+      it = leafIndices.emplace(pointLeaves[i], leaves.size()).first;
+      leaves.push_back(pointLeaves[i]);
+      leafPoints.push_back(std::vector<size_t>());
+    }
+    leafPoints[it->second].push_back(i);
+  }
+
+  // The statistics of each dimension of each leaf are independent, so each
+  // (leaf, dimension) pair can be updated by a different thread.
+  const size_t dims = data.n_rows;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t w = 0; w < (omp_size_t) (leaves.size() * dims); ++w)
+  {
+    HoeffdingTree& leaf = *leaves[w / dims];
+    if (!leaf.active)
+      continue;
+
+    const std::vector<size_t>& points = leafPoints[w / dims];
+    const size_t d = w % dims;
+    const size_t type = leaf.dimensionMappings->at(d).first;
+    const size_t index = leaf.dimensionMappings->at(d).second;
+    if (type == data::Datatype::categorical)
+    {
+      for (size_t i = 0; i < points.size(); ++i)
+      {
+        leaf.categoricalSplits[index].Train(data(d, points[i]),
+            labels[points[i]]);
+      }
+    }
+    else if (type == data::Datatype::numeric)
+    {
+      for (size_t i = 0; i < points.size(); ++i)
+        leaf.numericSplits[index].Train(data(d, points[i]), labels[points[i]]);
+    }
+  }
+
+  // Now check each leaf for a split, once.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t l = 0; l < (omp_size_t) leaves.size(); ++l)
+  {
+    HoeffdingTree& leaf = *leaves[l];
+    const size_t oldNumSamples = leaf.numSamples;
+    leaf.numSamples += leafPoints[l].size();
+    for (size_t i = 0; i < leafPoints[l].size(); ++i)
+      if (labels[leafPoints[l][i]] != leaf.majorityClass)
+        ++leaf.numMistakes;
+    if (!leaf.active)
+      continue;
+
+    leaf.UpdateMajorityClass();
+
+    if (leaf.numSamples / leaf.checkInterval !=
+        oldNumSamples / leaf.checkInterval)
+    {
+      const size_t numChildren = leaf.SplitCheck();
+      if (numChildren > 0)
+      {
+        leaf.children.clear();
+        leaf.CreateChildren();
+      }
+    }
+  }
+
+  if (memoryBudget > 0)
+  {
+    samplesSinceMemoryCheck += data.n_cols;
+    if (samplesSinceMemoryCheck >= checkInterval)
+      EnforceMemoryBudget();
+  }
 }
 
 template<typename FitnessFunction,
@@ -468,8 +633,8 @@ size_t HoeffdingTree<
     CategoricalSplitType
 >::SplitCheck()
 {
-  // Do nothing if we've already split.
-  if (splitDimension != size_t(-1))
+  // Do nothing if we've already split, or if we have no statistics.
+  if (splitDimension != size_t(-1) || !active)
     return 0;
 
   // If not enough points have been seen, we cannot split.
@@ -612,6 +777,136 @@ void HoeffdingTree<
     children[i]->CheckInterval(checkInterval);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MemoryBudget(const size_t memoryBudget)
+{
+  this->memoryBudget = memoryBudget;
+  samplesSinceMemoryCheck = 0;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MemoryUsage() const
+{
+  size_t memory = 0;
+  std::stack<const HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    const HoeffdingTree* node = stack.top();
+    stack.pop();
+    memory += node->LeafMemoryUsage();
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+  }
+
+  return memory;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::EnforceMemoryBudget()
+{
+  samplesSinceMemoryCheck = 0;
+  if (memoryBudget == 0)
+    return;
+
+  // Collect the leaves, and the memory used by the active ones.
+  std::vector<HoeffdingTree*> leaves;
+  size_t activeMemory = 0;
+  size_t numActive = 0;
+  const HoeffdingTree* prototype = NULL;
+  std::stack<HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    HoeffdingTree* node = stack.top();
+    stack.pop();
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+
+    if (node->splitDimension != size_t(-1))
+      continue;
+
+    leaves.push_back(node);
+    if (node->active)
+    {
+      activeMemory += node->LeafMemoryUsage();
+      ++numActive;
+      if (prototype == NULL)
+        prototype = node;
+    }
+  }
+
+  if (numActive == leaves.size() && activeMemory <= memoryBudget)
+    return;
+
+  // The statistics of a reactivated leaf (and of the active leaves) are
+  // estimated to take the average memory of the active leaves.  At least one
+  // leaf always stays active.
+  size_t maxActive = 1;
+  if (numActive > 0 && activeMemory > 0)
+  {
+    const double leafMemory = double(activeMemory) / double(numActive);
+    maxActive = std::max((size_t) (double(memoryBudget) / leafMemory),
+        (size_t) 1);
+  }
+
+  // Reactivated leaves take the parameters of the splits of an active leaf,
+  // which are copied first, since that leaf may be deactivated.
+  const CategoricalSplitType<FitnessFunction> categoricalPrototype =
+      (prototype != NULL && !prototype->categoricalSplits.empty()) ?
+      CategoricalSplitType<FitnessFunction>(0, 0,
+          prototype->categoricalSplits[0]) :
+      CategoricalSplitType<FitnessFunction>(0, 0);
+  const NumericSplitType<FitnessFunction> numericPrototype =
+      (prototype != NULL && !prototype->numericSplits.empty()) ?
+      NumericSplitType<FitnessFunction>(0, prototype->numericSplits[0]) :
+      NumericSplitType<FitnessFunction>(0);
+
+  // Rank the leaves by promise, from the most promising.
+  std::vector<std::pair<size_t, size_t>> promises(leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+    promises[i] = std::make_pair(leaves[i]->numMistakes, i);
+  std::stable_sort(promises.begin(), promises.end(),
+      [](const std::pair<size_t, size_t>& a,
+         const std::pair<size_t, size_t>& b)
+      {
+        return a.first > b.first;
+      });
+
+  for (size_t i = 0; i < promises.size(); ++i)
+  {
+    HoeffdingTree* leaf = leaves[promises[i].second];
+    if (i < maxActive && !leaf->active)
+      leaf->Activate(categoricalPrototype, numericPrototype);
+    else if (i >= maxActive && leaf->active)
+      leaf->Deactivate();
+  }
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -823,10 +1118,19 @@ void HoeffdingTree<
     FitnessFunction,
     NumericSplitType,
     CategoricalSplitType
->::serialize(Archive& ar, const uint32_t /* version */)
+>::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(splitDimension));
 
+  // Since version 1, the memory budget and the state of the leaves under it
+  // are saved.
+  if (version > 0)
+    ar(CEREAL_NVP(memoryBudget));
+  else if (cereal::is_loading<Archive>())
+    memoryBudget = 0;
+  if (cereal::is_loading<Archive>())
+    samplesSinceMemoryCheck = 0;
+
   // Clear memory for the mappings if necessary.
   if (cereal::is_loading<Archive>() && ownsMappings && dimensionMappings)
     delete dimensionMappings;
@@ -866,15 +1170,25 @@ void HoeffdingTree<
     ar(CEREAL_NVP(numClasses));
     ar(CEREAL_NVP(maxSamples));
     ar(CEREAL_NVP(successProbability));
+    if (version > 0)
+    {
+      ar(CEREAL_NVP(active));
+      ar(CEREAL_NVP(numMistakes));
+    }
+    else if (cereal::is_loading<Archive>())
+    {
+      active = true;
+      numMistakes = 0;
+    }
 
     // Serialize the splits, but not if we haven't seen any samples yet (in
     // which case we can just reinitialize).
     if (cereal::is_loading<Archive>())
     {
-      // Re-initialize all of the splits.
+      // Re-initialize all of the splits (inactive leaves have none).
       numericSplits.clear();
       categoricalSplits.clear();
-      for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+      for (size_t i = 0; i < datasetInfo->Dimensionality() && active; ++i)
       {
         if (datasetInfo->Type(i) == data::Datatype::categorical)
           categoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
@@ -1013,6 +1327,100 @@ void HoeffdingTree<
   }
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::UpdateMajorityClass()
+{
+  // Grab majority class from splits.
+  if (categoricalSplits.size() > 0)
+  {
+    majorityClass = categoricalSplits[0].MajorityClass();
+    majorityProbability = categoricalSplits[0].MajorityProbability();
+  }
+  else
+  {
+    majorityClass = numericSplits[0].MajorityClass();
+    majorityProbability = numericSplits[0].MajorityProbability();
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::LeafMemoryUsage() const
+{
+  size_t memory = 0;
+  for (size_t i = 0; i < numericSplits.size(); ++i)
+    memory += details::SplitMemoryUsage(numericSplits[i]);
+  for (size_t i = 0; i < categoricalSplits.size(); ++i)
+    memory += details::SplitMemoryUsage(categoricalSplits[i]);
+
+  return memory;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Activate(
+    const CategoricalSplitType<FitnessFunction>& categoricalSplitIn,
+    const NumericSplitType<FitnessFunction>& numericSplitIn)
+{
+  for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      categoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
+          datasetInfo->NumMappings(i), numClasses, categoricalSplitIn));
+    }
+    else
+    {
+      numericSplits.push_back(NumericSplitType<FitnessFunction>(numClasses,
+          numericSplitIn));
+    }
+  }
+
+  // The Hoeffding bound of the next split check must only count the points in
+  // the new statistics.  The majority class is kept until the next point.
+  numSamples = 0;
+  active = true;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Deactivate()
+{
+  std::vector<NumericSplitType<FitnessFunction>>().swap(numericSplits);
+  std::vector<CategoricalSplitType<FitnessFunction>>().swap(
+      categoricalSplits);
+  active = false;
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -1060,6 +1468,9 @@ void HoeffdingTree<
 
   // Reset statistics.
   numSamples = 0;
+  active = true;
+  numMistakes = 0;
+  samplesSinceMemoryCheck = 0;
   splitDimension = size_t(-1);
   majorityClass = 0;
   majorityProbability = 0.0;
@@ -1071,4 +1482,11 @@ void HoeffdingTree<
 } // namespace tree
 } // namespace mlpack
 
+// Since version 1, the memory budget and the state of the leaves are saved.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType>),
+    (mlpack::tree::HoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType>), (1));
+
 #endif
@@ -0,0 +1,154 @@
+/**
+ * @file methods/hoeffding_trees/quantile_numeric_split.hpp
+ *
+ * A binary numeric feature split for Hoeffding trees that keeps a quantile
+ * sketch of the values of each class, so that its memory does not grow with
+ * the number of points seen.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "binary_numeric_split_info.hpp"
+#include <mlpack/core/data/quantile_sketch.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The QuantileNumericSplit class finds binary splits of a numeric feature, like
+ * BinaryNumericSplit, but instead of storing every value seen, it keeps a
+ * data::QuantileSketch of the values of each class.  EvaluateFitnessFunction()
+ * then sweeps over the weighted values kept by the sketches in sorted order,
+ * moving their weights to the left side of the split, and evaluates the split
+ * at each of them; the class counts of each side are estimates, with an error
+ * that shrinks as the sketch size grows.  So the memory of each split is at
+ * most SketchSize() values per level of each sketch, which grows only with the
+ * logarithm of the number of points the node sees, and the evaluation takes
+ * time proportional to that, not to the number of points.  (The sketches hold
+ * the values as doubles.)
+ *
+ * Because the sketches are mergeable, the statistics of two splits trained on
+ * different points can be combined with Merge().
+ *
+ * @tparam FitnessFunction Fitness function to use for calculating gain.
+ * @tparam ObservationType Type of observations in this dimension.
+ */
+template<typename FitnessFunction,
+         typename ObservationType = double>
+class QuantileNumericSplit
+{
+ public:
+  //! The splitting information required by the QuantileNumericSplit.
+  typedef BinaryNumericSplitInfo<ObservationType> SplitInfo;
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes.
+   *
+   * @param numClasses Number of classes in dataset.
+   * @param sketchSize Capacity of each level of each quantile sketch.
+   */
+  QuantileNumericSplit(const size_t numClasses = 0,
+                       const size_t sketchSize = 200);
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes,
+   * using the sketch size of the given other split.
+   */
+  QuantileNumericSplit(const size_t numClasses,
+                       const QuantileNumericSplit& other);
+
+  /**
+   * Train on the given value with the given label.
+   *
+   * @param value The value to train on.
+   * @param label The label to train on.
+   */
+  void Train(ObservationType value, const size_t label);
+
+  /**
+   * Add the statistics of another split of the same dimension (trained on
+   * other points) to this one.
+   *
+   * @param other Split to merge in.
+   */
+  void Merge(const QuantileNumericSplit& other);
+
+  /**
+   * Given the points seen so far, evaluate the fitness function, returning the
+   * best possible gain of a binary split at one of the values stored in the
+   * sketches.
+   *
+   * @param bestFitness Fitness function value for best possible split.
+   * @param secondBestFitness Fitness function value for second best possible
+   *      split.
+   */
+  void EvaluateFitnessFunction(double& bestFitness,
+                               double& secondBestFitness);
+
+  // Return the number of children if this node were to split on this feature.
+  size_t NumChildren() const { return 2; }
+
+  /**
+   * Given that a split should happen, return the majority classes of the (two)
+   * children and an initialized SplitInfo object.
+   *
+   * @param childMajorities Majority classes of the children after the split.
+   * @param splitInfo Split information.
+   */
+  void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo);
+
+  //! The majority class of the points seen so far.
+  size_t MajorityClass() const;
+  //! The probability of the majority class given the points seen so far.
+  double MajorityProbability() const;
+
+  //! Get the capacity of each level of each quantile sketch.
+  size_t SketchSize() const { return sketchSize; }
+  //! Get the quantile sketch of the values of the given class.
+  const data::QuantileSketch& Sketch(const size_t label) const
+  {
+    return sketches[label];
+  }
+
+  //! Get the memory used by the statistics, in bytes.
+  size_t MemoryUsage() const;
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The quantile sketch of the values of each class.
+  std::vector<data::QuantileSketch> sketches;
+  //! The number of points of each class seen so far.
+  arma::Col<size_t> classCounts;
+  //! The capacity of each level of each quantile sketch.
+  size_t sketchSize;
+
+  //! A cached best split point.
+  ObservationType bestSplit;
+  //! The class counts of each side of the cached best split.
+  arma::Mat<size_t> bestCounts;
+  //! If true, the cached best split point is accurate (that is, we have not
+  //! seen any more samples since we calculated it).
+  bool isAccurate;
+};
+
+//! Convenience typedef.
+template<typename FitnessFunction>
+using QuantileDoubleNumericSplit = QuantileNumericSplit<FitnessFunction,
+    double>;
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "quantile_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file methods/hoeffding_trees/quantile_numeric_split_impl.hpp
+ *
+ * Implementation of the QuantileNumericSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantile_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const size_t sketchSize) :
+    sketches(numClasses, data::QuantileSketch(sketchSize)),
+    classCounts(numClasses, arma::fill::zeros),
+    sketchSize(sketchSize),
+    bestSplit(std::numeric_limits<ObservationType>::lowest()),
+    isAccurate(false)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const QuantileNumericSplit& other) :
+    sketches(numClasses, data::QuantileSketch(other.sketchSize)),
+    classCounts(numClasses, arma::fill::zeros),
+    sketchSize(other.sketchSize),
+    bestSplit(std::numeric_limits<ObservationType>::lowest()),
+    isAccurate(false)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Train(
+    ObservationType value,
+    const size_t label)
+{
+  sketches[label].Insert((double) value);
+  ++classCounts[label];
+
+  // Whatever we have cached is no longer valid.
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Merge(
+    const QuantileNumericSplit& other)
+{
+  for (size_t c = 0; c < sketches.size(); ++c)
+    sketches[c].Merge(other.sketches[c]);
+  classCounts += other.classCounts;
+
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::
+    EvaluateFitnessFunction(double& bestFitness,
+                            double& secondBestFitness)
+{
+  // Collect the stored values of all the classes, with their weights.
+  typedef std::pair<size_t, size_t> ClassWeight;
+  std::vector<std::pair<double, ClassWeight>> items;
+  std::vector<std::pair<double, size_t>> weighted;
+  for (size_t c = 0; c < sketches.size(); ++c)
+  {
+    sketches[c].WeightedValues(weighted);
+    for (size_t i = 0; i < weighted.size(); ++i)
+    {
+      items.push_back(std::make_pair(weighted[i].first,
+          ClassWeight(c, weighted[i].second)));
+    }
+  }
+  std::sort(items.begin(), items.end(),
+      [](const std::pair<double, ClassWeight>& a,
+         const std::pair<double, ClassWeight>& b)
+      {
+        return a.first < b.first;
+      });
+
+  // Initialize the sufficient statistics: the total weight of the values of
+  // each class is exactly its number of points.
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+
+  bestFitness = FitnessFunction::Evaluate(counts);
+  secondBestFitness = 0.0;
+  bestSplit = std::numeric_limits<ObservationType>::lowest();
+  bestCounts = counts;
+
+  // Evaluate the split at each distinct stored value (with the smaller values
+  // on the left), then move the weights of that value to the left side.
+  size_t i = 0;
+  while (i < items.size())
+  {
+    const double value = items[i].first;
+    if (i > 0)
+    {
+      const double fitness = FitnessFunction::Evaluate(counts);
+      if (fitness > bestFitness)
+      {
+        secondBestFitness = bestFitness;
+        bestFitness = fitness;
+        bestSplit = (ObservationType) value;
+        bestCounts = counts;
+      }
+      else if (fitness > secondBestFitness)
+      {
+        secondBestFitness = fitness;
+      }
+    }
+
+    for (; i < items.size() && items[i].first == value; ++i)
+    {
+      const ClassWeight& classWeight = items[i].second;
+      counts(classWeight.first, 1) -= classWeight.second;
+      counts(classWeight.first, 0) += classWeight.second;
+    }
+  }
+
+  isAccurate = true;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Split(
+    arma::Col<size_t>& childMajorities,
+    SplitInfo& splitInfo)
+{
+  if (!isAccurate)
+  {
+    double bestGain, secondBestGain;
+    EvaluateFitnessFunction(bestGain, secondBestGain);
+  }
+
+  // Make one child for each side of the split.
+  childMajorities.set_size(2);
+  childMajorities[0] = (size_t) bestCounts.col(0).index_max();
+  childMajorities[1] = (size_t) bestCounts.col(1).index_max();
+
+  // Create the according SplitInfo object.
+  splitInfo = SplitInfo(bestSplit);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t QuantileNumericSplit<FitnessFunction, ObservationType>::MajorityClass()
+    const
+{
+  arma::uword maxIndex;
+  classCounts.max(maxIndex);
+  return size_t(maxIndex);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+double QuantileNumericSplit<FitnessFunction, ObservationType>::
+    MajorityProbability() const
+{
+  return double(arma::max(classCounts)) / double(arma::accu(classCounts));
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t QuantileNumericSplit<FitnessFunction, ObservationType>::MemoryUsage()
+    const
+{
+  size_t memory = sizeof(QuantileNumericSplit) +
+      (classCounts.n_elem + bestCounts.n_elem) * sizeof(size_t);
+  for (size_t c = 0; c < sketches.size(); ++c)
+    memory += sketches[c].MemoryUsage();
+
+  return memory;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+template<typename Archive>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(sketchSize));
+  ar(CEREAL_NVP(classCounts));
+  ar(CEREAL_NVP(sketches));
+
+  if (cereal::is_loading<Archive>())
+  {
+    bestSplit = std::numeric_limits<ObservationType>::lowest();
+    bestCounts.clear();
+    isAccurate = false;
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
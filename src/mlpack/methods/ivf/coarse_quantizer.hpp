@@ -0,0 +1,111 @@
+/**
+ * @file methods/ivf/coarse_quantizer.hpp
+ *
+ * Defines the CoarseQuantizer class, which partitions points into the lists
+ * of an inverted file index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_COARSE_QUANTIZER_HPP
+#define MLPACK_METHODS_IVF_COARSE_QUANTIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The CoarseQuantizer class clusters a set of points with kmeans::KMeans into
+ * NumLists() lists, and orders the points by list, so that the points of each
+ * list can be stored contiguously by an inverted file index such as IVFSearch
+ * or IVFPQSearch.  Probe() finds the lists whose centroids are closest to a
+ * query point.  The centroids are stored with the element type of MatType.
+ *
+ * @tparam MatType Type of matrix of the points.
+ */
+template<typename MatType = arma::mat>
+class CoarseQuantizer
+{
+ public:
+  //! The element type of the points.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the quantizer without training it.
+   *
+   * @param numLists Number of lists; must be positive.
+   * @param maxIterations Maximum number of iterations of k-means.
+   */
+  CoarseQuantizer(const size_t numLists = 64,
+                  const size_t maxIterations = 25);
+
+  /**
+   * Cluster the given points into the lists, replacing the current ones.
+   *
+   * @param data Points to cluster; there must be at least NumLists() of them.
+   * @param assignments Vector to store the list of each point in.
+   */
+  void Train(const MatType& data, arma::Row<size_t>& assignments);
+
+  /**
+   * Find the given number of lists whose centroids are closest to the query
+   * point, with their squared distances, closest first.
+   *
+   * @param query Query point.
+   * @param numProbes Number of lists to return; at most NumLists().
+   * @param lists Vector to store the squared distances and the lists in.
+   */
+  template<typename VecType>
+  void Probe(const VecType& query,
+             const size_t numProbes,
+             std::vector<std::pair<double, size_t>>& lists) const;
+
+  //! Get the number of lists.
+  size_t NumLists() const { return numLists; }
+  //! Get the maximum number of iterations of k-means.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of k-means.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the centroids of the lists.
+  const MatType& Centroids() const { return centroids; }
+  //! Get the index in the training points of each point, ordered by list.
+  const arma::Col<size_t>& Indices() const { return indices; }
+  //! Get the position of the first point of each list (and the number of
+  //! points at the end).
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+
+  //! Get the position of the first point of the given list.
+  size_t ListBegin(const size_t list) const { return listOffsets[list]; }
+  //! Get the position after the last point of the given list.
+  size_t ListEnd(const size_t list) const { return listOffsets[list + 1]; }
+
+  //! Serialize the quantizer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Number of lists.
+  size_t numLists;
+  //! Maximum number of iterations of k-means.
+  size_t maxIterations;
+
+  //! The centroids of the lists.
+  MatType centroids;
+  //! The index in the training points of each point, ordered by list.
+  arma::Col<size_t> indices;
+  //! The position of the first point of each list.
+  arma::Col<size_t> listOffsets;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "coarse_quantizer_impl.hpp"
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file methods/ivf/coarse_quantizer_impl.hpp
+ *
+ * Implementation of the CoarseQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_COARSE_QUANTIZER_IMPL_HPP
+#define MLPACK_METHODS_IVF_COARSE_QUANTIZER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "coarse_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+CoarseQuantizer<MatType>::CoarseQuantizer(const size_t numLists,
+                                          const size_t maxIterations) :
+    numLists(numLists),
+    maxIterations(maxIterations)
+{
+  if (numLists == 0)
+  {
+    Log::Fatal << "CoarseQuantizer::CoarseQuantizer(): numLists must be "
+        << "positive!" << std::endl;
+  }
+}
+
+template<typename MatType>
+void CoarseQuantizer<MatType>::Train(const MatType& data,
+                                     arma::Row<size_t>& assignments)
+{
+  if (numLists > data.n_cols)
+  {
+    Log::Fatal << "CoarseQuantizer::Train(): numLists (" << numLists << ") "
+        << "must not be greater than the number of points (" << data.n_cols
+        << ")!" << std::endl;
+  }
+
+  // k-means works in double precision.
+  arma::mat kmeansCentroids;
+  kmeans::KMeans<> kmeans(maxIterations);
+  kmeans.Cluster(arma::conv_to<arma::mat>::from(data), numLists, assignments,
+      kmeansCentroids);
+  centroids = arma::conv_to<MatType>::from(kmeansCentroids);
+
+  // Order the points by list.
+  listOffsets.zeros(numLists + 1);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    ++listOffsets[assignments[i] + 1];
+  for (size_t l = 0; l < numLists; ++l)
+    listOffsets[l + 1] += listOffsets[l];
+
+  arma::Col<size_t> positions = listOffsets.head(numLists);
+  indices.set_size(assignments.n_elem);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    indices[positions[assignments[i]]++] = i;
+}
+
+template<typename MatType>
+template<typename VecType>
+void CoarseQuantizer<MatType>::Probe(
+    const VecType& query,
+    const size_t numProbes,
+    std::vector<std::pair<double, size_t>>& lists) const
+{
+  lists.resize(numLists);
+  for (size_t l = 0; l < numLists; ++l)
+  {
+    const ElemType* centroid = centroids.colptr(l);
+    double distance = 0.0;
+    for (size_t j = 0; j < centroids.n_rows; ++j)
+    {
+      const double diff = double(query[j]) - double(centroid[j]);
+      distance += diff * diff;
+    }
+
+    lists[l] = std::make_pair(distance, l);
+  }
+
+  const size_t probes = std::min(numProbes, numLists);
+  std::partial_sort(lists.begin(), lists.begin() + probes, lists.end());
+  lists.resize(probes);
+}
+
+template<typename MatType>
+template<typename Archive>
+void CoarseQuantizer<MatType>::serialize(Archive& ar,
+                                         const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numLists));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(centroids));
+  ar(CEREAL_NVP(indices));
+  ar(CEREAL_NVP(listOffsets));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
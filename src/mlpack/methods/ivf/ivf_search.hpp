@@ -0,0 +1,135 @@
+/**
+ * @file methods/ivf/ivf_search.hpp
+ *
+ * Defines the IVFSearch class, an inverted file index for approximate nearest
+ * neighbor search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_IVF_SEARCH_HPP
+#define MLPACK_METHODS_IVF_IVF_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "coarse_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The IVFSearch class finds approximate nearest neighbors (with the Euclidean
+ * distance) in an inverted file index.  The reference points are partitioned
+ * into NumLists() cells by a CoarseQuantizer, and stored contiguously cell by
+ * cell; a query only scans the NumProbes() cells whose centroids are closest
+ * to it, so NumProbes() trades recall for speed.  When every cell is probed,
+ * the search is exact.
+ *
+ * The queries are searched as a batch: they are first assigned to the cells
+ * they probe, and then each cell is scanned in parallel for all its queries at
+ * once, computing the distances with a matrix product.  The points and the
+ * computations use the element type of MatType, so arma::fmat halves the
+ * memory of the index.  To store the points compressed, use IVFPQSearch,
+ * which shares the coarse quantizer.
+ *
+ * @tparam MatType Type of matrix of the points.
+ */
+template<typename MatType = arma::mat>
+class IVFSearch
+{
+ public:
+  //! The element type of the points.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Build the index of the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of cells of the coarse quantizer.
+   * @param numProbes Number of cells scanned by each search.
+   * @param maxIterations Maximum number of iterations of k-means.
+   */
+  IVFSearch(const MatType& referenceSet,
+            const size_t numLists = 64,
+            const size_t numProbes = 8,
+            const size_t maxIterations = 25);
+
+  /**
+   * Create the index without a reference set.  Train() must be called before
+   * searching.
+   *
+   * @param numLists Number of cells of the coarse quantizer.
+   * @param numProbes Number of cells scanned by each search.
+   * @param maxIterations Maximum number of iterations of k-means.
+   */
+  IVFSearch(const size_t numLists = 64,
+            const size_t numProbes = 8,
+            const size_t maxIterations = 25);
+
+  /**
+   * Build the index of the given reference set, replacing the current one.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Find the approximate k nearest neighbors of each point of the query set.
+   * If the scanned cells hold fewer than k points, the rest of the results are
+   * filled with SIZE_MAX and DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the number of cells.
+  size_t NumLists() const { return quantizer.NumLists(); }
+  //! Get the number of reference points.
+  size_t NumPoints() const { return points.n_cols; }
+
+  //! Get the number of cells scanned by each search.
+  size_t NumProbes() const { return numProbes; }
+  //! Modify the number of cells scanned by each search.
+  size_t& NumProbes() { return numProbes; }
+
+  //! Get the coarse quantizer.
+  const CoarseQuantizer<MatType>& Quantizer() const { return quantizer; }
+  //! Get the reference points, ordered by cell.
+  const MatType& Points() const { return points; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A reference point and its squared distance to the query.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Number of queries scanned together in a cell.
+  static constexpr size_t QueryBlockSize = 256;
+
+  //! Number of cells scanned by each search.
+  size_t numProbes;
+  //! The coarse quantizer.
+  CoarseQuantizer<MatType> quantizer;
+  //! The reference points, ordered by cell.
+  MatType points;
+  //! The squared norm of each reference point.
+  arma::Col<ElemType> pointNorms;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_search_impl.hpp"
+
+#endif
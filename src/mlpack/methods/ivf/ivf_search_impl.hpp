@@ -0,0 +1,223 @@
+/**
+ * @file methods/ivf/ivf_search_impl.hpp
+ *
+ * Implementation of the IVFSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_IVF_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_IVF_IVF_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+IVFSearch<MatType>::IVFSearch(const MatType& referenceSet,
+                              const size_t numLists,
+                              const size_t numProbes,
+                              const size_t maxIterations) :
+    IVFSearch(numLists, numProbes, maxIterations)
+{
+  Train(referenceSet);
+}
+
+template<typename MatType>
+IVFSearch<MatType>::IVFSearch(const size_t numLists,
+                              const size_t numProbes,
+                              const size_t maxIterations) :
+    numProbes(numProbes),
+    quantizer(numLists, maxIterations)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void IVFSearch<MatType>::Train(const MatType& referenceSet)
+{
+  arma::Row<size_t> assignments;
+  quantizer.Train(referenceSet, assignments);
+
+  // Store the points of each cell contiguously.
+  const arma::Col<size_t>& indices = quantizer.Indices();
+  points.set_size(referenceSet.n_rows, referenceSet.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    points.col(i) = referenceSet.col(indices[i]);
+
+  pointNorms = arma::sum(arma::square(points), 0).t();
+}
+
+template<typename MatType>
+void IVFSearch<MatType>::Search(const MatType& querySet,
+                                const size_t k,
+                                arma::Mat<size_t>& neighbors,
+                                arma::mat& distances) const
+{
+  if (k > points.n_cols)
+  {
+    Log::Fatal << "IVFSearch::Search(): requested " << k << " neighbors, but "
+        << "the reference set has only " << points.n_cols << " points!"
+        << std::endl;
+  }
+
+  if (querySet.n_rows != points.n_rows)
+  {
+    Log::Fatal << "IVFSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") does not match the dimensionality of the "
+        << "reference set (" << points.n_rows << ")!" << std::endl;
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  const size_t numLists = quantizer.NumLists();
+  const size_t probes = std::min(std::max(numProbes, (size_t) 1), numLists);
+  const arma::Col<size_t>& indices = quantizer.Indices();
+
+  // Find the cells probed by each query.
+  arma::Mat<size_t> probed(probes, querySet.n_cols);
+  #pragma omp parallel
+  {
+    std::vector<Candidate> lists;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      quantizer.Probe(querySet.col(q), probes, lists);
+      for (size_t p = 0; p < probes; ++p)
+        probed(p, q) = lists[p].second;
+    }
+  }
+
+  // Each query has one slot of results per probed cell, q * probes + p; group
+  // the slots by cell.
+  std::vector<std::vector<size_t>> cellSlots(numLists);
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+    for (size_t p = 0; p < probes; ++p)
+      cellSlots[probed(p, q)].push_back(q * probes + p);
+
+  arma::Mat<size_t> slotNeighbors(k, probes * querySet.n_cols);
+  arma::mat slotDistances(k, probes * querySet.n_cols);
+  slotNeighbors.fill(SIZE_MAX);
+  slotDistances.fill(DBL_MAX);
+
+  const arma::Col<ElemType> queryNorms =
+      arma::sum(arma::square(querySet), 0).t();
+
+  // Scan each cell for all the queries that probe it, a block of queries at a
+  // time: ||x - q||^2 = ||x||^2 + ||q||^2 - 2 x^T q.
+  #pragma omp parallel
+  {
+    MatType queryBlock, products;
+    std::vector<Candidate> best;
+
+    #pragma omp for schedule(dynamic, 1)
+    for (omp_size_t c = 0; c < (omp_size_t) numLists; ++c)
+    {
+      const size_t begin = quantizer.ListBegin(c);
+      const size_t end = quantizer.ListEnd(c);
+      const std::vector<size_t>& slots = cellSlots[c];
+      if (begin == end || slots.empty())
+        continue;
+
+      for (size_t b = 0; b < slots.size(); b += QueryBlockSize)
+      {
+        const size_t blockSize = std::min((size_t) QueryBlockSize,
+            slots.size() - b);
+        queryBlock.set_size(querySet.n_rows, blockSize);
+        for (size_t j = 0; j < blockSize; ++j)
+          queryBlock.col(j) = querySet.col(slots[b + j] / probes);
+
+        products = points.cols(begin, end - 1).t() * queryBlock;
+
+        for (size_t j = 0; j < blockSize; ++j)
+        {
+          const size_t slot = slots[b + j];
+          const double queryNorm = queryNorms[slot / probes];
+
+          // Keep the k closest points in a max-heap.
+          best.clear();
+          for (size_t i = begin; i < end; ++i)
+          {
+            const double distance = double(pointNorms[i]) + queryNorm -
+                2.0 * double(products(i - begin, j));
+            if (best.size() < k)
+            {
+              best.push_back(Candidate(distance, indices[i]));
+              std::push_heap(best.begin(), best.end());
+            }
+            else if (distance < best.front().first)
+            {
+              std::pop_heap(best.begin(), best.end());
+              best.back() = Candidate(distance, indices[i]);
+              std::push_heap(best.begin(), best.end());
+            }
+          }
+
+          std::sort_heap(best.begin(), best.end());
+          for (size_t r = 0; r < best.size(); ++r)
+          {
+            slotNeighbors(r, slot) = best[r].second;
+            slotDistances(r, slot) = std::max(best[r].first, 0.0);
+          }
+        }
+      }
+    }
+  }
+
+  // Merge the results of the cells probed by each query.
+  #pragma omp parallel
+  {
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      candidates.clear();
+      for (size_t slot = q * probes; slot < (q + 1) * probes; ++slot)
+      {
+        for (size_t r = 0; r < k && slotNeighbors(r, slot) != SIZE_MAX; ++r)
+        {
+          candidates.push_back(Candidate(slotDistances(r, slot),
+              slotNeighbors(r, slot)));
+        }
+      }
+
+      const size_t found = std::min(k, candidates.size());
+      std::partial_sort(candidates.begin(), candidates.begin() + found,
+          candidates.end());
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, q) = (j < found) ? candidates[j].second : SIZE_MAX;
+        distances(j, q) = (j < found) ? std::sqrt(candidates[j].first) :
+            DBL_MAX;
+      }
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void IVFSearch<MatType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numProbes));
+  ar(CEREAL_NVP(quantizer));
+  ar(CEREAL_NVP(points));
+
+  // The norms are not saved, since they are cheap to recompute.
+  if (cereal::is_loading<Archive>())
+    pointNorms = arma::sum(arma::square(points), 0).t();
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
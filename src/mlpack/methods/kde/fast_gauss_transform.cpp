@@ -0,0 +1,259 @@
+/**
+ * @file methods/kde/fast_gauss_transform.cpp
+ *
+ * Implementation of the FastGaussTransform class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "fast_gauss_transform.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+
+FastGaussTransform::FastGaussTransform(const double bandwidth,
+                                       const double epsilon,
+                                       const size_t numClusters,
+                                       const size_t maxOrder) :
+    bandwidth(bandwidth),
+    epsilon(epsilon),
+    numClusters(numClusters),
+    maxOrder(maxOrder),
+    order(0),
+    cutoffRadius(0.0),
+    numPoints(0)
+{
+  if (bandwidth <= 0.0)
+  {
+    Log::Fatal << "FastGaussTransform::FastGaussTransform(): bandwidth must "
+        << "be positive!" << std::endl;
+  }
+
+  if (epsilon <= 0.0 || epsilon >= 1.0)
+  {
+    Log::Fatal << "FastGaussTransform::FastGaussTransform(): epsilon must be "
+        << "in (0, 1)!" << std::endl;
+  }
+
+  if (numClusters == 0 || maxOrder == 0)
+  {
+    Log::Fatal << "FastGaussTransform::FastGaussTransform(): numClusters and "
+        << "maxOrder must be positive!" << std::endl;
+  }
+}
+
+void FastGaussTransform::Train(const arma::mat& referenceSet)
+{
+  if (referenceSet.n_cols == 0)
+  {
+    Log::Fatal << "FastGaussTransform::Train(): the reference set is empty!"
+        << std::endl;
+  }
+
+  const size_t d = referenceSet.n_rows;
+  numPoints = referenceSet.n_cols;
+  numClusters = std::min(numClusters, numPoints);
+
+  // Farthest-point clustering: each new center is the point farthest from the
+  // centers so far.
+  arma::vec distances(numPoints);
+  distances.fill(DBL_MAX);
+  arma::Col<size_t> assignments(numPoints);
+  centers.set_size(d, numClusters);
+  size_t centerIndex = math::RandInt(numPoints);
+  for (size_t k = 0; k < numClusters; ++k)
+  {
+    centers.col(k) = referenceSet.col(centerIndex);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+    {
+      const double distance = arma::accu(arma::square(referenceSet.col(i) -
+          centers.col(k)));
+      if (distance < distances[i])
+      {
+        distances[i] = distance;
+        assignments[i] = k;
+      }
+    }
+
+    centerIndex = distances.index_max();
+  }
+
+  radii.zeros(numClusters);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    radii[assignments[i]] = std::max(radii[assignments[i]],
+        std::sqrt(distances[i]));
+  }
+
+  // The kernel is e^{-||x - y||^2 / h^2}.  A source farther than the cutoff
+  // radius from the query contributes less than epsilon.
+  const double h = std::sqrt(2.0) * bandwidth;
+  cutoffRadius = h * std::sqrt(std::log(1.0 / epsilon));
+
+  // The truncation error of each source is at most
+  // (2^p / p!) (r_x / h)^p (r_y / h)^p, where r_x is the radius of its cluster
+  // and r_y <= r_x + cutoff is the distance of the query to the center.
+  const double rx = radii.max();
+  const double ratio = rx * (rx + cutoffRadius) / (h * h);
+  double bound = 1.0;
+  order = 0;
+  while (order < maxOrder && (order == 0 || bound > epsilon))
+  {
+    ++order;
+    bound *= 2.0 * ratio / order;
+  }
+
+  if (bound > epsilon)
+  {
+    Log::Warn << "FastGaussTransform::Train(): the clusters are too wide for "
+        << "the error tolerance with order " << maxOrder << " (error bound "
+        << bound << "); use more clusters or a larger maximum order."
+        << std::endl;
+  }
+
+  // Compute the constants 2^{|alpha|} / alpha! of the terms, in the same order
+  // as Monomials().
+  const size_t numTerms = NumTerms(d, order);
+  arma::vec constants(numTerms);
+  arma::Mat<size_t> exponents(d, numTerms, arma::fill::zeros);
+  std::vector<size_t> heads(d, 0);
+  constants[0] = 1.0;
+  for (size_t t = 1, tail = 1, degree = 1; degree < order; ++degree)
+  {
+    for (size_t j = 0; j < d; ++j)
+    {
+      const size_t head = heads[j];
+      heads[j] = t;
+      for (size_t m = head; m < tail; ++m, ++t)
+      {
+        exponents.col(t) = exponents.col(m);
+        ++exponents(j, t);
+        constants[t] = constants[m] * 2.0 / exponents(j, t);
+      }
+    }
+
+    tail = t;
+  }
+
+  // Group the points by cluster.
+  arma::Col<size_t> offsets(numClusters + 1, arma::fill::zeros);
+  for (size_t i = 0; i < numPoints; ++i)
+    ++offsets[assignments[i] + 1];
+  for (size_t k = 0; k < numClusters; ++k)
+    offsets[k + 1] += offsets[k];
+  arma::Col<size_t> positions = offsets.head(numClusters);
+  arma::Col<size_t> clusterPoints(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    clusterPoints[positions[assignments[i]]++] = i;
+
+  // C_alpha^k = 2^{|alpha|} / alpha! * sum_i e^{-||x_i - c_k||^2 / h^2}
+  //     ((x_i - c_k) / h)^alpha.
+  coefficients.zeros(numTerms, numClusters);
+  #pragma omp parallel
+  {
+    std::vector<size_t> threadHeads(d);
+    arma::vec dx(d), monomials(numTerms);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t k = 0; k < (omp_size_t) numClusters; ++k)
+    {
+      for (size_t i = offsets[k]; i < offsets[k + 1]; ++i)
+      {
+        dx = (referenceSet.col(clusterPoints[i]) - centers.col(k)) / h;
+        Monomials(dx.memptr(), d, order, threadHeads, monomials.memptr());
+        coefficients.col(k) += std::exp(-arma::dot(dx, dx)) * monomials;
+      }
+
+      coefficients.col(k) %= constants;
+    }
+  }
+}
+
+void FastGaussTransform::Evaluate(const arma::mat& querySet,
+                                  arma::vec& estimations) const
+{
+  if (numPoints == 0)
+  {
+    Log::Fatal << "FastGaussTransform::Evaluate(): the transform must be "
+        << "trained before evaluation!" << std::endl;
+  }
+
+  if (querySet.n_rows != centers.n_rows)
+  {
+    Log::Fatal << "FastGaussTransform::Evaluate(): dimensionality of query set "
+        << "(" << querySet.n_rows << ") does not match the dimensionality of "
+        << "the reference set (" << centers.n_rows << ")!" << std::endl;
+  }
+
+  const size_t d = centers.n_rows;
+  const double h = std::sqrt(2.0) * bandwidth;
+
+  estimations.set_size(querySet.n_cols);
+  #pragma omp parallel
+  {
+    std::vector<size_t> heads(d);
+    arma::vec dy(d), monomials(coefficients.n_rows);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      double estimate = 0.0;
+      for (size_t k = 0; k < numClusters; ++k)
+      {
+        // Skip the clusters whose points are all beyond the cutoff radius.
+        dy = querySet.col(q) - centers.col(k);
+        const double distance = arma::dot(dy, dy);
+        const double cutoff = radii[k] + cutoffRadius;
+        if (distance > cutoff * cutoff)
+          continue;
+
+        dy /= h;
+        Monomials(dy.memptr(), d, order, heads, monomials.memptr());
+        estimate += std::exp(-distance / (h * h)) *
+            arma::dot(coefficients.col(k), monomials);
+      }
+
+      estimations[q] = estimate / numPoints;
+    }
+  }
+}
+
+void FastGaussTransform::Monomials(const double* x,
+                                   const size_t dimensionality,
+                                   const size_t order,
+                                   std::vector<size_t>& heads,
+                                   double* monomials)
+{
+  // Each monomial of degree k is x_j times a monomial of degree k - 1 whose
+  // last variable is at least j; heads[j] is the first of those.
+  std::fill(heads.begin(), heads.end(), 0);
+  monomials[0] = 1.0;
+  for (size_t t = 1, tail = 1, degree = 1; degree < order; ++degree)
+  {
+    for (size_t j = 0; j < dimensionality; ++j)
+    {
+      const size_t head = heads[j];
+      heads[j] = t;
+      for (size_t m = head; m < tail; ++m, ++t)
+        monomials[t] = x[j] * monomials[m];
+    }
+
+    tail = t;
+  }
+}
+
+size_t FastGaussTransform::NumTerms(const size_t dimensionality,
+                                    const size_t order)
+{
+  // The number of monomials of degree less than p in d variables is
+  // (p - 1 + d)! / ((p - 1)! d!).
+  size_t terms = 1;
+  for (size_t i = 1; i < order; ++i)
+    terms = terms * (dimensionality + i) / i;
+
+  return terms;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file methods/kde/fast_gauss_transform.hpp
+ *
+ * Defines the FastGaussTransform class, the improved fast Gauss transform for
+ * Gaussian kernel density estimation in low dimensions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_FAST_GAUSS_TRANSFORM_HPP
+#define MLPACK_METHODS_KDE_FAST_GAUSS_TRANSFORM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The FastGaussTransform class estimates Gaussian kernel densities with the
+ * improved fast Gauss transform (IFGT) of Yang, Duraiswami and Gumerov.  The
+ * estimate of a query point y is the same as that of KDE with a GaussianKernel
+ * of the same bandwidth,
+ *
+ * @f[
+ * f(y) = \frac{1}{N} \sum_{i = 1}^{N} e^{-\| y - x_i \|^2 / (2 \sigma^2)},
+ * @f]
+ *
+ * but instead of a tree traversal, the reference points are split into
+ * NumClusters() clusters by farthest-point clustering, and the kernel sum of
+ * each cluster is replaced by a multivariate Taylor expansion of order Order()
+ * around its center.  A query then only costs, for each cluster within the
+ * cutoff radius, the evaluation of one polynomial with as many terms as there
+ * are monomials of degree less than Order() in d variables.  This is fastest
+ * for low-dimensional data and large sets of query points; for high
+ * dimensions, use KDE.
+ *
+ * The order and the cutoff radius are chosen from the error tolerance epsilon
+ * with the error bounds of Raykar et al., so that every estimate is within
+ * epsilon of the exact value.  If the clusters are too wide (compared to the
+ * bandwidth) for the bound to be met with at most MaxOrder() terms, a warning
+ * is given; more clusters will then help.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{yang2003improved,
+ *   title={Improved Fast Gauss Transform and Efficient Kernel Density
+ *       Estimation},
+ *   author={Yang, Changjiang and Duraiswami, Ramani and Gumerov, Nail A. and
+ *       Davis, Larry},
+ *   booktitle={Proceedings of the Ninth IEEE International Conference on
+ *       Computer Vision (ICCV 2003)},
+ *   pages={664--671},
+ *   year={2003}
+ * }
+ * @endcode
+ */
+class FastGaussTransform
+{
+ public:
+  /**
+   * Create the transform without reference points.  Train() must be called
+   * before evaluating.
+   *
+   * @param bandwidth Bandwidth of the Gaussian kernel.
+   * @param epsilon Absolute error tolerance of each estimate.
+   * @param numClusters Number of clusters of the reference points.
+   * @param maxOrder Maximum order of the Taylor expansions.
+   */
+  FastGaussTransform(const double bandwidth = 1.0,
+                     const double epsilon = 1e-3,
+                     const size_t numClusters = 64,
+                     const size_t maxOrder = 12);
+
+  /**
+   * Build the expansions of the given reference points.  The reference points
+   * are not kept.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const arma::mat& referenceSet);
+
+  /**
+   * Estimate the density of each point of the query set.  The query points are
+   * evaluated in parallel.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Vector in which the estimations will be stored.
+   */
+  void Evaluate(const arma::mat& querySet, arma::vec& estimations) const;
+
+  //! Get the bandwidth of the Gaussian kernel.
+  double Bandwidth() const { return bandwidth; }
+  //! Get the absolute error tolerance.
+  double Epsilon() const { return epsilon; }
+  //! Get the number of clusters (after training, at most the number of
+  //! reference points).
+  size_t NumClusters() const { return numClusters; }
+  //! Get the maximum order of the expansions.
+  size_t MaxOrder() const { return maxOrder; }
+  //! Get the order of the expansions chosen by Train().
+  size_t Order() const { return order; }
+  //! Get the cutoff radius: clusters farther than this (plus their radius)
+  //! from a query point are ignored.
+  double CutoffRadius() const { return cutoffRadius; }
+
+  //! Get the centers of the clusters.
+  const arma::mat& Centers() const { return centers; }
+  //! Get the radius of each cluster.
+  const arma::vec& Radii() const { return radii; }
+  //! Get the coefficients of the expansion of each cluster.
+  const arma::mat& Coefficients() const { return coefficients; }
+
+  //! Serialize the transform.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(bandwidth));
+    ar(CEREAL_NVP(epsilon));
+    ar(CEREAL_NVP(numClusters));
+    ar(CEREAL_NVP(maxOrder));
+    ar(CEREAL_NVP(order));
+    ar(CEREAL_NVP(cutoffRadius));
+    ar(CEREAL_NVP(numPoints));
+    ar(CEREAL_NVP(centers));
+    ar(CEREAL_NVP(radii));
+    ar(CEREAL_NVP(coefficients));
+  }
+
+ private:
+  /**
+   * Compute every monomial of the given vector of degree less than the given
+   * order, in graded order: monomials[0] = 1, then the d monomials of degree 1,
+   * and so on.
+   *
+   * @param x Vector to compute the monomials of.
+   * @param dimensionality Number of elements of x.
+   * @param order Order of the expansion.
+   * @param heads Workspace with one element per dimension.
+   * @param monomials Array storing the monomials; it must have
+   *     NumTerms(dimensionality, order) elements.
+   */
+  static void Monomials(const double* x,
+                        const size_t dimensionality,
+                        const size_t order,
+                        std::vector<size_t>& heads,
+                        double* monomials);
+
+  //! Get the number of monomials of degree less than the given order.
+  static size_t NumTerms(const size_t dimensionality, const size_t order);
+
+  //! Bandwidth of the Gaussian kernel.
+  double bandwidth;
+  //! Absolute error tolerance.
+  double epsilon;
+  //! Number of clusters.
+  size_t numClusters;
+  //! Maximum order of the expansions.
+  size_t maxOrder;
+  //! Order of the expansions.
+  size_t order;
+  //! Cutoff radius.
+  double cutoffRadius;
+  //! Number of reference points.
+  size_t numPoints;
+
+  //! Centers of the clusters.
+  arma::mat centers;
+  //! Radius of each cluster.
+  arma::vec radii;
+  //! Coefficients of the expansion of each cluster, one column per cluster.
+  arma::mat coefficients;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
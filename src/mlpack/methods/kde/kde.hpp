@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
 
 #include "kde_stat.hpp"
 
@@ -63,6 +64,9 @@ struct KDEDefaultParams
  * probability density function of a variable in a non parametric way.
  * This implementation performs this estimation using a tree-independent
  * dual-tree algorithm. Details about this algorithm are available in KDERules.
+ * If OpenMP is available, both the dual-tree and single-tree evaluations run
+ * in parallel over disjoint sets of query points, with the same error
+ * guarantees.
  *
  * @tparam KernelType Kernel function to use for KDE calculations.
  * @tparam MetricType Metric to use for KDE calculations.
@@ -352,6 +356,32 @@ class KDE
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
+
+  //! Compute the Monte Carlo alpha of every node of the given tree, so that
+  //! parallel traversals only need to read it.
+  void ComputeMCAlpha(Tree& node) const;
+
+  /**
+   * Perform a dual-tree traversal of the given query tree and the reference
+   * tree.  If OpenMP is available, the query tree is split into disjoint
+   * subtrees that are traversed in parallel, each with its own rules object.
+   *
+   * @param queryTree Tree built on query points.
+   * @param rules Rules object that receives the estimations of all threads.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
+  /**
+   * Perform a single-tree traversal of the reference tree for every query
+   * point.  If OpenMP is available, the query points are split across threads,
+   * each with its own rules object.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules object that receives the estimations of all threads.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
 };
 
 } // namespace kde
@@ -451,12 +451,8 @@ Evaluate(MatType querySet, arma::vec& estimations)
                               monteCarlo,
                               false);
 
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
-
     // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(querySet.n_cols, rules);
 
     estimations /= referenceTree->Dataset().n_cols;
 
@@ -520,13 +516,11 @@ Evaluate(Tree* queryTree,
                                 "dual-tree");
   }
 
-  // Clean accumulated alpha if Monte Carlo estimations are available.
-  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
-  {
-    KDECleanRules<Tree> cleanRules;
-    SingleTreeTraversalType<KDECleanRules<Tree>> cleanTraverser(cleanRules);
-    cleanTraverser.Traverse(0, *queryTree);
-  }
+  // Clean the error tolerance (and the Monte Carlo alpha) accumulated by a
+  // previous evaluation with the same tree.
+  KDECleanRules<Tree> cleanRules;
+  SingleTreeTraversalType<KDECleanRules<Tree>> cleanTraverser(cleanRules);
+  cleanTraverser.Traverse(0, *queryTree);
 
   // Evaluate.
   typedef KDERules<MetricType, KernelType, Tree> RuleType;
@@ -544,9 +538,7 @@ Evaluate(Tree* queryTree,
                             monteCarlo,
                             false);
 
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, rules);
   estimations /= referenceTree->Dataset().n_cols;
 
   // Rearrange if necessary.
@@ -584,13 +576,11 @@ Evaluate(arma::vec& estimations)
   estimations.set_size(referenceTree->Dataset().n_cols);
   estimations.fill(arma::fill::zeros);
 
-  // Clean accumulated alpha if Monte Carlo estimations are available.
-  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
-  {
-    KDECleanRules<Tree> cleanRules;
-    SingleTreeTraversalType<KDECleanRules<Tree>> cleanTraverser(cleanRules);
-    cleanTraverser.Traverse(0, *referenceTree);
-  }
+  // Clean the error tolerance (and the Monte Carlo alpha) accumulated by a
+  // previous evaluation with the same tree.
+  KDECleanRules<Tree> cleanRules;
+  SingleTreeTraversalType<KDECleanRules<Tree>> cleanTraverser(cleanRules);
+  cleanTraverser.Traverse(0, *referenceTree);
 
   // Evaluate.
   typedef KDERules<MetricType, KernelType, Tree> RuleType;
@@ -609,17 +599,9 @@ Evaluate(arma::vec& estimations)
                             true);
 
   if (mode == DUAL_TREE_MODE)
-  {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
-  }
+    DualTreeTraversal(*referenceTree, rules);
   else if (mode == SINGLE_TREE_MODE)
-  {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-  }
+    SingleTreeTraversal(referenceTree->Dataset().n_cols, rules);
 
   estimations /= referenceTree->Dataset().n_cols;
   // Rearrange if necessary.
@@ -847,5 +829,164 @@ RearrangeEstimations(const std::vector<size_t>& oldFromNew,
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+ComputeMCAlpha(Tree& node) const
+{
+  // This gives the same alpha as KDERules::CalculateAlpha(): the root gets
+  // beta, and each node splits its alpha evenly between its children.
+  KDEStat& stat = node.Stat();
+  const double mcBeta = 1 - mcProb;
+  if (node.Parent() == NULL)
+    stat.MCAlpha() = mcBeta;
+  else
+    stat.MCAlpha() = node.Parent()->Stat().MCAlpha() /
+        node.Parent()->NumChildren();
+  stat.MCBeta() = mcBeta;
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    ComputeMCAlpha(node.Child(i));
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeTraversal(Tree& queryTree, RuleType& rules)
+{
+  // Split the query tree into several subtrees per thread, so that the dynamic
+  // schedule can balance the load when some subtrees are pruned much earlier
+  // than others.
+  std::vector<Tree*> frontier;
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+    tree::SubtreeFrontier(queryTree, 8 * numThreads, frontier);
+  #endif
+
+  if (frontier.size() <= 1)
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return;
+  }
+
+  // The reference nodes are shared by all threads, so their Monte Carlo alpha
+  // must be ready before the traversal.
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    ComputeMCAlpha(*referenceTree);
+
+  // Each subtree gets its own generator for Monte Carlo samples.
+  std::vector<uint32_t> seeds(frontier.size());
+  for (size_t i = 0; i < seeds.size(); ++i)
+    seeds[i] = math::RandGen()();
+
+  size_t threadScores = 0;
+  size_t threadBaseCases = 0;
+
+  #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+  {
+    MetricType threadMetric(metric);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The subtrees are disjoint, so each thread's rules can add directly to
+      // the densities of the main rules object.
+      std::mt19937 generator(seeds[i]);
+      RuleType threadRules(rules, threadMetric, generator);
+      DualTreeTraversalType<RuleType> traverser(threadRules);
+      traverser.Traverse(*frontier[i], *referenceTree);
+
+      threadScores += threadRules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+    }
+  }
+
+  rules.Scores() += threadScores;
+  rules.BaseCases() += threadBaseCases;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeTraversal(const size_t numQueries, RuleType& rules)
+{
+  #ifdef HAS_OPENMP
+  if (omp_get_max_threads() > 1)
+  {
+    if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+      ComputeMCAlpha(*referenceTree);
+
+    std::vector<uint32_t> seeds(omp_get_max_threads());
+    for (size_t i = 0; i < seeds.size(); ++i)
+      seeds[i] = math::RandGen()();
+
+    size_t threadScores = 0;
+    size_t threadBaseCases = 0;
+
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      // Each thread visits its own query points, so its rules can add directly
+      // to the densities of the main rules object.
+      MetricType threadMetric(metric);
+      std::mt19937 generator(seeds[omp_get_thread_num()]);
+      RuleType threadRules(rules, threadMetric, generator);
+      SingleTreeTraversalType<RuleType> traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadScores += threadRules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+    return;
+  }
+  #endif
+
+  SingleTreeTraversalType<RuleType> traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+}
+
 } // namespace kde
 } // namespace mlpack
@@ -253,6 +253,21 @@ void KDEModel::Evaluate(util::Timers& timers, arma::vec& estimates)
   kdeModel->Evaluate(timers, estimates);
 }
 
+// Prepare the given query set for several evaluations.
+tree::PreparedQueries* KDEModel::PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet)
+{
+  return kdeModel->PrepareQueries(timers, std::move(querySet));
+}
+
+// Perform bichromatic evaluation with prepared queries.
+void KDEModel::Evaluate(util::Timers& timers,
+                        tree::PreparedQueries& queries,
+                        arma::vec& estimates)
+{
+  kdeModel->Evaluate(timers, queries, estimates);
+}
+
 // Clean memory.
 void KDEModel::CleanMemory()
 {
@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/octree.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/prepared_queries.hpp>
 
 // Include core.
 #include <mlpack/core.hpp>
@@ -125,6 +126,17 @@ class KDEWrapperBase
 
   //! Perform monochromatic KDE (i.e. with the reference set as the query set).
   virtual void Evaluate(util::Timers& timers, arma::vec& estimates) = 0;
+
+  //! Prepare the given query set for several bichromatic evaluations, building
+  //! the query tree if the search mode uses one.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet) = 0;
+
+  //! Perform bichromatic KDE with queries prepared by a wrapper with the same
+  //! tree type.
+  virtual void Evaluate(util::Timers& timers,
+                        tree::PreparedQueries& queries,
+                        arma::vec& estimates) = 0;
 };
 
 /**
@@ -205,6 +217,16 @@ class KDEWrapper : public KDEWrapperBase
   //! Perform monochromatic KDE (i.e. with the reference set as the query set).
   virtual void Evaluate(util::Timers& timers, arma::vec& estimates);
 
+  //! Prepare the given query set for several bichromatic evaluations.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet);
+
+  //! Perform bichromatic KDE with prepared queries.  In dual-tree mode, the
+  //! queries must hold a query tree of this type.
+  virtual void Evaluate(util::Timers& timers,
+                        tree::PreparedQueries& queries,
+                        arma::vec& estimates);
+
   //! Serialize the KDE model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -459,6 +481,33 @@ class KDEModel
    */
   void Evaluate(util::Timers& timers, arma::vec& estimations);
 
+  /**
+   * Prepare the given query set for several evaluations with Evaluate(),
+   * building the query tree (in dual-tree mode) only once.  The query tree
+   * does not depend on the kernel, so the queries can also be evaluated with
+   * other models that use the same tree type and mode.  The caller owns the
+   * returned object, which must be deleted when it is no longer needed.
+   *
+   * @param timers Object to hold timing information in.
+   * @param querySet Set of query points (will be moved).
+   */
+  tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                        arma::mat&& querySet);
+
+  /**
+   * Perform kernel density estimation with queries prepared by
+   * PrepareQueries().  If possible, it returns normalized estimations.
+   *
+   * @pre The model has to be previously created with BuildModel.
+   * @param timers Object to hold timing information in.
+   * @param queries Queries prepared by PrepareQueries().
+   * @param estimations Vector where the results will be stored in the same
+   *                    order as the original query points.
+   */
+  void Evaluate(util::Timers& timers,
+                tree::PreparedQueries& queries,
+                arma::vec& estimations);
+
 
  private:
   //! Clean memory.
@@ -90,6 +90,68 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
   timers.Stop("applying_normalizer");
 }
 
+//! Prepare the given query set for several bichromatic evaluations.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+tree::PreparedQueries* KDEWrapper<KernelType, TreeType>::PrepareQueries(
+    util::Timers& timers,
+    arma::mat&& querySet)
+{
+  if (kde.Mode() != DUAL_TREE_MODE)
+    return new tree::PreparedQueries(std::move(querySet));
+
+  timers.Start("tree_building");
+  std::vector<size_t> oldFromNewQueries;
+  typename decltype(kde)::Tree* queryTree = BuildTree<
+      typename decltype(kde)::Tree>(std::move(querySet), oldFromNewQueries);
+  timers.Stop("tree_building");
+
+  return new tree::PreparedQueryTree<typename decltype(kde)::Tree>(queryTree,
+      std::move(oldFromNewQueries));
+}
+
+//! Perform bichromatic KDE with prepared queries.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
+                                                tree::PreparedQueries& queries,
+                                                arma::vec& estimates)
+{
+  const size_t dimension = queries.QuerySet().n_rows;
+  timers.Start("computing_kde");
+  if (kde.Mode() == DUAL_TREE_MODE)
+  {
+    typedef tree::PreparedQueryTree<typename decltype(kde)::Tree>
+        QueryTreeType;
+    QueryTreeType* queryTree = dynamic_cast<QueryTreeType*>(&queries);
+    if (queryTree == NULL)
+    {
+      timers.Stop("computing_kde");
+      throw std::invalid_argument("KDEModel::Evaluate(): the queries were not "
+          "prepared with a query tree of the type used by the model");
+    }
+
+    // The statistics of the query tree are cleaned by KDE, and the estimations
+    // are returned in the original order of the queries.
+    kde.Evaluate(&queryTree->Tree(), queries.OldFromNew(), estimates);
+  }
+  else
+  {
+    kde.Evaluate(queries.QuerySet(), estimates);
+  }
+  timers.Stop("computing_kde");
+
+  timers.Start("applying_normalizer");
+  KernelNormalizer::ApplyNormalizer<KernelType>(kde.Kernel(),
+                                                dimension,
+                                                estimates);
+  timers.Stop("applying_normalizer");
+}
+
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
@@ -60,6 +60,22 @@ class KDERules
            const bool monteCarlo,
            const bool sameSet);
 
+  /**
+   * Construct a KDERules object for one thread of a parallel traversal.  The
+   * new object has its own traversal information and statistics, but it adds
+   * its estimations directly to the densities (and error tolerances) of the
+   * given rules object.  Each thread must visit a set of query points that is
+   * disjoint from the sets of query points visited by every other thread.  The
+   * Monte Carlo alpha of every reference node must already be computed (see
+   * KDE), since it is not safe to compute it from several threads.
+   *
+   * @param other Rules object whose densities will be used.
+   * @param metric Instantiated metric for this thread.
+   * @param generator Random number generator for the Monte Carlo samples of
+   *      this thread.
+   */
+  KDERules(KDERules& other, MetricType& metric, std::mt19937& generator);
+
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -89,9 +105,13 @@ class KDERules
 
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
 
   //! Get the number of scores.
   size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
 
   //! Get the minimum number of base cases we need to perform to have acceptable
   //! results.
@@ -109,6 +129,9 @@ class KDERules
   //! Calculate depth alpha for some node.
   double CalculateAlpha(TreeType* node);
 
+  //! Pick a random index in [lo, hiExclusive) for Monte Carlo samples.
+  size_t RandomIndex(const size_t lo, const size_t hiExclusive);
+
   //! The reference set.
   const arma::mat& referenceSet;
 
@@ -149,6 +172,9 @@ class KDERules
   //! Whether Monte Carlo estimations are going to be applied.
   const bool monteCarlo;
 
+  //! Random number generator for Monte Carlo samples.
+  std::mt19937& generator;
+
   //! Accumulated not used MC alpha values for each query point.
   arma::vec accumMCAlpha;
 
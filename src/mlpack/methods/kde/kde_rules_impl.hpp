@@ -49,6 +49,7 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     metric(metric),
     kernel(kernel),
     monteCarlo(monteCarlo),
+    generator(math::RandGen()),
     sameSet(sameSet),
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
@@ -64,6 +65,42 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     accumMCAlpha = arma::vec(querySet.n_cols, arma::fill::zeros);
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    KDERules& other,
+    MetricType& metric,
+    std::mt19937& generator) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    densities(other.densities),
+    absError(other.absError),
+    relError(other.relError),
+    mcBeta(other.mcBeta),
+    initialSampleSize(other.initialSampleSize),
+    mcAccessCoef(other.mcAccessCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    metric(metric),
+    kernel(other.kernel),
+    monteCarlo(other.monteCarlo),
+    generator(generator),
+    sameSet(other.sameSet),
+    absErrorTol(other.absErrorTol),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Use the accumulated error tolerances of the other object, without copying
+  // them; each thread only touches those of its own query points.
+  accumError = arma::vec(other.accumError.memptr(), other.accumError.n_elem,
+      false, true);
+  if (other.accumMCAlpha.n_elem > 0)
+  {
+    accumMCAlpha = arma::vec(other.accumMCAlpha.memptr(),
+        other.accumMCAlpha.n_elem, false, true);
+  }
+}
+
 //! The base case.
 template<typename MetricType, typename KernelType, typename TreeType>
 inline force_inline
@@ -222,9 +259,9 @@ Score(const size_t queryIndex, TreeType& referenceNode)
         // Sample and evaluate random points from the reference node.
         size_t randomPoint;
         if (alreadyDidRefPoint0)
-          randomPoint = math::RandInt(1, refNumDesc);
+          randomPoint = RandomIndex(1, refNumDesc);
         else
-          randomPoint = math::RandInt(0, refNumDesc);
+          randomPoint = RandomIndex(0, refNumDesc);
 
         sample(oldSize + i) =
             EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -439,9 +476,9 @@ Score(TreeType& queryNode, TreeType& referenceNode)
           // Sample and evaluate random points from the reference node.
           size_t randomPoint;
           if (alreadyDidRefPoint0)
-            randomPoint = math::RandInt(1, refNumDesc);
+            randomPoint = RandomIndex(1, refNumDesc);
           else
-            randomPoint = math::RandInt(0, refNumDesc);
+            randomPoint = RandomIndex(0, refNumDesc);
 
           sample(oldSize + i) =
               EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -573,6 +610,16 @@ CalculateAlpha(TreeType* node)
   return stat.MCAlpha();
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline size_t KDERules<MetricType, KernelType, TreeType>::
+RandomIndex(const size_t lo, const size_t hiExclusive)
+{
+  // This gives the same indices as math::RandInt() for the same generator.
+  std::uniform_real_distribution<> uniform;
+  return lo + (size_t) std::floor((double) (hiExclusive - lo) *
+      uniform(generator));
+}
+
 //! Clean rules base case.
 template<typename TreeType>
 inline force_inline
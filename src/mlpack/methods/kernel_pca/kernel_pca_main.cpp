@@ -36,6 +36,7 @@
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_features_method.hpp>
 
 #include "kernel_pca.hpp"
 
@@ -102,7 +103,14 @@ BINDING_LONG_DESC(
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystroem method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.");
+    "following list: 'kmeans', 'random', 'ordered'."
+    "\n\n"
+    "For the 'gaussian' and 'laplacian' kernels, the kernel can instead be "
+    "approximated with random Fourier features (\"Random Features for "
+    "Large-Scale Kernel Machines\", 2008) by setting the number of features "
+    "with the " + PRINT_PARAM_STRING("random_features") + " parameter.  This "
+    "scales linearly with the number of points, and the number of features "
+    "must be at least the new dimensionality.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -138,6 +146,9 @@ PARAM_FLAG("nystroem_method", "If set, the Nystroem method will be used.", "n");
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the Nystroem method: "
     "'kmeans', 'random', 'ordered'", "s", "kmeans");
 
+PARAM_INT_IN("random_features", "If not 0, approximate the 'gaussian' or "
+    "'laplacian' kernel with this many random Fourier features.", "R", 0);
+
 PARAM_DOUBLE_IN("kernel_scale", "Scale, for 'hyptan' kernel.", "S", 1.0);
 PARAM_DOUBLE_IN("offset", "Offset, for 'hyptan' and 'polynomial' kernels.", "O",
     0.0);
@@ -190,6 +201,22 @@ void RunKPCA(arma::mat& dataset,
   }
 }
 
+//! Run KPCA with random Fourier features for the given kernel type.
+template<typename KernelType>
+void RunRandomFeaturesKPCA(arma::mat& dataset,
+                           const bool centerTransformedData,
+                           const size_t newDim,
+                           const size_t features,
+                           KernelType& kernel)
+{
+  KernelPCA<KernelType, RandomFourierFeaturesKernelRule<KernelType>> kpca(
+      kernel, centerTransformedData);
+  kpca.Apply(dataset, features);
+
+  if (newDim < dataset.n_rows)
+    dataset.shed_rows(newDim, dataset.n_rows - 1);
+}
+
 void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
 {
   RequireAtLeastOnePassed(params, { "output" }, false,
@@ -222,6 +249,26 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
   const bool nystroem = params.Has("nystroem_method");
   const string sampling = params.Get<string>("sampling");
 
+  RequireParamValue<int>(params, "random_features",
+      [](int x) { return x >= 0; }, true,
+      "number of random features must be nonnegative");
+  const size_t features = (size_t) params.Get<int>("random_features");
+  if (features > 0)
+  {
+    RequireParamInSet<string>(params, "kernel", { "gaussian", "laplacian" },
+        true, "random features are only available for some kernels");
+    if (nystroem)
+    {
+      Log::Fatal << "Cannot use both the Nystroem method and random features!"
+          << endl;
+    }
+    if (features < newDim)
+    {
+      Log::Fatal << "The number of random features (" << features << ") must "
+          << "be at least the new dimensionality (" << newDim << ")!" << endl;
+    }
+  }
+
   if (kernelType == "linear")
   {
     LinearKernel kernel;
@@ -233,8 +280,16 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
     const double bandwidth = params.Get<double>("bandwidth");
 
     GaussianKernel kernel(bandwidth);
-    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (features > 0)
+    {
+      RunRandomFeaturesKPCA(dataset, centerTransformedData, newDim, features,
+          kernel);
+    }
+    else
+    {
+      RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem,
+          newDim, sampling, kernel);
+    }
   }
   else if (kernelType == "polynomial")
   {
@@ -259,8 +314,16 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
     const double bandwidth = params.Get<double>("bandwidth");
 
     LaplacianKernel kernel(bandwidth);
-    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (features > 0)
+    {
+      RunRandomFeaturesKPCA(dataset, centerTransformedData, newDim, features,
+          kernel);
+    }
+    else
+    {
+      RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem,
+          newDim, sampling, kernel);
+    }
   }
   else if (kernelType == "epanechnikov")
   {
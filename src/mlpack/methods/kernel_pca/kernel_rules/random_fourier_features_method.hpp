@@ -0,0 +1,124 @@
+/**
+ * @file methods/kernel_pca/kernel_rules/random_fourier_features_method.hpp
+ *
+ * Use random Fourier features for approximating a kernel matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_FEATURES_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_FEATURES_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Approximate the kernel with random Fourier features, as described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random Features for Large-Scale Kernel Machines},
+ *   author={Rahimi, A. and Recht, B.},
+ *   booktitle={Advances in Neural Information Processing Systems 20
+ *       (NIPS 2007)},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each point x is mapped to z(x) = sqrt(2 / D) cos(W x + b), where the D rows
+ * of W are drawn from the Fourier transform of the kernel and b is uniform in
+ * [0, 2 pi], so that z(x)^T z(y) approximates K(x, y).  Kernel PCA is then
+ * regular PCA of the centered features, which takes O(n D^2) time and O(n D)
+ * memory instead of the O(n^2) kernel matrix.  The rank given to
+ * ApplyKernelMatrix() is the number of features D.
+ *
+ * Only shift-invariant kernels have such a transform; GaussianKernel and
+ * LaplacianKernel are supported.
+ */
+template<typename KernelType = kernel::GaussianKernel>
+class RandomFourierFeaturesKernelRule
+{
+ public:
+  /**
+   * Compute the kernel principal components with random Fourier features.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec Principal components of the random features will be written
+   *     to this matrix.
+   * @param rank Number of random features to use.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    arma::mat frequencies;
+    Frequencies(kernel, data.n_rows, rank, frequencies);
+    const arma::vec phases = 2 * M_PI * arma::randu<arma::vec>(rank);
+
+    // Map the points to the random features.
+    arma::mat features = frequencies * data;
+    features.each_col() += phases;
+    features = std::sqrt(2.0 / rank) * arma::cos(features);
+
+    // For PCA the data has to be centered in the feature space; here the
+    // features are explicit, so they can be centered directly.
+    features.each_col() -= arma::mean(features, 1);
+
+    // The nonzero eigenvalues of the approximate kernel matrix Z^T Z are the
+    // squared singular values of Z, and the projections of the points on the
+    // principal components are S V^T.
+    arma::mat v;
+    if (!arma::svd_econ(eigvec, eigval, v, features))
+    {
+      Log::Fatal << "Failed to decompose the random features." << std::endl;
+    }
+
+    transformedData = v.t();
+    transformedData.each_col() %= eigval;
+    eigval %= eigval;
+  }
+
+ private:
+  //! Draw the frequencies for the Gaussian kernel, N(0, I / bandwidth^2).
+  static void Frequencies(const kernel::GaussianKernel& kernel,
+                          const size_t dimensionality,
+                          const size_t rank,
+                          arma::mat& frequencies)
+  {
+    frequencies = arma::randn<arma::mat>(rank, dimensionality) /
+        kernel.Bandwidth();
+  }
+
+  //! Draw the frequencies for the Laplacian kernel, a multivariate Cauchy
+  //! distribution with scale 1 / bandwidth: a Gaussian vector divided by the
+  //! absolute value of a Gaussian, for each row.
+  static void Frequencies(const kernel::LaplacianKernel& kernel,
+                          const size_t dimensionality,
+                          const size_t rank,
+                          arma::mat& frequencies)
+  {
+    frequencies = arma::randn<arma::mat>(rank, dimensionality) /
+        kernel.Bandwidth();
+    frequencies.each_col() /= arma::abs(arma::randn<arma::vec>(rank));
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
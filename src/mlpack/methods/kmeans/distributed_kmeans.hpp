@@ -0,0 +1,151 @@
+/**
+ * @file methods/kmeans/distributed_kmeans.hpp
+ *
+ * Definition of DistributedKMeans, which runs k-means over a dataset that is
+ * split between several processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans.hpp"
+#include "local_communicator.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * DistributedKMeans runs Lloyd iterations over a dataset that is split into
+ * shards, each held by one process (one rank of the communicator).  In each
+ * iteration, every rank runs one step of the LloydStepType on its shard, which
+ * gives the number of its points in each cluster and their mean; the sums and
+ * the counts are then summed over all the ranks with one all-reduce, so every
+ * rank computes the same new centroids.  The result is the same as clustering
+ * the whole dataset with KMeans and the same initial centroids (up to
+ * floating-point rounding), except that an empty cluster keeps its centroid.
+ *
+ * Each call of Cluster() must be made by all the ranks at the same time, with
+ * the same number of clusters.  Unless initial centroids are given, they are
+ * computed by rank 0 from its shard with the InitialPartitionPolicy, and sent to
+ * the other ranks.
+ *
+ * @code
+ * extern arma::mat shard; // The part of the dataset held by this rank.
+ * DistributedKMeans<MPICommunicator> k(MPICommunicator(MPI_COMM_WORLD));
+ * arma::mat centroids;
+ * arma::Row<size_t> assignments; // Assignments of the points of the shard.
+ * k.Cluster(shard, 10, assignments, centroids);
+ * @endcode
+ *
+ * @tparam CommunicatorType Communicator of the ranks; see LocalCommunicator.
+ * @tparam MetricType The distance metric to use.
+ * @tparam InitialPartitionPolicy Initial partitioning policy (see KMeans).
+ * @tparam LloydStepType Implementation of single Lloyd step to use; its
+ *     Iterate() must accept any centroids, not only the ones it returned last
+ *     (NaiveKMeans, ElkanKMeans, HamerlyKMeans and PellegMooreKMeans do;
+ *     DualTreeKMeans does not).
+ * @tparam MatType Type of the data matrix.
+ */
+template<typename CommunicatorType = LocalCommunicator,
+         typename MetricType = metric::EuclideanDistance,
+         typename InitialPartitionPolicy = SampleInitialization,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MatType = arma::mat>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create the DistributedKMeans object.
+   *
+   * @param communicator Communicator of the ranks that hold the data.
+   * @param maxIterations Maximum number of iterations allowed before giving up
+   *     (0 means no limit).
+   * @param metric Optional MetricType object.
+   * @param partitioner Optional InitialPartitionPolicy object.
+   */
+  DistributedKMeans(
+      CommunicatorType communicator = CommunicatorType(),
+      const size_t maxIterations = 1000,
+      const MetricType metric = MetricType(),
+      const InitialPartitionPolicy partitioner = InitialPartitionPolicy());
+
+  /**
+   * Cluster the dataset whose shard is given, and store the centroids (the
+   * same on every rank).
+   *
+   * @param data Shard of the dataset held by this rank.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then centroids holds the initial centroids;
+   *     they must be the same on every rank.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Cluster the dataset whose shard is given, and store the centroids and the
+   * assignments of the points of the shard.
+   *
+   * @param data Shard of the dataset held by this rank.
+   * @param clusters Number of clusters to compute.
+   * @param assignments Vector to store the assignments of the shard in.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then centroids holds the initial centroids;
+   *     they must be the same on every rank.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::Row<size_t>& assignments,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the communicator.
+  const CommunicatorType& Communicator() const { return communicator; }
+  //! Modify the communicator.
+  CommunicatorType& Communicator() { return communicator; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Set the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the initial partitioning policy.
+  const InitialPartitionPolicy& Partitioner() const { return partitioner; }
+  //! Modify the initial partitioning policy.
+  InitialPartitionPolicy& Partitioner() { return partitioner; }
+
+ private:
+  //! Compute the initial centroids on rank 0 and send them to all ranks.
+  void InitialCentroids(const MatType& data,
+                        const size_t clusters,
+                        arma::mat& centroids);
+
+  //! The communicator of the ranks.
+  CommunicatorType communicator;
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Instantiated initial partitioning policy.
+  InitialPartitionPolicy partitioner;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
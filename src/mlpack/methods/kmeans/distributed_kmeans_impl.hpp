@@ -0,0 +1,222 @@
+/**
+ * @file methods/kmeans/distributed_kmeans_impl.hpp
+ *
+ * Implementation of DistributedKMeans.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    LloydStepType,
+    MatType>::
+DistributedKMeans(CommunicatorType communicator,
+                  const size_t maxIterations,
+                  const MetricType metric,
+                  const InitialPartitionPolicy partitioner) :
+    communicator(communicator),
+    maxIterations(maxIterations),
+    metric(metric),
+    partitioner(partitioner)
+{
+  // Nothing to do.
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    LloydStepType,
+    MatType>::
+Cluster(const MatType& data,
+        const size_t clusters,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  if (clusters == 0)
+  {
+    Log::Fatal << "DistributedKMeans::Cluster(): zero clusters requested!"
+        << std::endl;
+  }
+
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters || centroids.n_rows != data.n_rows)
+    {
+      Log::Fatal << "DistributedKMeans::Cluster(): initial centroids have "
+          << "size " << centroids.n_rows << "x" << centroids.n_cols
+          << ", should be " << data.n_rows << "x" << clusters << "!"
+          << std::endl;
+    }
+  }
+  else
+  {
+    InitialCentroids(data, clusters, centroids);
+  }
+
+  LloydStepType<MetricType, MatType> lloydStep(data, metric);
+  arma::mat localCentroids;
+  arma::Col<size_t> localCounts;
+  // The sums of the points of each cluster, with the counts in the last row,
+  // so that one all-reduce combines both.
+  arma::mat sums(data.n_rows + 1, clusters);
+
+  size_t iteration = 0;
+  double cNorm;
+  do
+  {
+    lloydStep.Iterate(centroids, localCentroids, localCounts);
+
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      sums.col(c).head(data.n_rows) = localCentroids.col(c) *
+          (double) localCounts[c];
+      sums(data.n_rows, c) = (double) localCounts[c];
+    }
+    communicator.AllReduceSum(sums);
+
+    // Every rank has the same sums, so it computes the same centroids.  An
+    // empty cluster keeps its centroid.
+    cNorm = 0.0;
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      const double count = sums(data.n_rows, c);
+      if (count == 0.0)
+        continue;
+
+      const arma::vec newCentroid = sums.col(c).head(data.n_rows) / count;
+      cNorm += std::pow(metric.Evaluate(newCentroid, centroids.col(c)), 2.0);
+      centroids.col(c) = newCentroid;
+    }
+    cNorm = std::sqrt(cNorm);
+
+    ++iteration;
+    Log::Info << "DistributedKMeans::Cluster(): iteration " << iteration
+        << ", residual " << cNorm << "." << std::endl;
+    if (std::isnan(cNorm) || std::isinf(cNorm))
+      cNorm = 1e-4; // Keep iterating.
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  Log::Info << "DistributedKMeans::Cluster(): "
+      << ((iteration != maxIterations) ? "converged" : "terminated")
+      << " after " << iteration << " iterations; "
+      << lloydStep.DistanceCalculations() << " distance calculations on rank "
+      << communicator.Rank() << "." << std::endl;
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    LloydStepType,
+    MatType>::
+Cluster(const MatType& data,
+        const size_t clusters,
+        arma::Row<size_t>& assignments,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  Cluster(data, clusters, centroids, initialGuess);
+
+  // Assign each point of the shard to its closest centroid.
+  assignments.set_size(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = 0;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    assignments[i] = closestCluster;
+  }
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    LloydStepType,
+    MatType>::
+InitialCentroids(const MatType& data,
+                 const size_t clusters,
+                 arma::mat& centroids)
+{
+  // Only rank 0 computes the centroids; the other ranks add zeros, so the
+  // all-reduce sends the centroids of rank 0 to every rank.
+  arma::mat initial(data.n_rows, clusters, arma::fill::zeros);
+  if (communicator.Rank() == 0)
+  {
+    if (data.n_cols < clusters)
+    {
+      Log::Warn << "DistributedKMeans::Cluster(): rank 0 holds fewer points "
+          << "than the number of clusters." << std::endl;
+    }
+
+    arma::Row<size_t> assignments;
+    if (GetInitialAssignmentsOrCentroids(partitioner, data, clusters,
+        assignments, initial))
+    {
+      // The partitioner gives assignments, so compute the centroids from them.
+      arma::Col<size_t> counts(clusters, arma::fill::zeros);
+      initial.zeros(data.n_rows, clusters);
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        initial.col(assignments[i]) += arma::vec(data.col(i));
+        counts[assignments[i]]++;
+      }
+
+      for (size_t c = 0; c < clusters; ++c)
+        if (counts[c] != 0)
+          initial.col(c) /= counts[c];
+    }
+  }
+
+  communicator.AllReduceSum(initial);
+  centroids = std::move(initial);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
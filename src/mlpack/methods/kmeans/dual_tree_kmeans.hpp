@@ -18,6 +18,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
 
 #include "dual_tree_kmeans_statistic.hpp"
 
@@ -50,6 +51,10 @@ class DualTreeKMeans
   using NNSTreeType =
       TreeType<TreeMetricType, DualTreeKMeansStatistic, TreeMatType>;
 
+  //! The nearest neighbor search built on the centroids.
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+      MatType, NNSTreeType> CentroidSearchType;
+
   /**
    * Construct the DualTreeKMeans object, which will construct a tree on the
    * points.
@@ -78,6 +83,17 @@ class DualTreeKMeans
   //! Modify the number of distance calculations.
   size_t& DistanceCalculations() { return distanceCalculations; }
 
+  //! Get the threshold below which the centroid tree is refit instead of
+  //! rebuilt.
+  double RefitThreshold() const { return refitThreshold; }
+  //! Modify the threshold below which the centroid tree is refit instead of
+  //! rebuilt.  The tree built on the centroids is kept across iterations and
+  //! refit to the new centroids as long as the sum of the maximum centroid
+  //! movements since it was built is less than this fraction of the radius of
+  //! the tree (only trees that support refitting, like kd-trees, are refit).
+  //! Set to 0 to rebuild the tree at every iteration.
+  double& RefitThreshold() { return refitThreshold; }
+
  private:
   //! The original dataset reference.
   const MatType& datasetOrig; // Maybe not necessary.
@@ -102,7 +118,9 @@ class DualTreeKMeans
 
   arma::Row<size_t> assignments;
 
-  std::vector<bool> visited; // Was the point visited this iteration?
+  // Was the point visited this iteration?  (Threads of the traversal set the
+  // flags of different points, so these cannot be packed as bits.)
+  std::vector<char> visited;
 
   arma::mat lastIterationCentroids; // For sanity checks.
 
@@ -110,6 +128,16 @@ class DualTreeKMeans
 
   arma::mat interclusterDistances; // Static storage for intercluster distances.
 
+  //! The search on the centroids, which holds the centroid tree.
+  CentroidSearchType* centroidSearch;
+  //! The mapping of the centroids in the centroid tree.
+  std::vector<size_t> oldFromNewCentroids;
+  //! The threshold below which the centroid tree is refit.
+  double refitThreshold;
+  //! The sum of the maximum centroid movements since the centroid tree was
+  //! built.
+  double movementSinceBuild;
+
   //! Update the bounds in the tree before the next iteration.
   //! centroids is the current (not yet searched) centroids.
   void UpdateTree(Tree& node,
@@ -158,6 +186,26 @@ void RestoreChildren(TreeType& node,
                      const typename std::enable_if_t<tree::TreeTraits<
                          TreeType>::BinaryTree>* junk = 0);
 
+//! Refit a tree built on the centroids to the given centroids; this does
+//! nothing and returns false for trees that do not support refitting.
+template<typename TreeType>
+bool RefitTree(TreeType& tree,
+               const arma::mat& centroids,
+               const std::vector<size_t>& oldFromNew);
+
+//! Refit a binary space tree built on the centroids to the given centroids,
+//! and return true.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool RefitTree(tree::BinarySpaceTree<MetricType, StatisticType, MatType,
+                   BoundType, SplitType>& tree,
+               const arma::mat& centroids,
+               const std::vector<size_t>& oldFromNew);
+
 //! A template typedef for the DualTreeKMeans algorithm with the default tree
 //! type (a kd-tree).
 template<typename MetricType, typename MatType>
@@ -65,7 +65,10 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     lowerBounds(dataset.n_cols),
     prunedPoints(dataset.n_cols, false), // Fill with false.
     assignments(dataset.n_cols),
-    visited(dataset.n_cols, false) // Fill with false.
+    visited(dataset.n_cols, false), // Fill with false.
+    centroidSearch(NULL),
+    refitThreshold(0.05),
+    movementSinceBuild(0.0)
 {
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
@@ -86,6 +89,7 @@ DualTreeKMeans<MetricType, MatType, TreeType>::~DualTreeKMeans()
 {
   if (tree)
     delete tree;
+  delete centroidSearch;
 }
 
 // Run a single iteration.
@@ -99,16 +103,46 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::mat& newCentroids,
     arma::Col<size_t>& counts)
 {
-  // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
-  std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  // If the centroids have not moved much since the centroid tree was built,
+  // refit the tree of the last iteration to the new centroids instead of
+  // building a new one.  The refit tree has the same structure, so it stays
+  // valid, but it gets less efficient as the centroids move.
+  bool refit = false;
+  if (centroidSearch != NULL && refitThreshold > 0.0)
+  {
+    double maxMovement = 0.0;
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      maxMovement = std::max(maxMovement, metric.Evaluate(centroids.col(c),
+          lastIterationCentroids.col(c)));
+    }
+    distanceCalculations += centroids.n_cols;
+
+    movementSinceBuild += maxMovement;
+    if (movementSinceBuild < refitThreshold *
+        centroidSearch->ReferenceTree().FurthestDescendantDistance())
+    {
+      refit = RefitTree(centroidSearch->ReferenceTree(), centroids,
+          oldFromNewCentroids);
+    }
+  }
+
+  if (!refit)
+  {
+    // Build a tree on the centroids.  This will make a copy if necessary,
+    // which is unfortunate, but I don't see a reasonable way around it.
+    delete centroidSearch;
+    Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+
+    // Find the nearest neighbors of each of the clusters.  We have to make our
+    // own TreeType, which is a little bit abuse, but we know for sure the
+    // TreeStatType we have will work.
+    centroidSearch = new CentroidSearchType(std::move(*centroidTree));
+    delete centroidTree;
+    movementSinceBuild = 0.0;
+  }
 
-  // Find the nearest neighbors of each of the clusters.  We have to make our
-  // own TreeType, which is a little bit abuse, but we know for sure the
-  // TreeStatType we have will work.
-  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
-      NNSTreeType> nns(std::move(*centroidTree));
+  CentroidSearchType& nns = *centroidSearch;
 
   // Reset information in the tree, if we need to.
   if (iteration > 0)
@@ -151,14 +185,64 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
       upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
       visited);
 
-  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
-      traverser(rules);
+  typedef typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+      TraverserType;
 
   CoalesceTree(*tree);
 
-  // Set the number of pruned centroids in the root to 0.
-  tree->Stat().Pruned() = 0;
-  traverser.Traverse(*tree, nns.ReferenceTree());
+  // Split the tree into several subtrees per thread, so that the dynamic
+  // schedule can balance the load when some subtrees are pruned much earlier
+  // than others.  Statically pruned nodes must not be traversed, so they are
+  // not split.
+  std::vector<Tree*> frontier;
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    tree::SubtreeFrontier(*tree, 8 * numThreads, frontier,
+        [](const Tree& node) { return !node.Stat().StaticPruned(); });
+  }
+  #endif
+
+  if (frontier.size() <= 1)
+  {
+    // Set the number of pruned centroids in the root to 0.
+    tree->Stat().Pruned() = 0;
+    TraverserType traverser(rules);
+    traverser.Traverse(*tree, nns.ReferenceTree());
+  }
+  else
+  {
+    // Each subtree is traversed like the root, so its number of pruned
+    // centroids is set to 0.
+    for (size_t i = 0; i < frontier.size(); ++i)
+      if (!frontier[i]->Stat().StaticPruned())
+        frontier[i]->Stat().Pruned() = 0;
+
+    size_t threadScores = 0;
+    size_t threadBaseCases = 0;
+
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      MetricType threadMetric(metric);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+      {
+        // The subtrees are disjoint, so each thread's rules can update the
+        // bounds and assignments of the main rules object directly.
+        RuleType threadRules(rules, threadMetric);
+        TraverserType traverser(threadRules);
+        traverser.Traverse(*frontier[i], nns.ReferenceTree());
+
+        threadScores += threadRules.Scores();
+        threadBaseCases += threadRules.BaseCases();
+      }
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+  }
   distanceCalculations += rules.BaseCases() + rules.Scores();
 
   DecoalesceTree(*tree);
@@ -191,8 +275,6 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   distanceCalculations += centroids.n_cols;
 
-  delete centroidTree;
-
   ++iteration;
 
   return std::sqrt(residual);
@@ -619,6 +701,35 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::DecoalesceTree(Tree& node)
     DecoalesceTree(node.Child(i));
 }
 
+//! Refit a tree that does not support refitting (do nothing).
+template<typename TreeType>
+bool RefitTree(TreeType& /* tree */,
+               const arma::mat& /* centroids */,
+               const std::vector<size_t>& /* oldFromNew */)
+{
+  return false;
+}
+
+//! Refit a binary space tree to the given centroids.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool RefitTree(tree::BinarySpaceTree<MetricType, StatisticType, MatType,
+                   BoundType, SplitType>& tree,
+               const arma::mat& centroids,
+               const std::vector<size_t>& oldFromNew)
+{
+  // The tree holds the centroids in its own order.
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    tree.Dataset().col(i) = centroids.col(oldFromNew[i]);
+
+  tree.RefitBounds();
+  return true;
+}
+
 //! Utility function for hiding children in a non-binary tree.
 template<typename TreeType>
 void HideChild(TreeType& node,
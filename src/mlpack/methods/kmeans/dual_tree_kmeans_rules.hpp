@@ -31,7 +31,18 @@ class DualTreeKMeansRules
                       MetricType& metric,
                       const std::vector<bool>& prunedPoints,
                       const std::vector<size_t>& oldFromNewCentroids,
-                      std::vector<bool>& visited);
+                      std::vector<char>& visited);
+
+  /**
+   * Create a rules object for one thread of a parallel traversal, which
+   * shares the bounds and the assignments of the given rules object.  Each
+   * thread must visit a set of query nodes that is disjoint from the sets of
+   * query nodes visited by every other thread.
+   *
+   * @param other Rules object whose bounds and assignments will be used.
+   * @param metric Instantiated metric for this thread.
+   */
+  DualTreeKMeansRules(DualTreeKMeansRules& other, MetricType& metric);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -71,7 +82,7 @@ class DualTreeKMeansRules
 
   const std::vector<size_t>& oldFromNewCentroids;
 
-  std::vector<bool>& visited;
+  std::vector<char>& visited;
 
   size_t baseCases;
   size_t scores;
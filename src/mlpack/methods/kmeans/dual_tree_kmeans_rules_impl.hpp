@@ -27,7 +27,7 @@ DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
     MetricType& metric,
     const std::vector<bool>& prunedPoints,
     const std::vector<size_t>& oldFromNewCentroids,
-    std::vector<bool>& visited) :
+    std::vector<char>& visited) :
     centroids(centroids),
     dataset(dataset),
     assignments(assignments),
@@ -50,6 +50,31 @@ DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
   traversalInfo.LastReferenceNode() = (TreeType*) this;
 }
 
+template<typename MetricType, typename TreeType>
+DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
+    DualTreeKMeansRules& other,
+    MetricType& metric) :
+    centroids(other.centroids),
+    dataset(other.dataset),
+    assignments(other.assignments),
+    upperBounds(other.upperBounds),
+    lowerBounds(other.lowerBounds),
+    metric(metric),
+    prunedPoints(other.prunedPoints),
+    oldFromNewCentroids(other.oldFromNewCentroids),
+    visited(other.visited),
+    baseCases(0),
+    scores(0),
+    lastQueryIndex(dataset.n_cols),
+    lastReferenceIndex(centroids.n_cols),
+    lastBaseCase(0.0)
+{
+  // As in the other constructor, the last query and reference node pointers
+  // must be invalid but not NULL.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename MetricType, typename TreeType>
 inline force_inline double DualTreeKMeansRules<MetricType, TreeType>::BaseCase(
     const size_t queryIndex,
@@ -26,7 +26,8 @@ class ElkanKMeans
 
   /**
    * Run a single iteration of Elkan's algorithm, updating the given centroids
-   * into the newCentroids matrix.
+   * into the newCentroids matrix.  The points are assigned in parallel with
+   * OpenMP, if available, and the result is the same as with one thread.
    *
    * @param centroids Current cluster centroids.
    * @param newCentroids New cluster centroids.
@@ -56,6 +57,8 @@ class ElkanKMeans
   arma::vec upperBounds;
   //! Lower bounds on the distance between each point and each cluster.
   arma::mat lowerBounds;
+  //! The centroids that the bounds hold for.
+  arma::mat lastCentroids;
 
   //! Track distance calculations.
   size_t distanceCalculations;
@@ -46,8 +46,9 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
+  // Initially set r(x) to true.  (This is not a std::vector<bool>, so that
+  // threads can set the flags of different points at the same time.)
+  std::vector<char> mustRecalculate(dataset.n_cols, 1);
 
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
@@ -60,125 +61,165 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     upperBounds.fill(DBL_MAX);
     assignments.fill(0);
   }
+  else if (lastCentroids.n_cols == centroids.n_cols)
+  {
+    // The bounds hold for the centroids of the last iteration, so they are
+    // moved by the distance from those to the given centroids.  (These are
+    // usually the new centroids of the last iteration, but they can differ,
+    // for instance when an empty cluster was reinitialized, or when the
+    // centroids are combined over several processes.)
+    arma::vec moveDistances(centroids.n_cols);
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      moveDistances(c) = metric.Evaluate(centroids.col(c),
+          lastCentroids.col(c));
+    }
+    distanceCalculations += centroids.n_cols;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      // Step 5: for each point x and center c, assign
+      //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
+      // But it doesn't actually matter if l(x, c) is positive.
+      for (size_t c = 0; c < centroids.n_cols; ++c)
+        lowerBounds(c, i) -= moveDistances(c);
+
+      // Step 6: for each point x, assign
+      //   u(x) = u(x) + d(m(c(x)), c(x))
+      //   r(x) = true (we are setting that at the start of every iteration).
+      upperBounds(i) += moveDistances(assignments[i]);
+    }
+  }
 
   // Step 1: for all centers, compute between-cluster distances.  For all
   // centers, compute s(c) = 1/2 min d(c, c').
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) centroids.n_cols; ++i)
   {
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double distance = metric.Evaluate(centroids.col(i),
                                               centroids.col(j));
-      distanceCalculations++;
       clusterDistances(i, j) = distance;
       clusterDistances(j, i) = distance;
     }
   }
+  distanceCalculations += centroids.n_cols * (centroids.n_cols - 1) / 2;
 
   // Now find the closest cluster to each other cluster.  We multiply by 0.5 so
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  The
+  // points are handled in parallel; each thread sums the points assigned to
+  // each cluster separately, and the sums are combined at the end.
+  size_t localDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:localDistanceCalculations)
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
     {
-      for (size_t c = 0; c < centroids.n_cols; ++c)
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
       {
-        // Step 3: for all remaining points x and centers c such that c != c(x),
-        // u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
-        if (assignments[i] == c)
-          continue; // Pruned because this cluster is already the assignment.
-
-        if (upperBounds(i) <= lowerBounds(c, i))
-          continue; // Pruned by triangle inequality on lower bound.
-
-        if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
-          continue; // Pruned by triangle inequality on cluster distances.
-
-        // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
-        // Otherwise, d(x, c(x)) = u(x).
-        double dist;
-        if (mustRecalculate[i])
+        // No change needed.  This point must still belong to that cluster.
+        localCounts(assignments[i])++;
+        localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+        continue;
+      }
+      else
+      {
+        for (size_t c = 0; c < centroids.n_cols; ++c)
         {
-          mustRecalculate[i] = false;
-          dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
-          lowerBounds(assignments[i], i) = dist;
-          upperBounds(i) = dist;
-          distanceCalculations++;
+          // Step 3: for all remaining points x and centers c such that
+          // c != c(x), u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
+          if (assignments[i] == c)
+            continue; // Pruned because this cluster is already the assignment.
 
-          // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
             continue; // Pruned by triangle inequality on lower bound.
 
           if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
             continue; // Pruned by triangle inequality on cluster distances.
-        }
-        else
-        {
-          dist = upperBounds(i); // This is equivalent to d(x, c(x)).
-        }
 
-        // Step 3b: if d(x, c(x)) > l(x, c) or d(x, c(x)) > 0.5 d(c(x), c)...
-        if (dist > lowerBounds(c, i) ||
-            dist > 0.5 * clusterDistances(assignments[i], c))
-        {
-          // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
-          const double pointDist = metric.Evaluate(dataset.col(i),
-                                                   centroids.col(c));
-          lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
-          if (pointDist < dist)
+          // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
+          // Otherwise, d(x, c(x)) = u(x).
+          double dist;
+          if (mustRecalculate[i])
           {
-            upperBounds(i) = pointDist;
-            assignments[i] = c;
+            mustRecalculate[i] = 0;
+            dist = metric.Evaluate(dataset.col(i),
+                centroids.col(assignments[i]));
+            lowerBounds(assignments[i], i) = dist;
+            upperBounds(i) = dist;
+            ++localDistanceCalculations;
+
+            // Check if we can prune again.
+            if (upperBounds(i) <= lowerBounds(c, i))
+              continue; // Pruned by triangle inequality on lower bound.
+
+            if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
+              continue; // Pruned by triangle inequality on cluster distances.
+          }
+          else
+          {
+            dist = upperBounds(i); // This is equivalent to d(x, c(x)).
+          }
+
+          // Step 3b: if d(x, c(x)) > l(x, c) or d(x, c(x)) > 0.5 d(c(x), c)...
+          if (dist > lowerBounds(c, i) ||
+              dist > 0.5 * clusterDistances(assignments[i], c))
+          {
+            // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
+            const double pointDist = metric.Evaluate(dataset.col(i),
+                                                     centroids.col(c));
+            lowerBounds(c, i) = pointDist;
+            ++localDistanceCalculations;
+            if (pointDist < dist)
+            {
+              upperBounds(i) = pointDist;
+              assignments[i] = c;
+            }
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points assigned
+      // to c.
+      localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      localCounts[assignments[i]]++;
     }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    // Combine calculated state from each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
   }
+  distanceCalculations += localDistanceCalculations;
 
   // Now, normalize and calculate the distance each cluster has moved.
-  arma::vec moveDistances(centroids.n_cols);
   double cNorm = 0.0; // Cluster movement for residual.
   for (size_t c = 0; c < centroids.n_cols; ++c)
   {
     if (counts[c] > 0)
       newCentroids.col(c) /= counts[c];
 
-    moveDistances(c) = metric.Evaluate(newCentroids.col(c), centroids.col(c));
-    cNorm += std::pow(moveDistances(c), 2.0);
+    cNorm += std::pow(metric.Evaluate(newCentroids.col(c), centroids.col(c)),
+        2.0);
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    // Step 5: for each point x and center c, assign
-    //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
-    // But it doesn't actually matter if l(x, c) is positive.
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-      lowerBounds(c, i) -= moveDistances(c);
-
-    // Step 6: for each point x, assign
-    //   u(x) = u(x) + d(m(c(x)), c(x))
-    //   r(x) = true (we are setting that at the start of every iteration).
-    upperBounds(i) += moveDistances(assignments[i]);
-  }
+  // The bounds are moved at the start of the next iteration, once its
+  // centroids are known.
+  lastCentroids = centroids;
 
   return std::sqrt(cNorm);
 }
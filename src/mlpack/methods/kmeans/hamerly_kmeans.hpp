@@ -27,7 +27,8 @@ class HamerlyKMeans
 
   /**
    * Run a single iteration of Hamerly's algorithm, updating the given centroids
-   * into the newCentroids matrix.
+   * into the newCentroids matrix.  The points are assigned in parallel with
+   * OpenMP, if available, and the result is the same as with one thread.
    *
    * @param centroids Current cluster centroids.
    * @param newCentroids New cluster centroids.
@@ -52,6 +53,8 @@ class HamerlyKMeans
   arma::vec upperBounds;
   //! Lower bounds for each point.
   arma::vec lowerBounds;
+  //! The centroids that the bounds hold for.
+  arma::mat lastCentroids;
   //! Assignments for each point.
   arma::Col<size_t> assignments;
 
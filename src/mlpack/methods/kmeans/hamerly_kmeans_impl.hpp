@@ -44,6 +44,47 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     assignments.zeros(dataset.n_cols);
     minClusterDistances.set_size(centroids.n_cols);
   }
+  else if (lastCentroids.n_cols == centroids.n_cols)
+  {
+    // The bounds hold for the centroids of the last iteration, so they are
+    // moved by the distance from those to the given centroids (which are
+    // usually the new centroids of the last iteration, but can differ, for
+    // instance when the centroids are combined over several processes).  This
+    // contains parts of Move-Centers() and Update-Bounds().
+    double furthestMovement = 0.0;
+    double secondFurthestMovement = 0.0;
+    size_t furthestMovingCluster = 0;
+    arma::vec centroidMovements(centroids.n_cols);
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      const double movement = metric.Evaluate(centroids.col(c),
+                                              lastCentroids.col(c));
+      centroidMovements(c) = movement;
+      ++distanceCalculations;
+
+      if (movement > furthestMovement)
+      {
+        secondFurthestMovement = furthestMovement;
+        furthestMovement = movement;
+        furthestMovingCluster = c;
+      }
+      else if (movement > secondFurthestMovement)
+      {
+        secondFurthestMovement = movement;
+      }
+    }
+
+    // Now update bounds (lines 3-8 of Update-Bounds()).
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      upperBounds(i) += centroidMovements(assignments[i]);
+      if (assignments[i] == furthestMovingCluster)
+        lowerBounds(i) -= secondFurthestMovement;
+      else
+        lowerBounds(i) -= furthestMovement;
+    }
+  }
 
   // Reset new centroids.
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
@@ -67,105 +108,100 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // The points are handled in parallel; each thread sums the points assigned
+  // to each cluster separately, and the sums are combined at the end.
+  size_t localDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:hamerlyPruned, localDistanceCalculations)
   {
-    const double m = std::max(minClusterDistances(assignments[i]),
-                              lowerBounds(i));
-
-    // First bound test.
-    if (upperBounds(i) <= m)
-    {
-      ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
-
-    // Tighten upper bound.
-    upperBounds(i) = metric.Evaluate(dataset.col(i),
-                                     centroids.col(assignments[i]));
-    ++distanceCalculations;
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
 
-    // Second bound test.
-    if (upperBounds(i) <= m)
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
     {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
+      const double m = std::max(minClusterDistances(assignments[i]),
+                                lowerBounds(i));
 
-    // The bounds failed.  So test against all other clusters.
-    // This is Hamerly's Point-All-Ctrs() function from the paper.
-    // We have to reset the lower bound first.
-    lowerBounds(i) = DBL_MAX;
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-    {
-      if (c == assignments[i])
+      // First bound test.
+      if (upperBounds(i) <= m)
+      {
+        ++hamerlyPruned;
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
         continue;
+      }
 
-      const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+      // Tighten upper bound.
+      upperBounds(i) = metric.Evaluate(dataset.col(i),
+                                       centroids.col(assignments[i]));
+      ++localDistanceCalculations;
 
-      // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
-      if (dist < upperBounds(i))
+      // Second bound test.
+      if (upperBounds(i) <= m)
       {
-        // lowerBounds holds the second closest cluster.
-        lowerBounds(i) = upperBounds(i);
-        upperBounds(i) = dist;
-        assignments[i] = c;
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
+        continue;
       }
-      else if (dist < lowerBounds(i))
+
+      // The bounds failed.  So test against all other clusters.
+      // This is Hamerly's Point-All-Ctrs() function from the paper.
+      // We have to reset the lower bound first.
+      lowerBounds(i) = DBL_MAX;
+      for (size_t c = 0; c < centroids.n_cols; ++c)
       {
-        // This is a closer second-closest cluster.
-        lowerBounds(i) = dist;
+        if (c == assignments[i])
+          continue;
+
+        const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+
+        // Is this a better cluster?  At this point, upperBounds[i] =
+        // d(i, c(i)).
+        if (dist < upperBounds(i))
+        {
+          // lowerBounds holds the second closest cluster.
+          lowerBounds(i) = upperBounds(i);
+          upperBounds(i) = dist;
+          assignments[i] = c;
+        }
+        else if (dist < lowerBounds(i))
+        {
+          // This is a closer second-closest cluster.
+          lowerBounds(i) = dist;
+        }
       }
+      localDistanceCalculations += centroids.n_cols - 1;
+
+      // Update new centroids.
+      localCentroids.col(assignments[i]) += dataset.col(i);
+      ++localCounts(assignments[i]);
     }
-    distanceCalculations += centroids.n_cols - 1;
 
-    // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+    // Combine calculated state from each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
   }
+  distanceCalculations += localDistanceCalculations;
 
-  // Normalize centroids and calculate cluster movement (contains parts of
-  // Move-Centers() and Update-Bounds()).
-  double furthestMovement = 0.0;
-  double secondFurthestMovement = 0.0;
-  size_t furthestMovingCluster = 0;
-  arma::vec centroidMovements(centroids.n_cols);
+  // Normalize centroids and calculate cluster movement.
   double centroidMovement = 0.0;
   for (size_t c = 0; c < centroids.n_cols; ++c)
   {
     if (counts(c) > 0)
       newCentroids.col(c) /= counts(c);
 
-    // Calculate movement.
-    const double movement = metric.Evaluate(centroids.col(c),
-                                            newCentroids.col(c));
-    centroidMovements(c) = movement;
-    centroidMovement += std::pow(movement, 2.0);
+    centroidMovement += std::pow(metric.Evaluate(centroids.col(c),
+        newCentroids.col(c)), 2.0);
     ++distanceCalculations;
-
-    if (movement > furthestMovement)
-    {
-      secondFurthestMovement = furthestMovement;
-      furthestMovement = movement;
-      furthestMovingCluster = c;
-    }
-    else if (movement > secondFurthestMovement)
-    {
-      secondFurthestMovement = movement;
-    }
   }
 
-  // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    upperBounds(i) += centroidMovements(assignments[i]);
-    if (assignments[i] == furthestMovingCluster)
-      lowerBounds(i) -= secondFurthestMovement;
-    else
-      lowerBounds(i) -= furthestMovement;
-  }
+  // The bounds are moved at the start of the next iteration, once its
+  // centroids are known.
+  lastCentroids = centroids;
 
   Log::Info << "Hamerly prunes: " << hamerlyPruned << ".\n";
 
@@ -18,6 +18,7 @@
 #include "sample_initialization.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -63,7 +64,7 @@ namespace kmeans /** K-Means clustering. */ {
  * @tparam LloydStepType Implementation of single Lloyd step to use.
  *
  * @see RandomPartition, SampleInitialization, RefinedStart, AllowEmptyClusters,
- *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans
+ *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans, MiniBatchKMeans
  */
 template<typename MetricType = metric::EuclideanDistance,
          typename InitialPartitionPolicy = SampleInitialization,
@@ -155,6 +156,30 @@ class KMeans
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
+  /**
+   * Update the centroids with a chunk of the data, for data that arrives in
+   * chunks or is too large to cluster at once.  Each point of the chunk is
+   * assigned to its closest centroid, and each centroid is moved towards its
+   * points with a learning rate of one over the number of points it has been
+   * given so far, as in MiniBatchKMeans (whatever the LloydStepType is).  If
+   * counts is empty, the centroids are first initialized from the chunk with
+   * the initial partitioning policy.
+   *
+   * Returns the mean squared distance of the points of the chunk to their
+   * closest centroids before the update; once it stops decreasing from chunk
+   * to chunk, the centroids have converged.
+   *
+   * @param data Chunk of the dataset.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Centroids to update (one per column).
+   * @param counts Number of points given to each centroid so far; leave empty
+   *      for the first chunk.
+   */
+  double PartialFit(const MatType& data,
+                    const size_t clusters,
+                    arma::mat& centroids,
+                    arma::Col<size_t>& counts);
+
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Set the maximum number of iterations.
@@ -14,6 +14,7 @@
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/util/sfinae_utility.hpp>
+#include <mlpack/core/util/numa.hpp>
 
 namespace mlpack {
 namespace kmeans {
@@ -207,7 +208,11 @@ Cluster(const MatType& data,
 
   size_t iteration = 0;
 
-  LloydStepType<MetricType, MatType> lloydStep(data, metric);
+  // In NUMA mode, the Lloyd steps use a copy of the data that is spread over
+  // the memory of the sockets of the threads that process it.
+  MatType numaData;
+  LloydStepType<MetricType, MatType> lloydStep(
+      util::FirstTouchCopy(data, numaData), metric);
   arma::mat centroidsOther;
   double cNorm;
 
@@ -337,6 +342,76 @@ Cluster(const MatType& data,
   }
 }
 
+/**
+ * Update the centroids with a chunk of the data.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+double KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+PartialFit(const MatType& data,
+           const size_t clusters,
+           arma::mat& centroids,
+           arma::Col<size_t>& counts)
+{
+  if (counts.n_elem == 0)
+  {
+    // This is the first chunk, so initialize the centroids from it.
+    if (clusters > data.n_cols)
+    {
+      Log::Fatal << "KMeans::PartialFit(): more clusters requested than points "
+          << "in the first chunk." << std::endl;
+    }
+
+    arma::Row<size_t> assignments;
+    if (GetInitialAssignmentsOrCentroids(partitioner, data, clusters,
+        assignments, centroids))
+    {
+      arma::Row<size_t> assignmentCounts;
+      assignmentCounts.zeros(clusters);
+      centroids.zeros(data.n_rows, clusters);
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += arma::vec(data.col(i));
+        assignmentCounts[assignments[i]]++;
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        if (assignmentCounts[i] != 0)
+          centroids.col(i) /= assignmentCounts[i];
+    }
+
+    counts.zeros(clusters);
+  }
+
+  if (centroids.n_cols != clusters || counts.n_elem != clusters)
+  {
+    Log::Fatal << "KMeans::PartialFit(): wrong number of cluster centroids or "
+        << "counts (" << centroids.n_cols << " and " << counts.n_elem
+        << ", should be " << clusters << ")!" << std::endl;
+  }
+
+  if (centroids.n_rows != data.n_rows)
+  {
+    Log::Fatal << "KMeans::PartialFit(): cluster centroids have wrong "
+        << "dimensionality (" << centroids.n_rows << ", should be "
+        << data.n_rows << ")!" << std::endl;
+  }
+
+  size_t distanceCalculations = 0;
+  const arma::uvec points = (data.n_cols == 0) ? arma::uvec() :
+      arma::regspace<arma::uvec>(0, data.n_cols - 1);
+  return MiniBatchKMeans<MetricType, MatType>::Update(data, points, metric,
+      centroids, counts, distanceCalculations);
+}
+
 template<typename MetricType,
          typename InitialPartitionPolicy,
          typename EmptyClusterPolicy,
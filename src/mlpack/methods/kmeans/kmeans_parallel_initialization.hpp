@@ -0,0 +1,150 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * This file defines the k-means|| initialization strategy, a parallel
+ * alternative to k-means++.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class implements the k-means|| initialization, as described in the
+ * following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * k-means++ needs one pass over the data for each centroid it picks.  Instead,
+ * k-means|| makes a few passes over the data (Rounds()), and in each pass it
+ * samples each point independently with a probability proportional to its
+ * squared distance to the closest candidate picked so far, so that about
+ * Oversampling() * k candidates are added at each pass.  Each candidate is then
+ * weighted by the number of points closest to it, and the weighted candidates
+ * are reclustered into k centroids with k-means++ and a few iterations of
+ * weighted Lloyd's algorithm.  Each pass over the data is done in parallel with
+ * OpenMP, and the result does not depend on the number of threads.
+ *
+ * In accordance with mlpack's InitialPartitionPolicy template type, we only
+ * need to implement a constructor and a method to compute the initial
+ * centroids.
+ *
+ * @code
+ * KMeans<metric::EuclideanDistance, KMeansParallelInitialization> k;
+ * k.Cluster(data, 1000, centroids);
+ * @endcode
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the k-means|| initialization with the given parameters.
+   *
+   * @param oversampling Expected number of candidates sampled in each round,
+   *     as a multiple of the number of clusters.
+   * @param rounds Number of sampling rounds.
+   * @param maxIterations Maximum number of iterations of weighted Lloyd's
+   *     algorithm used to recluster the candidates.
+   */
+  KMeansParallelInitialization(const double oversampling = 2.0,
+                               const size_t rounds = 5,
+                               const size_t maxIterations = 10) :
+      oversampling(oversampling),
+      rounds(rounds),
+      maxIterations(maxIterations)
+  { }
+
+  /**
+   * Initialize the centroids matrix with the k-means|| algorithm.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the maximum number of reclustering iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of reclustering iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(oversampling));
+    ar(CEREAL_NVP(rounds));
+    ar(CEREAL_NVP(maxIterations));
+  }
+
+ private:
+  /**
+   * Update the squared distance of each point to its closest candidate, and
+   * the index of that candidate, with the candidates in [begin, end).  The
+   * candidates are given as indices of points of the data.
+   */
+  template<typename MatType>
+  static void UpdateDistances(const MatType& data,
+                              const std::vector<size_t>& candidates,
+                              const size_t begin,
+                              const size_t end,
+                              arma::vec& minDistances,
+                              arma::Col<size_t>& closest);
+
+  /**
+   * Recluster the weighted candidates into the given centroids, with weighted
+   * k-means++ followed by weighted Lloyd iterations.
+   */
+  void Recluster(const arma::mat& candidates,
+                 const arma::vec& weights,
+                 arma::mat& centroids) const;
+
+  //! The expected number of candidates of each round, per cluster.
+  double oversampling;
+  //! The number of sampling rounds.
+  size_t rounds;
+  //! The maximum number of reclustering iterations.
+  size_t maxIterations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
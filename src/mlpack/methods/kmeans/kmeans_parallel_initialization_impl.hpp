@@ -0,0 +1,214 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids)
+{
+  centroids.set_size(data.n_rows, clusters);
+  if (clusters == 0 || data.n_cols == 0)
+    return;
+
+  // We'll sample our first candidate fully randomly.
+  std::vector<size_t> candidates;
+  candidates.push_back(math::RandInt(0, data.n_cols));
+
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(std::numeric_limits<double>::max());
+  arma::Col<size_t> closest(data.n_cols);
+  UpdateDistances(data, candidates, 0, 1, minDistances, closest);
+
+  // The points are sampled in blocks, each with its own random stream, so that
+  // the sampled candidates don't depend on the number of threads.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  const double expectedSamples = oversampling * clusters;
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    const double cost = arma::accu(minDistances);
+    if (cost == 0.0)
+      break; // Every point is a candidate.
+
+    const size_t firstStream = math::ReserveRandomStreams(numBlocks);
+
+    std::vector<std::vector<size_t>> blockCandidates(numBlocks);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      std::mt19937 generator = math::RandomStream(firstStream + b);
+      std::uniform_real_distribution<> uniform;
+      const size_t end = std::min((size_t) (b + 1) * blockSize,
+          (size_t) data.n_cols);
+      for (size_t i = b * blockSize; i < end; ++i)
+      {
+        if (uniform(generator) < expectedSamples * minDistances[i] / cost)
+          blockCandidates[b].push_back(i);
+      }
+    }
+
+    const size_t begin = candidates.size();
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      candidates.insert(candidates.end(), blockCandidates[b].begin(),
+          blockCandidates[b].end());
+    }
+
+    UpdateDistances(data, candidates, begin, candidates.size(), minDistances,
+        closest);
+  }
+
+  // Weight each candidate by the number of points closest to it.
+  arma::mat candidatePoints(data.n_rows, candidates.size());
+  for (size_t j = 0; j < candidates.size(); ++j)
+    candidatePoints.col(j) = arma::vec(data.col(candidates[j]));
+
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    ++weights[closest[i]];
+
+  if (candidates.size() > clusters)
+  {
+    Recluster(candidatePoints, weights, centroids);
+  }
+  else
+  {
+    // There are too few candidates (this only happens for tiny datasets), so
+    // take all of them and fill the rest with random points.
+    centroids.cols(0, candidates.size() - 1) = candidatePoints;
+    for (size_t i = candidates.size(); i < clusters; ++i)
+      centroids.col(i) = data.col(math::RandInt(0, data.n_cols));
+  }
+}
+
+template<typename MatType>
+void KMeansParallelInitialization::UpdateDistances(
+    const MatType& data,
+    const std::vector<size_t>& candidates,
+    const size_t begin,
+    const size_t end,
+    arma::vec& minDistances,
+    arma::Col<size_t>& closest)
+{
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      const double distance = metric::SquaredEuclideanDistance::Evaluate(
+          data.col(i), data.col(candidates[j]));
+      if (distance < minDistances[i])
+      {
+        minDistances[i] = distance;
+        closest[i] = j;
+      }
+    }
+  }
+}
+
+inline void KMeansParallelInitialization::Recluster(
+    const arma::mat& candidates,
+    const arma::vec& weights,
+    arma::mat& centroids) const
+{
+  const size_t clusters = centroids.n_cols;
+
+  // Sample a candidate with probability proportional to the given scores.  A
+  // candidate with a score of zero is never sampled, unless all of them are.
+  auto sample = [&](const arma::vec& scores)
+  {
+    const arma::vec cdf = arma::cumsum(scores);
+    const double value = math::Random() * cdf[cdf.n_elem - 1];
+    const size_t position = (size_t) (std::upper_bound(cdf.begin(), cdf.end(),
+        value) - cdf.begin());
+    return std::min(position, (size_t) cdf.n_elem - 1);
+  };
+
+  // Use weighted k-means++ to pick the first centroids.  The distance of each
+  // candidate to its closest centroid is updated as centroids are picked.
+  arma::vec minDistances(candidates.n_cols);
+  minDistances.fill(std::numeric_limits<double>::max());
+  centroids.col(0) = candidates.col(sample(weights));
+  for (size_t c = 1; c <= clusters; ++c)
+  {
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) candidates.n_cols; ++j)
+    {
+      minDistances[j] = std::min(minDistances[j],
+          metric::SquaredEuclideanDistance::Evaluate(candidates.col(j),
+          centroids.col(c - 1)));
+    }
+
+    if (c < clusters)
+      centroids.col(c) = candidates.col(sample(weights % minDistances));
+  }
+
+  // Now refine the centroids with weighted Lloyd iterations on the candidates.
+  arma::Col<size_t> assignments(candidates.n_cols);
+  assignments.fill(clusters); // Invalid value.
+  for (size_t iteration = 0; iteration < maxIterations; ++iteration)
+  {
+    size_t changed = 0;
+    #pragma omp parallel for schedule(static) reduction(+:changed)
+    for (omp_size_t j = 0; j < (omp_size_t) candidates.n_cols; ++j)
+    {
+      double minDistance = std::numeric_limits<double>::max();
+      size_t closestCluster = 0;
+      for (size_t c = 0; c < clusters; ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            candidates.col(j), centroids.col(c));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = c;
+        }
+      }
+
+      if (assignments[j] != closestCluster)
+      {
+        assignments[j] = closestCluster;
+        ++changed;
+      }
+    }
+
+    if (changed == 0)
+      break;
+
+    // Centroids without any weight keep their position.
+    arma::mat sums(candidates.n_rows, clusters, arma::fill::zeros);
+    arma::vec clusterWeights(clusters, arma::fill::zeros);
+    for (size_t j = 0; j < candidates.n_cols; ++j)
+    {
+      sums.col(assignments[j]) += weights[j] * candidates.col(j);
+      clusterWeights[assignments[j]] += weights[j];
+    }
+
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      if (clusterWeights[c] > 0.0)
+        centroids.col(c) = sums.col(c) / clusterWeights[c];
+    }
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
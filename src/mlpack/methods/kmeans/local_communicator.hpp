@@ -0,0 +1,54 @@
+/**
+ * @file methods/kmeans/local_communicator.hpp
+ *
+ * The LocalCommunicator class, the communicator of a distributed computation
+ * that runs in one process.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_LOCAL_COMMUNICATOR_HPP
+#define MLPACK_METHODS_KMEANS_LOCAL_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A communicator is used by DistributedKMeans and gmm::DistributedEMFit to
+ * combine the statistics computed by the processes (the ranks) that each hold
+ * one shard of the data.  It must implement
+ *
+ * @code
+ * // Get the index of this process, and the number of processes.
+ * size_t Rank() const;
+ * size_t Size() const;
+ *
+ * // Replace the given matrix, on every process, by the sum of the matrices
+ * // given by all the processes (which all have the same size).
+ * void AllReduceSum(arma::mat& values) const;
+ * @endcode
+ *
+ * The LocalCommunicator is the communicator of a single process, which holds
+ * all the data; MPICommunicator uses MPI.
+ */
+class LocalCommunicator
+{
+ public:
+  //! Get the index of this process (always 0).
+  size_t Rank() const { return 0; }
+
+  //! Get the number of processes (always 1).
+  size_t Size() const { return 1; }
+
+  //! Sum the given matrix over all the processes (this does nothing).
+  void AllReduceSum(arma::mat& /* values */) const { }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
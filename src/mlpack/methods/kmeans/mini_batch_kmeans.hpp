@@ -0,0 +1,158 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of a mini-batch step for k-means clustering, which updates
+ * the centroids with a random sample of the points at each iteration.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This is an implementation of mini-batch k-means, for use as the Lloyd step
+ * of the KMeans class.  Instead of assigning all of the points at each
+ * iteration, each iteration samples BatchSize() points uniformly at random,
+ * assigns them to their closest centroids, and moves each centroid towards its
+ * points with a learning rate of one over the number of points it has been
+ * given so far.  Each iteration then takes time proportional to the batch size
+ * instead of the size of the dataset, at the cost of centroids that are only
+ * close to those of Lloyd's algorithm.  For more information, see the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * Since the centroids keep moving a little at each iteration, the movement of
+ * the centroids is not a good convergence criterion.  Instead, an
+ * exponentially weighted average of the mean squared distance of the points of
+ * each batch to their centroids is kept, and once it has not improved for
+ * MaxNoImprovement() iterations, Iterate() returns 0 so that KMeans stops.
+ *
+ * The counts returned by Iterate() are the number of points each centroid has
+ * been given since the start of the clustering, so a cluster is empty only
+ * until it gets its first point.  With many clusters and small batches,
+ * AllowEmptyClusters avoids calling the empty cluster policy on the whole
+ * dataset during the first iterations.
+ *
+ * @code
+ * KMeans<metric::EuclideanDistance, SampleInitialization, AllowEmptyClusters,
+ *     MiniBatchKMeans> k;
+ * k.Cluster(data, 100, centroids);
+ * @endcode
+ *
+ * To cluster data that arrives in chunks, see KMeans::PartialFit(), which uses
+ * the same update.
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points sampled at each iteration.
+   * @param maxNoImprovement Number of iterations without improvement of the
+   *     average batch distance after which the clustering is converged (0
+   *     means this criterion is not used).
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1024,
+                  const size_t maxNoImprovement = 10);
+
+  /**
+   * Run a single mini-batch iteration, updating the given centroids into the
+   * newCentroids matrix.  Returns the norm of the movement of the centroids,
+   * or 0 if the clustering has converged.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points given to each cluster so far.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Assign the given points of the data to their closest centroids, and move
+   * each centroid towards its points, in the order of the points, with a
+   * learning rate of one over its count.  The counts are incremented.  Returns
+   * the mean squared distance of the points to the centroids they were
+   * assigned to, before the centroids were moved.
+   *
+   * @param data Dataset the points are taken from.
+   * @param points Indices of the points to update the centroids with.
+   * @param metric Instantiated metric.
+   * @param centroids Centroids to update.
+   * @param counts Number of points given to each centroid so far.
+   * @param distanceCalculations Incremented by the number of distances
+   *     computed.
+   */
+  static double Update(const MatType& data,
+                       const arma::uvec& points,
+                       MetricType& metric,
+                       arma::mat& centroids,
+                       arma::Col<size_t>& counts,
+                       size_t& distanceCalculations);
+
+  //! Get the number of distance calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Get the number of iterations without improvement before convergence.
+  size_t MaxNoImprovement() const { return maxNoImprovement; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points sampled at each iteration.
+  size_t batchSize;
+  //! The number of iterations without improvement before convergence.
+  size_t maxNoImprovement;
+
+  //! The number of points given to each centroid so far.
+  arma::Col<size_t> centroidCounts;
+  //! The exponentially weighted average of the mean squared distance of the
+  //! points of each batch.
+  double averageDistance;
+  //! The best value of averageDistance so far.
+  double bestAverageDistance;
+  //! The number of iterations since bestAverageDistance improved.
+  size_t noImprovement;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * An implementation of a mini-batch step for k-means clustering, which updates
+ * the centroids with a random sample of the points at each iteration.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(
+    const MatType& dataset,
+    MetricType& metric,
+    const size_t batchSize,
+    const size_t maxNoImprovement) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    maxNoImprovement(maxNoImprovement),
+    averageDistance(0.0),
+    bestAverageDistance(DBL_MAX),
+    noImprovement(0),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // If this is the first iteration, reset the state of the clustering.
+  if (centroidCounts.n_elem != centroids.n_cols)
+  {
+    centroidCounts.zeros(centroids.n_cols);
+    bestAverageDistance = DBL_MAX;
+    noImprovement = 0;
+  }
+
+  // Sample the batch, with replacement.
+  arma::uvec batch(std::min(batchSize, (size_t) dataset.n_cols));
+  for (size_t i = 0; i < batch.n_elem; ++i)
+  {
+    batch[i] = std::min((size_t) (math::Random() * dataset.n_cols),
+        (size_t) dataset.n_cols - 1);
+  }
+
+  newCentroids = centroids;
+  const double batchDistance = Update(dataset, batch, metric, newCentroids,
+      centroidCounts, distanceCalculations);
+  counts = centroidCounts;
+
+  // Calculate the movement of the centroids for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  // Update the average distance of the batches.  The weight of each batch is
+  // about the fraction of the dataset it covers, so that the average spans a
+  // few passes over the data.
+  if (maxNoImprovement > 0)
+  {
+    const double alpha = std::min(1.0,
+        2.0 * batch.n_elem / (dataset.n_cols + 1.0));
+    if (bestAverageDistance == DBL_MAX)
+      averageDistance = batchDistance;
+    else
+      averageDistance = (1.0 - alpha) * averageDistance + alpha * batchDistance;
+
+    if (averageDistance < bestAverageDistance)
+    {
+      bestAverageDistance = averageDistance;
+      noImprovement = 0;
+    }
+    else if (++noImprovement >= maxNoImprovement)
+    {
+      Log::Info << "MiniBatchKMeans::Iterate(): no improvement of the average "
+          << "batch distance in " << noImprovement << " iterations."
+          << std::endl;
+      return 0.0;
+    }
+  }
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Update(
+    const MatType& data,
+    const arma::uvec& points,
+    MetricType& metric,
+    arma::mat& centroids,
+    arma::Col<size_t>& counts,
+    size_t& distanceCalculations)
+{
+  if (counts.n_elem != centroids.n_cols)
+    counts.zeros(centroids.n_cols);
+
+  // Find the closest centroid to each point, in parallel.
+  arma::Col<size_t> assignments(points.n_elem);
+  arma::vec distances(points.n_elem);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_elem; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(data.col(points[i]),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+    distances[i] = minDistance;
+  }
+  distanceCalculations += points.n_elem * centroids.n_cols;
+
+  // Each centroid is only moved by its own points, so the centroids can be
+  // updated in parallel, each with its points in order.
+  std::vector<std::vector<size_t>> centroidPoints(centroids.n_cols);
+  for (size_t i = 0; i < points.n_elem; ++i)
+    centroidPoints[assignments[i]].push_back(points[i]);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    for (size_t i = 0; i < centroidPoints[c].size(); ++i)
+    {
+      const double eta = 1.0 / (double) (++counts[c]);
+      centroids.col(c) = (1.0 - eta) * centroids.col(c) +
+          eta * arma::vec(data.col(centroidPoints[c][i]));
+    }
+  }
+
+  return (points.n_elem == 0) ? 0.0 :
+      arma::accu(arma::square(distances)) / (double) points.n_elem;
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
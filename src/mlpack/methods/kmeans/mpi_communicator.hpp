@@ -0,0 +1,87 @@
+/**
+ * @file methods/kmeans/mpi_communicator.hpp
+ *
+ * The MPICommunicator class, which combines the statistics of a distributed
+ * computation with MPI.
+ *
+ * mlpack itself does not use MPI: a program that includes this file must be
+ * compiled and linked with MPI (for instance with mpic++).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MPI_COMMUNICATOR_HPP
+#define MLPACK_METHODS_KMEANS_MPI_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mpi.h>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The MPICommunicator sums statistics with MPI_Allreduce() over the processes
+ * of an MPI communicator (see LocalCommunicator for the interface).  MPI must
+ * be initialized before it is used.
+ *
+ * @code
+ * // On each rank: load the shard of the data held by the rank.
+ * arma::mat shard;
+ * data::Load("data_" + std::to_string(rank) + ".csv", shard);
+ *
+ * DistributedKMeans<MPICommunicator> k(MPICommunicator(MPI_COMM_WORLD));
+ * arma::mat centroids;
+ * k.Cluster(shard, 10, centroids); // Every rank gets the same centroids.
+ * @endcode
+ */
+class MPICommunicator
+{
+ public:
+  /**
+   * Create the communicator for the given MPI communicator.
+   *
+   * @param comm MPI communicator of the processes that hold the data.
+   */
+  MPICommunicator(MPI_Comm comm = MPI_COMM_WORLD) : comm(comm) { }
+
+  //! Get the index of this process.
+  size_t Rank() const
+  {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    return (size_t) rank;
+  }
+
+  //! Get the number of processes.
+  size_t Size() const
+  {
+    int size;
+    MPI_Comm_size(comm, &size);
+    return (size_t) size;
+  }
+
+  //! Sum the given matrix over all the processes, in place.
+  void AllReduceSum(arma::mat& values) const
+  {
+    if (MPI_Allreduce(MPI_IN_PLACE, values.memptr(), (int) values.n_elem,
+        MPI_DOUBLE, MPI_SUM, comm) != MPI_SUCCESS)
+    {
+      throw std::runtime_error("MPICommunicator::AllReduceSum(): "
+          "MPI_Allreduce() failed!");
+    }
+  }
+
+  //! Get the MPI communicator.
+  MPI_Comm Comm() const { return comm; }
+
+ private:
+  //! The MPI communicator.
+  MPI_Comm comm;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_HPP
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
 #include "pelleg_moore_kmeans_statistic.hpp"
 
 namespace mlpack {
@@ -49,18 +49,73 @@ double PellegMooreKMeans<MetricType, MatType>::Iterate(
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
 
-  // Create rules object.
   typedef PellegMooreKMeansRules<MetricType, TreeType> RulesType;
-  RulesType rules(dataset, centroids, newCentroids, counts, metric);
 
-  // Use single-tree traverser.
-  typename TreeType::template SingleTreeTraverser<RulesType> traverser(rules);
+  // Split the tree into several subtrees per thread, so that the dynamic
+  // schedule can balance the load when some subtrees are owned by a single
+  // cluster much earlier than others.
+  std::vector<TreeType*> frontier;
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+    tree::SubtreeFrontier(*tree, 8 * numThreads, frontier);
+  #endif
 
-  // Now, do a traversal with a fake query index (since the query index is
-  // irrelevant; we are checking each node with all clusters.
-  traverser.Traverse(0, *tree);
+  if (frontier.size() <= 1)
+  {
+    // Create rules object.
+    RulesType rules(dataset, centroids, newCentroids, counts, metric);
+
+    // Use single-tree traverser.
+    typename TreeType::template SingleTreeTraverser<RulesType>
+        traverser(rules);
+
+    // Now, do a traversal with a fake query index (since the query index is
+    // irrelevant; we are checking each node with all clusters.
+    traverser.Traverse(0, *tree);
+
+    distanceCalculations += rules.DistanceCalculations();
+  }
+  else
+  {
+    // Each subtree must start with an empty blacklist, like the root, so the
+    // blacklists of the nodes above the subtrees (which are left from the last
+    // iteration) are cleared.
+    for (size_t i = 0; i < frontier.size(); ++i)
+      if (frontier[i]->Parent() != NULL)
+        frontier[i]->Parent()->Stat().Blacklist().reset();
+
+    size_t threadDistanceCalculations = 0;
 
-  distanceCalculations += rules.DistanceCalculations();
+    #pragma omp parallel reduction(+:threadDistanceCalculations)
+    {
+      // Each thread sums the points it assigns separately.
+      MetricType threadMetric(metric);
+      arma::mat threadCentroids(centroids.n_rows, centroids.n_cols,
+          arma::fill::zeros);
+      arma::Col<size_t> threadCounts(centroids.n_cols, arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+      {
+        RulesType rules(dataset, centroids, threadCentroids, threadCounts,
+            threadMetric);
+        typename TreeType::template SingleTreeTraverser<RulesType>
+            traverser(rules);
+        traverser.Traverse(0, *frontier[i]);
+
+        threadDistanceCalculations += rules.DistanceCalculations();
+      }
+
+      #pragma omp critical
+      {
+        newCentroids += threadCentroids;
+        counts += threadCounts;
+      }
+    }
+
+    distanceCalculations += threadDistanceCalculations;
+  }
 
   // Now, calculate how far the clusters moved, after normalizing them.
   double residual = 0.0;
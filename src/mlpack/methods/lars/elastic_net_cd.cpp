@@ -0,0 +1,144 @@
+/**
+ * @file methods/lars/elastic_net_cd.cpp
+ *
+ * Implementation of the non-templated ElasticNetCD functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "elastic_net_cd.hpp"
+#include <mlpack/core/util/log.hpp>
+
+using namespace mlpack;
+using namespace mlpack::regression;
+
+ElasticNetCD::ElasticNetCD(const double lambda1,
+                           const double lambda2,
+                           const size_t maxIterations,
+                           const double tolerance) :
+    lambda1(lambda1),
+    lambda2(lambda2),
+    maxIterations(maxIterations),
+    tolerance(tolerance)
+{
+  // Nothing to do.
+}
+
+void ElasticNetCD::SolveGram(const arma::mat& gram,
+                             const arma::mat& correlations,
+                             arma::mat& betas) const
+{
+  if (gram.n_rows != gram.n_cols || correlations.n_rows != gram.n_rows)
+  {
+    Log::Fatal << "ElasticNetCD::SolveGram(): Gram matrix (" << gram.n_rows
+        << "x" << gram.n_cols << ") must be square and have as many rows as "
+        << "the correlations (" << correlations.n_rows << ")!" << std::endl;
+  }
+
+  if (betas.n_rows != gram.n_rows || betas.n_cols != correlations.n_cols)
+    betas.zeros(gram.n_rows, correlations.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) correlations.n_cols; ++t)
+  {
+    arma::vec beta = betas.col(t);
+    arma::vec gramBeta = gram * beta;
+    const arma::vec correlation = correlations.col(t);
+
+    Descend([&](const bool activeOnly)
+    {
+      return SweepGram(gram, correlation, lambda1, lambda2, activeOnly, beta,
+          gramBeta);
+    }, maxIterations, tolerance);
+
+    betas.col(t) = beta;
+  }
+}
+
+double ElasticNetCD::SweepGram(const arma::mat& gram,
+                               const arma::vec& correlations,
+                               const double lambda1,
+                               const double lambda2,
+                               const bool activeOnly,
+                               arma::vec& beta,
+                               arma::vec& gramBeta)
+{
+  double maxChange = 0.0;
+  for (size_t j = 0; j < beta.n_elem; ++j)
+  {
+    const double norm = gram(j, j);
+    if (norm == 0.0 || (activeOnly && beta[j] == 0.0))
+      continue;
+
+    // Here the correlation of the residual with the dimension is the
+    // correlation of the target minus (G beta)_j.
+    const double oldBeta = beta[j];
+    const double z = correlations[j] - gramBeta[j] + norm * oldBeta;
+    beta[j] = SoftThreshold(z, lambda1) / (norm + lambda2);
+
+    const double delta = beta[j] - oldBeta;
+    if (delta != 0.0)
+    {
+      gramBeta += delta * gram.col(j);
+      maxChange = std::max(maxChange, std::abs(delta) * std::sqrt(norm));
+    }
+  }
+
+  return maxChange;
+}
+
+void ElasticNetCD::Prepare(const arma::mat& data,
+                           arma::mat& dataTrans,
+                           arma::vec& norms)
+{
+  dataTrans = data.t();
+  norms = arma::sum(arma::square(data), 1);
+}
+
+void ElasticNetCD::Prepare(const arma::sp_mat& data,
+                           arma::sp_mat& dataTrans,
+                           arma::vec& norms)
+{
+  dataTrans = data.t();
+  norms = arma::vec(arma::mat(arma::sum(arma::square(data), 1)));
+
+  // The columns are read directly (and by several threads).
+  dataTrans.sync();
+}
+
+double ElasticNetCD::ColumnDot(const arma::mat& x,
+                               const size_t column,
+                               const arma::vec& v)
+{
+  return arma::dot(x.unsafe_col(column), v);
+}
+
+double ElasticNetCD::ColumnDot(const arma::sp_mat& x,
+                               const size_t column,
+                               const arma::vec& v)
+{
+  double result = 0.0;
+  for (size_t i = x.col_ptrs[column]; i < x.col_ptrs[column + 1]; ++i)
+    result += x.values[i] * v[x.row_indices[i]];
+
+  return result;
+}
+
+void ElasticNetCD::ColumnUpdate(const arma::mat& x,
+                                const size_t column,
+                                const double delta,
+                                arma::vec& v)
+{
+  v -= delta * x.unsafe_col(column);
+}
+
+void ElasticNetCD::ColumnUpdate(const arma::sp_mat& x,
+                                const size_t column,
+                                const double delta,
+                                arma::vec& v)
+{
+  for (size_t i = x.col_ptrs[column]; i < x.col_ptrs[column + 1]; ++i)
+    v[x.row_indices[i]] -= delta * x.values[i];
+}
@@ -0,0 +1,302 @@
+/**
+ * @file methods/lars/elastic_net_cd.hpp
+ *
+ * Definition of the ElasticNetCD class, which solves the LASSO and the Elastic
+ * Net with coordinate descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LARS_ELASTIC_NET_CD_HPP
+#define MLPACK_METHODS_LARS_ELASTIC_NET_CD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace regression {
+
+/**
+ * A coordinate descent solver for the same problem as LARS, l1-regularized
+ * linear regression (LASSO) and l1+l2 regularized linear regression (Elastic
+ * Net):
+ *
+ * \f[ \min_{\beta} 0.5 || X \beta - y ||_2^2 + \lambda_1 || \beta ||_1 +
+ *     0.5 \lambda_2 || \beta ||_2^2. \f]
+ *
+ * Each coefficient in turn is set to its optimal value given the others (a
+ * soft-thresholding step), as described in the following paper:
+ *
+ * @code
+ * @article{friedman2010regularization,
+ *   title={Regularization Paths for Generalized Linear Models via Coordinate
+ *       Descent},
+ *   author={Friedman, J. and Hastie, T. and Tibshirani, R.},
+ *   journal={Journal of Statistical Software},
+ *   volume={33},
+ *   number={1},
+ *   pages={1--22},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * Unlike LARS, no Gram matrix of the dimensions is needed: the residual is
+ * updated as the coefficients change, so the memory used is that of the data,
+ * and the data may be sparse (arma::sp_mat).  An active-set strategy is used:
+ * after one sweep over all the coefficients, only the nonzero ones are swept
+ * until they converge, and then a sweep over all the coefficients checks the
+ * optimality conditions.  The solution can be warm started, which is what
+ * TrainPath() does to compute a whole regularization path; and several
+ * problems with the same data (or the same Gram matrix, with SolveGram(), as
+ * in sparse coding) are solved in parallel with Solve().
+ *
+ * As with LARS, no intercept is fitted.
+ */
+class ElasticNetCD
+{
+ public:
+  /**
+   * Set the parameters of the solver.
+   *
+   * @param lambda1 Regularization parameter for l1-norm penalty.
+   * @param lambda2 Regularization parameter for l2-norm penalty.
+   * @param maxIterations Maximum number of sweeps over the coefficients.
+   * @param tolerance Stop when no coefficient changes by more than this (the
+   *     change is scaled by the norm of the coefficient's dimension, so it is
+   *     the change of the predictions).
+   */
+  ElasticNetCD(const double lambda1 = 0.0,
+               const double lambda2 = 0.0,
+               const size_t maxIterations = 10000,
+               const double tolerance = 1e-10);
+
+  /**
+   * Solve the problem for the given data, which is column-major (each column
+   * is an observation).  The data may be dense or sparse.
+   *
+   * @param data Column-major input data.
+   * @param responses A vector of targets.
+   * @param warmStart If true and the model has a solution of the right size,
+   *     start from it.
+   * @return The value of the objective at the solution.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::rowvec& responses,
+               const bool warmStart = false);
+
+  /**
+   * Compute the regularization path for the given data: lambda1 decreases
+   * geometrically from the smallest value for which the solution is zero to
+   * Lambda1() (or to 1e-4 times that value, and then 0, if Lambda1() is 0),
+   * and each solution is the warm start of the next.  BetaPath() and
+   * LambdaPath() hold the path, and the last solution is the model.
+   *
+   * @param data Column-major input data.
+   * @param responses A vector of targets.
+   * @param pathLength Number of values of lambda1 on the path.
+   * @return The value of the objective at the last solution.
+   */
+  template<typename MatType>
+  double TrainPath(const MatType& data,
+                   const arma::rowvec& responses,
+                   const size_t pathLength = 100);
+
+  /**
+   * Solve one problem for each row of the responses, with the same data, in
+   * parallel.  The model itself is not modified.
+   *
+   * @param data Column-major input data.
+   * @param responses Matrix of targets; each row is one problem.
+   * @param betas Matrix to store the solutions in, one column for each
+   *     problem.  If it already has the right size, it is used as the warm
+   *     start.
+   */
+  template<typename MatType>
+  void Solve(const MatType& data,
+             const arma::mat& responses,
+             arma::mat& betas) const;
+
+  /**
+   * Solve one problem for each column of the correlations, given the Gram
+   * matrix X^T X of the dimensions, in parallel.  For sparse coding with a
+   * dictionary D, the Gram matrix is D^T D and the correlations are D^T x for
+   * each point x.  The model itself is not modified.
+   *
+   * @param gram Gram matrix of the dimensions.
+   * @param correlations Correlations X^T y of the dimensions with the
+   *     targets; each column is one problem.
+   * @param betas Matrix to store the solutions in, one column for each
+   *     problem.  If it already has the right size, it is used as the warm
+   *     start.
+   */
+  void SolveGram(const arma::mat& gram,
+                 const arma::mat& correlations,
+                 arma::mat& betas) const;
+
+  /**
+   * Predict y_i for each data point in the given (column-major) data matrix
+   * using the current solution.
+   *
+   * @param points The data points to regress on.
+   * @param predictions y, which will contained calculated values on completion.
+   */
+  template<typename MatType>
+  void Predict(const MatType& points, arma::rowvec& predictions) const;
+
+  /**
+   * Compute the value of the objective for the given data, using the current
+   * solution.
+   *
+   * @param data Column-major input data.
+   * @param responses A vector of targets.
+   */
+  template<typename MatType>
+  double Objective(const MatType& data, const arma::rowvec& responses) const;
+
+  //! Get the L1 regularization coefficient.
+  double Lambda1() const { return lambda1; }
+  //! Modify the L1 regularization coefficient.
+  double& Lambda1() { return lambda1; }
+
+  //! Get the L2 regularization coefficient.
+  double Lambda2() const { return lambda2; }
+  //! Modify the L2 regularization coefficient.
+  double& Lambda2() { return lambda2; }
+
+  //! Get the maximum number of sweeps.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of sweeps.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for convergence.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for convergence.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the solution coefficients.
+  const arma::vec& Beta() const { return beta; }
+  //! Modify the solution coefficients (for instance, to warm start).
+  arma::vec& Beta() { return beta; }
+
+  //! Get the indices of the nonzero coefficients of the solution.
+  arma::uvec ActiveSet() const { return arma::find(beta); }
+
+  //! Get the solutions along the last regularization path.
+  const std::vector<arma::vec>& BetaPath() const { return betaPath; }
+  //! Get the values of lambda1 along the last regularization path.
+  const std::vector<double>& LambdaPath() const { return lambdaPath; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Transpose the data (so that each dimension is a column) and compute the
+  //! squared norms of the dimensions.
+  static void Prepare(const arma::mat& data,
+                      arma::mat& dataTrans,
+                      arma::vec& norms);
+  //! Transpose the sparse data and compute the squared norms of the
+  //! dimensions.
+  static void Prepare(const arma::sp_mat& data,
+                      arma::sp_mat& dataTrans,
+                      arma::vec& norms);
+
+  //! Solve each problem of the given responses with the transposed data.
+  template<typename MatType>
+  static void SolveTransposed(const MatType& dataTrans,
+                              const arma::vec& norms,
+                              const arma::mat& responses,
+                              const double lambda1,
+                              const double lambda2,
+                              const size_t maxIterations,
+                              const double tolerance,
+                              arma::mat& betas);
+
+  /**
+   * Run the active-set strategy with the given sweep function, which takes
+   * whether to sweep the active coefficients only and returns the largest
+   * (scaled) change of a coefficient.
+   */
+  template<typename SweepType>
+  static size_t Descend(const SweepType& sweep,
+                        const size_t maxIterations,
+                        const double tolerance);
+
+  //! Sweep over the coefficients once, updating the residual.
+  template<typename MatType>
+  static double Sweep(const MatType& dataTrans,
+                      const arma::vec& norms,
+                      const double lambda1,
+                      const double lambda2,
+                      const bool activeOnly,
+                      arma::vec& beta,
+                      arma::vec& residual);
+
+  //! Sweep over the coefficients once, updating the product of the Gram
+  //! matrix and the coefficients.
+  static double SweepGram(const arma::mat& gram,
+                          const arma::vec& correlations,
+                          const double lambda1,
+                          const double lambda2,
+                          const bool activeOnly,
+                          arma::vec& beta,
+                          arma::vec& gramBeta);
+
+  //! Compute the dot product of the given column and vector.
+  static double ColumnDot(const arma::mat& x,
+                          const size_t column,
+                          const arma::vec& v);
+  //! Compute the dot product of the given sparse column and vector.
+  static double ColumnDot(const arma::sp_mat& x,
+                          const size_t column,
+                          const arma::vec& v);
+
+  //! Subtract delta times the given column from the vector.
+  static void ColumnUpdate(const arma::mat& x,
+                           const size_t column,
+                           const double delta,
+                           arma::vec& v);
+  //! Subtract delta times the given sparse column from the vector.
+  static void ColumnUpdate(const arma::sp_mat& x,
+                           const size_t column,
+                           const double delta,
+                           arma::vec& v);
+
+  //! The soft-thresholding operator, sign(z) max(|z| - lambda, 0).
+  static double SoftThreshold(const double z, const double lambda)
+  {
+    if (z > lambda)
+      return z - lambda;
+    else if (z < -lambda)
+      return z + lambda;
+    else
+      return 0.0;
+  }
+
+  //! Regularization parameter for l1 penalty.
+  double lambda1;
+  //! Regularization parameter for l2 penalty.
+  double lambda2;
+  //! Maximum number of sweeps.
+  size_t maxIterations;
+  //! Tolerance for convergence.
+  double tolerance;
+
+  //! The solution.
+  arma::vec beta;
+  //! Solutions along the last regularization path.
+  std::vector<arma::vec> betaPath;
+  //! Values of lambda1 along the last regularization path.
+  std::vector<double> lambdaPath;
+};
+
+} // namespace regression
+} // namespace mlpack
+
+// Include implementation.
+#include "elastic_net_cd_impl.hpp"
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * @file methods/lars/elastic_net_cd_impl.hpp
+ *
+ * Implementation of templated ElasticNetCD functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LARS_ELASTIC_NET_CD_IMPL_HPP
+#define MLPACK_METHODS_LARS_ELASTIC_NET_CD_IMPL_HPP
+
+//! In case it hasn't been included yet.
+#include "elastic_net_cd.hpp"
+
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+double ElasticNetCD::Train(const MatType& data,
+                           const arma::rowvec& responses,
+                           const bool warmStart)
+{
+  arma::mat betas;
+  if (warmStart && beta.n_elem == data.n_rows)
+    betas = beta;
+
+  Solve(data, responses, betas);
+  beta = betas.col(0);
+
+  betaPath.clear();
+  betaPath.push_back(beta);
+  lambdaPath.clear();
+  lambdaPath.push_back(lambda1);
+
+  return Objective(data, responses);
+}
+
+template<typename MatType>
+double ElasticNetCD::TrainPath(const MatType& data,
+                               const arma::rowvec& responses,
+                               const size_t pathLength)
+{
+  if (responses.n_elem != data.n_cols)
+  {
+    Log::Fatal << "ElasticNetCD::TrainPath(): number of responses ("
+        << responses.n_elem << ") does not match number of points ("
+        << data.n_cols << ")!" << std::endl;
+  }
+
+  MatType dataTrans;
+  arma::vec norms;
+  Prepare(data, dataTrans, norms);
+
+  // Above this value of lambda1, the solution is zero.
+  const double lambdaMax = arma::abs(arma::vec(data * responses.t())).max();
+  const double lambdaMin = (lambda1 > 0.0) ? lambda1 : 1e-4 * lambdaMax;
+
+  std::vector<double> lambdas;
+  if (pathLength < 2 || lambdaMin >= lambdaMax)
+  {
+    lambdas.push_back(lambda1);
+  }
+  else
+  {
+    for (size_t i = 0; i < pathLength; ++i)
+    {
+      lambdas.push_back(lambdaMax * std::pow(lambdaMin / lambdaMax,
+          double(i) / double(pathLength - 1)));
+    }
+    if (lambda1 == 0.0)
+      lambdas.push_back(0.0);
+  }
+
+  // Each solution is the warm start of the next one.
+  arma::mat betas(data.n_rows, 1, arma::fill::zeros);
+  betaPath.clear();
+  lambdaPath.clear();
+  for (size_t i = 0; i < lambdas.size(); ++i)
+  {
+    SolveTransposed(dataTrans, norms, responses, lambdas[i], lambda2,
+        maxIterations, tolerance, betas);
+    betaPath.push_back(betas.col(0));
+    lambdaPath.push_back(lambdas[i]);
+  }
+
+  beta = betaPath.back();
+  return Objective(data, responses);
+}
+
+template<typename MatType>
+void ElasticNetCD::Solve(const MatType& data,
+                         const arma::mat& responses,
+                         arma::mat& betas) const
+{
+  if (responses.n_cols != data.n_cols)
+  {
+    Log::Fatal << "ElasticNetCD::Solve(): number of responses ("
+        << responses.n_cols << ") does not match number of points ("
+        << data.n_cols << ")!" << std::endl;
+  }
+
+  MatType dataTrans;
+  arma::vec norms;
+  Prepare(data, dataTrans, norms);
+
+  SolveTransposed(dataTrans, norms, responses, lambda1, lambda2, maxIterations,
+      tolerance, betas);
+}
+
+template<typename MatType>
+void ElasticNetCD::Predict(const MatType& points,
+                           arma::rowvec& predictions) const
+{
+  predictions = beta.t() * points;
+}
+
+template<typename MatType>
+double ElasticNetCD::Objective(const MatType& data,
+                               const arma::rowvec& responses) const
+{
+  const arma::rowvec residual = responses - beta.t() * data;
+  return 0.5 * arma::dot(residual, residual) + lambda1 * arma::norm(beta, 1) +
+      0.5 * lambda2 * arma::dot(beta, beta);
+}
+
+template<typename MatType>
+void ElasticNetCD::SolveTransposed(const MatType& dataTrans,
+                                   const arma::vec& norms,
+                                   const arma::mat& responses,
+                                   const double lambda1,
+                                   const double lambda2,
+                                   const size_t maxIterations,
+                                   const double tolerance,
+                                   arma::mat& betas)
+{
+  if (betas.n_rows != dataTrans.n_cols || betas.n_cols != responses.n_rows)
+    betas.zeros(dataTrans.n_cols, responses.n_rows);
+
+  // Each problem has its own residual, so the problems are independent.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) responses.n_rows; ++t)
+  {
+    arma::vec beta = betas.col(t);
+    arma::vec residual = responses.row(t).t();
+    for (size_t j = 0; j < beta.n_elem; ++j)
+    {
+      if (beta[j] != 0.0)
+        ColumnUpdate(dataTrans, j, beta[j], residual);
+    }
+
+    Descend([&](const bool activeOnly)
+    {
+      return Sweep(dataTrans, norms, lambda1, lambda2, activeOnly, beta,
+          residual);
+    }, maxIterations, tolerance);
+
+    betas.col(t) = beta;
+  }
+}
+
+template<typename SweepType>
+size_t ElasticNetCD::Descend(const SweepType& sweep,
+                             const size_t maxIterations,
+                             const double tolerance)
+{
+  size_t iteration = 0;
+  while (iteration < maxIterations)
+  {
+    // A sweep over all the coefficients that changes nothing means the
+    // optimality conditions hold.
+    ++iteration;
+    if (sweep(false) <= tolerance)
+      break;
+
+    // Otherwise, optimize the active coefficients until they converge.
+    while (iteration < maxIterations)
+    {
+      ++iteration;
+      if (sweep(true) <= tolerance)
+        break;
+    }
+  }
+
+  return iteration;
+}
+
+template<typename MatType>
+double ElasticNetCD::Sweep(const MatType& dataTrans,
+                           const arma::vec& norms,
+                           const double lambda1,
+                           const double lambda2,
+                           const bool activeOnly,
+                           arma::vec& beta,
+                           arma::vec& residual)
+{
+  double maxChange = 0.0;
+  for (size_t j = 0; j < beta.n_elem; ++j)
+  {
+    // Coefficients of empty dimensions stay zero.
+    if (norms[j] == 0.0 || (activeOnly && beta[j] == 0.0))
+      continue;
+
+    const double oldBeta = beta[j];
+    const double z = ColumnDot(dataTrans, j, residual) + norms[j] * oldBeta;
+    beta[j] = SoftThreshold(z, lambda1) / (norms[j] + lambda2);
+
+    const double delta = beta[j] - oldBeta;
+    if (delta != 0.0)
+    {
+      ColumnUpdate(dataTrans, j, delta, residual);
+      maxChange = std::max(maxChange, std::abs(delta) * std::sqrt(norms[j]));
+    }
+  }
+
+  return maxChange;
+}
+
+/**
+ * Serialize the model.
+ */
+template<typename Archive>
+void ElasticNetCD::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(lambda1));
+  ar(CEREAL_NVP(lambda2));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(tolerance));
+  ar(CEREAL_NVP(beta));
+  ar(CEREAL_NVP(betaPath));
+  ar(CEREAL_NVP(lambdaPath));
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
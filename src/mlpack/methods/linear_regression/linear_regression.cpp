@@ -47,49 +47,112 @@ double LinearRegression::Train(const arma::mat& predictors,
                                const bool intercept)
 {
   this->intercept = intercept;
+  statistics = NormalEquations();
+  return PartialFit(predictors, responses, weights);
+}
+
+double LinearRegression::Train(const arma::sp_mat& predictors,
+                               const arma::rowvec& responses,
+                               const bool intercept)
+{
+  return Train(predictors, responses, arma::rowvec(), intercept);
+}
 
+double LinearRegression::Train(const arma::sp_mat& predictors,
+                               const arma::rowvec& responses,
+                               const arma::rowvec& weights,
+                               const bool intercept)
+{
+  this->intercept = intercept;
+  statistics = NormalEquations();
+  return PartialFit(predictors, responses, weights);
+}
+
+double LinearRegression::PartialFit(const arma::mat& predictors,
+                                    const arma::rowvec& responses,
+                                    const arma::rowvec& weights)
+{
+  statistics.Update(predictors, responses, weights);
+  Solve();
+  return ComputeError(predictors, responses);
+}
+
+double LinearRegression::PartialFit(const arma::sp_mat& predictors,
+                                    const arma::rowvec& responses,
+                                    const arma::rowvec& weights)
+{
+  statistics.Update(predictors, responses, weights);
+  Solve();
+  return ComputeError(predictors, responses);
+}
+
+void LinearRegression::Solve()
+{
   /*
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
+   * In order to get the intercept value, we add a row of ones to the
+   * predictors X.  The normal equations are then
+   *   (X W X^T + lambda I) a = X W y
+   * and for the row of ones, X W X^T and X W y only hold the sums of the
+   * weighted points and responses.  Forming them took O(d^2 N) time, in
+   * parallel; solving them takes O(d^3).
    */
+  const size_t d = statistics.DataMean().n_elem;
+  const size_t offset = intercept ? 1 : 0;
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
-
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
-
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
-  if (intercept)
+  arma::mat cov(d + offset, d + offset);
+  arma::vec rhs(d + offset);
+  if (d > 0)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    cov.submat(offset, offset, d + offset - 1, d + offset - 1) =
+        statistics.Gram();
+    rhs.subvec(offset, d + offset - 1) = statistics.Correlations();
   }
 
-  if (weights.n_elem > 0)
+  if (intercept)
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    cov(0, 0) = statistics.WeightSum();
+    if (d > 0)
+    {
+      cov.submat(1, 0, d, 0) = statistics.WeightSum() * statistics.DataMean();
+      cov.submat(0, 1, 0, d) = cov.submat(1, 0, d, 0).t();
+    }
+    rhs[0] = statistics.WeightSum() * statistics.ResponsesMean();
   }
 
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
-
-  parameters = arma::solve(cov, p * r.t());
-  return ComputeError(predictors, responses);
+  // Note that the intercept is penalized too.
+  cov.diag() += lambda;
+  parameters = arma::solve(cov, rhs);
 }
 
 void LinearRegression::Predict(const arma::mat& points,
     arma::rowvec& predictions) const
+{
+  PredictPoints(points, predictions);
+}
+
+void LinearRegression::Predict(const arma::sp_mat& points,
+    arma::rowvec& predictions) const
+{
+  PredictPoints(points, predictions);
+}
+
+double LinearRegression::ComputeError(const arma::mat& predictors,
+                                      const arma::rowvec& responses) const
+{
+  return ComputeErrorPoints(predictors, responses);
+}
+
+double LinearRegression::ComputeError(const arma::sp_mat& predictors,
+                                      const arma::rowvec& responses) const
+{
+  return ComputeErrorPoints(predictors, responses);
+}
+
+template<typename MatType>
+void LinearRegression::PredictPoints(const MatType& points,
+                                     arma::rowvec& predictions) const
 {
   if (intercept)
   {
@@ -112,8 +175,9 @@ void LinearRegression::Predict(const arma::mat& points,
   }
 }
 
-double LinearRegression::ComputeError(const arma::mat& predictors,
-                                      const arma::rowvec& responses) const
+template<typename MatType>
+double LinearRegression::ComputeErrorPoints(const MatType& predictors,
+                                            const arma::rowvec& responses) const
 {
   // Get the number of columns and rows of the dataset.
   const size_t nCols = predictors.n_cols;
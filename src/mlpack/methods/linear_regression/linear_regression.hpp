@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "normal_equations.hpp"
 
 namespace mlpack {
 namespace regression /** Regression methods. */ {
@@ -22,6 +23,12 @@ namespace regression /** Regression methods. */ {
  * A simple linear regression algorithm using ordinary least squares.
  * Optionally, this class can perform ridge regression, if the lambda parameter
  * is set to a number greater than zero.
+ *
+ * The model is solved from the normal equations, whose statistics (see
+ * NormalEquations) are accumulated in parallel in a single pass over the data.
+ * The statistics are kept, so PartialFit() can add more data to the model a
+ * chunk at a time, for datasets that do not fit in memory.  Dense and sparse
+ * predictors are supported.
  */
 class LinearRegression
 {
@@ -63,10 +70,9 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
-   * completely ignore and overwrite the existing model. This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model; to add data to the
+   * existing model, use PartialFit().  To set the regularization parameter
+   * lambda, call Lambda() or set a different value in the constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -79,10 +85,10 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data and weights. Careful!
-   * This will completely ignore and overwrite the existing model. This
-   * particular implementation does not have an incremental training algorithm.
-   * To set the regularization parameter lambda, call Lambda() or set a
-   * different value in the constructor.
+   * This will completely ignore and overwrite the existing model; to add data
+   * to the existing model, use PartialFit().  To set the regularization
+   * parameter lambda, call Lambda() or set a different value in the
+   * constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -95,6 +101,63 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Train the LinearRegression model on the given sparse data.  Careful!  This
+   * will completely ignore and overwrite the existing model.
+   *
+   * @param predictors X, the matrix of data points to train the model on.
+   * @param responses y, the responses to the data points.
+   * @param intercept Whether or not to fit an intercept term.
+   * @return The least squares error after training.
+   */
+  double Train(const arma::sp_mat& predictors,
+               const arma::rowvec& responses,
+               const bool intercept = true);
+
+  /**
+   * Train the LinearRegression model on the given sparse data and weights.
+   * Careful!  This will completely ignore and overwrite the existing model.
+   *
+   * @param predictors X, the matrix of data points to train the model on.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights (for boosting).
+   * @param intercept Whether or not to fit an intercept term.
+   * @return The least squares error after training.
+   */
+  double Train(const arma::sp_mat& predictors,
+               const arma::rowvec& responses,
+               const arma::rowvec& weights,
+               const bool intercept = true);
+
+  /**
+   * Add the given data to the model, and solve it again.  The result is the
+   * same as if Train() had been called with all of the data given to Train()
+   * and PartialFit() since the model was last trained, but only the statistics
+   * of that data are kept.  Whether an intercept is fit is set by the last
+   * call to Train() (or the constructor).
+   *
+   * @param predictors X, the matrix of data points to add.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights (empty means all weights are 1).
+   * @return The least squares error on the given data after training.
+   */
+  double PartialFit(const arma::mat& predictors,
+                    const arma::rowvec& responses,
+                    const arma::rowvec& weights = arma::rowvec());
+
+  /**
+   * Add the given sparse data to the model, and solve it again.  See the
+   * other overload.
+   *
+   * @param predictors X, the matrix of data points to add.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights (empty means all weights are 1).
+   * @return The least squares error on the given data after training.
+   */
+  double PartialFit(const arma::sp_mat& predictors,
+                    const arma::rowvec& responses,
+                    const arma::rowvec& weights = arma::rowvec());
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -103,6 +166,14 @@ class LinearRegression
    */
   void Predict(const arma::mat& points, arma::rowvec& predictions) const;
 
+  /**
+   * Calculate y_i for each data point in the given sparse matrix.
+   *
+   * @param points the data points to calculate with.
+   * @param predictions y, will contain calculated values on completion.
+   */
+  void Predict(const arma::sp_mat& points, arma::rowvec& predictions) const;
+
   /**
    * Calculate the L2 squared error on the given predictors and responses using
    * this linear regression model. This calculation returns
@@ -123,6 +194,16 @@ class LinearRegression
   double ComputeError(const arma::mat& points,
                       const arma::rowvec& responses) const;
 
+  /**
+   * Calculate the L2 squared error on the given sparse predictors and
+   * responses.  See the other overload.
+   *
+   * @param points Matrix of predictors (X).
+   * @param responses Transposed vector of responses (y^T).
+   */
+  double ComputeError(const arma::sp_mat& points,
+                      const arma::rowvec& responses) const;
+
   //! Return the parameters (the b vector).
   const arma::vec& Parameters() const { return parameters; }
   //! Modify the parameters (the b vector).
@@ -136,18 +217,42 @@ class LinearRegression
   //! Return whether or not an intercept term is used in the model.
   bool Intercept() const { return intercept; }
 
+  //! Return the statistics of the data the model was trained on.
+  const NormalEquations& Statistics() const { return statistics; }
+
   /**
    * Serialize the model.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(parameters));
     ar(CEREAL_NVP(lambda));
     ar(CEREAL_NVP(intercept));
+
+    // Older versions did not store the statistics, so PartialFit() on them
+    // starts a new fit.
+    if (version > 0)
+      ar(CEREAL_NVP(statistics));
+    else if (cereal::is_loading<Archive>())
+      statistics = NormalEquations();
   }
 
  private:
+  /**
+   * Solve the normal equations of the statistics for the parameters.
+   */
+  void Solve();
+
+  //! Compute the predictions of Predict() for dense or sparse points.
+  template<typename MatType>
+  void PredictPoints(const MatType& points, arma::rowvec& predictions) const;
+
+  //! Compute the error of ComputeError() for dense or sparse points.
+  template<typename MatType>
+  double ComputeErrorPoints(const MatType& predictors,
+                            const arma::rowvec& responses) const;
+
   /**
    * The calculated B.
    * Initialized and filled by constructor to hold the least squares solution.
@@ -162,9 +267,14 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! The statistics of the data the model was trained on.
+  NormalEquations statistics;
 };
 
 } // namespace regression
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::regression::LinearRegression, 1);
+
 #endif // MLPACK_METHODS_LINEAR_REGRESSION_HPP
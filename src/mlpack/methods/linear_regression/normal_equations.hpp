@@ -0,0 +1,253 @@
+/**
+ * @file methods/linear_regression/normal_equations.hpp
+ *
+ * NormalEquations class, which accumulates the statistics that least squares
+ * models are solved with in a single pass over the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace regression {
+
+/**
+ * The NormalEquations class holds the (weighted) number of points, the means
+ * of the predictors and responses, and the scatter matrices
+ *
+ *   sum_i w_i (x_i - mean(x)) (x_i - mean(x))^T,
+ *   sum_i w_i (x_i - mean(x)) (y_i - mean(y)),
+ *   sum_i w_i (y_i - mean(y))^2
+ *
+ * of a dataset, from which the normal equations X W X^T b = X W y of a least
+ * squares problem (with or without centering) can be formed.  With OpenMP,
+ * each thread accumulates the statistics of its own block of points, and the
+ * statistics of the blocks are then merged with the pairwise formulas of Chan
+ * et al.  The same merge is used when more points are added with Update(), so
+ * a dataset can be processed in chunks, and only the statistics (not the
+ * points) are kept.  Dense and sparse predictors are supported.
+ *
+ * @code
+ * NormalEquations statistics;
+ * statistics.Update(firstChunk, firstResponses);
+ * statistics.Update(secondChunk, secondResponses);
+ * arma::vec b = arma::solve(statistics.Gram(), statistics.Correlations());
+ * @endcode
+ */
+class NormalEquations
+{
+ public:
+  //! Create an empty object, with no points.
+  NormalEquations() :
+      count(0),
+      weightSum(0.0),
+      responsesMean(0.0),
+      responsesScatter(0.0)
+  { }
+
+  /**
+   * Add the points (columns) of the given dataset to the statistics.  The
+   * dimensionality of the dataset must be the same for every call.
+   *
+   * @param predictors Dataset to add.
+   * @param responses Response of each point.
+   * @param weights Weight of each point (empty means all weights are 1).
+   */
+  template<typename MatType>
+  void Update(const MatType& predictors,
+              const arma::rowvec& responses,
+              const arma::rowvec& weights = arma::rowvec())
+  {
+    if (count > 0 && predictors.n_rows != dataMean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "NormalEquations::Update(): dataset has " << predictors.n_rows
+          << " dimensions, but previous data had " << dataMean.n_elem;
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (responses.n_elem != predictors.n_cols ||
+        (weights.n_elem > 0 && weights.n_elem != predictors.n_cols))
+    {
+      std::ostringstream oss;
+      oss << "NormalEquations::Update(): dataset has " << predictors.n_cols
+          << " points, but " << responses.n_elem << " responses and "
+          << weights.n_elem << " weights were given";
+      throw std::invalid_argument(oss.str());
+    }
+
+    #ifdef HAS_OPENMP
+    const size_t blocks = std::max(std::min((size_t) omp_get_max_threads(),
+        (size_t) predictors.n_cols), (size_t) 1);
+    #else
+    const size_t blocks = 1;
+    #endif
+
+    std::vector<NormalEquations> partial(blocks);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t begin = b * predictors.n_cols / blocks;
+      const size_t end = (b + 1) * predictors.n_cols / blocks;
+      partial[b].UpdateSerial(predictors, responses, weights, begin, end);
+    }
+
+    for (size_t b = 0; b < blocks; ++b)
+      Merge(partial[b]);
+  }
+
+  /**
+   * Merge the statistics of other points into these statistics.
+   *
+   * @param other Statistics of the other points.
+   */
+  void Merge(const NormalEquations& other)
+  {
+    if (other.count == 0)
+      return;
+
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    const double total = weightSum + other.weightSum;
+    const arma::vec delta = other.dataMean - dataMean;
+    const double responsesDelta = other.responsesMean - responsesMean;
+    const double factor = weightSum * (other.weightSum / total);
+
+    scatter += other.scatter + factor * (delta * delta.t());
+    crossScatter += other.crossScatter + (factor * responsesDelta) * delta;
+    responsesScatter += other.responsesScatter +
+        factor * responsesDelta * responsesDelta;
+    dataMean += delta * (other.weightSum / total);
+    responsesMean += responsesDelta * (other.weightSum / total);
+    weightSum = total;
+    count += other.count;
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the sum of the weights of the points.
+  double WeightSum() const { return weightSum; }
+  //! Get the (weighted) mean of each dimension.
+  const arma::vec& DataMean() const { return dataMean; }
+  //! Get the (weighted) mean of the responses.
+  double ResponsesMean() const { return responsesMean; }
+  //! Get the scatter matrix of the centered predictors.
+  const arma::mat& Scatter() const { return scatter; }
+  //! Get the scatter of the centered predictors with the centered responses.
+  const arma::vec& CrossScatter() const { return crossScatter; }
+  //! Get the sum of squares of the centered responses.
+  double ResponsesScatter() const { return responsesScatter; }
+
+  //! Get X W X^T, for the uncentered predictors.
+  arma::mat Gram() const
+  {
+    return scatter + weightSum * (dataMean * dataMean.t());
+  }
+
+  //! Get X W y, for the uncentered predictors and responses.
+  arma::vec Correlations() const
+  {
+    return crossScatter + (weightSum * responsesMean) * dataMean;
+  }
+
+  //! Get y^T W y, for the uncentered responses.
+  double ResponsesSquares() const
+  {
+    return responsesScatter + weightSum * responsesMean * responsesMean;
+  }
+
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(count));
+    ar(CEREAL_NVP(weightSum));
+    ar(CEREAL_NVP(dataMean));
+    ar(CEREAL_NVP(responsesMean));
+    ar(CEREAL_NVP(scatter));
+    ar(CEREAL_NVP(crossScatter));
+    ar(CEREAL_NVP(responsesScatter));
+  }
+
+ private:
+  /**
+   * Compute the statistics of the points [begin, end) of the given dataset,
+   * which must be the first points given to this object.  The points are
+   * centered a block at a time, so that sparse data is never densified as a
+   * whole.
+   */
+  template<typename MatType>
+  void UpdateSerial(const MatType& predictors,
+                    const arma::rowvec& responses,
+                    const arma::rowvec& weights,
+                    const size_t begin,
+                    const size_t end)
+  {
+    if (begin == end)
+      return;
+
+    const arma::rowvec w = (weights.n_elem > 0) ?
+        arma::rowvec(weights.subvec(begin, end - 1)) :
+        arma::rowvec(end - begin, arma::fill::ones);
+    weightSum = arma::accu(w);
+    if (weightSum == 0.0)
+      return; // Points with no weight do not contribute anything.
+
+    count = end - begin;
+    dataMean = arma::vec(predictors.cols(begin, end - 1) * w.t()) / weightSum;
+    responsesMean = arma::dot(responses.subvec(begin, end - 1), w) /
+        weightSum;
+
+    scatter.zeros(predictors.n_rows, predictors.n_rows);
+    crossScatter.zeros(predictors.n_rows);
+    responsesScatter = 0.0;
+
+    const size_t blockSize = 1024;
+    for (size_t b = begin; b < end; b += blockSize)
+    {
+      const size_t e = std::min(b + blockSize, end);
+      arma::mat centered(predictors.cols(b, e - 1));
+      centered.each_col() -= dataMean;
+      const arma::rowvec r = responses.subvec(b, e - 1) - responsesMean;
+      const arma::rowvec blockWeights = w.subvec(b - begin, e - 1 - begin);
+
+      const arma::mat weighted = centered.each_row() % blockWeights;
+      scatter += weighted * centered.t();
+      crossScatter += weighted * r.t();
+      responsesScatter += arma::dot(r % blockWeights, r);
+    }
+  }
+
+  //! The number of points.
+  size_t count;
+  //! The sum of the weights of the points.
+  double weightSum;
+  //! The mean of each dimension.
+  arma::vec dataMean;
+  //! The mean of the responses.
+  double responsesMean;
+  //! The scatter matrix of the centered predictors.
+  arma::mat scatter;
+  //! The scatter of the centered predictors with the centered responses.
+  arma::vec crossScatter;
+  //! The sum of squares of the centered responses.
+  double responsesScatter;
+}; // class NormalEquations
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
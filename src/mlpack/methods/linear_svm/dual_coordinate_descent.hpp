@@ -0,0 +1,174 @@
+/**
+ * @file methods/linear_svm/dual_coordinate_descent.hpp
+ *
+ * Definition of the DualCoordinateDescent solver for the LinearSVM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_HPP
+#define MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "linear_svm_function.hpp"
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * DualCoordinateDescent trains a LinearSVM with the dual coordinate descent
+ * method of LIBLINEAR, with shrinking, instead of running a general optimizer
+ * on the primal objective.  It is used in place of an ensmallen optimizer:
+ *
+ * @code
+ * arma::sp_mat data; // Training data (for instance, bags of words).
+ * arma::Row<size_t> labels; // Labels associated with the data.
+ *
+ * LinearSVM<arma::sp_mat> lsvm(data, labels, numClasses, lambda, delta,
+ *     fitIntercept, DualCoordinateDescent());
+ * @endcode
+ *
+ * The classes are trained one-vs-rest: the column of class c of the parameters
+ * is the solution of the L2-regularized binary SVM with L1 (hinge) loss
+ *
+ *   min_w 0.5 ||w||^2 + C sum_i max(0, delta - y_i w^T x_i),
+ *
+ * where y_i is +1 for the points of class c and -1 for the others, and
+ * C = 1 / (lambda n), so that lambda and delta have the same role as in
+ * LinearSVMFunction.  When fitIntercept is true, the intercept is handled as
+ * the weight of a feature that is 1 for all the points (so it is regularized
+ * too).  The classes are trained in parallel with OpenMP, and dense and sparse
+ * data are supported.  With two classes only one problem is solved, since the
+ * column of class 0 is the negation of the column of class 1.
+ *
+ * Note that the one-vs-rest problems are not the multiclass problem that
+ * LinearSVMFunction describes, so the parameters differ from the ones found by
+ * the other optimizers, although the classifiers are usually as accurate.  For
+ * more details, see the following paper:
+ *
+ * @code
+ * @inproceedings{hsieh2008dual,
+ *   title     = {A Dual Coordinate Descent Method for Large-scale Linear SVM},
+ *   author    = {Hsieh, Cho-Jui and Chang, Kai-Wei and Lin, Chih-Jen and
+ *                Keerthi, S. Sathiya and Sundararajan, S.},
+ *   booktitle = {Proceedings of the 25th International Conference on Machine
+ *                Learning (ICML '08)},
+ *   pages     = {408--415},
+ *   year      = {2008}
+ * }
+ * @endcode
+ */
+class DualCoordinateDescent
+{
+ public:
+  /**
+   * Create the solver.
+   *
+   * @param maxIterations Maximum number of passes over the data for each
+   *     class (0 means no limit).
+   * @param tolerance Stop when the gap between the largest and the smallest
+   *     projected gradient of a pass is below this value.
+   * @param shrinking Whether to remove the variables that are likely to stay
+   *     at a bound from the passes.
+   */
+  DualCoordinateDescent(const size_t maxIterations = 1000,
+                        const double tolerance = 0.1,
+                        const bool shrinking = true);
+
+  /**
+   * Train the model described by the given function, and store the
+   * parameters (one column per class, with the intercepts in the last row if
+   * FitIntercept() is true) in the given matrix.  The contents of the given
+   * matrix are not used as a starting point.
+   *
+   * @param function The LinearSVMFunction to be trained.
+   * @param parameters Matrix to store the parameters in.
+   * @return The value of function.Evaluate() at the parameters.
+   */
+  template<typename MatType>
+  double Optimize(LinearSVMFunction<MatType>& function,
+                  arma::mat& parameters);
+
+  //! Get the maximum number of passes.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether shrinking is used.
+  bool Shrinking() const { return shrinking; }
+  //! Modify whether shrinking is used.
+  bool& Shrinking() { return shrinking; }
+
+ private:
+  /**
+   * Solve the binary problem of the given class, and store its weights (with
+   * the intercept last) in w.  Return the number of passes.
+   */
+  template<typename MatType>
+  size_t Solve(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const size_t positiveClass,
+               const arma::rowvec& squaredNorms,
+               const double c,
+               const double delta,
+               const bool fitIntercept,
+               std::mt19937& generator,
+               double* w) const;
+
+  //! Compute the dot product of point i of dense data with the weights.
+  template<typename eT>
+  static double ColumnDot(const arma::Mat<eT>& data,
+                          const size_t i,
+                          const double* w);
+
+  //! Compute the dot product of point i of sparse data with the weights.
+  template<typename eT>
+  static double ColumnDot(const arma::SpMat<eT>& data,
+                          const size_t i,
+                          const double* w);
+
+  //! Add scale times point i of dense data to the weights.
+  template<typename eT>
+  static void AddColumn(const arma::Mat<eT>& data,
+                        const size_t i,
+                        const double scale,
+                        double* w);
+
+  //! Add scale times point i of sparse data to the weights.
+  template<typename eT>
+  static void AddColumn(const arma::SpMat<eT>& data,
+                        const size_t i,
+                        const double scale,
+                        double* w);
+
+  //! Make sure the compressed representation of sparse data is up to date.
+  template<typename eT>
+  static void Sync(const arma::SpMat<eT>& data) { data.sync(); }
+
+  //! Dense data needs no synchronization.
+  template<typename eT>
+  static void Sync(const arma::Mat<eT>& /* data */) { }
+
+  //! The maximum number of passes.
+  size_t maxIterations;
+  //! The tolerance on the projected gradients.
+  double tolerance;
+  //! Whether shrinking is used.
+  bool shrinking;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "dual_coordinate_descent_impl.hpp"
+
+#endif
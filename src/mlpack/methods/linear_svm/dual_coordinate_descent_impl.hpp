@@ -0,0 +1,264 @@
+/**
+ * @file methods/linear_svm/dual_coordinate_descent_impl.hpp
+ *
+ * Implementation of the DualCoordinateDescent solver for the LinearSVM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dual_coordinate_descent.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace svm {
+
+inline DualCoordinateDescent::DualCoordinateDescent(
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shrinking) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shrinking(shrinking)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+double DualCoordinateDescent::Optimize(LinearSVMFunction<MatType>& function,
+                                       arma::mat& parameters)
+{
+  const MatType& data = function.Dataset();
+  const size_t numClasses = function.NumClasses();
+  const bool fitIntercept = function.FitIntercept();
+  Sync(data);
+
+  // Recover the labels from the label matrix, which has one nonzero per
+  // column.
+  const arma::sp_mat& groundTruth = function.GroundTruth();
+  groundTruth.sync();
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = groundTruth.row_indices[groundTruth.col_ptrs[i]];
+
+  // The weight of the hinge loss of each point, so that the binary problems
+  // have the same scale as LinearSVMFunction.
+  const double c = (function.Lambda() > 0.0) ?
+      1.0 / (function.Lambda() * data.n_cols) :
+      std::numeric_limits<double>::infinity();
+
+  const arma::rowvec squaredNorms(arma::sum(arma::square(data), 0));
+
+  parameters.zeros(data.n_rows + (fitIntercept ? 1 : 0), numClasses);
+
+  // With two classes, the problem of class 0 is the problem of class 1 with
+  // the signs of the labels flipped, so only class 1 is solved.
+  const size_t firstClass = (numClasses == 2) ? 1 : 0;
+  const size_t firstStream = math::ReserveRandomStreams(numClasses);
+  arma::Row<size_t> iterations(numClasses, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t k = (omp_size_t) firstClass; k < (omp_size_t) numClasses;
+       ++k)
+  {
+    std::mt19937 generator = math::RandomStream(firstStream + k);
+    iterations[k] = Solve(data, labels, k, squaredNorms, c, function.Delta(),
+        fitIntercept, generator, parameters.colptr(k));
+  }
+
+  if (numClasses == 2)
+    parameters.col(0) = -parameters.col(1);
+
+  for (size_t k = firstClass; k < numClasses; ++k)
+  {
+    if (maxIterations != 0 && iterations[k] >= maxIterations)
+    {
+      Log::Warning << "DualCoordinateDescent::Optimize(): class " << k
+          << " did not converge after " << maxIterations << " passes; "
+          << "consider increasing the tolerance or the maximum number of "
+          << "passes." << std::endl;
+    }
+    else
+    {
+      Log::Info << "DualCoordinateDescent::Optimize(): class " << k
+          << " converged after " << iterations[k] << " passes." << std::endl;
+    }
+  }
+
+  return function.Evaluate(parameters);
+}
+
+template<typename MatType>
+size_t DualCoordinateDescent::Solve(const MatType& data,
+                                    const arma::Row<size_t>& labels,
+                                    const size_t positiveClass,
+                                    const arma::rowvec& squaredNorms,
+                                    const double c,
+                                    const double delta,
+                                    const bool fitIntercept,
+                                    std::mt19937& generator,
+                                    double* w) const
+{
+  const size_t n = data.n_cols;
+  const double inf = std::numeric_limits<double>::infinity();
+
+  std::vector<double> alpha(n, 0.0);
+  std::vector<size_t> index(n);
+  for (size_t i = 0; i < n; ++i)
+    index[i] = i;
+
+  // The points in index[0, activeSize) are visited by the passes; the others
+  // have been shrunk, since their dual variables are likely to stay at a
+  // bound.
+  size_t activeSize = n;
+  double maxGradientOld = inf;
+  double minGradientOld = -inf;
+
+  size_t iteration = 0;
+  while (maxIterations == 0 || iteration < maxIterations)
+  {
+    double maxGradient = -inf;
+    double minGradient = inf;
+
+    for (size_t s = 0; s < activeSize; ++s)
+    {
+      std::uniform_int_distribution<size_t> dist(s, activeSize - 1);
+      std::swap(index[s], index[dist(generator)]);
+    }
+
+    for (size_t s = 0; s < activeSize; ++s)
+    {
+      const size_t i = index[s];
+      const double q = squaredNorms[i] + (fitIntercept ? 1.0 : 0.0);
+      if (q == 0.0)
+        continue; // The point does not change the weights.
+
+      const double y = (labels[i] == positiveClass) ? 1.0 : -1.0;
+      double dot = ColumnDot(data, i, w);
+      if (fitIntercept)
+        dot += w[data.n_rows];
+      const double gradient = y * dot - delta;
+
+      // Compute the projected gradient, and shrink the point if its variable
+      // is at a bound and the gradient pushes it further.
+      double projected = 0.0;
+      if (alpha[i] == 0.0)
+      {
+        if (shrinking && gradient > maxGradientOld)
+        {
+          std::swap(index[s], index[--activeSize]);
+          --s;
+          continue;
+        }
+        else if (gradient < 0.0)
+        {
+          projected = gradient;
+        }
+      }
+      else if (alpha[i] == c)
+      {
+        if (shrinking && gradient < minGradientOld)
+        {
+          std::swap(index[s], index[--activeSize]);
+          --s;
+          continue;
+        }
+        else if (gradient > 0.0)
+        {
+          projected = gradient;
+        }
+      }
+      else
+      {
+        projected = gradient;
+      }
+
+      maxGradient = std::max(maxGradient, projected);
+      minGradient = std::min(minGradient, projected);
+
+      if (std::abs(projected) > 1e-12)
+      {
+        const double oldAlpha = alpha[i];
+        alpha[i] = std::min(std::max(alpha[i] - gradient / q, 0.0), c);
+        const double step = (alpha[i] - oldAlpha) * y;
+        AddColumn(data, i, step, w);
+        if (fitIntercept)
+          w[data.n_rows] += step;
+      }
+    }
+
+    ++iteration;
+
+    if (maxGradient - minGradient <= tolerance)
+    {
+      // Converged on the active points; check all the points before stopping.
+      if (activeSize == n)
+        break;
+
+      activeSize = n;
+      maxGradientOld = inf;
+      minGradientOld = -inf;
+      continue;
+    }
+
+    maxGradientOld = (maxGradient <= 0.0) ? inf : maxGradient;
+    minGradientOld = (minGradient >= 0.0) ? -inf : minGradient;
+  }
+
+  return iteration;
+}
+
+template<typename eT>
+double DualCoordinateDescent::ColumnDot(const arma::Mat<eT>& data,
+                                        const size_t i,
+                                        const double* w)
+{
+  const eT* x = data.colptr(i);
+  double dot = 0.0;
+  for (size_t r = 0; r < data.n_rows; ++r)
+    dot += x[r] * w[r];
+  return dot;
+}
+
+template<typename eT>
+double DualCoordinateDescent::ColumnDot(const arma::SpMat<eT>& data,
+                                        const size_t i,
+                                        const double* w)
+{
+  double dot = 0.0;
+  for (size_t j = data.col_ptrs[i]; j < data.col_ptrs[i + 1]; ++j)
+    dot += data.values[j] * w[data.row_indices[j]];
+  return dot;
+}
+
+template<typename eT>
+void DualCoordinateDescent::AddColumn(const arma::Mat<eT>& data,
+                                      const size_t i,
+                                      const double scale,
+                                      double* w)
+{
+  const eT* x = data.colptr(i);
+  for (size_t r = 0; r < data.n_rows; ++r)
+    w[r] += scale * x[r];
+}
+
+template<typename eT>
+void DualCoordinateDescent::AddColumn(const arma::SpMat<eT>& data,
+                                      const size_t i,
+                                      const double scale,
+                                      double* w)
+{
+  for (size_t j = data.col_ptrs[i]; j < data.col_ptrs[i + 1]; ++j)
+    w[data.row_indices[j]] += scale * data.values[j];
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 #include <ensmallen.hpp>
 
 #include "linear_svm_function.hpp"
+#include "dual_coordinate_descent.hpp"
 
 namespace mlpack {
 namespace svm {
@@ -74,6 +75,10 @@ namespace svm {
  * lsvm.Classify(test_data, predictions);
  * @endcode
  *
+ * Instead of an ensmallen optimizer, the DualCoordinateDescent solver can be
+ * given to train one-vs-rest classifiers with the dual coordinate descent
+ * method of LIBLINEAR, which is usually much faster on large sparse datasets.
+ *
  * @tparam MatType Type of data matrix.
  */
 template <typename MatType = arma::mat>
@@ -122,6 +122,24 @@ class LinearSVMFunction
                 GradType& gradient,
                 const size_t batchSize = 1);
 
+  /**
+   * Evaluate the gradient of the hinge loss function on a batch as a sparse
+   * matrix, which only holds the rows of the features that are nonzero in the
+   * batch (and of the intercept).  The regularization is only applied to
+   * those rows (once for each point that has the feature).  This is used by
+   * optimizers such as ParallelSGD (Hogwild!), which apply sparse updates
+   * from many threads without locking.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the datapoint to use for the gradient evaluation.
+   * @param gradient Sparse matrix to output the gradient into.
+   * @param batchSize Size of the batch to process.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t firstId,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1);
+
   /**
    * Evaluate the gradient of the hinge loss function, following
    * the LinearFunctionType requirements on the Gradient function
@@ -163,9 +181,19 @@ class LinearSVMFunction
   arma::mat& InitialPoint() { return initialPoint; }
 
   //! Get the dataset.
-  const arma::sp_mat& Dataset() const { return dataset; }
+  const MatType& Dataset() const { return dataset; }
   //! Modify the dataset.
-  arma::sp_mat& Dataset() { return dataset; }
+  MatType& Dataset() { return dataset; }
+
+  //! Get the label matrix (one column per point, with a one in the row of its
+  //! class).
+  const arma::sp_mat& GroundTruth() const { return groundTruth; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the margin parameter.
+  double Delta() const { return delta; }
 
   //! Sets the regularization parameter.
   double& Lambda() { return lambda; }
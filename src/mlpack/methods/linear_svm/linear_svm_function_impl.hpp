@@ -355,6 +355,80 @@ void LinearSVMFunction<MatType>::Gradient(
   gradient += lambda * parameters;
 }
 
+template <typename MatType>
+void LinearSVMFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t firstId,
+    arma::sp_mat& gradient,
+    const size_t batchSize)
+{
+  const size_t lastId = firstId + batchSize - 1;
+  const arma::sp_mat batch(dataset.cols(firstId, lastId));
+
+  // Scores for each class are evaluated.
+  arma::mat scores;
+
+  // Check intercept condition.
+  if (!fitIntercept)
+  {
+    scores = parameters.t() * batch;
+  }
+  else
+  {
+    scores = parameters.rows(0, dataset.n_rows - 1).t() * batch
+        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
+  }
+
+  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
+      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
+      + delta - (delta * groundTruth.cols(firstId, lastId));
+
+  // For each sample, find the total number of classes where
+  // ( margin > 0 ).
+  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
+      { val = (val > 0) ? 1: 0; });
+
+  const arma::mat difference = (groundTruth.cols(firstId, lastId)
+      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask) / batchSize;
+
+  // Duplicate locations (a feature that is nonzero in several points) are
+  // summed when the sparse matrix is built.
+  const size_t interceptRows = fitIntercept ? 1 : 0;
+  arma::umat locations(2, numClasses * (batch.n_nonzero + interceptRows));
+  arma::vec values(numClasses * (batch.n_nonzero + interceptRows));
+  size_t i = 0;
+
+  // Per-point regularization, so that a feature that is nonzero in every
+  // point of the batch gets the same regularization as the dense gradient.
+  const double regularization = lambda / batchSize;
+  for (arma::sp_mat::const_iterator it = batch.begin(); it != batch.end();
+       ++it)
+  {
+    for (size_t c = 0; c < numClasses; ++c, ++i)
+    {
+      locations(0, i) = it.row();
+      locations(1, i) = c;
+      values[i] = difference(c, it.col()) * (*it) +
+          regularization * parameters(it.row(), c);
+    }
+  }
+
+  if (fitIntercept)
+  {
+    const arma::vec interceptGradient = arma::sum(difference, 1) +
+        lambda * parameters.row(dataset.n_rows).t();
+    for (size_t c = 0; c < numClasses; ++c, ++i)
+    {
+      locations(0, i) = dataset.n_rows;
+      locations(1, i) = c;
+      values[i] = interceptGradient[c];
+    }
+  }
+
+  gradient = arma::sp_mat(true, locations, values, parameters.n_rows,
+      parameters.n_cols);
+}
+
 template <typename MatType>
 template <typename GradType>
 double LinearSVMFunction<MatType>::EvaluateWithGradient(
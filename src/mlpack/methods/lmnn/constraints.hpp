@@ -186,6 +186,12 @@ class Constraints
   //! Modify the number of target neighbors (k).
   size_t& K() { return k; }
 
+  //! Get the relative error allowed in the impostor searches (0 means exact).
+  double Epsilon() const { return epsilon; }
+  //! Modify the relative error allowed in the impostor searches (0 means
+  //! exact).  Larger values make the searches faster.
+  double& Epsilon() { return epsilon; }
+
   //! Access the boolean value of precalculated.
   const bool& PreCalulated() const { return precalculated; }
   //! Modify the value of precalculated.
@@ -195,6 +201,9 @@ class Constraints
   //! Number of target neighbors & impostors to calulate.
   size_t k;
 
+  //! Relative error allowed in the impostor searches.
+  double epsilon;
+
   //! Store unique labels.
   arma::Row<size_t> uniqueLabels;
 
@@ -24,6 +24,7 @@ Constraints<MetricType>::Constraints(
     const arma::Row<size_t>& labels,
     const size_t k) :
     k(k),
+    epsilon(0.0),
     precalculated(false)
 {
   // Ensure a valid k is passed.
@@ -171,8 +172,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  // KNN instance; the search may be approximate.
+  KNN knn(neighbor::DUAL_TREE_MODE, epsilon);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -209,8 +210,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  // KNN instance; the search may be approximate.
+  KNN knn(neighbor::DUAL_TREE_MODE, epsilon);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -252,8 +253,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
+  // KNN instance; the search may be approximate.
+  KNN knn(neighbor::DUAL_TREE_MODE, epsilon);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -301,8 +302,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
-  // KNN instance.
-  KNN knn;
+  // KNN instance; the search may be approximate.
+  KNN knn(neighbor::DUAL_TREE_MODE, epsilon);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -348,8 +349,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  // KNN instance; the search may be approximate.
+  KNN knn(neighbor::DUAL_TREE_MODE, epsilon);
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -102,6 +102,13 @@ class LMNN
   //! Modify the range value.
   size_t& Range() { return range; }
 
+  //! Access the relative error allowed in the impostor searches.  With a
+  //! nonzero value, the impostors are found with approximate nearest neighbor
+  //! searches, which are faster on large datasets.
+  const double& ImpostorEpsilon() const { return impostorEpsilon; }
+  //! Modify the relative error allowed in the impostor searches.
+  double& ImpostorEpsilon() { return impostorEpsilon; }
+
   //! Access the value of k.
   const size_t& K() const { return k; }
   //! Modify the value of k.
@@ -127,6 +134,9 @@ class LMNN
   //! Range after which impostors need to be recalculated.
   size_t range;
 
+  //! Relative error allowed in the impostor searches.
+  double impostorEpsilon;
+
   //! Metric to be used.
   MetricType metric;
 
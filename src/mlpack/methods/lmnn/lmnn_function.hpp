@@ -189,6 +189,11 @@ class LMNNFunction
   //! Modify the value of k.
   size_t& Range() { return range; }
 
+  //! Get the relative error allowed in the impostor searches.
+  double ImpostorEpsilon() const { return constraint.Epsilon(); }
+  //! Modify the relative error allowed in the impostor searches.
+  double& ImpostorEpsilon() { return constraint.Epsilon(); }
+
  private:
   //! data.  This will be an alias until Shuffle() is called.
   arma::mat dataset;
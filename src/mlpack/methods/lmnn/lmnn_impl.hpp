@@ -32,6 +32,7 @@ LMNN<MetricType, OptimizerType>::LMNN(const arma::mat& dataset,
     k(k),
     regularization(0.5),
     range(1),
+    impostorEpsilon(0.0),
     metric(metric)
 { /* nothing to do */ }
 
@@ -43,6 +44,7 @@ void LMNN<MetricType, OptimizerType>::LearnDistance(arma::mat& outputMatrix,
   // LMNN objective function.
   LMNNFunction<MetricType> objFunction(dataset, labels, k,
       regularization, range);
+  objFunction.ImpostorEpsilon() = impostorEpsilon;
 
   // See if we were passed an initialized matrix. outputMatrix (L) must be
   // having r x d dimensionality.
@@ -65,7 +65,9 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("regularization") + "), In addition, this "
     "implementation of LMNN includes a parameter to decide the interval "
     "after which impostors must be re-calculated (specified with " +
-    PRINT_PARAM_STRING("range") + ")."
+    PRINT_PARAM_STRING("range") + ").  On large datasets, the impostor "
+    "searches can be made approximate (and faster) by allowing a relative error"
+    " with the " + PRINT_PARAM_STRING("epsilon") + " parameter."
     "\n\n"
     "Output can either be the learned distance matrix (specified with " +
     PRINT_PARAM_STRING("output") +"), or the transformed dataset "
@@ -184,6 +186,8 @@ PARAM_FLAG("linear_scan", "Don't shuffle the order in which data points are "
 PARAM_INT_IN("batch_size", "Batch size for mini-batch SGD.", "b", 50);
 PARAM_INT_IN("range", "Number of iterations after which impostors needs to be "
     "recalculated", "R", 1);
+PARAM_DOUBLE_IN("epsilon", "Relative error allowed in the nearest neighbor "
+    "searches for impostors (0 means exact searches).", "e", 0.0);
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -293,6 +297,9 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       "tolerance must be non-negative");
   RequireParamValue<int>(params, "rank", [](int x)
       { return x >= 0; }, true, "rank must be nonnegative");
+  RequireParamValue<double>(params, "epsilon",
+      [](double x) { return x >= 0.0; }, true,
+      "epsilon must be non-negative");
 
   const size_t k = (size_t) params.Get<int>("k");
   const double regularization = params.Get<double>("regularization");
@@ -307,6 +314,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   const size_t batchSize = (size_t) params.Get<int>("batch_size");
   const size_t range = (size_t) params.Get<int>("range");
   const size_t rank = (size_t) params.Get<int>("rank");
+  const double epsilon = params.Get<double>("epsilon");
 
   // Load data.
   arma::mat data = std::move(params.Get<arma::mat>("input"));
@@ -375,6 +383,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     LMNN<LMetric<2>> lmnn(data, labels, k);
     lmnn.Regularization() = regularization;
     lmnn.Range() = range;
+    lmnn.ImpostorEpsilon() = epsilon;
     lmnn.Optimizer().StepSize() = stepSize;
     lmnn.Optimizer().MaxIterations() = passes * data.n_cols;
     lmnn.Optimizer().Tolerance() = tolerance;
@@ -388,6 +397,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     LMNN<LMetric<2>, ens::BBS_BB> lmnn(data, labels, k);
     lmnn.Regularization() = regularization;
     lmnn.Range() = range;
+    lmnn.ImpostorEpsilon() = epsilon;
     lmnn.Optimizer().StepSize() = stepSize;
     lmnn.Optimizer().MaxIterations() = passes * data.n_cols;
     lmnn.Optimizer().Tolerance() = tolerance;
@@ -403,6 +413,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     LMNN<LMetric<2>, ens::StandardSGD> lmnn(data, labels, k);
     lmnn.Regularization() = regularization;
     lmnn.Range() = range;
+    lmnn.ImpostorEpsilon() = epsilon;
     lmnn.Optimizer().StepSize() = stepSize;
     lmnn.Optimizer().MaxIterations() = passes * data.n_cols;
     lmnn.Optimizer().Tolerance() = tolerance;
@@ -416,6 +427,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     LMNN<LMetric<2>, ens::L_BFGS> lmnn(data, labels, k);
     lmnn.Regularization() = regularization;
     lmnn.Range() = range;
+    lmnn.ImpostorEpsilon() = epsilon;
     lmnn.Optimizer().MaxIterations() = maxIterations;
     lmnn.Optimizer().MinGradientNorm() = tolerance;
 
@@ -34,22 +34,20 @@ void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
       data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
       * data);
 
-  arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
+  // The Gram matrix of the dictionary is computed once and shared; each point
+  // only rescales it by its weights.
+  const arma::mat dictGram = trans(dictionary) * dictionary;
 
+  Log::Debug << "Coding " << data.n_cols << " points." << std::endl;
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
     arma::vec invW = invSqDists.unsafe_col(i);
     arma::mat dictPrime = dictionary * diagmat(invW);
 
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+    // This is diagmat(invW) * dictGram * diagmat(invW).
+    arma::mat dictGramTD = dictGram % (invW * trans(invW));
 
     bool useCholesky = false;
     regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
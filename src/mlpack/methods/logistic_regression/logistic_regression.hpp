@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/data_source.hpp>
 #include <ensmallen.hpp>
 
 #include "logistic_regression_function.hpp"
@@ -159,6 +160,31 @@ class LogisticRegression
                OptimizerType& optimizer,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the LogisticRegression model on data read from disk, one batch of
+   * points at a time, so that the dataset does not need to fit in memory.  Both
+   * data sources are reset, and then the optimizer is run on each batch in
+   * turn, starting from the parameters found on the previous batch; so, one
+   * call makes one pass over the data.  The optimizer should usually be set to
+   * make one pass over a batch, and to keep its state between calls to
+   * Optimize().
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Source of the input training variables.
+   * @param responses Source of the labels (one per line, or one row); it must
+   *     hold the same number of points as predictors.
+   * @param optimizer Instantiated optimizer with instantiated error function.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the last batch (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(data::DataSource<MatType>& predictors,
+               data::DataSource<arma::Mat<size_t>>& responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
   //! Return the parameters (the b vector).
   const arma::rowvec& Parameters() const { return parameters; }
   //! Modify the parameters (the b vector).
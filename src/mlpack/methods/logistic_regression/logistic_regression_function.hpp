@@ -118,6 +118,28 @@ class LogisticRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * for the given batch as a sparse matrix, which only holds the coordinates
+   * of the intercept and of the features that are nonzero in the batch.  The
+   * regularization is only applied to those coordinates (once for each point
+   * of the batch that has the feature).  This is used by optimizers such as
+   * ParallelSGD (Hogwild!), which apply sparse updates from many threads
+   * without locking; with sparse data, the updates rarely touch the same
+   * coordinates.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one feature in the
@@ -159,6 +181,53 @@ class LogisticRegressionFunction
   size_t NumFeatures() const { return predictors.n_rows + 1; }
 
  private:
+  /**
+   * Compute the log-likelihood of the points of the given batch, and, if diffs
+   * is not NULL, the difference between the sigmoid of each point and its
+   * response, in one pass.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param diffs Vector to store the differences in (or NULL).
+   */
+  double LogLikelihood(const arma::mat& parameters,
+                       const size_t begin,
+                       const size_t batchSize,
+                       arma::rowvec* diffs = NULL) const;
+
+  //! Compute w'x + b for each point of the given batch of dense data.
+  template<typename eT>
+  static void Scores(const arma::Mat<eT>& data,
+                     const arma::mat& parameters,
+                     const size_t begin,
+                     const size_t batchSize,
+                     arma::rowvec& scores);
+
+  //! Compute w'x + b for each point of the given batch of sparse data, in
+  //! parallel over the points, directly from the compressed columns.
+  template<typename eT>
+  static void Scores(const arma::SpMat<eT>& data,
+                     const arma::mat& parameters,
+                     const size_t begin,
+                     const size_t batchSize,
+                     arma::rowvec& scores);
+
+  //! Compute diffs * X^T for the given batch X of dense data.
+  template<typename eT>
+  static void FeatureGradient(const arma::Mat<eT>& data,
+                              const arma::rowvec& diffs,
+                              const size_t begin,
+                              arma::rowvec& gradient);
+
+  //! Compute diffs * X^T for the given batch X of sparse data, in parallel
+  //! over the points, without forming X^T.
+  template<typename eT>
+  static void FeatureGradient(const arma::SpMat<eT>& data,
+                              const arma::rowvec& diffs,
+                              const size_t begin,
+                              arma::rowvec& gradient);
+
   //! The matrix of data points (predictors).  This is an alias until shuffling
   //! is done.
   MatType predictors;
@@ -82,20 +82,11 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
       parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
   // Assemble full objective function.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
   // doesn't actually affect the optimization result, so we'll just ignore those
-  // terms for computational efficiency.  Note that the conversion causes some
-  // copy and slowdown, but this is so negligible compared to the rest of the
-  // calculation it is not worth optimizing for.
-  const double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoid %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
+  // terms for computational efficiency.
+  const double result = LogLikelihood(parameters, 0, predictors.n_cols);
 
   // Invert the result, because it's a minimization.
   return regularization - result;
@@ -117,16 +108,8 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
-
   // Compute the objective for the given batch size from a given point.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoid %
-      (2 * respD - 1.0)));
+  const double result = LogLikelihood(parameters, begin, batchSize);
 
   // Invert the result, because it's a minimization.
   return regularization - result;
@@ -138,17 +121,7 @@ void LogisticRegressionFunction<MatType>::Gradient(
     const arma::mat& parameters,
     arma::mat& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1);
-
-  const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
-      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  EvaluateWithGradient(parameters, gradient);
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -161,23 +134,47 @@ void LogisticRegressionFunction<MatType>::Gradient(
                 GradType& gradient,
                 const size_t batchSize) const
 {
-  // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1)
-      / predictors.n_cols * batchSize;
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
 
-  const arma::rowvec exponents = parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1);
-  // Calculating the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
+//! Evaluate the sparse gradient of the logistic regression objective function
+//! for a given batch size.
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize) const
+{
+  const arma::sp_mat batch(predictors.cols(begin, begin + batchSize - 1));
+
+  arma::rowvec diffs;
+  LogLikelihood(parameters, begin, batchSize, &diffs);
+
+  // Per-point regularization, so that a feature that is nonzero in every
+  // point of the batch gets the same regularization as the dense gradient.
+  const double regularization = lambda / predictors.n_cols;
+
+  // Duplicate locations (a feature that is nonzero in several points) are
+  // summed when the sparse matrix is built.
+  arma::umat locations(2, batch.n_nonzero + 1);
+  arma::vec values(batch.n_nonzero + 1);
+  locations(0, 0) = 0;
+  locations(1, 0) = 0;
+  values[0] = arma::accu(diffs);
+
+  size_t i = 1;
+  for (arma::sp_mat::const_iterator it = batch.begin(); it != batch.end();
+       ++it, ++i)
+  {
+    locations(0, i) = 0;
+    locations(1, i) = it.row() + 1;
+    values[i] = diffs[it.col()] * (*it) +
+        regularization * parameters(0, it.row() + 1);
+  }
 
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient = arma::sp_mat(true, locations, values, parameters.n_rows,
+      parameters.n_cols);
 }
 
 /**
@@ -212,30 +209,7 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     GradType& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization = lambda *
-      parameters.tail_cols(parameters.n_elem - 1);
-
-  const double objectiveRegularization = lambda / 2.0 *
-      arma::dot(parameters.tail_cols(parameters.n_elem - 1),
-                parameters.tail_cols(parameters.n_elem - 1));
-
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoids %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
-
-  // Invert the result, because it's a minimization.
-  return objectiveRegularization - result;
+  return EvaluateWithGradient(parameters, 0, gradient, predictors.n_cols);
 }
 
 template<typename MatType>
@@ -256,28 +230,148 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
+  // Compute the objective function and the differences between the sigmoids
+  // and the responses in one pass.
+  arma::rowvec diffs;
+  const double result = LogLikelihood(parameters, begin, batchSize, &diffs);
+
+  arma::rowvec featureGradient;
+  FeatureGradient(predictors, diffs, begin, featureGradient);
 
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
-      (2 * respD - 1.0)));
+  gradient[0] = arma::accu(diffs);
+  gradient.tail_cols(parameters.n_elem - 1) = featureGradient + regularization;
 
   // Invert the result, because it's a minimization.
   return objectiveRegularization - result;
 }
 
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::LogLikelihood(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::rowvec* diffs) const
+{
+  arma::rowvec scores;
+  Scores(predictors, parameters, begin, batchSize, scores);
+
+  if (diffs)
+    diffs->set_size(batchSize);
+
+  // The log-likelihood of a point is log(sig(w'x)) if its response is 1, and
+  // log(1 - sig(w'x)) if its response is 0.
+  double result = 0.0;
+  #pragma omp parallel for reduction(+:result) schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
+  {
+    const double sigmoid = 1.0 / (1.0 + std::exp(-scores[i]));
+    const size_t response = responses[begin + i];
+    result += std::log((response == 1) ? sigmoid : 1.0 - sigmoid);
+    if (diffs)
+      (*diffs)[i] = sigmoid - response;
+  }
+
+  return result;
+}
+
+template<typename MatType>
+template<typename eT>
+void LogisticRegressionFunction<MatType>::Scores(
+    const arma::Mat<eT>& data,
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::rowvec& scores)
+{
+  // The intercept term is parameters(0, 0) and does not need to be multiplied
+  // by any of the predictors.
+  if (begin == 0 && batchSize == data.n_cols)
+  {
+    scores = parameters(0, 0) + parameters.tail_cols(parameters.n_elem - 1) *
+        data;
+  }
+  else
+  {
+    scores = parameters(0, 0) + parameters.tail_cols(parameters.n_elem - 1) *
+        data.cols(begin, begin + batchSize - 1);
+  }
+}
+
+template<typename MatType>
+template<typename eT>
+void LogisticRegressionFunction<MatType>::Scores(
+    const arma::SpMat<eT>& data,
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::rowvec& scores)
+{
+  // The compressed form must be up to date before the threads read it.
+  data.sync();
+  scores.set_size(batchSize);
+
+  // Each score only reads the nonzero elements of its own point, so the
+  // points are independent.
+  const double* weights = parameters.memptr() + 1;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) batchSize; ++j)
+  {
+    double score = parameters[0];
+    for (size_t p = data.col_ptrs[begin + j]; p < data.col_ptrs[begin + j + 1];
+         ++p)
+    {
+      score += weights[data.row_indices[p]] * data.values[p];
+    }
+    scores[j] = score;
+  }
+}
+
+template<typename MatType>
+template<typename eT>
+void LogisticRegressionFunction<MatType>::FeatureGradient(
+    const arma::Mat<eT>& data,
+    const arma::rowvec& diffs,
+    const size_t begin,
+    arma::rowvec& gradient)
+{
+  if (begin == 0 && diffs.n_elem == data.n_cols)
+    gradient = diffs * data.t();
+  else
+    gradient = diffs * data.cols(begin, begin + diffs.n_elem - 1).t();
+}
+
+template<typename MatType>
+template<typename eT>
+void LogisticRegressionFunction<MatType>::FeatureGradient(
+    const arma::SpMat<eT>& data,
+    const arma::rowvec& diffs,
+    const size_t begin,
+    arma::rowvec& gradient)
+{
+  data.sync();
+  gradient.zeros(data.n_rows);
+
+  // The points are split across threads, and the points of different threads
+  // may share features, so the additions are atomic.  With sparse data they
+  // rarely touch the same element at the same time.  This avoids both the
+  // transpose of the data and one dense gradient per thread.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) diffs.n_elem; ++j)
+  {
+    const double diff = diffs[j];
+    if (diff == 0)
+      continue;
+
+    for (size_t p = data.col_ptrs[begin + j]; p < data.col_ptrs[begin + j + 1];
+         ++p)
+    {
+      #pragma omp atomic
+      gradient[data.row_indices[p]] += diff * data.values[p];
+    }
+  }
+}
+
 } // namespace regression
 } // namespace mlpack
 
@@ -99,6 +99,43 @@ double LogisticRegression<MatType>::Train(
   return out;
 }
 
+template<typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+double LogisticRegression<MatType>::Train(
+    data::DataSource<MatType>& predictors,
+    data::DataSource<arma::Mat<size_t>>& responses,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  predictors.Reset();
+  responses.Reset();
+
+  double out = 0.0;
+  MatType predictorsBatch;
+  arma::Mat<size_t> responsesBatch;
+  while (predictors.Next(predictorsBatch))
+  {
+    if (!responses.Next(responsesBatch) ||
+        responsesBatch.n_elem != predictorsBatch.n_cols)
+    {
+      throw std::invalid_argument("LogisticRegression::Train(): the "
+          "predictors and the responses have different numbers of points");
+    }
+
+    const arma::Row<size_t> labels(responsesBatch.memptr(),
+        responsesBatch.n_elem, false, true);
+    out = Train(predictorsBatch, labels, optimizer, callbacks...);
+  }
+
+  if (responses.Next(responsesBatch))
+  {
+    throw std::invalid_argument("LogisticRegression::Train(): the "
+        "predictors and the responses have different numbers of points");
+  }
+
+  return out;
+}
+
 template<typename MatType>
 template<typename VecType>
 size_t LogisticRegression<MatType>::Classify(const VecType& point,
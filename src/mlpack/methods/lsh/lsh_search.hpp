@@ -290,9 +290,13 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the second hash table.  The points of all buckets are stored one
+  //! bucket after another; use BucketOffsets() to find each bucket.
+  const arma::Col<size_t>& SecondHashTable() const { return secondHashTable; }
+
+  //! Get the start of each bucket in the second hash table.  Bucket i holds
+  //! the elements at indices [BucketOffsets()[i], BucketOffsets()[i + 1]).
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -450,13 +454,13 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table; holds the points of (< secondHashSize) buckets each
+  //! with (<= bucketSize) elements, one bucket after another.
+  arma::Col<size_t> secondHashTable;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The start of each bucket in secondHashTable, plus the total number of
+  //! elements at the end; should be (number of buckets + 1).
+  arma::Col<size_t> bucketOffsets;
 
   //! For a particular hash value, points to the row in secondHashTable
   //! corresponding to this value. Length secondHashSize.
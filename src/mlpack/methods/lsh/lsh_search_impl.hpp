@@ -15,6 +15,10 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/random.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace neighbor {
 
@@ -84,7 +88,7 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
     secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -104,7 +108,7 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
     secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -132,7 +136,7 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
   secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -154,7 +158,7 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
   secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -254,99 +258,142 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   }
 
   // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
-
-  for (size_t i = 0; i < numTables; ++i)
+  // vector for table i will be held in column i, so that the elements of the
+  // matrix are in the order in which the points are put into the buckets.
+  const size_t numPoints = this->referenceSet.n_cols;
+  arma::Mat<size_t> secondHashVectors(numPoints, numTables);
+
+  // The points are hashed in blocks, so that the projections of only one block
+  // of points have to be held in memory by each thread.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Step IV: create the 'numProj'-dimensional key for each point in each
-    // table.
-
-    // The following code performs the task of hashing each point to a
-    // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
-    //
-    // For a single table, let the 'numProj' projections be denoted by 'proj_i'
-    // and the corresponding offset be 'offset_i'.  Then the key of a single
-    // point is obtained as:
-    // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
-    hashMat += offsetMat;
-    hashMat /= hashWidth;
-
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
-    // Now we hash every key, point ID to its corresponding bucket.  We must
-    // also normalize the hashes to the range [0, secondHashSize).
-    arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
-    for (size_t j = 0; j < unmodVector.n_elem; ++j)
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, numPoints);
+
+    for (size_t i = 0; i < numTables; ++i)
     {
-      double shs = (double) secondHashSize; // Convenience cast.
-      if (unmodVector[j] >= 0.0)
+      // Step IV: create the 'numProj'-dimensional key for each point in each
+      // table.
+
+      // The following code performs the task of hashing each point to a
+      // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
+      // 'end - begin') key matrix.
+      //
+      // For a single table, let the 'numProj' projections be denoted by
+      // 'proj_i' and the corresponding offset be 'offset_i'.  Then the key of
+      // a single point is obtained as:
+      // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
+      arma::mat hashMat = projections.slice(i).t() *
+          this->referenceSet.cols(begin, end - 1);
+      hashMat.each_col() += offsets.unsafe_col(i);
+      hashMat /= hashWidth;
+
+      // Step V: Hash every key to its corresponding bucket.  We must also
+      // normalize the hashes to the range [0, secondHashSize).
+      arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
+      for (size_t j = 0; j < unmodVector.n_elem; ++j)
       {
-        const size_t key = size_t(fmod(unmodVector[j], shs));
-        secondHashVectors(i, j) = key;
-      }
-      else
-      {
-        const double mod = fmod(-unmodVector[j], shs);
-        const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
-        secondHashVectors(i, j) = key;
+        double shs = (double) secondHashSize; // Convenience cast.
+        if (unmodVector[j] >= 0.0)
+        {
+          const size_t key = size_t(fmod(unmodVector[j], shs));
+          secondHashVectors(begin + j, i) = key;
+        }
+        else
+        {
+          const double mod = fmod(-unmodVector[j], shs);
+          const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
+          secondHashVectors(begin + j, i) = key;
+        }
       }
     }
   }
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+  // Step VI: Put the points in the 'secondHashTable' with a counting sort.
+  // The elements of secondHashVectors are split into one contiguous range per
+  // thread.  Each thread counts the elements of its range in each bucket, and
+  // then writes them to its own part of each bucket, so the points in each
+  // bucket are in the same order as if they were inserted serially.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  const size_t numElements = secondHashVectors.n_elem;
+  const size_t threadShareSize = (numElements + numThreads - 1) / numThreads;
+  arma::Mat<size_t> threadCounts(secondHashSize, numThreads,
+      arma::fill::zeros);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+  {
+    const size_t begin = std::min(t * threadShareSize, numElements);
+    const size_t end = std::min(begin + threadShareSize, numElements);
+    size_t* counts = threadCounts.colptr(t);
+    for (size_t k = begin; k < end; ++k)
+      counts[secondHashVectors[k]]++;
+  }
 
-  // Enforce the maximum bucket size.
+  // Now, using the counts, find the position of each non-empty bucket in the
+  // second hash table, and the position in the bucket at which each thread
+  // starts writing.  We also enforce the maximum bucket size here.
   const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
-
+  const arma::Col<size_t> secondHashBinCounts = arma::sum(threadCounts, 1);
   const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
+  bucketOffsets.set_size(numRowsInTable + 1);
+  bucketOffsets[0] = 0;
   size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
+  size_t maxBucketLength = 0;
+  for (size_t h = 0; h < secondHashSize; ++h)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    if (secondHashBinCounts[h] == 0)
+      continue;
+
+    const size_t length = std::min(secondHashBinCounts[h],
+        effectiveBucketSize);
+    bucketRowInHashTable[h] = currentRow;
+    bucketOffsets[currentRow + 1] = bucketOffsets[currentRow] + length;
+    maxBucketLength = std::max(maxBucketLength, length);
+    ++currentRow;
+
+    size_t start = 0;
+    for (size_t t = 0; t < numThreads; ++t)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
-      {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
-      }
+      const size_t count = threadCounts(h, t);
+      threadCounts(h, t) = start;
+      start += count;
+    }
+  }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+  secondHashTable.set_size(bucketOffsets[numRowsInTable]);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+  {
+    const size_t begin = std::min(t * threadShareSize, numElements);
+    const size_t end = std::min(begin + threadShareSize, numElements);
+    size_t* positions = threadCounts.colptr(t);
+    for (size_t k = begin; k < end; ++k)
+    {
+      // This is the bucket number.  The point ID is 'k % numPoints'.
+      const size_t hashInd = secondHashVectors[k];
+      const size_t row = bucketRowInHashTable[hashInd];
+      const size_t index = bucketOffsets[row] + positions[hashInd]++;
+
+      // If the bucket is not full, add the point.
+      if (index < bucketOffsets[row + 1])
+        secondHashTable[index] = k % numPoints;
+    }
+  }
 
   Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+            << "maximum length of " << maxBucketLength << ", totaling "
+            << secondHashTable.n_elem << " elements." << std::endl;
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -776,8 +823,8 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      if (tableRow < secondHashSize) // count bucket contents
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
@@ -808,11 +855,12 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
         size_t hashInd = hashMat(p, i);
         size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+        if (tableRow < secondHashSize)
         {
           // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          for (size_t j = bucketOffsets[tableRow];
+               j < bucketOffsets[tableRow + 1]; ++j)
+            refPointsConsidered[secondHashTable[j]]++;
         }
       }
     }
@@ -842,8 +890,9 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
         if (tableRow < secondHashSize)
         {
           // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
+          for (size_t j = bucketOffsets[tableRow];
+               j < bucketOffsets[tableRow + 1]; ++j)
+            refPointsConsideredSmall(start++) = secondHashTable[j];
        }
       }
     }
@@ -1026,7 +1075,7 @@ double LSHSearch<SortPolicy, MatType>::ComputeRecall(
 template<typename SortPolicy, typename MatType>
 template<typename Archive>
 void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
-                                               const uint32_t /* version */)
+                                               const uint32_t version)
 {
   ar(CEREAL_NVP(referenceSet));
   ar(CEREAL_NVP(numProj));
@@ -1042,8 +1091,31 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar(CEREAL_NVP(secondHashSize));
   ar(CEREAL_NVP(secondHashWeights));
   ar(CEREAL_NVP(bucketSize));
-  ar(CEREAL_NVP(secondHashTable));
-  ar(CEREAL_NVP(bucketContentSize));
+  // Before version 1, each bucket was stored as a separate vector.
+  if (version == 0)
+  {
+    std::vector<arma::Col<size_t>> oldSecondHashTable;
+    arma::Col<size_t> bucketContentSize;
+    ar(cereal::make_nvp("secondHashTable", oldSecondHashTable));
+    ar(CEREAL_NVP(bucketContentSize));
+
+    bucketOffsets.set_size(oldSecondHashTable.size() + 1);
+    bucketOffsets[0] = 0;
+    for (size_t i = 0; i < oldSecondHashTable.size(); ++i)
+      bucketOffsets[i + 1] = bucketOffsets[i] + bucketContentSize[i];
+
+    secondHashTable.set_size(bucketOffsets[oldSecondHashTable.size()]);
+    for (size_t i = 0; i < oldSecondHashTable.size(); ++i)
+    {
+      for (size_t j = 0; j < bucketContentSize[i]; ++j)
+        secondHashTable[bucketOffsets[i] + j] = oldSecondHashTable[i][j];
+    }
+  }
+  else
+  {
+    ar(CEREAL_NVP(secondHashTable));
+    ar(CEREAL_NVP(bucketOffsets));
+  }
   ar(CEREAL_NVP(bucketRowInHashTable));
   ar(CEREAL_NVP(distanceEvaluations));
 }
@@ -1051,4 +1123,9 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
 } // namespace neighbor
 } // namespace mlpack
 
+// Since version 1, the second hash table is stored as one flat vector.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename SortPolicy,
+    typename MatType>), (mlpack::neighbor::LSHSearch<SortPolicy, MatType>),
+    (1));
+
 #endif
@@ -21,10 +21,10 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::vec& values,
                                    const size_t r) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
+    initialPoint(arma::randu<arma::mat>(m + n, r)),
+    sdp(BuildSDP())
 {
-  CheckValues();
-  InitSDP();
+  // Nothing to do.
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
@@ -33,10 +33,10 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::vec& values,
                                    const arma::mat& initialPoint) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, initialPoint)
+    initialPoint(initialPoint),
+    sdp(BuildSDP())
 {
-  CheckValues();
-  InitSDP();
+  // Nothing to do.
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
@@ -44,11 +44,11 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::umat& indices,
                                    const arma::vec& values) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0,
-        arma::randu<arma::mat>(m + n, DefaultRank(m, n, indices.n_cols)))
+    initialPoint(arma::randu<arma::mat>(m + n,
+        DefaultRank(m, n, indices.n_cols))),
+    sdp(BuildSDP())
 {
-  CheckValues();
-  InitSDP();
+  // Nothing to do.
 }
 
 void MatrixCompletion::CheckValues()
@@ -77,25 +77,43 @@ void MatrixCompletion::CheckValues()
   }
 }
 
-void MatrixCompletion::InitSDP()
+PackedLRSDP MatrixCompletion::BuildSDP()
 {
-  sdp.SDP().C().eye(m + n, m + n);
-  sdp.SDP().SparseB() = 2. * values;
+  CheckValues();
+
+  // The objective is tr(X), and constraint i is tr(A_i X) = 2 M_ij, where A_i
+  // has ones at (i, m + j) and (m + j, i); that is, 2 X(i, m + j) = 2 M_ij.
   const size_t p = indices.n_cols;
+  arma::umat locations(2, m + n + p);
+  arma::vec entryValues(m + n + p);
+  arma::Col<size_t> terms(m + n + p);
+  for (size_t i = 0; i < m + n; ++i)
+  {
+    locations(0, i) = i;
+    locations(1, i) = i;
+    entryValues[i] = 1.0;
+    terms[i] = p;
+  }
+
   for (size_t i = 0; i < p; ++i)
   {
-    sdp.SDP().SparseA()[i].zeros(m + n, m + n);
-    sdp.SDP().SparseA()[i](indices(0, i), m + indices(1, i)) = 1.;
-    sdp.SDP().SparseA()[i](m + indices(1, i), indices(0, i)) = 1.;
+    locations(0, m + n + i) = indices(0, i);
+    locations(1, m + n + i) = m + indices(1, i);
+    entryValues[m + n + i] = 2.0;
+    terms[m + n + i] = i;
   }
+
+  return PackedLRSDP(m + n, locations, entryValues, terms,
+      arma::vec(2. * arma::vectorise(values)));
 }
 
 void MatrixCompletion::Recover(arma::mat& recovered)
 {
-  recovered = sdp.Function().GetInitialPoint();
-  sdp.Optimize(recovered);
-  recovered = recovered * trans(recovered);
-  recovered = recovered(arma::span(0, m - 1), arma::span(m, m + n - 1));
+  arma::mat coordinates = initialPoint.t();
+  sdp.Optimize(coordinates);
+
+  // Only the off-diagonal block of R^T R is needed.
+  recovered = coordinates.cols(0, m - 1).t() * coordinates.cols(m, m + n - 1);
 }
 
 size_t MatrixCompletion::DefaultRank(const size_t m,
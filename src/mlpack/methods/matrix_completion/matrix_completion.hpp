@@ -13,9 +13,10 @@
 #ifndef MLPACK_METHODS_MATRIX_COMPLETION_MATRIX_COMPLETION_HPP
 #define MLPACK_METHODS_MATRIX_COMPLETION_MATRIX_COMPLETION_HPP
 
-#include <ensmallen.hpp>
 #include <mlpack/prereqs.hpp>
 
+#include "packed_lrsdp.hpp"
+
 namespace mlpack {
 namespace matrix_completion {
 
@@ -29,6 +30,10 @@ namespace matrix_completion {
  *
  * where ||X||_* denotes the nuclear norm (sum of singular values of X).
  *
+ * The SDP has one constraint per known entry.  Each constraint is held as a
+ * single packed entry of a PackedLRSDP, so that problems with millions of known
+ * entries fit in memory, and the constraints are evaluated in parallel.
+ *
  * For a theoretical treatment of the conditions necessary for exact recovery,
  * see the following paper:
  *
@@ -48,7 +53,7 @@ namespace matrix_completion {
  * mc.Recover(recovered);
  * @endcode
  *
- * @see LRSDP
+ * @see PackedLRSDP
  */
 class MatrixCompletion
 {
@@ -112,12 +117,14 @@ class MatrixCompletion
   void Recover(arma::mat& recovered);
 
   //! Return the underlying SDP.
-  const ens::LRSDP<ens::SDP<arma::sp_mat>>& Sdp() const
-  {
-    return sdp;
-  }
+  const PackedLRSDP& Sdp() const { return sdp; }
   //! Modify the underlying SDP.
-  ens::LRSDP<ens::SDP<arma::sp_mat>>& Sdp() { return sdp; }
+  PackedLRSDP& Sdp() { return sdp; }
+
+  //! Get the starting point of the optimization (one row per point).
+  const arma::mat& InitialPoint() const { return initialPoint; }
+  //! Modify the starting point of the optimization (one row per point).
+  arma::mat& InitialPoint() { return initialPoint; }
 
  private:
   //! Number of rows in original matrix.
@@ -129,13 +136,15 @@ class MatrixCompletion
   //! Vector containing the values of the known entries.
   arma::mat values;
 
+  //! The starting point of the optimization.
+  arma::mat initialPoint;
   //! The underlying SDP to be solved.
-  ens::LRSDP<ens::SDP<arma::sp_mat>> sdp;
+  PackedLRSDP sdp;
 
   //! Validate the input matrices.
   void CheckValues();
-  //! Initialize the SDP.
-  void InitSDP();
+  //! Validate the input matrices and build the SDP.
+  PackedLRSDP BuildSDP();
 
   //! Select a rank of the matrix given that is of size m x n and has p known
   //! elements.
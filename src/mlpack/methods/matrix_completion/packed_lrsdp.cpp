@@ -0,0 +1,213 @@
+/**
+ * @file methods/matrix_completion/packed_lrsdp.cpp
+ *
+ * Implementation of the PackedLRSDP class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "packed_lrsdp.hpp"
+
+namespace mlpack {
+namespace matrix_completion {
+
+PackedLRSDP::PackedLRSDP(const size_t numPoints,
+                         const arma::umat& locations,
+                         const arma::vec& values,
+                         const arma::Col<size_t>& terms,
+                         const arma::vec& b,
+                         const size_t maxIterations) :
+    numPoints(numPoints),
+    locations(locations),
+    values(values),
+    terms(terms),
+    b(b),
+    lambda(b.n_elem, arma::fill::zeros),
+    sigma(10.0),
+    maxIterations(maxIterations)
+{
+  if (locations.n_rows != 2)
+  {
+    Log::Fatal << "PackedLRSDP::PackedLRSDP(): matrix of entry locations does "
+        << "not have 2 rows!" << std::endl;
+  }
+
+  if (values.n_elem != locations.n_cols || terms.n_elem != locations.n_cols)
+  {
+    Log::Fatal << "PackedLRSDP::PackedLRSDP(): " << locations.n_cols
+        << " entry locations were given, but " << values.n_elem
+        << " values and " << terms.n_elem << " terms!" << std::endl;
+  }
+
+  for (size_t k = 0; k < locations.n_cols; ++k)
+  {
+    if (locations(0, k) >= numPoints || locations(1, k) >= numPoints)
+    {
+      Log::Fatal << "PackedLRSDP::PackedLRSDP(): location (" << locations(0, k)
+          << ", " << locations(1, k) << ") is out of bounds for "
+          << numPoints << " points!" << std::endl;
+    }
+
+    if (terms(k) > b.n_elem)
+    {
+      Log::Fatal << "PackedLRSDP::PackedLRSDP(): term " << terms(k)
+          << " is out of bounds for " << b.n_elem << " constraints!"
+          << std::endl;
+    }
+  }
+
+  // Group the entries by point: each entry (a, c) is listed once for a (with
+  // c as the other point) and once for c (with a as the other point), so that
+  // the gradient of each point is a sum over its own list.
+  adjacentOffsets.zeros(numPoints + 1);
+  for (size_t k = 0; k < locations.n_cols; ++k)
+  {
+    ++adjacentOffsets[locations(0, k) + 1];
+    ++adjacentOffsets[locations(1, k) + 1];
+  }
+  for (size_t i = 0; i < numPoints; ++i)
+    adjacentOffsets[i + 1] += adjacentOffsets[i];
+
+  adjacentEntries.set_size(2 * locations.n_cols);
+  adjacentPoints.set_size(2 * locations.n_cols);
+  arma::Col<size_t> next = adjacentOffsets.head(numPoints);
+  for (size_t k = 0; k < locations.n_cols; ++k)
+  {
+    const size_t first = locations(0, k);
+    const size_t second = locations(1, k);
+    adjacentEntries[next[first]] = k;
+    adjacentPoints[next[first]++] = second;
+    adjacentEntries[next[second]] = k;
+    adjacentPoints[next[second]++] = first;
+  }
+}
+
+bool PackedLRSDP::Optimize(arma::mat& coordinates)
+{
+  if (coordinates.n_cols != numPoints)
+  {
+    Log::Fatal << "PackedLRSDP::Optimize(): coordinates have "
+        << coordinates.n_cols << " columns, but the program has " << numPoints
+        << " points!" << std::endl;
+  }
+
+  if (lambda.n_elem != b.n_elem)
+    lambda.zeros(b.n_elem);
+
+  // This is the same update of the multipliers and the penalty parameter as
+  // ens::AugLagrangian.
+  double penaltyThreshold = DBL_MAX;
+  double lastObjective = DBL_MAX;
+  arma::vec violations;
+  for (size_t it = 0; it != maxIterations; ++it)
+  {
+    lbfgs.Optimize(*this, coordinates);
+
+    const double objective = EvaluateObjective(coordinates, violations);
+    Log::Info << "PackedLRSDP::Optimize(): iteration " << it << ", objective "
+        << objective << "." << std::endl;
+
+    // The threshold we are comparing with is arbitrary.
+    if (std::abs(lastObjective - objective) < 1e-10 && sigma > 500000)
+      return true;
+    lastObjective = objective;
+
+    // Update the multipliers if the penalty decreased enough, and the penalty
+    // parameter otherwise.  The factor of 0.25 is taken from Burer and
+    // Monteiro (2002).
+    const double penalty = arma::dot(violations, violations);
+    if (penalty < penaltyThreshold)
+    {
+      lambda -= sigma * violations;
+      penaltyThreshold = 0.25 * penalty;
+    }
+    else
+    {
+      sigma *= 10;
+    }
+  }
+
+  return false;
+}
+
+double PackedLRSDP::Evaluate(const arma::mat& coordinates) const
+{
+  arma::vec violations;
+  const double objective = EvaluateObjective(coordinates, violations);
+  return objective - arma::dot(lambda, violations) +
+      0.5 * sigma * arma::dot(violations, violations);
+}
+
+void PackedLRSDP::Gradient(const arma::mat& coordinates,
+                           arma::mat& gradient) const
+{
+  EvaluateWithGradient(coordinates, gradient);
+}
+
+double PackedLRSDP::EvaluateWithGradient(const arma::mat& coordinates,
+                                         arma::mat& gradient) const
+{
+  arma::vec termValues, products;
+  EvaluateTerms(coordinates, termValues, products);
+
+  const arma::vec violations = termValues.head(b.n_elem) - b;
+  const double objective = termValues[b.n_elem];
+
+  // The gradient of the term of each entry is weighted by the derivative of
+  // the augmented Lagrangian with respect to that term.
+  arma::vec termWeights(b.n_elem + 1);
+  termWeights.head(b.n_elem) = sigma * violations - lambda;
+  termWeights[b.n_elem] = 1.0;
+
+  // The gradient of dot(R.col(a), R.col(c)) is R.col(c) in column a and
+  // R.col(a) in column c.  Each column only sums over its own entries, so the
+  // columns are independent.
+  gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+  {
+    for (size_t j = adjacentOffsets[i]; j < adjacentOffsets[i + 1]; ++j)
+    {
+      const size_t k = adjacentEntries[j];
+      gradient.col(i) += (values[k] * termWeights[terms[k]]) *
+          coordinates.col(adjacentPoints[j]);
+    }
+  }
+
+  return objective - arma::dot(lambda, violations) +
+      0.5 * sigma * arma::dot(violations, violations);
+}
+
+double PackedLRSDP::EvaluateObjective(const arma::mat& coordinates,
+                                      arma::vec& violations) const
+{
+  arma::vec termValues, products;
+  EvaluateTerms(coordinates, termValues, products);
+
+  violations = termValues.head(b.n_elem) - b;
+  return termValues[b.n_elem];
+}
+
+void PackedLRSDP::EvaluateTerms(const arma::mat& coordinates,
+                                arma::vec& termValues,
+                                arma::vec& products) const
+{
+  products.set_size(locations.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t k = 0; k < (omp_size_t) locations.n_cols; ++k)
+  {
+    products[k] = arma::dot(coordinates.col(locations(0, k)),
+        coordinates.col(locations(1, k)));
+  }
+
+  // Many entries may belong to the same term, so the sums are taken serially;
+  // they are cheap next to the inner products.
+  termValues.zeros(b.n_elem + 1);
+  for (size_t k = 0; k < locations.n_cols; ++k)
+    termValues[terms[k]] += values[k] * products[k];
+}
+
+} // namespace matrix_completion
+} // namespace mlpack
@@ -0,0 +1,187 @@
+/**
+ * @file methods/matrix_completion/packed_lrsdp.hpp
+ *
+ * Definition of the PackedLRSDP class, which solves low-rank semidefinite
+ * programs whose objective and constraint matrices are given as packed lists
+ * of entries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_PACKED_LRSDP_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_PACKED_LRSDP_HPP
+
+#include <ensmallen.hpp>
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace matrix_completion {
+
+/**
+ * The PackedLRSDP class solves the semidefinite program
+ *
+ *   min tr(C X) subj to tr(A_i X) = b_i, X = R^T R
+ *
+ * in the low-rank factorization of Burer and Monteiro, with the augmented
+ * Lagrangian method (as ens::LRSDP does).  Instead of one matrix per
+ * constraint, the entries of C and of all the A_i are held in a single packed
+ * list: entry k has a location (a_k, c_k), a value v_k, and the term t_k it
+ * belongs to (a constraint index, or NumConstraints() for the objective), and
+ * contributes v_k (R^T R)_{a_k c_k} = v_k dot(R.col(a_k), R.col(c_k)) to that
+ * term.  So the memory and time of an evaluation are linear in the number of
+ * entries (times the rank), and the terms and the gradient are computed in
+ * parallel with OpenMP, instead of forming the dense matrix R^T R.
+ *
+ * The coordinates R have one column per point (they are the transpose of the
+ * coordinates of ens::LRSDP), so that each entry reads two contiguous columns.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @article{burer2003nonlinear,
+ *   title={A nonlinear programming algorithm for solving semidefinite programs
+ *       via low-rank factorization},
+ *   author={Burer, S. and Monteiro, R.D.C.},
+ *   journal={Mathematical Programming},
+ *   volume={95},
+ *   number={2},
+ *   pages={329--357},
+ *   year={2003}
+ * }
+ * @endcode
+ */
+class PackedLRSDP
+{
+ public:
+  /**
+   * Create the semidefinite program with the given packed entries.
+   *
+   * @param numPoints Number of rows (and columns) of X.
+   * @param locations Location of each entry (must be [2 x k]).
+   * @param values Value of each entry (must be length k).
+   * @param terms Term of each entry: a constraint index, or b.n_elem for the
+   *     objective (must be length k).
+   * @param b Right-hand side of each constraint.
+   * @param maxIterations Maximum number of augmented Lagrangian iterations.
+   */
+  PackedLRSDP(const size_t numPoints,
+              const arma::umat& locations,
+              const arma::vec& values,
+              const arma::Col<size_t>& terms,
+              const arma::vec& b,
+              const size_t maxIterations = 1000);
+
+  /**
+   * Optimize the semidefinite program, starting from the given coordinates
+   * (one column per point).  Returns false if the maximum number of
+   * iterations was reached before convergence.
+   *
+   * @param coordinates Starting point, and the solution on return.
+   */
+  bool Optimize(arma::mat& coordinates);
+
+  /**
+   * Evaluate the augmented Lagrangian at the given coordinates.
+   *
+   * @param coordinates Coordinates R (one column per point).
+   */
+  double Evaluate(const arma::mat& coordinates) const;
+
+  /**
+   * Evaluate the gradient of the augmented Lagrangian at the given
+   * coordinates.
+   *
+   * @param coordinates Coordinates R (one column per point).
+   * @param gradient Matrix to store the gradient in.
+   */
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const;
+
+  /**
+   * Evaluate the augmented Lagrangian and its gradient at the given
+   * coordinates.
+   *
+   * @param coordinates Coordinates R (one column per point).
+   * @param gradient Matrix to store the gradient in.
+   */
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective tr(C X) and the constraint violations
+   * tr(A_i X) - b_i at the given coordinates.
+   *
+   * @param coordinates Coordinates R (one column per point).
+   * @param violations Vector to store the constraint violations in.
+   */
+  double EvaluateObjective(const arma::mat& coordinates,
+                           arma::vec& violations) const;
+
+  //! Get the number of rows (and columns) of X.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the number of constraints.
+  size_t NumConstraints() const { return b.n_elem; }
+
+  //! Get the Lagrange multipliers.
+  const arma::vec& Lambda() const { return lambda; }
+  //! Modify the Lagrange multipliers.
+  arma::vec& Lambda() { return lambda; }
+
+  //! Get the penalty parameter.
+  double Sigma() const { return sigma; }
+  //! Modify the penalty parameter.
+  double& Sigma() { return sigma; }
+
+  //! Get the maximum number of augmented Lagrangian iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of augmented Lagrangian iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the L-BFGS optimizer used for each augmented Lagrangian iteration.
+  const ens::L_BFGS& LBFGS() const { return lbfgs; }
+  //! Modify the L-BFGS optimizer used for each augmented Lagrangian iteration.
+  ens::L_BFGS& LBFGS() { return lbfgs; }
+
+ private:
+  /**
+   * Compute the value of each term (the constraints, then the objective) at
+   * the given coordinates, and the inner products of each entry.
+   */
+  void EvaluateTerms(const arma::mat& coordinates,
+                     arma::vec& termValues,
+                     arma::vec& products) const;
+
+  //! The number of rows (and columns) of X.
+  size_t numPoints;
+  //! The location of each entry.
+  arma::umat locations;
+  //! The value of each entry.
+  arma::vec values;
+  //! The term of each entry.
+  arma::Col<size_t> terms;
+  //! The right-hand side of each constraint.
+  arma::vec b;
+
+  //! The start of the entries of each point in adjacentEntries and
+  //! adjacentPoints (the entries are grouped by point, for the gradient).
+  arma::Col<size_t> adjacentOffsets;
+  //! The entries of each point.
+  arma::Col<size_t> adjacentEntries;
+  //! The other point of each entry of each point.
+  arma::Col<size_t> adjacentPoints;
+
+  //! The Lagrange multipliers.
+  arma::vec lambda;
+  //! The penalty parameter.
+  double sigma;
+  //! The maximum number of augmented Lagrangian iterations.
+  size_t maxIterations;
+  //! The optimizer for each augmented Lagrangian iteration.
+  ens::L_BFGS lbfgs;
+};
+
+} // namespace matrix_completion
+} // namespace mlpack
+
+#endif
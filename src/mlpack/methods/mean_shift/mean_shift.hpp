@@ -26,6 +26,13 @@ namespace meanshift /** Mean shift clustering. */ {
  * apply mean shift algorithm until maximum iterations or convergence.  Then
  * remove duplicate centroids.
  *
+ * The seeds are shifted together, one iteration at a time: at each iteration,
+ * the centroids of all seeds that haven't converged yet are given to a single
+ * range search on a tree built once on the dataset, which is done in parallel
+ * with OpenMP, and the new centroids are accumulated as the neighbors are
+ * found.  A seed that comes within a tenth of the radius of a centroid that
+ * has already converged stops early, with that centroid.
+ *
  * A simple example of how to run mean shift clustering is shown below.
  *
  * @code
@@ -126,34 +133,24 @@ class MeanShift
                 MatType& seeds);
 
   /**
-   * Use kernel to calculate new centroid given dataset and valid neighbors.
+   * Get the weight of a neighbor at the given distance in the new centroid,
+   * using the kernel.  Neighbors at a distance of zero are not used.
    *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * @param distance Distance of the neighbor to the current centroid.
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>& distances,
-                    arma::colvec& centroid);
+  typename std::enable_if<ApplyKernel, double>::type
+  CentroidWeight(const double distance);
 
   /**
-   * Use mean to calculate new centroid given dataset and valid neighbors.
+   * Get the weight of a neighbor at the given distance in the new centroid,
+   * which is the mean of the neighbors.
    *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * @param distance Distance of the neighbor to the current centroid (unused).
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<!ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>&, /*unused*/
-                    arma::colvec& centroid);
+  typename std::enable_if<!ApplyKernel, double>::type
+  CentroidWeight(const double /* distance */);
 
   /**
    * If distance of two centroids is less than radius, one will be removed.
@@ -129,51 +129,27 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
   seeds *= binSize;
 }
 
-// Calculate new centroid with given kernel.
+// Get the weight of a neighbor with the given kernel.
 template<bool UseKernel, typename KernelType, typename MatType>
 template<bool ApplyKernel>
-typename std::enable_if<ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>& distances,
-                  arma::colvec& centroid)
+typename std::enable_if<ApplyKernel, double>::type
+MeanShift<UseKernel, KernelType, MatType>::CentroidWeight(const double distance)
 {
-  double sumWeight = 0;
-  for (size_t i = 0; i < neighbors.size(); ++i)
-  {
-    if (distances[i] > 0)
-    {
-      double dist = distances[i] / radius;
-      double weight = kernel.Gradient(dist) / dist;
-      sumWeight += weight;
-      centroid += weight * data.unsafe_col(neighbors[i]);
-    }
-  }
+  if (distance == 0)
+    return 0;
 
-  if (sumWeight != 0)
-  {
-    centroid /= sumWeight;
-    return true;
-  }
-  return false;
+  const double dist = distance / radius;
+  return kernel.Gradient(dist) / dist;
 }
 
-// Calculate new centroid by mean.
+// Every neighbor has the same weight in the mean.
 template<bool UseKernel, typename KernelType, typename MatType>
 template<bool ApplyKernel>
-typename std::enable_if<!ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>&, /*unused*/
-                  arma::colvec& centroid)
+typename std::enable_if<!ApplyKernel, double>::type
+MeanShift<UseKernel, KernelType, MatType>::CentroidWeight(
+    const double /* distance */)
 {
-  for (size_t i = 0; i < neighbors.size(); ++i)
-    centroid += data.unsafe_col(neighbors[i]);
-
-  centroid /= neighbors.size();
-  return true;
+  return 1;
 }
 
 /**
@@ -204,61 +180,133 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
   // Holds all centroids before removing duplicate ones.
   arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+    allCentroids.col(i) = pSeeds->unsafe_col(i);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
+  // The tree is built once and shared by all seeds; each iteration searches
+  // for the neighbors of all active seeds at once, in parallel.
+  range::RangeSearch<> rangeSearcher(data, false, true);
   math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
 
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  // The seeds that haven't converged yet, and whether each seed has converged.
+  std::vector<size_t> active(pSeeds->n_cols);
+  for (size_t i = 0; i < active.size(); ++i)
+    active[i] = i;
+  std::vector<char> converged(pSeeds->n_cols, 0);
+
+  // The seeds that converged on their own, which other seeds can stop at.
+  std::vector<size_t> modes;
+
+  for (size_t completedIterations = 0; !active.empty() &&
+      (completedIterations < maxIterations || forceConvergence);
+      completedIterations++)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
+    arma::mat queries(pSeeds->n_rows, active.size());
+    for (size_t j = 0; j < active.size(); ++j)
+      queries.col(j) = allCentroids.unsafe_col(active[j]);
+
+    // Accumulate the new centroid of each seed as its neighbors are found.
+    // The results of each query are given by a single thread.
+    arma::mat sums(pSeeds->n_rows, active.size(), arma::fill::zeros);
+    arma::vec sumWeights(active.size(), arma::fill::zeros);
+    arma::Col<size_t> counts(active.size(), arma::fill::zeros);
+    auto accumulate = [&](const size_t query, const size_t reference,
+                          const double distance)
     {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+      ++counts[query];
+      const double weight = CentroidWeight(distance);
+      if (weight != 0)
+      {
+        sumWeights[query] += weight;
+        sums.col(query) += weight * data.col(reference);
+      }
+    };
+    rangeSearcher.Search(queries, validRadius, accumulate);
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+    // 0: still active; 1: converged; 2: no points in the cluster.
+    std::vector<char> status(active.size(), 0);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) active.size(); ++j)
+    {
+      if (counts[j] == 0)
+      {
+        status[j] = 2;
+        continue;
+      }
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+      // If no neighbor has any weight, the centroid stays where it is.
+      const size_t i = active[j];
+      const arma::vec newCentroid = (sumWeights[j] != 0) ?
+          arma::vec(sums.col(j) / sumWeights[j]) :
+          arma::vec(allCentroids.col(i));
 
       // If the mean shift vector is small enough, it has converged.
       if (metric::EuclideanDistance::Evaluate(newCentroid,
           allCentroids.unsafe_col(i)) < 1e-3 * radius)
+        status[j] = 1;
+      else
+        allCentroids.col(i) = newCentroid;
+    }
+
+    for (size_t j = 0; j < active.size(); ++j)
+      if (status[j] == 1)
+        modes.push_back(active[j]);
+
+    // A seed that is very close to a centroid that has converged would
+    // converge to it too, so it stops early.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) active.size(); ++j)
+    {
+      if (status[j] != 0)
+        continue;
+
+      for (size_t k = 0; k < modes.size(); ++k)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
+        if (metric::EuclideanDistance::Evaluate(
+            allCentroids.unsafe_col(active[j]),
+            allCentroids.unsafe_col(modes[k])) < 0.1 * radius)
         {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
+          allCentroids.col(active[j]) = allCentroids.col(modes[k]);
+          status[j] = 1;
+          break;
         }
+      }
+    }
 
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
+    std::vector<size_t> stillActive;
+    for (size_t j = 0; j < active.size(); ++j)
+    {
+      if (status[j] == 0)
+        stillActive.push_back(active[j]);
+      else if (status[j] == 1)
+        converged[active[j]] = 1;
+    }
+    active.swap(stillActive);
+  }
+
+  // Remove duplicate centroids, in the order of the seeds.
+  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  {
+    if (!converged[i])
+      continue;
 
-        // Get out of the loop.
+    // Determine if the new centroid is duplicate with old ones.
+    bool isDuplicated = false;
+    for (size_t k = 0; k < centroids.n_cols; ++k)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          allCentroids.unsafe_col(i), centroids.unsafe_col(k));
+      if (distance < radius)
+      {
+        isDuplicated = true;
         break;
       }
-
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
     }
+
+    if (!isDuplicated)
+      centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
   }
 
   // If no centroid has converged due to too little iterations and without
@@ -112,7 +112,8 @@ class NaiveBayesClassifier
    * @param labels The labels for the dataset.
    * @param numClasses The numbe of classes in the dataset.
    * @param incremental Whether or not to use the incremental algorithm for
-   *      training.
+   *      training.  This merges the batch into the model, so a stream of
+   *      batches may be given to successive calls.
    */
   template<typename MatType>
   void Train(const MatType& data,
@@ -241,6 +242,47 @@ class NaiveBayesClassifier
   template<typename MatType>
   void LogLikelihood(const MatType& data,
                      ModelMatType& logLikelihoods) const;
+
+  /**
+   * Compute the number of points, the mean and the sum of squared deviations
+   * from the mean of each class for the given range of points (with the
+   * two-pass algorithm).
+   *
+   * @param data Set of points.
+   * @param labels Labels of the points.
+   * @param begin Index of the first point of the range.
+   * @param end One past the index of the last point of the range.
+   * @param counts Vector to store the number of points of each class in.
+   * @param classMeans Matrix to store the mean of each class in.
+   * @param deviations Matrix to store the sums of squared deviations in.
+   */
+  template<typename MatType>
+  void ComputeStatistics(const MatType& data,
+                         const arma::Row<size_t>& labels,
+                         const size_t begin,
+                         const size_t end,
+                         ModelMatType& counts,
+                         ModelMatType& classMeans,
+                         ModelMatType& deviations) const;
+
+  /**
+   * Merge the statistics of another set of points into the given statistics,
+   * with the pairwise update of Chan, Golub and LeVeque.
+   *
+   * @param counts Number of points of each class; updated.
+   * @param classMeans Mean of each class; updated.
+   * @param deviations Sum of squared deviations of each class; updated.
+   * @param otherCounts Number of points of each class in the other set.
+   * @param otherMeans Mean of each class in the other set.
+   * @param otherDeviations Sum of squared deviations of each class in the
+   *     other set.
+   */
+  static void MergeStatistics(ModelMatType& counts,
+                              ModelMatType& classMeans,
+                              ModelMatType& deviations,
+                              const ModelMatType& otherCounts,
+                              const ModelMatType& otherMeans,
+                              const ModelMatType& otherDeviations);
 };
 
 } // namespace naive_bayes
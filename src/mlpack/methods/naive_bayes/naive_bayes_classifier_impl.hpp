@@ -18,6 +18,7 @@
 #define MLPACK_METHODS_NAIVE_BAYES_NAIVE_BAYES_CLASSIFIER_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/log_add.hpp>
 
 // In case it hasn't been included already.
 #include "naive_bayes_classifier.hpp"
@@ -105,74 +106,124 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     }
   }
 
-  // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
+  // The model is held as the number of points, the mean and the sum of squared
+  // deviations of each class.  The incremental algorithm starts from the
+  // current model (the variances are unbiased, and hold epsilon); otherwise
+  // the model is trained only on the given data.
+  ModelMatType counts, deviations;
   if (incremental)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
-
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
-
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-    {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
-    }
+    counts = probabilities * trainingPoints;
+    deviations = variances - epsilon;
+    for (size_t i = 0; i < counts.n_elem; ++i)
+      deviations.col(i) *= (counts[i] > 1) ? (counts[i] - 1) : 0;
+    deviations.clamp(0, std::numeric_limits<ElemType>::max());
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
+    counts.zeros(numClasses);
     means.zeros();
-    variances.zeros();
+    deviations.zeros(means.n_rows, means.n_cols);
+    trainingPoints = 0;
+  }
 
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
+  // The batch is split into a chunk for each thread; the statistics of each
+  // chunk are computed with the two-pass algorithm, and then the chunks are
+  // merged into the model in order.
+  #ifdef HAS_OPENMP
+    const size_t numChunks = std::max(std::min((size_t) omp_get_max_threads(),
+        (size_t) data.n_cols), (size_t) 1);
+  #else
+    const size_t numChunks = 1;
+  #endif
+  std::vector<ModelMatType> chunkCounts(numChunks), chunkMeans(numChunks),
+      chunkDeviations(numChunks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    ComputeStatistics(data, labels, c * data.n_cols / numChunks,
+        (c + 1) * data.n_cols / numChunks, chunkCounts[c], chunkMeans[c],
+        chunkDeviations[c]);
+  }
 
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
-    }
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    MergeStatistics(counts, means, deviations, chunkCounts[c], chunkMeans[c],
+        chunkDeviations[c]);
+  }
 
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+  // Now compute the unbiased variances; add epsilon to prevent log of zero.
+  variances = deviations;
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    if (counts[i] > 1)
+      variances.col(i) /= (counts[i] - 1);
+  variances += epsilon;
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
-    }
+  trainingPoints += data.n_cols;
+  if (trainingPoints > 0)
+    probabilities = counts / trainingPoints;
+  else
+    probabilities.zeros();
+}
 
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::ComputeStatistics(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t begin,
+    const size_t end,
+    ModelMatType& counts,
+    ModelMatType& classMeans,
+    ModelMatType& deviations) const
+{
+  counts.zeros(means.n_cols);
+  classMeans.zeros(means.n_rows, means.n_cols);
+  deviations.zeros(means.n_rows, means.n_cols);
+
+  // Calculate the means.
+  for (size_t j = begin; j < end; ++j)
+  {
+    const size_t label = labels[j];
+    ++counts[label];
+    classMeans.col(label) += data.col(j);
   }
 
-  // Add epsilon to prevent log of zero.
-  variances += epsilon;
+  // Normalize means.
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    if (counts[i] != 0.0)
+      classMeans.col(i) /= counts[i];
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+  // Calculate the sums of squared deviations.
+  for (size_t j = begin; j < end; ++j)
+  {
+    const size_t label = labels[j];
+    deviations.col(label) += square(data.col(j) - classMeans.col(label));
+  }
+}
+
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::MergeStatistics(
+    ModelMatType& counts,
+    ModelMatType& classMeans,
+    ModelMatType& deviations,
+    const ModelMatType& otherCounts,
+    const ModelMatType& otherMeans,
+    const ModelMatType& otherDeviations)
+{
+  for (size_t i = 0; i < counts.n_elem; ++i)
+  {
+    if (otherCounts[i] == 0)
+      continue;
+
+    const ElemType total = counts[i] + otherCounts[i];
+    const ModelMatType delta = otherMeans.col(i) - classMeans.col(i);
+    classMeans.col(i) += delta * (otherCounts[i] / total);
+    deviations.col(i) += otherDeviations.col(i) +
+        arma::square(delta) * (counts[i] * otherCounts[i] / total);
+    counts[i] = total;
+  }
 }
 
 template<typename ModelMatType>
@@ -210,24 +261,23 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; ++i)
-  {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        arma::accu(arma::log(variances.col(i))) + exponents);
-  }
+  // The log-likelihood of a point x for a class with means mu and variances
+  // sigma^2 is
+  //
+  //   log P(y) - 0.5 sum_i (x_i^2 / sigma_i^2 - 2 x_i mu_i / sigma_i^2 +
+  //       mu_i^2 / sigma_i^2 + log sigma_i^2) - (d / 2) log(2 pi),
+  //
+  // so the terms that depend on the points are computed for all classes and
+  // points with two matrix products.
+  const ModelMatType invVar = 1.0 / variances;
+  logLikelihoods = -0.5 * invVar.t() * arma::square(data) +
+      (means % invVar).t() * data;
+
+  const ModelMatType classTerms = arma::log(probabilities) -
+      0.5 * arma::sum(arma::square(means) % invVar, 0).t() -
+      0.5 * arma::sum(arma::log(variances), 0).t() -
+      means.n_rows / 2.0 * std::log(2 * M_PI);
+  logLikelihoods.each_col() += classTerms;
 }
 
 template<typename ModelMatType>
@@ -270,10 +320,8 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   LogLikelihood(point, logLikelihoods);
 
   // To prevent underflow in log of sum of exp of x operation (where x is a
-  // small negative value), we use logsumexp(x - max(x)) + max(x).
-  const double maxValue = arma::max(logLikelihoods);
-  const double logProbX = log(arma::accu(exp(logLikelihoods - maxValue))) +
-      maxValue;
+  // small negative value), AccuLog() uses logsumexp(x - max(x)) + max(x).
+  const double logProbX = math::AccuLog(logLikelihoods);
   probabilities = exp(logLikelihoods - logProbX); // log(exp(value)) == value.
 
   arma::uword maxIndex = 0;
@@ -324,19 +372,15 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   ModelMatType logLikelihoods;
   LogLikelihood(data, logLikelihoods);
 
-  predictionProbs.set_size(arma::size(logLikelihoods));
-  double maxValue, logProbX;
-  for (size_t j = 0; j < data.n_cols; ++j)
-  {
-    // The LogLikelihood() gives us the unnormalized log likelihood which is
-    // Log(Prob(X|Y)) + Log(Prob(Y)), so we subtract the normalization term.
-    // Besides, to prevent underflow in log of sum of exp of x operation (where
-    // x is a small negative value), we use logsumexp(x - max(x)) + max(x).
-    maxValue = arma::max(logLikelihoods.col(j));
-    logProbX = log(arma::accu(exp(logLikelihoods.col(j) -
-        maxValue))) + maxValue;
-    predictionProbs.col(j) = arma::exp(logLikelihoods.col(j) - logProbX);
-  }
+  // The LogLikelihood() gives us the unnormalized log likelihood which is
+  // Log(Prob(X|Y)) + Log(Prob(Y)), so we subtract the normalization term,
+  // computed for all the points at once with LogSumExpT() (which prevents
+  // underflow by computing logsumexp(x - max(x)) + max(x) for each point).
+  arma::Col<ElemType> logProbX;
+  math::LogSumExpT(logLikelihoods, logProbX);
+  predictionProbs = logLikelihoods;
+  predictionProbs.each_row() -= logProbX.t();
+  predictionProbs = arma::exp(predictionProbs);
 
   // Now calculate maximum probabilities for each point.
   for (size_t i = 0; i < data.n_cols; ++i)
@@ -86,6 +86,19 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the number of nearest neighbors the softmax of each point is
+  //! restricted to.
+  size_t NumNeighbors() const { return errorFunction.NumNeighbors(); }
+  //! Modify the number of nearest neighbors the softmax of each point is
+  //! restricted to (0 means all points; see SoftmaxErrorFunction).
+  size_t& NumNeighbors() { return errorFunction.NumNeighbors(); }
+
+  //! Get the number of points visited between searches for the neighbors.
+  size_t RefreshInterval() const { return errorFunction.RefreshInterval(); }
+  //! Modify the number of points visited between searches for the neighbors
+  //! (0 means once per pass over the dataset).
+  size_t& RefreshInterval() { return errorFunction.RefreshInterval(); }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
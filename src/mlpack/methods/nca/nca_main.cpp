@@ -98,6 +98,12 @@ BINDING_LONG_DESC(
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
+    "Each evaluation of the objective takes time quadratic in the number of "
+    "points.  For larger datasets, the " + PRINT_PARAM_STRING("num_neighbors") +
+    " parameter restricts the soft neighbor assignments of each point to its "
+    "nearest neighbors, which are searched for again each time " +
+    PRINT_PARAM_STRING("refresh_interval") + " points have been visited."
+    "\n\n"
     "By default, the SGD optimizer is used.");
 
 // See also...
@@ -141,6 +147,13 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "If nonzero, the softmax of each point is "
+    "restricted to this many nearest neighbors, which makes optimization "
+    "O(nk) instead of O(n^2).", "k", 0);
+PARAM_INT_IN("refresh_interval", "Number of points visited between searches "
+    "for the nearest neighbors when the number of neighbors is nonzero (0 "
+    "means once per pass over the dataset).", "r", 0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -200,6 +213,15 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   const double maxStep = params.Get<double>("max_step");
   const size_t batchSize = (size_t) params.Get<int>("batch_size");
 
+  RequireParamValue<int>(params, "num_neighbors", [](int x) { return x >= 0; },
+      true, "number of neighbors must be non-negative");
+  RequireParamValue<int>(params, "refresh_interval",
+      [](int x) { return x >= 0; }, true,
+      "refresh interval must be non-negative");
+  ReportIgnoredParam(params, {{ "num_neighbors", false }}, "refresh_interval");
+  const size_t numNeighbors = (size_t) params.Get<int>("num_neighbors");
+  const size_t refreshInterval = (size_t) params.Get<int>("refresh_interval");
+
   // Load data.
   arma::mat data = std::move(params.Get<arma::mat>("input"));
 
@@ -259,6 +281,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     nca.Optimizer().Tolerance() = tolerance;
     nca.Optimizer().Shuffle() = shuffle;
     nca.Optimizer().BatchSize() = batchSize;
+    nca.NumNeighbors() = numNeighbors;
+    nca.RefreshInterval() = refreshInterval;
 
     nca.LearnDistance(distance);
   }
@@ -273,6 +297,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
     nca.Optimizer().MinStep() = minStep;
     nca.Optimizer().MaxStep() = maxStep;
+    nca.NumNeighbors() = numNeighbors;
+    nca.RefreshInterval() = refreshInterval;
 
     nca.LearnDistance(distance);
   }
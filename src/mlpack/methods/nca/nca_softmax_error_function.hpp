@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -40,6 +41,18 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * Computing p_i exactly takes a scan over every point in the dataset, so an
+ * evaluation over the whole dataset is O(n^2).  If a nonzero number of
+ * neighbors is given, the softmax of each point is instead taken only over its
+ * k nearest neighbors in the transformed space (the other terms are
+ * vanishingly small for points that are far away).  The neighbors are found
+ * with a tree-based search, and are searched for again after a given number
+ * of points have been visited by the separable Gradient(), so that they follow
+ * the transformation as it is learned.  An evaluation is then O(n k), and the
+ * points of a batch are processed in parallel.  (The neighbors are found with
+ * the Euclidean distance, which gives the same neighbors as the default
+ * squared Euclidean distance.)
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -54,10 +67,17 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param metric Instantiated metric (optional).
+   * @param numNeighbors Number of nearest neighbors the softmax of each point
+   *     is restricted to (0 means all points).
+   * @param refreshInterval Number of points visited by the separable
+   *     Gradient() between searches for the nearest neighbors (0 means once
+   *     per pass over the dataset).
    */
   SoftmaxErrorFunction(const arma::mat& dataset,
                        const arma::Row<size_t>& labels,
-                       MetricType metric = MetricType());
+                       MetricType metric = MetricType(),
+                       const size_t numNeighbors = 0,
+                       const size_t refreshInterval = 0);
 
   /**
    * Shuffle the dataset.
@@ -131,6 +151,18 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of nearest neighbors the softmax is restricted to.
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Modify the number of nearest neighbors the softmax is restricted to (0
+  //! means all points).
+  size_t& NumNeighbors() { return numNeighbors; }
+
+  //! Get the number of points visited between searches for the neighbors.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of points visited between searches for the neighbors
+  //! (0 means once per pass over the dataset).
+  size_t& RefreshInterval() { return refreshInterval; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -154,6 +186,17 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! Number of nearest neighbors the softmax is restricted to (0 means all).
+  size_t numNeighbors;
+  //! Number of points visited between searches for the neighbors.
+  size_t refreshInterval;
+  //! The nearest neighbors of each point in the transformed space, when
+  //! numNeighbors is nonzero.
+  arma::Mat<size_t> neighbors;
+  //! Number of points visited by the separable Gradient() since the neighbors
+  //! were last searched for.
+  size_t visited;
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
@@ -168,6 +211,43 @@ class SoftmaxErrorFunction
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Search for the nearest neighbors of each point under the given
+   * transformation, if there are none yet (or their number has changed) or if
+   * the refresh interval has been reached, and count the given number of
+   * visited points.
+   *
+   * @param coordinates Coordinates matrix to search with.
+   * @param batchSize Number of points about to be visited.
+   */
+  void UpdateNeighbors(const arma::mat& coordinates, const size_t batchSize);
+
+  /**
+   * Evaluate the objective function on the given batch, with the softmax of
+   * each point restricted to its nearest neighbors.
+   *
+   * @param coordinates Coordinates matrix of Mahalanobis distance.
+   * @param begin Index of the initial point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateNeighbors(const arma::mat& coordinates,
+                           const size_t begin,
+                           const size_t batchSize);
+
+  /**
+   * Evaluate the gradient on the given batch, with the softmax of each point
+   * restricted to its nearest neighbors.
+   *
+   * @param coordinates Coordinates matrix of Mahalanobis distance.
+   * @param begin Index of the initial point of the batch.
+   * @param gradient Matrix to store the calculated gradient in.
+   * @param batchSize Number of points in the batch.
+   */
+  void GradientNeighbors(const arma::mat& coordinates,
+                         const size_t begin,
+                         arma::mat& gradient,
+                         const size_t batchSize);
 };
 
 } // namespace nca
@@ -25,11 +25,16 @@ template<typename MetricType>
 SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     const arma::mat& dataset,
     const arma::Row<size_t>& labels,
-    MetricType metric) :
+    MetricType metric,
+    const size_t numNeighbors,
+    const size_t refreshInterval) :
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
+    precalculated(false),
+    numNeighbors(numNeighbors),
+    refreshInterval(refreshInterval),
+    visited(0)
 { /* nothing to do */ }
 
 //! Shuffle the dataset.
@@ -46,12 +51,18 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The neighbor indices refer to the old order.
+  neighbors.reset();
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
 template<typename MetricType>
 double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates)
 {
+  if (numNeighbors > 0)
+    return EvaluateNeighbors(coordinates, 0, dataset.n_cols);
+
   // Calculate the denominators and numerators, if necessary.
   Precalculate(coordinates);
 
@@ -66,6 +77,9 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
+  if (numNeighbors > 0)
+    return EvaluateNeighbors(coordinates, begin, batchSize);
+
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
   double denominator = 0;
@@ -112,6 +126,12 @@ template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 arma::mat& gradient)
 {
+  if (numNeighbors > 0)
+  {
+    GradientNeighbors(coordinates, 0, gradient, dataset.n_cols);
+    return;
+  }
+
   // Calculate the denominators and numerators, if necessary.
   Precalculate(coordinates);
 
@@ -163,6 +183,14 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
+  if (numNeighbors > 0)
+  {
+    arma::mat denseGradient;
+    GradientNeighbors(coordinates, begin, denseGradient, batchSize);
+    gradient = denseGradient;
+    return;
+  }
+
   // The gradient involves two matrix terms which are eventually combined into
   // one.
   GradType firstTerm, secondTerm;
@@ -306,6 +334,138 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::UpdateNeighbors(
+    const arma::mat& coordinates,
+    const size_t batchSize)
+{
+  const size_t k = (dataset.n_cols == 0) ? 0 :
+      std::min(numNeighbors, (size_t) dataset.n_cols - 1);
+  const size_t interval = (refreshInterval == 0) ? (size_t) dataset.n_cols :
+      refreshInterval;
+  if (neighbors.n_rows == k && neighbors.n_cols == dataset.n_cols &&
+      visited < interval)
+  {
+    visited += batchSize;
+    return;
+  }
+
+  visited = batchSize;
+  if (k == 0)
+  {
+    neighbors.set_size(0, dataset.n_cols);
+    return;
+  }
+
+  // Each point is its own nearest neighbor in the stretched dataset, so search
+  // it as the reference set (the query points are then left out of their own
+  // results).
+  arma::mat distances;
+  neighbor::KNN knn(coordinates * dataset);
+  knn.Search(k, neighbors, distances);
+}
+
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::EvaluateNeighbors(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t batchSize)
+{
+  UpdateNeighbors(coordinates, 0);
+
+  double result = 0.0;
+  #pragma omp parallel for schedule(static) reduction(+:result)
+  for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
+  {
+    // Only the batch and its neighbors need to be stretched.  A x_k is
+    // A x_i - A (x_i - x_k).
+    arma::mat differences(dataset.n_rows, neighbors.n_rows);
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      differences.col(j) = dataset.col(i) - dataset.col(neighbors(j, i));
+    const arma::vec point = coordinates * dataset.col(i);
+    const arma::mat stretchedDifferences = coordinates * differences;
+
+    double numerator = 0.0;
+    double denominator = 0.0;
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      const double eval = std::exp(-metric.Evaluate(point,
+          arma::vec(point - stretchedDifferences.col(j))));
+      if (labels[i] == labels[neighbors(j, i)])
+        numerator += eval;
+      denominator += eval;
+    }
+
+    // If the denominator is 0, the point has no contribution.
+    if (denominator > 0.0)
+      result += -(numerator / denominator);
+  }
+
+  return result;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::GradientNeighbors(
+    const arma::mat& coordinates,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  UpdateNeighbors(coordinates, batchSize);
+
+  // Each point adds
+  //   sum_k p_ik (p_i - [class of k is class of i]) x_ik x_ik^T
+  // to the sum, which is D diag(w) D^T for the matrix D of differences x_ik.
+  // Each thread accumulates its own sum.
+  arma::mat sum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::mat threadSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    arma::mat differences(dataset.n_rows, neighbors.n_rows);
+    arma::vec evals(neighbors.n_rows);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
+    {
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+        differences.col(j) = dataset.col(i) - dataset.col(neighbors(j, i));
+      const arma::vec point = coordinates * dataset.col(i);
+      const arma::mat stretchedDifferences = coordinates * differences;
+
+      double numerator = 0.0;
+      double denominator = 0.0;
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+      {
+        evals[j] = std::exp(-metric.Evaluate(point,
+            arma::vec(point - stretchedDifferences.col(j))));
+        if (labels[i] == labels[neighbors(j, i)])
+          numerator += evals[j];
+        denominator += evals[j];
+      }
+
+      // If the denominator is zero, then all p_ik are zero and there is no
+      // gradient contribution from this point.
+      if (denominator == 0.0)
+        continue;
+
+      const double p = numerator / denominator;
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+      {
+        const double same = (labels[i] == labels[neighbors(j, i)]) ? 1.0 : 0.0;
+        evals[j] *= (p - same) / denominator;
+      }
+
+      threadSum += (differences.each_row() % evals.t()) * differences.t();
+    }
+
+    #pragma omp critical
+    sum += threadSum;
+  }
+
+  // We negate, because our optimizer is a minimizer.
+  gradient = -2 * coordinates * sum;
+}
+
 } // namespace nca
 } // namespace mlpack
 
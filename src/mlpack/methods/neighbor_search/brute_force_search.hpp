@@ -0,0 +1,274 @@
+/**
+ * @file methods/neighbor_search/brute_force_search.hpp
+ *
+ * Brute-force nearest neighbor search with the Euclidean distance, computing
+ * the distances between tiles of query and reference points with matrix
+ * products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * BruteForceTraits<MetricType, MatType>::Supported is true if
+ * TiledBruteForceSearch() can be used with the given metric and matrix type:
+ * that is, for the Euclidean and squared Euclidean distances, on dense
+ * matrices.
+ */
+template<typename MetricType, typename MatType>
+struct BruteForceTraits
+{
+  static const bool Supported = false;
+  static const bool TakeRoot = false;
+};
+
+template<bool MetricTakeRoot, typename ElemType>
+struct BruteForceTraits<metric::LMetric<2, MetricTakeRoot>,
+                        arma::Mat<ElemType>>
+{
+  static const bool Supported = true;
+  static const bool TakeRoot = MetricTakeRoot;
+};
+
+namespace details {
+
+//! A candidate neighbor: its distance and its index.
+typedef std::pair<double, size_t> BruteForceCandidate;
+
+/**
+ * Insert a candidate in a list of candidates sorted from best to worst,
+ * dropping the worst one, and return the new worst distance.  The candidate
+ * must be strictly better than the worst one.
+ */
+template<typename SortPolicy>
+inline double InsertCandidate(BruteForceCandidate* list,
+                              const size_t size,
+                              const double distance,
+                              const size_t index)
+{
+  size_t j = size - 1;
+  while (j > 0 && !SortPolicy::IsBetter(list[j - 1].first, distance))
+  {
+    list[j] = list[j - 1];
+    --j;
+  }
+
+  list[j] = BruteForceCandidate(distance, index);
+  return list[size - 1].first;
+}
+
+/**
+ * Return the threshold of the expanded (squared) distances that may be better
+ * than the given worst exact distance, given a bound on their rounding error.
+ */
+template<typename SortPolicy, bool TakeRoot>
+inline double FilterThreshold(const double worst, const double slack)
+{
+  const double bound = (TakeRoot && worst != SortPolicy::WorstDistance()) ?
+      worst * worst : worst;
+  return SortPolicy::CombineWorst(bound, slack);
+}
+
+/**
+ * Order candidates from best to worst, breaking ties by index, so that the
+ * candidates that were not filled (with index SIZE_MAX) come last.
+ */
+template<typename SortPolicy>
+struct CandidateOrder
+{
+  bool operator()(const BruteForceCandidate& a,
+                  const BruteForceCandidate& b) const
+  {
+    if (a.first != b.first)
+      return !SortPolicy::IsBetter(b.first, a.first);
+    return a.second < b.second;
+  }
+};
+
+} // namespace details
+
+/**
+ * Placeholder for metrics and matrix types that TiledBruteForceSearch() does
+ * not support: do nothing, and return false.
+ */
+template<typename SortPolicy, typename MetricType, typename MatType>
+typename std::enable_if<!BruteForceTraits<MetricType, MatType>::Supported,
+    bool>::type
+TiledBruteForceSearch(const MatType& /* querySet */,
+                      const MatType& /* referenceSet */,
+                      const size_t /* k */,
+                      const bool /* sameSet */,
+                      arma::Mat<size_t>& /* neighbors */,
+                      arma::mat& /* distances */)
+{
+  return false;
+}
+
+/**
+ * Find the k best neighbors of each query point among all the reference
+ * points, for the (squared) Euclidean distance, and return true.  The results
+ * are the same as those of NeighborSearchRules::BaseCase() called on every
+ * pair of points, but the distances are computed a tile of query points and a
+ * tile of reference points at a time, as ||q||^2 + ||r||^2 - 2 q^T r with one
+ * matrix product (so with BLAS) per pair of tiles.  Then, for each query point,
+ * the distances of the tile are compared with the worst of its k candidates
+ * in a single vectorizable pass, and only the (few) points that may be better
+ * have their exact distance computed and are inserted in its sorted candidate
+ * list.  The tiles of query points are processed in parallel with OpenMP.
+ *
+ * The expanded distances lose precision when the points are far from the
+ * origin, so they are only used as a filter: a point is skipped only if its
+ * expanded distance is worse than the worst candidate by more than a bound on
+ * the rounding error (which grows with the dimension and the norms of the
+ * points).  The candidate lists only hold exact distances, so the results do
+ * not depend on the rounding errors; but far from the origin (and especially
+ * with float matrices) many more exact distances are computed.  The matrix
+ * products are computed in the element type of the matrices, so float
+ * matrices (for instance, of embeddings) take half the memory and bandwidth.
+ *
+ * @param querySet Set of query points.
+ * @param referenceSet Set of reference points.
+ * @param k Number of neighbors to find.
+ * @param sameSet If true, the query set is the reference set, and a point is
+ *     not returned as its own neighbor.
+ * @param neighbors Matrix storing lists of neighbors for each query point.
+ * @param distances Matrix storing distances of neighbors for each query
+ *     point.
+ */
+template<typename SortPolicy, typename MetricType, typename MatType>
+typename std::enable_if<BruteForceTraits<MetricType, MatType>::Supported,
+    bool>::type
+TiledBruteForceSearch(const MatType& querySet,
+                      const MatType& referenceSet,
+                      const size_t k,
+                      const bool sameSet,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef details::BruteForceCandidate Candidate;
+  typedef metric::LMetric<2, BruteForceTraits<MetricType, MatType>::TakeRoot>
+      ExactMetricType;
+
+  // The tiles of dot products (of at most 512 x 128 elements) fit in the L2
+  // cache of each thread.
+  const size_t queryTileSize = 128;
+  const size_t referenceTileSize = 512;
+
+  const size_t numQueries = querySet.n_cols;
+  const size_t numReferences = referenceSet.n_cols;
+  neighbors.set_size(k, numQueries);
+  distances.set_size(k, numQueries);
+  if (k == 0 || numQueries == 0)
+    return true;
+
+  const arma::Row<ElemType> referenceNorms =
+      arma::sum(arma::square(referenceSet), 0);
+  const arma::Row<ElemType> queryNorms = sameSet ? referenceNorms :
+      arma::Row<ElemType>(arma::sum(arma::square(querySet), 0));
+
+  // The error of the expanded squared distance between q and r is at most
+  // about (d + 2) eps (||q||^2 + ||r||^2); this is a generous bound, relative
+  // to the squared norms of the query and of the largest reference point of
+  // the tile.
+  const double errorScale = 4.0 * (querySet.n_rows + 2) *
+      (double) std::numeric_limits<ElemType>::epsilon();
+
+  const size_t numTiles = (numQueries + queryTileSize - 1) / queryTileSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) numTiles; ++t)
+  {
+    const size_t queryBegin = t * queryTileSize;
+    const size_t queryEnd = std::min(queryBegin + queryTileSize, numQueries);
+    const size_t tileQueries = queryEnd - queryBegin;
+
+    std::vector<Candidate> lists(k * tileQueries,
+        Candidate(SortPolicy::WorstDistance(), SIZE_MAX));
+    std::vector<double> tileDistances(referenceTileSize);
+    arma::Mat<ElemType> products;
+
+    for (size_t referenceBegin = 0; referenceBegin < numReferences;
+         referenceBegin += referenceTileSize)
+    {
+      const size_t referenceEnd = std::min(referenceBegin + referenceTileSize,
+          numReferences);
+      const size_t tileReferences = referenceEnd - referenceBegin;
+
+      // All the dot products of the two tiles, in one matrix product.
+      products = referenceSet.cols(referenceBegin, referenceEnd - 1).t() *
+          querySet.cols(queryBegin, queryEnd - 1);
+
+      const ElemType* norms = referenceNorms.memptr() + referenceBegin;
+      const double maxNorm = (double) arma::max(
+          referenceNorms.subvec(referenceBegin, referenceEnd - 1));
+      for (size_t q = 0; q < tileQueries; ++q)
+      {
+        const size_t query = queryBegin + q;
+        const double queryNorm = (double) queryNorms[query];
+        const ElemType* dots = products.colptr(q);
+        for (size_t r = 0; r < tileReferences; ++r)
+        {
+          tileDistances[r] = std::max(queryNorm + (double) norms[r] -
+              2.0 * (double) dots[r], 0.0);
+        }
+
+        const double slack = errorScale * (queryNorm + maxNorm);
+        Candidate* list = lists.data() + q * k;
+        double worst = list[k - 1].first;
+        double threshold = details::FilterThreshold<SortPolicy,
+            BruteForceTraits<MetricType, MatType>::TakeRoot>(worst, slack);
+        for (size_t r = 0; r < tileReferences; ++r)
+        {
+          if (SortPolicy::IsBetter(threshold, tileDistances[r]))
+            continue;
+
+          const size_t reference = referenceBegin + r;
+          if (sameSet && reference == query)
+            continue;
+
+          // Only strictly better candidates are inserted, as in
+          // NeighborSearchRules::InsertNeighbor().
+          const double distance = ExactMetricType::Evaluate(
+              querySet.col(query), referenceSet.col(reference));
+          if (SortPolicy::IsBetter(worst, distance))
+            continue;
+
+          worst = details::InsertCandidate<SortPolicy>(list, k, distance,
+              reference);
+          threshold = details::FilterThreshold<SortPolicy,
+              BruteForceTraits<MetricType, MatType>::TakeRoot>(worst, slack);
+        }
+      }
+    }
+
+    // Break the ties by index (the candidate list is otherwise sorted).
+    for (size_t q = 0; q < tileQueries; ++q)
+    {
+      const size_t query = queryBegin + q;
+      Candidate* list = lists.data() + q * k;
+      std::sort(list, list + k, details::CandidateOrder<SortPolicy>());
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, query) = list[j].second;
+        distances(j, query) = list[j].first;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
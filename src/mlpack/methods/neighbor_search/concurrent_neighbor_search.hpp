@@ -0,0 +1,164 @@
+/**
+ * @file methods/neighbor_search/concurrent_neighbor_search.hpp
+ *
+ * Defines the ConcurrentNeighborSearch class, which allows neighbor searches to
+ * run concurrently with insertions and removals of reference points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_CONCURRENT_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_CONCURRENT_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ConcurrentNeighborSearch class holds a NeighborSearch model whose
+ * reference tree is updated in place (a RectangleTree: RTree, RStarTree, XTree
+ * and so on), so that any number of threads can call Search() while one
+ * thread at a time calls Insert() or Remove().  Searches never wait for
+ * updates, and they never see a tree in the middle of an update.
+ *
+ * Two copies of the model are kept.  Searches use the published copy; an update
+ * is applied to the other copy, which is then published atomically.  The
+ * updating thread waits until the searches still using the old copy are done,
+ * and applies the same update to it, so that it becomes the copy for the next
+ * update.  So memory use is doubled and each update is applied twice, but no
+ * copy of the tree is made after construction, unless an update fails on one
+ * of the copies: that copy is then dropped, and made again from the published
+ * copy at the next update.  Updates are meant to be rare compared to searches;
+ * Epoch() counts them.
+ *
+ * Searches are single-tree searches (each call is serial, so that concurrent
+ * calls scale over threads).  A search started before an update finishes
+ * returns the results of the model before the update.
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use; it must support insertion and
+ *     deletion, must not rearrange the dataset, and must not hold the centroid
+ *     as its first point (the single-tree search then does not modify it).
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::RStarTree>
+class ConcurrentNeighborSearch
+{
+ public:
+  //! The type of the model.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType>
+      NeighborSearchType;
+  //! The type of the reference tree.
+  typedef typename NeighborSearchType::Tree Tree;
+
+  /**
+   * Build the model on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric An optional instance of the MetricType class.
+   */
+  ConcurrentNeighborSearch(MatType referenceSet,
+                           const double epsilon = 0,
+                           const MetricType metric = MetricType());
+
+  /**
+   * Build the model on the given reference tree, which may for instance have
+   * been bulk loaded.
+   *
+   * @param referenceTree Pre-built tree for reference points.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric An optional instance of the MetricType class.
+   */
+  ConcurrentNeighborSearch(Tree referenceTree,
+                           const double epsilon = 0,
+                           const MetricType metric = MetricType());
+
+  /**
+   * Find the k neighbors of each point of the query set in the published
+   * model.  This can be called from any number of threads at once, and at the
+   * same time as Insert() and Remove().
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Add the given points to the reference set, as NeighborSearch::Insert().
+   * Concurrent updates are serialized.
+   *
+   * @param points New reference points.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Remove the given points from the reference tree, as
+   * NeighborSearch::Remove().  Concurrent updates are serialized.  If a point
+   * is not in the tree, an exception is thrown and the model is not changed.
+   *
+   * @param indices Indices of the reference points to remove.
+   */
+  void Remove(const arma::Col<size_t>& indices);
+
+  /**
+   * Get the published model.  The model stays valid (and unchanged) as long as
+   * the pointer is held, even if it is replaced by an update; it must not be
+   * modified.
+   */
+  std::shared_ptr<const NeighborSearchType> Snapshot() const
+  {
+    return std::atomic_load(&published);
+  }
+
+  //! Get the number of updates published so far.
+  size_t Epoch() const { return epoch.load(); }
+
+ private:
+  /**
+   * Apply the given update to the standby copy, publish it, wait for the
+   * searches on the old copy and apply the update to it too.
+   */
+  template<typename UpdateType>
+  void Update(const UpdateType& update);
+
+  //! The model used by searches.
+  std::shared_ptr<NeighborSearchType> published;
+  //! The model the next update is applied to; only the writer touches it.  It
+  //! is never the published model, and it is NULL after a failed update.
+  std::shared_ptr<NeighborSearchType> standby;
+  //! The metric used by searches.
+  MetricType metric;
+  //! Serializes the updates.
+  std::mutex writeLock;
+  //! The number of published updates.
+  std::atomic<size_t> epoch;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "concurrent_neighbor_search_impl.hpp"
+
+#endif
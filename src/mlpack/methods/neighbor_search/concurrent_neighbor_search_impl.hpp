@@ -0,0 +1,199 @@
+/**
+ * @file methods/neighbor_search/concurrent_neighbor_search_impl.hpp
+ *
+ * Implementation of the ConcurrentNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_CONCURRENT_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_CONCURRENT_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "concurrent_neighbor_search.hpp"
+
+#include <thread>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ConcurrentNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ConcurrentNeighborSearch(MatType referenceSet,
+                         const double epsilon,
+                         const MetricType metric) :
+    published(new NeighborSearchType(std::move(referenceSet),
+        SINGLE_TREE_MODE, epsilon, metric)),
+    standby(new NeighborSearchType(*published)),
+    metric(metric),
+    epoch(0)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset &&
+      !tree::TreeTraits<Tree>::FirstPointIsCentroid,
+      "ConcurrentNeighborSearch: the tree must not rearrange the dataset or "
+      "hold the centroid as its first point");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ConcurrentNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ConcurrentNeighborSearch(Tree referenceTree,
+                         const double epsilon,
+                         const MetricType metric) :
+    published(new NeighborSearchType(std::move(referenceTree),
+        SINGLE_TREE_MODE, epsilon, metric)),
+    standby(new NeighborSearchType(*published)),
+    metric(metric),
+    epoch(0)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset &&
+      !tree::TreeTraits<Tree>::FirstPointIsCentroid,
+      "ConcurrentNeighborSearch: the tree must not rearrange the dataset or "
+      "hold the centroid as its first point");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ConcurrentNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Search(const MatType& querySet,
+       const size_t k,
+       arma::Mat<size_t>& neighbors,
+       arma::mat& distances) const
+{
+  // Holding the model keeps the writer from modifying it.
+  std::shared_ptr<const NeighborSearchType> model = Snapshot();
+  const MatType& referenceSet = model->ReferenceSet();
+
+  if (k > model->ReferenceTree().NumDescendants())
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference tree ("
+        << model->ReferenceTree().NumDescendants() << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::stringstream ss;
+    ss << "ConcurrentNeighborSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") does not match the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // The rules only write to the query statistics of a dual-tree search, so a
+  // single-tree search leaves the shared reference tree as it is.  Each call
+  // has its own rules and metric.
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  MetricType searchMetric(metric);
+  RuleType rules(referenceSet, querySet, k, searchMetric, model->Epsilon());
+
+  Tree& referenceTree = const_cast<Tree&>(model->ReferenceTree());
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    traverser.Traverse(i, referenceTree);
+
+  rules.GetResults(neighbors, distances);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ConcurrentNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Insert(const MatType& points)
+{
+  Update([&points](NeighborSearchType& model) { model.Insert(points); });
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ConcurrentNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Remove(const arma::Col<size_t>& indices)
+{
+  Update([&indices](NeighborSearchType& model) { model.Remove(indices); });
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename UpdateType>
+void ConcurrentNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Update(const UpdateType& update)
+{
+  std::lock_guard<std::mutex> lock(writeLock);
+
+  // The standby copy is missing if the last update could not be applied to
+  // it; then it is copied from the published one (which is only read).
+  if (!standby)
+    standby = std::make_shared<NeighborSearchType>(*published);
+
+  // If the update fails halfway, the standby copy is dropped, and the model
+  // is not changed.
+  try
+  {
+    update(*standby);
+  }
+  catch (...)
+  {
+    standby.reset();
+    throw;
+  }
+
+  std::shared_ptr<NeighborSearchType> old =
+      std::atomic_exchange(&published, standby);
+  ++epoch;
+
+  // Wait for the searches that still hold the old copy; after that, nothing
+  // but this function can reach it.  The fence makes their reads happen before
+  // the writes below.
+  while (old.use_count() > 1)
+    std::this_thread::yield();
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  // The old copy is in the state the standby copy was in, so the same update
+  // brings it up to date.  If that fails, the update is still published, but
+  // the old copy is dropped, so that the standby copy never aliases the
+  // published one; the next update copies the published one instead.
+  try
+  {
+    update(*old);
+  }
+  catch (...)
+  {
+    standby.reset();
+    return;
+  }
+
+  standby = std::move(old);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
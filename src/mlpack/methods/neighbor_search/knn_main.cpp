@@ -20,6 +20,7 @@
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include <string>
@@ -29,6 +30,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "ns_auto_tuner.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -39,6 +41,7 @@ using namespace mlpack::util;
 
 // Convenience typedef.
 typedef NSModel<NearestNeighborSort> KNNModel;
+typedef NSAutoTuner<NearestNeighborSort> KNNTuner;
 
 // Program Name.
 BINDING_USER_NAME("k-Nearest-Neighbors Search");
@@ -109,7 +112,9 @@ PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'spill', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'spill', 'oct', 'hnsw'.  'hnsw' builds a hierarchical "
+    "navigable small world graph instead of a tree, for approximate search.",
+    "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, vp "
     "trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, spill trees, and octrees).", "l",
@@ -118,6 +123,13 @@ PARAM_DOUBLE_IN("tau", "Overlapping size (only valid for spill trees).", "u",
     0);
 PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
     0.7);
+PARAM_INT_IN("hnsw_m", "Maximum number of links of each point in each layer of "
+    "the graph (only valid for HNSW graphs).", "H", 16);
+PARAM_INT_IN("ef_construction", "Size of the list of closest points used to "
+    "insert points in the graph (only valid for HNSW graphs).", "C", 200);
+PARAM_INT_IN("ef", "Size of the list of closest points explored by a graph "
+    "search; larger values give a better recall but a slower search (only "
+    "valid for HNSW graphs).", "E", 50);
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
@@ -128,6 +140,23 @@ PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
     "'dual_tree', 'greedy'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_FLAG("collect_statistics", "If true, the number of nodes visited and "
+    "pruned, and the number of base cases, are collected for each depth of the "
+    "reference tree and saved to the 'traversal_statistics' output.", "");
+PARAM_UMATRIX_OUT("traversal_statistics", "If --collect_statistics is given, "
+    "matrix to output the traversal statistics into, with one row per depth"
+    " of the reference tree, and the numbers of visited nodes, pruned nodes, "
+    "and base cases in the columns.", "");
+
+// Auto-tuning settings.
+PARAM_FLAG("auto_tune", "If true, the tree type, leaf size, algorithm and "
+    "epsilon are chosen automatically, by benchmarking candidate "
+    "configurations on samples of the reference and query data and picking "
+    "the one with the lowest estimated time whose recall reaches "
+    "'auto_tune_recall'.", "");
+PARAM_DOUBLE_IN("auto_tune_recall", "Minimum recall of the configuration "
+    "chosen by auto-tuning, in (0, 1]; values below 1 allow approximate "
+    "searches.", "", 1.0);
 
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
@@ -143,6 +172,17 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   ReportIgnoredParam(params, {{ "input_model", true }}, "random_basis");
   ReportIgnoredParam(params, {{ "input_model", true }}, "tau");
   ReportIgnoredParam(params, {{ "input_model", true }}, "rho");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "auto_tune");
+  ReportIgnoredParam(params, {{ "auto_tune", false }}, "auto_tune_recall");
+  ReportIgnoredParam(params, {{ "auto_tune", true }}, "tree_type");
+  ReportIgnoredParam(params, {{ "auto_tune", true }}, "algorithm");
+  ReportIgnoredParam(params, {{ "auto_tune", true }}, "epsilon");
+  if (params.Has("auto_tune") && params.Has("leaf_size") &&
+      !params.Has("input_model"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("leaf_size") << " will be ignored because "
+        << PRINT_PARAM_STRING("auto_tune") << " is specified." << endl;
+  }
   if (params.Has("input_model") && params.Has("leaf_size"))
   {
     Log::Warn << PRINT_PARAM_STRING("leaf_size") << " will only be considered"
@@ -190,11 +230,33 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     ReportIgnoredParam(params, "rho", "spill trees are not being used");
   }
 
+  // Sanity checks on the HNSW graph parameters.
+  RequireParamValue<int>(params, "hnsw_m", [](int x) { return x >= 2; },
+      true, "hnsw_m must be at least 2");
+  RequireParamValue<int>(params, "ef_construction", [](int x) { return x > 0; },
+      true, "ef_construction must be positive");
+  RequireParamValue<int>(params, "ef", [](int x) { return x > 0; }, true,
+      "ef must be positive");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "hnsw_m");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "ef_construction");
+  if (!params.Has("input_model") && params.Get<string>("tree_type") != "hnsw")
+  {
+    ReportIgnoredParam(params, "hnsw_m", "HNSW graphs are not being used");
+    ReportIgnoredParam(params, "ef_construction",
+        "HNSW graphs are not being used");
+    ReportIgnoredParam(params, "ef", "HNSW graphs are not being used");
+  }
+
   // Sanity check on epsilon.
-  const double epsilon = params.Get<double>("epsilon");
+  double epsilon = params.Get<double>("epsilon");
   RequireParamValue<double>(params, "epsilon",
       [](double x) { return x >= 0.0; }, true, "epsilon must be positive");
 
+  // Sanity check on the auto-tuning recall.
+  RequireParamValue<double>(params, "auto_tune_recall",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "auto_tune_recall must be in (0, 1]");
+
   // We either have to load the reference data, or we have to load the model.
   KNNModel* knn;
 
@@ -221,7 +283,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>(params, "tree_type", { "kd", "cover", "r",
         "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill",
-        "vp", "rp", "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "vp", "rp", "max-rp", "ub", "oct", "hnsw" }, true,
+        "unknown tree type");
 
     knn = new KNNModel();
 
@@ -255,18 +318,56 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       tree = KNNModel::UB_TREE;
     else if (treeType == "oct")
       tree = KNNModel::OCTREE;
+    else if (treeType == "hnsw")
+      tree = KNNModel::HNSW;
 
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
+    knn->MaxConnections() = (size_t) params.Get<int>("hnsw_m");
+    knn->EfConstruction() = (size_t) params.Get<int>("ef_construction");
+    knn->Ef() = (size_t) params.Get<int>("ef");
 
     Log::Info << "Using reference data from "
         << params.GetPrintable<arma::mat>("reference") << "." << endl;
 
     arma::mat referenceSet = std::move(params.Get<arma::mat>("reference"));
 
+    // Tune the configuration for the search that will be done (or for k = 1,
+    // if no search is done).  Invalid values of k and query sets are reported
+    // after the model is built.
+    const int tuneK = params.Has("k") ? params.Get<int>("k") : 1;
+    const bool hasQuery = params.Has("query");
+    const bool validK = (tuneK > 0) &&
+        ((size_t) tuneK + (hasQuery ? 0 : 1) <= referenceSet.n_cols);
+    const bool validQuery = !hasQuery ||
+        (params.Get<arma::mat>("query").n_rows == referenceSet.n_rows);
+    if (params.Has("auto_tune") && validK && validQuery)
+    {
+      KNNTuner tuner(params.Get<double>("auto_tune_recall"));
+      timers.Start("auto_tuning");
+      const KNNTuner::Configuration& configuration = hasQuery ?
+          tuner.Tune(referenceSet, params.Get<arma::mat>("query"), tuneK) :
+          tuner.Tune(referenceSet, tuneK);
+      timers.Stop("auto_tuning");
+
+      knn->TreeType() = configuration.treeType;
+      knn->LeafSize() = configuration.leafSize;
+      searchMode = configuration.searchMode;
+      epsilon = configuration.epsilon;
+
+      const char* algorithmNames[] = { "naive", "single_tree", "dual_tree",
+          "greedy" };
+      Log::Info << "Auto-tuning chose " << knn->TreeName() << " with leaf "
+          << "size " << configuration.leafSize << ", algorithm '"
+          << algorithmNames[searchMode] << "' and epsilon " << epsilon
+          << " (estimated time "
+          << configuration.cost << "s, recall " << configuration.recall
+          << ")." << endl;
+    }
+
     knn->BuildModel(timers, std::move(referenceSet), searchMode, epsilon);
   }
   else
@@ -284,6 +385,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     if (params.Has("leaf_size"))
       knn->LeafSize() = size_t(lsInt);
 
+    // The size of the search list of a graph may also be changed.
+    if (params.Has("ef"))
+      knn->Ef() = (size_t) params.Get<int>("ef");
+
     Log::Info << "Loaded kNN model from '"
         << params.GetPrintable<KNNModel*>("input_model") << "' (trained on "
         << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
@@ -343,17 +448,32 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     arma::Mat<size_t> neighbors;
     arma::mat distances;
 
+    TraversalStatistics statistics;
+    if (params.Has("collect_statistics"))
+      statistics.Start();
+
     if (params.Has("query"))
       knn->Search(timers, std::move(queryData), k, neighbors, distances);
     else
       knn->Search(timers, k, neighbors, distances);
 
+    statistics.Stop();
+    if (params.Has("collect_statistics"))
+    {
+      Log::Info << statistics.NumVisited() << " nodes visited, "
+          << statistics.NumPrunes() << " nodes pruned, "
+          << statistics.NumBaseCases() << " base cases." << endl;
+      params.Get<arma::Mat<size_t>>("traversal_statistics") =
+          statistics.Matrix();
+    }
+
     Log::Info << "Search complete." << endl;
 
     // Calculate the effective error, if desired.
     if (params.Has("true_distances"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE &&
+          knn->TreeType() != KNNModel::HNSW && knn->Epsilon() == 0)
         Log::Warn << PRINT_PARAM_STRING("true_distances") << "specified, but "
             << "the search is exact, so there is no need to calculate the "
             << "error!" << endl;
@@ -377,7 +497,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     // Calculate the recall, if desired.
     if (params.Has("true_neighbors"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE &&
+          knn->TreeType() != KNNModel::HNSW && knn->Epsilon() == 0)
         Log::Warn << PRINT_PARAM_STRING("true_neighbors") << " specified, but "
             << " the search is exact, so there is no need to calculate the "
             << "recall!" << endl;
@@ -20,10 +20,12 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
 
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "neighbor_search_rules.hpp"
+#include "brute_force_search.hpp"
 
 namespace mlpack {
 // Neighbor-search routines. These include all-nearest-neighbors and
@@ -211,6 +213,40 @@ class NeighborSearch
    */
   void Train(Tree referenceTree);
 
+  /**
+   * Add the given points to the reference set, without rebuilding the
+   * reference tree.  The new points get the next indices of the reference
+   * points, so the first new point has index ReferenceSet().n_cols (before the
+   * call).  The tree type must support insertion, even in naive mode: this is
+   * the RectangleTree family (RTree, RStarTree, XTree, and so on), which
+   * inserts each point along one path of the tree, and the BinarySpaceTree
+   * family (KDTree, BallTree, VPTree, and so on), which adds the points to
+   * their nearest leaves with BinarySpaceTree::InsertPoints(), moving the other
+   * points of the rearranged dataset, and splits the leaves that become too
+   * large.
+   *
+   * @param points New reference points.
+   * @param maxLeafSize Maximum number of points in a leaf; only used by the
+   *     BinarySpaceTree family.
+   */
+  void Insert(const MatType& points, const size_t maxLeafSize = 20);
+
+  /**
+   * Remove the given points from the reference tree, so that they are not
+   * returned as neighbors anymore.  The points stay in the reference set, so
+   * the indices of the other points do not change.  This means that a
+   * monochromatic search still returns a column for each removed point, which
+   * should be ignored (in dual-tree mode the removed points are not searched:
+   * their neighbors are size_t(-1), with the worst distance).  The tree must
+   * support deletion (see Insert(); the BinarySpaceTree family uses
+   * BinarySpaceTree::RemovePoints(), which keeps the removed points at the end
+   * of its dataset), and points cannot be removed in naive mode.  An exception
+   * is thrown if a point is not in the tree.
+   *
+   * @param indices Indices of the reference points to remove.
+   */
+  void Remove(const arma::Col<size_t>& indices);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -240,10 +276,9 @@ class NeighborSearch
    * number of points in the query dataset and k is the number of neighbors
    * being searched for.
    *
-   * Note that if you are calling Search() multiple times with a single query
-   * tree, you need to reset the bounds in the statistic of each query node,
-   * otherwise the result may be wrong!  You can do this by calling
-   * \c TreeType::Stat().Reset() on each node in the query tree.
+   * The bounds in the statistic of each query node are reset before the
+   * search, so a single query tree can be used for several calls to Search(),
+   * with this or other NeighborSearch objects, without being rebuilt.
    *
    * @param queryTree Tree built on query points.
    * @param k Number of neighbors to search for.
@@ -326,6 +361,14 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Get whether single-tree searches store the bounds of the children of
+  //! the reference nodes in single precision.
+  bool SinglePrecisionBounds() const { return singlePrecisionBounds; }
+  //! Modify whether single-tree searches store the bounds of the children of
+  //! the reference nodes in single precision (this halves their memory, but
+  //! the bounds are a little looser; the results do not change).
+  bool& SinglePrecisionBounds() { return singlePrecisionBounds; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -363,6 +406,82 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! If true, single-tree searches store the bounds of the children of the
+  //! reference nodes in single precision.
+  bool singlePrecisionBounds;
+
+  /**
+   * Traverse the given query tree and the reference tree with the given rules.
+   * If OpenMP is available, the query tree is split into disjoint subtrees
+   * which are traversed in parallel against the whole reference tree; each
+   * thread uses its own rules object, and the scores and base cases of every
+   * thread are added to the given rules object.
+   *
+   * @param queryTree Tree built on query points.
+   * @param rules Rules object to use for the traversal.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
+  //! Reset the bounds in the statistics of every node of the given tree.
+  static void ResetTree(Tree& tree);
+
+  //! Get the number of reference points that can be returned as neighbors
+  //! (the points removed by Remove() cannot).
+  size_t NumReferencePoints() const
+  {
+    return referenceTree ? referenceTree->NumDescendants() :
+        referenceSet->n_cols;
+  }
+
+  //! Add the given points to the reference set and to a tree that does not
+  //! rearrange the dataset.
+  void InsertIntoTree(const MatType& points,
+                      const size_t /* maxLeafSize */,
+                      const std::false_type& /* rearrangesDataset */);
+
+  //! Add the given points to the reference set and to a tree that rearranges
+  //! the dataset.
+  void InsertIntoTree(const MatType& points,
+                      const size_t maxLeafSize,
+                      const std::true_type& /* rearrangesDataset */);
+
+  //! Remove the given reference points from a tree that does not rearrange
+  //! the dataset.
+  void RemoveFromTree(const arma::Col<size_t>& indices,
+                      const std::false_type& /* rearrangesDataset */);
+
+  //! Remove the given reference points from a tree that rearranges the
+  //! dataset.
+  void RemoveFromTree(const arma::Col<size_t>& indices,
+                      const std::true_type& /* rearrangesDataset */);
+
+  /**
+   * Traverse the reference tree once for each of the given number of query
+   * points, using a single-tree traverser of type TraverserType.  If OpenMP is
+   * available, the query points are split across threads; each thread uses its
+   * own rules object, and the scores and base cases of every thread are added
+   * to the given rules object.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules object to use for the traversal.
+   */
+  template<typename TraverserType, typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
+  /**
+   * Run a single-tree search for the given number of query points with the
+   * given rules.  If the bound of the tree is a HRectBound, the bounds of the
+   * children of every reference node are first stored together in a
+   * tree::ChildBounds object (in single precision, if SinglePrecisionBounds()
+   * is true), so that the rules score all the children of a node at once.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules object to use for the traversal.
+   */
+  template<typename RuleType>
+  void SingleTreeSearch(const size_t numQueries, RuleType& rules);
+
   //! The NSModel class should have access to internal members.
   friend class LeafSizeNSWrapper<SortPolicy, TreeType, DualTreeTraversalType,
       SingleTreeTraversalType>;
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/numa.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
@@ -68,10 +69,15 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    singlePrecisionBounds(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
+
+  // In NUMA mode, spread the points of the reference set over the memory of
+  // the sockets (the reference set is owned by this object).
+  util::FirstTouch(const_cast<MatType&>(*referenceSet));
 }
 
 // Construct the object.
@@ -95,10 +101,15 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    singlePrecisionBounds(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
+
+  // In NUMA mode, spread the points of the reference set over the memory of
+  // the sockets (the reference set is owned by this object).
+  util::FirstTouch(const_cast<MatType&>(*referenceSet));
 }
 
 // Construct the object without a reference dataset.
@@ -121,7 +132,8 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    singlePrecisionBounds(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -129,7 +141,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
   // Build the tree on the empty dataset, if necessary.
   if (mode != NAIVE_MODE)
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
   }
@@ -155,7 +167,8 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    singlePrecisionBounds(other.singlePrecisionBounds)
 {
   // Nothing else to do.
 }
@@ -179,7 +192,8 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    singlePrecisionBounds(other.singlePrecisionBounds)
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -233,6 +247,7 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  singlePrecisionBounds = other.singlePrecisionBounds;
 }
 
 // Move operator.
@@ -275,12 +290,13 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  singlePrecisionBounds = other.singlePrecisionBounds;
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
     delete other.referenceSet;
 
-  other.referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+  other.referenceTree = BuildTree<Tree>(std::move(MatType()),
       other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
@@ -334,6 +350,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   // We may need to rebuild the tree.
   if (searchMode != NAIVE_MODE)
   {
+    MLPACK_MEMORY_PHASE("reference_tree_building");
     referenceTree = BuildTree<Tree>(std::move(referenceSetIn),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
@@ -342,6 +359,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   {
     referenceSet = new MatType(std::move(referenceSetIn));
   }
+
+  // In NUMA mode, spread the points of the reference set over the memory of
+  // the sockets (the reference set is owned by this object).
+  util::FirstTouch(const_cast<MatType&>(*referenceSet));
 }
 
 template<typename SortPolicy,
@@ -371,6 +392,195 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+
+  // In NUMA mode, spread the points of the reference set over the memory of
+  // the sockets (the reference set is owned by this object).
+  util::FirstTouch(const_cast<MatType&>(*this->referenceSet));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(
+    const MatType& points,
+    const size_t maxLeafSize)
+{
+  if (points.n_elem == 0)
+    return;
+
+  if (referenceSet->n_cols > 0 && points.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Insert(): dimensionality of new points ("
+        << points.n_rows << ") does not match dimensionality of reference set ("
+        << referenceSet->n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // An empty tree has no dimensionality yet, so it is simpler to build it.
+  if (referenceSet->n_cols == 0)
+  {
+    Train(points);
+    return;
+  }
+
+  if (!referenceTree)
+  {
+    // In naive mode we own the reference set, so it can be modified.
+    MatType& dataset = const_cast<MatType&>(*referenceSet);
+    dataset.insert_cols(dataset.n_cols, points);
+    return;
+  }
+
+  InsertIntoTree(points, maxLeafSize, std::integral_constant<bool,
+      tree::TreeTraits<Tree>::RearrangesDataset>());
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertIntoTree(
+    const MatType& points,
+    const size_t /* maxLeafSize */,
+    const std::false_type& /* rearrangesDataset */)
+{
+  // The tree holds a pointer to the dataset, which we own.
+  MatType& dataset = const_cast<MatType&>(*referenceSet);
+  const size_t oldCols = dataset.n_cols;
+  dataset.insert_cols(oldCols, points);
+
+  for (size_t i = oldCols; i < dataset.n_cols; ++i)
+    referenceTree->InsertPoint(i);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertIntoTree(
+    const MatType& points,
+    const size_t maxLeafSize,
+    const std::true_type& /* rearrangesDataset */)
+{
+  // If the tree was given to us, the indices of the reference points are their
+  // positions in the tree; they must now be kept in the mapping, since the
+  // insertion moves the points.
+  if (oldFromNewReferences.empty())
+  {
+    oldFromNewReferences.resize(referenceSet->n_cols);
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      oldFromNewReferences[i] = i;
+  }
+
+  referenceTree->InsertPoints(points, oldFromNewReferences, maxLeafSize);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Remove(
+    const arma::Col<size_t>& indices)
+{
+  if (!referenceTree)
+  {
+    throw std::invalid_argument("NeighborSearch::Remove(): points cannot be "
+        "removed in naive mode");
+  }
+
+  RemoveFromTree(indices, std::integral_constant<bool,
+      tree::TreeTraits<Tree>::RearrangesDataset>());
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RemoveFromTree(
+    const arma::Col<size_t>& indices,
+    const std::false_type& /* rearrangesDataset */)
+{
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (!referenceTree->DeletePoint(indices[i]))
+    {
+      std::ostringstream oss;
+      oss << "NeighborSearch::Remove(): point " << indices[i] << " is not in "
+          << "the reference tree!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::RemoveFromTree(
+    const arma::Col<size_t>& indices,
+    const std::true_type& /* rearrangesDataset */)
+{
+  if (oldFromNewReferences.empty())
+  {
+    oldFromNewReferences.resize(referenceSet->n_cols);
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      oldFromNewReferences[i] = i;
+  }
+
+  // Find the positions of the points in the tree.  The points of the tree are
+  // the first NumDescendants() points of its dataset.
+  std::vector<size_t> newFromOld(oldFromNewReferences.size());
+  for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+    newFromOld[oldFromNewReferences[i]] = i;
+
+  arma::Col<size_t> positions(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= newFromOld.size() ||
+        newFromOld[indices[i]] >= referenceTree->NumDescendants())
+    {
+      std::ostringstream oss;
+      oss << "NeighborSearch::Remove(): point " << indices[i] << " is not in "
+          << "the reference tree!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    positions[i] = newFromOld[indices[i]];
+  }
+
+  referenceTree->RemovePoints(positions, oldFromNewReferences);
 }
 
 /**
@@ -392,17 +602,27 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  MLPACK_MEMORY_PHASE("neighbor_search");
+  if (k > NumReferencePoints())
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << NumReferencePoints() << ")";
     throw std::invalid_argument(ss.str());
   }
 
   baseCases = 0;
   scores = 0;
 
+  // The brute-force search computes the distances in tiles with matrix
+  // products, if the metric allows it.
+  if (searchMode == NAIVE_MODE && TiledBruteForceSearch<SortPolicy,
+      MetricType>(querySet, *referenceSet, k, false, neighbors, distances))
+  {
+    baseCases += querySet.n_cols * referenceSet->n_cols;
+    return;
+  }
+
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
 
@@ -453,12 +673,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      SingleTreeSearch(querySet.n_cols, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -474,15 +690,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     case DUAL_TREE_MODE:
     {
       // Build the query tree.
-      Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+      Tree* queryTree;
+      {
+        MLPACK_MEMORY_PHASE("query_tree_building");
+        queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+      }
 
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
+      DualTreeTraversal(*queryTree, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -502,12 +719,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
 
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      SingleTreeTraversal<tree::GreedySingleTreeTraverser<Tree, RuleType>>(
+          querySet.n_cols, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -598,11 +812,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::mat& distances,
     bool sameSet)
 {
-  if (k > referenceSet->n_cols)
+  if (k > NumReferencePoints())
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << NumReferencePoints() << ")";
     throw std::invalid_argument(ss.str());
   }
 
@@ -614,6 +828,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   baseCases = 0;
   scores = 0;
 
+  // The query tree may have been used for an earlier search.
+  ResetTree(queryTree);
+
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
 
@@ -631,9 +848,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  DualTreeTraversal(queryTree, rules);
 
   scores += rules.Scores();
   baseCases += rules.BaseCases();
@@ -677,18 +892,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  MLPACK_MEMORY_PHASE("neighbor_search");
+  if (k > NumReferencePoints())
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << NumReferencePoints() << ")";
     throw std::invalid_argument(ss.str());
   }
-  if (k == referenceSet->n_cols)
+  if (k == NumReferencePoints())
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is equal to the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ") and "
+        << "points in the reference set (" << NumReferencePoints() << ") and "
         << "no query set has been provided.";
     throw std::invalid_argument(ss.str());
   }
@@ -696,6 +912,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   baseCases = 0;
   scores = 0;
 
+  // The brute-force search computes the distances in tiles with matrix
+  // products, if the metric allows it.
+  if (searchMode == NAIVE_MODE && TiledBruteForceSearch<SortPolicy,
+      MetricType>(*referenceSet, *referenceSet, k, true, neighbors, distances))
+  {
+    baseCases += referenceSet->n_cols * referenceSet->n_cols;
+    return;
+  }
+
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
 
@@ -730,12 +955,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      SingleTreeSearch(referenceSet->n_cols, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -751,36 +972,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // The dual-tree monochromatic search case may require resetting the
       // bounds in the tree.
       if (treeNeedsReset)
-      {
-        std::stack<Tree*> nodes;
-        nodes.push(referenceTree);
-        while (!nodes.empty())
-        {
-          Tree* node = nodes.top();
-          nodes.pop();
-
-          // Reset bounds of this node.
-          node->Stat().Reset();
-
-          // Then add the children.
-          for (size_t i = 0; i < node->NumChildren(); ++i)
-            nodes.push(&node->Child(i));
-        }
-      }
-
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+        ResetTree(*referenceTree);
 
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
-        // non overlapping (tau = 0).
+        // non overlapping (tau = 0).  Its subtrees then hold disjoint sets of
+        // query points, so they can be traversed in parallel.
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeTraversal(queryTree, rules);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeTraversal(*referenceTree, rules);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
@@ -799,12 +1003,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      SingleTreeTraversal<tree::GreedySingleTreeTraverser<Tree, RuleType>>(
+          referenceSet->n_cols, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -832,9 +1033,14 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       const size_t refMapping = oldFromNewReferences[i];
       distances.col(refMapping) = distancePtr->col(i);
 
-      // Map each neighbor's index.
+      // Map each neighbor's index.  The points removed from the tree are not
+      // searched in dual-tree mode, so they have no neighbors to map.
       for (size_t j = 0; j < distances.n_rows; ++j)
-        neighbors(j, refMapping) = oldFromNewReferences[(*neighborPtr)(j, i)];
+      {
+        const size_t neighbor = (*neighborPtr)(j, i);
+        neighbors(j, refMapping) = (neighbor < oldFromNewReferences.size()) ?
+            oldFromNewReferences[neighbor] : neighbor;
+      }
     }
 
     // Finished with temporary matrices.
@@ -843,6 +1049,180 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+  // Split the query tree into several subtrees per thread, so that the dynamic
+  // schedule can balance the load when some subtrees are pruned much earlier
+  // than others.
+  std::vector<Tree*> frontier;
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+    tree::SubtreeFrontier(queryTree, 8 * numThreads, frontier);
+  #endif
+
+  if (frontier.size() <= 1)
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return;
+  }
+
+  size_t threadScores = 0;
+  size_t threadBaseCases = 0;
+
+  #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+  {
+    MetricType threadMetric(metric);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The subtrees are disjoint, so each thread's rules can insert directly
+      // into the candidate lists of the main rules object.
+      RuleType threadRules(rules, threadMetric);
+      DualTreeTraversalType<RuleType> traverser(threadRules);
+      traverser.Traverse(*frontier[i], *referenceTree);
+
+      threadScores += threadRules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+    }
+  }
+
+  rules.Scores() += threadScores;
+  rules.BaseCases() += threadBaseCases;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ResetTree(Tree& tree)
+{
+  std::stack<Tree*> nodes;
+  nodes.push(&tree);
+  while (!nodes.empty())
+  {
+    Tree* node = nodes.top();
+    nodes.pop();
+
+    // Reset bounds of this node.
+    node->Stat().Reset();
+
+    // Then add the children.
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push(&node->Child(i));
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TraverserType, typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+  // When the tree has self-children, the rules cache distances in the
+  // statistics of the reference nodes, so the queries must be run one at a
+  // time.
+  #ifdef HAS_OPENMP
+  if (!tree::TreeTraits<Tree>::HasSelfChildren && omp_get_max_threads() > 1)
+  {
+    size_t threadScores = 0;
+    size_t threadBaseCases = 0;
+
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      // Each thread visits its own query points, so its rules can insert
+      // directly into the candidate lists of the main rules object.
+      MetricType threadMetric(metric);
+      RuleType threadRules(rules, threadMetric);
+      TraverserType traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadScores += threadRules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+    return;
+  }
+  #endif
+
+  TraverserType traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeSearch(
+    const size_t numQueries,
+    RuleType& rules)
+{
+  typedef SingleTreeTraversalType<RuleType> TraverserType;
+
+  // Spill trees are traversed without scoring all the children of a node, so
+  // only trees of hyperrectangles that are not spill trees use the bounds.
+  if (!tree::IsHRectBound<typename tree::TreeBoundType<Tree>::type>::value ||
+      tree::IsSpillTree<Tree>::value)
+  {
+    SingleTreeTraversal<TraverserType>(numQueries, rules);
+    return;
+  }
+
+  if (singlePrecisionBounds)
+  {
+    const tree::ChildBounds<Tree, float> childBounds(*referenceTree);
+    rules.SetChildBounds(&childBounds);
+    SingleTreeTraversal<TraverserType>(numQueries, rules);
+    rules.SetChildBounds((const tree::ChildBounds<Tree, float>*) NULL);
+  }
+  else
+  {
+    const tree::ChildBounds<Tree> childBounds(*referenceTree);
+    rules.SetChildBounds(&childBounds);
+    SingleTreeTraversal<TraverserType>(numQueries, rules);
+    rules.SetChildBounds((const tree::ChildBounds<Tree>*) NULL);
+  }
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -14,12 +14,28 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/child_bounds.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 #include <queue>
 
 namespace mlpack {
 namespace neighbor {
 
+/**
+ * DirectLMetric<MetricType>::value is true if the distances of the given metric
+ * can be computed directly on the memory of the matrices by
+ * NeighborSearchRules::BaseCaseRange(); that is, for LMetric, except for the
+ * L-infinity metric, which is not a sum over the dimensions.
+ */
+template<typename MetricType>
+struct DirectLMetric : public std::false_type { };
+
+//! DirectLMetric specialization for LMetric.
+template<int Power, bool TakeRoot>
+struct DirectLMetric<metric::LMetric<Power, TakeRoot>> :
+    public std::integral_constant<bool, Power != INT_MAX> { };
+
 /**
  * The NeighborSearchRules class is a template helper class used by
  * NeighborSearch class when performing distance-based neighbor searches.  For
@@ -54,6 +70,20 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct a NeighborSearchRules object for one thread of a parallel
+   * traversal.  The new object has its own traversal information and
+   * statistics, but it inserts candidates directly into the candidate lists of
+   * the given rules object, so the results of every thread are available
+   * through other.GetResults() once all threads are finished.  Each thread
+   * must visit a set of query points that is disjoint from the sets of query
+   * points visited by every other thread.
+   *
+   * @param other Rules object whose candidate lists will be used.
+   * @param metric Instantiated metric for this thread.
+   */
+  NeighborSearchRules(NeighborSearchRules& other, MetricType& metric);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -73,6 +103,21 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between the query point and every reference point
+   * in [referenceBegin, referenceEnd), updating the candidates like
+   * BaseCase().  For LMetric distances on dense matrices, the distances are
+   * computed directly on the memory of the matrices, a few reference points at
+   * a time, which avoids the per-pair overhead of BaseCase().
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of first reference point.
+   * @param referenceEnd Index one past the last reference point.
+   */
+  void BaseCaseRange(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceEnd);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -83,6 +128,36 @@ class NeighborSearchRules
    */
   double Score(const size_t queryIndex, TreeType& referenceNode);
 
+  /**
+   * Get the scores of all the children of the given reference node, as
+   * Score() would give for each child.  If the bounds of the children of the
+   * node were given with SetChildBounds(), the distances to all the children
+   * are computed in one pass over their bounds.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Node whose children are scored.
+   * @param childScores Output scores (one per child, in the order of Child()).
+   */
+  void ScoreChildren(const size_t queryIndex,
+                     TreeType& referenceNode,
+                     arma::vec& childScores);
+
+  //! Use the given bounds of the children of the reference nodes in
+  //! ScoreChildren() (or none, if NULL).  The object must outlive the search.
+  void SetChildBounds(const tree::ChildBounds<TreeType>* bounds)
+  {
+    childBounds = bounds;
+    floatChildBounds = NULL;
+  }
+
+  //! Use the given single-precision bounds of the children of the reference
+  //! nodes in ScoreChildren() (or none, if NULL).
+  void SetChildBounds(const tree::ChildBounds<TreeType, float>* bounds)
+  {
+    childBounds = NULL;
+    floatChildBounds = bounds;
+  }
+
   /**
    * Get the child node with the best score.
    *
@@ -183,8 +258,12 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
+  //! Candidate lists owned by this object.  This is empty if the object was
+  //! constructed for a thread of a parallel traversal.
+  std::vector<CandidateList> candidateStorage;
+
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -214,11 +293,36 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! The bounds of the children of the reference nodes, if given.
+  const tree::ChildBounds<TreeType>* childBounds;
+  //! The single-precision bounds of the children of the reference nodes, if
+  //! given.
+  const tree::ChildBounds<TreeType, float>* floatChildBounds;
+
+  //! Score each bound of the given set of bounds of the children of a node.
+  template<typename BoundSetType>
+  void ScoreBounds(const size_t queryIndex,
+                   const BoundSetType& bounds,
+                   arma::vec& childScores);
+
   /**
    * Recalculate the bound for a given query node.
    */
   double CalculateBound(TreeType& queryNode) const;
 
+  //! Compute the base cases of a range one at a time with BaseCase().
+  void BaseCaseRangeImpl(const size_t queryIndex,
+                         const size_t referenceBegin,
+                         const size_t referenceEnd,
+                         const std::false_type& /* directLMetric */);
+
+  //! Compute the base cases of a range directly on the matrix memory (for
+  //! LMetric distances and dense matrices).
+  void BaseCaseRangeImpl(const size_t queryIndex,
+                         const size_t referenceBegin,
+                         const size_t referenceEnd,
+                         const std::true_type& /* directLMetric */);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -29,6 +29,7 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -36,7 +37,9 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    childBounds(NULL),
+    floatChildBounds(NULL)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
@@ -59,6 +62,30 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules& other,
+    MetricType& metric) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0),
+    childBounds(other.childBounds),
+    floatChildBounds(other.floatChildBounds)
+{
+  // As in the other constructor, the last query and reference node pointers
+  // must be invalid but not NULL.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -107,6 +134,107 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+BaseCaseRange(const size_t queryIndex,
+              const size_t referenceBegin,
+              const size_t referenceEnd)
+{
+  typedef typename TreeType::Mat MatType;
+  typedef typename MatType::elem_type ElemType;
+
+  // Sparse matrices can't be accessed directly.
+  const bool directLMetric = DirectLMetric<MetricType>::value &&
+      std::is_same<MatType, arma::Mat<ElemType>>::value;
+
+  BaseCaseRangeImpl(queryIndex, referenceBegin, referenceEnd,
+      std::integral_constant<bool, directLMetric>());
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+BaseCaseRangeImpl(const size_t queryIndex,
+                  const size_t referenceBegin,
+                  const size_t referenceEnd,
+                  const std::false_type& /* directLMetric */)
+{
+  for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+    BaseCase(queryIndex, ref);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+BaseCaseRangeImpl(const size_t queryIndex,
+                  const size_t referenceBegin,
+                  const size_t referenceEnd,
+                  const std::true_type& /* directLMetric */)
+{
+  typedef typename TreeType::Mat::elem_type ElemType;
+  const int power = MetricType::Power;
+  const size_t dim = querySet.n_rows;
+  const ElemType* query = querySet.colptr(queryIndex);
+
+  // Each block of reference points is contiguous in memory.  The sums for the
+  // points of a block are independent of each other, so the compiler can
+  // interleave (or vectorize) them.
+  const size_t blockSize = 4;
+  ElemType sums[blockSize];
+  for (size_t blockBegin = referenceBegin; blockBegin < referenceEnd;
+       blockBegin += blockSize)
+  {
+    const size_t numPoints = std::min(blockSize, referenceEnd - blockBegin);
+    const ElemType* reference = referenceSet.colptr(blockBegin);
+
+    for (size_t j = 0; j < blockSize; ++j)
+      sums[j] = 0;
+
+    if (numPoints == blockSize)
+    {
+      for (size_t i = 0; i < dim; ++i)
+      {
+        for (size_t j = 0; j < blockSize; ++j)
+        {
+          const ElemType diff = query[i] - reference[j * dim + i];
+          sums[j] += (power == 1) ? std::abs(diff) : (power == 2) ?
+              diff * diff : (ElemType) std::pow(std::abs(diff), power);
+        }
+      }
+    }
+    else
+    {
+      for (size_t j = 0; j < numPoints; ++j)
+      {
+        for (size_t i = 0; i < dim; ++i)
+        {
+          const ElemType diff = query[i] - reference[j * dim + i];
+          sums[j] += (power == 1) ? std::abs(diff) : (power == 2) ?
+              diff * diff : (ElemType) std::pow(std::abs(diff), power);
+        }
+      }
+    }
+
+    for (size_t j = 0; j < numPoints; ++j)
+    {
+      const size_t referenceIndex = blockBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      double distance = sums[j];
+      if (MetricType::TakeRoot && (power == 2))
+        distance = std::sqrt(distance);
+      else if (MetricType::TakeRoot && (power != 1))
+        distance = std::pow(distance, 1.0 / power);
+
+      ++baseCases;
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceIndex;
+      lastBaseCase = distance;
+    }
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -150,6 +278,61 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
       SortPolicy::ConvertToScore(distance) : DBL_MAX;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+ScoreChildren(const size_t queryIndex,
+              TreeType& referenceNode,
+              arma::vec& childScores)
+{
+  if (childBounds != NULL)
+  {
+    const typename tree::ChildBounds<TreeType>::SetType* bounds =
+        childBounds->Children(referenceNode);
+    if (bounds != NULL)
+    {
+      ScoreBounds(queryIndex, *bounds, childScores);
+      return;
+    }
+  }
+  else if (floatChildBounds != NULL)
+  {
+    const typename tree::ChildBounds<TreeType, float>::SetType* bounds =
+        floatChildBounds->Children(referenceNode);
+    if (bounds != NULL)
+    {
+      ScoreBounds(queryIndex, *bounds, childScores);
+      return;
+    }
+  }
+
+  // Without the bounds of the children, score them one at a time.
+  childScores.set_size(referenceNode.NumChildren());
+  for (size_t i = 0; i < childScores.n_elem; ++i)
+    childScores[i] = Score(queryIndex, referenceNode.Child(i));
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename BoundSetType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::ScoreBounds(
+    const size_t queryIndex,
+    const BoundSetType& bounds,
+    arma::vec& childScores)
+{
+  scores += bounds.Size(); // Count number of Score() calls.
+  SortPolicy::BestPointToBoundsDistances(querySet.col(queryIndex), bounds,
+      childScores);
+
+  // Compare against the best k'th distance for this query point so far.
+  double bestDistance = candidates[queryIndex].top().first;
+  bestDistance = SortPolicy::Relax(bestDistance, epsilon);
+
+  for (size_t i = 0; i < childScores.n_elem; ++i)
+  {
+    childScores[i] = SortPolicy::IsBetter(childScores[i], bestDistance) ?
+        SortPolicy::ConvertToScore(childScores[i]) : DBL_MAX;
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::
 GetBestChild(const size_t queryIndex, TreeType& referenceNode)
@@ -0,0 +1,257 @@
+/**
+ * @file methods/neighbor_search/ns_auto_tuner.hpp
+ *
+ * An auto-tuner that picks the tree type, leaf size, search mode and
+ * approximation level of an NSModel for a given dataset, by benchmarking
+ * candidate configurations on samples of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTO_TUNER_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTO_TUNER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+#include <cereal/types/map.hpp>
+#include "ns_model.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NSAutoTuner class chooses the configuration of an NSModel (the tree type,
+ * the leaf size, the search mode and epsilon) that is expected to be fastest
+ * for a given search, among a list of candidate configurations.  Each
+ * candidate is benchmarked on a random sample of the reference set and a
+ * random sample of the query set:
+ *
+ *  - the model is built and searched on the whole reference sample, and on a
+ *    quarter of it, and the times of both are measured;
+ *  - the growth of the traversal work (the visited nodes and the base cases,
+ *    from tree::TraversalStatistics) between the two sample sizes gives the
+ *    exponent of the search cost in the number of reference points, which is
+ *    used to extrapolate the search time to the full reference set (the build
+ *    time is extrapolated as O(n log n), and the search time is linear in the
+ *    number of queries);
+ *  - the recall of the search on the sample (the fraction of the returned
+ *    neighbors that are at least as good as the true k'th neighbor) is found
+ *    by comparing with a naive search.
+ *
+ * The candidate with the lowest estimated cost whose recall reaches
+ * MinRecall() is chosen.  With the default MinRecall() of 1, the approximate
+ * candidates (with a positive epsilon, the greedy search, spill trees and HNSW
+ * graphs) are not benchmarked at all, since their full recall on the sample
+ * would not guarantee exact results.  If the reference set is not larger than
+ * the sample, the candidates are benchmarked on the full reference set, and
+ * only the query time is extrapolated.
+ *
+ * The chosen configurations are cached, keyed by a fingerprint of the search
+ * (the sizes of the sets, k, MinRecall(), and a sample of the values of the
+ * reference set), so tuning the same search again returns the cached
+ * configuration without benchmarking.  The tuner can be serialized to keep the
+ * cache.  For example:
+ *
+ * @code
+ * NSAutoTuner<NearestNeighborSort> tuner(0.95);
+ * const NSAutoTuner<NearestNeighborSort>::Configuration& c =
+ *     tuner.Tune(referenceSet, querySet, 5);
+ *
+ * KNNModel model(c.treeType);
+ * model.LeafSize() = c.leafSize;
+ * model.BuildModel(timers, std::move(referenceSet), c.searchMode, c.epsilon);
+ * model.Search(timers, std::move(querySet), 5, neighbors, distances);
+ * @endcode
+ *
+ * The benchmarks use tree::TraversalStatistics, so another TraversalStatistics
+ * object that is recording when Tune() is called is stopped.
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ */
+template<typename SortPolicy>
+class NSAutoTuner
+{
+ public:
+  //! The type of model that is tuned.
+  typedef NSModel<SortPolicy> ModelType;
+  //! The tree types of the model.
+  typedef typename ModelType::TreeTypes TreeTypes;
+
+  //! A configuration of the model, with its benchmark results.
+  struct Configuration
+  {
+    //! Create the configuration with the given parameters.
+    Configuration(const TreeTypes treeType = ModelType::KD_TREE,
+                  const size_t leafSize = 20,
+                  const NeighborSearchMode searchMode = DUAL_TREE_MODE,
+                  const double epsilon = 0.0) :
+        treeType(treeType),
+        leafSize(leafSize),
+        searchMode(searchMode),
+        epsilon(epsilon),
+        cost(0.0),
+        recall(0.0)
+    { }
+
+    //! The type of tree.
+    TreeTypes treeType;
+    //! The leaf size of the trees.
+    size_t leafSize;
+    //! The search mode.
+    NeighborSearchMode searchMode;
+    //! The relative error of the search.
+    double epsilon;
+    //! The estimated time of the full search (with the build), in seconds.
+    double cost;
+    //! The recall of the search on the sample.
+    double recall;
+
+    //! Serialize the configuration.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(treeType));
+      ar(CEREAL_NVP(leafSize));
+      ar(CEREAL_NVP(searchMode));
+      ar(CEREAL_NVP(epsilon));
+      ar(CEREAL_NVP(cost));
+      ar(CEREAL_NVP(recall));
+    }
+  };
+
+  /**
+   * Create the tuner with the default candidate configurations: kd-trees, ball
+   * trees, vantage point trees and random projection trees with leaf sizes 5,
+   * 20 and 80, and cover trees, all in single-tree and dual-tree mode; the
+   * naive search; and the approximate greedy search, dual-tree searches with
+   * epsilon 0.1 and 0.5, and (for nearest neighbor search) an HNSW graph.
+   *
+   * @param minRecall Minimum recall of the chosen configuration, in (0, 1].
+   * @param referenceSampleSize Number of reference points to benchmark on.
+   * @param querySampleSize Number of query points to benchmark on.
+   */
+  NSAutoTuner(const double minRecall = 1.0,
+              const size_t referenceSampleSize = 2000,
+              const size_t querySampleSize = 200);
+
+  /**
+   * Choose the configuration for searching the k neighbors of the points of
+   * the given query set in the given reference set.  The configuration is
+   * taken from the cache if the search was already tuned.
+   *
+   * @param referenceSet Set of reference points.
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @return The chosen configuration, with its estimated cost and its recall.
+   */
+  const Configuration& Tune(const arma::mat& referenceSet,
+                            const arma::mat& querySet,
+                            const size_t k);
+
+  /**
+   * Choose the configuration for searching the k neighbors of each point of
+   * the given reference set (monochromatic search).
+   *
+   * @param referenceSet Set of reference points.
+   * @param k Number of neighbors to search for.
+   * @return The chosen configuration, with its estimated cost and its recall.
+   */
+  const Configuration& Tune(const arma::mat& referenceSet, const size_t k);
+
+  /**
+   * Compute the fingerprint that the cache uses for the given search.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numQueries Number of query points, or 0 for monochromatic search.
+   * @param k Number of neighbors to search for.
+   */
+  size_t Fingerprint(const arma::mat& referenceSet,
+                     const size_t numQueries,
+                     const size_t k) const;
+
+  //! Get the minimum recall of the chosen configuration.
+  double MinRecall() const { return minRecall; }
+  //! Modify the minimum recall of the chosen configuration.
+  double& MinRecall() { return minRecall; }
+
+  //! Get the number of reference points to benchmark on.
+  size_t ReferenceSampleSize() const { return referenceSampleSize; }
+  //! Modify the number of reference points to benchmark on.
+  size_t& ReferenceSampleSize() { return referenceSampleSize; }
+
+  //! Get the number of query points to benchmark on.
+  size_t QuerySampleSize() const { return querySampleSize; }
+  //! Modify the number of query points to benchmark on.
+  size_t& QuerySampleSize() { return querySampleSize; }
+
+  //! Get the candidate configurations.
+  const std::vector<Configuration>& Candidates() const { return candidates; }
+  //! Modify the candidate configurations.  (The cache should be cleared if
+  //! they change.)
+  std::vector<Configuration>& Candidates() { return candidates; }
+
+  //! Get the candidates benchmarked by the last tuning, with their results.
+  const std::vector<Configuration>& Results() const { return results; }
+
+  //! Get the cached configurations, keyed by fingerprint.
+  const std::map<size_t, Configuration>& Cache() const { return cache; }
+  //! Modify the cached configurations, keyed by fingerprint.
+  std::map<size_t, Configuration>& Cache() { return cache; }
+
+  //! Serialize the tuner.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Choose the configuration for the given search, for either Tune().
+  const Configuration& TuneSearch(const arma::mat& referenceSet,
+                                  const arma::mat& querySet,
+                                  const size_t k,
+                                  const bool monochromatic);
+
+  /**
+   * Build the model of the given configuration on the given reference set and
+   * search the given query set with it, measuring the times and the traversal
+   * work of both.
+   */
+  static void Measure(const Configuration& configuration,
+                      const arma::mat& referenceSet,
+                      const arma::mat& querySet,
+                      const size_t k,
+                      arma::mat& distances,
+                      double& buildTime,
+                      double& searchTime,
+                      double& work);
+
+  //! Return whether the given configuration always gives exact results.
+  static bool IsExact(const Configuration& configuration);
+
+  //! Compute the fraction of the found neighbors that are at least as good as
+  //! the true k'th neighbor.
+  static double Recall(const arma::mat& distances,
+                       const arma::mat& trueDistances);
+
+  //! The minimum recall of the chosen configuration.
+  double minRecall;
+  //! The number of reference points to benchmark on.
+  size_t referenceSampleSize;
+  //! The number of query points to benchmark on.
+  size_t querySampleSize;
+
+  //! The candidate configurations.
+  std::vector<Configuration> candidates;
+  //! The candidates benchmarked by the last tuning, with their results.
+  std::vector<Configuration> results;
+  //! The chosen configurations, keyed by fingerprint.
+  std::map<size_t, Configuration> cache;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ns_auto_tuner_impl.hpp"
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * @file methods/neighbor_search/ns_auto_tuner_impl.hpp
+ *
+ * Implementation of the NSAutoTuner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTO_TUNER_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTO_TUNER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ns_auto_tuner.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy>
+NSAutoTuner<SortPolicy>::NSAutoTuner(const double minRecall,
+                                     const size_t referenceSampleSize,
+                                     const size_t querySampleSize) :
+    minRecall(minRecall),
+    referenceSampleSize(referenceSampleSize),
+    querySampleSize(querySampleSize)
+{
+  if (minRecall <= 0.0 || minRecall > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "NSAutoTuner::NSAutoTuner(): the minimum recall must be in (0, 1] "
+        << "(given " << minRecall << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (referenceSampleSize == 0 || querySampleSize == 0)
+  {
+    throw std::invalid_argument("NSAutoTuner::NSAutoTuner(): the sample sizes "
+        "must be positive!");
+  }
+
+  // The exact tree searches.
+  const TreeTypes treeTypes[] = { ModelType::KD_TREE, ModelType::BALL_TREE,
+      ModelType::VP_TREE, ModelType::RP_TREE };
+  const size_t leafSizes[] = { 5, 20, 80 };
+  const NeighborSearchMode searchModes[] = { SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (const TreeTypes treeType : treeTypes)
+    for (const size_t leafSize : leafSizes)
+      for (const NeighborSearchMode searchMode : searchModes)
+        candidates.push_back(Configuration(treeType, leafSize, searchMode));
+
+  // Cover trees have no leaf size.
+  for (const NeighborSearchMode searchMode : searchModes)
+    candidates.push_back(Configuration(ModelType::COVER_TREE, 20, searchMode));
+
+  candidates.push_back(Configuration(ModelType::KD_TREE, 20, NAIVE_MODE));
+
+  // The approximate searches.
+  candidates.push_back(Configuration(ModelType::KD_TREE, 20,
+      GREEDY_SINGLE_TREE_MODE));
+  candidates.push_back(Configuration(ModelType::KD_TREE, 20, DUAL_TREE_MODE,
+      0.1));
+  candidates.push_back(Configuration(ModelType::KD_TREE, 20, DUAL_TREE_MODE,
+      0.5));
+  if (std::is_same<SortPolicy, NearestNeighborSort>::value)
+    candidates.push_back(Configuration(ModelType::HNSW, 20, DUAL_TREE_MODE));
+}
+
+template<typename SortPolicy>
+const typename NSAutoTuner<SortPolicy>::Configuration&
+NSAutoTuner<SortPolicy>::Tune(const arma::mat& referenceSet,
+                              const arma::mat& querySet,
+                              const size_t k)
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NSAutoTuner::Tune(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_cols == 0)
+  {
+    throw std::invalid_argument("NSAutoTuner::Tune(): the query set is "
+        "empty!");
+  }
+
+  if (k == 0 || k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NSAutoTuner::Tune(): k must be between 1 and the number of points "
+        << "in the reference set (" << referenceSet.n_cols << "); given "
+        << k << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return TuneSearch(referenceSet, querySet, k, false);
+}
+
+template<typename SortPolicy>
+const typename NSAutoTuner<SortPolicy>::Configuration&
+NSAutoTuner<SortPolicy>::Tune(const arma::mat& referenceSet, const size_t k)
+{
+  if (k == 0 || k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NSAutoTuner::Tune(): k must be between 1 and the number of points "
+        << "in the reference set minus one (" << referenceSet.n_cols - 1
+        << ") for monochromatic search; given " << k << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return TuneSearch(referenceSet, referenceSet, k, true);
+}
+
+template<typename SortPolicy>
+size_t NSAutoTuner<SortPolicy>::Fingerprint(const arma::mat& referenceSet,
+                                            const size_t numQueries,
+                                            const size_t k) const
+{
+  // This is the 64-bit FNV-1a hash of the search parameters and of (at most)
+  // 64 evenly spaced values of the reference set.
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](const void* data, const size_t bytes)
+  {
+    const unsigned char* bytePointer = (const unsigned char*) data;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+      hash ^= bytePointer[i];
+      hash *= 1099511628211ULL;
+    }
+  };
+
+  const uint64_t sizes[] = { (uint64_t) referenceSet.n_rows,
+      (uint64_t) referenceSet.n_cols, (uint64_t) numQueries, (uint64_t) k };
+  mix(sizes, sizeof(sizes));
+  mix(&minRecall, sizeof(double));
+
+  const size_t numValues = std::min((size_t) referenceSet.n_elem, (size_t) 64);
+  for (size_t i = 0; i < numValues; ++i)
+  {
+    const double value = referenceSet[i * referenceSet.n_elem / numValues];
+    mix(&value, sizeof(double));
+  }
+
+  return (size_t) hash;
+}
+
+template<typename SortPolicy>
+const typename NSAutoTuner<SortPolicy>::Configuration&
+NSAutoTuner<SortPolicy>::TuneSearch(const arma::mat& referenceSet,
+                                    const arma::mat& querySet,
+                                    const size_t k,
+                                    const bool monochromatic)
+{
+  if (candidates.empty())
+  {
+    throw std::invalid_argument("NSAutoTuner::Tune(): there are no candidate "
+        "configurations!");
+  }
+
+  const size_t numQueries = querySet.n_cols;
+  const size_t fingerprint = Fingerprint(referenceSet,
+      monochromatic ? 0 : numQueries, k);
+  typename std::map<size_t, Configuration>::const_iterator it =
+      cache.find(fingerprint);
+  if (it != cache.end())
+  {
+    Log::Info << "Using the cached configuration of the search." << std::endl;
+    return it->second;
+  }
+
+  // The reference sample holds at least 4k points, so that the quarter sample
+  // has at least k points.
+  const size_t n = referenceSet.n_cols;
+  const size_t sampleSize = std::min(n, std::max(referenceSampleSize, 4 * k));
+  const size_t smallSampleSize = sampleSize / 4;
+  const bool extrapolate = (sampleSize < n);
+
+  const arma::mat referenceSample = extrapolate ?
+      arma::mat(referenceSet.cols(arma::randperm(n, sampleSize))) :
+      referenceSet;
+  const arma::mat smallReferenceSample = extrapolate ?
+      arma::mat(referenceSample.cols(0, smallSampleSize - 1)) : arma::mat();
+  const size_t numSampleQueries = std::min(numQueries, querySampleSize);
+  const arma::mat querySample =
+      querySet.cols(arma::randperm(numQueries, numSampleQueries));
+
+  // The true neighbors of the sample come from a naive search.
+  arma::mat trueDistances;
+  double buildTime, searchTime, work;
+  Measure(Configuration(ModelType::KD_TREE, 20, NAIVE_MODE), referenceSample,
+      querySample, k, trueDistances, buildTime, searchTime, work);
+
+  const double scale = double(n) / double(sampleSize);
+  const double queryScale = double(numQueries) / double(numSampleQueries);
+  results.clear();
+  for (size_t c = 0; c < candidates.size(); ++c)
+    if (minRecall < 1.0 || IsExact(candidates[c]))
+      results.push_back(candidates[c]);
+
+  size_t best = results.size();
+  for (size_t c = 0; c < results.size(); ++c)
+  {
+    Configuration& configuration = results[c];
+    arma::mat distances;
+    Measure(configuration, referenceSample, querySample, k, distances,
+        buildTime, searchTime, work);
+    configuration.recall = Recall(distances, trueDistances);
+
+    double exponent = 1.0;
+    if (extrapolate)
+    {
+      // The growth of the work between the two sample sizes gives the
+      // exponent of the search cost; if the search does not use the traversers
+      // (like the naive search), the growth of the time is used instead.
+      double smallBuildTime, smallSearchTime, smallWork;
+      Measure(configuration, smallReferenceSample, querySample, k, distances,
+          smallBuildTime, smallSearchTime, smallWork);
+
+      const double sizeRatio = std::log(double(sampleSize) /
+          double(smallSampleSize));
+      if (work > 0.0 && smallWork > 0.0)
+        exponent = std::log(work / smallWork) / sizeRatio;
+      else if (searchTime > 0.0 && smallSearchTime > 0.0)
+        exponent = std::log(searchTime / smallSearchTime) / sizeRatio;
+      exponent = std::min(std::max(exponent, 0.0), 1.0);
+    }
+
+    const double buildScale = scale * std::log(std::max(double(n), 2.0)) /
+        std::log(std::max(double(sampleSize), 2.0));
+    configuration.cost = buildTime * buildScale +
+        searchTime * queryScale * std::pow(scale, exponent);
+
+    Log::Info << "Configuration " << c << ": estimated cost "
+        << configuration.cost << "s, recall " << configuration.recall << "."
+        << std::endl;
+
+    if (configuration.recall >= minRecall &&
+        (best == results.size() || configuration.cost < results[best].cost))
+      best = c;
+  }
+
+  if (best == results.size())
+  {
+    throw std::invalid_argument("NSAutoTuner::Tune(): no candidate "
+        "configuration reaches the minimum recall!");
+  }
+
+  Log::Info << "Chose configuration " << best << "." << std::endl;
+  return cache[fingerprint] = results[best];
+}
+
+template<typename SortPolicy>
+void NSAutoTuner<SortPolicy>::Measure(const Configuration& configuration,
+                                      const arma::mat& referenceSet,
+                                      const arma::mat& querySet,
+                                      const size_t k,
+                                      arma::mat& distances,
+                                      double& buildTime,
+                                      double& searchTime,
+                                      double& work)
+{
+  ModelType model(configuration.treeType);
+  model.LeafSize() = configuration.leafSize;
+
+  util::Timers timers;
+  arma::wall_clock clock;
+  arma::mat referenceCopy(referenceSet);
+  clock.tic();
+  model.BuildModel(timers, std::move(referenceCopy), configuration.searchMode,
+      configuration.epsilon);
+  buildTime = clock.toc();
+
+  tree::TraversalStatistics statistics;
+  arma::Mat<size_t> neighbors;
+  arma::mat queryCopy(querySet);
+  statistics.Start();
+  clock.tic();
+  model.Search(timers, std::move(queryCopy), k, neighbors, distances);
+  searchTime = clock.toc();
+  statistics.Stop();
+
+  work = double(statistics.NumVisited() + statistics.NumBaseCases());
+}
+
+template<typename SortPolicy>
+bool NSAutoTuner<SortPolicy>::IsExact(const Configuration& configuration)
+{
+  return configuration.epsilon == 0.0 &&
+      configuration.searchMode != GREEDY_SINGLE_TREE_MODE &&
+      configuration.treeType != ModelType::SPILL_TREE &&
+      configuration.treeType != ModelType::HNSW;
+}
+
+template<typename SortPolicy>
+double NSAutoTuner<SortPolicy>::Recall(const arma::mat& distances,
+                                       const arma::mat& trueDistances)
+{
+  // A neighbor is correct if it is at least as good as the true k'th neighbor
+  // (up to rounding errors), so ties are not counted as errors.
+  const size_t k = trueDistances.n_rows;
+  size_t found = 0;
+  for (size_t i = 0; i < distances.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (SortPolicy::IsBetter(SortPolicy::Relax(distances(j, i), 1e-10),
+          trueDistances(k - 1, i)))
+        ++found;
+    }
+  }
+
+  return double(found) / double(distances.n_elem);
+}
+
+template<typename SortPolicy>
+template<typename Archive>
+void NSAutoTuner<SortPolicy>::serialize(Archive& ar,
+                                        const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(minRecall));
+  ar(CEREAL_NVP(referenceSampleSize));
+  ar(CEREAL_NVP(querySampleSize));
+  ar(CEREAL_NVP(candidates));
+  ar(CEREAL_NVP(cache));
+
+  if (cereal::is_loading<Archive>())
+    results.clear();
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
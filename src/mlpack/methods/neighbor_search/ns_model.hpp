@@ -21,11 +21,52 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/spill_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/prepared_queries.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
 #include "neighbor_search.hpp"
 
 namespace mlpack {
 namespace neighbor {
 
+/**
+ * SupportsPointUpdates tells whether NeighborSearch::Insert() and
+ * NeighborSearch::Remove() can be used with the given tree type: this is true
+ * for the RectangleTree family and for the BinarySpaceTree family (except the
+ * UB tree, whose split cannot split a node on its own).
+ */
+template<typename TreeType>
+struct SupportsPointUpdates
+{
+  static const bool value = false;
+};
+
+// Specialization for BinarySpaceTree.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+struct SupportsPointUpdates<tree::BinarySpaceTree<MetricType, StatisticType,
+    MatType, BoundType, SplitType>>
+{
+  static const bool value =
+      tree::SplitTraits<SplitType<BoundType<MetricType>, MatType>>::LocalSplits;
+};
+
+// Specialization for RectangleTree.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+struct SupportsPointUpdates<tree::RectangleTree<MetricType, StatisticType,
+    MatType, SplitType, DescentType, AuxiliaryInformationType>>
+{
+  static const bool value = true;
+};
+
 /**
  * NSWrapperBase is a base wrapper class for holding all NeighborSearch types
  * supported by NSModel.  All NeighborSearch type wrappers inherit from this
@@ -82,6 +123,30 @@ class NSWrapperBase
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances) = 0;
+
+  //! Prepare the given query set for several bichromatic searches, building
+  //! the query tree if the search mode uses one.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t leafSize,
+                                                const double rho) = 0;
+
+  //! Perform bichromatic neighbor search with queries prepared by a wrapper of
+  //! the same type.
+  virtual void Search(util::Timers& timers,
+                      tree::PreparedQueries& queries,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances) = 0;
+
+  //! Add the given points to the reference set, without rebuilding the tree.
+  virtual void Insert(util::Timers& timers,
+                      const arma::mat& points,
+                      const size_t leafSize) = 0;
+
+  //! Remove the given points from the tree, without rebuilding it.
+  virtual void Remove(util::Timers& timers,
+                      const arma::Col<size_t>& indices) = 0;
 };
 
 /**
@@ -156,6 +221,32 @@ class NSWrapper : public NSWrapperBase
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances);
 
+  //! Prepare the given query set for several bichromatic searches.  For
+  //! NSWrapper, we ignore the extra parameters.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t /* leafSize */,
+                                                const double /* rho */);
+
+  //! Perform bichromatic neighbor search with prepared queries.  In dual-tree
+  //! mode, the queries must hold a query tree of this type.
+  virtual void Search(util::Timers& timers,
+                      tree::PreparedQueries& queries,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  //! Add the given points to the reference set, without rebuilding the tree.
+  //! An exception is thrown if the tree type does not support it.
+  virtual void Insert(util::Timers& timers,
+                      const arma::mat& points,
+                      const size_t leafSize);
+
+  //! Remove the given points from the tree, without rebuilding it.  An
+  //! exception is thrown if the tree type does not support it.
+  virtual void Remove(util::Timers& timers,
+                      const arma::Col<size_t>& indices);
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -174,6 +265,23 @@ class NSWrapper : public NSWrapperBase
 
   //! The instantiated NeighborSearch object that we are wrapping.
   NSType ns;
+
+ private:
+  //! Insert the given points, if the tree type supports it.
+  void InsertImpl(const arma::mat& points,
+                  const size_t leafSize,
+                  const std::true_type& /* supported */);
+  //! Throw an exception: the tree type does not support insertion.
+  void InsertImpl(const arma::mat& points,
+                  const size_t leafSize,
+                  const std::false_type& /* supported */);
+
+  //! Remove the given points, if the tree type supports it.
+  void RemoveImpl(const arma::Col<size_t>& indices,
+                  const std::true_type& /* supported */);
+  //! Throw an exception: the tree type does not support removal.
+  void RemoveImpl(const arma::Col<size_t>& indices,
+                  const std::false_type& /* supported */);
 };
 
 /**
@@ -239,6 +347,13 @@ class LeafSizeNSWrapper :
                       const size_t leafSize,
                       const double /* rho */);
 
+  //! Prepare the given query set for several bichromatic searches.  This
+  //! overload uses the leaf size, but ignores the other parameters.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t leafSize,
+                                                const double /* rho */);
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -310,6 +425,13 @@ class SpillNSWrapper :
                       const size_t leafSize,
                       const double rho);
 
+  //! Prepare the given query set for several bichromatic searches using the
+  //! given parameters.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t leafSize,
+                                                const double rho);
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -329,6 +451,119 @@ class SpillNSWrapper :
                    arma::mat>::template DefeatistSingleTreeTraverser>::ns;
 };
 
+/**
+ * The HNSWNSWrapper class wraps an HNSWSearch graph index instead of a
+ * NeighborSearch object.  The search is always approximate, so the search mode
+ * and epsilon are kept for the interface but ignored; the approximation is
+ * controlled by the size of the search list, Ef().  Only nearest neighbor
+ * search is supported.
+ */
+template<typename SortPolicy>
+class HNSWNSWrapper : public NSWrapperBase
+{
+ public:
+  //! Construct the HNSWNSWrapper with the given graph parameters.
+  HNSWNSWrapper(const NeighborSearchMode searchMode,
+                const double epsilon,
+                const size_t maxConnections,
+                const size_t efConstruction,
+                const size_t ef) :
+      searchMode(searchMode),
+      epsilon(epsilon),
+      hnsw(maxConnections, efConstruction, ef)
+  {
+    // Nothing else to do.
+  }
+
+  //! Destruct the HNSWNSWrapper.
+  virtual ~HNSWNSWrapper() { }
+
+  //! Return a copy of the HNSWNSWrapper.
+  virtual HNSWNSWrapper* Clone() const { return new HNSWNSWrapper(*this); }
+
+  //! Get a reference to the reference set.
+  const arma::mat& Dataset() const { return hnsw.ReferenceSet(); }
+
+  //! Get the search mode (ignored).
+  NeighborSearchMode SearchMode() const { return searchMode; }
+  //! Modify the search mode (ignored).
+  NeighborSearchMode& SearchMode() { return searchMode; }
+
+  //! Get epsilon (ignored).
+  double Epsilon() const { return epsilon; }
+  //! Modify epsilon (ignored).
+  double& Epsilon() { return epsilon; }
+
+  //! Get the size of the list of closest points explored by a search.
+  size_t Ef() const { return hnsw.Ef(); }
+  //! Modify the size of the list of closest points explored by a search.
+  size_t& Ef() { return hnsw.Ef(); }
+
+  //! Build the graph.  The extra parameters are ignored.
+  virtual void Train(util::Timers& timers,
+                     arma::mat&& referenceSet,
+                     const size_t /* leafSize */,
+                     const double /* tau */,
+                     const double /* rho */);
+
+  //! Perform bichromatic search (i.e. search with a different query set).  The
+  //! extra parameters are ignored.
+  virtual void Search(util::Timers& timers,
+                      arma::mat&& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const size_t /* leafSize */,
+                      const double /* rho */);
+
+  //! Perform monochromatic search (i.e. use the reference set as the query
+  //! set).
+  virtual void Search(util::Timers& timers,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  //! Prepare the given query set for several bichromatic searches (no tree is
+  //! built).  The extra parameters are ignored.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t /* leafSize */,
+                                                const double /* rho */);
+
+  //! Perform bichromatic search with prepared queries.
+  virtual void Search(util::Timers& timers,
+                      tree::PreparedQueries& queries,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  //! Add the given points to the graph.  The leaf size is ignored.
+  virtual void Insert(util::Timers& timers,
+                      const arma::mat& points,
+                      const size_t /* leafSize */);
+
+  //! Points cannot be removed from the graph, so this throws an exception.
+  virtual void Remove(util::Timers& timers,
+                      const arma::Col<size_t>& indices);
+
+  //! Serialize the graph.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(searchMode));
+    ar(CEREAL_NVP(epsilon));
+    ar(CEREAL_NVP(hnsw));
+  }
+
+ protected:
+  //! The search mode (ignored).
+  NeighborSearchMode searchMode;
+  //! The approximation parameter epsilon (ignored).
+  double epsilon;
+  //! The instantiated graph index.
+  HNSWSearch<metric::EuclideanDistance, arma::mat> hnsw;
+};
+
 /**
  * The NSModel class provides an easy way to serialize a model, abstracts away
  * the different types of trees, and also reflects the NeighborSearch API.  This
@@ -360,7 +595,8 @@ class NSModel
     MAX_RP_TREE,
     SPILL_TREE,
     UB_TREE,
-    OCTREE
+    OCTREE,
+    HNSW
   };
 
  private:
@@ -376,6 +612,11 @@ class NSModel
   double tau;
   double rho;
 
+  //! Parameters of the HNSW graph; only used if treeType is HNSW.
+  size_t maxConnections;
+  size_t efConstruction;
+  size_t ef;
+
   /**
    * nSearch holds an instance of the NeighborSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
@@ -426,7 +667,7 @@ class NSModel
 
   //! Serialize the neighbor search model.
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Expose the dataset.
   const arma::mat& Dataset() const;
@@ -447,6 +688,18 @@ class NSModel
   double Rho() const { return rho; }
   double& Rho() { return rho; }
 
+  //! Expose MaxConnections (only used by the HNSW graph).
+  size_t MaxConnections() const { return maxConnections; }
+  size_t& MaxConnections() { return maxConnections; }
+
+  //! Expose EfConstruction (only used by the HNSW graph).
+  size_t EfConstruction() const { return efConstruction; }
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Expose Ef (only used by the HNSW graph).
+  size_t Ef() const { return ef; }
+  size_t& Ef() { return ef; }
+
   //! Expose Epsilon.
   double Epsilon() const;
   double& Epsilon();
@@ -482,8 +735,61 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Prepare the given query set for several searches with Search(), building
+   * the query tree (if the search mode uses one) only once.  If this model
+   * uses a random basis, it is applied to the queries, so they should only be
+   * searched with this model; otherwise they can also be searched with other
+   * models that use the same tree type and search mode.  The caller owns the
+   * returned object, which must be deleted when it is no longer needed.
+   *
+   * @param timers Timers for the tree building.
+   * @param querySet Set of query points (will be moved).
+   */
+  tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                        arma::mat&& querySet);
+
+  /**
+   * Perform neighbor search with queries prepared by PrepareQueries().  The
+   * results are in the original order of the queries.
+   */
+  void Search(util::Timers& timers,
+              tree::PreparedQueries& queries,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Add the given points to the reference set, without rebuilding the tree
+   * (see NeighborSearch::Insert()).  The new points get the next indices of the
+   * reference points.  If this model uses a random basis, it is applied to the
+   * points.  This is supported by the kd-tree, ball tree, VP tree, RP trees,
+   * the R tree family and the HNSW graph; an exception is thrown for the other
+   * tree types.
+   *
+   * @param timers Timers for the tree updates.
+   * @param points New reference points (will be moved).
+   */
+  void Insert(util::Timers& timers, arma::mat&& points);
+
+  /**
+   * Remove the given reference points from the tree, without rebuilding it (see
+   * NeighborSearch::Remove()).  The indices of the other points do not change.
+   * This is supported by the same tree types as Insert(), except the HNSW
+   * graph, and not in naive mode; an exception is thrown otherwise.
+   *
+   * @param timers Timers for the tree updates.
+   * @param indices Indices of the reference points to remove.
+   */
+  void Remove(util::Timers& timers, const arma::Col<size_t>& indices);
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! Set the search parameters that may change between searches, and log the
+  //! type of the search.
+  void SetUpSearch(const size_t k);
 };
 
 } // namespace neighbor
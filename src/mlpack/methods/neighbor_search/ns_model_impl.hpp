@@ -103,6 +103,194 @@ void NSWrapper<
   timers.Stop("computing_neighbors");
 }
 
+//! Prepare the given query set for several bichromatic searches.  For
+//! NSWrapper, we ignore the extra parameters.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+tree::PreparedQueries* NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::PrepareQueries(util::Timers& timers,
+                  arma::mat&& querySet,
+                  const size_t /* leafSize */,
+                  const double /* rho */)
+{
+  if (ns.SearchMode() != DUAL_TREE_MODE)
+    return new tree::PreparedQueries(std::move(querySet));
+
+  timers.Start("tree_building");
+  typename decltype(ns)::Tree* queryTree = new typename decltype(ns)::Tree(
+      std::move(querySet));
+  timers.Stop("tree_building");
+
+  return new tree::PreparedQueryTree<typename decltype(ns)::Tree>(queryTree,
+      std::vector<size_t>());
+}
+
+//! Perform bichromatic neighbor search with prepared queries.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::Search(util::Timers& timers,
+          tree::PreparedQueries& queries,
+          const size_t k,
+          arma::Mat<size_t>& neighbors,
+          arma::mat& distances)
+{
+  timers.Start("computing_neighbors");
+  if (ns.SearchMode() == DUAL_TREE_MODE)
+  {
+    typedef tree::PreparedQueryTree<typename decltype(ns)::Tree> QueryTreeType;
+    QueryTreeType* queryTree = dynamic_cast<QueryTreeType*>(&queries);
+    if (queryTree == NULL)
+    {
+      timers.Stop("computing_neighbors");
+      throw std::invalid_argument("NSModel::Search(): the queries were not "
+          "prepared with a query tree of the type used by the model");
+    }
+
+    // The statistics of the query tree are reset by the search.
+    ns.Search(queryTree->Tree(), k, neighbors, distances);
+  }
+  else
+  {
+    ns.Search(queries.QuerySet(), k, neighbors, distances);
+  }
+  timers.Stop("computing_neighbors");
+
+  queries.Unmap(neighbors);
+  queries.Unmap(distances);
+}
+
+//! Add the given points to the reference set.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::Insert(util::Timers& timers,
+          const arma::mat& points,
+          const size_t leafSize)
+{
+  typedef typename decltype(ns)::Tree Tree;
+
+  timers.Start("tree_updating");
+  try
+  {
+    InsertImpl(points, leafSize, std::integral_constant<bool,
+        SupportsPointUpdates<Tree>::value>());
+  }
+  catch (...)
+  {
+    timers.Stop("tree_updating");
+    throw;
+  }
+  timers.Stop("tree_updating");
+}
+
+//! Remove the given points from the tree.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::Remove(util::Timers& timers,
+          const arma::Col<size_t>& indices)
+{
+  typedef typename decltype(ns)::Tree Tree;
+
+  timers.Start("tree_updating");
+  try
+  {
+    RemoveImpl(indices, std::integral_constant<bool,
+        SupportsPointUpdates<Tree>::value>());
+  }
+  catch (...)
+  {
+    timers.Stop("tree_updating");
+    throw;
+  }
+  timers.Stop("tree_updating");
+}
+
+//! Insert the given points into a tree that supports it.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::InsertImpl(const arma::mat& points,
+              const size_t leafSize,
+              const std::true_type& /* supported */)
+{
+  ns.Insert(points, leafSize);
+}
+
+//! Insertion is not supported by this tree type.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::InsertImpl(const arma::mat& /* points */,
+              const size_t /* leafSize */,
+              const std::false_type& /* supported */)
+{
+  throw std::invalid_argument("NSModel::Insert(): this tree type does not "
+      "support inserting points; rebuild the model instead");
+}
+
+//! Remove the given points from a tree that supports it.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::RemoveImpl(const arma::Col<size_t>& indices,
+              const std::true_type& /* supported */)
+{
+  ns.Remove(indices);
+}
+
+//! Removal is not supported by this tree type.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::RemoveImpl(const arma::Col<size_t>& /* indices */,
+              const std::false_type& /* supported */)
+{
+  throw std::invalid_argument("NSModel::Remove(): this tree type does not "
+      "support removing points; rebuild the model instead");
+}
+
 //! Train a model with the given parameters.  This overload uses leafSize but
 //! ignores the other parameters.
 template<typename SortPolicy,
@@ -189,6 +377,34 @@ void LeafSizeNSWrapper<
   }
 }
 
+//! Prepare the given query set for several bichromatic searches.  This
+//! overload uses the leaf size, but ignores the other parameters.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+tree::PreparedQueries* LeafSizeNSWrapper<
+    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+>::PrepareQueries(util::Timers& timers,
+                  arma::mat&& querySet,
+                  const size_t leafSize,
+                  const double /* rho */)
+{
+  if (ns.SearchMode() != DUAL_TREE_MODE)
+    return new tree::PreparedQueries(std::move(querySet));
+
+  timers.Start("tree_building");
+  std::vector<size_t> oldFromNewQueries;
+  typename decltype(ns)::Tree* queryTree = new typename decltype(ns)::Tree(
+      std::move(querySet), oldFromNewQueries, leafSize);
+  timers.Stop("tree_building");
+
+  return new tree::PreparedQueryTree<typename decltype(ns)::Tree>(queryTree,
+      std::move(oldFromNewQueries));
+}
+
 //! Train the model using the given parameters.
 template<typename SortPolicy>
 void SpillNSWrapper<SortPolicy>::Train(util::Timers& timers,
@@ -237,6 +453,123 @@ void SpillNSWrapper<SortPolicy>::Search(util::Timers& timers,
   }
 }
 
+//! Prepare the given query set for several bichromatic searches using the
+//! given parameters.
+template<typename SortPolicy>
+tree::PreparedQueries* SpillNSWrapper<SortPolicy>::PrepareQueries(
+    util::Timers& timers,
+    arma::mat&& querySet,
+    const size_t leafSize,
+    const double rho)
+{
+  if (ns.SearchMode() != DUAL_TREE_MODE)
+    return new tree::PreparedQueries(std::move(querySet));
+
+  // For Dual Tree Search on SpillTrees, the queryTree must be built with
+  // non overlapping (tau = 0).
+  timers.Start("tree_building");
+  typename decltype(ns)::Tree* queryTree = new typename decltype(ns)::Tree(
+      std::move(querySet), 0 /* tau */, leafSize, rho);
+  timers.Stop("tree_building");
+
+  return new tree::PreparedQueryTree<typename decltype(ns)::Tree>(queryTree,
+      std::vector<size_t>());
+}
+
+//! Build the graph.
+template<typename SortPolicy>
+void HNSWNSWrapper<SortPolicy>::Train(util::Timers& timers,
+                                      arma::mat&& referenceSet,
+                                      const size_t /* leafSize */,
+                                      const double /* tau */,
+                                      const double /* rho */)
+{
+  if (!std::is_same<SortPolicy, NearestNeighborSort>::value)
+  {
+    Log::Fatal << "HNSW graphs can only be used for nearest neighbor search!"
+        << std::endl;
+  }
+
+  timers.Start("graph_building");
+  hnsw.Train(std::move(referenceSet));
+  timers.Stop("graph_building");
+}
+
+//! Perform bichromatic search (i.e. search with a different query set).
+template<typename SortPolicy>
+void HNSWNSWrapper<SortPolicy>::Search(util::Timers& timers,
+                                       arma::mat&& querySet,
+                                       const size_t k,
+                                       arma::Mat<size_t>& neighbors,
+                                       arma::mat& distances,
+                                       const size_t /* leafSize */,
+                                       const double /* rho */)
+{
+  timers.Start("computing_neighbors");
+  hnsw.Search(querySet, k, neighbors, distances);
+  timers.Stop("computing_neighbors");
+}
+
+//! Perform monochromatic search (i.e. use the reference set as the query set).
+template<typename SortPolicy>
+void HNSWNSWrapper<SortPolicy>::Search(util::Timers& timers,
+                                       const size_t k,
+                                       arma::Mat<size_t>& neighbors,
+                                       arma::mat& distances)
+{
+  timers.Start("computing_neighbors");
+  hnsw.Search(k, neighbors, distances);
+  timers.Stop("computing_neighbors");
+}
+
+//! Prepare the given query set for several bichromatic searches (no tree is
+//! built).
+template<typename SortPolicy>
+tree::PreparedQueries* HNSWNSWrapper<SortPolicy>::PrepareQueries(
+    util::Timers& /* timers */,
+    arma::mat&& querySet,
+    const size_t /* leafSize */,
+    const double /* rho */)
+{
+  return new tree::PreparedQueries(std::move(querySet));
+}
+
+//! Perform bichromatic search with prepared queries.
+template<typename SortPolicy>
+void HNSWNSWrapper<SortPolicy>::Search(util::Timers& timers,
+                                       tree::PreparedQueries& queries,
+                                       const size_t k,
+                                       arma::Mat<size_t>& neighbors,
+                                       arma::mat& distances)
+{
+  timers.Start("computing_neighbors");
+  hnsw.Search(queries.QuerySet(), k, neighbors, distances);
+  timers.Stop("computing_neighbors");
+
+  queries.Unmap(neighbors);
+  queries.Unmap(distances);
+}
+
+//! Add the given points to the graph.
+template<typename SortPolicy>
+void HNSWNSWrapper<SortPolicy>::Insert(util::Timers& timers,
+                                       const arma::mat& points,
+                                       const size_t /* leafSize */)
+{
+  timers.Start("graph_building");
+  hnsw.Insert(points);
+  timers.Stop("graph_building");
+}
+
+//! Points cannot be removed from the graph.
+template<typename SortPolicy>
+void HNSWNSWrapper<SortPolicy>::Remove(util::Timers& /* timers */,
+                                       const arma::Col<size_t>& /* indices */)
+{
+  throw std::invalid_argument("NSModel::Remove(): points cannot be removed "
+      "from an HNSW graph; rebuild the model instead");
+}
+
 /**
  * Initialize the NSModel with the given type and whether or not a random
  * basis should be used.
@@ -248,6 +581,9 @@ NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
     leafSize(20),
     tau(0.0),
     rho(0.7),
+    maxConnections(16),
+    efConstruction(200),
+    ef(50),
     nSearch(NULL)
 {
   // Nothing to do.
@@ -261,6 +597,9 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
+    maxConnections(other.maxConnections),
+    efConstruction(other.efConstruction),
+    ef(other.ef),
     nSearch(other.nSearch->Clone())
 {
   // Nothing to do.
@@ -274,6 +613,9 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
+    maxConnections(other.maxConnections),
+    efConstruction(other.efConstruction),
+    ef(other.ef),
     nSearch(other.nSearch)
 {
   // Reset parameters of the other model.
@@ -282,6 +624,9 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.leafSize = 20;
   other.tau = 0.0;
   other.rho = 0.7;
+  other.maxConnections = 16;
+  other.efConstruction = 200;
+  other.ef = 50;
   other.nSearch = NULL;
 }
 
@@ -298,6 +643,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
+    maxConnections = other.maxConnections;
+    efConstruction = other.efConstruction;
+    ef = other.ef;
     nSearch = other.nSearch->Clone();
   }
 
@@ -317,6 +665,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
+    maxConnections = other.maxConnections;
+    efConstruction = other.efConstruction;
+    ef = other.ef;
     nSearch = other.nSearch;
 
     // Reset parameters of the other model.
@@ -325,6 +676,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     other.leafSize = 20;
     other.tau = 0.0;
     other.rho = 0.7;
+    other.maxConnections = 16;
+    other.efConstruction = 200;
+    other.ef = 50;
     other.nSearch = NULL;
   }
 
@@ -341,7 +695,7 @@ NSModel<SortPolicy>::~NSModel()
 //! Serialize the kNN model.
 template<typename SortPolicy>
 template<typename Archive>
-void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
+void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(treeType));
   ar(CEREAL_NVP(randomBasis));
@@ -350,6 +704,14 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(tau));
   ar(CEREAL_NVP(rho));
 
+  // The HNSW graph parameters were added in version 1.
+  if (version > 0)
+  {
+    ar(CEREAL_NVP(maxConnections));
+    ar(CEREAL_NVP(efConstruction));
+    ar(CEREAL_NVP(ef));
+  }
+
   // This should never happen, but just in case, be clean with memory.
   if (cereal::is_loading<Archive>())
     InitializeModel(DUAL_TREE_MODE, 0.0); // Values will be overwritten.
@@ -467,6 +829,13 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+    case HNSW:
+      {
+        HNSWNSWrapper<SortPolicy>& typedSearch =
+            dynamic_cast<HNSWNSWrapper<SortPolicy>&>(*nSearch);
+        ar(CEREAL_NVP(typedSearch));
+        break;
+      }
   }
 }
 
@@ -569,6 +938,10 @@ void NSModel<SortPolicy>::InitializeModel(const NeighborSearchMode searchMode,
       nSearch = new LeafSizeNSWrapper<SortPolicy, tree::Octree>(searchMode,
           epsilon);
       break;
+    case HNSW:
+      nSearch = new HNSWNSWrapper<SortPolicy>(searchMode, epsilon,
+          maxConnections, efConstruction, ef);
+      break;
   }
 }
 
@@ -625,6 +998,41 @@ void NSModel<SortPolicy>::BuildModel(util::Timers& timers,
     Log::Info << "Tree built." << std::endl;
 }
 
+//! Set the search parameters that may change between searches, and log the
+//! type of the search.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::SetUpSearch(const size_t k)
+{
+  Log::Info << "Searching for " << k << " neighbors with ";
+
+  // The graph search is always approximate, and its only parameter may be
+  // changed between searches.
+  if (treeType == HNSW)
+  {
+    static_cast<HNSWNSWrapper<SortPolicy>*>(nSearch)->Ef() = ef;
+    Log::Info << TreeName() << " search (ef = " << ef << ")..." << std::endl;
+  }
+  else
+  {
+    switch (SearchMode())
+    {
+      case NAIVE_MODE:
+        Log::Info << "brute-force (naive) search..." << std::endl;
+        break;
+      case SINGLE_TREE_MODE:
+        Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case DUAL_TREE_MODE:
+        Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case GREEDY_SINGLE_TREE_MODE:
+        Log::Info << "greedy single-tree " << TreeName() << " search..."
+            << std::endl;
+        break;
+    }
+  }
+}
+
 //! Perform neighbor search.  The query set will be reordered.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::Search(util::Timers& timers,
@@ -641,24 +1049,7 @@ void NSModel<SortPolicy>::Search(util::Timers& timers,
     timers.Stop("applying_random_basis");
   }
 
-  Log::Info << "Searching for " << k << " neighbors with ";
-
-  switch (SearchMode())
-  {
-    case NAIVE_MODE:
-      Log::Info << "brute-force (naive) search..." << std::endl;
-      break;
-    case SINGLE_TREE_MODE:
-      Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case DUAL_TREE_MODE:
-      Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case GREEDY_SINGLE_TREE_MODE:
-      Log::Info << "greedy single-tree " << TreeName() << " search..."
-          << std::endl;
-      break;
-  }
+  SetUpSearch(k);
 
   nSearch->Search(timers, std::move(querySet), k, neighbors, distances,
       leafSize, rho);
@@ -671,32 +1062,82 @@ void NSModel<SortPolicy>::Search(util::Timers& timers,
                                  arma::Mat<size_t>& neighbors,
                                  arma::mat& distances)
 {
-  Log::Info << "Searching for " << k << " neighbors with ";
+  SetUpSearch(k);
 
-  switch (SearchMode())
-  {
-    case NAIVE_MODE:
-      Log::Info << "brute-force (naive) search..." << std::endl;
-      break;
-    case SINGLE_TREE_MODE:
-      Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case DUAL_TREE_MODE:
-      Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case GREEDY_SINGLE_TREE_MODE:
-      Log::Info << "greedy single-tree " << TreeName() << " search..."
-          << std::endl;
-      break;
-  }
-
-  if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
+  if (Epsilon() != 0 && SearchMode() != NAIVE_MODE && treeType != HNSW)
     Log::Info << "Maximum of " << Epsilon() * 100 << "% relative error."
         << std::endl;
 
   nSearch->Search(timers, k, neighbors, distances);
 }
 
+//! Prepare the given query set for several searches.
+template<typename SortPolicy>
+tree::PreparedQueries* NSModel<SortPolicy>::PrepareQueries(
+    util::Timers& timers,
+    arma::mat&& querySet)
+{
+  // We may need to map the query set randomly.
+  if (randomBasis)
+  {
+    timers.Start("applying_random_basis");
+    querySet = q * querySet;
+    timers.Stop("applying_random_basis");
+  }
+
+  if (SearchMode() == DUAL_TREE_MODE && treeType != HNSW)
+    Log::Info << "Building query tree..." << std::endl;
+
+  return nSearch->PrepareQueries(timers, std::move(querySet), leafSize, rho);
+}
+
+//! Perform neighbor search with prepared queries.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Search(util::Timers& timers,
+                                 tree::PreparedQueries& queries,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances)
+{
+  SetUpSearch(k);
+  nSearch->Search(timers, queries, k, neighbors, distances);
+}
+
+//! Add the given points to the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(util::Timers& timers, arma::mat&& points)
+{
+  if (nSearch == NULL)
+  {
+    throw std::invalid_argument("NSModel::Insert(): the model has not been "
+        "built");
+  }
+
+  // The new points must be mapped like the reference set.
+  if (randomBasis)
+  {
+    timers.Start("applying_random_basis");
+    points = q * points;
+    timers.Stop("applying_random_basis");
+  }
+
+  nSearch->Insert(timers, points, leafSize);
+}
+
+//! Remove the given points from the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Remove(util::Timers& timers,
+                                 const arma::Col<size_t>& indices)
+{
+  if (nSearch == NULL)
+  {
+    throw std::invalid_argument("NSModel::Remove(): the model has not been "
+        "built");
+  }
+
+  nSearch->Remove(timers, indices);
+}
+
 //! Get the name of the tree type.
 template<typename SortPolicy>
 std::string NSModel<SortPolicy>::TreeName() const
@@ -733,6 +1174,8 @@ std::string NSModel<SortPolicy>::TreeName() const
       return "UB tree";
     case OCTREE:
       return "octree";
+    case HNSW:
+      return "HNSW graph";
     default:
       return "unknown tree";
   }
@@ -741,4 +1184,7 @@ std::string NSModel<SortPolicy>::TreeName() const
 } // namespace neighbor
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename SortPolicy>),
+    (mlpack::neighbor::NSModel<SortPolicy>), (1));
+
 #endif
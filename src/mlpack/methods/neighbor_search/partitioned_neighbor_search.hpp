@@ -0,0 +1,237 @@
+/**
+ * @file methods/neighbor_search/partitioned_neighbor_search.hpp
+ *
+ * Defines the PartitionedNeighborSearch class, which computes the k-nearest
+ * neighbor join of query and reference sets that are too large to be held in
+ * memory, by searching pairs of partitions stored on disk.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_PARTITIONED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_PARTITIONED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/hrectbound.hpp>
+#include <memory>
+#include <stack>
+
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The PartitionedNeighborSearch class finds the k neighbors of each point of a
+ * query set in a reference set when neither set fits in memory.  Both sets are
+ * given as lists of partitions, each stored in its own file (in any format
+ * data::Load() supports), and only one query partition and one reference
+ * partition are loaded at a time.  For each query partition, a query tree is
+ * built once; then the reference partitions are searched with dual-tree
+ * NeighborSearch, from the closest to the furthest, and the results are merged
+ * into the k best neighbors of each query.
+ *
+ * The bounding box of each reference partition is computed by Train(), and a
+ * reference partition is skipped when no point of its box can improve the
+ * k-th neighbor of any query of the query partition.  So the search is
+ * fastest when the partitions are spatially compact; Partition() splits a
+ * dataset into such partitions with the top levels of a kd-tree.
+ *
+ * The points of the reference set are numbered in the order of the partitions
+ * given to Train(), so the first point of the second partition has index
+ * n_0 (the number of points of the first partition), and so on; the columns of
+ * the results are numbered in the same way over the query partitions.
+ *
+ * @code
+ * // Split the datasets into partitions of at most 1M points each, and save
+ * // them.
+ * std::vector<arma::mat> partitions;
+ * std::vector<std::vector<size_t>> indices;
+ * PartitionedKNN::Partition(std::move(referenceSet), 1000000, partitions,
+ *     indices);
+ * std::vector<std::string> files;
+ * for (size_t i = 0; i < partitions.size(); ++i)
+ * {
+ *   files.push_back("reference_" + std::to_string(i) + ".bin");
+ *   data::Save(files.back(), partitions[i]);
+ * }
+ * ...
+ *
+ * PartitionedKNN knn;
+ * knn.Train(files);
+ * knn.Search(queryFiles, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation; it must be an LMetric,
+ *     because the partitions are bounded with hyperrectangles.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use for the partition-pair searches.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class PartitionedNeighborSearch
+{
+ public:
+  //! The type of the search used for each pair of partitions.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType>
+      NeighborSearchType;
+  //! The type of the trees.
+  typedef typename NeighborSearchType::Tree Tree;
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+  //! The type of the bounding box of a partition.
+  typedef bound::HRectBound<MetricType, ElemType> BoundType;
+
+  /**
+   * Create the object, without any reference partitions.
+   *
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric An optional instance of the MetricType class.
+   */
+  PartitionedNeighborSearch(const double epsilon = 0,
+                            const MetricType metric = MetricType());
+
+  /**
+   * Set the reference partitions.  Each partition is loaded once, to compute
+   * its size and its bounding box.
+   *
+   * @param referenceFiles Files holding the partitions of the reference set.
+   */
+  void Train(const std::vector<std::string>& referenceFiles);
+
+  /**
+   * Find the k neighbors of each point of the query partitions in the
+   * reference partitions.
+   *
+   * @param queryFiles Files holding the partitions of the query set.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const std::vector<std::string>& queryFiles,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Find the k neighbors of each point of the reference partitions in the
+   * reference set, excluding the point itself (this is the self-join of the
+   * reference set).
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each reference
+   *     point.
+   * @param distances Matrix storing distances of neighbors for each reference
+   *     point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Split the given dataset into spatially compact partitions of at most
+   * maxPartitionSize points, given by the leaves of a kd-tree built on the
+   * dataset.  indices[i][j] is the index in the dataset of column j of
+   * partitions[i].  The dataset must fit in memory; a larger dataset can be
+   * split chunk by chunk.
+   *
+   * @param dataset Dataset to split.
+   * @param maxPartitionSize Maximum number of points of a partition.
+   * @param partitions Output: the partitions.
+   * @param indices Output: the indices of the points of each partition.
+   */
+  static void Partition(MatType dataset,
+                        const size_t maxPartitionSize,
+                        std::vector<MatType>& partitions,
+                        std::vector<std::vector<size_t>>& indices);
+
+  //! Get the number of reference points.
+  size_t NumReferencePoints() const { return referenceOffsets.back(); }
+
+  //! Get the number of base cases of the last search.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of node combinations scored by the last search.
+  size_t Scores() const { return scores; }
+  //! Get the number of partition pairs searched by the last search.
+  size_t SearchedPairs() const { return searchedPairs; }
+  //! Get the number of partition pairs pruned by the last search.
+  size_t PrunedPairs() const { return prunedPairs; }
+
+  //! Get the relative approximate error.
+  double Epsilon() const { return epsilon; }
+  //! Modify the relative approximate error (non-negative).
+  double& Epsilon() { return epsilon; }
+
+ private:
+  /**
+   * Search the given query partition, and store its results in neighbors and
+   * distances (in the order of the partition).  If selfPartition is a valid
+   * reference partition, the query partition is that partition, and no point
+   * is its own neighbor.
+   */
+  void SearchPartition(MatType&& queryPartition,
+                       const size_t selfPartition,
+                       const size_t k,
+                       arma::Mat<size_t>& neighbors,
+                       arma::mat& distances);
+
+  /**
+   * Merge the new candidates of column newCol into column col of the current
+   * results (both kept sorted, best first).
+   */
+  static void Merge(const arma::Mat<size_t>& newNeighbors,
+                    const arma::mat& newDistances,
+                    const size_t newCol,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances,
+                    const size_t col);
+
+  //! Load the given partition, checking its dimension.
+  void Load(const std::string& file, MatType& partition) const;
+
+  //! The files of the reference partitions.
+  std::vector<std::string> referenceFiles;
+  //! The global index of the first point of each reference partition (with
+  //! the total number of points at the end).
+  std::vector<size_t> referenceOffsets;
+  //! The bounding box of each reference partition.
+  std::vector<BoundType> referenceBounds;
+  //! The dimension of the points.
+  size_t dimension;
+
+  //! Relative approximate error.
+  double epsilon;
+  //! The metric.
+  MetricType metric;
+
+  //! The number of base cases of the last search.
+  size_t baseCases;
+  //! The number of node combinations scored by the last search.
+  size_t scores;
+  //! The number of partition pairs searched by the last search.
+  size_t searchedPairs;
+  //! The number of partition pairs pruned by the last search.
+  size_t prunedPairs;
+};
+
+/**
+ * The PartitionedKNN class is the k-nearest-neighbor join of partitioned sets,
+ * with the Euclidean distance and kd-trees.
+ */
+typedef PartitionedNeighborSearch<NearestNeighborSort> PartitionedKNN;
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "partitioned_neighbor_search_impl.hpp"
+
+#endif
@@ -0,0 +1,412 @@
+/**
+ * @file methods/neighbor_search/partitioned_neighbor_search_impl.hpp
+ *
+ * Implementation of the PartitionedNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_PARTITIONED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_PARTITIONED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "partitioned_neighbor_search.hpp"
+
+#include <mlpack/core/data/load.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+PartitionedNeighborSearch(const double epsilon, const MetricType metric) :
+    referenceOffsets(1, 0),
+    dimension(0),
+    epsilon(epsilon),
+    metric(metric),
+    baseCases(0),
+    scores(0),
+    searchedPairs(0),
+    prunedPairs(0)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Train(const std::vector<std::string>& referenceFilesIn)
+{
+  referenceFiles = referenceFilesIn;
+  referenceOffsets.assign(1, 0);
+  referenceBounds.clear();
+  dimension = 0;
+
+  for (size_t i = 0; i < referenceFiles.size(); ++i)
+  {
+    MatType partition;
+    if (i == 0)
+    {
+      data::Load(referenceFiles[i], partition, true);
+      dimension = partition.n_rows;
+    }
+    else
+    {
+      Load(referenceFiles[i], partition);
+    }
+
+    BoundType bound(dimension);
+    bound |= partition;
+    referenceBounds.push_back(bound);
+    referenceOffsets.push_back(referenceOffsets.back() + partition.n_cols);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Search(const std::vector<std::string>& queryFiles,
+       const size_t k,
+       arma::Mat<size_t>& neighbors,
+       arma::mat& distances)
+{
+  if (k > NumReferencePoints())
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << NumReferencePoints() << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  baseCases = 0;
+  scores = 0;
+  searchedPairs = 0;
+  prunedPairs = 0;
+
+  // The number of queries is only known once all the partitions have been
+  // loaded, so keep the results of each partition until the end.
+  std::vector<arma::Mat<size_t>> partitionNeighbors(queryFiles.size());
+  std::vector<arma::mat> partitionDistances(queryFiles.size());
+  size_t numQueries = 0;
+  for (size_t i = 0; i < queryFiles.size(); ++i)
+  {
+    MatType queryPartition;
+    Load(queryFiles[i], queryPartition);
+    numQueries += queryPartition.n_cols;
+    SearchPartition(std::move(queryPartition), referenceFiles.size(), k,
+        partitionNeighbors[i], partitionDistances[i]);
+  }
+
+  neighbors.set_size(k, numQueries);
+  distances.set_size(k, numQueries);
+  size_t offset = 0;
+  for (size_t i = 0; i < queryFiles.size(); ++i)
+  {
+    const size_t n = partitionNeighbors[i].n_cols;
+    if (n == 0)
+      continue;
+
+    neighbors.cols(offset, offset + n - 1) = partitionNeighbors[i];
+    distances.cols(offset, offset + n - 1) = partitionDistances[i];
+    offset += n;
+
+    // Free the memory as we go.
+    partitionNeighbors[i].reset();
+    partitionDistances[i].reset();
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Search(const size_t k,
+       arma::Mat<size_t>& neighbors,
+       arma::mat& distances)
+{
+  if (k >= NumReferencePoints())
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than or equal to the "
+        << "number of points in the reference set (" << NumReferencePoints()
+        << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  baseCases = 0;
+  scores = 0;
+  searchedPairs = 0;
+  prunedPairs = 0;
+
+  neighbors.set_size(k, NumReferencePoints());
+  distances.set_size(k, NumReferencePoints());
+  for (size_t i = 0; i < referenceFiles.size(); ++i)
+  {
+    const size_t n = referenceOffsets[i + 1] - referenceOffsets[i];
+    if (n == 0)
+      continue;
+
+    MatType partition;
+    Load(referenceFiles[i], partition);
+
+    arma::Mat<size_t> partitionNeighbors;
+    arma::mat partitionDistances;
+    SearchPartition(std::move(partition), i, k, partitionNeighbors,
+        partitionDistances);
+    neighbors.cols(referenceOffsets[i], referenceOffsets[i + 1] - 1) =
+        partitionNeighbors;
+    distances.cols(referenceOffsets[i], referenceOffsets[i + 1] - 1) =
+        partitionDistances;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Partition(MatType dataset,
+          const size_t maxPartitionSize,
+          std::vector<MatType>& partitions,
+          std::vector<std::vector<size_t>>& indices)
+{
+  if (maxPartitionSize == 0)
+  {
+    throw std::invalid_argument("PartitionedNeighborSearch::Partition(): the "
+        "maximum partition size must be positive");
+  }
+
+  partitions.clear();
+  indices.clear();
+  if (dataset.n_cols == 0)
+    return;
+
+  // The leaves of a kd-tree with the maximum partition size as leaf size are
+  // the partitions.
+  typedef tree::KDTree<MetricType, tree::EmptyStatistic, MatType> KDTreeType;
+  std::vector<size_t> oldFromNew;
+  KDTreeType tree(std::move(dataset), oldFromNew, maxPartitionSize);
+
+  std::stack<const KDTreeType*> stack;
+  stack.push(&tree);
+  while (!stack.empty())
+  {
+    const KDTreeType* node = stack.top();
+    stack.pop();
+
+    if (!node->IsLeaf())
+    {
+      // Visit the left child first, so that the partitions are in the order of
+      // the tree.
+      stack.push(node->Right());
+      stack.push(node->Left());
+      continue;
+    }
+
+    if (node->Count() == 0)
+      continue;
+
+    const size_t begin = node->Begin();
+    const size_t end = begin + node->Count();
+    partitions.push_back(tree.Dataset().cols(begin, end - 1));
+    indices.push_back(std::vector<size_t>(oldFromNew.begin() + begin,
+        oldFromNew.begin() + end));
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+SearchPartition(MatType&& queryPartition,
+                const size_t selfPartition,
+                const size_t k,
+                arma::Mat<size_t>& neighbors,
+                arma::mat& distances)
+{
+  const size_t n = queryPartition.n_cols;
+  neighbors.set_size(k, n);
+  neighbors.fill(size_t() - 1);
+  distances.set_size(k, n);
+  distances.fill(SortPolicy::WorstDistance());
+  if (n == 0)
+    return;
+
+  BoundType queryBound(dimension);
+  queryBound |= queryPartition;
+
+  // Order the reference partitions from the best to the worst bound on the
+  // distances between their points and the queries; the partition of the
+  // queries (if any) is searched first.
+  std::vector<double> bestDistances(referenceFiles.size());
+  std::vector<std::pair<double, size_t>> order;
+  for (size_t r = 0; r < referenceFiles.size(); ++r)
+  {
+    if (referenceOffsets[r + 1] == referenceOffsets[r])
+      continue;
+
+    bestDistances[r] = (r == selfPartition) ? SortPolicy::BestDistance() :
+        SortPolicy::BestNodeToNodeDistance(&queryBound, &referenceBounds[r]);
+    order.push_back(std::make_pair(SortPolicy::ConvertToScore(
+        bestDistances[r]), r));
+  }
+  std::sort(order.begin(), order.end());
+
+  // Build the query tree once, for all the reference partitions.
+  std::vector<size_t> oldFromNewQueries;
+  std::unique_ptr<Tree> queryTree(BuildTree<Tree>(std::move(queryPartition),
+      oldFromNewQueries));
+
+  for (size_t o = 0; o < order.size(); ++o)
+  {
+    const size_t r = order[o].second;
+
+    // Find the worst k-th neighbor distance of the queries.
+    double worstDistance = SortPolicy::BestDistance();
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (SortPolicy::IsBetter(worstDistance, distances(k - 1, i)))
+        worstDistance = distances(k - 1, i);
+    }
+
+    // The remaining partitions are no better than this one, so if it cannot
+    // improve any query, none of them can.
+    if (r != selfPartition && !SortPolicy::IsBetter(bestDistances[r],
+        SortPolicy::Relax(worstDistance, epsilon)))
+    {
+      prunedPairs += order.size() - o;
+      break;
+    }
+
+    // In the partition of the queries, each point is not its own neighbor.
+    const size_t referencePoints = referenceOffsets[r + 1] -
+        referenceOffsets[r];
+    const size_t partitionK = std::min(k, (r == selfPartition) ?
+        referencePoints - 1 : referencePoints);
+    if (partitionK == 0)
+      continue;
+
+    MatType referencePartition;
+    if (r == selfPartition)
+      referencePartition = queryTree->Dataset();
+    else
+      Load(referenceFiles[r], referencePartition);
+
+    NeighborSearchType ns(std::move(referencePartition), DUAL_TREE_MODE,
+        epsilon, metric);
+    arma::Mat<size_t> newNeighbors;
+    arma::mat newDistances;
+    if (r == selfPartition)
+    {
+      // The reference set is the dataset of the query tree, so the neighbors
+      // are in the order of the query tree too.
+      ns.Search(partitionK, newNeighbors, newDistances);
+      if (!oldFromNewQueries.empty())
+        newNeighbors.transform([&](size_t j) { return oldFromNewQueries[j]; });
+    }
+    else
+    {
+      ns.Search(*queryTree, partitionK, newNeighbors, newDistances);
+    }
+    newNeighbors += referenceOffsets[r];
+
+    baseCases += ns.BaseCases();
+    scores += ns.Scores();
+    ++searchedPairs;
+
+    // The columns of the results are in the order of the query tree.
+    for (size_t i = 0; i < n; ++i)
+    {
+      const size_t query = oldFromNewQueries.empty() ? i :
+          oldFromNewQueries[i];
+      Merge(newNeighbors, newDistances, i, neighbors, distances, query);
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Merge(const arma::Mat<size_t>& newNeighbors,
+      const arma::mat& newDistances,
+      const size_t newCol,
+      arma::Mat<size_t>& neighbors,
+      arma::mat& distances,
+      const size_t col)
+{
+  const size_t k = neighbors.n_rows;
+  const arma::Col<size_t> oldNeighbors = neighbors.col(col);
+  const arma::vec oldDistances = distances.col(col);
+
+  size_t oldIndex = 0, newIndex = 0;
+  for (size_t j = 0; j < k; ++j)
+  {
+    if (newIndex < newDistances.n_rows && SortPolicy::IsBetter(
+        newDistances(newIndex, newCol), oldDistances[oldIndex]) &&
+        newDistances(newIndex, newCol) != oldDistances[oldIndex])
+    {
+      neighbors(j, col) = newNeighbors(newIndex, newCol);
+      distances(j, col) = newDistances(newIndex, newCol);
+      ++newIndex;
+    }
+    else
+    {
+      neighbors(j, col) = oldNeighbors[oldIndex];
+      distances(j, col) = oldDistances[oldIndex];
+      ++oldIndex;
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void PartitionedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Load(const std::string& file, MatType& partition) const
+{
+  data::Load(file, partition, true);
+  if (partition.n_rows != dimension)
+  {
+    std::ostringstream oss;
+    oss << "PartitionedNeighborSearch: the partition '" << file << "' has "
+        << partition.n_rows << " dimensions, but the reference partitions have "
+        << dimension << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -99,6 +99,16 @@ class FurthestNS
                                         const TreeType* referenceNode,
                                         const double pointToCenterDistance);
 
+  /**
+   * Compute the best possible distance between a point and each bound of a
+   * set of bounds (such as a bound::HRectBoundSet holding the bounds of the
+   * children of a node).  In our case, this is the maximum distance.
+   */
+  template<typename VecType, typename BoundSetType>
+  static void BestPointToBoundsDistances(const VecType& queryPoint,
+                                         const BoundSetType& bounds,
+                                         arma::vec& distances);
+
   /**
    * Return the best child according to this sort policy. In this case it will
    * return the one with the maximum distance.
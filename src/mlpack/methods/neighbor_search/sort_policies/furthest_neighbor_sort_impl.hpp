@@ -65,6 +65,15 @@ inline double FurthestNS::BestPointToNodeDistance(
   return referenceNode->MaxDistance(point, pointToCenterDistance);
 }
 
+template<typename VecType, typename BoundSetType>
+inline void FurthestNS::BestPointToBoundsDistances(
+    const VecType& point,
+    const BoundSetType& bounds,
+    arma::vec& distances)
+{
+  bounds.MaxDistance(point, distances);
+}
+
 } // namespace neighbor
 } // namespace mlpack
 
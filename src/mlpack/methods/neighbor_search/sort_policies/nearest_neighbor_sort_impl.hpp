@@ -65,6 +65,15 @@ inline double NearestNS::BestPointToNodeDistance(
   return referenceNode->MinDistance(point, pointToCenterDistance);
 }
 
+template<typename VecType, typename BoundSetType>
+inline void NearestNS::BestPointToBoundsDistances(
+    const VecType& point,
+    const BoundSetType& bounds,
+    arma::vec& distances)
+{
+  bounds.MinDistance(point, distances);
+}
+
 } // namespace neighbor
 } // namespace mlpack
 
@@ -0,0 +1,332 @@
+/**
+ * @file methods/neighbor_search/sparse_cosine_search.cpp
+ *
+ * Implementation of the SparseCosineSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "sparse_cosine_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+SparseCosineSearch::SparseCosineSearch() :
+    numReferences(0),
+    offsets(1, 0)
+{
+  // Nothing to do.
+}
+
+SparseCosineSearch::SparseCosineSearch(const arma::sp_mat& referenceSet) :
+    numReferences(0),
+    offsets(1, 0)
+{
+  Train(referenceSet);
+}
+
+void SparseCosineSearch::Train(const arma::sp_mat& referenceSetIn)
+{
+  referenceSet = referenceSetIn;
+  numReferences = referenceSet.n_cols;
+  const size_t dimensionality = referenceSet.n_rows;
+
+  // Count the nonzero values of each dimension.
+  offsets.assign(dimensionality + 1, 0);
+  for (arma::sp_mat::const_iterator it = referenceSet.begin();
+       it != referenceSet.end(); ++it)
+  {
+    if (*it != 0.0)
+      ++offsets[it.row() + 1];
+  }
+  for (size_t d = 0; d < dimensionality; ++d)
+    offsets[d + 1] += offsets[d];
+
+  // Fill the lists point by point, so that each list is sorted by point.
+  points.resize(offsets.back());
+  values.resize(offsets.back());
+  maxValues.assign(dimensionality, 0.0);
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  std::vector<std::pair<size_t, double>> pointValues;
+  for (size_t j = 0; j < numReferences; ++j)
+  {
+    QueryValues(referenceSet, j, pointValues);
+    for (size_t i = 0; i < pointValues.size(); ++i)
+    {
+      const size_t d = pointValues[i].first;
+      points[next[d]] = j;
+      values[next[d]] = pointValues[i].second;
+      maxValues[d] = std::max(maxValues[d], std::abs(pointValues[i].second));
+      ++next[d];
+    }
+  }
+}
+
+void SparseCosineSearch::Search(const arma::sp_mat& querySet,
+                                const size_t k,
+                                arma::Mat<size_t>& neighbors,
+                                arma::mat& similarities) const
+{
+  CheckQuerySet(querySet);
+  if (k > numReferences)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << numReferences << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  SearchAll(querySet, k, false, neighbors, similarities);
+}
+
+void SparseCosineSearch::Search(const size_t k,
+                                arma::Mat<size_t>& neighbors,
+                                arma::mat& similarities) const
+{
+  if (k >= numReferences)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is not less than the number of "
+        << "points in the reference set (" << numReferences << ") and no "
+        << "query set has been provided.";
+    throw std::invalid_argument(ss.str());
+  }
+
+  SearchAll(referenceSet, k, true, neighbors, similarities);
+}
+
+void SparseCosineSearch::Search(
+    const arma::sp_mat& querySet,
+    const double threshold,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& similarities) const
+{
+  CheckQuerySet(querySet);
+  if (threshold <= 0.0)
+  {
+    Log::Fatal << "SparseCosineSearch::Search(): the similarity threshold "
+        << "must be positive (given " << threshold << ")!" << std::endl;
+  }
+
+  neighbors.assign(querySet.n_cols, std::vector<size_t>());
+  similarities.assign(querySet.n_cols, std::vector<double>());
+
+  #pragma omp parallel
+  {
+    Accumulator accumulator(numReferences);
+    std::vector<double>& scores = accumulator.scores;
+    std::vector<char>& isTouched = accumulator.isTouched;
+    std::vector<size_t>& touched = accumulator.touched;
+    std::vector<std::pair<double, size_t>>& ranked = accumulator.ranked;
+
+    std::vector<std::pair<size_t, double>> queryValues;
+    std::vector<std::pair<double, size_t>> order;
+    std::vector<double> bounds;
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      QueryValues(querySet, q, queryValues);
+
+      // Order the dimensions by decreasing bound of their contribution to the
+      // similarity, and compute the bound of each suffix of the order.
+      order.clear();
+      for (size_t i = 0; i < queryValues.size(); ++i)
+      {
+        order.push_back(std::make_pair(-std::abs(queryValues[i].second) *
+            maxValues[queryValues[i].first], i));
+      }
+      std::sort(order.begin(), order.end());
+
+      bounds.assign(order.size() + 1, 0.0);
+      for (size_t i = order.size(); i > 0; --i)
+        bounds[i - 1] = bounds[i] - order[i - 1].first;
+
+      for (size_t i = 0; i < order.size(); ++i)
+      {
+        // A point that has no value in the dimensions so far can't reach the
+        // threshold once the bound of the remaining dimensions is below it.
+        // (The bound is relaxed a little for rounding errors.)
+        const bool addCandidates = (bounds[i] * (1 + 1e-10) >= threshold);
+
+        const size_t d = queryValues[order[i].second].first;
+        const double weight = queryValues[order[i].second].second;
+        for (size_t j = offsets[d]; j < offsets[d + 1]; ++j)
+        {
+          const size_t point = points[j];
+          if (!isTouched[point])
+          {
+            if (!addCandidates)
+              continue;
+
+            isTouched[point] = 1;
+            touched.push_back(point);
+          }
+
+          scores[point] += weight * values[j];
+        }
+      }
+
+      ranked.clear();
+      for (size_t i = 0; i < touched.size(); ++i)
+      {
+        if (scores[touched[i]] >= threshold)
+          ranked.push_back(std::make_pair(-scores[touched[i]], touched[i]));
+        scores[touched[i]] = 0.0;
+        isTouched[touched[i]] = 0;
+      }
+      touched.clear();
+
+      std::sort(ranked.begin(), ranked.end());
+      for (size_t i = 0; i < ranked.size(); ++i)
+      {
+        neighbors[q].push_back(ranked[i].second);
+        similarities[q].push_back(-ranked[i].first);
+      }
+    }
+  }
+}
+
+void SparseCosineSearch::CheckQuerySet(const arma::sp_mat& querySet) const
+{
+  if (querySet.n_rows != Dimensionality())
+  {
+    Log::Fatal << "SparseCosineSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << Dimensionality() << ")!" << std::endl;
+  }
+}
+
+void SparseCosineSearch::QueryValues(
+    const arma::sp_mat& querySet,
+    const size_t query,
+    std::vector<std::pair<size_t, double>>& queryValues)
+{
+  queryValues.clear();
+  double norm = 0.0;
+  for (arma::sp_mat::const_iterator it = querySet.begin_col(query);
+       it != querySet.end_col(query); ++it)
+  {
+    if (*it != 0.0)
+    {
+      queryValues.push_back(std::make_pair((size_t) it.row(), (double) *it));
+      norm += (*it) * (*it);
+    }
+  }
+
+  // Points with no nonzero values have no values to accumulate.
+  norm = std::sqrt(norm);
+  for (size_t i = 0; i < queryValues.size(); ++i)
+    queryValues[i].second /= norm;
+}
+
+void SparseCosineSearch::SearchPoint(
+    const std::vector<std::pair<size_t, double>>& queryValues,
+    const size_t k,
+    const size_t exclude,
+    Accumulator& accumulator,
+    const size_t column,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& similarities) const
+{
+  std::vector<double>& scores = accumulator.scores;
+  std::vector<char>& isTouched = accumulator.isTouched;
+  std::vector<size_t>& touched = accumulator.touched;
+  std::vector<std::pair<double, size_t>>& ranked = accumulator.ranked;
+
+  // Accumulate the similarities from the lists of the nonzero dimensions.
+  for (size_t i = 0; i < queryValues.size(); ++i)
+  {
+    const size_t d = queryValues[i].first;
+    const double weight = queryValues[i].second;
+    for (size_t j = offsets[d]; j < offsets[d + 1]; ++j)
+    {
+      const size_t point = points[j];
+      if (!isTouched[point])
+      {
+        isTouched[point] = 1;
+        touched.push_back(point);
+      }
+
+      scores[point] += weight * values[j];
+    }
+  }
+
+  // Sort the best k candidates by decreasing similarity, then by index.
+  ranked.clear();
+  for (size_t i = 0; i < touched.size(); ++i)
+    if (touched[i] != exclude)
+      ranked.push_back(std::make_pair(-scores[touched[i]], touched[i]));
+  const size_t numRanked = std::min(k, ranked.size());
+  std::partial_sort(ranked.begin(), ranked.begin() + numRanked, ranked.end());
+
+  // First the candidates with a positive similarity.
+  size_t j = 0;
+  size_t r = 0;
+  for (; j < k && r < numRanked && ranked[r].first < 0.0; ++j, ++r)
+  {
+    neighbors(j, column) = ranked[r].second;
+    similarities(j, column) = -ranked[r].first;
+  }
+
+  // Then the points with similarity 0, by index: the points that are not
+  // candidates, and the candidates whose similarity is exactly 0.
+  for (size_t point = 0; j < k && point < numReferences; ++point)
+  {
+    if (point == exclude || (isTouched[point] && scores[point] != 0.0))
+      continue;
+
+    neighbors(j, column) = point;
+    similarities(j, column) = 0.0;
+    ++j;
+  }
+
+  // Then the candidates with a negative similarity.
+  for (; j < k && r < numRanked; ++r)
+  {
+    if (ranked[r].first == 0.0)
+      continue;
+
+    neighbors(j, column) = ranked[r].second;
+    similarities(j, column) = -ranked[r].first;
+    ++j;
+  }
+
+  for (size_t i = 0; i < touched.size(); ++i)
+  {
+    scores[touched[i]] = 0.0;
+    isTouched[touched[i]] = 0;
+  }
+  touched.clear();
+}
+
+void SparseCosineSearch::SearchAll(const arma::sp_mat& querySet,
+                                   const size_t k,
+                                   const bool sameSet,
+                                   arma::Mat<size_t>& neighbors,
+                                   arma::mat& similarities) const
+{
+  neighbors.set_size(k, querySet.n_cols);
+  similarities.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    Accumulator accumulator(numReferences);
+    std::vector<std::pair<size_t, double>> queryValues;
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      QueryValues(querySet, q, queryValues);
+      SearchPoint(queryValues, k, sameSet ? (size_t) q : SIZE_MAX,
+          accumulator, q, neighbors, similarities);
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
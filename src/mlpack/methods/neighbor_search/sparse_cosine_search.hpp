@@ -0,0 +1,199 @@
+/**
+ * @file methods/neighbor_search/sparse_cosine_search.hpp
+ *
+ * Definition of the SparseCosineSearch class, which finds the most similar
+ * points of sparse datasets under the cosine similarity with an inverted
+ * index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPARSE_COSINE_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPARSE_COSINE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The SparseCosineSearch class finds, for sparse query points (such as TF-IDF
+ * vectors of documents), the reference points with the highest cosine
+ * similarity, exactly.  Trees give little pruning on sparse high-dimensional
+ * data, so instead the normalized reference points are stored as an inverted
+ * index: for each dimension, the list of reference points that are nonzero in
+ * it, with their values.  The similarities of a query point are then
+ * accumulated from the lists of its nonzero dimensions only, which computes
+ * one column of the sparse product of the query and reference sets, and only
+ * touches the reference points that share a dimension with the query point.
+ *
+ * Search() with a number of neighbors k returns the k most similar reference
+ * points of each query point.  Search() with a similarity threshold returns
+ * all the reference points at least that similar, and uses prefix filtering
+ * (as in all-pairs similarity search, Bayardo, Ma and Srikant, 2007): the
+ * dimensions of the query point are processed by decreasing upper bound of
+ * their contribution, and once the bound of the remaining dimensions is below
+ * the threshold, no new candidate can reach the threshold, so the remaining
+ * lists only update the candidates already found.
+ *
+ * The query points are processed in parallel with OpenMP, in blocks; each
+ * thread accumulates the similarities in its own dense array.  Points with no
+ * nonzero values have similarity 0 to every point.  Ties are broken by index.
+ *
+ * @code
+ * arma::sp_mat documents; // One TF-IDF vector per column.
+ * SparseCosineSearch search(documents);
+ *
+ * // The 10 most similar documents of each document.
+ * arma::Mat<size_t> neighbors;
+ * arma::mat similarities;
+ * search.Search(10, neighbors, similarities);
+ *
+ * // All the pairs of documents with similarity at least 0.9.
+ * std::vector<std::vector<size_t>> duplicates;
+ * std::vector<std::vector<double>> duplicateSimilarities;
+ * search.Search(documents, 0.9, duplicates, duplicateSimilarities);
+ * @endcode
+ */
+class SparseCosineSearch
+{
+ public:
+  //! Create the object without a reference set.
+  SparseCosineSearch();
+
+  /**
+   * Build the inverted index of the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  SparseCosineSearch(const arma::sp_mat& referenceSet);
+
+  /**
+   * Build the inverted index of the given reference set, replacing the current
+   * one.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const arma::sp_mat& referenceSet);
+
+  /**
+   * Find the k most similar reference points of each query point.  The
+   * neighbors of each point are sorted by decreasing similarity.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param similarities Matrix storing the cosine similarities of the neighbors
+   *     of each query point.
+   */
+  void Search(const arma::sp_mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& similarities) const;
+
+  /**
+   * Find the k most similar reference points of each reference point, not
+   * counting the point itself.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param similarities Matrix storing the cosine similarities of the neighbors
+   *     of each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& similarities) const;
+
+  /**
+   * Find all the reference points whose cosine similarity with each query
+   * point is at least the given threshold.  The neighbors of each point are
+   * sorted by decreasing similarity.
+   *
+   * @param querySet Set of query points.
+   * @param threshold Minimum similarity; must be positive.
+   * @param neighbors Lists of neighbors of each query point.
+   * @param similarities Cosine similarities of the neighbors of each query
+   *     point.
+   */
+  void Search(const arma::sp_mat& querySet,
+              const double threshold,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& similarities) const;
+
+  //! Get the number of reference points.
+  size_t NumReferences() const { return numReferences; }
+  //! Get the dimensionality of the reference points.
+  size_t Dimensionality() const { return offsets.size() - 1; }
+
+ private:
+  //! The similarities accumulated for one query point.
+  struct Accumulator
+  {
+    //! Create the accumulator for the given number of reference points.
+    Accumulator(const size_t size) : scores(size, 0.0), isTouched(size, 0) { }
+
+    //! The similarity of each reference point.
+    std::vector<double> scores;
+    //! Whether each reference point is a candidate.
+    std::vector<char> isTouched;
+    //! The candidates.
+    std::vector<size_t> touched;
+    //! The candidates with the opposite of their similarity, to be sorted.
+    std::vector<std::pair<double, size_t>> ranked;
+  };
+
+  //! Check that the query set has the dimensionality of the reference set.
+  void CheckQuerySet(const arma::sp_mat& querySet) const;
+
+  /**
+   * Get the normalized nonzero values of the given query point, with their
+   * dimensions.
+   */
+  static void QueryValues(const arma::sp_mat& querySet,
+                          const size_t query,
+                          std::vector<std::pair<size_t, double>>& queryValues);
+
+  /**
+   * Find the k most similar reference points of the given query point, skipping
+   * the given reference point (or none, if exclude is SIZE_MAX), and store them
+   * in the given column of the results.
+   */
+  void SearchPoint(const std::vector<std::pair<size_t, double>>& queryValues,
+                   const size_t k,
+                   const size_t exclude,
+                   Accumulator& accumulator,
+                   const size_t column,
+                   arma::Mat<size_t>& neighbors,
+                   arma::mat& similarities) const;
+
+  /**
+   * Find the k most similar reference points of each query point, in parallel;
+   * if sameSet is true, the query points are the reference points.
+   */
+  void SearchAll(const arma::sp_mat& querySet,
+                 const size_t k,
+                 const bool sameSet,
+                 arma::Mat<size_t>& neighbors,
+                 arma::mat& similarities) const;
+
+  //! The number of reference points.
+  size_t numReferences;
+  //! The start of the list of each dimension, followed by the total size of
+  //! the lists.
+  std::vector<size_t> offsets;
+  //! The reference points of the lists of all the dimensions.
+  std::vector<size_t> points;
+  //! The normalized values of the reference points of the lists.
+  std::vector<double> values;
+  //! The largest absolute normalized value of each dimension.
+  std::vector<double> maxValues;
+  //! The reference set, for the monochromatic search.
+  arma::sp_mat referenceSet;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * @file methods/nn_descent/nn_descent.hpp
+ *
+ * Defines the NNDescent class, which builds an approximate k-nearest-neighbor
+ * graph of a dataset with the NN-Descent algorithm, as described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{dong2011efficient,
+ *   title={Efficient k-nearest neighbor graph construction for generic
+ *       similarity measures},
+ *   author={Dong, W. and Charikar, M. and Li, K.},
+ *   booktitle={Proceedings of the 20th International Conference on World Wide
+ *       Web (WWW '11)},
+ *   pages={577--586},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NNDescent class finds approximate k nearest neighbors of every point of
+ * a reference set (the all-points kNN graph), the same results as
+ * NeighborSearch::Search(k, neighbors, distances), without a tree.  It starts
+ * from random neighbors, and improves them by local joins: a neighbor of a
+ * neighbor is likely to be a neighbor, so in each iteration, the neighbors
+ * and reverse neighbors of each point are compared with each other, and each
+ * closer point found replaces the furthest neighbor of a list.  Only the pairs
+ * with at least one neighbor that is new since the last iteration are
+ * compared, and only a fraction SampleRate() of the new neighbors (and of the
+ * reverse neighbors) of each point takes part in each iteration.  The
+ * iterations stop when fewer than Tolerance() * k * n neighbors change in an
+ * iteration, or after MaxIterations() iterations.
+ *
+ * The Train() and Search(k, neighbors, distances) methods are those of
+ * NeighborSearch, so that the class can be given as a template parameter to
+ * methods that need the kNN graph of a dataset, in place of an exact search.
+ *
+ * The local joins are run with OpenMP, in parallel over the points; the lists
+ * of neighbors are protected by a set of locks.  The random choices are made
+ * from random streams that only depend on the random seed, but because of the
+ * parallel updates, the graph may change with the number of threads.  For the
+ * Euclidean distance, the graph is built with squared distances, which give the
+ * same order without a square root per evaluation.
+ *
+ * @tparam MetricType Metric to use for the search.
+ * @tparam MatType Type of matrix to use to store the data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class NNDescent
+{
+ public:
+  /**
+   * Create the NNDescent object with the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxIterations Maximum number of iterations of local joins.
+   * @param sampleRate Fraction of the new neighbors (and reverse neighbors) of
+   *     each point used in each iteration; must be in (0, 1].
+   * @param tolerance The iterations stop when fewer than tolerance * k * n
+   *     neighbors change in an iteration.
+   * @param metric Instantiated metric.
+   */
+  NNDescent(MatType referenceSet,
+            const size_t maxIterations = 10,
+            const double sampleRate = 0.5,
+            const double tolerance = 0.001,
+            const MetricType metric = MetricType());
+
+  /**
+   * Create the NNDescent object without a reference set.  Train() must be
+   * called before searching.
+   *
+   * @param maxIterations Maximum number of iterations of local joins.
+   * @param sampleRate Fraction of the new neighbors (and reverse neighbors) of
+   *     each point used in each iteration; must be in (0, 1].
+   * @param tolerance The iterations stop when fewer than tolerance * k * n
+   *     neighbors change in an iteration.
+   * @param metric Instantiated metric.
+   */
+  NNDescent(const size_t maxIterations = 10,
+            const double sampleRate = 0.5,
+            const double tolerance = 0.001,
+            const MetricType metric = MetricType());
+
+  /**
+   * Set the reference set.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Find the approximate k nearest neighbors of each point of the reference
+   * set, not counting the point itself.  The neighbors of each point are
+   * sorted by increasing distance.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the fraction of the new neighbors used in each iteration.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the fraction of the new neighbors used in each iteration.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the fraction of changed neighbors below which the iterations stop.
+  double Tolerance() const { return tolerance; }
+  //! Modify the fraction of changed neighbors below which the iterations stop.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of iterations of the last search.
+  size_t Iterations() const { return iterations; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  /**
+   * Fill the lists of neighbors with k distinct random points each, and mark
+   * them all as new.
+   */
+  void Initialize(const size_t k);
+
+  /**
+   * Choose the points compared by the local join of each point in this
+   * iteration: a sample of its new neighbors and new reverse neighbors, and
+   * its old neighbors and a sample of its old reverse neighbors.  The chosen
+   * new neighbors are marked as old.
+   */
+  void Sample(const size_t k,
+              std::vector<std::vector<size_t>>& newCandidates,
+              std::vector<std::vector<size_t>>& oldCandidates);
+
+  /**
+   * Compare the chosen points of each point with each other, in parallel, and
+   * return the number of changed neighbors.
+   */
+  size_t LocalJoin(const std::vector<std::vector<size_t>>& newCandidates,
+                   const std::vector<std::vector<size_t>>& oldCandidates,
+                   std::vector<std::mutex>& locks);
+
+  /**
+   * Put the given candidate in the list of neighbors of the given point, if it
+   * is closer than the furthest neighbor and not in the list yet.  Return
+   * whether the list changed.  The lock of the point must be held.
+   */
+  bool Insert(const size_t point,
+              const size_t candidate,
+              const double distance);
+
+  //! Evaluate the distance used to build the graph.
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b);
+
+  //! Whether the squared distance is used instead of the Euclidean distance.
+  static constexpr bool UseSquaredDistance =
+      std::is_same<MetricType, metric::EuclideanDistance>::value;
+
+  //! Number of locks protecting the lists of neighbors.
+  static constexpr size_t NumLocks = 4096;
+
+  //! Number of points that draw their random numbers from the same stream.
+  static constexpr size_t StreamBlockSize = 1024;
+
+  //! The reference set.
+  MatType referenceSet;
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Fraction of the new neighbors used in each iteration.
+  double sampleRate;
+  //! Fraction of changed neighbors below which the iterations stop.
+  double tolerance;
+  //! Number of iterations of the last search.
+  size_t iterations;
+
+  //! The neighbors of each point during the search, sorted by distance.
+  arma::Mat<size_t> graphNeighbors;
+  //! The distances to the neighbors of each point during the search.
+  arma::mat graphDistances;
+  //! Whether each neighbor is new since it was last used in a local join.
+  std::vector<char> isNew;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "nn_descent_impl.hpp"
+
+#endif
@@ -0,0 +1,349 @@
+/**
+ * @file methods/nn_descent/nn_descent_impl.hpp
+ *
+ * Implementation of the NNDescent class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nn_descent.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(MatType referenceSetIn,
+                                          const size_t maxIterations,
+                                          const double sampleRate,
+                                          const double tolerance,
+                                          const MetricType metric) :
+    NNDescent(maxIterations, sampleRate, tolerance, metric)
+{
+  Train(std::move(referenceSetIn));
+}
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(const size_t maxIterations,
+                                          const double sampleRate,
+                                          const double tolerance,
+                                          const MetricType metric) :
+    metric(metric),
+    maxIterations(maxIterations),
+    sampleRate(sampleRate),
+    tolerance(tolerance),
+    iterations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Search(const size_t k,
+                                            arma::Mat<size_t>& neighbors,
+                                            arma::mat& distances)
+{
+  const size_t n = referenceSet.n_cols;
+  if (k >= n)
+  {
+    Log::Fatal << "NNDescent::Search(): requested " << k << " neighbors, but "
+        << "the reference set has only " << n << " points, including the "
+        << "query point!" << std::endl;
+  }
+
+  if (sampleRate <= 0.0 || sampleRate > 1.0)
+  {
+    Log::Fatal << "NNDescent::Search(): sample rate must be in (0, 1] (given "
+        << sampleRate << ")!" << std::endl;
+  }
+
+  iterations = 0;
+  if (k == 0)
+  {
+    neighbors.set_size(0, n);
+    distances.set_size(0, n);
+    return;
+  }
+
+  Initialize(k);
+
+  std::vector<std::mutex> locks(std::min(n, (size_t) NumLocks));
+  std::vector<std::vector<size_t>> newCandidates, oldCandidates;
+  while (iterations < maxIterations)
+  {
+    Sample(k, newCandidates, oldCandidates);
+    const size_t updates = LocalJoin(newCandidates, oldCandidates, locks);
+    ++iterations;
+
+    Log::Info << "NNDescent::Search(): iteration " << iterations << ", "
+        << updates << " neighbors changed." << std::endl;
+    if ((double) updates <= tolerance * k * n)
+      break;
+  }
+
+  neighbors = std::move(graphNeighbors);
+  if (UseSquaredDistance)
+    distances = arma::sqrt(graphDistances);
+  else
+    distances = std::move(graphDistances);
+
+  graphNeighbors.reset();
+  graphDistances.reset();
+  isNew.clear();
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Initialize(const size_t k)
+{
+  const size_t n = referenceSet.n_cols;
+  graphNeighbors.set_size(k, n);
+  graphDistances.set_size(k, n);
+  isNew.assign(k * n, 1);
+
+  const size_t numBlocks = (n + StreamBlockSize - 1) / StreamBlockSize;
+  const size_t firstStream = math::ReserveRandomStreams(numBlocks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 generator = math::RandomStream(firstStream + b);
+    std::uniform_int_distribution<size_t> others(0, n - 2);
+    std::vector<size_t> points;
+    std::vector<std::pair<double, size_t>> list(k);
+
+    const size_t end = std::min((size_t) (b + 1) * StreamBlockSize, n);
+    for (size_t v = b * StreamBlockSize; v < end; ++v)
+    {
+      // Draw k distinct points other than v: by rejection if they are few, or
+      // with a partial shuffle of all the other points otherwise.
+      points.clear();
+      if (2 * k < n)
+      {
+        while (points.size() < k)
+        {
+          size_t point = others(generator);
+          if (point >= v)
+            ++point;
+          if (std::find(points.begin(), points.end(), point) == points.end())
+            points.push_back(point);
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < n; ++i)
+          if (i != v)
+            points.push_back(i);
+        for (size_t i = 0; i < k; ++i)
+        {
+          std::uniform_int_distribution<size_t> rest(i, points.size() - 1);
+          std::swap(points[i], points[rest(generator)]);
+        }
+      }
+
+      for (size_t i = 0; i < k; ++i)
+      {
+        list[i] = std::make_pair(Evaluate(referenceSet.col(v),
+            referenceSet.col(points[i])), points[i]);
+      }
+      std::sort(list.begin(), list.end());
+
+      for (size_t i = 0; i < k; ++i)
+      {
+        graphDistances(i, v) = list[i].first;
+        graphNeighbors(i, v) = list[i].second;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Sample(
+    const size_t k,
+    std::vector<std::vector<size_t>>& newCandidates,
+    std::vector<std::vector<size_t>>& oldCandidates)
+{
+  const size_t n = referenceSet.n_cols;
+  const size_t sampleSize = std::max((size_t) 1,
+      (size_t) std::ceil(sampleRate * k));
+  const size_t numBlocks = (n + StreamBlockSize - 1) / StreamBlockSize;
+
+  newCandidates.assign(n, std::vector<size_t>());
+  oldCandidates.assign(n, std::vector<size_t>());
+
+  // Sample the new neighbors of each point, and collect its old ones.
+  size_t firstStream = math::ReserveRandomStreams(numBlocks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 generator = math::RandomStream(firstStream + b);
+    std::vector<size_t> fresh;
+
+    const size_t end = std::min((size_t) (b + 1) * StreamBlockSize, n);
+    for (size_t v = b * StreamBlockSize; v < end; ++v)
+    {
+      fresh.clear();
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (isNew[v * k + j])
+          fresh.push_back(j);
+        else
+          oldCandidates[v].push_back(graphNeighbors(j, v));
+      }
+
+      const size_t count = std::min(sampleSize, fresh.size());
+      for (size_t i = 0; i < count; ++i)
+      {
+        std::uniform_int_distribution<size_t> rest(i, fresh.size() - 1);
+        std::swap(fresh[i], fresh[rest(generator)]);
+        newCandidates[v].push_back(graphNeighbors(fresh[i], v));
+        isNew[v * k + fresh[i]] = 0;
+      }
+    }
+  }
+
+  // The reverse neighbors of each point.
+  std::vector<std::vector<size_t>> newReverse(n), oldReverse(n);
+  for (size_t v = 0; v < n; ++v)
+  {
+    for (size_t i = 0; i < newCandidates[v].size(); ++i)
+      newReverse[newCandidates[v][i]].push_back(v);
+    for (size_t i = 0; i < oldCandidates[v].size(); ++i)
+      oldReverse[oldCandidates[v][i]].push_back(v);
+  }
+
+  // Add a sample of the reverse neighbors of each point to its candidates.
+  firstStream = math::ReserveRandomStreams(numBlocks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 generator = math::RandomStream(firstStream + b);
+
+    const size_t end = std::min((size_t) (b + 1) * StreamBlockSize, n);
+    for (size_t v = b * StreamBlockSize; v < end; ++v)
+    {
+      for (size_t c = 0; c < 2; ++c)
+      {
+        std::vector<size_t>& reverse = (c == 0) ? newReverse[v] :
+            oldReverse[v];
+        std::vector<size_t>& candidates = (c == 0) ? newCandidates[v] :
+            oldCandidates[v];
+
+        const size_t count = std::min(sampleSize, reverse.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+          std::uniform_int_distribution<size_t> rest(i, reverse.size() - 1);
+          std::swap(reverse[i], reverse[rest(generator)]);
+          candidates.push_back(reverse[i]);
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()),
+            candidates.end());
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+size_t NNDescent<MetricType, MatType>::LocalJoin(
+    const std::vector<std::vector<size_t>>& newCandidates,
+    const std::vector<std::vector<size_t>>& oldCandidates,
+    std::vector<std::mutex>& locks)
+{
+  size_t updates = 0;
+
+  #pragma omp parallel for schedule(dynamic, 16) reduction(+:updates)
+  for (omp_size_t v = 0; v < (omp_size_t) referenceSet.n_cols; ++v)
+  {
+    const std::vector<size_t>& fresh = newCandidates[v];
+    const std::vector<size_t>& old = oldCandidates[v];
+    for (size_t i = 0; i < fresh.size(); ++i)
+    {
+      const size_t a = fresh[i];
+
+      // Each pair of new candidates, and each new candidate with each old one.
+      for (size_t j = i + 1; j < fresh.size() + old.size(); ++j)
+      {
+        const size_t b = (j < fresh.size()) ? fresh[j] :
+            old[j - fresh.size()];
+        if (a == b)
+          continue;
+
+        const double distance = Evaluate(referenceSet.col(a),
+            referenceSet.col(b));
+        {
+          std::lock_guard<std::mutex> guard(locks[a % locks.size()]);
+          if (Insert(a, b, distance))
+            ++updates;
+        }
+        {
+          std::lock_guard<std::mutex> guard(locks[b % locks.size()]);
+          if (Insert(b, a, distance))
+            ++updates;
+        }
+      }
+    }
+  }
+
+  return updates;
+}
+
+template<typename MetricType, typename MatType>
+bool NNDescent<MetricType, MatType>::Insert(const size_t point,
+                                            const size_t candidate,
+                                            const double distance)
+{
+  const size_t k = graphNeighbors.n_rows;
+  double* pointDistances = graphDistances.colptr(point);
+  size_t* pointNeighbors = graphNeighbors.colptr(point);
+  char* pointIsNew = isNew.data() + point * k;
+
+  if (distance >= pointDistances[k - 1])
+    return false;
+  for (size_t j = 0; j < k; ++j)
+    if (pointNeighbors[j] == candidate)
+      return false;
+
+  // Shift the further neighbors down, dropping the furthest one.
+  size_t j = k - 1;
+  while (j > 0 && pointDistances[j - 1] > distance)
+  {
+    pointDistances[j] = pointDistances[j - 1];
+    pointNeighbors[j] = pointNeighbors[j - 1];
+    pointIsNew[j] = pointIsNew[j - 1];
+    --j;
+  }
+
+  pointDistances[j] = distance;
+  pointNeighbors[j] = candidate;
+  pointIsNew[j] = 1;
+  return true;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecTypeA, typename VecTypeB>
+double NNDescent<MetricType, MatType>::Evaluate(const VecTypeA& a,
+                                                const VecTypeB& b)
+{
+  if (UseSquaredDistance)
+    return metric::SquaredEuclideanDistance::Evaluate(a, b);
+  else
+    return metric.Evaluate(a, b);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -77,6 +77,51 @@ class RandomizedSVDPolicy
     transformedData = arma::trans(eigvec) * centeredData;
   }
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized SVD.  The data is centered implicitly, in the products with
+   * the data, so it is never made dense.  Only the first rank components are
+   * kept.
+   *
+   * @param data Sparse data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    // This matrix will store the right singular values; we do not need them.
+    arma::mat v;
+
+    // The mean of sparse data is dense, but small.
+    const arma::mat rowMean = arma::mat(arma::sum(data, 1)) / data.n_cols;
+
+    svd::RandomizedSVD rsvd(iteratedPower, maxIterations);
+    rsvd.Apply(data, eigvec, eigVal, v, rank, rowMean);
+
+    // The decomposition may hold more components than were asked for.
+    if (eigVal.n_elem > rank)
+    {
+      eigVal.shed_rows(rank, eigVal.n_elem - 1);
+      eigvec.shed_cols(rank, eigvec.n_cols - 1);
+    }
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal %= eigVal / (data.n_cols - 1);
+
+    // Project the centered samples to the principals; the product is
+    // computed as its transpose, (X - mean)' * eigvec.
+    math::CenteredMultiplyTrans(data, rowMean, eigvec, transformedData);
+    arma::inplace_trans(transformedData);
+  }
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
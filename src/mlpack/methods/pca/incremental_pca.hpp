@@ -0,0 +1,133 @@
+/**
+ * @file methods/pca/incremental_pca.hpp
+ *
+ * Defines the IncrementalPCA class, which performs principal components
+ * analysis on data that is given one chunk of points at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+#define MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * This class implements incremental principal components analysis: the mean
+ * and the top principal components of a dataset are updated from one chunk of
+ * points at a time, so that the whole dataset never has to be in memory.  Each
+ * update computes the thin SVD of the current components (scaled by their
+ * singular values), the centered chunk and a correction for the change of the
+ * mean, as in the incremental SVD of Ross et al. (2008):
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title={Incremental learning for robust visual tracking},
+ *   author={Ross, D.A. and Lim, J. and Lin, R.-S. and Yang, M.-H.},
+ *   journal={International Journal of Computer Vision},
+ *   volume={77},
+ *   number={1--3},
+ *   pages={125--141},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each update takes O(d (k + m)^2) time and O(d (k + m)) memory, for points of
+ * dimension d, rank k and chunks of m points.  If the rank is the full
+ * dimensionality, the results are those of PCA on all the points; otherwise
+ * the discarded components make them an approximation.
+ *
+ * @code
+ * IncrementalPCA pca(10);
+ * for (size_t i = 0; i < numChunks; ++i)
+ *   pca.Update(chunks[i]);
+ *
+ * arma::mat transformed;
+ * pca.Transform(chunks[0], transformed);
+ * @endcode
+ */
+class IncrementalPCA
+{
+ public:
+  /**
+   * Create the IncrementalPCA object, which keeps the given number of principal
+   * components.
+   *
+   * @param rank Number of principal components to keep.
+   */
+  IncrementalPCA(const size_t rank = 0);
+
+  /**
+   * Update the mean and the principal components with the given chunk of
+   * points.  All chunks must have the same dimensionality.
+   *
+   * @param chunk New points (one per column).
+   */
+  void Update(const arma::mat& chunk);
+
+  /**
+   * Project the given points onto the principal components found so far.  This
+   * can be called on any number of chunks; it is safe to pass the same matrix
+   * for both parameters.
+   *
+   * @param data Points to transform (one per column).
+   * @param transformedData Matrix to store the transformed points in.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const;
+
+  /**
+   * Forget all the points seen so far.
+   */
+  void Reset();
+
+  //! Get the number of principal components to keep.
+  size_t Rank() const { return rank; }
+  //! Modify the number of principal components to keep (before any update).
+  size_t& Rank() { return rank; }
+
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the principal components (one per column).
+  const arma::mat& EigenVectors() const { return eigvec; }
+  //! Get the variances along the principal components, in decreasing order.
+  arma::vec EigenValues() const;
+
+  /**
+   * Get the fraction of the total variance of the points seen so far that is
+   * kept by the principal components (between 0 and 1).
+   */
+  double VarianceRetained() const;
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Number of principal components to keep.
+  size_t rank;
+  //! Number of points seen so far.
+  size_t numPoints;
+  //! Mean of the points seen so far.
+  arma::vec mean;
+  //! Principal components.
+  arma::mat eigvec;
+  //! Singular values of the centered points, for each principal component.
+  arma::vec singularValues;
+  //! Sum of the squared distances of the points to the mean.
+  double totalScatter;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+// Include implementation.
+#include "incremental_pca_impl.hpp"
+
+#endif
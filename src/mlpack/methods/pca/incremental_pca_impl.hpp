@@ -0,0 +1,141 @@
+/**
+ * @file methods/pca/incremental_pca_impl.hpp
+ *
+ * Implementation of the IncrementalPCA class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_INCREMENTAL_PCA_IMPL_HPP
+#define MLPACK_METHODS_PCA_INCREMENTAL_PCA_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "incremental_pca.hpp"
+
+namespace mlpack {
+namespace pca {
+
+inline IncrementalPCA::IncrementalPCA(const size_t rank) :
+    rank(rank),
+    numPoints(0),
+    totalScatter(0.0)
+{
+  // Nothing to do.
+}
+
+inline void IncrementalPCA::Update(const arma::mat& chunk)
+{
+  if (chunk.n_cols == 0)
+    return;
+
+  if (numPoints > 0 && chunk.n_rows != mean.n_elem)
+  {
+    Log::Fatal << "IncrementalPCA::Update(): dimensionality of chunk ("
+        << chunk.n_rows << ") does not match the dimensionality of the points "
+        << "seen so far (" << mean.n_elem << ")!" << std::endl;
+  }
+
+  const size_t k = (rank == 0) ? chunk.n_rows : std::min(rank, chunk.n_rows);
+  const double n = (double) numPoints;
+  const double m = (double) chunk.n_cols;
+
+  const arma::vec chunkMean = arma::mean(chunk, 1);
+
+  // The centered points are, up to rotation, the current components scaled by
+  // their singular values, the centered chunk, and one point that accounts for
+  // the move of the mean.
+  arma::mat stacked(chunk.n_rows, eigvec.n_cols + chunk.n_cols +
+      (numPoints > 0 ? 1 : 0));
+  if (eigvec.n_cols > 0)
+  {
+    stacked.cols(0, eigvec.n_cols - 1) = eigvec *
+        arma::diagmat(singularValues);
+  }
+  stacked.cols(eigvec.n_cols, eigvec.n_cols + chunk.n_cols - 1) =
+      chunk.each_col() - chunkMean;
+
+  double chunkScatter = arma::accu(arma::square(
+      stacked.cols(eigvec.n_cols, eigvec.n_cols + chunk.n_cols - 1)));
+  if (numPoints > 0)
+  {
+    const arma::vec shift = std::sqrt(n * m / (n + m)) * (chunkMean - mean);
+    stacked.col(stacked.n_cols - 1) = shift;
+    chunkScatter += arma::dot(shift, shift);
+  }
+
+  arma::mat u, v;
+  arma::vec s;
+  if (!arma::svd_econ(u, s, v, stacked, 'l'))
+  {
+    Log::Fatal << "IncrementalPCA::Update(): SVD failed!" << std::endl;
+  }
+
+  const size_t kept = std::min(k, (size_t) s.n_elem);
+  eigvec = u.cols(0, kept - 1);
+  singularValues = s.subvec(0, kept - 1);
+
+  if (numPoints == 0)
+    mean = chunkMean;
+  else
+    mean = (n * mean + m * chunkMean) / (n + m);
+
+  totalScatter += chunkScatter;
+  numPoints += chunk.n_cols;
+}
+
+inline void IncrementalPCA::Transform(const arma::mat& data,
+                                      arma::mat& transformedData) const
+{
+  if (data.n_rows != mean.n_elem)
+  {
+    Log::Fatal << "IncrementalPCA::Transform(): dimensionality of data ("
+        << data.n_rows << ") does not match the dimensionality of the points "
+        << "seen so far (" << mean.n_elem << ")!" << std::endl;
+  }
+
+  transformedData = eigvec.t() * (data.each_col() - mean);
+}
+
+inline void IncrementalPCA::Reset()
+{
+  numPoints = 0;
+  mean.reset();
+  eigvec.reset();
+  singularValues.reset();
+  totalScatter = 0.0;
+}
+
+inline arma::vec IncrementalPCA::EigenValues() const
+{
+  if (numPoints < 2)
+    return arma::zeros<arma::vec>(singularValues.n_elem);
+
+  return arma::square(singularValues) / (numPoints - 1);
+}
+
+inline double IncrementalPCA::VarianceRetained() const
+{
+  if (totalScatter == 0.0)
+    return 1.0;
+
+  return std::min(arma::accu(arma::square(singularValues)) / totalScatter,
+      1.0);
+}
+
+template<typename Archive>
+void IncrementalPCA::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(rank));
+  ar(CEREAL_NVP(numPoints));
+  ar(CEREAL_NVP(mean));
+  ar(CEREAL_NVP(eigvec));
+  ar(CEREAL_NVP(singularValues));
+  ar(CEREAL_NVP(totalScatter));
+}
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
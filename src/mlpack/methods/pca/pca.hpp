@@ -77,6 +77,25 @@ class PCA
   void Apply(const arma::mat& data,
              arma::mat& transformedData);
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set,
+   * keeping the given number of components.  The data is centered implicitly
+   * and is never made dense; this needs a decomposition policy that handles
+   * sparse data (RandomizedSVDPolicy or RandomizedBlockKrylovSVDPolicy).
+   * Scaling is not supported for sparse data.
+   *
+   * @param data Sparse data matrix.
+   * @param transformedData Matrix to store results of PCA in.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Number of principal components to compute.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank);
+
   /**
    * Use PCA for dimensionality reduction on the given dataset. This will save
    * the newDimension largest principal components of the data and remove the
@@ -86,6 +86,39 @@ void PCA<DecompositionPolicy>::Apply(const arma::mat& data,
   Apply(data, transformedData, eigVal, eigvec);
 }
 
+/**
+ * Apply Principal Component Analysis to the provided sparse data set, without
+ * making it dense.
+ *
+ * @param data - Sparse data matrix.
+ * @param transformedData - Data with PCA applied.
+ * @param eigVal - contains eigen values in a column vector
+ * @param eigvec - PCA Loadings/Coeffs/EigenVectors
+ * @param rank - Number of components to compute.
+ */
+template<typename DecompositionPolicy>
+void PCA<DecompositionPolicy>::Apply(const arma::sp_mat& data,
+                                     arma::mat& transformedData,
+                                     arma::vec& eigVal,
+                                     arma::mat& eigvec,
+                                     const size_t rank)
+{
+  if (scaleData)
+  {
+    Log::Fatal << "PCA::Apply(): scaling is not supported for sparse data!"
+        << std::endl;
+  }
+
+  if (rank == 0 || rank > data.n_rows)
+  {
+    Log::Fatal << "PCA::Apply(): rank (" << rank << ") must be between 1 and "
+        << "the dimensionality of the data (" << data.n_rows << ")!"
+        << std::endl;
+  }
+
+  decomposition.Apply(data, transformedData, eigVal, eigvec, rank);
+}
+
 /**
  * Use PCA for dimensionality reduction on the given dataset.  This will save
  * the newDimension largest principal components of the data and remove the
@@ -21,6 +21,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include "pca.hpp"
+#include "incremental_pca.hpp"
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
@@ -60,7 +61,12 @@ BINDING_LONG_DESC(
     "Multiple different decomposition techniques can be used.  The method to "
     "use can be specified with the " +
     PRINT_PARAM_STRING("decomposition_method") + " parameter, and it may take "
-    "the values 'exact', 'randomized', or 'quic'.");
+    "the values 'exact', 'randomized', 'randomized-block-krylov', 'quic', or "
+    "'incremental'.  The 'incremental' method updates the principal components "
+    "from chunks of " + PRINT_PARAM_STRING("chunk_size") + " points at a time "
+    "and transforms the data chunk by chunk, so it needs no centered copy of "
+    "the dataset; it supports neither " + PRINT_PARAM_STRING("scale") + " nor "
+    + PRINT_PARAM_STRING("var_to_retain") + ".");
 
 // Example.
 BINDING_EXAMPLE(
@@ -91,7 +97,56 @@ PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
 
 PARAM_STRING_IN("decomposition_method", "Method used for the principal "
     "components analysis: 'exact', 'randomized', 'randomized-block-krylov', "
-    "'quic'.", "c", "exact");
+    "'quic', 'incremental'.", "c", "exact");
+PARAM_INT_IN("chunk_size", "Number of points in each chunk for the "
+    "'incremental' decomposition method.", "", 10000);
+
+//! Run incremental PCA on the specified dataset, one chunk at a time.
+void RunIncrementalPCA(util::Params& params,
+                       util::Timers& timers,
+                       arma::mat& dataset,
+                       const size_t newDimension)
+{
+  if (params.Has("scale"))
+  {
+    Log::Fatal << "Scaling is not supported by the 'incremental' "
+        << "decomposition method!" << endl;
+  }
+  if (params.Has("var_to_retain"))
+  {
+    Log::Fatal << "Variance to retain is not supported by the 'incremental' "
+        << "decomposition method; specify the new dimensionality instead!"
+        << endl;
+  }
+  RequireParamValue<int>(params, "chunk_size", [](int x) { return x > 0; },
+      true, "chunk size must be positive");
+  const size_t chunkSize = (size_t) params.Get<int>("chunk_size");
+
+  IncrementalPCA p(newDimension);
+
+  Log::Info << "Performing incremental PCA on dataset..." << endl;
+
+  timers.Start("pca");
+  for (size_t i = 0; i < dataset.n_cols; i += chunkSize)
+  {
+    const size_t end = std::min(i + chunkSize, (size_t) dataset.n_cols);
+    p.Update(dataset.cols(i, end - 1));
+  }
+
+  arma::mat transformedData(p.EigenVectors().n_cols, dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; i += chunkSize)
+  {
+    const size_t end = std::min(i + chunkSize, (size_t) dataset.n_cols);
+    arma::mat transformedChunk;
+    p.Transform(dataset.cols(i, end - 1), transformedChunk);
+    transformedData.cols(i, end - 1) = transformedChunk;
+  }
+  dataset = std::move(transformedData);
+  timers.Stop("pca");
+
+  Log::Info << (p.VarianceRetained() * 100) << "% of variance retained ("
+      << dataset.n_rows << " dimensions)." << endl;
+}
 
 
 //! Run RunPCA on the specified dataset with the given decomposition method.
@@ -138,7 +193,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   // Check decomposition method validity.
   RequireParamInSet<string>(params, "decomposition_method",
-      { "exact", "randomized", "randomized-block-krylov", "quic" }, true,
+      { "exact", "randomized", "randomized-block-krylov", "quic",
+      "incremental" }, true,
       "unknown decomposition method");
 
   // Find out what dimension we want.
@@ -185,6 +241,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     RunPCA<QUICSVDPolicy>(params, timers, dataset, newDimension, scale,
         varToRetain);
   }
+  else if (decompositionMethod == "incremental")
+  {
+    RunIncrementalPCA(params, timers, dataset, newDimension);
+  }
 
   // Now save the results.
   if (params.Has("output"))
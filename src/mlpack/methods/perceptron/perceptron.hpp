@@ -26,6 +26,23 @@ namespace perceptron {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * Training can be split over shards of the dataset with iterative parameter
+ * mixing: in each iteration, a copy of the model is trained on each shard (in
+ * parallel, with OpenMP), and the copies are then averaged.  The averaged
+ * model converges too if the dataset is separable.  See NumShards().
+ *
+ * @code
+ * @inproceedings{mcdonald2010distributed,
+ *   title = {Distributed Training Strategies for the Structured Perceptron},
+ *   author = {McDonald, Ryan and Hall, Keith and Mann, Gideon},
+ *   booktitle = {Human Language Technologies: The 2010 Annual Conference of
+ *       the North American Chapter of the Association for Computational
+ *       Linguistics},
+ *   pages = {456--464},
+ *   year = {2010}
+ * }
+ * @endcode
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomInitialization.
@@ -95,6 +112,10 @@ class Perceptron
    * This training does not reset the model weights, so you can call Train() on
    * multiple datasets sequentially.
    *
+   * If NumShards() is not 1, each iteration trains a copy of the model on each
+   * contiguous shard of the dataset, in parallel, and then averages the
+   * copies; training has converged when no copy made a mistake.
+   *
    * @param data Dataset on which training should be performed.
    * @param labels Labels of the dataset.
    * @param numClasses Number of classes in the data.
@@ -127,6 +148,12 @@ class Perceptron
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of shards training is split over.
+  size_t NumShards() const { return numShards; }
+  //! Modify the number of shards training is split over (1 means sequential
+  //! training, 0 means one shard for each OpenMP thread).
+  size_t& NumShards() { return numShards; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -141,9 +168,26 @@ class Perceptron
   arma::vec& Biases() { return biases; }
 
  private:
+  /**
+   * Make one pass of the perceptron learning algorithm over the points [begin,
+   * end) of the dataset, updating the given weights and biases.
+   *
+   * @return The number of points that were misclassified.
+   */
+  size_t TrainPass(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::rowvec& instanceWeights,
+                   const size_t begin,
+                   const size_t end,
+                   arma::mat& passWeights,
+                   arma::vec& passBiases) const;
+
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of shards training is split over.
+  size_t numShards;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -14,6 +14,10 @@
 
 #include "perceptron.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace perceptron {
 
@@ -30,7 +34,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    numShards(1)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -56,7 +61,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    numShards(1)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +90,8 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    numShards(other.numShards)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,16 +113,14 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  // Compute the scores of all of the points at once.
+  arma::mat scores = weights.t() * test;
+  scores.each_col() += biases;
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; ++i)
-  {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
-  }
+  predictedLabels.set_size(test.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) test.n_cols; ++i)
+    predictedLabels[i] = scores.col(i).index_max();
 }
 
 /**
@@ -145,8 +150,82 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
-  size_t j, i = 0;
+  #ifdef HAS_OPENMP
+  const size_t threads = (size_t) omp_get_max_threads();
+  #else
+  const size_t threads = 1;
+  #endif
+  const size_t shards = std::max(std::min((numShards == 0) ? threads :
+      numShards, (size_t) data.n_cols), (size_t) 1);
+
+  size_t i = 0;
   bool converged = false;
+  if (shards == 1)
+  {
+    // This loop is for each iteration, and we use the 'converged' variable for
+    // noting whether or not convergence has been reached.
+    while ((i < maxIterations) && (!converged))
+    {
+      ++i;
+      converged = (TrainPass(data, labels, instanceWeights, 0, data.n_cols,
+          weights, biases) == 0);
+    }
+
+    return;
+  }
+
+  // Iterative parameter mixing: each shard starts from the mixed model of the
+  // last iteration.
+  std::vector<arma::mat> shardWeights(shards);
+  std::vector<arma::vec> shardBiases(shards);
+  while ((i < maxIterations) && (!converged))
+  {
+    ++i;
+
+    size_t mistakes = 0;
+    #pragma omp parallel for schedule(static) reduction(+:mistakes)
+    for (omp_size_t s = 0; s < (omp_size_t) shards; ++s)
+    {
+      shardWeights[s] = weights;
+      shardBiases[s] = biases;
+      mistakes += TrainPass(data, labels, instanceWeights,
+          (size_t) s * data.n_cols / shards,
+          ((size_t) s + 1) * data.n_cols / shards,
+          shardWeights[s], shardBiases[s]);
+    }
+
+    // If no shard made a mistake, none of the copies changed.
+    converged = (mistakes == 0);
+    if (converged)
+      break;
+
+    weights = shardWeights[0];
+    biases = shardBiases[0];
+    for (size_t s = 1; s < shards; ++s)
+    {
+      weights += shardWeights[s];
+      biases += shardBiases[s];
+    }
+    weights /= (double) shards;
+    biases /= (double) shards;
+  }
+}
+
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+size_t Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::TrainPass(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const arma::rowvec& instanceWeights,
+    const size_t begin,
+    const size_t end,
+    arma::mat& passWeights,
+    arma::vec& passBiases) const
+{
+  size_t mistakes = 0;
   size_t tempLabel;
   arma::uword maxIndexRow = 0, maxIndexCol = 0;
   arma::mat tempLabelMat;
@@ -155,41 +234,35 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
 
   const bool hasWeights = (instanceWeights.n_elem > 0);
 
-  while ((i < maxIterations) && (!converged))
+  // Go through the points in this pass.
+  for (size_t j = begin; j < end; ++j)
   {
-    // This outer loop is for each iteration, and we use the 'converged'
-    // variable for noting whether or not convergence has been reached.
-    ++i;
-    converged = true;
+    // Multiply for each variable and check whether the current weight vector
+    // correctly classifies this.
+    tempLabelMat = passWeights.t() * data.col(j) + passBiases;
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; ++j)
+    tempLabelMat.max(maxIndexRow, maxIndexCol);
+
+    // Check whether prediction is correct.
+    if (maxIndexRow != labels(0, j))
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
-
-      tempLabelMat.max(maxIndexRow, maxIndexCol);
-
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
-      {
-        // Due to incorrect prediction, convergence set to false.
-        converged = false;
-        tempLabel = labels(0, j);
-
-        // Send maxIndexRow for knowing which weight to update, send j to know
-        // the value of the vector to update it with.  Send tempLabel to know
-        // the correct class.
-        if (hasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
-      }
+      // Due to incorrect prediction, this point counts as a mistake.
+      ++mistakes;
+      tempLabel = labels(0, j);
+
+      // Send maxIndexRow for knowing which weight to update, send j to know
+      // the value of the vector to update it with.  Send tempLabel to know
+      // the correct class.
+      if (hasWeights)
+        LP.UpdateWeights(data.col(j), passWeights, passBiases, maxIndexRow,
+            tempLabel, instanceWeights(j));
+      else
+        LP.UpdateWeights(data.col(j), passWeights, passBiases, maxIndexRow,
+            tempLabel);
     }
   }
+
+  return mistakes;
 }
 
 //! Serialize the perceptron.
@@ -199,16 +272,30 @@ template<typename LearnPolicy,
 template<typename Archive>
 void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::serialize(
     Archive& ar,
-    const uint32_t /* version */)
+    const uint32_t version)
 {
   // We just need to serialize the maximum number of iterations, the weights,
   // and the biases.
   ar(CEREAL_NVP(maxIterations));
   ar(CEREAL_NVP(weights));
   ar(CEREAL_NVP(biases));
+
+  // Before version 1, training was always sequential.
+  if (version > 0)
+    ar(CEREAL_NVP(numShards));
+  else if (cereal::is_loading<Archive>())
+    numShards = 1;
 }
 
 } // namespace perceptron
 } // namespace mlpack
 
+// Since version 1, the number of shards is stored.
+CEREAL_TEMPLATE_CLASS_VERSION((template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType>),
+    (mlpack::perceptron::Perceptron<LearnPolicy, WeightInitializationPolicy,
+    MatType>), (1));
+
 #endif
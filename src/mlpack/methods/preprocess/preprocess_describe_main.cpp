@@ -11,6 +11,8 @@
  */
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/io.hpp>
+#include <mlpack/core/data/data_source.hpp>
+#include <mlpack/core/data/descriptive_statistics.hpp>
 
 #ifdef BINDING_NAME
   #undef BINDING_NAME
@@ -51,7 +53,16 @@ BINDING_LONG_DESC(
     "specific dimension to analyze if there are too many dimensions. The " +
     PRINT_PARAM_STRING("population") + " parameter can be specified when the "
     "dataset should be considered as a population.  Otherwise, the dataset "
-    "will be considered as a sample.");
+    "will be considered as a sample."
+    "\n\n"
+    "All the statistics are computed in a single pass over the data, in "
+    "parallel.  A dataset that does not fit in memory can be given as the "
+    "name of a file with " + PRINT_PARAM_STRING("input_file") + " instead of "
+    "with " + PRINT_PARAM_STRING("input") + "; it is then read " +
+    PRINT_PARAM_STRING("batch_size") + " points at a time.  The medians are "
+    "estimated with a quantile sketch, which keeps " +
+    PRINT_PARAM_STRING("sketch_size") + " values per level for each "
+    "dimension; they are exact for datasets of at most that many points.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -73,7 +84,14 @@ BINDING_SEE_ALSO("@preprocess_imputer", "#preprocess_imputer");
 BINDING_SEE_ALSO("@preprocess_split", "#preprocess_split");
 
 // Define parameters for data.
-PARAM_MATRIX_IN_REQ("input", "Matrix containing data,", "i");
+PARAM_MATRIX_IN("input", "Matrix containing data.", "i");
+PARAM_STRING_IN("input_file", "File containing data, read in batches instead "
+    "of being loaded into memory (CSV, TSV, TXT, or Armadillo binary with one "
+    "point per column).", "f", "");
+PARAM_INT_IN("batch_size", "Number of points read at a time from the input "
+    "file.", "b", 100000);
+PARAM_INT_IN("sketch_size", "Number of values kept per level of the quantile "
+    "sketch of each dimension, used to estimate the medians.", "s", 512);
 PARAM_INT_IN("dimension", "Dimension of the data. Use this to specify a "
     "dimension", "d", 0);
 PARAM_INT_IN("precision", "Precision of the output statistics.", "p", 4);
@@ -85,107 +103,31 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
 
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
-{
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
+void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
+  RequireOnlyOnePassed(params, { "input", "input_file" }, true);
+  if (params.Has("input_file"))
   {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
+    ReportIgnoredParam(params, "row_major", "the points of an input file are "
+        "always described by dimension");
   }
   else
   {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
+    ReportIgnoredParam(params, "batch_size", "the data is already in memory");
   }
-  return kurtosis;
-}
 
-/**
- * Calculates standard error of standard deviation.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @return Standard error of the stanrdard devation of the given vector.
- */
-double StandardError(const size_t size, const double& fStd)
-{
-  return fStd / sqrt(size);
-}
+  RequireParamValue<int>(params, "batch_size", [](int x) { return x > 0; },
+      true, "batch size must be positive");
+  RequireParamValue<int>(params, "sketch_size", [](int x) { return x > 1; },
+      true, "sketch size must be at least 2");
 
-void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
-{
   const size_t dimension = static_cast<size_t>(params.Get<int>("dimension"));
   const size_t precision = static_cast<size_t>(params.Get<int>("precision"));
   const size_t width = static_cast<size_t>(params.Get<int>("width"));
   const bool population = params.Has("population");
-  const bool rowMajor = params.Has("row_major");
-
-  // Load the data.
-  arma::mat& data = params.Get<arma::mat>("input");
+  const bool rowMajor = params.Has("row_major") && params.Has("input");
+  const size_t sketchSize = static_cast<size_t>(
+      params.Get<int>("sketch_size"));
 
   // Generate boost format recipe.
   const string widthPrecision("%-" + to_string(width) + "." +
@@ -201,56 +143,90 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     numberFormat += widthPrecision + "f";
   }
 
+  // Compute all the statistics in one pass over the data.  If the user
+  // specified a dimension of in-memory data, only that dimension is described.
   timers.Start("statistics");
+  DescriptiveStatistics statistics(sketchSize);
+  size_t firstDimension = 0;
+  if (params.Has("input_file"))
+  {
+    DataSource<> source(params.Get<string>("input_file"),
+        (size_t) params.Get<int>("batch_size"));
+    arma::mat batch;
+    while (source.Next(batch))
+      statistics.Update(batch);
+  }
+  else
+  {
+    arma::mat& data = params.Get<arma::mat>("input");
+    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
+    if (params.Has("dimension"))
+    {
+      if (dimension >= dimensions)
+      {
+        Log::Fatal << "Invalid dimension " << dimension << " specified; the "
+            << "data has " << dimensions << " dimensions!" << endl;
+      }
+
+      firstDimension = dimension;
+      if (rowMajor)
+        statistics.Update(arma::mat(data.col(dimension).t()));
+      else
+        statistics.Update(arma::mat(data.row(dimension)));
+    }
+    else if (rowMajor)
+    {
+      statistics.Update(arma::mat(data.t()));
+    }
+    else
+    {
+      statistics.Update(data);
+    }
+  }
+
+  if (statistics.Count() == 0)
+    Log::Fatal << "The input data holds no points!" << endl;
+
+  if (params.Has("dimension") &&
+      dimension >= firstDimension + statistics.Dimensionality())
+  {
+    Log::Fatal << "Invalid dimension " << dimension << " specified; the data "
+        << "has " << statistics.Dimensionality() << " dimensions!" << endl;
+  }
+
+  const arma::vec variance = statistics.Variance(population);
+  const arma::vec stddev = statistics.StandardDeviation(population);
+  const arma::vec median = statistics.Median();
+  const arma::vec skewness = statistics.Skewness(population);
+  const arma::vec kurtosis = statistics.Kurtosis(population);
+  timers.Stop("statistics");
+
   // Print the headers.
   Log::Info << boost::format(stringFormat)
       % "dim" % "var" % "mean" % "std" % "median" % "min" % "max"
       % "range" % "skew" % "kurt" % "SE" << endl;
 
-  // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
+  // Print statistics of the described dimensions.
+  const size_t begin = params.Has("dimension") ? dimension : 0;
+  const size_t end = params.Has("dimension") ? dimension + 1 :
+      statistics.Dimensionality();
+  for (size_t dim = begin; dim < end; ++dim)
   {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
-    else
-      feature = data.row(dim);
-
-    // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
-
-    // Print statistics of the given dimension.
+    const size_t i = dim - firstDimension;
+    const double fMin = statistics.Min()[i];
+    const double fMax = statistics.Max()[i];
     Log::Info << boost::format(numberFormat)
         % dim
-        % arma::var(feature, population)
-        % fMean
-        % fStd
-        % arma::median(feature)
+        % variance[i]
+        % statistics.Mean()[i]
+        % stddev[i]
+        % median[i]
         % fMin
         % fMax
         % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
+        % skewness[i]
+        % kurtosis[i]
+        % (stddev[i] / sqrt(statistics.Count())) // standard error
         << endl;
-  };
-
-  // If the user specified dimension, describe statistics of the given
-  // dimension. If a dimension is not specified, describe all dimensions.
-  if (params.Has("dimension"))
-  {
-    PrintStatResults(dimension, rowMajor);
   }
-  else
-  {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
-    {
-      PrintStatResults(i, rowMajor);
-    }
-  }
-  timers.Stop("statistics");
 }
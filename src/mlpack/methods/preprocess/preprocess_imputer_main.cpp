@@ -186,35 +186,31 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     else
     {
       // when --dimension is not specified,
-      // the program will apply the changes to all dimensions.
+      // the program will apply the changes to all dimensions at once.
       Log::Info << "Performing '" << strategy << "' imputation strategy "
           << "to replace '" << missingValue << "' on all dimensions." << endl;
 
       if (strategy == "mean")
       {
         Imputer<double, MapperType, MeanImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue, dirtyDimensions);
       }
       else if (strategy == "median")
       {
         Imputer<double, MapperType, MedianImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue, dirtyDimensions);
       }
       else if (strategy == "listwise_deletion")
       {
         Imputer<double, MapperType, ListwiseDeletion<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue, dirtyDimensions);
       }
       else if (strategy == "custom")
       {
         CustomImputation<double> strat(customValue);
         Imputer<double, MapperType, CustomImputation<double>> imputer(
             info, strat);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
+        imputer.Impute(input, missingValue, dirtyDimensions);
       }
       else
       {
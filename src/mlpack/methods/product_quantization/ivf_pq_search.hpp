@@ -0,0 +1,162 @@
+/**
+ * @file methods/product_quantization/ivf_pq_search.hpp
+ *
+ * Defines the IVFPQSearch class, an inverted file index of product-quantized
+ * points for approximate nearest neighbor search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_IVF_PQ_SEARCH_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_IVF_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ivf/coarse_quantizer.hpp>
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The IVFPQSearch class finds approximate nearest neighbors in a compressed
+ * reference set, with the inverted file of product-quantized residuals
+ * (IVFADC) of Jégou et al.  The reference points are clustered into
+ * NumLists() lists by a CoarseQuantizer, as in IVFSearch, and each point is
+ * stored in its list as the ProductQuantizer code of its residual to the list
+ * centroid, so the index holds NumSubspaces() bytes and one index per point
+ * instead of the points themselves.
+ *
+ * A query only visits the NumProbes() lists whose centroids are closest to
+ * it; in each of them, the distances to the points are estimated from one
+ * distance table of the query residual (the asymmetric distance computation of
+ * ProductQuantizer).  Searches are parallel over the query points.  With a
+ * single list, the search is an exhaustive scan of the codes.
+ *
+ * @tparam MatType Type of matrix of the points.
+ */
+template<typename MatType = arma::mat>
+class IVFPQSearch
+{
+ public:
+  /**
+   * Build the index of the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of lists of the coarse quantizer.
+   * @param numSubspaces Number of subspaces of the product quantizer; each
+   *     point is stored in this many bytes.
+   * @param numCentroids Number of centroids of each codebook of the product
+   *     quantizer; at most 256.
+   * @param numProbes Number of lists visited by each search.
+   * @param rotationIterations Number of iterations of optimized product
+   *     quantization; if 0, the residuals are not rotated.
+   * @param maxIterations Maximum number of iterations of k-means.
+   */
+  IVFPQSearch(const MatType& referenceSet,
+              const size_t numLists = 64,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const size_t numProbes = 8,
+              const size_t rotationIterations = 0,
+              const size_t maxIterations = 25);
+
+  /**
+   * Create the index without a reference set.  Train() must be called before
+   * searching.
+   *
+   * @param numLists Number of lists of the coarse quantizer.
+   * @param numSubspaces Number of subspaces of the product quantizer.
+   * @param numCentroids Number of centroids of each codebook; at most 256.
+   * @param numProbes Number of lists visited by each search.
+   * @param rotationIterations Number of iterations of optimized product
+   *     quantization.
+   * @param maxIterations Maximum number of iterations of k-means.
+   */
+  IVFPQSearch(const size_t numLists = 64,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const size_t numProbes = 8,
+              const size_t rotationIterations = 0,
+              const size_t maxIterations = 25);
+
+  /**
+   * Build the index of the given reference set, replacing the current one.
+   * The reference set is not kept.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Find the approximate k nearest neighbors of each point of the query set,
+   * with the distances estimated from the codes.  If the visited lists hold
+   * fewer than k points, the rest of the results are filled with SIZE_MAX and
+   * DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing the estimated distances of neighbors for
+   *     each query point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the number of lists of the coarse quantizer.
+  size_t NumLists() const { return coarseQuantizer.NumLists(); }
+  //! Get the number of reference points.
+  size_t NumPoints() const { return codes.n_cols; }
+
+  //! Get the number of lists visited by each search.
+  size_t NumProbes() const { return numProbes; }
+  //! Modify the number of lists visited by each search.
+  size_t& NumProbes() { return numProbes; }
+
+  //! Get the product quantizer of the residuals.
+  const ProductQuantizer<arma::mat>& Quantizer() const { return quantizer; }
+  //! Get the coarse quantizer.
+  const CoarseQuantizer<arma::mat>& Coarse() const { return coarseQuantizer; }
+  //! Get the codes of the reference points, grouped by list.
+  const arma::Mat<uint8_t>& Codes() const { return codes; }
+  //! Get the index in the reference set of each code.
+  const arma::Col<size_t>& Indices() const
+  {
+    return coarseQuantizer.Indices();
+  }
+  //! Get the position of the first code of each list (and the number of codes
+  //! at the end).
+  const arma::Col<size_t>& ListOffsets() const
+  {
+    return coarseQuantizer.ListOffsets();
+  }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A reference point and its estimated squared distance to the query.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Number of lists visited by each search.
+  size_t numProbes;
+
+  //! The coarse quantizer.
+  CoarseQuantizer<arma::mat> coarseQuantizer;
+  //! The product quantizer of the residuals to the list centroids.
+  ProductQuantizer<arma::mat> quantizer;
+  //! The codes of the reference points, grouped by list.
+  arma::Mat<uint8_t> codes;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_pq_search_impl.hpp"
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file methods/product_quantization/ivf_pq_search_impl.hpp
+ *
+ * Implementation of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_IVF_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_IVF_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_pq_search.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const MatType& referenceSet,
+                                  const size_t numLists,
+                                  const size_t numSubspaces,
+                                  const size_t numCentroids,
+                                  const size_t numProbes,
+                                  const size_t rotationIterations,
+                                  const size_t maxIterations) :
+    IVFPQSearch(numLists, numSubspaces, numCentroids, numProbes,
+        rotationIterations, maxIterations)
+{
+  Train(referenceSet);
+}
+
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const size_t numLists,
+                                  const size_t numSubspaces,
+                                  const size_t numCentroids,
+                                  const size_t numProbes,
+                                  const size_t rotationIterations,
+                                  const size_t maxIterations) :
+    numProbes(numProbes),
+    coarseQuantizer(numLists, maxIterations),
+    quantizer(numSubspaces, numCentroids, rotationIterations, maxIterations)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::Train(const MatType& referenceSet)
+{
+  // Cluster the points into the lists, and quantize their residuals.
+  arma::mat residuals = arma::conv_to<arma::mat>::from(referenceSet);
+  arma::Row<size_t> assignments;
+  coarseQuantizer.Train(residuals, assignments);
+
+  const arma::mat& centroids = coarseQuantizer.Centroids();
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) residuals.n_cols; ++i)
+    residuals.col(i) -= centroids.col(assignments[i]);
+
+  quantizer.Train(residuals);
+
+  arma::Mat<uint8_t> unsortedCodes;
+  quantizer.Encode(residuals, unsortedCodes);
+
+  // Group the codes by list.
+  const arma::Col<size_t>& indices = coarseQuantizer.Indices();
+  codes.set_size(unsortedCodes.n_rows, unsortedCodes.n_cols);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    codes.col(i) = unsortedCodes.col(indices[i]);
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::Search(const MatType& querySet,
+                                  const size_t k,
+                                  arma::Mat<size_t>& neighbors,
+                                  arma::mat& distances) const
+{
+  if (k > codes.n_cols)
+  {
+    Log::Fatal << "IVFPQSearch::Search(): requested " << k << " neighbors, "
+        << "but the reference set has only " << codes.n_cols << " points!"
+        << std::endl;
+  }
+
+  const arma::mat& centroids = coarseQuantizer.Centroids();
+  if (querySet.n_rows != centroids.n_rows)
+  {
+    Log::Fatal << "IVFPQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") does not match the dimensionality of the "
+        << "reference set (" << centroids.n_rows << ")!" << std::endl;
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  const size_t numLists = coarseQuantizer.NumLists();
+  const size_t probes = std::min(std::max(numProbes, (size_t) 1), numLists);
+  const size_t numSubspaces = quantizer.NumSubspaces();
+  const arma::Col<size_t>& indices = coarseQuantizer.Indices();
+
+  #pragma omp parallel
+  {
+    arma::vec query, residual;
+    arma::mat table;
+    std::vector<Candidate> lists;
+    std::priority_queue<Candidate> best;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      query = arma::conv_to<arma::vec>::from(querySet.col(q));
+
+      // Find the closest lists.
+      coarseQuantizer.Probe(query, probes, lists);
+
+      // Scan the codes of each list with the distance table of the query
+      // residual, keeping the k closest points.
+      for (size_t p = 0; p < probes; ++p)
+      {
+        const size_t l = lists[p].second;
+        residual = query - centroids.col(l);
+        quantizer.DistanceTable(residual, table);
+
+        const size_t begin = coarseQuantizer.ListBegin(l);
+        const size_t end = coarseQuantizer.ListEnd(l);
+        const uint8_t* code = codes.memptr() + begin * numSubspaces;
+        for (size_t i = begin; i < end; ++i, code += numSubspaces)
+        {
+          const double distance = quantizer.AsymmetricDistance(table, code);
+          if (best.size() < k)
+            best.push(Candidate(distance, indices[i]));
+          else if (distance < best.top().first)
+          {
+            best.pop();
+            best.push(Candidate(distance, indices[i]));
+          }
+        }
+      }
+
+      // The queue holds the furthest point first.
+      for (size_t j = k; j > 0; --j)
+      {
+        if (j > best.size())
+        {
+          neighbors(j - 1, q) = SIZE_MAX;
+          distances(j - 1, q) = DBL_MAX;
+        }
+        else
+        {
+          neighbors(j - 1, q) = best.top().second;
+          distances(j - 1, q) = std::sqrt(std::max(best.top().first, 0.0));
+          best.pop();
+        }
+      }
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void IVFPQSearch<MatType>::serialize(Archive& ar,
+                                     const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numProbes));
+  ar(CEREAL_NVP(coarseQuantizer));
+  ar(CEREAL_NVP(quantizer));
+  ar(CEREAL_NVP(codes));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
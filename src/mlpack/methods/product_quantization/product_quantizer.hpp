@@ -0,0 +1,234 @@
+/**
+ * @file methods/product_quantization/product_quantizer.hpp
+ *
+ * Defines the ProductQuantizer class, which compresses points into byte codes
+ * with product quantization, as described in the following paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The optional rotation is the non-parametric optimized product quantization
+ * of the following paper:
+ *
+ * @code
+ * @article{ge2014optimized,
+ *   title={Optimized product quantization},
+ *   author={Ge, T. and He, K. and Ke, Q. and Sun, J.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={36},
+ *   number={4},
+ *   pages={744--755},
+ *   year={2014}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ProductQuantizer class splits the dimensions of the points into
+ * NumSubspaces() contiguous groups, and quantizes each group separately with
+ * a codebook of NumCentroids() centroids found by kmeans::KMeans.  A point is
+ * then stored as one byte per subspace, the index of its closest centroid in
+ * each codebook; with 8 subspaces, a 256-dimensional point takes 8 bytes
+ * instead of 2 kilobytes.
+ *
+ * The squared Euclidean distance between a query point and an encoded point is
+ * estimated without decoding it (asymmetric distance computation): the squared
+ * distances between the query and every centroid of every subspace are
+ * computed once with DistanceTable(), and the distance to each encoded point is
+ * then the sum of one table entry per subspace, given by AsymmetricDistance().
+ * The table holds the entries of each subspace contiguously, so that this sum
+ * only reads NumSubspaces() values.
+ *
+ * If RotationIterations() is not 0, the points are rotated before they are
+ * split, with an orthogonal matrix chosen to reduce the quantization error
+ * (optimized product quantization); the rotation alternates with the training
+ * of the codebooks for the given number of iterations.
+ *
+ * The quantizer only keeps the codebooks, so it can be used as the storage of
+ * any index of points: IVFPQSearch uses it to encode the residuals of the
+ * points to their coarse centroid.
+ *
+ * @tparam MatType Type of matrix of the points to encode.
+ */
+template<typename MatType = arma::mat>
+class ProductQuantizer
+{
+ public:
+  /**
+   * Create the quantizer without training it.  Train() must be called before
+   * encoding points.
+   *
+   * @param numSubspaces Number of groups of dimensions, each quantized
+   *     separately; each point is encoded in this many bytes.
+   * @param numCentroids Number of centroids of each codebook; at most 256.
+   * @param rotationIterations Number of iterations of optimized product
+   *     quantization; if 0, the points are not rotated.
+   * @param maxIterations Maximum number of iterations of k-means for each
+   *     codebook.
+   */
+  ProductQuantizer(const size_t numSubspaces = 8,
+                   const size_t numCentroids = 256,
+                   const size_t rotationIterations = 0,
+                   const size_t maxIterations = 25);
+
+  /**
+   * Train the quantizer on the given points.
+   *
+   * @param data Points to train the codebooks on.
+   * @param numSubspaces Number of groups of dimensions, each quantized
+   *     separately; each point is encoded in this many bytes.
+   * @param numCentroids Number of centroids of each codebook; at most 256.
+   * @param rotationIterations Number of iterations of optimized product
+   *     quantization; if 0, the points are not rotated.
+   * @param maxIterations Maximum number of iterations of k-means for each
+   *     codebook.
+   */
+  ProductQuantizer(const MatType& data,
+                   const size_t numSubspaces = 8,
+                   const size_t numCentroids = 256,
+                   const size_t rotationIterations = 0,
+                   const size_t maxIterations = 25);
+
+  /**
+   * Train the codebooks (and the rotation, if RotationIterations() is not 0)
+   * on the given points, replacing the current ones.
+   *
+   * @param data Points to train the codebooks on; there must be at least
+   *     NumCentroids() of them.
+   */
+  void Train(const MatType& data);
+
+  /**
+   * Encode the given points, in parallel.
+   *
+   * @param data Points to encode.
+   * @param codes Matrix to store the codes in, with one column per point and
+   *     one row per subspace.
+   */
+  void Encode(const MatType& data, arma::Mat<uint8_t>& codes) const;
+
+  /**
+   * Decode the given codes into the closest point of each codebook.
+   *
+   * @param codes Codes to decode, as returned by Encode().
+   * @param data Matrix to store the decoded points in.
+   */
+  void Decode(const arma::Mat<uint8_t>& codes, arma::mat& data) const;
+
+  /**
+   * Compute the squared Euclidean distances between the given query point and
+   * every centroid of every codebook.
+   *
+   * @param query Query point.
+   * @param table Matrix to store the distances in, with one column per
+   *     subspace and one row per centroid.
+   */
+  template<typename VecType>
+  void DistanceTable(const VecType& query, arma::mat& table) const;
+
+  /**
+   * Estimate the squared Euclidean distance between the query point of the
+   * given table and an encoded point.
+   *
+   * @param table Distance table of the query point, from DistanceTable().
+   * @param code Code of the point: NumSubspaces() bytes.
+   */
+  double AsymmetricDistance(const arma::mat& table, const uint8_t* code) const
+  {
+    const double* t = table.memptr();
+    double distance = 0.0;
+    for (size_t s = 0; s < numSubspaces; ++s, t += numCentroids)
+      distance += t[code[s]];
+    return distance;
+  }
+
+  //! Get the number of subspaces.
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of centroids of each codebook.
+  size_t NumCentroids() const { return numCentroids; }
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the number of iterations of optimized product quantization.
+  size_t RotationIterations() const { return rotationIterations; }
+  //! Modify the number of iterations of optimized product quantization.
+  //! Train() must be called again for this to have any effect.
+  size_t& RotationIterations() { return rotationIterations; }
+
+  //! Get the maximum number of iterations of k-means.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of k-means.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the rotation applied to the points (empty if there is none).
+  const arma::mat& Rotation() const { return rotation; }
+  //! Get the codebook of the given subspace.
+  const arma::mat& Codebook(const size_t s) const { return codebooks[s]; }
+
+  //! Get the first dimension of the given subspace.
+  size_t SubspaceBegin(const size_t s) const
+  {
+    return s * dimensionality / numSubspaces;
+  }
+
+  //! Serialize the quantizer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Train the codebooks on the (rotated) points.
+  void TrainCodebooks(const arma::mat& data, const bool initialGuess);
+
+  //! Encode the (rotated) points.
+  template<typename DenseMatType>
+  void EncodeRotated(const DenseMatType& data, arma::Mat<uint8_t>& codes) const;
+
+  //! Decode the codes, without undoing the rotation.
+  void DecodeRotated(const arma::Mat<uint8_t>& codes, arma::mat& data) const;
+
+  //! Number of groups of dimensions.
+  size_t numSubspaces;
+  //! Number of centroids of each codebook.
+  size_t numCentroids;
+  //! Number of iterations of optimized product quantization.
+  size_t rotationIterations;
+  //! Maximum number of iterations of k-means.
+  size_t maxIterations;
+
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Rotation applied to the points (empty if there is none).
+  arma::mat rotation;
+  //! Codebook of each subspace, with one centroid per column.
+  std::vector<arma::mat> codebooks;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "product_quantizer_impl.hpp"
+
+#endif
@@ -0,0 +1,262 @@
+/**
+ * @file methods/product_quantization/product_quantizer_impl.hpp
+ *
+ * Implementation of the ProductQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_IMPL_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+ProductQuantizer<MatType>::ProductQuantizer(const size_t numSubspaces,
+                                            const size_t numCentroids,
+                                            const size_t rotationIterations,
+                                            const size_t maxIterations) :
+    numSubspaces(numSubspaces),
+    numCentroids(numCentroids),
+    rotationIterations(rotationIterations),
+    maxIterations(maxIterations),
+    dimensionality(0)
+{
+  if (numSubspaces == 0)
+  {
+    Log::Fatal << "ProductQuantizer::ProductQuantizer(): numSubspaces must be "
+        << "positive!" << std::endl;
+  }
+
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    Log::Fatal << "ProductQuantizer::ProductQuantizer(): numCentroids must be "
+        << "between 1 and 256 (given " << numCentroids << ")!" << std::endl;
+  }
+}
+
+template<typename MatType>
+ProductQuantizer<MatType>::ProductQuantizer(const MatType& data,
+                                            const size_t numSubspaces,
+                                            const size_t numCentroids,
+                                            const size_t rotationIterations,
+                                            const size_t maxIterations) :
+    ProductQuantizer(numSubspaces, numCentroids, rotationIterations,
+        maxIterations)
+{
+  Train(data);
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Train(const MatType& data)
+{
+  if (numSubspaces > data.n_rows)
+  {
+    Log::Fatal << "ProductQuantizer::Train(): numSubspaces (" << numSubspaces
+        << ") must not be greater than the dimensionality of the data ("
+        << data.n_rows << ")!" << std::endl;
+  }
+
+  if (numCentroids > data.n_cols)
+  {
+    Log::Fatal << "ProductQuantizer::Train(): numCentroids (" << numCentroids
+        << ") must not be greater than the number of points (" << data.n_cols
+        << ")!" << std::endl;
+  }
+
+  dimensionality = data.n_rows;
+  codebooks.resize(numSubspaces);
+
+  arma::mat points = arma::conv_to<arma::mat>::from(data);
+  if (rotationIterations == 0)
+  {
+    rotation.reset();
+    TrainCodebooks(points, false);
+    return;
+  }
+
+  // Alternate between the codebooks for the current rotation and the rotation
+  // that best maps the points to their reconstructions: R = U V^T, where
+  // U S V^T is the singular value decomposition of Y X^T.
+  arma::mat rotated = points;
+  arma::Mat<uint8_t> codes;
+  arma::mat reconstructed, u, v;
+  arma::vec s;
+  for (size_t i = 0; i < rotationIterations; ++i)
+  {
+    TrainCodebooks(rotated, i > 0);
+    EncodeRotated(rotated, codes);
+    DecodeRotated(codes, reconstructed);
+
+    if (!arma::svd(u, s, v, reconstructed * points.t()))
+    {
+      Log::Warn << "ProductQuantizer::Train(): singular value decomposition "
+          << "failed; keeping the rotation of the previous iteration."
+          << std::endl;
+      break;
+    }
+
+    rotation = u * v.t();
+    rotated = rotation * points;
+  }
+
+  // Train the codebooks for the final rotation.
+  TrainCodebooks(rotated, true);
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Encode(const MatType& data,
+                                       arma::Mat<uint8_t>& codes) const
+{
+  if (data.n_rows != dimensionality)
+  {
+    Log::Fatal << "ProductQuantizer::Encode(): dimensionality of the data ("
+        << data.n_rows << ") does not match the dimensionality of the "
+        << "quantizer (" << dimensionality << ")!" << std::endl;
+  }
+
+  if (rotation.is_empty())
+    EncodeRotated(data, codes);
+  else
+    EncodeRotated(arma::mat(rotation * data), codes);
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Decode(const arma::Mat<uint8_t>& codes,
+                                       arma::mat& data) const
+{
+  if (codes.n_rows != numSubspaces)
+  {
+    Log::Fatal << "ProductQuantizer::Decode(): codes have " << codes.n_rows
+        << " rows, but the quantizer has " << numSubspaces << " subspaces!"
+        << std::endl;
+  }
+
+  DecodeRotated(codes, data);
+
+  // The rotation is orthogonal, so its inverse is its transpose.
+  if (!rotation.is_empty())
+    data = rotation.t() * data;
+}
+
+template<typename MatType>
+template<typename VecType>
+void ProductQuantizer<MatType>::DistanceTable(const VecType& query,
+                                              arma::mat& table) const
+{
+  const arma::vec point = rotation.is_empty() ?
+      arma::conv_to<arma::vec>::from(query) : arma::vec(rotation * query);
+
+  table.set_size(numCentroids, numSubspaces);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const size_t begin = SubspaceBegin(s);
+    const size_t end = SubspaceBegin(s + 1);
+    for (size_t c = 0; c < numCentroids; ++c)
+    {
+      const double* centroid = codebooks[s].colptr(c);
+      double distance = 0.0;
+      for (size_t j = begin; j < end; ++j)
+      {
+        const double diff = point[j] - centroid[j - begin];
+        distance += diff * diff;
+      }
+
+      table(c, s) = distance;
+    }
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::TrainCodebooks(const arma::mat& data,
+                                               const bool initialGuess)
+{
+  // k-means is parallel by itself, so the subspaces are trained one at a time.
+  kmeans::KMeans<> kmeans(maxIterations);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const arma::mat subspace = data.rows(SubspaceBegin(s),
+        SubspaceBegin(s + 1) - 1);
+    kmeans.Cluster(subspace, numCentroids, codebooks[s], initialGuess);
+  }
+}
+
+template<typename MatType>
+template<typename DenseMatType>
+void ProductQuantizer<MatType>::EncodeRotated(const DenseMatType& data,
+                                              arma::Mat<uint8_t>& codes) const
+{
+  codes.set_size(numSubspaces, data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    const typename DenseMatType::elem_type* point = data.colptr(i);
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      const size_t begin = SubspaceBegin(s);
+      const size_t end = SubspaceBegin(s + 1);
+
+      size_t best = 0;
+      double bestDistance = DBL_MAX;
+      for (size_t c = 0; c < numCentroids; ++c)
+      {
+        const double* centroid = codebooks[s].colptr(c);
+        double distance = 0.0;
+        for (size_t j = begin; j < end; ++j)
+        {
+          const double diff = point[j] - centroid[j - begin];
+          distance += diff * diff;
+        }
+
+        if (distance < bestDistance)
+        {
+          bestDistance = distance;
+          best = c;
+        }
+      }
+
+      codes(s, i) = (uint8_t) best;
+    }
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::DecodeRotated(const arma::Mat<uint8_t>& codes,
+                                              arma::mat& data) const
+{
+  data.set_size(dimensionality, codes.n_cols);
+  for (size_t i = 0; i < codes.n_cols; ++i)
+  {
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      data.col(i).subvec(SubspaceBegin(s), SubspaceBegin(s + 1) - 1) =
+          codebooks[s].col(codes(s, i));
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void ProductQuantizer<MatType>::serialize(Archive& ar,
+                                          const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numSubspaces));
+  ar(CEREAL_NVP(numCentroids));
+  ar(CEREAL_NVP(rotationIterations));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(dimensionality));
+  ar(CEREAL_NVP(rotation));
+  ar(CEREAL_NVP(codebooks));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
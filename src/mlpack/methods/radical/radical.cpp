@@ -24,18 +24,28 @@ Radical::Radical(const double noiseStdDev,
                  const size_t replicates,
                  const size_t angles,
                  const size_t sweeps,
-                 const size_t m) :
+                 const size_t m,
+                 const size_t samples) :
     noiseStdDev(noiseStdDev),
     replicates(replicates),
     angles(angles),
     sweeps(sweeps),
-    m(m)
+    m(m),
+    samples(samples)
 {
   // Nothing to do here.
 }
 
 void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 {
+  if (samples > 0 && samples < replicates * x.n_rows)
+  {
+    const uvec points = randi<uvec>(samples,
+        distr_param(0, (int) x.n_rows - 1));
+    xNew = x.rows(points) + noiseStdDev * randn(samples, x.n_cols);
+    return;
+  }
+
   xNew = repmat(x, replicates, 1) + noiseStdDev * randn(replicates * x.n_rows,
       x.n_cols);
 }
@@ -44,7 +54,11 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 double Radical::Vasicek(vec& z) const
 {
   z = sort(z);
+  return SortedVasicek(z);
+}
 
+double Radical::SortedVasicek(const vec& z) const
+{
   // Apparently slower.
   /*
   vec logs = log(z.subvec(m, z.n_elem - 1) - z.subvec(0, z.n_elem - 1 - m));
@@ -64,32 +78,79 @@ double Radical::Vasicek(vec& z) const
 }
 
 
+/**
+ * Sort the given values into sorted, given the order that sorted the previous
+ * values (which is updated).  If the order is empty, or has changed too much,
+ * the values are sorted from scratch.
+ */
+static void SortFromOrder(const vec& values, uvec& order, vec& sorted)
+{
+  if (order.n_elem != values.n_elem)
+  {
+    order = sort_index(values);
+    sorted = values.elem(order);
+    return;
+  }
+
+  // Insertion sort is linear if the order has barely changed; give up on it
+  // after a linear number of moves.
+  sorted = values.elem(order);
+  const size_t maxMoves = 8 * (size_t) values.n_elem;
+  size_t moves = 0;
+  for (uword i = 1; i < sorted.n_elem; ++i)
+  {
+    const double value = sorted[i];
+    const uword index = order[i];
+    uword k = i;
+    for (; k > 0 && sorted[k - 1] > value && moves < maxMoves; --k, ++moves)
+    {
+      sorted[k] = sorted[k - 1];
+      order[k] = order[k - 1];
+    }
+    sorted[k] = value;
+    order[k] = index;
+
+    if (moves >= maxMoves)
+    {
+      order = sort_index(values);
+      sorted = values.elem(order);
+      return;
+    }
+  }
+}
+
 double Radical::DoRadical2D(const mat& matX, util::Timers& timers)
 {
   timers.Start("radical_copy_and_perturb");
   CopyAndPerturb(perturbed, matX);
   timers.Stop("radical_copy_and_perturb");
 
-  mat::fixed<2, 2> matJacobi;
-
   vec values(angles);
 
-  for (size_t i = 0; i < angles; ++i)
+  #pragma omp parallel
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
+    // Each thread takes a contiguous range of angles, so that the order of the
+    // projections at the last angle is a good start for sorting them.
+    vec candidateY, sorted;
+    uvec order1, order2;
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
-
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
-
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) angles; ++i)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
+
+      // These are the columns of perturbed * matJacobi, for the Jacobi
+      // rotation by theta.
+      candidateY = cosTheta * perturbed.col(0) - sinTheta * perturbed.col(1);
+      SortFromOrder(candidateY, order1, sorted);
+      values(i) = SortedVasicek(sorted);
+
+      candidateY = sinTheta * perturbed.col(0) + cosTheta * perturbed.col(1);
+      SortFromOrder(candidateY, order2, sorted);
+      values(i) += SortedVasicek(sorted);
+    }
   }
 
   uword indOpt = 0;
@@ -137,8 +198,6 @@ void Radical::DoRadical(const mat& matXT,
 
   mat matYSubspace(nPoints, 2);
 
-  mat matJ = eye(nDims, nDims);
-
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
@@ -158,19 +217,11 @@ void Radical::DoRadical(const mat& matXT,
         const double cosThetaOpt = cos(thetaOpt);
         const double sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
-
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        // Multiplying matY by the Jacobi rotation only changes columns i and
+        // j, so only they are rotated.
+        const vec matYi = matY.col(i);
+        matY.col(i) = cosThetaOpt * matYi - sinThetaOpt * matY.col(j);
+        matY.col(j) = sinThetaOpt * matYi + cosThetaOpt * matY.col(j);
       }
     }
   }
@@ -28,6 +28,13 @@ namespace radical {
  * The goal is to find a square unmixing matrix W such that Y = W X and
  * the rows of Y are independent components.
  *
+ * The angles of the brute-force search in Radical2D are evaluated in parallel
+ * with OpenMP.  Each thread evaluates a contiguous range of angles, and the
+ * sorted order of the projections at one angle is the starting point for
+ * sorting them at the next, which is much quicker when the angles are close.
+ * Instead of all of the replicates, a random sample of them can be used (see
+ * Samples()).
+ *
  * For more details, see the following paper:
  *
  * @code
@@ -56,12 +63,15 @@ class Radical
    * @param sweeps Number of sweeps.  Each sweep calls Radical2D once for each
    *    pair of dimensions
    * @param m The variable m from Vasicek's m-spacing estimator of entropy.
+   * @param samples Number of Gaussian-perturbed replicates (over all points)
+   *    to sample in Radical2D; 0 means all of them are used.
    */
   Radical(const double noiseStdDev = 0.175,
           const size_t replicates = 30,
           const size_t angles = 150,
           const size_t sweeps = 0,
-          const size_t m = 0);
+          const size_t m = 0,
+          const size_t samples = 0);
 
   /**
    * Run RADICAL.
@@ -89,7 +99,9 @@ class Radical
   /**
    * Make replicates of each data point (the number of replicates is set in
    * either the constructor or with Replicates()) and perturb data with Gaussian
-   * noise with standard deviation noiseStdDev.
+   * noise with standard deviation noiseStdDev.  If Samples() is nonzero and
+   * less than the number of replicates, only that many replicates, of randomly
+   * chosen points, are made.
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
@@ -117,7 +129,20 @@ class Radical
   //! Modify the number of sweeps.
   size_t& Sweeps() { return sweeps; }
 
+  //! Get the number of replicates sampled in Radical2D (0 means all).
+  size_t Samples() const { return samples; }
+  //! Modify the number of replicates sampled in Radical2D (0 means all).
+  size_t& Samples() { return samples; }
+
  private:
+  /**
+   * Vasicek's m-spacing estimator of entropy, for a sample that is already
+   * sorted.
+   *
+   * @param z Sorted empirical sample.
+   */
+  double SortedVasicek(const arma::vec& z) const;
+
   //! Standard deviation of the Gaussian noise added to the replicates of
   //! the data points during Radical2D.
   double noiseStdDev;
@@ -135,10 +160,11 @@ class Radical
   //! Value of m to use for Vasicek's m-spacing estimator of entropy.
   size_t m;
 
+  //! Number of replicates to sample in Radical2D (0 means all).
+  size_t samples;
+
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
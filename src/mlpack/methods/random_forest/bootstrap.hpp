@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  *
  * Implementation of the Bootstrap() function, which creates a bootstrapped
- * dataset from the given input dataset.
+ * dataset from the given input dataset, and of BootstrapIndices(), which
+ * samples the points of a bootstrapped dataset without copying them.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -13,6 +14,8 @@
 #ifndef MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 #define MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 
+#include <mlpack/core/math/random.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -44,6 +47,55 @@ void Bootstrap(const MatType& dataset,
     bootstrapWeights = weights.cols(indices);
 }
 
+/**
+ * Create a bootstrap sample of the given number of points without copying any
+ * data.  Each point that is sampled at least once is stored in indices (in
+ * increasing order), and its weight in bootstrapWeights is the number of times
+ * it was sampled (multiplied by its weight in weights, if UseWeights is true).
+ * Training with these weights on the indexed points is then equivalent to
+ * training with weights on the bootstrapped dataset.
+ *
+ * The random numbers are drawn from the given generator.
+ */
+template<bool UseWeights, typename WeightsType>
+void BootstrapIndices(const size_t numPoints,
+                      const WeightsType& weights,
+                      arma::uvec& indices,
+                      arma::rowvec& bootstrapWeights,
+                      std::mt19937& generator)
+{
+  // Random sampling with replacement.
+  std::uniform_int_distribution<size_t> sample(0, numPoints - 1);
+  arma::Row<size_t> counts(numPoints, arma::fill::zeros);
+  for (size_t i = 0; i < numPoints; ++i)
+    ++counts[sample(generator)];
+
+  indices = arma::find(counts);
+  bootstrapWeights.set_size(indices.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    bootstrapWeights[i] = (double) counts[indices[i]];
+    if (UseWeights)
+      bootstrapWeights[i] *= weights[indices[i]];
+  }
+}
+
+/**
+ * Create a bootstrap sample of the given number of points without copying any
+ * data, like above, with the random numbers drawn from a new random stream
+ * (see math::RandomStream()).
+ */
+template<bool UseWeights, typename WeightsType>
+void BootstrapIndices(const size_t numPoints,
+                      const WeightsType& weights,
+                      arma::uvec& indices,
+                      arma::rowvec& bootstrapWeights)
+{
+  std::mt19937 generator = math::RandomStream(math::ReserveRandomStreams(1));
+  BootstrapIndices<UseWeights>(numPoints, weights, indices, bootstrapWeights,
+      generator);
+}
+
 } // namespace tree
 } // namespace mlpack
 
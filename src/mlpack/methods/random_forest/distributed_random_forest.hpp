@@ -0,0 +1,152 @@
+/**
+ * @file methods/random_forest/distributed_random_forest.hpp
+ *
+ * Definition of the DistributedRandomForest class, which trains the trees of a
+ * random forest in several processes, each on its shard of the dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_DISTRIBUTED_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_DISTRIBUTED_RANDOM_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/local_communicator.hpp>
+
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * DistributedRandomForest trains a random forest on a dataset whose shards are
+ * held by several processes (the ranks of the communicator; see
+ * kmeans::LocalCommunicator and kmeans::MPICommunicator).  Each rank trains its
+ * share of the trees with RandomForest::Train(), on bootstrap samples of its
+ * own shard, so the dataset is never moved between the ranks.
+ *
+ * The trees of all the ranks can then be used in two ways:
+ *
+ *  - Merge() gathers them (through the serialization of the forests) into one
+ *    RandomForest on every rank, which can classify the points of each rank
+ *    independently, or be saved.
+ *  - Classify() classifies the same points on every rank with the local trees
+ *    only, and sums the class probabilities over the ranks, so that no rank
+ *    ever holds the whole forest.
+ *
+ * Each call of Train(), Merge() and Classify() must be made by all the ranks
+ * at the same time.  The random number generator of each rank should be
+ * seeded differently (for instance with math::RandomSeed(seed + rank)), so
+ * that the ranks do not select the same dimensions.
+ *
+ * @code
+ * kmeans::MPICommunicator communicator;
+ * DistributedRandomForest<kmeans::MPICommunicator> distributed(communicator);
+ * distributed.Train(shard, shardLabels, numClasses, 1000);
+ *
+ * RandomForest<> forest;
+ * distributed.Merge(forest);
+ * if (communicator.Rank() == 0)
+ *   data::Save("forest.bin", "forest", forest);
+ * @endcode
+ *
+ * @tparam CommunicatorType Communicator of the ranks.
+ * @tparam ForestType Type of the random forest to train.
+ */
+template<typename CommunicatorType = kmeans::LocalCommunicator,
+         typename ForestType = RandomForest<>>
+class DistributedRandomForest
+{
+ public:
+  /**
+   * Create the object, without any trees.
+   *
+   * @param communicator Communicator of the ranks that hold the data.
+   */
+  DistributedRandomForest(CommunicatorType communicator = CommunicatorType());
+
+  /**
+   * Train the trees of this rank on its shard of the dataset.  The numTrees
+   * trees are split as evenly as possible between the ranks.
+   *
+   * @param data Shard of the dataset held by this rank.
+   * @param labels Labels of the shard.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees of the whole forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param minimumGainSplit Minimum gain for splitting a decision tree node.
+   * @param maximumDepth Maximum depth for the tree.
+   * @return The average gain of all the trees of the forest.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numTrees = 20,
+               const size_t minimumLeafSize = 1,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0);
+
+  /**
+   * Gather the trees of all the ranks into the given forest, on every rank;
+   * the trees of rank 0 come first, then those of rank 1, and so on.
+   *
+   * @param forest Forest to store the trees of all the ranks in.
+   */
+  void Merge(ForestType& forest) const;
+
+  /**
+   * Classify the given points (which must be the same on every rank) with the
+   * trees of all the ranks.  Each rank only classifies the points with its
+   * own trees.
+   *
+   * @param data Points to classify.
+   * @param predictions Output predictions for each point.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the forest of the trees of this rank.
+  const ForestType& LocalForest() const { return localForest; }
+  //! Modify the forest of the trees of this rank.
+  ForestType& LocalForest() { return localForest; }
+
+  //! Get the number of trees of all the ranks.
+  size_t NumTrees() const { return numTrees; }
+
+  //! Get the communicator.
+  const CommunicatorType& Communicator() const { return communicator; }
+  //! Modify the communicator.
+  CommunicatorType& Communicator() { return communicator; }
+
+ private:
+  /**
+   * Gather the given strings of every rank, on every rank, with the sum
+   * reduction of the communicator: each string is packed into its own part of
+   * a matrix that is zero elsewhere, six bytes per element (so that they are
+   * held exactly by a double).
+   */
+  std::vector<std::string> AllGather(const std::string& local) const;
+
+  //! The communicator of the ranks.
+  CommunicatorType communicator;
+  //! The trees of this rank.
+  ForestType localForest;
+  //! The number of trees of all the ranks.
+  size_t numTrees;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_random_forest_impl.hpp"
+
+#endif
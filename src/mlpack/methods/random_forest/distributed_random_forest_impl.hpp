@@ -0,0 +1,172 @@
+/**
+ * @file methods/random_forest/distributed_random_forest_impl.hpp
+ *
+ * Implementation of the DistributedRandomForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_DISTRIBUTED_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_DISTRIBUTED_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename CommunicatorType, typename ForestType>
+DistributedRandomForest<CommunicatorType, ForestType>::DistributedRandomForest(
+    CommunicatorType communicator) :
+    communicator(std::move(communicator)),
+    numTrees(0),
+    numClasses(0)
+{
+  // Nothing to do.
+}
+
+template<typename CommunicatorType, typename ForestType>
+template<typename MatType>
+double DistributedRandomForest<CommunicatorType, ForestType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth)
+{
+  this->numTrees = numTrees;
+  this->numClasses = numClasses;
+
+  // The first numTrees % size ranks train one more tree than the others.
+  const size_t rank = communicator.Rank();
+  const size_t localTrees = numTrees / communicator.Size() +
+      ((rank < numTrees % communicator.Size()) ? 1 : 0);
+
+  arma::mat gain(1, 1, arma::fill::zeros);
+  if (localTrees > 0)
+  {
+    gain[0] = localTrees * localForest.Train(data, labels, numClasses,
+        localTrees, minimumLeafSize, minimumGainSplit, maximumDepth);
+  }
+  else
+  {
+    localForest = ForestType();
+  }
+
+  communicator.AllReduceSum(gain);
+  return (numTrees == 0) ? 0.0 : gain[0] / numTrees;
+}
+
+template<typename CommunicatorType, typename ForestType>
+void DistributedRandomForest<CommunicatorType, ForestType>::Merge(
+    ForestType& forest) const
+{
+  std::ostringstream oss;
+  {
+    cereal::BinaryOutputArchive ar(oss);
+    ar(cereal::make_nvp("forest", localForest));
+  }
+
+  const std::vector<std::string> forests = AllGather(oss.str());
+
+  forest = ForestType();
+  for (size_t i = 0; i < forests.size(); ++i)
+  {
+    ForestType rankForest;
+    std::istringstream iss(forests[i]);
+    {
+      cereal::BinaryInputArchive ar(iss);
+      ar(cereal::make_nvp("forest", rankForest));
+    }
+
+    forest.Merge(rankForest);
+  }
+}
+
+template<typename CommunicatorType, typename ForestType>
+template<typename MatType>
+void DistributedRandomForest<CommunicatorType, ForestType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& probabilities) const
+{
+  if (numTrees == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("DistributedRandomForest::Classify(): no "
+        "random forest trained!");
+  }
+
+  // The probabilities given by the local forest are averaged over its trees,
+  // so they are weighted by its number of trees before they are summed.
+  if (localForest.NumTrees() > 0)
+  {
+    localForest.Classify(data, predictions, probabilities);
+    probabilities *= localForest.NumTrees();
+  }
+  else
+  {
+    probabilities.zeros(numClasses, data.n_cols);
+  }
+
+  communicator.AllReduceSum(probabilities);
+  probabilities /= numTrees;
+
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = probabilities.col(i).index_max();
+}
+
+template<typename CommunicatorType, typename ForestType>
+std::vector<std::string>
+DistributedRandomForest<CommunicatorType, ForestType>::AllGather(
+    const std::string& local) const
+{
+  const size_t size = communicator.Size();
+  const size_t rank = communicator.Rank();
+  const size_t bytesPerElem = 6;
+
+  // Exchange the lengths of the strings first.
+  arma::mat lengths(1, size, arma::fill::zeros);
+  lengths[rank] = local.size();
+  communicator.AllReduceSum(lengths);
+
+  std::vector<size_t> offsets(size + 1, 0);
+  for (size_t i = 0; i < size; ++i)
+  {
+    offsets[i + 1] = offsets[i] + ((size_t) lengths[i] + bytesPerElem - 1) /
+        bytesPerElem;
+  }
+
+  arma::mat buffer(offsets[size], 1, arma::fill::zeros);
+  for (size_t i = 0; i < local.size(); ++i)
+  {
+    buffer[offsets[rank] + i / bytesPerElem] += std::ldexp(
+        (double) (unsigned char) local[i], 8 * (i % bytesPerElem));
+  }
+  communicator.AllReduceSum(buffer);
+
+  std::vector<std::string> strings(size);
+  for (size_t r = 0; r < size; ++r)
+  {
+    strings[r].resize((size_t) lengths[r]);
+    for (size_t i = 0; i < strings[r].size(); ++i)
+    {
+      const uint64_t elem = (uint64_t) buffer[offsets[r] + i / bytesPerElem];
+      strings[r][i] = (char) ((elem >> (8 * (i % bytesPerElem))) & 0xFF);
+    }
+  }
+
+  return strings;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -13,7 +13,9 @@
 #define MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
 
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_tree/column_subset_view.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/core/util/numa.hpp>
 #include "bootstrap.hpp"
 
 namespace mlpack {
@@ -35,6 +37,21 @@ namespace tree {
  *   publisher={Springer}
  * }
  * @endcode
+ *
+ * The trees are trained on views of the dataset (see ColumnSubsetView), so
+ * the dataset is not copied for each tree.  A bootstrap sample holds each
+ * sampled point once, weighted by the number of times it was sampled (see
+ * BootstrapIndices()); minimumLeafSize therefore counts distinct points.
+ *
+ * While each tree is trained, it is also evaluated on the points that are not
+ * in its bootstrap sample, so that Train() gives the out-of-bag error of the
+ * forest and the impurity and (optionally) permutation importance of each
+ * dimension without any retraining (see OOBError(), ImpurityImportance() and
+ * PermutationImportance()).
+ *
+ * With OpenMP, the trees are trained in parallel when there are at least as
+ * many of them as threads; otherwise they are trained one at a time, and each
+ * tree is trained in parallel (see DecisionTree).
  */
 template<typename FitnessFunction = GiniGain,
          typename DimensionSelectionType = MultipleRandomDimensionSelect,
@@ -353,6 +370,71 @@ class RandomForest
                 arma::Row<size_t>& predictions,
                 arma::mat& probabilities) const;
 
+  /**
+   * Predict the classes of each point in the given dataset, but stop
+   * evaluating trees for a point as soon as its predicted class is decided:
+   * that is, when the margin between the summed probabilities of its two best
+   * classes is larger than confidence times the number of trees not evaluated
+   * yet (each tree can reduce the margin by at most 1).  With confidence = 1,
+   * the predictions are the same as those of Classify() (up to rounding
+   * errors); a smaller confidence stops earlier, and gives an approximation.
+   * The probabilities of a point are the average of those of the trees that
+   * were evaluated for it.  If the random forest has not been trained, this
+   * will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   * @param confidence Fraction of the number of remaining trees that the margin
+   *     must exceed; must be in (0, 1].
+   * @return The total number of evaluations of a tree on a point.
+   */
+  template<typename MatType>
+  size_t EarlyExitClassify(const MatType& data,
+                           arma::Row<size_t>& predictions,
+                           arma::mat& probabilities,
+                           const double confidence = 1.0) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, but stop
+   * evaluating trees for a point as soon as its predicted class is decided.
+   * See the other overload of EarlyExitClassify() for details.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param confidence Fraction of the number of remaining trees that the margin
+   *     must exceed; must be in (0, 1].
+   * @return The total number of evaluations of a tree on a point.
+   */
+  template<typename MatType>
+  size_t EarlyExitClassify(const MatType& data,
+                           arma::Row<size_t>& predictions,
+                           const double confidence = 1.0) const;
+
+  /**
+   * Compile the trees of the trained forest into a FlatForest, which
+   * classifies batches of points faster and gives the same predictions and
+   * probabilities.  The trees must use binary numeric splits and
+   * AllCategoricalSplit (see FlatForest).
+   */
+  FlatForest Compile() const
+  {
+    FlatForest forest;
+    for (size_t i = 0; i < trees.size(); ++i)
+      forest.AddTree(trees[i]);
+    return forest;
+  }
+
+  /**
+   * Add the trees of the given forest (trained on the same dimensions and
+   * classes) to this forest.  The average gain, the out-of-bag error and the
+   * importances of the merged forest are the averages of those of the two
+   * forests, weighted by their numbers of trees.
+   *
+   * @param other Forest whose trees are added to this forest.
+   */
+  void Merge(const RandomForest& other);
+
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
   //! Modify a tree in the forest (be careful!).
@@ -361,6 +443,30 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  //! Get the out-of-bag error of the trees trained by the last call to
+  //! Train() (NaN without bootstrap sampling, or if no point was out of bag).
+  double OOBError() const { return oobError; }
+  //! Get the impurity importance of each dimension (the decrease of the
+  //! weighted impurity of the splits on it, normalized to sum to 1) of the
+  //! trees trained by the last call to Train().
+  const arma::vec& ImpurityImportance() const { return impurityImportance; }
+  //! Get the permutation importance of each dimension (the average decrease
+  //! of out-of-bag accuracy of each tree when the dimension is shuffled) of the
+  //! trees trained by the last call to Train(); empty if it was not computed.
+  const arma::vec& PermutationImportance() const
+  {
+    return permutationImportance;
+  }
+  //! Get whether Train() computes permutation importances.
+  bool ComputePermutationImportance() const
+  {
+    return computePermutationImportance;
+  }
+  //! Modify whether Train() computes permutation importances.  This requires
+  //! bootstrap sampling, and classifies each out-of-bag point once for every
+  //! dimension that each tree splits on.
+  bool& ComputePermutationImportance() { return computePermutationImportance; }
+
   /**
    * Serialize the random forest.
    */
@@ -403,11 +509,84 @@ class RandomForest
                DimensionSelectionType& dimensionSelector,
                const bool warmStart = false);
 
+  /**
+   * Classify the given point with the given trees (which are the trees of the
+   * forest, or a replica of them; see util::NUMAReplicas).
+   */
+  template<typename VecType>
+  static void ClassifyPoint(const std::vector<DecisionTreeType>& trees,
+                            const VecType& point,
+                            size_t& prediction,
+                            arma::vec& probabilities);
+
+  /**
+   * Classify the given point with the given trees, stopping once the remaining
+   * trees can't change the prediction (see EarlyExitClassify()), and return
+   * the number of trees evaluated.
+   */
+  template<typename VecType>
+  static size_t EarlyExitClassifyPoint(
+      const std::vector<DecisionTreeType>& trees,
+      const VecType& point,
+      const double confidence,
+      size_t& prediction,
+      arma::vec& probabilities);
+
+  /**
+   * Add the decrease of the weighted impurity of each split of the given
+   * subtree to the importance of its dimension.  The points of the subtree are
+   * points[positions[i]], with weights weights[positions[i]] (or 1 if weights
+   * is empty).
+   */
+  template<typename MatType>
+  static void TreeImpurityImportance(const DecisionTreeType& node,
+                                 const MatType& dataset,
+                                 const arma::Row<size_t>& labels,
+                                 const arma::uvec& points,
+                                 const arma::rowvec& weights,
+                                 const size_t numClasses,
+                                 const std::vector<size_t>& positions,
+                                 arma::vec& importance);
+
+  //! Return the impurity of the given points (as for TreeImpurityImportance()),
+  //! multiplied by their total weight.
+  static double WeightedImpurity(const arma::Row<size_t>& labels,
+                                 const arma::uvec& points,
+                                 const arma::rowvec& weights,
+                                 const size_t numClasses,
+                                 const std::vector<size_t>& positions);
+
+  //! Store the points in [0, numPoints) that are not in the sorted list inBag
+  //! into oob.
+  static void OutOfBag(const arma::uvec& inBag,
+                       const size_t numPoints,
+                       arma::uvec& oob);
+
+  /**
+   * Compute the decrease of the accuracy of the tree on the given out-of-bag
+   * points when each dimension is shuffled among them.
+   */
+  template<typename MatType>
+  static void TreePermutationImportance(const DecisionTreeType& tree,
+                                    const MatType& dataset,
+                                    const arma::Row<size_t>& labels,
+                                    const arma::uvec& oob,
+                                    arma::vec& importance);
+
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
 
   //! The average gain of the forest.
   double avgGain;
+
+  //! The out-of-bag error of the trees trained by the last call to Train().
+  double oobError;
+  //! The impurity importance of each dimension.
+  arma::vec impurityImportance;
+  //! The permutation importance of each dimension (empty if not computed).
+  arma::vec permutationImportance;
+  //! Whether Train() computes permutation importances.
+  bool computePermutationImportance;
 };
 
 /**
@@ -432,6 +611,19 @@ class RandomForest
  *   numpages = {40},
  * }
  * @endcode
+ *
+ * The trees are trained on views of the dataset (see ColumnSubsetView), so
+ * the dataset is not copied for each tree.  A bootstrap sample holds each
+ * sampled point once, weighted by the number of times it was sampled (see
+ * BootstrapIndices()); minimumLeafSize therefore counts distinct points.
+ *
+ * Since the trees are not trained on bootstrap samples, there are no
+ * out-of-bag points: OOBError() is NaN and PermutationImportance() is empty,
+ * but ImpurityImportance() is still computed.
+ *
+ * With OpenMP, the trees are trained in parallel when there are at least as
+ * many of them as threads; otherwise they are trained one at a time, and each
+ * tree is trained in parallel (see DecisionTree).
  */
 template<typename FitnessFunction = GiniGain,
          typename DimensionSelectionType = MultipleRandomDimensionSelect,
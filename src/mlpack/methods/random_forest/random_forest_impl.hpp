@@ -15,6 +15,12 @@
 // In case it hasn't been included yet.
 #include "random_forest.hpp"
 
+#include <stack>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -32,7 +38,9 @@ RandomForest<
     CategoricalSplitType,
     UseBootstrap
 >::RandomForest() :
-    avgGain(0.0)
+    avgGain(0.0),
+    oobError(std::numeric_limits<double>::quiet_NaN()),
+    computePermutationImportance(false)
 {
   // Nothing to do here.
 }
@@ -59,7 +67,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector) :
-    avgGain(0.0)
+    avgGain(0.0),
+    oobError(std::numeric_limits<double>::quiet_NaN()),
+    computePermutationImportance(false)
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored.
@@ -92,7 +102,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector):
-                    avgGain(0.0)
+                    avgGain(0.0),
+    oobError(std::numeric_limits<double>::quiet_NaN()),
+    computePermutationImportance(false)
 {
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
@@ -124,7 +136,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector) :
-    avgGain(0.0)
+    avgGain(0.0),
+    oobError(std::numeric_limits<double>::quiet_NaN()),
+    computePermutationImportance(false)
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored by Train().
@@ -157,7 +171,9 @@ RandomForest<
                 const double minimumGainSplit,
                 const size_t maximumDepth,
                 DimensionSelectionType dimensionSelector) :
-    avgGain(0.0)
+    avgGain(0.0),
+    oobError(std::numeric_limits<double>::quiet_NaN()),
+    computePermutationImportance(false)
 {
   // Pass off work to the Train() method.
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights,
@@ -345,23 +361,7 @@ void RandomForest<
         "trained!");
   }
 
-  probabilities.zeros(trees[0].NumClasses());
-  for (size_t i = 0; i < trees.size(); ++i)
-  {
-    arma::vec treeProbs;
-    size_t treePrediction; // Ignored.
-    trees[i].Classify(point, treePrediction, treeProbs);
-
-    probabilities += treeProbs;
-  }
-
-  // Find maximum element after renormalizing probabilities.
-  probabilities /= trees.size();
-  arma::uword maxIndex = 0;
-  probabilities.max(maxIndex);
-
-  // Set prediction.
-  prediction = (size_t) maxIndex;
+  ClassifyPoint(trees, point, prediction, probabilities);
 }
 
 template<
@@ -392,10 +392,16 @@ void RandomForest<
 
   predictions.set_size(data.n_cols);
 
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
+  // In NUMA mode, the threads of each socket use their own copy of the trees.
+  util::NUMAReplicas<std::vector<DecisionTreeType>> replicas(trees);
+  #pragma omp parallel
   {
-    predictions[i] = Classify(data.col(i));
+    const std::vector<DecisionTreeType>& localTrees = replicas.Local();
+    arma::vec probabilities;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < data.n_cols; ++i)
+      ClassifyPoint(localTrees, data.col(i), predictions[i], probabilities);
   }
 }
 
@@ -429,12 +435,254 @@ void RandomForest<
 
   probabilities.set_size(trees[0].NumClasses(), data.n_cols);
   predictions.set_size(data.n_cols);
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
+
+  // In NUMA mode, the threads of each socket use their own copy of the trees.
+  util::NUMAReplicas<std::vector<DecisionTreeType>> replicas(trees);
+  #pragma omp parallel
+  {
+    const std::vector<DecisionTreeType>& localTrees = replicas.Local();
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < data.n_cols; ++i)
+    {
+      arma::vec probs = probabilities.unsafe_col(i);
+      ClassifyPoint(localTrees, data.col(i), predictions[i], probs);
+    }
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename VecType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::ClassifyPoint(const std::vector<DecisionTreeType>& trees,
+                 const VecType& point,
+                 size_t& prediction,
+                 arma::vec& probabilities)
+{
+  probabilities.zeros(trees[0].NumClasses());
+  for (size_t i = 0; i < trees.size(); ++i)
+  {
+    arma::vec treeProbs;
+    size_t treePrediction; // Ignored.
+    trees[i].Classify(point, treePrediction, treeProbs);
+
+    probabilities += treeProbs;
+  }
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= trees.size();
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+
+  // Set prediction.
+  prediction = (size_t) maxIndex;
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+size_t RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::EarlyExitClassify(const MatType& data,
+                     arma::Row<size_t>& predictions,
+                     const double confidence) const
+{
+  arma::mat probabilities;
+  return EarlyExitClassify(data, predictions, probabilities, confidence);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+size_t RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::EarlyExitClassify(const MatType& data,
+                     arma::Row<size_t>& predictions,
+                     arma::mat& probabilities,
+                     const double confidence) const
+{
+  // Check edge cases.
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("RandomForest::EarlyExitClassify(): no random "
+        "forest trained!");
+  }
+
+  if (confidence <= 0.0 || confidence > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::EarlyExitClassify(): confidence must be in (0, 1] "
+        << "(given " << confidence << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  probabilities.set_size(trees[0].NumClasses(), data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  // In NUMA mode, the threads of each socket use their own copy of the trees.
+  util::NUMAReplicas<std::vector<DecisionTreeType>> replicas(trees);
+  size_t evaluations = 0;
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    const std::vector<DecisionTreeType>& localTrees = replicas.Local();
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < data.n_cols; ++i)
+    {
+      arma::vec probs = probabilities.unsafe_col(i);
+      evaluations += EarlyExitClassifyPoint(localTrees, data.col(i),
+          confidence, predictions[i], probs);
+    }
+  }
+
+  return evaluations;
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename VecType>
+size_t RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::EarlyExitClassifyPoint(
+    const std::vector<DecisionTreeType>& trees,
+    const VecType& point,
+    const double confidence,
+    size_t& prediction,
+    arma::vec& probabilities)
+{
+  probabilities.zeros(trees[0].NumClasses());
+  arma::vec treeProbs;
+  size_t evaluated = 0;
+  while (evaluated < trees.size())
+  {
+    size_t treePrediction; // Ignored.
+    trees[evaluated].Classify(point, treePrediction, treeProbs);
+    probabilities += treeProbs;
+    ++evaluated;
+
+    // The probabilities of a tree sum to 1, so each remaining tree can reduce
+    // the margin between the two best classes by at most 1.
+    double best = -1.0;
+    double second = -1.0;
+    for (size_t c = 0; c < probabilities.n_elem; ++c)
+    {
+      if (probabilities[c] > best)
+      {
+        second = best;
+        best = probabilities[c];
+      }
+      else if (probabilities[c] > second)
+      {
+        second = probabilities[c];
+      }
+    }
+
+    if (best - second > confidence * (trees.size() - evaluated))
+      break;
+  }
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= evaluated;
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+
+  return evaluated;
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::Merge(const RandomForest& other)
+{
+  if (other.trees.size() == 0)
+    return;
+  if (trees.size() == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  const double weight = (double) trees.size() / (trees.size() +
+      other.trees.size());
+  const double otherWeight = 1.0 - weight;
+
+  avgGain = weight * avgGain + otherWeight * other.avgGain;
+
+  // A statistic that one of the forests does not have is taken from the other.
+  if (std::isnan(oobError))
+    oobError = other.oobError;
+  else if (!std::isnan(other.oobError))
+    oobError = weight * oobError + otherWeight * other.oobError;
+
+  if (impurityImportance.n_elem == other.impurityImportance.n_elem)
+  {
+    impurityImportance = weight * impurityImportance +
+        otherWeight * other.impurityImportance;
+  }
+  if (permutationImportance.n_elem == 0)
+  {
+    permutationImportance = other.permutationImportance;
+  }
+  else if (permutationImportance.n_elem ==
+      other.permutationImportance.n_elem)
   {
-    arma::vec probs = probabilities.unsafe_col(i);
-    Classify(data.col(i), predictions[i], probs);
+    permutationImportance = weight * permutationImportance +
+        otherWeight * other.permutationImportance;
   }
+
+  trees.insert(trees.end(), other.trees.begin(), other.trees.end());
 }
 
 template<
@@ -451,7 +699,7 @@ void RandomForest<
     NumericSplitType,
     CategoricalSplitType,
     UseBootstrap
->::serialize(Archive& ar, const uint32_t /* version */)
+>::serialize(Archive& ar, const uint32_t version)
 {
   size_t numTrees;
   if (cereal::is_loading<Archive>())
@@ -465,8 +713,29 @@ void RandomForest<
   if (cereal::is_loading<Archive>())
     trees.resize(numTrees);
 
-  ar(CEREAL_NVP(trees));
+  // Since version 2, the trees are stored so that they can be loaded in
+  // parallel.
+  if (version > 1)
+    ar(cereal::make_nvp("trees", CEREAL_PARALLEL_VECTOR(trees)));
+  else
+    ar(CEREAL_NVP(trees));
   ar(CEREAL_NVP(avgGain));
+
+  // Before version 1, the out-of-bag statistics were not computed.
+  if (version > 0)
+  {
+    ar(CEREAL_NVP(oobError));
+    ar(CEREAL_NVP(impurityImportance));
+    ar(CEREAL_NVP(permutationImportance));
+    ar(CEREAL_NVP(computePermutationImportance));
+  }
+  else if (cereal::is_loading<Archive>())
+  {
+    oobError = std::numeric_limits<double>::quiet_NaN();
+    impurityImportance.clear();
+    permutationImportance.clear();
+    computePermutationImportance = false;
+  }
 }
 
 template<
@@ -495,6 +764,8 @@ double RandomForest<
          DimensionSelectionType& dimensionSelector,
          const bool warmStart)
 {
+  MLPACK_MEMORY_PHASE("random_forest_training");
+
   // Reset the forest if we are not doing a warm-start.
   if (!warmStart)
     trees.clear();
@@ -504,72 +775,355 @@ double RandomForest<
   // Convert avgGain to total gain.
   double totalGain = avgGain * oldNumTrees;
 
+  // If there are enough trees to keep every thread busy, train the trees in
+  // parallel.  Otherwise, train them one at a time, so that each tree builds
+  // its subtrees in parallel instead (see DecisionTree).
+  #ifdef HAS_OPENMP
+  const bool parallelTrees = (numTrees >= (size_t) omp_get_max_threads());
+  #else
+  const bool parallelTrees = false;
+  #endif
+
+  // The out-of-bag statistics and feature importances are accumulated over the
+  // trees trained here.
+  arma::mat oobProbabilities(numClasses, dataset.n_cols, arma::fill::zeros);
+  arma::Row<size_t> oobCounts(dataset.n_cols, arma::fill::zeros);
+  arma::vec impurity(dataset.n_rows, arma::fill::zeros);
+  arma::vec permutation(dataset.n_rows, arma::fill::zeros);
+  size_t numPermutationTrees = 0;
+
+  // Each tree draws its bootstrap sample from its own random stream, so that
+  // the samples don't depend on which thread trains which tree.
+  const size_t firstStream = math::ReserveRandomStreams(numTrees);
+
   // Train each tree individually.
-  #pragma omp parallel for reduction( + : totalGain)
+  #pragma omp parallel for schedule(dynamic) reduction( + : totalGain) \
+      if (parallelTrees)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
+    // Each tree is trained on a view of the dataset, so that the dataset is
+    // never copied.  A bootstrap sample is given by the points it contains,
+    // weighted by the number of times they were sampled.
+    arma::uvec indices;
+    arma::rowvec treeWeights;
     if (UseBootstrap)
     {
-      Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-          bootstrapLabels, bootstrapWeights);
+      std::mt19937 generator = math::RandomStream(firstStream + i);
+      BootstrapIndices<UseWeights>(dataset.n_cols, weights, indices,
+          treeWeights, generator);
     }
+    else
+    {
+      indices = arma::regspace<arma::uvec>(0, dataset.n_cols - 1);
+      if (UseWeights)
+        treeWeights = weights;
+    }
+
+    const arma::uvec inBag(indices);
+    const arma::rowvec inBagWeights(treeWeights);
+    ColumnSubsetView<MatType> view(dataset, std::move(indices));
+    arma::Row<size_t> treeLabels = labels.cols(view.Indices());
 
-    if (UseWeights)
+    if (UseBootstrap || UseWeights)
     {
-      if (UseDatasetInfo)
+      totalGain += UseDatasetInfo ?
+          trees[oldNumTrees + i].Train(std::move(view), datasetInfo,
+              std::move(treeLabels), numClasses, std::move(treeWeights),
+              minimumLeafSize, minimumGainSplit, maximumDepth,
+              dimensionSelector) :
+          trees[oldNumTrees + i].Train(std::move(view), std::move(treeLabels),
+              numClasses, std::move(treeWeights), minimumLeafSize,
+              minimumGainSplit, maximumDepth, dimensionSelector);
+    }
+    else
+    {
+      totalGain += UseDatasetInfo ?
+          trees[oldNumTrees + i].Train(std::move(view), datasetInfo,
+              std::move(treeLabels), numClasses, minimumLeafSize,
+              minimumGainSplit, maximumDepth, dimensionSelector) :
+          trees[oldNumTrees + i].Train(std::move(view), std::move(treeLabels),
+              numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
+              dimensionSelector);
+    }
+
+    // Evaluate the tree on its out-of-bag points, while this thread still
+    // holds its sample, and merge the results.
+    const DecisionTreeType& tree = trees[oldNumTrees + i];
+    arma::vec treeImpurity(dataset.n_rows, arma::fill::zeros);
+    std::vector<size_t> positions(inBag.n_elem);
+    for (size_t j = 0; j < positions.size(); ++j)
+      positions[j] = j;
+    TreeImpurityImportance(tree, dataset, labels, inBag, inBagWeights,
+        numClasses, positions, treeImpurity);
+
+    arma::uvec oob;
+    arma::mat treeProbabilities;
+    arma::vec treePermutation;
+    if (UseBootstrap)
+    {
+      OutOfBag(inBag, dataset.n_cols, oob);
+      treeProbabilities.set_size(numClasses, oob.n_elem);
+      for (size_t j = 0; j < oob.n_elem; ++j)
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
-                minimumGainSplit, maximumDepth, dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
-                numClasses, weights, minimumLeafSize, minimumGainSplit,
-                maximumDepth, dimensionSelector);
+        size_t prediction;
+        arma::vec probabilities;
+        tree.Classify(dataset.col(oob[j]), prediction, probabilities);
+        treeProbabilities.col(j) = probabilities;
       }
-      else
+
+      if (computePermutationImportance && oob.n_elem > 0)
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, bootstrapWeights, minimumLeafSize,
-                minimumGainSplit, maximumDepth, dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, labels, numClasses,
-                weights, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector);
+        TreePermutationImportance(tree, dataset, labels, oob, treePermutation);
       }
     }
-    else
+
+    #pragma omp critical
     {
-      if (UseDatasetInfo)
+      impurity += treeImpurity;
+      for (size_t j = 0; j < oob.n_elem; ++j)
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-                maximumDepth, dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
-                numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector);
+        oobProbabilities.col(oob[j]) += treeProbabilities.col(j);
+        ++oobCounts[oob[j]];
       }
-      else
+      if (treePermutation.n_elem > 0)
       {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, labels, numClasses,
-                minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector);
+        permutation += treePermutation;
+        ++numPermutationTrees;
       }
     }
   }
 
+  // A point's out-of-bag prediction is made only by the trees that were not
+  // trained on it.
+  oobError = std::numeric_limits<double>::quiet_NaN();
+  if (UseBootstrap)
+  {
+    size_t numOOB = 0, errors = 0;
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      if (oobCounts[i] == 0)
+        continue;
+
+      ++numOOB;
+      if (oobProbabilities.col(i).index_max() != labels[i])
+        ++errors;
+    }
+
+    if (numOOB > 0)
+      oobError = (double) errors / (double) numOOB;
+  }
+
+  const double totalImpurity = arma::accu(impurity);
+  impurityImportance = (totalImpurity > 0.0) ? arma::vec(impurity /
+      totalImpurity) : impurity;
+
+  if (numPermutationTrees > 0)
+    permutationImportance = permutation / (double) numPermutationTrees;
+  else
+    permutationImportance.clear();
+
   avgGain = totalGain / trees.size();
   return avgGain;
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::TreeImpurityImportance(
+    const DecisionTreeType& node,
+    const MatType& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::uvec& points,
+    const arma::rowvec& weights,
+    const size_t numClasses,
+    const std::vector<size_t>& positions,
+    arma::vec& importance)
+{
+  if (node.NumChildren() == 0)
+    return;
+
+  std::vector<std::vector<size_t>> childPositions(node.NumChildren());
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    const size_t p = positions[i];
+    childPositions[node.CalculateDirection(dataset.col(points[p]))].push_back(
+        p);
+  }
+
+  // The importance of the split is the decrease of the weighted impurity.
+  double decrease = WeightedImpurity(labels, points, weights, numClasses,
+      positions);
+  for (size_t c = 0; c < childPositions.size(); ++c)
+  {
+    decrease -= WeightedImpurity(labels, points, weights, numClasses,
+        childPositions[c]);
+  }
+  importance[node.SplitDimension()] += decrease;
+
+  for (size_t c = 0; c < childPositions.size(); ++c)
+  {
+    TreeImpurityImportance(node.Child(c), dataset, labels, points, weights,
+        numClasses, childPositions[c], importance);
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+double RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::WeightedImpurity(
+    const arma::Row<size_t>& labels,
+    const arma::uvec& points,
+    const arma::rowvec& weights,
+    const size_t numClasses,
+    const std::vector<size_t>& positions)
+{
+  arma::vec classWeights(numClasses, arma::fill::zeros);
+  double totalWeight = 0.0;
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    const size_t p = positions[i];
+    const double weight = weights.n_elem > 0 ? weights[p] : 1.0;
+    classWeights[labels[points[p]]] += weight;
+    totalWeight += weight;
+  }
+
+  if (totalWeight == 0.0)
+    return 0.0;
+
+  return -totalWeight * FitnessFunction::template EvaluatePtr<true>(
+      classWeights.memptr(), numClasses, totalWeight);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::OutOfBag(
+    const arma::uvec& inBag,
+    const size_t numPoints,
+    arma::uvec& oob)
+{
+  oob.set_size(numPoints - inBag.n_elem);
+  size_t j = 0, k = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    if (j < inBag.n_elem && inBag[j] == i)
+      ++j;
+    else
+      oob[k++] = i;
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::TreePermutationImportance(
+    const DecisionTreeType& tree,
+    const MatType& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::uvec& oob,
+    arma::vec& importance)
+{
+  importance.zeros(dataset.n_rows);
+
+  // Permuting a dimension that the tree does not split on changes nothing.
+  std::vector<bool> used(dataset.n_rows, false);
+  std::stack<const DecisionTreeType*> stack;
+  stack.push(&tree);
+  while (!stack.empty())
+  {
+    const DecisionTreeType* node = stack.top();
+    stack.pop();
+    if (node->NumChildren() == 0)
+      continue;
+
+    used[node->SplitDimension()] = true;
+    for (size_t c = 0; c < node->NumChildren(); ++c)
+      stack.push(&node->Child(c));
+  }
+
+  size_t correct = 0;
+  for (size_t i = 0; i < oob.n_elem; ++i)
+  {
+    if (tree.Classify(dataset.col(oob[i])) == labels[oob[i]])
+      ++correct;
+  }
+
+  arma::vec point;
+  for (size_t d = 0; d < dataset.n_rows; ++d)
+  {
+    if (!used[d])
+      continue;
+
+    // Permute the values of dimension d among the out-of-bag points.
+    const arma::uvec permutation = arma::shuffle(oob);
+    size_t permutedCorrect = 0;
+    for (size_t i = 0; i < oob.n_elem; ++i)
+    {
+      point = dataset.col(oob[i]);
+      point[d] = dataset(d, permutation[i]);
+      if (tree.Classify(point) == labels[oob[i]])
+        ++permutedCorrect;
+    }
+
+    importance[d] = ((double) correct - (double) permutedCorrect) /
+        (double) oob.n_elem;
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
+// Since version 1, the out-of-bag statistics are stored, and since version 2,
+// the trees are stored with CEREAL_PARALLEL_VECTOR.
+CEREAL_TEMPLATE_CLASS_VERSION((template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap>),
+    (mlpack::tree::RandomForest<FitnessFunction, DimensionSelectionType,
+    NumericSplitType, CategoricalSplitType, UseBootstrap>), (2));
+
 #endif
@@ -54,8 +54,8 @@ void RandomizedSVD::Apply(const arma::sp_mat& data,
                           arma::mat& v,
                           const size_t rank)
 {
-  // Center the data into a temporary matrix for sparse matrix.
-  arma::sp_mat rowMean = arma::sum(data, 1) / data.n_cols;
+  // The mean of sparse data is dense; the data itself is centered implicitly.
+  arma::mat rowMean = arma::mat(arma::sum(data, 1)) / data.n_cols;
 
   Apply(data, u, s, v, rank, rowMean);
 }
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/parallel_multiply.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -138,14 +139,17 @@ class RandomizedSVD
 
   /**
    * Apply Principal Component Analysis to the provided matrix data set
-   * using the randomized SVD.
+   * using the randomized SVD.  The data is centered on the given mean
+   * implicitly, in the products with the data, so no centered (or, for sparse
+   * data, dense) copy of the data is made; the products with sparse data are
+   * computed in parallel.
    *
-   * @param data Data matrix.
+   * @param data Data matrix (dense or sparse).
    * @param u First unitary matrix.
    * @param v Second unitary matrix.
    * @param s Diagonal "Sigma" matrix of singular values.
    * @param rank Rank of the approximation.
-   * @param rowMean Centered mean value matrix.
+   * @param rowMean Mean to center the data on (empty for no centering).
    */
   template<typename MatType>
   void Apply(const MatType& data,
@@ -153,7 +157,7 @@ class RandomizedSVD
              arma::vec& s,
              arma::mat& v,
              const size_t rank,
-             MatType rowMean)
+             const arma::mat& rowMean)
   {
     if (iteratedPower == 0)
       iteratedPower = rank + 2;
@@ -164,13 +168,12 @@ class RandomizedSVD
     if (data.n_cols >= data.n_rows)
     {
       R = arma::randn<arma::mat>(data.n_rows, iteratedPower);
-      Q = (data.t() * R) - arma::repmat(arma::trans(R.t() * rowMean),
-          data.n_cols, 1);
+      math::CenteredMultiplyTrans(data, rowMean, R, Q);
     }
     else
     {
       R = arma::randn<arma::mat>(data.n_cols, iteratedPower);
-      Q = (data * R) - (rowMean * (arma::ones(1, data.n_cols) * R));
+      math::CenteredMultiply(data, rowMean, R, Q);
     }
 
     // Form a matrix Q whose columns constitute a
@@ -189,15 +192,15 @@ class RandomizedSVD
     {
       if (data.n_cols >= data.n_rows)
       {
-        Q = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
-        arma::lu(Q, v, Q);
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        math::CenteredMultiply(data, rowMean, Q, R);
+        arma::lu(Q, v, R);
+        math::CenteredMultiplyTrans(data, rowMean, Q, R);
       }
       else
       {
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
-        arma::lu(Q, v, Q);
-        Q = (data * Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
+        math::CenteredMultiplyTrans(data, rowMean, Q, R);
+        arma::lu(Q, v, R);
+        math::CenteredMultiply(data, rowMean, Q, R);
       }
 
       // Computing the LU decomposition is more efficient than computing the QR
@@ -206,11 +209,11 @@ class RandomizedSVD
       // orthonormal.
       if (i < (maxIterations - 1))
       {
-        arma::lu(Q, v, Q);
+        arma::lu(Q, v, R);
       }
       else
       {
-        arma::qr_econ(Q, v, Q);
+        arma::qr_econ(Q, v, R);
       }
     }
 
@@ -219,13 +222,15 @@ class RandomizedSVD
     // applied to Q.
     if (data.n_cols >= data.n_rows)
     {
-      Qdata = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+      math::CenteredMultiply(data, rowMean, Q, Qdata);
       arma::svd_econ(u, s, v, Qdata);
       v = Q * v;
     }
     else
     {
-      Qdata = (Q.t() * data) - arma::repmat(Q.t() * rowMean, 1,  data.n_cols);
+      // Q^T * data is the transpose of data^T * Q.
+      math::CenteredMultiplyTrans(data, rowMean, Q, Qdata);
+      arma::inplace_trans(Qdata);
       arma::svd_econ(u, s, v, Qdata);
       u = Q * u;
     }
@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_callbacks.hpp"
 
 namespace mlpack {
 namespace range /** Range-search routines. */ {
@@ -268,6 +269,117 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, passing each result to the given callback as soon as it is
+   * found instead of storing it.  This takes no memory for the results, so it
+   * is useful when only a summary of the results (like the number of neighbors
+   * of each point) is needed, or when all of the results would not fit in
+   * memory.  The callback is called as
+   *
+   * @code
+   * callback(queryIndex, referenceIndex, distance);
+   * @endcode
+   *
+   * once for each pair of points within the range, in no particular order, with
+   * the original indices of the points.  If the single-tree search runs in
+   * parallel, the callback is called from several threads at once, but all of
+   * the results of a query point are given by the same thread.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              CallbackType& callback);
+
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, passing each result to the given
+   * callback as soon as it is found.  The query indices are those of the query
+   * tree's dataset.  If either naive or singleMode are set to true, this will
+   * throw an invalid_argument exception.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void Search(Tree* queryTree,
+              const math::Range& range,
+              CallbackType& callback);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, passing each result to the given callback as soon as it is found.  A
+   * point is not returned as its own result, and each pair of points is given
+   * once in each order.
+   *
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   */
+  template<typename CallbackType>
+  void Search(const math::Range& range, CallbackType& callback);
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed sparse row form instead of
+   * a vector for each query point.  The results of query point i are
+   * neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1], with the distances
+   * at the same positions of distances, in no particular order; offsets has one
+   * more element than there are query points.  The results are collected in
+   * one pass of the search (see CSRCallback).
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Position of the first result of each query point.
+   * @param neighbors Indices of the reference points of all results.
+   * @param distances Distances of all results.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in compressed sparse row form, as in the
+   * overload above.  A point is not returned as its own result.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Position of the first result of each point.
+   * @param neighbors Indices of the reference points of all results.
+   * @param distances Distances of all results.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing the results.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Number of reference points in the range of each query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the other points of the reference set in the given range of each
+   * point in the reference set, without storing the results.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Number of points in the range of each reference point.
+   */
+  void Count(const math::Range& range, arma::Col<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -318,6 +430,25 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Perform a single-tree search for every point in the query set, adding the
+   * number of base cases and scores to the counts of this object.  If OpenMP
+   * is available, the query points are split across threads, each with its own
+   * rules object; every thread passes the results of its query points to the
+   * given callback.
+   *
+   * @param querySet Set of query points.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to pass each result to.
+   * @param sameSet If true, a query point will not be returned in its own
+   *      results.
+   */
+  template<typename CallbackType>
+  void SingleTreeTraversal(const MatType& querySet,
+                           const math::Range& range,
+                           CallbackType& callback,
+                           const bool sameSet);
+
   //! For access to mappings when building models.
   friend class LeafSizeRSWrapper<TreeType>;
 };
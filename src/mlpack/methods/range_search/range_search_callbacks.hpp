@@ -0,0 +1,232 @@
+/**
+ * @file methods/range_search/range_search_callbacks.hpp
+ *
+ * Callbacks that receive the results of a range search as they are found.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_CALLBACKS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_CALLBACKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * A range search callback that stores the results in a list of neighbors and a
+ * list of distances for each query point, as returned by the overloads of
+ * RangeSearch::Search() that don't take a callback.  The lists must already
+ * have an entry for each query point.
+ *
+ * Like any range search callback, this must be callable as
+ *
+ * @code
+ * callback(queryIndex, referenceIndex, distance);
+ * @endcode
+ *
+ * once for each pair of points within the range.
+ */
+class NeighborListCallback
+{
+ public:
+  /**
+   * Construct the callback to store results in the given lists.
+   *
+   * @param neighbors List of neighbors of each query point.
+   * @param distances List of distances of each query point.
+   */
+  NeighborListCallback(std::vector<std::vector<size_t>>& neighbors,
+                       std::vector<std::vector<double>>& distances) :
+      neighbors(neighbors),
+      distances(distances)
+  { }
+
+  //! Store the given result.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double distance)
+  {
+    neighbors[queryIndex].push_back(referenceIndex);
+    distances[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The list of neighbors of each query point.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The list of distances of each query point.
+  std::vector<std::vector<double>>& distances;
+};
+
+/**
+ * A range search callback that only counts the results of each query point.
+ * The counts are added to the given vector, which must already have an entry
+ * for each query point.  Since all of the results of a query point are given by
+ * the same thread, this is safe to use with a parallel search.
+ */
+class CountCallback
+{
+ public:
+  /**
+   * Construct the callback to add the number of results of each query point to
+   * the given counts.
+   *
+   * @param counts Number of results of each query point.
+   */
+  CountCallback(arma::Col<size_t>& counts) : counts(counts) { }
+
+  //! Count the given result.
+  void operator()(const size_t queryIndex,
+                  const size_t /* referenceIndex */,
+                  const double /* distance */)
+  {
+    ++counts[queryIndex];
+  }
+
+ private:
+  //! The number of results of each query point.
+  arma::Col<size_t>& counts;
+};
+
+/**
+ * A range search callback that stores the results in compressed sparse row
+ * form: the results of query point i are neighbors[offsets[i]] to
+ * neighbors[offsets[i + 1] - 1], with the matching distances.  During the
+ * search, the results are appended to one flat buffer per thread, so no memory
+ * is allocated for each query point; Finalize() then moves them to their place
+ * with a counting sort.  The results of each query point keep the order in
+ * which they were found.
+ */
+class CSRCallback
+{
+ public:
+  /**
+   * Construct the callback for the given number of query points.
+   *
+   * @param numQueries Number of query points.
+   */
+  CSRCallback(const size_t numQueries) :
+      counts(numQueries, arma::fill::zeros)
+  {
+    size_t numThreads = 1;
+    #ifdef HAS_OPENMP
+      numThreads = omp_get_max_threads();
+    #endif
+    buffers.resize(numThreads);
+  }
+
+  //! Store the given result in the buffer of the calling thread.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double distance)
+  {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    buffers[threadId].push_back(Result(queryIndex, referenceIndex, distance));
+    ++counts[queryIndex];
+  }
+
+  /**
+   * Move the stored results to the given arrays, and release the buffers.
+   *
+   * @param offsets Position of the first result of each query point, and the
+   *      total number of results at the end.
+   * @param neighbors Indices of the reference points of every result.
+   * @param distances Distances of every result.
+   */
+  void Finalize(arma::Col<size_t>& offsets,
+                arma::Col<size_t>& neighbors,
+                arma::vec& distances)
+  {
+    offsets.set_size(counts.n_elem + 1);
+    offsets[0] = 0;
+    for (size_t i = 0; i < counts.n_elem; ++i)
+      offsets[i + 1] = offsets[i] + counts[i];
+
+    neighbors.set_size(offsets[counts.n_elem]);
+    distances.set_size(offsets[counts.n_elem]);
+
+    // Reuse the counts as the next free position of each query point.
+    counts = offsets.head(counts.n_elem);
+    for (size_t t = 0; t < buffers.size(); ++t)
+    {
+      for (size_t j = 0; j < buffers[t].size(); ++j)
+      {
+        const Result& result = buffers[t][j];
+        const size_t position = counts[std::get<0>(result)]++;
+        neighbors[position] = std::get<1>(result);
+        distances[position] = std::get<2>(result);
+      }
+
+      std::vector<Result>().swap(buffers[t]);
+    }
+
+    counts.zeros();
+  }
+
+ private:
+  //! A result: the query index, reference index, and distance.
+  typedef std::tuple<size_t, size_t, double> Result;
+
+  //! The number of results of each query point.
+  arma::Col<size_t> counts;
+  //! The results found by each thread.
+  std::vector<std::vector<Result>> buffers;
+};
+
+/**
+ * A range search callback that maps the indices of points in rearranged trees
+ * back to the indices of the original dataset before passing each result on to
+ * another callback.
+ *
+ * @tparam CallbackType Type of the callback to pass the results on to.
+ */
+template<typename CallbackType>
+class MappedCallback
+{
+ public:
+  /**
+   * Construct the callback.  If a mapping is NULL, those indices are passed on
+   * unchanged.
+   *
+   * @param callback Callback to pass the results on to.
+   * @param queryMapping Original index of each query point, or NULL.
+   * @param referenceMapping Original index of each reference point, or NULL.
+   */
+  MappedCallback(CallbackType& callback,
+                 const std::vector<size_t>* queryMapping,
+                 const std::vector<size_t>* referenceMapping) :
+      callback(callback),
+      queryMapping(queryMapping),
+      referenceMapping(referenceMapping)
+  { }
+
+  //! Map the indices of the given result and pass it on.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double distance)
+  {
+    callback(queryMapping ? (*queryMapping)[queryIndex] : queryIndex,
+        referenceMapping ? (*referenceMapping)[referenceIndex] :
+        referenceIndex, distance);
+  }
+
+ private:
+  //! The callback to pass the results on to.
+  CallbackType& callback;
+  //! The original index of each query point, or NULL.
+  const std::vector<size_t>* queryMapping;
+  //! The original index of each reference point, or NULL.
+  const std::vector<size_t>* referenceMapping;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
@@ -108,7 +108,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
     treeOwner = true;
@@ -154,7 +154,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
 {
   // Clear other object.
   other.referenceTree =
-      BuildTree<Tree>(std::move(arma::mat()), other.oldFromNewReferences);
+      BuildTree<Tree>(std::move(MatType()), other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.treeOwner = true;
   other.naive = false;
@@ -311,6 +311,27 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     const math::Range& range,
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
+{
+  // Resize each vector.
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
+
+  NeighborListCallback callback(neighbors, distances);
+  Search(querySet, range, callback);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    CallbackType& callback)
 {
   util::CheckSameDimensionality(querySet, *referenceSet,
       "RangeSearch::Search()", "query set");
@@ -319,41 +340,17 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (referenceSet->n_cols == 0)
     return;
 
-  // This will hold mappings for query points, if necessary.
-  std::vector<size_t> oldFromNewQueries;
-
-  // If we have built the trees ourselves, then we will have to map all the
-  // indices back to their original indices when this computation is finished.
-  // To avoid extra copies, we will store the unmapped neighbors and distances
-  // in a separate object.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
-
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // Query indices only need to be mapped if we are building the query tree
-    // ourselves.
-    if (!singleMode && !naive)
-    {
-      distancePtr = new std::vector<std::vector<double>>;
-      neighborPtr = new std::vector<std::vector<size_t>>;
-    }
-
-    // Reference indices only need to be mapped if we built the reference tree
-    // ourselves.
-    else if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t>>;
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distancePtr->clear();
-  distancePtr->resize(querySet.n_cols);
+  // If we have built the trees ourselves, then the indices of the results are
+  // mapped back to their original indices before they are given to the
+  // callback.  Reference indices only need to be mapped if we built the
+  // reference tree ourselves.
+  const std::vector<size_t>* referenceMapping =
+      (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  typedef MappedCallback<CallbackType> MappedCallbackType;
+  typedef RangeSearchRules<MetricType, Tree, MappedCallbackType> RuleType;
 
   // Reset counts.
   baseCases = 0;
@@ -361,8 +358,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    MappedCallbackType mappedCallback(callback, NULL, NULL);
+    RuleType rules(*referenceSet, querySet, range, mappedCallback, metric);
 
     // The naive brute-force solution.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -373,26 +370,22 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    // Traverse the reference tree for each point.
+    MappedCallbackType mappedCallback(callback, NULL, referenceMapping);
+    SingleTreeTraversal(querySet, range, mappedCallback, false);
   }
   else // Dual-tree recursion.
   {
-    // Build the query tree.
+    // Build the query tree; since we built it, its indices must be mapped.
+    std::vector<size_t> oldFromNewQueries;
     Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    MappedCallbackType mappedCallback(callback,
+        tree::TreeTraits<Tree>::RearrangesDataset ? &oldFromNewQueries : NULL,
+        referenceMapping);
 
     // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, mappedCallback,
+        metric);
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     traverser.Traverse(*queryTree, *referenceTree);
@@ -403,72 +396,6 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     // Clean up tree memory.
     delete queryTree;
   }
-
-  // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    if (!singleMode && !naive && treeOwner)
-    {
-      // We must map both query and reference indices.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-
-        // Copy each neighbor individually, because we need to map it.
-        neighbors[queryMapping].resize(distances[queryMapping].size());
-        for (size_t j = 0; j < distances[queryMapping].size(); ++j)
-          neighbors[queryMapping][j] =
-              oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (!singleMode && !naive)
-    {
-      // We must map query indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances and neighbors (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-        neighbors[queryMapping] = (*neighborPtr)[i];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (treeOwner)
-    {
-      // We must map reference indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < neighbors.size(); ++i)
-      {
-        neighbors[i].resize((*neighborPtr)[i].size());
-        for (size_t j = 0; j < neighbors[i].size(); ++j)
-          neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary object.
-      delete neighborPtr;
-    }
-  }
 }
 
 template<typename MetricType,
@@ -481,35 +408,48 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     const math::Range& range,
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
+{
+  // Resize each vector.
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(queryTree->Dataset().n_cols);
+  distances.clear();
+  distances.resize(queryTree->Dataset().n_cols);
+
+  NeighborListCallback callback(neighbors, distances);
+  Search(queryTree, range, callback);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    Tree* queryTree,
+    const math::Range& range,
+    CallbackType& callback)
 {
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
     return;
 
-  // Get a reference to the query set.
-  const MatType& querySet = queryTree->Dataset();
-
   // Make sure we are in dual-tree mode.
   if (singleMode || naive)
     throw std::invalid_argument("cannot call RangeSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
-  // We won't need to map query indices, but will we need to map distances?
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-    neighborPtr = new std::vector<std::vector<size_t>>;
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distances.clear();
-  distances.resize(querySet.n_cols);
+  // We won't need to map query indices, but will we need to map reference
+  // indices?
+  MappedCallback<CallbackType> mappedCallback(callback, NULL,
+      (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
+  typedef RangeSearchRules<MetricType, Tree, MappedCallback<CallbackType>>
+      RuleType;
+  RuleType rules(*referenceSet, queryTree->Dataset(), range, mappedCallback,
+      metric);
 
   // Create the traverser.
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
@@ -518,24 +458,6 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
-
-  // Do we need to map indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // We must map reference indices only.
-    neighbors.clear();
-    neighbors.resize(querySet.n_cols);
-
-    for (size_t i = 0; i < neighbors.size(); ++i)
-    {
-      neighbors[i].resize((*neighborPtr)[i].size());
-      for (size_t j = 0; j < neighbors[i].size(); ++j)
-        neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-    }
-
-    // Finished with temporary object.
-    delete neighborPtr;
-  }
 }
 
 template<typename MetricType,
@@ -547,32 +469,43 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     const math::Range& range,
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
+{
+  // Resize each vector.
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(referenceSet->n_cols);
+  distances.clear();
+  distances.resize(referenceSet->n_cols);
+
+  NeighborListCallback callback(neighbors, distances);
+  Search(range, callback);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    CallbackType& callback)
 {
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
     return;
 
-  // Here, we will use the query set as the reference set.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
-
-  if (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner)
-  {
-    // We will always need to rearrange in this case.
-    distancePtr = new std::vector<std::vector<double>>;
-    neighborPtr = new std::vector<std::vector<size_t>>;
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(referenceSet->n_cols);
-  distancePtr->clear();
-  distancePtr->resize(referenceSet->n_cols);
+  // Here, we will use the query set as the reference set, so if we built the
+  // tree, both the query and reference indices must be mapped.
+  const std::vector<size_t>* mapping =
+      (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
+  typedef MappedCallback<CallbackType> MappedCallbackType;
+  MappedCallbackType mappedCallback(callback, mapping, mapping);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+  typedef RangeSearchRules<MetricType, Tree, MappedCallbackType> RuleType;
+  RuleType rules(*referenceSet, *referenceSet, range, mappedCallback, metric,
+      true /* don't return the query in the results */);
 
   if (naive)
   {
@@ -586,15 +519,11 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    // Traverse the reference tree for each point.
+    baseCases = 0;
+    scores = 0;
+    SingleTreeTraversal(*referenceSet, range, mappedCallback,
+        true /* don't return the query in the results */);
   }
   else // Dual-tree recursion.
   {
@@ -606,33 +535,125 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     baseCases = rules.BaseCases();
     scores = rules.Scores();
   }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  CSRCallback callback(querySet.n_cols);
+  Search(querySet, range, callback);
+  callback.Finalize(offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  CSRCallback callback(referenceSet->n_cols);
+  Search(range, callback);
+  callback.Finalize(offsets, neighbors, distances);
+}
 
-  // Do we need to map the reference indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  counts.zeros(querySet.n_cols);
+  CountCallback callback(counts);
+  Search(querySet, range, callback);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  counts.zeros(referenceSet->n_cols);
+  CountCallback callback(counts);
+  Search(range, callback);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::SingleTreeTraversal(
+    const MatType& querySet,
+    const math::Range& range,
+    CallbackType& callback,
+    const bool sameSet)
+{
+  typedef RangeSearchRules<MetricType, Tree, CallbackType> RuleType;
+
+  // When the first point of each node is its centroid, the rules cache
+  // distances in the statistics of the reference nodes, so the queries must be
+  // run one at a time.
+  #ifdef HAS_OPENMP
+  if (!tree::TreeTraits<Tree>::FirstPointIsCentroid &&
+      omp_get_max_threads() > 1)
   {
-    neighbors.clear();
-    neighbors.resize(referenceSet->n_cols);
-    distances.clear();
-    distances.resize(referenceSet->n_cols);
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
 
-    for (size_t i = 0; i < distances.size(); ++i)
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
     {
-      // Map distances (copy a column).
-      const size_t refMapping = oldFromNewReferences[i];
-      distances[refMapping] = (*distancePtr)[i];
-
-      // Copy each neighbor individually, because we need to map it.
-      neighbors[refMapping].resize(distances[refMapping].size());
-      for (size_t j = 0; j < distances[refMapping].size(); ++j)
-      {
-        neighbors[refMapping][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
+      // Each thread only gives the results of its own query points.
+      MetricType threadMetric(metric);
+      RuleType rules(*referenceSet, querySet, range, callback, threadMetric,
+          sameSet);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += rules.BaseCases();
+      threadScores += rules.Scores();
     }
 
-    // Finished with temporary objects.
-    delete neighborPtr;
-    delete distancePtr;
+    baseCases += threadBaseCases;
+    scores += threadScores;
+    return;
   }
+  #endif
+
+  RuleType rules(*referenceSet, querySet, range, callback, metric, sameSet);
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+  // Now have it traverse for each point.
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    traverser.Traverse(i, *referenceTree);
+
+  baseCases += rules.BaseCases();
+  scores += rules.Scores();
 }
 
 template<typename MetricType,
@@ -22,6 +22,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "range_search.hpp"
 #include "rs_model.hpp"
@@ -119,6 +120,13 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
+PARAM_FLAG("collect_statistics", "If true, the number of nodes visited and "
+    "pruned, and the number of base cases, are collected for each depth of the "
+    "reference tree and saved to the 'traversal_statistics' output.", "");
+PARAM_UMATRIX_OUT("traversal_statistics", "If --collect_statistics is given, "
+    "matrix to output the traversal statistics into, with one row per depth"
+    " of the reference tree, and the numbers of visited nodes, pruned nodes, "
+    "and base cases in the columns.", "");
 
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
@@ -264,11 +272,25 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     vector<vector<size_t>> neighbors;
     vector<vector<double>> distances;
 
+    TraversalStatistics statistics;
+    if (params.Has("collect_statistics"))
+      statistics.Start();
+
     if (params.Has("query"))
       rs->Search(timers, std::move(queryData), r, neighbors, distances);
     else
       rs->Search(timers, r, neighbors, distances);
 
+    statistics.Stop();
+    if (params.Has("collect_statistics"))
+    {
+      Log::Info << statistics.NumVisited() << " nodes visited, "
+          << statistics.NumPrunes() << " nodes pruned, "
+          << statistics.NumBaseCases() << " base cases." << endl;
+      params.Get<arma::Mat<size_t>>("traversal_statistics") =
+          statistics.Matrix();
+    }
+
     Log::Info << "Search complete." << endl;
 
     // Save output, if desired.  We have to do this by hand.
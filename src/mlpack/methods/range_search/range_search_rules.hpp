@@ -13,18 +13,24 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include "range_search_callbacks.hpp"
 
 namespace mlpack {
 namespace range {
 
 /**
  * The RangeSearchRules class is a template helper class used by RangeSearch
- * class when performing range searches.
+ * class when performing range searches.  Each result is passed to a callback
+ * as soon as it is found, instead of being stored by the rules.
  *
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam CallbackType The callback to pass each result to; it is called as
+ *      callback(queryIndex, referenceIndex, distance).
  */
-template<typename MetricType, typename TreeType>
+template<typename MetricType,
+         typename TreeType,
+         typename CallbackType = NeighborListCallback>
 class RangeSearchRules
 {
  public:
@@ -35,8 +41,7 @@ class RangeSearchRules
    * @param referenceSet Set of reference data.
    * @param querySet Set of query data.
    * @param range Range to search for.
-   * @param neighbors Vector to store resulting neighbors in.
-   * @param distances Vector to store resulting distances in.
+   * @param callback Callback to pass each result to.
    * @param metric Instantiated metric.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
@@ -44,8 +49,7 @@ class RangeSearchRules
   RangeSearchRules(const arma::mat& referenceSet,
                    const arma::mat& querySet,
                    const math::Range& range,
-                   std::vector<std::vector<size_t> >& neighbors,
-                   std::vector<std::vector<double> >& distances,
+                   CallbackType& callback,
                    MetricType& metric,
                    const bool sameSet = false);
 
@@ -131,11 +135,8 @@ class RangeSearchRules
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The callback each result is passed to.
+  CallbackType& callback;
 
   //! The instantiated metric.
   MetricType& metric;
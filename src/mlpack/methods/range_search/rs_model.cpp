@@ -241,6 +241,43 @@ void RSModel::Search(util::Timers& timers,
   rSearch->Search(timers, range, neighbors, distances);
 }
 
+// Prepare the given query set for several searches.
+tree::PreparedQueries* RSModel::PrepareQueries(util::Timers& timers,
+                                               arma::mat&& querySet)
+{
+  // We may need to map the query set randomly.
+  if (randomBasis)
+  {
+    timers.Start("applying_random_basis");
+    querySet = q * querySet;
+    timers.Stop("applying_random_basis");
+  }
+
+  if (!Naive() && !SingleMode())
+    Log::Info << "Building query tree..." << std::endl;
+
+  return rSearch->PrepareQueries(timers, std::move(querySet), leafSize);
+}
+
+// Perform range search with prepared queries.
+void RSModel::Search(util::Timers& timers,
+                     tree::PreparedQueries& queries,
+                     const math::Range& range,
+                     std::vector<std::vector<size_t>>& neighbors,
+                     std::vector<std::vector<double>>& distances)
+{
+  Log::Info << "Search for points in the range [" << range.Lo() << ", "
+      << range.Hi() << "] with ";
+  if (!Naive() && !SingleMode())
+    Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
+  else if (!Naive())
+    Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
+  else
+    Log::Info << "brute-force (naive) search..." << std::endl;
+
+  rSearch->Search(timers, queries, range, neighbors, distances);
+}
+
 // Get the name of the tree type.
 std::string RSModel::TreeName() const
 {
@@ -19,6 +19,7 @@
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/prepared_queries.hpp>
 
 #include "range_search.hpp"
 
@@ -78,6 +79,20 @@ class RSWrapperBase
                       const math::Range& range,
                       std::vector<std::vector<size_t>>& neighbors,
                       std::vector<std::vector<double>>& distances) = 0;
+
+  //! Prepare the given query set for several bichromatic searches, building
+  //! the query tree if the search mode uses one.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t leafSize) = 0;
+
+  //! Perform bichromatic range search with queries prepared by a wrapper of
+  //! the same type.
+  virtual void Search(util::Timers& timers,
+                      tree::PreparedQueries& queries,
+                      const math::Range& range,
+                      std::vector<std::vector<size_t>>& neighbors,
+                      std::vector<std::vector<double>>& distances) = 0;
 };
 
 /**
@@ -138,6 +153,20 @@ class RSWrapper : public RSWrapperBase
                       std::vector<std::vector<size_t>>& neighbors,
                       std::vector<std::vector<double>>& distances);
 
+  //! Prepare the given query set for several bichromatic searches.  This
+  //! ignores the leaf size.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t /* leafSize */);
+
+  //! Perform bichromatic range search with prepared queries.  In dual-tree
+  //! mode, the queries must hold a query tree of this type.
+  virtual void Search(util::Timers& timers,
+                      tree::PreparedQueries& queries,
+                      const math::Range& range,
+                      std::vector<std::vector<size_t>>& neighbors,
+                      std::vector<std::vector<double>>& distances);
+
   //! Serialize the RangeSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -194,6 +223,12 @@ class LeafSizeRSWrapper : public RSWrapper<TreeType>
                       std::vector<std::vector<double>>& distances,
                       const size_t leafSize);
 
+  //! Prepare the given query set for several bichromatic searches.  This
+  //! overload takes the leaf size into account when building the query tree.
+  virtual tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                                arma::mat&& querySet,
+                                                const size_t leafSize);
+
   //! Serialize the RangeSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -358,6 +393,34 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Prepare the given query set for several searches with Search(), building
+   * the query tree (if the search mode uses one) only once.  If this model
+   * uses a random basis, it is applied to the queries, so they should only be
+   * searched with this model; otherwise they can also be searched with other
+   * models that use the same tree type and search mode.  The caller owns the
+   * returned object, which must be deleted when it is no longer needed.
+   *
+   * @param querySet Set of query points (will be moved).
+   */
+  tree::PreparedQueries* PrepareQueries(util::Timers& timers,
+                                        arma::mat&& querySet);
+
+  /**
+   * Perform range search with queries prepared by PrepareQueries().  The
+   * results are in the original order of the queries.
+   *
+   * @param queries Queries prepared by PrepareQueries().
+   * @param range Range to search for.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void Search(util::Timers& timers,
+              tree::PreparedQueries& queries,
+              const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances);
+
  private:
   //! The type of tree we are using.
   TreeTypes treeType;
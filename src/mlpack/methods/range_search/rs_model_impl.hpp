@@ -77,6 +77,61 @@ void RSWrapper<TreeType>::Search(util::Timers& timers,
   timers.Stop("computing_neighbors");
 }
 
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+tree::PreparedQueries* RSWrapper<TreeType>::PrepareQueries(
+    util::Timers& timers,
+    arma::mat&& querySet,
+    const size_t /* leafSize */)
+{
+  if (Naive() || SingleMode())
+    return new tree::PreparedQueries(std::move(querySet));
+
+  timers.Start("tree_building");
+  typename decltype(rs)::Tree* queryTree = new typename decltype(rs)::Tree(
+      std::move(querySet));
+  timers.Stop("tree_building");
+
+  return new tree::PreparedQueryTree<typename decltype(rs)::Tree>(queryTree,
+      std::vector<size_t>());
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RSWrapper<TreeType>::Search(util::Timers& timers,
+                                 tree::PreparedQueries& queries,
+                                 const math::Range& range,
+                                 std::vector<std::vector<size_t>>& neighbors,
+                                 std::vector<std::vector<double>>& distances)
+{
+  timers.Start("computing_neighbors");
+  if (!Naive() && !SingleMode())
+  {
+    typedef tree::PreparedQueryTree<typename decltype(rs)::Tree> QueryTreeType;
+    QueryTreeType* queryTree = dynamic_cast<QueryTreeType*>(&queries);
+    if (queryTree == NULL)
+    {
+      timers.Stop("computing_neighbors");
+      throw std::invalid_argument("RSModel::Search(): the queries were not "
+          "prepared with a query tree of the type used by the model");
+    }
+
+    // The range search statistics only hold information about reference
+    // nodes, so the query tree can be searched again as it is.
+    rs.Search(&queryTree->Tree(), range, neighbors, distances);
+  }
+  else
+  {
+    rs.Search(queries.QuerySet(), range, neighbors, distances);
+  }
+  timers.Stop("computing_neighbors");
+
+  queries.Unmap(neighbors);
+  queries.Unmap(distances);
+}
+
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
@@ -151,6 +206,27 @@ void LeafSizeRSWrapper<TreeType>::Search(
   }
 }
 
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+tree::PreparedQueries* LeafSizeRSWrapper<TreeType>::PrepareQueries(
+    util::Timers& timers,
+    arma::mat&& querySet,
+    const size_t leafSize)
+{
+  if (rs.Naive() || rs.SingleMode())
+    return new tree::PreparedQueries(std::move(querySet));
+
+  timers.Start("tree_building");
+  std::vector<size_t> oldFromNewQueries;
+  typename decltype(rs)::Tree* queryTree = new typename decltype(rs)::Tree(
+      std::move(querySet), oldFromNewQueries, leafSize);
+  timers.Stop("tree_building");
+
+  return new tree::PreparedQueryTree<typename decltype(rs)::Tree>(queryTree,
+      std::move(oldFromNewQueries));
+}
+
 // Serialize the model.
 template<typename Archive>
 void RSModel::serialize(Archive& ar, const uint32_t /* version */)
@@ -28,6 +28,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/subtree_frontier.hpp>
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
@@ -395,6 +396,33 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Traverse the reference tree once for each of the given number of query
+   * points.  If OpenMP is available, the query points are split across
+   * threads, each with its own rules object.  Each block of query points
+   * samples from its own random stream, so the results do not depend on the
+   * number of threads.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules object to use for the traversal.
+   * @return Number of distance computations performed by all threads.
+   */
+  template<typename RuleType>
+  size_t SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
+  /**
+   * Traverse the given query tree and the reference tree.  If OpenMP is
+   * available, the query tree is split into disjoint subtrees, which are
+   * traversed in parallel with one rules object per subtree, each sampling
+   * from its own random stream.
+   *
+   * @param queryTree Query tree to traverse.
+   * @param rules Rules object to use for the traversal.
+   * @return Number of distance computations performed by all threads.
+   */
+  template<typename RuleType>
+  size_t DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
   //! For access to mappings when building models.
   friend class LeafSizeRAWrapper<TreeType>;
 }; // class RASearch
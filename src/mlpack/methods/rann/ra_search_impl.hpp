@@ -304,9 +304,16 @@ Search(const MatType& querySet,
 
     // Run the base case on each combination of query point and sampled
     // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    #pragma omp parallel
+    {
+      MetricType threadMetric(metric);
+      RuleType threadRules(rules, threadMetric);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+          threadRules.BaseCase(i, (size_t) distinctSamples[j]);
+    }
 
     rules.GetResults(*neighborPtr, *distancePtr);
   }
@@ -321,17 +328,13 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
       // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      const size_t numDistComputations = SingleTreeTraversal(querySet.n_cols,
+          rules);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
-          << (rules.NumDistComputations() / querySet.n_cols) << "."
-          << std::endl;
+          << (numDistComputations / querySet.n_cols) << "." << std::endl;
     }
 
     rules.GetResults(*neighborPtr, *distancePtr);
@@ -346,16 +349,15 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    const size_t numDistComputations = DualTreeTraversal(*queryTree, rules);
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
-        << (rules.NumDistComputations() / querySet.n_cols) << "." << std::endl;
+        << (numDistComputations / querySet.n_cols) << "." << std::endl;
 
     rules.GetResults(*neighborPtr, *distancePtr);
 
@@ -456,9 +458,7 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, rules);
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -519,25 +519,25 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
         distinctSamples);
 
     // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    #pragma omp parallel
+    {
+      MetricType threadMetric(metric);
+      RuleType threadRules(rules, threadMetric);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          threadRules.BaseCase(i, j);
+    }
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
     // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(referenceSet->n_cols, rules);
   }
   else
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeTraversal(*referenceTree, rules);
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
@@ -581,6 +581,103 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::ResetQueryTree(
     ResetQueryTree(&queryNode->Child(i));
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+size_t RASearch<SortPolicy, MetricType, MatType, TreeType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+  // The query points are split into tasks of 16 points, and each task samples
+  // from its own random stream, so that the results depend on the random seed
+  // but not on the number of threads.
+  const size_t taskSize = 16;
+  const size_t numTasks = (numQueries + taskSize - 1) / taskSize;
+  const size_t firstStream = math::ReserveRandomStreams(numTasks);
+  size_t numDistComputations = 0;
+
+  #pragma omp parallel reduction(+:numDistComputations)
+  {
+    // Each thread visits its own query points, so its rules can insert
+    // directly into the candidate lists of the main rules object.
+    MetricType threadMetric(metric);
+    RuleType threadRules(rules, threadMetric);
+    typename Tree::template SingleTreeTraverser<RuleType>
+        traverser(threadRules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t t = 0; t < (omp_size_t) numTasks; ++t)
+    {
+      threadRules.Generator() = math::RandomStream(firstStream + t);
+      const size_t end = std::min(numQueries, (size_t) (t + 1) * taskSize);
+      for (size_t i = t * taskSize; i < end; ++i)
+        traverser.Traverse(i, *referenceTree);
+    }
+
+    numDistComputations += threadRules.NumDistComputations();
+  }
+
+  return numDistComputations;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+size_t RASearch<SortPolicy, MetricType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+  // Split the query tree into several subtrees per thread, so that the dynamic
+  // schedule can balance the load when some subtrees are pruned much earlier
+  // than others.
+  std::vector<Tree*> frontier;
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+    tree::SubtreeFrontier(queryTree, 8 * numThreads, frontier);
+  #endif
+
+  if (frontier.size() <= 1)
+  {
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return rules.NumDistComputations();
+  }
+
+  const size_t firstStream = math::ReserveRandomStreams(frontier.size());
+  size_t numDistComputations = 0;
+
+  #pragma omp parallel reduction(+:numDistComputations)
+  {
+    MetricType threadMetric(metric);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      // The subtrees are disjoint, so each thread's rules can insert directly
+      // into the candidate lists of the main rules object, and the statistics
+      // of the query nodes are only modified by one thread.
+      RuleType threadRules(rules, threadMetric);
+      threadRules.Generator() = math::RandomStream(firstStream + i);
+      typename Tree::template DualTreeTraverser<RuleType>
+          traverser(threadRules);
+      traverser.Traverse(*frontier[i], *referenceTree);
+
+      numDistComputations += threadRules.NumDistComputations();
+    }
+  }
+
+  return numDistComputations;
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -14,6 +14,7 @@
 #ifndef MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 #define MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 
+#include <mlpack/core/math/random.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 
 #include <queue>
@@ -66,6 +67,22 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Construct a RASearchRules object for one thread of a parallel search.  The
+   * new object has its own statistics and its own random number generator (a
+   * copy of the generator of other, which the thread should reseed with
+   * Generator() for each task), but it inserts candidates directly into the
+   * candidate lists of the given rules object and counts samples there too,
+   * so the results of every thread are available through other.GetResults()
+   * once all threads are finished.  Each thread must visit a set of query
+   * points (or, for a dual-tree search, a set of query subtrees) that is
+   * disjoint from the sets visited by every other thread.
+   *
+   * @param other Rules object whose candidate lists will be used.
+   * @param metric Instantiated metric for this thread.
+   */
+  RASearchRules(RASearchRules& other, MetricType& metric);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -228,6 +245,10 @@ class RASearchRules
 
 
   size_t NumDistComputations() { return numDistComputations; }
+
+  //! Get the random number generator used for sampling.
+  std::mt19937& Generator() { return generator; }
+
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -268,8 +289,12 @@ class RASearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
+  //! Candidate lists owned by this object.  This is empty if the object was
+  //! constructed for a thread of a parallel search.
+  std::vector<CandidateList> candidateStorage;
+
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -289,8 +314,11 @@ class RASearchRules
   //! The minimum number of samples required per query.
   size_t numSamplesReqd;
 
+  //! The number of samples made for every query, if owned by this object.
+  arma::Col<size_t> numSamplesMadeStorage;
+
   //! The number of samples made for every query.
-  arma::Col<size_t> numSamplesMade;
+  arma::Col<size_t>& numSamplesMade;
 
   //! The sampling ratio.
   double samplingRatio;
@@ -303,6 +331,23 @@ class RASearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! The random number generator used for sampling.
+  std::mt19937 generator;
+
+  /**
+   * Obtain the distinct points among numSamples points drawn uniformly (with
+   * replacement) from [0, numPoints), or all the points if numSamples is not
+   * less than numPoints.  This has the same distribution as
+   * math::ObtainDistinctSamples(), but it uses the generator of this object.
+   *
+   * @param numPoints Number of points to sample from.
+   * @param numSamples Number of samples to draw.
+   * @param distinctSamples The sorted distinct samples.
+   */
+  void ObtainDistinctSamples(const size_t numPoints,
+                             const size_t numSamples,
+                             arma::uvec& distinctSamples);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
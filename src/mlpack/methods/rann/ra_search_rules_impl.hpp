@@ -33,12 +33,15 @@ RASearchRules(const arma::mat& referenceSet,
               const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    sameSet(sameSet)
+    numSamplesMade(numSamplesMadeStorage),
+    sameSet(sameSet),
+    generator(math::RandomStream(math::ReserveRandomStreams(1)))
 {
   // Validate tau to make sure that the rank approximation is greater than the
   // number of neighbors requested.
@@ -84,14 +87,81 @@ RASearchRules(const arma::mat& referenceSet,
 
   if (naive) // No tree traversal; just do naive sampling here.
   {
-    // Sample enough points.
-    arma::uvec distinctSamples;
-    for (size_t i = 0; i < querySet.n_cols; ++i)
+    // Sample enough points for each query point, in parallel.  Each query
+    // point samples from its own random stream, so that the samples do not
+    // depend on the number of threads.
+    const size_t firstStream = math::ReserveRandomStreams(querySet.n_cols);
+    size_t threadDistComputations = 0;
+
+    #pragma omp parallel reduction(+:threadDistComputations)
     {
-      math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        BaseCase(i, (size_t) distinctSamples[j]);
+      MetricType threadMetric(metric);
+      RASearchRules threadRules(*this, threadMetric);
+      arma::uvec distinctSamples;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      {
+        threadRules.Generator() = math::RandomStream(firstStream + i);
+        threadRules.ObtainDistinctSamples(n, numSamplesReqd, distinctSamples);
+        for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+          threadRules.BaseCase(i, (size_t) distinctSamples[j]);
+      }
+
+      threadDistComputations += threadRules.NumDistComputations();
     }
+
+    numDistComputations += threadDistComputations;
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+RASearchRules<SortPolicy, MetricType, TreeType>::
+RASearchRules(RASearchRules& other, MetricType& metric) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(metric),
+    sampleAtLeaves(other.sampleAtLeaves),
+    firstLeafExact(other.firstLeafExact),
+    singleSampleLimit(other.singleSampleLimit),
+    numSamplesReqd(other.numSamplesReqd),
+    numSamplesMade(other.numSamplesMade),
+    samplingRatio(other.samplingRatio),
+    numDistComputations(0),
+    sameSet(other.sameSet),
+    generator(other.generator)
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::ObtainDistinctSamples(
+    const size_t numPoints,
+    const size_t numSamples,
+    arma::uvec& distinctSamples)
+{
+  if (numSamples < numPoints)
+  {
+    // Draw the samples with replacement, and keep the distinct ones; this
+    // takes O(numSamples log numSamples) time and no memory proportional to
+    // numPoints.
+    std::uniform_int_distribution<arma::uword> dist(0, numPoints - 1);
+    distinctSamples.set_size(numSamples);
+    for (size_t i = 0; i < numSamples; ++i)
+      distinctSamples[i] = dist(generator);
+
+    std::sort(distinctSamples.begin(), distinctSamples.end());
+    const size_t numDistinct = std::unique(distinctSamples.begin(),
+        distinctSamples.end()) - distinctSamples.begin();
+    distinctSamples.resize(numDistinct);
+  }
+  else
+  {
+    distinctSamples.set_size(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+      distinctSamples[i] = i;
   }
 }
 
@@ -202,7 +272,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
           arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; ++i)
             // The counting of the samples are done in the 'BaseCase' function
@@ -218,7 +288,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             // Approximate node by sampling enough number of points.
             arma::uvec distinctSamples;
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t i = 0; i < distinctSamples.n_elem; ++i)
               // The counting of the samples are done in the 'BaseCase' function
@@ -306,7 +376,7 @@ Rescore(const size_t queryIndex,
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
         arma::uvec distinctSamples;
-        math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+        ObtainDistinctSamples(referenceNode.NumDescendants(),
             samplesReqd, distinctSamples);
         for (size_t i = 0; i < distinctSamples.n_elem; ++i)
           // The counting of the samples are done in the 'BaseCase' function so
@@ -322,7 +392,7 @@ Rescore(const size_t queryIndex,
         {
           // Approximate node by sampling enough points.
           arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; ++i)
             // The counting of the samples are done in the 'BaseCase' function
@@ -509,7 +579,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; ++j)
               // The counting of the samples are done in the 'BaseCase' function
@@ -539,7 +609,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
             {
               const size_t queryIndex = queryNode.Descendant(i);
-              math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+              ObtainDistinctSamples(referenceNode.NumDescendants(),
                   samplesReqd, distinctSamples);
               for (size_t j = 0; j < distinctSamples.n_elem; ++j)
                 // The counting of the samples are done in the 'BaseCase'
@@ -714,7 +784,7 @@ Rescore(TreeType& queryNode,
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
         {
           const size_t queryIndex = queryNode.Descendant(i);
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+          ObtainDistinctSamples(referenceNode.NumDescendants(),
               samplesReqd, distinctSamples);
           for (size_t j = 0; j < distinctSamples.n_elem; ++j)
             // The counting of the samples are done in the 'BaseCase'
@@ -743,7 +813,7 @@ Rescore(TreeType& queryNode,
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
+            ObtainDistinctSamples(referenceNode.NumDescendants(),
                 samplesReqd, distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; ++j)
               // The counting of the samples are done in BaseCase() so no
@@ -0,0 +1,217 @@
+/**
+ * @file methods/reinforcement_learning/actor_learner.hpp
+ *
+ * This file is the definition of ActorLearner class, which trains a
+ * Q-Learning agent with many actors that generate experience in parallel and
+ * one learner that consumes it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ACTOR_LEARNER_HPP
+#define MLPACK_METHODS_RL_ACTOR_LEARNER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mutex>
+#include <deque>
+
+#include "q_learning.hpp"
+#include "training_config.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Decoupled actor-learner training of a Q-Learning agent, in the style of
+ * Ape-X.  Each actor interacts with its own copy of the environment, with a
+ * local copy of the learning network and of the behavior policy, and sends
+ * its transitions to a queue in trajectories of config.UpdateInterval()
+ * steps.  The learner takes the trajectories from the queue, stores them in
+ * the replay buffer (one stream per actor, so the n-step returns of different
+ * actors are not mixed) and trains the network with QLearning, once per
+ * transition.  Every SyncInterval() training steps, the learner publishes its
+ * parameters and policy, which the actors pick up before their next
+ * trajectory.
+ *
+ * The actors and the learner run in their own OpenMP threads, and only meet at
+ * the queue and at the published parameters, so the actors never wait for the
+ * training of the network (and the learner never waits for the environments),
+ * unless the queue is full.  There are config.NumWorkers() actors, which are
+ * shared among all the threads but one; with a single thread, the actors and
+ * the learner take turns.
+ *
+ * For more details, see the following:
+ * @code
+ * @inproceedings{horgan2018distributed,
+ *   title     = {Distributed Prioritized Experience Replay},
+ *   author    = {Horgan, Dan and Quan, John and Budden, David and
+ *                Barth-Maron, Gabriel and Hessel, Matteo and van Hasselt,
+ *                Hado and Silver, David},
+ *   booktitle = {International Conference on Learning Representations},
+ *   year      = {2018}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ * @tparam NetworkType The network to compute action value.
+ * @tparam UpdaterType How to apply gradients when training.
+ * @tparam PolicyType Behavior policy of the agent.
+ * @tparam ReplayType Experience replay method.
+ */
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType = RandomReplay<EnvironmentType>
+>
+class ActorLearner
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for the learner.
+  using LearnerType = QLearning<EnvironmentType, NetworkType, UpdaterType,
+      PolicyType, ReplayType>;
+
+  /**
+   * Create the ActorLearner object with given settings.  The arguments are
+   * given to the QLearning learner.
+   *
+   * @param config Hyper-parameters for training.
+   * @param network The network to compute action value.
+   * @param policy Behavior policy of the agent.
+   * @param replayMethod Experience replay method.
+   * @param updater How to apply gradients when training.
+   * @param environment Reinforcement learning task, which each actor copies.
+   */
+  ActorLearner(TrainingConfig& config,
+               NetworkType& network,
+               PolicyType& policy,
+               ReplayType& replayMethod,
+               UpdaterType updater = UpdaterType(),
+               EnvironmentType environment = EnvironmentType());
+
+  /**
+   * Train the agent until the given measure is satisfied.
+   *
+   * @tparam Measure The type of the measurement. It should be a
+   *   callable object like
+   *   @code
+   *   bool foo(double reward);
+   *   @endcode
+   * @param measure The measurement instance, which is called by the learner
+   *     with the return of each episode of the actors.  The training stops
+   *     when it returns true.
+   */
+  template <typename Measure>
+  void Train(Measure& measure);
+
+  //! Get the learner.
+  const LearnerType& Learner() const { return learner; }
+  //! Modify the learner.
+  LearnerType& Learner() { return learner; }
+
+  //! Get the number of training steps between two syncs of the actors.
+  size_t SyncInterval() const { return syncInterval; }
+  //! Modify the number of training steps between two syncs of the actors.
+  size_t& SyncInterval() { return syncInterval; }
+
+  //! Get the maximum number of trajectories in the queue.
+  size_t QueueCapacity() const { return queueCapacity; }
+  //! Modify the maximum number of trajectories in the queue.
+  size_t& QueueCapacity() { return queueCapacity; }
+
+ private:
+  //! The local state of an actor.
+  struct Actor
+  {
+    //! The copy of the environment.
+    EnvironmentType environment;
+    //! The local copy of the learning network.
+    NetworkType network;
+    //! The local copy of the behavior policy.
+    PolicyType policy;
+    //! The version of the published parameters of the local copies.
+    size_t version;
+    //! The current state.
+    StateType state;
+    //! The number of steps of the current episode.
+    size_t steps;
+    //! The return of the current episode.
+    double episodeReturn;
+  };
+
+  //! A trajectory of an actor.
+  struct Trajectory
+  {
+    //! The index of the actor.
+    size_t actor;
+    //! The transitions of the trajectory.
+    std::vector<StateType> states;
+    std::vector<ActionType> actions;
+    std::vector<double> rewards;
+    std::vector<StateType> nextStates;
+    std::vector<int> isEnd;
+    //! The returns of the episodes that ended in the trajectory.
+    std::vector<double> returns;
+  };
+
+  /**
+   * Generate a trajectory with the given actor, and push it to the queue.
+   */
+  void Act(Actor& actor, const size_t index);
+
+  /**
+   * Store and train on all the trajectories in the queue, and publish the
+   * parameters when needed.  Returns true if the measure is satisfied.
+   */
+  template <typename Measure>
+  bool Learn(Measure& measure);
+
+  //! Locally-stored hyper-parameters.
+  TrainingConfig& config;
+
+  //! Locally-stored behavior policy.
+  PolicyType& policy;
+
+  //! Locally-stored experience method.
+  ReplayType& replayMethod;
+
+  //! Locally-stored reinforcement learning task.
+  EnvironmentType environment;
+
+  //! The learner.
+  LearnerType learner;
+
+  //! The number of training steps between two syncs of the actors.
+  size_t syncInterval;
+
+  //! The maximum number of trajectories in the queue.
+  size_t queueCapacity;
+
+  //! The queue of trajectories.
+  std::deque<Trajectory> queue;
+  //! The lock of the queue.
+  std::mutex queueMutex;
+
+  //! The parameters and policy published by the learner, and their version.
+  arma::mat publishedParameters;
+  PolicyType publishedPolicy;
+  size_t publishedVersion;
+  //! The lock of the published parameters and policy.
+  std::mutex publishedMutex;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+// Include implementation
+#include "actor_learner_impl.hpp"
+#endif
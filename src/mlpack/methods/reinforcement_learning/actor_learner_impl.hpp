@@ -0,0 +1,280 @@
+/**
+ * @file methods/reinforcement_learning/actor_learner_impl.hpp
+ *
+ * This file is the implementation of ActorLearner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ACTOR_LEARNER_IMPL_HPP
+#define MLPACK_METHODS_RL_ACTOR_LEARNER_IMPL_HPP
+
+#include <thread>
+
+#include "actor_learner.hpp"
+
+namespace mlpack {
+namespace rl {
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::ActorLearner(TrainingConfig& config,
+                NetworkType& network,
+                PolicyType& policy,
+                ReplayType& replayMethod,
+                UpdaterType updater,
+                EnvironmentType environment) :
+    config(config),
+    policy(policy),
+    replayMethod(replayMethod),
+    environment(environment),
+    learner(config, network, policy, replayMethod, std::move(updater),
+        std::move(environment)),
+    syncInterval(config.TargetNetworkSyncInterval()),
+    queueCapacity(4 * std::max(config.NumWorkers(), (size_t) 1)),
+    publishedPolicy(policy),
+    publishedVersion(0)
+{ /* Nothing to do here. */ }
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+template <typename Measure>
+void ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Train(Measure& measure)
+{
+  if (syncInterval == 0)
+  {
+    Log::Fatal << "ActorLearner::Train(): the sync interval must be positive!"
+        << std::endl;
+  }
+
+  // Publish the initial parameters, and set up the actors with them.
+  publishedParameters = learner.Network().Parameters();
+  publishedPolicy = policy;
+  ++publishedVersion;
+  queue.clear();
+
+  const size_t numActors = std::max(config.NumWorkers(), (size_t) 1);
+  std::vector<Actor> actors;
+  actors.reserve(numActors);
+  for (size_t i = 0; i < numActors; ++i)
+  {
+    actors.push_back(Actor{ environment, learner.Network(), policy,
+        publishedVersion, StateType(), 0, 0.0 });
+    actors.back().state = actors.back().environment.InitialSample();
+  }
+
+  size_t numThreads = 0;
+  #pragma omp parallel reduction(+:numThreads)
+  numThreads++;
+  Log::Debug << numThreads << " threads will be used in total." << std::endl;
+
+  bool stop = false;
+  #pragma omp parallel for shared(stop, actors) schedule(static, 1)
+  for (omp_size_t thread = 0; thread < (omp_size_t) numThreads; ++thread)
+  {
+    if (numThreads == 1)
+    {
+      // The actors and the learner take turns.
+      while (!stop)
+      {
+        for (size_t i = 0; i < numActors; ++i)
+          Act(actors[i], i);
+        stop = Learn(measure);
+      }
+    }
+    else if (thread == 0)
+    {
+      // This is the learner.
+      while (!stop)
+      {
+        if (Learn(measure))
+          stop = true;
+        else
+          std::this_thread::yield();
+      }
+    }
+    else
+    {
+      // Each of the other threads runs every (numThreads - 1)-th actor.
+      while (!stop)
+      {
+        for (size_t i = thread - 1; i < numActors && !stop;
+            i += numThreads - 1)
+        {
+          Act(actors[i], i);
+        }
+      }
+    }
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+void ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Act(Actor& actor, const size_t index)
+{
+  // Skip this turn if the queue is full, so that the actors do not get too far
+  // ahead of the learner.
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (queue.size() >= queueCapacity)
+      return;
+  }
+
+  // Sync with the latest published parameters and policy.
+  {
+    std::lock_guard<std::mutex> lock(publishedMutex);
+    if (actor.version != publishedVersion)
+    {
+      actor.network.Parameters() = publishedParameters;
+      actor.policy = publishedPolicy;
+      actor.version = publishedVersion;
+    }
+  }
+
+  Trajectory trajectory;
+  trajectory.actor = index;
+  const size_t length = std::max(config.UpdateInterval(), (size_t) 1);
+  for (size_t step = 0; step < length; ++step)
+  {
+    // Interact with the environment.
+    arma::colvec actionValue;
+    actor.network.Predict(actor.state.Encode(), actionValue);
+    const ActionType action = actor.policy.Sample(actionValue, false,
+        config.NoisyQLearning());
+    StateType nextState;
+    const double reward = actor.environment.Sample(actor.state, action,
+        nextState);
+    actor.episodeReturn += reward;
+    actor.steps++;
+
+    // As in the async workers, reaching the step limit also ends the episode.
+    const bool terminal = actor.environment.IsTerminal(nextState) ||
+        (config.StepLimit() && actor.steps >= config.StepLimit());
+
+    trajectory.states.push_back(actor.state);
+    trajectory.actions.push_back(action);
+    trajectory.rewards.push_back(reward);
+    trajectory.nextStates.push_back(nextState);
+    trajectory.isEnd.push_back(terminal);
+
+    if (terminal)
+    {
+      trajectory.returns.push_back(actor.episodeReturn);
+      actor.episodeReturn = 0;
+      actor.steps = 0;
+      actor.state = actor.environment.InitialSample();
+    }
+    else
+    {
+      actor.state = nextState;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(queueMutex);
+  queue.push_back(std::move(trajectory));
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+template <typename Measure>
+bool ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Learn(Measure& measure)
+{
+  // Take all the trajectories at once, so that the actors can keep pushing
+  // while the learner trains.
+  std::deque<Trajectory> trajectories;
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    trajectories.swap(queue);
+  }
+
+  for (Trajectory& trajectory : trajectories)
+  {
+    // Store the transitions in the stream of the actor, all at once.
+    const size_t n = trajectory.states.size();
+    arma::Col<size_t> streams(n);
+    streams.fill(trajectory.actor);
+    replayMethod.Store(trajectory.states, trajectory.actions,
+        arma::rowvec(trajectory.rewards), trajectory.nextStates,
+        arma::conv_to<arma::irowvec>::from(trajectory.isEnd), streams,
+        config.Discount());
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      learner.TotalSteps()++;
+      if (learner.TotalSteps() < config.ExplorationSteps())
+        continue;
+      if (config.IsCategorical())
+        learner.TrainCategoricalAgent();
+      else
+        learner.TrainAgent();
+
+      // Publish the parameters and the policy for the actors.
+      if (learner.TotalSteps() % syncInterval == 0)
+      {
+        std::lock_guard<std::mutex> lock(publishedMutex);
+        publishedParameters = learner.Network().Parameters();
+        publishedPolicy = policy;
+        ++publishedVersion;
+      }
+    }
+
+    for (size_t i = 0; i < trajectory.returns.size(); ++i)
+    {
+      if (measure(trajectory.returns[i]))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/threads.hpp>
 #include "queue"
 
 namespace mlpack {
@@ -73,12 +74,16 @@ void AsyncLearning<
   PolicyType policy = this->policy;
   bool stop = false;
 
+  // Set up the shards of the learning network, which the workers update.
+  ParameterShards shards(learningNetwork.Parameters().n_elem,
+      config.NumParameterShards());
+
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
   for (size_t i = 0; i <= config.NumWorkers(); ++i)
   {
     workers.push_back(WorkerType(updater, environment, config, !i));
-    workers.back().Initialize(learningNetwork);
+    workers.back().Initialize(learningNetwork, &shards);
   }
   // Set up task queue corresponding to worker pool.
   std::queue<size_t> tasks;
@@ -95,6 +100,10 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
+  // Each worker runs its networks on its own thread, so BLAS must not start
+  // more threads for every worker.
+  SerialBLASScope serialBLAS;
+
   #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
       targetNetwork, totalSteps, policy)
   for (omp_size_t i = 0; i < numThreads; ++i)
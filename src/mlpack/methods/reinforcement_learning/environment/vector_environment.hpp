@@ -0,0 +1,142 @@
+/**
+ * @file methods/reinforcement_learning/environment/vector_environment.hpp
+ *
+ * This file is the definition of the VectorEnvironment class, which steps
+ * several copies of an environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A vector of copies of an environment, which are stepped in lockstep: each
+ * call to Sample() takes one step in every copy whose state is not terminal.
+ * The agents use it to select the actions of all the copies with one forward
+ * pass of their network over the encoded states (see Encode()), instead of
+ * one forward pass per state.
+ *
+ * Each copy has its own step counter (for the environments with a maximum
+ * number of steps), so the copies are independent episodes.
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ */
+template<typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment.
+   *
+   * @param numEnvironments Number of copies.
+   * @param environment Environment to copy.
+   */
+  VectorEnvironment(const size_t numEnvironments,
+                    const EnvironmentType& environment = EnvironmentType()) :
+      environments(numEnvironments, environment)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Start a new episode in every copy.
+   *
+   * @return The initial state of each copy.
+   */
+  std::vector<StateType> InitialSample()
+  {
+    std::vector<StateType> states(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+      states[i] = environments[i].InitialSample();
+    return states;
+  }
+
+  /**
+   * Take one step in every copy whose state is not terminal.  The copies whose
+   * state is terminal keep their state, with a reward of 0.
+   *
+   * @param states The current state of each copy.
+   * @param actions The action to take in each copy.
+   * @param nextStates The next state of each copy.
+   * @return The reward of each copy.
+   */
+  arma::rowvec Sample(const std::vector<StateType>& states,
+                      const std::vector<ActionType>& actions,
+                      std::vector<StateType>& nextStates)
+  {
+    arma::rowvec rewards(environments.size(), arma::fill::zeros);
+    nextStates.resize(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      if (environments[i].IsTerminal(states[i]))
+        nextStates[i] = states[i];
+      else
+        rewards[i] = environments[i].Sample(states[i], actions[i],
+            nextStates[i]);
+    }
+
+    return rewards;
+  }
+
+  /**
+   * Check whether the state of each copy is terminal.
+   *
+   * @param states The state of each copy.
+   */
+  arma::irowvec IsTerminal(const std::vector<StateType>& states) const
+  {
+    arma::irowvec terminal(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+      terminal[i] = environments[i].IsTerminal(states[i]);
+    return terminal;
+  }
+
+  /**
+   * Encode the given states, one column per state, so that they can be given
+   * to a network in one batch.
+   *
+   * @param states The states to encode.
+   */
+  static arma::mat Encode(const std::vector<StateType>& states)
+  {
+    if (states.empty())
+      return arma::mat();
+
+    arma::mat encoded(states[0].Encode().n_elem, states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+      encoded.col(i) = states[i].Encode();
+    return encoded;
+  }
+
+  //! Get the number of copies.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the given copy.
+  const EnvironmentType& Environment(const size_t i) const
+  {
+    return environments[i];
+  }
+  //! Modify the given copy.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
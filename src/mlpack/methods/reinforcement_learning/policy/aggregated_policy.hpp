@@ -57,6 +57,43 @@ class AggregatedPolicy
     return policies[selected].Sample(actionValue, false);
   }
 
+  /**
+   * Sample an action for each of the given states, based on their action
+   * values.  A child policy is drawn for each state, and each child policy
+   * samples the actions of all its states at once.
+   *
+   * @param actionValues Values for each action (one column per state).
+   * @param actions Sampled action for each state; will be resized.
+   * @param deterministic Always select the actions greedily.
+   */
+  void Sample(const arma::mat& actionValues,
+              std::vector<ActionType>& actions,
+              bool deterministic = false)
+  {
+    if (deterministic)
+    {
+      policies.front().Sample(actionValues, actions, true);
+      return;
+    }
+
+    actions.resize(actionValues.n_cols);
+    arma::uvec selected(actionValues.n_cols);
+    for (size_t i = 0; i < actionValues.n_cols; ++i)
+      selected[i] = arma::as_scalar(sampler.Random());
+
+    std::vector<ActionType> childActions;
+    for (size_t p = 0; p < policies.size(); ++p)
+    {
+      const arma::uvec states = arma::find(selected == p);
+      if (states.is_empty())
+        continue;
+
+      policies[p].Sample(actionValues.cols(states), childActions, false);
+      for (size_t i = 0; i < states.n_elem; ++i)
+        actions[states[i]] = childActions[i];
+    }
+  }
+
   /**
    * Exploration probability will anneal at each step.
    */
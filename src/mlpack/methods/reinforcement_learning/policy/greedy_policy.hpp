@@ -84,6 +84,43 @@ class GreedyPolicy
     return action;
   }
 
+  /**
+   * Sample an action for each of the given states, based on their action
+   * values (for instance, from one batched Predict() of the network).  The
+   * exploration decisions are drawn for all the states at once, and the greedy
+   * actions are found with one pass over the matrix.
+   *
+   * @param actionValues Values for each action (one column per state).
+   * @param actions Sampled action for each state; will be resized.
+   * @param deterministic Always select the actions greedily.
+   * @param isNoisy Specifies whether the network used is noisy.
+   */
+  void Sample(const arma::mat& actionValues,
+              std::vector<ActionType>& actions,
+              bool deterministic = false,
+              const bool isNoisy = false)
+  {
+    actions.resize(actionValues.n_cols);
+    const arma::urowvec greedy = arma::index_max(actionValues, 0);
+    for (size_t i = 0; i < actionValues.n_cols; ++i)
+    {
+      actions[i].action = static_cast<decltype(actions[i].action)>(
+          greedy[i]);
+    }
+
+    // Select some of the actions randomly.
+    if (!deterministic && isNoisy == false)
+    {
+      const arma::uvec explore = arma::find(
+          arma::randu<arma::rowvec>(actionValues.n_cols) < epsilon);
+      for (size_t i = 0; i < explore.n_elem; ++i)
+      {
+        actions[explore[i]].action = static_cast<decltype(
+            actions[explore[i]].action)>(math::RandInt(ActionType::size));
+      }
+    }
+  }
+
   /**
    * Exploration probability will anneal at each step.
    */
@@ -18,6 +18,7 @@
 
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -111,6 +112,18 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Execute an episode in each copy of the given vector of environments, in
+   * lockstep.  At each step, the actions of all the copies that are not done
+   * are selected with one forward pass of the network, and their transitions
+   * are stored in the replay buffer with one call.  The agent is trained after
+   * each stored transition, as in Episode().
+   *
+   * @param environments Copies of the environment.
+   * @return Return of the episode of each copy.
+   */
+  arma::vec Episodes(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -182,6 +195,14 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Locally-stored buffers of the sampled transitions, which are reused
+  //! between updates.
+  arma::mat sampledStates;
+  std::vector<ActionType> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::mat sampledNextStates;
+  arma::irowvec isTerminal;
 };
 
 } // namespace rl
@@ -134,13 +134,7 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
+  // Sample from previous experience, into the buffers of the agent.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -221,13 +215,7 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
+  // Sample from previous experience, into the buffers of the agent.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -387,6 +375,87 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::vec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Episodes(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the initial state of each copy of the environment.
+  std::vector<StateType> states = environments.InitialSample();
+  arma::irowvec terminal = environments.IsTerminal(states);
+
+  // Track the return of the episode of each copy.
+  arma::vec totalReturns(environments.NumEnvironments(), arma::fill::zeros);
+
+  std::vector<ActionType> actions(environments.NumEnvironments());
+  std::vector<StateType> nextStates;
+  while (arma::any(terminal == 0))
+  {
+    const arma::uvec running = arma::find(terminal == 0);
+    std::vector<StateType> runningStates(running.n_elem);
+    for (size_t i = 0; i < running.n_elem; ++i)
+      runningStates[i] = states[running[i]];
+
+    // Get the action values of all the running copies with one forward pass,
+    // and select the actions of all of them at once with the behavior policy.
+    arma::mat actionValues;
+    learningNetwork.Predict(
+        VectorEnvironment<EnvironmentType>::Encode(runningStates),
+        actionValues);
+    std::vector<ActionType> runningActions;
+    policy.Sample(actionValues, runningActions, deterministic,
+        config.NoisyQLearning());
+    for (size_t i = 0; i < running.n_elem; ++i)
+      actions[running[i]] = runningActions[i];
+
+    // Interact with the environments to advance to the next states.
+    const arma::rowvec rewards = environments.Sample(states, actions,
+        nextStates);
+    const arma::irowvec nextTerminal = environments.IsTerminal(nextStates);
+
+    // Store the transitions of the running copies for replay, all at once.
+    std::vector<StateType> runningNextStates(running.n_elem);
+    for (size_t i = 0; i < running.n_elem; ++i)
+      runningNextStates[i] = nextStates[running[i]];
+    replayMethod.Store(runningStates, runningActions,
+        arma::rowvec(rewards.elem(running).t()), runningNextStates,
+        arma::irowvec(nextTerminal.elem(running).t()),
+        arma::conv_to<arma::Col<size_t>>::from(running), config.Discount());
+
+    // The state and action of the agent follow the first running copy.
+    state = runningNextStates[0];
+    action = runningActions[0];
+
+    for (size_t i = 0; i < running.n_elem; ++i)
+    {
+      totalReturns[running[i]] += rewards[running[i]];
+      totalSteps++;
+
+      if (deterministic || totalSteps < config.ExplorationSteps())
+        continue;
+      if (config.IsCategorical())
+        TrainCategoricalAgent();
+      else
+        TrainAgent();
+    }
+
+    states = std::move(nextStates);
+    terminal = nextTerminal;
+  }
+
+  return totalReturns;
+}
+
 } // namespace rl
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "sumtree.hpp"
+#include "replay_memory.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -23,6 +24,10 @@ namespace rl {
  * replay can replay important transitions more frequently by prioritizing
  * transitions, and make agent learn more efficiently.
  *
+ * The transitions are held in a ReplayMemory, which stores each state of an
+ * episode once.  Store(), Sample() and Update() can be called from several
+ * threads.
+ *
  * @code
  * @article{schaul2015prioritized,
  *  title   = {Prioritized experience replay},
@@ -45,29 +50,19 @@ class PrioritizedReplay
   //! Convenient typedef for state.
   using StateType = typename EnvironmentType::State;
 
-  struct Transition
-  {
-    StateType state;
-    ActionType action;
-    double reward;
-    StateType nextState;
-    bool isEnd;
-  };
+  //! Convenient typedef for a step that is not yet part of a transition.
+  using Transition = typename ReplayMemory<EnvironmentType>::Transition;
 
   /**
    * Default constructor.
    */
   PrioritizedReplay():
       batchSize(0),
-      capacity(0),
-      position(0),
-      full(false),
       alpha(0),
       maxPriority(0),
       initialBeta(0),
       beta(0),
-      replayBetaIters(0),
-      nSteps(0)
+      replayBetaIters(0)
   { /* Nothing to do here. */ }
 
   /**
@@ -78,26 +73,23 @@ class PrioritizedReplay
    * @param alpha How much prioritization is used.
    * @param nSteps Number of steps to look in the future.
    * @param dimension The dimension of an encoded state.
+   * @param observationCapacity Number of encoded states to hold (0 means
+   *     the ReplayMemory default).
    */
   PrioritizedReplay(const size_t batchSize,
                     const size_t capacity,
                     const double alpha,
                     const size_t nSteps = 1,
-                    const size_t dimension = StateType::dimension) :
+                    const size_t dimension = StateType::dimension,
+                    const size_t observationCapacity = 0) :
       batchSize(batchSize),
-      capacity(capacity),
-      position(0),
-      full(false),
       alpha(alpha),
       maxPriority(1.0),
       initialBeta(0.6),
       replayBetaIters(10000),
-      nSteps(nSteps),
-      states(dimension, capacity),
-      actions(capacity),
-      rewards(capacity),
-      nextStates(dimension, capacity),
-      isTerminal(capacity)
+      memory(capacity, nSteps, dimension, observationCapacity),
+      sampledIndices(batchSize),
+      weights(batchSize)
   {
     size_t size = 1;
     while (size < capacity)
@@ -126,37 +118,37 @@ class PrioritizedReplay
              bool isEnd,
              const double& discount)
   {
-    nStepBuffer.push_back({state, action, reward, nextState, isEnd});
-
-    // Single step transition is not ready.
-    if (nStepBuffer.size() < nSteps)
-      return;
-
-    // To keep the queue size fixed to nSteps.
-    if (nStepBuffer.size() > nSteps)
-      nStepBuffer.pop_front();
-
-    // Before moving ahead, lets confirm if our fixed size buffer works.
-    assert(nStepBuffer.size() == nSteps);
-
-    // Make a n-step transition.
-    GetNStepInfo(reward, nextState, isEnd, discount);
-
-    state = nStepBuffer.front().state;
-    action = nStepBuffer.front().action;
-    states.col(position) = state.Encode();
-    actions[position] = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-
-    idxSum.Set(position, maxPriority * alpha);
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    StoreStep(0, state, action, reward, nextState, isEnd, discount);
+  }
 
-    position++;
-    if (position == capacity)
+  /**
+   * Store the given experiences, one from each of several environments (for
+   * instance the copies of a VectorEnvironment), and set their priorities.
+   * The n-step transitions are made separately for each environment.
+   *
+   * @param newStates Given states.
+   * @param newActions Given actions.
+   * @param newRewards Given rewards.
+   * @param newNextStates Given next states.
+   * @param isEnd Whether each next state is terminal state.
+   * @param environments The environment each experience comes from.
+   * @param discount The discount parameter.
+   */
+  void Store(const std::vector<StateType>& newStates,
+             const std::vector<ActionType>& newActions,
+             const arma::rowvec& newRewards,
+             const std::vector<StateType>& newNextStates,
+             const arma::irowvec& isEnd,
+             const arma::Col<size_t>& environments,
+             const double& discount)
+  {
+    // Stream 0 is the stream of the single experiences.
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    for (size_t i = 0; i < newStates.size(); ++i)
     {
-      full = true;
-      position = 0;
+      StoreStep(environments[i] + 1, newStates[i], newActions[i],
+          newRewards[i], newNextStates[i], isEnd[i], discount);
     }
   }
 
@@ -173,21 +165,8 @@ class PrioritizedReplay
                     bool& isEnd,
                     const double& discount)
   {
-    reward = nStepBuffer.back().reward;
-    nextState = nStepBuffer.back().nextState;
-    isEnd = nStepBuffer.back().isEnd;
-
-    // Should start from the second last transition in buffer.
-    for (int i = nStepBuffer.size() - 2; i >= 0; i--)
-    {
-      bool iE = nStepBuffer[i].isEnd;
-      reward = nStepBuffer[i].reward + discount * reward * (1 - iE);
-      if (iE)
-      {
-        nextState = nStepBuffer[i].nextState;
-        isEnd = iE;
-      }
-    }
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    memory.GetNStepInfo(0, reward, nextState, isEnd, discount);
   }
 
   /**
@@ -198,18 +177,14 @@ class PrioritizedReplay
   arma::ucolvec SampleProportional()
   {
     arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
-    double sumPerRange = totalSum / batchSize;
-    for (size_t bt = 0; bt < batchSize; bt++)
-    {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
-    }
+    SampleProportional(idxes);
     return idxes;
   }
 
   /**
-   * Sample some experience according to their priorities.
+   * Sample some experience according to their priorities.  The given matrices
+   * are only reallocated if they do not have the right size, so they can be
+   * reused between calls.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -224,24 +199,19 @@ class PrioritizedReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    sampledIndices = SampleProportional();
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    SampleProportional(sampledIndices);
     BetaAnneal();
 
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    memory.Gather(sampledIndices, sampledStates, sampledActions,
+        sampledRewards, sampledNextStates, isTerminal);
 
     // Calculate the weights of sampled transitions.
-
-    size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
-
+    const size_t numSample = memory.Size();
+    const double totalSum = idxSum.Sum();
     for (size_t i = 0; i < sampledIndices.n_rows; ++i)
     {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
+      double p_sample = idxSum.Get(sampledIndices(i)) / totalSum;
       weights(i) = pow(numSample * p_sample, -beta);
     }
     weights /= weights.max();
@@ -255,9 +225,8 @@ class PrioritizedReplay
    */
   void UpdatePriorities(arma::ucolvec& indices, arma::colvec& priorities)
   {
-      arma::colvec alphaPri = alpha * priorities;
-      maxPriority = std::max(maxPriority, arma::max(priorities));
-      idxSum.BatchUpdate(indices, alphaPri);
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    SetPriorities(indices, priorities);
   }
 
   /**
@@ -267,7 +236,7 @@ class PrioritizedReplay
    */
   const size_t& Size()
   {
-    return full ? capacity : position;
+    return memory.Size();
   }
 
   /**
@@ -298,27 +267,63 @@ class PrioritizedReplay
           target(sampledActions[i].action, i);
     }
     tdError = arma::abs(tdError);
-    UpdatePriorities(sampledIndices, tdError);
+
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    SetPriorities(sampledIndices, tdError);
 
     // Update the gradient
     gradients = arma::mean(weights) * gradients;
   }
 
   //! Get the number of steps for n-step agent.
-  const size_t& NSteps() const { return nSteps; }
+  const size_t& NSteps() const { return memory.NSteps(); }
+
+  //! Get the underlying memory.
+  const ReplayMemory<EnvironmentType>& Memory() const { return memory; }
 
  private:
-  //! Locally-stored number of examples of each sample.
-  size_t batchSize;
+  //! Store the given step of the given stream, and set the priority of the
+  //! transition that is stored (and of the ones that are dropped).
+  void StoreStep(const size_t stream,
+                 const StateType& state,
+                 const ActionType& action,
+                 const double reward,
+                 const StateType& nextState,
+                 const bool isEnd,
+                 const double discount)
+  {
+    const size_t slot = memory.Store(stream, state, action, reward, nextState,
+        isEnd, discount, [this](const size_t dropped)
+        {
+          idxSum.Set(dropped, 0.0);
+        });
+
+    if (slot < memory.Capacity())
+      idxSum.Set(slot, maxPriority * alpha);
+  }
 
-  //! Locally-stored total memory limit.
-  size_t capacity;
+  //! Sample the slots of a batch according to their priorities.
+  void SampleProportional(arma::ucolvec& idxes)
+  {
+    // Draw one mass in each of batchSize equal ranges (stratified sampling),
+    // so that the masses are sorted, and search for all of them at once.
+    const double sumPerRange = idxSum.Sum() / batchSize;
+    arma::colvec masses = sumPerRange * (arma::randu<arma::colvec>(batchSize) +
+        arma::regspace<arma::colvec>(0, batchSize - 1));
+    idxSum.FindPrefixSum(masses, idxes);
+  }
 
-  //! Indicate the position to store new transition.
-  size_t position;
+  //! Set the priorities of the given transitions.
+  void SetPriorities(const arma::ucolvec& indices,
+                     const arma::colvec& priorities)
+  {
+    arma::colvec alphaPri = alpha * priorities;
+    maxPriority = std::max(maxPriority, arma::max(priorities));
+    idxSum.BatchUpdate(indices, alphaPri);
+  }
 
-  //! Locally-stored indicator that whether the memory is full or not.
-  bool full;
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
 
   //! How much prioritization is used.
   //! (0 - no prioritization, 1 - full prioritization)
@@ -336,6 +341,9 @@ class PrioritizedReplay
   //! How many iteration for replay beta to decay.
   size_t replayBetaIters;
 
+  //! Locally-stored transitions.
+  ReplayMemory<EnvironmentType> memory;
+
   //! Locally-stored the prefix sum of prioritization.
   SumTree<double> idxSum;
 
@@ -344,27 +352,6 @@ class PrioritizedReplay
 
   //! Locally-stored the weights of sampled transitions.
   arma::rowvec weights;
-
-  //! Locally-stored number of steps to look into the future.
-  size_t nSteps;
-
-  //! Locally-stored buffer containing n consecutive steps.
-  std::deque<Transition> nStepBuffer;
-
-  //! Locally-stored encoded previous states.
-  arma::mat states;
-
-  //! Locally-stored previous actions.
-  std::vector<ActionType> actions;
-
-  //! Locally-stored previous rewards.
-  arma::rowvec rewards;
-
-  //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
-
-  //! Locally-stored termination information of previous experience.
-  arma::irowvec isTerminal;
 };
 
 } // namespace rl
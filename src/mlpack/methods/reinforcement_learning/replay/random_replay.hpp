@@ -13,7 +13,8 @@
 #define MLPACK_METHODS_RL_REPLAY_RANDOM_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <cassert>
+#include <mlpack/core/math/random.hpp>
+#include "replay_memory.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -27,6 +28,9 @@ namespace rl {
  * train the agent. Typically this would be a random sample and
  * the memory will be a First-In-First-Out buffer.
  *
+ * The transitions are held in a ReplayMemory, which stores each state of an
+ * episode once.  Store() and Sample() can be called from several threads.
+ *
  * For more information, see the following.
  *
  * @code
@@ -50,21 +54,11 @@ class RandomReplay
   //! Convenient typedef for state.
   using StateType = typename EnvironmentType::State;
 
-  struct Transition
-  {
-    StateType state;
-    ActionType action;
-    double reward;
-    StateType nextState;
-    bool isEnd;
-  };
+  //! Convenient typedef for a step that is not yet part of a transition.
+  using Transition = typename ReplayMemory<EnvironmentType>::Transition;
 
   RandomReplay():
-      batchSize(0),
-      capacity(0),
-      position(0),
-      full(false),
-      nSteps(0)
+      batchSize(0)
   { /* Nothing to do here. */ }
 
   /**
@@ -74,21 +68,17 @@ class RandomReplay
    * @param capacity Total memory size in terms of number of examples.
    * @param nSteps Number of steps to look in the future.
    * @param dimension The dimension of an encoded state.
+   * @param observationCapacity Number of encoded states to hold (0 means
+   *     the ReplayMemory default).
    */
   RandomReplay(const size_t batchSize,
                const size_t capacity,
                const size_t nSteps = 1,
-               const size_t dimension = StateType::dimension) :
+               const size_t dimension = StateType::dimension,
+               const size_t observationCapacity = 0) :
       batchSize(batchSize),
-      capacity(capacity),
-      position(0),
-      full(false),
-      nSteps(nSteps),
-      states(dimension, capacity),
-      actions(capacity),
-      rewards(capacity),
-      nextStates(dimension, capacity),
-      isTerminal(capacity)
+      memory(capacity, nSteps, dimension, observationCapacity),
+      sampledIndices(batchSize)
   { /* Nothing to do here. */ }
 
   /**
@@ -108,35 +98,39 @@ class RandomReplay
              bool isEnd,
              const double& discount)
   {
-    nStepBuffer.push_back({state, action, reward, nextState, isEnd});
-
-    // Single step transition is not ready.
-    if (nStepBuffer.size() < nSteps)
-      return;
-
-    // To keep the queue size fixed to nSteps.
-    if (nStepBuffer.size() > nSteps)
-      nStepBuffer.pop_front();
-
-    // Before moving ahead, lets confirm if our fixed size buffer works.
-    assert(nStepBuffer.size() == nSteps);
-
-    // Make a n-step transition.
-    GetNStepInfo(reward, nextState, isEnd, discount);
-
-    state = nStepBuffer.front().state;
-    action = nStepBuffer.front().action;
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    memory.Store(0, state, action, reward, nextState, isEnd, discount,
+        [](const size_t /* slot */) { });
+  }
 
-    states.col(position) = state.Encode();
-    actions[position] = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-    position++;
-    if (position == capacity)
+  /**
+   * Store the given experiences, one from each of several environments (for
+   * instance the copies of a VectorEnvironment).  The n-step transitions are
+   * made separately for each environment.
+   *
+   * @param newStates Given states.
+   * @param newActions Given actions.
+   * @param newRewards Given rewards.
+   * @param newNextStates Given next states.
+   * @param isEnd Whether each next state is terminal state.
+   * @param environments The environment each experience comes from.
+   * @param discount The discount parameter.
+   */
+  void Store(const std::vector<StateType>& newStates,
+             const std::vector<ActionType>& newActions,
+             const arma::rowvec& newRewards,
+             const std::vector<StateType>& newNextStates,
+             const arma::irowvec& isEnd,
+             const arma::Col<size_t>& environments,
+             const double& discount)
+  {
+    // Stream 0 is the stream of the single experiences.
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    for (size_t i = 0; i < newStates.size(); ++i)
     {
-      full = true;
-      position = 0;
+      memory.Store(environments[i] + 1, newStates[i], newActions[i],
+          newRewards[i], newNextStates[i], isEnd[i], discount,
+          [](const size_t /* slot */) { });
     }
   }
 
@@ -153,25 +147,13 @@ class RandomReplay
                     bool& isEnd,
                     const double& discount)
   {
-    reward = nStepBuffer.back().reward;
-    nextState = nStepBuffer.back().nextState;
-    isEnd = nStepBuffer.back().isEnd;
-
-    // Should start from the second last transition in buffer.
-    for (int i = nStepBuffer.size() - 2; i >= 0; i--)
-    {
-      bool iE = nStepBuffer[i].isEnd;
-      reward = nStepBuffer[i].reward + discount * reward * (1 - iE);
-      if (iE)
-      {
-        nextState = nStepBuffer[i].nextState;
-        isEnd = iE;
-      }
-    }
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    memory.GetNStepInfo(0, reward, nextState, isEnd, discount);
   }
 
   /**
-   * Sample some experiences.
+   * Sample some experiences.  The given matrices are only reallocated if they
+   * do not have the right size, so they can be reused between calls.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -186,16 +168,12 @@ class RandomReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    size_t upperBound = full ? capacity : position;
-    arma::uvec sampledIndices = arma::randi<arma::uvec>(
-        batchSize, arma::distr_param(0, upperBound - 1));
+    std::lock_guard<std::mutex> lock(memory.Mutex());
+    for (size_t i = 0; i < batchSize; ++i)
+      sampledIndices[i] = memory.Slot(math::RandInt(memory.Size()));
 
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    memory.Gather(sampledIndices, sampledStates, sampledActions,
+        sampledRewards, sampledNextStates, isTerminal);
   }
 
   /**
@@ -205,7 +183,7 @@ class RandomReplay
    */
   const size_t& Size()
   {
-    return full ? capacity : position;
+    return memory.Size();
   }
 
   /**
@@ -225,41 +203,20 @@ class RandomReplay
   }
 
   //! Get the number of steps for n-step agent.
-  const size_t& NSteps() const { return nSteps; }
+  const size_t& NSteps() const { return memory.NSteps(); }
+
+  //! Get the underlying memory.
+  const ReplayMemory<EnvironmentType>& Memory() const { return memory; }
 
  private:
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
 
-  //! Locally-stored total memory limit.
-  size_t capacity;
-
-  //! Indicate the position to store new transition.
-  size_t position;
-
-  //! Locally-stored indicator that whether the memory is full or not
-  bool full;
-
-  //! Locally-stored number of steps to look into the future.
-  size_t nSteps;
-
-  //! Locally-stored buffer containing n consecutive steps.
-  std::deque<Transition> nStepBuffer;
-
-  //! Locally-stored encoded previous states.
-  arma::mat states;
-
-  //! Locally-stored previous actions.
-  std::vector<ActionType> actions;
-
-  //! Locally-stored previous rewards.
-  arma::rowvec rewards;
-
-  //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
+  //! Locally-stored transitions.
+  ReplayMemory<EnvironmentType> memory;
 
-  //! Locally-stored termination information of previous experience.
-  arma::irowvec isTerminal;
+  //! Locally-stored slots of the last sample.
+  arma::uvec sampledIndices;
 };
 
 } // namespace rl
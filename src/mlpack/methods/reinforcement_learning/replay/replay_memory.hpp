@@ -0,0 +1,415 @@
+/**
+ * @file methods/reinforcement_learning/replay/replay_memory.hpp
+ *
+ * This file is the definition of the ReplayMemory class, the storage shared by
+ * the experience replay methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_REPLAY_MEMORY_HPP
+#define MLPACK_METHODS_RL_REPLAY_REPLAY_MEMORY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mutex>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * The storage of the experience replay methods: a first-in first-out ring of
+ * n-step transitions, whose states are held in a separate ring of encoded
+ * observations.  Each transition only holds the numbers of the observations of
+ * its state and next state, and when the state given to Store() is the next
+ * state of the previous step of the same environment (as it is within an
+ * episode), the observation is shared instead of stored again.  So an episode
+ * of L steps takes L + 1 observations instead of 2 L.
+ *
+ * The observation ring holds capacity + max(capacity / 4, 1024) observations
+ * by default.  If it runs out (because of many short episodes, or of states
+ * that do not follow each other), the oldest transitions are dropped early, so
+ * Size() may stay below the capacity.
+ *
+ * The steps of several environments can be stored (one n-step buffer per
+ * stream), and the samples are written into the caller's matrices, which are
+ * only reallocated if their size changes.  The methods are not synchronized
+ * themselves; the replay methods hold Mutex() while they use the memory.
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template<typename EnvironmentType>
+class ReplayMemory
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! A step given to Store(), held until its n-step transition is made.
+  struct Transition
+  {
+    StateType state;
+    ActionType action;
+    double reward;
+    StateType nextState;
+    bool isEnd;
+    //! The number of the observation of the state.
+    size_t stateNumber;
+    //! The number of the observation of the next state.
+    size_t nextStateNumber;
+  };
+
+  //! Create an empty memory that cannot hold anything.
+  ReplayMemory() :
+      capacity(0),
+      nSteps(0),
+      head(0),
+      size(0),
+      observationCount(0)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Create an empty memory.
+   *
+   * @param capacity Total memory size in terms of number of transitions.
+   * @param nSteps Number of steps to look in the future.
+   * @param dimension The dimension of an encoded state.
+   * @param observationCapacity Number of observations to hold (0 means
+   *     capacity + max(capacity / 4, 1024)).
+   */
+  ReplayMemory(const size_t capacity,
+               const size_t nSteps,
+               const size_t dimension,
+               const size_t observationCapacity = 0) :
+      capacity(capacity),
+      nSteps(nSteps),
+      head(0),
+      size(0),
+      stateNumbers(capacity),
+      nextStateNumbers(capacity),
+      actions(capacity),
+      rewards(capacity),
+      isTerminal(capacity),
+      observations(dimension, (observationCapacity == 0) ?
+          capacity + std::max(capacity / 4, (size_t) 1024) :
+          observationCapacity),
+      references(observations.n_cols, arma::fill::zeros),
+      observationCount(0)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given step of the given stream.  Once the stream has n steps,
+   * an n-step transition is made and stored.  The given function is called
+   * with the slot of each transition that is dropped to make room.
+   *
+   * @param stream The stream (environment) the step comes from.
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   * @param discount The discount parameter.
+   * @param dropped Function called with the slot of each dropped transition.
+   * @return The slot of the stored transition, or Capacity() if none was
+   *     stored.
+   */
+  template<typename DroppedType>
+  size_t Store(const size_t stream,
+               const StateType& state,
+               const ActionType& action,
+               const double reward,
+               const StateType& nextState,
+               const bool isEnd,
+               const double discount,
+               const DroppedType& dropped)
+  {
+    if (stream >= streams.size())
+      streams.resize(stream + 1);
+    std::deque<Transition>& buffer = streams[stream];
+
+    // Share the observation of the state with the previous step of the
+    // stream, if the state is its next state.
+    const arma::colvec encodedState = state.Encode();
+    size_t stateNumber;
+    if (!buffer.empty() && Matches(buffer.back().nextStateNumber,
+        encodedState))
+      stateNumber = buffer.back().nextStateNumber;
+    else
+      stateNumber = Append(encodedState, dropped);
+    Acquire(stateNumber);
+
+    const size_t nextStateNumber = Append(nextState.Encode(), dropped);
+    Acquire(nextStateNumber);
+
+    buffer.push_back({ state, action, reward, nextState, isEnd, stateNumber,
+        nextStateNumber });
+
+    // Single step transition is not ready.
+    if (buffer.size() < nSteps)
+      return capacity;
+
+    // To keep the queue size fixed to nSteps.
+    if (buffer.size() > nSteps)
+    {
+      Release(buffer.front().stateNumber);
+      Release(buffer.front().nextStateNumber);
+      buffer.pop_front();
+    }
+
+    // Make a n-step transition.
+    double nStepReward;
+    size_t nStepNextNumber;
+    bool nStepIsEnd;
+    NStepInfo(buffer, discount, nStepReward, nStepNextNumber, nStepIsEnd);
+
+    if (size == capacity)
+      DropOldest(dropped);
+
+    const size_t slot = head;
+    stateNumbers[slot] = buffer.front().stateNumber;
+    nextStateNumbers[slot] = nStepNextNumber;
+    Acquire(stateNumbers[slot]);
+    Acquire(nextStateNumbers[slot]);
+    actions[slot] = buffer.front().action;
+    rewards[slot] = nStepReward;
+    isTerminal[slot] = nStepIsEnd;
+
+    head = (head + 1) % capacity;
+    ++size;
+    return slot;
+  }
+
+  /**
+   * Get the reward, next state and terminal boolean for nth step of the given
+   * stream.
+   *
+   * @param stream The stream (environment).
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   * @param discount The discount parameter.
+   */
+  void GetNStepInfo(const size_t stream,
+                    double& reward,
+                    StateType& nextState,
+                    bool& isEnd,
+                    const double discount) const
+  {
+    const std::deque<Transition>& buffer = streams[stream];
+    reward = buffer.back().reward;
+    nextState = buffer.back().nextState;
+    isEnd = buffer.back().isEnd;
+
+    // Should start from the second last transition in buffer.
+    for (int i = buffer.size() - 2; i >= 0; i--)
+    {
+      bool iE = buffer[i].isEnd;
+      reward = buffer[i].reward + discount * reward * (1 - iE);
+      if (iE)
+      {
+        nextState = buffer[i].nextState;
+        isEnd = iE;
+      }
+    }
+  }
+
+  /**
+   * Write the transitions in the given slots into the given matrices, which
+   * are only reallocated if they do not have the right size.
+   *
+   * @param slots Slots of the transitions.
+   * @param sampledStates Encoded states.
+   * @param sampledActions Actions.
+   * @param sampledRewards Rewards.
+   * @param sampledNextStates Encoded next states.
+   * @param sampledIsTerminal Whether each next state is terminal state.
+   */
+  void Gather(const arma::uvec& slots,
+              arma::mat& sampledStates,
+              std::vector<ActionType>& sampledActions,
+              arma::rowvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::irowvec& sampledIsTerminal) const
+  {
+    sampledStates.set_size(observations.n_rows, slots.n_elem);
+    sampledNextStates.set_size(observations.n_rows, slots.n_elem);
+    sampledActions.resize(slots.n_elem);
+    sampledRewards.set_size(slots.n_elem);
+    sampledIsTerminal.set_size(slots.n_elem);
+    for (size_t i = 0; i < slots.n_elem; ++i)
+    {
+      const size_t slot = slots[i];
+      sampledStates.col(i) = observations.col(stateNumbers[slot] %
+          observations.n_cols);
+      sampledNextStates.col(i) = observations.col(nextStateNumbers[slot] %
+          observations.n_cols);
+      sampledActions[i] = actions[slot];
+      sampledRewards[i] = rewards[slot];
+      sampledIsTerminal[i] = isTerminal[slot];
+    }
+  }
+
+  /**
+   * Get the slot of the given transition, where 0 is the oldest transition.
+   *
+   * @param i Index of the transition (smaller than Size()).
+   */
+  size_t Slot(const size_t i) const
+  {
+    return (head + capacity - size + i) % capacity;
+  }
+
+  //! Get the number of transitions in the memory.
+  const size_t& Size() const { return size; }
+  //! Get the maximum number of transitions in the memory.
+  size_t Capacity() const { return capacity; }
+  //! Get the number of observations the memory can hold.
+  size_t ObservationCapacity() const { return observations.n_cols; }
+  //! Get the number of steps for n-step agent.
+  const size_t& NSteps() const { return nSteps; }
+
+  //! Get the lock the replay methods hold while they use the memory.
+  std::mutex& Mutex() const { return lock.mutex; }
+
+ private:
+  //! A mutex that is not copied with the memory.
+  struct Lock
+  {
+    Lock() { }
+    Lock(const Lock& /* other */) { }
+    Lock& operator=(const Lock& /* other */) { return *this; }
+
+    std::mutex mutex;
+  };
+
+  //! Check whether the given observation holds the given encoded state.
+  bool Matches(const size_t number, const arma::colvec& encoded) const
+  {
+    return encoded.n_elem == observations.n_rows && std::equal(
+        encoded.begin(), encoded.end(),
+        observations.colptr(number % observations.n_cols));
+  }
+
+  /**
+   * Append the given encoded state to the observations, and return its
+   * number.  If the oldest observation is still in use, the oldest
+   * transitions are dropped until it is not.
+   */
+  template<typename DroppedType>
+  size_t Append(const arma::colvec& encoded, const DroppedType& dropped)
+  {
+    const size_t slot = observationCount % observations.n_cols;
+    while (references[slot] > 0)
+    {
+      if (size == 0)
+      {
+        Log::Fatal << "ReplayMemory::Append(): the " << observations.n_cols
+            << " observations are all used by pending steps; increase the "
+            << "observation capacity!" << std::endl;
+      }
+
+      DropOldest(dropped);
+    }
+
+    observations.col(slot) = encoded;
+    return observationCount++;
+  }
+
+  //! Drop the oldest transition.
+  template<typename DroppedType>
+  void DropOldest(const DroppedType& dropped)
+  {
+    const size_t slot = Slot(0);
+    Release(stateNumbers[slot]);
+    Release(nextStateNumbers[slot]);
+    --size;
+    dropped(slot);
+  }
+
+  //! Add a reference to the given observation.
+  void Acquire(const size_t number)
+  {
+    ++references[number % observations.n_cols];
+  }
+
+  //! Remove a reference to the given observation.
+  void Release(const size_t number)
+  {
+    --references[number % observations.n_cols];
+  }
+
+  //! Get the reward, the number of the next state and terminal boolean for
+  //! nth step of the given buffer.
+  void NStepInfo(const std::deque<Transition>& buffer,
+                 const double discount,
+                 double& reward,
+                 size_t& nextStateNumber,
+                 bool& isEnd) const
+  {
+    reward = buffer.back().reward;
+    nextStateNumber = buffer.back().nextStateNumber;
+    isEnd = buffer.back().isEnd;
+
+    for (int i = buffer.size() - 2; i >= 0; i--)
+    {
+      bool iE = buffer[i].isEnd;
+      reward = buffer[i].reward + discount * reward * (1 - iE);
+      if (iE)
+      {
+        nextStateNumber = buffer[i].nextStateNumber;
+        isEnd = iE;
+      }
+    }
+  }
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Locally-stored number of steps to look into the future.
+  size_t nSteps;
+
+  //! The slot of the next transition.
+  size_t head;
+
+  //! The number of transitions in the memory.
+  size_t size;
+
+  //! Locally-stored buffers containing n consecutive steps of each stream.
+  std::vector<std::deque<Transition>> streams;
+
+  //! The number of the observation of the state of each transition.
+  arma::Col<size_t> stateNumbers;
+
+  //! The number of the observation of the next state of each transition.
+  arma::Col<size_t> nextStateNumbers;
+
+  //! Locally-stored previous actions.
+  std::vector<ActionType> actions;
+
+  //! Locally-stored previous rewards.
+  arma::rowvec rewards;
+
+  //! Locally-stored termination information of previous experience.
+  arma::irowvec isTerminal;
+
+  //! The ring of encoded observations; observation k is in column k % n_cols.
+  arma::mat observations;
+
+  //! The number of transitions and pending steps using each observation.
+  arma::Col<size_t> references;
+
+  //! The number of observations appended so far.
+  size_t observationCount;
+
+  //! The lock of the memory.
+  mutable Lock lock;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -24,7 +24,12 @@ namespace rl {
  * Build a Segment Tree like data structure.
  * https://en.wikipedia.org/wiki/Segment_tree
  *
- * Used to maintain prefix-sum of an array.
+ * Used to maintain prefix-sum of an array.  The tree is packed in a single
+ * array, with the children of node i at 2i and 2i + 1 and the data at
+ * [capacity, 2 capacity).  The batch methods only touch the paths of the
+ * given indices, and the batch search runs in parallel with OpenMP; the const
+ * methods may be called from several threads at once, as long as no thread
+ * modifies the tree at the same time.
  *
  * @tparam T The array's element type.
  */
@@ -68,21 +73,32 @@ class SumTree
 
   /**
    * Update the data with batch rather loop over the indices with set method.
+   * Each ancestor of the changed data is recomputed once, so this takes
+   * O(n log(capacity)) time for n indices, instead of O(capacity) to rebuild
+   * the whole tree.
    *
    * @param indices The indices of data to be changed.
    * @param data The data that array with indices to be.
    */
   void BatchUpdate(const arma::ucolvec& indices, const arma::Col<T>& data)
   {
+    std::vector<size_t> nodes;
+    nodes.reserve(2 * indices.n_rows);
     for (size_t i = 0; i < indices.n_rows; ++i)
     {
-      element[indices[i] + capacity] = data[i];
-    }
-    // update the total tree with bottom-up technique.
-    for (size_t i = capacity - 1; i > 0; i--)
-    {
-      element[i] = element[2 * i] + element[2 * i + 1];
+      size_t idx = indices[i] + capacity;
+      element[idx] = data[i];
+      for (idx /= 2; idx >= 1; idx /= 2)
+        nodes.push_back(idx);
     }
+
+    // Update the ancestors with bottom-up technique: a node always has a
+    // higher index than its parent, so the children of each node are up to
+    // date when it is recomputed.
+    std::sort(nodes.begin(), nodes.end(), std::greater<size_t>());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    for (size_t i = 0; i < nodes.size(); ++i)
+      element[nodes[i]] = element[2 * nodes[i]] + element[2 * nodes[i] + 1];
   }
 
   /**
@@ -90,7 +106,7 @@ class SumTree
    *
    * @param idx The array idx to get data.
    */
-  T Get(size_t idx)
+  T Get(size_t idx) const
   {
     idx += capacity;
     return element[idx];
@@ -109,7 +125,7 @@ class SumTree
               const size_t end,
               const size_t node,
               const size_t nodeStart,
-              const size_t nodeEnd)
+              const size_t nodeEnd) const
   {
     if (start == nodeStart && end == nodeEnd)
     {
@@ -140,18 +156,19 @@ class SumTree
    * @param start The starting position of subsequence.
    * @param end The end position of subsequence.
    */
-  T Sum(const size_t start, size_t end)
+  T Sum(const size_t start, size_t end) const
   {
     end -= 1;
     return SumHelper(start, end, 1, 0, capacity - 1);
   }
 
   /**
-   * Shortcut for calculating the sum of whole array.
+   * Shortcut for calculating the sum of whole array, which is held by the
+   * root.
    */
-  T Sum()
+  T Sum() const
   {
-    return Sum(0, capacity);
+    return (capacity == 0) ? T(0) : element[1];
   }
 
   /**
@@ -160,7 +177,7 @@ class SumTree
    *
    * @param mass The upper bound of segment array sum.
    */
-  size_t FindPrefixSum(T mass)
+  size_t FindPrefixSum(T mass) const
   {
     size_t idx = 1;
     while (idx < capacity)
@@ -178,6 +195,23 @@ class SumTree
     return idx - capacity;
   }
 
+  /**
+   * Find the index for each of the given masses, as FindPrefixSum(mass) does,
+   * in parallel.  If the masses are sorted (as for stratified sampling), the
+   * searches of nearby masses share most of their paths in the tree, so they
+   * are mostly served from the cache.
+   *
+   * @param masses The upper bounds of segment array sum.
+   * @param indices The index for each mass; will be resized.
+   */
+  void FindPrefixSum(const arma::Col<T>& masses, arma::ucolvec& indices) const
+  {
+    indices.set_size(masses.n_elem);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) masses.n_elem; ++i)
+      indices[i] = FindPrefixSum(masses[i]);
+  }
+
  private:
   //! The capacity of the data array.
   size_t capacity;
@@ -21,6 +21,7 @@
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/visitor/parameters_visitor.hpp>
 #include "training_config.hpp"
+#include "environment/vector_environment.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -123,6 +124,18 @@ class SAC
    */
   double Episode();
 
+  /**
+   * Execute an episode in each copy of the given vector of environments, in
+   * lockstep.  At each step, the actions of all the copies that are not done
+   * are selected with one forward pass of the policy network, and their
+   * transitions are stored in the replay buffer with one call.  The networks
+   * are updated after each stored transition, as in Episode().
+   *
+   * @param environments Copies of the environment.
+   * @return Return of the episode of each copy.
+   */
+  arma::vec Episodes(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -189,6 +202,14 @@ class SAC
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
 
+  //! Locally-stored buffers of the sampled transitions, which are reused
+  //! between updates.
+  arma::mat sampledStates;
+  std::vector<ActionType> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::mat sampledNextStates;
+  arma::irowvec isTerminal;
+
   //! Locally-stored loss function.
   mlpack::ann::MeanSquaredError<> lossFunction;
 };
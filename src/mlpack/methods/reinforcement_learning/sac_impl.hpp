@@ -157,13 +157,7 @@ void SAC<
   ReplayType
 >::Update()
 {
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
+  // Sample from previous experience, into the buffers of the agent.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -358,6 +352,105 @@ double SAC<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+arma::vec SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::Episodes(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the initial state of each copy of the environment.
+  std::vector<StateType> states = environments.InitialSample();
+  arma::irowvec terminal = environments.IsTerminal(states);
+
+  // Track the return of the episode of each copy.
+  arma::vec totalReturns(environments.NumEnvironments(), arma::fill::zeros);
+
+  // Track the steps in this episode.
+  size_t steps = 0;
+
+  std::vector<ActionType> actions(environments.NumEnvironments());
+  std::vector<StateType> nextStates;
+  while (arma::any(terminal == 0))
+  {
+    if (config.StepLimit() && steps >= config.StepLimit())
+      break;
+    steps++;
+
+    const arma::uvec running = arma::find(terminal == 0);
+    std::vector<StateType> runningStates(running.n_elem);
+    for (size_t i = 0; i < running.n_elem; ++i)
+      runningStates[i] = states[running[i]];
+
+    // Get the actions of all the running copies with one forward pass of the
+    // policy network.
+    arma::mat outputActions;
+    policyNetwork.Predict(
+        VectorEnvironment<EnvironmentType>::Encode(runningStates),
+        outputActions);
+
+    if (!deterministic)
+    {
+      arma::mat noise = arma::randn<arma::mat>(arma::size(outputActions)) *
+          0.1;
+      noise = arma::clamp(noise, -0.25, 0.25);
+      outputActions = outputActions + noise;
+    }
+
+    for (size_t i = 0; i < running.n_elem; ++i)
+    {
+      actions[running[i]].action = arma::conv_to<std::vector<double>>::from(
+          arma::colvec(outputActions.col(i)));
+    }
+
+    // Interact with the environments to advance to the next states.
+    const arma::rowvec rewards = environments.Sample(states, actions,
+        nextStates);
+    const arma::irowvec nextTerminal = environments.IsTerminal(nextStates);
+
+    // Store the transitions of the running copies for replay, all at once.
+    std::vector<ActionType> runningActions(running.n_elem);
+    std::vector<StateType> runningNextStates(running.n_elem);
+    for (size_t i = 0; i < running.n_elem; ++i)
+    {
+      runningActions[i] = actions[running[i]];
+      runningNextStates[i] = nextStates[running[i]];
+    }
+    replayMethod.Store(runningStates, runningActions,
+        arma::rowvec(rewards.elem(running).t()), runningNextStates,
+        arma::irowvec(nextTerminal.elem(running).t()),
+        arma::conv_to<arma::Col<size_t>>::from(running), config.Discount());
+
+    // The state and action of the agent follow the first running copy.
+    state = runningNextStates[0];
+    action = runningActions[0];
+
+    for (size_t i = 0; i < running.n_elem; ++i)
+    {
+      totalReturns[running[i]] += rewards[running[i]];
+      totalSteps++;
+
+      if (deterministic || totalSteps < config.ExplorationSteps())
+        continue;
+      for (size_t j = 0; j < config.UpdateInterval(); j++)
+        Update();
+    }
+
+    states = std::move(nextStates);
+    terminal = nextTerminal;
+  }
+
+  return totalReturns;
+}
+
 } // namespace rl
 } // namespace mlpack
 #endif
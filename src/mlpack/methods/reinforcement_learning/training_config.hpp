@@ -34,7 +34,8 @@ class TrainingConfig
       atomSize(51),
       vMin(0),
       vMax(200),
-      rho(0.005)
+      rho(0.005),
+      numParameterShards(0)
   { /* Nothing to do here. */ }
 
   TrainingConfig(
@@ -52,7 +53,8 @@ class TrainingConfig
       size_t atomSize,
       double vMin,
       double vMax,
-      double rho) :
+      double rho,
+      size_t numParameterShards = 0) :
       numWorkers(numWorkers),
       updateInterval(updateInterval),
       targetNetworkSyncInterval(targetNetworkSyncInterval),
@@ -67,7 +69,8 @@ class TrainingConfig
       atomSize(atomSize),
       vMin(vMin),
       vMax(vMax),
-      rho(rho)
+      rho(rho),
+      numParameterShards(numParameterShards)
   { /* Nothing to do here. */ }
 
   //! Get the amount of workers.
@@ -149,6 +152,14 @@ class TrainingConfig
   //! Modify the rho value for sac.
   double& Rho() { return rho; }
 
+  //! Get the number of shards of the shared parameters.
+  size_t NumParameterShards() const { return numParameterShards; }
+  /**
+   * Modify the number of shards of the shared parameters.
+   * Setting it to 0 means lock-free updates.
+   */
+  size_t& NumParameterShards() { return numParameterShards; }
+
  private:
   /**
    * Locally-stored number of workers.
@@ -242,6 +253,14 @@ class TrainingConfig
    * This is valid only for Soft Actor-Critic.
    */
   double rho;
+
+  /**
+   * Locally-stored number of shards of the shared parameters.  With 0 shards
+   * the workers update the shared parameters without locking (Hogwild!);
+   * otherwise each shard is updated under its own lock.
+   * This is valid only for async RL agent.
+   */
+  size_t numParameterShards;
 };
 
 } // namespace rl
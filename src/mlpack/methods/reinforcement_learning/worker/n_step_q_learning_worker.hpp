@@ -15,6 +15,7 @@
 
 #include <ensmallen.hpp>
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include "parameter_shards.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -61,6 +62,7 @@ class NStepQLearningWorker
       environment(environment),
       config(config),
       deterministic(deterministic),
+      shards(NULL),
       pending(config.UpdateInterval())
   { Reset(); }
 
@@ -77,6 +79,7 @@ class NStepQLearningWorker
       environment(other.environment),
       config(other.config),
       deterministic(other.deterministic),
+      shards(other.shards),
       steps(other.steps),
       episodeReturn(other.episodeReturn),
       pending(other.pending),
@@ -107,6 +110,7 @@ class NStepQLearningWorker
       environment(std::move(other.environment)),
       config(std::move(other.config)),
       deterministic(std::move(other.deterministic)),
+      shards(other.shards),
       steps(std::move(other.steps)),
       episodeReturn(std::move(other.episodeReturn)),
       pending(std::move(other.pending)),
@@ -142,6 +146,7 @@ class NStepQLearningWorker
     environment = other.environment;
     config = other.config;
     deterministic = other.deterministic;
+    shards = other.shards;
     steps = other.steps;
     episodeReturn = other.episodeReturn;
     pending = other.pending;
@@ -179,6 +184,7 @@ class NStepQLearningWorker
     environment = std::move(other.environment);
     config = std::move(other.config);
     deterministic = std::move(other.deterministic);
+    shards = other.shards;
     steps = std::move(other.steps);
     episodeReturn = std::move(other.episodeReturn);
     pending = std::move(other.pending);
@@ -211,9 +217,14 @@ class NStepQLearningWorker
   /**
    * Initialize the worker.
    * @param learningNetwork The shared network.
+   * @param shards The shards of the shared parameters, or NULL for lock-free
+   *     updates.
    */
-  void Initialize(NetworkType& learningNetwork)
+  void Initialize(NetworkType& learningNetwork,
+                  ParameterShards* shards = NULL)
   {
+    this->shards = shards;
+
     #if ENS_VERSION_MAJOR == 1
     updater.Initialize(learningNetwork.Parameters().n_rows,
                        learningNetwork.Parameters().n_cols);
@@ -266,7 +277,7 @@ class NStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
@@ -320,17 +331,18 @@ class NStepQLearningWorker
           { return std::min(std::max(gradient, -config.GradientLimit()),
           config.GradientLimit()); });
 
-      // Perform async update of the global network.
-      #if ENS_VERSION_MAJOR == 1
-      updater.Update(learningNetwork.Parameters(), config.StepSize(),
-          totalGradients);
-      #else
-      updatePolicy->Update(learningNetwork.Parameters(),
-          config.StepSize(), totalGradients);
-      #endif
-
-      // Sync the local network with the global network.
-      network = learningNetwork;
+      // Perform async update of the global network, and sync the local
+      // network with the global network.  Only the parameters are copied.
+      ParameterShards::Update(shards, learningNetwork.Parameters(),
+          network.Parameters(), [&](arma::mat& parameters)
+          {
+            #if ENS_VERSION_MAJOR == 1
+            updater.Update(parameters, config.StepSize(), totalGradients);
+            #else
+            updatePolicy->Update(parameters, config.StepSize(),
+                totalGradients);
+            #endif
+          });
 
       pendingIndex = 0;
     }
@@ -339,7 +351,7 @@ class NStepQLearningWorker
     if (totalSteps % config.TargetNetworkSyncInterval() == 0)
     {
       #pragma omp critical
-      { targetNetwork = learningNetwork; }
+      { targetNetwork.Parameters() = learningNetwork.Parameters(); }
     }
 
     policy.Anneal();
@@ -381,6 +393,9 @@ class NStepQLearningWorker
   //! Whether this episode is deterministic or not.
   bool deterministic;
 
+  //! The shards of the shared parameters (NULL for lock-free updates).
+  ParameterShards* shards;
+
   //! Total steps in current episode.
   size_t steps;
 
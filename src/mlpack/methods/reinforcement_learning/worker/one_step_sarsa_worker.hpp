@@ -15,6 +15,7 @@
 
 #include <ensmallen.hpp>
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include "parameter_shards.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -62,6 +63,7 @@ class OneStepSarsaWorker
       environment(environment),
       config(config),
       deterministic(deterministic),
+      shards(NULL),
       pending(config.UpdateInterval())
   { Reset(); }
 
@@ -78,6 +80,7 @@ class OneStepSarsaWorker
       environment(other.environment),
       config(other.config),
       deterministic(other.deterministic),
+      shards(other.shards),
       steps(other.steps),
       episodeReturn(other.episodeReturn),
       pending(other.pending),
@@ -109,6 +112,7 @@ class OneStepSarsaWorker
       environment(std::move(other.environment)),
       config(std::move(other.config)),
       deterministic(std::move(other.deterministic)),
+      shards(other.shards),
       steps(std::move(other.steps)),
       episodeReturn(std::move(other.episodeReturn)),
       pending(std::move(other.pending)),
@@ -145,6 +149,7 @@ class OneStepSarsaWorker
     environment = other.environment;
     config = other.config;
     deterministic = other.deterministic;
+    shards = other.shards;
     steps = other.steps;
     episodeReturn = other.episodeReturn;
     pending = other.pending;
@@ -183,6 +188,7 @@ class OneStepSarsaWorker
     environment = std::move(other.environment);
     config = std::move(other.config);
     deterministic = std::move(other.deterministic);
+    shards = other.shards;
     steps = std::move(other.steps);
     episodeReturn = std::move(other.episodeReturn);
     pending = std::move(other.pending);
@@ -216,9 +222,14 @@ class OneStepSarsaWorker
   /**
    * Initialize the worker.
    * @param learningNetwork The shared network.
+   * @param shards The shards of the shared parameters, or NULL for lock-free
+   *     updates.
    */
-  void Initialize(NetworkType& learningNetwork)
+  void Initialize(NetworkType& learningNetwork,
+                  ParameterShards* shards = NULL)
   {
+    this->shards = shards;
+
     #if ENS_VERSION_MAJOR == 1
     updater.Initialize(learningNetwork.Parameters().n_rows,
                        learningNetwork.Parameters().n_cols);
@@ -278,7 +289,7 @@ class OneStepSarsaWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
@@ -297,17 +308,22 @@ class OneStepSarsaWorker
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
+
+      // Predict the values of all the next states with one pass of the shared
+      // target network, so that it is only locked once per update.
+      arma::mat nextStates(state.Encode().n_elem, pending.size());
+      for (size_t i = 0; i < pending.size(); ++i)
+        nextStates.col(i) = std::get<3>(pending[i]).Encode();
+      arma::mat targetActionValues;
+      #pragma omp critical
+      { targetNetwork.Predict(nextStates, targetActionValues); };
+
       for (size_t i = 0; i < pending.size(); ++i)
       {
         TransitionType &transition = pending[i];
 
         // Compute the target state-action value.
-        arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        arma::colvec actionValue = targetActionValues.col(i);
         double targetActionValue = 0;
         if (!(terminal && i == pending.size() - 1))
           targetActionValue = actionValue[std::get<4>(transition).action];
@@ -333,17 +349,18 @@ class OneStepSarsaWorker
           { return std::min(std::max(gradient, -config.GradientLimit()),
           config.GradientLimit()); });
 
-      // Perform async update of the global network.
-      #if ENS_VERSION_MAJOR == 1
-      updater.Update(learningNetwork.Parameters(), config.StepSize(),
-          totalGradients);
-      #else
-      updatePolicy->Update(learningNetwork.Parameters(),
-          config.StepSize(), totalGradients);
-      #endif
-
-      // Sync the local network with the global network.
-      network = learningNetwork;
+      // Perform async update of the global network, and sync the local
+      // network with the global network.  Only the parameters are copied.
+      ParameterShards::Update(shards, learningNetwork.Parameters(),
+          network.Parameters(), [&](arma::mat& parameters)
+          {
+            #if ENS_VERSION_MAJOR == 1
+            updater.Update(parameters, config.StepSize(), totalGradients);
+            #else
+            updatePolicy->Update(parameters, config.StepSize(),
+                totalGradients);
+            #endif
+          });
 
       pendingIndex = 0;
     }
@@ -352,7 +369,7 @@ class OneStepSarsaWorker
     if (totalSteps % config.TargetNetworkSyncInterval() == 0)
     {
       #pragma omp critical
-      { targetNetwork = learningNetwork; }
+      { targetNetwork.Parameters() = learningNetwork.Parameters(); }
     }
 
     policy.Anneal();
@@ -397,6 +414,9 @@ class OneStepSarsaWorker
   //! Whether this episode is deterministic or not.
   bool deterministic;
 
+  //! The shards of the shared parameters (NULL for lock-free updates).
+  ParameterShards* shards;
+
   //! Total steps in current episode.
   size_t steps;
 
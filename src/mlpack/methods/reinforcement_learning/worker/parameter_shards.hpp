@@ -0,0 +1,128 @@
+/**
+ * @file methods/reinforcement_learning/worker/parameter_shards.hpp
+ *
+ * This file is the definition of the ParameterShards class, which controls how
+ * the async workers apply their updates to the shared parameters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_WORKER_PARAMETER_SHARDS_HPP
+#define MLPACK_METHODS_RL_WORKER_PARAMETER_SHARDS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mutex>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * The shared parameters of the async workers, split into contiguous shards
+ * with one lock each.
+ *
+ * With no shards, the updates are lock-free (Hogwild!): each worker applies its
+ * optimizer step directly to the shared parameters, and no thread ever waits
+ * for another.  Concurrent updates may overwrite each other, which is harmless
+ * for the sparse and noisy gradients of the async agents.
+ *
+ * With shards, each worker applies its optimizer step to its local copy of the
+ * parameters, and then adds the change to each shard of the shared parameters
+ * (and reads back the shard) under the lock of that shard, like a sharded
+ * parameter server.  No update is lost, and each lock is only held for one
+ * shard, so the workers rarely wait for each other.
+ *
+ * For more information on Hogwild!, see the following paper:
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title={Hogwild!: A lock-free approach to parallelizing stochastic gradient
+ *       descent},
+ *   author={Recht, Benjamin and Re, Christopher and Wright, Stephen and Niu,
+ *       Feng},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ */
+class ParameterShards
+{
+ public:
+  /**
+   * Split the given number of parameters into the given number of shards.
+   *
+   * @param numParameters Number of shared parameters.
+   * @param numShards Number of shards; 0 means lock-free updates.
+   */
+  ParameterShards(const size_t numParameters, const size_t numShards) :
+      numParameters(numParameters),
+      locks(numShards)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Apply an optimizer step to the shared parameters, and sync the local
+   * parameters with them.  If shards is NULL or has no shards, the step is
+   * applied directly to the shared parameters without locking.
+   *
+   * @param shards The shards of the shared parameters (may be NULL).
+   * @param sharedParameters The shared parameters.
+   * @param localParameters The local parameters of the worker.
+   * @param update Function that applies the optimizer step to the given
+   *     parameters.
+   */
+  template<typename UpdateFunctionType>
+  static void Update(ParameterShards* shards,
+                     arma::mat& sharedParameters,
+                     arma::mat& localParameters,
+                     const UpdateFunctionType& update)
+  {
+    if (shards == NULL || shards->NumShards() == 0)
+    {
+      update(sharedParameters);
+      localParameters = sharedParameters;
+      return;
+    }
+
+    const arma::mat previousParameters = localParameters;
+    update(localParameters);
+
+    // The parameters of a network are a single column.
+    for (size_t s = 0; s < shards->NumShards(); ++s)
+    {
+      const size_t begin = shards->Begin(s);
+      const size_t end = shards->End(s);
+      if (begin == end)
+        continue;
+
+      std::lock_guard<std::mutex> lock(shards->locks[s]);
+      sharedParameters.rows(begin, end - 1) +=
+          localParameters.rows(begin, end - 1) -
+          previousParameters.rows(begin, end - 1);
+      localParameters.rows(begin, end - 1) =
+          sharedParameters.rows(begin, end - 1);
+    }
+  }
+
+  //! Get the number of shards.
+  size_t NumShards() const { return locks.size(); }
+
+  //! Get the first parameter of the given shard.
+  size_t Begin(const size_t shard) const
+  { return shard * numParameters / locks.size(); }
+  //! Get one past the last parameter of the given shard.
+  size_t End(const size_t shard) const
+  { return (shard + 1) * numParameters / locks.size(); }
+
+ private:
+  //! The number of shared parameters.
+  size_t numParameters;
+  //! The lock of each shard.
+  std::vector<std::mutex> locks;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -92,6 +92,29 @@ class SoftmaxRegression
                     const double lambda = 0.0001,
                     const bool fitIntercept = false,
                     OptimizerType optimizer = OptimizerType());
+  /**
+   * Construct the SoftmaxRegression class with the provided data and labels,
+   * and train the model starting from the given parameters (for instance, the
+   * parameters of a model trained with another lambda).  If the initial
+   * parameters do not have the right size, they are ignored.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Input training features. Each column associate with one sample
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param initialPoint Initial model parameters to train from.
+   * @param lambda L2-regularization constant.
+   * @param fitIntercept add intercept term or not.
+   * @param optimizer Desired optimizer.
+   */
+  template<typename OptimizerType = ens::L_BFGS>
+  SoftmaxRegression(const arma::mat& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const arma::mat& initialPoint,
+                    const double lambda = 0.0001,
+                    const bool fitIntercept = false,
+                    OptimizerType optimizer = OptimizerType());
   /**
    * Construct the SoftmaxRegression class with the provided data and labels.
    * This will train the model. Optionally, the parameter 'lambda' can be
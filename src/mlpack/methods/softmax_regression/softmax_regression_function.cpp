@@ -182,6 +182,16 @@ void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
  * Evaluates the objective function given the parameters.
  */
 double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Evaluate(parameters, 0, data.n_cols);
+}
+
+/**
+ * Evaluate the objective function for the given points given the parameters.
+ */
+double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t start,
+                                           const size_t batchSize) const
 {
   // The objective function is the negative log likelihood of the model
   // calculated over all the training examples. Mathematically it is as follows:
@@ -192,113 +202,194 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
   // 'm' is the number of training examples.
   // The cost also takes into account the regularization to control the
   // parameter weights.
-
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
-  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
-  // The sum is calculated over all the classes.
-  // x_i is the input vector for a particular training example.
-  // theta_j is the parameter vector associated with a particular class.
-  arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
-
-  // Calculate the log likelihood and regularization terms.
-  double logLikelihood, weightDecay, cost;
-
-  logLikelihood = arma::accu(groundTruth % arma::log(probabilities)) /
-                  data.n_cols;
-  weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
+  arma::mat scoreGradients;
+  const double logLikelihood = -ScoreGradients(parameters, start, batchSize,
+      scoreGradients) / batchSize;
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters %
+      parameters);
 
   // The cost is the sum of the negative log likelihood and the regularization
   // terms.
-  cost = -logLikelihood + weightDecay;
-
-  return cost;
+  return -logLikelihood + weightDecay;
 }
 
 /**
- * Evaluate the objective function for the given points given the parameters.
+ * Calculates and stores the gradient values given a set of parameters.
  */
-double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
-                                           const size_t start,
-                                           const size_t batchSize) const
+void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
+                                         arma::mat& gradient) const
 {
-  arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
+  Gradient(parameters, 0, gradient, data.n_cols);
+}
 
-  // Calculate the log likelihood and regularization terms.
-  double logLikelihood, weightDecay;
+void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
+                                         const size_t start,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
+{
+  arma::mat scoreGradients;
+  ScoreGradients(parameters, start, batchSize, scoreGradients);
+  ParameterGradient(parameters, start, scoreGradients, gradient);
+}
 
-  logLikelihood = arma::accu(groundTruth.cols(start, start + batchSize - 1) %
-      arma::log(probabilities)) / batchSize;
-  weightDecay = 0.5 * lambda * arma::accu(parameters * parameters);
+double SoftmaxRegressionFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return EvaluateWithGradient(parameters, 0, gradient, data.n_cols);
+}
+
+double SoftmaxRegressionFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  arma::mat scoreGradients;
+  const double logLikelihood = -ScoreGradients(parameters, start, batchSize,
+      scoreGradients) / batchSize;
+  ParameterGradient(parameters, start, scoreGradients, gradient);
 
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters %
+      parameters);
   return -logLikelihood + weightDecay;
 }
 
-/**
- * Calculates and stores the gradient values given a set of parameters.
- */
-void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
+double SoftmaxRegressionFunction::ScoreGradients(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize,
+    arma::mat& scoreGradients) const
 {
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
-  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
-  // The sum is calculated over all the classes.
-  // x_i is the input vector for a particular training example.
-  // theta_j is the parameter vector associated with a particular class.
-  arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+  // Compute the class scores, theta_j' * x_i, for each point.  If there is an
+  // intercept, parameters.col(0) is added to the scores instead of joining a
+  // row of ones to the data.
+  const arma::mat batch(const_cast<double*>(data.colptr(start)), data.n_rows,
+      batchSize, false, true);
+  if (fitIntercept)
+  {
+    scoreGradients = parameters.cols(1, parameters.n_cols - 1) * batch;
+    scoreGradients.each_col() += parameters.col(0);
+  }
+  else
+  {
+    scoreGradients = parameters * batch;
+  }
+
+  // The ground truth matrix has one element in each column, in the row of the
+  // label of the point.
+  groundTruth.sync();
+
+  // The probabilities of each class are given by
+  //   p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i)),
+  // where the largest score is subtracted before taking the exponentials, so
+  // that they cannot overflow.
+  const size_t classes = scoreGradients.n_rows;
+  double negLogLikelihood = 0.0;
+  #pragma omp parallel for reduction(+:negLogLikelihood) schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
+  {
+    double* scores = scoreGradients.colptr(i);
+    const size_t label = groundTruth.row_indices[groundTruth.col_ptrs[start +
+        i]];
+
+    double maxScore = scores[0];
+    for (size_t c = 1; c < classes; ++c)
+      maxScore = std::max(maxScore, scores[c]);
+
+    double sum = 0.0;
+    for (size_t c = 0; c < classes; ++c)
+    {
+      scores[c] = std::exp(scores[c] - maxScore);
+      sum += scores[c];
+    }
+
+    negLogLikelihood -= std::log(scores[label] / sum);
+
+    for (size_t c = 0; c < classes; ++c)
+      scores[c] /= sum;
+    scores[label] -= 1.0;
+  }
+
+  return negLogLikelihood;
+}
+
+void SoftmaxRegressionFunction::ParameterGradient(
+    const arma::mat& parameters,
+    const size_t start,
+    const arma::mat& scoreGradients,
+    arma::mat& gradient) const
+{
+  const size_t batchSize = scoreGradients.n_cols;
+  const arma::mat batch(const_cast<double*>(data.colptr(start)), data.n_rows,
+      batchSize, false, true);
 
-  // Calculate the parameter gradients.
   gradient.set_size(parameters.n_rows, parameters.n_cols);
   if (fitIntercept)
   {
     // Treating the intercept term parameters.col(0) seperately to avoid
     // the cost of building matrix [1; data].
-    arma::mat inner = probabilities - groundTruth;
-    gradient.col(0) =
-      inner * arma::ones<arma::mat>(data.n_cols, 1) / data.n_cols +
-      lambda * parameters.col(0);
+    gradient.col(0) = arma::sum(scoreGradients, 1) / batchSize +
+        lambda * parameters.col(0);
     gradient.cols(1, parameters.n_cols - 1) =
-      inner * data.t() / data.n_cols +
-      lambda * parameters.cols(1, parameters.n_cols - 1);
+        scoreGradients * batch.t() / batchSize +
+        lambda * parameters.cols(1, parameters.n_cols - 1);
   }
   else
   {
-    gradient = (probabilities - groundTruth) * data.t() / data.n_cols +
-               lambda * parameters;
+    gradient = scoreGradients * batch.t() / batchSize + lambda * parameters;
   }
 }
 
 void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
                                          const size_t start,
-                                         arma::mat& gradient,
+                                         arma::sp_mat& gradient,
                                          const size_t batchSize) const
 {
-  arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
-
-  // Calculate the parameter gradients.
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  arma::mat inner;
+  ScoreGradients(parameters, start, batchSize, inner);
+  inner /= batchSize;
+  const arma::sp_mat batch(data.cols(start, start + batchSize - 1));
+
+  // The column of feature j is column j + 1 if there is an intercept.
+  const size_t offset = fitIntercept ? 1 : 0;
+  const size_t numClasses = parameters.n_rows;
+
+  // Duplicate locations (a feature that is nonzero in several points) are
+  // summed when the sparse matrix is built.
+  arma::umat locations(2, numClasses * (batch.n_nonzero + offset));
+  arma::vec values(numClasses * (batch.n_nonzero + offset));
+  size_t i = 0;
   if (fitIntercept)
   {
-    arma::mat inner = probabilities - groundTruth.cols(start, start +
-        batchSize - 1);
-    gradient.col(0) =
-        inner * arma::ones<arma::mat>(batchSize, 1) / batchSize +
+    const arma::vec interceptGradient = arma::sum(inner, 1) +
         lambda * parameters.col(0);
-    gradient.cols(1, parameters.n_cols - 1) =
-        inner * data.cols(start, start + batchSize - 1).t() / batchSize +
-        lambda * parameters.cols(1, parameters.n_cols - 1);
+    for (size_t c = 0; c < numClasses; ++c, ++i)
+    {
+      locations(0, i) = c;
+      locations(1, i) = 0;
+      values[i] = interceptGradient[c];
+    }
   }
-  else
+
+  // Per-point regularization, so that a feature that is nonzero in every
+  // point of the batch gets the same regularization as the dense gradient.
+  const double regularization = lambda / batchSize;
+  for (arma::sp_mat::const_iterator it = batch.begin(); it != batch.end();
+       ++it)
   {
-    gradient = (probabilities - groundTruth.cols(start, start + batchSize - 1))
-        * data.cols(start, start + batchSize - 1).t() / batchSize
-        + lambda * parameters;
+    const size_t column = it.row() + offset;
+    for (size_t c = 0; c < numClasses; ++c, ++i)
+    {
+      locations(0, i) = c;
+      locations(1, i) = column;
+      values[i] = inner(c, it.col()) * (*it) +
+          regularization * parameters(c, column);
+    }
   }
+
+  gradient = arma::sp_mat(true, locations, values, parameters.n_rows,
+      parameters.n_cols);
 }
 
 void SoftmaxRegressionFunction::PartialGradient(const arma::mat& parameters,
@@ -150,6 +150,48 @@ class SoftmaxRegressionFunction
                 arma::mat& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the objective function on a subset of the data
+   * as a sparse matrix, which only holds the columns of the intercept and of
+   * the features that are nonzero in the subset.  The regularization is only
+   * applied to those columns (once for each point that has the feature).
+   * This is used by optimizers such as ParallelSGD (Hogwild!), which apply
+   * sparse updates from many threads without locking.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Sparse matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t start,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters, in one pass over the data.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters, on a subset of the data, in one pass over the subset.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t start,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -188,6 +230,33 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
+  /**
+   * Compute the derivatives of the negative log-likelihood of the given points
+   * with respect to their class scores (the probabilities minus the ground
+   * truth), and return the negative log-likelihood of the points.  The
+   * probabilities of each point are computed, normalized and turned into
+   * derivatives in one pass over the scores, in parallel over the points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param batchSize Number of data points to use.
+   * @param scoreGradients Matrix to store the derivatives in (one column for
+   *     each point).
+   */
+  double ScoreGradients(const arma::mat& parameters,
+                        const size_t start,
+                        const size_t batchSize,
+                        arma::mat& scoreGradients) const;
+
+  /**
+   * Compute the gradient of the objective function from the given derivatives
+   * with respect to the class scores of the given points.
+   */
+  void ParameterGradient(const arma::mat& parameters,
+                         const size_t start,
+                         const arma::mat& scoreGradients,
+                         arma::mat& gradient) const;
+
   //! Training data matrix.  This is an alias until the data is shuffled.
   arma::mat data;
   //! Label matrix for the provided data.
@@ -33,6 +33,23 @@ SoftmaxRegression::SoftmaxRegression(
   Train(data, labels, numClasses, optimizer);
 }
 
+template<typename OptimizerType>
+SoftmaxRegression::SoftmaxRegression(
+    const arma::mat& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::mat& initialPoint,
+    const double lambda,
+    const bool fitIntercept,
+    OptimizerType optimizer) :
+    parameters(initialPoint),
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  Train(data, labels, numClasses, optimizer);
+}
+
 template<typename OptimizerType, typename... CallbackTypes>
 SoftmaxRegression::SoftmaxRegression(
     const arma::mat& data,
@@ -39,13 +39,13 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   // lambda2 > 0.
   arma::mat matGram = trans(dictionary) * dictionary;
 
+  // Each point is coded independently; every LARS object only reads the shared
+  // Gram matrix.
+  Log::Debug << "Coding " << data.n_cols << " points." << std::endl;
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
 
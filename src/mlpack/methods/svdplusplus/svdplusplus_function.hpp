@@ -144,6 +144,27 @@ class SVDPlusPlusFunction
   size_t numItems;
 };
 
+/**
+ * Optimize the given SVDPlusPlusFunction with stratified parallel SGD: in each
+ * epoch, the ratings are visited one stratum of RatingBlocks at a time, and the
+ * blocks of a stratum are processed by different threads without atomics or
+ * locks.  The implicit item vectors of a user may belong to any block, so they
+ * are held fixed during a stratum, and the updates of the stratum's ratings
+ * are summed per user and applied to them after it, in parallel over items.
+ * The ParallelSGD specializations below call this; the thread share size of
+ * the optimizer is not used.
+ *
+ * @param optimizer Parallel SGD optimizer holding the parameters of the
+ *     optimization.
+ * @param function The SVDPlusPlusFunction to optimize.
+ * @param iterate Starting point; the optimized parameters will be stored here.
+ * @return Objective value of the final point.
+ */
+template<typename DecayPolicyType>
+double StratifiedOptimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                          SVDPlusPlusFunction<arma::mat>& function,
+                          arma::mat& iterate);
+
 } // namespace svd
 } // namespace mlpack
 
@@ -171,6 +192,12 @@ namespace ens {
       mlpack::svd::SVDPlusPlusFunction<arma::mat>& function,
       arma::mat& parameters);
 
+  template <>
+  template <>
+  inline double ParallelSGD<ConstantStep>::Optimize(
+      mlpack::svd::SVDPlusPlusFunction<arma::mat>& function,
+      arma::mat& parameters);
+
 } // namespace ens
 
 /**
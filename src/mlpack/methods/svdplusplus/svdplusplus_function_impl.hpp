@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_SVDPLUSPLUS_SVDPLUSPLUS_FUNCTION_IMPL_HPP
 
 #include "svdplusplus_function.hpp"
+#include <mlpack/methods/bias_svd/rating_blocks.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 
 namespace mlpack {
@@ -285,6 +286,184 @@ void SVDPlusPlusFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template<typename DecayPolicyType>
+double StratifiedOptimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                          SVDPlusPlusFunction<arma::mat>& function,
+                          arma::mat& iterate)
+{
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  const arma::mat& data = function.Dataset();
+  const arma::sp_mat& implicitData = function.ImplicitDataset();
+  const size_t numUsers = function.NumUsers();
+  const size_t numItems = function.NumItems();
+  const size_t implicitStart = numUsers + numItems;
+  const double lambda = function.Lambda();
+
+  // Rank of decomposition.
+  const size_t rank = function.Rank();
+
+  // Each thread gets one block of users and one block of items in each
+  // stratum, so no two threads ever touch the same user or item column.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+    numBlocks = omp_get_max_threads();
+  #endif
+  RatingBlocks blocks(data, numUsers, numItems, numBlocks);
+  arma::uvec strata = arma::linspace<arma::uvec>(0, blocks.NumBlocks() - 1,
+      blocks.NumBlocks());
+
+  // The implicit item vectors of a user are not in the user's block, so their
+  // updates are summed per user during a stratum and applied after it, one
+  // implicit item at a time; for that we need the users of each item.
+  const arma::sp_mat implicitUsers = implicitData.t();
+  arma::vec implicitNorms(numUsers, arma::fill::zeros);
+  for (size_t user = 0; user < numUsers; ++user)
+  {
+    implicitNorms[user] = std::sqrt((double) std::distance(
+        implicitData.begin_col(user), implicitData.end_col(user)));
+  }
+
+  // The sum of the implicit item vectors of each user (scaled), the summed
+  // rating errors times item vectors, and the number of ratings, per stratum.
+  arma::mat implicitSums(rank, numUsers);
+  arma::mat implicitGradients(rank, numUsers);
+  arma::Col<size_t> implicitRatings(numUsers);
+
+  // Iterate till the objective is within tolerance or the maximum number of
+  // allowed iterations is reached. If maxIterations is 0, this will iterate
+  // till convergence.
+  for (size_t i = 1; i != optimizer.MaxIterations(); ++i)
+  {
+    // Calculate the overall objective.
+    lastObjective = overallObjective;
+    overallObjective = 0;
+
+    #pragma omp parallel for reduction(+:overallObjective)
+    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
+    {
+      overallObjective += function.Evaluate(iterate, j);
+    }
+
+    // Output current objective function.
+    Log::Info << "Parallel SGD: iteration " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Parallel SGD: converged to " << overallObjective
+          << "; terminating with failure. Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < optimizer.Tolerance())
+    {
+      Log::Info << "SGD: minimized within tolerance " << optimizer.Tolerance()
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    // Get the stepsize for this iteration
+    const double stepSize = optimizer.DecayPolicy().StepSize(i);
+
+    if (optimizer.Shuffle()) // Determine order of visitation.
+    {
+      blocks.Shuffle();
+      strata = arma::shuffle(strata);
+    }
+
+    for (size_t s = 0; s < strata.n_elem; ++s)
+    {
+      // The implicit item vectors do not change during the stratum.
+      #pragma omp parallel for schedule(dynamic, 64)
+      for (omp_size_t user = 0; user < (omp_size_t) numUsers; ++user)
+      {
+        implicitSums.col(user).zeros();
+        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+        for (; it != it_end; ++it)
+        {
+          implicitSums.col(user) +=
+              iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
+        }
+        if (implicitNorms[user] != 0.0)
+          implicitSums.col(user) /= implicitNorms[user];
+      }
+      implicitGradients.zeros();
+      implicitRatings.zeros();
+
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) blocks.NumBlocks(); ++b)
+      {
+        const size_t itemBlock = blocks.ItemBlock(b, strata[s]);
+        const size_t end = blocks.End(b, itemBlock);
+        for (size_t j = blocks.Begin(b, itemBlock); j < end; ++j)
+        {
+          // Indices for accessing the the correct parameter columns.
+          const size_t example = blocks.Rating(j);
+          const size_t user = data(0, example);
+          const size_t item = data(1, example) + numUsers;
+
+          // Prediction error for the example.
+          const double rating = data(2, example);
+          const double userBias = iterate(rank, user);
+          const double itemBias = iterate(rank, item);
+          const arma::vec userVec = implicitSums.col(user) +
+              iterate.col(user).subvec(0, rank - 1);
+          const arma::vec itemVec = iterate.col(item).subvec(0, rank - 1);
+
+          const double ratingError = rating - userBias - itemBias -
+              arma::dot(userVec, itemVec);
+
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example; the user and item columns belong to this block
+          // only, and the user's implicit item columns are updated later.
+          iterate.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+              lambda * iterate.col(user).subvec(0, rank - 1) -
+              ratingError * itemVec);
+          iterate.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+              lambda * itemVec - ratingError * userVec);
+          iterate(rank, user) -= stepSize * 2 * (
+              lambda * iterate(rank, user) - ratingError);
+          iterate(rank, item) -= stepSize * 2 * (
+              lambda * iterate(rank, item) - ratingError);
+
+          implicitGradients.col(user) += ratingError * itemVec;
+          ++implicitRatings[user];
+        }
+      }
+
+      // Update the implicit item vectors with the summed updates of the
+      // ratings of the stratum.
+      #pragma omp parallel for schedule(dynamic, 64)
+      for (omp_size_t item = 0; item < (omp_size_t) numItems; ++item)
+      {
+        arma::sp_mat::const_iterator it = implicitUsers.begin_col(item);
+        arma::sp_mat::const_iterator it_end = implicitUsers.end_col(item);
+        for (; it != it_end; ++it)
+        {
+          // Note that implicitNorms[user] != 0 if the user is an item's user.
+          const size_t user = it.row();
+          if (implicitRatings[user] == 0)
+            continue;
+
+          iterate.col(implicitStart + item).subvec(0, rank - 1) -=
+              stepSize * 2.0 * (lambda * implicitRatings[user] /
+              (implicitNorms[user] * implicitNorms[user]) *
+              iterate.col(implicitStart + item).subvec(0, rank - 1) -
+              implicitGradients.col(user) / implicitNorms[user]);
+        }
+      }
+    }
+  }
+  Log::Info << "\n Parallel SGD terminated with objective : "
+      << overallObjective << std::endl;
+
+  return overallObjective;
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -399,159 +578,16 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     mlpack::svd::SVDPlusPlusFunction<arma::mat>& function,
     arma::mat& iterate)
 {
-  double overallObjective = DBL_MAX;
-  double lastObjective;
-
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-  const arma::sp_mat implicitData = function.ImplicitDataset();
-  const size_t numUsers = function.NumUsers();
-  const size_t numItems = function.NumItems();
-  const double lambda = function.Lambda();
-
-  // Rank of decomposition.
-  const size_t rank = function.Rank();
-
-  // Iterate till the objective is within tolerance or the maximum number of
-  // allowed iterations is reached. If maxIterations is 0, this will iterate
-  // till convergence.
-  for (size_t i = 1; i != maxIterations; ++i)
-  {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-    overallObjective = 0;
-
-    #pragma omp parallel for reduction(+:overallObjective)
-    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
-    {
-      overallObjective += function.Evaluate(iterate, j);
-    }
-
-    // Output current objective function.
-    mlpack::Log::Info << "Parallel SGD: iteration " << i << ", objective "
-        << overallObjective << "." << std::endl;
-
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
-    {
-      mlpack::Log::Warn << "Parallel SGD: converged to " << overallObjective
-          << "; terminating with failure. Try a smaller step size?"
-          << std::endl;
-      return overallObjective;
-    }
-
-    if (std::abs(lastObjective - overallObjective) < tolerance)
-    {
-      mlpack::Log::Info << "SGD: minimized within tolerance " << tolerance
-          << "; terminating optimization." << std::endl;
-      return overallObjective;
-    }
-
-    // Get the stepsize for this iteration
-    double stepSize = decayPolicy.StepSize(i);
-
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-
-    #pragma omp parallel
-    {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
-        {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
-        {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
-        }
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
-          {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
-          }
-        }
-      }
-    }
-  }
-  mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
-      << overallObjective << std::endl;
+  return mlpack::svd::StratifiedOptimize(*this, function, iterate);
+}
 
-  return overallObjective;
+template <>
+template <>
+inline double ParallelSGD<ConstantStep>::Optimize(
+    mlpack::svd::SVDPlusPlusFunction<arma::mat>& function,
+    arma::mat& iterate)
+{
+  return mlpack::svd::StratifiedOptimize(*this, function, iterate);
 }
 
 } // namespace ens
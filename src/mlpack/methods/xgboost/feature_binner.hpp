@@ -0,0 +1,97 @@
+/**
+ * @file methods/xgboost/feature_binner.hpp
+ *
+ * Definition of the FeatureBinner class, which maps the values of each feature
+ * of a dataset to quantile bins for histogram based tree building.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_FEATURE_BINNER_HPP
+#define MLPACK_METHODS_XGBOOST_FEATURE_BINNER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ensemble {
+
+/**
+ * The FeatureBinner maps the values of each feature (dimension) of a dataset to
+ * at most 256 bins, so that each value can be stored in a single byte and the
+ * split search of a tree node only needs to scan one histogram per feature.
+ * The bins of a feature are given by its quantiles: if a feature has no more
+ * distinct values than bins, each distinct value gets its own bin; otherwise,
+ * each bin holds about the same number of points.
+ *
+ * Bin b of a feature holds the values x with Edge(b - 1) < x <= Edge(b), so a
+ * split that sends bins [0, b] left is the split x <= Edge(b) of the original
+ * values.  NaN values are put in the last bin.
+ */
+class FeatureBinner
+{
+ public:
+  //! Create an empty binner.  Fit() must be called before Bin().
+  FeatureBinner() { }
+
+  /**
+   * Compute the bins of each feature of the given dataset (one point per
+   * column).  The features are processed in parallel.
+   *
+   * @param data Dataset to compute the bins of.
+   * @param maxBins Maximum number of bins of each feature (at most 256).
+   */
+  template<typename MatType>
+  void Fit(const MatType& data, const size_t maxBins = 256);
+
+  /**
+   * Map the values of the given dataset to their bins.  The output has one
+   * column per feature, so that the bins of a feature are contiguous in
+   * memory, and one row per point.
+   *
+   * @param data Dataset to bin (one point per column).
+   * @param bins Matrix to store the bins into.
+   */
+  template<typename MatType>
+  void Bin(const MatType& data, arma::Mat<unsigned char>& bins) const;
+
+  //! Return the bin of the given value of the given feature.
+  unsigned char Bin(const size_t feature, const double value) const
+  {
+    const std::vector<double>& e = edges[feature];
+    return (unsigned char) (std::lower_bound(e.begin(), e.end(), value) -
+        e.begin());
+  }
+
+  //! Get the number of features.
+  size_t NumFeatures() const { return edges.size(); }
+  //! Get the number of bins of the given feature.
+  size_t NumBins(const size_t feature) const
+  { return edges[feature].size() + 1; }
+  //! Get the upper edge of the given bin of the given feature.
+  double Edge(const size_t feature, const size_t bin) const
+  {
+    return (bin < edges[feature].size()) ? edges[feature][bin] :
+        std::numeric_limits<double>::infinity();
+  }
+
+  //! Serialize the binner.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(edges));
+  }
+
+ private:
+  //! The upper edges of the bins of each feature, except the last bin.
+  std::vector<std::vector<double>> edges;
+};
+
+} // namespace ensemble
+} // namespace mlpack
+
+// Include implementation.
+#include "feature_binner_impl.hpp"
+
+#endif
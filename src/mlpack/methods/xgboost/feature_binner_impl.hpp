@@ -0,0 +1,97 @@
+/**
+ * @file methods/xgboost/feature_binner_impl.hpp
+ *
+ * Implementation of the FeatureBinner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_FEATURE_BINNER_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_FEATURE_BINNER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "feature_binner.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+template<typename MatType>
+void FeatureBinner::Fit(const MatType& data, const size_t maxBins)
+{
+  if (maxBins < 2 || maxBins > 256)
+  {
+    std::ostringstream oss;
+    oss << "FeatureBinner::Fit(): the number of bins must be between 2 and "
+        << "256, not " << maxBins;
+    throw std::invalid_argument(oss.str());
+  }
+
+  edges.clear();
+  edges.resize(data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t f = 0; f < (omp_size_t) data.n_rows; ++f)
+  {
+    std::vector<double> values;
+    values.reserve(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const double value = (double) data(f, i);
+      if (!std::isnan(value))
+        values.push_back(value);
+    }
+
+    std::sort(values.begin(), values.end());
+    size_t distinct = (values.empty() ? 0 : 1);
+    for (size_t i = 1; i < values.size(); ++i)
+      distinct += (values[i] != values[i - 1]);
+
+    std::vector<double>& e = edges[f];
+    if (distinct <= maxBins)
+    {
+      // Each distinct value gets its own bin; the last one needs no edge.
+      for (size_t i = 1; i < values.size(); ++i)
+      {
+        if (values[i] != values[i - 1])
+          e.push_back(values[i - 1]);
+      }
+      continue;
+    }
+
+    // Otherwise, the edges are the quantiles of the values.
+    for (size_t b = 1; b < maxBins; ++b)
+    {
+      const double edge = values[b * values.size() / maxBins - 1];
+      if ((e.empty() || edge > e.back()) && edge < values.back())
+        e.push_back(edge);
+    }
+  }
+}
+
+template<typename MatType>
+void FeatureBinner::Bin(const MatType& data,
+                        arma::Mat<unsigned char>& bins) const
+{
+  if (data.n_rows != edges.size())
+  {
+    std::ostringstream oss;
+    oss << "FeatureBinner::Bin(): dataset has " << data.n_rows << " features, "
+        << "but the binner was fitted with " << edges.size();
+    throw std::invalid_argument(oss.str());
+  }
+
+  bins.set_size(data.n_cols, data.n_rows);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    for (size_t f = 0; f < data.n_rows; ++f)
+      bins(i, f) = Bin(f, (double) data(f, i));
+  }
+}
+
+} // namespace ensemble
+} // namespace mlpack
+
+#endif
@@ -93,18 +93,69 @@ class SSELoss
     return std::pow(ApplyL1(arma::accu(gradients)), 2) /
         (arma::accu(hessians) + lambda);
   }
+
+  /**
+   * Compute the first and second order gradients of the loss with respect to
+   * the predictions, for each point.  These are used by the histogram based
+   * booster (see XGBoost).
+   *
+   * @param responses True observed values.
+   * @param predictions Predictions at the current step of boosting.
+   * @param gradients Vector to store the first order gradients into.
+   * @param hessians Vector to store the second order gradients into.
+   */
+  void Gradients(const arma::rowvec& responses,
+                 const arma::rowvec& predictions,
+                 arma::vec& gradients,
+                 arma::vec& hessians) const
+  {
+    gradients = (predictions - responses).t();
+    hessians.ones(responses.n_elem);
+  }
+
+  /**
+   * Return the gain (score) of a node, given the sums of the gradients and
+   * hessians of its points.
+   */
+  double Gain(const double sumGradients, const double sumHessians) const
+  {
+    return std::pow(ApplyL1(sumGradients), 2) / (sumHessians + lambda);
+  }
+
+  /**
+   * Return the output value of a leaf, given the sums of the gradients and
+   * hessians of its points.
+   */
+  double LeafValue(const double sumGradients, const double sumHessians) const
+  {
+    return -ApplyL1(sumGradients) / (sumHessians + lambda);
+  }
+
+  //! Get the L1 regularization parameter.
+  double Alpha() const { return alpha; }
+  //! Get the L2 regularization parameter.
+  double Lambda() const { return lambda; }
+
+  //! Serialize the loss function.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(alpha));
+    ar(CEREAL_NVP(lambda));
+  }
+
  private:
-  //! The L2 regularization parameter.
-  const double lambda;
   //! The L1 regularization parameter.
-  const double alpha;
+  double alpha;
+  //! The L2 regularization parameter.
+  double lambda;
   //! First order gradients.
   arma::vec gradients;
   //! Second order gradients (hessians).
   arma::vec hessians;
 
   //! Applies the L1 regularization.
-  double ApplyL1(const double sumGradients)
+  double ApplyL1(const double sumGradients) const
   {
     if (sumGradients > alpha)
     {
@@ -114,7 +165,7 @@ class SSELoss
     {
       return sumGradients + alpha;
     }
-    
+
     return 0;
   }
 };
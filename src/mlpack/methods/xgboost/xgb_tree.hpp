@@ -0,0 +1,203 @@
+/**
+ * @file methods/xgboost/xgb_tree.hpp
+ *
+ * Definition of the XGBTree class, a regression tree that is built on
+ * gradient histograms for gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGB_TREE_HPP
+#define MLPACK_METHODS_XGBOOST_XGB_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "feature_binner.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+/**
+ * The XGBTree is one regression tree of a gradient boosted ensemble (see
+ * XGBoost).  It is fitted to the first and second order gradients of the loss
+ * of each point, on a dataset whose features have been binned by a
+ * FeatureBinner, so that the best split of a node is found by one scan of a
+ * gradient histogram per feature instead of by sorting.  The histograms of a
+ * node are built in parallel over the features; the histograms of the larger
+ * child of a split are then computed by subtracting the histograms of the
+ * smaller child from those of the node, so only the smaller child's points are
+ * ever scanned.
+ *
+ * The tree can be grown depth-wise (level by level), or leaf-wise (always
+ * splitting the leaf with the largest gain, as in LightGBM), which gives a
+ * better tree for the same number of leaves.
+ */
+class XGBTree
+{
+ public:
+  //! Create an empty tree, which predicts zero.
+  XGBTree() { }
+
+  /**
+   * Grow the tree on the given binned dataset.  The leaf values are the
+   * optimal values of the loss for the points of each leaf, scaled by the
+   * learning rate.
+   *
+   * @param bins Binned dataset (one row per point, one column per feature).
+   * @param binner Binner that computed the bins.
+   * @param gradients First order gradients of the loss of each point.
+   * @param hessians Second order gradients of the loss of each point.
+   * @param rows Indices of the points to grow the tree on (e.g. a subsample);
+   *     they are reordered during the growth.
+   * @param loss Loss function, which gives the gain of a node and the value of
+   *     a leaf from the sums of gradients and hessians of its points.
+   * @param maxDepth Maximum depth of the tree (0 means no limit).
+   * @param maxLeaves Maximum number of leaves; if it is nonzero, the tree is
+   *     grown leaf-wise, otherwise it is grown depth-wise.
+   * @param minChildWeight Minimum sum of hessians of each child of a split.
+   * @param learningRate Factor that the leaf values are scaled by.
+   */
+  template<typename LossFunctionType>
+  void Train(const arma::Mat<unsigned char>& bins,
+             const FeatureBinner& binner,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             std::vector<size_t>& rows,
+             const LossFunctionType& loss,
+             const size_t maxDepth,
+             const size_t maxLeaves,
+             const double minChildWeight,
+             const double learningRate);
+
+  /**
+   * Predict the value of the given point.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the value of the given point of a binned dataset.
+   *
+   * @param bins Binned dataset (one row per point, one column per feature).
+   * @param row Index of the point.
+   */
+  double Predict(const arma::Mat<unsigned char>& bins, const size_t row) const;
+
+  //! Get the number of nodes of the tree.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of leaves of the tree.
+  size_t NumLeaves() const { return (nodes.size() + 1) / 2; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(nodes));
+  }
+
+  /**
+   * A node of the tree.  Points with a value at most the threshold (or a bin
+   * at most the split bin) in the split feature go to the left child.  The
+   * node is a leaf if it has no left child (the root is never a child).
+   */
+  struct Node
+  {
+    Node() : feature(0), bin(0), threshold(0.0), left(0), right(0), value(0.0)
+    { }
+
+    //! The feature of the split.
+    size_t feature;
+    //! The last bin of the split that goes left.
+    unsigned char bin;
+    //! The last value of the split that goes left.
+    double threshold;
+    //! The index of the left child, or 0 for a leaf.
+    size_t left;
+    //! The index of the right child.
+    size_t right;
+    //! The value of the leaf.
+    double value;
+
+    //! Serialize the node.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(feature));
+      ar(CEREAL_NVP(bin));
+      ar(CEREAL_NVP(threshold));
+      ar(CEREAL_NVP(left));
+      ar(CEREAL_NVP(right));
+      ar(CEREAL_NVP(value));
+    }
+  };
+
+  //! Get the nodes of the tree; the root is the first one.
+  const std::vector<Node>& Nodes() const { return nodes; }
+
+ private:
+  //! The sums of the gradients and hessians of the points in a bin.
+  struct HistogramBin
+  {
+    double gradient;
+    double hessian;
+    size_t count;
+  };
+
+  //! A leaf that may still be split.
+  struct Candidate
+  {
+    //! The index of the node.
+    size_t node;
+    //! The points of the node are rows[begin, end).
+    size_t begin;
+    size_t end;
+    //! The depth of the node.
+    size_t depth;
+    //! The histogram of each feature, with 256 bins per feature.
+    std::vector<HistogramBin> histogram;
+    //! The sums of the gradients and hessians of the node's points.
+    double sumGradients;
+    double sumHessians;
+    //! The best split of the node.
+    double gain;
+    size_t feature;
+    unsigned char bin;
+  };
+
+  /**
+   * Build the histograms of the points rows[begin, end), in parallel over the
+   * features.
+   */
+  static void BuildHistogram(const arma::Mat<unsigned char>& bins,
+                             const arma::vec& gradients,
+                             const arma::vec& hessians,
+                             const std::vector<size_t>& rows,
+                             const size_t begin,
+                             const size_t end,
+                             std::vector<HistogramBin>& histogram);
+
+  /**
+   * Find the best split of the given candidate from its histograms, in
+   * parallel over the features.  The gain of the candidate is left at zero if
+   * there is no split with positive gain.
+   */
+  template<typename LossFunctionType>
+  static void FindSplit(Candidate& candidate,
+                        const FeatureBinner& binner,
+                        const LossFunctionType& loss,
+                        const double minChildWeight);
+
+  //! The nodes of the tree.
+  std::vector<Node> nodes;
+};
+
+} // namespace ensemble
+} // namespace mlpack
+
+// Include implementation.
+#include "xgb_tree_impl.hpp"
+
+#endif
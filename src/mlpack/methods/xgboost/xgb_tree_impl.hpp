@@ -0,0 +1,268 @@
+/**
+ * @file methods/xgboost/xgb_tree_impl.hpp
+ *
+ * Implementation of the XGBTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGB_TREE_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGB_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgb_tree.hpp"
+
+#include <deque>
+
+namespace mlpack {
+namespace ensemble {
+
+template<typename LossFunctionType>
+void XGBTree::Train(const arma::Mat<unsigned char>& bins,
+                    const FeatureBinner& binner,
+                    const arma::vec& gradients,
+                    const arma::vec& hessians,
+                    std::vector<size_t>& rows,
+                    const LossFunctionType& loss,
+                    const size_t maxDepth,
+                    const size_t maxLeaves,
+                    const double minChildWeight,
+                    const double learningRate)
+{
+  nodes.assign(1, Node());
+  if (rows.empty())
+    return;
+
+  Candidate root;
+  root.node = 0;
+  root.begin = 0;
+  root.end = rows.size();
+  root.depth = 0;
+  root.sumGradients = 0.0;
+  root.sumHessians = 0.0;
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    root.sumGradients += gradients[rows[i]];
+    root.sumHessians += hessians[rows[i]];
+  }
+  nodes[0].value = learningRate * loss.LeafValue(root.sumGradients,
+      root.sumHessians);
+
+  // The leaves that may still be split.  When the tree is grown depth-wise,
+  // they are split in the order they were created, so level by level.
+  std::deque<Candidate> open;
+  BuildHistogram(bins, gradients, hessians, rows, root.begin, root.end,
+      root.histogram);
+  FindSplit(root, binner, loss, minChildWeight);
+  if (root.gain > 0.0)
+    open.push_back(std::move(root));
+
+  size_t numLeaves = 1;
+  while (!open.empty() && (maxLeaves == 0 || numLeaves < maxLeaves))
+  {
+    size_t next = 0;
+    if (maxLeaves > 0)
+    {
+      for (size_t i = 1; i < open.size(); ++i)
+      {
+        if (open[i].gain > open[next].gain)
+          next = i;
+      }
+    }
+
+    Candidate c = std::move(open[next]);
+    open.erase(open.begin() + next);
+
+    // Partition the points stably, so that the points of each node stay
+    // sorted and the histograms are built with increasing memory accesses.
+    const unsigned char* featureBins = bins.colptr(c.feature);
+    const unsigned char splitBin = c.bin;
+    const size_t mid = std::stable_partition(rows.begin() + c.begin,
+        rows.begin() + c.end,
+        [featureBins, splitBin](const size_t r)
+        { return featureBins[r] <= splitBin; }) - rows.begin();
+
+    Candidate children[2];
+    children[0].begin = c.begin;
+    children[0].end = mid;
+    children[1].begin = mid;
+    children[1].end = c.end;
+
+    // Only the histograms of the smaller child are built from its points;
+    // those of the larger child are the difference with the parent's.
+    const size_t smaller = (mid - c.begin <= c.end - mid) ? 0 : 1;
+    Candidate& small = children[smaller];
+    Candidate& large = children[1 - smaller];
+    BuildHistogram(bins, gradients, hessians, rows, small.begin, small.end,
+        small.histogram);
+    large.histogram = std::move(c.histogram);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) large.histogram.size(); ++i)
+    {
+      large.histogram[i].gradient -= small.histogram[i].gradient;
+      large.histogram[i].hessian -= small.histogram[i].hessian;
+      large.histogram[i].count -= small.histogram[i].count;
+    }
+
+    small.sumGradients = 0.0;
+    small.sumHessians = 0.0;
+    const HistogramBin* splitHistogram = &small.histogram[c.feature * 256];
+    for (size_t b = 0; b < 256; ++b)
+    {
+      small.sumGradients += splitHistogram[b].gradient;
+      small.sumHessians += splitHistogram[b].hessian;
+    }
+    large.sumGradients = c.sumGradients - small.sumGradients;
+    large.sumHessians = c.sumHessians - small.sumHessians;
+
+    const size_t left = nodes.size();
+    nodes.resize(left + 2);
+    nodes[c.node].feature = c.feature;
+    nodes[c.node].bin = c.bin;
+    nodes[c.node].threshold = binner.Edge(c.feature, c.bin);
+    nodes[c.node].left = left;
+    nodes[c.node].right = left + 1;
+    ++numLeaves;
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+      Candidate& child = children[i];
+      child.node = left + i;
+      child.depth = c.depth + 1;
+      nodes[child.node].value = learningRate * loss.LeafValue(
+          child.sumGradients, child.sumHessians);
+
+      if (maxDepth == 0 || child.depth < maxDepth)
+      {
+        FindSplit(child, binner, loss, minChildWeight);
+        if (child.gain > 0.0)
+          open.push_back(std::move(child));
+      }
+    }
+  }
+}
+
+template<typename VecType>
+double XGBTree::Predict(const VecType& point) const
+{
+  if (nodes.empty())
+    return 0.0;
+
+  size_t n = 0;
+  while (nodes[n].left != 0)
+  {
+    n = (point[nodes[n].feature] <= nodes[n].threshold) ? nodes[n].left :
+        nodes[n].right;
+  }
+
+  return nodes[n].value;
+}
+
+inline double XGBTree::Predict(const arma::Mat<unsigned char>& bins,
+                               const size_t row) const
+{
+  if (nodes.empty())
+    return 0.0;
+
+  size_t n = 0;
+  while (nodes[n].left != 0)
+  {
+    n = (bins(row, nodes[n].feature) <= nodes[n].bin) ? nodes[n].left :
+        nodes[n].right;
+  }
+
+  return nodes[n].value;
+}
+
+inline void XGBTree::BuildHistogram(const arma::Mat<unsigned char>& bins,
+                                    const arma::vec& gradients,
+                                    const arma::vec& hessians,
+                                    const std::vector<size_t>& rows,
+                                    const size_t begin,
+                                    const size_t end,
+                                    std::vector<HistogramBin>& histogram)
+{
+  histogram.assign(bins.n_cols * 256, HistogramBin{ 0.0, 0.0, 0 });
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t f = 0; f < (omp_size_t) bins.n_cols; ++f)
+  {
+    const unsigned char* featureBins = bins.colptr(f);
+    HistogramBin* featureHistogram = &histogram[f * 256];
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t r = rows[i];
+      HistogramBin& bin = featureHistogram[featureBins[r]];
+      bin.gradient += gradients[r];
+      bin.hessian += hessians[r];
+      ++bin.count;
+    }
+  }
+}
+
+template<typename LossFunctionType>
+void XGBTree::FindSplit(Candidate& candidate,
+                        const FeatureBinner& binner,
+                        const LossFunctionType& loss,
+                        const double minChildWeight)
+{
+  const size_t numFeatures = binner.NumFeatures();
+  const size_t count = candidate.end - candidate.begin;
+  const double sumGradients = candidate.sumGradients;
+  const double sumHessians = candidate.sumHessians;
+  const double parentGain = loss.Gain(sumGradients, sumHessians);
+
+  // Find the best split of each feature, then the best of them serially, so
+  // that the result does not depend on the number of threads.
+  std::vector<double> gains(numFeatures, 0.0);
+  std::vector<unsigned char> splitBins(numFeatures, 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t f = 0; f < (omp_size_t) numFeatures; ++f)
+  {
+    const HistogramBin* featureHistogram = &candidate.histogram[f * 256];
+    double leftGradients = 0.0, leftHessians = 0.0;
+    size_t leftCount = 0;
+    for (size_t b = 0; b + 1 < binner.NumBins(f); ++b)
+    {
+      leftGradients += featureHistogram[b].gradient;
+      leftHessians += featureHistogram[b].hessian;
+      leftCount += featureHistogram[b].count;
+      if (leftCount == 0)
+        continue;
+      if (leftCount == count)
+        break;
+
+      const double rightHessians = sumHessians - leftHessians;
+      if (leftHessians < minChildWeight || rightHessians < minChildWeight)
+        continue;
+
+      const double gain = loss.Gain(leftGradients, leftHessians) +
+          loss.Gain(sumGradients - leftGradients, rightHessians) - parentGain;
+      if (gain > gains[f])
+      {
+        gains[f] = gain;
+        splitBins[f] = (unsigned char) b;
+      }
+    }
+  }
+
+  candidate.gain = 0.0;
+  candidate.feature = 0;
+  candidate.bin = 0;
+  for (size_t f = 0; f < numFeatures; ++f)
+  {
+    if (gains[f] > candidate.gain)
+    {
+      candidate.gain = gains[f];
+      candidate.feature = f;
+      candidate.bin = splitBins[f];
+    }
+  }
+}
+
+} // namespace ensemble
+} // namespace mlpack
+
+#endif
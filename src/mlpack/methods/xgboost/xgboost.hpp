@@ -0,0 +1,160 @@
+/**
+ * @file methods/xgboost/xgboost.hpp
+ *
+ * Definition of the XGBoost class, a histogram based gradient boosting engine
+ * for regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "loss_functions/sse_loss.hpp"
+#include "feature_binner.hpp"
+#include "xgb_tree.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+/**
+ * The XGBoost class implements gradient boosted regression trees, as
+ * described in the XGBoost paper:
+ *
+ * @code
+ * @inproceedings{chen2016xgboost,
+ *   title={{XGBoost}: A Scalable Tree Boosting System},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * Each tree is fitted to the gradients and hessians of the loss at the current
+ * predictions, and its leaf values are the regularized optimal values given by
+ * the loss function.  Before training, the features are binned into at most
+ * 256 quantile bins (see FeatureBinner), so that the trees are built from
+ * gradient histograms (see XGBTree) instead of by sorting the points.  Each
+ * tree can be grown on a random subsample of the points.
+ *
+ * @code
+ * // Train 200 trees with at most 31 leaves each, on 80% of the points.
+ * XGBoost<> model(data, responses, 200, 0.1, 0, 31, 1.0, 0.8);
+ * arma::rowvec predictions;
+ * model.Predict(testData, predictions);
+ * @endcode
+ *
+ * @tparam LossFunctionType Loss function to minimize; it gives the initial
+ *     prediction, the gradients of the loss, and the gain and value of a node.
+ */
+template<typename LossFunctionType = SSELoss>
+class XGBoost
+{
+ public:
+  /**
+   * Create the model without training it.  Predict() will predict zero until
+   * Train() is called.
+   */
+  XGBoost();
+
+  /**
+   * Create the model and train it on the given data and responses; see
+   * Train() for the parameters.
+   */
+  template<typename MatType>
+  XGBoost(const MatType& data,
+          const arma::rowvec& responses,
+          const size_t numTrees = 100,
+          const double learningRate = 0.1,
+          const size_t maxDepth = 6,
+          const size_t maxLeaves = 0,
+          const double minChildWeight = 1.0,
+          const double subsampleRatio = 1.0,
+          const size_t maxBins = 256,
+          const LossFunctionType& loss = LossFunctionType());
+
+  /**
+   * Train the model on the given data and responses.  Any previous training
+   * is discarded.
+   *
+   * @param data Dataset to train on (one point per column).
+   * @param responses Responses of each point.
+   * @param numTrees Number of trees (boosting rounds).
+   * @param learningRate Factor that the leaf values of each tree are scaled
+   *     by (shrinkage).
+   * @param maxDepth Maximum depth of each tree (0 means no limit).
+   * @param maxLeaves Maximum number of leaves of each tree; if it is nonzero,
+   *     the trees are grown leaf-wise, otherwise depth-wise.
+   * @param minChildWeight Minimum sum of hessians of each child of a split.
+   * @param subsampleRatio Fraction of the points that each tree is grown on
+   *     (between 0 and 1).
+   * @param maxBins Maximum number of bins of each feature (at most 256).
+   * @param loss Instantiated loss function.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::rowvec& responses,
+             const size_t numTrees = 100,
+             const double learningRate = 0.1,
+             const size_t maxDepth = 6,
+             const size_t maxLeaves = 0,
+             const double minChildWeight = 1.0,
+             const double subsampleRatio = 1.0,
+             const size_t maxBins = 256,
+             const LossFunctionType& loss = LossFunctionType());
+
+  /**
+   * Predict the response of the given point.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the responses of the given points, in parallel.
+   *
+   * @param data Points to predict (one point per column).
+   * @param predictions Row to store the predictions into.
+   */
+  template<typename MatType>
+  void Predict(const MatType& data, arma::rowvec& predictions) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get a tree of the model.
+  const XGBTree& Tree(const size_t i) const { return trees[i]; }
+  //! Get the binner of the features.
+  const FeatureBinner& Binner() const { return binner; }
+  //! Get the initial prediction, which the trees are added to.
+  double InitialPrediction() const { return initialPrediction; }
+  //! Get the loss function.
+  const LossFunctionType& Loss() const { return loss; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The loss function.
+  LossFunctionType loss;
+  //! The binner of the features.
+  FeatureBinner binner;
+  //! The initial prediction.
+  double initialPrediction;
+  //! The trees.
+  std::vector<XGBTree> trees;
+};
+
+} // namespace ensemble
+} // namespace mlpack
+
+// Include implementation.
+#include "xgboost_impl.hpp"
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file methods/xgboost/xgboost_impl.hpp
+ *
+ * Implementation of the XGBoost class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgboost.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+template<typename LossFunctionType>
+XGBoost<LossFunctionType>::XGBoost() : initialPrediction(0.0)
+{
+  // Nothing to do.
+}
+
+template<typename LossFunctionType>
+template<typename MatType>
+XGBoost<LossFunctionType>::XGBoost(const MatType& data,
+                                   const arma::rowvec& responses,
+                                   const size_t numTrees,
+                                   const double learningRate,
+                                   const size_t maxDepth,
+                                   const size_t maxLeaves,
+                                   const double minChildWeight,
+                                   const double subsampleRatio,
+                                   const size_t maxBins,
+                                   const LossFunctionType& loss) :
+    initialPrediction(0.0)
+{
+  Train(data, responses, numTrees, learningRate, maxDepth, maxLeaves,
+      minChildWeight, subsampleRatio, maxBins, loss);
+}
+
+template<typename LossFunctionType>
+template<typename MatType>
+void XGBoost<LossFunctionType>::Train(const MatType& data,
+                                      const arma::rowvec& responses,
+                                      const size_t numTrees,
+                                      const double learningRate,
+                                      const size_t maxDepth,
+                                      const size_t maxLeaves,
+                                      const double minChildWeight,
+                                      const double subsampleRatio,
+                                      const size_t maxBins,
+                                      const LossFunctionType& loss)
+{
+  util::CheckSameSizes(data, responses, "XGBoost::Train()", "responses");
+  if (data.n_cols == 0)
+    throw std::invalid_argument("XGBoost::Train(): the dataset is empty");
+  if (learningRate <= 0.0)
+  {
+    throw std::invalid_argument("XGBoost::Train(): the learning rate must be "
+        "positive");
+  }
+  if (subsampleRatio <= 0.0 || subsampleRatio > 1.0)
+  {
+    throw std::invalid_argument("XGBoost::Train(): the subsample ratio must be "
+        "in (0, 1]");
+  }
+
+  this->loss = loss;
+  binner.Fit(data, maxBins);
+  arma::Mat<unsigned char> bins;
+  binner.Bin(data, bins);
+
+  initialPrediction = this->loss.InitialPrediction(responses);
+  arma::rowvec predictions(data.n_cols);
+  predictions.fill(initialPrediction);
+
+  trees.clear();
+  trees.resize(numTrees);
+  arma::vec gradients, hessians;
+  std::vector<size_t> rows;
+  rows.reserve(data.n_cols);
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    this->loss.Gradients(responses, predictions, gradients, hessians);
+
+    rows.clear();
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      if (subsampleRatio == 1.0 || math::Random() < subsampleRatio)
+        rows.push_back(i);
+    }
+
+    trees[t].Train(bins, binner, gradients, hessians, rows, this->loss,
+        maxDepth, maxLeaves, minChildWeight, learningRate);
+
+    // Every training point is predicted through its bins, including those
+    // that were not in the subsample.
+    const XGBTree& tree = trees[t];
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      predictions[i] += tree.Predict(bins, i);
+  }
+}
+
+template<typename LossFunctionType>
+template<typename VecType>
+double XGBoost<LossFunctionType>::Predict(const VecType& point) const
+{
+  double prediction = initialPrediction;
+  for (size_t t = 0; t < trees.size(); ++t)
+    prediction += trees[t].Predict(point);
+
+  return prediction;
+}
+
+template<typename LossFunctionType>
+template<typename MatType>
+void XGBoost<LossFunctionType>::Predict(const MatType& data,
+                                        arma::rowvec& predictions) const
+{
+  if (!trees.empty() && data.n_rows != binner.NumFeatures())
+  {
+    std::ostringstream oss;
+    oss << "XGBoost::Predict(): dataset has " << data.n_rows << " dimensions, "
+        << "but the model was trained with " << binner.NumFeatures();
+    throw std::invalid_argument(oss.str());
+  }
+
+  predictions.set_size(data.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    predictions[i] = Predict(data.col(i));
+}
+
+template<typename LossFunctionType>
+template<typename Archive>
+void XGBoost<LossFunctionType>::serialize(Archive& ar,
+                                          const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(loss));
+  ar(CEREAL_NVP(binner));
+  ar(CEREAL_NVP(initialPrediction));
+  ar(CEREAL_NVP(trees));
+}
+
+} // namespace ensemble
+} // namespace mlpack
+
+#endif
@@ -103,6 +103,7 @@ using enable_if_t = typename enable_if<B, T>::type;
 #include <mlpack/core/cereal/pointer_vector_variant_wrapper.hpp>
 #include <mlpack/core/cereal/pointer_vector_wrapper.hpp>
 #include <mlpack/core/cereal/pointer_wrapper.hpp>
+#include <mlpack/core/cereal/template_class_version.hpp>
 #include <mlpack/core/data/has_serialize.hpp>
 
 // If we have Boost 1.58 or older and are using C++14, the compilation is likely
@@ -128,6 +129,9 @@ or upgrade Boost to 1.59 or newer.
 // All code should have access to logging.
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/util/profiler.hpp>
+#include <mlpack/core/util/memory_tracker.hpp>
+#include <mlpack/core/util/huge_page_allocator.hpp>
 
 // This can be removed with Visual Studio supports an OpenMP version with
 // unsigned loop variables.
@@ -137,6 +141,9 @@ or upgrade Boost to 1.59 or newer.
   #define omp_size_t size_t
 #endif
 
+// The parallel vector wrapper uses omp_size_t, so it is included here.
+#include <mlpack/core/cereal/parallel_vector_wrapper.hpp>
+
 // We need to be able to mark functions deprecated.
 #include <mlpack/core/util/deprecated.hpp>
 
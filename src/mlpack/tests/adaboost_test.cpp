@@ -891,3 +891,92 @@ TEST_CASE("ID3DecisionStumpSerializationTest", "[AdaBoostTest]")
             abBinary.WeakLearner(i).SplitDimension());
   }
 }
+
+/**
+ * Make sure that the batch classification of AdaBoost gives the weighted vote
+ * of its weak learners on each point.
+ */
+TEST_CASE("ClassifyWeightedVoteTest", "[AdaBoostTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  const arma::Row<size_t> labelsvec = labels.row(0);
+  const size_t numClasses = max(labelsvec) + 1;
+  ID3DecisionStump ds(inputData, labelsvec, numClasses);
+  AdaBoost<ID3DecisionStump> a(inputData, labelsvec, numClasses, ds, 50,
+      1e-10);
+  REQUIRE(a.WeakLearners() > 0);
+
+  arma::Row<size_t> predictedLabels;
+  arma::mat probabilities;
+  a.Classify(inputData, predictedLabels, probabilities);
+  REQUIRE(predictedLabels.n_elem == inputData.n_cols);
+  REQUIRE(probabilities.n_rows == numClasses);
+  REQUIRE(probabilities.n_cols == inputData.n_cols);
+
+  for (size_t i = 0; i < inputData.n_cols; ++i)
+  {
+    arma::vec votes(numClasses, arma::fill::zeros);
+    for (size_t j = 0; j < a.WeakLearners(); ++j)
+      votes[a.WeakLearner(j).Classify(inputData.col(i))] += a.Alpha(j);
+    votes /= arma::accu(votes);
+
+    for (size_t c = 0; c < numClasses; ++c)
+      REQUIRE(probabilities(c, i) == Approx(votes[c]).epsilon(1e-7));
+    REQUIRE(predictedLabels[i] == probabilities.col(i).index_max());
+  }
+}
+
+/**
+ * Make sure that the early-exit classification of AdaBoost gives the labels of
+ * the full classification with confidence 1, with fewer weak learner
+ * evaluations, and fewer still with a lower confidence.
+ */
+TEST_CASE("AdaBoostEarlyExitClassifyTest", "[AdaBoostTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  const arma::Row<size_t> labelsvec = labels.row(0);
+  const size_t numClasses = max(labelsvec) + 1;
+  ID3DecisionStump ds(inputData, labelsvec, numClasses);
+  AdaBoost<ID3DecisionStump> a(inputData, labelsvec, numClasses, ds, 50,
+      1e-10);
+  REQUIRE(a.WeakLearners() > 1);
+
+  arma::Row<size_t> predictedLabels;
+  a.Classify(inputData, predictedLabels);
+
+  arma::Row<size_t> exitLabels;
+  arma::mat exitProbabilities;
+  const size_t evaluations = a.EarlyExitClassify(inputData, exitLabels,
+      exitProbabilities);
+  REQUIRE(exitProbabilities.n_rows == numClasses);
+  REQUIRE(exitProbabilities.n_cols == inputData.n_cols);
+  REQUIRE(evaluations <= a.WeakLearners() * inputData.n_cols);
+  for (size_t i = 0; i < inputData.n_cols; ++i)
+  {
+    REQUIRE(exitLabels[i] == predictedLabels[i]);
+    REQUIRE(arma::accu(exitProbabilities.col(i)) == Approx(1.0).epsilon(1e-7));
+  }
+
+  arma::Row<size_t> fastLabels;
+  const size_t fastEvaluations = a.EarlyExitClassify(inputData, fastLabels,
+      0.25);
+  REQUIRE(fastEvaluations <= evaluations);
+  REQUIRE(fastLabels.n_elem == inputData.n_cols);
+
+  REQUIRE_THROWS_AS(a.EarlyExitClassify(inputData, fastLabels, 1.5),
+      std::invalid_argument);
+}
@@ -22,6 +22,7 @@
 #include <mlpack/methods/ann/loss_functions/binary_cross_entropy_loss.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/rnn.hpp>
+#include <mlpack/methods/ann/util/dropout_mask.hpp>
 
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
@@ -410,6 +411,43 @@ TEST_CASE("NoAlphaDropoutTest", "[ANNLayerTest]")
   REQUIRE(arma::accu(output) == arma::accu(input));
 }
 
+/**
+ * Make sure that a DropoutMask keeps the right proportion of the elements,
+ * that it is reproducible with the same seed, and that Apply() matches the
+ * unpacked mask.
+ */
+TEST_CASE("DropoutMaskTest", "[ANNLayerTest]")
+{
+  arma::mat input(37, 1001, arma::fill::randn);
+
+  math::RandomSeed(7);
+  DropoutMask mask;
+  mask.Generate(input.n_rows, input.n_cols, 0.3);
+  arma::mat unpacked;
+  mask.Unpack(unpacked);
+  REQUIRE(unpacked.n_rows == input.n_rows);
+  REQUIRE(unpacked.n_cols == input.n_cols);
+  REQUIRE(arma::accu(unpacked) / unpacked.n_elem == Approx(0.7).margin(0.01));
+
+  math::RandomSeed(7);
+  DropoutMask sameMask;
+  sameMask.Generate(input.n_rows, input.n_cols, 0.3);
+  arma::mat sameUnpacked;
+  sameMask.Unpack(sameUnpacked);
+  CheckMatrices(unpacked, sameUnpacked);
+
+  arma::mat output;
+  mask.Apply(input, output, 2.0, 0.5, -1.0);
+  const arma::mat expected = unpacked % (2.0 * input + 0.5) -
+      (1 - unpacked);
+  CheckMatrices(output, expected);
+
+  // A ratio of 1 drops everything.
+  mask.Generate(5, 5, 1.0);
+  mask.Unpack(unpacked);
+  REQUIRE(arma::accu(unpacked) == 0.0);
+}
+
 /**
  * Simple linear module test.
  */
@@ -1547,6 +1585,50 @@ TEST_CASE("GRULayerParametersTest", "[ANNLayerTest]")
   REQUIRE(layer1.Rho() == layer2.Rho());
 }
 
+/**
+ * Check the output of the GRU layer against a direct implementation of the
+ * GRU equations.
+ */
+TEST_CASE("GRULayerForwardTest", "[ANNLayerTest]")
+{
+  const size_t inSize = 3, outSize = 4, rho = 5;
+
+  RNN<> model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<GRU<> >(inSize, outSize, rho);
+
+  arma::cube input(inSize, 2, rho, arma::fill::randu);
+  arma::cube output;
+  model.Predict(input, output);
+
+  // The parameters of the GRU layer are the weights and the biases of the
+  // input, followed by the weights of the previous output (for zt and rt) and
+  // the weights of the reset previous output (for ot).
+  const arma::mat& parameters = model.Parameters();
+  const arma::mat w(parameters.memptr(), 3 * outSize, inSize);
+  const arma::vec b(parameters.memptr() + w.n_elem, 3 * outSize);
+  const arma::mat u(parameters.memptr() + w.n_elem + b.n_elem, 2 * outSize,
+      outSize);
+  const arma::mat uh(parameters.memptr() + w.n_elem + b.n_elem + u.n_elem,
+      outSize, outSize);
+
+  arma::mat h(outSize, 2, arma::fill::zeros);
+  for (size_t t = 0; t < rho; ++t)
+  {
+    arma::mat g = w * input.slice(t);
+    g.each_col() += b;
+    const arma::mat z = 1.0 / (1.0 + arma::exp(-(g.rows(0, outSize - 1) +
+        u.rows(0, outSize - 1) * h)));
+    const arma::mat r = 1.0 / (1.0 + arma::exp(-(g.rows(outSize,
+        2 * outSize - 1) + u.rows(outSize, 2 * outSize - 1) * h)));
+    const arma::mat o = arma::tanh(g.rows(2 * outSize, 3 * outSize - 1) +
+        uh * (r % h));
+    h = z % (h - o) + o;
+
+    CheckMatrices(output.slice(t), h, 1e-6);
+  }
+}
+
 /**
  * Check if the gradients computed by GRU cell are close enough to the
  * approximation of the gradients.
@@ -1689,6 +1771,116 @@ TEST_CASE("SimpleConcatLayerTest", "[ANNLayerTest]")
   REQUIRE(arma::accu(delta) == 0);
 }
 
+/**
+ * Test that the Backward() function of the Concat layer gives each module the
+ * rows of the error that correspond to its output.
+ */
+TEST_CASE("ConcatLayerBackwardTest", "[ANNLayerTest]")
+{
+  arma::mat output, input, error, delta, deltaA, deltaB, outputA, outputB;
+
+  Linear<>* moduleA = new Linear<>(10, 4);
+  moduleA->Parameters().randu();
+  moduleA->Reset();
+
+  Linear<>* moduleB = new Linear<>(10, 6);
+  moduleB->Parameters().randu();
+  moduleB->Reset();
+
+  Concat<> module(true);
+  module.Add(moduleA);
+  module.Add(moduleB);
+
+  input = arma::randu(10, 3);
+  module.Forward(input, output);
+  moduleA->Forward(input, outputA);
+  moduleB->Forward(input, outputB);
+  CheckMatrices(output, arma::join_cols(outputA, outputB));
+
+  error = arma::randu(10, 3);
+  module.Backward(input, error, delta);
+
+  const arma::mat errorA = error.rows(0, 3);
+  const arma::mat errorB = error.rows(4, 9);
+  moduleA->Backward(input, errorA, deltaA);
+  moduleB->Backward(input, errorB, deltaB);
+  CheckMatrices(delta, deltaA + deltaB);
+
+  // The Backward() function of a single module uses the same rows.
+  module.Backward(input, error, delta, 1);
+  CheckMatrices(delta, deltaB);
+
+  delete moduleA;
+  delete moduleB;
+}
+
+/**
+ * Test that the Concat and AddMerge layers give the same results when their
+ * modules run in parallel.
+ */
+TEST_CASE("ParallelConcatAddMergeLayerTest", "[ANNLayerTest]")
+{
+  const arma::mat input = arma::randu(10, 4);
+  const arma::mat error = arma::randu(15, 4);
+
+  std::vector<Linear<>*> layers;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    // The layers i and i + 3 are the same.
+    layers.push_back(new Linear<>(10, 5));
+    layers.back()->Parameters().set_size(55, 1);
+    if (i < 3)
+      layers.back()->Parameters().randu();
+    else
+      layers.back()->Parameters() = layers[i - 3]->Parameters();
+    layers.back()->Reset();
+    layers.back()->Gradient().zeros(55, 1);
+  }
+
+  Concat<> concat(true), parallelConcat(true);
+  parallelConcat.Parallel() = true;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    concat.Add(layers[i]);
+    parallelConcat.Add(layers[i + 3]);
+  }
+
+  arma::mat output, parallelOutput, delta, parallelDelta, gradient;
+  concat.Forward(input, output);
+  parallelConcat.Forward(input, parallelOutput);
+  CheckMatrices(output, parallelOutput);
+
+  concat.Backward(input, error, delta);
+  parallelConcat.Backward(input, error, parallelDelta);
+  CheckMatrices(delta, parallelDelta);
+
+  concat.Gradient(input, error, gradient);
+  parallelConcat.Gradient(input, error, gradient);
+  for (size_t i = 0; i < 3; ++i)
+    CheckMatrices(layers[i]->Gradient(), layers[i + 3]->Gradient());
+
+  // The AddMerge layer does not own the layers either.
+  AddMerge<> addMerge(true, true, false), parallelAddMerge(true, true, false);
+  parallelAddMerge.Parallel() = true;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    addMerge.Add(layers[i]);
+    parallelAddMerge.Add(layers[i + 3]);
+  }
+
+  const arma::mat mergeError = error.rows(0, 4);
+  addMerge.Forward(input, output);
+  parallelAddMerge.Forward(input, parallelOutput);
+  CheckMatrices(output, parallelOutput);
+
+  addMerge.Backward(input, mergeError, delta);
+  parallelAddMerge.Backward(input, mergeError, parallelDelta);
+  CheckMatrices(delta, parallelDelta);
+
+  for (size_t i = 0; i < layers.size(); ++i)
+    delete layers[i];
+}
+
 /**
  * Test to check Concat layer along different axes.
  */
@@ -2001,6 +2193,50 @@ TEST_CASE("GradientLookupLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) <= 1e-6);
 }
 
+/**
+ * Test that the sparse gradient of a network that starts with a Lookup layer
+ * is the same as the dense gradient, and only holds the used embeddings.
+ */
+TEST_CASE("SparseGradientLookupLayerTest", "[ANNLayerTest]")
+{
+  const size_t seqLength = 3;
+  const size_t embeddingSize = 4;
+  const size_t vocabSize = 100;
+  const size_t batchSize = 2;
+
+  arma::mat input(seqLength, batchSize);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    input(i) = math::RandInt(1, vocabSize);
+  // Use one token twice, so that its gradient is accumulated.
+  input(1, 1) = input(0, 0);
+
+  arma::mat target = arma::zeros(vocabSize, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+    target(math::RandInt(vocabSize), i) = 1;
+
+  FFN<BCELoss<>, GlorotInitialization> model(BCELoss<>(1e-10, false));
+  model.Predictors() = input;
+  model.Responses() = target;
+  model.Add<Lookup<> >(vocabSize, embeddingSize);
+  model.Add<Linear<> >(embeddingSize * seqLength, vocabSize);
+  model.Add<Softmax<> >();
+  model.ResetParameters();
+
+  arma::mat denseGradient;
+  model.Gradient(model.Parameters(), 0, denseGradient, batchSize);
+  arma::sp_mat sparseGradient;
+  model.Gradient(model.Parameters(), 0, sparseGradient, batchSize);
+
+  REQUIRE(sparseGradient.n_rows == denseGradient.n_rows);
+  REQUIRE(sparseGradient.n_cols == denseGradient.n_cols);
+  CheckMatrices(arma::mat(sparseGradient), denseGradient, 1e-10);
+
+  // Only the used embeddings (at most seqLength * batchSize - 1) are stored.
+  const size_t linearSize = embeddingSize * seqLength * vocabSize + vocabSize;
+  REQUIRE(sparseGradient.n_nonzero <= linearSize +
+      (seqLength * batchSize - 1) * embeddingSize);
+}
+
 /**
  * Test that the functions that can access the parameters of the
  * Lookup layer work.
@@ -2414,6 +2650,48 @@ TEST_CASE("BatchNormTest", "[ANNLayerTest]")
   CheckMatrices(output, result, 1e-1);
 }
 
+/**
+ * Make sure the BatchNorm, LayerNorm and GroupNorm layers normalize inputs
+ * whose mean is large compared to their standard deviation.
+ */
+TEST_CASE("NormalizationLargeMeanTest", "[ANNLayerTest]")
+{
+  // 4 channels of 6 elements, for 20 points.
+  arma::mat input = 1e8 + arma::randn<arma::mat>(24, 20);
+  arma::mat output;
+
+  BatchNorm<> batchNorm(4, 1e-8);
+  batchNorm.Reset();
+  batchNorm.Forward(input, output);
+  for (size_t c = 0; c < 4; ++c)
+  {
+    arma::vec channel = arma::vectorise(output.rows(6 * c, 6 * c + 5));
+    REQUIRE(arma::mean(channel) == Approx(0.0).margin(1e-6));
+    REQUIRE(arma::var(channel, 1) == Approx(1.0));
+  }
+
+  LayerNorm<> layerNorm(24, 1e-8);
+  layerNorm.Reset();
+  layerNorm.Forward(input, output);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    arma::vec point = output.col(i);
+    REQUIRE(arma::mean(point) == Approx(0.0).margin(1e-6));
+    REQUIRE(arma::var(point, 1) == Approx(1.0));
+  }
+  REQUIRE(layerNorm.Mean()(0) == Approx(arma::mean(input.col(0))));
+
+  GroupNorm<> groupNorm(2, 4, 1e-8);
+  groupNorm.Reset();
+  groupNorm.Forward(input, output);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    arma::vec group = arma::vectorise(output.submat(12, i, 23, i));
+    REQUIRE(arma::mean(group) == Approx(0.0).margin(1e-6));
+    REQUIRE(arma::var(group, 1) == Approx(1.0));
+  }
+}
+
 /**
  * BatchNorm layer numerical gradient test.
  */
@@ -3996,6 +4274,109 @@ TEST_CASE("ConvolutionLayerPaddingTest", "[ANNLayerTest]")
   module2.Backward(input, output, delta);
 }
 
+/**
+ * Make sure that the Convolution layer gives the same results with
+ * Im2ColConvolution as with the naive convolution.
+ */
+TEST_CASE("ConvolutionLayerIm2ColTest", "[ANNLayerTest]")
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>> Im2ColLayer;
+
+  // Two input maps of size 6 x 5, and a batch of 4 points.
+  arma::mat input = arma::randu<arma::mat>(6 * 5 * 2, 4);
+
+  // A stride of 1, with padding.
+  Convolution<> naive(2, 3, 3, 3, 1, 1, 1, 1, 6, 5);
+  Im2ColLayer im2col(2, 3, 3, 3, 1, 1, 1, 1, 6, 5);
+  naive.Parameters() = arma::randu<arma::mat>(3 * 3 * 2 * 3 + 3, 1);
+  im2col.Parameters() = naive.Parameters();
+  naive.Reset();
+  im2col.Reset();
+
+  arma::mat naiveOutput, im2colOutput;
+  naive.Forward(input, naiveOutput);
+  im2col.Forward(input, im2colOutput);
+  CheckMatrices(naiveOutput, im2colOutput);
+
+  arma::mat error = arma::randu<arma::mat>(naiveOutput.n_rows, 4);
+  arma::mat naiveDelta, im2colDelta;
+  naive.Backward(input, error, naiveDelta);
+  im2col.Backward(input, error, im2colDelta);
+  CheckMatrices(naiveDelta, im2colDelta);
+
+  arma::mat naiveGradient, im2colGradient;
+  naive.Gradient(input, error, naiveGradient);
+  im2col.Gradient(input, error, im2colGradient);
+  CheckMatrices(naiveGradient, im2colGradient);
+
+  // A stride of 2, without padding.
+  Convolution<> naiveStrided(2, 3, 2, 2, 2, 2, 0, 0, 6, 5);
+  Im2ColLayer im2colStrided(2, 3, 2, 2, 2, 2, 0, 0, 6, 5);
+  naiveStrided.Parameters() = arma::randu<arma::mat>(2 * 2 * 2 * 3 + 3, 1);
+  im2colStrided.Parameters() = naiveStrided.Parameters();
+  naiveStrided.Reset();
+  im2colStrided.Reset();
+
+  naiveStrided.Forward(input, naiveOutput);
+  im2colStrided.Forward(input, im2colOutput);
+  CheckMatrices(naiveOutput, im2colOutput);
+}
+
+/**
+ * Make sure that the Convolution layer gives the same results with
+ * CachedFFTConvolution as with the naive convolution, also after its weights
+ * change.
+ */
+TEST_CASE("ConvolutionLayerCachedFFTTest", "[ANNLayerTest]")
+{
+  typedef Convolution<CachedFFTConvolution<ValidConvolution>> FFTLayer;
+
+  // Two input maps of size 6 x 5, and a batch of 4 points.
+  arma::mat input = arma::randu<arma::mat>(6 * 5 * 2, 4);
+
+  // A stride of 1, with padding.
+  Convolution<> naive(2, 3, 3, 3, 1, 1, 1, 1, 6, 5);
+  FFTLayer fft(2, 3, 3, 3, 1, 1, 1, 1, 6, 5);
+  naive.Parameters() = arma::randu<arma::mat>(3 * 3 * 2 * 3 + 3, 1);
+  fft.Parameters() = naive.Parameters();
+  naive.Reset();
+  fft.Reset();
+
+  arma::mat naiveOutput, fftOutput;
+  naive.Forward(input, naiveOutput);
+  fft.Forward(input, fftOutput);
+  CheckMatrices(naiveOutput, fftOutput);
+
+  // Update the weights in place, as an optimizer does; the spectra of the
+  // filters must be computed again.
+  naive.Parameters() -= 0.1;
+  fft.Parameters() -= 0.1;
+  naive.Forward(input, naiveOutput);
+  fft.Forward(input, fftOutput);
+  CheckMatrices(naiveOutput, fftOutput);
+
+  // The backward pass and the gradient use the naive convolution.
+  arma::mat error = arma::randu<arma::mat>(naiveOutput.n_rows, 4);
+  arma::mat naiveGradient, fftGradient;
+  naive.Gradient(input, error, naiveGradient);
+  fft.Gradient(input, error, fftGradient);
+  CheckMatrices(naiveGradient, fftGradient);
+
+  // A stride of 2 with a large filter, without padding.
+  Convolution<> naiveStrided(2, 3, 4, 4, 2, 2, 0, 0, 6, 5);
+  FFTLayer fftStrided(2, 3, 4, 4, 2, 2, 0, 0, 6, 5);
+  naiveStrided.Parameters() = arma::randu<arma::mat>(4 * 4 * 2 * 3 + 3, 1);
+  fftStrided.Parameters() = naiveStrided.Parameters();
+  naiveStrided.Reset();
+  fftStrided.Reset();
+
+  naiveStrided.Forward(input, naiveOutput);
+  fftStrided.Forward(input, fftOutput);
+  CheckMatrices(naiveOutput, fftOutput);
+}
+
 /**
  * Test that the padding options in Transposed Convolution layer.
  */
@@ -4143,6 +4524,43 @@ TEST_CASE("LpMaxPoolingTestCase", "[ANNLayerTest]")
   REQUIRE(output.n_elem == 4);
 }
 
+/**
+ * Check the gradient of the LpPooling layer against finite differences, with
+ * overlapping windows that are clipped at the border.
+ */
+TEST_CASE("LpPoolingGradientTest", "[ANNLayerTest]")
+{
+  // Two channels of a 6 x 4 input, for a batch of 2 points.
+  arma::mat input = arma::randu(48, 2) + 0.5;
+  arma::mat error = arma::randu(18, 2);
+
+  LpPooling<> module(3, 3, 2, 2, 1, false);
+  module.InputWidth() = 6;
+  module.InputHeight() = 4;
+
+  arma::mat output, delta;
+  module.Forward(input, output);
+  REQUIRE(output.n_rows == 18);
+  module.Backward(input, error, delta);
+  REQUIRE(delta.n_rows == input.n_rows);
+  REQUIRE(delta.n_cols == input.n_cols);
+
+  const double perturbation = 1e-6;
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    arma::mat outputPlus, outputMinus;
+    input(i) += perturbation;
+    module.Forward(input, outputPlus);
+    input(i) -= 2 * perturbation;
+    module.Forward(input, outputMinus);
+    input(i) += perturbation;
+
+    const double estimate = arma::accu(error % (outputPlus - outputMinus)) /
+        (2 * perturbation);
+    REQUIRE(delta(i) == Approx(estimate).epsilon(1e-5));
+  }
+}
+
 /**
  * Simple test for Mean Pooling layer.
  */
@@ -4194,6 +4612,70 @@ TEST_CASE("MeanPoolingTestCase", "[ANNLayerTest]")
   REQUIRE(arma::accu(delta2) == 19.5);
 }
 
+/**
+ * Compare the max and mean pooling layers with a direct computation, with
+ * overlapping windows that are clipped at the border, and check that the
+ * backward pass of the mean pooling layer is the transpose of its forward pass.
+ */
+TEST_CASE("PoolingClippedWindowsTest", "[ANNLayerTest]")
+{
+  const size_t inputWidth = 8, inputHeight = 6, channels = 3;
+  const size_t kernelWidth = 3, kernelHeight = 3;
+  const size_t strideWidth = 2, strideHeight = 2;
+  const size_t outputWidth = 4, outputHeight = 3;
+  arma::mat input = arma::randn(inputWidth * inputHeight * channels, 2);
+
+  MaxPooling<> maxModule(kernelWidth, kernelHeight, strideWidth, strideHeight,
+      false);
+  MeanPooling<> meanModule(kernelWidth, kernelHeight, strideWidth,
+      strideHeight, false);
+  maxModule.InputWidth() = meanModule.InputWidth() = inputWidth;
+  maxModule.InputHeight() = meanModule.InputHeight() = inputHeight;
+
+  arma::mat maxOutput, meanOutput;
+  maxModule.Forward(input, maxOutput);
+  meanModule.Forward(input, meanOutput);
+  REQUIRE(maxOutput.n_rows == outputWidth * outputHeight * channels);
+  REQUIRE(meanOutput.n_rows == outputWidth * outputHeight * channels);
+
+  for (size_t s = 0; s < 2 * channels; ++s)
+  {
+    const arma::mat slice(input.memptr() + s * inputWidth * inputHeight,
+        inputWidth, inputHeight);
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const size_t rowEnd = std::min(i * strideWidth + kernelWidth,
+            inputWidth) - 1;
+        const size_t colEnd = std::min(j * strideHeight + kernelHeight,
+            inputHeight) - 1;
+        const arma::mat window = slice.submat(i * strideWidth,
+            j * strideHeight, rowEnd, colEnd);
+
+        const size_t index = s * outputWidth * outputHeight +
+            j * outputWidth + i;
+        REQUIRE(maxOutput(index) == Approx(window.max()).epsilon(1e-10));
+        REQUIRE(meanOutput(index) ==
+            Approx(arma::mean(arma::vectorise(window))).epsilon(1e-10));
+      }
+    }
+  }
+
+  // The max pooling layer sends the error to the maximum of each window.
+  arma::mat delta;
+  maxModule.Backward(input, maxOutput, delta);
+  REQUIRE(delta.n_rows == input.n_rows);
+  REQUIRE(arma::accu(delta) == Approx(arma::accu(maxOutput)).epsilon(1e-10));
+
+  // <Forward(x), e> == <x, Backward(e)> for the (linear) mean pooling layer.
+  arma::mat error = arma::randn(meanOutput.n_rows, meanOutput.n_cols);
+  meanModule.Backward(input, error, delta);
+  REQUIRE(delta.n_rows == input.n_rows);
+  REQUIRE(arma::accu(delta % input) ==
+      Approx(arma::accu(error % meanOutput)).epsilon(1e-10));
+}
+
 /**
  * Simple test for Max Pooling layer.
  */
@@ -5267,6 +5749,82 @@ TEST_CASE("SimpleMultiheadAttentionTest", "[ANNLayerTest]")
   REQUIRE(gradient.n_cols == module.Parameters().n_cols);
 }
 
+/**
+ * Test the output of the MultiheadAttention module against a direct
+ * per-head implementation of attention.
+ */
+TEST_CASE("MultiheadAttentionReferenceTest", "[ANNLayerTest]")
+{
+  const size_t tgtSeqLen = 3;
+  const size_t srcSeqLen = 4;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t headDim = embedDim / numHeads;
+
+  arma::mat query = arma::randu(embedDim, tgtSeqLen);
+  arma::mat key = arma::randu(embedDim, srcSeqLen);
+  arma::mat value = arma::randu(embedDim, srcSeqLen);
+  arma::mat attnMask = arma::randu(tgtSeqLen, srcSeqLen);
+  arma::mat keyPaddingMask = arma::randu(1, srcSeqLen);
+
+  MultiheadAttention<> module(tgtSeqLen, srcSeqLen, embedDim, numHeads);
+  module.AttentionMask() = attnMask;
+  module.KeyPaddingMask() = keyPaddingMask;
+  module.Reset();
+  module.Parameters().randu();
+
+  arma::mat input = arma::join_cols(arma::join_cols(arma::vectorise(query),
+      arma::vectorise(key)), arma::vectorise(value));
+  arma::mat output;
+  module.Forward(input, output);
+
+  // Compute the attention of each head directly.
+  const arma::mat& w = module.Parameters();
+  const size_t wtSize = embedDim * embedDim;
+  const arma::mat queryWt = arma::reshape(w.rows(0, wtSize - 1), embedDim,
+      embedDim);
+  const arma::mat keyWt = arma::reshape(w.rows(wtSize, 2 * wtSize - 1),
+      embedDim, embedDim);
+  const arma::mat valueWt = arma::reshape(w.rows(2 * wtSize, 3 * wtSize - 1),
+      embedDim, embedDim);
+  const arma::mat outWt = arma::reshape(w.rows(3 * wtSize, 4 * wtSize - 1),
+      embedDim, embedDim);
+  const arma::mat qBias = w.rows(4 * wtSize, 4 * wtSize + embedDim - 1);
+  const arma::mat kBias = w.rows(4 * wtSize + embedDim,
+      4 * wtSize + 2 * embedDim - 1);
+  const arma::mat vBias = w.rows(4 * wtSize + 2 * embedDim,
+      4 * wtSize + 3 * embedDim - 1);
+  const arma::mat outBias = w.rows(4 * wtSize + 3 * embedDim,
+      4 * wtSize + 4 * embedDim - 1);
+
+  arma::mat q = arma::trans(queryWt * query +
+      arma::repmat(qBias, 1, tgtSeqLen)) / std::sqrt(headDim);
+  arma::mat k = arma::trans(keyWt * key + arma::repmat(kBias, 1, srcSeqLen));
+  arma::mat v = arma::trans(valueWt * value +
+      arma::repmat(vBias, 1, srcSeqLen));
+
+  arma::mat attnOut(tgtSeqLen, embedDim);
+  for (size_t h = 0; h < numHeads; ++h)
+  {
+    const arma::span cols(h * headDim, (h + 1) * headDim - 1);
+    arma::mat scores = q.cols(cols) * arma::trans(k.cols(cols)) + attnMask +
+        arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+
+    // The softmax is taken over each column, like the Softmax layer.
+    scores = arma::exp(scores);
+    scores /= arma::repmat(arma::sum(scores, 0), tgtSeqLen, 1);
+    attnOut.cols(cols) = scores * v.cols(cols);
+  }
+
+  arma::mat expected = arma::vectorise(arma::trans(attnOut * outWt +
+      arma::repmat(arma::trans(outBias), tgtSeqLen, 1)));
+
+  REQUIRE(output.n_rows == expected.n_rows);
+  REQUIRE(output.n_cols == 1);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    REQUIRE(output[i] == Approx(expected[i]).epsilon(1e-7));
+}
+
 /**
  * Jacobian MultiheadAttention module test.
  */
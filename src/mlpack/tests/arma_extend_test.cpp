@@ -225,3 +225,55 @@ TEST_CASE("SpRowColIteratorTest", "[ArmaExtendTest]")
 
   REQUIRE(count == 1);
 }
+
+/**
+ * Make sure that the huge page allocator aligns all allocations, and maps the
+ * large ones (on Linux), in each mode.
+ */
+TEST_CASE("HugePageAllocatorTest", "[ArmaExtendTest]")
+{
+  typedef util::HugePageAllocator Allocator;
+  const Allocator::HugePageMode oldMode = Allocator::Mode();
+  const size_t oldThreshold = Allocator::Threshold();
+  Allocator::SetThreshold(1 << 20);
+
+  const Allocator::HugePageMode modes[] = { Allocator::NO_HUGE_PAGES,
+      Allocator::TRANSPARENT_HUGE_PAGES, Allocator::HUGE_PAGES_2MB,
+      Allocator::HUGE_PAGES_1GB };
+  for (const Allocator::HugePageMode mode : modes)
+  {
+    Allocator::SetMode(mode);
+    REQUIRE(Allocator::Mode() == mode);
+    const size_t mapped = Allocator::MappedBytes();
+
+    // A large allocation.  (If there are no free explicit huge pages,
+    // transparent huge pages are used instead.)
+    const size_t bytes = 3 << 20;
+    char* large = (char*) Allocator::Allocate(bytes);
+    REQUIRE(large != NULL);
+    REQUIRE((size_t) large % Allocator::Alignment == 0);
+    std::fill(large, large + bytes, 1);
+    REQUIRE(std::count(large, large + bytes, 1) == (std::ptrdiff_t) bytes);
+
+    #ifdef __linux__
+    if (mode == Allocator::NO_HUGE_PAGES)
+      REQUIRE(Allocator::MappedBytes() == mapped);
+    else
+      REQUIRE(Allocator::MappedBytes() >= mapped + bytes);
+    #endif
+
+    // A small allocation is only aligned.
+    char* small = (char*) Allocator::Allocate(1000);
+    REQUIRE(small != NULL);
+    REQUIRE((size_t) small % Allocator::Alignment == 0);
+    REQUIRE(Allocator::MappedBytes() >= mapped);
+
+    Allocator::Free(small);
+    Allocator::Free(large);
+    REQUIRE(Allocator::MappedBytes() == mapped);
+  }
+
+  Allocator::Free(NULL);
+  Allocator::SetMode(oldMode);
+  Allocator::SetThreshold(oldThreshold);
+}
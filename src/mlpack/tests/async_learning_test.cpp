@@ -25,6 +25,7 @@
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -247,3 +248,96 @@ TEST_CASE("NStepQLearningTest", "[AsyncLearningTest]")
   agent.Train(measure);
   Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
 }
+
+// Make sure that the sharded updates apply the step of each worker to the
+// shared parameters, like the lock-free updates.
+TEST_CASE("ParameterShardsUpdateTest", "[AsyncLearningTest]")
+{
+  arma::mat shared(10, 1, arma::fill::randu);
+  arma::mat local = shared;
+  const arma::mat step(10, 1, arma::fill::randu);
+  auto update = [&step](arma::mat& parameters) { parameters -= step; };
+
+  // Lock-free updates apply the step directly.
+  arma::mat expected = shared - step;
+  ParameterShards::Update(NULL, shared, local, update);
+  CheckMatrices(shared, expected);
+  CheckMatrices(local, expected);
+
+  // With more shards than parameters, some shards are empty.
+  for (size_t numShards : { 1, 3, 4, 20 })
+  {
+    ParameterShards shards(shared.n_elem, numShards);
+    REQUIRE(shards.Begin(0) == 0);
+    REQUIRE(shards.End(numShards - 1) == shared.n_elem);
+
+    // Another worker has changed the shared parameters since the last sync of
+    // the local parameters; its change must not be lost.
+    local = shared;
+    shared += 1.0;
+    expected = shared - step;
+    ParameterShards::Update(&shards, shared, local, update);
+    CheckMatrices(shared, expected);
+    CheckMatrices(local, expected);
+  }
+}
+
+// Test async n step q-learning in Cart Pole with sharded updates.
+TEST_CASE("NStepQLearningShardedTest", "[AsyncLearningTest]")
+{
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(1);
+  #endif
+
+  // Set up the network.
+  FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+      GaussianInitialization(0, 0.001));
+  model.Add<Linear<>>(4, 20);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(20, 20);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(20, 2);
+
+  // Set up the policy.
+  using Policy = GreedyPolicy<CartPole>;
+  AggregatedPolicy<Policy> policy({Policy(0.7, 5000, 0.1),
+                                   Policy(0.7, 5000, 0.01),
+                                   Policy(0.7, 5000, 0.5)},
+                                  arma::colvec("0.4 0.3 0.3"));
+
+  TrainingConfig config;
+  config.StepSize() = 0.0001;
+  config.Discount() = 0.99;
+  config.NumWorkers() = 16;
+  config.UpdateInterval() = 6;
+  config.StepLimit() = 200;
+  config.TargetNetworkSyncInterval() = 200;
+  config.NumParameterShards() = 4;
+
+  NStepQLearning<
+      CartPole, decltype(model), ens::VanillaUpdate, decltype(policy)>
+      agent(std::move(config), std::move(model), std::move(policy));
+
+  arma::vec rewards(20, arma::fill::zeros);
+  size_t pos = 0;
+  size_t testEpisodes = 0;
+  auto measure = [&rewards, &pos, &testEpisodes](double reward)
+  {
+    size_t maxEpisode = 100000;
+    if (testEpisodes > maxEpisode)
+      REQUIRE(false);
+    testEpisodes++;
+    rewards[pos++] = reward;
+    pos %= rewards.n_elem;
+    // Maybe underestimated.
+    double avgReward = arma::mean(rewards);
+    Log::Debug << "Average return: " << avgReward
+               << " Episode return: " << reward << std::endl;
+    if (avgReward > 60)
+      return true;
+    return false;
+  };
+
+  agent.Train(measure);
+  Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
+}
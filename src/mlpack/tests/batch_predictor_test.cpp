@@ -0,0 +1,84 @@
+/**
+ * @file tests/batch_predictor_test.cpp
+ *
+ * Tests for the BatchPredictor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/batch_predictor.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+
+/**
+ * Make sure that the requests sent to a BatchPredictor get the same results as
+ * the batch method of the model, and that they are batched.
+ */
+TEST_CASE("BatchPredictorRandomForestTest", "[BatchPredictorTest]")
+{
+  arma::mat dataset(5, 500, arma::fill::randu);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0;
+
+  RandomForest<> rf(dataset, labels, 2, 10);
+  arma::Row<size_t> predictions;
+  rf.Classify(dataset, predictions);
+
+  std::vector<std::future<arma::Row<size_t>>> results;
+  {
+    BatchPredictor<arma::Row<size_t>> predictor(
+        [&rf](const arma::mat& points, arma::Row<size_t>& batchPredictions)
+        {
+          rf.Classify(points, batchPredictions);
+        }, 64, 0.01);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      results.push_back(predictor.Predict(dataset.col(i)));
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      const arma::Row<size_t> result = results[i].get();
+      REQUIRE(result.n_elem == 1);
+      REQUIRE(result[0] == predictions[i]);
+    }
+
+    const BatchPredictorStats stats = predictor.Stats();
+    REQUIRE(stats.requests == dataset.n_cols);
+    REQUIRE(stats.batches < dataset.n_cols);
+    REQUIRE(stats.meanBatchSize > 1.0);
+    REQUIRE(stats.meanLatency <= stats.maxLatency);
+
+    predictor.ResetStats();
+    REQUIRE(predictor.Stats().requests == 0);
+  }
+}
+
+/**
+ * Make sure that the errors of a batch are given to the futures of its
+ * requests.
+ */
+TEST_CASE("BatchPredictorErrorTest", "[BatchPredictorTest]")
+{
+  BatchPredictor<> predictor([](const arma::mat& points, arma::mat& results)
+      {
+        if (points.n_rows != 3)
+          throw std::invalid_argument("wrong dimensionality");
+        results = 2 * points;
+      }, 16, 0.001);
+
+  std::future<arma::mat> good = predictor.Predict(arma::vec("1 2 3"));
+  REQUIRE(arma::approx_equal(good.get(), arma::mat("2; 4; 6"), "absdiff",
+      1e-10));
+
+  std::future<arma::mat> bad = predictor.Predict(arma::vec("1 2"));
+  REQUIRE_THROWS_AS(bad.get(), std::invalid_argument);
+}
@@ -193,3 +193,36 @@ TEST_CASE("EqualtoRidge", "[BayesianLinearRegressionTest]")
 
   REQUIRE(trial <= 3);
 }
+
+// Check that training with PartialFit() on chunks of the data, or on sparse
+// data, gives the same model as training on all of the data.
+TEST_CASE("BayesianLinearRegressionPartialFitTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+
+  GenerateProblem(matX, y, 600, 8, 0.5);
+
+  BayesianLinearRegression estimator(true, true);
+  estimator.Train(matX, y);
+
+  BayesianLinearRegression chunked(true, true);
+  chunked.Train(matX.cols(0, 199), y.subvec(0, 199));
+  chunked.PartialFit(matX.cols(200, 599), y.subvec(200, 599));
+
+  REQUIRE(chunked.Alpha() == Approx(estimator.Alpha()).epsilon(1e-6));
+  REQUIRE(chunked.Beta() == Approx(estimator.Beta()).epsilon(1e-6));
+  for (size_t i = 0; i < estimator.Omega().n_elem; ++i)
+    REQUIRE(chunked.Omega()[i] == Approx(estimator.Omega()[i]).epsilon(1e-6));
+
+  const arma::sp_mat sparseX(matX);
+  BayesianLinearRegression sparse(true, true);
+  sparse.Train(sparseX, y);
+
+  arma::rowvec predictions, sparsePredictions;
+  estimator.Predict(matX, predictions);
+  sparse.Predict(sparseX, sparsePredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(sparsePredictions[i] == Approx(predictions[i]).epsilon(1e-6));
+}
@@ -375,3 +375,53 @@ TEST_CASE("BiasSVDFunctionParallelOptimize", "[BiasSVDTest]")
 }
 
 #endif
+
+/**
+ * Make sure that RatingBlocks puts every rating in exactly one block, and that
+ * the blocks of a stratum share no user or item.
+ */
+TEST_CASE("RatingBlocksStrataTest", "[BiasSVDTest]")
+{
+  const size_t numUsers = 60;
+  const size_t numItems = 40;
+  const size_t numRatings = 2000;
+
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  RatingBlocks blocks(data, numUsers, numItems, 4);
+  blocks.Shuffle();
+  REQUIRE(blocks.NumBlocks() == 4);
+
+  arma::Col<size_t> seen(numRatings, arma::fill::zeros);
+  for (size_t s = 0; s < blocks.NumBlocks(); ++s)
+  {
+    arma::Col<size_t> userBlock(numUsers);
+    arma::Col<size_t> itemBlock(numItems);
+    userBlock.fill(blocks.NumBlocks());
+    itemBlock.fill(blocks.NumBlocks());
+    for (size_t b = 0; b < blocks.NumBlocks(); ++b)
+    {
+      const size_t i = blocks.ItemBlock(b, s);
+      for (size_t j = blocks.Begin(b, i); j < blocks.End(b, i); ++j)
+      {
+        const size_t example = blocks.Rating(j);
+        const size_t user = data(0, example);
+        const size_t item = data(1, example);
+        ++seen[example];
+
+        // No other block of the stratum may hold this user or item.
+        REQUIRE((userBlock[user] == blocks.NumBlocks() ||
+            userBlock[user] == b));
+        REQUIRE((itemBlock[item] == blocks.NumBlocks() ||
+            itemBlock[item] == b));
+        userBlock[user] = b;
+        itemBlock[item] = b;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < numRatings; ++i)
+    REQUIRE(seen[i] == 1);
+}
@@ -106,3 +106,39 @@ TEST_CASE("RandomizedBlockKrylovSVDNoisyLowRankTest", "[BlockKrylovSVDTest]")
   double error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
   REQUIRE(error == Approx(0.0).margin(1e-4));
 }
+
+/**
+ * The randomized block krylov SVD of sparse data, centered implicitly, should
+ * be the SVD of the centered data.
+ */
+TEST_CASE("RandomizedBlockKrylovSVDSparseTest", "[BlockKrylovSVDTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(40, 400, 0.05);
+  const arma::mat denseData(data);
+
+  arma::mat centeredData;
+  math::Center(denseData, centeredData);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  // The Krylov subspace spans the whole space, so the decomposition is exact.
+  svd::RandomizedBlockKrylovSVD rSVD(2, 20);
+  rSVD.Apply(data, U2, s2, V2, 20, arma::mat(arma::mean(denseData, 1)));
+
+  for (size_t i = 0; i < 20; ++i)
+    REQUIRE(s2[i] == Approx(s1[i]).epsilon(1e-7));
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  double error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-7));
+
+  // Without a mean the data is not centered.
+  rSVD.Apply(data, U2, s2, V2, 20);
+  arma::svd_econ(U1, s1, V1, denseData);
+  REQUIRE(s2[0] == Approx(s1[0]).epsilon(1e-7));
+}
@@ -13,6 +13,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/cf/cf.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/batch_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/randomized_svd_method.hpp>
@@ -686,6 +687,15 @@ TEST_CASE("RecommendationAccuracyNMFTest", "[CFTest]")
   RecommendationAccuracy<NMFPolicy>();
 }
 
+/**
+ * Make sure recommendations that are generated are reasonably accurate
+ * for ALS.
+ */
+TEST_CASE("RecommendationAccuracyALSTest", "[CFTest]")
+{
+  RecommendationAccuracy<ALSPolicy>();
+}
+
 /**
  * Make sure recommendations that are generated are reasonably accurate
  * for SVD Complete Incremental method.
@@ -750,6 +760,12 @@ TEST_CASE("CFPredictNMFTest", "[CFTest]")
   CFPredict<NMFPolicy>();
 }
 
+// Make sure that Predict() is returning reasonable results for ALS.
+TEST_CASE("CFPredictALSTest", "[CFTest]")
+{
+  CFPredict<ALSPolicy>();
+}
+
 /**
  * Make sure that Predict() is returning reasonable results for SVD Complete
  * Incremental method.
@@ -996,6 +1012,14 @@ TEST_CASE("SerializationNMFTest", "[CFTest]")
   Serialization<NMFPolicy>();
 }
 
+/**
+ * Ensure we can load and save the CF model using ALS policy.
+ */
+TEST_CASE("SerializationALSTest", "[CFTest]")
+{
+  Serialization<ALSPolicy>();
+}
+
 /**
  * Ensure we can load and save the CF model using SVD Complete Incremental.
  */
@@ -1225,3 +1249,299 @@ TEST_CASE("CFPredictRegressionInterpolation", "[CFTest]")
             EuclideanSearch,
             RegressionInterpolation>(2.0);
 }
+
+/**
+ * Make sure that the conjugate gradient variant of ALS, with as many
+ * iterations as the rank, gives the same factorization as direct solves, for
+ * both explicit and implicit feedback.
+ */
+TEST_CASE("ALSConjugateGradientTest", "[CFTest]")
+{
+  arma::sp_mat ratings;
+  ratings.sprandu(80, 60, 0.2);
+  ratings *= 5.0;
+
+  for (const bool implicit : { false, true })
+  {
+    ALSPolicy direct(0.1, implicit, 2.0);
+    math::RandomSeed(1);
+    direct.Apply(arma::mat(), ratings, 4, 5, 0.0, true);
+
+    ALSPolicy cg(0.1, implicit, 2.0, 4);
+    math::RandomSeed(1);
+    cg.Apply(arma::mat(), ratings, 4, 5, 0.0, true);
+
+    const arma::mat directRatings = direct.W() * direct.H();
+    const arma::mat cgRatings = cg.W() * cg.H();
+    REQUIRE(arma::approx_equal(directRatings, cgRatings, "absdiff", 1e-5));
+  }
+}
+
+/**
+ * Make sure that implicit ALS predicts higher preferences for the observed
+ * ratings than for the missing ones.
+ */
+TEST_CASE("ALSImplicitTest", "[CFTest]")
+{
+  // Two groups of users, each interacting with its own group of items.
+  arma::sp_mat ratings(40, 30);
+  for (size_t u = 0; u < 30; ++u)
+  {
+    for (size_t i = 0; i < 40; ++i)
+    {
+      if ((i < 20) == (u < 15) && (i + u) % 3 != 0)
+        ratings(i, u) = 1.0 + (i + u) % 4;
+    }
+  }
+
+  ALSPolicy als(0.1, true, 10.0);
+  als.Apply(arma::mat(), ratings, 2, 20, 1e-8, false);
+
+  for (size_t u = 0; u < 30; ++u)
+  {
+    arma::vec preferences;
+    als.GetRatingOfUser(u, preferences);
+    const double inGroup = arma::mean(u < 15 ? preferences.subvec(0, 19) :
+        preferences.subvec(20, 39));
+    const double outGroup = arma::mean(u < 15 ? preferences.subvec(20, 39) :
+        preferences.subvec(0, 19));
+    REQUIRE(inGroup > 0.5);
+    REQUIRE(outGroup < 0.2);
+  }
+}
+
+/**
+ * Make sure that the recommendations are the top-rated unrated items for each
+ * user, when the users span several batches.
+ */
+template<typename DecompositionPolicy>
+void BatchedRecommendations()
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  DecompositionPolicy decomposition;
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  // Query each of the 200 users three times, so that the 600 queries span
+  // several batches.
+  arma::Col<size_t> users(600);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    users(i) = (i * 7) % 200;
+
+  const size_t numRecs = 10;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+  REQUIRE(recommendations.n_rows == numRecs);
+  REQUIRE(recommendations.n_cols == users.n_elem);
+
+  // Check a few queries from each batch against Predict().
+  for (size_t i = 0; i < users.n_elem; i += 37)
+  {
+    const size_t user = users(i);
+    arma::vec predictions(c.CleanedData().n_rows);
+    for (size_t item = 0; item < predictions.n_elem; ++item)
+      predictions[item] = c.Predict(user, item);
+
+    double lowest = DBL_MAX;
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      const size_t item = recommendations(j, i);
+      REQUIRE((double) c.CleanedData()(item, user) == 0.0);
+      REQUIRE(predictions[item] <= lowest + 1e-8);
+      lowest = std::min(lowest, predictions[item]);
+    }
+
+    // No other unrated item may be rated higher than the recommendations.
+    for (size_t item = 0; item < predictions.n_elem; ++item)
+    {
+      if ((double) c.CleanedData()(item, user) != 0.0 ||
+          arma::any(recommendations.col(i) == item))
+        continue;
+
+      REQUIRE(predictions[item] <= lowest + 1e-8);
+    }
+  }
+}
+
+/**
+ * Check the batched recommendations of a policy that rates batches of users
+ * at once.
+ */
+TEST_CASE("CFBatchedRecommendationsNMFTest", "[CFTest]")
+{
+  BatchedRecommendations<NMFPolicy>();
+}
+
+/**
+ * Check the batched recommendations of a policy that rates one user at a time.
+ */
+TEST_CASE("CFBatchedRecommendationsSVDPPTest", "[CFTest]")
+{
+  BatchedRecommendations<SVDPlusPlusPolicy>();
+}
+
+/**
+ * Make sure that the recommendations found with the item index are the same
+ * as the ones found by rating every item.
+ */
+TEST_CASE("CFItemIndexRecommendationsTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<NMFPolicy> c(dataset, NMFPolicy(), 5, 5, 30);
+  arma::Mat<size_t> scanned;
+  c.GetRecommendations(10, scanned);
+
+  REQUIRE(!c.HasItemIndex());
+  CFType<NMFPolicy> indexed(c);
+  indexed.BuildItemIndex();
+  REQUIRE(indexed.HasItemIndex());
+
+  arma::Mat<size_t> recommendations;
+  indexed.GetRecommendations(10, recommendations);
+  REQUIRE(recommendations.n_rows == scanned.n_rows);
+  REQUIRE(recommendations.n_cols == scanned.n_cols);
+
+  // The items may only come out in a different order where the predicted
+  // ratings are tied.
+  for (size_t i = 0; i < scanned.n_cols; ++i)
+  {
+    for (size_t j = 0; j < scanned.n_rows; ++j)
+    {
+      REQUIRE((double) c.CleanedData()(recommendations(j, i), i) == 0.0);
+      REQUIRE(indexed.Predict(i, recommendations(j, i)) ==
+          Approx(c.Predict(i, scanned(j, i))).epsilon(1e-7));
+    }
+  }
+
+  // Training again discards the index.
+  indexed.Train(dataset, NMFPolicy(), 30);
+  REQUIRE(!indexed.HasItemIndex());
+}
+
+/**
+ * Make sure that folding in the ratings of a new user gives it the least
+ * squares factors for those ratings.
+ */
+TEST_CASE("CFFoldInUsersTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<NMFPolicy> c(dataset, NMFPolicy(), 5, 5, 30);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const size_t numItems = c.CleanedData().n_rows;
+  const arma::mat w = c.Decomposition().W();
+  const arma::mat h = c.Decomposition().H();
+
+  // The new user has the ratings of user 0.
+  arma::mat newRatings = dataset.cols(arma::find(dataset.row(0) == 0));
+  newRatings.row(0).fill(numUsers);
+  c.FoldInUsers(newRatings);
+
+  REQUIRE(c.CleanedData().n_cols == numUsers + 1);
+  REQUIRE(c.CleanedData().n_rows == numItems);
+  REQUIRE(c.Decomposition().H().n_cols == numUsers + 1);
+
+  // The other factors are unchanged.
+  CheckMatrices(c.Decomposition().W(), w);
+  CheckMatrices(c.Decomposition().H().cols(0, numUsers - 1), h);
+
+  // The new factors fit the ratings at least as well as the ones of user 0.
+  double newError = 0.0, oldError = 0.0;
+  for (size_t i = 0; i < newRatings.n_cols; ++i)
+  {
+    const size_t item = newRatings(1, i);
+    REQUIRE((double) c.CleanedData()(item, numUsers) == newRatings(2, i));
+    newError += std::pow(newRatings(2, i) - arma::dot(w.row(item),
+        c.Decomposition().H().col(numUsers)), 2.0);
+    oldError += std::pow(newRatings(2, i) - arma::dot(w.row(item),
+        h.col(0)), 2.0);
+  }
+  REQUIRE(newError <= oldError + 1e-8);
+
+  // The new user can be given recommendations.
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(5, recommendations, arma::Col<size_t>({ numUsers }));
+  REQUIRE(recommendations.n_rows == 5);
+  for (size_t j = 0; j < 5; ++j)
+    REQUIRE((double) c.CleanedData()(recommendations(j, 0), numUsers) == 0.0);
+}
+
+/**
+ * Make sure that folding in the ratings of a new item gives it the least
+ * squares factors for those ratings.
+ */
+TEST_CASE("CFFoldInItemsTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<NMFPolicy, UserMeanNormalization> c(dataset, NMFPolicy(), 5, 5, 30);
+  const size_t numItems = c.CleanedData().n_rows;
+  const arma::mat w = c.Decomposition().W();
+  const arma::mat h = c.Decomposition().H();
+
+  // The new item has the ratings of item 0.
+  const size_t item = dataset(1, 0);
+  arma::mat newRatings = dataset.cols(arma::find(dataset.row(1) == item));
+  newRatings.row(1).fill(numItems);
+  c.FoldInItems(newRatings, 0.01);
+
+  REQUIRE(c.CleanedData().n_rows == numItems + 1);
+  REQUIRE(c.Decomposition().W().n_rows == numItems + 1);
+  CheckMatrices(c.Decomposition().W().rows(0, numItems - 1), w);
+  CheckMatrices(c.Decomposition().H(), h);
+
+  // The ratings are normalized with the means of the known users, so the new
+  // item gets the normalized ratings of the old one.
+  for (size_t i = 0; i < newRatings.n_cols; ++i)
+  {
+    const size_t user = newRatings(0, i);
+    REQUIRE((double) c.CleanedData()(numItems, user) ==
+        Approx((double) c.CleanedData()(item, user)));
+  }
+}
+
+/**
+ * Make sure that the user and item mean normalizations compute the means of
+ * new users and items only when folding in.
+ */
+TEST_CASE("CFFoldInNormalizationTest", "[CFTest]")
+{
+  arma::mat data = { { 0, 0, 1, 1 },
+                     { 0, 1, 0, 1 },
+                     { 1, 3, 2, 4 } };
+  arma::mat newData = { { 1, 2, 2 },
+                        { 2, 0, 1 },
+                        { 5, 1, 2 } };
+
+  UserMeanNormalization userMean;
+  userMean.Normalize(data);
+  arma::mat userData(newData);
+  userMean.FoldIn(userData);
+  REQUIRE(userMean.Mean().n_elem == 3);
+  REQUIRE(userMean.Mean()(1) == Approx(3.0));
+  REQUIRE(userMean.Mean()(2) == Approx(1.5));
+  REQUIRE(userData(2, 0) == Approx(2.0));
+  REQUIRE(userData(2, 1) == Approx(-0.5));
+
+  data = { { 0, 0, 1, 1 },
+           { 0, 1, 0, 1 },
+           { 1, 3, 2, 4 } };
+  ItemMeanNormalization itemMean;
+  itemMean.Normalize(data);
+  arma::mat itemData(newData);
+  itemMean.FoldIn(itemData);
+  REQUIRE(itemMean.Mean().n_elem == 3);
+  REQUIRE(itemMean.Mean()(0) == Approx(1.5));
+  REQUIRE(itemMean.Mean()(2) == Approx(5.0));
+  REQUIRE(itemData(2, 1) == Approx(-0.5));
+  REQUIRE(itemData(2, 2) == Approx(-1.5));
+}
@@ -13,9 +13,11 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
+#include <mlpack/methods/ann/convolution_rules/cached_fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "serialization.hpp"
 #include "catch.hpp"
@@ -148,6 +150,14 @@ TEST_CASE("ValidConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through a matrix multiplication (im2col).
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input,
+      filter, output);
+
+  // Perform the convolution through fft with the spectrum of the filter.
+  Convolution2DMethodTest<CachedFFTConvolution<ValidConvolution> >(input,
+      filter, output);
 }
 
 /**
@@ -185,6 +195,14 @@ TEST_CASE("FullConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through a matrix multiplication (im2col).
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input,
+      filter, output);
+
+  // Perform the convolution through fft with the spectrum of the filter.
+  Convolution2DMethodTest<CachedFFTConvolution<FullConvolution> >(input,
+      filter, output);
 }
 
 /**
@@ -230,6 +248,10 @@ TEST_CASE("ValidConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through a matrix multiplication (im2col).
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -279,6 +301,10 @@ TEST_CASE("FullConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through a matrix multiplication (im2col).
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -321,6 +347,10 @@ TEST_CASE("ValidConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through a matrix multiplication (im2col).
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -367,4 +397,8 @@ TEST_CASE("FullConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through a matrix multiplication (im2col).
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
 }
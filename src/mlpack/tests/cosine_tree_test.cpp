@@ -218,6 +218,39 @@ TEST_CASE("CosineTreeModifiedGramSchmidt", "[CosineTreeTest]")
   }
 }
 
+/**
+ * Check that CosineTree::GramSchmidt() keeps the basis orthonormal even when
+ * the centroids are almost parallel.
+ */
+TEST_CASE("CosineTreeGramSchmidtIllConditioned", "[CosineTreeTest]")
+{
+  const size_t numRows = 100;
+  const size_t numCols = 20;
+
+  arma::mat data = arma::randu(numRows, numCols);
+  CosineTree dummyTree(data, 1, 0.1);
+
+  // All the centroids are one vector plus a tiny perturbation.
+  arma::vec direction = arma::randu(numRows);
+  arma::mat basis(numRows, numCols, arma::fill::zeros);
+  for (size_t i = 0; i < numCols; ++i)
+  {
+    arma::vec centroid = direction + 1e-7 * arma::randu(numRows);
+    arma::vec newBasisVector;
+    dummyTree.GramSchmidt(basis, centroid, newBasisVector);
+    basis.col(i) = newBasisVector;
+  }
+
+  const arma::mat gram = basis.t() * basis;
+  for (size_t i = 0; i < numCols; ++i)
+  {
+    for (size_t j = 0; j < numCols; ++j)
+    {
+      REQUIRE(gram(i, j) == Approx((i == j) ? 1.0 : 0.0).margin(1e-8));
+    }
+  }
+}
+
 /**
  * Test the copy constructor & copy assignment using Cosine trees.
  */
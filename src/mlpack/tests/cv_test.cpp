@@ -345,6 +345,20 @@ TEST_CASE("TakesNumClassesTest", "[CVTest]")
       "Value should be false");
 }
 
+/**
+ * Test MetaInfoExtractor correctly recognizes the type of the parameters of a
+ * given machine learning algorithm.
+ */
+TEST_CASE("ParametersTypeTest", "[CVTest]")
+{
+  static_assert(std::is_same<MetaInfoExtractor<LogisticRegression<>>::
+      ParametersType, arma::rowvec>::value, "Value should be true");
+  static_assert(std::is_same<MetaInfoExtractor<SoftmaxRegression>::
+      ParametersType, arma::mat>::value, "Value should be true");
+  static_assert(std::is_same<MetaInfoExtractor<LARS>::ParametersType,
+      void*>::value, "Value should be true");
+}
+
 /**
  * Test the simple cross-validation strategy implementation with the Accuracy
  * metric.
@@ -765,6 +779,140 @@ TEST_CASE("KFoldCVWithDTTestUnevenBinsWeighted", "[CVTest]")
   REQUIRE(accuracy > 0.7);
 }
 
+/**
+ * With uneven bins, the parallel folds should give the same score as training
+ * and evaluating each fold by hand.
+ */
+TEST_CASE("KFoldCVParallelFoldsTest", "[CVTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 22);
+  arma::rowvec responses = arma::randu<arma::rowvec>(22);
+  const size_t k = 4;
+
+  KFoldCV<LinearRegression, MSE> cv(k, data, responses, false);
+  const double score = cv.Evaluate(0.1);
+
+  // The last bin holds the remaining points.
+  const size_t binSize = 22 / k;
+  double expectedScore = 0.0;
+  for (size_t i = 0; i < k; ++i)
+  {
+    const size_t begin = (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
+    const size_t end = (i == 0) ? 22 : begin + binSize;
+    arma::uvec training(22 - (end - begin));
+    for (size_t j = 0, t = 0; j < 22; ++j)
+    {
+      if (j < begin || j >= end)
+        training[t++] = j;
+    }
+
+    const arma::mat trainingData = data.cols(training);
+    const arma::rowvec trainingResponses = responses.cols(training);
+    const arma::mat validationData = data.cols(begin, end - 1);
+    const arma::rowvec validationResponses = responses.cols(begin, end - 1);
+
+    LinearRegression lr(trainingData, trainingResponses, 0.1);
+    expectedScore += MSE::Evaluate(lr, validationData, validationResponses) / k;
+  }
+
+  REQUIRE(score == Approx(expectedScore).epsilon(1e-7));
+}
+
+//! A metric that always throws.
+class ThrowingMetric
+{
+ public:
+  template<typename MLAlgorithm, typename DataType, typename ResponsesType>
+  static double Evaluate(MLAlgorithm& /* model */,
+                         const DataType& /* data */,
+                         const ResponsesType& /* responses */)
+  {
+    throw std::runtime_error("ThrowingMetric::Evaluate()");
+  }
+};
+
+/**
+ * An exception thrown while a fold runs should reach the caller.
+ */
+TEST_CASE("KFoldCVExceptionTest", "[CVTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 20);
+  arma::rowvec responses = arma::randu<arma::rowvec>(20);
+
+  KFoldCV<LinearRegression, ThrowingMetric> cv(5, data, responses);
+  REQUIRE_THROWS_AS(cv.Evaluate(), std::runtime_error);
+}
+
+/**
+ * Test that copies of SimpleCV and KFoldCV with a subset of the data give the
+ * same results as cross-validation on that subset.
+ */
+TEST_CASE("CVSubsetCopyTest", "[CVTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 40);
+  arma::rowvec responses = arma::randu<arma::rowvec>(40);
+
+  // A full copy gives the same results.
+  SimpleCV<LinearRegression, MSE> simpleCV(0.25, data, responses);
+  SimpleCV<LinearRegression, MSE> simpleCVCopy(simpleCV);
+  REQUIRE(simpleCVCopy.Evaluate(0.1) ==
+      Approx(simpleCV.Evaluate(0.1)).epsilon(1e-7));
+
+  // With half of the 30 training points, the validation set is the same.
+  SimpleCV<LinearRegression, MSE> simpleCVHalf(simpleCV, 0.5);
+  const arma::mat trainingData = data.cols(0, 14);
+  const arma::rowvec trainingResponses = responses.cols(0, 14);
+  const arma::mat validationData = data.cols(30, 39);
+  const arma::rowvec validationResponses = responses.cols(30, 39);
+  LinearRegression lr(trainingData, trainingResponses, 0.1);
+  REQUIRE(simpleCVHalf.Evaluate(0.1) == Approx(MSE::Evaluate(lr,
+      validationData, validationResponses)).epsilon(1e-7));
+
+  // Half of the data is split into four bins again.
+  using KFoldCVType = KFoldCV<LinearRegression, MSE>;
+  KFoldCVType kFoldCV(4, data, responses, false);
+  KFoldCVType kFoldCVHalf(kFoldCV, 0.5);
+  const arma::mat halfData = data.cols(0, 19);
+  const arma::rowvec halfResponses = responses.cols(0, 19);
+  KFoldCVType expectedCV(4, halfData, halfResponses, false);
+  REQUIRE(kFoldCVHalf.Evaluate(0.1) ==
+      Approx(expectedCV.Evaluate(0.1)).epsilon(1e-7));
+
+  // The subset is never smaller than the number of bins.
+  KFoldCVType kFoldCVSmall(kFoldCV, 0.01);
+  REQUIRE_NOTHROW(kFoldCVSmall.Evaluate(0.1));
+  REQUIRE_THROWS_AS(KFoldCVType(kFoldCV, 0.0), std::invalid_argument);
+}
+
+/**
+ * Test that warm-started training in SimpleCV and KFoldCV gives the same models
+ * as training from scratch.
+ */
+TEST_CASE("CVWarmStartTest", "[CVTest]")
+{
+  arma::mat data = arma::randn(3, 200);
+  arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      data.row(0) + 0.5 * data.row(1) + 0.5 * arma::randn(1, 200) > 0);
+
+  KFoldCV<LogisticRegression<>, Accuracy> kFoldCV(4, data, labels, false);
+  KFoldCV<LogisticRegression<>, Accuracy> coldKFoldCV(4, data, labels, false);
+  kFoldCV.WarmStart() = true;
+  kFoldCV.Evaluate(0.01);
+  coldKFoldCV.Evaluate(0.5);
+  kFoldCV.Evaluate(0.5);
+  REQUIRE(arma::approx_equal(kFoldCV.Model().Parameters(),
+      coldKFoldCV.Model().Parameters(), "absdiff", 1e-3));
+
+  SimpleCV<SoftmaxRegression, Accuracy> simpleCV(0.2, data, labels, 2);
+  SimpleCV<SoftmaxRegression, Accuracy> coldSimpleCV(0.2, data, labels, 2);
+  simpleCV.WarmStart() = true;
+  simpleCV.Evaluate(0.01);
+  coldSimpleCV.Evaluate(0.5);
+  simpleCV.Evaluate(0.5);
+  REQUIRE(arma::approx_equal(simpleCV.Model().Parameters(),
+      coldSimpleCV.Model().Parameters(), "absdiff", 1e-2));
+}
+
 /**
  * Test Silhouette Score
  */
@@ -779,3 +927,54 @@ TEST_CASE("SilhouetteScoreTest", "[CVTest]")
   double silhouetteScore = SilhouetteScore::Overall(X, labels, metric);
   REQUIRE(silhouetteScore == Approx(0.1121684822489150).epsilon(1e-7));
 }
+
+/**
+ * Make sure the blocked silhouette scores match the ones computed from the
+ * full distance matrix, for more points than one block.
+ */
+TEST_CASE("SilhouetteScoreBlockedTest", "[CVTest]")
+{
+  arma::mat X = arma::randu<arma::mat>(3, 700);
+  X.cols(0, 299) += 2.0;
+  arma::Row<size_t> labels(700);
+  labels.cols(0, 299).fill(3);
+  labels.cols(300, 499).fill(1);
+  labels.cols(500, 699).fill(7);
+
+  metric::EuclideanDistance euclidean;
+  arma::rowvec scores = SilhouetteScore::SamplesScore(X, labels, euclidean);
+  arma::rowvec expected = SilhouetteScore::SamplesScore(
+      PairwiseDistances(X, euclidean), labels);
+  REQUIRE(scores.n_elem == 700);
+  for (size_t i = 0; i < scores.n_elem; ++i)
+    REQUIRE(scores[i] == Approx(expected[i]).margin(1e-7));
+
+  metric::ManhattanDistance manhattan;
+  scores = SilhouetteScore::SamplesScore(X, labels, manhattan);
+  expected = SilhouetteScore::SamplesScore(PairwiseDistances(X, manhattan),
+      labels);
+  for (size_t i = 0; i < scores.n_elem; ++i)
+    REQUIRE(scores[i] == Approx(expected[i]).margin(1e-7));
+}
+
+/**
+ * Make sure the sampled silhouette score is exact when all the points are
+ * sampled, and close to the exact score otherwise.
+ */
+TEST_CASE("SilhouetteScoreSampledTest", "[CVTest]")
+{
+  arma::mat X = arma::randu<arma::mat>(2, 2000);
+  X.cols(0, 999) += 1.5;
+  arma::Row<size_t> labels(2000);
+  labels.cols(0, 999).fill(0);
+  labels.cols(1000, 1999).fill(1);
+
+  metric::EuclideanDistance metric;
+  const double overall = SilhouetteScore::Overall(X, labels, metric);
+  REQUIRE(SilhouetteScore::SampledOverall(X, labels, metric, 2000) ==
+      Approx(overall).epsilon(1e-10));
+
+  const double sampled = SilhouetteScore::SampledOverall(X, labels, metric,
+      500);
+  REQUIRE(sampled == Approx(overall).margin(0.05));
+}
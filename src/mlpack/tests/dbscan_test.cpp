@@ -306,3 +306,72 @@ TEST_CASE("RandomPointSelectionTest", "[DBSCANTest]")
   // The number of assignments returned should be the same as points.
   REQUIRE(assignments.n_elem == points.n_cols);
 }
+
+/**
+ * Check that a point within epsilon of two clusters, but without enough
+ * neighbors to be a core point itself, doesn't merge the clusters.
+ */
+TEST_CASE("BorderPointTest", "[DBSCANTest]")
+{
+  // Two clusters of four points, a border point between them, and noise.
+  arma::mat points("0.0 0.3 0.6 1.0 2.0 3.0 3.4 3.7 4.0 10.0");
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    DBSCAN<> d(1.0, 4, (mode == 0));
+
+    arma::Row<size_t> assignments;
+    const size_t clusters = d.Cluster(points, assignments);
+
+    REQUIRE(clusters == 2);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      REQUIRE(assignments[i] == 0);
+      REQUIRE(assignments[i + 5] == 1);
+    }
+
+    // The border point goes to the cluster of its lowest-index core neighbor.
+    REQUIRE(assignments[4] == 0);
+    REQUIRE(assignments[9] == SIZE_MAX);
+  }
+}
+
+/**
+ * Check that batch and pointwise clustering give the same clusters, with both
+ * dual-tree and (parallel) single-tree search, on more points than a block of
+ * the pointwise search.
+ */
+TEST_CASE("BatchPointwiseEquivalenceTest", "[DBSCANTest]")
+{
+  arma::mat points(3, 3000);
+
+  GaussianDistribution g1(3), g2(3), g3(3);
+  g1.Mean() = arma::vec("0.0 0.0 0.0");
+  g2.Mean() = arma::vec("6.0 6.0 8.0");
+  g3.Mean() = arma::vec("-6.0 1.0 -7.0");
+  for (size_t i = 0; i < 1000; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 1000; i < 2000; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 2000; i < 3000; ++i)
+    points.col(i) = g3.Random();
+
+  DBSCAN<> batch(0.3, 5);
+  arma::Row<size_t> batchAssignments;
+  const size_t batchClusters = batch.Cluster(points, batchAssignments);
+
+  for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+  {
+    for (size_t batchMode = 0; batchMode < 2; ++batchMode)
+    {
+      DBSCAN<> d(0.3, 5, (batchMode == 1),
+          RangeSearch<>(false, (singleMode == 1)));
+      arma::Row<size_t> assignments;
+      const size_t clusters = d.Cluster(points, assignments);
+
+      REQUIRE(clusters == batchClusters);
+      for (size_t i = 0; i < points.n_cols; ++i)
+        REQUIRE(assignments[i] == batchAssignments[i]);
+    }
+  }
+}
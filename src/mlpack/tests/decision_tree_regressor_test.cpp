@@ -11,6 +11,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/decision_tree/decision_tree_regressor.hpp>
+#include <mlpack/methods/decision_tree/binned_binary_numeric_split.hpp>
+#include <mlpack/methods/decision_tree/binary_categorical_split.hpp>
 #include <mlpack/methods/decision_tree/mad_gain.hpp>
 #include <mlpack/methods/decision_tree/mse_gain.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
@@ -1100,3 +1102,59 @@ TEST_CASE("WeightedDecisionTreeMADGainTest", "[DecisionTreeRegressorTest]")
   double rmse = RMSE(predictions, testResponses);
   REQUIRE(rmse < 6.5);
 }
+
+/**
+ * Make sure a regression tree with binned numeric splits fits a piecewise
+ * function, with both MSE gain and MAD gain.
+ */
+TEST_CASE("BinnedNumericSplitRegressorTest", "[DecisionTreeRegressorTest]")
+{
+  arma::mat data(2, 3000, arma::fill::randu);
+  arma::rowvec responses = arma::floor(4 * data.row(0)) + 0.5 * data.row(1);
+  arma::mat testData(2, 1000, arma::fill::randu);
+  arma::rowvec testResponses = arma::floor(4 * testData.row(0)) + 0.5 *
+      testData.row(1);
+  arma::rowvec weights(data.n_cols, arma::fill::ones);
+
+  DecisionTreeRegressor<MSEGain, BinnedBinaryNumericSplit> mse(data,
+      responses, 5);
+  DecisionTreeRegressor<MSEGain, BinnedBinaryNumericSplit> weightedMse(data,
+      responses, weights, 5);
+  DecisionTreeRegressor<MADGain, BinnedBinaryNumericSplit> mad(data,
+      responses, 5);
+
+  arma::rowvec predictions;
+  mse.Predict(testData, predictions);
+  REQUIRE(RMSE(predictions, testResponses) < 0.1);
+  weightedMse.Predict(testData, predictions);
+  REQUIRE(RMSE(predictions, testResponses) < 0.1);
+  mad.Predict(testData, predictions);
+  REQUIRE(RMSE(predictions, testResponses) < 0.1);
+}
+
+/**
+ * Make sure that a regression tree with BinaryCategoricalSplit learns a
+ * feature with many categories.
+ */
+TEST_CASE("BinaryCategoricalSplitRegressorTest", "[DecisionTreeRegressorTest]")
+{
+  arma::mat data(1, 5000);
+  arma::rowvec responses(5000);
+  data::DatasetInfo info(1);
+  info.Type(0) = data::Datatype::categorical;
+  for (size_t c = 0; c < 100; ++c)
+    info.MapString<double>(std::to_string(c), 0);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    data(0, i) = math::RandInt(100);
+    responses[i] = ((size_t) data(0, i) % 4) + 0.1 * math::Random();
+  }
+
+  DecisionTreeRegressor<MSEGain, BestBinaryNumericSplit,
+      BinaryCategoricalSplit> tree(data, info, responses, 10);
+  REQUIRE(tree.NumChildren() == 2);
+
+  arma::rowvec predictions;
+  tree.Predict(data, predictions);
+  REQUIRE(RMSE(predictions, responses) < 0.1);
+}
@@ -13,6 +13,8 @@
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
+#include <mlpack/methods/decision_tree/binned_binary_numeric_split.hpp>
+#include <mlpack/methods/decision_tree/binary_categorical_split.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
 
@@ -1399,3 +1401,246 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure the binned numeric split finds a perfect split between two groups
+ * of values.
+ */
+TEST_CASE("BinnedNumericSplitPerfectTest", "[DecisionTreeTest]")
+{
+  arma::rowvec values(1000);
+  arma::Row<size_t> labels(1000);
+  double maxLeft = -DBL_MAX, minRight = DBL_MAX;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = (i % 2 == 0) ? math::Random(0.0, 1.0) : math::Random(2.0, 3.0);
+    labels[i] = i % 2;
+    if (i % 2 == 0)
+      maxLeft = std::max(maxLeft, values[i]);
+    else
+      minRight = std::min(minRight, values[i]);
+  }
+  arma::rowvec weights(1000, arma::fill::ones);
+
+  arma::vec splitInfo;
+  BinnedBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+  double gain = BinnedBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      GiniGain::Evaluate<false>(labels, 2, weights), values, labels, 2, weights,
+      3, 1e-7, splitInfo, aux);
+
+  REQUIRE(gain == Approx(0.0).margin(1e-10));
+  REQUIRE(splitInfo.n_elem == 1);
+  REQUIRE(splitInfo[0] > maxLeft);
+  REQUIRE(splitInfo[0] < minRight);
+
+  // The same split is found with weights.
+  gain = BinnedBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(
+      GiniGain::Evaluate<true>(labels, 2, weights), values, labels, 2, weights,
+      3, 1e-7, splitInfo, aux);
+
+  REQUIRE(gain == Approx(0.0).margin(1e-10));
+  REQUIRE(splitInfo[0] > maxLeft);
+  REQUIRE(splitInfo[0] < minRight);
+}
+
+/**
+ * Make sure a decision tree with binned numeric splits classifies data as well
+ * as a tree with exact numeric splits.
+ */
+TEST_CASE("BinnedNumericSplitTreeTest", "[DecisionTreeTest]")
+{
+  // The label of each point is given by which thirds of [0, 1] its first two
+  // dimensions fall in.
+  arma::mat data(3, 3000, arma::fill::randu);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = ((size_t) (3 * data(0, i)) + (size_t) (3 * data(1, i))) % 3;
+
+  arma::mat testData(3, 1000, arma::fill::randu);
+  arma::Row<size_t> testLabels(1000);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    testLabels[i] = ((size_t) (3 * testData(0, i)) +
+        (size_t) (3 * testData(1, i))) % 3;
+  }
+
+  DecisionTree<GiniGain, BinnedBinaryNumericSplit> gini(data, labels, 3, 5);
+  DecisionTree<InformationGain, BinnedBinaryNumericSplit> info(data, labels, 3,
+      5);
+
+  arma::Row<size_t> giniPredictions, infoPredictions;
+  gini.Classify(testData, giniPredictions);
+  info.Classify(testData, infoPredictions);
+
+  const double giniAccuracy = arma::accu(giniPredictions == testLabels) /
+      (double) testLabels.n_elem;
+  const double infoAccuracy = arma::accu(infoPredictions == testLabels) /
+      (double) testLabels.n_elem;
+  REQUIRE(giniAccuracy > 0.95);
+  REQUIRE(infoAccuracy > 0.95);
+}
+
+/**
+ * Make sure that a compiled tree gives the same predictions and probabilities
+ * as the tree, on numeric and categorical data.
+ */
+TEST_CASE("CompiledDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat data(3, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = ((size_t) (3 * data(0, i)) + (size_t) (3 * data(1, i))) % 3;
+
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  DecisionTree<> numericTree(data, labels, 3, 5);
+  DecisionTree<> categoricalTree(d, di, l, 5, 10);
+
+  FlatForest numericFlat = numericTree.Compile();
+  FlatForest categoricalFlat = categoricalTree.Compile();
+  REQUIRE(numericFlat.NumTrees() == 1);
+  REQUIRE(numericFlat.NumClasses() == 3);
+  REQUIRE(categoricalFlat.NumClasses() == 5);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  numericTree.Classify(data, predictions, probabilities);
+  numericFlat.Classify(data, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    REQUIRE(numericFlat.Classify(data.col(i)) == predictions[i]);
+
+  categoricalTree.Classify(d, predictions, probabilities);
+  categoricalFlat.Classify(d, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * Make sure that a tree trained on sparse data is the same as a tree trained
+ * on the dense copy of the data.
+ */
+TEST_CASE("SparseDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(10, 2000, 0.3);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(0, i) > 0.5 || data(1, i) > 0.5) ? 1 : 0;
+  arma::mat denseData(data);
+
+  DecisionTree<> tree, denseTree;
+  const double gain = tree.Train(data, labels, 2, 5);
+  const double denseGain = denseTree.Train(denseData, labels, 2, 5);
+  REQUIRE(gain == Approx(denseGain).epsilon(1e-10));
+
+  arma::Row<size_t> predictions, densePredictions;
+  arma::mat probabilities, denseProbabilities;
+  tree.Classify(data, predictions, probabilities);
+  denseTree.Classify(denseData, densePredictions, denseProbabilities);
+  CheckMatrices(predictions, densePredictions);
+  CheckMatrices(probabilities, denseProbabilities);
+
+  const size_t correct = arma::accu(predictions == labels);
+  REQUIRE(double(correct) / double(data.n_cols) > 0.95);
+}
+
+/**
+ * Make sure that BinaryCategoricalSplit splits a feature with many categories
+ * into two children, and learns it.
+ */
+TEST_CASE("BinaryCategoricalSplitTest", "[DecisionTreeTest]")
+{
+  // One categorical dimension with 100 categories, and one noise dimension.
+  arma::mat data(2, 5000);
+  arma::Row<size_t> labels(5000);
+  data::DatasetInfo info(2);
+  info.Type(0) = data::Datatype::categorical;
+  for (size_t c = 0; c < 100; ++c)
+    info.MapString<double>(std::to_string(c), 0);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    data(0, i) = math::RandInt(100);
+    data(1, i) = math::Random();
+    labels[i] = ((size_t) data(0, i) % 3 == 0) ? 1 : 0;
+  }
+
+  typedef DecisionTree<GiniGain, BestBinaryNumericSplit,
+      BinaryCategoricalSplit> TreeType;
+  TreeType tree(data, info, labels, 2, 10);
+  REQUIRE(tree.NumChildren() == 2);
+  REQUIRE(tree.SplitDimension() == 0);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(data, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  REQUIRE(double(correct) / double(data.n_cols) > 0.99);
+
+  TreeType xmlTree, jsonTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, jsonTree, binaryTree);
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlTree.Classify(data, xmlPredictions);
+  jsonTree.Classify(data, jsonPredictions);
+  binaryTree.Classify(data, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, jsonPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+
+  // The split can't be compiled, since it doesn't keep a child per category.
+  REQUIRE_THROWS_AS(tree.Compile(), std::invalid_argument);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that a tree trained in parallel is the same as a tree trained with
+ * one thread, on numeric and categorical data.
+ */
+TEST_CASE("ParallelDecisionTreeTest", "[DecisionTreeTest]")
+{
+  // This is large enough that the subtrees are trained in parallel.
+  arma::mat data(4, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = ((size_t) (3 * data(0, i)) + (size_t) (3 * data(1, i))) % 3;
+    if (math::Random() < 0.1)
+      labels[i] = math::RandInt(3); // Add some noise.
+  }
+
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  DecisionTree<> serialTree, serialCategoricalTree;
+  const double serialGain = serialTree.Train(data, labels, 3, 10);
+  const double serialCategoricalGain = serialCategoricalTree.Train(d, di, l,
+      5, 10);
+
+  omp_set_num_threads(4);
+  DecisionTree<> tree, categoricalTree;
+  const double gain = tree.Train(data, labels, 3, 10);
+  const double categoricalGain = categoricalTree.Train(d, di, l, 5, 10);
+  omp_set_num_threads(oldThreads);
+
+  REQUIRE(gain == Approx(serialGain).epsilon(1e-10));
+  REQUIRE(categoricalGain == Approx(serialCategoricalGain).epsilon(1e-10));
+
+  arma::Row<size_t> predictions, serialPredictions;
+  tree.Classify(data, predictions);
+  serialTree.Classify(data, serialPredictions);
+  CheckMatrices(predictions, serialPredictions);
+
+  categoricalTree.Classify(d, predictions);
+  serialCategoricalTree.Classify(d, serialPredictions);
+  CheckMatrices(predictions, serialPredictions);
+}
+
+#endif
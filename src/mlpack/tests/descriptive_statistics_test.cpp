@@ -0,0 +1,200 @@
+/**
+ * @file tests/descriptive_statistics_test.cpp
+ *
+ * Tests for the DescriptiveStatistics and QuantileSketch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/descriptive_statistics.hpp>
+
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+/**
+ * Check the statistics of the given dataset against statistics computed in
+ * several passes over each dimension.
+ */
+void CheckDescriptiveStatistics(const arma::mat& data,
+                                const DescriptiveStatistics& statistics)
+{
+  REQUIRE(statistics.Count() == data.n_cols);
+  REQUIRE(statistics.Dimensionality() == data.n_rows);
+
+  const double n = data.n_cols;
+  const arma::vec mean = arma::mean(data, 1);
+  const arma::mat centered = data.each_col() - mean;
+  const arma::vec m2 = arma::sum(arma::pow(centered, 2), 1);
+  const arma::vec m3 = arma::sum(arma::pow(centered, 3), 1);
+  const arma::vec m4 = arma::sum(arma::pow(centered, 4), 1);
+
+  CheckMatrices(statistics.Mean(), mean);
+  CheckMatrices(statistics.Min(), arma::vec(arma::min(data, 1)));
+  CheckMatrices(statistics.Max(), arma::vec(arma::max(data, 1)));
+  CheckMatrices(statistics.Variance(), arma::vec(arma::var(data, 0, 1)));
+  CheckMatrices(statistics.Variance(true), arma::vec(arma::var(data, 1, 1)));
+
+  const arma::vec std = arma::sqrt(m2 / n);
+  CheckMatrices(statistics.Skewness(true),
+      arma::vec(m3 / (n * arma::pow(std, 3))));
+  CheckMatrices(statistics.Kurtosis(true),
+      arma::vec(n * m4 / arma::square(m2) - 3));
+
+  const arma::vec sampleStd = arma::sqrt(m2 / (n - 1));
+  CheckMatrices(statistics.Skewness(),
+      arma::vec(n * m3 / ((n - 1) * (n - 2) * arma::pow(sampleStd, 3))));
+  CheckMatrices(statistics.Kurtosis(),
+      arma::vec((n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3)) * m4 /
+      arma::pow(sampleStd, 4) - (3 * (n - 1) * (n - 1)) / ((n - 2) *
+      (n - 3))));
+}
+
+/**
+ * Make sure that the moments and extrema are the same when the data is given
+ * at once, in chunks, or as merged statistics.
+ */
+TEST_CASE("DescriptiveStatisticsMomentsTest", "[DescriptiveStatisticsTest]")
+{
+  // Skewed data, with a large offset.
+  arma::mat data = arma::exp(arma::randn<arma::mat>(7, 1000)) + 100.0;
+
+  DescriptiveStatistics all;
+  all.Update(data);
+  CheckDescriptiveStatistics(data, all);
+
+  DescriptiveStatistics chunks;
+  chunks.Update(data.cols(0, 10));
+  chunks.Update(data.cols(11, 600));
+  chunks.Update(data.cols(601, 999));
+  CheckDescriptiveStatistics(data, chunks);
+
+  DescriptiveStatistics first, second;
+  first.Update(data.cols(0, 299));
+  second.Update(data.cols(300, 999));
+  first.Merge(second);
+  CheckDescriptiveStatistics(data, first);
+
+  // A single dimension, which is processed in blocks of points.
+  arma::mat row = data.row(0);
+  DescriptiveStatistics rowStatistics;
+  rowStatistics.Update(row);
+  CheckDescriptiveStatistics(row, rowStatistics);
+
+  // Data with a different dimensionality can't be added.
+  REQUIRE_THROWS_AS(all.Update(row), std::invalid_argument);
+}
+
+/**
+ * Make sure that the medians are exact for small datasets, as given by
+ * arma::median().
+ */
+TEST_CASE("QuantileSketchExactTest", "[DescriptiveStatisticsTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+
+  DescriptiveStatistics statistics(128);
+  statistics.Update(data);
+  CheckMatrices(statistics.Median(), arma::vec(arma::median(data, 1)));
+
+  arma::rowvec values = arma::randu<arma::rowvec>(51);
+  QuantileSketch sketch;
+  for (size_t i = 0; i < values.n_elem; ++i)
+    sketch.Insert(values[i]);
+  REQUIRE(sketch.Quantile(0.5) == Approx(arma::median(values)));
+  REQUIRE(sketch.Quantile(0.0) == Approx(arma::min(values)));
+  REQUIRE(sketch.Quantile(1.0) == Approx(arma::max(values)));
+
+  REQUIRE_THROWS_AS(QuantileSketch().Quantile(0.5), std::invalid_argument);
+}
+
+/**
+ * Make sure that the quantiles of a large stream, given to one sketch or to
+ * merged sketches, have a small rank error.
+ */
+TEST_CASE("QuantileSketchApproximateTest", "[DescriptiveStatisticsTest]")
+{
+  const size_t n = 200000;
+  arma::vec values = arma::randu<arma::vec>(n);
+
+  QuantileSketch sketch, first, second;
+  for (size_t i = 0; i < n; ++i)
+  {
+    sketch.Insert(values[i]);
+    if (i < n / 3)
+      first.Insert(values[i]);
+    else
+      second.Insert(values[i]);
+  }
+  first.Merge(second);
+  REQUIRE(sketch.Count() == n);
+  REQUIRE(first.Count() == n);
+
+  const arma::vec sorted = arma::sort(values);
+  const double quantiles[] = { 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99 };
+  for (const double q : quantiles)
+  {
+    // The rank of the estimate must be within 1% of the requested rank.
+    for (const QuantileSketch* s : { &sketch, &first })
+    {
+      const double estimate = s->Quantile(q);
+      const double rank = (double) (std::lower_bound(sorted.begin(),
+          sorted.end(), estimate) - sorted.begin()) / n;
+      REQUIRE(std::abs(rank - q) < 0.01);
+    }
+  }
+
+  REQUIRE_THROWS_AS(sketch.Merge(QuantileSketch(16)), std::invalid_argument);
+}
+
+/**
+ * Make sure that the quantile sketch estimates ranks accurately in little
+ * memory, and that merging two sketches gives a sketch of both streams.
+ */
+TEST_CASE("QuantileSketchRankTest", "[DescriptiveStatisticsTest]")
+{
+  QuantileSketch sketch(200);
+  QuantileSketch otherSketch(200);
+  arma::vec values(100000, arma::fill::randu);
+  for (size_t i = 0; i < 50000; ++i)
+    sketch.Insert(values[i]);
+  for (size_t i = 50000; i < 100000; ++i)
+    otherSketch.Insert(3.0 * values[i]);
+
+  REQUIRE(sketch.Count() == 50000);
+  REQUIRE(sketch.NumItems() < 1000);
+  for (double x = 0.1; x < 1.0; x += 0.1)
+  {
+    const size_t trueRank = arma::accu(values.subvec(0, 49999) < x);
+    REQUIRE(std::abs(double(sketch.Rank(x)) - double(trueRank)) < 1000.0);
+  }
+  REQUIRE(sketch.Quantile(0.5) == Approx(0.5).margin(0.02));
+
+  // The weights of the kept values add up to the number of values.
+  std::vector<std::pair<double, size_t>> weighted;
+  sketch.WeightedValues(weighted);
+  REQUIRE(weighted.size() == sketch.NumItems());
+  size_t totalWeight = 0;
+  for (size_t i = 0; i < weighted.size(); ++i)
+  {
+    totalWeight += weighted[i].second;
+    if (i > 0)
+      REQUIRE(weighted[i - 1].first <= weighted[i].first);
+  }
+  REQUIRE(totalWeight == sketch.Count());
+
+  sketch.Merge(otherSketch);
+  REQUIRE(sketch.Count() == 100000);
+  REQUIRE(sketch.NumItems() < 1000);
+  values.subvec(50000, 99999) *= 3.0;
+  for (double x = 0.25; x < 3.0; x += 0.25)
+  {
+    const size_t trueRank = arma::accu(values < x);
+    REQUIRE(std::abs(double(sketch.Rank(x)) - double(trueRank)) < 2000.0);
+  }
+}
@@ -110,8 +110,8 @@ TEST_CASE("TestFindSplit", "[DETTest]")
       log(2.5));
 
   testDTree.logVolume = log(7.0) + log(4.0) + log(7.0);
-  REQUIRE(testDTree.FindSplit(
-      testData, obDim, obSplit, obLeftError, obRightError, 1));
+  REQUIRE(testDTree.FindSplit(testData, arma::mat(), obDim, obSplit,
+      obLeftError, obRightError, 1));
 
   REQUIRE(trueDim == obDim);
   REQUIRE(trueSplit == Approx(obSplit).epsilon(1e-12));
@@ -120,6 +120,34 @@ TEST_CASE("TestFindSplit", "[DETTest]")
   REQUIRE(trueRightError == Approx(obRightError).epsilon(1e-12));
 }
 
+TEST_CASE("TestPresortedFindSplit", "[DETTest]")
+{
+  arma::mat testData(3, 5);
+
+  testData = { { 4, 5, 7, 3, 5 },
+               { 5, 0, 1, 7, 1 },
+               { 5, 6, 7, 1, 8 } };
+
+  DTree<arma::mat> testDTree(testData);
+  testDTree.logVolume = log(7.0) + log(4.0) + log(7.0);
+
+  // The presorted values of each dimension are stored in the columns.
+  const arma::mat sortedValues = arma::sort(testData.t());
+
+  size_t dim, presortedDim;
+  double leftError, rightError, split;
+  double presortedLeftError, presortedRightError, presortedSplit;
+  REQUIRE(testDTree.FindSplit(testData, arma::mat(), dim, split, leftError,
+      rightError, 1));
+  REQUIRE(testDTree.FindSplit(testData, sortedValues, presortedDim,
+      presortedSplit, presortedLeftError, presortedRightError, 1));
+
+  REQUIRE(presortedDim == dim);
+  REQUIRE(presortedSplit == split);
+  REQUIRE(presortedLeftError == leftError);
+  REQUIRE(presortedRightError == rightError);
+}
+
 TEST_CASE("TestSplitData", "[DETTest]")
 {
   arma::mat testData(3, 5);
@@ -172,8 +200,8 @@ TEST_CASE("TestSparseFindSplit", "[DETTest]")
       (log(7.0) + log(6.5) + log(8.0) + log(6.0));
 
   testDTree.logVolume = log(7.0) + log(7.0) + log(8.0) + log(6.0);
-  REQUIRE(testDTree.FindSplit(
-      testData, obDim, obSplit, obLeftError, obRightError, 1));
+  REQUIRE(testDTree.FindSplit(testData, arma::mat(), obDim, obSplit,
+      obLeftError, obRightError, 1));
 
   REQUIRE(trueDim == obDim);
   REQUIRE(trueSplit == Approx(obSplit).epsilon(1e-12));
@@ -458,6 +486,39 @@ TEST_CASE("TestSparseComputeValue", "[DETTest]")
   REQUIRE(0.0 == Approx(testDTree.ComputeValue(q4)).epsilon(1e-12));
 }
 
+/**
+ * Make sure that a tree grown on dense data, whose dimensions are presorted, is
+ * the same as a tree grown on the same data stored as a sparse matrix, whose
+ * dimensions are sorted at each node.
+ */
+TEST_CASE("TestPresortedGrow", "[DETTest]")
+{
+  arma::mat denseData(4, 1000, arma::fill::randu);
+  arma::sp_mat sparseData(denseData);
+  const arma::mat queries(denseData);
+
+  arma::Col<size_t> denseOldFromNew =
+      arma::regspace<arma::Col<size_t>>(0, denseData.n_cols - 1);
+  arma::Col<size_t> sparseOldFromNew(denseOldFromNew);
+
+  DTree<arma::mat> denseTree(denseData);
+  DTree<arma::sp_mat> sparseTree(sparseData);
+  const double denseAlpha = denseTree.Grow(denseData, denseOldFromNew, false,
+      10, 5);
+  const double sparseAlpha = sparseTree.Grow(sparseData, sparseOldFromNew,
+      false, 10, 5);
+
+  REQUIRE(denseAlpha == Approx(sparseAlpha).epsilon(1e-10));
+  REQUIRE(denseTree.SubtreeLeaves() == sparseTree.SubtreeLeaves());
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.col(i);
+    const arma::sp_vec sparseQuery(query);
+    REQUIRE(denseTree.ComputeValue(query) ==
+        Approx(sparseTree.ComputeValue(sparseQuery)).epsilon(1e-10));
+  }
+}
+
 /**
  * These are not yet implemented.
  *
@@ -453,6 +453,70 @@ TEST_CASE("GaussianMultipointMultivariateProbabilityTest", "[DistributionTest]")
   REQUIRE(phis(5) == Approx(-14.900192463287908).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batched Mahalanobis distances, which use the Cholesky factor of
+ * the covariance, match the ones computed with the inverse covariance, over
+ * more points than one block.
+ */
+TEST_CASE("GaussianMahalanobisBatchTest", "[DistributionTest]")
+{
+  arma::vec mean = "5 6 3 3 2";
+  arma::mat cov("6 1 1 1 2;"
+                "1 7 1 0 0;"
+                "1 1 4 1 1;"
+                "1 0 1 7 0;"
+                "2 0 1 0 6");
+  GaussianDistribution g(mean, cov);
+
+  arma::mat points = 5 * arma::randn<arma::mat>(5, 2500);
+  arma::vec distances, logProbs;
+  g.Mahalanobis(points, distances);
+  g.LogProbability(points, logProbs);
+  REQUIRE(distances.n_elem == 2500);
+  REQUIRE(logProbs.n_elem == 2500);
+
+  const arma::mat invCov = arma::inv(cov);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const arma::vec diff = points.col(i) - mean;
+    REQUIRE(distances[i] ==
+        Approx(arma::dot(diff, invCov * diff)).epsilon(1e-7));
+    REQUIRE(logProbs[i] ==
+        Approx(g.LogProbability(points.col(i))).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure the blocked, one-pass ColumnCovariance() matches the two-pass
+ * covariance, over more points than one block, and for points far from the
+ * origin.
+ */
+TEST_CASE("BlockedColumnCovarianceTest", "[DistributionTest]")
+{
+  arma::mat points = arma::randn<arma::mat>(4, 10000);
+  points.row(1) += 1e6;
+  points.row(2) *= 100;
+
+  const arma::mat expected = arma::cov(points.t());
+  const arma::mat covariance = mlpack::math::ColumnCovariance(points);
+  REQUIRE(covariance.n_rows == 4);
+  REQUIRE(covariance.n_cols == 4);
+  for (size_t i = 0; i < covariance.n_elem; ++i)
+  {
+    if (std::abs(expected[i]) < 1e-5)
+      REQUIRE(covariance[i] == Approx(0.0).margin(1e-5));
+    else
+      REQUIRE(covariance[i] == Approx(expected[i]).epsilon(1e-7));
+  }
+
+  const arma::mat biased = mlpack::math::ColumnCovariance(points, 1);
+  for (size_t i = 0; i < covariance.n_elem; ++i)
+  {
+    REQUIRE(biased[i] ==
+        Approx(covariance[i] * 9999.0 / 10000.0).epsilon(1e-7).margin(1e-10));
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -1544,3 +1608,71 @@ TEST_CASE("DiagonalGaussianWeightedParametersReductionTest",
     REQUIRE(d1.Covariance()(i) == Approx(d2.Covariance()(i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Check the batched LogProbability() and Probability() of the given
+ * distribution against the given single-observation log probabilities, and
+ * make sure an output of the right size is reused.
+ */
+template<typename DistributionType>
+void CheckBatchedLogProbability(const DistributionType& dist,
+                                const arma::mat& points,
+                                const arma::vec& expected)
+{
+  arma::vec logProbs(points.n_cols);
+  const double* memory = logProbs.memptr();
+  dist.LogProbability(points, logProbs);
+  REQUIRE(logProbs.memptr() == memory);
+
+  arma::vec probs;
+  dist.Probability(points, probs);
+  REQUIRE(logProbs.n_elem == points.n_cols);
+  REQUIRE(probs.n_elem == points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    REQUIRE(logProbs[i] == Approx(expected[i]).epsilon(1e-7));
+    REQUIRE(probs[i] == Approx(std::exp(expected[i])).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure the batched LogProbability() of each distribution matches the
+ * single-observation version.
+ */
+TEST_CASE("BatchedLogProbabilityTest", "[DistributionTest]")
+{
+  const arma::mat points = arma::randu<arma::mat>(3, 100) + 0.1;
+  arma::vec expected(points.n_cols);
+
+  DiagonalGaussianDistribution diagonal(arma::vec("0.5 0.2 0.7"),
+      arma::vec("0.3 1.2 0.8"));
+  for (size_t i = 0; i < points.n_cols; ++i)
+    expected[i] = diagonal.LogProbability(arma::vec(points.col(i)));
+  CheckBatchedLogProbability(diagonal, points, expected);
+
+  LaplaceDistribution laplace(arma::vec("0.5 0.2 0.7"), 0.8);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    expected[i] = laplace.LogProbability(arma::vec(points.col(i)));
+  CheckBatchedLogProbability(laplace, points, expected);
+
+  GammaDistribution gamma(arma::vec("1.0 2.5 0.7"), arma::vec("0.5 1.5 2.0"));
+  expected.zeros();
+  for (size_t i = 0; i < points.n_cols; ++i)
+    for (size_t d = 0; d < points.n_rows; ++d)
+      expected[i] += gamma.LogProbability(points(d, i), d);
+  CheckBatchedLogProbability(gamma, points, expected);
+
+  // The discrete distribution takes integer observations.
+  DiscreteDistribution discrete(std::vector<arma::vec>({
+      arma::vec("0.1 0.2 0.7"), arma::vec("0.5 0.5") }));
+  arma::mat observations(2, 50);
+  arma::vec discreteExpected(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    observations(0, i) = i % 3;
+    observations(1, i) = i % 2;
+    discreteExpected[i] = discrete.LogProbability(
+        arma::vec(observations.col(i)));
+  }
+  CheckBatchedLogProbability(discrete, observations, discreteExpected);
+}
@@ -163,3 +163,61 @@ TEST_CASE("SparseTest", "[DrusillaSelectTest]")
   REQUIRE(distances.n_cols == 1000);
   REQUIRE(distances.n_rows == 3);
 }
+
+// Make sure that the blocked search over many queries gives the furthest
+// points of the candidate set.
+TEST_CASE("DrusillaSelectManyQueriesTest", "[DrusillaSelectTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(6, 500);
+  arma::mat queries = arma::randu<arma::mat>(6, 1000);
+
+  DrusillaSelect<> ds(dataset, 8, 6);
+
+  arma::mat distances;
+  arma::Mat<size_t> neighbors;
+  ds.Search(queries, 4, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 4);
+  REQUIRE(neighbors.n_cols == 1000);
+
+  const arma::mat& candidates = ds.CandidateSet();
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    arma::vec candidateDistances(candidates.n_cols);
+    for (size_t r = 0; r < candidates.n_cols; ++r)
+      candidateDistances[r] = arma::norm(queries.col(q) - candidates.col(r));
+    const arma::uvec order = arma::sort_index(candidateDistances, "descend");
+
+    for (size_t j = 0; j < 4; ++j)
+    {
+      REQUIRE(neighbors(j, q) == ds.CandidateIndices()[order[j]]);
+      REQUIRE(distances(j, q) ==
+          Approx(candidateDistances[order[j]]).epsilon(1e-10));
+    }
+  }
+}
+
+// Make sure that the candidate set can be stored in single precision.
+TEST_CASE("DrusillaSelectFloatTest", "[DrusillaSelectTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 100);
+  arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+
+  // With one point per projection, the candidate set is the whole dataset.
+  DrusillaSelect<arma::fmat> ds(floatDataset, 100, 1);
+
+  arma::mat distances, distancesTrue;
+  arma::Mat<size_t> neighbors, neighborsTrue;
+  ds.Search(floatDataset, 5, neighbors, distances);
+
+  KFN kfn(dataset);
+  kfn.Search(dataset, 5, neighborsTrue, distancesTrue);
+
+  REQUIRE(neighbors.n_rows == neighborsTrue.n_rows);
+  REQUIRE(neighbors.n_cols == neighborsTrue.n_cols);
+  for (size_t i = 0; i < distances.n_elem; ++i)
+  {
+    REQUIRE(neighbors[i] == neighborsTrue[i]);
+    REQUIRE(distances[i] == Approx(distancesTrue[i]).epsilon(1e-5));
+  }
+}
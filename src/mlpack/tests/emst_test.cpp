@@ -274,3 +274,45 @@ TEST_CASE("EMSTBallTreeTest", "[EMSTTest]")
     REQUIRE(bstResults(2, i) == Approx(ballResults(2, i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure that a grid, where almost all candidate edges of the components
+ * have the same length, still gives a spanning tree of the right length with
+ * both the dual-tree and the naive method.
+ */
+TEST_CASE("EMSTGridTiesTest", "[EMSTTest]")
+{
+  const size_t side = 20;
+  arma::mat inputData(2, side * side);
+  for (size_t i = 0; i < side; ++i)
+  {
+    for (size_t j = 0; j < side; ++j)
+    {
+      inputData(0, i * side + j) = (double) i;
+      inputData(1, i * side + j) = (double) j;
+    }
+  }
+
+  for (const bool naive : { false, true })
+  {
+    DualTreeBoruvka<> dtb(inputData, naive);
+
+    arma::mat results;
+    dtb.ComputeMST(results);
+
+    REQUIRE(results.n_cols == inputData.n_cols - 1);
+    REQUIRE(arma::accu(results.row(2)) ==
+        Approx((double) inputData.n_cols - 1.0).epsilon(1e-7));
+
+    // The edges must connect every point.
+    UnionFind connections(inputData.n_cols);
+    for (size_t i = 0; i < results.n_cols; ++i)
+    {
+      REQUIRE(results(2, i) == Approx(1.0).epsilon(1e-7));
+      connections.Union((size_t) results(0, i), (size_t) results(1, i));
+    }
+
+    for (size_t i = 1; i < inputData.n_cols; ++i)
+      REQUIRE(connections.Find(i) == connections.Find(0));
+  }
+}
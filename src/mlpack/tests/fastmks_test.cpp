@@ -1141,3 +1141,85 @@ TEST_CASE("CopyAssignmentTest", "[FastMKSTest]")
       REQUIRE(newKernels[i] == Approx(0.0).margin(1e-5));
   }
 }
+
+/**
+ * The blocked brute-force search with the linear kernel should give the same
+ * results as evaluating every inner product, with and without a query set, and
+ * when the number of points is not a multiple of the block sizes.
+ */
+TEST_CASE("FastMKSNaiveLinearBlocksTest", "[FastMKSTest]")
+{
+  arma::mat referenceData = arma::randn(6, 2500);
+  arma::mat queryData = arma::randn(6, 700);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> naive(referenceData, lk, false, true);
+
+  for (size_t mono = 0; mono < 2; ++mono)
+  {
+    const arma::mat& querySet = (mono == 1) ? referenceData : queryData;
+    arma::Mat<size_t> indices;
+    arma::mat products;
+    if (mono == 1)
+      naive.Search(5, indices, products);
+    else
+      naive.Search(queryData, 5, indices, products);
+
+    REQUIRE(indices.n_cols == querySet.n_cols);
+    const arma::mat allProducts = referenceData.t() * querySet;
+    for (size_t q = 0; q < querySet.n_cols; ++q)
+    {
+      arma::vec column = allProducts.col(q);
+      if (mono == 1)
+        column[q] = -DBL_MAX;
+      const arma::uvec order = arma::sort_index(column, "descend");
+
+      for (size_t r = 0; r < 5; ++r)
+      {
+        REQUIRE(indices(r, q) == order[r]);
+        REQUIRE(products(r, q) == Approx(column[order[r]]).epsilon(1e-7));
+      }
+    }
+  }
+}
+
+// The parallel traversals are only used if OpenMP is available.
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that single-tree and dual-tree search give the same results as
+ * naive search when the query points are split across several threads.
+ */
+TEST_CASE("FastMKSParallelVsNaive", "[FastMKSTest]")
+{
+  arma::mat referenceData = arma::randn(5, 1500);
+  arma::mat queryData = arma::randn(5, 600);
+  PolynomialKernel pk(2.0, 1.0);
+
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+  arma::Mat<size_t> naiveIndices, naiveMonoIndices;
+  arma::mat naiveKernels, naiveMonoKernels;
+  naive.Search(queryData, 8, naiveIndices, naiveKernels);
+  naive.Search(8, naiveMonoIndices, naiveMonoKernels);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    FastMKS<PolynomialKernel> fastmks(referenceData, pk, (mode == 1));
+    arma::Mat<size_t> indices, monoIndices;
+    arma::mat kernels, monoKernels;
+    fastmks.Search(queryData, 8, indices, kernels);
+    fastmks.Search(8, monoIndices, monoKernels);
+
+    for (size_t i = 0; i < kernels.n_elem; ++i)
+      REQUIRE(kernels[i] == Approx(naiveKernels[i]).epsilon(1e-7));
+    for (size_t i = 0; i < monoKernels.n_elem; ++i)
+      REQUIRE(monoKernels[i] == Approx(naiveMonoKernels[i]).epsilon(1e-7));
+  }
+
+  omp_set_num_threads(oldThreads);
+}
+
+#endif
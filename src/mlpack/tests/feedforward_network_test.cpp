@@ -11,10 +11,12 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/training_telemetry.hpp>
 
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/distributed_ffn.hpp>
 
 #include <ensmallen.hpp>
 
@@ -730,6 +732,510 @@ TEST_CASE("FFNMiscTest", "[FeedForwardNetworkTest]")
   auto moveOperator = std::move(copiedModel);
 }
 
+/**
+ * Make sure that predicting in batches gives the same results as predicting
+ * one point at a time, for batch sizes that do and don't divide the number of
+ * points.
+ */
+TEST_CASE("FFNBatchPredictTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 103);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 3);
+  model.ResetParameters();
+
+  arma::mat predictions, batchPredictions;
+  model.Predict(data, predictions, 1);
+  REQUIRE(predictions.n_rows == 3);
+  REQUIRE(predictions.n_cols == 103);
+
+  for (const size_t batchSize : { 10, 103, 500 })
+  {
+    model.Predict(data, batchPredictions, batchSize);
+    CheckMatrices(predictions, batchPredictions);
+  }
+}
+
+/**
+ * Make sure that a network created with ShareWeights() uses the weights of the
+ * original network and gives the same predictions.
+ */
+TEST_CASE("FFNShareWeightsTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 50);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Dropout<>>();
+  model.Add<Linear<>>(8, 3);
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  FFN<MeanSquaredError<>> shared = model.ShareWeights();
+  REQUIRE(shared.Parameters().memptr() == model.Parameters().memptr());
+
+  arma::mat sharedPredictions;
+  shared.Predict(data, sharedPredictions);
+  CheckMatrices(predictions, sharedPredictions);
+
+  // Changing the weights of the original network changes the predictions of
+  // the shared network.
+  model.Parameters() *= 2.0;
+  model.Predict(data, predictions);
+  shared.Predict(data, sharedPredictions);
+  CheckMatrices(predictions, sharedPredictions);
+}
+
+/**
+ * Make sure that a network built from a StaticSequential block gives the same
+ * predictions and is trained the same way as the same network built from
+ * separate layers.
+ */
+TEST_CASE("FFNStaticSequentialTest", "[FeedForwardNetworkTest]")
+{
+  typedef StaticSequential<Linear<>, SigmoidLayer<>, Linear<>> Block;
+
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+  arma::mat responses = arma::randu<arma::mat>(3, 100);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 3);
+  model.ResetParameters();
+
+  FFN<MeanSquaredError<>, RandomInitialization, Block> staticModel;
+  staticModel.Add<Block>(Linear<>(5, 8), SigmoidLayer<>(), Linear<>(8, 3));
+  staticModel.ResetParameters();
+
+  REQUIRE(staticModel.Parameters().n_elem == model.Parameters().n_elem);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(data, predictions);
+  staticModel.Predict(data, staticPredictions);
+  CheckMatrices(predictions, staticPredictions);
+
+  // Train both networks in the same way.
+  ens::RMSProp opt(0.01, 10, 0.88, 1e-8, 500, -1, false);
+  model.Train(data, responses, opt);
+  staticModel.Train(data, responses, opt);
+  CheckMatrices(model.Parameters(), staticModel.Parameters());
+
+  model.Predict(data, predictions);
+  staticModel.Predict(data, staticPredictions);
+  CheckMatrices(predictions, staticPredictions);
+}
+
+/**
+ * Make sure that training with several threads, with one shard of each batch
+ * per thread, gives the same result as training with one thread.
+ */
+TEST_CASE("FFNThreadsTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+  arma::mat responses = arma::randu<arma::mat>(3, 100);
+
+  FFN<MeanSquaredError<>> model, threadedModel;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 3);
+  threadedModel.Add<Linear<>>(5, 8);
+  threadedModel.Add<SigmoidLayer<>>();
+  threadedModel.Add<Linear<>>(8, 3);
+
+  // Run a forward pass so that the parameters are not reset by Train().
+  arma::mat predictions, threadedPredictions;
+  model.Predict(data, predictions);
+  threadedModel.Predict(data, threadedPredictions);
+  threadedModel.Parameters() = model.Parameters();
+
+  threadedModel.Threads() = 3;
+  REQUIRE(threadedModel.Threads() == 3);
+
+  // The batch size is not a multiple of the number of threads, so the shards
+  // have different sizes.
+  ens::RMSProp opt(0.01, 10, 0.88, 1e-8, 500, -1, false);
+  model.Train(data, responses, opt);
+  threadedModel.Train(data, responses, opt);
+  CheckMatrices(model.Parameters(), threadedModel.Parameters(), 1e-5);
+
+  model.Predict(data, predictions);
+  threadedModel.Predict(data, threadedPredictions);
+  CheckMatrices(predictions, threadedPredictions, 1e-5);
+}
+
+/**
+ * Make sure that shuffling the visitation order does not move the training
+ * data, and that it does not change the objective and the gradient over all
+ * the points.
+ */
+TEST_CASE("FFNShuffleTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+  arma::mat responses = arma::randu<arma::mat>(3, 100);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 3);
+
+  // The optimizer shuffles the points before each epoch.
+  ens::RMSProp opt(0.01, 10, 0.88, 1e-8, 500, -1, true);
+  model.Train(data, responses, opt);
+  CheckMatrices(model.Predictors(), data);
+  CheckMatrices(model.Responses(), responses);
+
+  model.Shuffle();
+  CheckMatrices(model.Predictors(), data);
+  CheckMatrices(model.Responses(), responses);
+
+  // Every batch has the same size, so the sum of the objectives of the batches
+  // does not depend on the order of the points; neither does the gradient of
+  // the whole data.
+  double objective = 0.0;
+  for (size_t begin = 0; begin < 100; begin += 10)
+    objective += model.Evaluate(model.Parameters(), begin, 10);
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 100);
+
+  model.Shuffle();
+  double shuffledObjective = 0.0;
+  for (size_t begin = 0; begin < 100; begin += 10)
+    shuffledObjective += model.Evaluate(model.Parameters(), begin, 10);
+  arma::mat shuffledGradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, shuffledGradient, 100);
+
+  REQUIRE(shuffledObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(shuffledGradient, gradient, 1e-5);
+}
+
+/**
+ * Make sure that the memory plan shares memory between the buffers that are
+ * not used at the same time.
+ */
+TEST_CASE("MemoryPlanTest", "[FeedForwardNetworkTest]")
+{
+  MemoryPlan plan;
+  const size_t a = plan.Add(100, 0, 1);
+  const size_t b = plan.Add(50, 1, 2);
+  const size_t c = plan.Add(80, 2, 3);
+  const size_t d = plan.Add(10, 0, 3);
+  plan.Plan();
+
+  REQUIRE(plan.NumBuffers() == 4);
+  REQUIRE(plan.TotalElements() == 240);
+
+  // a and c are not used at the same time, so they share memory.
+  REQUIRE(plan.Offset(a) == plan.Offset(c));
+  REQUIRE(plan.Size() == 160);
+
+  // The buffers that are used at the same time do not overlap.
+  REQUIRE((plan.Offset(b) >= plan.Offset(a) + 100 ||
+      plan.Offset(a) >= plan.Offset(b) + 50));
+  REQUIRE((plan.Offset(d) >= plan.Offset(b) + 50 ||
+      plan.Offset(b) >= plan.Offset(d) + 10));
+  REQUIRE((plan.Offset(d) >= plan.Offset(a) + 100 ||
+      plan.Offset(a) >= plan.Offset(d) + 10));
+}
+
+/**
+ * Make sure that training with the memory plan (with shared deltas and
+ * in-place activations) gives the same result as training without it.
+ */
+TEST_CASE("FFNMemoryPlanningTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+  arma::mat responses = arma::randu<arma::mat>(3, 100);
+
+  FFN<MeanSquaredError<>> model, plannedModel;
+  model.Add<Linear<>>(5, 8);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(8, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 8);
+  model.Add<TanHLayer<>>();
+  model.Add<Linear<>>(8, 3);
+  plannedModel.Add<Linear<>>(5, 8);
+  plannedModel.Add<ReLULayer<>>();
+  plannedModel.Add<Linear<>>(8, 8);
+  plannedModel.Add<SigmoidLayer<>>();
+  plannedModel.Add<Linear<>>(8, 8);
+  plannedModel.Add<TanHLayer<>>();
+  plannedModel.Add<Linear<>>(8, 3);
+
+  // Run a forward pass so that the parameters are not reset by Train().
+  arma::mat predictions, plannedPredictions;
+  model.Predict(data, predictions);
+  plannedModel.Predict(data, plannedPredictions);
+  plannedModel.Parameters() = model.Parameters();
+
+  plannedModel.MemoryPlanning() = true;
+  REQUIRE(plannedModel.MemoryPlanning() == true);
+  REQUIRE(plannedModel.PlannedMemory() == 0);
+
+  ens::RMSProp opt(0.01, 10, 0.88, 1e-8, 500, -1, false);
+  model.Train(data, responses, opt);
+  plannedModel.Train(data, responses, opt);
+  CheckMatrices(model.Parameters(), plannedModel.Parameters(), 1e-5);
+
+  // The activations take 8 * 3 + 3 elements per point (the activation layers
+  // are computed in place), and two deltas of 8 elements per point are enough.
+  REQUIRE(plannedModel.PlannedMemory() <= 10 * (8 * 3 + 3 + 2 * 8));
+
+  model.Predict(data, predictions);
+  plannedModel.Predict(data, plannedPredictions);
+  CheckMatrices(predictions, plannedPredictions, 1e-5);
+}
+
+/**
+ * Make sure that a network that uses mixed precision gives about the same
+ * predictions and gradients as in double precision, and keeps the parameters
+ * in double precision.
+ */
+TEST_CASE("FFNMixedPrecisionTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 64);
+  arma::mat responses = arma::randu<arma::mat>(2, 64);
+
+  FFN<MeanSquaredError<>> model, mixedModel;
+  model.Add<Linear<>>(10, 16);
+  model.Add<ReLULayer<>>();
+  model.Add<LinearNoBias<>>(16, 16);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(16, 2);
+  Linear<>* linear = new Linear<>(10, 16);
+  mixedModel.Add(linear);
+  mixedModel.Add<ReLULayer<>>();
+  mixedModel.Add<LinearNoBias<>>(16, 16);
+  mixedModel.Add<SigmoidLayer<>>();
+  mixedModel.Add<Linear<>>(16, 2);
+
+  arma::mat predictions, mixedPredictions;
+  model.Predict(data, predictions);
+  mixedModel.Predict(data, mixedPredictions);
+  mixedModel.Parameters() = model.Parameters();
+
+  mixedModel.MixedPrecision() = true;
+  REQUIRE(mixedModel.MixedPrecision() == true);
+  model.Predict(data, predictions);
+  mixedModel.Predict(data, mixedPredictions);
+  REQUIRE(linear->MixedPrecision() == true);
+  CheckMatrices(predictions, mixedPredictions, 1e-2);
+
+  arma::mat gradient, mixedGradient;
+  model.Predictors() = data;
+  model.Responses() = responses;
+  mixedModel.Predictors() = data;
+  mixedModel.Responses() = responses;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 64);
+  const double mixedObjective = mixedModel.EvaluateWithGradient(
+      mixedModel.Parameters(), 0, mixedGradient, 64);
+  REQUIRE(mixedObjective == Approx(objective).epsilon(1e-4));
+  CheckMatrices(gradient, mixedGradient, 1e-2);
+
+  // Training still works, and the parameters are updated in double precision.
+  ens::RMSProp opt(0.01, 16, 0.88, 1e-8, 640, -1, false);
+  mixedModel.Train(data, responses, opt);
+  mixedModel.MixedPrecision() = false;
+  mixedModel.Predict(data, mixedPredictions);
+  REQUIRE(linear->MixedPrecision() == false);
+  REQUIRE(arma::accu(arma::square(mixedPredictions - responses)) <
+      arma::accu(arma::square(predictions - responses)));
+}
+
+/**
+ * Make sure that the training telemetry callback measures the epochs and the
+ * layers of an FFN, and writes them as JSON lines.
+ */
+TEST_CASE("FFNTrainingTelemetryTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 64);
+  arma::mat responses = arma::randu<arma::mat>(2, 64);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(10, 16);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(16, 2);
+  REQUIRE(model.LayerTiming() == false);
+
+  // Two epochs of four steps.
+  std::ostringstream telemetryStream;
+  util::TrainingTelemetry telemetry(telemetryStream, 2);
+  ens::RMSProp opt(0.01, 16, 0.88, 1e-8, 128, -1, false);
+  model.Train(data, responses, opt, telemetry);
+
+  // The layer timing is only on during the optimization.
+  REQUIRE(model.LayerTiming() == false);
+  REQUIRE(model.LayerForwardTimes().size() == 3);
+  REQUIRE(model.LayerBackwardTimes().size() == 3);
+
+  const util::TrainingTelemetry::Statistics& total = telemetry.Total();
+  REQUIRE(telemetry.Epochs() >= 1);
+  REQUIRE(total.steps >= 4);
+  REQUIRE(total.evaluations >= 4);
+  REQUIRE(total.samples >= 64);
+  REQUIRE(total.seconds > 0.0);
+  REQUIRE(total.evaluateSeconds > 0.0);
+  REQUIRE(total.layerForwardSeconds.size() == 3);
+  REQUIRE(total.layerBackwardSeconds.size() == 3);
+  REQUIRE(arma::accu(arma::vec(total.layerForwardSeconds)) > 0.0);
+  REQUIRE(telemetry.LastEpoch().samples == 64);
+
+  // Each line is one JSON object.
+  const std::string lines = telemetryStream.str();
+  REQUIRE(lines.find("{ \"event\": \"step\", \"index\": 2, ") == 0);
+  REQUIRE(lines.find("{ \"event\": \"epoch\", \"index\": ") !=
+      std::string::npos);
+  REQUIRE(lines.find("{ \"event\": \"optimization\", ") !=
+      std::string::npos);
+  REQUIRE(lines.find("\"layer_forward_seconds\": [") != std::string::npos);
+  REQUIRE(lines.back() == '\n');
+}
+
+/**
+ * Make sure that folding BatchNorm layers into the previous Linear and
+ * Convolution layers does not change the predictions of the network.
+ */
+TEST_CASE("FFNFuseBatchNormTest", "[FeedForwardNetworkTest]")
+{
+  // A network with a Linear layer followed by a BatchNorm layer.
+  arma::mat data = arma::randu<arma::mat>(5, 50);
+
+  BatchNorm<>* batchNorm = new BatchNorm<>(8);
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add(batchNorm);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(8, 3);
+  model.ResetParameters();
+
+  // Use some statistics that are not the identity.
+  batchNorm->Parameters().randu();
+  batchNorm->TrainingMean().randu();
+  batchNorm->TrainingVariance() = arma::randu<arma::mat>(8, 1) + 0.5;
+
+  arma::mat predictions, fusedPredictions;
+  model.Predict(data, predictions);
+
+  REQUIRE(model.FuseBatchNorm() == 1);
+  REQUIRE(model.Model().size() == 3);
+  REQUIRE(model.Parameters().n_elem == 5 * 8 + 8 + 8 * 3 + 3);
+
+  model.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+
+  // Nothing is left to fuse.
+  REQUIRE(model.FuseBatchNorm() == 0);
+
+  // A network with a Convolution layer followed by a BatchNorm layer.
+  arma::mat images = arma::randu<arma::mat>(36, 10);
+
+  BatchNorm<>* convBatchNorm = new BatchNorm<>(2);
+  FFN<MeanSquaredError<>> convModel;
+  convModel.Add<Convolution<>>(1, 2, 3, 3, 1, 1, 0, 0, 6, 6);
+  convModel.Add(convBatchNorm);
+  convModel.Add<Linear<>>(2 * 4 * 4, 3);
+  convModel.ResetParameters();
+
+  convBatchNorm->Parameters().randu();
+  convBatchNorm->TrainingMean().randu();
+  convBatchNorm->TrainingVariance() = arma::randu<arma::mat>(2, 1) + 0.5;
+
+  convModel.Predict(images, predictions);
+
+  REQUIRE(convModel.FuseBatchNorm() == 1);
+  REQUIRE(convModel.Model().size() == 2);
+
+  convModel.Predict(images, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+}
+
+/**
+ * Make sure that the input range of a Linear layer that follows another Linear
+ * layer is calibrated on the full-precision output of that layer.
+ */
+TEST_CASE("FFNQuantizeConsecutiveLinearTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 100);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(10, 8);
+  model.Add<Linear<>>(8, 4);
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  // The full-precision output of the first layer.
+  arma::mat hidden = model.Parameters().rows(0, 79);
+  hidden.reshape(8, 10);
+  arma::mat hiddenOutput = hidden * data;
+  hiddenOutput.each_col() += arma::vec(model.Parameters().rows(80, 87));
+
+  REQUIRE(model.Quantize(data) == 2);
+  QuantizedLinear<>* second =
+      boost::get<QuantizedLinear<>*>(model.Model()[1]);
+  REQUIRE(second->InputScale() ==
+      Approx(arma::abs(hiddenOutput).max() / 127.0).epsilon(1e-10));
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+  REQUIRE(arma::abs(quantizedPredictions - predictions).max() <
+      0.05 * arma::abs(predictions).max());
+}
+
+/**
+ * Make sure that the predictions of a quantized network are close to those of
+ * the original network, and that the quantized network can be serialized.
+ */
+TEST_CASE("FFNQuantizeTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 200);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(10, 16);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(16, 4);
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  REQUIRE(model.Quantize(data) == 2);
+  REQUIRE(model.Parameters().n_elem == 0);
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+
+  REQUIRE(quantizedPredictions.n_rows == predictions.n_rows);
+  REQUIRE(quantizedPredictions.n_cols == predictions.n_cols);
+  const double range = arma::abs(predictions).max();
+  REQUIRE(arma::abs(quantizedPredictions - predictions).max() <
+      0.05 * range);
+
+  // Nothing is left to quantize.
+  REQUIRE(model.Quantize(data) == 0);
+
+  FFN<MeanSquaredError<>> xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
 /**
  * Test that serialization works ok.
  */
@@ -1010,3 +1516,37 @@ TEST_CASE("FFNCheckInputShapeTest", "[FeedForwardNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(trainData, trainLabels, opt), std::logic_error);
 }
+
+/**
+ * Make sure that DistributedFFN on a single rank trains the network in the
+ * same way as FFN::Train().
+ */
+TEST_CASE("DistributedFFNSingleRankTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(4, 200, arma::fill::randu);
+  arma::mat labels(1, 200);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(0, i) + data(1, i) > 1.0) ? 1 : 0;
+
+  FFN<NegativeLogLikelihood<>> model, distributedModel;
+  for (FFN<NegativeLogLikelihood<>>* network : { &model, &distributedModel })
+  {
+    network->Add<Linear<>>(4, 8);
+    network->Add<SigmoidLayer<>>();
+    network->Add<Linear<>>(8, 2);
+    network->Add<LogSoftMax<>>();
+    network->ResetParameters();
+  }
+  distributedModel.Parameters() = model.Parameters();
+
+  ens::StandardSGD opt(0.01, 10, 5 * data.n_cols, -1, false);
+  const double objective = model.Train(data, labels, opt);
+
+  DistributedFFN<FFN<NegativeLogLikelihood<>>> distributed(distributedModel);
+  REQUIRE(distributed.Communicator().Size() == 1);
+  const double distributedObjective = distributed.Train(data, labels, opt);
+
+  REQUIRE(distributedObjective == Approx(objective).epsilon(1e-7));
+  REQUIRE(arma::approx_equal(distributedModel.Parameters(),
+      model.Parameters(), "absdiff", 1e-8));
+}
@@ -340,8 +340,8 @@ TEST_CASE("GANMemorySharingTest", "[GANNetworkTest]")
 
   CheckMatrices(gan.Predictors().head_cols(trainData.n_cols), trainData);
   CheckMatrices(gan.Predictors(), gan.Discriminator().Predictors());
+  // Shuffling only changes the visitation order, so the data does not move.
   gan.Shuffle();
   CheckMatrices(gan.Predictors(), gan.Discriminator().Predictors());
-  CheckMatricesNotEqual(gan.Predictors().head_cols(trainData.n_cols),
-      trainData);
+  CheckMatrices(gan.Predictors().head_cols(trainData.n_cols), trainData);
 }
@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
+#include <mlpack/methods/gmm/distributed_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -838,6 +839,139 @@ TEST_CASE("UseExistingModelTest", "[GMMTest]")
   }
 }
 
+/**
+ * Make sure that a single iteration of EMFit::Estimate() gives the same model
+ * as a straightforward implementation of the E-step and M-step.  There are
+ * enough points that the observations are split into several blocks.
+ */
+TEST_CASE("EMFitSingleIterationTest", "[GMMTest]")
+{
+  const size_t dims = 4;
+  const size_t gaussians = 3;
+
+  std::vector<distribution::GaussianDistribution> dists;
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    arma::vec mean = 10.0 * arma::randu<arma::vec>(dims);
+    arma::mat covariance = arma::randu<arma::mat>(dims, dims);
+    covariance = covariance * covariance.t() + arma::eye(dims, dims);
+    dists.push_back(distribution::GaussianDistribution(mean, covariance));
+  }
+  arma::vec weights("0.2 0.3 0.5");
+
+  arma::mat data(dims, 2500);
+  for (size_t j = 0; j < data.n_cols; ++j)
+    data.col(j) = dists[j % gaussians].Random();
+
+  // Compute one iteration directly.
+  arma::mat condLogProb(data.n_cols, gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+    for (size_t j = 0; j < data.n_cols; ++j)
+      condLogProb(j, i) = std::log(weights[i]) +
+          dists[i].LogProbability(data.col(j));
+  for (size_t j = 0; j < data.n_cols; ++j)
+    condLogProb.row(j) -= math::AccuLog(condLogProb.row(j));
+
+  std::vector<distribution::GaussianDistribution> expected(dists);
+  arma::vec expectedWeights(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    const double probSum = math::AccuLog(condLogProb.col(i));
+    const arma::vec probs = arma::exp(condLogProb.col(i) - probSum);
+    expected[i].Mean() = data * probs;
+    arma::mat diffs = data.each_col() - expected[i].Mean();
+    arma::mat covariance = diffs * arma::diagmat(probs) * diffs.t();
+    PositiveDefiniteConstraint::ApplyConstraint(covariance);
+    expected[i].Covariance(std::move(covariance));
+    expectedWeights[i] = std::exp(probSum) / data.n_cols;
+  }
+
+  // Now run one iteration of EMFit, starting from the same model.
+  EMFit<> fitter(2, 1e-10);
+  fitter.Estimate(data, dists, weights, true);
+
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    REQUIRE(weights[i] == Approx(expectedWeights[i]).epsilon(1e-7));
+    for (size_t j = 0; j < dims; ++j)
+    {
+      REQUIRE(dists[i].Mean()[j] ==
+          Approx(expected[i].Mean()[j]).epsilon(1e-7));
+      for (size_t k = 0; k < dims; ++k)
+      {
+        REQUIRE(dists[i].Covariance()(j, k) ==
+            Approx(expected[i].Covariance()(j, k)).epsilon(1e-7)
+            .margin(1e-10));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that a GMM trained with StochasticEMFit finds two well-separated
+ * Gaussians.
+ */
+TEST_CASE("StochasticEMFitTrainTest", "[GMMTest]")
+{
+  arma::mat data(2, 4000, arma::fill::randn);
+  data.cols(1000, 3999) += 10.0;
+
+  GMM gmm(2, 2);
+  gmm.Train(data, 1, false, StochasticEMFit<>(300, 500));
+
+  // Find which component is which.
+  const size_t low = (gmm.Component(0).Mean()[0] <
+      gmm.Component(1).Mean()[0]) ? 0 : 1;
+  const size_t high = 1 - low;
+
+  REQUIRE(gmm.Weights()[low] == Approx(0.25).margin(0.03));
+  REQUIRE(gmm.Weights()[high] == Approx(0.75).margin(0.03));
+  for (size_t d = 0; d < 2; ++d)
+  {
+    REQUIRE(gmm.Component(low).Mean()[d] == Approx(0.0).margin(0.2));
+    REQUIRE(gmm.Component(high).Mean()[d] == Approx(10.0).margin(0.2));
+    REQUIRE(gmm.Component(low).Covariance()(d, d) ==
+        Approx(1.0).margin(0.25));
+    REQUIRE(gmm.Component(high).Covariance()(d, d) ==
+        Approx(1.0).margin(0.25));
+  }
+}
+
+/**
+ * Make sure that GMM::PartialFit() follows a component whose mean drifts after
+ * the model is trained.
+ */
+TEST_CASE("GMMPartialFitTest", "[GMMTest]")
+{
+  arma::mat data(2, 2000, arma::fill::randn);
+  data.cols(1000, 1999) += 10.0;
+
+  GMM gmm(2, 2);
+  gmm.Train(data);
+
+  const size_t low = (gmm.Component(0).Mean()[0] <
+      gmm.Component(1).Mean()[0]) ? 0 : 1;
+  const size_t high = 1 - low;
+
+  // Now the second Gaussian moves.
+  StochasticEMFit<> fitter;
+  for (size_t i = 0; i < 50; ++i)
+  {
+    arma::mat chunk(2, 200, arma::fill::randn);
+    chunk.cols(100, 199) += 12.0;
+
+    const double logLikelihood = gmm.PartialFit(chunk, fitter);
+    REQUIRE(std::isfinite(logLikelihood));
+  }
+
+  REQUIRE(fitter.Steps() == 50);
+  for (size_t d = 0; d < 2; ++d)
+  {
+    REQUIRE(gmm.Component(low).Mean()[d] == Approx(0.0).margin(0.3));
+    REQUIRE(gmm.Component(high).Mean()[d] == Approx(12.0).margin(0.3));
+  }
+}
+
 /********************************************************/
 /** Diagonal Gaussian Mixture Model(DiagonalGMM) Tests **/
 /********************************************************/
@@ -1239,3 +1373,67 @@ TEST_CASE("DiagonalGMMLoadSaveTest", "[GMMTest]")
     }
   }
 }
+
+/**
+ * Make sure that a DiagonalGMM trained with StochasticEMFit finds two
+ * well-separated Gaussians.
+ */
+TEST_CASE("DiagonalGMMStochasticEMFitTrainTest", "[GMMTest]")
+{
+  arma::mat data(3, 4000, arma::fill::randn);
+  data.row(0) *= 2.0;
+  data.cols(2000, 3999) += 10.0;
+
+  DiagonalGMM gmm(2, 3);
+  gmm.Train(data, 1, false, StochasticEMFit<kmeans::KMeans<>,
+      DiagonalConstraint, distribution::DiagonalGaussianDistribution>(300,
+      500));
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const double offset = (gmm.Component(i).Mean()[0] > 5.0) ? 10.0 : 0.0;
+    REQUIRE(gmm.Weights()[i] == Approx(0.5).margin(0.03));
+    REQUIRE(gmm.Component(i).Covariance()[0] == Approx(4.0).margin(0.8));
+    for (size_t d = 0; d < 3; ++d)
+      REQUIRE(gmm.Component(i).Mean()[d] == Approx(offset).margin(0.3));
+    for (size_t d = 1; d < 3; ++d)
+      REQUIRE(gmm.Component(i).Covariance()[d] == Approx(1.0).margin(0.25));
+  }
+}
+
+/**
+ * Make sure that DistributedEMFit on a single rank recovers the components of
+ * a GMM and a diagonal GMM.
+ */
+TEST_CASE("DistributedEMFitTrainTest", "[GMMTest]")
+{
+  arma::mat data(3, 4000, arma::fill::randn);
+  data.row(0) *= 2.0;
+  data.cols(2000, 3999) += 10.0;
+
+  GMM gmm(2, 3);
+  gmm.Train(data, 1, false, DistributedEMFit<>());
+
+  DiagonalGMM diagGMM(2, 3);
+  diagGMM.Train(data, 1, false, DistributedEMFit<kmeans::LocalCommunicator,
+      DiagonalConstraint, distribution::DiagonalGaussianDistribution>());
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const double offset = (gmm.Component(i).Mean()[0] > 5.0) ? 10.0 : 0.0;
+    REQUIRE(gmm.Weights()[i] == Approx(0.5).margin(0.03));
+    REQUIRE(gmm.Component(i).Covariance()(0, 0) == Approx(4.0).margin(0.8));
+    for (size_t d = 0; d < 3; ++d)
+      REQUIRE(gmm.Component(i).Mean()[d] == Approx(offset).margin(0.3));
+
+    const double diagOffset = (diagGMM.Component(i).Mean()[0] > 5.0) ? 10.0 :
+        0.0;
+    REQUIRE(diagGMM.Weights()[i] == Approx(0.5).margin(0.03));
+    REQUIRE(diagGMM.Component(i).Covariance()[0] == Approx(4.0).margin(0.8));
+    for (size_t d = 0; d < 3; ++d)
+    {
+      REQUIRE(diagGMM.Component(i).Mean()[d] ==
+          Approx(diagOffset).margin(0.3));
+    }
+  }
+}
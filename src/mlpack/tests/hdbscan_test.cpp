@@ -0,0 +1,145 @@
+/**
+ * @file tests/hdbscan_test.cpp
+ *
+ * Test the HDBSCAN implementation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hdbscan/hdbscan.hpp>
+
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::hdbscan;
+using namespace mlpack::emst;
+using namespace mlpack::tree;
+using namespace mlpack::metric;
+
+/**
+ * Make sure the mutual reachability distance is the largest of the distance
+ * and the core distances stored in the last dimension.
+ */
+TEST_CASE("MutualReachabilityDistanceTest", "[HDBSCANTest]")
+{
+  MutualReachabilityDistance<> metric;
+
+  arma::vec a("0.0 0.0 0.5");
+  arma::vec b("3.0 4.0 1.0");
+  arma::vec c("0.0 0.2 2.0");
+
+  REQUIRE(metric.Evaluate(a, b) == Approx(5.0));
+  REQUIRE(metric.Evaluate(a, c) == Approx(2.0));
+  REQUIRE(metric.Evaluate(c, a) == Approx(2.0));
+  REQUIRE(metric.Evaluate(a, a) == Approx(0.5));
+}
+
+/**
+ * The dual-tree minimum spanning tree under the mutual reachability distance
+ * must have the same length as the naive one.
+ */
+TEST_CASE("MutualReachabilityMSTTest", "[HDBSCANTest]")
+{
+  arma::mat data(4, 500, arma::fill::randu);
+  data.row(3) = 0.2 * arma::randu<arma::rowvec>(500);
+
+  typedef DualTreeBoruvka<MutualReachabilityDistance<>, arma::mat, BallTree>
+      DTBType;
+  DTBType dtb(data);
+  DTBType dtbNaive(data, true);
+
+  arma::mat results, naiveResults;
+  dtb.ComputeMST(results);
+  dtbNaive.ComputeMST(naiveResults);
+
+  REQUIRE(results.n_cols == naiveResults.n_cols);
+  REQUIRE(arma::accu(results.row(2)) ==
+      Approx(arma::accu(naiveResults.row(2))).epsilon(1e-7));
+}
+
+/**
+ * Three well-separated Gaussian clusters, with a few far outliers, should be
+ * found without setting any radius.
+ */
+TEST_CASE("HDBSCANGaussianClustersTest", "[HDBSCANTest]")
+{
+  arma::mat points(2, 603);
+  points.cols(0, 199) = 0.5 * arma::randn<arma::mat>(2, 200);
+  points.cols(200, 399) = 0.5 * arma::randn<arma::mat>(2, 200);
+  points.cols(400, 599) = 0.5 * arma::randn<arma::mat>(2, 200);
+  points.cols(200, 399).each_col() += arma::vec("20.0 0.0");
+  points.cols(400, 599).each_col() += arma::vec("0.0 20.0");
+  points.col(600) = arma::vec("100.0 100.0");
+  points.col(601) = arma::vec("-100.0 50.0");
+  points.col(602) = arma::vec("50.0 -100.0");
+
+  HDBSCAN<> h(10);
+
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  const size_t clusters = h.Cluster(points, assignments, centroids);
+
+  REQUIRE(clusters == 3);
+  REQUIRE(assignments.n_elem == points.n_cols);
+  REQUIRE(centroids.n_cols == 3);
+
+  // The outliers are noise.
+  REQUIRE(assignments[600] == SIZE_MAX);
+  REQUIRE(assignments[601] == SIZE_MAX);
+  REQUIRE(assignments[602] == SIZE_MAX);
+
+  // Most of each Gaussian is in its own cluster; some of the points on the
+  // edges may be noise.
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const arma::Row<size_t> blob = assignments.cols(200 * c, 200 * c + 199);
+    const size_t label = blob[arma::index_min(blob)];
+    REQUIRE(label != SIZE_MAX);
+    REQUIRE(arma::accu(blob == label) > 180);
+    REQUIRE(arma::accu(blob != label && blob != SIZE_MAX) == 0);
+
+    const arma::vec mean = arma::mean(points.cols(200 * c, 200 * c + 199), 1);
+    REQUIRE(arma::norm(centroids.col(label) - mean) < 0.5);
+  }
+}
+
+/**
+ * A single uniform blob is a single cluster only if that is allowed.
+ */
+TEST_CASE("HDBSCANSingleClusterTest", "[HDBSCANTest]")
+{
+  arma::mat points(2, 300, arma::fill::randu);
+
+  HDBSCAN<> h(150, 5, true);
+
+  arma::Row<size_t> assignments;
+  const size_t clusters = h.Cluster(points, assignments);
+
+  REQUIRE(clusters == 1);
+  REQUIRE(arma::accu(assignments == 0) == points.n_cols);
+
+  // Without a single cluster, no split is large enough, so all points are
+  // noise.
+  h.AllowSingleCluster() = false;
+  REQUIRE(h.Cluster(points, assignments) == 0);
+  REQUIRE(arma::accu(assignments == SIZE_MAX) == points.n_cols);
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("HDBSCANInvalidParametersTest", "[HDBSCANTest]")
+{
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(HDBSCAN<>(1), std::runtime_error);
+
+  arma::mat points(2, 10, arma::fill::randu);
+  arma::Row<size_t> assignments;
+  HDBSCAN<> h(5, 20);
+  REQUIRE_THROWS_AS(h.Cluster(points, assignments), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
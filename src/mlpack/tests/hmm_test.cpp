@@ -2109,3 +2109,91 @@ TEST_CASE("DiagonalGMMHMMLoadSaveTest", "[HMMTest]")
     }
   }
 }
+
+/**
+ * Make sure that Baum-Welch training on many sequences (which are processed in
+ * parallel) does not depend on the order of the sequences.
+ */
+TEST_CASE("GaussianHMMMultipleSequenceOrderTest", "[HMMTest]")
+{
+  HMM<GaussianDistribution> trueHMM(2, GaussianDistribution(1));
+  trueHMM.Transition() = arma::mat("0.9 0.2; 0.1 0.8");
+  trueHMM.Emission()[0] = GaussianDistribution("0.0", "1.0");
+  trueHMM.Emission()[1] = GaussianDistribution("4.0", "1.0");
+
+  std::vector<arma::mat> observations(40);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHMM.Generate(50 + 10 * (i % 5), observations[i], states);
+  }
+  std::vector<arma::mat> reversed(observations.rbegin(), observations.rend());
+
+  HMM<GaussianDistribution> hmm(2, GaussianDistribution(1));
+  hmm.Emission()[0] = GaussianDistribution("1.0", "2.0");
+  hmm.Emission()[1] = GaussianDistribution("3.0", "2.0");
+  HMM<GaussianDistribution> reversedHMM(hmm);
+
+  const double loglik = hmm.Train(observations);
+  const double reversedLoglik = reversedHMM.Train(reversed);
+
+  REQUIRE(loglik == Approx(reversedLoglik).epsilon(1e-5));
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(hmm.Transition()[i] ==
+        Approx(reversedHMM.Transition()[i]).margin(1e-3));
+  }
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(hmm.Initial()[i] == Approx(reversedHMM.Initial()[i]).margin(1e-3));
+    REQUIRE(hmm.Emission()[i].Mean()[0] ==
+        Approx(reversedHMM.Emission()[i].Mean()[0]).margin(1e-3));
+  }
+
+  // The model should be close to the true one.
+  REQUIRE(hmm.Emission()[0].Mean()[0] == Approx(0.0).margin(0.3));
+  REQUIRE(hmm.Emission()[1].Mean()[0] == Approx(4.0).margin(0.3));
+}
+
+/**
+ * The batch versions of Predict() and LogLikelihood() should give the results
+ * of the single-sequence versions.
+ */
+TEST_CASE("GaussianHMMBatchPredictTest", "[HMMTest]")
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.8 0.1 0.3; 0.1 0.7 0.3; 0.1 0.2 0.4");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("3.0 1.0", "1.0 0.5; 0.5 1.0");
+  hmm.Emission()[2] = GaussianDistribution("-2.0 4.0", "2.0 0.0; 0.0 1.0");
+
+  std::vector<arma::mat> observations(25);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    hmm.Generate(2 + 7 * i, observations[i], states);
+  }
+
+  std::vector<arma::Row<size_t>> stateSeqs;
+  const arma::vec pathLogLikelihoods = hmm.Predict(observations, stateSeqs);
+  const arma::vec logLikelihoods = hmm.LogLikelihood(observations);
+
+  REQUIRE(stateSeqs.size() == observations.size());
+  REQUIRE(pathLogLikelihoods.n_elem == observations.size());
+  REQUIRE(logLikelihoods.n_elem == observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    const double pathLogLikelihood = hmm.Predict(observations[i], stateSeq);
+
+    REQUIRE(stateSeqs[i].n_elem == stateSeq.n_elem);
+    for (size_t t = 0; t < stateSeq.n_elem; ++t)
+      REQUIRE(stateSeqs[i][t] == stateSeq[t]);
+    REQUIRE(pathLogLikelihoods[i] == Approx(pathLogLikelihood).epsilon(1e-10));
+    REQUIRE(logLikelihoods[i] ==
+        Approx(hmm.LogLikelihood(observations[i])).epsilon(1e-10));
+
+    // The most probable path is no more likely than all the paths together.
+    REQUIRE(pathLogLikelihoods[i] <= logLikelihoods[i] + 1e-10);
+  }
+}
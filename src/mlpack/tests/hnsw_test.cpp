@@ -0,0 +1,211 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Test the HNSW graph index for approximate nearest neighbor search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::metric;
+
+/**
+ * Compute the fraction of the true neighbors that were found.
+ */
+double Recall(const arma::Mat<size_t>& neighbors,
+              const arma::Mat<size_t>& trueNeighbors)
+{
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      if (arma::any(trueNeighbors.col(i) == neighbors(j, i)))
+        ++found;
+    }
+  }
+
+  return double(found) / trueNeighbors.n_elem;
+}
+
+/**
+ * The approximate neighbors of random queries should be almost all the exact
+ * ones, and the distances should be the true distances to those neighbors.
+ */
+TEST_CASE("HNSWRecallTest", "[HNSWTest]")
+{
+  arma::mat referenceData(10, 2000, arma::fill::randu);
+  arma::mat queryData(10, 200, arma::fill::randu);
+
+  HNSWSearch<> hnsw(referenceData);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 10, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 200);
+  REQUIRE(distances.n_rows == 10);
+  REQUIRE(distances.n_cols == 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  REQUIRE(Recall(neighbors, trueNeighbors) >= 0.95);
+
+  EuclideanDistance metric;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(distances(j, i) == Approx(metric.Evaluate(queryData.col(i),
+          referenceData.col(neighbors(j, i)))).epsilon(1e-7));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+}
+
+/**
+ * The monochromatic search must not return the query point itself.
+ */
+TEST_CASE("HNSWMonochromaticTest", "[HNSWTest]")
+{
+  arma::mat referenceData(5, 1000, arma::fill::randu);
+
+  HNSWSearch<> hnsw(referenceData, 8, 100, 50);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(5, neighbors, distances);
+
+  REQUIRE(neighbors.n_cols == referenceData.n_cols);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    REQUIRE(arma::all(neighbors.col(i) != i));
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  REQUIRE(Recall(neighbors, trueNeighbors) >= 0.95);
+}
+
+/**
+ * Points inserted after training should be found too.
+ */
+TEST_CASE("HNSWInsertTest", "[HNSWTest]")
+{
+  arma::mat referenceData(8, 1500, arma::fill::randu);
+  arma::mat queryData(8, 100, arma::fill::randu);
+
+  HNSWSearch<> hnsw(referenceData.cols(0, 499));
+  hnsw.Insert(referenceData.cols(500, 1499));
+
+  REQUIRE(hnsw.ReferenceSet().n_cols == 1500);
+  CheckMatrices(hnsw.ReferenceSet(), referenceData);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  REQUIRE(Recall(neighbors, trueNeighbors) >= 0.95);
+}
+
+/**
+ * A larger search list should find more of the true neighbors in a sparse
+ * graph.
+ */
+TEST_CASE("HNSWEfTest", "[HNSWTest]")
+{
+  arma::mat referenceData(10, 1000, arma::fill::randu);
+  arma::mat queryData(10, 100, arma::fill::randu);
+
+  HNSWSearch<> hnsw(referenceData, 4, 20, 10);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 10, neighbors, distances);
+  const double lowRecall = Recall(neighbors, trueNeighbors);
+
+  hnsw.Ef() = 200;
+  hnsw.Search(queryData, 10, neighbors, distances);
+  const double highRecall = Recall(neighbors, trueNeighbors);
+
+  REQUIRE(highRecall >= lowRecall);
+  REQUIRE(highRecall >= 0.95);
+}
+
+/**
+ * Make sure that the graph gives the same results after serialization.
+ */
+TEST_CASE("HNSWSerializationTest", "[HNSWTest]")
+{
+  arma::mat referenceData(6, 800, arma::fill::randu);
+  arma::mat queryData(6, 50, arma::fill::randu);
+
+  HNSWSearch<> hnsw(referenceData, 10, 100, 40);
+  HNSWSearch<> xmlHnsw, jsonHnsw, binaryHnsw;
+
+  SerializeObjectAll(hnsw, xmlHnsw, jsonHnsw, binaryHnsw);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+  xmlHnsw.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  jsonHnsw.Search(queryData, 5, jsonNeighbors, jsonDistances);
+  binaryHnsw.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  REQUIRE(xmlHnsw.MaxConnections() == 10);
+  REQUIRE(jsonHnsw.EfConstruction() == 100);
+  REQUIRE(binaryHnsw.Ef() == 40);
+
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("HNSWInvalidParametersTest", "[HNSWTest]")
+{
+  arma::mat referenceData(3, 10, arma::fill::randu);
+  arma::mat queryData(2, 10, arma::fill::randu);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(HNSWSearch<>(referenceData, 1), std::runtime_error);
+
+  HNSWSearch<> hnsw(referenceData);
+  REQUIRE_THROWS_AS(hnsw.Search(referenceData, 11, neighbors, distances),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(hnsw.Search(10, neighbors, distances), std::runtime_error);
+  REQUIRE_THROWS_AS(hnsw.Search(queryData, 3, neighbors, distances),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(hnsw.Insert(queryData), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -15,6 +15,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
+#include <mlpack/methods/hoeffding_trees/quantile_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
 
 #include "catch.hpp"
@@ -1526,3 +1527,215 @@ TEST_CASE("HoeffdingTreeEmptyConstructorTrainTest", "[HoeffdingTreeTest]")
   REQUIRE_NOTHROW(ht.Train(data, labels, false, true, 2));
   REQUIRE_NOTHROW(ht.Train(data2, info, labels2, false, 3));
 }
+
+/**
+ * Make sure that training on minibatches of CheckInterval() points gives the
+ * same tree as training on each point in turn.
+ */
+TEST_CASE("HoeffdingTreeMinibatchTrainTest", "[HoeffdingTreeTest]")
+{
+  // The first three features are numeric, and the fourth is categorical.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4);
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  info.MapString<double>("2", 3);
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    labels[i] = i % 3;
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random() + (double) labels[i];
+    dataset(2, i) = mlpack::math::Random() + 0.4 * labels[i];
+    dataset(3, i) = (mlpack::math::Random() < 0.7) ? labels[i] :
+        mlpack::math::RandInt(3);
+  }
+
+  HoeffdingTree<> streamTree(info, 3);
+  for (size_t i = 0; i < 9000; ++i)
+    streamTree.Train(dataset.col(i), labels[i]);
+
+  HoeffdingTree<> minibatchTree(info, 3);
+  const size_t batchSize = minibatchTree.CheckInterval();
+  for (size_t i = 0; i < 9000; i += batchSize)
+  {
+    minibatchTree.TrainMinibatch(dataset.cols(i, i + batchSize - 1),
+        labels.subvec(i, i + batchSize - 1));
+  }
+
+  REQUIRE(streamTree.NumChildren() > 0);
+  REQUIRE(minibatchTree.NumDescendants() == streamTree.NumDescendants());
+  REQUIRE(minibatchTree.SplitDimension() == streamTree.SplitDimension());
+
+  arma::Row<size_t> streamPredictions, minibatchPredictions;
+  arma::rowvec streamProbabilities, minibatchProbabilities;
+  streamTree.Classify(dataset, streamPredictions, streamProbabilities);
+  minibatchTree.Classify(dataset, minibatchPredictions,
+      minibatchProbabilities);
+  CheckMatrices(minibatchPredictions, streamPredictions);
+  CheckMatrices(minibatchProbabilities, streamProbabilities);
+
+  // A minibatch with the wrong dimensionality is rejected.
+  REQUIRE_THROWS_AS(minibatchTree.TrainMinibatch(dataset.rows(0, 2), labels),
+      std::invalid_argument);
+}
+
+/**
+ * Create a QuantileNumericSplit object, feed it samples where anything less
+ * than 1.0 is class 0 and anything greater is class 1, and make sure it can
+ * perform a perfect split with bounded memory.
+ */
+TEST_CASE("QuantileNumericSplitSimpleSplitTest", "[HoeffdingTreeTest]")
+{
+  QuantileNumericSplit<GiniImpurity> split(2, 100); // 2 classes.
+
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    split.Train(mlpack::math::Random(), 0);
+    split.Train(mlpack::math::Random() + 1.0, 1);
+  }
+
+  // The Gini impurity for the unsplit node is 2 * (0.5^2) = 0.5, and the Gini
+  // impurity for the children is 0.
+  double bestGain, secondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  REQUIRE(bestGain == Approx(0.5).epsilon(1e-7));
+  REQUIRE(bestGain > secondBestGain);
+  REQUIRE(split.Sketch(0).Count() == 5000);
+  REQUIRE(split.Sketch(0).NumItems() < 500);
+  REQUIRE(split.MajorityProbability() == Approx(0.5).epsilon(1e-7));
+
+  arma::Col<size_t> childMajorities;
+  BinaryNumericSplitInfo<> splitInfo;
+  split.Split(childMajorities, splitInfo);
+
+  REQUIRE(childMajorities[0] == 0);
+  REQUIRE(childMajorities[1] == 1);
+  REQUIRE(splitInfo.CalculateDirection(0.5) == 0);
+  REQUIRE(splitInfo.CalculateDirection(0.99) == 0);
+  REQUIRE(splitInfo.CalculateDirection(1.1) == 1);
+  REQUIRE(splitInfo.CalculateDirection(1.5) == 1);
+}
+
+/**
+ * Count the leaves of the given tree, and how many of them are active.
+ */
+template<typename TreeType>
+void CountLeaves(const TreeType& tree, size_t& leaves, size_t& activeLeaves)
+{
+  if (tree.NumChildren() == 0)
+  {
+    ++leaves;
+    if (tree.IsActive())
+      ++activeLeaves;
+    return;
+  }
+
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CountLeaves(tree.Child(i), leaves, activeLeaves);
+}
+
+/**
+ * A streaming Hoeffding tree with quantile numeric splits should learn as well
+ * as with binary numeric splits, with much less memory.
+ */
+TEST_CASE("QuantileNumericHoeffdingTreeTest", "[HoeffdingTreeTest]")
+{
+  arma::mat dataset(3, 30000);
+  arma::Row<size_t> labels(30000);
+  for (size_t i = 0; i < 30000; ++i)
+  {
+    labels[i] = i % 3;
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random() + (double) labels[i];
+    dataset(2, i) = mlpack::math::Random() + 0.4 * labels[i];
+  }
+  data::DatasetInfo info(3);
+
+  HoeffdingTree<GiniImpurity, QuantileDoubleNumericSplit> quantileTree(info,
+      3);
+  HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> binaryTree(info, 3);
+  for (size_t i = 0; i < 30000; ++i)
+  {
+    quantileTree.Train(dataset.col(i), labels[i]);
+    binaryTree.Train(dataset.col(i), labels[i]);
+  }
+
+  REQUIRE(quantileTree.NumChildren() > 0);
+  REQUIRE(quantileTree.SplitDimension() == 1);
+  REQUIRE(quantileTree.MemoryUsage() < binaryTree.MemoryUsage());
+
+  arma::Row<size_t> predictions;
+  quantileTree.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  REQUIRE(correct > size_t(0.95 * 30000));
+}
+
+/**
+ * With a memory budget, the least promising leaves should be deactivated, so
+ * that the statistics take less memory, and the tree should still be
+ * serializable and usable.
+ */
+TEST_CASE("HoeffdingTreeMemoryBudgetTest", "[HoeffdingTreeTest]")
+{
+  // The label changes six times along the first dimension, so the tree needs
+  // a lot of leaves.
+  arma::mat dataset(3, 40000, arma::fill::randu);
+  arma::Row<size_t> labels(40000);
+  for (size_t i = 0; i < 40000; ++i)
+    labels[i] = size_t(6 * dataset(0, i)) % 3;
+  data::DatasetInfo info(3);
+
+  HoeffdingTree<> freeTree(info, 3);
+  for (size_t i = 0; i < 40000; ++i)
+    freeTree.Train(dataset.col(i), labels[i]);
+  size_t freeLeaves = 0, freeActiveLeaves = 0;
+  CountLeaves(freeTree, freeLeaves, freeActiveLeaves);
+  REQUIRE(freeLeaves > 3);
+  REQUIRE(freeActiveLeaves == freeLeaves);
+
+  const size_t budget = freeTree.MemoryUsage() / 4;
+  HoeffdingTree<> budgetTree(info, 3);
+  budgetTree.MemoryBudget(budget);
+  REQUIRE(budgetTree.MemoryBudget() == budget);
+  for (size_t i = 0; i < 40000; ++i)
+    budgetTree.Train(dataset.col(i), labels[i]);
+
+  budgetTree.EnforceMemoryBudget();
+  size_t leaves = 0, activeLeaves = 0;
+  CountLeaves(budgetTree, leaves, activeLeaves);
+  REQUIRE(activeLeaves > 0);
+  REQUIRE(activeLeaves < leaves);
+  REQUIRE(budgetTree.MemoryUsage() < freeTree.MemoryUsage());
+  REQUIRE(budgetTree.MemoryUsage() <= 2 * budget);
+
+  arma::Row<size_t> predictions;
+  budgetTree.Classify(dataset, predictions);
+  REQUIRE(arma::all(predictions < 3));
+
+  HoeffdingTree<> xmlTree, jsonTree, binaryTree;
+  SerializeObjectAll(budgetTree, xmlTree, jsonTree, binaryTree);
+  REQUIRE(binaryTree.MemoryBudget() == budget);
+  size_t loadedLeaves = 0, loadedActiveLeaves = 0;
+  CountLeaves(binaryTree, loadedLeaves, loadedActiveLeaves);
+  REQUIRE(loadedLeaves == leaves);
+  REQUIRE(loadedActiveLeaves == activeLeaves);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlTree.Classify(dataset, xmlPredictions);
+  jsonTree.Classify(dataset, jsonPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, jsonPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+
+  // Training can go on with the loaded tree.
+  binaryTree.TrainMinibatch(dataset.cols(0, 999), labels.subvec(0, 999));
+
+  // Without a budget, the leaves are not changed.
+  budgetTree.MemoryBudget(0);
+  budgetTree.EnforceMemoryBudget();
+  size_t newLeaves = 0, newActiveLeaves = 0;
+  CountLeaves(budgetTree, newLeaves, newActiveLeaves);
+  REQUIRE(newActiveLeaves == activeLeaves);
+}
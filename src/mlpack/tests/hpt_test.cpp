@@ -11,6 +11,7 @@
 
 #include <mlpack/core/cv/metrics/mse.hpp>
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/k_fold_cv.hpp>
 #include <mlpack/core/cv/simple_cv.hpp>
 #include <mlpack/core/hpt/cv_function.hpp>
 #include <mlpack/core/hpt/fixed.hpp>
@@ -177,6 +178,29 @@ TEST_CASE("CVFunctionGradientTest", "[HPTTest]")
   REQUIRE(gradient(2) == Approx(aproximateZPartialDerivative).epsilon(1e-7));
 }
 
+/**
+ * Test CVFunction runs cross-validation only once for each set of parameters.
+ */
+TEST_CASE("CVFunctionMemoizationTest", "[HPTTest]")
+{
+  QuadraticFunction<LARS> lf(1.0, -1.5, 2.5, 3.0);
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 3);
+  CVFunction<decltype(lf), LARS, 3> cvFun(lf, datasetInfo, 0.01, 0.001);
+
+  const arma::vec parameters("0.0 -1.0 2.0");
+  const double objective = cvFun.Evaluate(parameters);
+  REQUIRE(cvFun.NumEvaluations() == 1);
+  REQUIRE(cvFun.Evaluate(parameters) == objective);
+  REQUIRE(cvFun.NumEvaluations() == 1);
+
+  // The gradient only needs one more evaluation for each parameter.
+  arma::mat gradient;
+  cvFun.Gradient(parameters, gradient);
+  REQUIRE(cvFun.NumEvaluations() == 4);
+}
+
 
 void InitProneToOverfittingData(arma::mat& xs,
                                 arma::rowvec& ys,
@@ -324,6 +348,128 @@ TEST_CASE("HPTTest", "[HPTTest]")
   REQUIRE(expectedObjective == Approx(objective).epsilon(1e-7));
 }
 
+/**
+ * Test HyperParameterTuner with KFoldCV finds the same hyper-parameters as an
+ * exhaustive search.
+ */
+TEST_CASE("HPTKFoldCVTest", "[HPTTest]")
+{
+  arma::mat xs = arma::randn(5, 60);
+  arma::vec beta = arma::randn(5, 1);
+  arma::rowvec ys = beta.t() * xs + 0.5 * arma::randn(1, 60);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.01 0.1 1.0 10.0");
+  arma::vec lambda2Set("0.0 0.5 5.0");
+
+  KFoldCV<LARS, MSE> cv(3, xs, ys, false);
+  double expectedObjective = std::numeric_limits<double>::max();
+  double expectedLambda1 = 0.0, expectedLambda2 = 0.0;
+  for (double lambda1 : lambda1Set)
+  {
+    for (double lambda2 : lambda2Set)
+    {
+      const double objective =
+          cv.Evaluate(transposeData, useCholesky, lambda1, lambda2);
+      if (objective < expectedObjective)
+      {
+        expectedObjective = objective;
+        expectedLambda1 = lambda1;
+        expectedLambda2 = lambda2;
+      }
+    }
+  }
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, KFoldCV> hpt(3, xs, ys, false);
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(expectedObjective == Approx(hpt.BestObjective()).epsilon(1e-7));
+  REQUIRE(expectedLambda1 == Approx(actualLambda1).epsilon(1e-7));
+  REQUIRE(expectedLambda2 == Approx(actualLambda2).epsilon(1e-7));
+}
+
+/**
+ * Test successive halving in HyperParameterTuner returns one of the candidates
+ * with its objective on all the data, and the model trained with it.
+ */
+TEST_CASE("HPTSuccessiveHalvingTest", "[HPTTest]")
+{
+  arma::mat xs = arma::randn(5, 200);
+  arma::vec beta = arma::randn(5, 1);
+  arma::rowvec ys = beta.t() * xs + 0.5 * arma::randn(1, 200);
+  double validationSize = 0.25;
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  HyperParameterTuner<LARS, MSE, SimpleCV> hpt(validationSize, xs, ys);
+  hpt.ReductionFactor() = 2;
+
+  double actualLambda1, actualLambda2;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(arma::any(lambda1Set == actualLambda1));
+  REQUIRE(arma::any(lambda2Set == actualLambda2));
+  REQUIRE(hpt.BestObjective() >= expectedObjective - 1e-10);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  const double objective =
+      cv.Evaluate(transposeData, useCholesky, actualLambda1, actualLambda2);
+  REQUIRE(hpt.BestObjective() == Approx(objective).epsilon(1e-7));
+
+  const size_t validationFirstColumn = 150;
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  REQUIRE(MSE::Evaluate(hpt.BestModel(), validationXs, validationYs) ==
+      Approx(objective).epsilon(1e-7));
+
+  // With a reduction factor larger than the number of candidates, all of them
+  // are evaluated on all the data.
+  hpt.ReductionFactor() = 100;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+  REQUIRE(expectedObjective == Approx(hpt.BestObjective()).epsilon(1e-7));
+  REQUIRE(expectedLambda1 == Approx(actualLambda1).epsilon(1e-7));
+  REQUIRE(expectedLambda2 == Approx(actualLambda2).epsilon(1e-7));
+}
+
+/**
+ * Test HyperParameterTuner with warm starts returns one of the candidates, with
+ * the objective of the model trained from scratch with it.
+ */
+TEST_CASE("HPTWarmStartTest", "[HPTTest]")
+{
+  arma::mat xs = arma::randn(3, 200);
+  arma::Row<size_t> ys = arma::conv_to<arma::Row<size_t>>::from(
+      xs.row(0) - xs.row(2) + 0.5 * arma::randn(1, 200) > 0);
+  const double validationSize = 0.25;
+
+  arma::vec lambdas("0.001 0.003 0.01 0.03 0.1 0.3 1.0 3.0 10.0");
+
+  HyperParameterTuner<LogisticRegression<>, Accuracy, SimpleCV>
+      hpt(validationSize, xs, ys);
+  hpt.WarmStart() = true;
+
+  double actualLambda;
+  std::tie(actualLambda) = hpt.Optimize(lambdas);
+  REQUIRE(arma::any(lambdas == actualLambda));
+
+  SimpleCV<LogisticRegression<>, Accuracy> cv(validationSize, xs, ys);
+  REQUIRE(hpt.BestObjective() ==
+      Approx(cv.Evaluate(actualLambda)).epsilon(1e-7));
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
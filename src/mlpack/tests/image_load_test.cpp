@@ -109,6 +109,56 @@ TEST_CASE("LoadVectorImageAPITest", "[ImageLoadTest]")
   REQUIRE(matrix.n_cols == 2);
 }
 
+/**
+ * Test that images are resized and normalized when they are loaded with
+ * LoadImages().
+ */
+TEST_CASE("LoadImagesResizeNormalizeTest", "[ImageLoadTest]")
+{
+  std::vector<std::string> files(5, "test_image.png");
+  arma::mat original;
+  data::ImageInfo info;
+  REQUIRE(data::Load(files, original, info, false) == true);
+
+  // Normalize without resizing.
+  const arma::vec mean("100 120 140");
+  const arma::vec stddev("50 60 70");
+  arma::mat normalized;
+  data::ImageInfo normalizedInfo;
+  REQUIRE(data::LoadImages(files, normalized, normalizedInfo, mean,
+      stddev) == true);
+  REQUIRE(normalized.n_rows == original.n_rows);
+  REQUIRE(normalized.n_cols == 5);
+  for (size_t i = 0; i < normalized.n_elem; ++i)
+  {
+    const size_t c = (i % original.n_rows) % 3;
+    REQUIRE(normalized[i] ==
+        Approx((original[i] - mean[c]) / stddev[c]).epsilon(1e-7));
+  }
+
+  // Resize every image.
+  arma::mat resized;
+  data::ImageInfo resizedInfo(25, 20);
+  REQUIRE(data::LoadImages(files, resized, resizedInfo) == true);
+  REQUIRE(resizedInfo.Width() == 25);
+  REQUIRE(resizedInfo.Height() == 20);
+  REQUIRE(resizedInfo.Channels() == 3);
+  REQUIRE(resized.n_rows == 25 * 20 * 3);
+  REQUIRE(resized.n_cols == 5);
+  REQUIRE(resized.min() >= 0.0);
+  REQUIRE(resized.max() <= 255.0);
+  for (size_t i = 1; i < 5; ++i)
+    CheckMatrices(resized.col(i), resized.col(0));
+
+  // The first pixel of the resized image is the first pixel of the image.
+  for (size_t c = 0; c < 3; ++c)
+    REQUIRE(resized(c, 0) == Approx(original(c, 0)).epsilon(1e-7));
+
+  // A wrong number of channels in the mean.
+  REQUIRE(data::LoadImages(files, resized, resizedInfo, arma::vec("1"),
+      arma::vec("1")) == false);
+}
+
 /**
  * Test if the image is saved correctly using API for arma mat.
  */
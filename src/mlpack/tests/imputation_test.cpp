@@ -266,6 +266,43 @@ TEST_CASE("ListwiseDeletionTest", "[ImputationTest]")
   REQUIRE(rowWiseInput(1, 3) == Approx(8.0).epsilon(1e-7));
 }
 
+/**
+ * Make sure that imputing several dimensions at once gives the same result as
+ * imputing each of them in turn, for each strategy and both orientations.
+ */
+template<typename StrategyType>
+void CheckMultipleDimensions(StrategyType& imputer)
+{
+  arma::mat input = arma::round(5 * arma::randu<arma::mat>(6, 101));
+  input(3, 7) = arma::datum::nan;
+  input.row(5).fill(1.0);
+  std::vector<size_t> dimensions = { 0, 3, 4 };
+  std::vector<double> mappedValues = { 0.0, 2.0, 5.0 };
+
+  for (const bool columnMajor : { true, false })
+  {
+    arma::mat data = columnMajor ? input : arma::mat(input.t());
+    arma::mat expected(data);
+    for (size_t i = 0; i < dimensions.size(); ++i)
+      imputer.Impute(expected, mappedValues[i], dimensions[i], columnMajor);
+
+    imputer.Impute(data, mappedValues, dimensions, columnMajor);
+    CheckMatrices(data, expected);
+  }
+}
+
+TEST_CASE("MultipleDimensionsImputationTest", "[ImputationTest]")
+{
+  MeanImputation<double> mean;
+  CheckMultipleDimensions(mean);
+  MedianImputation<double> median;
+  CheckMultipleDimensions(median);
+  CustomImputation<double> custom(-1.0);
+  CheckMultipleDimensions(custom);
+  ListwiseDeletion<double> deletion;
+  CheckMultipleDimensions(deletion);
+}
+
 /**
  * Make sure we can map non-strings.
  */
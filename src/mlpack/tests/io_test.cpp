@@ -1291,3 +1291,43 @@ TEST_CASE("CppNameTest", "[IOTest]")
   REQUIRE(p.Parameters().at("help").cppType == "bool");
   REQUIRE(p.Parameters().at("double").cppType == "double");
 }
+
+/**
+ * Make sure the number of threads given with --num_threads is used, and that a
+ * negative number of threads is an error.
+ */
+TEST_CASE("NumThreadsParameterTest", "[IOTest]")
+{
+  AddRequiredCLIOptions("NumThreadsParameterTest");
+  CLIOption<int> numThreads(0, "num_threads", "Number of threads.", "", "int",
+      false, true, false, "NumThreadsParameterTest");
+
+  const size_t oldThreads = NumThreads();
+
+  int argc = 3;
+  const char* argv[3];
+  argv[0] = "./test";
+  argv[1] = "--num_threads";
+  argv[2] = "2";
+
+  util::Params p = ParseCommandLine(argc, const_cast<char**>(argv),
+      "NumThreadsParameterTest");
+  util::SetNumThreads(p);
+  #ifdef HAS_OPENMP
+  REQUIRE(NumThreads() == 2);
+  #else
+  REQUIRE(NumThreads() == 1);
+  #endif
+
+  // 0 restores the default number of threads.
+  SetNumThreads(0);
+  REQUIRE(NumThreads() == oldThreads);
+
+  argv[2] = "-1";
+  util::Params p2 = ParseCommandLine(argc, const_cast<char**>(argv),
+      "NumThreadsParameterTest");
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(util::SetNumThreads(p2), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+  REQUIRE(NumThreads() == oldThreads);
+}
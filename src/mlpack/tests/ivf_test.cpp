@@ -0,0 +1,186 @@
+/**
+ * @file tests/ivf_test.cpp
+ *
+ * Test the CoarseQuantizer and IVFSearch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ivf/ivf_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * The coarse quantizer should order every point by list, and probe the lists
+ * closest first.
+ */
+TEST_CASE("CoarseQuantizerTest", "[IVFTest]")
+{
+  arma::mat data(3, 500, arma::fill::randu);
+
+  CoarseQuantizer<> quantizer(10);
+  arma::Row<size_t> assignments;
+  quantizer.Train(data, assignments);
+
+  REQUIRE(quantizer.Centroids().n_cols == 10);
+  REQUIRE(quantizer.ListOffsets().n_elem == 11);
+  REQUIRE(quantizer.ListEnd(9) == 500);
+  for (size_t l = 0; l < 10; ++l)
+  {
+    for (size_t i = quantizer.ListBegin(l); i < quantizer.ListEnd(l); ++i)
+      REQUIRE(assignments[quantizer.Indices()[i]] == l);
+  }
+
+  std::vector<std::pair<double, size_t>> lists;
+  quantizer.Probe(data.col(0), 4, lists);
+  REQUIRE(lists.size() == 4);
+  for (size_t p = 1; p < 4; ++p)
+    REQUIRE(lists[p].first >= lists[p - 1].first);
+  for (size_t l = 0; l < 10; ++l)
+  {
+    REQUIRE(arma::accu(arma::square(data.col(0) -
+        quantizer.Centroids().col(l))) >= lists[0].first - 1e-10);
+  }
+}
+
+/**
+ * When every cell is probed, the search is exact.
+ */
+TEST_CASE("IVFSearchExactTest", "[IVFTest]")
+{
+  arma::mat referenceData(5, 1000, arma::fill::randu);
+  arma::mat queryData(5, 300, arma::fill::randu);
+
+  IVFSearch<> ivf(referenceData, 16, 16);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivf.Search(queryData, 5, neighbors, distances);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances, 1e-4);
+}
+
+/**
+ * Probing a few cells should find most of the true neighbors, and probing more
+ * cells should not find fewer of them.
+ */
+TEST_CASE("IVFSearchRecallTest", "[IVFTest]")
+{
+  arma::mat referenceData(8, 5000, arma::fill::randu);
+  arma::mat queryData(8, 500, arma::fill::randu);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  IVFSearch<> ivf(referenceData, 32);
+
+  size_t found[2] = { 0, 0 };
+  const size_t probes[2] = { 4, 12 };
+  for (size_t p = 0; p < 2; ++p)
+  {
+    ivf.NumProbes() = probes[p];
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    ivf.Search(queryData, 10, neighbors, distances);
+
+    for (size_t q = 0; q < queryData.n_cols; ++q)
+      for (size_t j = 0; j < 10; ++j)
+        found[p] += arma::any(trueNeighbors.col(q) == neighbors(j, q));
+  }
+
+  REQUIRE(found[1] >= found[0]);
+  REQUIRE(found[1] >= 0.9 * trueNeighbors.n_elem);
+}
+
+/**
+ * Single-precision points should give the same neighbors as double-precision
+ * ones when every cell is probed.
+ */
+TEST_CASE("IVFSearchFloatTest", "[IVFTest]")
+{
+  arma::fmat referenceData(6, 800, arma::fill::randu);
+  arma::fmat queryData(6, 100, arma::fill::randu);
+
+  IVFSearch<arma::fmat> ivf(referenceData, 8, 8);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivf.Search(queryData, 3, neighbors, distances);
+
+  arma::mat doubleReferenceData = arma::conv_to<arma::mat>::from(referenceData);
+  arma::mat doubleQueryData = arma::conv_to<arma::mat>::from(queryData);
+  KNN knn(doubleReferenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(doubleQueryData, 3, trueNeighbors, trueDistances);
+
+  // Allow for distances that are equal in single precision.
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    REQUIRE(distances[i] == Approx(trueDistances[i]).epsilon(1e-3));
+}
+
+/**
+ * Make sure that the index gives the same results after serialization.
+ */
+TEST_CASE("IVFSearchSerializationTest", "[IVFTest]")
+{
+  arma::mat referenceData(4, 600, arma::fill::randu);
+  arma::mat queryData(4, 50, arma::fill::randu);
+
+  IVFSearch<> ivf(referenceData, 6, 2);
+  IVFSearch<> xmlIvf, jsonIvf, binaryIvf;
+
+  SerializeObjectAll(ivf, xmlIvf, jsonIvf, binaryIvf);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  ivf.Search(queryData, 4, neighbors, distances);
+  xmlIvf.Search(queryData, 4, xmlNeighbors, xmlDistances);
+  jsonIvf.Search(queryData, 4, jsonNeighbors, jsonDistances);
+  binaryIvf.Search(queryData, 4, binaryNeighbors, binaryDistances);
+
+  REQUIRE(binaryIvf.NumProbes() == 2);
+  REQUIRE(binaryIvf.NumLists() == 6);
+
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("IVFSearchInvalidParametersTest", "[IVFTest]")
+{
+  arma::mat referenceData(3, 20, arma::fill::randu);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(IVFSearch<>(0), std::runtime_error);
+  REQUIRE_THROWS_AS(IVFSearch<>(referenceData, 21), std::runtime_error);
+
+  IVFSearch<> ivf(referenceData, 4);
+  REQUIRE_THROWS_AS(ivf.Search(referenceData, 21, neighbors, distances),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(ivf.Search(arma::mat(2, 5, arma::fill::randu), 3,
+      neighbors, distances), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -10,6 +10,8 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/fast_gauss_transform.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
@@ -1297,3 +1299,182 @@ TEST_CASE("GaussianBreadthDualKDTreeMonteCarloKDE", "[KDETest]")
 
   REQUIRE(correctResults > 70);
 }
+
+// The parallel traversals are only used if OpenMP is available.
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the relative error guarantee holds when the dual-tree and
+ * single-tree evaluations are split across several threads, both with a query
+ * set and monochromatically.
+ */
+TEST_CASE("ParallelKDEErrorBoundTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(3, 2000);
+  arma::mat query = arma::randu(3, 1000);
+  const double relError = 0.05;
+  GaussianKernel kernel(0.3);
+
+  arma::vec bfEstimations, bfMonoEstimations;
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  // Monochromatic estimations don't include the point itself.
+  bfMonoEstimations -= 1.0 / reference.n_cols;
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    KDE<> kde(relError, 0.0, kernel,
+        (mode == 0) ? KDEMode::DUAL_TREE_MODE : KDEMode::SINGLE_TREE_MODE);
+    kde.Train(reference);
+
+    arma::vec estimations, monoEstimations;
+    kde.Evaluate(query, estimations);
+    kde.Evaluate(monoEstimations);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+      REQUIRE(estimations[i] == Approx(bfEstimations[i]).epsilon(relError));
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      REQUIRE(monoEstimations[i] ==
+          Approx(bfMonoEstimations[i]).epsilon(relError));
+    }
+  }
+
+  omp_set_num_threads(oldThreads);
+}
+
+#endif
+
+/**
+ * The fast Gauss transform should be within its error tolerance of the exact
+ * estimations.
+ */
+TEST_CASE("FastGaussTransformAccuracyTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 500);
+  const double bandwidth = 0.2;
+  const double epsilon = 1e-4;
+
+  GaussianKernel kernel(bandwidth);
+  arma::vec bfEstimations;
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  FastGaussTransform fgt(bandwidth, epsilon, 100, 20);
+  fgt.Train(reference);
+  REQUIRE(fgt.Order() <= 20);
+
+  arma::vec estimations;
+  fgt.Evaluate(query, estimations);
+
+  REQUIRE(estimations.n_elem == query.n_cols);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(std::abs(estimations[i] - bfEstimations[i]) <= epsilon);
+}
+
+/**
+ * Make sure that the fast Gauss transform gives the same estimations after
+ * serialization.
+ */
+TEST_CASE("FastGaussTransformSerializationTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(3, 500);
+  arma::mat query = arma::randu(3, 100);
+
+  FastGaussTransform fgt(0.5, 1e-3, 20);
+  fgt.Train(reference);
+  FastGaussTransform xmlFgt, jsonFgt, binaryFgt;
+
+  SerializeObjectAll(fgt, xmlFgt, jsonFgt, binaryFgt);
+
+  arma::vec estimations, xmlEstimations, jsonEstimations, binaryEstimations;
+  fgt.Evaluate(query, estimations);
+  xmlFgt.Evaluate(query, xmlEstimations);
+  jsonFgt.Evaluate(query, jsonEstimations);
+  binaryFgt.Evaluate(query, binaryEstimations);
+
+  REQUIRE(binaryFgt.Order() == fgt.Order());
+  CheckMatrices(estimations, xmlEstimations, jsonEstimations,
+      binaryEstimations);
+}
+
+/**
+ * Make sure that the fast Gauss transform rejects invalid parameters.
+ */
+TEST_CASE("FastGaussTransformInvalidParametersTest", "[KDETest]")
+{
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(FastGaussTransform(0.0), std::runtime_error);
+  REQUIRE_THROWS_AS(FastGaussTransform(1.0, 1.0), std::runtime_error);
+  REQUIRE_THROWS_AS(FastGaussTransform(1.0, 1e-3, 0), std::runtime_error);
+
+  FastGaussTransform fgt;
+  arma::vec estimations;
+  REQUIRE_THROWS_AS(fgt.Evaluate(arma::randu(2, 10), estimations),
+      std::runtime_error);
+
+  fgt.Train(arma::randu(2, 10));
+  REQUIRE(fgt.NumClusters() == 10);
+  REQUIRE_THROWS_AS(fgt.Evaluate(arma::randu(3, 10), estimations),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Queries prepared once with KDEModel::PrepareQueries() should give the same
+ * estimations as the usual evaluation, with several models that use the same
+ * tree type but different kernels.
+ */
+TEST_CASE("KDEModelPreparedQueriesTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(3, 300);
+  arma::mat query = arma::randu(3, 100);
+  util::Timers timers;
+
+  const KDEModel::TreeTypes treeTypes[] = { KDEModel::TreeTypes::KD_TREE,
+      KDEModel::TreeTypes::COVER_TREE };
+  const KDEMode modes[] = { KDEMode::DUAL_TREE_MODE,
+      KDEMode::SINGLE_TREE_MODE };
+  for (size_t t = 0; t < 2; ++t)
+  {
+    for (size_t m = 0; m < 2; ++m)
+    {
+      KDEModel gaussian(0.4, 0.0, 0.0, KDEModel::KernelTypes::GAUSSIAN_KERNEL,
+          treeTypes[t], false);
+      KDEModel epanechnikov(0.4, 0.0, 0.0,
+          KDEModel::KernelTypes::EPANECHNIKOV_KERNEL, treeTypes[t], false);
+      arma::mat referenceCopy(reference);
+      gaussian.BuildModel(timers, std::move(referenceCopy));
+      referenceCopy = reference;
+      epanechnikov.BuildModel(timers, std::move(referenceCopy));
+      gaussian.Mode() = modes[m];
+      epanechnikov.Mode() = modes[m];
+
+      arma::mat queryCopy(query);
+      tree::PreparedQueries* queries = gaussian.PrepareQueries(timers,
+          std::move(queryCopy));
+
+      for (size_t i = 0; i < 4; ++i)
+      {
+        KDEModel& model = (i % 2 == 0) ? gaussian : epanechnikov;
+        arma::vec estimations, baselineEstimations;
+        queryCopy = query;
+        model.Evaluate(timers, std::move(queryCopy), baselineEstimations);
+        model.Evaluate(timers, *queries, estimations);
+
+        REQUIRE(estimations.n_elem == query.n_cols);
+        for (size_t j = 0; j < query.n_cols; ++j)
+        {
+          REQUIRE(estimations[j] ==
+              Approx(baselineEstimations[j]).epsilon(1e-8));
+        }
+      }
+
+      delete queries;
+    }
+  }
+}
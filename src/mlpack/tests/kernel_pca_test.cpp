@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_features_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_pca.hpp>
 
 #include "catch.hpp"
@@ -147,3 +148,33 @@ TEST_CASE("CircleTransformationTestNystroem", "[KernelPCATest]")
   REQUIRE(ranges[0].Contains(ranges[2]) == false);
   REQUIRE(ranges[1].Contains(ranges[2]) == false);
 }
+
+/**
+ * With enough random Fourier features, the largest kernel principal component
+ * should have about the same eigenvalue as with the exact kernel matrix.
+ */
+TEST_CASE("RandomFourierFeaturesEigenvalueTest", "[KernelPCATest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 100);
+
+  KernelPCA<GaussianKernel> exact(GaussianKernel(0.5));
+  arma::mat transformed, eigvec;
+  arma::vec eigval;
+  exact.Apply(dataset, transformed, eigval, eigvec);
+
+  KernelPCA<GaussianKernel, RandomFourierFeaturesKernelRule<GaussianKernel>>
+      approx(GaussianKernel(0.5));
+  arma::mat transformedApprox, eigvecApprox;
+  arma::vec eigvalApprox;
+  approx.Apply(dataset, transformedApprox, eigvalApprox, eigvecApprox, 5000);
+
+  REQUIRE(transformedApprox.n_cols == 100);
+  REQUIRE(eigvalApprox[0] == Approx(eigval[0]).epsilon(0.05));
+
+  // The Laplacian kernel has random features too.
+  KernelPCA<LaplacianKernel, RandomFourierFeaturesKernelRule<LaplacianKernel>>
+      laplacian(LaplacianKernel(0.5));
+  laplacian.Apply(dataset, transformedApprox, eigvalApprox, eigvecApprox, 50);
+  REQUIRE(transformedApprox.n_rows == 50);
+  REQUIRE(transformedApprox.is_finite());
+}
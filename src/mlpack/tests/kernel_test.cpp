@@ -14,6 +14,7 @@
 #include <mlpack/core/kernels/epanechnikov_kernel.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/kernels/laplacian_kernel.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
@@ -632,3 +633,110 @@ TEST_CASE("CauchyKernelTest", "[KernelTest]")
   REQUIRE(ck.Evaluate(a, b) == Approx(0.92592588).epsilon(1e-7));
   REQUIRE(ck.Evaluate(b, a) == Approx(0.92592588).epsilon(1e-7));
 }
+
+/**
+ * Check that a kernel matrix, computed with KernelMatrix(), holds the kernel
+ * evaluations of the given points.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(const KernelType& kernel)
+{
+  const arma::mat a = arma::randu<arma::mat>(4, 30);
+  const arma::mat b = arma::randu<arma::mat>(4, 20);
+  KernelType evaluator(kernel);
+
+  arma::mat kernelMatrix;
+  KernelMatrix(kernel, a, b, kernelMatrix);
+  REQUIRE(kernelMatrix.n_rows == 30);
+  REQUIRE(kernelMatrix.n_cols == 20);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(kernelMatrix(i, j) == Approx(evaluator.Evaluate(a.col(i),
+          b.col(j))).epsilon(1e-10).margin(1e-12));
+    }
+  }
+
+  KernelMatrix(kernel, a, kernelMatrix);
+  REQUIRE(kernelMatrix.n_rows == 30);
+  REQUIRE(kernelMatrix.n_cols == 30);
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(kernelMatrix(i, j) == Approx(evaluator.Evaluate(a.col(i),
+          a.col(j))).epsilon(1e-10).margin(1e-12));
+    }
+  }
+}
+
+/**
+ * A Gaussian kernel without KernelTraits, so that its kernel matrices are
+ * evaluated entry by entry.
+ */
+class EntrywiseGaussianKernel : public GaussianKernel
+{
+ public:
+  EntrywiseGaussianKernel(const double bandwidth) : GaussianKernel(bandwidth)
+  { }
+};
+
+/**
+ * The kernel matrices computed with the batched Evaluate() of the kernels and
+ * the ones evaluated entry by entry should be right.
+ */
+TEST_CASE("KernelMatrixTest", "[KernelTest]")
+{
+  CheckKernelMatrix(LinearKernel());
+  CheckKernelMatrix(PolynomialKernel(3.0, 0.5));
+  CheckKernelMatrix(HyperbolicTangentKernel(0.5, 0.2));
+  CheckKernelMatrix(GaussianKernel(0.7));
+  CheckKernelMatrix(LaplacianKernel(0.7));
+  CheckKernelMatrix(EpanechnikovKernel(2.0));
+  CheckKernelMatrix(CosineDistance());
+  CheckKernelMatrix(TriangularKernel(1.5));
+  CheckKernelMatrix(CauchyKernel(0.8));
+  CheckKernelMatrix(EntrywiseGaussianKernel(0.7));
+}
+
+/**
+ * The batched Evaluate() of each kernel should match the evaluations of each
+ * pair of points, also on subviews, and with a zero vector for the cosine
+ * distance.
+ */
+template<typename KernelType>
+void CheckBatchEvaluation(KernelType kernel)
+{
+  static_assert(KernelTraits<KernelType>::HasBatchEvaluation,
+      "The kernel should have a batched Evaluate().");
+
+  arma::mat data = arma::randu<arma::mat>(3, 40);
+  data.col(5).zeros();
+  arma::mat output;
+  kernel.Evaluate(data.cols(0, 9), data.cols(10, 39), output);
+  REQUIRE(output.n_rows == 10);
+  REQUIRE(output.n_cols == 30);
+  for (size_t j = 0; j < output.n_cols; ++j)
+  {
+    for (size_t i = 0; i < output.n_rows; ++i)
+    {
+      REQUIRE(output(i, j) == Approx(kernel.Evaluate(data.col(i),
+          data.col(10 + j))).epsilon(1e-10).margin(1e-12));
+    }
+  }
+}
+
+TEST_CASE("KernelBatchEvaluationTest", "[KernelTest]")
+{
+  CheckBatchEvaluation(LinearKernel());
+  CheckBatchEvaluation(PolynomialKernel(2.0, 1.0));
+  CheckBatchEvaluation(HyperbolicTangentKernel(0.3, 0.1));
+  CheckBatchEvaluation(CosineDistance());
+  CheckBatchEvaluation(GaussianKernel(0.5));
+  CheckBatchEvaluation(LaplacianKernel(0.5));
+  CheckBatchEvaluation(EpanechnikovKernel(1.2));
+  CheckBatchEvaluation(TriangularKernel(1.2));
+  CheckBatchEvaluation(SphericalKernel(0.6));
+  CheckBatchEvaluation(CauchyKernel(0.5));
+}
@@ -13,10 +13,13 @@
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
 #include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
@@ -553,6 +556,134 @@ TEST_CASE("KMeansPlusPlusTest", "[KMeansTest]")
   REQUIRE(distortion < 14500.0);
 }
 
+/**
+ * Test that the k-means|| initialization strategy returns decent initial
+ * cluster estimates, and that it can be used as the initial partition policy
+ * of KMeans.
+ */
+TEST_CASE("KMeansParallelInitializationTest", "[KMeansTest]")
+{
+  // The same dataset as KMeansPlusPlusTest.
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0  5 -2 -6  1;"
+                      " 0  0 -2  8  6;"
+                      " 0 -2 -2  8  1");
+
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1800; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1800; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  KMeansParallelInitialization k;
+  arma::mat resultingCentroids;
+  k.Cluster(data, 5, resultingCentroids);
+  REQUIRE(resultingCentroids.n_rows == 3);
+  REQUIRE(resultingCentroids.n_cols == 5);
+
+  // Calculate sum of distances from the closest centroids.
+  double distortion = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double bestDist = DBL_MAX;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      bestDist = std::min(bestDist, metric::EuclideanDistance::Evaluate(
+          data.col(i), resultingCentroids.col(j)));
+    }
+    distortion += bestDist;
+  }
+
+  // The weighted reclustering should do at least as well as k-means++.
+  REQUIRE(distortion < 14500.0);
+
+  // Now use it to initialize KMeans, which should find the true centroids.
+  KMeans<metric::EuclideanDistance, KMeansParallelInitialization> km;
+  arma::mat kmCentroids;
+  km.Cluster(data, 5, kmCentroids);
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    double bestDist = DBL_MAX;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      bestDist = std::min(bestDist, metric::EuclideanDistance::Evaluate(
+          centroids.col(i), kmCentroids.col(j)));
+    }
+    REQUIRE(bestDist < 0.5);
+  }
+
+  // With more clusters than points, every centroid should be a point.
+  arma::mat smallData(3, 4, arma::fill::randu);
+  k.Cluster(smallData, 6, resultingCentroids);
+  REQUIRE(resultingCentroids.n_cols == 6);
+  for (size_t j = 0; j < resultingCentroids.n_cols; ++j)
+  {
+    bool found = false;
+    for (size_t i = 0; i < smallData.n_cols; ++i)
+    {
+      found |= arma::approx_equal(smallData.col(i), resultingCentroids.col(j),
+          "absdiff", 1e-12);
+    }
+    REQUIRE(found);
+  }
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure the k-means|| initialization doesn't depend on the number of
+ * threads.
+ */
+TEST_CASE("KMeansParallelInitializationThreadsTest", "[KMeansTest]")
+{
+  arma::mat data(5, 10000, arma::fill::randu);
+
+  const int oldThreads = omp_get_max_threads();
+  KMeansParallelInitialization k(2.0, 3);
+  arma::mat serialCentroids, centroids;
+
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  k.Cluster(data, 20, serialCentroids);
+
+  omp_set_num_threads(4);
+  math::RandomSeed(42);
+  k.Cluster(data, 20, centroids);
+  omp_set_num_threads(oldThreads);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(centroids[i] == Approx(serialCentroids[i]).epsilon(1e-10));
+}
+
+/**
+ * Make sure that k-means gives the same result in NUMA mode, where the Lloyd
+ * steps work on a copy of the data.
+ */
+TEST_CASE("KMeansNUMAModeTest", "[KMeansTest]")
+{
+  arma::mat data(5, 5000, arma::fill::randu);
+  arma::mat initialCentroids = data.cols(0, 9);
+
+  KMeans<> kmeans;
+  arma::mat centroids(initialCentroids), numaCentroids(initialCentroids);
+  kmeans.Cluster(data, 10, centroids, true);
+
+  SetNUMAMode(true);
+  kmeans.Cluster(data, 10, numaCentroids, true);
+  SetNUMAMode(false);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(numaCentroids[i] == Approx(centroids[i]).epsilon(1e-10));
+}
+
+#endif
+
 #ifdef ARMA_HAS_SPMAT
 /**
  * Make sure sparse k-means works okay.
@@ -669,6 +800,188 @@ TEST_CASE("HamerlyTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Generate three well-separated Gaussian clusters, and return the true
+ * centroids and a point of each cluster.
+ */
+void MiniBatchData(arma::mat& dataset,
+                   arma::mat& trueCentroids,
+                   arma::mat& seeds)
+{
+  trueCentroids = { { 0.0, 10.0, -10.0 },
+                    { 0.0, 10.0,   5.0 } };
+  dataset.randn(2, 6000);
+  dataset *= 0.3;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) += trueCentroids.col(i % 3);
+  dataset = arma::shuffle(dataset, 1);
+
+  seeds.set_size(2, 3);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t c = 0; c < 3; ++c)
+    {
+      if (arma::norm(dataset.col(i) - trueCentroids.col(c)) < 1.0)
+        seeds.col(c) = dataset.col(i);
+    }
+  }
+}
+
+/**
+ * Make sure that mini-batch k-means finds well-separated clusters.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset, trueCentroids, centroids;
+  MiniBatchData(dataset, trueCentroids, centroids);
+
+  KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters,
+      MiniBatchKMeans> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  for (size_t c = 0; c < 3; ++c)
+    REQUIRE(arma::norm(centroids.col(c) - trueCentroids.col(c)) < 0.1);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const arma::vec distances = arma::sqrt(arma::sum(arma::square(
+        trueCentroids.each_col() - dataset.col(i)), 0)).t();
+    REQUIRE(assignments[i] == distances.index_min());
+  }
+}
+
+/**
+ * Make sure that KMeans::PartialFit() finds well-separated clusters from
+ * chunks of the data.
+ */
+TEST_CASE("KMeansPartialFitTest", "[KMeansTest]")
+{
+  arma::mat dataset, trueCentroids, centroids;
+  MiniBatchData(dataset, trueCentroids, centroids);
+
+  KMeans<> kmeans;
+  arma::Col<size_t> counts(3, arma::fill::zeros);
+  double firstDistance = 0.0, lastDistance = 0.0;
+  for (size_t chunk = 0; chunk < 10; ++chunk)
+  {
+    const arma::mat data = dataset.cols(chunk * 600, chunk * 600 + 599);
+    lastDistance = kmeans.PartialFit(data, 3, centroids, counts);
+    if (chunk == 0)
+      firstDistance = lastDistance;
+  }
+
+  REQUIRE(arma::accu(counts) == dataset.n_cols);
+  REQUIRE(lastDistance <= firstDistance);
+  for (size_t c = 0; c < 3; ++c)
+    REQUIRE(arma::norm(centroids.col(c) - trueCentroids.col(c)) < 0.1);
+
+  // If the counts are empty, the centroids are initialized from the first
+  // chunk.
+  arma::mat newCentroids;
+  arma::Col<size_t> newCounts;
+  kmeans.PartialFit(dataset.cols(0, 599), 3, newCentroids, newCounts);
+  REQUIRE(newCentroids.n_rows == 2);
+  REQUIRE(newCentroids.n_cols == 3);
+  REQUIRE(arma::accu(newCounts) == 600);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that Elkan's and Hamerly's algorithms find the same clusters with
+ * several threads as with one.
+ */
+TEST_CASE("ParallelElkanHamerlyTest", "[KMeansTest]")
+{
+  arma::mat dataset(10, 5000, arma::fill::randu);
+  const size_t k = 20;
+  arma::mat centroids(10, k, arma::fill::randu);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      ElkanKMeans> elkan;
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      HamerlyKMeans> hamerly;
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  arma::Row<size_t> serialElkanAssignments, serialHamerlyAssignments;
+  arma::mat serialElkanCentroids(centroids), serialHamerlyCentroids(centroids);
+  elkan.Cluster(dataset, k, serialElkanAssignments, serialElkanCentroids,
+      false, true);
+  hamerly.Cluster(dataset, k, serialHamerlyAssignments,
+      serialHamerlyCentroids, false, true);
+
+  omp_set_num_threads(4);
+  arma::Row<size_t> elkanAssignments, hamerlyAssignments;
+  arma::mat elkanCentroids(centroids), hamerlyCentroids(centroids);
+  elkan.Cluster(dataset, k, elkanAssignments, elkanCentroids, false, true);
+  hamerly.Cluster(dataset, k, hamerlyAssignments, hamerlyCentroids, false,
+      true);
+  omp_set_num_threads(oldThreads);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(elkanAssignments[i] == serialElkanAssignments[i]);
+    REQUIRE(hamerlyAssignments[i] == serialHamerlyAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(elkanCentroids[i] ==
+        Approx(serialElkanCentroids[i]).epsilon(1e-7));
+    REQUIRE(hamerlyCentroids[i] ==
+        Approx(serialHamerlyCentroids[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that the tree-based algorithms, which traverse subtrees of the
+ * dataset in parallel, return the same clusters as the naive algorithm.
+ */
+TEST_CASE("ParallelTreeKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 5000, arma::fill::randu);
+  const size_t k = 50;
+  arma::mat centroids(5, k, arma::fill::randu);
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      PellegMooreKMeans> pellegMoore;
+  arma::Row<size_t> pmAssignments;
+  arma::mat pmCentroids(centroids);
+  pellegMoore.Cluster(dataset, k, pmAssignments, pmCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans> dtnn;
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  omp_set_num_threads(oldThreads);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(assignments[i] == pmAssignments[i]);
+    REQUIRE(assignments[i] == dtnnAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(naiveCentroids[i] == Approx(pmCentroids[i]).epsilon(1e-7));
+    REQUIRE(naiveCentroids[i] == Approx(dtnnCentroids[i]).epsilon(1e-7));
+  }
+}
+
+#endif
+
 TEST_CASE("PellegMooreTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -767,6 +1080,54 @@ TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure that the dual-tree algorithm gives the same iterations as the naive
+ * algorithm when the centroid tree is refit at every iteration instead of
+ * rebuilt.
+ */
+TEST_CASE("DTNNTreeRefitTest", "[KMeansTest]")
+{
+  arma::mat dataset(10, 1000, arma::fill::randu);
+  const size_t k = 30;
+  arma::mat centroids(10, k, arma::fill::randu);
+
+  metric::EuclideanDistance metric;
+  NaiveKMeans<metric::EuclideanDistance, arma::mat> naive(dataset, metric);
+  DefaultDualTreeKMeans<metric::EuclideanDistance, arma::mat> dtnn(dataset,
+      metric);
+  dtnn.RefitThreshold() = DBL_MAX;
+
+  arma::mat naiveCentroids(centroids), dtnnCentroids(centroids);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    arma::mat newNaiveCentroids, newDTNNCentroids;
+    arma::Col<size_t> naiveCounts, dtnnCounts;
+    naive.Iterate(naiveCentroids, newNaiveCentroids, naiveCounts);
+    dtnn.Iterate(dtnnCentroids, newDTNNCentroids, dtnnCounts);
+
+    for (size_t c = 0; c < k; ++c)
+    {
+      REQUIRE(naiveCounts[c] == dtnnCounts[c]);
+
+      // Keep empty clusters where they are.
+      if (naiveCounts[c] == 0)
+      {
+        newNaiveCentroids.col(c) = naiveCentroids.col(c);
+        newDTNNCentroids.col(c) = dtnnCentroids.col(c);
+      }
+    }
+
+    for (size_t j = 0; j < newNaiveCentroids.n_elem; ++j)
+    {
+      REQUIRE(newDTNNCentroids[j] ==
+          Approx(newNaiveCentroids[j]).epsilon(1e-7));
+    }
+
+    naiveCentroids = newNaiveCentroids;
+    dtnnCentroids = newDTNNCentroids;
+  }
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -800,3 +1161,59 @@ TEST_CASE("SampleInitializationTest", "[KMeansTest]")
     REQUIRE(j < dataset.n_cols);
   }
 }
+
+/**
+ * Check that the given DistributedKMeans type on a single rank gives the same
+ * clustering as KMeans.
+ */
+template<typename DistributedKMeansType>
+void CheckDistributedKMeansSingleRank()
+{
+  arma::mat dataset(4, 600, arma::fill::randn);
+  dataset.cols(200, 399) += 8.0;
+  dataset.cols(400, 599) -= 8.0;
+
+  arma::mat initialCentroids(4, 3);
+  initialCentroids.col(0) = dataset.col(10);
+  initialCentroids.col(1) = dataset.col(210);
+  initialCentroids.col(2) = dataset.col(410);
+
+  KMeans<> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids = initialCentroids;
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  DistributedKMeansType distributed;
+  REQUIRE(distributed.Communicator().Size() == 1);
+  arma::Row<size_t> distributedAssignments;
+  arma::mat distributedCentroids = initialCentroids;
+  distributed.Cluster(dataset, 3, distributedAssignments,
+      distributedCentroids, true);
+
+  REQUIRE(arma::all(assignments == distributedAssignments));
+  REQUIRE(arma::approx_equal(centroids, distributedCentroids, "absdiff",
+      1e-8));
+
+  // Without an initial guess, the clusters should still be found.
+  distributed.Cluster(dataset, 3, distributedAssignments,
+      distributedCentroids);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const size_t cluster = distributedAssignments[200 * i];
+    REQUIRE(arma::all(distributedAssignments.cols(200 * i, 200 * i + 199) ==
+        cluster));
+  }
+}
+
+/**
+ * Make sure that DistributedKMeans on a single rank gives the same clustering
+ * as KMeans, with the naive, Elkan and Hamerly steps.
+ */
+TEST_CASE("DistributedKMeansSingleRankTest", "[KMeansTest]")
+{
+  CheckDistributedKMeansSingleRank<DistributedKMeans<>>();
+  CheckDistributedKMeansSingleRank<DistributedKMeans<LocalCommunicator,
+      EuclideanDistance, SampleInitialization, ElkanKMeans>>();
+  CheckDistributedKMeansSingleRank<DistributedKMeans<LocalCommunicator,
+      EuclideanDistance, SampleInitialization, HamerlyKMeans>>();
+}
@@ -10,10 +10,16 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/concurrent_neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/ns_auto_tuner.hpp>
+#include <mlpack/methods/neighbor_search/partitioned_neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/sparse_cosine_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+#include "serialization.hpp"
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
 
@@ -1243,6 +1249,141 @@ TEST_CASE("KNNModelMonochromaticTest", "[KNNTest]")
   }
 }
 
+/**
+ * Queries prepared once with NSModel::PrepareQueries() should give the same
+ * results as the usual search for several searches with different k, and
+ * should be usable with a second model of the same type.
+ */
+TEST_CASE("KNNModelPreparedQueriesTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  util::Timers timers;
+
+  arma::mat queryData = arma::randu<arma::mat>(5, 100);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  arma::mat otherReferenceData = arma::randu<arma::mat>(5, 200);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::TreeTypes::KD_TREE,
+      KNNModel::TreeTypes::COVER_TREE, KNNModel::TreeTypes::BALL_TREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE,
+      NAIVE_MODE };
+
+  for (size_t t = 0; t < 3; ++t)
+  {
+    for (size_t m = 0; m < 3; ++m)
+    {
+      KNNModel model(treeTypes[t], false);
+      KNNModel otherModel(treeTypes[t], false);
+      model.LeafSize() = 10;
+      otherModel.LeafSize() = 10;
+      arma::mat referenceCopy(referenceData);
+      arma::mat otherReferenceCopy(otherReferenceData);
+      model.BuildModel(timers, std::move(referenceCopy), modes[m]);
+      otherModel.BuildModel(timers, std::move(otherReferenceCopy), modes[m]);
+
+      arma::mat queryCopy(queryData);
+      tree::PreparedQueries* queries = model.PrepareQueries(timers,
+          std::move(queryCopy));
+
+      // Search with a small k first, so that stale bounds in the query tree
+      // would prune too much in the second search.
+      const size_t ks[] = { 2, 7 };
+      for (size_t i = 0; i < 3; ++i)
+      {
+        const size_t k = ks[i % 2];
+        KNN knn((i == 2) ? otherReferenceData : referenceData);
+        arma::Mat<size_t> baselineNeighbors;
+        arma::mat baselineDistances;
+        knn.Search(queryData, k, baselineNeighbors, baselineDistances);
+
+        arma::Mat<size_t> neighbors;
+        arma::mat distances;
+        if (i == 2)
+          otherModel.Search(timers, *queries, k, neighbors, distances);
+        else
+          model.Search(timers, *queries, k, neighbors, distances);
+
+        REQUIRE(neighbors.n_rows == k);
+        REQUIRE(neighbors.n_cols == queryData.n_cols);
+        for (size_t j = 0; j < neighbors.n_elem; ++j)
+        {
+          REQUIRE(neighbors[j] == baselineNeighbors[j]);
+          REQUIRE(distances[j] == Approx(baselineDistances[j]).epsilon(1e-7));
+        }
+      }
+
+      delete queries;
+    }
+  }
+
+  // Queries prepared with a query tree of another type cannot be used.
+  KNNModel kdModel(KNNModel::TreeTypes::KD_TREE, false);
+  KNNModel ballModel(KNNModel::TreeTypes::BALL_TREE, false);
+  arma::mat referenceCopy(referenceData);
+  arma::mat otherReferenceCopy(referenceData);
+  kdModel.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+  ballModel.BuildModel(timers, std::move(otherReferenceCopy), DUAL_TREE_MODE);
+
+  arma::mat queryCopy(queryData);
+  tree::PreparedQueries* queries = kdModel.PrepareQueries(timers,
+      std::move(queryCopy));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(ballModel.Search(timers, *queries, 3, neighbors,
+      distances), std::invalid_argument);
+  delete queries;
+}
+
+/**
+ * An NSModel using an HNSW graph should find most of the true neighbors, both
+ * after building and after serialization.
+ */
+TEST_CASE("KNNModelHNSWTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  util::Timers timers;
+
+  arma::mat referenceData = arma::randu<arma::mat>(10, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(10, 100);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 5, baselineNeighbors, baselineDistances);
+
+  KNNModel model(KNNModel::TreeTypes::HNSW, false);
+  model.MaxConnections() = 12;
+  model.Ef() = 100;
+  arma::mat referenceCopy(referenceData);
+  model.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+
+  KNNModel xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  KNNModel* models[4] = { &model, &xmlModel, &jsonModel, &binaryModel };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(models[i]->TreeType() == KNNModel::TreeTypes::HNSW);
+    REQUIRE(models[i]->MaxConnections() == 12);
+    REQUIRE(models[i]->Ef() == 100);
+
+    arma::mat queryCopy(queryData);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    models[i]->Search(timers, std::move(queryCopy), 5, neighbors, distances);
+
+    REQUIRE(neighbors.n_rows == 5);
+    REQUIRE(neighbors.n_cols == queryData.n_cols);
+
+    size_t found = 0;
+    for (size_t j = 0; j < neighbors.n_cols; ++j)
+      for (size_t l = 0; l < neighbors.n_rows; ++l)
+        found += arma::any(baselineNeighbors.col(j) == neighbors(l, j));
+
+    REQUIRE(found >= 0.95 * baselineNeighbors.n_elem);
+  }
+}
+
 /**
  * If we search twice with the same reference tree, the bounds need to be reset
  * before the second search.  This test ensures that that happens, by making
@@ -1832,3 +1973,947 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(arma::accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+/**
+ * Make sure that kd-tree search with other LMetric distances, where the base
+ * cases of each leaf are computed together, matches naive search.
+ */
+template<typename MetricType>
+void LMetricKNNVsNaiveTest()
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 200);
+
+  typedef NeighborSearch<NearestNeighborSort, MetricType> KNNType;
+  KNNType knn(dataset);
+  KNNType naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  // Dual-tree and single-tree, bichromatic search.
+  knn.Search(querySet, 7, neighbors, distances);
+  naive.Search(querySet, 7, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.SearchMode() = SINGLE_TREE_MODE;
+  knn.Search(querySet, 7, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Monochromatic search must skip the query point itself.
+  knn.SearchMode() = DUAL_TREE_MODE;
+  knn.Search(7, neighbors, distances);
+  naive.Search(7, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+TEST_CASE("KNNManhattanVsNaiveTest", "[KNNTest]")
+{
+  LMetricKNNVsNaiveTest<ManhattanDistance>();
+}
+
+TEST_CASE("KNNL3VsNaiveTest", "[KNNTest]")
+{
+  LMetricKNNVsNaiveTest<LMetric<3, true>>();
+}
+
+/**
+ * Make sure that kNN search works with single-precision data, and gives the
+ * same results as naive search.
+ */
+TEST_CASE("KNNFloatTest", "[KNNTest]")
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(4, 1000);
+  arma::fmat querySet = arma::randu<arma::fmat>(4, 200);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      KDTree> FloatKNN;
+
+  // Train after default construction, to make sure the empty model can be
+  // built too.
+  FloatKNN knn;
+  knn.Train(dataset);
+  FloatKNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.SearchMode() = SINGLE_TREE_MODE;
+  knn.Search(querySet, 5, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // The distances should be close to those computed in double precision.
+  KNN doubleKNN(arma::conv_to<arma::mat>::from(dataset));
+  arma::Mat<size_t> doubleNeighbors;
+  arma::mat doubleDistances;
+  doubleKNN.Search(arma::conv_to<arma::mat>::from(querySet), 5,
+      doubleNeighbors, doubleDistances);
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    REQUIRE(distances[i] == Approx(doubleDistances[i]).epsilon(1e-5));
+}
+
+/**
+ * Make sure that inserting and removing reference points in an R tree gives the
+ * same results as naive search on the modified reference set.
+ */
+TEST_CASE("KNNInsertRemoveTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 200);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      RTree> RTreeKNN;
+  RTreeKNN knn(dataset);
+  knn.Insert(newPoints);
+  REQUIRE(knn.ReferenceSet().n_cols == 700);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  KNN naive(arma::mat(arma::join_rows(dataset, newPoints)), NAIVE_MODE);
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Now remove every third point; the naive model only holds the remaining
+  // points, so its indices must be mapped back.
+  std::vector<size_t> removed, kept;
+  for (size_t i = 0; i < 700; ++i)
+  {
+    if (i % 3 == 0)
+      removed.push_back(i);
+    else
+      kept.push_back(i);
+  }
+
+  knn.Remove(arma::Col<size_t>(removed));
+  REQUIRE_THROWS_AS(knn.Remove(arma::Col<size_t>(removed)),
+      std::invalid_argument);
+
+  arma::uvec keptCols = arma::conv_to<arma::uvec>::from(kept);
+  KNN naiveKept(arma::mat(knn.ReferenceSet().cols(keptCols)), NAIVE_MODE);
+  knn.Search(querySet, 5, neighbors, distances);
+  naiveKept.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+    naiveNeighbors[i] = kept[naiveNeighbors[i]];
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Points can't be removed without a tree.
+  RTreeKNN naiveRTree(dataset, NAIVE_MODE);
+  naiveRTree.Insert(newPoints);
+  REQUIRE(naiveRTree.ReferenceSet().n_cols == 700);
+  REQUIRE_THROWS_AS(naiveRTree.Remove(arma::Col<size_t>(removed)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that points can be inserted into and removed from a kd-tree (which
+ * rearranges the dataset and splits the leaves that grow too large), in all
+ * search modes.
+ */
+TEST_CASE("KNNKDTreeInsertRemoveTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 300);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+  arma::mat allPoints = arma::join_rows(dataset, newPoints);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  KNN naive(allPoints, NAIVE_MODE);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  KNN singleKNN(dataset, SINGLE_TREE_MODE);
+  singleKNN.Insert(newPoints, 10);
+  REQUIRE(singleKNN.ReferenceTree().NumDescendants() == 800);
+  singleKNN.Search(querySet, 5, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  KNN knn(dataset);
+  knn.Insert(newPoints, 10);
+  knn.Search(querySet, 5, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Monochromatic search must also be correct after insertion.
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Now remove every third point.
+  std::vector<size_t> removed, kept;
+  for (size_t i = 0; i < 800; ++i)
+  {
+    if (i % 3 == 0)
+      removed.push_back(i);
+    else
+      kept.push_back(i);
+  }
+
+  knn.Remove(arma::Col<size_t>(removed));
+  REQUIRE(knn.ReferenceTree().NumDescendants() == kept.size());
+  REQUIRE_THROWS_AS(knn.Remove(arma::Col<size_t>(removed)),
+      std::invalid_argument);
+
+  arma::uvec keptCols = arma::conv_to<arma::uvec>::from(kept);
+  KNN naiveKept(arma::mat(allPoints.cols(keptCols)), NAIVE_MODE);
+  knn.Search(querySet, 5, neighbors, distances);
+  naiveKept.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+    naiveNeighbors[i] = kept[naiveNeighbors[i]];
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Inserting after a removal keeps numbering the new points after all the
+  // earlier ones.
+  arma::mat morePoints = arma::randu<arma::mat>(3, 50);
+  knn.Insert(morePoints, 10);
+  REQUIRE(knn.ReferenceTree().NumDescendants() == kept.size() + 50);
+  for (size_t i = 0; i < 50; ++i)
+    kept.push_back(800 + i);
+
+  keptCols = arma::conv_to<arma::uvec>::from(kept);
+  allPoints = arma::join_rows(allPoints, morePoints);
+  KNN naiveMore(arma::mat(allPoints.cols(keptCols)), NAIVE_MODE);
+  knn.Search(querySet, 5, neighbors, distances);
+  naiveMore.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+    naiveNeighbors[i] = kept[naiveNeighbors[i]];
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that NSModel can insert and remove points with the tree types that
+ * support it, and refuses to with the others.
+ */
+TEST_CASE("KNNModelInsertRemoveTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 200);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+  arma::mat allPoints = arma::join_rows(dataset, newPoints);
+  util::Timers timers;
+
+  // Check with and without a random basis.
+  for (size_t r = 0; r < 2; ++r)
+  {
+    KNNModel model(KNNModel::KD_TREE, (r == 1));
+    model.LeafSize() = 10;
+    model.BuildModel(timers, arma::mat(dataset), DUAL_TREE_MODE);
+    model.Insert(timers, arma::mat(newPoints));
+
+    KNNModel naive(KNNModel::KD_TREE, false);
+    naive.BuildModel(timers, arma::mat(allPoints), NAIVE_MODE);
+
+    arma::Mat<size_t> neighbors, naiveNeighbors;
+    arma::mat distances, naiveDistances;
+    model.Search(timers, arma::mat(querySet), 5, neighbors, distances);
+    naive.Search(timers, arma::mat(querySet), 5, naiveNeighbors,
+        naiveDistances);
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+
+    std::vector<size_t> removed, kept;
+    for (size_t i = 0; i < 700; ++i)
+    {
+      if (i % 4 == 1)
+        removed.push_back(i);
+      else
+        kept.push_back(i);
+    }
+    model.Remove(timers, arma::Col<size_t>(removed));
+
+    arma::uvec keptCols = arma::conv_to<arma::uvec>::from(kept);
+    KNNModel naiveKept(KNNModel::KD_TREE, false);
+    naiveKept.BuildModel(timers, arma::mat(allPoints.cols(keptCols)),
+        NAIVE_MODE);
+    model.Search(timers, arma::mat(querySet), 5, neighbors, distances);
+    naiveKept.Search(timers, arma::mat(querySet), 5, naiveNeighbors,
+        naiveDistances);
+    for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+      naiveNeighbors[i] = kept[naiveNeighbors[i]];
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+
+  // Spill trees and UB trees cannot be updated.
+  KNNModel spill(KNNModel::SPILL_TREE, false);
+  spill.BuildModel(timers, arma::mat(dataset), DUAL_TREE_MODE);
+  REQUIRE_THROWS_AS(spill.Insert(timers, arma::mat(newPoints)),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(spill.Remove(timers, arma::Col<size_t>({ 1, 2 })),
+      std::invalid_argument);
+
+  KNNModel ub(KNNModel::UB_TREE, false);
+  ub.BuildModel(timers, arma::mat(dataset), DUAL_TREE_MODE);
+  REQUIRE_THROWS_AS(ub.Insert(timers, arma::mat(newPoints)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that ConcurrentNeighborSearch gives the same results as naive
+ * search after updates, that a failed update leaves it unchanged, and that
+ * searches can run while points are inserted.
+ */
+TEST_CASE("ConcurrentKNNTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 200);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  ConcurrentNeighborSearch<> knn(dataset);
+  REQUIRE(knn.Epoch() == 0);
+
+  knn.Insert(newPoints.cols(0, 99));
+  knn.Remove(arma::Col<size_t>({ 3, 17, 250 }));
+  REQUIRE(knn.Epoch() == 2);
+
+  // The point 3 was removed already, so this fails after removing 4; the
+  // model must not change.
+  REQUIRE_THROWS_AS(knn.Remove(arma::Col<size_t>({ 4, 3 })),
+      std::invalid_argument);
+  REQUIRE(knn.Epoch() == 2);
+  REQUIRE(knn.Snapshot()->ReferenceTree().NumDescendants() == 597);
+
+  // Points can be inserted while searches run.  (Catch is not thread-safe, so
+  // the results are checked after the loop.)
+  size_t unsorted = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:unsorted)
+  for (omp_size_t i = 0; i < 40; ++i)
+  {
+    if (i % 4 == 0)
+    {
+      knn.Insert(newPoints.cols(100 + 10 * (i / 4), 109 + 10 * (i / 4)));
+    }
+    else
+    {
+      arma::Mat<size_t> threadNeighbors;
+      arma::mat threadDistances;
+      knn.Search(querySet, 5, threadNeighbors, threadDistances);
+      for (size_t j = 1; j < 5; ++j)
+      {
+        unsorted += arma::accu(threadDistances.row(j) <
+            threadDistances.row(j - 1));
+      }
+    }
+  }
+
+  REQUIRE(unsorted == 0);
+  REQUIRE(knn.Epoch() == 12);
+  std::shared_ptr<const ConcurrentNeighborSearch<>::NeighborSearchType>
+      model = knn.Snapshot();
+  REQUIRE(model->ReferenceSet().n_cols == 700);
+  REQUIRE(model->ReferenceTree().NumDescendants() == 697);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  // The removed points stay in the reference set, so compare with a naive
+  // search of the points that are left.
+  std::vector<size_t> kept;
+  for (size_t i = 0; i < 700; ++i)
+    if (i != 3 && i != 17 && i != 250)
+      kept.push_back(i);
+
+  arma::uvec keptCols = arma::conv_to<arma::uvec>::from(kept);
+  KNN naive(arma::mat(model->ReferenceSet().cols(keptCols)), NAIVE_MODE);
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+    naiveNeighbors[i] = kept[naiveNeighbors[i]];
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that the traversal statistics are recorded only while they are
+ * started, and that they are consistent.
+ */
+TEST_CASE("KNNTraversalStatisticsTest", "[KNNTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  KNN singleTree(referenceSet, SINGLE_TREE_MODE);
+  KNN dualTree(referenceSet, DUAL_TREE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  TraversalStatistics statistics;
+  singleTree.Search(querySet, 3, neighbors, distances);
+  REQUIRE(statistics.Matrix().n_elem == 0);
+
+  statistics.Start();
+  singleTree.Search(querySet, 3, neighbors, distances);
+  statistics.Stop();
+
+  // Each query visits the root once.
+  arma::Mat<size_t> perDepth = statistics.Matrix();
+  REQUIRE(perDepth.n_rows > 1);
+  REQUIRE(perDepth.n_cols == 3);
+  REQUIRE(perDepth(0, 0) == 100);
+  REQUIRE(statistics.NumVisited() == arma::accu(perDepth.col(0)));
+  REQUIRE(statistics.NumPrunes() > 0);
+
+  // Each leaf evaluation evaluates one base case per point in the leaf.
+  arma::Col<size_t> leafSizes = statistics.LeafSizes();
+  size_t leafBaseCases = 0;
+  for (size_t i = 0; i < leafSizes.n_elem; ++i)
+    leafBaseCases += i * leafSizes[i];
+  REQUIRE(statistics.NumBaseCases() == leafBaseCases);
+  REQUIRE(statistics.NumBaseCases() < 100 * 500);
+
+  // Nothing is recorded after the statistics are stopped.
+  const size_t numVisited = statistics.NumVisited();
+  singleTree.Search(querySet, 3, neighbors, distances);
+  REQUIRE(statistics.NumVisited() == numVisited);
+
+  statistics.Reset();
+  REQUIRE(statistics.NumVisited() == 0);
+
+  statistics.Start();
+  dualTree.Search(querySet, 3, neighbors, distances);
+  statistics.Stop();
+
+  REQUIRE(statistics.NumVisited() > 0);
+  REQUIRE(statistics.NumBaseCases() > 0);
+  REQUIRE(statistics.NumBaseCases() < 100 * 500);
+}
+
+/**
+ * Save the given partitions to files with the given prefix, and return the
+ * names of the files.
+ */
+std::vector<std::string> SavePartitions(
+    const std::vector<arma::mat>& partitions,
+    const std::string& prefix)
+{
+  std::vector<std::string> files;
+  for (size_t i = 0; i < partitions.size(); ++i)
+  {
+    files.push_back(prefix + std::to_string(i) + ".bin");
+    data::Save(files.back(), partitions[i], true);
+  }
+  return files;
+}
+
+/**
+ * The partitioned kNN join should give the same results as KNN, both for a
+ * separate query set and for the self-join, and should skip the partitions of
+ * a distant cluster.
+ */
+TEST_CASE("PartitionedKNNTest", "[KNNTest]")
+{
+  // Two distant clusters of reference points; the queries are all in the
+  // first one.
+  arma::mat referenceData = arma::join_rows(arma::randu<arma::mat>(3, 400),
+      arma::randu<arma::mat>(3, 400) + 10.0);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  std::vector<arma::mat> referencePartitions, queryPartitions;
+  std::vector<std::vector<size_t>> referenceIndices, queryIndices;
+  PartitionedKNN::Partition(referenceData, 100, referencePartitions,
+      referenceIndices);
+  PartitionedKNN::Partition(queryData, 50, queryPartitions, queryIndices);
+  REQUIRE(referencePartitions.size() >= 8);
+  REQUIRE(queryPartitions.size() >= 4);
+
+  // The global index of each point is its index in the concatenation of the
+  // partitions.
+  std::vector<size_t> referenceOriginal, queryOriginal;
+  for (size_t i = 0; i < referenceIndices.size(); ++i)
+  {
+    REQUIRE(referencePartitions[i].n_cols <= 100);
+    referenceOriginal.insert(referenceOriginal.end(),
+        referenceIndices[i].begin(), referenceIndices[i].end());
+  }
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+  {
+    queryOriginal.insert(queryOriginal.end(), queryIndices[i].begin(),
+        queryIndices[i].end());
+  }
+  REQUIRE(referenceOriginal.size() == referenceData.n_cols);
+  REQUIRE(queryOriginal.size() == queryData.n_cols);
+
+  const std::vector<std::string> referenceFiles = SavePartitions(
+      referencePartitions, "knn_join_reference_");
+  const std::vector<std::string> queryFiles = SavePartitions(queryPartitions,
+      "knn_join_query_");
+
+  PartitionedKNN partitionedKNN;
+  partitionedKNN.Train(referenceFiles);
+  REQUIRE(partitionedKNN.NumReferencePoints() == referenceData.n_cols);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> neighbors, baselineNeighbors;
+  arma::mat distances, baselineDistances;
+
+  // Bichromatic join.
+  partitionedKNN.Search(queryFiles, 5, neighbors, distances);
+  knn.Search(queryData, 5, baselineNeighbors, baselineDistances);
+  REQUIRE(neighbors.n_cols == queryData.n_cols);
+  REQUIRE(partitionedKNN.PrunedPairs() > 0);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    const size_t query = queryOriginal[i];
+    for (size_t j = 0; j < 5; ++j)
+    {
+      REQUIRE(referenceOriginal[neighbors(j, i)] ==
+          baselineNeighbors(j, query));
+      REQUIRE(distances(j, i) ==
+          Approx(baselineDistances(j, query)).epsilon(1e-7));
+    }
+  }
+
+  // Self-join.
+  partitionedKNN.Search(5, neighbors, distances);
+  knn.Search(5, baselineNeighbors, baselineDistances);
+  REQUIRE(neighbors.n_cols == referenceData.n_cols);
+  REQUIRE(partitionedKNN.PrunedPairs() > 0);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    const size_t point = referenceOriginal[i];
+    for (size_t j = 0; j < 5; ++j)
+    {
+      REQUIRE(referenceOriginal[neighbors(j, i)] ==
+          baselineNeighbors(j, point));
+      REQUIRE(distances(j, i) ==
+          Approx(baselineDistances(j, point)).epsilon(1e-7));
+    }
+  }
+
+  for (const std::string& file : referenceFiles)
+    remove(file.c_str());
+  for (const std::string& file : queryFiles)
+    remove(file.c_str());
+}
+
+// The parallel dual-tree traversal is only used if OpenMP is available.
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the parallel dual-tree traversal returns the same results as
+ * naive search, both for the bichromatic and the monochromatic case.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ParallelDualTreeKNNTest()
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 1500);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, naiveMonoNeighbors;
+  arma::mat naiveDistances, naiveMonoDistances;
+  naive.Search(queryData, 7, naiveNeighbors, naiveDistances);
+  naive.Search(7, naiveMonoNeighbors, naiveMonoDistances);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      dualTree(referenceData);
+  arma::Mat<size_t> neighbors, monoNeighbors;
+  arma::mat distances, monoDistances;
+  dualTree.Search(queryData, 7, neighbors, distances);
+  dualTree.Search(7, monoNeighbors, monoDistances);
+
+  omp_set_num_threads(oldThreads);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+  CheckMatrices(monoNeighbors, naiveMonoNeighbors);
+  CheckMatrices(monoDistances, naiveMonoDistances);
+}
+
+/**
+ * Make sure that single-tree search gives the same results as naive search
+ * when the query points are split across several threads.
+ */
+TEST_CASE("KNNParallelSingleTreeTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 1500);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(queryData, 7, naiveNeighbors, naiveDistances);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  KNN singleTree(referenceData, SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  singleTree.Search(queryData, 7, neighbors, distances);
+
+  omp_set_num_threads(oldThreads);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+TEST_CASE("KNNParallelDualTreeTest", "[KNNTest]")
+{
+  ParallelDualTreeKNNTest<KDTree>();
+  ParallelDualTreeKNNTest<BallTree>();
+  ParallelDualTreeKNNTest<StandardCoverTree>();
+  ParallelDualTreeKNNTest<RTree>();
+}
+
+#endif
+
+/**
+ * Make sure that single-tree search gives the same results as naive search
+ * when the children of each node are scored at once, with double or single
+ * precision bounds, for trees with two or more children per node.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         typename SortPolicy>
+void ChildBoundsSingleTreeTest()
+{
+  typedef NeighborSearch<SortPolicy, EuclideanDistance, arma::mat, TreeType>
+      NeighborSearchType;
+
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1500);
+  arma::mat queryData = arma::randu<arma::mat>(4, 300);
+
+  NeighborSearchType naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  for (size_t singlePrecision = 0; singlePrecision < 2; ++singlePrecision)
+  {
+    NeighborSearchType singleTree(referenceData, SINGLE_TREE_MODE);
+    singleTree.SinglePrecisionBounds() = (singlePrecision == 1);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    singleTree.Search(queryData, 5, neighbors, distances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+
+    // The monochromatic search also scores the children at once.
+    arma::Mat<size_t> naiveMonoNeighbors, monoNeighbors;
+    arma::mat naiveMonoDistances, monoDistances;
+    naive.Search(5, naiveMonoNeighbors, naiveMonoDistances);
+    singleTree.Search(5, monoNeighbors, monoDistances);
+
+    CheckMatrices(monoNeighbors, naiveMonoNeighbors);
+    CheckMatrices(monoDistances, naiveMonoDistances);
+  }
+}
+
+TEST_CASE("KNNChildBoundsSingleTreeTest", "[KNNTest]")
+{
+  ChildBoundsSingleTreeTest<KDTree, NearestNeighborSort>();
+  ChildBoundsSingleTreeTest<Octree, NearestNeighborSort>();
+  ChildBoundsSingleTreeTest<RStarTree, NearestNeighborSort>();
+  ChildBoundsSingleTreeTest<KDTree, FurthestNeighborSort>();
+}
+
+/**
+ * The naive search with the Euclidean distance computes the distances in tiles
+ * with matrix products; make sure that it gives the exact results, for several
+ * tiles of queries and references, for points far from the origin, for the
+ * furthest neighbors, and for float matrices.
+ */
+TEST_CASE("KNNTiledBruteForceTest", "[KNNTest]")
+{
+  arma::mat referenceData(50, 1300, arma::fill::randn);
+  arma::mat queryData(50, 300, arma::fill::randn);
+  referenceData += 10.0;
+  queryData += 10.0;
+
+  KNN naive(referenceData, NAIVE_MODE);
+  KNN tree(referenceData, DUAL_TREE_MODE);
+
+  arma::Mat<size_t> naiveNeighbors, treeNeighbors;
+  arma::mat naiveDistances, treeDistances;
+  naive.Search(queryData, 10, naiveNeighbors, naiveDistances);
+  tree.Search(queryData, 10, treeNeighbors, treeDistances);
+
+  REQUIRE(naive.BaseCases() == 300 * 1300);
+  CheckMatrices(naiveNeighbors, treeNeighbors);
+  CheckMatrices(naiveDistances, treeDistances);
+
+  naive.Search(10, naiveNeighbors, naiveDistances);
+  tree.Search(10, treeNeighbors, treeDistances);
+
+  CheckMatrices(naiveNeighbors, treeNeighbors);
+  CheckMatrices(naiveDistances, treeDistances);
+
+  KFN naiveFurthest(referenceData, NAIVE_MODE);
+  KFN treeFurthest(referenceData, DUAL_TREE_MODE);
+  naiveFurthest.Search(queryData, 5, naiveNeighbors, naiveDistances);
+  treeFurthest.Search(queryData, 5, treeNeighbors, treeDistances);
+
+  CheckMatrices(naiveNeighbors, treeNeighbors);
+  CheckMatrices(naiveDistances, treeDistances);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat>
+      floatNaive(arma::conv_to<arma::fmat>::from(referenceData), NAIVE_MODE);
+  floatNaive.Search(arma::conv_to<arma::fmat>::from(queryData), 10,
+      naiveNeighbors, naiveDistances);
+  tree.Search(queryData, 10, treeNeighbors, treeDistances);
+
+  CheckMatrices(naiveNeighbors, treeNeighbors);
+  for (size_t i = 0; i < naiveDistances.n_elem; ++i)
+    REQUIRE(naiveDistances[i] == Approx(treeDistances[i]).epsilon(1e-4));
+}
+
+/**
+ * Far from the origin, the expanded distances of the naive search are
+ * dominated by the rounding errors; make sure that the naive search still
+ * gives exactly the results of the base cases of a tree search.
+ */
+TEST_CASE("KNNTiledBruteForceOffsetTest", "[KNNTest]")
+{
+  arma::mat referenceData(3, 1000, arma::fill::randu);
+  arma::mat queryData(3, 200, arma::fill::randu);
+  referenceData += 1e6;
+  queryData += 1e6;
+
+  KNN naive(referenceData, NAIVE_MODE);
+  KNN tree(referenceData, SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> naiveNeighbors, treeNeighbors;
+  arma::mat naiveDistances, treeDistances;
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  tree.Search(5, treeNeighbors, treeDistances);
+
+  REQUIRE(arma::all(arma::vectorise(naiveNeighbors == treeNeighbors)));
+  REQUIRE(arma::all(arma::vectorise(naiveDistances == treeDistances)));
+
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+  tree.Search(queryData, 5, treeNeighbors, treeDistances);
+
+  REQUIRE(arma::all(arma::vectorise(naiveNeighbors == treeNeighbors)));
+  REQUIRE(arma::all(arma::vectorise(naiveDistances == treeDistances)));
+}
+
+/**
+ * Compute the cosine similarities between the points of two sparse sets (one
+ * row per point of the first set).
+ */
+arma::mat CosineSimilarities(const arma::sp_mat& a, const arma::sp_mat& b)
+{
+  return arma::normalise(arma::mat(a), 2, 0).t() *
+      arma::normalise(arma::mat(b), 2, 0);
+}
+
+/**
+ * The k most similar points found with the inverted index must have the
+ * exact similarities, in decreasing order, including the points with no
+ * dimension in common with the query (similarity 0) and those with a negative
+ * similarity.
+ */
+TEST_CASE("SparseCosineSearchKNNTest", "[KNNTest]")
+{
+  arma::sp_mat referenceData, queryData;
+  referenceData.sprandn(300, 400, 0.02);
+  queryData.sprandn(300, 50, 0.02);
+
+  SparseCosineSearch search(referenceData);
+  REQUIRE(search.NumReferences() == 400);
+  REQUIRE(search.Dimensionality() == 300);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat similarities;
+  search.Search(queryData, 30, neighbors, similarities);
+  REQUIRE(neighbors.n_rows == 30);
+  REQUIRE(neighbors.n_cols == 50);
+
+  const arma::mat trueSimilarities = CosineSimilarities(queryData,
+      referenceData);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    const arma::rowvec sorted = arma::sort(trueSimilarities.row(i),
+        "descend");
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(similarities(j, i) == Approx(sorted[j]).margin(1e-10));
+      REQUIRE(similarities(j, i) == Approx(trueSimilarities(i,
+          neighbors(j, i))).margin(1e-10));
+    }
+  }
+
+  // The monochromatic search must not return the point itself.
+  search.Search(20, neighbors, similarities);
+  const arma::mat selfSimilarities = CosineSimilarities(referenceData,
+      referenceData);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    arma::rowvec others = selfSimilarities.row(i);
+    others.shed_col(i);
+    const arma::rowvec sorted = arma::sort(others, "descend");
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(neighbors(j, i) != i);
+      REQUIRE(similarities(j, i) == Approx(sorted[j]).margin(1e-10));
+    }
+  }
+}
+
+/**
+ * The threshold search with prefix filtering must find exactly the points
+ * whose similarity is at least the threshold.
+ */
+TEST_CASE("SparseCosineSearchThresholdTest", "[KNNTest]")
+{
+  arma::sp_mat referenceData, queryData;
+  referenceData.sprandu(100, 500, 0.1);
+  queryData.sprandu(100, 80, 0.1);
+
+  SparseCosineSearch search(referenceData);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> similarities;
+  search.Search(queryData, 0.3, neighbors, similarities);
+  REQUIRE(neighbors.size() == 80);
+
+  const arma::mat trueSimilarities = CosineSimilarities(queryData,
+      referenceData);
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    const arma::uvec expected = arma::find(trueSimilarities.row(i) >= 0.3);
+    REQUIRE(neighbors[i].size() == expected.n_elem);
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+    {
+      REQUIRE(similarities[i][j] == Approx(trueSimilarities(i,
+          neighbors[i][j])).margin(1e-10));
+      if (j > 0)
+        REQUIRE(similarities[i][j] <= similarities[i][j - 1]);
+    }
+    found += neighbors[i].size();
+  }
+
+  // Make sure the test is not trivial.
+  REQUIRE(found > 0);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(search.Search(queryData, 0.0, neighbors, similarities),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * The configuration chosen by the auto-tuner with the default minimum recall
+ * must be exact, and it must be reused from the cache when the same search is
+ * tuned again.
+ */
+TEST_CASE("NSAutoTunerExactTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 500);
+
+  typedef NSAutoTuner<NearestNeighborSort> TunerType;
+  TunerType tuner(1.0, 1000, 100);
+  const TunerType::Configuration configuration = tuner.Tune(referenceData,
+      queryData, 5);
+  REQUIRE(configuration.recall == 1.0);
+  REQUIRE(configuration.cost > 0.0);
+  REQUIRE(tuner.Cache().size() == 1);
+
+  // Only the exact candidates are benchmarked.
+  REQUIRE(tuner.Results().size() > 0);
+  REQUIRE(tuner.Results().size() < tuner.Candidates().size());
+  for (size_t i = 0; i < tuner.Results().size(); ++i)
+  {
+    REQUIRE(tuner.Results()[i].epsilon == 0.0);
+    REQUIRE(tuner.Results()[i].searchMode != GREEDY_SINGLE_TREE_MODE);
+    REQUIRE(tuner.Results()[i].treeType != TunerType::ModelType::HNSW);
+    REQUIRE(tuner.Results()[i].recall == 1.0);
+  }
+
+  util::Timers timers;
+  TunerType::ModelType model(configuration.treeType);
+  model.LeafSize() = configuration.leafSize;
+  model.BuildModel(timers, arma::mat(referenceData), configuration.searchMode,
+      configuration.epsilon);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(timers, arma::mat(queryData), 5, neighbors, distances);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(queryData, 5, trueNeighbors, trueDistances);
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    REQUIRE(distances[i] == Approx(trueDistances[i]).epsilon(1e-7));
+
+  // Tuning the same search again must return the cached configuration.
+  tuner.Cache().begin()->second.cost = -1.0;
+  REQUIRE(tuner.Tune(referenceData, queryData, 5).cost == -1.0);
+  REQUIRE(tuner.Cache().size() == 1);
+
+  // A different search is tuned separately.
+  tuner.Tune(referenceData, 3);
+  REQUIRE(tuner.Cache().size() == 2);
+
+  // The cache is kept by serialization.
+  TunerType xmlTuner, jsonTuner, binaryTuner;
+  SerializeObjectAll(tuner, xmlTuner, jsonTuner, binaryTuner);
+  REQUIRE(xmlTuner.Cache().size() == 2);
+  REQUIRE(jsonTuner.Cache().size() == 2);
+  REQUIRE(binaryTuner.Cache().size() == 2);
+  REQUIRE(binaryTuner.Tune(referenceData, queryData, 5).cost == -1.0);
+}
+
+/**
+ * With a lower minimum recall, the auto-tuner must choose a configuration that
+ * reaches it, and it must report the recall of the naive search as exact.
+ */
+TEST_CASE("NSAutoTunerApproximateTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 2000);
+
+  typedef NSAutoTuner<NearestNeighborSort> TunerType;
+  TunerType tuner(0.6, 500, 100);
+  const TunerType::Configuration& configuration = tuner.Tune(referenceData,
+      10);
+  REQUIRE(configuration.recall >= 0.6);
+
+  for (size_t i = 0; i < tuner.Results().size(); ++i)
+  {
+    const TunerType::Configuration& result = tuner.Results()[i];
+    REQUIRE(result.recall >= 0.0);
+    REQUIRE(result.recall <= 1.0);
+    if (result.searchMode == NAIVE_MODE)
+      REQUIRE(result.recall == 1.0);
+    if (result.recall >= 0.6)
+      REQUIRE(configuration.cost <= result.cost);
+  }
+
+  REQUIRE_THROWS_AS(TunerType(0.0), std::invalid_argument);
+  REQUIRE_THROWS_AS(TunerType(1.5), std::invalid_argument);
+  REQUIRE_THROWS_AS(tuner.Tune(referenceData, 2000), std::invalid_argument);
+}
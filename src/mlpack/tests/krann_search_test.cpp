@@ -14,6 +14,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 
+#include "serialization.hpp"
 #include "catch.hpp"
 
 #include <mlpack/methods/rann/ra_search.hpp>
@@ -572,6 +573,42 @@ TEST_CASE("KRANNNeighborPtrDeleteTest", "[KRANNTest]")
   REQUIRE(distances.n_rows == 3);
 }
 
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the sampling of single-tree and naive rank-approximate search
+ * doesn't depend on the number of threads.
+ */
+TEST_CASE("KRANNThreadsTest", "[KRANNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryset = arma::randu<arma::mat>(3, 500);
+
+  const int oldThreads = omp_get_max_threads();
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    const bool naive = (mode == 0);
+    RASearch<> rann(dataset, naive, !naive, 5.0, 0.95, true);
+
+    arma::Mat<size_t> serialNeighbors, neighbors;
+    arma::mat serialDistances, distances;
+
+    omp_set_num_threads(1);
+    math::RandomSeed(42);
+    rann.Search(queryset, 3, serialNeighbors, serialDistances);
+
+    omp_set_num_threads(4);
+    math::RandomSeed(42);
+    rann.Search(queryset, 3, neighbors, distances);
+    omp_set_num_threads(oldThreads);
+
+    CheckMatrices(neighbors, serialNeighbors);
+    CheckMatrices(distances, serialDistances);
+  }
+}
+
+#endif
+
 /**
  * Test that the rvalue reference move constructor works.
  */
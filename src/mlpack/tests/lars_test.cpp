@@ -11,6 +11,7 @@
  */
 
 #include <mlpack/methods/lars/lars.hpp>
+#include <mlpack/methods/lars/elastic_net_cd.hpp>
 #include <mlpack/core/data/load.hpp>
 
 #include "catch.hpp"
@@ -469,3 +470,123 @@ TEST_CASE("LARSCopyConstructorTest", "[LARSTest]")
   // The output of both models should be the same.
   CheckMatrices(predictions, predictionsFromCopiedModel);
 }
+
+/**
+ * Make sure that the coordinate descent solver finds the same solutions as
+ * LARS, for the LASSO and the Elastic Net.
+ */
+TEST_CASE("ElasticNetCDMatchesLARSTest", "[LARSTest]")
+{
+  arma::mat X;
+  arma::rowvec y;
+
+  for (size_t i = 0; i < 20; ++i)
+  {
+    GenerateProblem(X, y, 100, 10);
+
+    arma::vec sortedAbsCorr = sort(abs(X * y.t()));
+    const double lambda1 = sortedAbsCorr(5);
+    const double lambda2 = (i % 2 == 0) ? 0.0 : lambda1 / 2;
+
+    LARS lars(true, lambda1, lambda2);
+    arma::vec larsBeta;
+    lars.Train(X, y, larsBeta);
+
+    ElasticNetCD cd(lambda1, lambda2, 100000, 1e-13);
+    cd.Train(X, y);
+
+    REQUIRE(cd.Beta().n_elem == larsBeta.n_elem);
+    for (size_t j = 0; j < larsBeta.n_elem; ++j)
+      REQUIRE(cd.Beta()[j] == Approx(larsBeta[j]).margin(1e-6));
+  }
+}
+
+/**
+ * Sparse data should give the same solution as dense data.
+ */
+TEST_CASE("ElasticNetCDSparseTest", "[LARSTest]")
+{
+  arma::sp_mat sparseX;
+  sparseX.sprandu(30, 200, 0.2);
+  arma::mat X(sparseX);
+  const arma::vec trueBeta = arma::randn(30);
+  const arma::rowvec y = trueBeta.t() * X;
+
+  ElasticNetCD dense(0.1, 0.05, 100000, 1e-12);
+  dense.Train(X, y);
+  ElasticNetCD sparse(0.1, 0.05, 100000, 1e-12);
+  sparse.Train(sparseX, y);
+
+  for (size_t j = 0; j < dense.Beta().n_elem; ++j)
+    REQUIRE(sparse.Beta()[j] == Approx(dense.Beta()[j]).margin(1e-8));
+}
+
+/**
+ * Each solution of the regularization path should match a solution computed
+ * from scratch, and the path should start at zero and end at Lambda1().
+ */
+TEST_CASE("ElasticNetCDPathTest", "[LARSTest]")
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 200, 20);
+
+  ElasticNetCD cd(1.0, 0.0, 100000, 1e-12);
+  cd.TrainPath(X, y, 20);
+
+  REQUIRE(cd.BetaPath().size() == 20);
+  REQUIRE(cd.LambdaPath().size() == 20);
+  REQUIRE(arma::norm(cd.BetaPath()[0], 1) == Approx(0.0).margin(1e-10));
+  REQUIRE(cd.LambdaPath()[19] == Approx(1.0));
+  for (size_t i = 1; i < 20; ++i)
+    REQUIRE(cd.LambdaPath()[i] < cd.LambdaPath()[i - 1]);
+
+  for (size_t i = 0; i < 20; i += 5)
+  {
+    ElasticNetCD scratch(cd.LambdaPath()[i], 0.0, 100000, 1e-12);
+    scratch.Train(X, y);
+    for (size_t j = 0; j < 20; ++j)
+    {
+      REQUIRE(cd.BetaPath()[i][j] ==
+          Approx(scratch.Beta()[j]).margin(1e-6));
+    }
+  }
+
+  // A warm start from the solution should not change it.
+  const arma::vec pathBeta = cd.Beta();
+  cd.Train(X, y, true);
+  for (size_t j = 0; j < 20; ++j)
+    REQUIRE(cd.Beta()[j] == Approx(pathBeta[j]).margin(1e-6));
+}
+
+/**
+ * Solving several problems at once, from the data or the Gram matrix, should
+ * give the solution of each problem alone.
+ */
+TEST_CASE("ElasticNetCDMultipleTargetsTest", "[LARSTest]")
+{
+  arma::mat X = arma::randn(15, 150);
+  arma::mat Y = arma::randn(15, 6).t() * X;
+  Y += 0.1 * arma::randn(6, 150);
+
+  ElasticNetCD cd(0.5, 0.1, 100000, 1e-12);
+  arma::mat betas, gramBetas;
+  cd.Solve(X, Y, betas);
+  cd.SolveGram(X * X.t(), X * Y.t(), gramBetas);
+
+  REQUIRE(betas.n_rows == 15);
+  REQUIRE(betas.n_cols == 6);
+  REQUIRE(gramBetas.n_rows == 15);
+  REQUIRE(gramBetas.n_cols == 6);
+
+  for (size_t t = 0; t < 6; ++t)
+  {
+    ElasticNetCD single(0.5, 0.1, 100000, 1e-12);
+    single.Train(X, arma::rowvec(Y.row(t)));
+    for (size_t j = 0; j < 15; ++j)
+    {
+      REQUIRE(betas(j, t) == Approx(single.Beta()[j]).margin(1e-6));
+      REQUIRE(gramBetas(j, t) == Approx(single.Beta()[j]).margin(1e-6));
+    }
+  }
+}
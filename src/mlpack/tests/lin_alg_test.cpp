@@ -13,6 +13,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/math/lin_alg.hpp>
+#include <mlpack/core/math/parallel_multiply.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -266,3 +267,35 @@ TEST_CASE("TestSymKronId", "[LinAlgTest]")
       REQUIRE(lhs(j) == Approx(rhs(j)).epsilon(1e-7));
   }
 }
+
+/**
+ * The parallel products with a sparse matrix, with and without implicit
+ * centering, should match the products with the dense (centered) matrix.
+ */
+TEST_CASE("TestParallelMultiplySparse", "[LinAlgTest]")
+{
+  arma::sp_mat a;
+  a.sprandu(30, 200, 0.1);
+  const arma::mat dense(a);
+  const arma::mat b = arma::randu<arma::mat>(200, 7);
+  const arma::mat c = arma::randu<arma::mat>(30, 7);
+
+  arma::mat product;
+  ParallelMultiply(a, b, product);
+  CheckMatrices(product, dense * b);
+  ParallelMultiplyTrans(a, c, product);
+  CheckMatrices(product, dense.t() * c);
+
+  const arma::mat mean = arma::mean(dense, 1);
+  const arma::mat centered = dense.each_col() - mean.col(0);
+  CenteredMultiply(a, mean, b, product);
+  CheckMatrices(product, centered * b);
+  CenteredMultiplyTrans(a, mean, c, product);
+  CheckMatrices(product, centered.t() * c);
+
+  // The dense products give the same results.
+  CenteredMultiply(dense, mean, b, product);
+  CheckMatrices(product, centered * b);
+  CenteredMultiplyTrans(dense, mean, c, product);
+  CheckMatrices(product, centered.t() * c);
+}
@@ -266,3 +266,60 @@ TEST_CASE("LinearRegressionTrainReturnObjective", "[LinearRegressionTest]")
 
   REQUIRE(std::isfinite(error) == true);
 }
+
+/**
+ * Make sure that training with PartialFit() on chunks of the data gives the
+ * same model as training on all of the data, with weights.
+ */
+TEST_CASE("LinearRegressionPartialFitTest", "[LinearRegressionTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 3000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(3000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(3000);
+
+  LinearRegression lr(dataset, responses, weights, 0.1);
+
+  LinearRegression lrChunks;
+  lrChunks.Lambda() = 0.1;
+  lrChunks.Train(dataset.cols(0, 999), responses.subvec(0, 999),
+      weights.subvec(0, 999));
+  lrChunks.PartialFit(dataset.cols(1000, 1499), responses.subvec(1000, 1499),
+      weights.subvec(1000, 1499));
+  lrChunks.PartialFit(dataset.cols(1500, 2999), responses.subvec(1500, 2999),
+      weights.subvec(1500, 2999));
+
+  REQUIRE(lrChunks.Statistics().Count() == 3000);
+  REQUIRE(lr.Parameters().n_elem == lrChunks.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    REQUIRE(lr.Parameters()[i] ==
+        Approx(lrChunks.Parameters()[i]).epsilon(1e-7));
+}
+
+/**
+ * Make sure that training on sparse data gives the same model as training on
+ * the same data in dense form.
+ */
+TEST_CASE("LinearRegressionSparseTest", "[LinearRegressionTest]")
+{
+  arma::sp_mat sparse;
+  sparse.sprandu(20, 1500, 0.1);
+  const arma::mat dense(sparse);
+  arma::rowvec responses = arma::randu<arma::rowvec>(1500);
+
+  LinearRegression lr(dense, responses, 0.5);
+  LinearRegression lrSparse;
+  lrSparse.Lambda() = 0.5;
+  const double error = lrSparse.Train(sparse, responses);
+
+  REQUIRE(error == Approx(lr.ComputeError(dense, responses)).epsilon(1e-7));
+  REQUIRE(lr.Parameters().n_elem == lrSparse.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    REQUIRE(lr.Parameters()[i] ==
+        Approx(lrSparse.Parameters()[i]).epsilon(1e-7));
+
+  arma::rowvec predictions, sparsePredictions;
+  lr.Predict(dense, predictions);
+  lrSparse.Predict(sparse, sparsePredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(sparsePredictions[i] == Approx(predictions[i]).epsilon(1e-7));
+}
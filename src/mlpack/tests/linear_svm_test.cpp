@@ -1181,3 +1181,108 @@ TEST_CASE("LinearSVMCallbackTest", "[LinearSVMTest]")
 
   REQUIRE(cb.calledEndOptimization == true);
 }
+
+/**
+ * Make sure that the sparse gradient of the linear SVM function is the same as
+ * the dense gradient when there is no regularization.
+ */
+TEST_CASE("LinearSVMSparseGradientTest", "[LinearSVMTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(20, 50, 0.2);
+
+  arma::Row<size_t> labels(50);
+  for (size_t i = 0; i < 50; ++i)
+    labels(i) = math::RandInt(0, 3);
+
+  for (size_t fitIntercept = 0; fitIntercept < 2; ++fitIntercept)
+  {
+    LinearSVMFunction<arma::sp_mat> svmf(data, labels, 3, 0.0, 1.0,
+        fitIntercept);
+
+    arma::mat parameters = arma::randu<arma::mat>(20 + fitIntercept, 3);
+    for (size_t begin = 0; begin < 50; begin += 10)
+    {
+      arma::mat gradient;
+      arma::sp_mat sparseGradient;
+      svmf.Gradient(parameters, begin, gradient, 10);
+      svmf.Gradient(parameters, begin, sparseGradient, 10);
+
+      REQUIRE(sparseGradient.n_rows == gradient.n_rows);
+      REQUIRE(sparseGradient.n_cols == gradient.n_cols);
+      const arma::mat denseGradient(sparseGradient);
+      for (size_t i = 0; i < gradient.n_elem; ++i)
+        REQUIRE(denseGradient[i] == Approx(gradient[i]).margin(1e-10));
+    }
+  }
+}
+
+
+/**
+ * Test that dual coordinate descent trains an accurate model on a
+ * five-Gaussian dataset, with and without the intercept.
+ */
+TEST_CASE("LinearSVMDualCoordinateDescentMultipleClasses", "[LinearSVMTest]")
+{
+  const size_t points = 1000;
+  const size_t numClasses = 5;
+
+  arma::mat identity = arma::eye<arma::mat>(5, 5);
+  GaussianDistribution g[5] = {
+      GaussianDistribution(arma::vec("1.0 9.0 1.0 2.0 2.0"), identity),
+      GaussianDistribution(arma::vec("4.0 3.0 4.0 2.0 2.0"), identity),
+      GaussianDistribution(arma::vec("3.0 2.0 7.0 0.0 5.0"), identity),
+      GaussianDistribution(arma::vec("4.0 1.0 1.0 2.0 7.0"), identity),
+      GaussianDistribution(arma::vec("1.0 0.0 1.0 8.0 3.0"), identity) };
+
+  arma::mat data(5, points), testData(5, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = (i * numClasses) / points;
+    data.col(i) = g[labels[i]].Random();
+    testData.col(i) = g[labels[i]].Random();
+  }
+
+  for (size_t fitIntercept = 0; fitIntercept < 2; ++fitIntercept)
+  {
+    LinearSVM<arma::mat> lsvm(data, labels, numClasses, 0.001, 1.0,
+        fitIntercept, DualCoordinateDescent(1000, 0.01));
+
+    REQUIRE(lsvm.Parameters().n_rows == 5 + fitIntercept);
+    REQUIRE(lsvm.Parameters().n_cols == numClasses);
+    REQUIRE(lsvm.ComputeAccuracy(data, labels) >= 0.95);
+    REQUIRE(lsvm.ComputeAccuracy(testData, labels) >= 0.95);
+  }
+}
+
+/**
+ * Test that dual coordinate descent gives the same model on sparse data as on
+ * the same data stored densely, with and without shrinking.
+ */
+TEST_CASE("LinearSVMDualCoordinateDescentSparse", "[LinearSVMTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(30, 500, 0.1);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  for (size_t shrinking = 0; shrinking < 2; ++shrinking)
+  {
+    math::RandomSeed(42);
+    LinearSVM<arma::mat> lsvm(denseDataset, labels, 3, 0.01, 1.0, true,
+        DualCoordinateDescent(100, 0.1, shrinking));
+    math::RandomSeed(42);
+    LinearSVM<arma::sp_mat> lsvmSparse(dataset, labels, 3, 0.01, 1.0, true,
+        DualCoordinateDescent(100, 0.1, shrinking));
+
+    REQUIRE(lsvm.Parameters().n_elem == lsvmSparse.Parameters().n_elem);
+    for (size_t i = 0; i < lsvm.Parameters().n_elem; ++i)
+    {
+      REQUIRE(lsvm.Parameters()[i] ==
+          Approx(lsvmSparse.Parameters()[i]).margin(1e-8));
+    }
+  }
+}
@@ -101,6 +101,44 @@ TEST_CASE("LMNNImpostorsTest", "[LMNNTest]")
 // Tests for the LMNNFunction
 //
 
+/**
+ * Approximate impostor searches should find differently labeled points within
+ * the allowed relative error of the exact impostors.
+ */
+TEST_CASE("LMNNApproximateImpostorsTest", "[LMNNTest]")
+{
+  arma::mat dataset = arma::randu(3, 300);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+    labels[i] = (i % 3);
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    norm(i) = arma::norm(dataset.col(i));
+
+  Constraints<> constraint(dataset, labels, 3);
+  arma::Mat<size_t> impostors(3, dataset.n_cols);
+  arma::mat distances(3, dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  Constraints<> approxConstraint(dataset, labels, 3);
+  approxConstraint.Epsilon() = 0.5;
+  arma::Mat<size_t> approxImpostors(3, dataset.n_cols);
+  arma::mat approxDistances(3, dataset.n_cols);
+  approxConstraint.Impostors(approxImpostors, approxDistances, dataset, labels,
+      norm);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      REQUIRE(labels[approxImpostors(j, i)] != labels[i]);
+      REQUIRE(approxDistances(j, i) >= distances(j, i) - 1e-10);
+      REQUIRE(approxDistances(j, i) <= 1.5 * distances(j, i) + 1e-10);
+    }
+  }
+}
+
 /**
  * The LMNN function should return the identity matrix as its initial
  * point.
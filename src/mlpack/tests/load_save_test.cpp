@@ -9,10 +9,16 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <fstream>
 #include <sstream>
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
+#include <mlpack/core/data/load_libsvm.hpp>
+#include <mlpack/core/data/data_source.hpp>
+#include <mlpack/core/data/interned_string_map.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
+#include <mlpack/core/data/mlds.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -1543,6 +1549,50 @@ TEST_CASE("CategoricalCSVLoadTest00", "[LoadSaveTest]")
   remove("test.csv");
 }
 
+/**
+ * Make sure that an InternedStringMap finds all the keys inserted into it,
+ * including keys that are prefixes of each other and the empty key, while its
+ * hash table grows.
+ */
+TEST_CASE("InternedStringMapTest", "[LoadSaveTest]")
+{
+  data::InternedStringMap<size_t> map;
+  REQUIRE(map.empty());
+  REQUIRE(map.count("a") == 0);
+
+  std::vector<std::string> keys;
+  keys.push_back("");
+  for (size_t i = 0; i < 5000; ++i)
+    keys.push_back(std::string(1 + i % 7, (char) ('a' + i % 26)) +
+        std::to_string(i));
+  keys.push_back("a");
+  keys.push_back("aa");
+
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    REQUIRE(map.insert(std::make_pair(keys[i], i)));
+    REQUIRE(!map.insert(std::make_pair(keys[i], i + 1)));
+  }
+
+  REQUIRE(map.size() == keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    REQUIRE(map.count(keys[i]) == 1);
+    REQUIRE(map.at(keys[i]) == i);
+    REQUIRE(*map.Find(keys[i].data(), keys[i].size()) == i);
+    REQUIRE(map.Key(i) == keys[i]);
+    REQUIRE(map.Value(i) == i);
+  }
+
+  REQUIRE(map.count("aaa") == 0);
+  REQUIRE(map.Find("a", 0) != NULL);
+  REQUIRE_THROWS_AS(map.at("missing"), std::out_of_range);
+
+  map.clear();
+  REQUIRE(map.size() == 0);
+  REQUIRE(map.count("a") == 0);
+}
+
 TEST_CASE("CategoricalCSVLoadTest01", "[LoadSaveTest]")
 {
   fstream f;
@@ -2001,6 +2051,55 @@ TEST_CASE("CategoricalNontransposedCSVLoadTest04", "[LoadSaveTest]")
     remove("test.csv");
 }
 
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that loading a categorical CSV with several threads gives the same
+ * matrix and mappings as loading it with one thread.
+ */
+TEST_CASE("ParallelCategoricalCSVLoadTest", "[LoadSaveTest]")
+{
+  // The third dimension only becomes categorical near the end of the file.
+  const char* categories[] = { "red", "green", "blue", "\"a, b\"" };
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    f << (i * 0.25) << ", " << categories[(i * 7) % 4] << ", "
+        << ((i == 2900) ? "missing" : std::to_string(i % 5)) << endl;
+  }
+  f.close();
+
+  const int oldThreads = omp_get_max_threads();
+  for (const bool transpose : { true, false })
+  {
+    arma::mat serialMatrix, parallelMatrix;
+    DatasetInfo serialInfo, parallelInfo;
+
+    omp_set_num_threads(1);
+    REQUIRE(data::Load("test.csv", serialMatrix, serialInfo, true,
+        transpose));
+    omp_set_num_threads(4);
+    REQUIRE(data::Load("test.csv", parallelMatrix, parallelInfo, true,
+        transpose));
+    omp_set_num_threads(oldThreads);
+
+    CheckMatrices(serialMatrix, parallelMatrix);
+    REQUIRE(serialInfo.Dimensionality() == parallelInfo.Dimensionality());
+    for (size_t d = 0; d < serialInfo.Dimensionality(); ++d)
+    {
+      REQUIRE(serialInfo.Type(d) == parallelInfo.Type(d));
+      REQUIRE(serialInfo.NumMappings(d) == parallelInfo.NumMappings(d));
+      for (size_t m = 0; m < serialInfo.NumMappings(d); ++m)
+        REQUIRE(serialInfo.UnmapString(m, d) == parallelInfo.UnmapString(m, d));
+    }
+  }
+
+  remove("test.csv");
+}
+
+#endif
+
 /**
  * A harder test CSV based on the concerns in #658.
  */
@@ -2504,3 +2603,288 @@ TEST_CASE("LoadCSVHeaderTest", "[LoadSaveTest]")
   REQUIRE(dataset.n_rows == 4);
   REQUIRE(dataset.n_cols == 2);
 }
+
+// Memory mapping is only available on POSIX systems.
+#ifndef _WIN32
+
+/**
+ * Make sure a memory-mapped Armadillo binary file holds the saved matrix, and
+ * that changes to it are not written back to the file by default.
+ */
+TEST_CASE("MappedMatrixArmaBinaryTest", "[LoadSaveTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 100);
+  REQUIRE(data.quiet_save("test_mapped_file.bin", arma::arma_binary) == true);
+
+  {
+    MappedMatrix<> mapped("test_mapped_file.bin");
+    CheckMatrices(mapped.Matrix(), data);
+
+    // Modify the private mapping.
+    mapped.Matrix().zeros();
+  }
+
+  MappedMatrix<> mapped("test_mapped_file.bin");
+  CheckMatrices(mapped.Matrix(), data);
+
+  // Moving the matrix must not copy the mapped memory.
+  const double* memptr = mapped.Matrix().memptr();
+  arma::mat moved(std::move(mapped.Matrix()));
+  REQUIRE(moved.memptr() == memptr);
+
+  // Loading with the wrong element type should fail.
+  REQUIRE_THROWS_AS(MappedMatrix<float>("test_mapped_file.bin"),
+      std::runtime_error);
+
+  remove("test_mapped_file.bin");
+}
+
+/**
+ * Make sure a memory-mapped raw binary file holds the saved matrix, and that
+ * changes are written back when requested.
+ */
+TEST_CASE("MappedMatrixRawBinaryTest", "[LoadSaveTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 60);
+  REQUIRE(data.quiet_save("test_mapped_file.bin", arma::raw_binary) == true);
+
+  {
+    MappedMatrix<> mapped("test_mapped_file.bin", 5, true);
+    CheckMatrices(mapped.Matrix(), data);
+
+    mapped.Matrix() *= 2.0;
+  }
+
+  MappedMatrix<> mapped("test_mapped_file.bin", 5);
+  CheckMatrices(mapped.Matrix(), 2.0 * data);
+
+  // The file size is not a multiple of 7 columns.
+  REQUIRE_THROWS_AS(MappedMatrix<>("test_mapped_file.bin", 7),
+      std::runtime_error);
+
+  remove("test_mapped_file.bin");
+}
+
+/**
+ * Make sure that a memory-mapped Armadillo binary file is only used in place if
+ * its data is aligned, and that a header with dimensions too large for the file
+ * is rejected even if their product overflows.
+ */
+TEST_CASE("MappedMatrixArmaBinaryAlignmentTest", "[LoadSaveTest]")
+{
+  // The header "ARMA_MAT_BIN_FN008\n4 10\n" takes 24 bytes, so the data is
+  // aligned, and changes can be written back.
+  arma::mat data = arma::randu<arma::mat>(4, 10);
+  REQUIRE(data.quiet_save("test_mapped_file.bin", arma::arma_binary) == true);
+  {
+    MappedMatrix<> mapped("test_mapped_file.bin", 0, true);
+    CheckMatrices(mapped.Matrix(), data);
+    mapped.Matrix() *= 2.0;
+  }
+
+  {
+    MappedMatrix<> mapped("test_mapped_file.bin");
+    CheckMatrices(mapped.Matrix(), 2.0 * data);
+  }
+
+  // The header "ARMA_MAT_BIN_FN008\n4 100\n" takes 25 bytes: the data is
+  // copied, so it can't be written back.
+  data = arma::randu<arma::mat>(4, 100);
+  REQUIRE(data.quiet_save("test_mapped_file.bin", arma::arma_binary) == true);
+  {
+    MappedMatrix<> copied("test_mapped_file.bin");
+    CheckMatrices(copied.Matrix(), data);
+  }
+  REQUIRE_THROWS_AS(MappedMatrix<>("test_mapped_file.bin", 0, true),
+      std::runtime_error);
+
+  // 2^32 x 2^32 x 8 bytes overflows a 64-bit size.
+  std::ofstream file("test_mapped_file.bin", std::ios::binary);
+  file << arma::diskio::gen_bin_header(arma::mat()) << "\n"
+      << "4294967296 4294967296\n" << std::string(64, '\0');
+  file.close();
+  REQUIRE_THROWS_AS(MappedMatrix<>("test_mapped_file.bin"),
+      std::runtime_error);
+
+  remove("test_mapped_file.bin");
+}
+
+#endif
+
+/**
+ * Make sure that reading a text file and an Armadillo binary file with a
+ * DataSource gives the loaded matrix, in batches.
+ */
+TEST_CASE("DataSourceTest", "[LoadSaveTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 250);
+  REQUIRE(data::Save("test_source.csv", data) == true);
+  REQUIRE(data::Save("test_source.bin", data, true, false,
+      arma::arma_binary) == true);
+
+  // The text file is saved with one point per line, so it is loaded with the
+  // precision of the text.
+  arma::mat textData;
+  REQUIRE(data::Load("test_source.csv", textData) == true);
+
+  for (const bool prefetch : { false, true })
+  {
+    data::DataSource<> textSource("test_source.csv", 100, prefetch);
+    data::DataSource<> binarySource("test_source.bin", 100, prefetch);
+    REQUIRE(textSource.Dimensionality() == 3);
+    REQUIRE(binarySource.Dimensionality() == 3);
+
+    // Make two passes, to check Reset().
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      arma::mat batch;
+      size_t points = 0;
+      while (textSource.Next(batch))
+      {
+        REQUIRE(batch.n_cols == std::min(size_t(100), 250 - points));
+        CheckMatrices(batch, textData.cols(points, points + batch.n_cols - 1));
+        points += batch.n_cols;
+      }
+      REQUIRE(points == 250);
+
+      points = 0;
+      while (binarySource.Next(batch))
+      {
+        REQUIRE(batch.n_cols == std::min(size_t(100), 250 - points));
+        CheckMatrices(batch, data.cols(points, points + batch.n_cols - 1));
+        points += batch.n_cols;
+      }
+      REQUIRE(points == 250);
+
+      textSource.Reset();
+      binarySource.Reset();
+    }
+  }
+
+  // HDF5 files can't be read in parts.
+  REQUIRE_THROWS_AS(data::DataSource<>("test_source.h5", 100),
+      std::invalid_argument);
+
+  remove("test_source.csv");
+  remove("test_source.bin");
+}
+
+/**
+ * Make sure that a dataset with categorical dimensions saved in the mlpack
+ * dataset format is loaded with the same values and mappings, also when only
+ * some of the dimensions are loaded.
+ */
+TEST_CASE("MLDSRoundTripTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_mlds.csv", fstream::out);
+  f << "1.5,a,3,x" << endl;
+  f << "2.5,b,4,y" << endl;
+  f << "3.5,a,5,z" << endl;
+  f.close();
+
+  arma::mat data;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_mlds.csv", data, info) == true);
+  REQUIRE(data::Save("test_mlds.mlds", data, info) == true);
+
+  arma::mat loaded;
+  data::DatasetInfo loadedInfo;
+  REQUIRE(data::Load("test_mlds.mlds", loaded, loadedInfo) == true);
+  CheckMatrices(loaded, data);
+  REQUIRE(loadedInfo.Dimensionality() == 4);
+  for (size_t d = 0; d < 4; ++d)
+  {
+    REQUIRE(loadedInfo.Type(d) == info.Type(d));
+    REQUIRE(loadedInfo.NumMappings(d) == info.NumMappings(d));
+  }
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(loadedInfo.UnmapString(loaded(1, i), 1) ==
+        info.UnmapString(data(1, i), 1));
+    REQUIRE(loadedInfo.UnmapString(loaded(3, i), 3) ==
+        info.UnmapString(data(3, i), 3));
+  }
+
+  // Load only the last and the second dimension.
+  arma::mat projected;
+  data::DatasetInfo projectedInfo;
+  data::LoadMLDS("test_mlds.mlds", projected, projectedInfo, { 3, 1 });
+  REQUIRE(projected.n_rows == 2);
+  REQUIRE(projected.n_cols == 3);
+  REQUIRE(projectedInfo.Dimensionality() == 2);
+  CheckMatrices(projected.row(0), data.row(3));
+  CheckMatrices(projected.row(1), data.row(1));
+  REQUIRE(projectedInfo.Type(0) == data::Datatype::categorical);
+  REQUIRE(projectedInfo.UnmapString(projected(0, 2), 0) == "z");
+
+  // Without a DatasetMapper, and untransposed.
+  arma::mat plain;
+  REQUIRE(data::Load("test_mlds.mlds", plain, false, false) == true);
+  CheckMatrices(plain, data.t());
+
+  // A dimension out of range, and the mappings of a format that can't hold
+  // them.
+  REQUIRE_THROWS_AS(data::LoadMLDS("test_mlds.mlds", projected, { 4 }),
+      std::invalid_argument);
+  REQUIRE(data::Save("test_mlds.csv", data, info) == false);
+
+  remove("test_mlds.csv");
+  remove("test_mlds.mlds");
+}
+
+/**
+ * Make sure that LibSVM files are loaded into sparse matrices with one point
+ * per column, and that their labels can be loaded.
+ */
+TEST_CASE("LoadLibSVMTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_libsvm.svm", fstream::out);
+  f << "+1 1:0.5 4:2 # First point." << endl;
+  f << "-1 qid:3 5:1.5 2:-3 3:0" << endl;
+  f << endl;
+  f << "1" << endl;
+  f.close();
+
+  arma::sp_mat matrix;
+  arma::Row<size_t> labels;
+  data::LoadLibSVM("test_libsvm.svm", matrix, labels);
+  REQUIRE(matrix.n_rows == 5);
+  REQUIRE(matrix.n_cols == 3);
+  REQUIRE(matrix.n_nonzero == 4);
+  REQUIRE(matrix(0, 0) == Approx(0.5).epsilon(1e-7));
+  REQUIRE(matrix(3, 0) == Approx(2.0).epsilon(1e-7));
+  REQUIRE(matrix(1, 1) == Approx(-3.0).epsilon(1e-7));
+  REQUIRE(matrix(4, 1) == Approx(1.5).epsilon(1e-7));
+  REQUIRE(labels.n_elem == 3);
+  REQUIRE(labels[0] == 1);
+  REQUIRE(labels[1] == 0);
+  REQUIRE(labels[2] == 1);
+
+  // Signed labels are kept.
+  arma::rowvec signedLabels;
+  data::LoadLibSVM("test_libsvm.svm", matrix, signedLabels, 10);
+  REQUIRE(matrix.n_rows == 10);
+  REQUIRE(signedLabels[1] == -1.0);
+
+  // Through data::Load().
+  arma::sp_mat sparse;
+  REQUIRE(data::Load("test_libsvm.svm", sparse) == true);
+  CheckMatrices(arma::mat(sparse), arma::mat(matrix.rows(0, 4)));
+  arma::mat dense;
+  REQUIRE(data::Load("test_libsvm.svm", dense, false, false) == true);
+  CheckMatrices(dense, arma::mat(sparse).t());
+  arma::Row<size_t> loadedLabels;
+  REQUIRE(data::Load("test_libsvm.svm", loadedLabels) == true);
+  CheckMatrices(loadedLabels, labels);
+
+  // Indices start at 1.
+  f.open("test_libsvm.svm", fstream::out);
+  f << "1 0:0.5" << endl;
+  f.close();
+  REQUIRE_THROWS_AS(data::LoadLibSVM("test_libsvm.svm", matrix, labels),
+      std::runtime_error);
+
+  remove("test_libsvm.svm");
+}
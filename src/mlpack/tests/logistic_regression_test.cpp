@@ -15,6 +15,7 @@
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::regression;
@@ -1081,3 +1082,164 @@ TEST_CASE("IncrementalTraining", "[LogisticRegressionTest]")
 
   REQUIRE(acc == Approx(100.0).epsilon(0.03)); // 3% error tolerance.
 }
+
+/**
+ * Make sure that the sparse gradient of the logistic regression function is
+ * the same as the dense gradient when there is no regularization.
+ */
+TEST_CASE("LogisticRegressionSparseGradientTest", "[LogisticRegressionTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(20, 50, 0.1);
+  arma::Row<size_t> responses(50);
+  for (size_t i = 0; i < 50; ++i)
+    responses[i] = i % 2;
+
+  LogisticRegressionFunction<arma::sp_mat> lrf(data, responses, 0.0);
+
+  arma::mat parameters = arma::randu<arma::mat>(1, 21);
+  for (size_t begin = 0; begin < 50; begin += 10)
+  {
+    arma::mat gradient;
+    arma::sp_mat sparseGradient;
+    lrf.Gradient(parameters, begin, gradient, 10);
+    lrf.Gradient(parameters, begin, sparseGradient, 10);
+
+    REQUIRE(sparseGradient.n_rows == gradient.n_rows);
+    REQUIRE(sparseGradient.n_cols == gradient.n_cols);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      REQUIRE(sparseGradient(0, i) == Approx(gradient[i]).margin(1e-10));
+  }
+}
+
+/**
+ * Make sure that the objective and the gradient are the same for sparse and
+ * dense data, for the whole dataset and for batches.
+ */
+TEST_CASE("LogisticRegressionSparseDenseFunctionTest",
+          "[LogisticRegressionTest]")
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(30, 200, 0.1);
+  const arma::mat denseData(sparseData);
+  arma::Row<size_t> responses(200);
+  for (size_t i = 0; i < 200; ++i)
+    responses[i] = (i % 3 == 0) ? 1 : 0;
+
+  LogisticRegressionFunction<arma::sp_mat> sparseLrf(sparseData, responses,
+      0.5);
+  LogisticRegressionFunction<arma::mat> denseLrf(denseData, responses, 0.5);
+
+  const arma::mat parameters = arma::randn<arma::mat>(1, 31);
+  arma::mat sparseGradient, denseGradient;
+  const double sparseObjective = sparseLrf.EvaluateWithGradient(parameters,
+      sparseGradient);
+  const double denseObjective = denseLrf.EvaluateWithGradient(parameters,
+      denseGradient);
+
+  REQUIRE(sparseObjective == Approx(denseObjective).epsilon(1e-10));
+  REQUIRE(sparseLrf.Evaluate(parameters) ==
+      Approx(denseObjective).epsilon(1e-10));
+  for (size_t i = 0; i < denseGradient.n_elem; ++i)
+    REQUIRE(sparseGradient[i] == Approx(denseGradient[i]).margin(1e-10));
+
+  for (size_t begin = 0; begin < 200; begin += 50)
+  {
+    const double sparseBatchObjective = sparseLrf.EvaluateWithGradient(
+        parameters, begin, sparseGradient, 50);
+    const double denseBatchObjective = denseLrf.EvaluateWithGradient(
+        parameters, begin, denseGradient, 50);
+
+    REQUIRE(sparseBatchObjective ==
+        Approx(denseBatchObjective).epsilon(1e-10));
+    REQUIRE(sparseLrf.Evaluate(parameters, begin, 50) ==
+        Approx(denseBatchObjective).epsilon(1e-10));
+    for (size_t i = 0; i < denseGradient.n_elem; ++i)
+      REQUIRE(sparseGradient[i] == Approx(denseGradient[i]).margin(1e-10));
+  }
+}
+
+/**
+ * Train logistic regression on sparse data with ParallelSGD (Hogwild!), which
+ * uses the sparse gradient.
+ */
+TEST_CASE("LogisticRegressionParallelSGDTest", "[LogisticRegressionTest]")
+{
+  // The points of each class only have nonzero values in their own half of
+  // the features.
+  arma::mat denseData = arma::randu<arma::mat>(20, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    responses[i] = i % 2;
+    if (responses[i] == 0)
+      denseData.submat(10, i, 19, i).zeros();
+    else
+      denseData.submat(0, i, 9, i).zeros();
+
+    // Keep only two nonzero features per point.
+    for (size_t j = 0; j < 20; ++j)
+    {
+      if (math::Random() < 0.8)
+        denseData(j, i) = 0.0;
+    }
+  }
+
+  arma::sp_mat data(denseData);
+
+  ens::ParallelSGD<> optimizer(100000, 10000, 1e-10);
+  LogisticRegression<arma::sp_mat> lr(data.n_rows, 0.0001);
+  lr.Train(data, responses, optimizer);
+
+  // Points without any nonzero feature can't be classified.
+  arma::Row<size_t> predictions;
+  lr.Classify(data, predictions);
+  size_t correct = 0, classifiable = 0;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    if (arma::accu(denseData.col(i)) == 0.0)
+      continue;
+
+    ++classifiable;
+    if (predictions[i] == responses[i])
+      ++correct;
+  }
+
+  REQUIRE(double(correct) / classifiable > 0.95);
+}
+
+
+/**
+ * Make sure that training on a DataSource that holds the whole dataset in one
+ * batch gives the same model as training on the loaded dataset.
+ */
+TEST_CASE("LogisticRegressionDataSourceTest", "[LogisticRegressionTest]")
+{
+  arma::mat data = arma::randn<arma::mat>(3, 200);
+  arma::Row<size_t> responses(200);
+  for (size_t i = 0; i < 200; ++i)
+    responses[i] = (data(0, i) + data(2, i) > 0) ? 1 : 0;
+
+  REQUIRE(data::Save("test_lr_data.bin", data, true, false,
+      arma::arma_binary) == true);
+  REQUIRE(data::Save("test_lr_labels.csv", responses) == true);
+
+  ens::StandardSGD sgd(0.01, 1, 200, 1e-10, false);
+  LogisticRegression<> lr(3, 0.001);
+  lr.Train(data, responses, sgd);
+
+  data::DataSource<> dataSource("test_lr_data.bin", 200);
+  data::DataSource<arma::Mat<size_t>> labelSource("test_lr_labels.csv", 200);
+  LogisticRegression<> streamed(3, 0.001);
+  streamed.Train(dataSource, labelSource, sgd);
+
+  CheckMatrices(lr.Parameters(), streamed.Parameters());
+
+  // Batches with different numbers of points are an error.
+  data::DataSource<arma::Mat<size_t>> smallSource("test_lr_labels.csv", 150);
+  REQUIRE_THROWS_AS(streamed.Train(dataSource, smallSource, sgd),
+      std::invalid_argument);
+
+  remove("test_lr_data.bin");
+  remove("test_lr_labels.csv");
+}
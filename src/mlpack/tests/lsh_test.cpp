@@ -654,6 +654,42 @@ TEST_CASE("LSHTrainTest", "[LSHTest]")
   REQUIRE(distances.n_rows == 3);
 }
 
+/**
+ * Make sure that every point is in exactly one bucket of each table when the
+ * bucket size is unlimited, and that no bucket is larger than the bucket size
+ * otherwise.
+ */
+TEST_CASE("LSHBucketLayoutTest", "[LSHTest]")
+{
+  // Use enough points that they are hashed in more than one block.
+  arma::mat referenceData = arma::randu<arma::mat>(5, 5000);
+  const size_t numTables = 4;
+
+  LSHSearch<> lsh(referenceData, 3, numTables, 0.5, 99901, 0);
+
+  const arma::Col<size_t>& table = lsh.SecondHashTable();
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  REQUIRE(table.n_elem == numTables * referenceData.n_cols);
+  REQUIRE(offsets[0] == 0);
+  REQUIRE(offsets[offsets.n_elem - 1] == table.n_elem);
+
+  arma::Col<size_t> counts(referenceData.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < table.n_elem; ++i)
+    counts[table[i]]++;
+  REQUIRE(arma::all(counts == numTables));
+
+  // Now limit the bucket size.
+  lsh.Train(referenceData, 3, numTables, 0.5, 99901, 3);
+  const arma::Col<size_t>& cappedOffsets = lsh.BucketOffsets();
+  REQUIRE(cappedOffsets[cappedOffsets.n_elem - 1] ==
+      lsh.SecondHashTable().n_elem);
+  for (size_t i = 0; i + 1 < cappedOffsets.n_elem; ++i)
+  {
+    REQUIRE(cappedOffsets[i + 1] > cappedOffsets[i]);
+    REQUIRE(cappedOffsets[i + 1] - cappedOffsets[i] <= 3);
+  }
+}
+
 /**
  * Test: this verifies ComputeRecall works correctly by providing two identical
  * vectors and requiring that Recall is equal to 1.
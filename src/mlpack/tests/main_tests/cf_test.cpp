@@ -141,7 +141,7 @@ TEST_CASE_METHOD(CFTestFixture, "CFNeighborhoodBoundTest",
 /**
  * Ensure algorithm is one of { "NMF", "BatchSVD",
  * "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
- * "BiasSVD", "SVDPP" }.
+ * "BiasSVD", "SVDPP", "ALS" }.
  */
 TEST_CASE_METHOD(CFTestFixture, "CFAlgorithmBoundTest",
                 "[CFMainTest][BindingTests]")
@@ -166,7 +166,7 @@ TEST_CASE_METHOD(CFTestFixture, "CFModelReuseTest",
 {
   std::string algorithms[] = { "NMF", "BatchSVD",
       "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
-      "BiasSVD", "SVDPP" };
+      "BiasSVD", "SVDPP", "ALS" };
 
   mat dataset;
   data::Load("GroupLensSmall.csv", dataset);
@@ -715,3 +715,59 @@ TEST_CASE_METHOD(CFTestFixture, "CFNormalizationTest",
   REQUIRE(arma::any(arma::vectorise(output1 != output2)));
   REQUIRE(arma::any(arma::vectorise(output1 != output3)));
 }
+
+/**
+ * Ensure that the ratings of a new user can be folded into a trained model and
+ * that the new user can then be given recommendations.
+ */
+TEST_CASE_METHOD(CFTestFixture, "CFFoldInTest",
+                "[CFMainTest][BindingTests]")
+{
+  mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+  const size_t userNum = max(dataset.row(0)) + 1;
+
+  SetInputParam("training", dataset);
+  SetInputParam("max_iterations", int(10));
+  SetInputParam("algorithm", std::string("NMF"));
+
+  RUN_BINDING();
+
+  CFModel* m = params.Get<CFModel*>("output_model");
+  ResetSettings();
+
+  // The new user has the ratings of user 0.
+  mat foldIn = dataset.cols(arma::find(dataset.row(0) == 0));
+  foldIn.row(0).fill(userNum);
+  Mat<size_t> query(1, 1);
+  query(0, 0) = userNum;
+
+  SetInputParam("input_model", m);
+  SetInputParam("fold_in", std::move(foldIn));
+  SetInputParam("query", std::move(query));
+  SetInputParam("recommendations", int(5));
+
+  RUN_BINDING();
+
+  const Mat<size_t>& output = params.Get<Mat<size_t>>("output");
+  REQUIRE(output.n_rows == 5);
+  REQUIRE(output.n_cols == 1);
+}
+
+/**
+ * Ensure that ratings to fold in must have three dimensions.
+ */
+TEST_CASE_METHOD(CFTestFixture, "CFFoldInDimensionTest",
+                "[CFMainTest][BindingTests]")
+{
+  mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  SetInputParam("training", dataset);
+  SetInputParam("max_iterations", int(10));
+  SetInputParam("fold_in", mat(dataset.rows(0, 1)));
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
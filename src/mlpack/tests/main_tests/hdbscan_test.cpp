@@ -0,0 +1,84 @@
+/**
+ * @file tests/main_tests/hdbscan_test.cpp
+ *
+ * Test RUN_BINDING() of hdbscan_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hdbscan/hdbscan_main.cpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "main_test_fixture.hpp"
+
+#include "../catch.hpp"
+#include "../test_catch_tools.hpp"
+
+using namespace mlpack;
+
+BINDING_TEST_FIXTURE(HDBSCANTestFixture);
+
+/**
+ * Check that number of output labels and number of input
+ * points are equal.
+ */
+TEST_CASE_METHOD(HDBSCANTestFixture, "HDBSCANOutputDimensionTest",
+                 "[HDBSCANMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Unable to load dataset iris.csv!");
+
+  size_t inputSize = inputData.n_cols;
+
+  SetInputParam("input", inputData);
+  SetInputParam("min_cluster_size", (int) 10);
+
+  RUN_BINDING();
+
+  // Check that number of predicted labels is equal to the input test points.
+  REQUIRE(params.Get<arma::Row<size_t>>("assignments").n_cols == inputSize);
+  REQUIRE(params.Get<arma::Row<size_t>>("assignments").n_rows == 1);
+  REQUIRE(params.Get<arma::mat>("centroids").n_rows == 4);
+  REQUIRE(params.Get<arma::mat>("centroids").n_cols >= 1);
+}
+
+/**
+ * Check that the minimum cluster size must be at least 2.
+ */
+TEST_CASE_METHOD(HDBSCANTestFixture, "HDBSCANMinClusterSizeTest",
+                 "[HDBSCANMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Unable to load dataset iris.csv!");
+
+  SetInputParam("input", inputData);
+  SetInputParam("min_cluster_size", (int) 1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that the number of neighbors can't be negative.
+ */
+TEST_CASE_METHOD(HDBSCANTestFixture, "HDBSCANMinPointsTest",
+                 "[HDBSCANMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Unable to load dataset iris.csv!");
+
+  SetInputParam("input", inputData);
+  SetInputParam("min_points", (int) -1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -52,3 +52,54 @@ TEST_CASE_METHOD(HMMLoglikTestFixture, "HMMLoglikOutputNegativeTest",
   // Since the log of a probability <= 0 ...
   REQUIRE(loglik <= 0);
 }
+
+TEST_CASE_METHOD(HMMLoglikTestFixture, "HMMLoglikLengthsTest",
+                 "[HMMLoglikMainTest][BindingTests]")
+{
+  // Load data to train a discrete HMM model with.
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  // Initialize and train an HMM model.
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+
+  // Score the sequence twice in one call.
+  arma::Col<size_t> lengths = { inp.n_cols, inp.n_cols };
+  SetInputParam("input_model", h);
+  SetInputParam("input", arma::mat(arma::join_rows(inp, inp)));
+  SetInputParam("lengths", lengths);
+
+  RUN_BINDING();
+
+  const arma::vec& logliks = params.Get<arma::vec>("log_likelihoods");
+  REQUIRE(logliks.n_elem == 2);
+  REQUIRE(logliks[0] <= 0);
+  REQUIRE(logliks[0] == Approx(logliks[1]).epsilon(1e-7));
+  REQUIRE(params.Get<double>("log_likelihood") ==
+      Approx(logliks[0] + logliks[1]).epsilon(1e-7));
+}
+
+TEST_CASE_METHOD(HMMLoglikTestFixture, "HMMLoglikWrongLengthsTest",
+                 "[HMMLoglikMainTest][BindingTests]")
+{
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+
+  // The lengths do not add up to the number of observations.
+  arma::Col<size_t> lengths = { inp.n_cols, 1 };
+  SetInputParam("input_model", h);
+  SetInputParam("input", inp);
+  SetInputParam("lengths", lengths);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -227,3 +227,33 @@ TEST_CASE_METHOD(HMMViterbiTestFixture,
   REQUIRE(out.n_rows == 1);
   REQUIRE(out.n_cols == observations.n_cols);
 }
+
+TEST_CASE_METHOD(HMMViterbiTestFixture,
+                 "HMMViterbiLengthsTest",
+                 "[HMMViterbiMainTest][BindingTests]")
+{
+  // Load data to train a discrete HMM model with.
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  // Initialize and train a discrete HMM model.
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+
+  // Predict the same sequence twice in one call.
+  arma::Col<size_t> lengths = { inp.n_cols, inp.n_cols };
+  SetInputParam("input_model", h);
+  SetInputParam("input", arma::mat(arma::join_rows(inp, inp)));
+  SetInputParam("lengths", lengths);
+
+  RUN_BINDING();
+
+  // The output holds both state sequences, which must be the same.
+  arma::Mat<size_t> out = params.Get<arma::Mat<size_t> >("output");
+  REQUIRE(out.n_rows == 1);
+  REQUIRE(out.n_cols == 2 * inp.n_cols);
+  for (size_t i = 0; i < inp.n_cols; ++i)
+    REQUIRE(out[i] == out[inp.n_cols + i]);
+}
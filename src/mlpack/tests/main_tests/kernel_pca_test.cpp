@@ -343,3 +343,47 @@ TEST_CASE_METHOD(KernelPCATestFixture, "KernelPCASamplingSchemeTest",
   REQUIRE(arma::any(arma::vectorise(output2 != output3)));
   REQUIRE(arma::any(arma::vectorise(output1 != output3)));
 }
+
+/**
+ * Random Fourier features should give the right output dimensionality, and
+ * they should only be allowed for shift-invariant kernels.
+ */
+TEST_CASE_METHOD(KernelPCATestFixture, "KernelPCARandomFeaturesTest",
+                 "[KernelPCAMainTest][BindingTests]")
+{
+  arma::mat x = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("input", x);
+  SetInputParam("new_dimensionality", (int) 3);
+  SetInputParam("kernel", (std::string) "gaussian");
+  SetInputParam("random_features", (int) 50);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::mat>("output").n_rows == 3);
+  REQUIRE(params.Get<arma::mat>("output").n_cols == 100);
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("input", x);
+  SetInputParam("kernel", (std::string) "linear");
+  SetInputParam("random_features", (int) 50);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  CleanMemory();
+  ResetSettings();
+
+  // Too few features for the new dimensionality.
+  SetInputParam("input", std::move(x));
+  SetInputParam("new_dimensionality", (int) 4);
+  SetInputParam("kernel", (std::string) "laplacian");
+  SetInputParam("random_features", (int) 2);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -248,6 +248,83 @@ TEST_CASE_METHOD(KNNTestFixture, "KNNInvalidRhoTest",
   Log::Fatal.ignoreInput = false;
 }
 
+/*
+ * Check that we can't pass invalid HNSW graph parameters.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNInvalidHNSWParametersTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 100); // 100 points in 3 dimensions.
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 10);
+  SetInputParam("tree_type", (string) "hnsw");
+  SetInputParam("hnsw_m", (int) 1); // Invalid.
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+
+  // Reset passed parameters.
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("k", (int) 10);
+  SetInputParam("tree_type", (string) "hnsw");
+  SetInputParam("ef", (int) 0); // Invalid.
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Ensure that an HNSW graph can be built, saved, and searched again with a
+ * different search list size.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNHNSWModelReuseTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(5, 500); // 500 points in 5 dimensions.
+
+  arma::mat queryData;
+  queryData.randu(5, 50); // 50 points in 5 dimensions.
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("query", queryData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("tree_type", (string) "hnsw");
+  SetInputParam("hnsw_m", (int) 8);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::Mat<size_t>>("neighbors").n_rows == 5);
+  REQUIRE(params.Get<arma::Mat<size_t>>("neighbors").n_cols == 50);
+  REQUIRE(arma::all(arma::vectorise(
+      params.Get<arma::Mat<size_t>>("neighbors")) < 500));
+
+  KNNModel* output_model;
+  output_model = std::move(params.Get<KNNModel*>("output_model"));
+  REQUIRE(output_model->TreeType() == KNNModel::HNSW);
+  REQUIRE(output_model->MaxConnections() == 8);
+
+  // Reset passed parameters.
+  params.Get<KNNModel*>("output_model") = NULL;
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("input_model", output_model);
+  SetInputParam("query", std::move(queryData));
+  SetInputParam("k", (int) 5);
+  SetInputParam("ef", (int) 100);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<KNNModel*>("output_model")->Ef() == 100);
+  REQUIRE(params.Get<arma::Mat<size_t>>("neighbors").n_cols == 50);
+}
+
 /**
  * Make sure that dimensions of the neighbors and distances matrices are correct
  * given a value of k.
@@ -669,3 +746,42 @@ TEST_CASE_METHOD(KNNTestFixture, "KNNDifferentLeafSizes",
   REQUIRE(params.Get<KNNModel*>("output_model")->LeafSize() == (int) 10);
   delete output_model;
 }
+
+/**
+ * Ensure that auto-tuning gives the exact distances, and that it sets the
+ * configuration of the output model.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNAutoTuneTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 3000); // 3000 points in 3 dimensions.
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("algorithm", (string) "naive");
+
+  RUN_BINDING();
+
+  const arma::mat trueDistances = params.Get<arma::mat>("distances");
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("k", (int) 5);
+  SetInputParam("auto_tune", true);
+
+  RUN_BINDING();
+
+  const arma::mat& distances = params.Get<arma::mat>("distances");
+  REQUIRE(distances.n_rows == 5);
+  REQUIRE(distances.n_cols == 3000);
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    REQUIRE(distances[i] == Approx(trueDistances[i]).epsilon(1e-7));
+
+  // The default minimum recall only allows exact searches.
+  KNNModel* model = params.Get<KNNModel*>("output_model");
+  REQUIRE(model->Epsilon() == 0.0);
+  REQUIRE(model->SearchMode() != GREEDY_SINGLE_TREE_MODE);
+}
@@ -803,6 +803,20 @@ TEST_CASE_METHOD(LMNNTestFixture, "LMNNBoundsTest",
   // Reset settings.
   ResetSettings();
 
+  // Test for epsilon value.
+
+  // Input training data.
+  SetInputParam("input", inputData);
+  SetInputParam("labels", labels);
+  SetInputParam("epsilon", (double) -0.1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  // Reset settings.
+  ResetSettings();
+
   // Test for tolerance value.
 
   // Input training data.
@@ -491,3 +491,40 @@ TEST_CASE_METHOD(NCATestFixture, "NCADifferentMaxIterationTest",
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure that restricting the softmax to nearest neighbors gives output of
+ * the right size, and that a negative number of neighbors is rejected.
+ */
+TEST_CASE_METHOD(NCATestFixture, "NCANumNeighborsTest",
+                "[NCAMainTest][BindingTests]")
+{
+  arma::mat x;
+  x.randu(3, 100);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100,
+      arma::distr_param(0, 1));
+  arma::mat y = x;
+  arma::Row<size_t> labels2 = labels;
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("num_neighbors", (int) 5);
+  SetInputParam("refresh_interval", (int) 20);
+  SetInputParam("max_iterations", (int) 500);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::mat>("output").n_rows == 3);
+  REQUIRE(params.Get<arma::mat>("output").n_cols == 3);
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("input", std::move(y));
+  SetInputParam("labels", std::move(labels2));
+  SetInputParam("num_neighbors", (int) -1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -98,3 +98,55 @@ TEST_CASE_METHOD(PCATestFixture, "PCATooHighNewDimensionalityTest",
   REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
   Log::Fatal.ignoreInput = false;
 }
+
+/**
+ * Make sure that the incremental decomposition gives the same output as the
+ * exact one, up to sign.
+ */
+TEST_CASE_METHOD(PCATestFixture, "PCAIncrementalTest",
+                 "[PCAMainTest][BindingTests]")
+{
+  arma::mat x = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("input", x);
+  SetInputParam("new_dimensionality", (int) 3);
+
+  RUN_BINDING();
+
+  const arma::mat exactOutput = params.Get<arma::mat>("output");
+
+  ResetSettings();
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("new_dimensionality", (int) 3);
+  SetInputParam("decomposition_method", std::string("incremental"));
+  SetInputParam("chunk_size", (int) 15);
+
+  RUN_BINDING();
+
+  const arma::mat& output = params.Get<arma::mat>("output");
+  REQUIRE(output.n_rows == 3);
+  REQUIRE(output.n_cols == 100);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const double sign = (arma::dot(output.row(i), exactOutput.row(i)) < 0) ?
+        -1.0 : 1.0;
+    REQUIRE(arma::approx_equal(sign * output.row(i), exactOutput.row(i),
+        "absdiff", 1e-5));
+  }
+}
+
+/**
+ * Make sure that the incremental decomposition does not accept scaling.
+ */
+TEST_CASE_METHOD(PCATestFixture, "PCAIncrementalScaleTest",
+                 "[PCAMainTest][BindingTests]")
+{
+  SetInputParam("input", arma::mat(arma::randu<arma::mat>(5, 20)));
+  SetInputParam("decomposition_method", std::string("incremental"));
+  SetInputParam("scale", true);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -97,6 +97,18 @@ TEST_CASE_METHOD(RadicalTestFixture, "RadicalBoundsTest",
   Log::Fatal.ignoreInput = true;
   REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
   Log::Fatal.ignoreInput = false;
+
+  CleanMemory();
+  ResetSettings();
+
+  // Test for samples.
+
+  SetInputParam("input", input);
+  SetInputParam("samples", (int) -1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
 }
 
 /**
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/log_add.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
 #include "catch.hpp"
@@ -617,6 +618,43 @@ TEST_CASE("ShuffleTest", "[MathTest]")
     REQUIRE(counts[i] == 1);
 }
 
+/**
+ * Make sure shuffling data in place works.
+ */
+TEST_CASE("ShuffleInPlaceTest", "[MathTest]")
+{
+  arma::mat data(3, 10, arma::fill::zeros);
+  arma::Row<size_t> labels(10);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    data(0, i) = i;
+    labels[i] = i;
+  }
+
+  const double* dataMem = data.memptr();
+  ShuffleDataInPlace(data, labels);
+
+  REQUIRE(data.memptr() == dataMem);
+  REQUIRE(data.n_cols == 10);
+  REQUIRE(labels.n_elem == 10);
+
+  // Make sure we only have each point once.
+  arma::Row<size_t> counts(10, arma::fill::zeros);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE((size_t) data(0, i) == labels[i]);
+    REQUIRE(data(1, i) == Approx(0.0).margin(1e-5));
+    counts[labels[i]]++;
+  }
+
+  for (size_t i = 0; i < 10; ++i)
+    REQUIRE(counts[i] == 1);
+
+  arma::Row<size_t> wrongLabels(9);
+  REQUIRE_THROWS_AS(ShuffleDataInPlace(data, wrongLabels),
+      std::invalid_argument);
+}
+
 /**
  * Make sure shuffling sparse data works.
  */
@@ -1006,3 +1044,96 @@ TEST_CASE("InplaceSparseShuffleWeightsTest", "[MathTest]")
     REQUIRE(weightCounts[i] == 1);
   }
 }
+
+/**
+ * Make sure that FastExp() is close to std::exp() over the range of exponents
+ * used by the log-sum-exp functions.
+ */
+TEST_CASE("FastExpTest", "[MathTest]")
+{
+  for (double x = -700.0; x <= 50.0; x += 0.0137)
+    REQUIRE(std::abs(FastExp(x) / std::exp(x) - 1.0) < 1e-8);
+
+  REQUIRE(FastExp(0.0) == Approx(1.0).epsilon(1e-12));
+  REQUIRE(FastExp(-std::numeric_limits<double>::infinity()) < 1e-300);
+}
+
+/**
+ * Make sure that AccuLog(), LogSumExp() and LogSumExpT() give the same results
+ * as the direct computation, in the precise and the fast modes.
+ */
+TEST_CASE("LogSumExpTest", "[MathTest]")
+{
+  arma::mat x(13, 7, arma::fill::randu);
+  x = 20 * x - 10;
+  arma::vec y0(13, arma::fill::randu);
+  arma::vec y1(7, arma::fill::randu);
+
+  const arma::vec rowSums = arma::log(arma::sum(arma::exp(x), 1));
+  const arma::vec colSums = arma::log(arma::sum(arma::exp(x), 0)).t();
+
+  arma::vec y;
+  LogSumExp(x, y);
+  CheckMatrices(y, rowSums, 1e-10);
+  LogSumExp<arma::mat, false, true>(x, y);
+  CheckMatrices(y, rowSums, 1e-4);
+
+  LogSumExpT(x, y);
+  CheckMatrices(y, colSums, 1e-10);
+  LogSumExpT<arma::mat, false, true>(x, y);
+  CheckMatrices(y, colSums, 1e-4);
+
+  // Now add the values of y to the sums.
+  y = y0;
+  LogSumExp<arma::mat, true>(x, y);
+  CheckMatrices(y, arma::vec(arma::log(arma::exp(rowSums) + arma::exp(y0))),
+      1e-10);
+  y = y1;
+  LogSumExpT<arma::mat, true>(x, y);
+  CheckMatrices(y, arma::vec(arma::log(arma::exp(colSums) + arma::exp(y1))),
+      1e-10);
+
+  // AccuLog() of subviews (that are not contiguous) and of dense vectors.
+  for (size_t i = 0; i < x.n_rows; ++i)
+  {
+    REQUIRE(AccuLog(x.row(i)) == Approx(rowSums[i]).epsilon(1e-10));
+    const arma::rowvec row = x.row(i);
+    REQUIRE(AccuLog<arma::rowvec, true>(row) ==
+        Approx(rowSums[i]).epsilon(1e-6).margin(1e-7));
+  }
+  for (size_t j = 0; j < x.n_cols; ++j)
+  {
+    const arma::vec col = x.col(j);
+    REQUIRE(AccuLog(col) == Approx(colSums[j]).epsilon(1e-10));
+  }
+
+  REQUIRE(LogAdd(std::log(0.3), std::log(0.5)) ==
+      Approx(std::log(0.8)).epsilon(1e-12));
+}
+
+/**
+ * Make sure that rows and columns of zero probability give -inf, and that
+ * large log values do not overflow.
+ */
+TEST_CASE("LogSumExpInfinityTest", "[MathTest]")
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  arma::mat x(3, 4);
+  x.fill(-inf);
+  x(1, 2) = 1000.0;
+  x(1, 3) = 1000.0;
+
+  arma::vec y;
+  LogSumExp(x, y);
+  REQUIRE(y[0] == -inf);
+  REQUIRE(y[1] == Approx(1000.0 + std::log(2.0)).epsilon(1e-12));
+  REQUIRE(y[2] == -inf);
+
+  LogSumExpT<arma::mat, false, true>(x, y);
+  REQUIRE(y[0] == -inf);
+  REQUIRE(y[1] == -inf);
+  REQUIRE(y[2] == Approx(1000.0).epsilon(1e-12));
+  REQUIRE(y[3] == Approx(1000.0).epsilon(1e-12));
+
+  REQUIRE(AccuLog(x.col(0)) == -inf);
+}
@@ -60,3 +60,69 @@ TEST_CASE("UniformMatrixCompletionSDP", "[MatrixCompletionTest]")
        Approx(Xorig(indices(0, i), indices(1, i))).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure the gradient of the packed augmented Lagrangian matches a finite
+ * difference approximation, for entries on and off the diagonal that share
+ * terms.
+ */
+TEST_CASE("PackedLRSDPGradientTest", "[MatrixCompletionTest]")
+{
+  // Objective: tr(X); a constraint with two entries and one with a diagonal
+  // entry.
+  arma::umat locations = { { 0, 1, 2, 3, 0, 2, 1 },
+                           { 0, 1, 2, 3, 3, 1, 1 } };
+  arma::vec values = { 1.0, 1.0, 1.0, 1.0, 2.0, -0.5, 3.0 };
+  arma::Col<size_t> terms = { 2, 2, 2, 2, 0, 0, 1 };
+  arma::vec b = { 1.0, 2.0 };
+
+  PackedLRSDP sdp(4, locations, values, terms, b);
+  sdp.Lambda() = arma::vec({ 0.3, -0.7 });
+  sdp.Sigma() = 5.0;
+
+  arma::mat coordinates(3, 4, arma::fill::randu);
+  arma::mat gradient;
+  const double value = sdp.EvaluateWithGradient(coordinates, gradient);
+  REQUIRE(value == Approx(sdp.Evaluate(coordinates)).epsilon(1e-10));
+
+  const double h = 1e-6;
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+  {
+    arma::mat plus = coordinates, minus = coordinates;
+    plus[i] += h;
+    minus[i] -= h;
+    const double numeric = (sdp.Evaluate(plus) - sdp.Evaluate(minus)) /
+        (2 * h);
+    REQUIRE(gradient[i] == Approx(numeric).epsilon(1e-5).margin(1e-7));
+  }
+}
+
+/**
+ * Recover a random low-rank matrix from a subset of its entries.
+ */
+TEST_CASE("RandomLowRankMatrixCompletion", "[MatrixCompletionTest]")
+{
+  const size_t m = 40, n = 30;
+  const arma::mat x = arma::randu<arma::mat>(m, 2) *
+      arma::randu<arma::mat>(2, n);
+
+  // Observe about 60% of the entries.
+  arma::uvec observed = arma::find(arma::randu<arma::vec>(m * n) < 0.6);
+  arma::umat indices(2, observed.n_elem);
+  arma::vec values(observed.n_elem);
+  for (size_t i = 0; i < observed.n_elem; ++i)
+  {
+    indices(0, i) = observed[i] % m;
+    indices(1, i) = observed[i] / m;
+    values[i] = x[observed[i]];
+  }
+
+  arma::mat recovered;
+  MatrixCompletion mc(m, n, indices, values, 10);
+  mc.Recover(recovered);
+
+  REQUIRE(recovered.n_rows == m);
+  REQUIRE(recovered.n_cols == n);
+  const double err = arma::norm(x - recovered, "fro") / arma::norm(x, "fro");
+  REQUIRE(err == Approx(0.0).margin(1e-3));
+}
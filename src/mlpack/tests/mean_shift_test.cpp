@@ -162,3 +162,31 @@ TEST_CASE("GaussianClustering", "[MeanShiftTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure that mean shift with a kernel, starting from every point instead
+ * of seeds, also finds the three classes of the 30-point test case.
+ */
+TEST_CASE("MeanShiftKernelNoSeedsTest", "[MeanShiftTest]")
+{
+  MeanShift<true> meanShift(2.0);
+
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids,
+      true, false);
+
+  REQUIRE(centroids.n_cols == 3);
+
+  // The classes are points 0-12, 13-19 and 20-29.
+  for (size_t i = 1; i < 13; ++i)
+    REQUIRE(assignments(i) == assignments(0));
+  for (size_t i = 14; i < 20; ++i)
+    REQUIRE(assignments(i) == assignments(13));
+  for (size_t i = 21; i < 30; ++i)
+    REQUIRE(assignments(i) == assignments(20));
+
+  REQUIRE(assignments(0) != assignments(13));
+  REQUIRE(assignments(0) != assignments(20));
+  REQUIRE(assignments(13) != assignments(20));
+}
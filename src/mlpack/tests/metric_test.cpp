@@ -71,6 +71,38 @@ TEST_CASE("L2MetricTest", "[MetricTest]")
       Approx(lMetric.Evaluate(a2, b2)).epsilon(1e-7));
 }
 
+/**
+ * The low-dimensional L1 and L2 metrics, computed with loops of fixed length,
+ * must match the general computation.
+ */
+TEST_CASE("LMetricFixedDimensionTest", "[MetricTest]")
+{
+  for (size_t dim = 1; dim <= 6; ++dim)
+  {
+    const arma::mat points = arma::randn<arma::mat>(dim, 2);
+    const arma::vec diff = points.col(0) - points.col(1);
+    const arma::fvec a = arma::conv_to<arma::fvec>::from(points.col(0));
+    const arma::fvec b = arma::conv_to<arma::fvec>::from(points.col(1));
+
+    REQUIRE(ManhattanDistance::Evaluate(points.col(0), points.col(1)) ==
+        Approx(arma::accu(arma::abs(diff))).epsilon(1e-12));
+    REQUIRE(EuclideanDistance::Evaluate(points.col(0), points.col(1)) ==
+        Approx(std::sqrt(arma::accu(arma::square(diff)))).epsilon(1e-12));
+    REQUIRE(SquaredEuclideanDistance::Evaluate(points.col(0),
+        points.col(1)) == Approx(arma::accu(arma::square(diff))).
+        epsilon(1e-12));
+    REQUIRE(EuclideanDistance::Evaluate(a, b) ==
+        Approx(std::sqrt(arma::accu(arma::square(diff)))).epsilon(1e-5));
+
+    // The distance between identical points is 0, and the distance between
+    // points whose squared differences underflow is still accurate.
+    REQUIRE(EuclideanDistance::Evaluate(points.col(0), points.col(0)) == 0.0);
+    const arma::vec tiny = 1e-200 * arma::ones<arma::vec>(dim);
+    REQUIRE(EuclideanDistance::Evaluate(tiny, arma::vec(2 * tiny)) ==
+        Approx(1e-200 * std::sqrt((double) dim)).epsilon(1e-10));
+  }
+}
+
 /**
  * Simple test for L-Infinity metric.
  */
@@ -301,6 +333,109 @@ TEST_CASE("NMSMetricTest", "[MetricTest]")
   CheckMatrices(desiredBoundingBox, selectedBoundingBox);
 }
 
+/**
+ * Compare NMS with a straightforward greedy NMS that uses IoU, on many random
+ * bounding boxes.
+ */
+TEST_CASE("NMSRandomBoxesTest", "[MetricTest]")
+{
+  arma::mat bbox(4, 300);
+  bbox.rows(0, 1) = 100.0 * arma::randu<arma::mat>(2, 300);
+  bbox.rows(2, 3) = bbox.rows(0, 1) + 5.0 + 20.0 * arma::randu<arma::mat>(2,
+      300);
+  arma::vec confidenceScores = arma::randu<arma::vec>(300);
+
+  arma::uvec selectedIndices;
+  NMS<true>::Evaluate(bbox, confidenceScores, selectedIndices, 0.3);
+
+  // Greedy NMS, one pair at a time.
+  arma::uvec order = arma::sort_index(confidenceScores, "descend");
+  std::vector<size_t> expected;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < expected.size(); ++j)
+    {
+      if (IoU<true>::Evaluate(bbox.col(order[i]), bbox.col(expected[j])) >
+          0.3)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      expected.push_back(order[i]);
+  }
+
+  REQUIRE(selectedIndices.n_elem == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    REQUIRE(selectedIndices[i] == expected[i]);
+}
+
+/**
+ * Make sure that per-class NMS only suppresses bounding boxes of the same
+ * class.
+ */
+TEST_CASE("NMSPerClassTest", "[MetricTest]")
+{
+  // Bounding boxes represent {x0, y0, x1, y1}.
+  arma::mat bbox = { { 0.0, 1.0, 0.0, 50.0 },
+                     { 0.0, 1.0, 0.0, 50.0 },
+                     { 10.0, 11.0, 10.0, 60.0 },
+                     { 10.0, 11.0, 10.0, 60.0 } };
+  arma::vec confidenceScores = { 0.9, 0.8, 0.7, 0.6 };
+  arma::Row<size_t> labels = { 0, 0, 1, 1 };
+
+  // Without classes, the first box suppresses the second and the third.
+  arma::uvec selectedIndices;
+  NMS<true>::Evaluate(bbox, confidenceScores, selectedIndices, 0.5);
+  REQUIRE(selectedIndices.n_elem == 2);
+  REQUIRE(selectedIndices[0] == 0);
+  REQUIRE(selectedIndices[1] == 3);
+
+  // With classes, the third box is of another class.
+  NMS<true>::Evaluate(bbox, confidenceScores, labels, selectedIndices, 0.5);
+  REQUIRE(selectedIndices.n_elem == 3);
+  REQUIRE(selectedIndices[0] == 0);
+  REQUIRE(selectedIndices[1] == 2);
+  REQUIRE(selectedIndices[2] == 3);
+}
+
+/**
+ * Check the decayed scores of Soft-NMS.
+ */
+TEST_CASE("SoftNMSTest", "[MetricTest]")
+{
+  // Bounding boxes represent {x0, y0, x1, y1}.  The first two overlap with
+  // IoU 0.5, and the third does not overlap them.
+  arma::mat bbox = { { 0.0, 0.0, 100.0 },
+                     { 0.0, 0.0, 100.0 },
+                     { 2.0, 2.0, 101.0 },
+                     { 2.0, 1.0, 101.0 } };
+  arma::vec confidenceScores = { 0.9, 0.8, 0.5 };
+
+  arma::uvec selectedIndices;
+  arma::vec selectedScores;
+  NMS<true>::SoftEvaluate(bbox, confidenceScores, selectedIndices,
+      selectedScores, 0.5);
+
+  // The score of the second box is 0.8 * exp(-0.5^2 / 0.5), which is below
+  // the score of the third box.
+  REQUIRE(selectedIndices.n_elem == 3);
+  REQUIRE(selectedIndices[0] == 0);
+  REQUIRE(selectedIndices[1] == 2);
+  REQUIRE(selectedIndices[2] == 1);
+  REQUIRE(selectedScores[0] == Approx(0.9));
+  REQUIRE(selectedScores[1] == Approx(0.5));
+  REQUIRE(selectedScores[2] == Approx(0.8 * std::exp(-0.5)));
+
+  // With a higher score threshold, the second box is discarded.
+  NMS<true>::SoftEvaluate(bbox, confidenceScores, selectedIndices,
+      selectedScores, 0.5, 0.49);
+  REQUIRE(selectedIndices.n_elem == 2);
+}
+
 /**
  *
  */
@@ -398,3 +398,70 @@ TEST_CASE("NaiveBayesClassifierHighDimensionsTest", "[NBCTest]")
   for (size_t i = 0; i < calcVec.n_cols; ++i)
     REQUIRE(calcVec(i) == testLabels(i));
 }
+
+/**
+ * Training incrementally on a stream of batches should give the same model as
+ * training on all the data at once.
+ */
+TEST_CASE("NaiveBayesClassifierBatchStreamTest", "[NBCTest]")
+{
+  const size_t classes = 3;
+  arma::mat data = arma::randn(5, 600);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = i % classes;
+    data.col(i) += 2.0 * labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, classes);
+
+  // Stream the data in batches of different sizes.
+  NaiveBayesClassifier<> nbcStream(data.n_rows, classes);
+  const size_t bounds[] = { 0, 1, 50, 51, 300, 600 };
+  for (size_t b = 0; b < 5; ++b)
+  {
+    nbcStream.Train(data.cols(bounds[b], bounds[b + 1] - 1),
+        labels.subvec(bounds[b], bounds[b + 1] - 1), classes, true);
+  }
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    REQUIRE(nbcStream.Means()[i] == Approx(nbc.Means()[i]).margin(1e-10));
+    REQUIRE(nbcStream.Variances()[i] ==
+        Approx(nbc.Variances()[i]).epsilon(1e-8));
+  }
+  for (size_t i = 0; i < classes; ++i)
+  {
+    REQUIRE(nbcStream.Probabilities()[i] ==
+        Approx(nbc.Probabilities()[i]).epsilon(1e-10));
+  }
+
+  // The batch log-likelihood computation should match the density of each
+  // feature computed directly.
+  arma::mat probabilities;
+  arma::Row<size_t> predictions;
+  nbc.Classify(data.cols(0, 9), predictions, probabilities);
+  for (size_t j = 0; j < 10; ++j)
+  {
+    arma::vec logLikelihoods(classes);
+    for (size_t c = 0; c < classes; ++c)
+    {
+      logLikelihoods[c] = std::log(nbc.Probabilities()[c]);
+      for (size_t i = 0; i < data.n_rows; ++i)
+      {
+        const double var = nbc.Variances()(i, c);
+        const double diff = data(i, j) - nbc.Means()(i, c);
+        logLikelihoods[c] += -0.5 * std::log(2 * M_PI * var) -
+            0.5 * diff * diff / var;
+      }
+    }
+
+    const arma::vec expected = arma::exp(logLikelihoods -
+        logLikelihoods.max()) / arma::accu(arma::exp(logLikelihoods -
+        logLikelihoods.max()));
+    for (size_t c = 0; c < classes; ++c)
+      REQUIRE(probabilities(c, j) == Approx(expected[c]).margin(1e-8));
+    REQUIRE(predictions[j] == expected.index_max());
+  }
+}
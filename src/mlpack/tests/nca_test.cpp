@@ -318,3 +318,69 @@ TEST_CASE("NCALBFGSSimpleDataset", "[NCATesT]")
   // norm is close to 0.
   REQUIRE(arma::norm(finalGradient, 2) < 1e-6);
 }
+
+/**
+ * When the softmax is restricted to all other points, the objective and
+ * gradient must be the same as the exact ones.
+ */
+TEST_CASE("SoftmaxAllNeighborsTest", "[NCATesT]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 40);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(40,
+      arma::distr_param(0, 2));
+  arma::mat coordinates = arma::randu<arma::mat>(3, 3);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> knnSef(data, labels,
+      SquaredEuclideanDistance(), 39);
+
+  REQUIRE(knnSef.Evaluate(coordinates) ==
+      Approx(sef.Evaluate(coordinates)).epsilon(1e-7));
+  REQUIRE(knnSef.Evaluate(coordinates, 5, 10) ==
+      Approx(sef.Evaluate(coordinates, 5, 10)).epsilon(1e-7));
+
+  arma::mat gradient, knnGradient;
+  sef.Gradient(coordinates, gradient);
+  knnSef.Gradient(coordinates, knnGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    REQUIRE(knnGradient[i] == Approx(gradient[i]).epsilon(1e-7).margin(1e-10));
+
+  sef.Gradient(coordinates, 5, gradient, 10);
+  knnSef.Gradient(coordinates, 5, knnGradient, 10);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    REQUIRE(knnGradient[i] == Approx(gradient[i]).epsilon(1e-7).margin(1e-10));
+}
+
+/**
+ * NCA with the softmax restricted to a few nearest neighbors should still
+ * separate the classes of a simple dataset.
+ */
+TEST_CASE("NCASGDNearestNeighborsTest", "[NCATesT]")
+{
+  // Two classes, separated along the first dimension only, with a lot of noise
+  // in the second.
+  arma::mat data(2, 200);
+  data.row(0) = 0.1 * arma::randn<arma::rowvec>(200);
+  data.row(1) = 5.0 * arma::randn<arma::rowvec>(200);
+  arma::Row<size_t> labels(200);
+  labels.subvec(0, 99).zeros();
+  labels.subvec(100, 199).ones();
+  data.row(0).subvec(100, 199) += 0.5;
+
+  NCA<SquaredEuclideanDistance> nca(data, labels);
+  nca.NumNeighbors() = 10;
+  nca.RefreshInterval() = 50;
+  nca.Optimizer().StepSize() = 0.01;
+  nca.Optimizer().MaxIterations() = 20000;
+  nca.Optimizer().Tolerance() = 0;
+  nca.Optimizer().BatchSize() = 10;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  // The exact objective should improve.
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  const double initObj = sef.Evaluate(arma::eye<arma::mat>(2, 2));
+  const double finalObj = sef.Evaluate(outputMatrix);
+  REQUIRE(finalObj < initObj);
+}
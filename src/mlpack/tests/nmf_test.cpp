@@ -180,6 +180,40 @@ TEST_CASE("SparseNMFAcolDistTest", "[NMFTest]")
       Approx(0.0).margin(1e-5));
 }
 
+/**
+ * The divergence update rules on a sparse matrix, which only evaluate W * H at
+ * the nonzero elements, should give the same factorization as on the dense
+ * matrix.
+ */
+TEST_CASE("SparseNMFDivTest", "[NMFTest]")
+{
+  sp_mat v;
+  v.sprandu(30, 30, 0.2);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 30; ++i)
+    v(i, i) += 1e-5;
+  mat dv(v); // Make a dense copy.
+  const size_t r = 5;
+
+  arma::mat iw, ih;
+  RandomAcolInitialization<>::Initialize(v, r, iw, ih);
+  GivenInitialization g(std::move(iw), std::move(ih));
+
+  SimpleResidueTermination srt(1e-10, 200);
+  AMF<SimpleResidueTermination,
+      GivenInitialization,
+      NMFMultiplicativeDivergenceUpdate> nmf(srt, g);
+
+  mat w, h, dw, dh;
+  nmf.Apply(v, r, w, h);
+  nmf.Apply(dv, r, dw, dh);
+
+  REQUIRE(w.is_finite());
+  REQUIRE(h.is_finite());
+  REQUIRE(arma::norm(w * h - dw * dh, "fro") / arma::norm(dw * dh, "fro") ==
+      Approx(0.0).margin(1e-8));
+}
+
 /**
  * Check that the product of the calculated factorization is close to the
  * input matrix, with a sparse input matrix.  This uses the random
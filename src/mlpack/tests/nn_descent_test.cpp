@@ -0,0 +1,170 @@
+/**
+ * @file tests/nn_descent_test.cpp
+ *
+ * Test the NN-Descent construction of approximate k-nearest-neighbor graphs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/nn_descent/nn_descent.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::metric;
+
+/**
+ * Compute the fraction of the true neighbors of the graph that were found.
+ */
+double GraphRecall(const arma::Mat<size_t>& neighbors,
+                   const arma::Mat<size_t>& trueNeighbors)
+{
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      if (arma::any(trueNeighbors.col(i) == neighbors(j, i)))
+        ++found;
+    }
+  }
+
+  return double(found) / trueNeighbors.n_elem;
+}
+
+/**
+ * Check that each list of the graph holds distinct points other than the point
+ * itself, with their true distances in increasing order.
+ */
+template<typename MetricType>
+void CheckGraph(const arma::mat& data,
+                const arma::Mat<size_t>& neighbors,
+                const arma::mat& distances,
+                MetricType& metric)
+{
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(neighbors(j, i) < data.n_cols);
+      REQUIRE(neighbors(j, i) != i);
+      REQUIRE(distances(j, i) == Approx(metric.Evaluate(data.col(i),
+          data.col(neighbors(j, i)))).epsilon(1e-7).margin(1e-12));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+
+    arma::Col<size_t> sorted = arma::sort(neighbors.col(i));
+    for (size_t j = 1; j < sorted.n_elem; ++j)
+      REQUIRE(sorted[j] != sorted[j - 1]);
+  }
+}
+
+/**
+ * The graph should hold almost all the exact neighbors.
+ */
+TEST_CASE("NNDescentRecallTest", "[NNDescentTest]")
+{
+  arma::mat data(8, 2000, arma::fill::randu);
+
+  NNDescent<> nnDescent(data);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnDescent.Search(10, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 2000);
+  REQUIRE(distances.n_rows == 10);
+  REQUIRE(distances.n_cols == 2000);
+  REQUIRE(nnDescent.Iterations() > 0);
+  REQUIRE(nnDescent.Iterations() <= nnDescent.MaxIterations());
+
+  EuclideanDistance metric;
+  CheckGraph(data, neighbors, distances, metric);
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(10, trueNeighbors, trueDistances);
+
+  REQUIRE(GraphRecall(neighbors, trueNeighbors) >= 0.9);
+}
+
+/**
+ * Other metrics should work too, and the iterations should improve the random
+ * initial graph.
+ */
+TEST_CASE("NNDescentManhattanTest", "[NNDescentTest]")
+{
+  arma::mat data(5, 1000, arma::fill::randu);
+
+  NeighborSearch<NearestNeighborSort, ManhattanDistance> knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  NNDescent<ManhattanDistance> nnDescent(data, 0);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnDescent.Search(5, neighbors, distances);
+  REQUIRE(nnDescent.Iterations() == 0);
+
+  ManhattanDistance metric;
+  CheckGraph(data, neighbors, distances, metric);
+  const double randomRecall = GraphRecall(neighbors, trueNeighbors);
+
+  nnDescent.MaxIterations() = 15;
+  nnDescent.Search(5, neighbors, distances);
+  CheckGraph(data, neighbors, distances, metric);
+  const double recall = GraphRecall(neighbors, trueNeighbors);
+
+  REQUIRE(recall > randomRecall);
+  REQUIRE(recall >= 0.9);
+}
+
+/**
+ * When k is the number of other points, every list must hold all the other
+ * points, in the order of the exact search.
+ */
+TEST_CASE("NNDescentCompleteGraphTest", "[NNDescentTest]")
+{
+  arma::mat data(3, 30, arma::fill::randu);
+
+  NNDescent<> nnDescent(data);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnDescent.Search(29, neighbors, distances);
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(29, trueNeighbors, trueDistances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("NNDescentInvalidParametersTest", "[NNDescentTest]")
+{
+  arma::mat data(3, 10, arma::fill::randu);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  NNDescent<> nnDescent(data);
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(nnDescent.Search(10, neighbors, distances),
+      std::runtime_error);
+  nnDescent.SampleRate() = 0.0;
+  REQUIRE_THROWS_AS(nnDescent.Search(3, neighbors, distances),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
@@ -346,3 +346,72 @@ TEST_CASE("OctreeSerializationTest", "[OctreeTest]")
   delete binaryTree;
   delete jsonTree;
 }
+
+/**
+ * Check that the two given trees have the same nodes, holding the same
+ * original points (the order of the points inside the leaves may differ).
+ */
+void CheckSameOctree(const Octree<>& t1,
+                     const std::vector<size_t>& oldFromNew1,
+                     const Octree<>& t2,
+                     const std::vector<size_t>& oldFromNew2)
+{
+  REQUIRE(t1.NumChildren() == t2.NumChildren());
+  REQUIRE(t1.NumDescendants() == t2.NumDescendants());
+  REQUIRE(t1.ParentDistance() == Approx(t2.ParentDistance()));
+  for (size_t d = 0; d < t1.Bound().Dim(); ++d)
+  {
+    REQUIRE(t1.Bound()[d].Lo() == t2.Bound()[d].Lo());
+    REQUIRE(t1.Bound()[d].Hi() == t2.Bound()[d].Hi());
+  }
+
+  if (t1.IsLeaf())
+  {
+    std::vector<size_t> points1, points2;
+    for (size_t i = 0; i < t1.NumPoints(); ++i)
+    {
+      points1.push_back(oldFromNew1[t1.Point(i)]);
+      points2.push_back(oldFromNew2[t2.Point(i)]);
+    }
+    std::sort(points1.begin(), points1.end());
+    std::sort(points2.begin(), points2.end());
+    REQUIRE(points1 == points2);
+  }
+
+  for (size_t i = 0; i < t1.NumChildren(); ++i)
+    CheckSameOctree(t1.Child(i), oldFromNew1, t2.Child(i), oldFromNew2);
+}
+
+/**
+ * Make sure that building the tree from Morton codes gives the same tree as
+ * building it recursively, including when the nodes are deeper than the levels
+ * held by the codes.
+ */
+TEST_CASE("OctreeMortonBuildTest", "[OctreeTest]")
+{
+  // A 3-dimensional dataset, and a 6-dimensional dataset (10 levels per code)
+  // with a tight cluster that needs more levels than that.
+  arma::mat dataset3(3, 20000, arma::fill::randu);
+  arma::mat dataset6(6, 3000, arma::fill::randu);
+  dataset6.cols(0, 99) = 0.5 + 1e-5 * arma::randu<arma::mat>(6, 100);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    const arma::mat& dataset = (trial == 0) ? dataset3 : dataset6;
+
+    std::vector<size_t> oldFromNew, mortonOldFromNew, mortonNewFromOld;
+    Octree<> t(dataset, oldFromNew, 10);
+    Octree<> mortonTree(dataset, mortonOldFromNew, mortonNewFromOld, 10,
+        true);
+
+    REQUIRE(mortonOldFromNew.size() == dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      REQUIRE(mortonNewFromOld[mortonOldFromNew[i]] == i);
+      REQUIRE(arma::approx_equal(mortonTree.Dataset().col(i),
+          dataset.col(mortonOldFromNew[i]), "absdiff", 1e-15));
+    }
+
+    CheckSameOctree(t, oldFromNew, mortonTree, mortonOldFromNew);
+  }
+}
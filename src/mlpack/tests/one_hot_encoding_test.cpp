@@ -172,6 +172,29 @@ TEST_CASE("OneHotEncodingVeryBigInputTest", "[OneHotEncodingTest]")
     REQUIRE(matrix.at(i) == output.at(i));
 }
 
+/**
+ * Make sure that one hot encoding into a sparse matrix gives the same result as
+ * encoding into a dense matrix.
+ */
+TEST_CASE("OneHotEncodingSparseOutputTest", "[OneHotEncodingTest]")
+{
+  arma::mat input = arma::floor(4 * arma::randu<arma::mat>(6, 200));
+  // A dimension that is not encoded, with some zeros.
+  input.row(2) = arma::randn<arma::rowvec>(200);
+  input(2, 10) = 0.0;
+
+  // Duplicate indices are encoded only once.
+  arma::Col<size_t> indices("0 3 5 3");
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  data::OneHotEncoding(input, indices, output);
+  data::OneHotEncoding(input, indices, sparseOutput);
+
+  REQUIRE(output.n_rows == sparseOutput.n_rows);
+  REQUIRE(output.n_cols == sparseOutput.n_cols);
+  CheckMatrices(output, arma::mat(sparseOutput));
+}
+
 /**
  * Test one hot encoding using DatasetInfo object.
  */
@@ -12,6 +12,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
+#include <mlpack/methods/pca/incremental_pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
@@ -336,3 +337,128 @@ TEST_CASE("PCAScalingTest", "[PCATest]")
   // The eigenvalues should sum to three.
   REQUIRE(accu(eigval) == Approx(3.0).epsilon(0.001));
 }
+
+/**
+ * Sparse PCA with the randomized policies, with as many components as
+ * dimensions, should match exact PCA of the dense data.
+ */
+template<typename DecompositionPolicy>
+void SparsePCAComparison()
+{
+  arma::sp_mat data;
+  data.sprandu(10, 500, 0.2);
+  const arma::mat denseData(data);
+
+  arma::mat eigvec, eigvec1, transformed, transformed1;
+  arma::vec eigVal, eigVal1;
+
+  PCA<ExactSVDPolicy> exactPCA;
+  exactPCA.Apply(denseData, transformed, eigVal, eigvec);
+
+  PCA<DecompositionPolicy> sparsePCA;
+  sparsePCA.Apply(data, transformed1, eigVal1, eigvec1, 10);
+
+  REQUIRE(eigVal1.n_elem == 10);
+  REQUIRE(eigvec1.n_cols == 10);
+  REQUIRE(transformed1.n_rows == 10);
+  REQUIRE(transformed1.n_cols == 500);
+
+  for (size_t i = 0; i < 10; ++i)
+    REQUIRE(eigVal1[i] == Approx(eigVal[i]).epsilon(1e-5));
+
+  // The components are only known up to their sign.
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const double sign = arma::dot(eigvec.col(i), eigvec1.col(i)) > 0 ? 1 : -1;
+    for (size_t j = 0; j < transformed.n_cols; ++j)
+    {
+      REQUIRE(sign * transformed1(i, j) ==
+          Approx(transformed(i, j)).epsilon(1e-5).margin(1e-8));
+    }
+  }
+}
+
+TEST_CASE("SparseRandomizedPCATest", "[PCATest]")
+{
+  SparsePCAComparison<RandomizedSVDPolicy>();
+}
+
+TEST_CASE("SparseRandomizedBlockKrylovPCATest", "[PCATest]")
+{
+  SparsePCAComparison<RandomizedBlockKrylovSVDPolicy>();
+}
+
+/**
+ * Make sure that incremental PCA with all components gives the same results as
+ * exact PCA, whatever the chunk size.
+ */
+TEST_CASE("IncrementalPCAExactTest", "[PCATest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 1000);
+  data.row(1) += 2 * data.row(0);
+
+  PCA<> exact;
+  arma::mat exactData;
+  arma::vec exactEigVal;
+  arma::mat exactEigVec;
+  exact.Apply(data, exactData, exactEigVal, exactEigVec);
+
+  const size_t chunkSizes[] = { 1, 7, 100, 1000 };
+  for (const size_t chunkSize : chunkSizes)
+  {
+    IncrementalPCA p;
+    for (size_t i = 0; i < data.n_cols; i += chunkSize)
+      p.Update(data.cols(i, std::min(i + chunkSize, (size_t) data.n_cols) - 1));
+
+    REQUIRE(p.NumPoints() == data.n_cols);
+    REQUIRE(arma::approx_equal(p.Mean(), arma::mean(data, 1), "absdiff",
+        1e-10));
+    REQUIRE(p.VarianceRetained() == Approx(1.0).epsilon(1e-8));
+
+    const arma::vec eigVal = p.EigenValues();
+    REQUIRE(eigVal.n_elem == exactEigVal.n_elem);
+    for (size_t i = 0; i < eigVal.n_elem; ++i)
+      REQUIRE(eigVal[i] == Approx(exactEigVal[i]).epsilon(1e-6));
+
+    // The components are only defined up to sign.
+    arma::mat transformed;
+    p.Transform(data, transformed);
+    for (size_t i = 0; i < transformed.n_rows; ++i)
+    {
+      const double sign = (arma::dot(p.EigenVectors().col(i),
+          exactEigVec.col(i)) < 0) ? -1.0 : 1.0;
+      REQUIRE(arma::approx_equal(sign * transformed.row(i), exactData.row(i),
+          "absdiff", 1e-6));
+    }
+  }
+}
+
+/**
+ * Make sure that incremental PCA with fewer components recovers the subspace
+ * of data that lies in it.
+ */
+TEST_CASE("IncrementalPCALowRankTest", "[PCATest]")
+{
+  // The points lie on a 2-dimensional plane through (1, 2, 3, 4, 5).
+  const arma::mat basis = arma::orth(arma::randn<arma::mat>(5, 2));
+  arma::mat data = basis * arma::randn<arma::mat>(2, 500);
+  data.each_col() += arma::vec("1 2 3 4 5");
+
+  IncrementalPCA p(2);
+  for (size_t i = 0; i < data.n_cols; i += 50)
+    p.Update(data.cols(i, i + 49));
+
+  REQUIRE(p.EigenVectors().n_cols == 2);
+  REQUIRE(p.VarianceRetained() == Approx(1.0).epsilon(1e-8));
+
+  // The components span the plane.
+  const arma::mat projection = p.EigenVectors() * p.EigenVectors().t();
+  REQUIRE(arma::approx_equal(projection * basis, basis, "absdiff", 1e-8));
+
+  // So the points are projected and reconstructed exactly.
+  arma::mat transformed;
+  p.Transform(data, transformed);
+  arma::mat reconstructed = p.EigenVectors() * transformed;
+  reconstructed.each_col() += p.Mean();
+  REQUIRE(arma::approx_equal(reconstructed, data, "absdiff", 1e-8));
+}
@@ -245,3 +245,32 @@ TEST_CASE("SecondaryConstructor", "[PerceptronTest]")
 
   Perceptron<> p2(p1);
 }
+
+/**
+ * Training with iterative parameter mixing over several shards should still
+ * separate a linearly separable dataset.
+ */
+TEST_CASE("PerceptronShardsTest", "[PerceptronTest]")
+{
+  // Three well-separated classes.
+  mat trainData(2, 300);
+  Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+  {
+    labels[i] = i % 3;
+    trainData.col(i) = 0.2 * randn<vec>(2);
+    trainData(labels[i] == 2 ? 1 : 0, i) += (labels[i] == 0) ? -3.0 : 3.0;
+  }
+
+  Perceptron<> p(3, 2, 1000);
+  p.NumShards() = 4;
+  p.Train(trainData, labels, 3);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+  REQUIRE(accu(predictedLabels == labels) == 300);
+
+  // A copy for a weak learner keeps the number of shards.
+  Perceptron<> p2(p, trainData, labels, 3, ones<rowvec>(300));
+  REQUIRE(p2.NumShards() == 4);
+}
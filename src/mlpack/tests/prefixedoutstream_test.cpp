@@ -11,6 +11,7 @@
  */
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include <mlpack/core.hpp>
 
@@ -235,3 +236,95 @@ TEST_CASE("TestArmaCustomPrecision", "[PrefixedOutStreamTest]")
       BASH_GREEN "[INFO ] " BASH_CLEAR "   2.5000   3.0000   3.5000\n"
       BASH_GREEN "[INFO ] " BASH_CLEAR "   4.0000   4.5000   5.0000\n");
 }
+
+//! A type that counts the times it is formatted.
+struct CountedOutput
+{
+  static size_t count;
+};
+
+size_t CountedOutput::count = 0;
+
+std::ostream& operator<<(std::ostream& os, const CountedOutput& /* c */)
+{
+  ++CountedOutput::count;
+  return os << "counted";
+}
+
+/**
+ * Make sure that a stream that ignores its input does not format it.
+ */
+TEST_CASE("TestPrefixedOutStreamIgnoredInputNotFormatted",
+          "[PrefixedOutStreamTest]")
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, "[INFO ] ", true);
+  CountedOutput::count = 0;
+
+  pss << CountedOutput() << std::endl;
+  REQUIRE(CountedOutput::count == 0);
+  REQUIRE(ss.str() == "");
+
+  pss.ignoreInput = false;
+  pss << CountedOutput() << std::endl;
+  REQUIRE(CountedOutput::count == 1);
+  REQUIRE(ss.str() == "[INFO ] counted\n");
+}
+
+/**
+ * Make sure that the lines of an asynchronous stream are written whole, and in
+ * order for each thread, when many threads log at once.
+ */
+TEST_CASE("TestAsynchronousPrefixedOutStream", "[PrefixedOutStreamTest]")
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, "[INFO ] ");
+  pss.Asynchronous(true);
+  REQUIRE(pss.Asynchronous());
+
+  // An incomplete line is not written.
+  pss << "incomplete ";
+  Log::Flush();
+  REQUIRE(ss.str() == "");
+  pss << "line" << std::endl;
+  Log::Flush();
+  REQUIRE(ss.str() == "[INFO ] incomplete line\n");
+  ss.str("");
+
+  const size_t numThreads = 4;
+  const size_t numLines = 500;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread([&pss, t, numLines]()
+    {
+      for (size_t i = 0; i < numLines; ++i)
+        pss << "thread " << t << " line " << i << std::endl;
+    }));
+  }
+  for (size_t t = 0; t < numThreads; ++t)
+    threads[t].join();
+
+  // Making the stream synchronous writes the queued lines.
+  pss.Asynchronous(false);
+  REQUIRE(!pss.Asynchronous());
+
+  std::vector<size_t> nextLine(numThreads, 0);
+  std::string line;
+  size_t lines = 0;
+  while (std::getline(ss, line))
+  {
+    size_t t, i;
+    REQUIRE(sscanf(line.c_str(), "[INFO ] thread %zu line %zu", &t, &i) == 2);
+    REQUIRE(t < numThreads);
+    REQUIRE(i == nextLine[t]);
+    ++nextLine[t];
+    ++lines;
+  }
+  REQUIRE(lines == numThreads * numLines);
+
+  // The fatal streams stay synchronous.
+  PrefixedOutStream fatal(ss, "[FATAL] ", false, true);
+  fatal.Asynchronous(true);
+  REQUIRE(!fatal.Asynchronous());
+}
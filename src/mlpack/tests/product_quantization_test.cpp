@@ -0,0 +1,243 @@
+/**
+ * @file tests/product_quantization_test.cpp
+ *
+ * Test the ProductQuantizer and IVFPQSearch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/product_quantization/product_quantizer.hpp>
+#include <mlpack/methods/product_quantization/ivf_pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * The reconstruction error of the codes should be much smaller than the
+ * variance of the data, and the codes should take one byte per subspace.
+ */
+TEST_CASE("ProductQuantizerReconstructionTest", "[ProductQuantizationTest]")
+{
+  arma::mat data(8, 2000, arma::fill::randu);
+
+  ProductQuantizer<> pq(data, 4, 64);
+
+  arma::Mat<uint8_t> codes;
+  pq.Encode(data, codes);
+  REQUIRE(codes.n_rows == 4);
+  REQUIRE(codes.n_cols == data.n_cols);
+  REQUIRE(arma::all(arma::vectorise(codes) < 64));
+
+  arma::mat decoded;
+  pq.Decode(codes, decoded);
+  REQUIRE(decoded.n_rows == data.n_rows);
+  REQUIRE(decoded.n_cols == data.n_cols);
+
+  const double error = arma::accu(arma::square(decoded - data));
+  const double variance = arma::accu(arma::square(data.each_col() -
+      arma::mean(data, 1)));
+  REQUIRE(error < 0.1 * variance);
+}
+
+/**
+ * The asymmetric distance must be the squared distance between the query and
+ * the decoded point, with or without a rotation; the rotation must be
+ * orthogonal.
+ */
+TEST_CASE("ProductQuantizerAsymmetricDistanceTest",
+          "[ProductQuantizationTest]")
+{
+  // Correlated data, so that the rotation is not the identity.
+  arma::mat data = arma::randn<arma::mat>(6, 6) *
+      arma::randu<arma::mat>(6, 1000);
+
+  for (size_t rotationIterations = 0; rotationIterations < 4;
+       rotationIterations += 3)
+  {
+    ProductQuantizer<> pq(data, 3, 16, rotationIterations);
+    if (rotationIterations > 0)
+    {
+      REQUIRE(pq.Rotation().n_rows == 6);
+      const arma::mat product = pq.Rotation().t() * pq.Rotation();
+      CheckMatrices(product, arma::mat(arma::eye(6, 6)));
+    }
+    else
+    {
+      REQUIRE(pq.Rotation().is_empty());
+    }
+
+    arma::mat queries(6, 10, arma::fill::randn);
+    arma::Mat<uint8_t> codes;
+    arma::mat decoded, table;
+    pq.Encode(data.cols(0, 49), codes);
+    pq.Decode(codes, decoded);
+
+    for (size_t q = 0; q < queries.n_cols; ++q)
+    {
+      pq.DistanceTable(queries.col(q), table);
+      REQUIRE(table.n_rows == 16);
+      REQUIRE(table.n_cols == 3);
+
+      for (size_t i = 0; i < codes.n_cols; ++i)
+      {
+        const double distance = arma::accu(arma::square(queries.col(q) -
+            decoded.col(i)));
+        REQUIRE(pq.AsymmetricDistance(table, codes.colptr(i)) ==
+            Approx(distance).epsilon(1e-7));
+      }
+    }
+  }
+}
+
+/**
+ * Subspaces of uneven sizes should cover all the dimensions.
+ */
+TEST_CASE("ProductQuantizerUnevenSubspacesTest", "[ProductQuantizationTest]")
+{
+  arma::mat data(7, 300, arma::fill::randu);
+
+  ProductQuantizer<> pq(data, 3, 8);
+
+  REQUIRE(pq.SubspaceBegin(0) == 0);
+  REQUIRE(pq.SubspaceBegin(3) == 7);
+  size_t dims = 0;
+  for (size_t s = 0; s < 3; ++s)
+  {
+    REQUIRE(pq.Codebook(s).n_rows == pq.SubspaceBegin(s + 1) -
+        pq.SubspaceBegin(s));
+    REQUIRE(pq.Codebook(s).n_cols == 8);
+    dims += pq.Codebook(s).n_rows;
+  }
+  REQUIRE(dims == 7);
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("ProductQuantizerInvalidParametersTest", "[ProductQuantizationTest]")
+{
+  arma::mat data(4, 100, arma::fill::randu);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(ProductQuantizer<>(0, 16), std::runtime_error);
+  REQUIRE_THROWS_AS(ProductQuantizer<>(2, 257), std::runtime_error);
+  REQUIRE_THROWS_AS(ProductQuantizer<>(data, 5, 16), std::runtime_error);
+  REQUIRE_THROWS_AS(ProductQuantizer<>(data, 2, 200), std::runtime_error);
+
+  ProductQuantizer<> pq(data, 2, 16);
+  arma::Mat<uint8_t> codes;
+  REQUIRE_THROWS_AS(pq.Encode(arma::mat(3, 10, arma::fill::randu), codes),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * The inverted file index should find most of the true nearest neighbors, and
+ * visiting more lists should not find fewer of them.
+ */
+TEST_CASE("IVFPQSearchRecallTest", "[ProductQuantizationTest]")
+{
+  arma::mat referenceData(16, 4000, arma::fill::randu);
+  arma::mat queryData(16, 100, arma::fill::randu);
+
+  IVFPQSearch<> ivf(referenceData, 16, 8, 256, 2);
+  REQUIRE(ivf.NumPoints() == 4000);
+  REQUIRE(ivf.Codes().n_rows == 8);
+  REQUIRE(ivf.Codes().n_cols == 4000);
+  REQUIRE(ivf.ListOffsets()[16] == 4000);
+
+  // Every point is in exactly one list.
+  arma::Col<size_t> sortedIndices = arma::sort(ivf.Indices());
+  REQUIRE(arma::all(sortedIndices ==
+      arma::regspace<arma::Col<size_t>>(0, 3999)));
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 1, trueNeighbors, trueDistances);
+
+  // Count the queries whose true nearest neighbor is in the first 10 results.
+  size_t found[2] = { 0, 0 };
+  const size_t probes[2] = { 2, 16 };
+  for (size_t p = 0; p < 2; ++p)
+  {
+    ivf.NumProbes() = probes[p];
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    ivf.Search(queryData, 10, neighbors, distances);
+    REQUIRE(neighbors.n_rows == 10);
+    REQUIRE(neighbors.n_cols == 100);
+
+    for (size_t q = 0; q < queryData.n_cols; ++q)
+    {
+      if (arma::any(neighbors.col(q) == trueNeighbors(0, q)))
+        ++found[p];
+      for (size_t j = 1; j < 10; ++j)
+        REQUIRE(distances(j, q) >= distances(j - 1, q));
+    }
+  }
+
+  REQUIRE(found[1] >= found[0]);
+  REQUIRE(found[1] >= 90);
+}
+
+/**
+ * If the visited lists hold fewer points than requested, the missing results
+ * are marked as invalid.
+ */
+TEST_CASE("IVFPQSearchNotEnoughPointsTest", "[ProductQuantizationTest]")
+{
+  // Two well-separated groups of points, so each list holds one of them.
+  arma::mat referenceData(2, 40, arma::fill::randu);
+  referenceData.cols(20, 39) += 100.0;
+
+  IVFPQSearch<> ivf(referenceData, 2, 2, 4, 1);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivf.Search(arma::mat("0.5; 0.5"), 30, neighbors, distances);
+
+  for (size_t j = 0; j < 20; ++j)
+    REQUIRE(neighbors(j, 0) < 20);
+  for (size_t j = 20; j < 30; ++j)
+  {
+    REQUIRE(neighbors(j, 0) == SIZE_MAX);
+    REQUIRE(distances(j, 0) == DBL_MAX);
+  }
+}
+
+/**
+ * Make sure that the index gives the same results after serialization.
+ */
+TEST_CASE("IVFPQSearchSerializationTest", "[ProductQuantizationTest]")
+{
+  arma::mat referenceData(6, 1000, arma::fill::randu);
+  arma::mat queryData(6, 20, arma::fill::randu);
+
+  IVFPQSearch<> ivf(referenceData, 8, 3, 32, 3, 2);
+  IVFPQSearch<> xmlIvf, jsonIvf, binaryIvf;
+
+  SerializeObjectAll(ivf, xmlIvf, jsonIvf, binaryIvf);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  ivf.Search(queryData, 5, neighbors, distances);
+  xmlIvf.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  jsonIvf.Search(queryData, 5, jsonNeighbors, jsonDistances);
+  binaryIvf.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  REQUIRE(binaryIvf.NumProbes() == 3);
+  REQUIRE(binaryIvf.Quantizer().Rotation().n_rows == 6);
+
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
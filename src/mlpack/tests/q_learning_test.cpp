@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/empty_loss.hpp>
+#include <mlpack/methods/reinforcement_learning/actor_learner.hpp>
 #include <mlpack/methods/reinforcement_learning/q_learning.hpp>
 #include <mlpack/methods/reinforcement_learning/sac.hpp>
 #include <mlpack/methods/reinforcement_learning/q_networks/simple_dqn.hpp>
@@ -123,6 +124,96 @@ TEST_CASE("CartPoleWithDQN", "[QLearningTest]")
   REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task, with several actors and a separate learner.
+TEST_CASE("CartPoleWithDQNActorLearner", "[QLearningTest]")
+{
+  // Set up the network.
+  SimpleDQN<> network(4, 128, 128, 2);
+
+  // Set up the policy and replay method.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  // Setting all training hyperparameters.
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.DoubleQLearning() = false;
+  config.StepLimit() = 200;
+  config.NumWorkers() = 4;
+  config.UpdateInterval() = 10;
+
+  ActorLearner<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+  agent.SyncInterval() = 50;
+
+  // Stop when the average return of the last 50 episodes of the actors is
+  // high enough, or when too many episodes were run.
+  std::vector<double> returnList;
+  size_t episodes = 0;
+  bool converged = false;
+  auto measure = [&](double episodeReturn)
+  {
+    episodes++;
+    returnList.push_back(episodeReturn);
+    if (returnList.size() > 50)
+      returnList.erase(returnList.begin());
+
+    const double averageReturn = std::accumulate(returnList.begin(),
+        returnList.end(), 0.0) / returnList.size();
+    converged = (returnList.size() >= 50 && averageReturn > 40);
+    return converged || episodes > 2000;
+  };
+
+  agent.Train(measure);
+
+  REQUIRE(agent.Learner().TotalSteps() > 0);
+  REQUIRE(converged);
+}
+
+//! Test DQN in Cart Pole task, running several environments in lockstep.
+TEST_CASE("CartPoleWithDQNVectorEnvironment", "[QLearningTest]")
+{
+  // Set up the network.
+  SimpleDQN<> network(4, 128, 128, 2);
+
+  // Set up the policy and replay method.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  // Setting all training hyperparameters.
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.DoubleQLearning() = false;
+
+  // Set up DQN agent.
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  VectorEnvironment<CartPole> environments(4);
+  bool converged = false;
+  arma::running_stat<double> averageReturn;
+  for (size_t i = 0; i < 250 && !converged; ++i)
+  {
+    const arma::vec returns = agent.Episodes(environments);
+    REQUIRE(returns.n_elem == 4);
+
+    // Average over the episodes of the last 5 calls.
+    if (i % 5 == 0)
+      averageReturn.reset();
+    averageReturn(arma::mean(returns));
+    converged = (i % 5 == 4) && averageReturn.mean() > 40;
+  }
+
+  REQUIRE(std::isfinite(double(agent.Action().action)));
+  REQUIRE(converged);
+}
+
 //! Test DQN in Cart Pole task with Prioritized Replay.
 TEST_CASE("CartPoleWithDQNPrioritizedReplay", "[QLearningTest]")
 {
@@ -241,3 +241,42 @@ TEST_CASE("QDAFNSparseTest", "[QDAFNTest]")
   REQUIRE(distances.n_rows == 3);
   REQUIRE(distances.n_cols == 1000);
 }
+
+/**
+ * Make sure that the tables can be stored in single precision, and that the
+ * neighbors that are returned are distinct and sorted from the furthest.
+ */
+TEST_CASE("QDAFNFloatTest", "[QDAFNTest]")
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(10, 500);
+
+  QDAFN<arma::fmat> qdafn(dataset, 10, 30);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(dataset, 3, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 3);
+  REQUIRE(neighbors.n_cols == 500);
+  REQUIRE(distances.n_rows == 3);
+  REQUIRE(distances.n_cols == 500);
+
+  for (size_t i = 0; i < 500; ++i)
+  {
+    REQUIRE(neighbors(0, i) < 500);
+    REQUIRE(neighbors(1, i) < 500);
+    REQUIRE(neighbors(2, i) < 500);
+    REQUIRE(neighbors(0, i) != neighbors(1, i));
+    REQUIRE(neighbors(0, i) != neighbors(2, i));
+    REQUIRE(neighbors(1, i) != neighbors(2, i));
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+      const double distance = arma::norm(dataset.col(i) -
+          dataset.col(neighbors(j, i)));
+      REQUIRE(distances(j, i) == Approx(distance).epsilon(1e-5));
+      if (j > 0)
+        REQUIRE(distances(j, i) <= distances(j - 1, i));
+    }
+  }
+}
@@ -56,3 +56,27 @@ TEST_CASE("Radical_Test_Radical3D", "[RadicalTest]")
   // Larger tolerance is sometimes needed.
   REQUIRE(valBest == Approx(valEst).epsilon(0.02));
 }
+
+/**
+ * Sampling the replicates should still recover two mixed independent sources.
+ */
+TEST_CASE("RadicalSamplesTest", "[RadicalTest]")
+{
+  // Two uniform sources, mixed by a rotation.
+  mat matS = 2 * randu<mat>(2, 2000) - 1;
+  const double theta = 0.4;
+  mat rotation = { { cos(theta), -sin(theta) },
+                   { sin(theta), cos(theta) } };
+  mat matX = rotation * matS;
+
+  Radical rad(0.175, 30, 150, 1);
+  rad.Samples() = 10000;
+
+  mat matY, matW;
+  rad.DoRadical(matX, matY, matW);
+
+  // Each component should be almost perfectly correlated with one source.
+  const mat correlation = abs(cor(matY.t(), matS.t()));
+  for (uword i = 0; i < 2; ++i)
+    REQUIRE(max(correlation.row(i)) > 0.99);
+}
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/distributed_random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include "serialization.hpp"
@@ -114,6 +115,34 @@ TEST_CASE("EmptyClassifyTest", "[RandomForestTest]")
       pointProbabilities), std::invalid_argument);
 }
 
+/**
+ * Make sure that the predictions are the same in NUMA mode, where the points
+ * may be classified with replicas of the forest.
+ */
+TEST_CASE("NUMAModeClassifyTest", "[RandomForestTest]")
+{
+  arma::mat dataset(5, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0;
+
+  RandomForest<> rf(dataset, labels, 2, 10);
+
+  arma::Row<size_t> predictions, numaPredictions;
+  arma::mat probabilities, numaProbabilities;
+  rf.Classify(dataset, predictions, probabilities);
+
+  SetNUMAMode(true);
+  rf.Classify(dataset, numaPredictions, numaProbabilities);
+  arma::Row<size_t> numaPredictions2;
+  rf.Classify(dataset, numaPredictions2);
+  SetNUMAMode(false);
+
+  CheckMatrices(predictions, numaPredictions);
+  CheckMatrices(predictions, numaPredictions2);
+  CheckMatrices(probabilities, numaProbabilities);
+}
+
 /**
  * Test unweighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -609,3 +638,242 @@ TEST_CASE("ExtraTreesAccuracyTest", "[RandomForestTest]")
 
   REQUIRE(accuracy >= 0.91);
 }
+
+/**
+ * Make sure that a compiled forest gives the same predictions and
+ * probabilities as the forest, and that it can be serialized.
+ */
+TEST_CASE("CompiledRandomForestTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  RandomForest<> rf(d, di, l, 5, 10 /* 10 trees */, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(3));
+  FlatForest flat = rf.Compile();
+  REQUIRE(flat.NumTrees() == 10);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(d, predictions, probabilities);
+  flat.Classify(d, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  FlatForest xmlFlat, jsonFlat, binaryFlat;
+  SerializeObjectAll(flat, xmlFlat, jsonFlat, binaryFlat);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, jsonProbabilities, binaryProbabilities;
+  xmlFlat.Classify(d, xmlPredictions, xmlProbabilities);
+  jsonFlat.Classify(d, jsonPredictions, jsonProbabilities);
+  binaryFlat.Classify(d, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(flatPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+  CheckMatrices(flatProbabilities, xmlProbabilities, jsonProbabilities,
+      binaryProbabilities);
+}
+
+/**
+ * Make sure that the bootstrap weights of the sampled points are their
+ * multiplicities, times their weights.
+ */
+TEST_CASE("BootstrapIndicesTest", "[RandomForestTest]")
+{
+  arma::rowvec weights(1000);
+  weights.fill(0.5);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::uvec indices;
+    arma::rowvec bootstrapWeights, weightedBootstrapWeights;
+    BootstrapIndices<false>(1000, weights, indices, bootstrapWeights);
+
+    REQUIRE(indices.n_elem == bootstrapWeights.n_elem);
+    REQUIRE(indices.n_elem < 1000);
+    REQUIRE(arma::accu(bootstrapWeights) == Approx(1000.0));
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      REQUIRE(indices[i] < 1000);
+      REQUIRE(bootstrapWeights[i] >= 1.0);
+      if (i > 0)
+        REQUIRE(indices[i] > indices[i - 1]);
+    }
+
+    BootstrapIndices<true>(1000, weights, indices, weightedBootstrapWeights);
+    REQUIRE(arma::accu(weightedBootstrapWeights) == Approx(500.0));
+  }
+}
+
+/**
+ * Make sure that a decision tree trained on a ColumnSubsetView is the same as
+ * one trained on a copy of the columns, and that the dataset is not modified.
+ */
+TEST_CASE("ColumnSubsetViewTrainTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+  const arma::mat original(d);
+
+  arma::uvec indices;
+  arma::rowvec noWeights, weights;
+  BootstrapIndices<false>(d.n_cols, noWeights, indices, weights);
+
+  const arma::mat subset = d.cols(indices);
+  const arma::Row<size_t> subsetLabels = l.cols(indices);
+
+  DecisionTree<> tree(ColumnSubsetView<arma::mat>(d, indices), di,
+      subsetLabels, 5, weights, 5);
+  DecisionTree<> copyTree(subset, di, subsetLabels, 5, weights, 5);
+
+  CheckMatrices(d, original);
+
+  arma::Row<size_t> predictions, copyPredictions;
+  arma::mat probabilities, copyProbabilities;
+  tree.Classify(d, predictions, probabilities);
+  copyTree.Classify(d, copyPredictions, copyProbabilities);
+  CheckMatrices(predictions, copyPredictions);
+  CheckMatrices(probabilities, copyProbabilities);
+}
+
+/**
+ * Make sure that a random forest can be trained on sparse data.
+ */
+TEST_CASE("SparseRandomForestTest", "[RandomForestTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(20, 3000, 0.2);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(0, i) + data(1, i) > 0.5) ? 1 : 0;
+
+  RandomForest<> rf(data, labels, 2, 20, 5);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(data, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  REQUIRE(double(correct) / double(data.n_cols) > 0.9);
+}
+
+/**
+ * Make sure that the out-of-bag error and the feature importances computed
+ * during training find the only informative dimension.
+ */
+TEST_CASE("OutOfBagStatisticsTest", "[RandomForestTest]")
+{
+  // Only the first dimension decides the label.
+  arma::mat d(4, 1000, arma::fill::randu);
+  arma::Row<size_t> l(1000);
+  for (size_t i = 0; i < d.n_cols; ++i)
+    l[i] = (d(0, i) > 0.5) ? 1 : 0;
+
+  RandomForest<> rf;
+  rf.ComputePermutationImportance() = true;
+  rf.Train(d, l, 2, 20, 5);
+
+  REQUIRE(std::isfinite(rf.OOBError()));
+  REQUIRE(rf.OOBError() >= 0.0);
+  REQUIRE(rf.OOBError() < 0.1);
+
+  REQUIRE(rf.ImpurityImportance().n_elem == 4);
+  REQUIRE(arma::accu(rf.ImpurityImportance()) == Approx(1.0).epsilon(1e-5));
+  REQUIRE(rf.ImpurityImportance().index_max() == 0);
+
+  REQUIRE(rf.PermutationImportance().n_elem == 4);
+  REQUIRE(rf.PermutationImportance().index_max() == 0);
+  REQUIRE(rf.PermutationImportance()[0] > 0.2);
+
+  // Without bootstrap sampling there are no out-of-bag points.
+  ExtraTrees<> et(d, l, 2, 20, 5);
+  REQUIRE(std::isnan(et.OOBError()));
+  REQUIRE(et.PermutationImportance().n_elem == 0);
+  REQUIRE(et.ImpurityImportance().index_max() == 0);
+}
+
+/**
+ * Make sure that merging two forests gives a forest with the trees of both,
+ * and that DistributedRandomForest on a single rank gives the same
+ * classifications with its local trees and with the merged forest.
+ */
+TEST_CASE("DistributedRandomForestMergeTest", "[RandomForestTest]")
+{
+  arma::mat dataset(5, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0;
+
+  RandomForest<> rf1(dataset, labels, 2, 4);
+  RandomForest<> rf2(dataset, labels, 2, 6);
+  RandomForest<> merged(rf1);
+  merged.Merge(rf2);
+  REQUIRE(merged.NumTrees() == 10);
+  REQUIRE(merged.OOBError() == Approx(0.4 * rf1.OOBError() +
+      0.6 * rf2.OOBError()));
+
+  DistributedRandomForest<> distributed;
+  distributed.Train(dataset, labels, 2, 10);
+  REQUIRE(distributed.NumTrees() == 10);
+  REQUIRE(distributed.LocalForest().NumTrees() == 10);
+
+  RandomForest<> forest;
+  distributed.Merge(forest);
+  REQUIRE(forest.NumTrees() == 10);
+
+  arma::Row<size_t> predictions, distributedPredictions;
+  arma::mat probabilities, distributedProbabilities;
+  forest.Classify(dataset, predictions, probabilities);
+  distributed.Classify(dataset, distributedPredictions,
+      distributedProbabilities);
+
+  CheckMatrices(predictions, distributedPredictions);
+  CheckMatrices(probabilities, distributedProbabilities);
+}
+
+/**
+ * Make sure that the early-exit classification gives the predictions of the
+ * full classification with confidence 1, with fewer tree evaluations, and
+ * fewer still with a lower confidence.
+ */
+TEST_CASE("RandomForestEarlyExitClassifyTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+
+  RandomForest<> rf(dataset, labels, 3, 50, 1, 1e-7);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(dataset, predictions);
+
+  arma::Row<size_t> exitPredictions;
+  arma::mat exitProbabilities;
+  const size_t evaluations = rf.EarlyExitClassify(dataset, exitPredictions,
+      exitProbabilities);
+  REQUIRE(exitProbabilities.n_rows == 3);
+  REQUIRE(exitProbabilities.n_cols == dataset.n_cols);
+  REQUIRE(evaluations < 50 * dataset.n_cols);
+  CheckMatrices(predictions, exitPredictions);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(arma::accu(exitProbabilities.col(i)) == Approx(1.0).epsilon(1e-7));
+    REQUIRE(exitPredictions[i] == exitProbabilities.col(i).index_max());
+  }
+
+  arma::Row<size_t> fastPredictions;
+  const size_t fastEvaluations = rf.EarlyExitClassify(dataset,
+      fastPredictions, 0.5);
+  REQUIRE(fastEvaluations <= evaluations);
+  const size_t agree = arma::accu(fastPredictions == predictions);
+  REQUIRE(agree >= size_t(0.9 * dataset.n_cols));
+
+  REQUIRE_THROWS_AS(rf.EarlyExitClassify(dataset, fastPredictions, 0.0),
+      std::invalid_argument);
+}
@@ -94,3 +94,149 @@ TEST_CASE("WeightedRandomTest", "[RandomTest]")
     }
   }
 }
+
+// Test that the random streams only depend on the seed and their index.
+TEST_CASE("RandomStreamTest", "[RandomTest]")
+{
+  RandomSeed(42);
+  const size_t first = ReserveRandomStreams(2);
+  REQUIRE(first == 0);
+  REQUIRE(ReserveRandomStreams(1) == 2);
+
+  std::mt19937 a = RandomStream(first);
+  std::mt19937 b = RandomStream(first);
+  std::mt19937 c = RandomStream(first + 1);
+  bool different = false;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const uint32_t x = a();
+    REQUIRE(x == b());
+    if (x != c())
+      different = true;
+  }
+  REQUIRE(different);
+
+  // Setting the seed again resets the streams.
+  RandomSeed(42);
+  REQUIRE(ReserveRandomStreams(1) == 0);
+  std::mt19937 d = RandomStream(0);
+  REQUIRE(d() == RandomStream(first)());
+
+  // A different seed gives different streams.
+  RandomSeed(43);
+  std::mt19937 e = RandomStream(0);
+  std::mt19937 f = RandomStream(first);
+  RandomSeed(42);
+  different = false;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    if (e() != f())
+      different = true;
+  }
+  REQUIRE(different);
+
+  RandomSeed(std::time(NULL));
+}
+
+// Test that a LocalRandomGenerator has its own seed and random streams, and
+// leaves the global ones (and those of other local generators) alone.
+TEST_CASE("LocalRandomStreamTest", "[RandomTest]")
+{
+  RandomSeed(42);
+  REQUIRE(ReserveRandomStreams(3) == 0);
+  const uint32_t global = RandomStream(1)();
+
+  uint32_t localFirst, localSecond;
+  {
+    LocalRandomGenerator local;
+    RandomSeed(7);
+    const size_t first = ReserveRandomStreams(2);
+
+    {
+      // Seeding another local generator does not change the streams of the
+      // first one.
+      LocalRandomGenerator other;
+      RandomSeed(8);
+      ReserveRandomStreams(5);
+    }
+
+    REQUIRE(ReserveRandomStreams(1) == first + 2);
+    localFirst = RandomStream(first)();
+    localSecond = RandomStream(first + 1)();
+  }
+
+  // The global streams were not disturbed.
+  REQUIRE(ReserveRandomStreams(1) == 3);
+  REQUIRE(RandomStream(1)() == global);
+
+  // The local streams are the global streams with the same seed.
+  RandomSeed(7);
+  REQUIRE(RandomStream(0)() == localFirst);
+  REQUIRE(RandomStream(1)() == localSecond);
+
+  RandomSeed(std::time(NULL));
+}
+
+// Test that the parallel fills are reproducible, whatever the number of
+// threads, and have the right distribution.
+TEST_CASE("RandomFillTest", "[RandomTest]")
+{
+  arma::mat first(100, 500), second(100, 500);
+  RandomSeed(7);
+  RandUniformFill(first);
+  RandomSeed(7);
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+  RandUniformFill(second);
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  REQUIRE(arma::approx_equal(first, second, "absdiff", 0.0));
+  REQUIRE(first.min() >= 0.0);
+  REQUIRE(first.max() < 1.0);
+  REQUIRE(arma::mean(arma::vectorise(first)) == Approx(0.5).margin(0.01));
+
+  // The next fill draws from new streams.
+  RandUniformFill(second);
+  REQUIRE(!arma::approx_equal(first, second, "absdiff", 0.0));
+
+  arma::fmat normal(200, 500);
+  RandNormalFill(normal);
+  REQUIRE(arma::mean(arma::vectorise(normal)) == Approx(0.0).margin(0.01));
+  REQUIRE(arma::stddev(arma::vectorise(normal)) == Approx(1.0).epsilon(0.01));
+
+  RandomSeed(std::time(NULL));
+}
+
+// Test that each thread of a parallel region has its own generator, which is
+// reproducible with the same seed.
+TEST_CASE("ThreadRandomTest", "[RandomTest]")
+{
+  #ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+
+  arma::mat first(10, numThreads), second(10, numThreads);
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::mat& values = (trial == 0) ? first : second;
+    RandomSeed(13);
+    #pragma omp parallel for schedule(static, 1)
+    for (omp_size_t t = 0; t < (omp_size_t) numThreads; ++t)
+    {
+      for (size_t i = 0; i < values.n_rows; ++i)
+        values(i, t) = Random();
+    }
+  }
+
+  REQUIRE(arma::approx_equal(first, second, "absdiff", 0.0));
+  if (numThreads > 1)
+    REQUIRE(!arma::approx_equal(first.col(0), first.col(1), "absdiff", 0.0));
+
+  RandomSeed(std::time(NULL));
+}
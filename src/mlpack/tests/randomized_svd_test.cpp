@@ -60,3 +60,40 @@ TEST_CASE("RandomizedSVDReconstructionError", "[RandomizedSVDTest]")
       arma::norm(centeredData, "frob");
   REQUIRE(error == Approx(0.0).margin(1e-5));
 }
+
+/**
+ * The randomized SVD of sparse data, which is centered implicitly, should be
+ * the same as the randomized SVD of the same data as a dense matrix.
+ */
+TEST_CASE("RandomizedSVDSparseTest", "[RandomizedSVDTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(50, 300, 0.05);
+  const arma::mat denseData(data);
+  const arma::mat rowMean = arma::mean(denseData, 1);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  // With the same random matrices, the two decompositions only differ by
+  // rounding errors.
+  svd::RandomizedSVD rSVD(0, 4);
+  math::RandomSeed(3);
+  rSVD.Apply(denseData, U1, s1, V1, 5, rowMean);
+  math::RandomSeed(3);
+  rSVD.Apply(data, U2, s2, V2, 5);
+
+  REQUIRE(s1.n_elem == s2.n_elem);
+  for (size_t i = 0; i < s1.n_elem; ++i)
+    REQUIRE(s2[i] == Approx(s1[i]).epsilon(1e-6));
+
+  // With full rank, the singular values are those of the centered data.
+  arma::mat centeredData;
+  math::Center(denseData, centeredData);
+  const arma::vec s3 = arma::svd(centeredData);
+
+  svd::RandomizedSVD fullSVD(0, 2);
+  fullSVD.Apply(data, U2, s2, V2, 50);
+  for (size_t i = 0; i < s3.n_elem; ++i)
+    REQUIRE(s2[i] == Approx(s3[i]).epsilon(1e-6).margin(1e-10));
+}
@@ -1355,6 +1355,67 @@ TEST_CASE("RSModelTest", "[RangeSearchTest]")
   }
 }
 
+/**
+ * Queries prepared once with RSModel::PrepareQueries() should give the same
+ * results as the usual search for several ranges.
+ */
+TEST_CASE("RSModelPreparedQueriesTest", "[RangeSearchTest]")
+{
+  arma::mat queryData = arma::randu<arma::mat>(5, 80);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 200);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::TreeTypes::KD_TREE,
+      RSModel::TreeTypes::COVER_TREE, RSModel::TreeTypes::R_TREE };
+  const math::Range ranges[] = { math::Range(0.0, 0.3),
+      math::Range(0.2, 0.6) };
+  util::Timers timers;
+
+  for (size_t t = 0; t < 3; ++t)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      RSModel model(treeTypes[t], false);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(timers, std::move(referenceCopy), 5, (j == 2),
+          (j == 1));
+
+      arma::mat queryCopy(queryData);
+      tree::PreparedQueries* queries = model.PrepareQueries(timers,
+          std::move(queryCopy));
+
+      for (size_t r = 0; r < 2; ++r)
+      {
+        RangeSearch<> rs(referenceData);
+        vector<vector<size_t>> baselineNeighbors;
+        vector<vector<double>> baselineDistances;
+        rs.Search(queryData, ranges[r], baselineNeighbors, baselineDistances);
+        vector<vector<pair<double, size_t>>> baselineSorted;
+        SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+        vector<vector<size_t>> neighbors;
+        vector<vector<double>> distances;
+        model.Search(timers, *queries, ranges[r], neighbors, distances);
+        vector<vector<pair<double, size_t>>> sorted;
+        SortResults(neighbors, distances, sorted);
+
+        REQUIRE(sorted.size() == baselineSorted.size());
+        for (size_t k = 0; k < sorted.size(); ++k)
+        {
+          REQUIRE(sorted[k].size() == baselineSorted[k].size());
+          for (size_t l = 0; l < sorted[k].size(); ++l)
+          {
+            REQUIRE(sorted[k][l].second == baselineSorted[k][l].second);
+            REQUIRE(sorted[k][l].first ==
+                Approx(baselineSorted[k][l].first).epsilon(1e-7));
+          }
+        }
+      }
+
+      delete queries;
+    }
+  }
+}
+
 TEST_CASE("RSModelMonochromaticTest", "[RangeSearchTest]")
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1718,3 +1779,172 @@ TEST_CASE("MoveOperatorNaiveTest", "[RangeSearchTest]")
     }
   }
 }
+
+// The parallel single-tree search is only used if OpenMP is available.
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that single-tree range search gives the same results as naive
+ * search when the query points are split across several threads.
+ */
+TEST_CASE("ParallelSingleTreeVsNaive", "[RangeSearchTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 800);
+
+  RangeSearch<> naive(referenceData, true);
+  vector<vector<size_t>> neighborsNaive;
+  vector<vector<double>> distancesNaive;
+  naive.Search(queryData, Range(0.1, 0.3), neighborsNaive, distancesNaive);
+  vector<vector<pair<double, size_t>>> sortedNaive;
+  SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  RangeSearch<> single(referenceData, false, true);
+  vector<vector<size_t>> neighborsSingle;
+  vector<vector<double>> distancesSingle;
+  single.Search(queryData, Range(0.1, 0.3), neighborsSingle, distancesSingle);
+
+  omp_set_num_threads(oldThreads);
+
+  vector<vector<pair<double, size_t>>> sortedSingle;
+  SortResults(neighborsSingle, distancesSingle, sortedSingle);
+
+  REQUIRE(sortedSingle.size() == sortedNaive.size());
+  for (size_t i = 0; i < sortedSingle.size(); ++i)
+  {
+    REQUIRE(sortedSingle[i].size() == sortedNaive[i].size());
+
+    for (size_t j = 0; j < sortedSingle[i].size(); ++j)
+    {
+      REQUIRE(sortedSingle[i][j].second == sortedNaive[i][j].second);
+      REQUIRE(sortedSingle[i][j].first ==
+          Approx(sortedNaive[i][j].first).epsilon(1e-7));
+    }
+  }
+}
+
+#endif
+
+/**
+ * Make sure that the results streamed to a callback are the same as those
+ * stored by Search(), in every search mode, with and without a query set.
+ */
+TEST_CASE("CallbackSearchTest", "[RangeSearchTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, (mode == 0), (mode == 1));
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      if (mono == 1)
+        rs.Search(Range(0.1, 0.3), neighbors, distances);
+      else
+        rs.Search(queryData, Range(0.1, 0.3), neighbors, distances);
+
+      // Only count the results, and sum the distances, of each query point.
+      const size_t numQueries = (mono == 1) ? referenceData.n_cols :
+          queryData.n_cols;
+      vector<size_t> counts(numQueries, 0);
+      vector<double> sums(numQueries, 0.0);
+      size_t maxReference = 0;
+      auto callback = [&](const size_t queryIndex,
+                          const size_t referenceIndex,
+                          const double distance)
+      {
+        ++counts[queryIndex];
+        sums[queryIndex] += distance;
+        #pragma omp critical
+        maxReference = std::max(maxReference, referenceIndex);
+      };
+
+      if (mono == 1)
+        rs.Search(Range(0.1, 0.3), callback);
+      else
+        rs.Search(queryData, Range(0.1, 0.3), callback);
+
+      REQUIRE(maxReference < referenceData.n_cols);
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        REQUIRE(counts[i] == neighbors[i].size());
+        double sum = 0.0;
+        for (size_t j = 0; j < distances[i].size(); ++j)
+          sum += distances[i][j];
+        REQUIRE(sums[i] == Approx(sum).epsilon(1e-7));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the compressed sparse row results and the counts are the same
+ * as the results stored by Search(), in every search mode, with and without a
+ * query set.
+ */
+TEST_CASE("CSRAndCountSearchTest", "[RangeSearchTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, (mode == 0), (mode == 1));
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      arma::Col<size_t> offsets, csrNeighbors, counts;
+      arma::vec csrDistances;
+      if (mono == 1)
+      {
+        rs.Search(Range(0.1, 0.3), neighbors, distances);
+        rs.Search(Range(0.1, 0.3), offsets, csrNeighbors, csrDistances);
+        rs.Count(Range(0.1, 0.3), counts);
+      }
+      else
+      {
+        rs.Search(queryData, Range(0.1, 0.3), neighbors, distances);
+        rs.Search(queryData, Range(0.1, 0.3), offsets, csrNeighbors,
+            csrDistances);
+        rs.Count(queryData, Range(0.1, 0.3), counts);
+      }
+
+      REQUIRE(offsets.n_elem == neighbors.size() + 1);
+      REQUIRE(counts.n_elem == neighbors.size());
+      REQUIRE(offsets[neighbors.size()] == csrNeighbors.n_elem);
+      REQUIRE(csrDistances.n_elem == csrNeighbors.n_elem);
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        REQUIRE(counts[i] == neighbors[i].size());
+        REQUIRE(offsets[i + 1] - offsets[i] == neighbors[i].size());
+
+        // The results of each query point are in no particular order.
+        vector<pair<size_t, double>> sorted, csrSorted;
+        for (size_t j = 0; j < neighbors[i].size(); ++j)
+        {
+          sorted.push_back(make_pair(neighbors[i][j], distances[i][j]));
+          csrSorted.push_back(make_pair(csrNeighbors[offsets[i] + j],
+              csrDistances[offsets[i] + j]));
+        }
+        sort(sorted.begin(), sorted.end());
+        sort(csrSorted.begin(), csrSorted.end());
+
+        for (size_t j = 0; j < sorted.size(); ++j)
+        {
+          REQUIRE(csrSorted[j].first == sorted[j].first);
+          REQUIRE(csrSorted[j].second ==
+              Approx(sorted[j].second).epsilon(1e-7));
+        }
+      }
+    }
+  }
+}
@@ -211,6 +211,85 @@ TEST_CASE("ssRBMClassificationTest", "[RBMNetworkTest]")
   REQUIRE(ssRbmClassificationAccuracy >= 76.18 - 3.0);
 }
 
+/**
+ * Check that the batched Bernoulli sampling of the BinaryRBM gives samples of
+ * the hidden and visible means.
+ */
+TEST_CASE("BinaryRBMSamplingTest", "[RBMNetworkTest]")
+{
+  const size_t visibleSize = 6, hiddenSize = 4, numSamples = 20000;
+  arma::mat data = arma::randu(visibleSize, 10);
+  RBM<GaussianInitialization> model(data, GaussianInitialization(0, 1),
+      visibleSize, hiddenSize);
+  model.Reset();
+
+  // Sample the hidden layer for many copies of the same point.
+  arma::mat input = arma::repmat(data.col(0), 1, numSamples);
+  arma::mat hiddenMean, hidden;
+  model.HiddenMean(data.col(0), hiddenMean);
+  model.SampleHidden(input, hidden);
+  REQUIRE(hidden.n_rows == hiddenSize);
+  REQUIRE(hidden.n_cols == numSamples);
+  REQUIRE(arma::all(arma::vectorise((hidden == 0) + (hidden == 1)) == 1));
+
+  const arma::vec hiddenFrequency = arma::mean(hidden, 1);
+  for (size_t i = 0; i < hiddenSize; ++i)
+    REQUIRE(hiddenFrequency(i) == Approx(hiddenMean(i)).margin(0.02));
+
+  // Now sample the visible layer from the hidden samples.
+  arma::mat visibleMean, visible;
+  model.VisibleMean(hidden, visibleMean);
+  model.SampleVisible(hidden, visible);
+  REQUIRE(visible.n_rows == visibleSize);
+  REQUIRE(visible.n_cols == numSamples);
+
+  const arma::vec visibleFrequency = arma::mean(visible, 1);
+  const arma::vec expectedFrequency = arma::mean(visibleMean, 1);
+  for (size_t i = 0; i < visibleSize; ++i)
+    REQUIRE(visibleFrequency(i) == Approx(expectedFrequency(i)).margin(0.02));
+}
+
+/**
+ * Check that the spike and slab means of the SpikeSlabRBM, computed with one
+ * matrix product over all the hidden units, match their definitions.
+ */
+TEST_CASE("SpikeSlabRBMMeanTest", "[RBMNetworkTest]")
+{
+  const size_t visibleSize = 5, hiddenSize = 3, poolSize = 2;
+  const double slabPenalty = 8;
+  arma::mat data = arma::randu(visibleSize, 4);
+  RBM<GaussianInitialization, arma::mat, SpikeSlabRBM> model(data,
+      GaussianInitialization(0, 0.5), visibleSize, hiddenSize, 4, 1, 1,
+      poolSize, slabPenalty, 1);
+  model.Reset();
+  model.VisiblePenalty().fill(5);
+  model.SpikeBias().randn();
+
+  arma::mat spikeMean(hiddenSize, 1);
+  model.SpikeMean(data, spikeMean);
+  arma::mat spike = arma::mat("1; 0; 1");
+  arma::mat slabMean(poolSize, hiddenSize);
+  model.SlabMean(data, spike, slabMean);
+
+  for (size_t i = 0; i < hiddenSize; ++i)
+  {
+    const arma::mat& w = model.Weight().slice(i);
+    const double energy = arma::accu(data.t() * (w * w.t()) * data) /
+        (2.0 * slabPenalty * data.n_cols * data.n_cols);
+    const double expected = 1.0 / (1.0 + std::exp(-energy -
+        model.SpikeBias()(i)));
+    REQUIRE(spikeMean(i) == Approx(expected).epsilon(1e-10));
+
+    const arma::vec expectedSlab = arma::mean(w.t() * data, 1) * spike(i) /
+        slabPenalty;
+    for (size_t j = 0; j < poolSize; ++j)
+    {
+      REQUIRE(slabMean(j, i) ==
+          Approx(expectedSlab(j)).epsilon(1e-10).margin(1e-12));
+    }
+  }
+}
+
 template<typename MatType = arma::mat>
 void BuildVanillaNetwork(MatType& trainData,
                          const size_t hiddenLayerSize)
@@ -1359,3 +1359,106 @@ TEST_CASE("RectangleTreeMoveDatasetTest", "[RectangleTreeTraitsTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * Bulk load a tree of the given type with the given policy, check that it is
+ * valid and full, and that it gives the same neighbors as a naive search.
+ */
+template<template<typename, typename, typename> class TreeType,
+         typename BulkLoadType>
+void CheckBulkLoadedTree(const arma::mat& dataset)
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, BulkLoadType(), 20, 6, 5, 2);
+
+  REQUIRE(tree.NumDescendants() == dataset.n_cols);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+
+  // Every point is in exactly one leaf, and the leaves are full, except
+  // possibly the last two.
+  arma::Col<size_t> counts(dataset.n_cols, arma::fill::zeros);
+  size_t numLeaves = 0;
+  std::vector<const Tree*> stack(1, &tree);
+  while (!stack.empty())
+  {
+    const Tree* node = stack.back();
+    stack.pop_back();
+    if (node->IsLeaf())
+    {
+      ++numLeaves;
+      for (size_t i = 0; i < node->Count(); ++i)
+        ++counts[node->Point(i)];
+    }
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push_back(&node->Child(i));
+  }
+
+  REQUIRE(arma::all(counts == 1));
+  REQUIRE(numLeaves == (dataset.n_cols + 19) / 20);
+
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn1(std::move(tree));
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  CheckMatrices(neighbors1, neighbors2);
+  CheckMatrices(distances1, distances2);
+}
+
+/**
+ * Bulk load R trees, R* trees and X trees with STR and Hilbert packing.
+ */
+TEST_CASE("RectangleTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset;
+  dataset.randu(4, 1013); // 1013 points in 4 dimensions.
+
+  CheckBulkLoadedTree<RTree, STRBulkLoad>(dataset);
+  CheckBulkLoadedTree<RTree, HilbertBulkLoad>(dataset);
+  CheckBulkLoadedTree<RStarTree, STRBulkLoad>(dataset);
+  CheckBulkLoadedTree<RStarTree, HilbertBulkLoad>(dataset);
+  CheckBulkLoadedTree<XTree, STRBulkLoad>(dataset);
+  CheckBulkLoadedTree<XTree, HilbertBulkLoad>(dataset);
+}
+
+/**
+ * Points can still be inserted into a bulk-loaded tree.
+ */
+TEST_CASE("RectangleTreeBulkLoadInsertTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset;
+  dataset.randu(3, 500);
+
+  typedef RStarTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, STRBulkLoad());
+  REQUIRE(tree.NumDescendants() == 500);
+
+  // Insert the first 100 points a second time.
+  for (size_t i = 0; i < 100; ++i)
+    tree.InsertPoint(i);
+
+  REQUIRE(tree.NumDescendants() == 600);
+  CheckContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+
+  // A dataset smaller than a leaf gives a single leaf.
+  arma::mat smallDataset(3, 10, arma::fill::randu);
+  TreeType smallTree(smallDataset, HilbertBulkLoad());
+  REQUIRE(smallTree.IsLeaf());
+  REQUIRE(smallTree.Count() == 10);
+  CheckExactContainment(smallTree);
+}
@@ -931,3 +931,196 @@ TEST_CASE("RNNCheckInputShapeTest", "[RecurrentNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(input, labels, opt), std::logic_error);
 }
+
+/**
+ * Test that training a RNN with gradient checkpointing gives the same model as
+ * training it without.
+ */
+TEST_CASE("RNNCheckpointingTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 6);
+
+  arma::cube labels = arma::zeros<arma::cube>(1, labelsTemp.n_cols, rho);
+  for (size_t i = 0; i < labelsTemp.n_cols; ++i)
+  {
+    const int value = arma::as_scalar(arma::find(
+        arma::max(labelsTemp.col(i)) == labelsTemp.col(i), 1));
+    labels.tube(0, i).fill(value);
+  }
+
+  arma::mat parameters[2];
+  for (size_t i = 0; i < 2; ++i)
+  {
+    RNN<> model(rho);
+    model.Add<IdentityLayer<> >();
+    model.Add<Linear<> >(1, 4);
+    model.Add<LSTM<> >(4, 4, rho);
+    model.Add<Linear<> >(4, 10);
+    model.Add<LogSoftMax<> >();
+    model.Checkpointing() = (i == 1);
+
+    math::RandomSeed(7);
+    StandardSGD opt(0.1, 1, 2 * input.n_cols, -100, false);
+    model.Train(input, labels, opt);
+    parameters[i] = model.Parameters();
+  }
+
+  CheckMatrices(parameters[0], parameters[1]);
+}
+
+/**
+ * Test that training a BRNN whose directions run in parallel gives the same
+ * model and the same predictions as training it sequentially.
+ */
+TEST_CASE("BRNNParallelTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 6);
+
+  arma::cube labels = arma::zeros<arma::cube>(1, labelsTemp.n_cols, rho);
+  for (size_t i = 0; i < labelsTemp.n_cols; ++i)
+  {
+    const int value = arma::as_scalar(arma::find(
+        arma::max(labelsTemp.col(i)) == labelsTemp.col(i), 1));
+    labels.tube(0, i).fill(value);
+  }
+
+  arma::mat parameters[2];
+  arma::cube predictions[2];
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BRNN<> model(rho);
+    model.Add<IdentityLayer<> >();
+    model.Add<Linear<> >(1, 4);
+    model.Add<LSTM<> >(4, 4, rho);
+    model.Add<Linear<> >(4, 5);
+    model.Parallel() = (i == 1);
+
+    math::RandomSeed(7);
+    StandardSGD opt(0.1, 1, 2 * input.n_cols, -100, false);
+    model.Train(input, labels, opt);
+    parameters[i] = model.Parameters();
+    model.Predict(input, predictions[i]);
+  }
+
+  CheckMatrices(parameters[0], parameters[1]);
+  CheckMatrices(predictions[0], predictions[1]);
+}
+
+/**
+ * Check that stepping a RNN with the given recurrent layer through a sequence
+ * gives the same outputs as Predict(), both for a batch of streams and for
+ * groups of streams that are stepped separately and then batched together.
+ */
+template<typename RecurrentLayerType>
+void CheckRNNStep()
+{
+  const size_t rho = 5;
+  const arma::cube input(3, 4, rho, arma::fill::randu);
+
+  RNN<> model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<Linear<> >(3, 6);
+  model.Add<RecurrentLayerType>(6, 4, rho);
+  model.Add<Linear<> >(4, 2);
+
+  arma::cube predictions;
+  model.Predict(input, predictions);
+
+  arma::mat output;
+  for (size_t t = 0; t < rho; ++t)
+  {
+    model.Step(input.slice(t), output);
+    CheckMatrices(output, predictions.slice(t));
+  }
+
+  // A new sequence starts after ResetStepState().
+  model.ResetStepState();
+  model.Step(input.slice(0), output);
+  CheckMatrices(output, predictions.slice(0));
+
+  std::vector<arma::mat> stateA, stateB;
+  arma::mat outputA, outputB;
+  for (size_t t = 0; t < 2; ++t)
+  {
+    model.Step(input.slice(t).cols(0, 1), outputA, stateA);
+    model.Step(input.slice(t).cols(2, 3), outputB, stateB);
+    CheckMatrices(arma::join_rows(outputA, outputB), predictions.slice(t));
+  }
+
+  std::vector<arma::mat> state(stateA.size());
+  for (size_t l = 0; l < state.size(); ++l)
+    state[l] = arma::join_rows(stateA[l], stateB[l]);
+
+  for (size_t t = 2; t < rho; ++t)
+  {
+    model.Step(input.slice(t), output, state);
+    CheckMatrices(output, predictions.slice(t));
+  }
+
+  // A state of the wrong number of streams is rejected.
+  REQUIRE_THROWS_AS(model.Step(input.slice(0).cols(0, 1), output, state),
+      std::invalid_argument);
+}
+
+/**
+ * Test that RNN::Step() matches RNN::Predict() for each recurrent layer that
+ * supports it.
+ */
+TEST_CASE("RNNStepTest", "[RecurrentNetworkTest]")
+{
+  CheckRNNStep<LSTM<> >();
+  CheckRNNStep<FastLSTM<> >();
+  CheckRNNStep<GRU<> >();
+}
+
+/**
+ * Make sure that a network created with RNN::ShareWeights() uses the memory of
+ * the weights of the original network, so that it gives the same predictions,
+ * and that training the original network changes the shared network too.
+ */
+TEST_CASE("RNNShareWeightsTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 5;
+  const arma::cube input(3, 20, rho, arma::fill::randu);
+  const arma::cube responses(2, 20, rho, arma::fill::randu);
+
+  RNN<MeanSquaredError<> > model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<Linear<> >(3, 6);
+  model.Add<LSTM<> >(6, 4, rho);
+  model.Add<Linear<> >(4, 2);
+
+  arma::cube predictions;
+  model.Predict(input, predictions);
+
+  RNN<MeanSquaredError<> > shared = model.ShareWeights();
+  REQUIRE(shared.Parameters().memptr() == model.Parameters().memptr());
+  REQUIRE(shared.Parameters().n_elem == model.Parameters().n_elem);
+
+  arma::cube sharedPredictions;
+  shared.Predict(input, sharedPredictions);
+  CheckMatrices(predictions, sharedPredictions);
+
+  // Training the original network updates its weights in place, so the shared
+  // network sees the new weights.
+  const arma::mat oldParameters = model.Parameters();
+  StandardSGD opt(0.1, 5, 10 * input.n_cols, -100, false);
+  model.Train(input, responses, opt);
+
+  REQUIRE(shared.Parameters().memptr() == model.Parameters().memptr());
+  CheckMatricesNotEqual(oldParameters, shared.Parameters());
+
+  arma::cube trainedPredictions;
+  model.Predict(input, trainedPredictions);
+  shared.Predict(input, sharedPredictions);
+  CheckMatricesNotEqual(predictions, sharedPredictions);
+  CheckMatrices(trainedPredictions, sharedPredictions);
+}
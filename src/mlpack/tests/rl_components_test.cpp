@@ -20,8 +20,10 @@
 #include <mlpack/methods/reinforcement_learning/environment/continuous_double_pole_cart.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vector_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
+#include <mlpack/methods/reinforcement_learning/policy/aggregated_policy.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -271,6 +273,151 @@ TEST_CASE("RandomReplayTest", "[RLComponentsTest]")
   }
 }
 
+/**
+ * Store the transitions of several environments at once, and make sure that
+ * the n-step transitions are made separately for each environment.
+ */
+TEST_CASE("RandomReplayBatchStoreTest", "[RLComponentsTest]")
+{
+  RandomReplay<MountainCar> replay(1, 10, 2);
+  MountainCar env;
+  std::vector<MountainCar::State> states(2, env.InitialSample());
+  std::vector<MountainCar::Action> actions(2);
+  const arma::Col<size_t> environments = { 0, 1 };
+
+  replay.Store(states, actions, arma::rowvec({ 1.0, 10.0 }), states,
+      arma::irowvec({ 0, 0 }), environments, 0.9);
+  REQUIRE(replay.Size() == 0);
+
+  replay.Store(states, actions, arma::rowvec({ 2.0, 20.0 }), states,
+      arma::irowvec({ 0, 0 }), environments, 0.9);
+  REQUIRE(replay.Size() == 2);
+
+  // Each sampled reward is the two-step return of one of the environments.
+  arma::mat sampledState, sampledNextState;
+  arma::rowvec sampledReward;
+  arma::irowvec sampledTerminal;
+  for (size_t i = 0; i < 30; ++i)
+  {
+    std::vector<MountainCar::Action> sampledAction;
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+    const double reward = arma::as_scalar(sampledReward);
+    REQUIRE((reward == Approx(2.8) || reward == Approx(28.0)));
+  }
+}
+
+/**
+ * Make sure that the states of an episode are stored once, and that the
+ * oldest transitions are dropped when the observations run out.
+ */
+TEST_CASE("RandomReplaySharedStatesTest", "[RLComponentsTest]")
+{
+  // Ten transitions of one episode take eleven observations.
+  RandomReplay<MountainCar> replay(4, 10, 1, MountainCar::State::dimension,
+      11);
+  MountainCar env(0);
+  std::vector<MountainCar::State> states(1, env.InitialSample());
+  MountainCar::Action action;
+  action.action = MountainCar::Action::actions::forward;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    MountainCar::State nextState;
+    const double reward = env.Sample(states.back(), action, nextState);
+    replay.Store(states.back(), action, reward, nextState, false, 0.9);
+    states.push_back(nextState);
+  }
+  REQUIRE(replay.Size() == 10);
+  REQUIRE(replay.Memory().ObservationCapacity() == 11);
+
+  // The next state of each sampled transition is the state that followed.
+  arma::mat sampledStates, sampledNextStates;
+  std::vector<MountainCar::Action> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::irowvec sampledTerminal;
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    replay.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, sampledTerminal);
+    REQUIRE(sampledStates.n_cols == 4);
+    REQUIRE(sampledActions.size() == 4);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      size_t j = 0;
+      while (j < 10 && !arma::approx_equal(states[j].Encode(),
+          sampledStates.col(i), "absdiff", 1e-12))
+        ++j;
+      REQUIRE(j < 10);
+      CheckMatrices(states[j + 1].Encode(),
+          arma::mat(sampledNextStates.col(i)));
+    }
+  }
+
+  // A transition that does not follow the previous one takes two more
+  // observations, so the two oldest transitions are dropped.
+  replay.Store(states[0], action, 0.0, states[5], true, 0.9);
+  REQUIRE(replay.Size() == 9);
+}
+
+/**
+ * Step several copies of an environment in lockstep, and make sure that each
+ * copy behaves as a single environment would.
+ */
+TEST_CASE("VectorEnvironmentTest", "[RLComponentsTest]")
+{
+  VectorEnvironment<CartPole> environments(3, CartPole(5));
+  REQUIRE(environments.NumEnvironments() == 3);
+
+  std::vector<CartPole::State> states = environments.InitialSample();
+  REQUIRE(environments.IsTerminal(states).max() == 0);
+
+  const arma::mat encoded = VectorEnvironment<CartPole>::Encode(states);
+  REQUIRE(encoded.n_rows == CartPole::State::dimension);
+  REQUIRE(encoded.n_cols == 3);
+
+  std::vector<CartPole::Action> actions(3);
+  actions[0].action = CartPole::Action::actions::backward;
+  actions[1].action = CartPole::Action::actions::forward;
+  actions[2].action = CartPole::Action::actions::backward;
+
+  size_t steps = 0;
+  while (environments.IsTerminal(states).min() == 0)
+  {
+    // Keep copies of the environments from before the step.
+    std::vector<CartPole> before;
+    for (size_t i = 0; i < 3; ++i)
+      before.push_back(environments.Environment(i));
+    const arma::irowvec terminal = environments.IsTerminal(states);
+
+    std::vector<CartPole::State> nextStates;
+    const arma::rowvec rewards = environments.Sample(states, actions,
+        nextStates);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      if (!terminal[i])
+      {
+        // The copy moves as a single environment would.
+        CartPole::State nextState;
+        const double reward = before[i].Sample(states[i], actions[i],
+            nextState);
+        REQUIRE(rewards[i] == Approx(reward));
+        CheckMatrices(nextState.Encode(), nextStates[i].Encode());
+      }
+      else
+      {
+        // The copy is done, so it is not stepped.
+        REQUIRE(rewards[i] == 0.0);
+        CheckMatrices(states[i].Encode(), nextStates[i].Encode());
+      }
+    }
+
+    states = nextStates;
+    ++steps;
+    REQUIRE(steps <= 5);
+  }
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -286,3 +433,46 @@ TEST_CASE("GreedyPolicyTest", "[RLComponentsTest]")
   REQUIRE(actionValue[action.action] ==
       Approx(actionValue.max()).epsilon(1e-7));
 }
+
+/**
+ * Make sure that the batch sampling of the greedy policy and of the aggregated
+ * policy selects the greedy actions when it should, and explores otherwise.
+ */
+TEST_CASE("GreedyPolicyBatchSampleTest", "[RLComponentsTest]")
+{
+  const arma::mat actionValues = arma::randn<arma::mat>(
+      CartPole::Action::size, 1000);
+  const arma::urowvec greedy = arma::index_max(actionValues, 0);
+
+  // Without exploration, all the actions are greedy.
+  GreedyPolicy<CartPole> policy(1.0, 10, 0.0, 0.99);
+  std::vector<CartPole::Action> actions;
+  policy.Sample(actionValues, actions, true);
+  REQUIRE(actions.size() == 1000);
+  for (size_t i = 0; i < actions.size(); ++i)
+    REQUIRE((size_t) actions[i].action == greedy[i]);
+
+  // With epsilon = 1, the actions are random, so about half of them are
+  // greedy for the two actions of Cart Pole.
+  policy.Sample(actionValues, actions);
+  size_t numGreedy = 0;
+  for (size_t i = 0; i < actions.size(); ++i)
+    numGreedy += ((size_t) actions[i].action == greedy[i]);
+  REQUIRE(numGreedy > 400);
+  REQUIRE(numGreedy < 600);
+
+  for (size_t i = 0; i < 15; ++i)
+    policy.Anneal();
+  policy.Sample(actionValues, actions);
+  for (size_t i = 0; i < actions.size(); ++i)
+    REQUIRE((size_t) actions[i].action == greedy[i]);
+
+  // An aggregated policy of greedy children without exploration.
+  AggregatedPolicy<GreedyPolicy<CartPole>> aggregated(
+      { GreedyPolicy<CartPole>(0.0, 10, 0.0),
+        GreedyPolicy<CartPole>(0.0, 10, 0.0) }, arma::colvec("0.5 0.5"));
+  aggregated.Sample(actionValues, actions);
+  REQUIRE(actions.size() == 1000);
+  for (size_t i = 0; i < actions.size(); ++i)
+    REQUIRE((size_t) actions[i].action == greedy[i]);
+}
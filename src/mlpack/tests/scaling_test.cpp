@@ -172,3 +172,39 @@ TEST_CASE("ZCAWhiteningTest", "[ScalingTest]")
   scale.InverseTransform(output, temp);
   CheckMatrices(dataset, temp);
 }
+
+/**
+ * Make sure that fitting each scaler in chunks with PartialFit() gives the same
+ * scaling as fitting it on the whole dataset, and that the in-place Transform()
+ * gives the same result as the other overload.
+ */
+template<typename ScalerType>
+void CheckPartialFit(const arma::mat& data)
+{
+  ScalerType full, chunked;
+  full.Fit(data);
+  chunked.Fit(data.cols(0, 9));
+  chunked.PartialFit(data.cols(10, 49));
+  chunked.PartialFit(data.cols(50, data.n_cols - 1));
+
+  arma::mat fullOutput, chunkedOutput;
+  full.Transform(data, fullOutput);
+  chunked.Transform(data, chunkedOutput);
+  CheckMatrices(fullOutput, chunkedOutput);
+
+  arma::mat inPlace(data);
+  chunked.Transform(inPlace);
+  CheckMatrices(fullOutput, inPlace);
+}
+
+TEST_CASE("PartialFitTest", "[ScalingTest]")
+{
+  arma::mat data = 5.0 * arma::randu<arma::mat>(4, 200) - 2.0;
+  // A constant dimension checks the handling of zero scales.
+  data.row(3).fill(2.0);
+
+  CheckPartialFit<data::MinMaxScaler>(data);
+  CheckPartialFit<data::MaxAbsScaler>(data);
+  CheckPartialFit<data::StandardScaler>(data);
+  CheckPartialFit<data::MeanNormalization>(data);
+}
@@ -58,6 +58,28 @@ using namespace boost;
 using namespace cereal;
 using namespace std;
 
+/**
+ * A statistic that holds nothing, only used to give the tree type below its
+ * own serialization version.
+ */
+class VersionZeroStatistic
+{
+ public:
+  VersionZeroStatistic() { }
+
+  template<typename TreeType>
+  VersionZeroStatistic(TreeType& /* node */) { }
+
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+};
+
+// This kd-tree is saved and loaded with version 0 of the BinarySpaceTree
+// format (one nested object per node), which older versions of mlpack wrote.
+typedef KDTree<EuclideanDistance, VersionZeroStatistic, arma::mat>
+    VersionZeroKDTree;
+CEREAL_CLASS_VERSION(VersionZeroKDTree, 0);
+
 /**
  * Serialize a random cube.
  */
@@ -152,6 +174,85 @@ TEST_CASE("EmptySparseMatrixSerializeTest", "[SerializationTest]")
   TestAllArmadilloSerialization(m);
 }
 
+/**
+ * Make sure that the binary archive stores the elements of a matrix as raw
+ * memory, and that the elements of a matrix written one by one (as mlpack did
+ * before) can still be loaded.
+ */
+TEST_CASE("MatrixBinaryLayoutTest", "[SerializationTest]")
+{
+  arma::mat m;
+  m.randu(30, 40);
+
+  std::ostringstream oss;
+  {
+    cereal::BinaryOutputArchive ar(oss);
+    ar(cereal::make_nvp("matrix", m));
+  }
+
+  const std::string bytes = oss.str();
+  const size_t headerSize = 3 * sizeof(arma::uword);
+  REQUIRE(bytes.size() == headerSize + m.n_elem * sizeof(double));
+  const arma::mat raw((const double*) (bytes.data() + headerSize), m.n_rows,
+      m.n_cols);
+  CheckMatrices(m, raw);
+
+  std::ostringstream elementwise;
+  {
+    cereal::BinaryOutputArchive ar(elementwise);
+    arma::uword n_rows = m.n_rows, n_cols = m.n_cols, vec_state = 0;
+    ar(n_rows, n_cols, vec_state);
+    for (size_t i = 0; i < m.n_elem; ++i)
+      ar(m[i]);
+  }
+
+  arma::mat loaded;
+  std::istringstream iss(elementwise.str());
+  {
+    cereal::BinaryInputArchive ar(iss);
+    ar(cereal::make_nvp("matrix", loaded));
+  }
+  CheckMatrices(m, loaded);
+}
+
+/**
+ * A list of matrices, serialized with CEREAL_PARALLEL_VECTOR.
+ */
+struct MatrixList
+{
+  std::vector<arma::mat> matrices;
+
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(cereal::make_nvp("matrices", CEREAL_PARALLEL_VECTOR(matrices)));
+  }
+};
+
+/**
+ * Make sure that the elements of a vector serialized with
+ * CEREAL_PARALLEL_VECTOR are loaded back with every archive type.
+ */
+TEST_CASE("ParallelVectorSerializeTest", "[SerializationTest]")
+{
+  MatrixList list;
+  for (size_t i = 0; i < 50; ++i)
+    list.matrices.push_back(arma::randu<arma::mat>(i % 7, 10));
+
+  MatrixList xmlList, jsonList, binaryList, portableList;
+  SerializeObjectAll(list, xmlList, jsonList, binaryList);
+  SerializeObject<MatrixList, cereal::PortableBinaryInputArchive,
+      cereal::PortableBinaryOutputArchive>(list, portableList);
+
+  for (MatrixList* loaded : { &xmlList, &jsonList, &binaryList,
+      &portableList })
+  {
+    REQUIRE(loaded->matrices.size() == list.matrices.size());
+    for (size_t i = 0; i < list.matrices.size(); ++i)
+      CheckMatrices(loaded->matrices[i], list.matrices[i]);
+  }
+}
+
 TEST_CASE("BallBoundTest", "[SerializationTest]")
 {
   BallBound<> b(100);
@@ -336,6 +437,27 @@ TEST_CASE("BinarySpaceTreeTest", "[SerializationTest]")
 
   CheckTrees(tree, *xmlTree, *jsonTree, *binaryTree);
 
+  // The nodes below the root are loaded into one block, in preorder.
+  std::vector<TreeType*> nodes;
+  std::stack<TreeType*> stack;
+  stack.push(binaryTree);
+  while (!stack.empty())
+  {
+    TreeType* node = stack.top();
+    stack.pop();
+    nodes.push_back(node);
+    if (node->Right())
+      stack.push(node->Right());
+    if (node->Left())
+      stack.push(node->Left());
+  }
+
+  REQUIRE(nodes.size() > 2);
+  const ptrdiff_t stride = (char*) nodes[2] - (char*) nodes[1];
+  REQUIRE(stride > 0);
+  for (size_t i = 2; i < nodes.size(); ++i)
+    REQUIRE((char*) nodes[i] - (char*) nodes[i - 1] == stride);
+
   delete xmlTree;
   delete jsonTree;
   delete binaryTree;
@@ -359,6 +481,47 @@ TEST_CASE("BinarySpaceTreeOverwriteTest", "[SerializationTest]")
   CheckTrees(tree, xmlTree, jsonTree, binaryTree);
 }
 
+// Make sure a deep ball tree (one point per leaf) survives serialization.
+TEST_CASE("BinarySpaceTreeDeepTreeTest", "[SerializationTest]")
+{
+  arma::mat data;
+  data.randu(4, 1000);
+  typedef BallTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data, 1);
+
+  TreeType* xmlTree;
+  TreeType* jsonTree;
+  TreeType* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, jsonTree, binaryTree);
+
+  CheckTrees(tree, *xmlTree, *jsonTree, *binaryTree);
+
+  delete xmlTree;
+  delete jsonTree;
+  delete binaryTree;
+}
+
+// Make sure that trees in the version 0 format can still be loaded.
+TEST_CASE("BinarySpaceTreeVersionZeroTest", "[SerializationTest]")
+{
+  arma::mat data;
+  data.randu(3, 200);
+  VersionZeroKDTree tree(data, 5);
+
+  VersionZeroKDTree* xmlTree;
+  VersionZeroKDTree* jsonTree;
+  VersionZeroKDTree* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, jsonTree, binaryTree);
+
+  CheckTrees(tree, *xmlTree, *jsonTree, *binaryTree);
+
+  delete xmlTree;
+  delete jsonTree;
+  delete binaryTree;
+}
+
 TEST_CASE("CoverTreeTest", "[SerializationTest]")
 {
   arma::mat data;
@@ -1073,16 +1236,10 @@ TEST_CASE("LSHTest", "[SerializationTest]")
   REQUIRE(lsh.BucketSize() == jsonLsh.BucketSize());
   REQUIRE(lsh.BucketSize() == binaryLsh.BucketSize());
 
-  REQUIRE(lsh.SecondHashTable().size() ==
-      xmlLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      jsonLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      binaryLsh.SecondHashTable().size());
-
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      jsonLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  CheckMatrices(lsh.SecondHashTable(), xmlLsh.SecondHashTable(),
+      jsonLsh.SecondHashTable(), binaryLsh.SecondHashTable());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      jsonLsh.BucketOffsets(), binaryLsh.BucketOffsets());
 }
 
 // Make sure serialization works for LARS.
@@ -1303,6 +1460,43 @@ TEST_CASE("HoeffdingCategoricalSplitTest", "[SerializationTest]")
  * Make sure the HoeffdingTree object serializes correctly before a split has
  * occured.
  */
+/**
+ * Make sure that the mappings of a DatasetInfo survive serialization.
+ */
+TEST_CASE("DatasetInfoSerializationTest", "[SerializationTest]")
+{
+  data::DatasetInfo info(3);
+  for (size_t i = 0; i < 2000; ++i)
+    info.MapString<double>("value " + std::to_string(i), 1);
+  info.MapString<double>("", 2);
+  info.MapString<double>("a", 2);
+  info.MapString<double>("ab", 2);
+
+  data::DatasetInfo xmlInfo, jsonInfo, binaryInfo;
+  SerializeObjectAll(info, xmlInfo, jsonInfo, binaryInfo);
+
+  for (data::DatasetInfo* newInfo : { &xmlInfo, &jsonInfo, &binaryInfo })
+  {
+    REQUIRE(newInfo->Dimensionality() == 3);
+    REQUIRE(newInfo->Type(0) == data::Datatype::numeric);
+    REQUIRE(newInfo->Type(1) == data::Datatype::categorical);
+    REQUIRE(newInfo->NumMappings(1) == 2000);
+    REQUIRE(newInfo->NumMappings(2) == 3);
+
+    for (size_t i = 0; i < 2000; i += 37)
+    {
+      const std::string input = "value " + std::to_string(i);
+      REQUIRE(newInfo->UnmapValue(input, 1) == i);
+      REQUIRE(newInfo->UnmapString(i, 1) == input);
+    }
+    REQUIRE(newInfo->MapString<double>("ab", 2) == 2.0);
+    REQUIRE(newInfo->UnmapString(0, 2) == "");
+
+    // New mappings continue from the loaded ones.
+    REQUIRE(newInfo->MapString<double>("new", 1) == 2000.0);
+  }
+}
+
 TEST_CASE("HoeffdingTreeBeforeSplitTest", "[SerializationTest]")
 {
   data::DatasetInfo info(5);
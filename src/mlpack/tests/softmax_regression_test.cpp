@@ -674,3 +674,83 @@ TEST_CASE("SoftmaxRegressionComputeProbabilitiesAndLabelsTest",
     REQUIRE(testLabels(i) == labels(i));
   }
 }
+
+/**
+ * Make sure that the sparse gradient of the softmax regression function is the
+ * same as the dense gradient when there is no regularization.
+ */
+TEST_CASE("SoftmaxRegressionSparseGradientTest", "[SoftmaxRegressionTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(20, 50);
+  data.elem(arma::find(data < 0.8)).zeros();
+
+  arma::Row<size_t> labels(50);
+  for (size_t i = 0; i < 50; ++i)
+    labels(i) = math::RandInt(0, 3);
+
+  for (size_t fitIntercept = 0; fitIntercept < 2; ++fitIntercept)
+  {
+    SoftmaxRegressionFunction srf(data, labels, 3, 0, fitIntercept);
+
+    arma::mat parameters = arma::randu<arma::mat>(3, 20 + fitIntercept);
+    for (size_t begin = 0; begin < 50; begin += 10)
+    {
+      arma::mat gradient;
+      arma::sp_mat sparseGradient;
+      srf.Gradient(parameters, begin, gradient, 10);
+      srf.Gradient(parameters, begin, sparseGradient, 10);
+
+      REQUIRE(sparseGradient.n_rows == gradient.n_rows);
+      REQUIRE(sparseGradient.n_cols == gradient.n_cols);
+      const arma::mat denseGradient(sparseGradient);
+      for (size_t i = 0; i < gradient.n_elem; ++i)
+        REQUIRE(denseGradient[i] == Approx(gradient[i]).margin(1e-10));
+    }
+  }
+}
+
+/**
+ * Check EvaluateWithGradient() against Evaluate() and finite differences, and
+ * make sure that large scores do not overflow.
+ */
+TEST_CASE("SoftmaxRegressionEvaluateWithGradientTest",
+          "[SoftmaxRegressionTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 40);
+  arma::Row<size_t> labels(40);
+  for (size_t i = 0; i < 40; ++i)
+    labels(i) = i % 4;
+
+  for (size_t fitIntercept = 0; fitIntercept < 2; ++fitIntercept)
+  {
+    SoftmaxRegressionFunction srf(data, labels, 4, 0.01, fitIntercept);
+    arma::mat parameters = arma::randn<arma::mat>(4, 5 + fitIntercept);
+
+    for (size_t begin = 0; begin < 40; begin += 20)
+    {
+      arma::mat gradient;
+      const double objective = srf.EvaluateWithGradient(parameters, begin,
+          gradient, 20);
+      REQUIRE(objective ==
+          Approx(srf.Evaluate(parameters, begin, 20)).epsilon(1e-10));
+
+      for (size_t i = 0; i < parameters.n_elem; ++i)
+      {
+        arma::mat shifted(parameters);
+        shifted[i] += 1e-6;
+        const double plus = srf.Evaluate(shifted, begin, 20);
+        shifted[i] -= 2e-6;
+        const double minus = srf.Evaluate(shifted, begin, 20);
+        REQUIRE(gradient[i] ==
+            Approx((plus - minus) / 2e-6).epsilon(1e-4).margin(1e-6));
+      }
+    }
+
+    // exp(1000) overflows, but the probabilities are still well-defined.
+    arma::mat gradient;
+    const double objective = srf.EvaluateWithGradient(1000 * parameters,
+        gradient);
+    REQUIRE(std::isfinite(objective));
+    REQUIRE(gradient.is_finite());
+  }
+}
@@ -304,3 +304,138 @@ TEST_CASE("SpillTreeMoveDatasetTest", "[SpillTreeTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * Make sure that Relayout() reorders the dataset by leaf and keeps every node
+ * holding the same points.
+ */
+TEST_CASE("SpillTreeRelayoutTest", "[SpillTreeTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset, 0.05 /* tau */, 10 /* maxLeafSize */);
+  TreeType original(tree);
+
+  std::vector<size_t> oldFromNew;
+  tree.Relayout(oldFromNew);
+
+  REQUIRE(oldFromNew.size() == 1000);
+  std::vector<bool> seen(1000, false);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    REQUIRE(!seen[oldFromNew[i]]);
+    seen[oldFromNew[i]] = true;
+    REQUIRE(arma::approx_equal(tree.Dataset().col(i),
+        dataset.col(oldFromNew[i]), "absdiff", 1e-10));
+  }
+
+  // Walk both trees together; the leaves are reached in the new order, so the
+  // first time a point is seen it takes the next index.
+  std::stack<TreeType*> nodes, originalNodes;
+  nodes.push(&tree);
+  originalNodes.push(&original);
+  size_t next = 0;
+  while (!nodes.empty())
+  {
+    TreeType* node = nodes.top();
+    TreeType* originalNode = originalNodes.top();
+    nodes.pop();
+    originalNodes.pop();
+
+    REQUIRE(&node->Dataset() == &tree.Dataset());
+    REQUIRE(node->NumDescendants() == originalNode->NumDescendants());
+    for (size_t i = 0; i < node->NumDescendants(); ++i)
+    {
+      REQUIRE(oldFromNew[node->Descendant(i)] ==
+          originalNode->Descendant(i));
+    }
+
+    if (node->IsLeaf())
+    {
+      for (size_t i = 0; i < node->NumPoints(); ++i)
+      {
+        if (node->Point(i) >= next)
+        {
+          REQUIRE(node->Point(i) == next);
+          ++next;
+        }
+      }
+    }
+    else
+    {
+      nodes.push(node->Right());
+      nodes.push(node->Left());
+      originalNodes.push(originalNode->Right());
+      originalNodes.push(originalNode->Left());
+    }
+  }
+
+  REQUIRE(next == 1000);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Check that the two given trees have the same structure and hold the same
+ * points.
+ */
+template<typename TreeType>
+void CheckSameTree(TreeType& tree, TreeType& other)
+{
+  std::stack<TreeType*> nodes, otherNodes;
+  nodes.push(&tree);
+  otherNodes.push(&other);
+  while (!nodes.empty())
+  {
+    TreeType* node = nodes.top();
+    TreeType* otherNode = otherNodes.top();
+    nodes.pop();
+    otherNodes.pop();
+
+    REQUIRE(node->IsLeaf() == otherNode->IsLeaf());
+    REQUIRE(node->Overlap() == otherNode->Overlap());
+    REQUIRE(node->NumDescendants() == otherNode->NumDescendants());
+    for (size_t i = 0; i < node->NumDescendants(); ++i)
+      REQUIRE(node->Descendant(i) == otherNode->Descendant(i));
+    REQUIRE(node->ParentDistance() == Approx(otherNode->ParentDistance()));
+    REQUIRE(node->FurthestDescendantDistance() ==
+        Approx(otherNode->FurthestDescendantDistance()));
+
+    if (!node->IsLeaf())
+    {
+      nodes.push(node->Left());
+      nodes.push(node->Right());
+      otherNodes.push(otherNode->Left());
+      otherNodes.push(otherNode->Right());
+    }
+  }
+}
+
+/**
+ * Make sure that building a large spill tree in parallel gives the same tree
+ * as building it serially, with axis-orthogonal and general hyperplanes.
+ */
+TEST_CASE("SpillTreeParallelBuildTest", "[SpillTreeTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 20000);
+  const int oldThreads = omp_get_max_threads();
+
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef NonOrtSPTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      NonOrtTreeType;
+
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, 0.02, 10);
+  NonOrtTreeType serialNonOrtTree(dataset, 0.02, 10);
+
+  omp_set_num_threads(4);
+  TreeType tree(dataset, 0.02, 10);
+  NonOrtTreeType nonOrtTree(dataset, 0.02, 10);
+  omp_set_num_threads(oldThreads);
+
+  CheckSameTree(tree, serialTree);
+  CheckSameTree(nonOrtTree, serialNonOrtTree);
+}
+
+#endif
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/split_data.hpp>
+#include <mlpack/core/data/streaming_split.hpp>
 
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
@@ -434,3 +435,161 @@ TEST_CASE("SplitLabeledDataResultField", "[SplitDataTest]")
   CheckFields(input, inputConcat);
   CheckFields(label, labelConcat);
 }
+
+/**
+ * Make sure the indices given by SplitIndices() partition the points.
+ */
+TEST_CASE("SplitIndicesTest", "[SplitDataTest]")
+{
+  uvec trainIndices, testIndices;
+  SplitIndices(1000, trainIndices, testIndices, 0.25);
+
+  REQUIRE(trainIndices.n_elem == 750);
+  REQUIRE(testIndices.n_elem == 250);
+
+  Row<size_t> counts(1000, fill::zeros);
+  for (size_t i = 0; i < trainIndices.n_elem; ++i)
+    counts[trainIndices[i]]++;
+  for (size_t i = 0; i < testIndices.n_elem; ++i)
+    counts[testIndices[i]]++;
+
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    REQUIRE(counts[i] == 1);
+
+  // Without shuffling, the test set is the last points.
+  SplitIndices(10, trainIndices, testIndices, 0.3, false);
+  REQUIRE(testIndices.n_elem == 3);
+  REQUIRE(testIndices[0] == 7);
+  REQUIRE(testIndices[2] == 9);
+}
+
+/**
+ * Make sure StratifiedSplitIndices() gives the right number of each label.
+ */
+TEST_CASE("StratifiedSplitIndicesTest", "[SplitDataTest]")
+{
+  // 60 0s, 30 1s and 10 2s.
+  Row<size_t> labels(100);
+  labels.subvec(0, 59).fill(0);
+  labels.subvec(60, 89).fill(1);
+  labels.subvec(90, 99).fill(2);
+
+  uvec trainIndices, testIndices;
+  StratifiedSplitIndices(labels, trainIndices, testIndices, 0.25);
+
+  REQUIRE(trainIndices.n_elem == 76);
+  REQUIRE(testIndices.n_elem == 24);
+
+  const Row<size_t> testLabels = labels.elem(testIndices).t();
+  REQUIRE(static_cast<uvec>(find(testLabels == 0)).n_elem == 15);
+  REQUIRE(static_cast<uvec>(find(testLabels == 1)).n_elem == 7);
+  REQUIRE(static_cast<uvec>(find(testLabels == 2)).n_elem == 2);
+}
+
+/**
+ * Make sure SplitInPlace() makes aliases of the input, and keeps each label
+ * with its point.
+ */
+TEST_CASE("SplitInPlaceTest", "[SplitDataTest]")
+{
+  mat input(2, 100, fill::randu);
+  Row<size_t> labels(100);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    input(0, i) = i;
+    labels[i] = i;
+  }
+
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  SplitInPlace(input, labels, trainData, testData, trainLabels, testLabels,
+      0.2);
+
+  REQUIRE(trainData.n_cols == 80);
+  REQUIRE(testData.n_cols == 20);
+  REQUIRE(trainLabels.n_elem == 80);
+  REQUIRE(testLabels.n_elem == 20);
+
+  // The sets are aliases of the shuffled input.
+  REQUIRE(trainData.memptr() == input.memptr());
+  REQUIRE(testData.memptr() == input.colptr(80));
+  REQUIRE(trainLabels.memptr() == labels.memptr());
+  REQUIRE(testLabels.memptr() == labels.memptr() + 80);
+
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    REQUIRE((size_t) trainData(0, i) == trainLabels[i]);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    REQUIRE((size_t) testData(0, i) == testLabels[i]);
+}
+
+/**
+ * Make sure StreamingSplit() writes each point once, and keeps each label with
+ * its point.
+ */
+TEST_CASE("StreamingSplitTest", "[SplitDataTest]")
+{
+  // Each point holds its index, and its label is the index modulo 4.
+  std::ofstream data("streaming_split_data.csv");
+  std::ofstream labels("streaming_split_labels.csv");
+  for (size_t i = 0; i < 200; ++i)
+  {
+    data << i << "," << 2 * i << "\n";
+    labels << (i % 4) << "\n";
+  }
+  data.close();
+  labels.close();
+
+  for (const bool stratify : { false, true })
+  {
+    StreamingSplit("streaming_split_data.csv", "streaming_split_labels.csv",
+        "streaming_split_train.csv", "streaming_split_test.csv",
+        "streaming_split_train_labels.csv", "streaming_split_test_labels.csv",
+        0.3, stratify);
+
+    mat train, test;
+    Row<size_t> trainLabels, testLabels;
+    REQUIRE(data::Load("streaming_split_train.csv", train));
+    REQUIRE(data::Load("streaming_split_test.csv", test));
+    REQUIRE(data::Load("streaming_split_train_labels.csv", trainLabels));
+    REQUIRE(data::Load("streaming_split_test_labels.csv", testLabels));
+
+    REQUIRE(train.n_cols == 140);
+    REQUIRE(test.n_cols == 60);
+    REQUIRE(trainLabels.n_elem == 140);
+    REQUIRE(testLabels.n_elem == 60);
+
+    Row<size_t> counts(200, fill::zeros);
+    for (size_t i = 0; i < train.n_cols; ++i)
+    {
+      REQUIRE(train(1, i) == 2 * train(0, i));
+      REQUIRE(trainLabels[i] == (size_t) train(0, i) % 4);
+      counts[(size_t) train(0, i)]++;
+    }
+    for (size_t i = 0; i < test.n_cols; ++i)
+    {
+      REQUIRE(testLabels[i] == (size_t) test(0, i) % 4);
+      counts[(size_t) test(0, i)]++;
+    }
+
+    for (size_t i = 0; i < counts.n_elem; ++i)
+      REQUIRE(counts[i] == 1);
+
+    // Each of the four labels has 50 points, so 15 of each are held out.
+    if (stratify)
+    {
+      for (size_t l = 0; l < 4; ++l)
+        REQUIRE(static_cast<uvec>(find(testLabels == l)).n_elem == 15);
+    }
+  }
+
+  remove("streaming_split_data.csv");
+  remove("streaming_split_labels.csv");
+  remove("streaming_split_train.csv");
+  remove("streaming_split_test.csv");
+  remove("streaming_split_train_labels.csv");
+  remove("streaming_split_test_labels.csv");
+
+  REQUIRE_THROWS_AS(StreamingSplit("streaming_split_missing.csv",
+      "streaming_split_train.csv", "streaming_split_test.csv", 0.3),
+      std::runtime_error);
+}
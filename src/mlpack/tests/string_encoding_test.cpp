@@ -18,6 +18,7 @@
 #include <mlpack/core/data/string_encoding_policies/dictionary_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/bag_of_words_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/tf_idf_encoding_policy.hpp>
+#include <mlpack/core/data/string_encoding_policies/hashing_encoding_policy.hpp>
 #include <memory>
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
@@ -1434,3 +1435,91 @@ TEST_CASE("SplitByAnyOfTfIdfEncodingSerialization", "[StringEncodingTest]")
 
   CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
 }
+
+/**
+ * Make sure that encoding into a sparse matrix gives the same result as
+ * encoding into a dense matrix, for each of the encoding policies.
+ */
+TEST_CASE("SparseOutputEncodingTest", "[StringEncodingTest]")
+{
+  SplitByAnyOf tokenizer(" ,.\"");
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+
+  DictionaryEncoding<SplitByAnyOf::TokenType> dictionaryEncoder;
+  dictionaryEncoder.Encode(stringEncodingInput, output, tokenizer);
+  dictionaryEncoder.Encode(stringEncodingInput, sparseOutput, tokenizer);
+  CheckMatrices(output, arma::mat(sparseOutput));
+
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> bagOfWordsEncoder;
+  bagOfWordsEncoder.Encode(stringEncodingInput, output, tokenizer);
+  bagOfWordsEncoder.Encode(stringEncodingInput, sparseOutput, tokenizer);
+  CheckMatrices(output, arma::mat(sparseOutput));
+
+  TfIdfEncoding<SplitByAnyOf::TokenType> tfIdfEncoder;
+  tfIdfEncoder.Encode(stringEncodingInput, output, tokenizer);
+  tfIdfEncoder.Encode(stringEncodingInput, sparseOutput, tokenizer);
+  CheckMatrices(output, arma::mat(sparseOutput));
+}
+
+/**
+ * Make sure that the labels are assigned in the order in which the tokens
+ * first appear, even when the strings are tokenized in blocks.
+ */
+TEST_CASE("ManyStringsDictionaryEncodingTest", "[StringEncodingTest]")
+{
+  vector<string> input;
+  for (size_t i = 0; i < 1000; ++i)
+    input.push_back("token" + to_string(i) + " token" + to_string(i / 2));
+
+  DictionaryEncoding<SplitByAnyOf::TokenType> encoder;
+  SplitByAnyOf tokenizer(" ");
+  vector<vector<size_t>> output;
+  encoder.Encode(input, output, tokenizer);
+
+  REQUIRE(encoder.Dictionary().Size() == 1000);
+  REQUIRE(output.size() == 1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    REQUIRE(output[i].size() == 2);
+    REQUIRE(output[i][0] == i + 1);
+    REQUIRE(output[i][1] == i / 2 + 1);
+  }
+}
+
+/**
+ * Test the hashing encoding algorithm: the result has to be the bag of words
+ * encoding with the rows given by the hashes of the tokens.
+ */
+TEST_CASE("HashingEncodingTest", "[StringEncodingTest]")
+{
+  SplitByAnyOf tokenizer(" ,.");
+
+  arma::mat bagOfWords;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> bagOfWordsEncoder;
+  bagOfWordsEncoder.Encode(stringEncodingInput, bagOfWords, tokenizer);
+
+  HashingEncoding<SplitByAnyOf::TokenType> encoder(1000);
+  arma::sp_mat output;
+  encoder.Encode(stringEncodingInput, output, tokenizer);
+
+  // No dictionary is built.
+  REQUIRE(encoder.Dictionary().Size() == 0);
+  REQUIRE(output.n_rows == 1000);
+  REQUIRE(output.n_cols == stringEncodingInput.size());
+
+  arma::mat expected(1000, stringEncodingInput.size(), arma::fill::zeros);
+  for (auto& keyValue : bagOfWordsEncoder.Dictionary().Mapping())
+  {
+    const size_t row = encoder.EncodingPolicy().Label(keyValue.first) - 1;
+    expected.row(row) += bagOfWords.row(keyValue.second - 1);
+  }
+
+  CheckMatrices(expected, arma::mat(output));
+
+  // The dense output has to be the same.
+  arma::mat denseOutput;
+  encoder.Encode(stringEncodingInput, denseOutput, tokenizer);
+  CheckMatrices(expected, denseOutput);
+}
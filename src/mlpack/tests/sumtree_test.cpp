@@ -88,3 +88,42 @@ TEST_CASE("BatchUpdate", "[SumTreeTest]")
   CHECK(sumtree.FindPrefixSum(2.8) <= 3);
   CHECK(sumtree.FindPrefixSum(3.0) <= 3);
 }
+
+/**
+ * Test that a batch update of some of the elements gives the same tree as
+ * setting them one by one, and that the batch search gives the same indices
+ * as the single search.
+ */
+TEST_CASE("BatchUpdateAndSearch", "[SumTreeTest]")
+{
+  SumTree<double> sumtree(64), reference(64);
+  for (size_t i = 0; i < 64; ++i)
+  {
+    const double value = arma::randu();
+    sumtree.Set(i, value);
+    reference.Set(i, value);
+  }
+
+  // Update a few elements, including a duplicated one.
+  arma::ucolvec indices = {3, 17, 40, 17, 63};
+  arma::colvec data = {0.5, 2.0, 0.1, 1.5, 3.0};
+  sumtree.BatchUpdate(indices, data);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    reference.Set(indices[i], data[i]);
+
+  CHECK(sumtree.Sum() == Approx(reference.Sum()).epsilon(1e-10));
+  for (size_t i = 0; i < 64; ++i)
+  {
+    CHECK(sumtree.Get(i) == Approx(reference.Get(i)).epsilon(1e-10));
+    CHECK(sumtree.Sum(0, i + 1) ==
+        Approx(reference.Sum(0, i + 1)).epsilon(1e-10));
+  }
+
+  arma::colvec masses = arma::sort(sumtree.Sum() *
+      arma::randu<arma::colvec>(100));
+  arma::ucolvec found;
+  sumtree.FindPrefixSum(masses, found);
+  REQUIRE(found.n_elem == 100);
+  for (size_t i = 0; i < masses.n_elem; ++i)
+    REQUIRE(found[i] == sumtree.FindPrefixSum(masses[i]));
+}
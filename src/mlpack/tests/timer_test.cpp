@@ -143,3 +143,116 @@ TEST_CASE("DisabledTimingTest", "[TimerTest]")
 
   REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
+
+// A recursive function with a profiled scope, for ProfilerTest.
+static void ProfiledRecursion(const size_t id,
+                              const size_t leafId,
+                              const size_t depth)
+{
+  util::ProfileScope scope(id);
+  if (depth == 0)
+  {
+    util::ProfileScope leafScope(leafId);
+    return;
+  }
+
+  ProfiledRecursion(id, leafId, depth - 1);
+  ProfiledRecursion(id, leafId, depth - 1);
+}
+
+/**
+ * Make sure that the profiler counts the calls of nested scopes, folds
+ * recursive calls, and merges the threads.
+ */
+TEST_CASE("ProfilerTest", "[TimerTest]")
+{
+  util::Profiler::Reset();
+  REQUIRE(util::Profiler::Empty());
+
+  const size_t id = util::Profiler::Register("recursion");
+  const size_t leafId = util::Profiler::Register("leaf");
+  REQUIRE(util::Profiler::Register("recursion") == id);
+  REQUIRE(leafId != id);
+
+  ProfiledRecursion(id, leafId, 3);
+  REQUIRE(!util::Profiler::Empty());
+  REQUIRE(util::Profiler::ToJSON().find("{ \"name\": \"recursion\", "
+      "\"calls\": 15, ") == 0);
+  REQUIRE(util::Profiler::ToJSON().find("{ \"name\": \"leaf\", "
+      "\"calls\": 8, ") != std::string::npos);
+
+  // The calls of other threads are added to the same scopes.
+  std::thread threads[2];
+  for (size_t i = 0; i < 2; ++i)
+    threads[i] = std::thread(ProfiledRecursion, id, leafId, 3);
+  for (size_t i = 0; i < 2; ++i)
+    threads[i].join();
+
+  REQUIRE(util::Profiler::ToJSON().find("{ \"name\": \"recursion\", "
+      "\"calls\": 45, ") == 0);
+  REQUIRE(util::Profiler::ToJSON().find("{ \"name\": \"leaf\", "
+      "\"calls\": 24, ") != std::string::npos);
+
+  util::Profiler::Reset();
+  REQUIRE(util::Profiler::Empty());
+  REQUIRE(util::Profiler::ToJSON() == "[]");
+}
+
+/**
+ * Make sure that the memory tracker accounts for allocations, and records the
+ * peaks of nested phases.
+ */
+TEST_CASE("MemoryTrackerTest", "[TimerTest]")
+{
+  util::MemoryTracker::Reset();
+  REQUIRE(util::MemoryTracker::Empty());
+  const size_t base = util::MemoryTracker::CurrentBytes();
+
+  void* outer = NULL;
+  {
+    util::MemoryPhase outerPhase("outer");
+    outer = util::MemoryTracker::Allocate(1000);
+    REQUIRE(outer != NULL);
+    REQUIRE(util::MemoryTracker::CurrentBytes() == base + 1000);
+
+    {
+      util::MemoryPhase innerPhase("inner");
+      void* inner = util::MemoryTracker::Allocate(5000);
+      REQUIRE(util::MemoryTracker::CurrentBytes() == base + 6000);
+      util::MemoryTracker::Free(inner);
+    }
+
+    REQUIRE(util::MemoryTracker::CurrentBytes() == base + 1000);
+  }
+
+  REQUIRE(!util::MemoryTracker::Empty());
+  REQUIRE(util::MemoryTracker::PeakBytes() >= base + 6000);
+
+  std::map<std::string, util::MemoryTracker::PhaseStatistics> phases =
+      util::MemoryTracker::Phases();
+  REQUIRE(phases.size() == 2);
+
+  // The inner phase allocated 5000 bytes and freed them.
+  REQUIRE(phases["inner"].calls == 1);
+  REQUIRE(phases["inner"].peakIncrease >= 5000);
+  REQUIRE(phases["inner"].netBytes == 0);
+
+  // The peak of the inner phase counts for the outer phase, which kept its
+  // 1000 bytes.
+  REQUIRE(phases["outer"].calls == 1);
+  REQUIRE(phases["outer"].peakIncrease >= 6000);
+  REQUIRE(phases["outer"].peakBytes >= phases["inner"].peakBytes);
+  REQUIRE(phases["outer"].netBytes == 1000);
+
+  util::MemoryTracker::Free(outer);
+  util::MemoryTracker::Free(NULL);
+  REQUIRE(util::MemoryTracker::CurrentBytes() == base);
+
+  const std::string json = util::MemoryTracker::ToJSON();
+  REQUIRE(json.find("{ \"name\": \"inner\", \"calls\": 1, ") !=
+      std::string::npos);
+  REQUIRE(json.find("\"net_bytes\": 1000 }") != std::string::npos);
+
+  util::MemoryTracker::Reset();
+  REQUIRE(util::MemoryTracker::Empty());
+}
@@ -15,8 +15,10 @@
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/child_bounds.hpp>
 
 #include <queue>
+#include <set>
 #include <stack>
 
 #include "catch.hpp"
@@ -1986,6 +1988,64 @@ TEST_CASE("SparseCoverTreeConstructionTest", "[TreeTest]")
   // in our implementation.
 }
 
+// Make sure that two cover trees have exactly the same structure.
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Point() == b.Point());
+  REQUIRE(a.Scale() == b.Scale());
+  REQUIRE(a.NumDescendants() == b.NumDescendants());
+  REQUIRE(a.ParentDistance() == Approx(b.ParentDistance()).epsilon(1e-10));
+  REQUIRE(a.FurthestDescendantDistance() ==
+      Approx(b.FurthestDescendantDistance()).epsilon(1e-10));
+  REQUIRE(a.NumChildren() == b.NumChildren());
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Create a cover tree large enough for the distances at the top levels to be
+ * computed in parallel, and make sure it is accurate and does not depend on
+ * the number of threads.
+ */
+TEST_CASE("LargeCoverTreeConstructionTest", "[TreeTest]")
+{
+  arma::mat dataset;
+  dataset.randu(3, 6000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  arma::vec counts;
+  counts.zeros(6000);
+  RecurseTreeCountLeaves(tree, counts);
+
+  for (size_t i = 0; i < 6000; ++i)
+    REQUIRE(counts[i] == 1);
+
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true> >(tree);
+
+  // The distances that are already known are not computed again, so there
+  // must be far fewer distance computations than pairs of points.
+  REQUIRE(tree.DistanceComps() < 6000 * 5999 / 2);
+
+  // The parallel distance computations are only used if OpenMP is available.
+  #ifdef HAS_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset);
+  omp_set_num_threads(4);
+  TreeType parallelTree(dataset);
+  omp_set_num_threads(threads);
+
+  CheckSameCoverTree(serialTree, parallelTree);
+  REQUIRE(serialTree.DistanceComps() == parallelTree.DistanceComps());
+  #endif
+}
+
 /**
  * Test the manual constructor.
  */
@@ -2287,3 +2347,283 @@ TEST_CASE("CoverTreeDescendantTest", "[TreeTest]")
   // using the recursive function above.
   CheckDescendants(&tree);
 }
+
+/**
+ * Make sure that the NodePool hands out distinct, usable memory, reuses freed
+ * memory, and places consecutive allocations next to each other.
+ */
+TEST_CASE("NodePoolTest", "[TreeTest]")
+{
+  typedef arma::vec::fixed<3> NodeType;
+  typedef NodePool<NodeType> Pool;
+
+  std::vector<NodeType*> nodes;
+  for (size_t i = 0; i < 3 * Pool::ChunkSize; ++i)
+  {
+    nodes.push_back((NodeType*) Pool::Allocate(sizeof(NodeType)));
+    new (nodes.back()) NodeType();
+    nodes.back()->fill(i);
+  }
+
+  // All allocations in the same chunk are ordered in memory.
+  for (size_t i = 1; i < Pool::ChunkSize; ++i)
+    REQUIRE((char*) nodes[i] > (char*) nodes[i - 1]);
+
+  // Free every other node; the rest must be untouched.
+  for (size_t i = 0; i < nodes.size(); i += 2)
+  {
+    nodes[i]->~NodeType();
+    Pool::Deallocate(nodes[i], sizeof(NodeType));
+  }
+
+  for (size_t i = 1; i < nodes.size(); i += 2)
+    for (size_t d = 0; d < 3; ++d)
+      REQUIRE((*nodes[i])[d] == (double) i);
+
+  // Reallocate the freed nodes; they should come from the freed memory.
+  std::set<NodeType*> oldNodes(nodes.begin(), nodes.end());
+  for (size_t i = 0; i < nodes.size(); i += 2)
+  {
+    nodes[i] = (NodeType*) Pool::Allocate(sizeof(NodeType));
+    REQUIRE(oldNodes.count(nodes[i]) == 1);
+    new (nodes[i]) NodeType();
+    nodes[i]->fill(i);
+  }
+
+  std::set<NodeType*> newNodes(nodes.begin(), nodes.end());
+  REQUIRE(newNodes.size() == nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    for (size_t d = 0; d < 3; ++d)
+      REQUIRE((*nodes[i])[d] == (double) i);
+
+    nodes[i]->~NodeType();
+    Pool::Deallocate(nodes[i], sizeof(NodeType));
+  }
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that two binary space trees have the same structure and bounds.
+ */
+template<typename TreeType>
+void CheckSameBinarySpaceTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.ParentDistance() == Approx(b.ParentDistance()).epsilon(1e-10));
+  REQUIRE(a.FurthestDescendantDistance() ==
+      Approx(b.FurthestDescendantDistance()).epsilon(1e-10));
+
+  arma::vec aCenter, bCenter;
+  a.Center(aCenter);
+  b.Center(bCenter);
+  CheckMatrices(aCenter, bCenter);
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+  {
+    REQUIRE(b.Child(i).Parent() == &b);
+    CheckSameBinarySpaceTree(a.Child(i), b.Child(i));
+  }
+}
+
+/**
+ * Make sure that building a tree in parallel gives the same tree as building it
+ * with one thread.
+ */
+template<typename TreeType>
+void ParallelBinarySpaceTreeTest()
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 30000);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::vector<size_t> oldFromNew;
+  TreeType serialTree(dataset, oldFromNew, 10);
+
+  omp_set_num_threads(4);
+  std::vector<size_t> parallelOldFromNew;
+  TreeType parallelTree(dataset, parallelOldFromNew, 10);
+  omp_set_num_threads(oldThreads);
+
+  CheckMatrices(serialTree.Dataset(), parallelTree.Dataset());
+  REQUIRE(oldFromNew == parallelOldFromNew);
+  CheckSameBinarySpaceTree(serialTree, parallelTree);
+}
+
+TEST_CASE("KDTreeParallelBuildTest", "[TreeTest]")
+{
+  ParallelBinarySpaceTreeTest<KDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>();
+}
+
+TEST_CASE("BallTreeParallelBuildTest", "[TreeTest]")
+{
+  ParallelBinarySpaceTreeTest<BallTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>();
+}
+
+#endif
+
+/**
+ * Make sure that the distances computed by HRectBoundSet are those of the
+ * bounds it holds, and that single-precision sets still contain the bounds.
+ */
+TEST_CASE("HRectBoundSetDistances", "[TreeTest]")
+{
+  const size_t dim = 5;
+  std::vector<HRectBound<EuclideanDistance>> bounds(7,
+      HRectBound<EuclideanDistance>(dim));
+  HRectBoundSet<EuclideanDistance> set(dim, bounds.size());
+  HRectBoundSet<EuclideanDistance, float> floatSet(dim, bounds.size());
+  for (size_t i = 0; i < bounds.size(); ++i)
+  {
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const double lo = 0.1 * i + math::Random();
+      bounds[i][d] = math::Range(lo, lo + math::Random());
+    }
+    set.Set(i, bounds[i]);
+    floatSet.Set(i, bounds[i]);
+  }
+
+  REQUIRE(set.Size() == bounds.size());
+  REQUIRE(set.Dim() == dim);
+
+  for (size_t trial = 0; trial < 20; ++trial)
+  {
+    const arma::vec point = 3 * arma::randu<arma::vec>(dim) - 1;
+
+    arma::vec minDistances, maxDistances, floatMin, floatMax;
+    set.MinDistance(point, minDistances);
+    set.MaxDistance(point, maxDistances);
+    floatSet.MinDistance(point, floatMin);
+    floatSet.MaxDistance(point, floatMax);
+
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+      REQUIRE(minDistances[i] == bounds[i].MinDistance(point));
+      REQUIRE(maxDistances[i] == bounds[i].MaxDistance(point));
+
+      // The single-precision bounds are a little larger.
+      REQUIRE(floatMin[i] <= minDistances[i]);
+      REQUIRE(floatMax[i] >= maxDistances[i]);
+      REQUIRE(floatMin[i] == Approx(minDistances[i]).margin(1e-5));
+      REQUIRE(floatMax[i] == Approx(maxDistances[i]).epsilon(1e-5));
+    }
+  }
+}
+
+/**
+ * The distances of low-dimensional bounds, computed with loops of fixed
+ * length, must match the distances computed from their definitions.
+ */
+TEST_CASE("HRectBoundFixedDimensionDistances", "[TreeTest]")
+{
+  for (size_t dim = 1; dim <= 6; ++dim)
+  {
+    HRectBound<EuclideanDistance> bound(dim), other(dim);
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const double lo = math::Random();
+      const double otherLo = math::Random();
+      bound[d] = math::Range(lo, lo + math::Random());
+      other[d] = math::Range(otherLo, otherLo + math::Random());
+    }
+
+    for (size_t trial = 0; trial < 10; ++trial)
+    {
+      const arma::vec point = 3 * arma::randu<arma::vec>(dim) - 1;
+
+      // The closest point of the bound is the point clamped to the bound, and
+      // the furthest point is the furthest corner.
+      double minSum = 0.0, maxSum = 0.0;
+      for (size_t d = 0; d < dim; ++d)
+      {
+        const double closest = std::min(std::max(point[d], bound[d].Lo()),
+            bound[d].Hi());
+        const double furthest = std::max(std::abs(point[d] - bound[d].Lo()),
+            std::abs(point[d] - bound[d].Hi()));
+        minSum += std::pow(point[d] - closest, 2.0);
+        maxSum += std::pow(furthest, 2.0);
+      }
+
+      REQUIRE(bound.MinDistance(point) ==
+          Approx(std::sqrt(minSum)).margin(1e-12));
+      REQUIRE(bound.MaxDistance(point) ==
+          Approx(std::sqrt(maxSum)).epsilon(1e-12));
+      const math::Range range = bound.RangeDistance(point);
+      REQUIRE(range.Lo() == Approx(std::sqrt(minSum)).margin(1e-12));
+      REQUIRE(range.Hi() == Approx(std::sqrt(maxSum)).epsilon(1e-12));
+    }
+
+    double minSum = 0.0, maxSum = 0.0;
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const double gap = std::max(std::max(other[d].Lo() - bound[d].Hi(),
+          bound[d].Lo() - other[d].Hi()), 0.0);
+      const double span = std::max(other[d].Hi() - bound[d].Lo(),
+          bound[d].Hi() - other[d].Lo());
+      minSum += gap * gap;
+      maxSum += span * span;
+    }
+
+    REQUIRE(bound.MinDistance(other) ==
+        Approx(std::sqrt(minSum)).margin(1e-12));
+    REQUIRE(bound.MaxDistance(other) ==
+        Approx(std::sqrt(maxSum)).epsilon(1e-12));
+    const math::Range range = bound.RangeDistance(other);
+    REQUIRE(range.Lo() == Approx(std::sqrt(minSum)).margin(1e-12));
+    REQUIRE(range.Hi() == Approx(std::sqrt(maxSum)).epsilon(1e-12));
+  }
+}
+
+/**
+ * Make sure that ChildBounds holds the bounds of the children of every node
+ * of a kd-tree, and of no node of a cover tree.
+ */
+TEST_CASE("ChildBoundsTest", "[TreeTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset, 10);
+  ChildBounds<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>
+      childBounds(tree);
+
+  size_t internalNodes = 0;
+  std::stack<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>*> nodes;
+  nodes.push(&tree);
+  while (!nodes.empty())
+  {
+    KDTree<EuclideanDistance, EmptyStatistic, arma::mat>* node = nodes.top();
+    nodes.pop();
+    if (node->IsLeaf())
+    {
+      REQUIRE(childBounds.Children(*node) == NULL);
+      continue;
+    }
+
+    ++internalNodes;
+    REQUIRE(childBounds.Children(*node) != NULL);
+    REQUIRE(childBounds.Children(*node)->Size() == 2);
+
+    // The distances must be those of the children.
+    const arma::vec point = arma::randu<arma::vec>(3);
+    arma::vec distances;
+    childBounds.Children(*node)->MinDistance(point, distances);
+    REQUIRE(distances[0] == node->Left()->MinDistance(point));
+    REQUIRE(distances[1] == node->Right()->MinDistance(point));
+
+    nodes.push(node->Left());
+    nodes.push(node->Right());
+  }
+  REQUIRE(childBounds.NumNodes() == internalNodes);
+
+  StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      coverTree(dataset);
+  ChildBounds<StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>>
+      coverBounds(coverTree);
+  REQUIRE(coverBounds.NumNodes() == 0);
+  REQUIRE(coverBounds.Children(coverTree) == NULL);
+}
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/xgboost/loss_functions/sse_loss.hpp>
+#include <mlpack/methods/xgboost/xgboost.hpp>
 
 #include "catch.hpp"
 #include "serialization.hpp"
@@ -64,3 +65,136 @@ TEST_CASE("SSEGainTest", "[XGBTest]")
   SSELoss Loss;
   REQUIRE(Loss.Evaluate<false>(input, weights) == gain);
 }
+
+/**
+ * Test that the sums based gain and leaf value of SSE loss match Evaluate() and
+ * OutputLeafValue().
+ */
+TEST_CASE("SSESumsTest", "[XGBTest]")
+{
+  arma::mat input = { { 1,   3,   2,   2, 5, 6, 9,    11, 8,   8 },
+                      { 0.5, 1, 2.5, 1.5, 5, 8, 8, 10.75, 9, 9.5 } };
+  arma::vec weights; // dummy weights not used.
+
+  SSELoss loss(0.1, 1.0);
+  const double gain = loss.Evaluate<false>(input, weights);
+  const double leafValue = loss.OutputLeafValue(input, weights);
+
+  arma::vec gradients, hessians;
+  loss.Gradients(input.row(0), input.row(1), gradients, hessians);
+  REQUIRE(loss.Gain(arma::accu(gradients), arma::accu(hessians)) ==
+      Approx(gain).epsilon(1e-10));
+  REQUIRE(loss.LeafValue(arma::accu(gradients), arma::accu(hessians)) ==
+      Approx(leafValue).epsilon(1e-10));
+}
+
+/**
+ * Test that the FeatureBinner gives each distinct value its own bin when there
+ * are few of them, and bins of similar sizes otherwise.
+ */
+TEST_CASE("FeatureBinnerTest", "[XGBTest]")
+{
+  arma::mat data(2, 1000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    data(0, i) = i % 4;
+    data(1, i) = i;
+  }
+
+  FeatureBinner binner;
+  binner.Fit(data, 10);
+  REQUIRE(binner.NumBins(0) == 4);
+  REQUIRE(binner.NumBins(1) == 10);
+
+  arma::Mat<unsigned char> bins;
+  binner.Bin(data, bins);
+  REQUIRE(bins.n_rows == 1000);
+  REQUIRE(bins.n_cols == 2);
+
+  arma::uvec counts(10, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    REQUIRE(bins(i, 0) == i % 4);
+    // The values of each bin are at most its upper edge.
+    REQUIRE(data(1, i) <= binner.Edge(1, bins(i, 1)));
+    counts[bins(i, 1)]++;
+  }
+
+  for (size_t b = 0; b < 10; ++b)
+    REQUIRE(counts[b] == 100);
+
+  REQUIRE_THROWS_AS(binner.Fit(data, 300), std::invalid_argument);
+}
+
+/**
+ * Test that XGBoost fits a nonlinear function, and better with more trees.
+ */
+TEST_CASE("XGBoostRegressionTest", "[XGBTest]")
+{
+  arma::mat data(3, 2000, arma::fill::randu);
+  arma::rowvec responses = arma::sin(6 * data.row(0)) + 2 * data.row(1) %
+      data.row(2);
+  arma::mat testData(3, 500, arma::fill::randu);
+  arma::rowvec testResponses = arma::sin(6 * testData.row(0)) + 2 *
+      testData.row(1) % testData.row(2);
+
+  XGBoost<> few(data, responses, 5);
+  XGBoost<> many(data, responses, 200);
+  REQUIRE(many.NumTrees() == 200);
+
+  arma::rowvec fewPredictions, manyPredictions;
+  few.Predict(testData, fewPredictions);
+  many.Predict(testData, manyPredictions);
+
+  const double fewError = arma::mean(arma::square(fewPredictions -
+      testResponses));
+  const double manyError = arma::mean(arma::square(manyPredictions -
+      testResponses));
+  REQUIRE(manyError < fewError);
+  REQUIRE(manyError < 0.01);
+
+  // Predicting a single point gives the same result.
+  REQUIRE(many.Predict(testData.col(3)) ==
+      Approx(manyPredictions[3]).epsilon(1e-10));
+}
+
+/**
+ * Test that leaf-wise growth respects the maximum number of leaves, and that
+ * depth-wise growth respects the maximum depth.
+ */
+TEST_CASE("XGBoostTreeSizeTest", "[XGBTest]")
+{
+  arma::mat data(4, 1000, arma::fill::randu);
+  arma::rowvec responses = arma::sum(arma::square(data), 0);
+
+  XGBoost<> leafWise(data, responses, 10, 0.3, 0, 7, 1.0, 0.5);
+  for (size_t t = 0; t < leafWise.NumTrees(); ++t)
+    REQUIRE(leafWise.Tree(t).NumLeaves() == 7);
+
+  XGBoost<> depthWise(data, responses, 10, 0.3, 2);
+  for (size_t t = 0; t < depthWise.NumTrees(); ++t)
+    REQUIRE(depthWise.Tree(t).NumLeaves() <= 4);
+}
+
+/**
+ * Test that a serialized XGBoost model gives the same predictions.
+ */
+TEST_CASE("XGBoostSerializationTest", "[XGBTest]")
+{
+  arma::mat data(3, 500, arma::fill::randu);
+  arma::rowvec responses = data.row(0) + data.row(1) % data.row(2);
+
+  XGBoost<> model(data, responses, 20, 0.3, 4, 0, 1.0, 1.0, 64,
+      SSELoss(0.0, 1.0));
+  XGBoost<> xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::rowvec predictions, xmlPredictions, jsonPredictions, binaryPredictions;
+  model.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}